@@ -41,6 +41,8 @@ from __future__ import absolute_import
 from m5 import fatal
 import m5.objects
 
+from . import ObjectList
+
 def config_etrace(cpu_cls, cpu_list, options):
     if issubclass(cpu_cls, m5.objects.DerivO3CPU):
         # Assign the same file name to all cpus for now. This must be
@@ -64,3 +66,48 @@ def config_etrace(cpu_cls, cpu_list, options):
     else:
         fatal("%s does not support data dependency tracing. Use a CPU model of"
               " type or inherited from DerivO3CPU.", cpu_cls)
+
+def config_shadow_bp(cpu, bp_types):
+    """Add shadow branch predictors to the predictor of a CPU.
+
+    bp_types is a comma-separated list of branch predictor names. Each
+    shadow predicts the committed branches of the CPU without steering
+    fetch; its accuracy shows up in the shadowMispredicts statistics of
+    the main predictor and in the statistics of the shadow itself.
+    """
+
+    cpu.branchPred.shadows = [ ObjectList.bp_list.get(t)()
+                               for t in bp_types.split(',') if t ]
+
+def config_cpu_threads(cpus, device_eq=0, first_cpu_eq=1):
+    """Run each CPU in its own host thread.
+
+    Every CPU in cpus is moved to an event queue of its own, starting
+    at first_cpu_eq, while its children (TLBs, interrupt controllers,
+    caches, etc.) are kept on the device queue. The queues only
+    synchronize at the end of each simulation quantum. This has to be
+    called after all the children of the CPUs have been created since
+    they mustn't inherit the CPU event queue.
+    """
+
+    for idx, cpu in enumerate(cpus):
+        for obj in cpu.descendants():
+            obj.eventq_index = device_eq
+        cpu.eventq_index = first_cpu_eq + idx
+
+def config_kvm_threads(cpus, device_eq=0, first_cpu_eq=1):
+    """Run each KVM vCPU in its own host thread.
+
+    The vCPUs are placed on their own event queues as with
+    config_cpu_threads. They then only synchronize with the rest of
+    the system when they access a device and at the end of each
+    simulation quantum, so a large quantum (e.g., 1ms) lets them run
+    almost at native speed.
+    """
+
+    for cpu in cpus:
+        if not ObjectList.is_kvm_cpu(type(cpu)):
+            fatal("%s is not a KVM CPU and can't run in its own thread.",
+                  cpu)
+
+    config_cpu_threads(cpus, device_eq, first_cpu_eq)
@@ -689,7 +689,8 @@ def makeDistRoot(testSystem,
                  sync_start,
                  linkspeed,
                  linkdelay,
-                 dumpfile):
+                 dumpfile,
+                 shm=False):
     self = Root(full_system = True)
     self.testsys = testSystem
 
@@ -700,7 +701,8 @@ def makeDistRoot(testSystem,
                                    server_name = server_name,
                                    server_port = server_port,
                                    sync_start = sync_start,
-                                   sync_repeat = sync_repeat)
+                                   sync_repeat = sync_repeat,
+                                   shm_transport = shm)
 
     if hasattr(testSystem, 'realview'):
         self.etherlink.int0 = Parent.testsys.realview.ethernet.interface
@@ -74,7 +74,9 @@ def create_TLB_Coalescer(options, my_level, my_index, TLB_name, Coalescer_name):
         TLB_name.append(eval(TLB_constructor(my_level)))
         Coalescer_name.append(eval(Coalescer_constructor(my_level)))
 
-def config_tlb_hierarchy(options, system, shader_idx):
+def config_tlb_hierarchy(options, system, shader_idx, l2_bridge_delay=None):
+    # If l2_bridge_delay is set, the L1 TLBs of the CUs reach the L2 through
+    # bridges with this delay, so that they can run on other event queues.
     n_cu = options.num_compute_units
     # Make this configurable now, instead of the hard coded val.  The dispatcher
     # is always the last item in the system.cpu list.
@@ -193,10 +195,25 @@ def config_tlb_hierarchy(options, system, shader_idx):
     l2_coalescer_index = 0
     for TLB_type in L1:
         name = TLB_type['name']
+        bridged = l2_bridge_delay is not None and name != 'dispatcher'
+        if bridged:
+            bridges = [Bridge(delay = l2_bridge_delay,
+                              req_size = options.L1MaxOutstandingReqs,
+                              resp_size = options.L1MaxOutstandingReqs)
+                       for i in range(TLB_type['width'])]
+            exec('system.%s_tlb_bridge = bridges' % name)
         for index in range(TLB_type['width']):
-            exec('system.%s_tlb[%d].master[0] = \
-                    system.l2_coalescer[0].slave[%d]' % \
-                    (name, index, l2_coalescer_index))
+            if bridged:
+                exec('system.%s_tlb[%d].master[0] = \
+                        system.%s_tlb_bridge[%d].slave' % \
+                        (name, index, name, index))
+                exec('system.%s_tlb_bridge[%d].master = \
+                        system.l2_coalescer[0].slave[%d]' % \
+                        (name, index, l2_coalescer_index))
+            else:
+                exec('system.%s_tlb[%d].master[0] = \
+                        system.l2_coalescer[0].slave[%d]' % \
+                        (name, index, l2_coalescer_index))
             l2_coalescer_index += 1
     # L2 <-> L3
     system.l2_tlb[0].master[0] = system.l3_coalescer[0].slave[0]
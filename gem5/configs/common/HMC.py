@@ -223,6 +223,12 @@ def add_options(parser):
                         type=int, help="Gbs/s speed of each lane of serial\
                         link")
 
+    # window in which packets leaving a serial link are batched
+    parser.add_argument("--serial-link-batch-window", default='0ns',
+                        type=str, help="Window in which the packets leaving\
+                        a serial link are batched, 0 sends each packet on\
+                        its own")
+
     # address range for each of the serial links
     parser.add_argument("--serial-link-addr-range", default='1GB', type=str,
                         help="memory range for each of the serial links.\
@@ -339,6 +345,7 @@ def config_hmc_host_ctrl(opt, system):
                      resp_size=opt.link_buffer_size_rsp,
                      num_lanes=opt.num_lanes_per_link,
                      link_speed=opt.serial_link_speed,
+                     batch_window=opt.serial_link_batch_window,
                      delay=opt.total_ctrl_latency) for i in
           range(opt.num_serial_links)]
     system.hmc_host.seriallink = sl
@@ -177,6 +177,9 @@ def addCommonOptions(parser):
                       default="SimpleIndirectPredictor",
                       choices=ObjectList.indirect_bp_list.get_names(),
                       help = "type of indirect branch predictor to run with")
+    parser.add_option("--shadow-bp-types", type="string", default=None,
+                      help="comma-separated list of branch predictor types "
+                      "evaluated in the shadow of the main predictor")
     parser.add_option("--list-hwp-types",
                       action="callback", callback=_listHWPTypes,
                       help="List available hardware prefetcher types")
@@ -254,6 +257,9 @@ def addCommonOptions(parser):
                       default="5200000000000t",
                       action="store", type="string",
                       help="Time to schedule the first dist synchronisation barrier\nDEFAULT:5200000000000t")
+    parser.add_option("--dist-shm", action="store_true",
+                      help="Exchange dist-gem5 messages through shared "
+                      "memory (all gem5 processes on the same host).")
     parser.add_option("--ethernet-linkspeed", default="10Gbps",
                         action="store", type="string",
                         help="Link speed in bps\nDEFAULT: 10Gbps")
@@ -287,11 +293,23 @@ def addCommonOptions(parser):
                       help="Enable basic block profiling for SimPoints")
     parser.add_option("--simpoint-interval", type="int", default=10000000,
                       help="SimPoint interval in num of instructions")
+    parser.add_option("--branch-trace", action="store", type="string",
+                      default=None,
+                      help="Write the committed branches to a trace that "
+                      "can be replayed by configs/example/bp_replay.py")
     parser.add_option("--take-simpoint-checkpoints", action="store", type="string",
         help="<simpoint file,weight file,interval-length,warmup-length>")
     parser.add_option("--restore-simpoint-checkpoint", action="store_true",
         help="restore from a simpoint checkpoint taken with " +
              "--take-simpoint-checkpoints")
+    parser.add_option("--fork-simpoints", action="store", type="string",
+        help="simulate every simpoint in a forked copy of the simulator " \
+             "with --cpu-type and report weighted stats: " \
+             "<simpoint file,weight file,interval-length,warmup-length>")
+    parser.add_option("--max-forks", action="store", type="int",
+        default=None,
+        help="Maximum number of simpoints simulated at the same time " \
+             "with --fork-simpoints (default: number of host CPUs)")
 
     # Checkpointing options
     ###Note that performing checkpointing via python script files will override
@@ -339,6 +357,18 @@ def addCommonOptions(parser):
     parser.add_option("-F", "--fast-forward", action="store", type="string",
         default=None,
         help="Number of instructions to fast forward before switching")
+    parser.add_option("--functional-warming", action="store_true",
+        default=False,
+        help="Only warm up the caches while fast forwarding")
+    parser.add_option("--functional-warming-insts", action="store",
+        type="int", default=None,
+        help="Only warm up the caches during the last <N> instructions " \
+             "fast forwarded (requires --functional-warming)")
+    parser.add_option("--sampling", action="store", type="string",
+        default=None,
+        help="SMARTS-style sampling with an atomic CPU and --cpu-type: " \
+             "<fast-forward>,<warmup>,<measure>,<samples>, the first three " \
+             "in instructions (use with --functional-warming)")
     parser.add_option("-S", "--simpoint", action="store_true", default=False,
         help="""Use workload simpoints as an instruction offset for
                 --checkpoint-restore or --take-checkpoint.""")
@@ -381,6 +411,12 @@ def addSEOptions(parser):
                            "for information or functionality. Instead of "    \
                            "finding files on the __HOST__ filesystem, the "   \
                            "process will find the user's replacment files.")
+    parser.add_option("--cpu-threads", action="store_true",
+            help="Run each CPU in its own host thread")
+    parser.add_option("--sim-quantum", action="store", type="string",
+            default="1us",
+            help="Synchronization quantum of the event queues when "
+            "running multiple threads (e.g., with --cpu-threads)")
 
 
 def addFSOptions(parser):
@@ -389,6 +425,12 @@ def addFSOptions(parser):
     # Simulation options
     parser.add_option("--timesync", action="store_true",
             help="Prevent simulated time from getting ahead of real time")
+    parser.add_option("--kvm-threads", action="store_true",
+            help="Run each KVM vCPU in its own host thread")
+    parser.add_option("--sim-quantum", action="store", type="string",
+            default="1ms",
+            help="Synchronization quantum of the event queues when "
+            "running multiple threads (e.g., with --kvm-threads)")
 
     # System options
     parser.add_option("--kernel", action="store", type="string")
@@ -81,7 +81,7 @@ def setCPUClass(options):
         if options.restore_with_cpu != options.cpu_type:
             CPUClass = TmpClass
             TmpClass, test_mem_mode = getCPUClass(options.restore_with_cpu)
-    elif options.fast_forward:
+    elif options.fast_forward or options.sampling or options.fork_simpoints:
         CPUClass = TmpClass
         TmpClass = AtomicSimpleCPU
         test_mem_mode = 'atomic'
@@ -289,8 +289,10 @@ def benchCheckpoints(options, maxtick, cptdir):
 def parseSimpointAnalysisFile(options, testsys):
     import re
 
+    simpoint_spec = options.take_simpoint_checkpoints or \
+        options.fork_simpoints
     simpoint_filename, weight_filename, interval_length, warmup_length = \
-        options.take_simpoint_checkpoints.split(",", 3)
+        simpoint_spec.split(",", 3)
     print("simpoint analysis file:", simpoint_filename)
     print("simpoint weight file:", weight_filename)
     print("interval length:", interval_length)
@@ -390,6 +392,129 @@ def takeSimpointCheckpoints(simpoints, interval_length, cptdir):
     print("%d checkpoints taken" % num_checkpoints)
     sys.exit(code)
 
+def _runSimpoint(testsys, switch_cpu_list, interval_length, warmup_length):
+    """Simulate one simpoint in a forked simulator and exit."""
+    m5.switchCpus(testsys, switch_cpu_list, verbose=False)
+    cpu = switch_cpu_list[0][1]
+
+    if warmup_length:
+        cpu.scheduleInstStop(0, warmup_length, "simpoint warmup done")
+        exit_event = m5.simulate()
+        if exit_event.getCause() != "simpoint warmup done":
+            print("Exiting @ tick %i during warmup because %s" %
+                  (m5.curTick(), exit_event.getCause()))
+            sys.exit(1)
+
+    m5.stats.reset()
+    cpu.scheduleInstStop(0, interval_length, "simpoint done")
+    exit_event = m5.simulate()
+    m5.stats.dump()
+
+    if exit_event.getCause() != "simpoint done":
+        print("Simpoint ended early @ tick %i because %s" %
+              (m5.curTick(), exit_event.getCause()))
+        sys.exit(1)
+    sys.exit(0)
+
+def _parseStats(filename):
+    """Return the scalar values of the last dump in a stats file."""
+    values = {}
+    with open(filename) as stats_file:
+        for line in stats_file:
+            if line.startswith("---------- Begin Simulation Statistics"):
+                values = {}
+                continue
+            fields = line.split()
+            if len(fields) < 2 or fields[0].startswith("-"):
+                continue
+            try:
+                values[fields[0]] = float(fields[1])
+            except ValueError:
+                pass
+    return values
+
+def _weightStats(results, filename):
+    """Write the average of each stat over the simpoints, weighted by
+    the simpoint weights, and return the weighted stats."""
+    total_weight = sum(weight for weight, stats in results)
+    weighted = {}
+    for weight, stats in results:
+        for name, value in stats.items():
+            weighted[name] = weighted.get(name, 0.0) + \
+                value * weight / total_weight
+
+    with open(filename, "w") as out:
+        for name in sorted(weighted):
+            print("%-60s %20.6f" % (name, weighted[name]), file=out)
+    return weighted
+
+def forkSimpoints(testsys, switch_cpu_list, simpoints, interval_length,
+                  max_forks):
+    """Simulate each simpoint in a child process forked when the fast
+    forwarding CPUs reach it. The children share the memory of the
+    parent copy-on-write, so no checkpoint is written or restored."""
+    import os
+
+    running = {}
+    finished = []
+    failed = 0
+
+    def wait_child():
+        pid, status = os.waitpid(-1, 0)
+        index, weight, outdir = running.pop(pid)
+        if os.WIFEXITED(status) and os.WEXITSTATUS(status) == 0:
+            finished.append((weight,
+                             _parseStats(joinpath(outdir, "stats.txt"))))
+        else:
+            warn("Simpoint #%d failed, see %s" % (index, outdir))
+            return 1
+        return 0
+
+    last_start_inst_count = -1
+    exit_cause = "simpoint starting point found"
+    for index, simpoint in enumerate(simpoints):
+        interval, weight, starting_inst_count, actual_warmup_length = simpoint
+        if starting_inst_count != last_start_inst_count:
+            exit_event = m5.simulate()
+
+            # skip checkpoint instructions should they exist
+            while exit_event.getCause() == "checkpoint":
+                print("Found 'checkpoint' exit event...ignoring...")
+                exit_event = m5.simulate()
+
+            exit_cause = exit_event.getCause()
+            if exit_cause != "simpoint starting point found":
+                break
+        last_start_inst_count = starting_inst_count
+
+        while len(running) >= max_forks:
+            failed += wait_child()
+
+        outdir = "simpoint_%02d" % index
+        pid = m5.fork("%(parent)s/" + outdir)
+        if pid == 0:
+            _runSimpoint(testsys, switch_cpu_list, interval_length,
+                         actual_warmup_length)
+        print("Simpoint #%d forked @ tick %i, start inst:%d weight:%f" %
+              (index, m5.curTick(), starting_inst_count, weight))
+        running[pid] = (index, weight, joinpath(m5.options.outdir, outdir))
+
+    while running:
+        failed += wait_child()
+
+    print("Fast forward stopped @ tick %i because %s" %
+          (m5.curTick(), exit_cause))
+    print("%d simpoints simulated, %d failed" % (len(finished), failed))
+    if not finished:
+        sys.exit(1)
+
+    weighted = _weightStats(finished, joinpath(m5.options.outdir,
+                                               "simpoints_weighted.txt"))
+    for name in ("sim_insts", "sim_ticks"):
+        if name in weighted:
+            print("Weighted %s: %f" % (name, weighted[name]))
+    sys.exit(1 if failed else 0)
+
 def restoreSimpointCheckpoint():
     exit_event = m5.simulate()
     exit_cause = exit_event.getCause()
@@ -449,6 +574,34 @@ def run(options, root, testsys, cpu_class):
     if options.repeat_switch and options.take_checkpoints:
         fatal("Can't specify both --repeat-switch and --take-checkpoints")
 
+    if options.fork_simpoints and \
+       (options.fast_forward or options.standard_switch or
+        options.repeat_switch or options.sampling or
+        options.take_simpoint_checkpoints or
+        options.checkpoint_restore != None):
+        fatal("--fork-simpoints can't be combined with --fast-forward, "
+              "--standard-switch, --repeat-switch, --sampling or "
+              "checkpoints")
+
+    if options.functional_warming_insts and \
+       not (options.functional_warming and options.fast_forward):
+        fatal("--functional-warming-insts requires --functional-warming " \
+              "and --fast-forward")
+
+    if options.sampling:
+        if options.fast_forward or options.standard_switch or \
+           options.repeat_switch or options.checkpoint_restore != None:
+            fatal("--sampling can't be combined with --fast-forward, "
+                  "--standard-switch, --repeat-switch or "
+                  "--checkpoint-restore")
+        try:
+            sampling = [int(n) for n in options.sampling.split(',')]
+        except ValueError:
+            sampling = []
+        if len(sampling) != 4:
+            fatal("--sampling takes <fast-forward>,<warmup>,<measure>,"
+                  "<samples>")
+
     np = options.num_cpus
     switch_cpus = None
 
@@ -467,6 +620,11 @@ def run(options, root, testsys, cpu_class):
         for i in range(np):
             if options.fast_forward:
                 testsys.cpu[i].max_insts_any_thread = int(options.fast_forward)
+                if options.functional_warming_insts:
+                    # Stop before warming up the caches
+                    testsys.cpu[i].max_insts_any_thread = \
+                        max(int(options.fast_forward) -
+                            options.functional_warming_insts, 1)
             switch_cpus[i].system = testsys
             switch_cpus[i].workload = testsys.cpu[i].workload
             switch_cpus[i].clk_domain = testsys.cpu[i].clk_domain
@@ -487,6 +645,9 @@ def run(options, root, testsys, cpu_class):
                     options.indirect_bp_type)
                 switch_cpus[i].branchPred.indirectBranchPred = \
                     IndirectBPClass()
+            if options.shadow_bp_types:
+                CpuConfig.config_shadow_bp(switch_cpus[i],
+                                           options.shadow_bp_types)
 
         # If elastic tracing is enabled attach the elastic trace probe
         # to the switch CPUs
@@ -496,6 +657,12 @@ def run(options, root, testsys, cpu_class):
         testsys.switch_cpus = switch_cpus
         switch_cpu_list = [(testsys.cpu[i], switch_cpus[i]) for i in range(np)]
 
+        if options.sampling:
+            testsys.sampler = SamplingController(
+                fast_cpus=testsys.cpu, detailed_cpus=switch_cpus,
+                fast_forward_insts=sampling[0], warmup_insts=sampling[1],
+                measure_insts=sampling[2], num_samples=sampling[3])
+
     if options.repeat_switch:
         switch_class = getCPUClass(options.cpu_type)[0]
         if switch_class.require_caches() and \
@@ -604,9 +771,23 @@ def run(options, root, testsys, cpu_class):
             for i in range(np):
                 testsys.cpu[i].max_insts_any_thread = offset
 
-    if options.take_simpoint_checkpoints != None:
+    if options.take_simpoint_checkpoints != None or options.fork_simpoints:
         simpoints, interval_length = parseSimpointAnalysisFile(options, testsys)
 
+    if options.fork_simpoints:
+        # The simulator can't be forked with listeners, e.g. remote
+        # GDB, enabled
+        m5.disableAllListeners()
+
+    # Caches only warm up while the atomic CPUs fast forward
+    warming_caches = []
+    if options.functional_warming:
+        warming_caches = [ obj for obj in testsys.descendants()
+                           if isinstance(obj, BaseCache) ]
+        for cache in warming_caches:
+            cache.functional_warming = True
+            cache.warming = not options.functional_warming_insts
+
     checkpoint_dir = None
     if options.checkpoint_restore:
         cpt_starttick, checkpoint_dir = findCptDir(options, cptdir, testsys)
@@ -655,7 +836,20 @@ def run(options, root, testsys, cpu_class):
         fatal("Bad maxtick (%d) specified: " \
               "Checkpoint starts starts from tick: %d", maxtick, cpt_starttick)
 
-    if options.standard_switch or cpu_class:
+    if options.sampling:
+        print("Taking %d samples" % testsys.sampler.num_samples)
+        exit_event = testsys.sampler.run()
+        if exit_event is None:
+            # All the samples were taken, report them
+            m5.stats.dump()
+            print("Sampling complete @ tick %i" % m5.curTick())
+            return
+    elif options.fork_simpoints:
+        import multiprocessing
+        max_forks = options.max_forks or multiprocessing.cpu_count()
+        forkSimpoints(testsys, switch_cpu_list, simpoints, interval_length,
+                      max_forks)
+    elif options.standard_switch or cpu_class:
         if options.standard_switch:
             print("Switch at instruction count:%s" %
                     str(testsys.cpu[0].max_insts_any_thread))
@@ -664,6 +858,16 @@ def run(options, root, testsys, cpu_class):
             print("Switch at instruction count:%s" %
                     str(testsys.cpu[0].max_insts_any_thread))
             exit_event = m5.simulate()
+            if options.functional_warming_insts:
+                print("Warming caches up @ tick %s" % (m5.curTick()))
+                for cache in warming_caches:
+                    cache.setWarming(True)
+                for i in range(np):
+                    testsys.cpu[i].scheduleInstStop(0,
+                        int(options.fast_forward) -
+                        testsys.cpu[i].max_insts_any_thread,
+                        "max instruction count")
+                exit_event = m5.simulate()
         else:
             print("Switch at curTick count:%s" % str(10000))
             exit_event = m5.simulate(10000)
@@ -712,7 +916,7 @@ def run(options, root, testsys, cpu_class):
     elif options.restore_simpoint_checkpoint != None:
         restoreSimpointCheckpoint()
 
-    else:
+    elif not options.sampling:
         if options.fast_forward:
             m5.stats.reset()
         print("**** REAL SIMULATION ****")
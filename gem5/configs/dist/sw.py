@@ -56,12 +56,30 @@ def build_switch(options):
                                       sync_start = options.dist_sync_start,
                                       sync_repeat = options.dist_sync_repeat,
                                       is_switch = True,
+                                      shm_transport = options.dist_shm,
                                       num_nodes = options.dist_size)
                        for i in range(options.dist_size)]
 
     for (i, link) in enumerate(switch.portlink):
         link.int0 = switch.interface[i]
 
+    # a rack level switch connects to an upper level switch through an
+    # extra port and only synchronises with it every uplink delay
+    if options.dist_uplink_server_name:
+        switch.uplink = DistEtherLink(
+            speed = options.ethernet_linkspeed,
+            delay = options.dist_uplink_delay,
+            dist_rank = options.dist_uplink_rank,
+            dist_size = options.dist_uplink_size,
+            server_name = options.dist_uplink_server_name,
+            server_port = options.dist_uplink_server_port,
+            sync_start = options.dist_sync_start,
+            is_switch = True,
+            is_uplink = True,
+            shm_transport = options.dist_shm,
+            num_nodes = options.dist_size)
+        switch.uplink.int0 = switch.interface[options.dist_size]
+
     return switch
 
 def main():
@@ -69,6 +87,24 @@ def main():
     parser = optparse.OptionParser()
     Options.addCommonOptions(parser)
     Options.addFSOptions(parser)
+    parser.add_option("--dist-uplink-server-name", default="",
+                      action="store", type="string",
+                      help="Upper level switch to connect this switch to "
+                      "(hierarchical sync).")
+    parser.add_option("--dist-uplink-server-port", default=2200,
+                      action="store", type="int",
+                      help="Message server port of the upper level switch.")
+    parser.add_option("--dist-uplink-rank", default=0,
+                      action="store", type="int",
+                      help="Rank of this switch at the upper level switch.")
+    parser.add_option("--dist-uplink-size", default=0,
+                      action="store", type="int",
+                      help="Number of switches connected to the upper "
+                      "level switch.")
+    parser.add_option("--dist-uplink-delay", default="10us",
+                      action="store", type="string",
+                      help="Link delay to the upper level switch, this is "
+                      "also its sync interval.")
     (options, args) = parser.parse_args()
 
     system = build_switch(options)
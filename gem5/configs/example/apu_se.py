@@ -41,7 +41,7 @@ import inspect
 
 import m5
 from m5.objects import *
-from m5.util import addToPath
+from m5.util import addToPath, convert
 
 addToPath('../')
 
@@ -157,6 +157,18 @@ parser.add_option('--fast-forward-pseudo-op', action='store_true',
 parser.add_option('--outOfOrderDataDelivery', action='store_true',
                   default=False, help='enable OoO data delivery in the GM'
                   ' pipeline')
+parser.add_option("--gpu-threads", type="int", default=0,
+                  help="simulate the compute units on this many additional"
+                  " event queues")
+parser.add_option("--gpu-thread-latency", type="int", default=10,
+                  help="latency in GPU cycles of the links crossing between"
+                  " the compute unit event queues and the rest of the GPU")
+parser.add_option("--kernel-samples", type="int", default=0,
+                  help="simulate only this many instances of each kernel and"
+                  " grid size in detail, extrapolate the others")
+parser.add_option("--kernel-resample-period", type="int", default=0,
+                  help="simulate every nth extrapolated kernel instance in"
+                  " detail again")
 
 Ruby.define_options(parser)
 
@@ -353,7 +365,9 @@ for i in range(options.num_cpus):
 ########################## Creating the GPU dispatcher ########################
 # Dispatcher dispatches work from host CPU to GPU
 host_cpu = cpu_list[0]
-dispatcher = GpuDispatcher()
+dispatcher = GpuDispatcher(kernel_samples = options.kernel_samples,
+                           kernel_resample_period = \
+                               options.kernel_resample_period)
 
 ########################## Create and assign the workload ########################
 # Check for rel_path in elements of base_list using test, returning
@@ -439,7 +453,17 @@ if fast_forward:
         fatal("KvmCPU can only be used in SE mode with x86")
 
 # configure the TLB hierarchy
-GPUTLBConfig.config_tlb_hierarchy(options, system, shader_idx)
+if options.gpu_threads:
+    if options.TLB_config not in ("perCU", "perLane"):
+        fatal("--gpu-threads requires a perCU or perLane TLB configuration")
+    shader.remote_cu_latency = options.gpu_thread_latency
+    gpu_period = 1.0 / convert.toFrequency(options.GPUClock)
+    l2_bridge_delay = '%dps' % \
+        (options.gpu_thread_latency * gpu_period * 1e12)
+else:
+    l2_bridge_delay = None
+GPUTLBConfig.config_tlb_hierarchy(options, system, shader_idx,
+                                  l2_bridge_delay)
 
 # create Ruby system
 system.piobus = IOXBar(width=32, response_latency=0,
@@ -529,6 +553,26 @@ else:
 dispatcher.shader_pointer = shader
 dispatcher.cl_driver = driver
 
+# Spread the compute units over the additional event queues. A CU shares
+# its queue with its L1 caches and TLBs, and all the CUs sharing an SQC
+# end up on the same queue.
+if options.gpu_threads:
+    num_groups = min(options.gpu_threads, num_sqc)
+    tlb_per_cu = len(system.l1_tlb) // n_cu
+    for i in range(n_cu):
+        cu = system.cpu[shader_idx].CUs[i]
+        sqc_idx = i // options.cu_per_sqc
+        queue = 1 + sqc_idx * num_groups // num_sqc
+        cu.eventq_index = queue
+        cu.memory_port[0].peer.simobj.get_parent().eventq_index = queue
+        cu.sqc_port.peer.simobj.get_parent().eventq_index = queue
+        for t in range(i * tlb_per_cu, (i + 1) * tlb_per_cu):
+            system.l1_tlb[t].eventq_index = queue
+            system.l1_coalescer[t].eventq_index = queue
+        system.sqc_tlb[sqc_idx].eventq_index = queue
+        system.sqc_coalescer[sqc_idx].eventq_index = queue
+    m5.checkEventQueues()
+
 ########################## Start simulation ########################
 
 root = Root(system=system, full_system=False)
@@ -53,6 +53,7 @@ from m5.objects import *
 m5.util.addToPath("../../")
 
 from common import SysPaths
+from common import CpuConfig
 from common import ObjectList
 from common.cores.arm import ex5_big, ex5_LITTLE
 
@@ -284,15 +285,7 @@ def _build_kvm(system, cpus):
     # has to be done after creating caches and other child objects
     # since these mustn't inherit the CPU event queue.
     if len(cpus) > 1:
-        device_eq = 0
-        first_cpu_eq = 1
-        for idx, cpu in enumerate(cpus):
-            # Child objects usually inherit the parent's event
-            # queue. Override that and use the same event queue for
-            # all devices.
-            for obj in cpu.descendants():
-                obj.eventq_index = device_eq
-            cpu.eventq_index = first_cpu_eq + idx
+        CpuConfig.config_kvm_threads(cpus)
 
 
 
@@ -0,0 +1,64 @@
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+# Replay a branch trace, e.g. written by se.py or fs.py with
+# --branch-trace, on a branch predictor without simulating a CPU, and
+# report its mispredictions per thousand instructions.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+
+parser = optparse.OptionParser(usage="%prog [options] <trace>")
+
+parser.add_option("--bp-type", type="string", default="TAGE_SC_L_64KB",
+                  help="Branch predictor to evaluate [default: %default]")
+parser.add_option("--max-insts", type="int", default=0,
+                  help="Stop after this many instructions, 0 to replay the "
+                  "whole trace [default: %default]")
+
+(options, args) = parser.parse_args()
+
+if len(args) != 1:
+    parser.print_help()
+    sys.exit(1)
+
+root = Root(full_system=False)
+root.replay = BranchTraceReplay(
+    branch_pred=getattr(m5.objects, options.bp_type)(),
+    trace_file=args[0],
+    max_insts=options.max_insts)
+
+m5.instantiate()
+
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
@@ -50,7 +50,7 @@ import sys
 import m5
 from m5.defines import buildEnv
 from m5.objects import *
-from m5.util import addToPath, fatal, warn
+from m5.util import addToPath, fatal, warn, inform
 from m5.util.fdthelper import *
 
 addToPath('../')
@@ -198,10 +198,17 @@ def build_test_system(np):
                 fatal("SimPoint generation should be done with atomic cpu")
             if np > 1:
                 fatal("SimPoint generation not supported with more than one CPUs")
+        if options.branch_trace and \
+           not ObjectList.is_noncaching_cpu(TestCPUClass):
+            fatal("Branch traces can only be written with an atomic cpu")
 
         for i in range(np):
             if options.simpoint_profile:
                 test_sys.cpu[i].addSimPointProbe(options.simpoint_interval)
+            if options.branch_trace:
+                test_sys.cpu[i].addBranchTraceProbe(
+                    options.branch_trace if np == 1 else
+                    "cpu%d.%s" % (i, options.branch_trace))
             if options.checker:
                 test_sys.cpu[i].addCheckerCpu()
             if not ObjectList.is_kvm_cpu(TestCPUClass):
@@ -213,6 +220,9 @@ def build_test_system(np):
                         options.indirect_bp_type)
                     test_sys.cpu[i].branchPred.indirectBranchPred = \
                         IndirectBPClass()
+                if options.shadow_bp_types:
+                    CpuConfig.config_shadow_bp(test_sys.cpu[i],
+                                               options.shadow_bp_types)
             test_sys.cpu[i].createThreads()
 
         # If elastic tracing is enabled when not restoring from checkpoint and
@@ -230,6 +240,11 @@ def build_test_system(np):
 
         MemConfig.config_mem(options, test_sys)
 
+    if options.kvm_threads and np > 1:
+        if not ObjectList.is_kvm_cpu(TestCPUClass):
+            fatal("--kvm-threads requires a KVM CPU")
+        CpuConfig.config_kvm_threads(test_sys.cpu)
+
     return test_sys
 
 def build_drive_system(np):
@@ -354,7 +369,8 @@ elif len(bm) == 1 and options.dist:
                         options.dist_sync_start,
                         options.ethernet_linkspeed,
                         options.ethernet_linkdelay,
-                        options.etherdump);
+                        options.etherdump,
+                        options.dist_shm);
 elif len(bm) == 1:
     root = Root(full_system=True, system=test_sys)
 else:
@@ -364,6 +380,12 @@ else:
 if options.timesync:
     root.time_sync_enable = True
 
+if options.kvm_threads and np > 1:
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(options.sim_quantum))
+    inform("Running %d KVM vCPU threads with a %s simulation quantum",
+           np, options.sim_quantum)
+
 if options.frame_capture:
     VncServer.frame_capture = True
 
@@ -83,6 +83,23 @@ parser.add_option("--inj-vnet", type="int", default=-1,
                         0 and 1 are 1-flit, 2 is 5-flit.\
                         Set to -1 to inject randomly in all vnets.")
 
+parser.add_option("--inj-process", type="choice", default="bernoulli",
+                  choices=['bernoulli', 'geometric', 'on_off', 'trace'],
+                  help="bernoulli checks for an injection every cycle, \
+                        geometric draws the cycles between injections, \
+                        on_off injects in bursts, trace replays \
+                        --trace-file.")
+
+parser.add_option("--on-cycles", type="float", default=100,
+                  help="Mean length of the bursts in cycles (on_off).")
+
+parser.add_option("--off-cycles", type="float", default=900,
+                  help="Mean length of the idle periods in cycles (on_off).")
+
+parser.add_option("--trace-file", type="string", default="",
+                  help="Network trace to replay (trace), one packet per \
+                        line: time (cycles) src dst vnet [size (bytes)].")
+
 #
 # Add the ruby specific and protocol specific options
 #
@@ -110,6 +127,10 @@ cpus = [ GarnetSyntheticTraffic(
                      inj_rate=options.injectionrate,
                      inj_vnet=options.inj_vnet,
                      precision=options.precision,
+                     inj_process=options.inj_process,
+                     on_cycles=options.on_cycles,
+                     off_cycles=options.off_cycles,
+                     trace_file=options.trace_file,
                      num_dest=options.num_dirs) \
          for i in range(options.num_cpus) ]
 
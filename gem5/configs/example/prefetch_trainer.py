@@ -0,0 +1,78 @@
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+# Train a prefetcher on packet traces, e.g. recorded by a MemTraceProbe,
+# without simulating the cache hierarchy, and report its coverage and
+# accuracy.
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+import optparse
+import sys
+
+import m5
+from m5.objects import *
+
+parser = optparse.OptionParser(usage="%prog [options] <trace>...")
+
+parser.add_option("--prefetcher", type="string", default="StridePrefetcher",
+                  help="Prefetcher to train [default: %default]")
+parser.add_option("--block-size", type="int", default=64,
+                  help="Cache line size in bytes [default: %default]")
+parser.add_option("--filter-size", type="int", default=1024,
+                  help="Blocks of the LRU filter approximating the cache "
+                  "[default: %default]")
+parser.add_option("--buffer-size", type="int", default=64,
+                  help="Blocks of the prefetch buffer [default: %default]")
+
+(options, args) = parser.parse_args()
+
+if not args:
+    parser.print_help()
+    sys.exit(1)
+
+system = System(cache_line_size=options.block_size)
+system.clk_domain = SrcClockDomain(clock="1GHz",
+                                   voltage_domain=VoltageDomain())
+
+# The system port has to be connected, nothing is ever sent through it
+system.memory = SimpleMemory(range=AddrRange("1MB"))
+system.system_port = system.memory.port
+
+system.trainer = PrefetchTrainer(
+    prefetcher=getattr(m5.objects, options.prefetcher)(),
+    trace_files=args,
+    filter_size=options.filter_size,
+    buffer_size=options.buffer_size)
+
+root = Root(full_system=False, system=system)
+m5.instantiate()
+
+exit_event = m5.simulate()
+print("Exiting @ tick %i because %s" %
+      (m5.curTick(), exit_event.getCause()))
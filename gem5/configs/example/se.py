@@ -222,6 +222,9 @@ if options.simpoint_profile:
     if np > 1:
         fatal("SimPoint generation not supported with more than one CPUs")
 
+if options.branch_trace and not ObjectList.is_noncaching_cpu(CPUClass):
+    fatal("Branch traces can only be written with an atomic cpu")
+
 for i in range(np):
     if options.smt:
         system.cpu[i].workload = multiprocesses
@@ -233,6 +236,11 @@ for i in range(np):
     if options.simpoint_profile:
         system.cpu[i].addSimPointProbe(options.simpoint_interval)
 
+    if options.branch_trace:
+        system.cpu[i].addBranchTraceProbe(options.branch_trace if np == 1
+                                          else "cpu%d.%s" %
+                                          (i, options.branch_trace))
+
     if options.checker:
         system.cpu[i].addCheckerCpu()
 
@@ -245,6 +253,9 @@ for i in range(np):
             ObjectList.indirect_bp_list.get(options.indirect_bp_type)
         system.cpu[i].branchPred.indirectBranchPred = indirectBPClass()
 
+    if options.shadow_bp_types:
+        CpuConfig.config_shadow_bp(system.cpu[i], options.shadow_bp_types)
+
     system.cpu[i].createThreads()
 
 if options.ruby:
@@ -278,5 +289,21 @@ else:
     MemConfig.config_mem(options, system)
     config_filesystem(system, options)
 
+# Threads of a multi-threaded workload run on separate CPUs. Put each
+# CPU on its own event queue so that they are simulated in parallel.
+# Syscalls run on the queue of the calling CPU, so the memory system
+# must not hold state that the CPUs could race on.
+if options.cpu_threads and np > 1:
+    if CPUClass.memory_mode() != 'atomic' or options.ruby or \
+       options.caches or options.l2cache:
+        fatal("--cpu-threads requires atomic CPUs without caches")
+    CpuConfig.config_cpu_threads(system.cpu)
+
 root = Root(full_system = False, system = system)
+
+if options.cpu_threads and np > 1:
+    root.sim_quantum = m5.ticks.fromSeconds(
+        m5.util.convert.anyToLatency(options.sim_quantum))
+    print("Running %d CPU threads with a %s simulation quantum" %
+          (np, options.sim_quantum))
 Simulation.run(options, root, system, FutureClass)
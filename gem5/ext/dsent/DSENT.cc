@@ -275,12 +275,21 @@ namespace DSENT
     }
 
     Model *initialize(const char *config_file_name, map<String, String> &config)
+    {
+        return initialize(config_file_name, config, map<String, String>());
+    }
+
+    Model *initialize(const char *config_file_name, map<String, String> &config,
+                      const map<String, String> &overrides)
     {
         // Init the log file
         Log::allocate("/tmp/dsent.log");
 
         // Init the config file
         LibUtil::readFile(config_file_name, config);
+        for (const auto &it : overrides) {
+            config[it.first] = it.second;
+        }
 
         // Overwrite the technology file
         TechModel *tech_model = constructTechModel(config);
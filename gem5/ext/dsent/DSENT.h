@@ -59,6 +59,12 @@ namespace DSENT
     Model *initialize(const char *config_file_name,
                       std::map<String, String> &config);
 
+    // Same as above, but the given parameters replace the ones of the
+    // config file before the model is built
+    Model *initialize(const char *config_file_name,
+                      std::map<String, String> &config,
+                      const std::map<String, String> &overrides);
+
     void finalize(std::map<String, String> &config,
                   Model *ms_model);
 
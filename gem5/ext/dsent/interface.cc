@@ -48,8 +48,9 @@ DSENT::Model *ms_model;
 
 
 static PyMethodDef DSENTMethods[] = {
-    {"initialize", dsent_initialize, METH_O,
-     "initialize dsent using a config file."},
+    {"initialize", dsent_initialize, METH_VARARGS,
+     "initialize dsent using a config file, and optionally a dictionary of "
+     "parameters that replace the ones in the file."},
 
     {"finalize", dsent_finalize, METH_NOARGS,
      "finalize dsent by dstroying the config object"},
@@ -81,16 +82,39 @@ initdsent(void)
 
 
 static PyObject *
-dsent_initialize(PyObject *self, PyObject *arg)
+dsent_initialize(PyObject *self, PyObject *args)
 {
-    const char *config_file = PyString_AsString(arg);
+    const char *config_file;
+    PyObject *override_dict = NULL;
     //Read the arguments sent from the python script
-    if (!config_file) {
-        Py_RETURN_NONE;
+    if (!PyArg_ParseTuple(args, "s|O!", &config_file, &PyDict_Type,
+                          &override_dict)) {
+        return NULL;
+    }
+
+    // The model is built with the overridden parameters, so they can
+    // differ from the config file in more than the evaluated formulas
+    map<String, String> overrides;
+    if (override_dict) {
+        PyObject *key, *value;
+        Py_ssize_t pos = 0;
+        while (PyDict_Next(override_dict, &pos, &key, &value)) {
+            PyObject *key_str = PyObject_Str(key);
+            PyObject *value_str = PyObject_Str(value);
+            if (!key_str || !value_str) {
+                Py_XDECREF(key_str);
+                Py_XDECREF(value_str);
+                return NULL;
+            }
+            overrides[PyString_AsString(key_str)] =
+                PyString_AsString(value_str);
+            Py_DECREF(key_str);
+            Py_DECREF(value_str);
+        }
     }
 
     // Initialize DSENT
-    ms_model = DSENT::initialize(config_file, params);
+    ms_model = DSENT::initialize(config_file, params, overrides);
     Py_RETURN_NONE;
 }
 
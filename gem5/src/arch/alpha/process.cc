@@ -77,7 +77,7 @@ AlphaProcess::argsInit(int intSize, int pageSize)
     // Patch the ld_bias for dynamic executables.
     updateBias();
 
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
 
     std::vector<AuxVector<uint64_t>>  auxv;
 
@@ -51,6 +51,8 @@ class ArmTableWalker(ClockedObject):
     is_stage2 =  Param.Bool(False, "Is this object for stage 2 translation?")
     num_squash_per_cycle = Param.Unsigned(2,
             "Number of outstanding walks that can be squashed per cycle")
+    walk_cache_size = Param.Unsigned(0, "Number of table descriptors "
+            "cached per lookup level for AArch64 walks (0 to disable)")
 
     # The port to the memory system. This port is ultimately belonging
     # to the Stage2MMU, and shared by the two table walkers, but we
@@ -66,8 +68,18 @@ class ArmTLB(BaseTLB):
     cxx_header = "arch/arm/tlb.hh"
     sys = Param.System(Parent.any, "system object parameter")
     size = Param.Int(64, "TLB size")
+    assoc = Param.Int(0, "TLB associativity (0 for fully associative)")
     walker = Param.ArmTableWalker(ArmTableWalker(), "HW Table walker")
     is_stage2 = Param.Bool(False, "Is this a stage 2 TLB?")
+    next_level = Param.ArmTLB(NULL, "Next level TLB, looked up on a miss "
+        "before walking the page tables (may be shared by the ITB and DTB)")
+
+# Second level TLB, it only holds entries filled in by the first level TLBs
+# and doesn't walk the page tables itself.
+class ArmL2TLB(ArmTLB):
+    size = 1024
+    assoc = 8
+    walker = NULL
 
 # Stage 2 translation objects, only used when virtualisation is being used
 class ArmStage2TableWalker(ArmTableWalker):
@@ -52,7 +52,41 @@
 namespace ArmISA
 {
 
-GenericISA::BasicDecodeCache Decoder::defaultCache;
+Decoder::InstCache Decoder::defaultCache;
+
+Decoder::InstCache::Table &
+Decoder::InstCache::getTable(uint32_t mode)
+{
+    if (lastTable && mode == lastMode)
+        return *lastTable;
+
+    auto &table = tables[mode];
+    if (!table)
+        table.reset(new Table(TableEntries, Entry{0, nullptr}));
+
+    lastMode = mode;
+    lastTable = table.get();
+    return *lastTable;
+}
+
+StaticInstPtr
+Decoder::InstCache::decode(Decoder *decoder, ExtMachInst mach_inst)
+{
+    Table &table = getTable(mach_inst >> 32);
+    Entry &entry = table[index(mach_inst)];
+    if (entry.inst && entry.machInst == mach_inst)
+        return entry.inst;
+
+    entry.machInst = mach_inst;
+    auto iter = instMap.find(mach_inst);
+    if (iter != instMap.end()) {
+        entry.inst = iter->second;
+    } else {
+        entry.inst = decoder->decodeInst(mach_inst);
+        instMap[mach_inst] = entry.inst;
+    }
+    return entry.inst;
+}
 
 Decoder::Decoder(ISA* isa)
     : data(0), fpscrLen(0), fpscrStride(0),
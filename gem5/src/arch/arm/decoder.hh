@@ -44,11 +44,14 @@
 #define __ARCH_ARM_DECODER_HH__
 
 #include <cassert>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "arch/arm/miscregs.hh"
 #include "arch/arm/types.hh"
-#include "arch/generic/decode_cache.hh"
 #include "base/types.hh"
+#include "cpu/decode_cache.hh"
 #include "cpu/static_inst.hh"
 #include "enums/DecoderFlavour.hh"
 
@@ -59,6 +62,61 @@ class ISA;
 class Decoder
 {
   protected:
+    /**
+     * A cache of decoded instructions split in two levels. The upper
+     * half of an ExtMachInst holds the mode and state bits (instruction
+     * set, ITSTATE, FPSCR and SVE vector length...) which rarely
+     * change, the lower half holds the instruction word. The first
+     * level finds the table of the current mode, remembering the last
+     * one used, and the second one is a direct-mapped table indexed by
+     * the instruction word. A hit therefore only compares the mode with
+     * the previous one and loads the table entry.
+     *
+     * Conflicting instructions fall back to a hash map holding every
+     * instruction decoded so far, so that an instruction is never
+     * decoded twice.
+     */
+    class InstCache
+    {
+      private:
+        /** Number of entries in the table of each mode. */
+        static const unsigned TableEntries = 1024;
+
+        struct Entry
+        {
+            ExtMachInst machInst;
+            StaticInstPtr inst;
+        };
+        typedef std::vector<Entry> Table;
+
+        /** Tables of the modes seen so far */
+        std::unordered_map<uint32_t, std::unique_ptr<Table>> tables;
+
+        /** Mode of the last lookup and its table */
+        uint32_t lastMode;
+        Table *lastTable;
+
+        /** Every instruction decoded so far */
+        DecodeCache::InstMap<ExtMachInst> instMap;
+
+        Table &getTable(uint32_t mode);
+
+        static unsigned
+        index(uint32_t inst_bits)
+        {
+            return (inst_bits ^ (inst_bits >> 10) ^ (inst_bits >> 20)) &
+                (TableEntries - 1);
+        }
+
+      public:
+        InstCache() : lastMode(0), lastTable(nullptr) {}
+
+        /// Decode a machine instruction.
+        /// @param mach_inst The binary instruction to decode.
+        /// @retval A pointer to the corresponding StaticInst object.
+        StaticInstPtr decode(Decoder *decoder, ExtMachInst mach_inst);
+    };
+
     //The extended machine instruction being generated
     ExtMachInst emi;
     MachInst data;
@@ -81,7 +139,7 @@ class Decoder
     Enums::DecoderFlavour decoderFlavour;
 
     /// A cache of decoded instruction objects.
-    static GenericISA::BasicDecodeCache defaultCache;
+    static InstCache defaultCache;
 
     /**
      * Pre-decode an instruction from the current state of the
@@ -172,7 +230,7 @@ class Decoder
      */
     StaticInstPtr decode(ExtMachInst mach_inst, Addr addr)
     {
-        return defaultCache.decode(this, mach_inst, addr);
+        return defaultCache.decode(this, mach_inst);
     }
 
     /**
@@ -28,7 +28,9 @@
 import os
 
 from m5.defines import buildEnv
+from m5.util import convert
 import _m5.arm_fast_model
+import _m5.systemc
 
 def set_armlmd_license_file(force=False):
     '''Set the ARMLMD_LICENSE_FILE environment variable. If "force" is
@@ -128,3 +130,16 @@ def scx_get_min_sync_latency(arg=None):
         return _m5.arm_fast_model.scx_get_min_sync_latency(arg)
     else:
         return _m5.arm_fast_model.scx_get_min_sync_latency()
+
+def set_quantum(quantum):
+    '''Let Fast Model components run ahead of the rest of the simulation
+       by up to "quantum" (a latency like "1us") before synchronizing.
+       Accesses which can't use DMI are then annotated with their delay
+       instead of stopping the model every time, which is much faster at
+       the cost of timing accuracy. This should be called before the
+       simulation is instantiated.'''
+    seconds = convert.toLatency(quantum)
+    sc_time = _m5.systemc.sc_time
+    _m5.systemc.tlm_global_quantum.instance().set(
+            sc_time(seconds, sc_time.SC_SEC))
+    _m5.arm_fast_model.scx_set_min_sync_latency(seconds)
@@ -42,8 +42,11 @@
 
 #include "arch/arm/pmu.hh"
 
+#include <algorithm>
+
 #include "arch/arm/isa.hh"
 #include "arch/arm/utility.hh"
+#include "base/bitfield.hh"
 #include "base/trace.hh"
 #include "cpu/base.hh"
 #include "debug/Checkpoint.hh"
@@ -120,7 +123,7 @@ PMU::addSoftwareIncrementEvent(unsigned int id)
     fatal_if(old_event != eventMap.end(), "An event with id %d has "
              "been previously defined\n", id);
 
-    swIncrementEvent = new SWIncrementEvent();
+    swIncrementEvent = new SWIncrementEvent(*this);
     eventMap[id] = swIncrementEvent;
     registerEvent(id);
 }
@@ -136,7 +139,7 @@ PMU::addEventProbe(unsigned int id, SimObject *obj, const char *probe_name)
     auto event_entry = eventMap.find(id);
     if (event_entry == eventMap.end()) {
 
-        event = new RegularEvent();
+        event = new RegularEvent(*this);
         eventMap[id] = event;
 
     } else {
@@ -448,6 +451,8 @@ PMU::PMUEvent::attachEvent(PMU::CounterState *user)
     if (userCounters.empty()) {
         enable();
     }
+    // Events seen so far belong to the counters already attached
+    updateAttachedCounters();
     userCounters.insert(user);
     updateAttachedCounters();
 }
@@ -455,14 +460,49 @@ PMU::PMUEvent::attachEvent(PMU::CounterState *user)
 void
 PMU::PMUEvent::increment(const uint64_t val)
 {
+    const RegVal context(pmu.filterContext());
+    if (pending && context != pendingContext)
+        updateAttachedCounters();
+
+    if (!pending) {
+        pendingFirst = val;
+        pendingContext = context;
+    }
+    pending += val;
+
+    if (pending > pendingLimit)
+        updateAttachedCounters();
+}
+
+void
+PMU::PMUEvent::updateAttachedCounters()
+{
+    if (!pending) {
+        // The counters may have changed, so the next increment is
+        // applied right away to find out how far they are from an
+        // overflow.
+        pendingLimit = 0;
+        return;
+    }
+
+    // The first increment is applied on its own as a counter drops
+    // the first increment after it has been reset.
+    const uint64_t first(pendingFirst);
+    const uint64_t rest(pending - pendingFirst);
+    pending = 0;
+    pendingLimit = UINT64_MAX;
     for (auto& counter: userCounters) {
-        counter->add(val);
+        uint64_t remaining(counter->add(first, pendingContext));
+        if (rest)
+            remaining = counter->add(rest, pendingContext);
+        pendingLimit = std::min(pendingLimit, remaining);
     }
 }
 
 void
 PMU::PMUEvent::detachEvent(PMU::CounterState *user)
 {
+    updateAttachedCounters();
     userCounters.erase(user);
 
     if (userCounters.empty()) {
@@ -491,14 +531,24 @@ PMU::RegularEvent::disable()
     attachedProbePointList.clear();
 }
 
-bool
-PMU::CounterState::isFiltered() const
+RegVal
+PMU::filterContext() const
 {
-    assert(pmu.isa);
+    assert(isa);
+
+    const SCR scr(isa->readMiscRegNoEffect(MISCREG_SCR));
+    const CPSR cpsr(isa->readMiscRegNoEffect(MISCREG_CPSR));
+    return (RegVal)cpsr.mode | ((RegVal)scr.ns << 5);
+}
 
+bool
+PMU::CounterState::isFiltered(RegVal context) const
+{
     const PMEVTYPER_t filter(this->filter);
-    const SCR scr(pmu.isa->readMiscRegNoEffect(MISCREG_SCR));
-    const CPSR cpsr(pmu.isa->readMiscRegNoEffect(MISCREG_CPSR));
+    SCR scr = 0;
+    scr.ns = bits(context, 5);
+    CPSR cpsr = 0;
+    cpsr.mode = bits(context, 4, 0);
     const ExceptionLevel el(currEL(cpsr));
     const bool secure(inSecureState(scr, cpsr));
 
@@ -558,6 +608,9 @@ PMU::CounterState::getValue() const
 void
 PMU::CounterState::setValue(uint64_t val)
 {
+    // Pending increments predate the new value
+    sync();
+
     value = val;
     resetValue = true;
 
@@ -569,6 +622,13 @@ PMU::CounterState::setValue(uint64_t val)
     }
 }
 
+void
+PMU::CounterState::sync() const
+{
+    if (sourceEvent)
+        sourceEvent->updateAttachedCounters();
+}
+
 void
 PMU::updateCounter(CounterState &ctr)
 {
@@ -639,6 +699,7 @@ PMU::setCounterTypeRegister(CounterId id, PMEVTYPER_t val)
     CounterState &ctr(getCounter(id));
     const EventTypeId old_event_id(ctr.eventId);
 
+    ctr.sync();
     ctr.filter = val;
 
     // If PMCCNTR Register, do not change event type. PMCCNTR can
@@ -752,6 +813,8 @@ PMU::getEvent(uint64_t eventId)
 void
 PMU::CounterState::serialize(CheckpointOut &cp) const
 {
+    sync();
+
     SERIALIZE_SCALAR(eventId);
     SERIALIZE_SCALAR(value);
     SERIALIZE_SCALAR(overflow64);
@@ -763,10 +826,12 @@ PMU::CounterState::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(eventId);
     UNSERIALIZE_SCALAR(value);
     UNSERIALIZE_SCALAR(overflow64);
+
+    sync();
 }
 
 uint64_t
-PMU::CounterState::add(uint64_t delta)
+PMU::CounterState::add(uint64_t delta, RegVal context)
 {
     uint64_t value_until_overflow;
     if (overflow64) {
@@ -775,7 +840,7 @@ PMU::CounterState::add(uint64_t delta)
         value_until_overflow = UINT32_MAX - (uint32_t)value;
     }
 
-    if (isFiltered())
+    if (isFiltered(context))
         return value_until_overflow;
 
     if (resetValue) {
@@ -796,9 +861,11 @@ PMU::CounterState::add(uint64_t delta)
         if (pmu.reg_pminten  & (1 << counterId)) {
             pmu.raiseInterrupt();
         }
-        return overflow64 ? UINT64_MAX : UINT32_MAX;
+
+        // The counter wrapped around
+        return overflow64 ? UINT64_MAX - value : UINT32_MAX - (uint32_t)value;
     }
-    return value_until_overflow - delta + 1;
+    return value_until_overflow - delta;
 }
 
 void
@@ -806,7 +873,7 @@ PMU::SWIncrementEvent::write(uint64_t val)
 {
     for (auto& counter: userCounters) {
         if (val & (0x1 << counter->getCounterId())) {
-            counter->add(1);
+            counter->add(1, pmu.filterContext());
         }
     }
 }
@@ -294,7 +294,9 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
      */
     struct PMUEvent {
 
-        PMUEvent() {}
+        PMUEvent(PMU &_pmu)
+            : pmu(_pmu), pending(0), pendingFirst(0), pendingLimit(0),
+              pendingContext(0) {}
 
         virtual ~PMUEvent() {}
 
@@ -316,6 +318,10 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
          * notify an event increment of val units, all the attached counters'
          * value is incremented by val units.
          *
+         * Increments are accumulated and only applied to the counters
+         * when they are accessed, when the filtering context changes or
+         * when the accumulated value could overflow one of them.
+         *
          * @param the quantity by which to increment the attached counter
          * values
          */
@@ -335,17 +341,37 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
          *  Method called immediately before a counter access in order for
          *  the associated event to update its state (if required)
          */
-        virtual void updateAttachedCounters() {}
+        virtual void updateAttachedCounters();
 
       protected:
 
+        /** PMU this event belongs to */
+        PMU &pmu;
+
         /** set of counters using this event  **/
         std::set<PMU::CounterState*> userCounters;
+
+        /** Increments not yet applied to the attached counters */
+        uint64_t pending;
+
+        /** First increment included in pending */
+        uint64_t pendingFirst;
+
+        /**
+         * Number of events that can be accumulated before one of the
+         * attached counters may overflow
+         */
+        uint64_t pendingLimit;
+
+        /** Filtering context the pending increments were counted in */
+        RegVal pendingContext;
     };
 
     struct RegularEvent : public PMUEvent {
         typedef std::pair<SimObject*, std::string> EventTypeEntry;
 
+        RegularEvent(PMU &_pmu) : PMUEvent(_pmu) {}
+
         void addMicroarchitectureProbe(SimObject* object,
             std::string name) {
 
@@ -390,6 +416,7 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
         void disable() override {}
 
       public:
+        SWIncrementEvent(PMU &_pmu) : PMUEvent(_pmu) {}
 
         /**
          * write on the sw increment register inducing an increment of the
@@ -423,11 +450,19 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
          * Add an event count to the counter and check for overflow.
          *
          * @param delta Number of events to add to the counter.
-         * @return the quantity remaining until a counter overflow occurs.
+         * @param context Filtering context the events were counted in.
+         * @return the number of events the counter can take before it
+         * overflows.
          */
-        uint64_t add(uint64_t delta);
+        uint64_t add(uint64_t delta, RegVal context);
 
-        bool isFiltered() const;
+        /**
+         * Check if the counter's filter excludes a given context.
+         *
+         * @param context Filtering context as returned by
+         * PMU::filterContext().
+         */
+        bool isFiltered(RegVal context) const;
 
         /**
          * Detach the counter from its event
@@ -464,6 +499,11 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
          */
         void setValue(uint64_t val);
 
+        /**
+         * Apply the increments the counter's event has accumulated
+         */
+        void sync() const;
+
       public: /* Serializable state */
         /** Counter event ID */
         EventTypeId eventId;
@@ -560,6 +600,12 @@ class PMU : public SimObject, public ArmISA::BaseISADevice {
      */
     bool isFiltered(const CounterState &ctr) const;
 
+    /**
+     * Get the state counter filtering depends on: the current
+     * operating mode and security state of the PE.
+     */
+    RegVal filterContext() const;
+
     /**
      * Call updateCounter() for each counter in the PMU if the
      * counter's state has changed..
@@ -270,7 +270,7 @@ ArmProcess::argsInit(int pageSize, IntRegIndex spIndex)
     updateBias();
 
     // load object file into target memory
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
 
     //Setup the auxilliary vectors. These will already have endian conversion.
     //Auxilliary vectors are loaded only for elf formatted executables.
@@ -39,6 +39,7 @@
  */
 #include "arch/arm/table_walker.hh"
 
+#include <algorithm>
 #include <memory>
 
 #include "arch/arm/faults.hh"
@@ -62,6 +63,7 @@ TableWalker::TableWalker(const Params *p)
       isStage2(p->is_stage2), tlb(NULL),
       currState(NULL), pending(false),
       numSquashable(p->num_squash_per_cycle),
+      walkCacheSize(p->walk_cache_size),
       pendingReqs(0),
       pendingChangeTick(curTick()),
       doL1DescEvent([this]{ doL1DescriptorWrapper(); }, name()),
@@ -91,6 +93,8 @@ TableWalker::TableWalker(const Params *p)
         physAddrRange = 32;
     }
 
+    for (auto &level : walkCache)
+        level.resize(walkCacheSize);
 }
 
 TableWalker::~TableWalker()
@@ -135,7 +139,7 @@ TableWalker::WalkerState::WalkerState() :
     htcr(0), hcr(0), vtcr(0),
     isWrite(false), isFetch(false), isSecure(false),
     secureLookup(false), rwTable(false), userTable(false), xnTable(false),
-    pxnTable(false), hpd(false), stage2Req(false),
+    pxnTable(false), hpd(false), ttbr(0), tsz(0), stage2Req(false),
     stage2Tran(nullptr), timing(false), functional(false),
     mode(BaseTLB::Read), tranType(TLB::NormalTran), l2Desc(l1Desc),
     delayed(false), tableWalker(nullptr)
@@ -977,6 +981,42 @@ TableWalker::processWalkAArch64()
         (bits(currState->vaddr, tsz - 1,
               stride * (3 - start_lookup_level) + tg) << 3);
 
+    // Skip the levels whose table descriptors are in the walk cache,
+    // starting from the deepest one
+    currState->ttbr = ttbr;
+    currState->tsz = tsz;
+    if (walkCacheSize) {
+        WalkCacheEntry *wce = NULL;
+        int L = L2;
+        for (; L >= start_lookup_level; --L) {
+            wce = lookupWalkCache((LookupLevel)L, tg);
+            if (wce)
+                break;
+        }
+
+        if (wce) {
+            LongDescriptor desc;
+            desc.data = wce->data;
+            desc.aarch64 = true;
+            desc.grainSize = tg;
+            desc.lookupLevel = (LookupLevel)L;
+            desc_addr = desc.nextDescAddr(currState->vaddr);
+            start_lookup_level = (LookupLevel)(desc.lookupLevel + 1);
+
+            currState->secureLookup = wce->secureLookup;
+            currState->rwTable = wce->rwTable;
+            currState->userTable = wce->userTable;
+            currState->xnTable = wce->xnTable;
+            currState->pxnTable = wce->pxnTable;
+
+            DPRINTF(TLB, "Walk cache hit, starting at L%d descriptor %#x\n",
+                    start_lookup_level, desc_addr);
+            statWalkCacheHits++;
+        } else {
+            statWalkCacheMisses++;
+        }
+    }
+
     // Trickbox address check
     Fault f = testWalk(desc_addr, sizeof(uint64_t),
                        TlbEntry::DomainType::NoAccess, start_lookup_level);
@@ -998,7 +1038,7 @@ TableWalker::processWalkAArch64()
         flag.set(Request::UNCACHEABLE);
     }
 
-    if (currState->isSecure) {
+    if (currState->secureLookup) {
         flag.set(Request::SECURE);
     }
 
@@ -1697,6 +1737,9 @@ TableWalker::doLongDescriptor()
                 return;
             }
 
+            if (currState->aarch64 && walkCacheSize)
+                insertWalkCache(currState->longDesc);
+
             Request::Flags flag = Request::PT_WALK;
             if (currState->secureLookup)
                 flag.set(Request::SECURE);
@@ -2126,6 +2169,69 @@ ArmTableWalkerParams::create()
     return new ArmISA::TableWalker(this);
 }
 
+Addr
+TableWalker::walkCacheTag(Addr va, LookupLevel lookup_level, GrainSize tg)
+{
+    const int stride = tg - 3;
+    return va >> (stride * (3 - lookup_level) + tg);
+}
+
+TableWalker::WalkCacheEntry *
+TableWalker::lookupWalkCache(LookupLevel lookup_level, GrainSize tg)
+{
+    std::vector<WalkCacheEntry> &entries = walkCache[lookup_level];
+    const Addr va_tag = walkCacheTag(currState->vaddr, lookup_level, tg);
+
+    for (auto it = entries.begin(); it != entries.end(); ++it) {
+        if (it->valid && it->vaTag == va_tag &&
+            it->ttbr == currState->ttbr && it->tsz == currState->tsz &&
+            it->grainSize == tg && it->vmid == currState->vmid &&
+            it->el == currState->el && it->isSecure == currState->isSecure) {
+            // Move the hit entry to the MRU position
+            WalkCacheEntry hit = *it;
+            std::copy_backward(entries.begin(), it, it + 1);
+            entries.front() = hit;
+            return &entries.front();
+        }
+    }
+    return NULL;
+}
+
+void
+TableWalker::insertWalkCache(const LongDescriptor &desc)
+{
+    std::vector<WalkCacheEntry> &entries = walkCache[desc.lookupLevel];
+
+    // Evict the LRU entry
+    std::copy_backward(entries.begin(), entries.end() - 1, entries.end());
+
+    WalkCacheEntry &wce = entries.front();
+    wce.valid = true;
+    wce.ttbr = currState->ttbr;
+    wce.tsz = currState->tsz;
+    wce.grainSize = desc.grainSize;
+    wce.vmid = currState->vmid;
+    wce.el = currState->el;
+    wce.isSecure = currState->isSecure;
+    wce.vaTag = walkCacheTag(currState->vaddr, desc.lookupLevel,
+                             desc.grainSize);
+    wce.data = desc.data;
+    wce.secureLookup = currState->secureLookup;
+    wce.rwTable = currState->rwTable;
+    wce.userTable = currState->userTable;
+    wce.xnTable = currState->xnTable;
+    wce.pxnTable = currState->pxnTable;
+}
+
+void
+TableWalker::flushWalkCache()
+{
+    for (auto &level : walkCache) {
+        for (auto &wce : level)
+            wce.valid = false;
+    }
+}
+
 LookupLevel
 TableWalker::toLookupLevel(uint8_t lookup_level_as_int)
 {
@@ -2244,6 +2350,18 @@ TableWalker::regStats()
         .flags(Stats::nozero)
         ;
 
+    statWalkCacheHits
+        .name(name() + ".walkCacheHits")
+        .desc("Table walks that skipped levels through the walk cache")
+        .flags(Stats::nozero)
+        ;
+
+    statWalkCacheMisses
+        .name(name() + ".walkCacheMisses")
+        .desc("Table walks that missed in the walk cache")
+        .flags(Stats::nozero)
+        ;
+
     statWalkWaitTime
         .init(16)
         .name(name() + ".walkWaitTime")
@@ -767,6 +767,11 @@ class TableWalker : public ClockedObject
         /** Hierarchical access permission disable */
         bool hpd;
 
+        /** Translation table base register and input address size of an
+         * AArch64 walk, these identify the tables in the walk cache */
+        Addr ttbr;
+        int tsz;
+
         /** Flag indicating if a second stage of lookup is required */
         bool stage2Req;
 
@@ -850,6 +855,39 @@ class TableWalker : public ClockedObject
      * removed from the pendingQueue per cycle. */
     unsigned numSquashable;
 
+    /**
+     * Walk cache entry, a table descriptor that was read during an
+     * AArch64 walk. A hit lets a later walk for the same region start at
+     * the next level.
+     */
+    struct WalkCacheEntry
+    {
+        bool valid;
+        Addr ttbr;
+        int tsz;
+        GrainSize grainSize;
+        uint8_t vmid;
+        ExceptionLevel el;
+        bool isSecure;
+        /** Virtual address bits above the region the table maps */
+        Addr vaTag;
+        /** Table descriptor */
+        uint64_t data;
+        /** Hierarchical permissions including this descriptor */
+        bool secureLookup;
+        bool rwTable;
+        bool userTable;
+        bool xnTable;
+        bool pxnTable;
+
+        WalkCacheEntry() : valid(false) {}
+    };
+
+    /** Number of walk cache entries per lookup level */
+    const unsigned walkCacheSize;
+    /** Walk cache per lookup level, most recently used entry first */
+    std::vector<WalkCacheEntry> walkCache[MAX_LOOKUP_LEVELS];
+
     /** Cached copies of system-level properties */
     bool haveSecurity;
     bool _haveLPAE;
@@ -865,6 +903,8 @@ class TableWalker : public ClockedObject
     Stats::Vector statWalksLongTerminatedAtLevel;
     Stats::Scalar statSquashedBefore;
     Stats::Scalar statSquashedAfter;
+    Stats::Scalar statWalkCacheHits;
+    Stats::Scalar statWalkCacheMisses;
     Stats::Histogram statWalkWaitTime;
     Stats::Histogram statWalkServiceTime;
     Stats::Histogram statPendingWalks; // essentially "L" of queueing theory
@@ -909,6 +949,9 @@ class TableWalker : public ClockedObject
                bool timing, bool functional, bool secure,
                TLB::ArmTranslationType tranType, bool _stage2Req);
 
+    /** Drop all cached table descriptors, called on TLB maintenance */
+    void flushWalkCache();
+
     void setTlb(TLB *_tlb) { tlb = _tlb; }
     TLB* getTlb() { return tlb; }
     void setMMU(Stage2MMU *m, MasterID master_id);
@@ -969,6 +1012,16 @@ class TableWalker : public ClockedObject
 
     static uint8_t pageSizeNtoStatBin(uint8_t N);
 
+    /** Virtual address bits above the region mapped by a table descriptor
+     * at the given lookup level */
+    static Addr walkCacheTag(Addr va, LookupLevel lookup_level,
+                             GrainSize tg);
+    /** Find the table descriptor for the current walk at a lookup level */
+    WalkCacheEntry *lookupWalkCache(LookupLevel lookup_level,
+                                    GrainSize tg);
+    /** Remember the table descriptor the current walk has just read */
+    void insertWalkCache(const LongDescriptor &desc);
+
     Fault testWalk(Addr pa, Addr size, TlbEntry::DomainType domain,
                    LookupLevel lookup_level);
 };
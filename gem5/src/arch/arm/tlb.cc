@@ -75,24 +75,40 @@ using namespace ArmISA;
 
 TLB::TLB(const ArmTLBParams *p)
     : BaseTLB(p), table(new TlbEntry[p->size]), size(p->size),
+      assoc(p->assoc ? p->assoc : p->size), numSets(size / assoc),
+      shiftCount(64, 0), pageShifts(0),
       isStage2(p->is_stage2), stage2Req(false), stage2DescReq(false), _attr(0),
       directToStage2(false), tableWalker(p->walker), stage2Tlb(NULL),
-      stage2Mmu(NULL), test(nullptr), rangeMRU(1),
+      stage2Mmu(NULL), nextLevel(p->next_level), test(nullptr), rangeMRU(1),
       aarch64(false), aarch64EL(EL0), isPriv(false), isSecure(false),
       isHyp(false), asid(0), vmid(0), hcr(0), dacr(0),
       miscRegValid(false), miscRegContext(0), curTranType(NormalTran)
 {
     const ArmSystem *sys = dynamic_cast<const ArmSystem *>(p->sys);
 
-    tableWalker->setTlb(this);
+    fatal_if(size % assoc, "%s: TLB size %d isn't a multiple of the "
+             "associativity %d\n", name(), size, assoc);
 
-    // Cache system-level properties
-    haveLPAE = tableWalker->haveLPAE();
-    haveVirtualization = tableWalker->haveVirtualization();
-    haveLargeAsid64 = tableWalker->haveLargeAsid64();
+    // A next level TLB is only filled by the TLBs in front of it and
+    // doesn't have a walker of its own
+    if (tableWalker) {
+        tableWalker->setTlb(this);
+
+        // Cache system-level properties
+        haveLPAE = tableWalker->haveLPAE();
+        haveVirtualization = tableWalker->haveVirtualization();
+        haveLargeAsid64 = tableWalker->haveLargeAsid64();
+    } else {
+        haveLPAE = false;
+        haveVirtualization = false;
+        haveLargeAsid64 = false;
+    }
 
     if (sys)
         m5opRange = sys->m5opRange();
+
+    // Let functional accesses cache translations
+    newGeneration();
 }
 
 TLB::~TLB()
@@ -155,26 +171,17 @@ TLB::lookup(Addr va, uint16_t asn, uint8_t vmid, bool hyp, bool secure,
 
     TlbEntry *retval = NULL;
 
-    // Maintaining LRU array
-    int x = 0;
-    while (retval == NULL && x < size) {
-        if ((!ignore_asn && table[x].match(va, asn, vmid, hyp, secure, false,
-             target_el)) ||
-            (ignore_asn && table[x].match(va, vmid, hyp, secure, target_el))) {
-            // We only move the hit entry ahead when the position is higher
-            // than rangeMRU
-            if (x > rangeMRU && !functional) {
-                TlbEntry tmp_entry = table[x];
-                for (int i = x; i > 0; i--)
-                    table[i] = table[i - 1];
-                table[0] = tmp_entry;
-                retval = &table[0];
-            } else {
-                retval = &table[x];
-            }
-            break;
+    if (numSets == 1) {
+        retval = lookupSet(0, va, asn, vmid, hyp, secure, functional,
+                           ignore_asn, target_el);
+    } else {
+        // Probe the set the address maps to for every page size in use
+        for (uint64_t shifts = pageShifts; shifts && !retval;
+             shifts &= shifts - 1) {
+            const int shift = findLsbSet(shifts);
+            retval = lookupSet(setIndex(va >> shift), va, asn, vmid, hyp,
+                               secure, functional, ignore_asn, target_el);
         }
-        ++x;
     }
 
     DPRINTF(TLBVerbose, "Lookup %#x, asn %#x -> %s vmn 0x%x hyp %d secure %d "
@@ -190,6 +197,85 @@ TLB::lookup(Addr va, uint16_t asn, uint8_t vmid, bool hyp, bool secure,
     return retval;
 }
 
+TlbEntry*
+TLB::lookupSet(int set, Addr va, uint16_t asn, uint8_t vmid, bool hyp,
+               bool secure, bool functional, bool ignore_asn,
+               ExceptionLevel target_el)
+{
+    // Maintaining LRU array
+    TlbEntry *ways = &table[set * assoc];
+    for (int x = 0; x < assoc; ++x) {
+        if ((!ignore_asn && ways[x].match(va, asn, vmid, hyp, secure, false,
+             target_el)) ||
+            (ignore_asn && ways[x].match(va, vmid, hyp, secure, target_el))) {
+            // We only move the hit entry ahead when the position is higher
+            // than rangeMRU
+            if (x > rangeMRU && !functional) {
+                TlbEntry tmp_entry = ways[x];
+                for (int i = x; i > 0; i--)
+                    ways[i] = ways[i - 1];
+                ways[0] = tmp_entry;
+                return &ways[0];
+            } else {
+                return &ways[x];
+            }
+        }
+    }
+    return NULL;
+}
+
+TlbEntry*
+TLB::place(const TlbEntry &entry)
+{
+    TlbEntry *ways = &table[setIndex(entry.vpn) * assoc];
+    TlbEntry &victim = ways[assoc - 1];
+
+    if (victim.valid) {
+        DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
+                "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
+                victim.vpn << victim.N, victim.asid, victim.vmid,
+                victim.pfn << victim.N, victim.size, victim.ap, victim.ns,
+                victim.nstid, victim.global, victim.isHyp, victim.el);
+        removePageShift(victim.N);
+    }
+
+    //inserting to MRU position and evicting the LRU one
+
+    for (int i = assoc - 1; i > 0; --i)
+        ways[i] = ways[i-1];
+    ways[0] = entry;
+
+    if (entry.valid)
+        addPageShift(entry.N);
+
+    return &ways[0];
+}
+
+void
+TLB::invalidate(TlbEntry *te)
+{
+    DPRINTF(TLB, " -  %s\n", te->print());
+    te->valid = false;
+    removePageShift(te->N);
+    flushedEntries++;
+}
+
+void
+TLB::addPageShift(uint8_t shift)
+{
+    assert(shift < shiftCount.size());
+    if (shiftCount[shift]++ == 0)
+        pageShifts |= ULL(1) << shift;
+}
+
+void
+TLB::removePageShift(uint8_t shift)
+{
+    assert(shiftCount[shift] > 0);
+    if (--shiftCount[shift] == 0)
+        pageShifts &= ~(ULL(1) << shift);
+}
+
 // insert a new TLB entry
 void
 TLB::insert(Addr addr, TlbEntry &entry)
@@ -202,23 +288,15 @@ TLB::insert(Addr addr, TlbEntry &entry)
             entry.ap, static_cast<uint8_t>(entry.domain), entry.ns, entry.nstid,
             entry.isHyp);
 
-    if (table[size - 1].valid)
-        DPRINTF(TLB, " - Replacing Valid entry %#x, asn %d vmn %d ppn %#x "
-                "size: %#x ap:%d ns:%d nstid:%d g:%d isHyp:%d el: %d\n",
-                table[size-1].vpn << table[size-1].N, table[size-1].asid,
-                table[size-1].vmid, table[size-1].pfn << table[size-1].N,
-                table[size-1].size, table[size-1].ap, table[size-1].ns,
-                table[size-1].nstid, table[size-1].global, table[size-1].isHyp,
-                table[size-1].el);
-
-    //inserting to MRU position and evicting the LRU one
-
-    for (int i = size - 1; i > 0; --i)
-        table[i] = table[i-1];
-    table[0] = entry;
+    place(entry);
 
     inserts++;
     ppRefills->notify(1);
+
+    // Keep the next level inclusive so that the other TLBs sharing it can
+    // find the entry
+    if (nextLevel)
+        nextLevel->insert(addr, entry);
 }
 
 void
@@ -250,21 +328,26 @@ TLB::flushAllSecurity(bool secure_lookup, ExceptionLevel target_el,
 
         if (te->valid && secure_lookup == !te->nstid &&
             (te->vmid == vmid || secure_lookup) && el_match) {
-
-            DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
-            flushedEntries++;
+            invalidate(te);
         }
         ++x;
     }
 
     flushTlb++;
+    newGeneration();
+    if (tableWalker)
+        tableWalker->flushWalkCache();
 
     // If there's a second stage TLB (and we're not it) then flush it as well
     // if we're currently in hyp mode
-    if (!isStage2 && isHyp) {
+    if (!isStage2 && isHyp && stage2Tlb) {
         stage2Tlb->flushAllSecurity(secure_lookup, EL1, true);
     }
+
+    if (nextLevel) {
+        nextLevel->vmid = vmid;
+        nextLevel->flushAllSecurity(secure_lookup, target_el, ignore_el);
+    }
 }
 
 void
@@ -282,20 +365,23 @@ TLB::flushAllNs(ExceptionLevel target_el, bool ignore_el)
             true : te->checkELMatch(target_el);
 
         if (te->valid && te->nstid && te->isHyp == hyp && el_match) {
-
-            DPRINTF(TLB, " -  %s\n", te->print());
-            flushedEntries++;
-            te->valid = false;
+            invalidate(te);
         }
         ++x;
     }
 
     flushTlb++;
+    newGeneration();
+    if (tableWalker)
+        tableWalker->flushWalkCache();
 
     // If there's a second stage TLB (and we're not it) then flush it as well
-    if (!isStage2 && !hyp) {
+    if (!isStage2 && !hyp && stage2Tlb) {
         stage2Tlb->flushAllNs(EL1, true);
     }
+
+    if (nextLevel)
+        nextLevel->flushAllNs(target_el, ignore_el);
 }
 
 void
@@ -323,14 +409,19 @@ TLB::flushAsid(uint64_t asn, bool secure_lookup, ExceptionLevel target_el)
         if (te->valid && te->asid == asn && secure_lookup == !te->nstid &&
             (te->vmid == vmid || secure_lookup) &&
             te->checkELMatch(target_el)) {
-
-            te->valid = false;
-            DPRINTF(TLB, " -  %s\n", te->print());
-            flushedEntries++;
+            invalidate(te);
         }
         ++x;
     }
     flushTlbAsid++;
+    newGeneration();
+    if (tableWalker)
+        tableWalker->flushWalkCache();
+
+    if (nextLevel) {
+        nextLevel->vmid = vmid;
+        nextLevel->flushAsid(asn, secure_lookup, target_el);
+    }
 }
 
 void
@@ -355,14 +446,22 @@ TLB::_flushMva(Addr mva, uint64_t asn, bool secure_lookup,
     te = lookup(mva, asn, vmid, hyp, secure_lookup, false, ignore_asn,
                 target_el);
     while (te != NULL) {
-        if (secure_lookup == !te->nstid) {
-            DPRINTF(TLB, " -  %s\n", te->print());
-            te->valid = false;
-            flushedEntries++;
-        }
+        if (secure_lookup == !te->nstid)
+            invalidate(te);
         te = lookup(mva, asn, vmid, hyp, secure_lookup, false, ignore_asn,
                     target_el);
     }
+
+    newGeneration();
+
+    // The walk cache isn't indexed by page, drop all of it
+    if (tableWalker)
+        tableWalker->flushWalkCache();
+
+    if (nextLevel) {
+        nextLevel->vmid = vmid;
+        nextLevel->_flushMva(mva, asn, secure_lookup, ignore_asn, target_el);
+    }
 }
 
 void
@@ -370,6 +469,9 @@ TLB::flushIpaVmid(Addr ipa, bool secure_lookup, ExceptionLevel target_el)
 {
     assert(!isStage2);
     stage2Tlb->_flushMva(ipa, 0xbeef, secure_lookup, true, target_el);
+
+    // Our translations go through the stage 2 ones
+    newGeneration();
 }
 
 void
@@ -434,8 +536,20 @@ TLB::unserialize(CheckpointIn &cp)
 
     int num_entries;
     UNSERIALIZE_SCALAR(num_entries);
-    for (int i = 0; i < min(size, num_entries); i++)
-        table[i].unserializeSection(cp, csprintf("TlbEntry%d", i));
+    vector<TlbEntry> entries(num_entries);
+    for (int i = 0; i < num_entries; i++)
+        entries[i].unserializeSection(cp, csprintf("TlbEntry%d", i));
+
+    // Re-insert the entries from the LRU end so that their order is kept
+    // even if the geometry of the TLB has changed
+    for (int i = 0; i < size; i++)
+        table[i] = TlbEntry();
+    fill(shiftCount.begin(), shiftCount.end(), 0);
+    pageShifts = 0;
+    for (int i = num_entries - 1; i >= 0; i--) {
+        if (entries[i].valid)
+            place(entries[i]);
+    }
 }
 
 void
@@ -527,6 +641,11 @@ TLB::regStats()
         .desc("Number of entries that have been flushed from TLB")
         ;
 
+    nextLevelHits
+        .name(name() + ".next_level_hits")
+        .desc("Number of misses served by the next level TLB")
+        ;
+
     alignFaults
         .name(name() + ".align_faults")
         .desc("Number of TLB faults due to alignment restrictions")
@@ -1470,6 +1589,30 @@ TLB::getTE(TlbEntry **te, const RequestPtr &req, ThreadContext *tc, Mode mode,
         vaddr = vaddr_tainted;
     }
     *te = lookup(vaddr, asid, vmid, isHyp, is_secure, false, false, target_el);
+    if (*te == NULL && nextLevel) {
+        TlbEntry *next_te = nextLevel->lookup(vaddr, asid, vmid, isHyp,
+                                              is_secure, functional, false,
+                                              target_el);
+        if (next_te) {
+            if (is_fetch)
+                instMisses++;
+            else if (is_write)
+                writeMisses++;
+            else
+                readMisses++;
+            nextLevelHits++;
+
+            // Refill from the next level instead of walking the tables
+            if (functional) {
+                *te = next_te;
+            } else {
+                *te = place(*next_te);
+                inserts++;
+                ppRefills->notify(1);
+            }
+            return NoFault;
+        }
+    }
     if (*te == NULL) {
         if (req->isPrefetch()) {
             // if the request is a prefetch don't attempt to fill the TLB or go
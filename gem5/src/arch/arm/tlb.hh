@@ -44,6 +44,8 @@
 #define __ARCH_ARM_TLB_HH__
 
 
+#include <vector>
+
 #include "arch/arm/isa_traits.hh"
 #include "arch/arm/pagetable.hh"
 #include "arch/arm/utility.hh"
@@ -150,6 +152,13 @@ class TLB : public BaseTLB
   protected:
     TlbEntry* table;     // the Page Table
     int size;            // TLB Size
+    int assoc;           // Ways per set (size if fully associative)
+    int numSets;         // Number of sets
+    // Number of valid entries per page size (log2), an entry is kept in the
+    // set selected by its virtual page number so a lookup has to probe the
+    // set of each page size in use
+    std::vector<unsigned> shiftCount;
+    uint64_t pageShifts; // Page sizes (log2) with valid entries
     bool isStage2;       // Indicates this TLB is part of the second stage MMU
     bool stage2Req;      // Indicates whether a stage 2 lookup is also required
     // Indicates whether a stage 2 lookup of the table descriptors is required.
@@ -163,6 +172,7 @@ class TLB : public BaseTLB
     TableWalker *tableWalker;
     TLB *stage2Tlb;
     Stage2MMU *stage2Mmu;
+    TLB *nextLevel;      // Next level TLB, may be shared by several TLBs
 
     TlbTestInterface *test;
 
@@ -174,6 +184,7 @@ class TLB : public BaseTLB
     mutable Stats::Scalar writeHits;
     mutable Stats::Scalar writeMisses;
     mutable Stats::Scalar inserts;
+    mutable Stats::Scalar nextLevelHits;
     mutable Stats::Scalar flushTlb;
     mutable Stats::Scalar flushTlbMva;
     mutable Stats::Scalar flushTlbMvaAsid;
@@ -443,7 +454,13 @@ public:
     {
         return dynamic_cast<const Params *>(_params);
     }
-    inline void invalidateMiscReg() { miscRegValid = false; }
+    inline void
+    invalidateMiscReg()
+    {
+        // The translation context may have changed
+        miscRegValid = false;
+        newGeneration();
+    }
 
 private:
     /** Remove any entries that match both a va and asn
@@ -455,6 +472,29 @@ private:
     void _flushMva(Addr mva, uint64_t asn, bool secure_lookup,
                    bool ignore_asn, ExceptionLevel target_el);
 
+    /** Lookup an entry in one set, see lookup() */
+    TlbEntry *lookupSet(int set, Addr va, uint16_t asn, uint8_t vmid,
+                        bool hyp, bool secure, bool functional,
+                        bool ignore_asn, ExceptionLevel target_el);
+
+    /** Set holding the entries of a virtual page */
+    int
+    setIndex(Addr vpn) const
+    {
+        return numSets == 1 ? 0 : vpn % numSets;
+    }
+
+    /** Place an entry at the MRU position of its set, evicting the LRU one
+     * @return pointer to the placed entry
+     */
+    TlbEntry *place(const TlbEntry &entry);
+
+    /** Invalidate an entry as part of a flush */
+    void invalidate(TlbEntry *te);
+
+    void addPageShift(uint8_t shift);
+    void removePageShift(uint8_t shift);
+
   public: /* Testing */
     Fault testTranslation(const RequestPtr &req, Mode mode,
                           TlbEntry::DomainType domain);
@@ -51,10 +51,27 @@ class ThreadContext;
 
 class BaseTLB : public SimObject
 {
+  private:
+    /**
+     * Generation of the translations derived from this TLB's context,
+     * or 0 if the TLB doesn't keep track of it.
+     */
+    uint64_t _generation;
+
   protected:
-    BaseTLB(const Params *p) : SimObject(p) {}
+    BaseTLB(const Params *p) : SimObject(p), _generation(0) {}
+
+    /**
+     * Start a new generation of translations. A TLB that calls this
+     * whenever translations may have become stale (invalidations,
+     * changes of the translation context) lets functional accesses
+     * cache translations.
+     */
+    void newGeneration() { ++_generation; }
 
   public:
+    uint64_t generation() const { return _generation; }
+
 
     enum Mode { Read, Write, Execute };
 
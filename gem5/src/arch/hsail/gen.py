@@ -252,6 +252,10 @@ $class_name::execute(GPUDynInstPtr gpuDynInst)
 }
 
 '''
+# The exec functions read and write whole registers (all the lanes of
+# the wavefront at once) and only compute the result lane by lane, so
+# the register accesses are done once per instruction instead of once
+# per lane.
 exec_template_nodt_nosrc = '''
 void
 $class_name::execute(GPUDynInstPtr gpuDynInst)
@@ -261,13 +265,17 @@ $class_name::execute(GPUDynInstPtr gpuDynInst)
     typedef Base::DestCType DestCType;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    DestCType dest_lanes[MaxWfSize];
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
-            DestCType dest_val = $expr;
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -282,15 +290,21 @@ $class_name::execute(GPUDynInstPtr gpuDynInst)
     typedef Base::SrcCType  SrcCType;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
-        if (mask[lane]) {
-            SrcCType src_val0 = this->src0.get<SrcCType>(w, lane);
-            DestCType dest_val = $expr;
+    DestCType dest_lanes[MaxWfSize];
+    SrcCType src_lanes0[MaxWfSize];
 
-            this->dest.set(w, lane, dest_val);
+    this->src0.getLanes(w, src_lanes0);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
+        if (mask[lane]) {
+            SrcCType src_val0 = src_lanes0[lane];
+            dest_lanes[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -303,25 +317,37 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    CType dest_lanes[MaxWfSize];
+    CType src_lanes[$num_srcs][MaxWfSize];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_lanes);
+    }
+
+    for (int i = 0; i < $num_srcs; ++i) {
+        this->src[i].template getLanes<CType>(w, src_lanes[i]);
+    }
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
             CType dest_val;
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_lanes[lane];
             }
-
             CType src_val[$num_srcs];
 
             for (int i = 0; i < $num_srcs; ++i) {
-                src_val[i] = this->src[i].template get<CType>(w, lane);
+                src_val[i] = src_lanes[i][lane];
             }
 
             dest_val = (CType)($expr);
-
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = dest_val;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -338,24 +364,38 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     typedef typename Base::Src2CType Src2T;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    CType dest_lanes[MaxWfSize];
+    Src0T src_lanes0[MaxWfSize];
+    Src1T src_lanes1[MaxWfSize];
+    Src2T src_lanes2[MaxWfSize];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_lanes);
+    }
+
+    this->src0.template getLanes<Src0T>(w, src_lanes0);
+    this->src1.template getLanes<Src1T>(w, src_lanes1);
+    this->src2.template getLanes<Src2T>(w, src_lanes2);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
             CType dest_val;
-
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_lanes[lane];
             }
 
-            Src0T src_val0 = this->src0.template get<Src0T>(w, lane);
-            Src1T src_val1 = this->src1.template get<Src1T>(w, lane);
-            Src2T src_val2 = this->src2.template get<Src2T>(w, lane);
+            Src0T src_val0 = src_lanes0[lane];
+            Src1T src_val1 = src_lanes1[lane];
+            Src2T src_val2 = src_lanes2[lane];
 
             dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = dest_val;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -372,21 +412,34 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     typedef typename Base::Src1CType Src1T;
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    DestT dest_lanes[MaxWfSize];
+    Src0T src_lanes0[MaxWfSize];
+    Src1T src_lanes1[MaxWfSize];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<DestT>(w, dest_lanes);
+    }
+
+    this->src0.template getLanes<Src0T>(w, src_lanes0);
+    this->src1.template getLanes<Src1T>(w, src_lanes1);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
             DestT dest_val;
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<DestT>(w, lane);
+                dest_val = dest_lanes[lane];
             }
-            Src0T src_val0 = this->src0.template get<Src0T>(w, lane);
-            Src1T src_val1 = this->src1.template get<Src1T>(w, lane);
+            Src0T src_val0 = src_lanes0[lane];
+            Src1T src_val1 = src_lanes1[lane];
 
             dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = dest_val;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -399,22 +452,34 @@ $class_name<DataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    const int num_lanes = w->computeUnit->wfSize();
+
+    CType dest_lanes[MaxWfSize];
+    CType src_lanes0[MaxWfSize];
+    uint32_t src_lanes1[MaxWfSize];
+
+    if ($dest_is_src_flag) {
+        this->dest.template getLanes<CType>(w, dest_lanes);
+    }
+
+    this->src0.template getLanes<CType>(w, src_lanes0);
+    this->src1.template getLanes<uint32_t>(w, src_lanes1);
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
             CType dest_val;
-
             if ($dest_is_src_flag) {
-                dest_val = this->dest.template get<CType>(w, lane);
+                dest_val = dest_lanes[lane];
             }
-
-            CType src_val0 = this->src0.template get<CType>(w, lane);
-            uint32_t src_val1 = this->src1.template get<uint32_t>(w, lane);
+            CType src_val0 = src_lanes0[lane];
+            uint32_t src_val1 = src_lanes1[lane];
 
             dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = dest_val;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -427,21 +492,28 @@ $class_name<DestDataType, SrcDataType>::execute(GPUDynInstPtr gpuDynInst)
     Wavefront *w = gpuDynInst->wavefront();
 
     const VectorMask &mask = w->getPred();
+    const int num_lanes = w->computeUnit->wfSize();
 
-    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+    DestCType dest_lanes[MaxWfSize];
+    SrcCType src_lanes[$num_srcs][MaxWfSize];
+
+    for (int i = 0; i < $num_srcs; ++i) {
+        this->src[i].template getLanes<SrcCType>(w, src_lanes[i]);
+    }
+
+    for (int lane = 0; lane < num_lanes; ++lane) {
         if (mask[lane]) {
-            DestCType dest_val;
             SrcCType src_val[$num_srcs];
 
             for (int i = 0; i < $num_srcs; ++i) {
-                src_val[i] = this->src[i].template get<SrcCType>(w, lane);
+                src_val[i] = src_lanes[i][lane];
             }
 
-            dest_val = $expr;
-
-            this->dest.set(w, lane, dest_val);
+            dest_lanes[lane] = $expr;
         }
     }
+
+    this->dest.setLanes(w, dest_lanes, mask);
 }
 
 '''
@@ -785,7 +857,7 @@ gen_special('GridGroups',
     'divCeil(w->gridSz[src0],w->workGroupSz[src0])')
 gen_special('LaneId', 'lane')
 gen_special('WaveId', 'w->wfId')
-gen_special('Clock', 'w->computeUnit->shader->tick_cnt', 'U64')
+gen_special('Clock', 'w->computeUnit->tick_cnt', 'U64')
 
 # gen_special('CU'', ')
 
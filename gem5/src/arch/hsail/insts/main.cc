@@ -192,7 +192,7 @@ namespace HsailISA
                 local_mempacket->wfDynId = w->wfDynId;
                 w->computeUnit->injectGlobalMemFence(local_mempacket, true);
             } else {
-                w->computeUnit->shader->dispatcher->scheduleDispatch();
+                w->computeUnit->scheduleDispatch();
             }
         }
     }
@@ -236,7 +236,7 @@ namespace HsailISA
         m->wfDynId = w->wfDynId;
         m->kern_id = w->kernId;
         m->cu_id = w->computeUnit->cu_id;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         switch (this->segment) {
           case Brig::BRIG_SEGMENT_GLOBAL:
@@ -415,7 +415,7 @@ namespace HsailISA
         m->wfDynId = w->wfDynId;
         m->kern_id = w->kernId;
         m->cu_id = w->computeUnit->cu_id;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         switch (this->segment) {
           case Brig::BRIG_SEGMENT_GLOBAL:
@@ -584,7 +584,7 @@ namespace HsailISA
         m->wfDynId = w->wfDynId;
         m->kern_id = w->kernId;
         m->cu_id = w->computeUnit->cu_id;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         switch (this->segment) {
           case Brig::BRIG_SEGMENT_GLOBAL:
@@ -644,7 +644,7 @@ namespace HsailISA
         m->simdId = w->simdId;
         m->wfSlotId = w->wfSlotId;
         m->wfDynId = w->wfDynId;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         m->pipeId = GLBMEM_PIPE;
         m->latency.set(w->computeUnit->shader->ticks(64));
@@ -684,7 +684,7 @@ namespace HsailISA
         m->simdId = w->simdId;
         m->wfSlotId = w->wfSlotId;
         m->wfDynId = w->wfDynId;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         m->pipeId = GLBMEM_PIPE;
         m->latency.set(w->computeUnit->shader->ticks(64));
@@ -723,7 +723,7 @@ namespace HsailISA
         m->simdId = w->simdId;
         m->wfSlotId = w->wfSlotId;
         m->wfDynId = w->wfDynId;
-        m->latency.init(&w->computeUnit->shader->tick_cnt);
+        m->latency.init(&w->computeUnit->tick_cnt);
 
         m->pipeId = GLBMEM_PIPE;
         m->latency.set(w->computeUnit->shader->ticks(1));
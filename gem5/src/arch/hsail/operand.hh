@@ -42,8 +42,11 @@
  *  Defines classes encapsulating HSAIL instruction operands.
  */
 
+#include <algorithm>
+#include <cstring>
 #include <limits>
 #include <string>
+#include <type_traits>
 
 #include "arch/hsail/Brig.h"
 #include "base/trace.hh"
@@ -185,6 +188,28 @@ class SRegOperand : public BaseRegOperand
         return (OperandType)ret;
     }
 
+    // Read the operand for all the lanes of a wavefront
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        assert(sizeof(OperandType) <= sizeof(uint32_t));
+        assert(regIdx < w->maxSpVgprs);
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(uint32_t), 1);
+        const uint32_t *regs =
+            w->computeUnit->vrf[w->simdId]->lanes<uint32_t>(vgprIdx);
+        const int num_lanes = w->computeUnit->wfSize();
+
+        if (sizeof(OperandType) == sizeof(uint32_t)) {
+            std::memcpy(vals, regs, num_lanes * sizeof(uint32_t));
+        } else {
+            // if OperandType is smaller than 32-bit, we truncate the value
+            const uint32_t val_mask = sizeof(OperandType) == 1 ? 0xff : 0xffff;
+            for (int lane = 0; lane < num_lanes; ++lane)
+                vals[lane] = (OperandType)(regs[lane] & val_mask);
+        }
+    }
+
     // special get method for compatibility with LabelOperand
     uint32_t
     getTarget(Wavefront *w, int lane)
@@ -194,6 +219,12 @@ class SRegOperand : public BaseRegOperand
 
     template<typename OperandType>
     void set(Wavefront *w, int lane, OperandType &val);
+
+    // Write the operand for the active lanes of a wavefront
+    template<typename OperandType>
+    void setLanes(Wavefront *w, const OperandType *vals,
+                  const VectorMask &mask);
+
     std::string disassemble();
 };
 
@@ -222,6 +253,32 @@ SRegOperand::set(Wavefront *w, int lane, uint64_t &val)
     w->computeUnit->vrf[w->simdId]->write<uint32_t>(vgprIdx, val, lane);
 }
 
+template<typename OperandType>
+void
+SRegOperand::setLanes(Wavefront *w, const OperandType *vals,
+                      const VectorMask &mask)
+{
+    // Only 32-bit values or 64-bit ones truncated to 32 bits can be set.
+    assert(sizeof(OperandType) == sizeof(uint32_t) ||
+           (std::is_same<OperandType, uint64_t>::value));
+    assert(regIdx < w->maxSpVgprs);
+    uint32_t vgprIdx = w->remap(regIdx, sizeof(uint32_t), 1);
+    uint32_t *regs = w->computeUnit->vrf[w->simdId]->lanes<uint32_t>(vgprIdx);
+
+    for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+        if (!mask[lane])
+            continue;
+
+        DPRINTF(GPUReg, "CU%d, WF[%d][%d], lane %d: $s%d <- %d\n",
+                w->computeUnit->cu_id, w->simdId, w->wfSlotId, lane, regIdx,
+                vals[lane]);
+        if (sizeof(OperandType) == sizeof(uint32_t))
+            std::memcpy(&regs[lane], &vals[lane], sizeof(uint32_t));
+        else
+            regs[lane] = (uint32_t)vals[lane];
+    }
+}
+
 class DRegOperand : public BaseRegOperand
 {
   public:
@@ -283,6 +340,45 @@ class DRegOperand : public BaseRegOperand
         w->computeUnit->vrf[w->simdId]->write<OperandType>(vgprIdx,val,lane);
     }
 
+    // Read the operand for all the lanes of a wavefront
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        assert(sizeof(OperandType) <= sizeof(uint64_t));
+        // TODO: this check is valid only for HSAIL
+        assert(regIdx < w->maxDpVgprs);
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(OperandType), 1);
+
+        std::memcpy(vals,
+                    w->computeUnit->vrf[w->simdId]->
+                        lanes<OperandType>(vgprIdx),
+                    w->computeUnit->wfSize() * sizeof(OperandType));
+    }
+
+    // Write the operand for the active lanes of a wavefront
+    template<typename OperandType>
+    void
+    setLanes(Wavefront *w, const OperandType *vals, const VectorMask &mask)
+    {
+        assert(sizeof(OperandType) <= sizeof(uint64_t));
+        // TODO: this check is valid only for HSAIL
+        assert(regIdx < w->maxDpVgprs);
+        uint32_t vgprIdx = w->remap(regIdx, sizeof(OperandType), 1);
+        OperandType *regs =
+            w->computeUnit->vrf[w->simdId]->lanes<OperandType>(vgprIdx);
+
+        for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+            if (!mask[lane])
+                continue;
+
+            DPRINTF(GPUReg, "CU%d, WF[%d][%d], lane %d: $d%d <- %d\n",
+                    w->computeUnit->cu_id, w->simdId, w->wfSlotId, lane,
+                    regIdx, vals[lane]);
+            regs[lane] = vals[lane];
+        }
+    }
+
     std::string disassemble();
 };
 
@@ -341,6 +437,28 @@ class CRegOperand : public BaseRegOperand
         w->condRegState->write<OperandType>(regIdx,lane,val);
     }
 
+    // Read the operand for all the lanes of a wavefront
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane)
+            vals[lane] = get<OperandType>(w, lane);
+    }
+
+    // Write the operand for the active lanes of a wavefront
+    template<typename OperandType>
+    void
+    setLanes(Wavefront *w, const OperandType *vals, const VectorMask &mask)
+    {
+        for (int lane = 0; lane < w->computeUnit->wfSize(); ++lane) {
+            if (mask[lane]) {
+                OperandType val = vals[lane];
+                set<OperandType>(w, lane, val);
+            }
+        }
+    }
+
     std::string disassemble();
 };
 
@@ -383,6 +501,14 @@ class ImmOperand : public BaseOperand
     {
         return get<OperandType>(w);
     }
+
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        std::fill(vals, vals + w->computeUnit->wfSize(),
+                  get<OperandType>(w));
+    }
 };
 
 template<typename T>
@@ -477,6 +603,16 @@ class RegOrImmOperand : public BaseOperand
                          reg_op.template get<OperandType>(w, lane);
     }
 
+    template<typename OperandType>
+    void
+    getLanes(Wavefront *w, OperandType *vals)
+    {
+        if (is_imm)
+            imm_op.template getLanes<OperandType>(w, vals);
+        else
+            reg_op.template getLanes<OperandType>(w, vals);
+    }
+
     uint32_t
     opSize()
     {
@@ -93,7 +93,7 @@ MipsProcess::argsInit(int pageSize)
     updateBias();
 
     // load object file into target memory
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
 
     std::vector<AuxVector<IntType>> auxv;
 
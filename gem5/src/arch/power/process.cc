@@ -99,7 +99,7 @@ PowerProcess::argsInit(int intSize, int pageSize)
     updateBias();
 
     // load object file into target memory
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
 
     //Setup the auxilliary vectors. These will already have endian conversion.
     //Auxilliary vectors are loaded only for elf formatted executables.
@@ -168,7 +168,8 @@ RemoteGDB::acc(Addr va, size_t len)
     // port proxy to read/writeBlob.  I (bgs) am not convinced the first byte
     // check is enough.
     panic_if(FullSystem, "acc not implemented for POWER FS!");
-    return context()->getProcessPtr()->pTable->lookup(va) != nullptr;
+    Process *p = context()->getProcessPtr();
+    return p->pTable->lookup(va) || p->loadLazyPage(va);
 }
 
 void
@@ -37,15 +37,17 @@
 namespace RiscvISA
 {
 
+GenericISA::BasicDecodeCache Decoder::defaultCache;
+
 static const MachInst LowerBitMask = (1 << sizeof(MachInst) * 4) - 1;
 static const MachInst UpperBitMask = LowerBitMask << sizeof(MachInst) * 4;
 
 void Decoder::reset()
 {
-    aligned = true;
     mid = false;
     more = true;
     emi = 0;
+    instSize = sizeof(MachInst);
     instDone = false;
 }
 
@@ -58,9 +60,11 @@ Decoder::moreBytes(const PCState &pc, Addr fetchPC, MachInst inst)
     bool aligned = pc.pc() % sizeof(MachInst) == 0;
     if (aligned) {
         emi = inst;
-        if (compressed(emi))
+        bool is_compressed = compressed(emi);
+        if (is_compressed)
             emi &= LowerBitMask;
-        more = !compressed(emi);
+        instSize = is_compressed ? sizeof(MachInst) / 2 : sizeof(MachInst);
+        more = !is_compressed;
         instDone = true;
     } else {
         if (mid) {
@@ -71,9 +75,12 @@ Decoder::moreBytes(const PCState &pc, Addr fetchPC, MachInst inst)
             instDone = true;
         } else {
             emi = (inst & UpperBitMask) >> sizeof(MachInst)*4;
-            mid = !compressed(emi);
+            bool is_compressed = compressed(emi);
+            instSize = is_compressed ? sizeof(MachInst) / 2 :
+                                       sizeof(MachInst);
+            mid = !is_compressed;
             more = true;
-            instDone = compressed(emi);
+            instDone = is_compressed;
         }
     }
 }
@@ -83,13 +90,7 @@ Decoder::decode(ExtMachInst mach_inst, Addr addr)
 {
     DPRINTF(Decode, "Decoding instruction 0x%08x at address %#x\n",
             mach_inst, addr);
-    if (instMap.find(mach_inst) != instMap.end())
-        return instMap[mach_inst];
-    else {
-        StaticInstPtr si = decodeInst(mach_inst);
-        instMap[mach_inst] = si;
-        return si;
-    }
+    return defaultCache.decode(this, mach_inst, addr);
 }
 
 StaticInstPtr
@@ -99,11 +100,7 @@ Decoder::decode(RiscvISA::PCState &nextPC)
         return nullptr;
     instDone = false;
 
-    if (compressed(emi)) {
-        nextPC.npc(nextPC.instAddr() + sizeof(MachInst) / 2);
-    } else {
-        nextPC.npc(nextPC.instAddr() + sizeof(MachInst));
-    }
+    nextPC.npc(nextPC.instAddr() + instSize);
 
     return decode(emi, nextPC.instAddr());
 }
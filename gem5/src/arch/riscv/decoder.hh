@@ -48,14 +48,14 @@ class ISA;
 class Decoder
 {
   private:
-    DecodeCache::InstMap<ExtMachInst> instMap;
-    bool aligned;
     bool mid;
     bool more;
 
   protected:
     //The extended machine instruction being generated
     ExtMachInst emi;
+    /// Size of the instruction in emi, found when its bytes arrive
+    unsigned instSize;
     bool instDone;
 
   public:
@@ -74,6 +74,11 @@ class Decoder
     bool instReady() { return instDone; }
     void takeOverFrom(Decoder *old) {}
 
+  protected:
+    /// A cache of decoded instruction objects.
+    static GenericISA::BasicDecodeCache defaultCache;
+
+  public:
     StaticInstPtr decodeInst(ExtMachInst mach_inst);
 
     /// Decode a machine instruction.
@@ -124,7 +124,7 @@ RiscvProcess::argsInit(int pageSize)
     const int addrSize = sizeof(IntType);
 
     updateBias();
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
     ElfObject* elfObject = dynamic_cast<ElfObject*>(objFile);
     memState->setStackMin(memState->getStackBase());
 
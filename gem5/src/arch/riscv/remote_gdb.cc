@@ -157,7 +157,8 @@ bool
 RemoteGDB::acc(Addr va, size_t len)
 {
     panic_if(FullSystem, "acc not implemented for RISCV FS!");
-    return context()->getProcessPtr()->pTable->lookup(va) != nullptr;
+    Process *p = context()->getProcessPtr();
+    return p->pTable->lookup(va) || p->loadLazyPage(va);
 }
 
 void
@@ -167,7 +167,8 @@ RemoteGDB::acc(Addr va, size_t len)
     } else {
         // Check to make sure the first byte is mapped into the processes
         // address space.
-        return context()->getProcessPtr()->pTable->lookup(va) != nullptr;
+        Process *p = context()->getProcessPtr();
+        return p->pTable->lookup(va) || p->loadLazyPage(va);
     }
 }
 
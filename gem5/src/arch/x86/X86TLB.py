@@ -54,6 +54,14 @@ class X86TLB(BaseTLB):
     type = 'X86TLB'
     cxx_class = 'X86ISA::TLB'
     cxx_header = 'arch/x86/tlb.hh'
-    size = Param.Unsigned(64, "TLB size")
+    size = Param.Unsigned(64, "TLB size (4 KiB page entries)")
+    assoc = Param.Unsigned(4, "Associativity of the 4 KiB page entries "
+                           "(0 is fully associative)")
+    large_size = Param.Unsigned(32, "Number of 2 MiB and 4 MiB page entries")
+    large_assoc = Param.Unsigned(4, "Associativity of the 2 MiB and 4 MiB "
+                                 "page entries (0 is fully associative)")
+    huge_size = Param.Unsigned(4, "Number of 1 GiB page entries")
+    huge_assoc = Param.Unsigned(0, "Associativity of the 1 GiB page entries "
+                                "(0 is fully associative)")
     walker = Param.X86PagetableWalker(\
             X86PagetableWalker(), "page table walker")
@@ -294,6 +294,12 @@ class Decoder
         altAddr = old->altAddr;
         defAddr = old->defAddr;
         stack = old->stack;
+
+        // Keep the instructions the old decoder found at each address,
+        // rather than decoding them again after switching CPUs.
+        addrCacheMap.swap(old->addrCacheMap);
+        decodePages = old->decodePages;
+        old->decodePages = NULL;
     }
 
     void reset()
@@ -40,6 +40,9 @@
 #ifndef __ARCH_X86_INSTS_MACROOP_HH__
 #define __ARCH_X86_INSTS_MACROOP_HH__
 
+#include <mutex>
+#include <unordered_map>
+
 #include "arch/x86/insts/badmicroop.hh"
 #include "arch/x86/insts/static_inst.hh"
 #include "arch/x86/emulenv.hh"
@@ -89,7 +92,32 @@ class MacroopBase : public X86StaticInst
         return mnemonic;
     }
 
+    /**
+     * Microcode ROM microops generated for this macroop. They depend on
+     * the macroop's ExtMachInst and EmulEnv only, so they can be shared
+     * by every CPU that shares the macroop.
+     */
+    mutable std::unordered_map<MicroPC, StaticInstPtr> romMicroops;
+    mutable std::mutex romMicroopLock;
+
   public:
+    /**
+     * Look up a microcode ROM microop for this macroop, generating it
+     * the first time it's fetched.
+     * @param microPC The (normalized) ROM micro PC.
+     * @param gen Callable which generates the microop.
+     */
+    template <class Generator>
+    StaticInstPtr
+    fetchRomMicroop(MicroPC microPC, Generator gen) const
+    {
+        std::lock_guard<std::mutex> lock(romMicroopLock);
+        auto it = romMicroops.find(microPC);
+        if (it == romMicroops.end())
+            it = romMicroops.emplace(microPC, gen()).first;
+        return it->second;
+    }
+
     ExtMachInst
     getExtMachInst()
     {
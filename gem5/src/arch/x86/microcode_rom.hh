@@ -32,6 +32,7 @@
 #define __ARCH_X86_MICROCODE_ROM_HH__
 
 #include "arch/x86/insts/badmicroop.hh"
+#include "arch/x86/insts/macroop.hh"
 #include "arch/x86/emulenv.hh"
 #include "cpu/static_inst.hh"
 
@@ -63,8 +64,16 @@ namespace X86ISAInst
             microPC = normalMicroPC(microPC);
             if (microPC >= numMicroops)
                 return X86ISA::badMicroop;
-            else
+            if (!curMacroop || !curMacroop->isMacroop())
                 return genFuncs[microPC](curMacroop);
+
+            // The generated microops only depend on the macroop, so keep
+            // them with it instead of building them on every fetch.
+            auto macroop =
+                static_cast<const X86ISA::MacroopBase *>(curMacroop.get());
+            return macroop->fetchRomMicroop(microPC, [&]() {
+                return genFuncs[microPC](curMacroop);
+            });
         }
     };
 }
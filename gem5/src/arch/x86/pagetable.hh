@@ -47,20 +47,12 @@
 
 #include "base/bitunion.hh"
 #include "base/types.hh"
-#include "base/trie.hh"
 #include "arch/x86/system.hh"
 #include "debug/MMU.hh"
 
 class Checkpoint;
 class ThreadContext;
 
-namespace X86ISA
-{
-    struct TlbEntry;
-}
-
-typedef Trie<Addr, X86ISA::TlbEntry> TlbEntryTrie;
-
 namespace X86ISA
 {
     struct TlbEntry : public Serializable
@@ -92,8 +84,6 @@ namespace X86ISA
         // A sequence number to keep track of LRU.
         uint64_t lruSeq;
 
-        TlbEntryTrie::Handle trieHandle;
-
         TlbEntry(Addr asn, Addr _vaddr, Addr _paddr,
                  bool uncacheable, bool read_only);
         TlbEntry();
@@ -774,7 +774,7 @@ X86Process::argsInit(int pageSize,
     updateBias();
 
     // load object file into target memory
-    objFile->loadSegments(initVirtMem);
+    loadSegments();
 
     enum X86CpuFeature {
         X86_OnboardFPU = 1 << 0,
@@ -88,7 +88,8 @@ RemoteGDB::acc(Addr va, size_t len)
                                         BaseTLB::Read);
         return fault == NoFault;
     } else {
-        return context()->getProcessPtr()->pTable->lookup(va) != nullptr;
+        Process *p = context()->getProcessPtr();
+        return p->pTable->lookup(va) || p->loadLazyPage(va);
     }
 }
 
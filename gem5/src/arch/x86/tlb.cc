@@ -39,6 +39,7 @@
 
 #include "arch/x86/tlb.hh"
 
+#include <algorithm>
 #include <cstring>
 #include <memory>
 
@@ -49,6 +50,7 @@
 #include "arch/x86/regs/misc.hh"
 #include "arch/x86/regs/msr.hh"
 #include "arch/x86/x86_traits.hh"
+#include "base/intmath.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
 #include "debug/TLB.hh"
@@ -60,82 +62,126 @@
 namespace X86ISA {
 
 TLB::TLB(const Params *p)
-    : BaseTLB(p), configAddress(0), size(p->size),
-      tlb(size), lruSeq(0)
+    : BaseTLB(p), configAddress(0), lruSeq(0)
 {
-    if (!size)
-        fatal("TLBs must have a non-zero size.\n");
-
-    for (int x = 0; x < size; x++) {
-        tlb[x].trieHandle = NULL;
-        freeList.push_back(&tlb[x]);
-    }
+    arrays[0].init(name(), p->size, p->assoc);
+    arrays[1].init(name(), p->large_size, p->large_assoc);
+    arrays[2].init(name(), p->huge_size, p->huge_assoc);
 
     walker = p->walker;
     walker->setTLB(this);
+
+    // Let functional accesses cache translations
+    newGeneration();
+}
+
+void
+TLB::EntryArray::init(const std::string &name, unsigned size,
+                      unsigned _assoc)
+{
+    if (!size)
+        fatal("TLBs must have a non-zero size.\n");
+
+    // An associativity of 0 makes the array fully associative.
+    assoc = _assoc ? _assoc : size;
+    fatal_if(size % assoc, "%s: TLB size %d isn't a multiple of its "
+             "associativity %d.\n", name, size, assoc);
+    fatal_if(!isPowerOf2(size / assoc),
+             "%s: The number of TLB sets must be a power of 2.\n", name);
+    setMask = size / assoc - 1;
+    pageSizes = 0;
+
+    entries.resize(size);
+    valid.assign(size, false);
 }
 
 void
-TLB::evictLRU()
+TLB::EntryArray::updatePageSizes()
 {
-    // Find the entry with the lowest (and hence least recently updated)
-    // sequence number.
+    pageSizes = 0;
+    for (unsigned i = 0; i < entries.size(); i++) {
+        if (valid[i])
+            pageSizes |= ULL(1) << entries[i].logBytes;
+    }
+}
 
-    unsigned lru = 0;
-    for (unsigned i = 1; i < size; i++) {
-        if (tlb[i].lruSeq < tlb[lru].lruSeq)
-            lru = i;
+TlbEntry *
+TLB::insertEntry(Addr vpn, const TlbEntry &entry)
+{
+    EntryArray &array = arrays[arrayIndex(entry.logBytes)];
+    unsigned base = array.setBase(vpn, entry.logBytes);
+
+    // Use a free way if there is one, or the least recently used one.
+    unsigned victim = base;
+    for (unsigned way = base; way < base + array.assoc; way++) {
+        if (!array.valid[way]) {
+            victim = way;
+            break;
+        }
+        if (array.entries[way].lruSeq < array.entries[victim].lruSeq)
+            victim = way;
     }
 
-    assert(tlb[lru].trieHandle);
-    trie.remove(tlb[lru].trieHandle);
-    tlb[lru].trieHandle = NULL;
-    freeList.push_back(&tlb[lru]);
+    TlbEntry *newEntry = &array.entries[victim];
+    *newEntry = entry;
+    newEntry->vaddr = vpn;
+    array.valid[victim] = true;
+    array.pageSizes |= ULL(1) << entry.logBytes;
+    return newEntry;
+}
+
+void
+TLB::invalidate(TlbEntry *entry)
+{
+    EntryArray &array = arrays[arrayIndex(entry->logBytes)];
+    array.valid[entry - array.entries.data()] = false;
 }
 
 TlbEntry *
 TLB::insert(Addr vpn, const TlbEntry &entry)
 {
     // If somebody beat us to it, just use that existing entry.
-    TlbEntry *newEntry = trie.lookup(vpn);
+    TlbEntry *newEntry = lookup(vpn, false);
     if (newEntry) {
         assert(newEntry->vaddr == vpn);
         return newEntry;
     }
 
-    if (freeList.empty())
-        evictLRU();
-
-    newEntry = freeList.front();
-    freeList.pop_front();
-
-    *newEntry = entry;
+    newEntry = insertEntry(vpn, entry);
     newEntry->lruSeq = nextSeq();
-    newEntry->vaddr = vpn;
-    newEntry->trieHandle =
-    trie.insert(vpn, TlbEntryTrie::MaxBits - entry.logBytes, newEntry);
     return newEntry;
 }
 
 TlbEntry *
 TLB::lookup(Addr va, bool update_lru)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry && update_lru)
-        entry->lruSeq = nextSeq();
-    return entry;
+    for (auto &array : arrays) {
+        for (uint64_t sizes = array.pageSizes; sizes; sizes &= sizes - 1) {
+            unsigned log_bytes = findLsbSet(sizes);
+            Addr vpn = va & ~mask(log_bytes);
+            unsigned base = array.setBase(va, log_bytes);
+            for (unsigned way = base; way < base + array.assoc; way++) {
+                TlbEntry &entry = array.entries[way];
+                if (array.valid[way] && entry.vaddr == vpn &&
+                        entry.logBytes == log_bytes) {
+                    if (update_lru)
+                        entry.lruSeq = nextSeq();
+                    return &entry;
+                }
+            }
+        }
+    }
+    return NULL;
 }
 
 void
 TLB::flushAll()
 {
     DPRINTF(TLB, "Invalidating all entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
-        }
+    newGeneration();
+    for (auto &array : arrays) {
+        array.valid.assign(array.entries.size(), false);
+        array.pageSizes = 0;
     }
 }
 
@@ -149,24 +195,23 @@ void
 TLB::flushNonGlobal()
 {
     DPRINTF(TLB, "Invalidating all non global entries.\n");
-    for (unsigned i = 0; i < size; i++) {
-        if (tlb[i].trieHandle && !tlb[i].global) {
-            trie.remove(tlb[i].trieHandle);
-            tlb[i].trieHandle = NULL;
-            freeList.push_back(&tlb[i]);
+    newGeneration();
+    for (auto &array : arrays) {
+        for (unsigned i = 0; i < array.entries.size(); i++) {
+            if (!array.entries[i].global)
+                array.valid[i] = false;
         }
+        array.updatePageSizes();
     }
 }
 
 void
 TLB::demapPage(Addr va, uint64_t asn)
 {
-    TlbEntry *entry = trie.lookup(va);
-    if (entry) {
-        trie.remove(entry->trieHandle);
-        entry->trieHandle = NULL;
-        freeList.push_back(entry);
-    }
+    newGeneration();
+    TlbEntry *entry = lookup(va, false);
+    if (entry)
+        invalidate(entry);
 }
 
 Fault
@@ -361,10 +406,13 @@ TLB::translate(const RequestPtr &req,
                     Process *p = tc->getProcessPtr();
                     const EmulationPageTable::Entry *pte =
                         p->pTable->lookup(vaddr);
-                    if (!pte && mode != Execute) {
-                        // Check if we just need to grow the stack.
-                        if (p->fixupStackFault(vaddr)) {
-                            // If we did, lookup the entry for the new page.
+                    if (!pte) {
+                        // Check if the page of the executable hasn't been
+                        // loaded yet or we just need to grow the stack.
+                        bool fixed = mode == Execute ?
+                            p->loadLazyPage(vaddr) : p->fixupFault(vaddr);
+                        if (fixed) {
+                            // If so, lookup the entry for the new page.
                             pte = p->pTable->lookup(vaddr);
                         }
                     }
@@ -480,36 +528,37 @@ void
 TLB::serialize(CheckpointOut &cp) const
 {
     // Only store the entries in use.
-    uint32_t _size = size - freeList.size();
+    uint32_t _size = 0;
+    for (auto &array : arrays)
+        _size += std::count(array.valid.begin(), array.valid.end(), true);
     SERIALIZE_SCALAR(_size);
     SERIALIZE_SCALAR(lruSeq);
 
     uint32_t _count = 0;
-    for (uint32_t x = 0; x < size; x++) {
-        if (tlb[x].trieHandle != NULL)
-            tlb[x].serializeSection(cp, csprintf("Entry%d", _count++));
+    for (auto &array : arrays) {
+        for (unsigned i = 0; i < array.entries.size(); i++) {
+            if (array.valid[i]) {
+                array.entries[i].serializeSection(
+                    cp, csprintf("Entry%d", _count++));
+            }
+        }
     }
 }
 
 void
 TLB::unserialize(CheckpointIn &cp)
 {
-    // Do not allow to restore with a smaller tlb.
     uint32_t _size;
     UNSERIALIZE_SCALAR(_size);
-    if (_size > size) {
-        fatal("TLB size less than the one in checkpoint!");
-    }
-
     UNSERIALIZE_SCALAR(lruSeq);
 
+    // Entries which don't fit in the sets of this TLB are replaced
+    // like they would be on a miss.
     for (uint32_t x = 0; x < _size; x++) {
-        TlbEntry *newEntry = freeList.front();
-        freeList.pop_front();
-
-        newEntry->unserializeSection(cp, csprintf("Entry%d", x));
-        newEntry->trieHandle = trie.insert(newEntry->vaddr,
-            TlbEntryTrie::MaxBits - newEntry->logBytes, newEntry);
+        TlbEntry entry;
+        entry.unserializeSection(cp, csprintf("Entry%d", x));
+        if (!lookup(entry.vaddr, false))
+            insertEntry(entry.vaddr, entry);
     }
 }
 
@@ -40,12 +40,10 @@
 #ifndef __ARCH_X86_TLB_HH__
 #define __ARCH_X86_TLB_HH__
 
-#include <list>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/x86/pagetable.hh"
-#include "base/trie.hh"
 #include "mem/request.hh"
 #include "params/X86TLB.hh"
 
@@ -60,8 +58,6 @@ namespace X86ISA
       protected:
         friend class Walker;
 
-        typedef std::list<TlbEntry *> EntryList;
-
         uint32_t configAddress;
 
       public:
@@ -77,8 +73,6 @@ namespace X86ISA
 
       protected:
 
-        EntryList::iterator lookupIt(Addr va, bool update_lru = true);
-
         Walker * walker;
 
       public:
@@ -91,13 +85,55 @@ namespace X86ISA
         void demapPage(Addr va, uint64_t asn) override;
 
       protected:
-        uint32_t size;
+        /**
+         * A set associative array of entries for a range of page sizes.
+         * An entry lives in the set selected by the address bits right
+         * above its page offset, so a lookup probes one set for every
+         * page size the array has held since it was last flushed.
+         */
+        struct EntryArray
+        {
+            unsigned assoc;
+            Addr setMask;
+            /** Bitmap of the page sizes (in address bits) held */
+            uint64_t pageSizes;
+
+            std::vector<TlbEntry> entries;
+            std::vector<bool> valid;
+
+            void init(const std::string &name, unsigned size,
+                      unsigned _assoc);
+
+            /** Index of the first way of the set for a page */
+            unsigned
+            setBase(Addr va, unsigned log_bytes) const
+            {
+                return ((va >> log_bytes) & setMask) * assoc;
+            }
+
+            /** Recompute pageSizes from the valid entries */
+            void updatePageSizes();
+        };
+
+        /** Arrays for 4 KiB, 2 MiB (and 4 MiB) and 1 GiB pages */
+        EntryArray arrays[3];
+
+        /** Index of the array that holds pages of a size */
+        static unsigned
+        arrayIndex(unsigned log_bytes)
+        {
+            return log_bytes < 21 ? 0 : (log_bytes < 30 ? 1 : 2);
+        }
 
-        std::vector<TlbEntry> tlb;
+        /**
+         * Place an entry into its set, replacing the least recently used
+         * entry if the set is full.
+         */
+        TlbEntry *insertEntry(Addr vpn, const TlbEntry &entry);
 
-        EntryList freeList;
+        /** Remove an entry returned by lookup() */
+        void invalidate(TlbEntry *entry);
 
-        TlbEntryTrie trie;
         uint64_t lruSeq;
 
         // Statistics
@@ -114,8 +150,6 @@ namespace X86ISA
 
       public:
 
-        void evictLRU();
-
         uint64_t
         nextSeq()
         {
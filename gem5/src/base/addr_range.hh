@@ -407,21 +407,40 @@ class AddrRange
         // no interleaving, or with interleaving also if the selected
         // bits from the address match the interleaving value
         bool in_range = a >= _start && a <= _end;
-        if (in_range) {
-            auto sel = 0;
-            for (int i = 0; i < masks.size(); i++) {
-                Addr masked = a & masks[i];
-                // The result of an xor operation is 1 if the number
-                // of bits set is odd or 0 othersize, thefore it
-                // suffices to count the number of bits set to
-                // determine the i-th bit of sel.
-                sel |= (popCount(masked) % 2) << i;
-            }
-            return sel == intlvMatch;
+        return in_range && intlvSelect(a) == intlvMatch;
+    }
+
+    /**
+     * Determine the interleaving bits of an address, i.e. the
+     * interleaving match value of the range that the address belongs
+     * to among all the ranges sharing the masks of this one. The
+     * address is not checked against the bounds of the range.
+     *
+     * @param a Address to get the interleaving bits of
+     * @return The interleaving match value, 0 if not interleaved
+     */
+    uint8_t intlvSelect(Addr a) const
+    {
+        uint8_t sel = 0;
+        for (int i = 0; i < masks.size(); i++) {
+            Addr masked = a & masks[i];
+            // The result of an xor operation is 1 if the number
+            // of bits set is odd or 0 othersize, thefore it
+            // suffices to count the number of bits set to
+            // determine the i-th bit of sel.
+            sel |= (popCount(masked) % 2) << i;
         }
-        return false;
+        return sel;
     }
 
+    /**
+     * Get the interleaving match value of this range.
+     *
+     * @return The value the interleaving bits of an address in the
+     *         range have, 0 if not interleaved
+     */
+    uint8_t getIntlvMatch() const { return intlvMatch; }
+
     /**
      * Remove the interleaving bits from an input address.
      *
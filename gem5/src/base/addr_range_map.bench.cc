@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/addr_range_map.hh"
+#include "base/bench/benchmark.hh"
+
+/**
+ * Look up the addresses of a stream in a map of contiguous ranges, as
+ * done to route packets in a crossbar.
+ */
+static void
+addrRangeMapLookup(Bench::State &state)
+{
+    const Addr footprint = 1ULL << 32;
+    const Addr size = footprint / state.arg();
+
+    AddrRangeMap<int> map;
+    for (int64_t i = 0; i < state.arg(); ++i)
+        map.insert(RangeSize(i * size, size), i);
+
+    const auto addrs = Bench::addresses(1 << 16, footprint);
+    size_t next = 0;
+    int64_t sum = 0;
+    for (auto _ : state) {
+        auto it = map.contains(addrs[next] % footprint);
+        if (it != map.end())
+            sum += it->second;
+        next = (next + 1) % addrs.size();
+    }
+    Bench::doNotOptimize(sum);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(addrRangeMapLookup)->range(2, 512);
@@ -44,11 +44,13 @@
 #ifndef __BASE_ADDR_RANGE_MAP_HH__
 #define __BASE_ADDR_RANGE_MAP_HH__
 
+#include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <list>
 #include <map>
 #include <utility>
+#include <vector>
 
 #include "base/addr_range.hh"
 #include "base/types.hh"
@@ -57,6 +59,13 @@
  * The AddrRangeMap uses an STL map to implement an interval tree for
  * address decoding. The value stored is a template type and can be
  * e.g. a port identifier, or a pointer.
+ *
+ * Containment lookups, which is what address decoding uses, do not
+ * walk the tree. The map also keeps a flat, sorted array of the
+ * address intervals it covers, where all the interleaved ranges that
+ * merge into one interval share a single slot. A lookup is a binary
+ * search for the slot, followed by extracting the interleaving bits of
+ * the address to index the ranges of the slot.
  */
 template <typename V, int max_cache_size=0>
 class AddrRangeMap
@@ -81,12 +90,20 @@ class AddrRangeMap
     const_iterator
     contains(const AddrRange &r) const
     {
-        return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+        return const_cast<AddrRangeMap *>(this)->contains(r);
     }
     iterator
     contains(const AddrRange &r)
     {
-        return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+        if (r.interleaved())
+            return find(r, [r](const AddrRange r1) { return r.isSubset(r1); });
+
+        // the ranges in the map never overlap, so the only candidate
+        // is the range holding the first address
+        iterator it = lookup(r.start());
+        if (it != end() && r.isSubset(it->first))
+            return it;
+        return end();
     }
 
     /**
@@ -102,12 +119,12 @@ class AddrRangeMap
     const_iterator
     contains(Addr r) const
     {
-        return contains(RangeSize(r, 1));
+        return const_cast<AddrRangeMap *>(this)->lookup(r);
     }
     iterator
     contains(Addr r)
     {
-        return contains(RangeSize(r, 1));
+        return lookup(r);
     }
 
     /**
@@ -137,29 +154,31 @@ class AddrRangeMap
         if (intersects(r) != end())
             return tree.end();
 
-        return tree.insert(std::make_pair(r, d)).first;
+        iterator it = tree.insert(std::make_pair(r, d)).first;
+        addToSlots(it);
+        return it;
     }
 
     void
     erase(iterator p)
     {
         cache.remove(p);
+        removeFromSlots(p);
         tree.erase(p);
     }
 
     void
     erase(iterator p, iterator q)
     {
-        for (auto it = p; it != q; it++) {
-            cache.remove(p);
-        }
-        tree.erase(p,q);
+        while (p != q)
+            erase(p++);
     }
 
     void
     clear()
     {
         cache.erase(cache.begin(), cache.end());
+        slots.clear();
         tree.erase(tree.begin(), tree.end());
     }
 
@@ -200,6 +219,93 @@ class AddrRangeMap
     }
 
   private:
+    /**
+     * An interval of the address space covered by the map, holding
+     * either a single range that is not interleaved, or all the
+     * interleaved ranges that merge into the interval, indexed by
+     * their interleaving match value.
+     */
+    struct Slot
+    {
+        /** One of the ranges in the slot, used for its masks */
+        AddrRange range;
+
+        /** Map entries indexed by interleaving match value */
+        std::vector<iterator> entries;
+
+        /** Number of entries that are in the map */
+        unsigned used;
+    };
+
+    /**
+     * Find the slot covering an address.
+     *
+     * @param a An input address
+     * @return An iterator to the slot, or slots.end() if none
+     */
+    typename std::vector<Slot>::iterator
+    findSlot(Addr a)
+    {
+        // find the first slot starting after the address and step
+        // back to the one that may cover it
+        auto s = std::upper_bound(slots.begin(), slots.end(), a,
+                                  [](Addr addr, const Slot &slot)
+                                  { return addr < slot.range.start(); });
+        if (s == slots.begin())
+            return slots.end();
+        --s;
+        return a <= s->range.end() ? s : slots.end();
+    }
+
+    /**
+     * Find the entry whose range contains an address using the slots.
+     *
+     * @param a An input address
+     * @return An iterator to the entry, or end() if none
+     */
+    iterator
+    lookup(Addr a)
+    {
+        auto s = findSlot(a);
+        if (s == slots.end())
+            return end();
+        return s->entries[s->range.intlvSelect(a)];
+    }
+
+    /**
+     * Add a newly inserted entry to its slot, creating the slot if
+     * this is the first range of its interval.
+     */
+    void
+    addToSlots(iterator it)
+    {
+        const AddrRange &r = it->first;
+        auto s = std::lower_bound(slots.begin(), slots.end(), r.start(),
+                                  [](const Slot &slot, Addr addr)
+                                  { return slot.range.start() < addr; });
+        if (s == slots.end() || s->range.start() != r.start()) {
+            // entries that do not intersect with an existing one but
+            // start at the same address have to merge with it
+            s = slots.insert(s, Slot{r, std::vector<iterator>(r.stripes(),
+                                                              end()), 0});
+        }
+        s->entries[r.getIntlvMatch()] = it;
+        ++s->used;
+    }
+
+    /**
+     * Remove an entry from its slot, and drop the slot when it
+     * becomes empty.
+     */
+    void
+    removeFromSlots(iterator it)
+    {
+        auto s = findSlot(it->first.start());
+        s->entries[it->first.getIntlvMatch()] = end();
+        if (--s->used == 0)
+            slots.erase(s);
+    }
+
     /**
      * Add an address range map entry to the cache.
      *
@@ -281,6 +387,9 @@ class AddrRangeMap
 
     RangeMap tree;
 
+    /** Intervals covered by the map, sorted by start address */
+    std::vector<Slot> slots;
+
     /**
      * A list of iterator that correspond to the max_cache_size most
      * recently used entries in the address range map. This mainly
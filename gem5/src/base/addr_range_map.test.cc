@@ -68,3 +68,85 @@ TEST(AddrRangeMapTest, LegacyTests)
 
     EXPECT_NE(r.contains(RangeIn(20, 30)), r.end());
 }
+
+namespace {
+
+/**
+ * Reference lookup walking all the entries of the map.
+ */
+template <typename M>
+typename M::const_iterator
+bruteForceContains(const M &m, Addr a)
+{
+    for (auto it = m.begin(); it != m.end(); ++it) {
+        if (it->first.contains(a))
+            return it;
+    }
+    return m.end();
+}
+
+} // anonymous namespace
+
+TEST(AddrRangeMapTest, InterleavedLookup)
+{
+    AddrRangeMap<int> r;
+
+    // four channels interleaved on an xor of two bits and one bit,
+    // followed by a plain range and a pair of channels interleaved on
+    // a single bit
+    const std::vector<Addr> masks = { 1 << 6 | 1 << 12, 1 << 7 };
+    for (int i = 0; i < 4; ++i)
+        ASSERT_NE(r.insert(AddrRange(0x0, 0xffff, masks, i), i), r.end());
+    ASSERT_NE(r.insert(RangeIn(0x10000, 0x17fff), 4), r.end());
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_NE(r.insert(AddrRange(0x20000, 0x2ffff, { 1 << 8 }, i),
+                           5 + i), r.end());
+    }
+
+    for (Addr a = 0; a < 0x30000; a += 4) {
+        auto it = r.contains(a);
+        ASSERT_EQ(it, bruteForceContains(r, a)) << "address " << a;
+        if (it != r.end())
+            EXPECT_TRUE(it->first.contains(a));
+    }
+    EXPECT_EQ(r.contains(0x18000), r.end());
+    EXPECT_EQ(r.contains(0x30000), r.end());
+
+    // a block within one stripe is part of a single channel, while a
+    // block crossing a stripe boundary is not part of any of them
+    auto it = r.contains(RangeSize(0x1040, 64));
+    ASSERT_NE(it, r.end());
+    EXPECT_EQ(it, r.contains(0x1040));
+    EXPECT_EQ(r.contains(RangeSize(0x1020, 64)), r.end());
+    EXPECT_EQ(r.contains(RangeSize(0x10ff0, 0x20)), r.contains(0x10ff0));
+    EXPECT_EQ(r.contains(RangeSize(0x17ff0, 0x20)), r.end());
+}
+
+TEST(AddrRangeMapTest, EraseInterleaved)
+{
+    AddrRangeMap<int> r;
+
+    const std::vector<Addr> masks = { 1 << 6 };
+    auto first = r.insert(AddrRange(0x0, 0xfff, masks, 0), 0);
+    auto second = r.insert(AddrRange(0x0, 0xfff, masks, 1), 1);
+    ASSERT_NE(first, r.end());
+    ASSERT_NE(second, r.end());
+
+    r.erase(first);
+    EXPECT_EQ(r.contains(0x0), r.end());
+    ASSERT_NE(r.contains(0x40), r.end());
+    EXPECT_EQ(r.contains(0x40)->second, 1);
+
+    // the freed stripes can be taken by a new entry
+    ASSERT_NE(r.insert(AddrRange(0x0, 0xfff, masks, 0), 2), r.end());
+    EXPECT_EQ(r.contains(0x0)->second, 2);
+
+    r.erase(r.begin(), r.end());
+    EXPECT_TRUE(r.empty());
+    EXPECT_EQ(r.contains(0x40), r.end());
+
+    ASSERT_NE(r.insert(RangeIn(0x0, 0xfff), 3), r.end());
+    EXPECT_EQ(r.contains(0x40)->second, 3);
+    r.clear();
+    EXPECT_EQ(r.contains(0x40), r.end());
+}
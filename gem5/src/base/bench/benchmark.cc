@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/bench/benchmark.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <regex>
+#include <sstream>
+
+namespace Bench {
+
+namespace {
+
+std::vector<std::unique_ptr<Benchmark>> &
+registry()
+{
+    static std::vector<std::unique_ptr<Benchmark>> benchmarks;
+    return benchmarks;
+}
+
+/** Addresses read from --bench_trace, empty if there is none */
+std::vector<Addr> traceAddrs;
+
+/**
+ * Parse the address of a trace line, either a lone address, or the
+ * "[id,]cmd,addr,size,..." format of util/decode_packet_trace.py.
+ */
+bool
+parseAddr(const std::string &line, Addr &addr)
+{
+    std::vector<std::string> fields;
+    std::istringstream is(line);
+    std::string field;
+    while (std::getline(is, field, ','))
+        fields.push_back(field);
+
+    size_t pos = 0;
+    if (fields.size() > 1) {
+        // the address follows the command
+        while (pos < fields.size() && fields[pos] != "r" &&
+               fields[pos] != "w" && fields[pos] != "u")
+            ++pos;
+        ++pos;
+    }
+    if (pos >= fields.size())
+        return false;
+
+    char *end;
+    addr = std::strtoull(fields[pos].c_str(), &end, 0);
+    return end != fields[pos].c_str();
+}
+
+void
+loadTrace(const std::string &path)
+{
+    std::ifstream trace(path);
+    if (!trace) {
+        std::cerr << "Cannot open trace " << path << std::endl;
+        std::exit(1);
+    }
+
+    std::string line;
+    Addr addr;
+    while (std::getline(trace, line)) {
+        if (parseAddr(line, addr))
+            traceAddrs.push_back(addr);
+    }
+
+    if (traceAddrs.empty()) {
+        std::cerr << "No addresses in trace " << path << std::endl;
+        std::exit(1);
+    }
+}
+
+std::string
+runName(const Benchmark &bench, const std::vector<int64_t> &args)
+{
+    std::string name = bench.name;
+    for (auto arg : args)
+        name += "/" + std::to_string(arg);
+    return name;
+}
+
+/**
+ * Run a benchmark with growing iteration counts until it takes the
+ * minimum time, and report the last run.
+ */
+void
+run(const Benchmark &bench, const std::vector<int64_t> &args,
+    double min_time)
+{
+    const uint64_t max_iterations = 1000000000;
+    uint64_t iterations = 1;
+
+    while (true) {
+        State state(iterations, args);
+        bench.function(state);
+
+        const double elapsed = state.elapsed();
+        if (elapsed >= min_time || iterations >= max_iterations) {
+            std::printf("%-40s %12llu %14.1f ns", runName(bench, args).c_str(),
+                        (unsigned long long)iterations,
+                        elapsed * 1e9 / iterations);
+            if (state.itemsProcessed())
+                std::printf(" %12.3f M items/s",
+                            state.itemsProcessed() / elapsed / 1e6);
+            std::printf("\n");
+            return;
+        }
+
+        // Aim a bit past the minimum time, and grow at most tenfold
+        // while the run is too short to predict from
+        double multiplier = 10;
+        if (elapsed > min_time / 10)
+            multiplier = std::min(10.0, 1.4 * min_time / elapsed);
+        iterations = std::min<uint64_t>(max_iterations,
+            std::max<uint64_t>(iterations + 1, iterations * multiplier));
+    }
+}
+
+} // anonymous namespace
+
+State::State(uint64_t max_iterations, const std::vector<int64_t> &_args)
+    : maxIterations(max_iterations), args(_args), running(false),
+      _elapsed(0), _items(0)
+{
+}
+
+State::Iterator
+State::begin()
+{
+    resumeTiming();
+    return Iterator(this, maxIterations);
+}
+
+void
+State::pauseTiming()
+{
+    if (running) {
+        _elapsed += Clock::now() - start;
+        running = false;
+    }
+}
+
+void
+State::resumeTiming()
+{
+    if (!running) {
+        running = true;
+        start = Clock::now();
+    }
+}
+
+Benchmark *
+Benchmark::arg(int64_t value)
+{
+    argSets.push_back({ value });
+    return this;
+}
+
+Benchmark *
+Benchmark::args(const std::vector<int64_t> &values)
+{
+    argSets.push_back(values);
+    return this;
+}
+
+Benchmark *
+Benchmark::range(int64_t low, int64_t high, int64_t multiplier)
+{
+    for (int64_t value = low; value < high; value *= multiplier)
+        arg(value);
+    return arg(high);
+}
+
+Benchmark *
+registerBenchmark(const std::string &name, Function function)
+{
+    registry().emplace_back(new Benchmark(name, function));
+    return registry().back().get();
+}
+
+std::vector<Addr>
+addresses(size_t count, Addr footprint, Addr block_size)
+{
+    std::vector<Addr> addrs;
+    addrs.reserve(count);
+
+    if (!traceAddrs.empty()) {
+        for (size_t i = 0; i < count; ++i)
+            addrs.push_back(traceAddrs[i % traceAddrs.size()]);
+        return addrs;
+    }
+
+    // A fixed seed keeps the runs comparable
+    std::mt19937_64 rng(1);
+    const Addr blocks = std::max<Addr>(footprint / block_size, 1);
+    const Addr hot_blocks = std::max<Addr>(blocks / 5, 1);
+    std::uniform_int_distribution<unsigned> hot(0, 99);
+    for (size_t i = 0; i < count; ++i) {
+        const Addr range = hot(rng) < 80 ? hot_blocks : blocks;
+        addrs.push_back(
+            std::uniform_int_distribution<Addr>(0, range - 1)(rng) *
+            block_size);
+    }
+    return addrs;
+}
+
+} // namespace Bench
+
+int
+main(int argc, char **argv)
+{
+    std::string filter = ".*";
+    double min_time = 0.5;
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string opt(argv[i]);
+        auto value = [&opt]() { return opt.substr(opt.find('=') + 1); };
+        if (opt.compare(0, 15, "--bench_filter=") == 0) {
+            filter = value();
+        } else if (opt.compare(0, 17, "--bench_min_time=") == 0) {
+            min_time = std::atof(value().c_str());
+        } else if (opt.compare(0, 14, "--bench_trace=") == 0) {
+            Bench::loadTrace(value());
+        } else if (opt == "--bench_list") {
+            list = true;
+        } else {
+            std::cerr << "Unknown option " << opt << std::endl;
+            return 1;
+        }
+    }
+
+    const std::regex re(filter);
+    if (!list)
+        std::printf("%-40s %12s %17s\n", "Benchmark", "Iterations", "Time");
+
+    for (auto &bench : Bench::registry()) {
+        std::vector<std::vector<int64_t>> arg_sets = bench->argSets;
+        if (arg_sets.empty())
+            arg_sets.emplace_back();
+
+        for (auto &args : arg_sets) {
+            const std::string name = Bench::runName(*bench, args);
+            if (!std::regex_search(name, re))
+                continue;
+            if (list)
+                std::printf("%s\n", name.c_str());
+            else
+                Bench::run(*bench, args, min_time);
+        }
+    }
+
+    return 0;
+}
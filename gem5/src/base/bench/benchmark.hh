@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Microbenchmark harness, in the style of Google Benchmark
+ */
+
+#ifndef __BASE_BENCH_BENCHMARK_HH__
+#define __BASE_BENCH_BENCHMARK_HH__
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/compiler.hh"
+#include "base/types.hh"
+
+/**
+ * Microbenchmarks time a core data structure in isolation, so that an
+ * optimization of the structure can be evaluated without simulating
+ * a whole system. A benchmark is a function taking a Bench::State,
+ * with the code to time in a loop over the state:
+ *
+ * <pre>
+ * static void
+ * queuePush(Bench::State &state)
+ * {
+ *     CircularQueue<int> queue(state.arg());
+ *     for (auto _ : state) {
+ *         ...
+ *     }
+ *     state.setItemsProcessed(state.iterations());
+ * }
+ * BENCHMARK(queuePush)->arg(16)->arg(1024);
+ * </pre>
+ *
+ * The harness picks the number of iterations so that each benchmark
+ * runs for a minimum time, and reports the time per iteration. The
+ * benchmarks are built with the GBench SCons target, next to the unit
+ * tests, and the binaries take the following options:
+ *
+ * --bench_filter=<regex>  only run the matching benchmarks
+ * --bench_min_time=<s>    minimum time of each benchmark (0.5s)
+ * --bench_trace=<file>    addresses to use instead of synthetic ones
+ * --bench_list            list the benchmarks and exit
+ *
+ * The trace holds one address per line, or is the text output of
+ * util/decode_packet_trace.py, so the address stream of a recorded
+ * simulation can be replayed against a data structure.
+ */
+namespace Bench {
+
+class State
+{
+  public:
+    /** The (empty) value of each iteration of the benchmark loop */
+    struct M5_VAR_USED Value {};
+
+    class Iterator
+    {
+      private:
+        State *state;
+        uint64_t left;
+
+      public:
+        Iterator(State *_state, uint64_t _left)
+            : state(_state), left(_left)
+        {}
+
+        Value operator*() const { return Value(); }
+        Iterator &operator++() { --left; return *this; }
+
+        bool
+        operator!=(const Iterator &other) const
+        {
+            if (left)
+                return true;
+            state->pauseTiming();
+            return false;
+        }
+    };
+
+    State(uint64_t max_iterations, const std::vector<int64_t> &args);
+
+    /** Start the benchmark loop, and the timer */
+    Iterator begin();
+    Iterator end() { return Iterator(nullptr, 0); }
+
+    /** Stop timing, e.g. to set up the next iteration */
+    void pauseTiming();
+    void resumeTiming();
+
+    /** Number of iterations of the benchmark loop */
+    uint64_t iterations() const { return maxIterations; }
+
+    /** Get an argument of the benchmark */
+    int64_t arg(size_t i = 0) const { return args.at(i); }
+
+    /** Report a rate of items processed, e.g. lookups */
+    void setItemsProcessed(uint64_t items) { _items = items; }
+    uint64_t itemsProcessed() const { return _items; }
+
+    /** Seconds spent in the timed part of the benchmark loop */
+    double elapsed() const { return _elapsed.count(); }
+
+  private:
+    typedef std::chrono::steady_clock Clock;
+
+    const uint64_t maxIterations;
+    const std::vector<int64_t> args;
+
+    bool running;
+    Clock::time_point start;
+    std::chrono::duration<double> _elapsed;
+    uint64_t _items;
+};
+
+typedef void (*Function)(State &);
+
+/** A registered benchmark and the arguments to run it with */
+class Benchmark
+{
+  public:
+    Benchmark(const std::string &_name, Function _function)
+        : name(_name), function(_function)
+    {}
+
+    /** Run the benchmark with another argument */
+    Benchmark *arg(int64_t value);
+
+    /** Run the benchmark with several arguments at once */
+    Benchmark *args(const std::vector<int64_t> &values);
+
+    /**
+     * Run the benchmark with the powers of multiplier in the range
+     * [low, high], plus high itself.
+     */
+    Benchmark *range(int64_t low, int64_t high, int64_t multiplier = 8);
+
+    const std::string name;
+    const Function function;
+
+    /** One set of arguments per run, none if it takes no argument */
+    std::vector<std::vector<int64_t>> argSets;
+};
+
+Benchmark *registerBenchmark(const std::string &name, Function function);
+
+/**
+ * Keep the compiler from optimizing a value away. The value is
+ * considered to be read by the barrier.
+ */
+template <class T>
+inline void
+doNotOptimize(const T &value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/** Keep the compiler from optimizing memory writes away */
+inline void
+clobberMemory()
+{
+    asm volatile("" : : : "memory");
+}
+
+/**
+ * Get a stream of addresses to access a data structure with. If a
+ * trace was given with --bench_trace, its addresses are replayed,
+ * wrapping around as needed. Otherwise the addresses are random,
+ * block aligned, and 80% of them fall in 20% of the footprint, which
+ * roughly mimics the locality of a program.
+ *
+ * @param count Number of addresses
+ * @param footprint Range of the synthetic addresses in bytes
+ * @param block_size Alignment of the synthetic addresses
+ */
+std::vector<Addr> addresses(size_t count, Addr footprint = 64 << 20,
+                            Addr block_size = 64);
+
+} // namespace Bench
+
+#define BENCHMARK_CONCAT2(a, b) a##b
+#define BENCHMARK_CONCAT(a, b) BENCHMARK_CONCAT2(a, b)
+
+/** Register a benchmark function */
+#define BENCHMARK(function)                                              \
+    static Bench::Benchmark *BENCHMARK_CONCAT(benchmark_, __LINE__)      \
+    M5_VAR_USED = Bench::registerBenchmark(#function, function)
+
+#endif // __BASE_BENCH_BENCHMARK_HH__
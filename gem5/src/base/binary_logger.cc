@@ -0,0 +1,287 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "base/binary_logger.hh"
+
+#include <chrono>
+#include <cstring>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+
+namespace Trace {
+
+namespace {
+
+const char binaryMagic[] = "GDTB";
+const uint32_t binaryVersion = 1;
+
+/** Format used for the messages that are already formatted */
+const char messageFormat[] = "%s";
+
+/** State of the calling thread, valid if owned by the logger */
+__thread BinaryLogger *stateOwner = nullptr;
+__thread void *stateRing = nullptr;
+__thread void *stateCache = nullptr;
+
+void
+putU32(char *buf, size_t &pos, uint32_t val)
+{
+    for (int i = 0; i < 4; ++i)
+        buf[pos++] = (val >> (8 * i)) & 0xff;
+}
+
+void
+putU32(std::string &buf, uint32_t val)
+{
+    for (int i = 0; i < 4; ++i)
+        buf.push_back((val >> (8 * i)) & 0xff);
+}
+
+} // anonymous namespace
+
+BinaryLogger::BinaryLogger(std::ostream &_stream)
+    : stream(_stream), lineBuf(*this), lineStream(&lineBuf),
+      stopping(false)
+{
+    rawArgs = true;
+
+    std::string header(binaryMagic, 4);
+    putU32(header, binaryVersion);
+    stream.write(header.data(), header.size());
+
+    writer = std::thread([this] { writerLoop(); });
+
+    registerExitCallback(
+        new MakeCallback<BinaryLogger, &BinaryLogger::close>(this, true));
+}
+
+BinaryLogger::~BinaryLogger()
+{
+    close();
+}
+
+void
+BinaryLogger::close()
+{
+    if (!writer.joinable())
+        return;
+
+    stopping.store(true, std::memory_order_release);
+    writer.join();
+}
+
+void
+BinaryLogger::threadState(Ring *&ring, IdCache *&cache)
+{
+    if (stateOwner != this) {
+        std::lock_guard<std::mutex> guard(lock);
+        rings.emplace_back(new Ring());
+        caches.emplace_back(new IdCache());
+        stateOwner = this;
+        stateRing = rings.back().get();
+        stateCache = caches.back().get();
+    }
+
+    ring = static_cast<Ring *>(stateRing);
+    cache = static_cast<IdCache *>(stateCache);
+}
+
+void
+BinaryLogger::define(char tag, uint32_t id, const std::string &str)
+{
+    pendingDefs.push_back(tag);
+    putU32(pendingDefs, id);
+    putU32(pendingDefs, str.size());
+    pendingDefs.append(str);
+}
+
+uint32_t
+BinaryLogger::formatId(IdCache &cache, const char *fmt)
+{
+    // The format strings are almost always literals, but check the
+    // contents in case the pointer was reused for another string.
+    auto it = cache.formats.find(fmt);
+    if (it != cache.formats.end() && std::strcmp(it->second.first, fmt) == 0)
+        return it->second.second;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto ins = formatIds.emplace(fmt, formatIds.size());
+    if (ins.second)
+        define('F', ins.first->second, ins.first->first);
+
+    cache.formats[fmt] = std::make_pair(ins.first->first.c_str(),
+                                        ins.first->second);
+    return ins.first->second;
+}
+
+uint32_t
+BinaryLogger::nameId(IdCache &cache, const std::string &name)
+{
+    if (name.empty())
+        return 0;
+
+    auto it = cache.names.find(name.data());
+    if (it != cache.names.end() && it->second.first == name)
+        return it->second.second;
+
+    std::lock_guard<std::mutex> guard(lock);
+    // Id 0 is the empty name
+    auto ins = nameIds.emplace(name, nameIds.size() + 1);
+    if (ins.second)
+        define('N', ins.first->second, name);
+
+    cache.names[name.data()] = std::make_pair(name, ins.first->second);
+    return ins.first->second;
+}
+
+void
+BinaryLogger::push(Ring &ring, const char *data, size_t size)
+{
+    const uint64_t pos = ring.produced.load(std::memory_order_relaxed);
+    while (pos + size - ring.consumed.load(std::memory_order_acquire) >
+           Ring::Size) {
+        std::this_thread::yield();
+    }
+
+    const size_t off = pos % Ring::Size;
+    const size_t first = size < Ring::Size - off ? size : Ring::Size - off;
+    std::memcpy(ring.data.get() + off, data, first);
+    std::memcpy(ring.data.get(), data + first, size - first);
+
+    ring.produced.store(pos + size, std::memory_order_release);
+}
+
+void
+BinaryLogger::logRaw(Tick when, const std::string &name, const char *fmt,
+                     const RawArgs &args)
+{
+    // Nothing is written out once the logger has been closed
+    if (stopping.load(std::memory_order_relaxed))
+        return;
+
+    Ring *ring;
+    IdCache *cache;
+    threadState(ring, cache);
+
+    char record[RawArgs::MaxSize + 32];
+    size_t pos = 0;
+    record[pos++] = 'R';
+    for (int i = 0; i < 8; ++i)
+        record[pos++] = (when >> (8 * i)) & 0xff;
+    putU32(record, pos, formatId(*cache, fmt));
+    putU32(record, pos, nameId(*cache, name));
+    record[pos++] = args.size() & 0xff;
+    record[pos++] = (args.size() >> 8) & 0xff;
+    std::memcpy(record + pos, args.data(), args.size());
+    pos += args.size();
+
+    push(*ring, record, pos);
+}
+
+void
+BinaryLogger::logMessage(Tick when, const std::string &name,
+                         const std::string &message)
+{
+    if (!name.empty() && ignore.match(name))
+        return;
+
+    RawArgs args;
+    args.add(message);
+    logRaw(when, name, messageFormat, args);
+}
+
+int
+BinaryLogger::LineBuf::overflow(int c)
+{
+    if (c == traits_type::eof())
+        return traits_type::not_eof(c);
+
+    line.push_back(c);
+    if (c == '\n') {
+        logger.logMessage(MaxTick, std::string(), line);
+        line.clear();
+    }
+    return c;
+}
+
+void
+BinaryLogger::writerLoop()
+{
+    std::vector<std::pair<Ring *, uint64_t>> ends;
+    std::string defs;
+
+    while (true) {
+        const bool stop = stopping.load(std::memory_order_acquire);
+
+        // Take the end of the rings before the definitions, so that
+        // every record written below has its definitions written
+        // before it.
+        ends.clear();
+        defs.clear();
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            for (auto &ring : rings) {
+                ends.emplace_back(ring.get(), ring->produced.load(
+                                      std::memory_order_acquire));
+            }
+            defs.swap(pendingDefs);
+        }
+
+        stream.write(defs.data(), defs.size());
+
+        uint64_t written = 0;
+        for (auto &end : ends) {
+            Ring &ring = *end.first;
+            const uint64_t begin =
+                ring.consumed.load(std::memory_order_relaxed);
+            uint64_t pos = begin;
+            while (pos < end.second) {
+                const size_t off = pos % Ring::Size;
+                const size_t avail = end.second - pos;
+                const size_t size =
+                    avail < Ring::Size - off ? avail : Ring::Size - off;
+                stream.write(ring.data.get() + off, size);
+                pos += size;
+            }
+            ring.consumed.store(pos, std::memory_order_release);
+            written += pos - begin;
+        }
+
+        if (stop && written == 0 && defs.empty())
+            break;
+
+        if (written == 0)
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    stream.flush();
+}
+
+} // namespace Trace
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_BINARY_LOGGER_HH__
+#define __BASE_BINARY_LOGGER_HH__
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "base/trace.hh"
+
+namespace Trace {
+
+/**
+ * Debug logger that writes records with the raw arguments of the
+ * messages instead of formatting them. The format string of a message
+ * and the name of the object logging it are written once, the first
+ * time they are used, and then referred to by an id. Records go to a
+ * ring buffer of the thread logging them, and a background thread
+ * writes the rings out, so the simulation threads never wait on the
+ * file unless a ring fills up. util/decode_debug_trace.py formats the
+ * records offline.
+ *
+ * The file starts with the magic "GDTB" and a 32-bit version,
+ * followed by records starting with a one byte tag. Integers are
+ * little endian and strings are stored as a 32-bit length followed by
+ * the characters.
+ * <ul>
+ * <li>'F': a format string, made of its 32-bit id and the string.
+ * <li>'N': an object name, made of its 32-bit id and the name. Id 0
+ *     is the empty name.
+ * <li>'R': a message, made of the 64-bit tick (MaxTick if it has
+ *     none), the 32-bit format and name ids, the 16-bit size of the
+ *     arguments and the arguments, encoded as in RawArgs.
+ * </ul>
+ * Messages logged by different threads are not ordered in the file.
+ */
+class BinaryLogger : public Logger
+{
+  public:
+    BinaryLogger(std::ostream &stream);
+    ~BinaryLogger();
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) override;
+
+    void logRaw(Tick when, const std::string &name, const char *fmt,
+                const RawArgs &args) override;
+
+    /** Lines written to the stream are logged as messages */
+    std::ostream &getOstream() override { return lineStream; }
+
+    /** Write out all the messages and stop the writer thread */
+    void close();
+
+  protected:
+    /** Buffer of the records of a thread */
+    struct Ring
+    {
+        static const size_t Size = 1 << 20;
+
+        std::unique_ptr<char[]> data;
+
+        /** Number of bytes written and read since the creation */
+        std::atomic<uint64_t> produced;
+        std::atomic<uint64_t> consumed;
+
+        Ring() : data(new char[Size]), produced(0), consumed(0) {}
+    };
+
+    /** Stream buffer that logs a message for every line */
+    class LineBuf : public std::streambuf
+    {
+      protected:
+        BinaryLogger &logger;
+        std::string line;
+
+        int overflow(int c) override;
+
+      public:
+        LineBuf(BinaryLogger &_logger) : logger(_logger) {}
+    };
+
+    /** Per-thread cache of the ids of the format strings and names */
+    struct IdCache
+    {
+        std::unordered_map<const char *, std::pair<const char *, uint32_t>>
+            formats;
+        std::unordered_map<const char *, std::pair<std::string, uint32_t>>
+            names;
+    };
+
+    /** Get the ring and id cache of the calling thread */
+    void threadState(Ring *&ring, IdCache *&cache);
+
+    uint32_t formatId(IdCache &cache, const char *fmt);
+    uint32_t nameId(IdCache &cache, const std::string &name);
+
+    /** Queue a definition for the writer, with the lock held */
+    void define(char tag, uint32_t id, const std::string &str);
+
+    void push(Ring &ring, const char *data, size_t size);
+
+    void writerLoop();
+
+    std::ostream &stream;
+
+    LineBuf lineBuf;
+    std::ostream lineStream;
+
+    /** Protects the fields below */
+    std::mutex lock;
+    std::vector<std::unique_ptr<Ring>> rings;
+    std::vector<std::unique_ptr<IdCache>> caches;
+    std::unordered_map<std::string, uint32_t> formatIds;
+    std::unordered_map<std::string, uint32_t> nameIds;
+    /** Definitions that haven't been written yet */
+    std::string pendingDefs;
+
+    std::atomic<bool> stopping;
+    std::thread writer;
+};
+
+} // namespace Trace
+
+#endif // __BASE_BINARY_LOGGER_HH__
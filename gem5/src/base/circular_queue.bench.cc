@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/bench/benchmark.hh"
+#include "base/circular_queue.hh"
+
+/** A queue in steady state, as in a pipeline stage */
+static void
+circularQueuePushPop(Bench::State &state)
+{
+    CircularQueue<uint64_t> queue(state.arg());
+    while (!queue.full())
+        queue.push_back(0);
+
+    uint64_t value = 0;
+    for (auto _ : state) {
+        value += queue.front();
+        queue.pop_front();
+        queue.push_back(value);
+    }
+    Bench::doNotOptimize(value);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(circularQueuePushPop)->range(8, 1024);
+
+/** Walk the queue from head to tail, as when searching for a match */
+static void
+circularQueueIterate(Bench::State &state)
+{
+    CircularQueue<uint64_t> queue(state.arg());
+    while (!queue.full())
+        queue.push_back(queue.size());
+
+    uint64_t sum = 0;
+    for (auto _ : state) {
+        for (auto it = queue.begin(); it != queue.end(); ++it)
+            sum += *it;
+    }
+    Bench::doNotOptimize(sum);
+    state.setItemsProcessed(state.iterations() * queue.size());
+}
+BENCHMARK(circularQueueIterate)->range(8, 1024);
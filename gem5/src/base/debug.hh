@@ -82,6 +82,9 @@ class SimpleFlag : public Flag
 
     static void enableAll();
     static void disableAll();
+
+    /** Are debug tracings enabled? */
+    static bool active() { return _active; }
 };
 
 class CompoundFlag : public Flag
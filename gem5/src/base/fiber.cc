@@ -47,11 +47,100 @@
 #include <cerrno>
 #include <cstdio>
 #include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
 
 #include "base/logging.hh"
 
 using namespace std;
 
+#if M5_FIBER_ASM_SWITCH
+
+/*
+ * Save the callee saved registers and the floating point control state on
+ * the current stack, store the stack pointer in *from_sp, then switch to
+ * to_sp and restore the state saved there. Everything else is clobbered by
+ * the call as far as the compiler is concerned.
+ */
+extern "C" void m5_fiber_switch(void **from_sp, void *to_sp);
+
+#if defined(__x86_64__)
+
+// Frame: mxcsr and x87 control word, r15, r14, r13, r12, rbx, rbp, return
+// address.
+asm(".text\n"
+    ".globl m5_fiber_switch\n"
+    ".hidden m5_fiber_switch\n"
+    ".type m5_fiber_switch, @function\n"
+    "m5_fiber_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $8, %rsp\n"
+    "    stmxcsr (%rsp)\n"
+    "    fnstcw 4(%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    ldmxcsr (%rsp)\n"
+    "    fldcw 4(%rsp)\n"
+    "    addq $8, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size m5_fiber_switch, .-m5_fiber_switch\n");
+
+#elif defined(__aarch64__)
+
+// Frame: x19-x28, fp, lr, d8-d15 and fpcr, padded to 16 bytes.
+asm(".text\n"
+    ".globl m5_fiber_switch\n"
+    ".hidden m5_fiber_switch\n"
+    ".type m5_fiber_switch, %function\n"
+    "m5_fiber_switch:\n"
+    "    sub sp, sp, #176\n"
+    "    stp x19, x20, [sp, #0]\n"
+    "    stp x21, x22, [sp, #16]\n"
+    "    stp x23, x24, [sp, #32]\n"
+    "    stp x25, x26, [sp, #48]\n"
+    "    stp x27, x28, [sp, #64]\n"
+    "    stp x29, x30, [sp, #80]\n"
+    "    stp d8, d9, [sp, #96]\n"
+    "    stp d10, d11, [sp, #112]\n"
+    "    stp d12, d13, [sp, #128]\n"
+    "    stp d14, d15, [sp, #144]\n"
+    "    mrs x2, fpcr\n"
+    "    str x2, [sp, #160]\n"
+    "    mov x2, sp\n"
+    "    str x2, [x0]\n"
+    "    mov sp, x1\n"
+    "    ldr x2, [sp, #160]\n"
+    "    msr fpcr, x2\n"
+    "    ldp x19, x20, [sp, #0]\n"
+    "    ldp x21, x22, [sp, #16]\n"
+    "    ldp x23, x24, [sp, #32]\n"
+    "    ldp x25, x26, [sp, #48]\n"
+    "    ldp x27, x28, [sp, #64]\n"
+    "    ldp x29, x30, [sp, #80]\n"
+    "    ldp d8, d9, [sp, #96]\n"
+    "    ldp d10, d11, [sp, #112]\n"
+    "    ldp d12, d13, [sp, #128]\n"
+    "    ldp d14, d15, [sp, #144]\n"
+    "    add sp, sp, #176\n"
+    "    ret\n"
+    ".size m5_fiber_switch, .-m5_fiber_switch\n");
+
+#endif
+
+#endif // M5_FIBER_ASM_SWITCH
+
 namespace
 {
 
@@ -75,6 +164,23 @@ Fiber *_currentFiber = &_primaryFiber;
 // A pointer to the Fiber which is currently being started/initialized.
 Fiber *startingFiber = nullptr;
 
+/*
+ * Short lived fibers (e.g. coroutines created for every transaction of a
+ * device model) would otherwise pay for an mmap, an mprotect and a munmap
+ * each. Keep a bounded number of released stacks, guard page included,
+ * and hand them out again to fibers asking for the same stack size.
+ */
+const size_t maxCachedStacks = 64;
+
+std::vector<std::pair<void *, size_t>> &
+stackCache()
+{
+    // Never destroyed, so that fibers with static storage duration can
+    // still release their stack at exit.
+    static auto *cache = new std::vector<std::pair<void *, size_t>>;
+    return *cache;
+}
+
 } // anonymous namespace
 
 void
@@ -90,7 +196,17 @@ Fiber::Fiber(Fiber *link, size_t stack_size) :
     link(link), stack(nullptr), stackSize(stack_size), guardPage(nullptr),
     guardPageSize(sysconf(_SC_PAGE_SIZE)), _started(false), _finished(false)
 {
-    if (stack_size) {
+    auto &cache = stackCache();
+    for (auto it = cache.rbegin(); stack_size && it != cache.rend(); ++it) {
+        if (it->second == stack_size) {
+            guardPage = it->first;
+            stack = (void *)((uint8_t *)guardPage + guardPageSize);
+            cache.erase(std::next(it).base());
+            break;
+        }
+    }
+
+    if (stack_size && !guardPage) {
         guardPage = mmap(nullptr, guardPageSize + stack_size,
                          PROT_READ | PROT_WRITE,
                          MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
@@ -116,25 +232,65 @@ Fiber::~Fiber()
 #if HAVE_VALGRIND
     VALGRIND_STACK_DEREGISTER(valgrindStackId);
 #endif
-    if (guardPage)
+    if (!guardPage)
+        return;
+
+    auto &cache = stackCache();
+    if (cache.size() < maxCachedStacks)
+        cache.emplace_back(guardPage, stackSize);
+    else
         munmap(guardPage, guardPageSize + stackSize);
 }
 
+void
+Fiber::swap(Fiber *from, Fiber *to)
+{
+#if M5_FIBER_ASM_SWITCH
+    m5_fiber_switch(&from->sp, to->sp);
+#else
+    int ret M5_VAR_USED = swapcontext(&from->ctx, &to->ctx);
+    panic_if(ret == -1, strerror(errno));
+#endif
+}
+
 void
 Fiber::createContext()
 {
     // Set up a context for the new fiber, starting it in the trampoline.
+#if M5_FIBER_ASM_SWITCH
+    // Lay out the top of the stack as if the fiber had switched itself
+    // out right before returning into the trampoline, with the default
+    // floating point control state. The trampoline never returns.
+    void **top = (void **)(((uintptr_t)stack + stackSize) & ~(uintptr_t)15);
+#if defined(__x86_64__)
+    // The return address sits at a 16 byte boundary so that the
+    // trampoline starts with the stack alignment of a called function.
+    void **frame = top - 9;
+    frame[0] = (void *)((uintptr_t)0x037f << 32 | 0x1f80);
+    for (int i = 1; i < 7; i++)
+        frame[i] = nullptr;
+    frame[7] = (void *)&entryTrampoline;
+    frame[8] = nullptr;
+#elif defined(__aarch64__)
+    void **frame = top - 22;
+    for (int i = 0; i < 22; i++)
+        frame[i] = nullptr;
+    frame[11] = (void *)&entryTrampoline;
+#endif
+    sp = frame;
+#else
     getcontext(&ctx);
     ctx.uc_stack.ss_sp = stack;
     ctx.uc_stack.ss_size = stackSize;
     ctx.uc_link = nullptr;
     makecontext(&ctx, &entryTrampoline, 0);
+#endif
 
     // Swap to the new context so it can enter its start() function. It
     // will then swap itself back out and return here.
     startingFiber = this;
     panic_if(!_currentFiber, "No active Fiber object.");
-    swapcontext(&_currentFiber->ctx, &ctx);
+    swap(_currentFiber, this);
 
     // The new context is now ready and about to call main().
 }
@@ -149,8 +305,7 @@ Fiber::start()
 
     // Swap back to the parent context which is still considered "current",
     // now that we're ready to go.
-    int ret M5_VAR_USED = swapcontext(&ctx, &_currentFiber->ctx);
-    panic_if(ret == -1, strerror(errno));
+    swap(this, _currentFiber);
 
     // Call main() when we're been reactivated for the first time.
     main();
@@ -177,7 +332,7 @@ Fiber::run()
     Fiber *prev = _currentFiber;
     Fiber *next = this;
     _currentFiber = next;
-    swapcontext(&prev->ctx, &next->ctx);
+    swap(prev, next);
 }
 
 Fiber *Fiber::currentFiber() { return _currentFiber; }
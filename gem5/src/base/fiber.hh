@@ -30,6 +30,16 @@
 #ifndef __BASE_FIBER_HH__
 #define __BASE_FIBER_HH__
 
+// On x86-64 and AArch64 ELF hosts, fibers are switched by a short assembly
+// routine which only saves the callee saved registers. swapcontext also
+// saves and restores the signal mask, which costs a system call per switch.
+#if (defined(__x86_64__) || defined(__aarch64__)) && defined(__ELF__)
+#define M5_FIBER_ASM_SWITCH 1
+#else
+#define M5_FIBER_ASM_SWITCH 0
+#endif
+
+#if !M5_FIBER_ASM_SWITCH
 // ucontext functions (like getcontext, setcontext etc) have been marked
 // as deprecated and are hence hidden in latest macOS releases.
 // By defining _XOPEN_SOURCE we make them available at compilation time.
@@ -40,6 +50,7 @@
 #else
 #include <ucontext.h>
 #endif
+#endif
 
 #include <cstddef>
 #include <cstdint>
@@ -106,7 +117,16 @@ class Fiber
     static void entryTrampoline();
     void start();
 
+    /// Save the state of from and resume execution in to.
+    static void swap(Fiber *from, Fiber *to);
+
+#if M5_FIBER_ASM_SWITCH
+    /// The stack pointer of the fiber while it's switched out, the
+    /// registers it needs to resume are saved on its stack.
+    void *sp = nullptr;
+#else
     ucontext_t ctx;
+#endif
     Fiber *link;
 
     // The stack for this context, or a nullptr if allocated elsewhere.
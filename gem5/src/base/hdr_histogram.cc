@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "base/hdr_histogram.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+// Values below 2^subBits have a bucket of their own. Above that, a
+// value is shifted right until it has subBits significant bits, its
+// top bit is then always set, so the buckets of each shift only use
+// the upper half of the sub-bucket range, and follow on directly
+// from the buckets of the previous shift.
+HdrHistogram::HdrHistogram(unsigned sub_bits)
+    : subBits(sub_bits), halfCount(1ULL << (sub_bits - 1)),
+      counts((64 - sub_bits + 2) * halfCount, 0),
+      topBucket(0), total(0), maxValue(0)
+{
+    fatal_if(sub_bits < 1 || sub_bits > 16,
+             "HDR histogram sub-bucket bits must be between 1 and 16\n");
+}
+
+unsigned
+HdrHistogram::bucket(uint64_t value) const
+{
+    if (value < 2 * halfCount)
+        return value;
+
+    const unsigned shift = floorLog2(value) - subBits + 1;
+    return shift * halfCount + (value >> shift);
+}
+
+uint64_t
+HdrHistogram::bucketHigh(unsigned index) const
+{
+    if (index < 2 * halfCount)
+        return index;
+
+    const unsigned shift = index / halfCount - 1;
+    const uint64_t low = (index - shift * halfCount) << shift;
+    return low + ((1ULL << shift) - 1);
+}
+
+void
+HdrHistogram::sample(uint64_t value, uint64_t count)
+{
+    const unsigned index = bucket(value);
+    counts[index] += count;
+    topBucket = std::max(topBucket, index);
+    total += count;
+    maxValue = std::max(maxValue, value);
+}
+
+uint64_t
+HdrHistogram::percentile(double p) const
+{
+    if (total == 0)
+        return 0;
+
+    // The rank of the sample holding the percentile, starting at 1
+    const uint64_t rank = std::max<uint64_t>(
+        1, std::min<uint64_t>(total, std::ceil(p / 100.0 * total)));
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i <= topBucket; ++i) {
+        seen += counts[i];
+        if (seen >= rank)
+            return std::min(bucketHigh(i), maxValue);
+    }
+
+    return maxValue;
+}
+
+void
+HdrHistogram::reset()
+{
+    std::fill(counts.begin(), counts.begin() + topBucket + 1, 0);
+    topBucket = 0;
+    total = 0;
+    maxValue = 0;
+}
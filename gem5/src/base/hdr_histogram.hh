@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Log-linear histogram for latency percentiles
+ */
+
+#ifndef __BASE_HDR_HISTOGRAM_HH__
+#define __BASE_HDR_HISTOGRAM_HH__
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A high dynamic range histogram, in the spirit of HdrHistogram. Each
+ * power of two is split in a fixed number of linear sub-buckets, so
+ * any 64-bit value can be recorded in constant time and a constant
+ * amount of memory, and every percentile is reported with a relative
+ * error below 2^(1 - subBits). This makes it cheap enough to sample the
+ * latency of every single request and still report tail percentiles
+ * (e.g. p99.9) that a Stats::Distribution with fixed buckets cannot
+ * resolve without knowing the range up front.
+ */
+class HdrHistogram
+{
+  public:
+    /**
+     * @param sub_bits log2 of the number of sub-buckets of a power of
+     * two, i.e. the number of significant bits kept for each value
+     */
+    explicit HdrHistogram(unsigned sub_bits = 7);
+
+    /** Record a value, count times */
+    void sample(uint64_t value, uint64_t count = 1);
+
+    /**
+     * Get the value at a percentile of the samples.
+     *
+     * @param p percentile in the range [0, 100]
+     * @return the largest value of the bucket holding the percentile,
+     * capped to the largest value recorded, or 0 if there are no
+     * samples
+     */
+    uint64_t percentile(double p) const;
+
+    /** Number of values recorded */
+    uint64_t count() const { return total; }
+
+    /** Largest value recorded */
+    uint64_t max() const { return maxValue; }
+
+    /** Discard all the values recorded */
+    void reset();
+
+  private:
+    /** Bucket of a value */
+    unsigned bucket(uint64_t value) const;
+
+    /** Largest value mapped to a bucket */
+    uint64_t bucketHigh(unsigned index) const;
+
+    /** Number of significant bits of a value */
+    const unsigned subBits;
+
+    /** Sub-buckets in the upper half of each power of two */
+    const uint64_t halfCount;
+
+    std::vector<uint64_t> counts;
+
+    /** Highest bucket in use, bounds the percentile walk */
+    unsigned topBucket;
+
+    uint64_t total;
+    uint64_t maxValue;
+};
+
+#endif // __BASE_HDR_HISTOGRAM_HH__
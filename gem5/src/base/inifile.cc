@@ -121,6 +121,34 @@ IniFile::Section::add(const std::string &assignment)
 }
 
 
+IniFile::Section::~Section()
+{
+    for (auto &entry : table)
+        delete entry.second;
+}
+
+
+bool
+IniFile::Section::removeEntry(const std::string &entryName)
+{
+    EntryTable::iterator ei = table.find(entryName);
+    if (ei == table.end())
+        return false;
+
+    delete ei->second;
+    table.erase(ei);
+    return true;
+}
+
+
+void
+IniFile::Section::getEntryNames(vector<string> &list) const
+{
+    for (const auto &entry : table)
+        list.push_back(entry.first);
+}
+
+
 IniFile::Entry *
 IniFile::Section::findEntry(const std::string &entryName) const
 {
@@ -302,6 +330,46 @@ IniFile::getSectionNames(vector<string> &list) const
     }
 }
 
+void
+IniFile::getEntryNames(const string &sectionName, vector<string> &list) const
+{
+    Section *section = findSection(sectionName);
+    if (section)
+        section->getEntryNames(list);
+}
+
+void
+IniFile::set(const string &sectionName, const string &entryName,
+             const string &value)
+{
+    addSection(sectionName)->addEntry(entryName, value, false);
+}
+
+void
+IniFile::createSection(const string &sectionName)
+{
+    addSection(sectionName);
+}
+
+bool
+IniFile::removeEntry(const string &sectionName, const string &entryName)
+{
+    Section *section = findSection(sectionName);
+    return section && section->removeEntry(entryName);
+}
+
+bool
+IniFile::removeSection(const string &sectionName)
+{
+    SectionTable::iterator i = table.find(sectionName);
+    if (i == table.end())
+        return false;
+
+    delete i->second;
+    table.erase(i);
+    return true;
+}
+
 bool
 IniFile::printUnreferenced()
 {
@@ -105,6 +105,9 @@ class IniFile
         {
         }
 
+        /// Destructor.
+        ~Section();
+
         /// Has this section been used?
         bool isReferenced() { return referenced; }
 
@@ -126,6 +129,13 @@ class IniFile
         /// @retval Pointer to the entry object, or NULL if none.
         Entry *findEntry(const std::string &entryName) const;
 
+        /// Remove the entry with the given name.
+        /// @retval True if the entry was found.
+        bool removeEntry(const std::string &entryName);
+
+        /// Push the names of all the entries into the given vector.
+        void getEntryNames(std::vector<std::string> &list) const;
+
         /// Print the unreferenced entries in this section to cerr.
         /// Messages can be suppressed using "unref_section_ok" and
         /// "unref_entries_ok".
@@ -200,6 +210,26 @@ class IniFile
     /// Push all section names into the given vector
     void getSectionNames(std::vector<std::string> &list) const;
 
+    /// Push the names of the entries of a section into the given vector
+    void getEntryNames(const std::string &section,
+                       std::vector<std::string> &list) const;
+
+    /// Set the value of an entry, creating the entry and its section
+    /// if they don't exist.
+    void set(const std::string &section, const std::string &entry,
+             const std::string &value);
+
+    /// Create an empty section if the named section doesn't exist.
+    void createSection(const std::string &section);
+
+    /// Remove an entry of a section.
+    /// @retval True if the entry was found.
+    bool removeEntry(const std::string &section, const std::string &entry);
+
+    /// Remove a section and all its entries.
+    /// @retval True if the section was found.
+    bool removeSection(const std::string &section);
+
     /// Print unreferenced entries in object.  Iteratively calls
     /// printUnreferend() on all the constituent sections.
     bool printUnreferenced();
@@ -476,6 +476,15 @@ ElfObject::loadSegments(const PortProxy &mem_proxy)
     return true;
 }
 
+void
+ElfObject::appendSegments(std::vector<Segment> &segs) const
+{
+    ObjectFile::appendSegments(segs);
+
+    if (interpreter)
+        interpreter->appendSegments(segs);
+}
+
 void
 ElfObject::getSections()
 {
@@ -90,6 +90,7 @@ class ElfObject : public ObjectFile
     virtual ~ElfObject() {}
 
     bool loadSegments(const PortProxy &mem_proxy) override;
+    void appendSegments(std::vector<Segment> &segs) const override;
 
     virtual bool loadAllSymbols(SymbolTable *symtab, Addr base = 0,
                                 Addr offset = 0, Addr addr_mask = maxAddr)
@@ -95,6 +95,17 @@ ObjectFile::loadSegments(const PortProxy &proxy)
     return true;
 }
 
+void
+ObjectFile::appendSegments(std::vector<Segment> &segs) const
+{
+    for (auto &seg: segments) {
+        if (seg->size == 0)
+            continue;
+        segs.push_back(*seg);
+        segs.back().base = (seg->base & loadMask) + loadOffset;
+    }
+}
+
 namespace
 {
 
@@ -146,6 +146,13 @@ class ObjectFile
   public:
     Addr entryPoint() const { return entry; }
 
+    /**
+     * Append the segments loadSegments() would load, with the addresses
+     * they would be loaded at, to a list. This lets a caller copy them
+     * into memory itself, e.g. a page at a time when first touched.
+     */
+    virtual void appendSegments(std::vector<Segment> &segs) const;
+
     Addr
     maxSegmentAddr() const
     {
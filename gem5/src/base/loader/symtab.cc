@@ -30,8 +30,13 @@
 
 #include "base/loader/symtab.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <fstream>
+#include <functional>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -44,11 +49,100 @@ using namespace std;
 
 SymbolTable *debugSymbolTable = NULL;
 
+namespace
+{
+
+/** Source of SymbolTable generations, unique across tables */
+std::atomic<uint64_t> nextGeneration(1);
+
+/** Range of the symbol the last nearest-symbol lookup found */
+struct LookupCache
+{
+    const SymbolTable *table;
+    uint64_t generation;
+    Addr start;
+    Addr end;
+    size_t index;
+};
+
+thread_local LookupCache lookupCache = { nullptr, 0, 0, 0, 0 };
+
+} // anonymous namespace
+
+SymbolTable::SymbolTable()
+    : sorted(true), generation(nextGeneration++), hasPending(false),
+      loading(false)
+{
+}
+
+SymbolTable::SymbolTable(const string &file)
+    : SymbolTable()
+{
+    load(file);
+}
+
+void
+SymbolTable::changed() const
+{
+    generation = nextGeneration++;
+}
+
 void
 SymbolTable::clear()
 {
+    std::lock_guard<std::recursive_mutex> lock(pendingLock);
+    pendingLoads.clear();
+    hasPending = false;
     addrTable.clear();
     symbolTable.clear();
+    sorted = true;
+    changed();
+}
+
+void
+SymbolTable::deferLoad(std::function<void(SymbolTable *)> loader)
+{
+    std::lock_guard<std::recursive_mutex> lock(pendingLock);
+    pendingLoads.push_back(std::move(loader));
+    hasPending = true;
+}
+
+void
+SymbolTable::runPendingLoads() const
+{
+    std::lock_guard<std::recursive_mutex> lock(pendingLock);
+    // The loaders insert symbols, which calls back in here.
+    if (loading)
+        return;
+
+    loading = true;
+    while (!pendingLoads.empty()) {
+        auto loads = std::move(pendingLoads);
+        pendingLoads.clear();
+        for (auto &load : loads)
+            load(const_cast<SymbolTable *>(this));
+    }
+    loading = false;
+    hasPending = false;
+}
+
+void
+SymbolTable::prepareSlow() const
+{
+    std::lock_guard<std::recursive_mutex> lock(pendingLock);
+    if (loading)
+        return;
+
+    runPendingLoads();
+
+    if (!sorted) {
+        std::stable_sort(addrTable.begin(), addrTable.end(),
+            [](const Symbol &a, const Symbol &b) {
+                return a.address < b.address;
+            });
+        sorted = true;
+        changed();
+    }
 }
 
 bool
@@ -57,16 +151,65 @@ SymbolTable::insert(Addr address, string symbol)
     if (symbol.empty())
         return false;
 
-    if (!symbolTable.insert(make_pair(symbol, address)).second)
+    if (hasPending)
+        runPendingLoads();
+
+    std::lock_guard<std::recursive_mutex> lock(pendingLock);
+    auto ret = symbolTable.emplace(std::move(symbol), address);
+    if (!ret.second)
         return false;
 
     // There can be multiple symbols for the same address, so always
-    // update the addrTable multimap when we see a new symbol name.
-    addrTable.insert(make_pair(address, symbol));
+    // add a new symbol name to the address table.
+    if (!addrTable.empty() && address < addrTable.back().address)
+        sorted = false;
+    addrTable.push_back({address, &ret.first->first});
+    changed();
+
+    return true;
+}
+
+bool
+SymbolTable::findSymbol(Addr address, std::string &symbol) const
+{
+    prepare();
+    auto i = std::lower_bound(addrTable.begin(), addrTable.end(), address,
+        [](const Symbol &sym, Addr addr) { return sym.address < addr; });
+    if (i == addrTable.end() || i->address != address)
+        return false;
 
+    symbol = *i->name;
     return true;
 }
 
+bool
+SymbolTable::findNearest(Addr addr, size_t &index, Addr &nextaddr) const
+{
+    prepare();
+
+    LookupCache &cache = lookupCache;
+    if (cache.table == this && cache.generation == generation &&
+            addr >= cache.start && addr < cache.end) {
+        index = cache.index;
+        nextaddr = cache.end;
+        return true;
+    }
+
+    // find first symbol *larger* than desired address
+    auto i = std::upper_bound(addrTable.begin(), addrTable.end(), addr,
+        [](Addr addr, const Symbol &sym) { return addr < sym.address; });
+
+    // if very first symbol is larger, we're out of luck
+    if (i == addrTable.begin())
+        return false;
+
+    nextaddr = i == addrTable.end() ? std::numeric_limits<Addr>::max() :
+                                      i->address;
+    index = i - addrTable.begin() - 1;
+
+    cache = { this, generation, addrTable[index].address, nextaddr, index };
+    return true;
+}
 
 bool
 SymbolTable::load(const string &filename)
@@ -112,13 +255,13 @@ SymbolTable::load(const string &filename)
 void
 SymbolTable::serialize(const string &base, CheckpointOut &cp) const
 {
+    prepare();
     paramOut(cp, base + ".size", addrTable.size());
 
     int i = 0;
-    ATable::const_iterator p, end = addrTable.end();
-    for (p = addrTable.begin(); p != end; ++p) {
-        paramOut(cp, csprintf("%s.addr_%d", base, i), p->first);
-        paramOut(cp, csprintf("%s.symbol_%d", base, i), p->second);
+    for (const auto &sym : addrTable) {
+        paramOut(cp, csprintf("%s.addr_%d", base, i), sym.address);
+        paramOut(cp, csprintf("%s.symbol_%d", base, i), *sym.name);
         ++i;
     }
 }
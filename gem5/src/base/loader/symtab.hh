@@ -32,70 +32,129 @@
 #ifndef __SYMTAB_HH__
 #define __SYMTAB_HH__
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <iosfwd>
-#include <map>
+#include <mutex>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/types.hh"
 #include "sim/serialize.hh"
 
+/**
+ * A table of symbols and their addresses.
+ *
+ * Symbol names are interned in a hash table that maps them to their
+ * address. A vector of the symbols sorted by address answers lookups
+ * by address with a binary search. Symbols are usually inserted in
+ * bulk when an object file is loaded, so the vector is only sorted
+ * again when it is first used after an insertion out of order.
+ *
+ * Lookups of the nearest symbol tend to hit the same function many
+ * times in a row (e.g., when tracing or profiling every instruction),
+ * so every host thread remembers the range of the symbol it found
+ * last.
+ */
 class SymbolTable
 {
   public:
-    typedef std::multimap<Addr, std::string> ATable;
-    typedef std::map<std::string, Addr> STable;
+    struct Symbol
+    {
+        Addr address;
+        /** Interned name of the symbol */
+        const std::string *name;
+    };
+
+    /** Symbols sorted by address, in insertion order at each address */
+    typedef std::vector<Symbol> ATable;
+    typedef std::unordered_map<std::string, Addr> STable;
 
   private:
-    ATable addrTable;
+    mutable ATable addrTable;
     STable symbolTable;
 
-  private:
-    bool
-    upperBound(Addr addr, ATable::const_iterator &iter) const
-    {
-        // find first key *larger* than desired address
-        iter = addrTable.upper_bound(addr);
+    /** Whether addrTable is sorted */
+    mutable std::atomic<bool> sorted;
+    /** Changes whenever the symbols change, to invalidate caches */
+    mutable uint64_t generation;
 
-        // if very first key is larger, we're out of luck
-        if (iter == addrTable.begin())
-            return false;
+    /** Loaders deferred until the table is first used */
+    mutable std::vector<std::function<void(SymbolTable *)>> pendingLoads;
+    mutable std::atomic<bool> hasPending;
+    mutable bool loading;
+    mutable std::recursive_mutex pendingLock;
 
-        return true;
+    /** Run the deferred loaders and sort the table if needed */
+    void
+    prepare() const
+    {
+        if (hasPending || !sorted)
+            prepareSlow();
     }
 
+    void prepareSlow() const;
+    void runPendingLoads() const;
+    void changed() const;
+
+    /**
+     * Find the last symbol at or below an address.
+     * @param addr The address to look up.
+     * @param index Return reference for the index of the symbol.
+     * @param nextaddr Return reference for the address of the
+     *                 following symbol.
+     * @retval True if a symbol was found.
+     */
+    bool findNearest(Addr addr, size_t &index, Addr &nextaddr) const;
+
   public:
-    SymbolTable() {}
-    SymbolTable(const std::string &file) { load(file); }
+    SymbolTable();
+    SymbolTable(const std::string &file);
     ~SymbolTable() {}
 
     void clear();
     bool insert(Addr address, std::string symbol);
     bool load(const std::string &file);
 
-    const ATable &getAddrTable() const { return addrTable; }
-    const STable &getSymbolTable() const { return symbolTable; }
+    /**
+     * Defer filling the table until it is first used, so that the
+     * symbols of a large object file are only parsed when something
+     * looks them up.
+     */
+    void deferLoad(std::function<void(SymbolTable *)> loader);
+
+    const ATable &
+    getAddrTable() const
+    {
+        prepare();
+        return addrTable;
+    }
+
+    const STable &
+    getSymbolTable() const
+    {
+        prepare();
+        return symbolTable;
+    }
 
   public:
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
 
   public:
-    bool
-    findSymbol(Addr address, std::string &symbol) const
-    {
-        ATable::const_iterator i = addrTable.find(address);
-        if (i == addrTable.end())
-            return false;
-
-        // There are potentially multiple symbols that map to the same
-        // address. For simplicity, just return the first one.
-        symbol = (*i).second;
-        return true;
-    }
+    /**
+     * Find the symbol at an address. There are potentially multiple
+     * symbols that map to the same address. For simplicity, just
+     * return the first one.
+     */
+    bool findSymbol(Addr address, std::string &symbol) const;
 
     bool
     findAddress(const std::string &symbol, Addr &address) const
     {
+        prepare();
         STable::const_iterator i = symbolTable.find(symbol);
         if (i == symbolTable.end())
             return false;
@@ -116,14 +175,12 @@ class SymbolTable
     findNearestSymbol(Addr addr, std::string &symbol, Addr &symaddr,
                       Addr &nextaddr) const
     {
-        ATable::const_iterator i;
-        if (!upperBound(addr, i))
+        size_t index;
+        if (!findNearest(addr, index, nextaddr))
             return false;
 
-        nextaddr = i->first;
-        --i;
-        symaddr = i->first;
-        symbol = i->second;
+        symaddr = addrTable[index].address;
+        symbol = *addrTable[index].name;
         return true;
     }
 
@@ -132,40 +189,26 @@ class SymbolTable
     bool
     findNearestSymbol(Addr addr, std::string &symbol, Addr &symaddr) const
     {
-        ATable::const_iterator i;
-        if (!upperBound(addr, i))
-            return false;
-
-        --i;
-        symaddr = i->first;
-        symbol = i->second;
-        return true;
+        Addr nextaddr;
+        return findNearestSymbol(addr, symbol, symaddr, nextaddr);
     }
 
-
     bool
     findNearestAddr(Addr addr, Addr &symaddr, Addr &nextaddr) const
     {
-        ATable::const_iterator i;
-        if (!upperBound(addr, i))
+        size_t index;
+        if (!findNearest(addr, index, nextaddr))
             return false;
 
-        nextaddr = i->first;
-        --i;
-        symaddr = i->first;
+        symaddr = addrTable[index].address;
         return true;
     }
 
     bool
     findNearestAddr(Addr addr, Addr &symaddr) const
     {
-        ATable::const_iterator i;
-        if (!upperBound(addr, i))
-            return false;
-
-        --i;
-        symaddr = i->first;
-        return true;
+        Addr nextaddr;
+        return findNearestAddr(addr, symaddr, nextaddr);
     }
 };
 
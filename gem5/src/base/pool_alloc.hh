@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_POOL_ALLOC_HH__
+#define __BASE_POOL_ALLOC_HH__
+
+#include <cstddef>
+#include <new>
+
+/**
+ * Mix-in keeping the storage of deleted objects of a class on a per
+ * host thread free list, so that small objects created and deleted
+ * all the time (e.g., the history of a branch in flight) don't go
+ * through the heap once the list is warm.
+ *
+ * A class T uses it by deriving from PoolAllocated<T>. Objects of a
+ * different size, e.g. of a class deriving from T that doesn't mix
+ * in its own pool, are allocated on the heap as usual. A class
+ * deriving from a pooled class has to pick its own pool with using
+ * declarations for operator new and operator delete.
+ */
+template <class T>
+class PoolAllocated
+{
+  private:
+    static __thread void *freeList;
+
+  public:
+    static void *
+    operator new(std::size_t size)
+    {
+        static_assert(sizeof(T) >= sizeof(void *),
+                      "Pooled objects must be able to hold a pointer");
+        if (size != sizeof(T) || !freeList)
+            return ::operator new(size);
+
+        void *p = freeList;
+        freeList = *static_cast<void **>(p);
+        return p;
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(T)) {
+            ::operator delete(p);
+            return;
+        }
+
+        *static_cast<void **>(p) = freeList;
+        freeList = p;
+    }
+};
+
+template <class T>
+__thread void *PoolAllocated<T>::freeList = nullptr;
+
+#endif // __BASE_POOL_ALLOC_HH__
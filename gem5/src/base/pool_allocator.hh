@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* @file
+ * Allocator recycling single objects through a per-thread free list
+ */
+
+#ifndef __BASE_POOL_ALLOCATOR_HH__
+#define __BASE_POOL_ALLOCATOR_HH__
+
+#include <cstddef>
+#include <new>
+
+/**
+ * A stateless allocator for node based containers (std::list,
+ * std::map, ...) that allocate their elements one at a time. Freed
+ * single objects are kept on a per-thread free list of their type and
+ * handed out again by the next allocation, so a container that has
+ * reached its steady state size no longer touches the heap.
+ * Allocations of several objects at once go to the global operator
+ * new.
+ *
+ * All instances compare equal, so nodes can be spliced and swapped
+ * between containers. An object freed by another thread than the one
+ * that allocated it simply migrates to that thread's list. The memory
+ * of the free lists is never given back.
+ */
+template <class T>
+class PoolAllocator
+{
+  private:
+    /** Storage of a freed object, linked on the free list. */
+    union Slot
+    {
+        Slot *next;
+        alignas(T) char storage[sizeof(T)];
+    };
+
+    /** Freed objects owned by the current thread. */
+    static thread_local Slot *freeList;
+
+  public:
+    typedef T value_type;
+
+    template <class U>
+    struct rebind
+    {
+        typedef PoolAllocator<U> other;
+    };
+
+    PoolAllocator() noexcept {}
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U> &) noexcept {}
+
+    T *
+    allocate(std::size_t n)
+    {
+        if (n != 1 || !freeList)
+            return static_cast<T *>(::operator new(n * sizeof(Slot)));
+
+        Slot *slot = freeList;
+        freeList = slot->next;
+        return reinterpret_cast<T *>(slot);
+    }
+
+    void
+    deallocate(T *p, std::size_t n) noexcept
+    {
+        if (n != 1) {
+            ::operator delete(p);
+            return;
+        }
+
+        Slot *slot = reinterpret_cast<Slot *>(p);
+        slot->next = freeList;
+        freeList = slot;
+    }
+};
+
+template <class T>
+thread_local typename PoolAllocator<T>::Slot *PoolAllocator<T>::freeList =
+    nullptr;
+
+template <class T, class U>
+bool
+operator==(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return true;
+}
+
+template <class T, class U>
+bool
+operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &)
+{
+    return false;
+}
+
+#endif // __BASE_POOL_ALLOCATOR_HH__
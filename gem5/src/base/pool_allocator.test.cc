@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <list>
+#include <vector>
+
+#include "base/pool_allocator.hh"
+
+/** Freed nodes are handed out again by the next allocation */
+TEST(PoolAllocatorTest, Recycle)
+{
+    PoolAllocator<uint64_t> alloc;
+
+    uint64_t *a = alloc.allocate(1);
+    uint64_t *b = alloc.allocate(1);
+    EXPECT_NE(a, b);
+
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+
+    // The free list is last in, first out
+    EXPECT_EQ(alloc.allocate(1), b);
+    EXPECT_EQ(alloc.allocate(1), a);
+
+    alloc.deallocate(a, 1);
+    alloc.deallocate(b, 1);
+}
+
+/** Arrays are not pooled */
+TEST(PoolAllocatorTest, Array)
+{
+    PoolAllocator<uint64_t> alloc;
+
+    uint64_t *a = alloc.allocate(4);
+    for (int i = 0; i < 4; ++i)
+        a[i] = i;
+    alloc.deallocate(a, 4);
+}
+
+/** Rebound allocators share the pool of their type */
+TEST(PoolAllocatorTest, Rebind)
+{
+    PoolAllocator<uint32_t> alloc;
+    PoolAllocator<uint32_t>::rebind<uint16_t>::other rebound(alloc);
+
+    EXPECT_TRUE(alloc == rebound);
+
+    uint16_t *a = rebound.allocate(1);
+    rebound.deallocate(a, 1);
+    EXPECT_EQ(PoolAllocator<uint16_t>().allocate(1), a);
+    rebound.deallocate(a, 1);
+}
+
+/** Lists can splice nodes between each other and reuse them */
+TEST(PoolAllocatorTest, List)
+{
+    typedef std::list<int, PoolAllocator<int>> List;
+    List a, b;
+
+    for (int i = 0; i < 8; ++i)
+        a.push_back(i);
+
+    b.splice(b.end(), a, a.begin(), std::next(a.begin(), 4));
+    EXPECT_EQ(a.size(), 4);
+    EXPECT_EQ(b.size(), 4);
+    EXPECT_EQ(a.front(), 4);
+    EXPECT_EQ(b.back(), 3);
+
+    std::vector<const int *> nodes;
+    for (const auto &v : b)
+        nodes.push_back(&v);
+    b.clear();
+
+    // The nodes of b are reused by the next insertions
+    for (int i = 0; i < 4; ++i) {
+        a.push_front(i);
+        EXPECT_EQ(&a.front(), nodes[3 - i]);
+    }
+}
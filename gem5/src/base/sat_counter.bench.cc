@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <random>
+#include <vector>
+
+#include "base/bench/benchmark.hh"
+#include "base/sat_counter.hh"
+
+/**
+ * Train a table of counters with a biased outcome stream, as done by
+ * the branch predictors.
+ */
+static void
+satCounterTrain(Bench::State &state)
+{
+    const size_t entries = 4096;
+    const unsigned bits = state.arg();
+    std::vector<SatCounter> table(entries, SatCounter(bits));
+
+    const auto addrs = Bench::addresses(1 << 16, entries * 64);
+    std::vector<bool> taken(addrs.size());
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < taken.size(); ++i)
+        taken[i] = rng() % 100 < 90;
+
+    size_t next = 0;
+    unsigned predicted = 0;
+    for (auto _ : state) {
+        SatCounter &counter = table[(addrs[next] / 64) % entries];
+        predicted += counter >> (bits - 1);
+        if (taken[next])
+            counter++;
+        else
+            counter--;
+        next = (next + 1) % addrs.size();
+    }
+    Bench::doNotOptimize(predicted);
+    state.setItemsProcessed(state.iterations());
+}
+BENCHMARK(satCounterTrain)->arg(2)->arg(3);
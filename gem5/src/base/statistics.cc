@@ -155,6 +155,30 @@ nameMap()
 
 int Info::id_count = 0;
 
+__thread uint32_t threadShard = 0;
+
+const uint32_t ShardedStor::MaxShards;
+
+void
+ShardedStor::allocShard()
+{
+    fatal_if(threadShard >= MaxShards, "Sharded stats support at most %d "
+             "simulation threads.", MaxShards);
+
+    // Counters are never freed, like the stats that use them
+    static const size_t chunkSize = 1024;
+    static __thread Counter *chunk = nullptr;
+    static __thread size_t left = 0;
+
+    if (left == 0) {
+        chunk = new Counter[chunkSize]();
+        left = chunkSize;
+    }
+
+    --left;
+    shards[threadShard] = chunk++;
+}
+
 int debug_break_id = -1;
 
 Info::Info()
@@ -280,6 +304,12 @@ Info::enable()
 {
 }
 
+void
+Info::disable()
+{
+    flags.clear(display);
+}
+
 void
 VectorInfo::enable()
 {
@@ -394,9 +424,51 @@ HistStor::grow_up()
     bucket_size *= 2;
 }
 
+void
+HistStor::flush()
+{
+    if (buffer.empty())
+        return;
+
+    // The sum of the logarithms is computed as the logarithm of the
+    // product of the samples, which saves a log() per sample. The
+    // product is kept as a mantissa and an exponent to avoid
+    // overflows.
+    double mantissa = 1.0;
+    int exponent = 0;
+    int exp;
+    size_type count = 0;
+
+    // Growing the histogram merges buckets, which doesn't give the
+    // same counts as bucketing with the final bucket size for
+    // negative values, so bucket the samples in order.
+    for (const auto &s : buffer) {
+        grow(s.first);
+        bucket(s.first, s.second);
+
+        if (s.first > 0 && s.second == 1) {
+            mantissa *= std::frexp(s.first, &exp);
+            exponent += exp;
+            if (++count % 256 == 0) {
+                mantissa = std::frexp(mantissa, &exp);
+                exponent += exp;
+            }
+        } else {
+            logs += log(s.first) * s.second;
+        }
+    }
+
+    logs += std::log(mantissa) + exponent * M_LN2;
+
+    buffer.clear();
+}
+
 void
 HistStor::add(HistStor *hs)
 {
+    flush();
+    hs->flush();
+
     int b_size = hs->size();
     assert(size() == b_size);
     assert(min_bucket == hs->min_bucket);
@@ -73,6 +73,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "base/stats/group.hh"
@@ -106,6 +107,12 @@ class InfoProxy : public Base
     void prepare() { s.prepare(); }
     void reset() { s.reset(); }
     void
+    disable()
+    {
+        Base::disable();
+        s.disableUpdates();
+    }
+    void
     visit(Output &visitor)
     {
         visitor.visit(*static_cast<Base *>(this));
@@ -188,6 +195,9 @@ class InfoAccess
   private:
     Info *_info;
 
+    /** Are updates to this stat enabled? */
+    bool _enabled;
+
   protected:
     /** Set up an info class for this statistic */
     void setInfo(Group *parent, Info *info);
@@ -203,7 +213,19 @@ class InfoAccess
 
   public:
     InfoAccess()
-        : _info(nullptr) {};
+        : _info(nullptr), _enabled(true) {};
+
+    /**
+     * Updates to a stat disabled by the stat filter are ignored. Check
+     * this before computing expensive sample values.
+     * @return true if this stat is updated.
+     */
+    bool enabled() const { return _enabled; }
+
+    /**
+     * Ignore all updates to this stat from now on.
+     */
+    void disableUpdates() { _enabled = false; }
 
     /**
      * Reset the stat to the default state.
@@ -649,6 +671,117 @@ class AvgStor
 
 };
 
+/**
+ * Index of the shard of the calling simulation thread. The simulation
+ * thread of event queue i uses shard i.
+ */
+extern __thread uint32_t threadShard;
+
+/**
+ * Storage for a stat that is updated by several simulation threads.
+ * Every thread updates its own counter, and the counters are only
+ * summed when the stat is read, so updates are race free without
+ * atomics. The counter of a thread is allocated by the thread the
+ * first time it updates the stat, next to the other counters of the
+ * thread, which avoids false sharing.
+ *
+ * Reads, set() and reset() must only happen while the simulation
+ * threads are synchronized, e.g., when dumping stats.
+ */
+class ShardedStor
+{
+  public:
+    struct Params : public StorageParams {};
+
+    /** The maximum number of simulation threads. */
+    static const uint32_t MaxShards = 64;
+
+  private:
+    /** The counter of each thread, nullptr if it hasn't been used. */
+    Counter *shards[MaxShards];
+
+    /** Allocate the counter of the calling thread. */
+    void allocShard();
+
+    Counter &
+    shard()
+    {
+        if (threadShard >= MaxShards || !shards[threadShard])
+            allocShard();
+        return *shards[threadShard];
+    }
+
+  public:
+    ShardedStor(Info *info)
+    {
+        for (auto &c : shards)
+            c = nullptr;
+    }
+
+    /**
+     * Set the stat to the given value.
+     * @param val The new value.
+     */
+    void
+    set(Counter val)
+    {
+        for (auto c : shards) {
+            if (c)
+                *c = Counter();
+        }
+        shard() = val;
+    }
+    /**
+     * Increment the stat by the given value.
+     * @param val The new value.
+     */
+    void inc(Counter val) { shard() += val; }
+    /**
+     * Decrement the stat by the given value.
+     * @param val The new value.
+     */
+    void dec(Counter val) { shard() -= val; }
+    /**
+     * Return the value of this stat as its base type.
+     * @return The sum of the counters of all the threads.
+     */
+    Counter
+    value() const
+    {
+        Counter total = Counter();
+        for (auto c : shards) {
+            if (c)
+                total += *c;
+        }
+        return total;
+    }
+    /**
+     * Return the value of this stat as a result type.
+     * @return The value of this stat.
+     */
+    Result result() const { return (Result)value(); }
+    /**
+     * Prepare stat data for dumping or serialization
+     */
+    void prepare(Info *info) { }
+    /**
+     * Reset stat value to default
+     */
+    void
+    reset(Info *info)
+    {
+        for (auto c : shards) {
+            if (c)
+                *c = Counter();
+        }
+    }
+
+    /**
+     * @return true if zero value
+     */
+    bool zero() const { return value() == Counter(); }
+};
+
 /**
  * Implementation of a scalar stat. The type of stat is determined by the
  * Storage template.
@@ -716,12 +849,22 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { data()->inc(1); }
+    void
+    operator++()
+    {
+        if (this->enabled())
+            data()->inc(1);
+    }
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { data()->dec(1); }
+    void
+    operator--()
+    {
+        if (this->enabled())
+            data()->dec(1);
+    }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -734,7 +877,12 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The new value.
      */
     template <typename U>
-    void operator=(const U &v) { data()->set(v); }
+    void
+    operator=(const U &v)
+    {
+        if (this->enabled())
+            data()->set(v);
+    }
 
     /**
      * Increment the stat by the given value. This calls the associated
@@ -742,7 +890,12 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to add.
      */
     template <typename U>
-    void operator+=(const U &v) { data()->inc(v); }
+    void
+    operator+=(const U &v)
+    {
+        if (this->enabled())
+            data()->inc(v);
+    }
 
     /**
      * Decrement the stat by the given value. This calls the associated
@@ -750,7 +903,12 @@ class ScalarBase : public DataWrap<Derived, ScalarInfoProxy>
      * @param v The value to substract.
      */
     template <typename U>
-    void operator-=(const U &v) { data()->dec(v); }
+    void
+    operator-=(const U &v)
+    {
+        if (this->enabled())
+            data()->dec(v);
+    }
 
     /**
      * Return the number of elements, always 1 for a scalar.
@@ -959,12 +1117,22 @@ class ScalarProxy
      * Increment the stat by 1. This calls the associated storage object inc
      * function.
      */
-    void operator++() { stat.data(index)->inc(1); }
+    void
+    operator++()
+    {
+        if (stat.enabled())
+            stat.data(index)->inc(1);
+    }
     /**
      * Decrement the stat by 1. This calls the associated storage object dec
      * function.
      */
-    void operator--() { stat.data(index)->dec(1); }
+    void
+    operator--()
+    {
+        if (stat.enabled())
+            stat.data(index)->dec(1);
+    }
 
     /** Increment the stat by 1. */
     void operator++(int) { ++*this; }
@@ -980,7 +1148,8 @@ class ScalarProxy
     void
     operator=(const U &v)
     {
-        stat.data(index)->set(v);
+        if (stat.enabled())
+            stat.data(index)->set(v);
     }
 
     /**
@@ -992,7 +1161,8 @@ class ScalarProxy
     void
     operator+=(const U &v)
     {
-        stat.data(index)->inc(v);
+        if (stat.enabled())
+            stat.data(index)->inc(v);
     }
 
     /**
@@ -1004,7 +1174,8 @@ class ScalarProxy
     void
     operator-=(const U &v)
     {
-        stat.data(index)->dec(v);
+        if (stat.enabled())
+            stat.data(index)->dec(v);
     }
 
     /**
@@ -1551,8 +1722,10 @@ class HistStor
     {
         /** The number of buckets.. */
         size_type buckets;
+        /** The number of samples to buffer before bucketing them. */
+        size_type sampleBuffer;
 
-        Params() : DistParams(Hist), buckets(0) {}
+        Params() : DistParams(Hist), buckets(0), sampleBuffer(0) {}
     };
 
   private:
@@ -1574,25 +1747,17 @@ class HistStor
     /** Counter for each bucket. */
     VCounter cvec;
 
-  public:
-    HistStor(Info *info)
-        : cvec(safe_cast<const Params *>(info->storageParams)->buckets)
-    {
-        reset(info);
-    }
-
-    void grow_up();
-    void grow_out();
-    void grow_convert();
-    void add(HistStor *);
+    /** The maximum number of buffered samples, 0 if not buffered. */
+    size_type bufferSize;
+    /** Samples and their count that haven't been bucketed yet. */
+    std::vector<std::pair<Counter, int>> buffer;
 
     /**
-     * Add a value to the distribution for the given number of times.
-     * @param val The value to add.
-     * @param number The number of times to add the value.
+     * Grow the histogram until it covers the given value.
+     * @param val The value to cover.
      */
     void
-    sample(Counter val, int number)
+    grow(Counter val)
     {
         assert(min_bucket < max_bucket);
         if (val < min_bucket) {
@@ -1610,7 +1775,18 @@ class HistStor
                     grow_out();
             }
         }
+    }
 
+    /**
+     * Add a value to the buckets for the given number of times. The
+     * histogram must already cover the value. This doesn't update
+     * the sum of logarithms.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void
+    bucket(Counter val, int number)
+    {
         size_type index =
             (int64_t)std::floor((val - min_bucket) / bucket_size);
 
@@ -1619,10 +1795,54 @@ class HistStor
 
         sum += val * number;
         squares += val * val * number;
-        logs += log(val) * number;
         samples += number;
     }
 
+  public:
+    HistStor(Info *info)
+        : cvec(safe_cast<const Params *>(info->storageParams)->buckets),
+          bufferSize(safe_cast<const Params *>(
+                         info->storageParams)->sampleBuffer)
+    {
+        reset(info);
+    }
+
+    void grow_up();
+    void grow_out();
+    void grow_convert();
+    void add(HistStor *);
+
+    /**
+     * Bucket the buffered samples.
+     */
+    void flush();
+
+    /**
+     * Add a value to the distribution for the given number of times.
+     * Buffered histograms only record the value, and bucket the
+     * buffered values together when the buffer is full or when the
+     * histogram is read.
+     * @param val The value to add.
+     * @param number The number of times to add the value.
+     */
+    void
+    sample(Counter val, int number)
+    {
+        if (bufferSize) {
+            // Only allocate the buffer of histograms that are used
+            if (buffer.capacity() < bufferSize)
+                buffer.reserve(bufferSize);
+            buffer.emplace_back(val, number);
+            if (buffer.size() >= bufferSize)
+                flush();
+            return;
+        }
+
+        grow(val);
+        bucket(val, number);
+        logs += log(val) * number;
+    }
+
     /**
      * Return the number of buckets in this distribution.
      * @return the number of buckets.
@@ -1636,7 +1856,7 @@ class HistStor
     bool
     zero() const
     {
-        return samples == Counter();
+        return samples == Counter() && buffer.empty();
     }
 
     void
@@ -1644,6 +1864,8 @@ class HistStor
     {
         const Params *params = safe_cast<const Params *>(info->storageParams);
 
+        flush();
+
         assert(params->type == Hist);
         data.type = params->type;
         data.min = min_bucket;
@@ -1683,6 +1905,8 @@ class HistStor
         squares = Counter();
         samples = Counter();
         logs = Counter();
+
+        buffer.clear();
     }
 };
 
@@ -1898,7 +2122,12 @@ class DistBase : public DataWrap<Derived, DistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        if (this->enabled())
+            data()->sample(v, n);
+    }
 
     /**
      * Return the number of entries in this stat.
@@ -2069,7 +2298,8 @@ class DistProxy
     void
     sample(const U &v, int n = 1)
     {
-        data()->sample(v, n);
+        if (stat.enabled())
+            data()->sample(v, n);
     }
 
     size_type
@@ -2559,6 +2789,37 @@ class Vector : public VectorBase<Vector, StatStor>
     }
 };
 
+/**
+ * A scalar that several simulation threads can update concurrently.
+ * @sa Stat, ScalarBase, ShardedStor
+ */
+class ShardedScalar : public ScalarBase<ShardedScalar, ShardedStor>
+{
+  public:
+    using ScalarBase<ShardedScalar, ShardedStor>::operator=;
+
+    ShardedScalar(Group *parent = nullptr, const char *name = nullptr,
+                  const char *desc = nullptr)
+        : ScalarBase<ShardedScalar, ShardedStor>(parent, name, desc)
+    {
+    }
+};
+
+/**
+ * A vector of scalar stats that several simulation threads can update
+ * concurrently.
+ * @sa Stat, VectorBase, ShardedStor
+ */
+class ShardedVector : public VectorBase<ShardedVector, ShardedStor>
+{
+  public:
+    ShardedVector(Group *parent = nullptr, const char *name = nullptr,
+                  const char *desc = nullptr)
+        : VectorBase<ShardedVector, ShardedStor>(parent, name, desc)
+    {
+    }
+};
+
 /**
  * A vector of Average stats.
  * @sa Stat, VectorBase, AvgStor
@@ -2640,13 +2901,16 @@ class Histogram : public DistBase<Histogram, HistStor>
     /**
      * Set the parameters of this histogram. @sa HistStor::Params
      * @param size The number of buckets in the histogram
+     * @param sample_buffer The number of samples to buffer and bucket
+     *     at once, 0 to bucket every sample when it is taken.
      * @return A reference to this histogram.
      */
     Histogram &
-    init(size_type size)
+    init(size_type size, size_type sample_buffer = 0)
     {
         HistStor::Params *params = new HistStor::Params;
         params->buckets = size;
+        params->sampleBuffer = sample_buffer;
         this->setParams(params);
         this->doInit();
         return this->self();
@@ -2788,25 +3052,75 @@ class VectorAverageDeviation
     }
 };
 
+/**
+ * Formulas are only evaluated when a visitor reads them, and at most
+ * once between two calls to prepare(), like the other stats that are
+ * snapshot by prepare().
+ */
 template <class Stat>
 class FormulaInfoProxy : public InfoProxy<Stat, FormulaInfo>
 {
   protected:
     mutable VResult vec;
     mutable VCounter cvec;
+    mutable Result tot;
+
+    /** Are vec and tot up to date? */
+    mutable bool vecValid;
+    mutable bool totValid;
 
   public:
-    FormulaInfoProxy(Stat &stat) : InfoProxy<Stat, FormulaInfo>(stat) {}
+    FormulaInfoProxy(Stat &stat)
+        : InfoProxy<Stat, FormulaInfo>(stat), tot(0.0), vecValid(false),
+          totValid(false)
+    {}
+
+    void
+    prepare()
+    {
+        vecValid = totValid = false;
+        this->s.prepare();
+    }
+
+    void
+    reset()
+    {
+        vecValid = totValid = false;
+        this->s.reset();
+    }
+
+    bool
+    zero() const
+    {
+        for (auto v : result()) {
+            if (v != 0.0)
+                return false;
+        }
+        return true;
+    }
 
     size_type size() const { return this->s.size(); }
 
     const VResult &
     result() const
     {
-        this->s.result(vec);
+        if (!vecValid) {
+            this->s.result(vec);
+            vecValid = true;
+        }
         return vec;
     }
-    Result total() const { return this->s.total(); }
+
+    Result
+    total() const
+    {
+        if (!totValid) {
+            tot = this->s.total();
+            totValid = true;
+        }
+        return tot;
+    }
+
     VCounter &value() const { return cvec; }
 
     std::string str() const { return this->s.str(); }
@@ -2876,7 +3190,12 @@ class SparseHistBase : public DataWrap<Derived, SparseHistInfoProxy>
      * @param n The number of times to add it, defaults to 1.
      */
     template <typename U>
-    void sample(const U &v, int n = 1) { data()->sample(v, n); }
+    void
+    sample(const U &v, int n = 1)
+    {
+        if (this->enabled())
+            data()->sample(v, n);
+    }
 
     /**
      * Return the number of entries in this stat.
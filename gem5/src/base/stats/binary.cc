@@ -0,0 +1,385 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "base/stats/binary.hh"
+
+#include <cstring>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/info.hh"
+
+namespace Stats {
+
+namespace {
+
+const char binaryMagic[] = "GSTB";
+const uint32_t binaryVersion = 1;
+
+/** Name of a value of a stat, its index if it has no subname */
+std::string
+subname(const std::vector<std::string> &subnames, off_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    else
+        return std::to_string(i);
+}
+
+} // anonymous namespace
+
+Binary::Binary(const std::string &_file, bool changed_only, bool desc,
+               bool formulas)
+    : file(simout.create(_file, true)),
+      changedOnly(changed_only), enableDescriptions(desc),
+      enableFormula(formulas), schemaPos(0), schemaChanged(false)
+{
+    stream = file->stream();
+    if (!valid())
+        fatal("Unable to open statistics file %s for writing\n", _file);
+
+    putHeader();
+}
+
+Binary::~Binary()
+{
+    simout.close(file);
+}
+
+void
+Binary::begin()
+{
+    assert(path.empty());
+
+    schemaPos = 0;
+    schemaChanged = false;
+    values.clear();
+}
+
+void
+Binary::end()
+{
+    // Stats that were not visited this time have disappeared
+    if (schemaPos != schema.size()) {
+        schema.resize(schemaPos);
+        schemaChanged = true;
+    }
+
+    if (schemaChanged) {
+        writeSchema();
+        // The indices of the values have changed, so start over from
+        // a full dump.
+        prevValues.clear();
+    }
+
+    if (changedOnly && prevValues.size() == values.size()) {
+        uint32_t changed = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (std::memcmp(&values[i], &prevValues[i], sizeof(double)))
+                ++changed;
+        }
+
+        putU8('C');
+        putU32(changed);
+        for (size_t i = 0; i < values.size(); ++i) {
+            if (std::memcmp(&values[i], &prevValues[i], sizeof(double))) {
+                putU32(i);
+                putDouble(values[i]);
+            }
+        }
+    } else {
+        putU8('D');
+        putU32(values.size());
+        for (auto v : values)
+            putDouble(v);
+    }
+
+    prevValues.swap(values);
+    stream->flush();
+}
+
+bool
+Binary::valid() const
+{
+    return stream != nullptr && stream->good();
+}
+
+void
+Binary::beginGroup(const char *name)
+{
+    if (path.empty()) {
+        path.push(name);
+    } else {
+        path.push(csprintf("%s.%s", path.top(), name));
+    }
+}
+
+void
+Binary::endGroup()
+{
+    assert(!path.empty());
+    path.pop();
+}
+
+std::string
+Binary::statName(const std::string &name) const
+{
+    if (path.empty())
+        return name;
+    else
+        return csprintf("%s.%s", path.top(), name);
+}
+
+Binary::Entry *
+Binary::schemaEntry(const Info &info, Kind kind, uint32_t num_values)
+{
+    if (schemaPos < schema.size()) {
+        const Entry &entry = schema[schemaPos];
+        if (entry.info == &info && entry.kind == kind &&
+            entry.numValues == num_values) {
+            ++schemaPos;
+            return nullptr;
+        }
+
+        schema.resize(schemaPos);
+    }
+
+    schemaChanged = true;
+    schema.push_back(Entry{ &info, num_values, kind, statName(info.name),
+                            std::vector<std::string>() });
+    ++schemaPos;
+    return &schema.back();
+}
+
+void
+Binary::visit(const ScalarInfo &info)
+{
+    // Prerequisites are ignored, the layout of a dump would depend on
+    // the values otherwise.
+    if (!info.flags.isSet(display))
+        return;
+
+    schemaEntry(info, ScalarKind, 1);
+    values.push_back(info.result());
+}
+
+void
+Binary::visitVector(const VectorInfo &info, Kind kind)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const VResult &result = info.result();
+    Entry *entry = schemaEntry(info, kind, result.size());
+    if (entry) {
+        for (off_type i = 0; i < result.size(); ++i)
+            entry->valueNames.push_back(subname(info.subnames, i));
+    }
+
+    values.insert(values.end(), result.begin(), result.end());
+}
+
+void
+Binary::visit(const VectorInfo &info)
+{
+    visitVector(info, VectorKind);
+}
+
+void
+Binary::distValueNames(const DistData &data, const std::string &prefix,
+                       std::vector<std::string> &names)
+{
+    static const char *summary[] = {
+        "samples", "sum", "squares",
+        "min_val", "max_val", "underflow", "overflow",
+        "min", "bucket_size",
+    };
+
+    const size_t num_summary = data.type == Deviation ? 3 : 9;
+    for (size_t i = 0; i < num_summary; ++i)
+        names.push_back(prefix + summary[i]);
+
+    if (data.type == Deviation)
+        return;
+
+    for (off_type i = 0; i < data.cvec.size(); ++i)
+        names.push_back(csprintf("%s%d", prefix,
+                                 data.min + i * data.bucket_size));
+}
+
+void
+Binary::appendDist(const DistData &data)
+{
+    values.push_back(data.samples);
+    values.push_back(data.sum);
+    values.push_back(data.squares);
+    if (data.type == Deviation)
+        return;
+
+    values.push_back(data.min_val);
+    values.push_back(data.max_val);
+    values.push_back(data.underflow);
+    values.push_back(data.overflow);
+    values.push_back(data.min);
+    values.push_back(data.bucket_size);
+    values.insert(values.end(), data.cvec.begin(), data.cvec.end());
+}
+
+void
+Binary::visit(const DistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = values.size();
+    appendDist(info.data);
+
+    Entry *entry = schemaEntry(info, DistKind, values.size() - first);
+    if (entry)
+        distValueNames(info.data, "", entry->valueNames);
+}
+
+void
+Binary::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const size_t first = values.size();
+    for (const auto &data : info.data)
+        appendDist(data);
+
+    Entry *entry = schemaEntry(info, VectorDistKind, values.size() - first);
+    if (entry) {
+        for (off_type i = 0; i < info.data.size(); ++i) {
+            distValueNames(info.data[i], subname(info.subnames, i) + "::",
+                           entry->valueNames);
+        }
+    }
+}
+
+void
+Binary::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    Entry *entry = schemaEntry(info, Vector2dKind, info.cvec.size());
+    if (entry) {
+        for (off_type x = 0; x < info.x; ++x) {
+            const std::string xname = subname(info.subnames, x);
+            for (off_type y = 0; y < info.y; ++y) {
+                entry->valueNames.push_back(
+                    xname + "::" + subname(info.y_subnames, y));
+            }
+        }
+    }
+
+    values.insert(values.end(), info.cvec.begin(), info.cvec.end());
+}
+
+void
+Binary::visit(const FormulaInfo &info)
+{
+    if (enableFormula)
+        visitVector(info, FormulaKind);
+}
+
+void
+Binary::visit(const SparseHistInfo &info)
+{
+    // The number of values of a sparse histogram changes from one
+    // dump to the next, which doesn't fit a fixed layout.
+    if (info.flags.isSet(display))
+        warn_once("Sparse histograms are not stored in binary stats.\n");
+}
+
+void
+BinaryWriter::putHeader()
+{
+    stream->write(binaryMagic, 4);
+    putU32(binaryVersion);
+}
+
+void
+BinaryWriter::putU32(uint32_t val)
+{
+    char buf[4];
+    for (int i = 0; i < 4; ++i)
+        buf[i] = (val >> (8 * i)) & 0xff;
+    stream->write(buf, sizeof(buf));
+}
+
+void
+BinaryWriter::putString(const std::string &str)
+{
+    putU32(str.size());
+    stream->write(str.data(), str.size());
+}
+
+void
+BinaryWriter::putDouble(double val)
+{
+    static_assert(sizeof(double) == sizeof(uint64_t),
+                  "Binary stats expect 64-bit doubles");
+    uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+
+    char buf[8];
+    for (int i = 0; i < 8; ++i)
+        buf[i] = (bits >> (8 * i)) & 0xff;
+    stream->write(buf, sizeof(buf));
+}
+
+void
+Binary::writeSchema()
+{
+    putU8('S');
+    putU32(schema.size());
+    for (const auto &entry : schema) {
+        putString(entry.name);
+        putString(enableDescriptions ? entry.info->desc : "");
+        putU8(entry.kind);
+        putU32(entry.numValues);
+        putU32(entry.valueNames.size());
+        for (const auto &name : entry.valueNames)
+            putString(name);
+    }
+}
+
+std::unique_ptr<Output>
+initBinary(const std::string &filename, bool changed_only, bool desc,
+           bool formulas)
+{
+    return std::unique_ptr<Output>(
+        new Binary(filename, changed_only, desc, formulas));
+}
+
+} // namespace Stats
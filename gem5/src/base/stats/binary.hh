@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_STATS_BINARY_HH__
+#define __BASE_STATS_BINARY_HH__
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <stack>
+#include <string>
+#include <vector>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+class OutputStream;
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Writer of the values making up the records of the binary stat
+ * format described in Binary, for the objects that store stats in
+ * this format.
+ */
+class BinaryWriter
+{
+  protected:
+    std::ostream *stream;
+
+  public:
+    BinaryWriter(std::ostream *_stream = nullptr) : stream(_stream) {}
+
+    /** Write the magic and the version starting the file */
+    void putHeader();
+
+    void putU8(uint8_t val) { stream->put(val); }
+    void putU32(uint32_t val);
+    void putString(const std::string &str);
+    void putDouble(double val);
+};
+
+/**
+ * Compact binary stat output for frequent dumps. The names of the
+ * stats are written once, in a schema record, and every dump only
+ * writes the raw values, optionally just the ones that changed since
+ * the previous dump. A new schema is written whenever the set of
+ * stats changes. util/read_binary_stats.py turns the file into a
+ * pandas DataFrame with a row per dump.
+ *
+ * The file starts with the magic "GSTB" and a 32-bit version,
+ * followed by records starting with a one byte tag. All integers are
+ * little-endian and strings are stored as a 32-bit length followed
+ * by the characters.
+ * <ul>
+ * <li>'S': a schema, made of the number of stats and, for every
+ *     stat, its name, description (empty unless enabled), kind,
+ *     number of values, and the number of value names followed by
+ *     the names (there are none for scalars).
+ * <li>'D': a full dump, made of the number of values and the values
+ *     as doubles.
+ * <li>'C': a dump of the values that changed, made of their number
+ *     and of pairs of 32-bit index and double value.
+ * </ul>
+ */
+class Binary : public Output, protected BinaryWriter
+{
+  public:
+    /** Kind of a stat in the schema */
+    enum Kind : uint8_t {
+        ScalarKind, VectorKind, DistKind, VectorDistKind, Vector2dKind,
+        FormulaKind
+    };
+
+    Binary(const std::string &file, bool changed_only, bool desc,
+           bool formulas);
+
+    ~Binary();
+
+    Binary() = delete;
+    Binary(const Binary &other) = delete;
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override;
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** A stat in the schema */
+    struct Entry
+    {
+        const Info *info;
+        uint32_t numValues;
+        Kind kind;
+        std::string name;
+        std::vector<std::string> valueNames;
+    };
+
+    /**
+     * Check that the stat at the current position of the schema is
+     * the one being visited, and replace the rest of the schema by
+     * new entries otherwise.
+     *
+     * @return The new entry to fill in, or nullptr if the schema
+     *         matched.
+     */
+    Entry *schemaEntry(const Info &info, Kind kind, uint32_t num_values);
+
+    /** Get the name of a stat, including the group path */
+    std::string statName(const std::string &name) const;
+
+    /** Visit a vector or a formula */
+    void visitVector(const VectorInfo &info, Kind kind);
+
+    /** Append the values of a distribution */
+    void appendDist(const DistData &data);
+
+    /** Names of the values appended by appendDist */
+    static void distValueNames(const DistData &data,
+                               const std::string &prefix,
+                               std::vector<std::string> &names);
+
+    void writeSchema();
+
+  protected:
+    OutputStream *file;
+
+    const bool changedOnly;
+    const bool enableDescriptions;
+    const bool enableFormula;
+
+    std::stack<std::string> path;
+
+    /** The stats in the order they are visited */
+    std::vector<Entry> schema;
+
+    /** Position in the schema of the next stat visited */
+    size_t schemaPos;
+
+    /** Was the schema changed in the current dump? */
+    bool schemaChanged;
+
+    /** Values of the current and of the previous dump */
+    std::vector<double> values;
+    std::vector<double> prevValues;
+};
+
+std::unique_ptr<Output> initBinary(const std::string &filename,
+                                   bool changed_only = false,
+                                   bool desc = false, bool formulas = true);
+
+} // namespace Stats
+
+#endif // __BASE_STATS_BINARY_HH__
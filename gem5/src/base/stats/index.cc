@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "base/stats/index.hh"
+
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "base/stats/group.hh"
+#include "base/stats/info.hh"
+#include "base/stats/output.hh"
+
+namespace Stats {
+
+namespace {
+
+bool
+globMatch(const std::string &pattern, const std::string &name)
+{
+    return fnmatch(pattern.c_str(), name.c_str(), 0) == 0;
+}
+
+bool
+globMatchAny(const std::vector<std::string> &patterns,
+             const std::string &name)
+{
+    for (const auto &pattern : patterns) {
+        if (globMatch(pattern, name))
+            return true;
+    }
+    return false;
+}
+
+} // anonymous namespace
+
+void
+Index::build(Group *_root)
+{
+    root = _root;
+
+    legacy.assign(statsList().begin(), statsList().end());
+    std::stable_sort(legacy.begin(), legacy.end(), Info::less);
+
+    byName.clear();
+    for (auto info : legacy)
+        byName.emplace_back(info->name, info);
+    if (root)
+        addGroup(*root, "");
+
+    std::sort(byName.begin(), byName.end(),
+              [](const std::pair<std::string, Info *> &a,
+                 const std::pair<std::string, Info *> &b) {
+                  return a.first < b.first;
+              });
+
+    isBuilt = true;
+}
+
+void
+Index::addGroup(Group &group, const std::string &path)
+{
+    for (auto info : group.getStats())
+        byName.emplace_back(path + info->name, info);
+
+    for (const auto &g : group.getStatGroups())
+        addGroup(*g.second, path + g.first + ".");
+}
+
+std::pair<size_t, size_t>
+Index::prefixRange(const std::string &prefix) const
+{
+    auto first = std::lower_bound(
+        byName.begin(), byName.end(), prefix,
+        [](const std::pair<std::string, Info *> &a, const std::string &b) {
+            return a.first < b;
+        });
+
+    auto last = first;
+    while (last != byName.end() &&
+           last->first.compare(0, prefix.size(), prefix) == 0) {
+        ++last;
+    }
+
+    return std::make_pair(first - byName.begin(), last - byName.begin());
+}
+
+void
+Index::enable()
+{
+    for (const auto &entry : byName) {
+        Info *info = entry.second;
+        if (!info->check() || !info->baseCheck()) {
+            fatal("statistic '%s' (%d) was not properly initialized "
+                  "by a regStats() function\n", entry.first, info->id);
+        }
+
+        if (!info->flags.isSet(display))
+            info->name = csprintf("__Stat%06d", info->id);
+
+        info->enable();
+    }
+}
+
+Info *
+Index::find(const std::string &name) const
+{
+    auto range = prefixRange(name);
+    for (size_t i = range.first; i < range.second; ++i) {
+        if (byName[i].first == name)
+            return byName[i].second;
+    }
+    return nullptr;
+}
+
+std::vector<size_t>
+Index::matchIndices(const std::string &pattern) const
+{
+    // Only the stats starting with the part of the pattern before the
+    // first wildcard can match.
+    const std::string prefix =
+        pattern.substr(0, pattern.find_first_of("*?[\\"));
+    auto range = prefixRange(prefix);
+
+    std::vector<size_t> indices;
+    for (size_t i = range.first; i < range.second; ++i) {
+        if (globMatch(pattern, byName[i].first))
+            indices.push_back(i);
+    }
+    return indices;
+}
+
+std::vector<Info *>
+Index::match(const std::string &pattern) const
+{
+    std::vector<Info *> stats;
+    for (auto i : matchIndices(pattern))
+        stats.push_back(byName[i].second);
+    return stats;
+}
+
+std::vector<std::string>
+Index::matchNames(const std::string &pattern) const
+{
+    std::vector<std::string> names;
+    for (auto i : matchIndices(pattern))
+        names.push_back(byName[i].first);
+    return names;
+}
+
+std::vector<Result>
+Index::values(const std::vector<std::string> &names) const
+{
+    std::vector<Result> vals;
+    vals.reserve(names.size());
+
+    for (const auto &name : names) {
+        Info *info = find(name);
+        if (auto scalar = dynamic_cast<ScalarInfo *>(info)) {
+            vals.push_back(scalar->result());
+        } else if (auto vector = dynamic_cast<VectorInfo *>(info)) {
+            vals.push_back(vector->total());
+        } else {
+            vals.push_back(NAN);
+        }
+    }
+
+    return vals;
+}
+
+void
+Index::filter(const std::vector<std::string> &allow,
+              const std::vector<std::string> &deny)
+{
+    if (allow.empty() && deny.empty())
+        return;
+
+    for (const auto &entry : byName) {
+        Info *info = entry.second;
+        if (!info->flags.isSet(display))
+            continue;
+
+        if ((!allow.empty() && !globMatchAny(allow, entry.first)) ||
+            globMatchAny(deny, entry.first)) {
+            info->disable();
+        }
+    }
+}
+
+void
+Index::prepare()
+{
+    for (const auto &entry : byName)
+        entry.second->prepare();
+}
+
+void
+Index::visitGroup(Output &output, Group &group)
+{
+    for (auto info : group.getStats())
+        info->visit(output);
+
+    for (const auto &g : group.getStatGroups()) {
+        output.beginGroup(g.first.c_str());
+        visitGroup(output, *g.second);
+        output.endGroup();
+    }
+}
+
+void
+Index::visit(Output &output)
+{
+    for (auto info : legacy)
+        info->visit(output);
+
+    if (root)
+        visitGroup(output, *root);
+}
+
+void
+Index::resetLegacy()
+{
+    for (auto info : legacy)
+        info->reset();
+}
+
+Index &
+statsIndex()
+{
+    static Index index;
+    return index;
+}
+
+} // namespace Stats
@@ -0,0 +1,138 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_STATS_INDEX_HH__
+#define __BASE_STATS_INDEX_HH__
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+class Group;
+class Info;
+struct Output;
+
+/**
+ * Index of all the stats by their full name, built once the stat
+ * hierarchy is complete, so that the stats can be looked up, filtered,
+ * prepared and visited without walking the groups from Python. The
+ * names are kept sorted, so that the stats starting with a prefix are
+ * found with a binary search.
+ */
+class Index
+{
+  public:
+    /**
+     * Index the legacy stats, which have their full name, and the
+     * stats of the groups under the root, if there is one.
+     */
+    void build(Group *root);
+
+    bool built() const { return isBuilt; }
+
+    /**
+     * Check that all the stats have been initialized, and enable
+     * them. Stats that aren't displayed get a generated name.
+     */
+    void enable();
+
+    /** Find a stat by its full name, nullptr if there is none */
+    Info *find(const std::string &name) const;
+
+    /** Find the stats matching a glob pattern, in name order */
+    std::vector<Info *> match(const std::string &pattern) const;
+
+    /** Names of the stats matching a glob pattern */
+    std::vector<std::string> matchNames(const std::string &pattern) const;
+
+    /**
+     * Current value of some stats: the result of scalars and the
+     * total of vectors and formulas. Other stats and unknown names
+     * get NaN.
+     */
+    std::vector<Result> values(const std::vector<std::string> &names) const;
+
+    /**
+     * Disable the displayed stats that don't match any of the allow
+     * patterns, if there are any, or that match one of the deny
+     * patterns.
+     */
+    void filter(const std::vector<std::string> &allow,
+                const std::vector<std::string> &deny);
+
+    /** Prepare all the stats for a dump */
+    void prepare();
+
+    /**
+     * Visit all the stats, the legacy stats first and then the groups
+     * under the root, in the same order as the dumps from Python.
+     */
+    void visit(Output &output);
+
+    /** Reset the legacy stats; the groups reset their own stats */
+    void resetLegacy();
+
+    const std::vector<std::pair<std::string, Info *>> &
+    all() const
+    {
+        return byName;
+    }
+
+  protected:
+    void addGroup(Group &group, const std::string &path);
+
+    void visitGroup(Output &output, Group &group);
+
+    /** Range of the stats whose name starts with the prefix */
+    std::pair<size_t, size_t> prefixRange(const std::string &prefix) const;
+
+    /** Positions in byName of the stats matching a glob pattern */
+    std::vector<size_t> matchIndices(const std::string &pattern) const;
+
+    bool isBuilt = false;
+
+    Group *root = nullptr;
+
+    /** Legacy stats, in the order they are dumped */
+    std::vector<Info *> legacy;
+
+    /** All the stats, sorted by name */
+    std::vector<std::pair<std::string, Info *>> byName;
+};
+
+/** Index of the stats of the simulation */
+Index &statsIndex();
+
+} // namespace Stats
+
+#endif // __BASE_STATS_INDEX_HH__
@@ -115,6 +115,12 @@ class Info
      */
     virtual void enable();
 
+    /**
+     * Disable the stat. It is no longer output and updates to it are
+     * ignored.
+     */
+    virtual void disable();
+
     /**
      * Prepare the stat for dumping.
      */
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "base/stats/json.hh"
+
+#include <cmath>
+
+#include "base/cprintf.hh"
+#include "base/stats/info.hh"
+
+namespace Stats {
+
+namespace {
+
+/** Name of a value of a stat, its index if it has no subname */
+std::string
+subname(const std::vector<std::string> &subnames, off_type i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    else
+        return std::to_string(i);
+}
+
+/** Write a string with the JSON escapes */
+void
+quote(std::ostream &stream, const std::string &str)
+{
+    stream.put('"');
+    for (char c : str) {
+        if (c == '"' || c == '\\') {
+            stream.put('\\');
+            stream.put(c);
+        } else if ((unsigned char)c < 0x20) {
+            ccprintf(stream, "\\u%04x", (unsigned)c);
+        } else {
+            stream.put(c);
+        }
+    }
+    stream.put('"');
+}
+
+} // anonymous namespace
+
+Json::Json(std::ostream &_stream, Tick _tick)
+    : stream(_stream), tick(_tick), first(true)
+{
+}
+
+void
+Json::begin()
+{
+    assert(path.empty());
+
+    first = true;
+    ccprintf(stream, "{\"tick\": %d, \"stats\": {", tick);
+}
+
+void
+Json::end()
+{
+    stream << "}}\n";
+}
+
+void
+Json::beginGroup(const char *name)
+{
+    if (path.empty()) {
+        path.push(name);
+    } else {
+        path.push(csprintf("%s.%s", path.top(), name));
+    }
+}
+
+void
+Json::endGroup()
+{
+    assert(!path.empty());
+    path.pop();
+}
+
+std::string
+Json::statName(const std::string &name) const
+{
+    if (path.empty())
+        return name;
+    else
+        return csprintf("%s.%s", path.top(), name);
+}
+
+void
+Json::value(const std::string &name, Result val)
+{
+    if (!first)
+        stream << ", ";
+    first = false;
+
+    quote(stream, name);
+    if (std::isfinite(val))
+        ccprintf(stream, ": %.12g", val);
+    else
+        stream << ": null";
+}
+
+void
+Json::dist(const std::string &name, const DistData &data)
+{
+    value(name + "samples", data.samples);
+    value(name + "sum", data.sum);
+    value(name + "squares", data.squares);
+    if (data.type == Deviation)
+        return;
+
+    value(name + "min_val", data.min_val);
+    value(name + "max_val", data.max_val);
+    value(name + "underflow", data.underflow);
+    value(name + "overflow", data.overflow);
+    for (off_type i = 0; i < data.cvec.size(); ++i)
+        value(csprintf("%s%d", name, data.min + i * data.bucket_size),
+              data.cvec[i]);
+}
+
+void
+Json::visit(const ScalarInfo &info)
+{
+    if (info.flags.isSet(display))
+        value(statName(info.name), info.result());
+}
+
+void
+Json::visit(const VectorInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const std::string name = statName(info.name);
+    const VResult &result = info.result();
+    for (off_type i = 0; i < result.size(); ++i)
+        value(name + "::" + subname(info.subnames, i), result[i]);
+}
+
+void
+Json::visit(const DistInfo &info)
+{
+    if (info.flags.isSet(display))
+        dist(statName(info.name) + "::", info.data);
+}
+
+void
+Json::visit(const VectorDistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const std::string name = statName(info.name);
+    for (off_type i = 0; i < info.data.size(); ++i)
+        dist(name + "::" + subname(info.subnames, i) + "::", info.data[i]);
+}
+
+void
+Json::visit(const Vector2dInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const std::string name = statName(info.name);
+    for (off_type x = 0; x < info.x; ++x) {
+        const std::string xname = name + "::" + subname(info.subnames, x);
+        for (off_type y = 0; y < info.y; ++y) {
+            value(xname + "::" + subname(info.y_subnames, y),
+                  info.cvec[x * info.y + y]);
+        }
+    }
+}
+
+void
+Json::visit(const FormulaInfo &info)
+{
+    visit((const VectorInfo &)info);
+}
+
+void
+Json::visit(const SparseHistInfo &info)
+{
+    if (!info.flags.isSet(display))
+        return;
+
+    const std::string name = statName(info.name);
+    value(name + "::samples", info.data.samples);
+    for (const auto &it : info.data.cmap)
+        value(csprintf("%s::%d", name, it.first), it.second);
+}
+
+} // namespace Stats
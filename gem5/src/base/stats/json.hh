@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_STATS_JSON_HH__
+#define __BASE_STATS_JSON_HH__
+
+#include <ostream>
+#include <stack>
+#include <string>
+
+#include "base/stats/output.hh"
+#include "base/stats/types.hh"
+
+namespace Stats {
+
+struct DistData;
+
+/**
+ * Stat output as a single JSON object, for tools that poll the stats
+ * of a running simulation. The object maps the name of every value to
+ * the value, null if it isn't finite. Values are named like in the
+ * binary stats: the name of the stat, followed by "::" and the name of
+ * the value for vectors, distributions and formulas.
+ */
+class Json : public Output
+{
+  public:
+    /**
+     * @param stream Stream to write to
+     * @param tick Tick stored along with the values
+     */
+    Json(std::ostream &stream, Tick tick);
+
+  public: // Output interface
+    void begin() override;
+    void end() override;
+    bool valid() const override { return true; }
+
+    void beginGroup(const char *name) override;
+    void endGroup() override;
+
+    void visit(const ScalarInfo &info) override;
+    void visit(const VectorInfo &info) override;
+    void visit(const DistInfo &info) override;
+    void visit(const VectorDistInfo &info) override;
+    void visit(const Vector2dInfo &info) override;
+    void visit(const FormulaInfo &info) override;
+    void visit(const SparseHistInfo &info) override;
+
+  protected:
+    /** Get the name of a stat, including the group path */
+    std::string statName(const std::string &name) const;
+
+    void value(const std::string &name, Result val);
+
+    void dist(const std::string &name, const DistData &data);
+
+    std::ostream &stream;
+    const Tick tick;
+
+    std::stack<std::string> path;
+
+    /** Has a value been written since begin()? */
+    bool first;
+};
+
+} // namespace Stats
+
+#endif // __BASE_STATS_JSON_HH__
@@ -62,6 +62,10 @@ namespace Trace
 
 Logger *debug_logger = NULL;
 
+// Set when the messages are kept in memory while debug logging is
+// disabled, in which case it is the debug logger.
+HistoryLogger *history_logger = NULL;
+
 Logger *
 getDebugLogger()
 {
@@ -83,6 +87,8 @@ setDebugLogger(Logger *logger)
 {
     if (!logger)
         warn("Trying to set debug logger to NULL\n");
+    else if (history_logger)
+        history_logger->setOutput(logger);
     else
         debug_logger = logger;
 }
@@ -90,13 +96,35 @@ setDebugLogger(Logger *logger)
 void
 enable()
 {
+    if (history_logger)
+        history_logger->release();
     Debug::SimpleFlag::enableAll();
 }
 
 void
 disable()
 {
-    Debug::SimpleFlag::disableAll();
+    if (history_logger)
+        history_logger->hold();
+    else
+        Debug::SimpleFlag::disableAll();
+}
+
+void
+setHistory(size_t messages)
+{
+    if (history_logger) {
+        warn("Debug message history already set, ignoring\n");
+        return;
+    }
+
+    history_logger = new HistoryLogger(getDebugLogger(), messages);
+    debug_logger = history_logger;
+
+    if (!Debug::SimpleFlag::active()) {
+        history_logger->hold();
+        Debug::SimpleFlag::enableAll();
+    }
 }
 
 ObjectMatch ignore;
@@ -157,4 +185,38 @@ OstreamLogger::logMessage(Tick when, const std::string &name,
     stream.flush();
 }
 
+void
+HistoryLogger::hold()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    held = true;
+}
+
+void
+HistoryLogger::release()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (const auto &m : messages)
+        out->logMessage(m.when, m.name, m.message);
+    messages.clear();
+    held = false;
+}
+
+void
+HistoryLogger::logMessage(Tick when, const std::string &name,
+                          const std::string &message)
+{
+    if (!held) {
+        out->logMessage(when, name, message);
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    if (size == 0)
+        return;
+    if (messages.size() == size)
+        messages.pop_front();
+    messages.push_back(Message{when, name, message});
+}
+
 } // namespace Trace
@@ -36,11 +36,14 @@
 #ifndef __BASE_TRACE_HH__
 #define __BASE_TRACE_HH__
 
+#include <deque>
+#include <mutex>
 #include <string>
 
 #include "base/cprintf.hh"
 #include "base/debug.hh"
 #include "base/match.hh"
+#include "base/trace_args.hh"
 #include "base/types.hh"
 #include "sim/core.hh"
 
@@ -54,7 +57,12 @@ class Logger
     /** Name match for objects to ignore */
     ObjectMatch ignore;
 
+    /** Does this logger take the raw arguments of the messages? */
+    bool rawArgs;
+
   public:
+    Logger() : rawArgs(false) { }
+
     /** Log a single message */
     template <typename ...Args>
     void dprintf(Tick when, const std::string &name, const char *fmt,
@@ -63,6 +71,13 @@ class Logger
         if (!name.empty() && ignore.match(name))
             return;
 
+        if (rawArgs) {
+            RawArgs raw;
+            raw.add(args...);
+            logRaw(when, name, fmt, raw);
+            return;
+        }
+
         std::ostringstream line;
         ccprintf(line, fmt, args...);
         logMessage(when, name, line.str());
@@ -76,6 +91,10 @@ class Logger
     virtual void logMessage(Tick when, const std::string &name,
                             const std::string &message) = 0;
 
+    /** Log a message that hasn't been formatted, if rawArgs is set */
+    virtual void logRaw(Tick when, const std::string &name,
+                        const char *fmt, const RawArgs &args) { }
+
     /** Return an ostream that can be used to send messages to
      *  the 'same place' as formatted logMessage messages.  This
      *  can be implemented to use a logger's underlying ostream,
@@ -109,6 +128,50 @@ class OstreamLogger : public Logger
     std::ostream &getOstream() override { return stream; }
 };
 
+/** Logger that keeps the last messages in memory while it's held, and
+ *  passes them on to another logger when it's released. This allows
+ *  tracing the messages leading to an event without tracing the whole
+ *  simulation. */
+class HistoryLogger : public Logger
+{
+  protected:
+    struct Message
+    {
+        Tick when;
+        std::string name;
+        std::string message;
+    };
+
+    /** Logger that the messages are passed on to */
+    Logger *out;
+
+    /** Maximum number of messages kept while held */
+    size_t size;
+
+    bool held;
+
+    std::mutex lock;
+    std::deque<Message> messages;
+
+  public:
+    HistoryLogger(Logger *out_, size_t size_)
+        : out(out_), size(size_), held(false)
+    { }
+
+    void setOutput(Logger *out_) { out = out_; }
+
+    /** Keep the messages in memory from now on */
+    void hold();
+
+    /** Write out the messages kept, and pass on the next ones */
+    void release();
+
+    void logMessage(Tick when, const std::string &name,
+                    const std::string &message) override;
+
+    std::ostream &getOstream() override { return out->getOstream(); }
+};
+
 /** Get the current global debug logger.  This takes ownership of the given
  *  logger which should be allocated using 'new' */
 Logger *getDebugLogger();
@@ -123,6 +186,11 @@ void setDebugLogger(Logger *logger);
 void enable();
 void disable();
 
+/** Keep the last messages in memory while debug logging is disabled,
+ *  and write them out when it's enabled again. The debug flags stay
+ *  enabled and messages are formatted in the meantime. */
+void setHistory(size_t messages);
+
 } // namespace Trace
 
 // This silly little class allows us to wrap a string in a functor
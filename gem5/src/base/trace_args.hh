@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __BASE_TRACE_ARGS_HH__
+#define __BASE_TRACE_ARGS_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+namespace Trace {
+
+/**
+ * The arguments of a debug message in a compact binary form, for
+ * loggers that format the messages offline (see BinaryLogger). Every
+ * argument is stored as a one byte tag followed by its value:
+ * integers, floating point numbers and pointers as 8 bytes, characters
+ * as 1 byte, and strings as a 32-bit length followed by the
+ * characters. All values are little endian. Arguments of other types
+ * are converted to a string using their output operator, like cprintf
+ * does. Arguments that don't fit in the buffer are dropped.
+ */
+class RawArgs
+{
+  public:
+    /** Type tag of an argument */
+    enum Tag : uint8_t {
+        Signed = 'i',
+        Unsigned = 'u',
+        Float = 'f',
+        Char = 'c',
+        String = 's',
+        Pointer = 'p',
+    };
+
+    /** Maximum size of the arguments of a message */
+    static const size_t MaxSize = 1024;
+
+  protected:
+    char buf[MaxSize];
+    size_t len;
+
+    bool
+    room(size_t n) const
+    {
+        return len + n <= MaxSize;
+    }
+
+    void
+    put64(Tag tag, uint64_t val)
+    {
+        if (!room(9))
+            return;
+        buf[len++] = tag;
+        for (int i = 0; i < 8; ++i)
+            buf[len++] = (val >> (8 * i)) & 0xff;
+    }
+
+    void
+    putString(const char *s, size_t n)
+    {
+        if (!room(5))
+            return;
+        if (!room(5 + n))
+            n = MaxSize - len - 5;
+        buf[len++] = String;
+        for (int i = 0; i < 4; ++i)
+            buf[len++] = (n >> (8 * i)) & 0xff;
+        std::memcpy(buf + len, s, n);
+        len += n;
+    }
+
+    void
+    putChar(char c)
+    {
+        if (!room(2))
+            return;
+        buf[len++] = Char;
+        buf[len++] = c;
+    }
+
+  public:
+    RawArgs() : len(0) {}
+
+    const char *data() const { return buf; }
+    size_t size() const { return len; }
+
+    void add() {}
+
+    template <typename T, typename ...Args>
+    void
+    add(const T &arg, const Args &...args)
+    {
+        addArg(arg);
+        add(args...);
+    }
+
+  protected:
+    void addArg(char c) { putChar(c); }
+    void addArg(signed char c) { putChar(c); }
+    void addArg(unsigned char c) { putChar(c); }
+
+    void addArg(const char *s) { putString(s, s ? std::strlen(s) : 0); }
+    void addArg(char *s) { addArg((const char *)s); }
+    void addArg(const std::string &s) { putString(s.data(), s.size()); }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            std::is_signed<T>::value>::type
+    addArg(const T &v)
+    {
+        put64(Signed, (int64_t)v);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_integral<T>::value &&
+                            !std::is_signed<T>::value>::type
+    addArg(const T &v)
+    {
+        put64(Unsigned, (uint64_t)v);
+    }
+
+    template <typename T>
+    typename std::enable_if<std::is_floating_point<T>::value>::type
+    addArg(const T &v)
+    {
+        double d = v;
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        put64(Float, bits);
+    }
+
+    template <typename T>
+    void
+    addArg(T *p)
+    {
+        put64(Pointer, (uintptr_t)p);
+    }
+
+    template <size_t N>
+    void
+    addArg(const char (&s)[N])
+    {
+        addArg((const char *)s);
+    }
+
+    template <typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value &&
+                            !std::is_pointer<T>::value>::type
+    addArg(const T &v)
+    {
+        std::ostringstream s;
+        s << v;
+        addArg(s.str());
+    }
+};
+
+} // namespace Trace
+
+#endif // __BASE_TRACE_ARGS_HH__
@@ -0,0 +1,124 @@
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+from m5.SimObject import SimObject, PyBindMethod
+from m5.params import *
+from m5.proxy import *
+
+class SamplingController(SimObject):
+    """SMARTS-style sampled simulation.
+
+    The controller alternates between the fast CPUs and the detailed
+    CPUs. Each sample fast-forwards fast_forward_insts instructions,
+    switches to the detailed CPUs, warms their microarchitectural state
+    up for warmup_insts instructions and finally measures the CPI over
+    measure_insts instructions. The fast CPUs should use caches in
+    functional warming mode, so that the caches are warm whenever the
+    detailed CPUs take over. The statistics of the controller report the
+    mean CPI over all the samples with its confidence interval; they
+    aren't affected by stats resets.
+
+    The instruction counts are those of the first thread of the first
+    CPU. Call run() after instantiating the system to run the samples.
+    """
+
+    type = 'SamplingController'
+    cxx_header = "cpu/sampling_controller.hh"
+
+    cxx_exports = [
+        PyBindMethod("startSample"),
+        PyBindMethod("endSample"),
+    ]
+
+    system = Param.System(Parent.any, "System the CPUs belong to")
+    fast_cpus = VectorParam.BaseCPU("CPUs used to fast-forward")
+    detailed_cpus = VectorParam.BaseCPU("CPUs used to warm up and measure, "
+                                        "switched out initially")
+
+    fast_forward_insts = Param.Counter("Instructions to fast-forward "
+                                       "before each sample")
+    warmup_insts = Param.Counter(0, "Instructions to warm up the "
+                                 "detailed CPUs before measuring")
+    measure_insts = Param.Counter("Instructions measured per sample")
+    num_samples = Param.Unsigned("Number of samples")
+
+    confidence_z = Param.Float(1.96, "Standard score of the confidence "
+                               "interval (e.g., 1.96 for 95%)")
+
+    def _runFor(self, cpus, insts, cause):
+        """Run until the first CPU executed insts more instructions.
+        Returns None if it did, or the exit event that stopped the
+        simulation before that."""
+
+        import m5
+
+        if not insts:
+            return None
+
+        cpus[0].scheduleInstStop(0, insts, cause)
+        exit_event = m5.simulate()
+        return exit_event if exit_event.getCause() != cause else None
+
+    def run(self):
+        """Run all the samples.
+
+        Returns the exit event that stopped the simulation before the
+        samples were all taken (e.g., the workload exiting), or None
+        once every sample has been measured. The fast CPUs are
+        switched in again at the end of each sample.
+        """
+
+        import m5
+
+        fast = list(self.fast_cpus)
+        detailed = list(self.detailed_cpus)
+        to_detailed = list(zip(fast, detailed))
+        to_fast = list(zip(detailed, fast))
+
+        for i in range(self.num_samples):
+            exit_event = self._runFor(fast, self.fast_forward_insts,
+                                      "sampling: end of fast-forward")
+            if exit_event is not None:
+                return exit_event
+
+            m5.switchCpus(self.system, to_detailed, verbose=False)
+
+            exit_event = self._runFor(detailed, self.warmup_insts,
+                                      "sampling: end of warmup")
+            if exit_event is not None:
+                return exit_event
+
+            self.startSample()
+            exit_event = self._runFor(detailed, self.measure_insts,
+                                      "sampling: end of measurement")
+            if exit_event is not None:
+                return exit_event
+            self.endSample()
+
+            m5.switchCpus(self.system, to_fast, verbose=False)
+
+        return None
@@ -41,7 +41,7 @@ ActivityRecorder::ActivityRecorder(const string &name, int num_stages,
     int longest_latency, int activity)
     : _name(name), activityBuffer(longest_latency, 0),
       longestLatency(longest_latency), activityCount(activity),
-      numStages(num_stages)
+      inFlight(0), numStages(num_stages)
 {
     stageActive = new bool[numStages];
     std::memset(stageActive, 0, numStages);
@@ -64,6 +64,7 @@ ActivityRecorder::activity()
     activityBuffer[0] = true;
 
     ++activityCount;
+    ++inFlight;
 
     DPRINTF(Activity, "Activity: %i\n", activityCount);
 }
@@ -75,6 +76,7 @@ ActivityRecorder::advance()
     // time buffer advances, then decrement the activityCount.
     if (activityBuffer[-longestLatency]) {
         --activityCount;
+        --inFlight;
 
         assert(activityCount >= 0);
 
@@ -126,6 +128,7 @@ void
 ActivityRecorder::reset()
 {
     activityCount = 0;
+    inFlight = 0;
     std::memset(stageActive, 0, numStages);
     for (int i = 0; i < longestLatency + 1; ++i)
         activityBuffer.advance();
@@ -89,6 +89,11 @@ class ActivityRecorder
     /** Returns if the CPU should be active. */
     bool active() { return activityCount; }
 
+    /** Returns if there is communication still in flight, as opposed
+     *  to stages that are merely marked active.
+     */
+    bool communicating() const { return inFlight; }
+
     /** Clears the time buffer and the activity count. */
     void reset();
 
@@ -130,6 +135,9 @@ class ActivityRecorder
      */
     int activityCount;
 
+    /** Number of cycles of the time buffer that have activity. */
+    int inFlight;
+
     /** Number of stages that can be marked as active or inactive. */
     int numStages;
 
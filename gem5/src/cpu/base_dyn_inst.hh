@@ -92,7 +92,7 @@ class BaseDynInst : public ExecContext, public RefCounted
     typedef RefCountingPtr<BaseDynInst<Impl> > BaseDynInstPtr;
 
     // The list of instructions iterator type.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::DynInstList::iterator ListIt;
 
     enum {
         MaxInstSrcRegs = TheISA::MaxInstSrcRegs,        /// Max source regs
@@ -143,6 +143,10 @@ class BaseDynInst : public ExecContext, public RefCounted
         IsStrictlyOrdered,
         ReqMade,
         MemOpDone,
+        InICount,
+        InBranchCount,
+        ValuePredLookup,
+        ValuePredicted,
         MaxFlags
     };
 
@@ -200,6 +204,9 @@ class BaseDynInst : public ExecContext, public RefCounted
     /** Predicted PC state after this instruction. */
     TheISA::PCState predPC;
 
+    /** Value the value predictor predicted for the destination. */
+    RegVal predictedValue;
+
     /** The Macroop if one exists */
     const StaticInstPtr macroop;
 
@@ -501,6 +508,24 @@ class BaseDynInst : public ExecContext, public RefCounted
         return !(tempPC == predPC);
     }
 
+    /** Returns whether the value predictor looked up the instruction. */
+    bool valuePredLookup() const { return instFlags[ValuePredLookup]; }
+
+    /** Returns whether the dependents use a predicted value. */
+    bool valuePredicted() const { return instFlags[ValuePredicted]; }
+
+    /**
+     * Records a lookup of the value predictor.
+     * @param confident Whether the value is forwarded to the dependents.
+     */
+    void
+    setValuePrediction(RegVal value, bool confident)
+    {
+        instFlags[ValuePredLookup] = true;
+        instFlags[ValuePredicted] = confident;
+        predictedValue = value;
+    }
+
     //
     //  Instruction types.  Forward checks to StaticInst object.
     //
@@ -740,7 +765,7 @@ class BaseDynInst : public ExecContext, public RefCounted
     void clearCanIssue() { status.reset(CanIssue); }
 
     /** Sets this instruction as issued from the IQ. */
-    void setIssued() { status.set(Issued); }
+    void setIssued() { status.set(Issued); leaveICount(); }
 
     /** Returns whether or not this instruction has issued. */
     bool isIssued() const { return status[Issued]; }
@@ -749,11 +774,46 @@ class BaseDynInst : public ExecContext, public RefCounted
     void clearIssued() { status.reset(Issued); }
 
     /** Sets this instruction as executed. */
-    void setExecuted() { status.set(Executed); }
+    void setExecuted() { status.set(Executed); leaveBranchCount(); }
 
     /** Returns whether or not this instruction has executed. */
     bool isExecuted() const { return status[Executed]; }
 
+    /**
+     * Counts the instruction in the occupancy of its thread seen by
+     * the SMT fetch policy, until it issues (executes for a branch)
+     * or gets squashed.
+     */
+    void countThreadOccupancy();
+
+    /** Stops counting the instruction as not issued yet. */
+    void
+    leaveICount()
+    {
+        if (instFlags[InICount]) {
+            instFlags.reset(InICount);
+            --cpu->smtCounts[threadNumber].icount;
+        }
+    }
+
+    /** Stops counting the instruction as an unresolved branch. */
+    void
+    leaveBranchCount()
+    {
+        if (instFlags[InBranchCount]) {
+            instFlags.reset(InBranchCount);
+            --cpu->smtCounts[threadNumber].branchCount;
+        }
+    }
+
+    /** Stops counting the instruction in the occupancy of its thread. */
+    void
+    leaveThreadOccupancy()
+    {
+        leaveICount();
+        leaveBranchCount();
+    }
+
     /** Sets this instruction as ready to commit. */
     void setCanCommit() { status.set(CanCommit); }
 
@@ -791,7 +851,13 @@ class BaseDynInst : public ExecContext, public RefCounted
     bool isInIQ() const { return status[IqEntry]; }
 
     /** Sets this instruction as squashed in the IQ. */
-    void setSquashedInIQ() { status.set(SquashedInIQ); status.set(Squashed);}
+    void
+    setSquashedInIQ()
+    {
+        status.set(SquashedInIQ);
+        status.set(Squashed);
+        leaveThreadOccupancy();
+    }
 
     /** Returns whether or not this instruction is squashed in the IQ. */
     bool isSquashedInIQ() const { return status[SquashedInIQ]; }
@@ -809,7 +875,13 @@ class BaseDynInst : public ExecContext, public RefCounted
     bool isInLSQ() const { return status[LsqEntry]; }
 
     /** Sets this instruction as squashed in the LSQ. */
-    void setSquashedInLSQ() { status.set(SquashedInLSQ); status.set(Squashed);}
+    void
+    setSquashedInLSQ()
+    {
+        status.set(SquashedInLSQ);
+        status.set(Squashed);
+        leaveThreadOccupancy();
+    }
 
     /** Returns whether or not this instruction is squashed in the LSQ. */
     bool isSquashedInLSQ() const { return status[SquashedInLSQ]; }
@@ -97,6 +97,7 @@ BaseDynInst<Impl>::initVars()
     physEffAddr = 0;
     readyRegs = 0;
     memReqFlags = 0;
+    predictedValue = 0;
 
     status.reset();
 
@@ -142,6 +143,8 @@ BaseDynInst<Impl>::initVars()
 template <class Impl>
 BaseDynInst<Impl>::~BaseDynInst()
 {
+    leaveThreadOccupancy();
+
     if (memData) {
         delete [] memData;
     }
@@ -239,11 +242,25 @@ BaseDynInst<Impl>::eaSrcsReady() const
 
 
 
+template <class Impl>
+void
+BaseDynInst<Impl>::countThreadOccupancy()
+{
+    instFlags.set(InICount);
+    ++cpu->smtCounts[threadNumber].icount;
+
+    if (isControl()) {
+        instFlags.set(InBranchCount);
+        ++cpu->smtCounts[threadNumber].branchCount;
+    }
+}
+
 template <class Impl>
 void
 BaseDynInst<Impl>::setSquashed()
 {
     status.set(Squashed);
+    leaveThreadOccupancy();
 
     if (!isPinnedRegsRenamed() || isPinnedRegsSquashDone())
         return;
@@ -31,10 +31,14 @@
 #ifndef __CPU_DECODE_CACHE_HH__
 #define __CPU_DECODE_CACHE_HH__
 
+#include <algorithm>
+#include <cassert>
 #include <unordered_map>
+#include <vector>
 
 #include "arch/isa_traits.hh"
 #include "arch/types.hh"
+#include "base/intmath.hh"
 #include "config/the_isa.hh"
 #include "cpu/static_inst_fwd.hh"
 
@@ -50,7 +54,15 @@ namespace DecodeCache
 template <typename EMI>
 using InstMap = std::unordered_map<EMI, StaticInstPtr>;
 
-/// A sparse map from an Addr to a Value, stored in page chunks.
+/**
+ * A sparse map from an Addr to a Value, stored in page chunks. The pages
+ * are direct mapped to the slots of a flat table, so that looking up an
+ * address takes a shift, a mask and a compare instead of hashing it. A
+ * page that maps to the same slot as another one replaces it, which also
+ * bounds the memory used by the map. The users validate the values
+ * against the actual instruction bytes, so that losing or sharing pages
+ * never returns a wrong instruction.
+ */
 template<class Value>
 class AddrMap
 {
@@ -59,63 +71,56 @@ class AddrMap
     struct CachePage {
         Value items[TheISA::PageBytes];
     };
-    // A map of cache pages which allows a sparse mapping.
-    typedef typename std::unordered_map<Addr, CachePage *> PageMap;
-    typedef typename PageMap::iterator PageIt;
-    // Mini cache of recent lookups.
-    PageIt recent[2];
-    PageMap pageMap;
-
-    /// Update the mini cache of recent lookups.
-    /// @param recentest The most recent result;
-    void
-    update(PageIt recentest)
-    {
-        recent[1] = recent[0];
-        recent[0] = recentest;
-    }
 
-    /// Attempt to find the CacheePage which goes with a particular
-    /// address. First check the small cache of recent results, then
-    /// actually look in the hash map.
+    struct Slot {
+        Addr pageAddr;
+        CachePage *page;
+    };
+
+    std::vector<Slot> slots;
+
+    /// Find the CachePage which goes with a particular address,
+    /// replacing the page in its slot if it isn't the right one.
     /// @param addr The address to look up.
     CachePage *
     getPage(Addr addr)
     {
-        Addr page_addr = addr & ~(TheISA::PageBytes - 1);
-
-        // Check against recent lookups.
-        if (recent[0] != pageMap.end()) {
-            if (recent[0]->first == page_addr)
-                return recent[0]->second;
-            if (recent[1] != pageMap.end() &&
-                    recent[1]->first == page_addr) {
-                update(recent[1]);
-                // recent[1] has just become recent[0].
-                return recent[0]->second;
-            }
-        }
-
-        // Actually look in the has_map.
-        PageIt it = pageMap.find(page_addr);
-        if (it != pageMap.end()) {
-            update(it);
-            return it->second;
-        }
-
-        // Didn't find an existing page, so add a new one.
-        CachePage *newPage = new CachePage;
-        page_addr = page_addr & ~(TheISA::PageBytes - 1);
-        typename PageMap::value_type to_insert(page_addr, newPage);
-        update(pageMap.insert(to_insert).first);
-        return newPage;
+        const Addr page_addr = addr & ~(TheISA::PageBytes - 1);
+        Slot &slot =
+            slots[(page_addr / TheISA::PageBytes) & (slots.size() - 1)];
+
+        if (slot.page && slot.pageAddr == page_addr)
+            return slot.page;
+
+        // Reuse the memory of the page we replace.
+        if (slot.page)
+            std::fill(slot.page->items, slot.page->items + TheISA::PageBytes,
+                      Value());
+        else
+            slot.page = new CachePage;
+        slot.pageAddr = page_addr;
+        return slot.page;
     }
 
   public:
+    /// Default number of pages the map holds.
+    static const unsigned DefaultSlots = 256;
+
     /// Constructor
-    AddrMap()
+    /// @param num_slots Number of pages the map holds, a power of 2.
+    AddrMap(unsigned num_slots = DefaultSlots)
+        : slots(num_slots, Slot{0, nullptr})
+    {
+        assert(isPowerOf2(num_slots));
+    }
+
+    AddrMap(const AddrMap &) = delete;
+    AddrMap &operator=(const AddrMap &) = delete;
+
+    ~AddrMap()
     {
-        recent[0] = recent[1] = pageMap.end();
+        for (auto &slot : slots)
+            delete slot.page;
     }
 
     Value &
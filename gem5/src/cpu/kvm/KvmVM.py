@@ -40,9 +40,23 @@ from m5.proxy import *
 
 from m5.SimObject import SimObject
 
+class KvmIOEventFD(SimObject):
+    type = 'KvmIOEventFD'
+    cxx_header = "cpu/kvm/vm.hh"
+
+    addr = Param.Addr("Guest physical address or IO port to watch")
+    size = Param.Unsigned(2, "Size of the watched write (1, 2, 4 or 8)")
+    data = Param.UInt64("Value a guest write must have to match")
+    pio = Param.Bool(False, "Watch an IO port instead of a memory address")
+
 class KvmVM(SimObject):
     type = 'KvmVM'
     cxx_header = "cpu/kvm/vm.hh"
 
     coalescedMMIO = \
       VectorParam.AddrRange([], "memory ranges for coalesced MMIO")
+    coalescedPIO = \
+      VectorParam.AddrRange([], "IO port ranges for coalesced PIO")
+    ioEventFDs = VectorParam.KvmIOEventFD([],
+        "Write-only notification registers (e.g., virtio queue notify) "
+        "signalled through an eventfd instead of a VM exit")
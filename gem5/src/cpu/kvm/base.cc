@@ -304,6 +304,16 @@ BaseKvmCPU::regStats()
         .desc("number of coalesced memory mapped IO requests")
         ;
 
+    numCoalescedPIO
+        .name(name() + ".numCoalescedPIO")
+        .desc("number of coalesced IO port requests")
+        ;
+
+    numIOEvents
+        .name(name() + ".numIOEvents")
+        .desc("number of notification writes signalled through ioeventfd")
+        ;
+
     numIO
         .name(name() + ".numIO")
         .desc("number of VM exits due to legacy IO")
@@ -820,7 +830,7 @@ BaseKvmCPU::kvmRun(Tick ticks)
 
     ++numVMExits;
 
-    return ticksExecuted + flushCoalescedMMIO();
+    return ticksExecuted + flushCoalescedMMIO() + flushIOEvents();
 }
 
 void
@@ -1199,6 +1209,18 @@ BaseKvmCPU::flushCoalescedMMIO()
         struct kvm_coalesced_mmio &ent(
             mmioRing->coalesced_mmio[mmioRing->first]);
 
+#ifdef KVM_CAP_COALESCED_PIO
+        if (ent.pio) {
+            DPRINTF(KvmIO, "KVM: Handling coalesced PIO (port: 0x%x, "
+                    "len: %u)\n", ent.phys_addr, ent.len);
+
+            ++numCoalescedPIO;
+            ticks += doPIOWrite(ent.phys_addr, ent.data, ent.len);
+            mmioRing->first = (mmioRing->first + 1) % KVM_COALESCED_MMIO_MAX;
+            continue;
+        }
+#endif
+
         DPRINTF(KvmIO, "KVM: Handling coalesced MMIO (addr: 0x%x, len: %u)\n",
                 ent.phys_addr, ent.len);
 
@@ -1211,6 +1233,39 @@ BaseKvmCPU::flushCoalescedMMIO()
     return ticks;
 }
 
+Tick
+BaseKvmCPU::flushIOEvents()
+{
+    Tick ticks(0);
+    for (auto &ev : vm.ioEvents) {
+        // The eventfds are non-blocking, reading one that hasn't been
+        // signalled fails with EAGAIN. Reading resets the counter, so
+        // only one vCPU replays a given notification.
+        uint64_t count;
+        if (read(ev.fd, &count, sizeof(count)) != sizeof(count))
+            continue;
+
+        DPRINTF(KvmIO, "KVM: Handling ioeventfd (%s: 0x%x, data: 0x%x, "
+                "count: %u)\n", ev.pio ? "port" : "addr", ev.addr, ev.data,
+                count);
+
+        ++numIOEvents;
+        uint64_t data(ev.data);
+        if (ev.pio)
+            ticks += doPIOWrite(ev.addr, &data, ev.size);
+        else
+            ticks += doMMIOAccess(ev.addr, &data, ev.size, true);
+    }
+
+    return ticks;
+}
+
+Tick
+BaseKvmCPU::doPIOWrite(uint16_t port, void *data, int size)
+{
+    panic("KVM: IO port writes are not supported on this architecture\n");
+}
+
 /**
  * Dummy handler for KVM kick signals.
  *
@@ -533,6 +533,20 @@ class BaseKvmCPU : public BaseCPU
      */
     Tick doMMIOAccess(Addr paddr, void *data, int size, bool write);
 
+    /**
+     * Inject an IO port write that was coalesced or signalled through
+     * an ioeventfd instead of causing a KVM_EXIT_IO exit.
+     *
+     * The default implementation panics since only some
+     * architectures have an IO port address space.
+     *
+     * @param port IO port
+     * @param data Pointer to the source buffer
+     * @param size Access size
+     * @return Number of ticks spent servicing the access
+     */
+    virtual Tick doPIOWrite(uint16_t port, void *data, int size);
+
     /** @{ */
     /**
      * Set the signal mask used in kvmRun()
@@ -649,6 +663,14 @@ class BaseKvmCPU : public BaseCPU
      */
     Tick flushCoalescedMMIO();
 
+    /**
+     * Replay guest writes to the notification registers the VM
+     * watches through ioeventfds (see KvmVM::registerIOEventFD()).
+     *
+     * @return Number of ticks spent servicing the writes
+     */
+    Tick flushIOEvents();
+
     /**
      * Setup a signal handler to catch the timer signal used to
      * switch back to the monitor.
@@ -789,6 +811,8 @@ class BaseKvmCPU : public BaseCPU
     Stats::Scalar numExitSignal;
     Stats::Scalar numMMIO;
     Stats::Scalar numCoalescedMMIO;
+    Stats::Scalar numCoalescedPIO;
+    Stats::Scalar numIOEvents;
     Stats::Scalar numIO;
     Stats::Scalar numHalt;
     Stats::Scalar numInterrupts;
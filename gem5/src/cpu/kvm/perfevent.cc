@@ -163,11 +163,7 @@ PerfKvmCounter::attach(PerfKvmCounterConfig &config,
 {
     assert(!attached());
 
-    fd = syscall(__NR_perf_event_open,
-                 &config.attr, tid,
-                 -1, // CPU (-1 => Any CPU that the task happens to run on)
-                 group_fd,
-                 0); // Flags
+    fd = perfEventOpen(config, tid, group_fd);
     if (fd == -1)
     {
         if (errno == EACCES)
@@ -185,6 +181,30 @@ PerfKvmCounter::attach(PerfKvmCounterConfig &config,
     mmapPerf(1);
 }
 
+bool
+PerfKvmCounter::tryAttach(PerfKvmCounterConfig &config, pid_t tid)
+{
+    assert(!attached());
+
+    fd = perfEventOpen(config, tid, -1);
+    if (fd == -1)
+        return false;
+
+    mmapPerf(1);
+    return true;
+}
+
+int
+PerfKvmCounter::perfEventOpen(PerfKvmCounterConfig &config, pid_t tid,
+                              int group_fd)
+{
+    return syscall(__NR_perf_event_open,
+                   &config.attr, tid,
+                   -1, // CPU (-1 => Any CPU that the task happens to run on)
+                   group_fd,
+                   0); // Flags
+}
+
 pid_t
 PerfKvmCounter::sysGettid()
 {
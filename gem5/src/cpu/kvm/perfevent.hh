@@ -223,6 +223,16 @@ public:
         attach(config, tid, parent.fd);
     }
 
+    /**
+     * Attach a counter, unless PerfEvent doesn't allow it (e.g., due
+     * to the perf_event_paranoid setting).
+     *
+     * @param config Counter configuration
+     * @param tid Thread to sample (0 indicates current thread)
+     * @return true if the counter was attached
+     */
+    bool tryAttach(PerfKvmCounterConfig &config, pid_t tid);
+
     /** Detach a counter from PerfEvent. */
     void detach();
 
@@ -307,6 +317,9 @@ private:
 
     void attach(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
 
+    /** Call perf_event_open and return the file descriptor */
+    int perfEventOpen(PerfKvmCounterConfig &config, pid_t tid, int group_fd);
+
     /**
      * Get the TID of the current thread.
      *
@@ -42,6 +42,7 @@
 
 #include <fcntl.h>
 #include <linux/kvm.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -52,6 +53,7 @@
 
 #include "cpu/kvm/base.hh"
 #include "debug/Kvm.hh"
+#include "params/KvmIOEventFD.hh"
 #include "params/KvmVM.hh"
 #include "sim/system.hh"
 
@@ -127,6 +129,26 @@ Kvm::capCoalescedMMIO() const
     return checkExtension(KVM_CAP_COALESCED_MMIO);
 }
 
+bool
+Kvm::capCoalescedPIO() const
+{
+#ifdef KVM_CAP_COALESCED_PIO
+    return checkExtension(KVM_CAP_COALESCED_PIO) != 0;
+#else
+    return false;
+#endif
+}
+
+bool
+Kvm::capIOEventFD() const
+{
+#ifdef KVM_CAP_IOEVENTFD
+    return checkExtension(KVM_CAP_IOEVENTFD) != 0;
+#else
+    return false;
+#endif
+}
+
 int
 Kvm::capNumMemSlots() const
 {
@@ -305,10 +327,28 @@ KvmVM::KvmVM(KvmVMParams *params)
     /* Setup the coalesced MMIO regions */
     for (int i = 0; i < params->coalescedMMIO.size(); ++i)
         coalesceMMIO(params->coalescedMMIO[i]);
+
+    if (!params->coalescedPIO.empty() && !kvm->capCoalescedPIO()) {
+        warn("KVM: Coalesced PIO not supported by host OS\n");
+    } else {
+        for (const auto &range : params->coalescedPIO)
+            coalescePIO(range);
+    }
+
+    if (!params->ioEventFDs.empty() && !kvm->capIOEventFD()) {
+        warn("KVM: ioeventfd not supported by host OS, notification "
+             "registers will cause VM exits\n");
+    } else {
+        for (const auto *ev : params->ioEventFDs)
+            registerIOEventFD(ev->addr, ev->size, ev->data, ev->pio);
+    }
 }
 
 KvmVM::~KvmVM()
 {
+    for (const auto &ev : ioEvents)
+        close(ev.fd);
+
     if (vmFD != -1)
         close(vmFD);
 
@@ -325,6 +365,10 @@ KvmVM::notifyFork()
 
         vmFD = -1;
 
+        for (const auto &ev : ioEvents)
+            close(ev.fd);
+        ioEvents.clear();
+
         delete kvm;
         kvm = NULL;
     }
@@ -476,6 +520,58 @@ KvmVM::coalesceMMIO(Addr start, int size)
               errno);
 }
 
+void
+KvmVM::coalescePIO(const AddrRange &range)
+{
+#ifdef KVM_CAP_COALESCED_PIO
+    struct kvm_coalesced_mmio_zone zone;
+
+    zone.addr = range.start();
+    zone.size = range.size();
+    zone.pio = 1;
+
+    DPRINTF(Kvm, "KVM: Registering coalesced PIO ports [0x%x, 0x%x]\n",
+            zone.addr, zone.addr + zone.size - 1);
+    if (ioctl(KVM_REGISTER_COALESCED_MMIO, (void *)&zone) == -1)
+        panic("KVM: Failed to register coalesced PIO region (%i)\n",
+              errno);
+#else
+    panic("KVM: Coalesced PIO not supported by the KVM headers\n");
+#endif
+}
+
+void
+KvmVM::registerIOEventFD(Addr addr, unsigned size, uint64_t data, bool pio)
+{
+    fatal_if(size != 1 && size != 2 && size != 4 && size != 8,
+             "KVM: Illegal ioeventfd size (%u)\n", size);
+
+    IOEvent ev;
+    ev.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (ev.fd == -1)
+        panic("KVM: Failed to create eventfd (%i)\n", errno);
+    ev.addr = addr;
+    ev.size = size;
+    ev.data = data;
+    ev.pio = pio;
+
+    struct kvm_ioeventfd kev;
+    memset(&kev, 0, sizeof(kev));
+    kev.datamatch = data;
+    kev.addr = addr;
+    kev.len = size;
+    kev.fd = ev.fd;
+    kev.flags = KVM_IOEVENTFD_FLAG_DATAMATCH |
+        (pio ? KVM_IOEVENTFD_FLAG_PIO : 0);
+
+    DPRINTF(Kvm, "KVM: Registering ioeventfd (%s: 0x%x, size: %u, "
+            "data: 0x%x)\n", pio ? "port" : "addr", addr, size, data);
+    if (ioctl(KVM_IOEVENTFD, (void *)&kev) == -1)
+        panic("KVM: Failed to register ioeventfd (%i)\n", errno);
+
+    ioEvents.push_back(ev);
+}
+
 void
 KvmVM::setTSSAddress(Addr tss_address)
 {
@@ -593,3 +689,16 @@ KvmVMParams::create()
 
     return new KvmVM(this);
 }
+
+
+KvmIOEventFD::KvmIOEventFD(const KvmIOEventFDParams *p)
+    : SimObject(p), addr(p->addr), size(p->size), data(p->data),
+      pio(p->pio)
+{
+}
+
+KvmIOEventFD *
+KvmIOEventFDParams::create()
+{
+    return new KvmIOEventFD(this);
+}
@@ -47,6 +47,7 @@
 #include "sim/sim_object.hh"
 
 // forward declarations
+struct KvmIOEventFDParams;
 struct KvmVMParams;
 class BaseKvmCPU;
 class System;
@@ -108,6 +109,12 @@ class Kvm
      */
     int capCoalescedMMIO() const;
 
+    /** Support for KvmVM::coalescePIO() */
+    bool capCoalescedPIO() const;
+
+    /** Support for KvmVM::registerIOEventFD() */
+    bool capIOEventFD() const;
+
     /**
      * Attempt to determine how many memory slots are available. If it can't
      * be determined, this function returns 0.
@@ -323,6 +330,39 @@ class KvmVM : public SimObject
     void coalesceMMIO(const AddrRange &range);
     /** @} */
 
+    /**
+     * Request coalescing of IO port writes for a port range.
+     *
+     * Writes to coalesced ports are queued in the same ring buffer as
+     * coalesced MMIO writes and delivered to gem5 the next time the
+     * vCPU exits. Only use this for ports where reads have no side
+     * effects that depend on prior writes.
+     *
+     * @note This functionality depends on Kvm::capCoalescedPIO().
+     *
+     * @param range Range of IO ports to coalesce
+     */
+    void coalescePIO(const AddrRange &range);
+
+    /**
+     * Register an eventfd that the kernel signals when the guest
+     * writes a specific value to an address or IO port. Such writes
+     * complete without a VM exit and are replayed to gem5 by the
+     * vCPUs the next time they exit (see
+     * BaseKvmCPU::flushIOEvents()). Writes of the same value that
+     * happen before gem5 notices are merged, which is fine for
+     * doorbells like the virtio queue notify register.
+     *
+     * @note This functionality depends on Kvm::capIOEventFD().
+     *
+     * @param addr Guest physical address or IO port
+     * @param size Size of the write (1, 2, 4 or 8 bytes)
+     * @param data Value to match
+     * @param pio True if addr is an IO port
+     */
+    void registerIOEventFD(Addr addr, unsigned size, uint64_t data,
+                           bool pio);
+
     /**
      * @addtogroup KvmInterrupts
      * @{
@@ -528,6 +568,18 @@ class KvmVM : public SimObject
     /** KVM VM file descriptor */
     int vmFD;
 
+    /** Guest write signalled through an eventfd */
+    struct IOEvent
+    {
+        /** Non-blocking eventfd signalled by the kernel */
+        int fd;
+        Addr addr;
+        unsigned size;
+        uint64_t data;
+        bool pio;
+    };
+    std::vector<IOEvent> ioEvents;
+
     /** Has delayedStartup() already been called? */
     bool started;
 
@@ -551,4 +603,18 @@ class KvmVM : public SimObject
     uint32_t maxMemorySlot;
 };
 
+/**
+ * Description of a KVM ioeventfd, see KvmVM::registerIOEventFD().
+ */
+class KvmIOEventFD : public SimObject
+{
+  public:
+    KvmIOEventFD(const KvmIOEventFDParams *p);
+
+    const Addr addr;
+    const unsigned size;
+    const uint64_t data;
+    const bool pio;
+};
+
 #endif
@@ -1364,6 +1364,31 @@ X86KvmCPU::handleKvmExitIO()
     return delay;
 }
 
+Tick
+X86KvmCPU::doPIOWrite(uint16_t port, void *data, int size)
+{
+    // PCI configuration accesses depend on the address register, so
+    // they can't be delayed.
+    panic_if(port == IO_PCI_CONF_ADDR ||
+             (port & ~0x3) == IO_PCI_CONF_DATA_BASE,
+             "KVM-x86: PCI configuration port 0x%x must not be coalesced\n",
+             port);
+
+    RequestPtr io_req = std::make_shared<Request>(
+        X86ISA::x86IOAddress(port), size,
+        Request::UNCACHEABLE, dataMasterId());
+
+    io_req->setContext(tc->contextId());
+
+    PacketPtr pkt = new Packet(io_req, MemCmd::WriteReq);
+    pkt->dataStatic(data);
+
+    // Temporarily lock and migrate to the device event queue to
+    // prevent races in multi-core mode.
+    EventQueue::ScopedMigration migrate(deviceEventQueue());
+    return dataPort.submitIO(pkt);
+}
+
 Tick
 X86KvmCPU::handleKvmExitIRQWindowOpen()
 {
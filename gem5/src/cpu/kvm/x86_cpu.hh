@@ -144,6 +144,7 @@ class X86KvmCPU : public BaseKvmCPU
      * Handle x86 legacy IO (in/out)
      */
     Tick handleKvmExitIO() override;
+    Tick doPIOWrite(uint16_t port, void *data, int size) override;
 
     Tick handleKvmExitIRQWindowOpen() override;
 
@@ -77,6 +77,8 @@ operator <<(std::ostream &os, const InstId &id)
 
 MinorDynInstPtr MinorDynInst::bubbleInst = NULL;
 
+__thread void *MinorDynInst::freeList = nullptr;
+
 void
 MinorDynInst::init()
 {
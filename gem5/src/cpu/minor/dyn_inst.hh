@@ -48,6 +48,8 @@
 #ifndef __CPU_MINOR_DYN_INST_HH__
 #define __CPU_MINOR_DYN_INST_HH__
 
+#include <cassert>
+#include <cstddef>
 #include <iostream>
 
 #include "base/refcnt.hh"
@@ -153,7 +155,10 @@ std::ostream &operator <<(std::ostream &os, const MinorDynInst &inst);
 /** Dynamic instruction for Minor.
  *  MinorDynInst implements the BubbleIF interface
  *  Has two separate notions of sequence number for pre/post-micro-op
- *  decomposition: fetchSeqNum and execSeqNum */
+ *  decomposition: fetchSeqNum and execSeqNum
+ *  The storage of retired instructions is kept on a per-thread free list
+ *  rather than being returned to the heap as one instruction is created
+ *  for every fetched (micro-)op */
 class MinorDynInst : public RefCounted
 {
   private:
@@ -161,6 +166,9 @@ class MinorDynInst : public RefCounted
      *  to initialise this */
     static MinorDynInstPtr bubbleInst;
 
+    /** Retired instructions owned by the current thread */
+    static __thread void *freeList;
+
   public:
     StaticInstPtr staticInst;
 
@@ -285,6 +293,25 @@ class MinorDynInst : public RefCounted
     void setMemAccPredicate(bool val) { memAccPredicate = val; }
 
     ~MinorDynInst();
+
+    static void *
+    operator new(std::size_t size)
+    {
+        assert(size == sizeof(MinorDynInst));
+        if (!freeList)
+            return ::operator new(size);
+
+        void *p = freeList;
+        freeList = *static_cast<void **>(p);
+        return p;
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        *static_cast<void **>(p) = freeList;
+        freeList = p;
+    }
 };
 
 /** Print a summary of the instruction */
@@ -48,9 +48,8 @@ from m5.objects.BaseCPU import BaseCPU
 from m5.objects.FUPool import *
 from m5.objects.O3Checker import O3Checker
 from m5.objects.BranchPredictor import *
-
-class FetchPolicy(ScopedEnum):
-    vals = [ 'SingleThread', 'RoundRobin', 'Branch', 'IQCount', 'LSQCount' ]
+from m5.objects.ValuePredictor import *
+from m5.objects.SMTFetchPolicy import *
 
 class SMTQueuePolicy(ScopedEnum):
     vals = [ 'Dynamic', 'Partitioned', 'Threshold' ]
@@ -58,6 +57,9 @@ class SMTQueuePolicy(ScopedEnum):
 class CommitPolicy(ScopedEnum):
     vals = [ 'Aggressive', 'RoundRobin', 'OldestReady' ]
 
+class IQWakeupModel(ScopedEnum):
+    vals = [ 'List', 'Matrix' ]
+
 class DerivO3CPU(BaseCPU):
     type = 'DerivO3CPU'
     cxx_header = 'cpu/o3/deriv.hh'
@@ -75,6 +77,9 @@ class DerivO3CPU(BaseCPU):
         return True
 
     activity = Param.Unsigned(0, "Initial count")
+    stallSkipping = Param.Bool(False, "Stop ticking while the pipeline is "
+        "stalled with nothing in flight between the stages, and resume on "
+        "the next event that can change its state")
 
     cacheStorePorts = Param.Unsigned(200, "Cache Ports. "
           "Constrains stores only.")
@@ -103,6 +108,9 @@ class DerivO3CPU(BaseCPU):
     commitToRenameDelay = Param.Cycles(1, "Commit to rename delay")
     decodeToRenameDelay = Param.Cycles(1, "Decode to rename delay")
     renameWidth = Param.Unsigned(8, "Rename width")
+    renameCheckpoints = Param.Unsigned(0, "Number of rename map checkpoints "
+        "taken at branches to undo squashes without walking the rename "
+        "history, 0 disables them (single thread only)")
 
     commitToIEWDelay = Param.Cycles(1, "Commit to "
                "Issue/Execute/Writeback delay")
@@ -158,10 +166,14 @@ class DerivO3CPU(BaseCPU):
     numPhysCCRegs = Param.Unsigned(_defaultNumPhysCCRegs,
                                    "Number of physical cc registers")
     numIQEntries = Param.Unsigned(64, "Number of instruction queue entries")
+    iqWakeupModel = Param.IQWakeupModel('List', "How the IQ tracks the "
+        "dependents of each physical register: linked lists or a wakeup "
+        "matrix")
     numROBEntries = Param.Unsigned(192, "Number of reorder buffer entries")
 
     smtNumFetchingThreads = Param.Unsigned(1, "SMT Number of Fetching Threads")
-    smtFetchPolicy = Param.FetchPolicy('SingleThread', "SMT Fetch policy")
+    smtFetchPolicy = Param.SMTFetchPolicy(RoundRobinFetchPolicy(),
+                                          "SMT Fetch policy")
     smtLSQPolicy    = Param.SMTQueuePolicy('Partitioned',
                                            "SMT LSQ Sharing Policy")
     smtLSQThreshold = Param.Int(100, "SMT LSQ Threshold Sharing Parameter")
@@ -176,9 +188,15 @@ class DerivO3CPU(BaseCPU):
     branchPred = Param.BranchPredictor(TournamentBP(numThreads =
                                                        Parent.numThreads),
                                        "Branch Predictor")
+    valuePred = Param.ValuePredictor(NULL, "Value predictor, the values "
+        "of the instructions are not predicted if it is not set")
     needsTSO = Param.Bool(buildEnv['TARGET_ISA'] == 'x86',
                           "Enable TSO Memory model")
 
+    pipeTraceFile = Param.String("", "File to write a binary pipeline "
+        "trace of all the instructions to, see util/o3-pipeview.py "
+        "(empty to disable)")
+
     def addCheckerCpu(self):
         if buildEnv['TARGET_ISA'] in ['arm']:
             from m5.objects.ArmTLB import ArmTLB
@@ -0,0 +1,67 @@
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+from m5.SimObject import SimObject
+from m5.params import *
+
+class SMTFetchPolicy(SimObject):
+    type = 'SMTFetchPolicy'
+    abstract = True
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+    stallThreshold = Param.Unsigned(0, "Stop fetching from a thread while "
+        "it has this many loads waiting for the data cache (0 to disable)")
+
+class RoundRobinFetchPolicy(SMTFetchPolicy):
+    type = 'RoundRobinFetchPolicy'
+    cxx_class = 'RoundRobinFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+class ICountFetchPolicy(SMTFetchPolicy):
+    type = 'ICountFetchPolicy'
+    cxx_class = 'ICountFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+class IQCountFetchPolicy(SMTFetchPolicy):
+    type = 'IQCountFetchPolicy'
+    cxx_class = 'IQCountFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+class LSQCountFetchPolicy(SMTFetchPolicy):
+    type = 'LSQCountFetchPolicy'
+    cxx_class = 'LSQCountFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+class BrCountFetchPolicy(SMTFetchPolicy):
+    type = 'BrCountFetchPolicy'
+    cxx_class = 'BrCountFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
+
+class MissCountFetchPolicy(SMTFetchPolicy):
+    type = 'MissCountFetchPolicy'
+    cxx_class = 'MissCountFetchPolicy'
+    cxx_header = "cpu/o3/smt_fetch_policy.hh"
@@ -148,6 +148,7 @@ struct TimeBufStruct {
 
         unsigned iqCount;
         unsigned ldstqCount;
+        unsigned missCount;
 
         unsigned dispatched;
         bool usedIQ;
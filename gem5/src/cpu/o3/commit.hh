@@ -211,6 +211,11 @@ class DefaultCommit
     /** Ticks the commit stage, which tries to commit instructions. */
     void tick();
 
+    /** Records the stats of cycles the CPU skipped while the pipeline
+     *  was stalled, as tick() would have done for each of them.
+     */
+    void creditStalledCycles(Cycles cycles);
+
     /** Handles any squashes that are sent from IEW, and adds instructions
      * to the ROB and tries to commit instructions.
      */
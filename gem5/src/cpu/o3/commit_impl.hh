@@ -64,7 +64,6 @@
 #include "debug/CommitRate.hh"
 #include "debug/Drain.hh"
 #include "debug/ExecFaulting.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/faults.hh"
 #include "sim/full_system.hh"
@@ -529,14 +528,11 @@ DefaultCommit<Impl>::generateTrapEvent(ThreadID tid, Fault inst_fault)
 {
     DPRINTF(Commit, "Generating trap event for [tid:%i]\n", tid);
 
-    EventFunctionWrapper *trap = new EventFunctionWrapper(
-        [this, tid]{ processTrapEvent(tid); },
-        "Trap", true, Event::CPU_Tick_Pri);
-
     Cycles latency = dynamic_pointer_cast<SyscallRetryFault>(inst_fault) ?
                      cpu->syscallRetryLatency : trapLatency;
 
-    cpu->schedule(trap, cpu->clockEdge(latency));
+    cpu->scheduleOneShot([this, tid]{ processTrapEvent(tid); },
+                         cpu->clockEdge(latency), Event::CPU_Tick_Pri);
     trapInFlight[tid] = true;
     thread[tid]->trapPending = true;
 }
@@ -652,6 +648,13 @@ DefaultCommit<Impl>::squashAfter(ThreadID tid, const DynInstPtr &head_inst)
     squashAfterInst[tid] = head_inst;
 }
 
+template <class Impl>
+void
+DefaultCommit<Impl>::creditStalledCycles(Cycles cycles)
+{
+    numCommittedDist.sample(0, cycles);
+}
+
 template <class Impl>
 void
 DefaultCommit<Impl>::tick()
@@ -1048,6 +1051,18 @@ DefaultCommit<Impl>::commitInsts()
                 statCommittedInstType[tid][head_inst->opClass()]++;
                 ppCommit->notify(head_inst);
 
+                if (cpu->valuePred) {
+                    if (head_inst->valuePredLookup()) {
+                        cpu->valuePred->update(tid, head_inst->seqNum,
+                            cpu->readIntReg(head_inst->renamedDestRegIdx(0)));
+                    }
+                    if (head_inst->isControl()) {
+                        cpu->valuePred->branchCommitted(tid,
+                            head_inst->instAddr(),
+                            head_inst->pcState().branching());
+                    }
+                }
+
                 changedROBNumEntries[tid] = true;
 
                 // Set the doneSeqNum to the youngest committed instruction.
@@ -1321,11 +1336,9 @@ DefaultCommit<Impl>::commitHead(const DynInstPtr &head_inst, unsigned inst_num)
     // Finally clear the head ROB entry.
     rob->retireHead(tid);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeline()) {
         head_inst->commitTick = curTick() - head_inst->fetchTick;
     }
-#endif
 
     // If this was a store, record it for this cycle.
     if (head_inst->isStore() || head_inst->isAtomic())
@@ -48,6 +48,7 @@
 
 #include "arch/generic/traits.hh"
 #include "arch/kernel_stats.hh"
+#include "base/output.hh"
 #include "config/the_isa.hh"
 #include "cpu/activity.hh"
 #include "cpu/checker/cpu.hh"
@@ -139,7 +140,11 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
 
       globalSeqNum(1),
       system(params->system),
-      lastRunningCycle(curCycle())
+      lastRunningCycle(curCycle()),
+      stallSkipping(params->stallSkipping),
+      stallSkipped(false),
+      pipeTrace(nullptr),
+      valuePred(params->valuePred)
 {
     if (!params->switched_out) {
         _status = Running;
@@ -161,6 +166,12 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
         tids.resize(numThreads);
     }
 
+    if (!params->pipeTraceFile.empty()) {
+        pipeTrace = new O3PipeTrace(
+            simout.resolve(name() + "." + params->pipeTraceFile),
+            name(), clockPeriod());
+    }
+
     // The stages also need their CPU pointer setup.  However this
     // must be done at the upper level CPU because they have pointers
     // to the upper level CPU, and not this FullO3CPU.
@@ -191,6 +202,14 @@ FullO3CPU<Impl>::FullO3CPU(DerivO3CPUParams *params)
     commit.setIEWQueue(&iewQueue);
     commit.setRenameQueue(&renameQueue);
 
+    // The stages only read from the past of the buffers, so idle
+    // cycles don't need to reset the entries that nobody wrote.
+    timeBuffer.setDirtyTracking(true);
+    fetchQueue.setDirtyTracking(true);
+    decodeQueue.setDirtyTracking(true);
+    renameQueue.setDirtyTracking(true);
+    iewQueue.setDirtyTracking(true);
+
     commit.setIEWStage(&iew);
     rename.setIEWStage(&iew);
     rename.setCommitStage(&commit);
@@ -418,6 +437,18 @@ FullO3CPU<Impl>::regStats()
               "for an interrupt")
         .prereq(quiesceCycles);
 
+    stallSkips
+        .name(name() + ".stallSkips")
+        .desc("Number of times that the CPU unscheduled itself while the "
+              "pipeline was stalled")
+        .prereq(stallSkips);
+
+    stallSkippedCycles
+        .name(name() + ".stallSkippedCycles")
+        .desc("Total number of stalled cycles that the CPU skipped, also "
+              "counted in numCycles and the stage stall stats")
+        .prereq(stallSkippedCycles);
+
     // Number of Instructions simulated
     // --------------------------------
     // Should probably be in Base CPU but need templated
@@ -534,6 +565,13 @@ FullO3CPU<Impl>::tick()
     assert(!switchedOut());
     assert(drainState() != DrainState::Drained);
 
+    if (stallSkipped) {
+        stallSkipped = false;
+        Cycles cycles(curCycle() - lastRunningCycle);
+        if (cycles > 1)
+            creditStalledCycles(Cycles(cycles - 1));
+    }
+
     ++numCycles;
     updateCycleCounters(BaseCPU::CPU_STATE_ON);
 
@@ -573,6 +611,11 @@ FullO3CPU<Impl>::tick()
             DPRINTF(O3CPU, "Idle!\n");
             lastRunningCycle = curCycle();
             timesIdled++;
+        } else if (stallSkipping && pipelineStalled()) {
+            DPRINTF(O3CPU, "Pipeline stalled, waiting for an event!\n");
+            lastRunningCycle = curCycle();
+            stallSkipped = true;
+            stallSkips++;
         } else {
             schedule(tickEvent, clockEdge(Cycles(1)));
             DPRINTF(O3CPU, "Scheduling next tick!\n");
@@ -663,7 +706,6 @@ FullO3CPU<Impl>::deactivateThread(ThreadID tid)
         activeThreads.erase(thread_it);
     }
 
-    fetch.deactivateThread(tid);
     commit.deactivateThread(tid);
 }
 
@@ -1039,6 +1081,8 @@ FullO3CPU<Impl>::drainSanityCheck() const
     rename.drainSanityCheck();
     iew.drainSanityCheck();
     commit.drainSanityCheck();
+    if (valuePred)
+        valuePred->drainSanityCheck();
 }
 
 template <class Impl>
@@ -1698,11 +1742,18 @@ template <class Impl>
 void
 FullO3CPU<Impl>::wakeCPU()
 {
-    if (activityRec.active() || tickEvent.scheduled()) {
+    if (tickEvent.scheduled() || (activityRec.active() && !stallSkipped)) {
         DPRINTF(Activity, "CPU already running.\n");
         return;
     }
 
+    if (stallSkipped) {
+        // The stalled cycles are credited when the CPU ticks again
+        DPRINTF(Activity, "Waking up stalled CPU\n");
+        schedule(tickEvent, clockEdge());
+        return;
+    }
+
     DPRINTF(Activity, "Waking up CPU\n");
 
     Cycles cycles(curCycle() - lastRunningCycle);
@@ -1716,12 +1767,46 @@ FullO3CPU<Impl>::wakeCPU()
     schedule(tickEvent, clockEdge());
 }
 
+template <class Impl>
+bool
+FullO3CPU<Impl>::pipelineStalled()
+{
+    // Fetch and decode may still be marked active while they wait on
+    // the stages after them, but nothing can change until an event
+    // unblocks the back end of the pipeline if no stage has sent
+    // anything within the activity window.
+    return !activityRec.communicating() && !isDraining() &&
+        !activityRec.getStageActive(RenameIdx) &&
+        !activityRec.getStageActive(IEWIdx) &&
+        !activityRec.getStageActive(CommitIdx);
+}
+
+template <class Impl>
+void
+FullO3CPU<Impl>::creditStalledCycles(Cycles cycles)
+{
+    DPRINTF(O3CPU, "Crediting %d stalled cycles\n", cycles);
+
+    numCycles += cycles;
+    stallSkippedCycles += cycles;
+
+    fetch.creditStalledCycles(cycles);
+    decode.creditStalledCycles(cycles);
+    rename.creditStalledCycles(cycles);
+    iew.creditStalledCycles(cycles);
+    commit.creditStalledCycles(cycles);
+}
+
 template <class Impl>
 void
 FullO3CPU<Impl>::wakeup(ThreadID tid)
 {
-    if (this->thread[tid]->status() != ThreadContext::Suspended)
+    if (this->thread[tid]->status() != ThreadContext::Suspended) {
+        // An interrupt may need the attention of a stalled pipeline
+        if (stallSkipped)
+            this->wakeCPU();
         return;
+    }
 
     this->wakeCPU();
 
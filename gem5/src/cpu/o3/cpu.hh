@@ -59,12 +59,15 @@
 #include "config/the_isa.hh"
 #include "cpu/o3/comm.hh"
 #include "cpu/o3/cpu_policy.hh"
+#include "cpu/o3/pipe_trace.hh"
 #include "cpu/o3/scoreboard.hh"
 #include "cpu/o3/thread_state.hh"
+#include "cpu/pred/vpred_unit.hh"
 #include "cpu/activity.hh"
 #include "cpu/base.hh"
 #include "cpu/simple_thread.hh"
 #include "cpu/timebuf.hh"
+#include "debug/O3PipeView.hh"
 //#include "cpu/o3/thread_context.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/process.hh"
@@ -111,7 +114,7 @@ class FullO3CPU : public BaseO3CPU
     typedef O3ThreadState<Impl> ImplState;
     typedef O3ThreadState<Impl> Thread;
 
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::DynInstList::iterator ListIt;
 
     friend class O3ThreadContext<Impl>;
 
@@ -536,7 +539,7 @@ class FullO3CPU : public BaseO3CPU
 #endif
 
     /** List of all the instructions in flight. */
-    std::list<DynInstPtr> instList;
+    typename Impl::DynInstList instList;
 
     /** List of all the instructions that will be removed at the end of this
      *  cycle.
@@ -667,6 +670,18 @@ class FullO3CPU : public BaseO3CPU
     /** Wakes the CPU, rescheduling the CPU if it's not already active. */
     void wakeCPU();
 
+    /**
+     * Checks if the pipeline is stalled in a state that only an event
+     * can change: nothing has been communicated between the stages for
+     * as long as the longest time buffer, and the only stages still
+     * marked active are the ones that don't make progress on their
+     * own.
+     */
+    bool pipelineStalled();
+
+    /** Credits the cycles skipped while the pipeline was stalled. */
+    void creditStalledCycles(Cycles cycles);
+
     virtual void wakeup(ThreadID tid) override;
 
     /** Gets a free thread id. Use if thread ids change across system. */
@@ -701,9 +716,46 @@ class FullO3CPU : public BaseO3CPU
     /** The cycle that the CPU was last running, used for statistics. */
     Cycles lastRunningCycle;
 
+    /** Whether to stop ticking while the pipeline is stalled. */
+    const bool stallSkipping;
+
+    /** Whether the CPU stopped ticking because of a stall. */
+    bool stallSkipped;
+
     /** The cycle that the CPU was last activated by a new thread*/
     Tick lastActivatedCycle;
 
+    /** Occupancy counters of a thread used by the SMT fetch policy. */
+    struct SMTCounts
+    {
+        /** Instructions fetched but not issued or squashed yet. */
+        unsigned icount = 0;
+        /** Branches fetched but not executed or squashed yet. */
+        unsigned branchCount = 0;
+    };
+
+    /**
+     * Per-thread counters, maintained by the instructions as they go
+     * through the pipeline rather than recomputed every cycle.
+     */
+    SMTCounts smtCounts[Impl::MaxThreads];
+
+    /** Binary pipeline trace, nullptr if it is disabled. */
+    O3PipeTrace *pipeTrace;
+
+    /** Value predictor, nullptr if value prediction is disabled. */
+    VPredUnit *valuePred;
+
+    /**
+     * Whether the instructions have to record when they go through
+     * each stage, for the O3PipeView output or the pipeline trace.
+     */
+    bool
+    tracePipeline() const
+    {
+        return DTRACE(O3PipeView) || pipeTrace;
+    }
+
     /** Mapping for system thread id to cpu id */
     std::map<ThreadID, unsigned> threadMap;
 
@@ -755,6 +807,10 @@ class FullO3CPU : public BaseO3CPU
     /** Stat for total number of cycles the CPU spends descheduled due to a
      * quiesce operation or waiting for an interrupt. */
     Stats::Scalar quiesceCycles;
+    /** Stat for the number of times the CPU skipped stalled cycles. */
+    Stats::Scalar stallSkips;
+    /** Stat for the number of stalled cycles that were skipped. */
+    Stats::Scalar stallSkippedCycles;
     /** Stat for the number of committed instructions per thread. */
     Stats::Vector committedInsts;
     /** Stat for the number of committed ops (including micro ops) per thread. */
@@ -140,6 +140,11 @@ class DefaultDecode
      */
     void tick();
 
+    /** Records the stats of cycles the CPU skipped while the pipeline
+     *  was stalled, as tick() would have done for each of them.
+     */
+    void creditStalledCycles(Cycles cycles);
+
     /** Determines what to do based on decode's current status.
      * @param status_change decode() sets this variable if there was a status
      * change (ie switching from from blocking to unblocking).
@@ -50,7 +50,6 @@
 #include "cpu/inst_seq.hh"
 #include "debug/Activity.hh"
 #include "debug/Decode.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/full_system.hh"
 
@@ -561,6 +560,22 @@ DefaultDecode<Impl>::checkSignalsAndUpdate(ThreadID tid)
     return false;
 }
 
+template<class Impl>
+void
+DefaultDecode<Impl>::creditStalledCycles(Cycles cycles)
+{
+    for (ThreadID tid : *activeThreads) {
+        if (decodeStatus[tid] == Blocked) {
+            decodeBlockedCycles += cycles;
+        } else if (decodeStatus[tid] == Squashing) {
+            decodeSquashCycles += cycles;
+        } else if (decodeStatus[tid] == Running ||
+                   decodeStatus[tid] == Idle) {
+            decodeIdleCycles += cycles;
+        }
+    }
+}
+
 template<class Impl>
 void
 DefaultDecode<Impl>::tick()
@@ -711,11 +726,9 @@ DefaultDecode<Impl>::decodeInsts(ThreadID tid)
         ++decodeDecodedInsts;
         --insts_available;
 
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
+        if (cpu->tracePipeline()) {
             inst->decodeTick = curTick() - inst->fetchTick;
         }
-#endif
 
         // Ensure that if it was predicted as a branch, it really is a
         // branch.
@@ -60,6 +60,56 @@ class DependencyEntry
     DependencyEntry<DynInstPtr> *next;
 };
 
+/**
+ * Interface of the structures the IQ uses to track which instructions
+ * wait on which physical registers. Each physical register has the
+ * future producer of its value and the consumers waiting on it.
+ */
+template <class DynInstPtr>
+class DependencyTracker
+{
+  public:
+    DependencyTracker() : nodesTraversed(0), nodesRemoved(0) { }
+
+    virtual ~DependencyTracker() { }
+
+    /** Resize the tracker to have num_entries registers. */
+    virtual void resize(int num_entries) = 0;
+
+    /** Clears all of the dependencies. */
+    virtual void reset() = 0;
+
+    /** Inserts an instruction to be dependent on the given index. */
+    virtual void insert(PhysRegIndex idx, const DynInstPtr &new_inst) = 0;
+
+    /** Sets the producing instruction of a given register. */
+    virtual void setInst(PhysRegIndex idx, const DynInstPtr &new_inst) = 0;
+
+    /** Clears the producing instruction. */
+    virtual void clearInst(PhysRegIndex idx) = 0;
+
+    /** Removes an instruction from the dependents of a single register. */
+    virtual void remove(PhysRegIndex idx,
+                        const DynInstPtr &inst_to_remove) = 0;
+
+    /** Removes and returns a dependent of a specific register. */
+    virtual DynInstPtr pop(PhysRegIndex idx) = 0;
+
+    /** Checks if there are no dependents at all. */
+    virtual bool empty() const = 0;
+
+    /** Checks if there are any dependents on a specific register. */
+    virtual bool empty(PhysRegIndex idx) const = 0;
+
+    /** Debugging function to dump out the dependencies. */
+    virtual void dump() = 0;
+
+    // Debug variable, remove when done testing.
+    uint64_t nodesTraversed;
+    // Debug variable, remove when done testing.
+    uint64_t nodesRemoved;
+};
+
 /** Array of linked list that maintains the dependencies between
  * producing instructions and consuming instructions.  Each linked
  * list represents a single physical register, having the future
@@ -70,50 +120,51 @@ class DependencyEntry
  * either when the producer completes, or the instruction is squashed.
 */
 template <class DynInstPtr>
-class DependencyGraph
+class DependencyGraph : public DependencyTracker<DynInstPtr>
 {
   public:
     typedef DependencyEntry<DynInstPtr> DepEntry;
 
     /** Default construction.  Must call resize() prior to use. */
     DependencyGraph()
-        : numEntries(0), memAllocCounter(0), nodesTraversed(0), nodesRemoved(0)
+        : numEntries(0), memAllocCounter(0)
     { }
 
     ~DependencyGraph();
 
     /** Resize the dependency graph to have num_entries registers. */
-    void resize(int num_entries);
+    void resize(int num_entries) override;
 
     /** Clears all of the linked lists. */
-    void reset();
+    void reset() override;
 
     /** Inserts an instruction to be dependent on the given index. */
-    void insert(PhysRegIndex idx, const DynInstPtr &new_inst);
+    void insert(PhysRegIndex idx, const DynInstPtr &new_inst) override;
 
     /** Sets the producing instruction of a given register. */
-    void setInst(PhysRegIndex idx, const DynInstPtr &new_inst)
+    void setInst(PhysRegIndex idx, const DynInstPtr &new_inst) override
     { dependGraph[idx].inst = new_inst; }
 
     /** Clears the producing instruction. */
-    void clearInst(PhysRegIndex idx)
+    void clearInst(PhysRegIndex idx) override
     { dependGraph[idx].inst = NULL; }
 
     /** Removes an instruction from a single linked list. */
-    void remove(PhysRegIndex idx, const DynInstPtr &inst_to_remove);
+    void remove(PhysRegIndex idx, const DynInstPtr &inst_to_remove) override;
 
     /** Removes and returns the newest dependent of a specific register. */
-    DynInstPtr pop(PhysRegIndex idx);
+    DynInstPtr pop(PhysRegIndex idx) override;
 
     /** Checks if the entire dependency graph is empty. */
-    bool empty() const;
+    bool empty() const override;
 
     /** Checks if there are any dependents on a specific register. */
-    bool empty(PhysRegIndex idx) const { return !dependGraph[idx].next; }
+    bool empty(PhysRegIndex idx) const override
+    { return !dependGraph[idx].next; }
 
     /** Debugging function to dump out the dependency graph.
      */
-    void dump();
+    void dump() override;
 
   private:
     /** Array of linked lists.  Each linked list is a list of all the
@@ -129,12 +180,6 @@ class DependencyGraph
 
     // Debug variable, remove when done testing.
     unsigned memAllocCounter;
-
-  public:
-    // Debug variable, remove when done testing.
-    uint64_t nodesTraversed;
-    // Debug variable, remove when done testing.
-    uint64_t nodesRemoved;
 };
 
 template <class DynInstPtr>
@@ -216,13 +261,13 @@ DependencyGraph<DynInstPtr>::remove(PhysRegIndex idx,
         return;
     }
 
-    nodesRemoved++;
+    this->nodesRemoved++;
 
     // Find the instruction to remove within the dependency linked list.
     while (curr->inst != inst_to_remove) {
         prev = curr;
         curr = curr->next;
-        nodesTraversed++;
+        this->nodesTraversed++;
 
         assert(curr != NULL);
     }
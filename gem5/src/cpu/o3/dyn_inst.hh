@@ -47,6 +47,7 @@
 #include <array>
 
 #include "arch/isa_traits.hh"
+#include "base/pool_allocator.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu.hh"
 #include "cpu/o3/isa_specific.hh"
@@ -88,6 +89,31 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
     ~BaseO3DynInst();
 
+    /**
+     * Every fetched instruction, squashed or not, is allocated and
+     * freed, so their storage is recycled through a per-thread pool
+     * that settles at the number of instructions in flight. Objects
+     * of derived classes use the global heap.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(BaseO3DynInst))
+            return ::operator new(size);
+        return PoolAllocator<BaseO3DynInst>().allocate(1);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(BaseO3DynInst)) {
+            ::operator delete(p);
+        } else {
+            PoolAllocator<BaseO3DynInst>().deallocate(
+                static_cast<BaseO3DynInst *>(p), 1);
+        }
+    }
+
     /** Executes the instruction.*/
     Fault execute();
 
@@ -121,7 +147,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
 
 
   public:
-#if TRACING_ON
     /** Tick records used for the pipeline activity viewer. */
     Tick fetchTick;      // instruction fetch is completed.
     int32_t decodeTick;  // instruction enters decode phase
@@ -131,7 +156,6 @@ class BaseO3DynInst : public BaseDynInst<Impl>
     int32_t completeTick;
     int32_t commitTick;
     int32_t storeTick;
-#endif
 
     /** Reads a misc. register, including any side-effects the read
      * might have as defined by the architecture.
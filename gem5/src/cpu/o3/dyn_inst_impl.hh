@@ -68,6 +68,25 @@ BaseO3DynInst<Impl>::BaseO3DynInst(const StaticInstPtr &_staticInst,
 
 template <class Impl>BaseO3DynInst<Impl>::~BaseO3DynInst()
 {
+    if (this->cpu->pipeTrace && this->fetchTick != -1) {
+        O3PipeTrace::Record rec;
+        rec.seqNum = this->seqNum;
+        rec.pc = this->instAddr();
+        rec.upc = this->microPC();
+        rec.tid = this->threadNumber;
+        rec.opClass = this->opClass();
+        rec.squashed = this->isSquashed();
+        rec.fetch = this->fetchTick;
+        rec.decode = this->decodeTick;
+        rec.rename = this->renameTick;
+        rec.dispatch = this->dispatchTick;
+        rec.issue = this->issueTick;
+        rec.complete = this->completeTick;
+        rec.commit = this->commitTick;
+        rec.store = this->storeTick;
+        this->cpu->pipeTrace->write(rec, this->staticInst);
+    }
+
 #if TRACING_ON
     if (DTRACE(O3PipeView)) {
         Tick fetch = this->fetchTick;
@@ -110,7 +129,6 @@ BaseO3DynInst<Impl>::initVars()
 
     _numDestMiscRegs = 0;
 
-#if TRACING_ON
     // Value -1 indicates that particular phase
     // hasn't happened (yet).
     fetchTick = -1;
@@ -121,7 +139,6 @@ BaseO3DynInst<Impl>::initVars()
     completeTick = -1;
     commitTick = -1;
     storeTick = -1;
-#endif
 }
 
 template <class Impl>
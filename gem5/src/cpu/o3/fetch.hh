@@ -48,11 +48,11 @@
 #include "arch/utility.hh"
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
+#include "cpu/o3/smt_fetch_policy.hh"
 #include "cpu/pc_event.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "cpu/timebuf.hh"
 #include "cpu/translation.hh"
-#include "enums/FetchPolicy.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "sim/eventq.hh"
@@ -208,10 +208,10 @@ class DefaultFetch
     ThreadStatus fetchStatus[Impl::MaxThreads];
 
     /** Fetch policy. */
-    FetchPolicy fetchPolicy;
+    SMTFetchPolicy *fetchPolicy;
 
-    /** List that has the threads organized by priority. */
-    std::list<ThreadID> priorityList;
+    /** The thread that comes first in round robin order. */
+    ThreadID nextFetchingThread;
 
     /** Probe points. */
     ProbePointArg<DynInstPtr> *ppFetch;
@@ -278,8 +278,6 @@ class DefaultFetch
     /** Tells fetch to wake up from a quiesce instruction. */
     void wakeFromQuiesce();
 
-    /** For priority-based fetch policies, need to keep update priorityList */
-    void deactivateThread(ThreadID tid);
   private:
     /** Reset this pipeline stage */
     void resetStage();
@@ -390,24 +388,17 @@ class DefaultFetch
     /** Returns the appropriate thread to fetch, given the fetch policy. */
     ThreadID getFetchingThread();
 
-    /** Returns the appropriate thread to fetch using a round robin policy. */
-    ThreadID roundRobin();
-
-    /** Returns the appropriate thread to fetch using the IQ count policy. */
-    ThreadID iqCount();
-
-    /** Returns the appropriate thread to fetch using the LSQ count policy. */
-    ThreadID lsqCount();
-
-    /** Returns the appropriate thread to fetch using the branch count
-     * policy. */
-    ThreadID branchCount();
-
     /** Pipeline the next I-cache access to the current one. */
     void pipelineIcacheAccesses(ThreadID tid);
 
     /** Profile the reasons of fetch stall. */
-    void profileStall(ThreadID tid);
+    void profileStall(ThreadID tid, Cycles cycles = Cycles(1));
+
+  public:
+    /** Records the stats of cycles the CPU skipped while the pipeline
+     *  was stalled, as tick() would have done for each of them.
+     */
+    void creditStalledCycles(Cycles cycles);
 
   private:
     /** Pointer to the O3CPU. */
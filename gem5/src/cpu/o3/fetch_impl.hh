@@ -48,8 +48,6 @@
 #include <algorithm>
 #include <cstring>
 #include <list>
-#include <map>
-#include <queue>
 
 #include "arch/generic/tlb.hh"
 #include "arch/isa_traits.hh"
@@ -67,7 +65,6 @@
 #include "debug/Drain.hh"
 #include "debug/Fetch.hh"
 #include "debug/O3CPU.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "params/DerivO3CPU.hh"
 #include "sim/byteswap.hh"
@@ -82,6 +79,7 @@ using namespace std;
 template<class Impl>
 DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
     : fetchPolicy(params->smtFetchPolicy),
+      nextFetchingThread(0),
       cpu(_cpu),
       branchPred(nullptr),
       decodeToFetchDelay(params->decodeToFetchDelay),
@@ -116,10 +114,6 @@ DefaultFetch<Impl>::DefaultFetch(O3CPU *_cpu, DerivO3CPUParams *params)
         fatal("cache block (%u bytes) is not a multiple of the "
               "fetch buffer (%u bytes)\n", cacheBlkSize, fetchBufferSize);
 
-    // Figure out fetch policy
-    panic_if(fetchPolicy == FetchPolicy::SingleThread && numThreads > 1,
-             "Invalid Fetch Policy for a SMT workload.");
-
     // Get the size of an instruction.
     instSize = sizeof(TheISA::MachInst);
 
@@ -321,7 +315,6 @@ template<class Impl>
 void
 DefaultFetch<Impl>::startupStage()
 {
-    assert(priorityList.empty());
     resetStage();
 
     // Fetch needs to start fetching instructions at the very beginning,
@@ -344,9 +337,6 @@ DefaultFetch<Impl>::clearStates(ThreadID tid)
     fetchBufferPC[tid] = 0;
     fetchBufferValid[tid] = false;
     fetchQueue[tid].clear();
-
-    // TODO not sure what to do with priorityList for now
-    // priorityList.push_back(tid);
 }
 
 template<class Impl>
@@ -356,8 +346,7 @@ DefaultFetch<Impl>::resetStage()
     numInst = 0;
     interruptPending = false;
     cacheBlocked = false;
-
-    priorityList.clear();
+    nextFetchingThread = 0;
 
     // Setup PC and nextPC with initial state.
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
@@ -376,8 +365,6 @@ DefaultFetch<Impl>::resetStage()
         fetchBufferValid[tid] = false;
 
         fetchQueue[tid].clear();
-
-        priorityList.push_back(tid);
     }
 
     wroteToTimeBuffer = false;
@@ -542,17 +529,6 @@ DefaultFetch<Impl>::switchToInactive()
     }
 }
 
-template <class Impl>
-void
-DefaultFetch<Impl>::deactivateThread(ThreadID tid)
-{
-    // Update priority list
-    auto thread_it = std::find(priorityList.begin(), priorityList.end(), tid);
-    if (thread_it != priorityList.end()) {
-        priorityList.erase(thread_it);
-    }
-}
-
 template <class Impl>
 bool
 DefaultFetch<Impl>::lookupAndUpdateNextPC(
@@ -1138,6 +1114,10 @@ DefaultFetch<Impl>::buildInst(ThreadID tid, StaticInstPtr staticInst,
     // Add instruction to the CPU's list of instructions.
     instruction->setInstListIt(cpu->addInst(instruction));
 
+    // Only the SMT fetch policy looks at the occupancy of the threads
+    if (numThreads > 1)
+        instruction->countThreadOccupancy();
+
     // Write the instruction to the first slot in the queue
     // that heads to decode.
     assert(numInst < fetchWidth);
@@ -1337,11 +1317,9 @@ DefaultFetch<Impl>::fetch(bool &status_change)
             ppFetch->notify(instruction);
             numInst++;
 
-#if TRACING_ON
-            if (DTRACE(O3PipeView)) {
+            if (cpu->tracePipeline()) {
                 instruction->fetchTick = curTick();
             }
-#endif
 
             nextPC = thisPC;
 
@@ -1439,6 +1417,7 @@ DefaultFetch<Impl>::recvReqRetry()
         // Access has been squashed since it was sent out.  Just clear
         // the cache being blocked.
         cacheBlocked = false;
+        cpu->wakeCPU();
     }
 }
 
@@ -1452,18 +1431,39 @@ ThreadID
 DefaultFetch<Impl>::getFetchingThread()
 {
     if (numThreads > 1) {
-        switch (fetchPolicy) {
-          case FetchPolicy::RoundRobin:
-            return roundRobin();
-          case FetchPolicy::IQCount:
-            return iqCount();
-          case FetchPolicy::LSQCount:
-            return lsqCount();
-          case FetchPolicy::Branch:
-            return branchCount();
-          default:
-            return InvalidThreadID;
+        // Sort the active threads in round robin order, starting
+        // after the thread that was picked last
+        ThreadID order[Impl::MaxThreads];
+        std::fill(order, order + numThreads, InvalidThreadID);
+        for (ThreadID tid : *activeThreads) {
+            order[(tid + numThreads - nextFetchingThread) % numThreads] =
+                tid;
         }
+
+        SMTFetchPolicy::ThreadInfo threads[Impl::MaxThreads];
+        unsigned num_threads = 0;
+        for (ThreadID i = 0; i < numThreads; ++i) {
+            const ThreadID tid = order[i];
+            if (tid == InvalidThreadID ||
+                (fetchStatus[tid] != Running &&
+                 fetchStatus[tid] != IcacheAccessComplete &&
+                 fetchStatus[tid] != Idle)) {
+                continue;
+            }
+
+            SMTFetchPolicy::ThreadInfo &info = threads[num_threads++];
+            info.tid = tid;
+            info.icount = cpu->smtCounts[tid].icount;
+            info.iqCount = fromIEW->iewInfo[tid].iqCount;
+            info.lsqCount = fromIEW->iewInfo[tid].ldstqCount;
+            info.branchCount = cpu->smtCounts[tid].branchCount;
+            info.missCount = fromIEW->iewInfo[tid].missCount;
+        }
+
+        const ThreadID tid = fetchPolicy->chooseThread(threads, num_threads);
+        if (tid != InvalidThreadID)
+            nextFetchingThread = (tid + 1) % numThreads;
+        return tid;
     } else {
         list<ThreadID>::iterator thread = activeThreads->begin();
         if (thread == activeThreads->end()) {
@@ -1483,117 +1483,6 @@ DefaultFetch<Impl>::getFetchingThread()
 }
 
 
-template<class Impl>
-ThreadID
-DefaultFetch<Impl>::roundRobin()
-{
-    list<ThreadID>::iterator pri_iter = priorityList.begin();
-    list<ThreadID>::iterator end      = priorityList.end();
-
-    ThreadID high_pri;
-
-    while (pri_iter != end) {
-        high_pri = *pri_iter;
-
-        assert(high_pri <= numThreads);
-
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle) {
-
-            priorityList.erase(pri_iter);
-            priorityList.push_back(high_pri);
-
-            return high_pri;
-        }
-
-        pri_iter++;
-    }
-
-    return InvalidThreadID;
-}
-
-template<class Impl>
-ThreadID
-DefaultFetch<Impl>::iqCount()
-{
-    //sorted from lowest->highest
-    std::priority_queue<unsigned,vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
-
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
-
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned iqCount = fromIEW->iewInfo[tid].iqCount;
-
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(iqCount);
-        threadMap[iqCount] = tid;
-    }
-
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
-
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
-
-    }
-
-    return InvalidThreadID;
-}
-
-template<class Impl>
-ThreadID
-DefaultFetch<Impl>::lsqCount()
-{
-    //sorted from lowest->highest
-    std::priority_queue<unsigned,vector<unsigned>,
-                        std::greater<unsigned> > PQ;
-    std::map<unsigned, ThreadID> threadMap;
-
-    list<ThreadID>::iterator threads = activeThreads->begin();
-    list<ThreadID>::iterator end = activeThreads->end();
-
-    while (threads != end) {
-        ThreadID tid = *threads++;
-        unsigned ldstqCount = fromIEW->iewInfo[tid].ldstqCount;
-
-        //we can potentially get tid collisions if two threads
-        //have the same iqCount, but this should be rare.
-        PQ.push(ldstqCount);
-        threadMap[ldstqCount] = tid;
-    }
-
-    while (!PQ.empty()) {
-        ThreadID high_pri = threadMap[PQ.top()];
-
-        if (fetchStatus[high_pri] == Running ||
-            fetchStatus[high_pri] == IcacheAccessComplete ||
-            fetchStatus[high_pri] == Idle)
-            return high_pri;
-        else
-            PQ.pop();
-    }
-
-    return InvalidThreadID;
-}
-
-template<class Impl>
-ThreadID
-DefaultFetch<Impl>::branchCount()
-{
-    panic("Branch Count Fetch policy unimplemented\n");
-    return InvalidThreadID;
-}
-
 template<class Impl>
 void
 DefaultFetch<Impl>::pipelineIcacheAccesses(ThreadID tid)
@@ -1626,41 +1515,41 @@ DefaultFetch<Impl>::pipelineIcacheAccesses(ThreadID tid)
 
 template<class Impl>
 void
-DefaultFetch<Impl>::profileStall(ThreadID tid) {
+DefaultFetch<Impl>::profileStall(ThreadID tid, Cycles cycles) {
     DPRINTF(Fetch,"There are no more threads available to fetch from.\n");
 
     // @todo Per-thread stats
 
     if (stalls[tid].drain) {
-        ++fetchPendingDrainCycles;
+        fetchPendingDrainCycles += cycles;
         DPRINTF(Fetch, "Fetch is waiting for a drain!\n");
     } else if (activeThreads->empty()) {
-        ++fetchNoActiveThreadStallCycles;
+        fetchNoActiveThreadStallCycles += cycles;
         DPRINTF(Fetch, "Fetch has no active thread!\n");
     } else if (fetchStatus[tid] == Blocked) {
-        ++fetchBlockedCycles;
+        fetchBlockedCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is blocked!\n", tid);
     } else if (fetchStatus[tid] == Squashing) {
-        ++fetchSquashCycles;
+        fetchSquashCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is squashing!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitResponse) {
-        ++icacheStallCycles;
+        icacheStallCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting cache response!\n",
                 tid);
     } else if (fetchStatus[tid] == ItlbWait) {
-        ++fetchTlbCycles;
+        fetchTlbCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting ITLB walk to "
                 "finish!\n", tid);
     } else if (fetchStatus[tid] == TrapPending) {
-        ++fetchPendingTrapStallCycles;
+        fetchPendingTrapStallCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending trap!\n",
                 tid);
     } else if (fetchStatus[tid] == QuiescePending) {
-        ++fetchPendingQuiesceStallCycles;
+        fetchPendingQuiesceStallCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for a pending quiesce "
                 "instruction!\n", tid);
     } else if (fetchStatus[tid] == IcacheWaitRetry) {
-        ++fetchIcacheWaitRetryStallCycles;
+        fetchIcacheWaitRetryStallCycles += cycles;
         DPRINTF(Fetch, "[tid:%i] Fetch is waiting for an I-cache retry!\n",
                 tid);
     } else if (fetchStatus[tid] == NoGoodAddr) {
@@ -1673,6 +1562,25 @@ DefaultFetch<Impl>::profileStall(ThreadID tid) {
     }
 }
 
+template<class Impl>
+void
+DefaultFetch<Impl>::creditStalledCycles(Cycles cycles)
+{
+    fetchNisnDist.sample(0, cycles);
+
+    // @todo Per-thread stats
+    if (numThreads != 1)
+        return;
+
+    if (fetchStatus[0] == Running) {
+        fetchCycles += cycles;
+    } else if (fetchStatus[0] == Idle) {
+        fetchIdleCycles += cycles;
+    } else {
+        profileStall(0, cycles);
+    }
+}
+
 template<class Impl>
 bool
 DefaultFetch<Impl>::IcachePort::recvTimingResp(PacketPtr pkt)
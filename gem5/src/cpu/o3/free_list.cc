@@ -42,6 +42,19 @@ UnifiedFreeList::UnifiedFreeList(const std::string &_my_name,
 {
     DPRINTF(FreeList, "Creating new free list object.\n");
 
+    auto range = regFile->getRegIds(IntRegClass);
+    intList.init(range.first, range.second);
+    range = regFile->getRegIds(FloatRegClass);
+    floatList.init(range.first, range.second);
+    range = regFile->getRegIds(VecRegClass);
+    vecList.init(range.first, range.second);
+    range = regFile->getRegIds(VecElemClass);
+    vecElemList.init(range.first, range.second);
+    range = regFile->getRegIds(VecPredRegClass);
+    predList.init(range.first, range.second);
+    range = regFile->getRegIds(CCRegClass);
+    ccList.init(range.first, range.second);
+
     // Have the register file initialize the free list since it knows
     // about its internal organization
     regFile->initFreeList(this);
@@ -44,10 +44,13 @@
 #ifndef __CPU_O3_FREE_LIST_HH__
 #define __CPU_O3_FREE_LIST_HH__
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <iostream>
-#include <queue>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "cpu/o3/comm.hh"
@@ -63,41 +66,161 @@
  */
 class SimpleFreeList
 {
+  public:
+    /**
+     * The state of the list saved with a rename checkpoint. Restoring
+     * it frees the registers that were free when it was taken and all
+     * the registers freed since.
+     */
+    struct Checkpoint
+    {
+        /** The registers that were free when it was taken. */
+        std::vector<uint64_t> free;
+        /** The registers freed until the next checkpoint was taken. */
+        std::vector<uint64_t> freed;
+    };
+
   private:
 
-    /** The actual free list */
-    std::queue<PhysRegIdPtr> freeRegs;
+    /** The registers the list can hold, in a contiguous array. */
+    PhysRegIdPtr regs;
+
+    /** The number of registers the list can hold. */
+    unsigned numRegs;
+
+    /** One bit per register, set when the register is free. */
+    std::vector<uint64_t> freeBits;
+
+    /** One bit per register, set when the register was freed since the
+     *  youngest rename checkpoint was taken.
+     */
+    std::vector<uint64_t> freedBits;
+
+    /** The number of free registers. */
+    unsigned numFree;
+
+    /** Where to start looking for a free register, so that registers
+     *  are handed out in a round robin fashion like with a FIFO.
+     */
+    unsigned nextReg;
+
+    /** Returns the position of a register in the list. */
+    unsigned
+    position(PhysRegIdPtr reg) const
+    {
+        assert(reg >= regs && reg < regs + numRegs);
+        return reg - regs;
+    }
 
   public:
 
-    SimpleFreeList() {};
+    SimpleFreeList()
+        : regs(nullptr), numRegs(0), numFree(0), nextReg(0)
+    {}
+
+    /** Sets the registers the list can hold, all of them being busy. */
+    template<class InputIt>
+    void
+    init(InputIt first, InputIt last)
+    {
+        numRegs = last - first;
+        regs = numRegs ? &*first : nullptr;
+        freeBits.assign((numRegs + 63) / 64, 0);
+        freedBits.assign(freeBits.size(), 0);
+        numFree = 0;
+        nextReg = 0;
+    }
 
     /** Add a physical register to the free list */
-    void addReg(PhysRegIdPtr reg) { freeRegs.push(reg); }
+    void
+    addReg(PhysRegIdPtr reg)
+    {
+        unsigned pos = position(reg);
+        uint64_t bit = ULL(1) << (pos % 64);
+        freedBits[pos / 64] |= bit;
+        if (!(freeBits[pos / 64] & bit)) {
+            freeBits[pos / 64] |= bit;
+            ++numFree;
+        }
+    }
 
     /** Add physical registers to the free list */
     template<class InputIt>
     void
     addRegs(InputIt first, InputIt last) {
         std::for_each(first, last, [this](typename InputIt::value_type& reg) {
-            this->freeRegs.push(&reg);
+            this->addReg(&reg);
         });
     }
 
     /** Get the next available register from the free list */
     PhysRegIdPtr getReg()
     {
-        assert(!freeRegs.empty());
-        PhysRegIdPtr free_reg = freeRegs.front();
-        freeRegs.pop();
-        return free_reg;
+        assert(numFree);
+        const unsigned words = freeBits.size();
+        unsigned word = nextReg / 64;
+        uint64_t bits = freeBits[word] & (~ULL(0) << (nextReg % 64));
+        for (unsigned i = 0; !bits; ++i) {
+            assert(i <= words);
+            word = word + 1 == words ? 0 : word + 1;
+            bits = freeBits[word];
+        }
+
+        unsigned pos = word * 64 + ctz64(bits);
+        freeBits[word] &= ~(ULL(1) << (pos % 64));
+        --numFree;
+        nextReg = pos + 1 == numRegs ? 0 : pos + 1;
+        return regs + pos;
     }
 
     /** Return the number of free registers on the list. */
-    unsigned numFreeRegs() const { return freeRegs.size(); }
+    unsigned numFreeRegs() const { return numFree; }
 
     /** True iff there are free registers on the list. */
-    bool hasFreeRegs() const { return !freeRegs.empty(); }
+    bool hasFreeRegs() const { return numFree != 0; }
+
+    /**
+     * Saves the free registers in a new checkpoint.
+     * @param cp The new checkpoint.
+     * @param prev The youngest checkpoint so far, if any, which gets
+     * the registers freed since it was taken.
+     */
+    void
+    save(Checkpoint &cp, Checkpoint *prev)
+    {
+        if (prev)
+            prev->freed = freedBits;
+        cp.free = freeBits;
+        std::fill(freedBits.begin(), freedBits.end(), 0);
+    }
+
+    /**
+     * Discards the youngest checkpoint, the registers freed since it
+     * was taken are then accounted to the one before it.
+     * @param prev The checkpoint before it, if any.
+     */
+    void
+    drop(const Checkpoint *prev)
+    {
+        if (!prev)
+            return;
+        for (unsigned i = 0; i < freedBits.size(); ++i)
+            freedBits[i] |= prev->freed[i];
+    }
+
+    /**
+     * Restores the youngest checkpoint, freeing all the registers
+     * allocated since it was taken.
+     */
+    void
+    restore(const Checkpoint &cp)
+    {
+        numFree = 0;
+        for (unsigned i = 0; i < freeBits.size(); ++i) {
+            freeBits[i] = cp.free[i] | freedBits[i];
+            numFree += popCount(freeBits[i]);
+        }
+    }
 };
 
 
@@ -156,7 +279,17 @@ class UnifiedFreeList
      */
     friend class UnifiedRenameMap;
 
+    /** All the per-class lists, for the operations on all of them. */
+    std::array<SimpleFreeList *, 6> lists()
+    {
+        return {{ &intList, &floatList, &vecList, &vecElemList, &predList,
+                  &ccList }};
+    }
+
   public:
+    /** The state of all the lists saved with a rename checkpoint. */
+    typedef std::array<SimpleFreeList::Checkpoint, 6> Checkpoint;
+
     /** Constructs a free list.
      *  @param _numPhysicalIntRegs Number of physical integer registers.
      *  @param reservedIntRegs Number of integer registers already
@@ -218,6 +351,40 @@ class UnifiedFreeList
     /** Adds a cc register back to the free list. */
     void addCCReg(PhysRegIdPtr freed_reg) { ccList.addReg(freed_reg); }
 
+    /**
+     * Saves the free registers in a new rename checkpoint.
+     * @param cp The new checkpoint.
+     * @param prev The youngest checkpoint so far, if any.
+     */
+    void
+    saveCheckpoint(Checkpoint &cp, Checkpoint *prev)
+    {
+        auto l = lists();
+        for (int i = 0; i < l.size(); ++i)
+            l[i]->save(cp[i], prev ? &(*prev)[i] : nullptr);
+    }
+
+    /**
+     * Discards the youngest rename checkpoint.
+     * @param prev The checkpoint before it, if any.
+     */
+    void
+    dropCheckpoint(const Checkpoint *prev)
+    {
+        auto l = lists();
+        for (int i = 0; i < l.size(); ++i)
+            l[i]->drop(prev ? &(*prev)[i] : nullptr);
+    }
+
+    /** Restores the youngest rename checkpoint. */
+    void
+    restoreCheckpoint(const Checkpoint &cp)
+    {
+        auto l = lists();
+        for (int i = 0; i < l.size(); ++i)
+            l[i]->restore(cp[i]);
+    }
+
     /** Checks if there are any free integer registers. */
     bool hasFreeIntRegs() const { return intList.hasFreeRegs(); }
 
@@ -299,8 +466,6 @@ UnifiedFreeList::addReg(PhysRegIdPtr freed_reg)
 {
     DPRINTF(FreeList,"Freeing register %i (%s).\n", freed_reg->index(),
             freed_reg->className());
-    //Might want to add in a check for whether or not this register is
-    //already in there.  A bit vector or something similar would be useful.
     switch (freed_reg->classValue()) {
         case IntRegClass:
             intList.addReg(freed_reg);
@@ -246,6 +246,14 @@ class DefaultIEW
      */
     void squashDueToMemOrder(const DynInstPtr &inst, ThreadID tid);
 
+    /** Sends commit proper information for a squash due to the
+     * dependents of an instruction using a mispredicted value.
+     */
+    void squashDueToValueMispred(const DynInstPtr &inst, ThreadID tid);
+
+    /** Checks the predicted value of an instruction that executed. */
+    void checkValuePrediction(const DynInstPtr &inst);
+
     /** Sets Dispatch to blocked, and signals back to other stages to block. */
     void block(ThreadID tid);
 
@@ -296,6 +304,11 @@ class DefaultIEW
      */
     void tick();
 
+    /** Records the stats of cycles the CPU skipped while the pipeline
+     *  was stalled, as tick() would have done for each of them.
+     */
+    void creditStalledCycles(Cycles cycles);
+
   private:
     /** Updates execution stats based on the instruction. */
     void updateExeInstStats(const DynInstPtr &inst);
@@ -442,6 +455,8 @@ class DefaultIEW
     Stats::Scalar iewLSQFullEvents;
     /** Stat for total number of memory ordering violation events. */
     Stats::Scalar memOrderViolationEvents;
+    /** Stat for total number of mispredicted values that were used. */
+    Stats::Scalar valueMispredicts;
     /** Stat for total number of incorrect predicted taken branches. */
     Stats::Scalar predictedTakenIncorrect;
     /** Stat for total number of incorrect predicted not taken branches. */
@@ -59,7 +59,6 @@
 #include "debug/Activity.hh"
 #include "debug/Drain.hh"
 #include "debug/IEW.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -100,6 +99,7 @@ DefaultIEW<Impl>::DefaultIEW(O3CPU *_cpu, DerivO3CPUParams *params)
 
     // Setup wire to read instructions coming from issue.
     fromIssue = issueToExecQueue.getWire(-issueToExecuteDelay);
+    issueToExecQueue.setDirtyTracking(true);
 
     // Instruction queue needs the queue between issue and execute.
     instQueue.setIssueToExecuteQueue(&issueToExecQueue);
@@ -198,6 +198,10 @@ DefaultIEW<Impl>::regStats()
         .name(name() + ".memOrderViolationEvents")
         .desc("Number of memory order violations");
 
+    valueMispredicts
+        .name(name() + ".valueMispredicts")
+        .desc("Number of mispredicted values used by the dependents");
+
     predictedTakenIncorrect
         .name(name() + ".predictedTakenIncorrect")
         .desc("Number of branches that were predicted taken incorrectly");
@@ -547,6 +551,48 @@ DefaultIEW<Impl>::squashDueToMemOrder(const DynInstPtr& inst, ThreadID tid)
     }
 }
 
+template<class Impl>
+void
+DefaultIEW<Impl>::squashDueToValueMispred(const DynInstPtr &inst,
+                                          ThreadID tid)
+{
+    DPRINTF(IEW, "[tid:%i] [sn:%llu] Value mispredicted, squashing younger "
+            "insts, PC: %s\n", tid, inst->seqNum, inst->pcState());
+
+    if (!toCommit->squash[tid] ||
+            inst->seqNum < toCommit->squashedSeqNum[tid]) {
+        toCommit->squash[tid] = true;
+        toCommit->squashedSeqNum[tid] = inst->seqNum;
+        toCommit->branchTaken[tid] = false;
+
+        // The instruction itself produced the right value, only the
+        // younger ones have to be fetched again
+        TheISA::PCState pc = inst->pcState();
+        TheISA::advancePC(pc, inst->staticInst);
+
+        toCommit->pc[tid] = pc;
+        toCommit->mispredictInst[tid] = NULL;
+        toCommit->includeSquashInst[tid] = false;
+
+        wroteToTimeBuffer = true;
+    }
+}
+
+template<class Impl>
+void
+DefaultIEW<Impl>::checkValuePrediction(const DynInstPtr &inst)
+{
+    const RegVal value = cpu->readIntReg(inst->renamedDestRegIdx(0));
+    if (value == inst->predictedValue)
+        return;
+
+    DPRINTF(IEW, "[tid:%i] [sn:%llu] Predicted value %#x, actual %#x\n",
+            inst->threadNumber, inst->seqNum, inst->predictedValue, value);
+
+    ++valueMispredicts;
+    squashDueToValueMispred(inst, inst->threadNumber);
+}
+
 template<class Impl>
 void
 DefaultIEW<Impl>::block(ThreadID tid)
@@ -1158,9 +1204,7 @@ DefaultIEW<Impl>::dispatchInsts(ThreadID tid)
 
         ++iewDispatchedInsts;
 
-#if TRACING_ON
         inst->dispatchTick = curTick() - inst->fetchTick;
-#endif
         ppDispatch->notify(inst);
     }
 
@@ -1479,6 +1523,9 @@ DefaultIEW<Impl>::writebackInsts()
         if (!inst->isSquashed() && inst->isExecuted() && inst->getFault() == NoFault) {
             int dependents = instQueue.wakeDependents(inst);
 
+            if (inst->valuePredicted())
+                checkValuePrediction(inst);
+
             for (int i = 0; i < inst->numDestRegs(); i++) {
                 // Mark register as ready if not pinned
                 if (inst->renamedDestRegIdx(i)->
@@ -1499,6 +1546,21 @@ DefaultIEW<Impl>::writebackInsts()
     }
 }
 
+template<class Impl>
+void
+DefaultIEW<Impl>::creditStalledCycles(Cycles cycles)
+{
+    for (ThreadID tid : *activeThreads) {
+        if (dispatchStatus[tid] == Blocked) {
+            iewBlockCycles += cycles;
+        } else if (dispatchStatus[tid] == Squashing) {
+            iewSquashCycles += cycles;
+        }
+    }
+
+    instQueue.creditStalledCycles(cycles);
+}
+
 template<class Impl>
 void
 DefaultIEW<Impl>::tick()
@@ -1598,6 +1660,8 @@ DefaultIEW<Impl>::tick()
                 instQueue.getCount(tid);
             toFetch->iewInfo[tid].ldstqCount =
                 ldstQueue.getCount(tid);
+            toFetch->iewInfo[tid].missCount =
+                ldstQueue.numLoadsInFlight(tid);
 
             toRename->iewInfo[tid].usedIQ = true;
             toRename->iewInfo[tid].freeIQEntries =
@@ -1637,11 +1701,9 @@ DefaultIEW<Impl>::updateExeInstStats(const DynInstPtr& inst)
 
     iewExecutedInsts++;
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeline()) {
         inst->completeTick = curTick() - inst->fetchTick;
     }
-#endif
 
     //
     //  Control operations
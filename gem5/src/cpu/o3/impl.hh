@@ -31,7 +31,10 @@
 #ifndef __CPU_O3_IMPL_HH__
 #define __CPU_O3_IMPL_HH__
 
+#include <list>
+
 #include "arch/isa_traits.hh"
+#include "base/pool_allocator.hh"
 #include "config/the_isa.hh"
 #include "cpu/o3/cpu_policy.hh"
 
@@ -67,6 +70,13 @@ struct O3CPUImpl
     typedef RefCountingPtr<DynInst> DynInstPtr;
     typedef RefCountingPtr<const DynInst> DynInstConstPtr;
 
+    /** List of instructions, as kept by the CPU, ROB, IQ and memory
+     *  dependence unit. Every instruction goes through several of
+     *  them, so their nodes are recycled instead of going back to the
+     *  heap.
+     */
+    typedef std::list<DynInstPtr, PoolAllocator<DynInstPtr>> DynInstList;
+
     /** The O3CPU type to be used. */
     typedef FullO3CPU<O3CPUImpl> O3CPU;
 
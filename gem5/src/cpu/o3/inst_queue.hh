@@ -44,17 +44,21 @@
 #ifndef __CPU_O3_INST_QUEUE_HH__
 #define __CPU_O3_INST_QUEUE_HH__
 
+#include <deque>
 #include <list>
 #include <map>
+#include <memory>
 #include <queue>
 #include <vector>
 
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/o3/dep_graph.hh"
 #include "cpu/inst_seq.hh"
 #include "cpu/op_class.hh"
 #include "cpu/timebuf.hh"
+#include "enums/IQWakeupModel.hh"
 #include "enums/SMTQueuePolicy.hh"
 #include "sim/eventq.hh"
 
@@ -93,7 +97,13 @@ class InstructionQueue
     typedef typename Impl::CPUPol::TimeStruct TimeStruct;
 
     // Typedef of iterator through the list of instructions.
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::DynInstList::iterator ListIt;
+
+    /** Queue of instructions that are only added and removed at the
+     *  ends, kept in contiguous chunks rather than list nodes.
+     */
+    typedef std::deque<DynInstPtr> InstDeque;
+    typedef typename InstDeque::iterator InstDequeIt;
 
     /** FU completion event class. */
     class FUCompletion : public Event {
@@ -134,6 +144,10 @@ class InstructionQueue
     /** Registers statistics. */
     void regStats();
 
+    /** Records cycles in which the CPU was stalled and nothing issued. */
+    void creditStalledCycles(Cycles cycles)
+    { numIssuedDist.sample(0, cycles); }
+
     /** Resets all instruction queue state. */
     void resetState();
 
@@ -312,24 +326,27 @@ class InstructionQueue
     // Instruction lists, ready queues, and ordering
     //////////////////////////////////////
 
-    /** List of all the instructions in the IQ (some of which may be issued). */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** List of all the instructions in the IQ (some of which may be issued).
+     *  Instructions are removed in order at commit and from the back on a
+     *  squash.
+     */
+    InstDeque instList[Impl::MaxThreads];
 
     /** List of instructions that are ready to be executed. */
-    std::list<DynInstPtr> instsToExecute;
+    InstDeque instsToExecute;
 
     /** List of instructions waiting for their DTB translation to
      *  complete (hw page table walk in progress).
      */
-    std::list<DynInstPtr> deferredMemInsts;
+    typename Impl::DynInstList deferredMemInsts;
 
     /** List of instructions that have been cache blocked. */
-    std::list<DynInstPtr> blockedMemInsts;
+    typename Impl::DynInstList blockedMemInsts;
 
     /** List of instructions that were cache blocked, but a retry has been seen
      * since, so they can now be retried. May fail again go on the blocked list.
      */
-    std::list<DynInstPtr> retryMemInsts;
+    typename Impl::DynInstList retryMemInsts;
 
     /**
      * Struct for comparing entries to be added to the priority queue.
@@ -360,45 +377,38 @@ class InstructionQueue
      *  the sequence number will be available.  Thus it is most efficient to be
      *  able to search by the sequence number alone.
      */
-    std::map<InstSeqNum, DynInstPtr> nonSpecInsts;
-
-    typedef typename std::map<InstSeqNum, DynInstPtr>::iterator NonSpecMapIt;
+    typedef std::map<InstSeqNum, DynInstPtr, std::less<InstSeqNum>,
+                     PoolAllocator<std::pair<const InstSeqNum, DynInstPtr>>>
+        NonSpecMap;
 
-    /** Entry for the list age ordering by op class. */
-    struct ListOrderEntry {
-        OpClass queueType;
-        InstSeqNum oldestInst;
-    };
+    NonSpecMap nonSpecInsts;
 
-    /** List that contains the age order of the oldest instruction of each
-     *  ready queue.  Used to select the oldest instruction available
-     *  among op classes.
-     *  @todo: Might be better to just move these entries around instead
-     *  of creating new ones every time the position changes due to an
-     *  instruction issuing.  Not sure std::list supports this.
-     */
-    std::list<ListOrderEntry> listOrder;
+    typedef typename NonSpecMap::iterator NonSpecMapIt;
 
-    typedef typename std::list<ListOrderEntry>::iterator ListOrderIt;
+    static_assert(Num_OpClasses <= 64,
+                  "The ready mask needs one bit per op class");
 
-    /** Tracks if each ready queue is on the age order list. */
-    bool queueOnList[Num_OpClasses];
+    /** Mask of the op classes whose ready queue is not empty. */
+    uint64_t readyOpClasses;
 
-    /** Iterators of each ready queue.  Points to their spot in the age order
-     *  list.
-     */
-    ListOrderIt readyIt[Num_OpClasses];
-
-    /** Add an op class to the age order list. */
-    void addToOrderList(OpClass op_class);
+    /** Marks the ready queue of an op class as holding instructions. */
+    void
+    setReady(OpClass op_class)
+    {
+        readyOpClasses |= ULL(1) << op_class;
+    }
 
     /**
-     * Called when the oldest instruction has been removed from a ready queue;
-     * this places that ready queue into the proper spot in the age order list.
+     * Returns the op class, out of a mask of op classes with ready
+     * instructions, whose oldest ready instruction is the oldest one.
+     * Used to select the oldest instruction available among op classes.
      */
-    void moveToYoungerInst(ListOrderIt age_order_it);
+    OpClass oldestReadyOpClass(uint64_t op_classes);
 
-    DependencyGraph<DynInstPtr> dependGraph;
+    /** Dependents of each physical register, either in linked lists or
+     *  in a wakeup matrix depending on the iqWakeupModel parameter.
+     */
+    std::unique_ptr<DependencyTracker<DynInstPtr>> dependGraph;
 
     //////////////////////////////////////
     // Various parameters
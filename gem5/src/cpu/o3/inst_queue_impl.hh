@@ -48,9 +48,11 @@
 #include <limits>
 #include <vector>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "cpu/o3/fu_pool.hh"
 #include "cpu/o3/inst_queue.hh"
+#include "cpu/o3/wakeup_matrix.hh"
 #include "debug/IQ.hh"
 #include "enums/OpClass.hh"
 #include "params/DerivO3CPU.hh"
@@ -107,9 +109,14 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
                     params->numPhysVecPredRegs +
                     params->numPhysCCRegs;
 
+    if (params->iqWakeupModel == IQWakeupModel::Matrix)
+        dependGraph.reset(new WakeupMatrix<DynInstPtr>);
+    else
+        dependGraph.reset(new DependencyGraph<DynInstPtr>);
+
     //Create an entry for each physical register within the
     //dependency graph.
-    dependGraph.resize(numPhysRegs);
+    dependGraph->resize(numPhysRegs);
 
     // Resize the register scoreboard.
     regScoreboard.resize(numPhysRegs);
@@ -161,10 +168,10 @@ InstructionQueue<Impl>::InstructionQueue(O3CPU *cpu_ptr, IEW *iew_ptr,
 template <class Impl>
 InstructionQueue<Impl>::~InstructionQueue()
 {
-    dependGraph.reset();
+    dependGraph->reset();
 #ifdef DEBUG
     cprintf("Nodes traversed: %i, removed: %i\n",
-            dependGraph.nodesTraversed, dependGraph.nodesRemoved);
+            dependGraph->nodesTraversed, dependGraph->nodesRemoved);
 #endif
 }
 
@@ -421,11 +428,9 @@ InstructionQueue<Impl>::resetState()
     for (int i = 0; i < Num_OpClasses; ++i) {
         while (!readyInsts[i].empty())
             readyInsts[i].pop();
-        queueOnList[i] = false;
-        readyIt[i] = listOrder.end();
     }
+    readyOpClasses = 0;
     nonSpecInsts.clear();
-    listOrder.clear();
     deferredMemInsts.clear();
     blockedMemInsts.clear();
     retryMemInsts.clear();
@@ -459,7 +464,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::isDrained() const
 {
-    bool drained = dependGraph.empty() &&
+    bool drained = dependGraph->empty() &&
                    instsToExecute.empty() &&
                    wbOutstanding == 0;
     for (ThreadID tid = 0; tid < numThreads; ++tid)
@@ -472,7 +477,7 @@ template <class Impl>
 void
 InstructionQueue<Impl>::drainSanityCheck() const
 {
-    assert(dependGraph.empty());
+    assert(dependGraph->empty());
     assert(instsToExecute.empty());
     for (ThreadID tid = 0; tid < numThreads; ++tid)
         memDepUnit[tid].drainSanityCheck();
@@ -562,17 +567,7 @@ template <class Impl>
 bool
 InstructionQueue<Impl>::hasReadyInsts()
 {
-    if (!listOrder.empty()) {
-        return true;
-    }
-
-    for (int i = 0; i < Num_OpClasses; ++i) {
-        if (!readyInsts[i].empty()) {
-            return true;
-        }
-    }
-
-    return false;
+    return readyOpClasses != 0;
 }
 
 template <class Impl>
@@ -695,56 +690,27 @@ InstructionQueue<Impl>::getInstToExecute()
 }
 
 template <class Impl>
-void
-InstructionQueue<Impl>::addToOrderList(OpClass op_class)
+OpClass
+InstructionQueue<Impl>::oldestReadyOpClass(uint64_t op_classes)
 {
-    assert(!readyInsts[op_class].empty());
+    assert(op_classes);
 
-    ListOrderEntry queue_entry;
+    OpClass oldest = (OpClass)ctz64(op_classes);
+    InstSeqNum oldest_num = readyInsts[oldest].top()->seqNum;
+    op_classes &= op_classes - 1;
 
-    queue_entry.queueType = op_class;
+    while (op_classes) {
+        OpClass op_class = (OpClass)ctz64(op_classes);
+        op_classes &= op_classes - 1;
 
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    ListOrderIt list_it = listOrder.begin();
-    ListOrderIt list_end_it = listOrder.end();
-
-    while (list_it != list_end_it) {
-        if ((*list_it).oldestInst > queue_entry.oldestInst) {
-            break;
+        const InstSeqNum seq_num = readyInsts[op_class].top()->seqNum;
+        if (seq_num < oldest_num) {
+            oldest = op_class;
+            oldest_num = seq_num;
         }
-
-        list_it++;
     }
 
-    readyIt[op_class] = listOrder.insert(list_it, queue_entry);
-    queueOnList[op_class] = true;
-}
-
-template <class Impl>
-void
-InstructionQueue<Impl>::moveToYoungerInst(ListOrderIt list_order_it)
-{
-    // Get iterator of next item on the list
-    // Delete the original iterator
-    // Determine if the next item is either the end of the list or younger
-    // than the new instruction.  If so, then add in a new iterator right here.
-    // If not, then move along.
-    ListOrderEntry queue_entry;
-    OpClass op_class = (*list_order_it).queueType;
-    ListOrderIt next_it = list_order_it;
-
-    ++next_it;
-
-    queue_entry.queueType = op_class;
-    queue_entry.oldestInst = readyInsts[op_class].top()->seqNum;
-
-    while (next_it != listOrder.end() &&
-           (*next_it).oldestInst < queue_entry.oldestInst) {
-        ++next_it;
-    }
-
-    readyIt[op_class] = listOrder.insert(next_it, queue_entry);
+    return oldest;
 }
 
 template <class Impl>
@@ -790,20 +756,20 @@ InstructionQueue<Impl>::scheduleReadyInsts()
         addReadyMemInst(mem_inst);
     }
 
-    // Have iterator to head of the list
-    // While I haven't exceeded bandwidth or reached the end of the list,
-    // Try to get a FU that can do what this op needs.
-    // If successful, change the oldestInst to the new top of the list, put
-    // the queue in the proper place in the list.
-    // Increment the iterator.
+    // While I haven't exceeded bandwidth or run out of op classes to try,
+    // pick the op class with the oldest ready instruction and try to get
+    // a FU that can do what this op needs.
+    // If successful, the op class stays a candidate with its next oldest
+    // instruction.
+    // Otherwise drop the op class for this cycle.
     // This will avoid trying to schedule a certain op class if there are no
     // FUs that handle it.
     int total_issued = 0;
-    ListOrderIt order_it = listOrder.begin();
-    ListOrderIt order_end_it = listOrder.end();
+    uint64_t candidates = readyOpClasses;
 
-    while (total_issued < totalWidth && order_it != order_end_it) {
-        OpClass op_class = (*order_it).queueType;
+    while (total_issued < totalWidth && candidates) {
+        OpClass op_class = oldestReadyOpClass(candidates);
+        const uint64_t op_class_bit = ULL(1) << op_class;
 
         assert(!readyInsts[op_class].empty());
 
@@ -817,20 +783,14 @@ InstructionQueue<Impl>::scheduleReadyInsts()
             intInstQueueReads++;
         }
 
-        assert(issuing_inst->seqNum == (*order_it).oldestInst);
-
         if (issuing_inst->isSquashed()) {
             readyInsts[op_class].pop();
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+            if (readyInsts[op_class].empty()) {
+                readyOpClasses &= ~op_class_bit;
+                candidates &= ~op_class_bit;
             }
 
-            listOrder.erase(order_it++);
-
             ++iqSquashedInstsIssued;
 
             continue;
@@ -892,19 +852,15 @@ InstructionQueue<Impl>::scheduleReadyInsts()
 
             readyInsts[op_class].pop();
 
-            if (!readyInsts[op_class].empty()) {
-                moveToYoungerInst(order_it);
-            } else {
-                readyIt[op_class] = listOrder.end();
-                queueOnList[op_class] = false;
+            if (readyInsts[op_class].empty()) {
+                readyOpClasses &= ~op_class_bit;
+                candidates &= ~op_class_bit;
             }
 
             issuing_inst->setIssued();
             ++total_issued;
 
-#if TRACING_ON
             issuing_inst->issueTick = curTick() - issuing_inst->fetchTick;
-#endif
 
             if (!issuing_inst->isMemRef()) {
                 // Memory instructions can not be freed from the IQ until they
@@ -916,12 +872,11 @@ InstructionQueue<Impl>::scheduleReadyInsts()
                 memDepUnit[tid].issue(issuing_inst);
             }
 
-            listOrder.erase(order_it++);
             statIssuedInstType[tid][op_class]++;
         } else {
             statFuBusy[op_class]++;
             fuBusy[tid]++;
-            ++order_it;
+            candidates &= ~op_class_bit;
         }
     }
 
@@ -974,11 +929,8 @@ InstructionQueue<Impl>::commit(const InstSeqNum &inst, ThreadID tid)
     DPRINTF(IQ, "[tid:%i] Committing instructions older than [sn:%llu]\n",
             tid,inst);
 
-    ListIt iq_it = instList[tid].begin();
-
-    while (iq_it != instList[tid].end() &&
-           (*iq_it)->seqNum <= inst) {
-        ++iq_it;
+    while (!instList[tid].empty() &&
+           instList[tid].front()->seqNum <= inst) {
         instList[tid].pop_front();
     }
 
@@ -1050,7 +1002,7 @@ InstructionQueue<Impl>::wakeDependents(const DynInstPtr &completed_inst)
 
         //Go through the dependency chain, marking the registers as
         //ready within the waiting instructions.
-        DynInstPtr dep_inst = dependGraph.pop(dest_reg->flatIndex());
+        DynInstPtr dep_inst = dependGraph->pop(dest_reg->flatIndex());
 
         while (dep_inst) {
             DPRINTF(IQ, "Waking up a dependent instruction, [sn:%llu] "
@@ -1064,15 +1016,15 @@ InstructionQueue<Impl>::wakeDependents(const DynInstPtr &completed_inst)
 
             addIfReady(dep_inst);
 
-            dep_inst = dependGraph.pop(dest_reg->flatIndex());
+            dep_inst = dependGraph->pop(dest_reg->flatIndex());
 
             ++dependents;
         }
 
         // Reset the head node now that all of its dependents have
         // been woken up.
-        assert(dependGraph.empty(dest_reg->flatIndex()));
-        dependGraph.clearInst(dest_reg->flatIndex());
+        assert(dependGraph->empty(dest_reg->flatIndex()));
+        dependGraph->clearInst(dest_reg->flatIndex());
 
         // Mark the scoreboard as having that register ready.
         regScoreboard[dest_reg->flatIndex()] = true;
@@ -1087,16 +1039,7 @@ InstructionQueue<Impl>::addReadyMemInst(const DynInstPtr &ready_inst)
     OpClass op_class = ready_inst->opClass();
 
     readyInsts[op_class].push(ready_inst);
-
-    // Will need to reorder the list if either a queue is not on the list,
-    // or it has an older instruction than last time.
-    if (!queueOnList[op_class]) {
-        addToOrderList(op_class);
-    } else if (readyInsts[op_class].top()->seqNum  <
-               (*readyIt[op_class]).oldestInst) {
-        listOrder.erase(readyIt[op_class]);
-        addToOrderList(op_class);
-    }
+    setReady(op_class);
 
     DPRINTF(IQ, "Instruction is ready to issue, putting it onto "
             "the ready list, PC %s opclass:%i [sn:%llu].\n",
@@ -1224,19 +1167,16 @@ template <class Impl>
 void
 InstructionQueue<Impl>::doSquash(ThreadID tid)
 {
-    // Start at the tail.
-    ListIt squash_it = instList[tid].end();
-    --squash_it;
-
     DPRINTF(IQ, "[tid:%i] Squashing until sequence number %i!\n",
             tid, squashedSeqNum[tid]);
 
     // Squash any instructions younger than the squashed sequence number
-    // given.
-    while (squash_it != instList[tid].end() &&
-           (*squash_it)->seqNum > squashedSeqNum[tid]) {
+    // given, starting at the tail.
+    while (!instList[tid].empty() &&
+           instList[tid].back()->seqNum > squashedSeqNum[tid]) {
 
-        DynInstPtr squashed_inst = (*squash_it);
+        DynInstPtr squashed_inst = std::move(instList[tid].back());
+        instList[tid].pop_back();
         if (squashed_inst->isFloating()) {
             fpInstQueueWrites++;
         } else if (squashed_inst->isVector()) {
@@ -1249,7 +1189,6 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
         // hasn't already been squashed in the IQ.
         if (squashed_inst->threadNumber != tid ||
             squashed_inst->isSquashedInIQ()) {
-            --squash_it;
             continue;
         }
 
@@ -1291,7 +1230,7 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
 
                     if (!squashed_inst->isReadySrcRegIdx(src_reg_idx) &&
                         !src_reg->isFixedMapping()) {
-                        dependGraph.remove(src_reg->flatIndex(),
+                        dependGraph->remove(src_reg->flatIndex(),
                                            squashed_inst);
                     }
 
@@ -1355,10 +1294,9 @@ InstructionQueue<Impl>::doSquash(ThreadID tid)
             if (dest_reg->isFixedMapping()){
                 continue;
             }
-            assert(dependGraph.empty(dest_reg->flatIndex()));
-            dependGraph.clearInst(dest_reg->flatIndex());
+            assert(dependGraph->empty(dest_reg->flatIndex()));
+            dependGraph->clearInst(dest_reg->flatIndex());
         }
-        instList[tid].erase(squash_it--);
         ++iqSquashedInstsExamined;
     }
 }
@@ -1392,7 +1330,7 @@ InstructionQueue<Impl>::addToDependents(const DynInstPtr &new_inst)
                         new_inst->pcState(), src_reg->index(),
                         src_reg->className());
 
-                dependGraph.insert(src_reg->flatIndex(), new_inst);
+                dependGraph->insert(src_reg->flatIndex(), new_inst);
 
                 // Change the return value to indicate that something
                 // was added to the dependency graph.
@@ -1433,14 +1371,14 @@ InstructionQueue<Impl>::addToProducers(const DynInstPtr &new_inst)
             continue;
         }
 
-        if (!dependGraph.empty(dest_reg->flatIndex())) {
-            dependGraph.dump();
+        if (!dependGraph->empty(dest_reg->flatIndex())) {
+            dependGraph->dump();
             panic("Dependency graph %i (%s) (flat: %i) not empty!",
                   dest_reg->index(), dest_reg->className(),
                   dest_reg->flatIndex());
         }
 
-        dependGraph.setInst(dest_reg->flatIndex(), new_inst);
+        dependGraph->setInst(dest_reg->flatIndex(), new_inst);
 
         // Mark the scoreboard to say it's not yet ready.
         regScoreboard[dest_reg->flatIndex()] = false;
@@ -1474,16 +1412,7 @@ InstructionQueue<Impl>::addIfReady(const DynInstPtr &inst)
                 inst->pcState(), op_class, inst->seqNum);
 
         readyInsts[op_class].push(inst);
-
-        // Will need to reorder the list if either a queue is not on the list,
-        // or it has an older instruction than last time.
-        if (!queueOnList[op_class]) {
-            addToOrderList(op_class);
-        } else if (readyInsts[op_class].top()->seqNum  <
-                   (*readyIt[op_class]).oldestInst) {
-            listOrder.erase(readyIt[op_class]);
-            addToOrderList(op_class);
-        }
+        setReady(op_class);
     }
 }
 
@@ -1519,18 +1448,12 @@ InstructionQueue<Impl>::dumpLists()
 
     cprintf("\n");
 
-    ListOrderIt list_order_it = listOrder.begin();
-    ListOrderIt list_order_end_it = listOrder.end();
-    int i = 1;
-
-    cprintf("List order: ");
-
-    while (list_order_it != list_order_end_it) {
-        cprintf("%i OpClass:%i [sn:%llu] ", i, (*list_order_it).queueType,
-                (*list_order_it).oldestInst);
+    cprintf("Ready op classes: ");
 
-        ++list_order_it;
-        ++i;
+    for (uint64_t mask = readyOpClasses; mask; mask &= mask - 1) {
+        const int op_class = ctz64(mask);
+        cprintf("OpClass:%i [sn:%llu] ", op_class,
+                readyInsts[op_class].top()->seqNum);
     }
 
     cprintf("\n");
@@ -1544,7 +1467,7 @@ InstructionQueue<Impl>::dumpInsts()
     for (ThreadID tid = 0; tid < numThreads; ++tid) {
         int num = 0;
         int valid_num = 0;
-        ListIt inst_list_it = instList[tid].begin();
+        InstDequeIt inst_list_it = instList[tid].begin();
 
         while (inst_list_it != instList[tid].end()) {
             cprintf("Instruction:%i\n", num);
@@ -1584,7 +1507,7 @@ InstructionQueue<Impl>::dumpInsts()
 
     int num = 0;
     int valid_num = 0;
-    ListIt inst_list_it = instsToExecute.begin();
+    InstDequeIt inst_list_it = instsToExecute.begin();
 
     while (inst_list_it != instsToExecute.end())
     {
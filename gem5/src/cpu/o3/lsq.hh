@@ -921,6 +921,15 @@ class LSQ
     /** Returns the number of instructions in the queues of one thread. */
     int getCount(ThreadID tid) { return thread.at(tid).getCount(); }
 
+    /** Returns the number of load packets of a thread waiting for the
+     * data cache.
+     */
+    unsigned
+    numLoadsInFlight(ThreadID tid) const
+    {
+        return thread.at(tid).numLoadsInFlight();
+    }
+
     /** Returns the total number of loads in the load queue. */
     int numLoads();
     /** Returns the total number of loads for a single thread. */
@@ -49,6 +49,7 @@
 #include <cstring>
 #include <map>
 #include <queue>
+#include <unordered_map>
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/generic/vec_reg.hh"
@@ -103,10 +104,16 @@ class LSQUnit
         uint32_t _size;
         /** Valid entry. */
         bool _valid;
+        /** Whether the entry is in the address index of its queue. */
+        bool _indexed;
+        /** First and last block the entry is indexed under. */
+        Addr _firstBlock;
+        Addr _lastBlock;
       public:
         /** Constructs an empty store queue entry. */
         LSQEntry()
-            : inst(nullptr), req(nullptr), _size(0), _valid(false)
+            : inst(nullptr), req(nullptr), _size(0), _valid(false),
+              _indexed(false), _firstBlock(0), _lastBlock(0)
         {
         }
 
@@ -129,6 +136,7 @@ class LSQUnit
             req = nullptr;
             _valid = false;
             _size = 0;
+            assert(!_indexed);
         }
 
         void
@@ -145,6 +153,12 @@ class LSQUnit
         /** Member accessors. */
         /** @{ */
         bool valid() const { return _valid; }
+        bool& indexed() { return _indexed; }
+        bool indexed() const { return _indexed; }
+        Addr& firstBlock() { return _firstBlock; }
+        Addr firstBlock() const { return _firstBlock; }
+        Addr& lastBlock() { return _lastBlock; }
+        Addr lastBlock() const { return _lastBlock; }
         uint32_t& size() { return _size; }
         const uint32_t& size() const { return _size; }
         const DynInstPtr& instruction() const { return inst; }
@@ -330,6 +344,9 @@ class LSQUnit
     /** Returns the number of instructions in the LSQ. */
     unsigned getCount() { return loads + stores; }
 
+    /** Returns the number of load packets waiting for the cache. */
+    unsigned numLoadsInFlight() const { return loadsInFlight; }
+
     /** Returns if there are any stores to writeback. */
     bool hasStoresToWB() { return storesToWB; }
 
@@ -483,6 +500,74 @@ class LSQUnit
      */
     unsigned depCheckShift;
 
+    /**
+     * Counts the entries of a queue that access each block of memory,
+     * so that the queue only has to be walked when one of its entries
+     * may overlap with an access.
+     */
+    class AddrIndex
+    {
+      private:
+        std::unordered_map<Addr, unsigned> blocks;
+
+      public:
+        void
+        insert(Addr first, Addr last)
+        {
+            for (Addr block = first; block <= last; ++block)
+                ++blocks[block];
+        }
+
+        void
+        remove(Addr first, Addr last)
+        {
+            for (Addr block = first; block <= last; ++block) {
+                auto it = blocks.find(block);
+                assert(it != blocks.end());
+                if (--it->second == 0)
+                    blocks.erase(it);
+            }
+        }
+
+        unsigned
+        count(Addr block) const
+        {
+            auto it = blocks.find(block);
+            return it == blocks.end() ? 0 : it->second;
+        }
+
+        void clear() { blocks.clear(); }
+    };
+
+    /** The number of places to shift addresses to get the block they
+     * are indexed under. At least a cache line, and at least as coarse
+     * as the dependency check.
+     */
+    unsigned indexShift;
+
+    /** Index of the addresses written by the stores in the SQ. */
+    AddrIndex storeIndex;
+
+    /** Index of the addresses read by the loads in the LQ. */
+    AddrIndex loadIndex;
+
+    /** Adds an entry to an address index, replacing the blocks it was
+     * previously indexed under.
+     */
+    void indexEntry(AddrIndex &index, LSQEntry &entry, Addr addr,
+                    unsigned size);
+
+    /** Removes an entry from an address index if it is in it. */
+    void unindexEntry(AddrIndex &index, LSQEntry &entry);
+
+    /** Checks whether any store in the SQ may write to the given range. */
+    bool storesMayOverlap(Addr addr, unsigned size) const;
+
+    /** Checks whether any load in the LQ, other than the given
+     * instruction itself, may read from the blocks it accesses.
+     */
+    bool loadsMayOverlap(const DynInstPtr &inst);
+
     /** Should loads be checked for dependency issues */
     bool checkLoads;
 
@@ -493,6 +578,9 @@ class LSQUnit
     /** The number of store instructions in the SQ waiting to writeback. */
     int storesToWB;
 
+    /** The number of load packets sent to the cache and not replied. */
+    unsigned loadsInFlight;
+
     /** The index of the first instruction that may be ready to be
      * written back, and has not yet been written back.
      */
@@ -618,6 +706,8 @@ LSQUnit<Impl>::read(LSQRequest *req, int load_idx)
     load_req.setRequest(req);
     assert(load_inst);
 
+    indexEntry(loadIndex, load_req, load_inst->effAddr, load_inst->effSize);
+
     assert(!load_inst->isExecuted());
 
     // Make sure this isn't a strictly ordered load
@@ -679,6 +769,11 @@ LSQUnit<Impl>::read(LSQRequest *req, int load_idx)
     // Check the SQ for any previous stores that might lead to forwarding
     auto store_it = load_inst->sqIt;
     assert (store_it >= storeWBIt);
+    // No store in the SQ writes to the blocks of the load
+    if (!storesMayOverlap(req->mainRequest()->getVaddr(),
+                          req->mainRequest()->getSize())) {
+        store_it = storeWBIt;
+    }
     // End once we've reached the top of the LSQ
     while (store_it != storeWBIt) {
         // Move the index to one younger
@@ -864,6 +959,10 @@ LSQUnit<Impl>::write(LSQRequest *req, uint8_t *data, int store_idx)
     storeQueue[store_idx].setRequest(req);
     unsigned size = req->_size;
     storeQueue[store_idx].size() = size;
+    if (size != 0) {
+        indexEntry(storeIndex, storeQueue[store_idx],
+                   storeQueue[store_idx].instruction()->effAddr, size);
+    }
     bool store_no_data =
         req->mainRequest()->getFlags() & Request::STORE_NO_DATA;
     storeQueue[store_idx].isAllZeros() = store_no_data;
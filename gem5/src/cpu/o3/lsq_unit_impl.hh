@@ -48,6 +48,7 @@
 
 #include "arch/generic/debugfaults.hh"
 #include "arch/locked_mem.hh"
+#include "base/intmath.hh"
 #include "base/str.hh"
 #include "config/the_isa.hh"
 #include "cpu/checker/cpu.hh"
@@ -56,7 +57,6 @@
 #include "debug/Activity.hh"
 #include "debug/IEW.hh"
 #include "debug/LSQUnit.hh"
-#include "debug/O3PipeView.hh"
 #include "mem/packet.hh"
 #include "mem/request.hh"
 
@@ -98,6 +98,10 @@ LSQUnit<Impl>::recvTimingResp(PacketPtr pkt)
     LSQRequest* req = senderState->request();
     assert(req != nullptr);
     bool ret = true;
+    if (senderState->isLoad) {
+        assert(loadsInFlight > 0);
+        --loadsInFlight;
+    }
     /* Check that the request is still alive before any further action. */
     if (senderState->alive()) {
         ret = req->recvTimingResp(pkt);
@@ -178,7 +182,7 @@ void
 LSQUnit<Impl>::resetState()
 {
     loads = stores = storesToWB = 0;
-
+    loadsInFlight = 0;
 
     storeWBIt = storeQueue.begin();
 
@@ -188,6 +192,11 @@ LSQUnit<Impl>::resetState()
     stalled = false;
 
     cacheBlockMask = ~(cpu->cacheLineSize() - 1);
+
+    indexShift = std::max<unsigned>(depCheckShift,
+                                    floorLog2(cpu->cacheLineSize()));
+    storeIndex.clear();
+    loadIndex.clear();
 }
 
 template<class Impl>
@@ -446,11 +455,71 @@ LSQUnit<Impl>::checkSnoop(PacketPtr pkt)
     return;
 }
 
+template <class Impl>
+void
+LSQUnit<Impl>::indexEntry(AddrIndex &index, LSQEntry &entry, Addr addr,
+                          unsigned size)
+{
+    unindexEntry(index, entry);
+
+    entry.firstBlock() = addr >> indexShift;
+    entry.lastBlock() = (addr + std::max(size, 1U) - 1) >> indexShift;
+    entry.indexed() = true;
+    index.insert(entry.firstBlock(), entry.lastBlock());
+}
+
+template <class Impl>
+void
+LSQUnit<Impl>::unindexEntry(AddrIndex &index, LSQEntry &entry)
+{
+    if (entry.indexed()) {
+        index.remove(entry.firstBlock(), entry.lastBlock());
+        entry.indexed() = false;
+    }
+}
+
+template <class Impl>
+bool
+LSQUnit<Impl>::storesMayOverlap(Addr addr, unsigned size) const
+{
+    Addr last = (addr + std::max(size, 1U) - 1) >> indexShift;
+    for (Addr block = addr >> indexShift; block <= last; ++block) {
+        if (storeIndex.count(block))
+            return true;
+    }
+    return false;
+}
+
+template <class Impl>
+bool
+LSQUnit<Impl>::loadsMayOverlap(const DynInstPtr &inst)
+{
+    // A load is in the index itself, so only count the other loads
+    const LQEntry *self = nullptr;
+    if (inst->isLoad() && loadQueue[inst->lqIdx].indexed())
+        self = &loadQueue[inst->lqIdx];
+
+    Addr last = (inst->effAddr + std::max(inst->effSize, 1U) - 1) >>
+        indexShift;
+    for (Addr block = inst->effAddr >> indexShift; block <= last; ++block) {
+        unsigned others = loadIndex.count(block);
+        if (self && block >= self->firstBlock() && block <= self->lastBlock())
+            --others;
+        if (others)
+            return true;
+    }
+    return false;
+}
+
 template <class Impl>
 Fault
 LSQUnit<Impl>::checkViolations(typename LoadQueue::iterator& loadIt,
         const DynInstPtr& inst)
 {
+    // No other load in the LQ reads from the blocks of the instruction
+    if (!loadsMayOverlap(inst))
+        return NoFault;
+
     Addr inst_eff_addr1 = inst->effAddr >> depCheckShift;
     Addr inst_eff_addr2 = (inst->effAddr + inst->effSize - 1) >> depCheckShift;
 
@@ -657,6 +726,7 @@ LSQUnit<Impl>::commitLoad()
     DPRINTF(LSQUnit, "Committing head load instruction, PC %s\n",
             loadQueue.front().instruction()->pcState());
 
+    unindexEntry(loadIndex, loadQueue.front());
     loadQueue.front().clear();
     loadQueue.pop_front();
 
@@ -865,6 +935,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
 
         // Clear the smart pointer to make sure it is decremented.
         loadQueue.back().instruction()->setSquashed();
+        unindexEntry(loadIndex, loadQueue.back());
         loadQueue.back().clear();
 
         --loads;
@@ -904,6 +975,7 @@ LSQUnit<Impl>::squash(const InstSeqNum &squashed_num)
         // Must delete request now that it wasn't handed off to
         // memory.  This is quite ugly.  @todo: Figure out the proper
         // place to really handle request deletes.
+        unindexEntry(storeIndex, storeQueue.back());
         storeQueue.back().clear();
         --stores;
 
@@ -1005,6 +1077,7 @@ LSQUnit<Impl>::completeStore(typename StoreQueue::iterator store_idx)
     DynInstPtr store_inst = store_idx->instruction();
     if (store_idx == storeQueue.begin()) {
         do {
+            unindexEntry(storeIndex, storeQueue.front());
             storeQueue.front().clear();
             storeQueue.pop_front();
             --stores;
@@ -1018,12 +1091,10 @@ LSQUnit<Impl>::completeStore(typename StoreQueue::iterator store_idx)
             "idx:%i\n",
             store_inst->seqNum, store_idx.idx() - 1, storeQueue.head() - 1);
 
-#if TRACING_ON
-    if (DTRACE(O3PipeView)) {
+    if (cpu->tracePipeline()) {
         store_inst->storeTick =
             curTick() - store_inst->fetchTick;
     }
-#endif
 
     if (isStalled() &&
         store_inst->seqNum == stallingStoreIsn) {
@@ -1077,6 +1148,8 @@ LSQUnit<Impl>::trySendPacket(bool isLoad, PacketPtr data_pkt)
         }
         lsq->cachePortBusy(isLoad);
         state->outstanding++;
+        if (state->isLoad)
+            ++loadsInFlight;
         state->request()->packetSent();
     } else {
         if (cache_got_blocked) {
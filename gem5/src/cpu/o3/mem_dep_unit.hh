@@ -43,11 +43,13 @@
 #ifndef __CPU_O3_MEM_DEP_UNIT_HH__
 #define __CPU_O3_MEM_DEP_UNIT_HH__
 
+#include <functional>
 #include <list>
 #include <memory>
 #include <set>
 #include <unordered_map>
 
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "cpu/inst_seq.hh"
 #include "debug/MemDepUnit.hh"
@@ -165,7 +167,7 @@ class MemDepUnit
     void dumpLists();
 
   private:
-    typedef typename std::list<DynInstPtr>::iterator ListIt;
+    typedef typename Impl::DynInstList::iterator ListIt;
 
     class MemDepEntry;
 
@@ -239,7 +241,19 @@ class MemDepUnit
     /** Moves an entry to the ready list. */
     inline void moveToReady(MemDepEntryPtr &ready_inst_entry);
 
-    typedef std::unordered_map<InstSeqNum, MemDepEntryPtr, SNHash> MemDepHash;
+    typedef std::unordered_map<InstSeqNum, MemDepEntryPtr, SNHash,
+                               std::equal_to<InstSeqNum>,
+                               PoolAllocator<std::pair<const InstSeqNum,
+                                                       MemDepEntryPtr>>>
+        MemDepHash;
+
+    /** Creates the entry of an instruction, from a pool of entries. */
+    static MemDepEntryPtr
+    makeEntry(const DynInstPtr &inst)
+    {
+        return std::allocate_shared<MemDepEntry>(
+            PoolAllocator<MemDepEntry>(), inst);
+    }
 
     typedef typename MemDepHash::iterator MemDepHashIt;
 
@@ -247,10 +261,10 @@ class MemDepUnit
     MemDepHash memDepHash;
 
     /** A list of all instructions in the memory dependence unit. */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    typename Impl::DynInstList instList[Impl::MaxThreads];
 
     /** A list of all instructions that are going to be replayed. */
-    std::list<DynInstPtr> instsToReplay;
+    typename Impl::DynInstList instsToReplay;
 
     /** The memory dependence predictor.  It is accessed upon new
      *  instructions being added to the IQ, and responds by telling
@@ -175,7 +175,7 @@ MemDepUnit<MemDepPred, Impl>::insert(const DynInstPtr &inst)
 {
     ThreadID tid = inst->threadNumber;
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
+    MemDepEntryPtr inst_entry = makeEntry(inst);
 
     // Add the MemDepEntry to the hash.
     memDepHash.insert(
@@ -272,7 +272,7 @@ MemDepUnit<MemDepPred, Impl>::insertNonSpec(const DynInstPtr &inst)
 {
     ThreadID tid = inst->threadNumber;
 
-    MemDepEntryPtr inst_entry = std::make_shared<MemDepEntry>(inst);
+    MemDepEntryPtr inst_entry = makeEntry(inst);
 
     // Insert the MemDepEntry into the hash.
     memDepHash.insert(
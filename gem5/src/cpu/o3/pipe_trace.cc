@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/o3/pipe_trace.hh"
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "config/have_protobuf.hh"
+#include "cpu/static_inst.hh"
+#include "sim/core.hh"
+
+#if HAVE_PROTOBUF
+#include "proto/o3_pipe_trace.pb.h"
+#include "proto/protoio.hh"
+#endif
+
+O3PipeTrace::O3PipeTrace(const std::string &filename,
+                         const std::string &obj_id, Tick clock_period)
+    : stream(nullptr)
+{
+#if HAVE_PROTOBUF
+    stream = new ProtoOutputStream(filename);
+
+    ProtoMessage::O3PipeHeader header;
+    header.set_obj_id(obj_id);
+    header.set_ver(0);
+    header.set_tick_freq(SimClock::Frequency);
+    header.set_clock_period(clock_period);
+    for (int i = 0; i < Enums::Num_OpClass; ++i)
+        header.add_op_class_names(Enums::OpClassStrings[i]);
+    stream->write(header);
+
+    // The CPU is never destroyed, so close the trace when we exit
+    Callback *cb = new MakeCallback<O3PipeTrace, &O3PipeTrace::close>(this);
+    registerExitCallback(cb);
+#else
+    fatal("%s: the pipeline trace requires gem5 to be built with "
+          "protobuf support.\n", obj_id);
+#endif
+}
+
+O3PipeTrace::~O3PipeTrace()
+{
+    close();
+}
+
+void
+O3PipeTrace::write(const Record &rec, const StaticInstPtr &inst)
+{
+#if HAVE_PROTOBUF
+    if (!stream)
+        return;
+
+    ProtoMessage::O3PipeRecord msg;
+    msg.set_seq_num(rec.seqNum);
+    msg.set_pc(rec.pc);
+    if (rec.upc)
+        msg.set_upc(rec.upc);
+    if (rec.tid)
+        msg.set_tid(rec.tid);
+    msg.set_op_class(rec.opClass);
+    if (rec.squashed)
+        msg.set_squashed(true);
+    msg.set_fetch(rec.fetch);
+
+    // -1 means the instruction never reached the stage
+    if (rec.decode != -1)
+        msg.set_decode(rec.decode);
+    if (rec.rename != -1)
+        msg.set_rename(rec.rename);
+    if (rec.dispatch != -1)
+        msg.set_dispatch(rec.dispatch);
+    if (rec.issue != -1)
+        msg.set_issue(rec.issue);
+    if (rec.complete != -1)
+        msg.set_complete(rec.complete);
+    if (rec.commit != -1)
+        msg.set_commit(rec.commit);
+    if (rec.store != -1)
+        msg.set_store(rec.store);
+
+    if (disassembled.emplace(rec.pc, rec.upc).second)
+        msg.set_disasm(inst->disassemble(rec.pc));
+
+    stream->write(msg);
+#endif
+}
+
+void
+O3PipeTrace::close()
+{
+#if HAVE_PROTOBUF
+    delete stream;
+    stream = nullptr;
+#endif
+}
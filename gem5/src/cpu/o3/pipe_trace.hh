@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_O3_PIPE_TRACE_HH__
+#define __CPU_O3_PIPE_TRACE_HH__
+
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "cpu/op_class.hh"
+#include "cpu/static_inst_fwd.hh"
+
+class ProtoOutputStream;
+
+/**
+ * Binary alternative to the O3PipeView debug output. Instead of
+ * printing several lines of text per instruction, the CPU writes one
+ * protobuf record per dynamic instruction with the same stage times
+ * to a (possibly gzipped) ProtoOutputStream, see o3_pipe_trace.proto.
+ * The trace can be displayed with util/o3-pipeview.py.
+ */
+class O3PipeTrace
+{
+  public:
+    /** Stage times of an instruction, in the format of the dyn inst. */
+    struct Record
+    {
+        InstSeqNum seqNum;
+        Addr pc;
+        MicroPC upc;
+        ThreadID tid;
+        OpClass opClass;
+        bool squashed;
+        Tick fetch;
+        int32_t decode;
+        int32_t rename;
+        int32_t dispatch;
+        int32_t issue;
+        int32_t complete;
+        int32_t commit;
+        int32_t store;
+    };
+
+    /**
+     * Open the trace file and write the header.
+     *
+     * @param filename Path of the trace, ending in .gz to compress it.
+     * @param obj_id Name of the CPU the trace is captured from.
+     * @param clock_period Clock period of the CPU in ticks.
+     */
+    O3PipeTrace(const std::string &filename, const std::string &obj_id,
+                Tick clock_period);
+
+    ~O3PipeTrace();
+
+    /**
+     * Write the record of an instruction. The disassembly is only
+     * generated the first time the pc/upc pair shows up.
+     */
+    void write(const Record &rec, const StaticInstPtr &inst);
+
+    /** Flush and close the trace, called when the simulation exits. */
+    void close();
+
+  private:
+    struct PCHash
+    {
+        size_t
+        operator()(const std::pair<Addr, MicroPC> &pc) const
+        {
+            return std::hash<Addr>()(pc.first ^ ((Addr)pc.second << 48));
+        }
+    };
+
+    /** Output stream, nullptr once the trace has been closed. */
+    ProtoOutputStream *stream;
+
+    /** Instructions already disassembled in the trace. */
+    std::unordered_set<std::pair<Addr, MicroPC>, PCHash> disassembled;
+};
+
+#endif // __CPU_O3_PIPE_TRACE_HH__
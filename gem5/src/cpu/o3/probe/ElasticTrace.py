@@ -62,3 +62,6 @@ class ElasticTrace(ProbeListenerObject):
     # Whether to trace virtual addresses for memory accesses
     traceVirtAddr = Param.Bool(False, "Set to true if virtual addresses are " \
                                 "to be traced.")
+    # Compress the traces in a separate host thread
+    traceWriteBehind = Param.Bool(True, "Set to true to compress the " \
+                                  "traces in a separate thread.")
@@ -41,6 +41,8 @@
 
 #include "cpu/o3/probe/elastic_trace.hh"
 
+#include <algorithm>
+
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
@@ -76,9 +78,11 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams* params)
                 "trace file path to dataDepTraceFile");
     std::string filename = simout.resolve(name() + "." +
                                             params->instFetchTraceFile);
-    instTraceStream = new ProtoOutputStream(filename);
+    instTraceStream = new ProtoOutputStream(filename,
+                                            params->traceWriteBehind);
     filename = simout.resolve(name() + "." + params->dataDepTraceFile);
-    dataTraceStream = new ProtoOutputStream(filename);
+    dataTraceStream = new ProtoOutputStream(filename,
+                                            params->traceWriteBehind);
     // Create a protobuf message for the header and write it to the stream
     ProtoMessage::PacketHeader inst_pkt_header;
     inst_pkt_header.set_obj_id(name());
@@ -91,6 +95,10 @@ ElasticTrace::ElasticTrace(const ElasticTraceParams* params)
     data_rec_header.set_tick_freq(SimClock::Frequency);
     data_rec_header.set_window_size(depWindowSize);
     dataTraceStream->write(data_rec_header);
+    // The temporary store holds the instructions in flight, the records
+    // of up to two windows are kept until they are written out
+    tempStore.reserve(depWindowSize);
+    traceInfoMap.reserve(2 * depWindowSize);
     // Register a callback to flush trace records and close the output streams.
     Callback* cb = new MakeCallback<ElasticTrace,
         &ElasticTrace::flushTraces>(this);
@@ -262,7 +270,11 @@ ElasticTrace::updateRegDep(const DynInstConstPtr& dyn_inst)
                 // replay.
                 if (seq_num - last_writer < depWindowSize) {
                     // Record a physical register dependency.
-                    exec_info_ptr->physRegDepSet.insert(last_writer);
+                    auto &deps = exec_info_ptr->physRegDepSet;
+                    auto pos = std::lower_bound(deps.begin(), deps.end(),
+                                                last_writer);
+                    if (pos == deps.end() || *pos != last_writer)
+                        deps.insert(pos, last_writer);
                 }
             }
 
@@ -443,17 +455,14 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
     }
 
     // Assign the register dependencies stored in the execution info object
-    std::set<InstSeqNum>::const_iterator dep_set_it;
-    for (dep_set_it = (exec_info_ptr->physRegDepSet).begin();
-         dep_set_it != (exec_info_ptr->physRegDepSet).end();
-         ++dep_set_it) {
-        auto trace_info_itr = traceInfoMap.find(*dep_set_it);
+    for (const InstSeqNum reg_dep_sn : exec_info_ptr->physRegDepSet) {
+        auto trace_info_itr = traceInfoMap.find(reg_dep_sn);
         if (trace_info_itr != traceInfoMap.end()) {
             // The register dependency is valid. Assign it and calculate
             // computational delay
-            new_record->physRegDepList.push_back(*dep_set_it);
+            new_record->physRegDepList.push_back(reg_dep_sn);
             DPRINTF(ElasticTrace, "Inst %lli has register dependency on "
-                    "%lli\n", new_record->instNum, *dep_set_it);
+                    "%lli\n", new_record->instNum, reg_dep_sn);
             TraceInfo* reg_dep = trace_info_itr->second;
             reg_dep->numDepts++;
             compDelayPhysRegDep(reg_dep, new_record);
@@ -470,7 +479,7 @@ ElasticTrace::addDepTraceRecord(const DynInstConstPtr& head_inst,
             // picked up by the commit probe listener. But a request is not
             // issued and registers are not written to in these cases.
             DPRINTF(ElasticTrace, "Inst %lli has register dependency on "
-                    "%lli is skipped\n",new_record->instNum, *dep_set_it);
+                    "%lli is skipped\n",new_record->instNum, reg_dep_sn);
         }
     }
 
@@ -824,8 +833,9 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             DPRINTFR(ElasticTrace, "\thas computational delay %lli\n",
                      temp_ptr->compDelay);
 
-            // Create a protobuf message for the dependency record
-            ProtoMessage::InstDepRecord dep_pkt;
+            // Fill in the protobuf message for the dependency record
+            ProtoMessage::InstDepRecord &dep_pkt = depRecord;
+            dep_pkt.Clear();
             dep_pkt.set_seq_num(temp_ptr->instNum);
             dep_pkt.set_type(temp_ptr->type);
             dep_pkt.set_pc(temp_ptr->pc);
@@ -844,20 +854,18 @@ ElasticTrace::writeDepTrace(uint32_t num_to_write)
             if (temp_ptr->robDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no order (rob) dependencies\n");
             }
-            while (!temp_ptr->robDepList.empty()) {
+            for (const InstSeqNum rob_dep : temp_ptr->robDepList) {
                 DPRINTFR(ElasticTrace, "\thas order (rob) dependency on %lli\n",
-                         temp_ptr->robDepList.front());
-                dep_pkt.add_rob_dep(temp_ptr->robDepList.front());
-                temp_ptr->robDepList.pop_front();
+                         rob_dep);
+                dep_pkt.add_rob_dep(rob_dep);
             }
             if (temp_ptr->physRegDepList.empty()) {
                 DPRINTFR(ElasticTrace, "\thas no register dependencies\n");
             }
-            while (!temp_ptr->physRegDepList.empty()) {
+            for (const InstSeqNum reg_dep : temp_ptr->physRegDepList) {
                 DPRINTFR(ElasticTrace, "\thas register dependency on %lli\n",
-                         temp_ptr->physRegDepList.front());
-                dep_pkt.add_reg_dep(temp_ptr->physRegDepList.front());
-                temp_ptr->physRegDepList.pop_front();
+                         reg_dep);
+                dep_pkt.add_reg_dep(reg_dep);
             }
             if (num_filtered_nodes != 0) {
                 // Set the weight of this node as the no. of filtered nodes
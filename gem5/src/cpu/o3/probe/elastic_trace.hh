@@ -50,10 +50,11 @@
 #ifndef __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 #define __CPU_O3_PROBE_ELASTIC_TRACE_HH__
 
-#include <set>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "base/pool_alloc.hh"
 #include "cpu/o3/dyn_inst.hh"
 #include "cpu/o3/impl.hh"
 #include "mem/request.hh"
@@ -197,7 +198,7 @@ class ElasticTrace : public ProbeListenerObject
      * @defgroup InstExecInfo Struct for storing information before an
      * instruction reaches the commit stage, e.g. execute timestamp.
      */
-    struct InstExecInfo
+    struct InstExecInfo : public PoolAllocated<InstExecInfo>
     {
         /**
          * @ingroup InstExecInfo
@@ -211,10 +212,12 @@ class ElasticTrace : public ProbeListenerObject
          */
         Tick toCommitTick;
         /**
-         * Set of instruction sequence numbers that this instruction depends on
-         * due to Read After Write data dependency based on physical register.
+         * Sorted set of instruction sequence numbers that this instruction
+         * depends on due to Read After Write data dependency based on
+         * physical register. An instruction has a handful of source
+         * registers at most, so this is a vector rather than a tree.
          */
-        std::set<InstSeqNum> physRegDepSet;
+        std::vector<InstSeqNum> physRegDepSet;
         /** @} */
 
         /** Constructor */
@@ -256,7 +259,7 @@ class ElasticTrace : public ProbeListenerObject
      * of records for writing to the output trace and not as a tree data
      * structure.
      */
-    struct TraceInfo
+    struct TraceInfo : public PoolAllocated<TraceInfo>
     {
         /**
          * @ingroup TraceInfo
@@ -275,9 +278,9 @@ class ElasticTrace : public ProbeListenerObject
         /* If instruction was committed, as against squashed. */
         bool commit;
         /* List of order dependencies. */
-        std::list<InstSeqNum> robDepList;
+        std::vector<InstSeqNum> robDepList;
         /* List of physical register RAW dependencies. */
-        std::list<InstSeqNum> physRegDepList;
+        std::vector<InstSeqNum> physRegDepList;
         /**
          * Computational delay after the last dependent inst. completed.
          * A value of -1 which means instruction has no dependencies.
@@ -339,6 +342,12 @@ class ElasticTrace : public ProbeListenerObject
      */
     std::unordered_map<InstSeqNum, TraceInfo*> traceInfoMap;
 
+    /**
+     * Message the dependency records are encoded in, kept around so that
+     * the storage of its repeated fields is reused.
+     */
+    ProtoMessage::InstDepRecord depRecord;
+
     /** Typedef of iterator to the instruction dependency trace. */
     typedef typename std::vector<TraceInfo*>::iterator depTraceItr;
 
@@ -44,8 +44,10 @@
 #ifndef __CPU_O3_RENAME_HH__
 #define __CPU_O3_RENAME_HH__
 
+#include <deque>
 #include <list>
 #include <utility>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "config/the_isa.hh"
@@ -201,6 +203,11 @@ class DefaultRename
      */
     void tick();
 
+    /** Records the stats of cycles the CPU skipped while the pipeline
+     *  was stalled, as tick() would have done for each of them.
+     */
+    void creditStalledCycles(Cycles cycles);
+
     /** Debugging function used to dump history buffer of renamings. */
     void dumpHistory();
 
@@ -254,12 +261,34 @@ class DefaultRename
     /** Removes a committed instruction's rename history. */
     void removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid);
 
+    /** Takes a rename checkpoint after renaming a branch, if there is
+     * one available.
+     */
+    void takeCheckpoint(const DynInstPtr &inst, ThreadID tid);
+
+    /** Discards the youngest rename checkpoint of a thread. */
+    void dropCheckpoint(ThreadID tid);
+
+    /** Undoes the renames of the instructions younger than the oldest
+     * checkpoint at or after the squashing instruction, if there is
+     * one, so that doSquash() only has to walk the renames between
+     * the two.
+     */
+    void restoreCheckpoint(const InstSeqNum &squash_seq_num, ThreadID tid);
+
     /** Renames the source registers of an instruction. */
     inline void renameSrcRegs(const DynInstPtr &inst, ThreadID tid);
 
     /** Renames the destination registers of an instruction. */
     inline void renameDestRegs(const DynInstPtr &inst, ThreadID tid);
 
+    /**
+     * Looks up the value of an instruction in the value predictor,
+     * and makes its destination register ready if the predictor is
+     * confident, so that the dependents can issue right away.
+     */
+    void predictValue(const DynInstPtr &inst, ThreadID tid);
+
     /** Calculates the number of free ROB entries for a specific thread. */
     inline int calcFreeROBEntries(ThreadID tid);
 
@@ -321,9 +350,37 @@ class DefaultRename
     };
 
     /** A per-thread list of all destination register renames, used to either
-     * undo rename mappings or free old physical registers.
+     * undo rename mappings or free old physical registers. The youngest
+     * renames are at the front.
      */
-    std::list<RenameHistory> historyBuffer[Impl::MaxThreads];
+    std::deque<RenameHistory> historyBuffer[Impl::MaxThreads];
+
+    /** The rename map and free list saved after renaming a branch. */
+    struct RenameCheckpoint
+    {
+        /** The sequence number of the branch. */
+        InstSeqNum instSeqNum;
+        /** The mappings after renaming the branch. */
+        typename RenameMap::Checkpoint map;
+        /** The state of the free list after renaming the branch. */
+        typename FreeList::Checkpoint freeList;
+    };
+
+    /** Per-thread rings of rename checkpoints, in program order. */
+    std::vector<RenameCheckpoint> checkpoints[Impl::MaxThreads];
+
+    /** The position of the oldest checkpoint of each thread. */
+    unsigned checkpointHead[Impl::MaxThreads];
+
+    /** The number of checkpoints in use by each thread. */
+    unsigned checkpointCount[Impl::MaxThreads];
+
+    /** Returns the i-th oldest checkpoint of a thread. */
+    RenameCheckpoint &
+    checkpoint(ThreadID tid, unsigned i)
+    {
+        return checkpoints[tid][(checkpointHead[tid] + i) % numCheckpoints];
+    }
 
     /** Pointer to CPU. */
     O3CPU *cpu;
@@ -464,6 +521,9 @@ class DefaultRename
     /** The number of threads active in rename. */
     ThreadID numThreads;
 
+    /** The number of rename checkpoints of each thread. */
+    const unsigned numCheckpoints;
+
     /** The maximum skid buffer size. */
     unsigned skidBufferMax;
 
@@ -522,6 +582,8 @@ class DefaultRename
     Stats::Scalar renameCommittedMaps;
     /** Stat for total number of mappings that were undone due to a squash. */
     Stats::Scalar renameUndoneMaps;
+    /** Stat for number of squashes undone from a rename checkpoint. */
+    Stats::Scalar renameCheckpointRestores;
     /** Number of serialize instructions handled. */
     Stats::Scalar renamedSerializing;
     /** Number of instructions marked as temporarily serializing. */
@@ -45,6 +45,7 @@
 #ifndef __CPU_O3_RENAME_IMPL_HH__
 #define __CPU_O3_RENAME_IMPL_HH__
 
+#include <algorithm>
 #include <list>
 
 #include "arch/isa_traits.hh"
@@ -54,7 +55,6 @@
 #include "cpu/reg_class.hh"
 #include "debug/Activity.hh"
 #include "debug/Rename.hh"
-#include "debug/O3PipeView.hh"
 #include "params/DerivO3CPU.hh"
 
 using namespace std;
@@ -67,13 +67,19 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
       commitToRenameDelay(params->commitToRenameDelay),
       renameWidth(params->renameWidth),
       commitWidth(params->commitWidth),
-      numThreads(params->numThreads)
+      numThreads(params->numThreads),
+      numCheckpoints(params->renameCheckpoints)
 {
     if (renameWidth > Impl::MaxWidth)
         fatal("renameWidth (%d) is larger than compiled limit (%d),\n"
              "\tincrease MaxWidth in src/cpu/o3/impl.hh\n",
              renameWidth, static_cast<int>(Impl::MaxWidth));
 
+    // The free list is shared by all the threads, so restoring it
+    // would also undo the renames of the other threads
+    fatal_if(numCheckpoints && numThreads > 1,
+             "Rename checkpoints are only supported with a single thread");
+
     // @todo: Make into a parameter.
     skidBufferMax = (decodeToRenameDelay + 1) * params->decodeWidth;
     for (uint32_t tid = 0; tid < Impl::MaxThreads; tid++) {
@@ -87,6 +93,9 @@ DefaultRename<Impl>::DefaultRename(O3CPU *_cpu, DerivO3CPUParams *params)
         stalls[tid] = {false, false};
         serializeInst[tid] = nullptr;
         serializeOnNextInst[tid] = false;
+        checkpoints[tid].resize(numCheckpoints);
+        checkpointHead[tid] = 0;
+        checkpointCount[tid] = 0;
     }
 }
 
@@ -169,6 +178,10 @@ DefaultRename<Impl>::regStats()
         .name(name() + ".UndoneMaps")
         .desc("Number of HB maps that are undone due to squashing")
         .prereq(renameUndoneMaps);
+    renameCheckpointRestores
+        .name(name() + ".CheckpointRestores")
+        .desc("Number of squashes undone from a rename checkpoint")
+        .prereq(renameCheckpointRestores);
     renamedSerializing
         .name(name() + ".serializingInsts")
         .desc("count of serializing insts renamed")
@@ -303,6 +316,9 @@ DefaultRename<Impl>::resetStage()
         storesInProgress[tid] = 0;
 
         serializeOnNextInst[tid] = false;
+
+        checkpointHead[tid] = 0;
+        checkpointCount[tid] = 0;
     }
 }
 
@@ -421,9 +437,30 @@ DefaultRename<Impl>::squash(const InstSeqNum &squash_seq_num, ThreadID tid)
     // Clear the skid buffer in case it has any data in it.
     skidBuffer[tid].clear();
 
+    if (cpu->valuePred)
+        cpu->valuePred->squash(tid, squash_seq_num);
+
     doSquash(squash_seq_num, tid);
 }
 
+template <class Impl>
+void
+DefaultRename<Impl>::creditStalledCycles(Cycles cycles)
+{
+    for (ThreadID tid : *activeThreads) {
+        if (renameStatus[tid] == Blocked) {
+            renameBlockCycles += cycles;
+        } else if (renameStatus[tid] == Squashing) {
+            renameSquashCycles += cycles;
+        } else if (renameStatus[tid] == SerializeStall) {
+            renameSerializeStallCycles += cycles;
+        } else if (renameStatus[tid] == Running ||
+                   renameStatus[tid] == Idle) {
+            renameIdleCycles += cycles;
+        }
+    }
+}
+
 template <class Impl>
 void
 DefaultRename<Impl>::tick()
@@ -756,6 +793,12 @@ DefaultRename<Impl>::renameInsts(ThreadID tid)
 
         renameDestRegs(inst, inst->threadNumber);
 
+        if (cpu->valuePred)
+            predictValue(inst, inst->threadNumber);
+
+        if (numCheckpoints && inst->isControl())
+            takeCheckpoint(inst, tid);
+
         if (inst->isAtomic() || inst->isStore()) {
             storesInProgress[tid]++;
         } else if (inst->isLoad()) {
@@ -841,11 +884,9 @@ DefaultRename<Impl>::sortInsts()
     for (int i = 0; i < insts_from_decode; ++i) {
         const DynInstPtr &inst = fromDecode->insts[i];
         insts[inst->threadNumber].push_back(inst);
-#if TRACING_ON
-        if (DTRACE(O3PipeView)) {
+        if (cpu->tracePipeline()) {
             inst->renameTick = curTick() - inst->fetchTick;
         }
-#endif
     }
 }
 
@@ -964,16 +1005,17 @@ template <class Impl>
 void
 DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 {
-    typename std::list<RenameHistory>::iterator hb_it =
-        historyBuffer[tid].begin();
+    // Listeners have to see every squashed mapping
+    if (checkpointCount[tid] && !ppSquashInRename->hasListeners())
+        restoreCheckpoint(squashed_seq_num, tid);
 
     // After a syscall squashes everything, the history buffer may be empty
     // but the ROB may still be squashing instructions.
     // Go through the most recent instructions, undoing the mappings
     // they did and freeing up the registers.
     while (!historyBuffer[tid].empty() &&
-           hb_it->instSeqNum > squashed_seq_num) {
-        assert(hb_it != historyBuffer[tid].end());
+           historyBuffer[tid].front().instSeqNum > squashed_seq_num) {
+        const RenameHistory *hb_it = &historyBuffer[tid].front();
 
         DPRINTF(Rename, "[tid:%i] Removing history entry with sequence "
                 "number %i (archReg: %d, newPhysReg: %d, prevPhysReg: %d).\n",
@@ -997,17 +1039,92 @@ DefaultRename<Impl>::doSquash(const InstSeqNum &squashed_seq_num, ThreadID tid)
 
         // Notify potential listeners that the register mapping needs to be
         // removed because the instruction it was mapped to got squashed. Note
-        // that this is done before hb_it is incremented.
+        // that this is done before hb_it is removed.
         ppSquashInRename->notify(std::make_pair(hb_it->instSeqNum,
                                                 hb_it->newPhysReg));
 
-        historyBuffer[tid].erase(hb_it++);
+        historyBuffer[tid].pop_front();
 
         ++renameUndoneMaps;
     }
 
     // Check if we need to change vector renaming mode after squashing
+    auto vec_mode = renameMap[tid]->vecRenameMode();
     cpu->switchRenameMode(tid, freeList);
+
+    // The checkpoints only hold the vector mappings of their mode
+    if (renameMap[tid]->vecRenameMode() != vec_mode)
+        checkpointCount[tid] = 0;
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::takeCheckpoint(const DynInstPtr &inst, ThreadID tid)
+{
+    if (checkpointCount[tid] == numCheckpoints)
+        return;
+
+    RenameCheckpoint *prev = checkpointCount[tid] ?
+        &checkpoint(tid, checkpointCount[tid] - 1) : nullptr;
+    RenameCheckpoint &cp = checkpoint(tid, checkpointCount[tid]);
+
+    cp.instSeqNum = inst->seqNum;
+    renameMap[tid]->saveCheckpoint(cp.map);
+    freeList->saveCheckpoint(cp.freeList, prev ? &prev->freeList : nullptr);
+    ++checkpointCount[tid];
+
+    DPRINTF(Rename, "[tid:%i] [sn:%llu] Took a rename checkpoint (%i in "
+            "use).\n", tid, inst->seqNum, checkpointCount[tid]);
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::dropCheckpoint(ThreadID tid)
+{
+    assert(checkpointCount[tid]);
+    --checkpointCount[tid];
+    freeList->dropCheckpoint(checkpointCount[tid] ?
+        &checkpoint(tid, checkpointCount[tid] - 1).freeList : nullptr);
+}
+
+template <class Impl>
+void
+DefaultRename<Impl>::restoreCheckpoint(const InstSeqNum &squashed_seq_num,
+                                       ThreadID tid)
+{
+    unsigned idx = 0;
+    while (idx < checkpointCount[tid] &&
+           checkpoint(tid, idx).instSeqNum < squashed_seq_num) {
+        ++idx;
+    }
+    if (idx == checkpointCount[tid])
+        return;
+
+    while (checkpointCount[tid] > idx + 1)
+        dropCheckpoint(tid);
+
+    const RenameCheckpoint &cp = checkpoint(tid, idx);
+    DPRINTF(Rename, "[tid:%i] Restoring the rename checkpoint of [sn:%llu]."
+            "\n", tid, cp.instSeqNum);
+
+    renameMap[tid]->restoreCheckpoint(cp.map);
+    freeList->restoreCheckpoint(cp.freeList);
+
+    // Forget the renames of the instructions after the branch, the
+    // ones between the squashing instruction and the branch are
+    // still undone one by one.
+    auto &hb = historyBuffer[tid];
+    const InstSeqNum cp_seq_num = cp.instSeqNum;
+    auto hb_end = std::partition_point(hb.begin(), hb.end(),
+        [cp_seq_num](const RenameHistory &entry)
+        { return entry.instSeqNum > cp_seq_num; });
+    renameUndoneMaps += hb_end - hb.begin();
+    hb.erase(hb.begin(), hb_end);
+    ++renameCheckpointRestores;
+
+    // The branch itself is squashed too
+    if (cp_seq_num > squashed_seq_num)
+        dropCheckpoint(tid);
 }
 
 template<class Impl>
@@ -1018,15 +1135,17 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
             "history buffer %u (size=%i), until [sn:%llu].\n",
             tid, tid, historyBuffer[tid].size(), inst_seq_num);
 
-    typename std::list<RenameHistory>::iterator hb_it =
-        historyBuffer[tid].end();
-
-    --hb_it;
+    // A squash can't go back past a committed branch
+    while (checkpointCount[tid] &&
+           checkpoint(tid, 0).instSeqNum <= inst_seq_num) {
+        checkpointHead[tid] = (checkpointHead[tid] + 1) % numCheckpoints;
+        --checkpointCount[tid];
+    }
 
     if (historyBuffer[tid].empty()) {
         DPRINTF(Rename, "[tid:%i] History buffer is empty.\n", tid);
         return;
-    } else if (hb_it->instSeqNum > inst_seq_num) {
+    } else if (historyBuffer[tid].back().instSeqNum > inst_seq_num) {
         DPRINTF(Rename, "[tid:%i] [sn:%llu] "
                 "Old sequence number encountered. "
                 "Ensure that a syscall happened recently.\n",
@@ -1039,8 +1158,8 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
     // rename histories if they did not have destination registers that were
     // renamed.
     while (!historyBuffer[tid].empty() &&
-           hb_it != historyBuffer[tid].end() &&
-           hb_it->instSeqNum <= inst_seq_num) {
+           historyBuffer[tid].back().instSeqNum <= inst_seq_num) {
+        const RenameHistory *hb_it = &historyBuffer[tid].back();
 
         DPRINTF(Rename, "[tid:%i] Freeing up older rename of reg %i (%s), "
                 "[sn:%llu].\n",
@@ -1057,7 +1176,7 @@ DefaultRename<Impl>::removeFromHistory(InstSeqNum inst_seq_num, ThreadID tid)
 
         ++renameCommittedMaps;
 
-        historyBuffer[tid].erase(hb_it--);
+        historyBuffer[tid].pop_back();
     }
 }
 
@@ -1182,6 +1301,39 @@ DefaultRename<Impl>::renameDestRegs(const DynInstPtr &inst, ThreadID tid)
     }
 }
 
+template <class Impl>
+void
+DefaultRename<Impl>::predictValue(const DynInstPtr &inst, ThreadID tid)
+{
+    VPredUnit *vpred = cpu->valuePred;
+
+    // Only the instructions that write a single integer register and
+    // that can be replayed by squashing the younger ones are predicted
+    if (inst->numDestRegs() != 1 || inst->isControl() || inst->isStore() ||
+        inst->isAtomic() || inst->isNonSpeculative() ||
+        inst->isSerializing() || (vpred->loadsOnly() && !inst->isLoad())) {
+        return;
+    }
+
+    const RegId &dest_reg = inst->flattenedDestRegIdx(0);
+    if (!dest_reg.isIntReg() || dest_reg.isZeroReg())
+        return;
+
+    RegVal value;
+    const bool confident = vpred->predict(tid, inst->seqNum,
+                                          inst->instAddr(), value);
+    inst->setValuePrediction(value, confident);
+    if (!confident)
+        return;
+
+    DPRINTF(Rename, "[tid:%i] [sn:%llu] Forwarding predicted value %#x "
+            "to the dependents.\n", tid, inst->seqNum, value);
+
+    PhysRegIdPtr phys_reg = inst->renamedDestRegIdx(0);
+    cpu->setIntReg(phys_reg, value);
+    scoreboard->setReg(phys_reg);
+}
+
 template <class Impl>
 inline int
 DefaultRename<Impl>::calcFreeROBEntries(ThreadID tid)
@@ -1469,7 +1621,7 @@ template <class Impl>
 void
 DefaultRename<Impl>::dumpHistory()
 {
-    typename std::list<RenameHistory>::iterator buf_it;
+    typename std::deque<RenameHistory>::iterator buf_it;
 
     for (ThreadID tid = 0; tid < numThreads; tid++) {
 
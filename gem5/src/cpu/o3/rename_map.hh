@@ -65,8 +65,9 @@
  */
 class SimpleRenameMap
 {
-  private:
+  public:
     using Arch2PhysMap = std::vector<PhysRegIdPtr>;
+  private:
     /** The acutal arch-to-phys register map */
     Arch2PhysMap map;
   public:
@@ -142,6 +143,17 @@ class SimpleRenameMap
         map[arch_reg.flatIndex()] = phys_reg;
     }
 
+    /** Saves the mappings into a rename checkpoint. */
+    void save(Arch2PhysMap &cp) const { cp = map; }
+
+    /** Restores the mappings of a rename checkpoint. */
+    void
+    restore(const Arch2PhysMap &cp)
+    {
+        assert(cp.size() == map.size());
+        map = cp;
+    }
+
     /** Return the number of free entries on the associated free list. */
     unsigned numFreeEntries() const { return freeList->numFreeRegs(); }
 
@@ -205,6 +217,20 @@ class UnifiedRenameMap
 
     typedef SimpleRenameMap::RenameInfo RenameInfo;
 
+    /**
+     * The mappings saved with a rename checkpoint. Only the vector map
+     * of the current renaming mode is saved.
+     */
+    struct Checkpoint
+    {
+        SimpleRenameMap::Arch2PhysMap intMap;
+        SimpleRenameMap::Arch2PhysMap floatMap;
+        SimpleRenameMap::Arch2PhysMap vecMap;
+        SimpleRenameMap::Arch2PhysMap predMap;
+        SimpleRenameMap::Arch2PhysMap ccMap;
+        VecMode vecMode;
+    };
+
     /** Default constructor.  init() must be called prior to use. */
     UnifiedRenameMap() : regFile(nullptr) {};
 
@@ -390,6 +416,39 @@ class UnifiedRenameMap
             vecPredRegs <= predMap.numFreeEntries() &&
             ccRegs <= ccMap.numFreeEntries();
     }
+    /** Saves all the mappings into a rename checkpoint. */
+    void
+    saveCheckpoint(Checkpoint &cp) const
+    {
+        intMap.save(cp.intMap);
+        floatMap.save(cp.floatMap);
+        if (vecMode == Enums::Full)
+            vecMap.save(cp.vecMap);
+        else
+            vecElemMap.save(cp.vecMap);
+        predMap.save(cp.predMap);
+        ccMap.save(cp.ccMap);
+        cp.vecMode = vecMode;
+    }
+
+    /** Restores all the mappings of a rename checkpoint. */
+    void
+    restoreCheckpoint(const Checkpoint &cp)
+    {
+        assert(cp.vecMode == vecMode);
+        intMap.restore(cp.intMap);
+        floatMap.restore(cp.floatMap);
+        if (vecMode == Enums::Full)
+            vecMap.restore(cp.vecMap);
+        else
+            vecElemMap.restore(cp.vecMap);
+        predMap.restore(cp.predMap);
+        ccMap.restore(cp.ccMap);
+    }
+
+    /** Returns the current vector renaming mode. */
+    VecMode vecRenameMode() const { return vecMode; }
+
     /**
      * Set vector mode to Full or Elem.
      * Ignore 'silent' modifications.
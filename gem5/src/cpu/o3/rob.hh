@@ -49,6 +49,7 @@
 #include <vector>
 
 #include "arch/registers.hh"
+#include "base/circular_queue.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
 #include "enums/SMTQueuePolicy.hh"
@@ -67,7 +68,8 @@ class ROB
     typedef typename Impl::DynInstPtr DynInstPtr;
 
     typedef std::pair<RegIndex, PhysRegIndex> UnmapInfo;
-    typedef typename std::list<DynInstPtr>::iterator InstIt;
+    typedef CircularQueue<DynInstPtr> InstList;
+    typedef typename InstList::iterator InstIt;
 
     /** Possible ROB statuses. */
     enum Status {
@@ -282,8 +284,11 @@ class ROB
     /** Max Insts a Thread Can Have in the ROB */
     unsigned maxEntries[Impl::MaxThreads];
 
-    /** ROB List of Instructions */
-    std::list<DynInstPtr> instList[Impl::MaxThreads];
+    /** ROB List of Instructions. Each thread is strictly FIFO, so
+     *  the instructions are kept in a ring as large as the whole
+     *  ROB, which no thread can ever overflow.
+     */
+    std::vector<InstList> instList;
 
     /** Number of instructions that can be squashed in a single cycle. */
     unsigned squashWidth;
@@ -59,6 +59,7 @@ ROB<Impl>::ROB(O3CPU *_cpu, DerivO3CPUParams *params)
     : robPolicy(params->smtROBPolicy),
       cpu(_cpu),
       numEntries(params->numROBEntries),
+      instList(Impl::MaxThreads, InstList(numEntries)),
       squashWidth(params->squashWidth),
       numInstsInROB(0),
       numThreads(params->numThreads)
@@ -246,11 +247,10 @@ ROB<Impl>::retireHead(ThreadID tid)
 
     assert(numInstsInROB > 0);
 
-    // Get the head ROB instruction by copying it and remove it from the list
-    InstIt head_it = instList[tid].begin();
-
-    DynInstPtr head_inst = std::move(*head_it);
-    instList[tid].erase(head_it);
+    // Get the head ROB instruction and remove it from the ring. Moving
+    // it out also drops the reference held by the now free slot.
+    DynInstPtr head_inst = std::move(instList[tid].front());
+    instList[tid].pop_front();
 
     assert(head_inst->readyToCommit());
 
@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/o3/smt_fetch_policy.hh"
+
+#include "params/BrCountFetchPolicy.hh"
+#include "params/ICountFetchPolicy.hh"
+#include "params/IQCountFetchPolicy.hh"
+#include "params/LSQCountFetchPolicy.hh"
+#include "params/MissCountFetchPolicy.hh"
+#include "params/RoundRobinFetchPolicy.hh"
+
+SMTFetchPolicy::SMTFetchPolicy(const Params *p)
+    : SimObject(p), stallThreshold(p->stallThreshold)
+{
+}
+
+ThreadID
+SMTFetchPolicy::chooseThread(const ThreadInfo *threads,
+                             unsigned num_threads) const
+{
+    ThreadID best = InvalidThreadID;
+    unsigned best_priority = 0;
+
+    for (unsigned i = 0; i < num_threads; ++i) {
+        const ThreadInfo &info = threads[i];
+        if (stallThreshold && info.missCount >= stallThreshold)
+            continue;
+
+        // Only a strictly better thread can take the place of one
+        // that comes first in round robin order
+        const unsigned p = priority(info);
+        if (best == InvalidThreadID || p < best_priority) {
+            best = info.tid;
+            best_priority = p;
+        }
+    }
+
+    return best;
+}
+
+RoundRobinFetchPolicy *
+RoundRobinFetchPolicyParams::create()
+{
+    return new RoundRobinFetchPolicy(this);
+}
+
+ICountFetchPolicy *
+ICountFetchPolicyParams::create()
+{
+    return new ICountFetchPolicy(this);
+}
+
+IQCountFetchPolicy *
+IQCountFetchPolicyParams::create()
+{
+    return new IQCountFetchPolicy(this);
+}
+
+LSQCountFetchPolicy *
+LSQCountFetchPolicyParams::create()
+{
+    return new LSQCountFetchPolicy(this);
+}
+
+BrCountFetchPolicy *
+BrCountFetchPolicyParams::create()
+{
+    return new BrCountFetchPolicy(this);
+}
+
+MissCountFetchPolicy *
+MissCountFetchPolicyParams::create()
+{
+    return new MissCountFetchPolicy(this);
+}
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Policies that select the thread to fetch from on an SMT core.
+ */
+
+#ifndef __CPU_O3_SMT_FETCH_POLICY_HH__
+#define __CPU_O3_SMT_FETCH_POLICY_HH__
+
+#include "base/types.hh"
+#include "params/SMTFetchPolicy.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Base class of the SMT fetch policies. Each cycle, fetch lists the
+ * threads that are able to fetch, in round robin order, with their
+ * occupancy of the pipeline. The policy picks the thread with the
+ * lowest priority value, the ties being broken in round robin order,
+ * so a policy only has to define how it ranks the threads.
+ */
+class SMTFetchPolicy : public SimObject
+{
+  public:
+    /** Occupancy of a thread that is able to fetch. */
+    struct ThreadInfo
+    {
+        ThreadID tid;
+        /** Instructions fetched but not issued yet. */
+        unsigned icount;
+        /** Instructions in the IQ. */
+        unsigned iqCount;
+        /** Instructions in the LSQ. */
+        unsigned lsqCount;
+        /** Branches fetched but not executed yet. */
+        unsigned branchCount;
+        /** Loads waiting for the data cache. */
+        unsigned missCount;
+    };
+
+    typedef SMTFetchPolicyParams Params;
+
+    SMTFetchPolicy(const Params *p);
+
+    /**
+     * Pick the thread to fetch from.
+     *
+     * @param threads Threads able to fetch, in round robin order.
+     * @param num_threads Number of threads in the array.
+     * @return The thread to fetch from, or InvalidThreadID if all the
+     * threads are stalled.
+     */
+    ThreadID chooseThread(const ThreadInfo *threads,
+                          unsigned num_threads) const;
+
+  protected:
+    /** Rank of a thread, the lowest being fetched from first. */
+    virtual unsigned priority(const ThreadInfo &info) const = 0;
+
+    /**
+     * Threads with this many loads waiting for the data cache don't
+     * fetch, so that they don't fill the shared queues while they
+     * can't make progress. 0 disables the stall.
+     */
+    const unsigned stallThreshold;
+};
+
+/** Fetches from the threads in turn. */
+class RoundRobinFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    RoundRobinFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned priority(const ThreadInfo &info) const override { return 0; }
+};
+
+/**
+ * ICOUNT: favours the threads with the fewest instructions in the
+ * front end and the IQ, i.e. the ones that move fastest through the
+ * pipeline.
+ */
+class ICountFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    ICountFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned
+    priority(const ThreadInfo &info) const override
+    {
+        return info.icount;
+    }
+};
+
+/** Favours the threads with the fewest instructions in the IQ. */
+class IQCountFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    IQCountFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned
+    priority(const ThreadInfo &info) const override
+    {
+        return info.iqCount;
+    }
+};
+
+/** Favours the threads with the fewest instructions in the LSQ. */
+class LSQCountFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    LSQCountFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned
+    priority(const ThreadInfo &info) const override
+    {
+        return info.lsqCount;
+    }
+};
+
+/**
+ * BRCOUNT: favours the threads with the fewest unresolved branches,
+ * i.e. the least likely to be on a wrong path.
+ */
+class BrCountFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    BrCountFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned
+    priority(const ThreadInfo &info) const override
+    {
+        return info.branchCount;
+    }
+};
+
+/**
+ * MISSCOUNT: favours the threads with the fewest loads waiting for
+ * the data cache.
+ */
+class MissCountFetchPolicy : public SMTFetchPolicy
+{
+  public:
+    MissCountFetchPolicy(const Params *p) : SMTFetchPolicy(p) {}
+
+  protected:
+    unsigned
+    priority(const ThreadInfo &info) const override
+    {
+        return info.missCount;
+    }
+};
+
+#endif // __CPU_O3_SMT_FETCH_POLICY_HH__
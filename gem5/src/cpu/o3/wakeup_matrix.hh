@@ -0,0 +1,313 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_O3_WAKEUP_MATRIX_HH__
+#define __CPU_O3_WAKEUP_MATRIX_HH__
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+#include "base/cprintf.hh"
+#include "base/logging.hh"
+#include "cpu/o3/dep_graph.hh"
+
+/**
+ * Dependency tracker modelled as a wakeup matrix, the way a hardware
+ * scheduler does it. Each row is a physical register tag and each
+ * column holds an instruction waiting in the IQ. A set bit means that
+ * the instruction of the column waits on the register of the row, so
+ * waking up the dependents of a register is a bit-scan of its row
+ * instead of a walk through a linked list, and inserting or removing
+ * a dependence never allocates.
+ *
+ * An instruction takes a column when it first gets a dependence and
+ * frees it once all its dependences are gone. The matrix grows by 64
+ * columns whenever it runs out, so it ends up about as wide as the
+ * number of instructions waiting in the IQ.
+ */
+template <class DynInstPtr>
+class WakeupMatrix : public DependencyTracker<DynInstPtr>
+{
+  public:
+    /** Default construction.  Must call resize() prior to use. */
+    WakeupMatrix()
+        : numRegs(0), numWords(0), numWaiting(0), lastColumn(-1)
+    { }
+
+    void resize(int num_entries) override;
+
+    void reset() override;
+
+    void insert(PhysRegIndex idx, const DynInstPtr &new_inst) override;
+
+    void setInst(PhysRegIndex idx, const DynInstPtr &new_inst) override
+    { producers[idx] = new_inst; }
+
+    void clearInst(PhysRegIndex idx) override
+    { producers[idx] = NULL; }
+
+    void remove(PhysRegIndex idx, const DynInstPtr &inst_to_remove) override;
+
+    /** Removes and returns the dependent in the lowest column. */
+    DynInstPtr pop(PhysRegIndex idx) override;
+
+    bool empty() const override { return numWaiting == 0; }
+
+    bool empty(PhysRegIndex idx) const override
+    { return rowCount[idx] == 0; }
+
+    void dump() override;
+
+  private:
+    /** Returns the first word of the row of a register. */
+    uint64_t *row(PhysRegIndex idx) { return &matrix[idx * numWords]; }
+
+    /** Finds a column for an instruction getting its first dependence. */
+    int allocColumn(const DynInstPtr &inst);
+
+    /** Adds 64 columns to the matrix. */
+    void grow();
+
+    /** Clears the bit of a column in the row of a register. */
+    void clearBit(PhysRegIndex idx, int col);
+
+    /** Number of rows; identical to the number of registers. */
+    int numRegs;
+
+    /** Number of 64-bit words in each row. */
+    int numWords;
+
+    /** Number of bits set in the whole matrix. */
+    unsigned numWaiting;
+
+    /** Column given to the last instruction inserted. The sources of
+     *  an instruction are inserted back to back, so they share it.
+     */
+    int lastColumn;
+
+    /** The matrix itself, row major. */
+    std::vector<uint64_t> matrix;
+
+    /** Number of bits set in each row. */
+    std::vector<unsigned> rowCount;
+
+    /** Producing instruction of each register. */
+    std::vector<DynInstPtr> producers;
+
+    /** Instruction waiting in each column. */
+    std::vector<DynInstPtr> columns;
+
+    /** Number of bits set in each column. */
+    std::vector<unsigned> columnCount;
+
+    /** Columns that hold no instruction. */
+    std::vector<int> freeColumns;
+};
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::resize(int num_entries)
+{
+    numRegs = num_entries;
+    producers.resize(numRegs);
+    rowCount.assign(numRegs, 0);
+    matrix.assign(numRegs * numWords, 0);
+    if (numWords == 0)
+        grow();
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::reset()
+{
+    std::fill(matrix.begin(), matrix.end(), 0);
+    std::fill(rowCount.begin(), rowCount.end(), 0);
+    std::fill(columnCount.begin(), columnCount.end(), 0);
+    for (auto &inst : producers)
+        inst = NULL;
+
+    freeColumns.clear();
+    for (int col = columns.size() - 1; col >= 0; --col) {
+        columns[col] = NULL;
+        freeColumns.push_back(col);
+    }
+
+    numWaiting = 0;
+    lastColumn = -1;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::grow()
+{
+    const int old_words = numWords;
+    ++numWords;
+
+    std::vector<uint64_t> new_matrix(numRegs * numWords, 0);
+    for (int idx = 0; old_words && idx < numRegs; ++idx) {
+        std::copy(matrix.begin() + idx * old_words,
+                  matrix.begin() + (idx + 1) * old_words,
+                  new_matrix.begin() + idx * numWords);
+    }
+    matrix.swap(new_matrix);
+
+    const int first = old_words * 64;
+    columns.resize(first + 64);
+    columnCount.resize(first + 64, 0);
+    // Hand out the lowest columns first
+    for (int col = first + 63; col >= first; --col)
+        freeColumns.push_back(col);
+}
+
+template <class DynInstPtr>
+int
+WakeupMatrix<DynInstPtr>::allocColumn(const DynInstPtr &inst)
+{
+    if (freeColumns.empty())
+        grow();
+
+    const int col = freeColumns.back();
+    freeColumns.pop_back();
+    columns[col] = inst;
+    return col;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::insert(PhysRegIndex idx,
+                                 const DynInstPtr &new_inst)
+{
+    // Share the column of the previous source of the same instruction,
+    // unless that source is the same register. Each dependence has to
+    // wake the instruction up once, so a register used twice needs two
+    // bits.
+    int col = lastColumn;
+    if (col < 0 || columns[col] != new_inst ||
+        bits(row(idx)[col / 64], col % 64)) {
+        col = allocColumn(new_inst);
+    }
+
+    row(idx)[col / 64] |= ULL(1) << (col % 64);
+    ++rowCount[idx];
+    ++columnCount[col];
+    ++numWaiting;
+    lastColumn = col;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::clearBit(PhysRegIndex idx, int col)
+{
+    row(idx)[col / 64] &= ~(ULL(1) << (col % 64));
+    --rowCount[idx];
+    --numWaiting;
+
+    if (--columnCount[col] == 0) {
+        columns[col] = NULL;
+        freeColumns.push_back(col);
+        if (lastColumn == col)
+            lastColumn = -1;
+    }
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::remove(PhysRegIndex idx,
+                                 const DynInstPtr &inst_to_remove)
+{
+    // As with the linked lists, an empty row means that the dependent
+    // is already ready.
+    if (rowCount[idx] == 0)
+        return;
+
+    this->nodesRemoved++;
+
+    uint64_t *words = row(idx);
+    for (int w = 0; w < numWords; ++w) {
+        for (uint64_t mask = words[w]; mask; mask &= mask - 1) {
+            const int col = w * 64 + ctz64(mask);
+            if (columns[col] == inst_to_remove) {
+                clearBit(idx, col);
+                return;
+            }
+            this->nodesTraversed++;
+        }
+    }
+
+    panic("Instruction [sn:%lli] does not depend on register %i.",
+          inst_to_remove->seqNum, idx);
+}
+
+template <class DynInstPtr>
+DynInstPtr
+WakeupMatrix<DynInstPtr>::pop(PhysRegIndex idx)
+{
+    if (rowCount[idx] == 0)
+        return NULL;
+
+    uint64_t *words = row(idx);
+    int w = 0;
+    while (!words[w])
+        ++w;
+
+    const int col = w * 64 + ctz64(words[w]);
+    DynInstPtr inst = columns[col];
+    clearBit(idx, col);
+    return inst;
+}
+
+template <class DynInstPtr>
+void
+WakeupMatrix<DynInstPtr>::dump()
+{
+    for (int idx = 0; idx < numRegs; ++idx) {
+        if (producers[idx]) {
+            cprintf("wakeupMatrix[%i]: producer: %s [sn:%lli] consumer: ",
+                    idx, producers[idx]->pcState(), producers[idx]->seqNum);
+        } else {
+            cprintf("wakeupMatrix[%i]: No producer. consumer: ", idx);
+        }
+
+        uint64_t *words = row(idx);
+        for (int w = 0; w < numWords; ++w) {
+            for (uint64_t mask = words[w]; mask; mask &= mask - 1) {
+                const DynInstPtr &inst = columns[w * 64 + ctz64(mask)];
+                cprintf("%s [sn:%lli] ", inst->pcState(), inst->seqNum);
+            }
+        }
+
+        cprintf("\n");
+    }
+    cprintf("Waiting dependences: %i, free columns: %i\n",
+            numWaiting, freeColumns.size());
+}
+
+#endif // __CPU_O3_WAKEUP_MATRIX_HH__
@@ -69,6 +69,10 @@ class BranchPredictor(SimObject):
     indirectBranchPred = Param.IndirectPredictor(SimpleIndirectPredictor(),
       "Indirect branch predictor, set to NULL to disable indirect predictions")
 
+    shadows = VectorParam.BranchPredictor([], "Shadow predictors that "
+        "predict the committed branches in order without driving the "
+        "pipeline, to compare predictors in a single simulation")
+
 class LocalBP(BranchPredictor):
     type = 'LocalBP'
     cxx_class = 'LocalBP'
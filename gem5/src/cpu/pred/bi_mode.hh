@@ -35,6 +35,7 @@
 #ifndef __CPU_PRED_BI_MODE_PRED_HH__
 #define __CPU_PRED_BI_MODE_PRED_HH__
 
+#include "base/pool_alloc.hh"
 #include "base/sat_counter.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "params/BiModeBP.hh"
@@ -67,7 +68,7 @@ class BiModeBP : public BPredUnit
   private:
     void updateGlobalHistReg(ThreadID tid, bool taken);
 
-    struct BPHistory {
+    struct BPHistory : public PoolAllocated<BPHistory> {
         unsigned globalHistoryReg;
         // was the taken array's prediction used?
         // true: takenPred used
@@ -61,6 +61,7 @@ BPredUnit::BPredUnit(const Params *params)
           params->BTBTagSize,
           params->instShiftAmt,
           params->numThreads),
+      shadows(params->shadows),
       RAS(numThreads),
       iPred(params->indirectBranchPred),
       instShiftAmt(params->instShiftAmt)
@@ -141,6 +142,27 @@ BPredUnit::regStats()
         .desc("Number of mispredicted indirect branches.")
         ;
 
+    shadowBranches
+        .name(name() + ".shadowBranches")
+        .desc("Number of committed branches observed as a shadow predictor")
+        .flags(Stats::nozero)
+        ;
+
+    shadowMispredicts
+        .name(name() + ".shadowMispredicts")
+        .desc("Number of observed branches mispredicted (direction or "
+              "target)")
+        .flags(Stats::nozero)
+        ;
+
+    shadowMispredictRate
+        .name(name() + ".shadowMispredictRate")
+        .desc("Fraction of the observed branches mispredicted")
+        .flags(Stats::nozero)
+        .precision(6)
+        ;
+    shadowMispredictRate = shadowMispredicts / shadowBranches;
+
 }
 
 ProbePoints::PMUUPtr
@@ -360,6 +382,13 @@ BPredUnit::update(const InstSeqNum &done_sn, ThreadID tid)
             iPred->commit(done_sn, tid, predHist[tid].back().indirectHistory);
         }
 
+        // The history holds the actual outcome of the branch by now
+        const PredictorHistory &committed = predHist[tid].back();
+        for (auto shadow : shadows) {
+            shadow->observe(committed.inst, committed.seqNum, committed.pc,
+                            committed.predTaken, committed.target, tid);
+        }
+
         predHist[tid].pop_back();
     }
 }
@@ -441,7 +470,7 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     // fix up the entry.
     if (!pred_hist.empty()) {
 
-        auto hist_it = pred_hist.begin();
+        PredictorHistory *hist_it = &pred_hist.front();
         //HistoryIt hist_it = find(pred_hist.begin(), pred_hist.end(),
         //                       squashed_sn);
 
@@ -540,23 +569,34 @@ BPredUnit::squash(const InstSeqNum &squashed_sn,
     }
 }
 
+void
+BPredUnit::observe(const StaticInstPtr &inst, const InstSeqNum &seq_num,
+                   Addr pc, bool taken, Addr target, ThreadID tid)
+{
+    TheISA::PCState pred_pc(pc);
+    const bool pred_taken = predict(inst, seq_num, pred_pc, tid);
+
+    ++shadowBranches;
+    if (pred_taken != taken || (taken && pred_pc.instAddr() != target)) {
+        ++shadowMispredicts;
+        squash(seq_num, TheISA::PCState(target), taken, tid);
+    }
+    update(seq_num, tid);
+}
+
 void
 BPredUnit::dump()
 {
     int i = 0;
     for (const auto& ph : predHist) {
         if (!ph.empty()) {
-            auto pred_hist_it = ph.begin();
-
             cprintf("predHist[%i].size(): %i\n", i++, ph.size());
 
-            while (pred_hist_it != ph.end()) {
+            for (size_t j = 0; j < ph.size(); ++j) {
                 cprintf("sn:%llu], PC:%#x, tid:%i, predTaken:%i, "
                         "bpHistory:%#x\n",
-                        pred_hist_it->seqNum, pred_hist_it->pc,
-                        pred_hist_it->tid, pred_hist_it->predTaken,
-                        pred_hist_it->bpHistory);
-                pred_hist_it++;
+                        ph[j].seqNum, ph[j].pc, ph[j].tid, ph[j].predTaken,
+                        ph[j].bpHistory);
             }
 
             cprintf("\n");
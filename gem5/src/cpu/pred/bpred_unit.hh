@@ -47,7 +47,7 @@
 #ifndef __CPU_PRED_BPRED_UNIT_HH__
 #define __CPU_PRED_BPRED_UNIT_HH__
 
-#include <deque>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -192,11 +192,31 @@ class BPredUnit : public SimObject
     void BTBUpdate(Addr instPC, const TheISA::PCState &target)
     { BTB.update(instPC, target, 0); }
 
+    /**
+     * Predict a committed branch as a shadow predictor: predict it,
+     * fix the prediction up with the actual outcome if it was wrong
+     * and commit it.
+     * @param inst The branch instruction.
+     * @param seq_num The sequence number of the branch.
+     * @param pc The PC of the branch.
+     * @param taken Whether the branch was taken.
+     * @param target The PC of the instruction after the branch.
+     * @param tid The thread id.
+     */
+    void observe(const StaticInstPtr &inst, const InstSeqNum &seq_num,
+                 Addr pc, bool taken, Addr target, ThreadID tid);
 
     void dump();
 
   private:
     struct PredictorHistory {
+        PredictorHistory()
+            : seqNum(0), pc(0), bpHistory(nullptr), indirectHistory(nullptr),
+              RASTarget(0), RASIndex(0), tid(0), predTaken(false),
+              usedRAS(false), pushedRAS(false), wasCall(false),
+              wasReturn(false), wasIndirect(false), target(MaxAddr)
+        {}
+
         /**
          * Makes a predictor history struct that contains any
          * information needed to update the predictor, BTB, and RAS.
@@ -263,10 +283,83 @@ class BPredUnit : public SimObject
         Addr target;
 
         /** The branch instrction */
-        const StaticInstPtr inst;
+        StaticInstPtr inst;
     };
 
-    typedef std::deque<PredictorHistory> History;
+    /**
+     * Predictor history of a thread, with the youngest branch at the
+     * front. The entries are kept in a ring that only grows when more
+     * branches are in flight than ever before, so predicting a branch
+     * doesn't allocate memory.
+     */
+    class History
+    {
+      public:
+        History() : ring(initialSize), head(0), count(0) {}
+
+        bool empty() const { return count == 0; }
+        size_t size() const { return count; }
+
+        /** The i-th youngest entry */
+        PredictorHistory &
+        operator[](size_t i)
+        {
+            return ring[(head + i) & (ring.size() - 1)];
+        }
+        const PredictorHistory &
+        operator[](size_t i) const
+        {
+            return ring[(head + i) & (ring.size() - 1)];
+        }
+
+        PredictorHistory &front() { return (*this)[0]; }
+        PredictorHistory &back() { return (*this)[count - 1]; }
+
+        void
+        push_front(const PredictorHistory &entry)
+        {
+            if (count == ring.size())
+                grow();
+            head = (head - 1) & (ring.size() - 1);
+            ring[head] = entry;
+            ++count;
+        }
+
+        void
+        pop_front()
+        {
+            assert(count);
+            front().inst = nullptr;
+            head = (head + 1) & (ring.size() - 1);
+            --count;
+        }
+
+        void
+        pop_back()
+        {
+            assert(count);
+            back().inst = nullptr;
+            --count;
+        }
+
+      private:
+        /** Initial number of entries, has to be a power of 2 */
+        static const size_t initialSize = 64;
+
+        void
+        grow()
+        {
+            std::vector<PredictorHistory> bigger(ring.size() * 2);
+            for (size_t i = 0; i < count; ++i)
+                bigger[i] = (*this)[i];
+            ring.swap(bigger);
+            head = 0;
+        }
+
+        std::vector<PredictorHistory> ring;
+        size_t head;
+        size_t count;
+    };
 
     /** Number of the threads for which the branch history is maintained. */
     const unsigned numThreads;
@@ -282,6 +375,12 @@ class BPredUnit : public SimObject
     /** The BTB. */
     DefaultBTB BTB;
 
+    /**
+     * Predictors that observe the committed branches without driving
+     * the pipeline.
+     */
+    std::vector<BPredUnit *> shadows;
+
     /** The per-thread return address stack. */
     std::vector<ReturnAddrStack> RAS;
 
@@ -316,6 +415,13 @@ class BPredUnit : public SimObject
     /** Stat for the number of indirect target mispredictions.*/
     Stats::Scalar indirectMispredicted;
 
+    /** Stat for the number of committed branches observed as a shadow. */
+    Stats::Scalar shadowBranches;
+    /** Stat for the number of observed branches mispredicted. */
+    Stats::Scalar shadowMispredicts;
+    /** Stat for the fraction of observed branches mispredicted. */
+    Stats::Formula shadowMispredictRate;
+
   protected:
     /** Number of bits to shift instructions by for predictor addresses. */
     const unsigned instShiftAmt;
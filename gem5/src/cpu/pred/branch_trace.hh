@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Format of the branch traces written by the BranchTraceProbe and
+ * replayed by BranchTraceReplay. A trace starts with a magic number
+ * and holds one record per committed control instruction, in commit
+ * order. The records are stored in the byte order of the host.
+ */
+
+#ifndef __CPU_PRED_BRANCH_TRACE_HH__
+#define __CPU_PRED_BRANCH_TRACE_HH__
+
+#include <cstdint>
+
+namespace BranchTrace {
+
+/** Magic number at the start of a trace */
+const char magic[4] = { 'B', 'R', 'T', '1' };
+
+/** Properties of a traced branch */
+enum Flags : uint8_t {
+    Taken = 0x01,
+    Conditional = 0x02,
+    Indirect = 0x04,
+    Call = 0x08,
+    Return = 0x10,
+};
+
+struct Record
+{
+    /** PC of the branch */
+    uint64_t pc;
+    /** PC of the instruction committed after the branch */
+    uint64_t target;
+    /**
+     * Number of instructions committed since the previous branch,
+     * including this one
+     */
+    uint32_t insts;
+    /** Flags of the branch */
+    uint8_t flags;
+    uint8_t pad[3];
+};
+
+static_assert(sizeof(Record) == 24, "Unexpected branch trace record size");
+
+} // namespace BranchTrace
+
+#endif // __CPU_PRED_BRANCH_TRACE_HH__
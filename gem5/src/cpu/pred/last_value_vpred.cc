@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/pred/last_value_vpred.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+LastValuePredictor::LastValuePredictor(
+        const LastValuePredictorParams *params)
+    : VPredUnit(params),
+      tableSize(params->tableSize),
+      tagBits(params->tagBits),
+      table(tableSize, Entry(params->confidenceBits))
+{
+    fatal_if(!isPowerOf2(tableSize),
+             "Invalid value predictor table size %u, it must be a power "
+             "of 2.", tableSize);
+}
+
+Addr
+LastValuePredictor::tag(Addr pc) const
+{
+    return (pc >> (instShiftAmt + floorLog2(tableSize))) & mask(tagBits);
+}
+
+LastValuePredictor::Entry *
+LastValuePredictor::findEntry(Addr pc)
+{
+    Entry &entry = table[index(pc)];
+    return entry.valid && entry.tag == tag(pc) ? &entry : nullptr;
+}
+
+LastValuePredictor::Entry &
+LastValuePredictor::allocateEntry(Addr pc, RegVal value)
+{
+    Entry &entry = table[index(pc)];
+    entry.valid = true;
+    entry.tag = tag(pc);
+    entry.value = value;
+    entry.confidence.reset();
+    return entry;
+}
+
+bool
+LastValuePredictor::lookup(ThreadID tid, Addr pc, RegVal &value,
+                           void * &vp_history)
+{
+    const Entry *entry = findEntry(pc);
+    if (!entry) {
+        value = 0;
+        return false;
+    }
+
+    value = entry->value;
+    return entry->confidence.isSaturated();
+}
+
+void
+LastValuePredictor::train(ThreadID tid, Addr pc, RegVal value,
+                          void *vp_history)
+{
+    Entry *entry = findEntry(pc);
+    if (!entry) {
+        allocateEntry(pc, value);
+    } else if (entry->value == value) {
+        ++entry->confidence;
+    } else {
+        entry->value = value;
+        entry->confidence.reset();
+    }
+}
+
+LastValuePredictor *
+LastValuePredictorParams::create()
+{
+    return new LastValuePredictor(this);
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_PRED_LAST_VALUE_VPRED_HH__
+#define __CPU_PRED_LAST_VALUE_VPRED_HH__
+
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "cpu/pred/vpred_unit.hh"
+#include "params/LastValuePredictor.hh"
+
+/**
+ * Predicts that an instruction produces the same value as the last
+ * time it committed. Each entry of the table has a confidence counter
+ * that is incremented when the value repeats and reset otherwise.
+ */
+class LastValuePredictor : public VPredUnit
+{
+  public:
+    LastValuePredictor(const LastValuePredictorParams *params);
+
+  protected:
+    bool lookup(ThreadID tid, Addr pc, RegVal &value,
+                void * &vp_history) override;
+
+    void train(ThreadID tid, Addr pc, RegVal value,
+               void *vp_history) override;
+
+    void squashLookup(ThreadID tid, Addr pc, void *vp_history) override {}
+
+    struct Entry
+    {
+        Entry(unsigned confidence_bits)
+            : valid(false), tag(0), value(0), confidence(confidence_bits)
+        {}
+
+        bool valid;
+        Addr tag;
+        RegVal value;
+        SatCounter confidence;
+    };
+
+    /** Returns the entry of an instruction, nullptr if it has none. */
+    Entry *findEntry(Addr pc);
+
+    /** Replaces the entry of the table an instruction maps to. */
+    Entry &allocateEntry(Addr pc, RegVal value);
+
+    /** Index of the entry of an instruction in the table. */
+    unsigned index(Addr pc) const { return tableIndex(pc, tableSize); }
+
+    const unsigned tableSize;
+
+    const unsigned tagBits;
+
+    std::vector<Entry> table;
+
+  private:
+    Addr tag(Addr pc) const;
+};
+
+#endif // __CPU_PRED_LAST_VALUE_VPRED_HH__
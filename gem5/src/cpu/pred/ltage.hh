@@ -55,6 +55,7 @@
 
 #include <vector>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/pred/loop_predictor.hh"
 #include "cpu/pred/tage.hh"
@@ -85,8 +86,12 @@ class LTAGE : public TAGE
     };
 
     // Primary branch history entry
-    struct LTageBranchInfo : public TageBranchInfo
+    struct LTageBranchInfo : public TageBranchInfo,
+                             public PoolAllocated<LTageBranchInfo>
     {
+        using PoolAllocated<LTageBranchInfo>::operator new;
+        using PoolAllocated<LTageBranchInfo>::operator delete;
+
         LoopPredictor::BranchInfo *lpBranchInfo;
         LTageBranchInfo(TAGEBase &tage, LoopPredictor &lp)
           : TageBranchInfo(tage), lpBranchInfo(lp.makeBranchInfo())
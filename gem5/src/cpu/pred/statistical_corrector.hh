@@ -42,6 +42,7 @@
 #ifndef __CPU_PRED_STATISTICAL_CORRECTOR_HH
 #define __CPU_PRED_STATISTICAL_CORRECTOR_HH
 
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "cpu/static_inst.hh"
@@ -186,7 +187,7 @@ class StatisticalCorrector : public SimObject
     Stats::Scalar scPredictorCorrect;
     Stats::Scalar scPredictorWrong;
   public:
-    struct BranchInfo
+    struct BranchInfo : public PoolAllocated<BranchInfo>
     {
         BranchInfo() : lowConf(false), highConf(false), altConf(false),
               medConf(false), scPred(false), lsum(0), thres(0),
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/pred/stride_vpred.hh"
+
+StrideValuePredictor::StrideValuePredictor(
+        const StrideValuePredictorParams *params)
+    : LastValuePredictor(params),
+      strides(tableSize, 0),
+      inFlight(tableSize, 0)
+{
+}
+
+bool
+StrideValuePredictor::lookup(ThreadID tid, Addr pc, RegVal &value,
+                             void * &vp_history)
+{
+    const Entry *entry = findEntry(pc);
+    if (!entry) {
+        value = 0;
+        return false;
+    }
+
+    const unsigned idx = index(pc);
+    value = entry->value + strides[idx] * ++inFlight[idx];
+    return entry->confidence.isSaturated();
+}
+
+void
+StrideValuePredictor::train(ThreadID tid, Addr pc, RegVal value,
+                            void *vp_history)
+{
+    const unsigned idx = index(pc);
+    Entry *entry = findEntry(pc);
+    if (!entry) {
+        allocateEntry(pc, value);
+        strides[idx] = 0;
+        inFlight[idx] = 0;
+        return;
+    }
+
+    // The entry may have been replaced since the lookup
+    if (inFlight[idx])
+        --inFlight[idx];
+
+    if (entry->value + strides[idx] == value) {
+        ++entry->confidence;
+    } else {
+        entry->confidence.reset();
+        strides[idx] = value - entry->value;
+    }
+    entry->value = value;
+}
+
+void
+StrideValuePredictor::squashLookup(ThreadID tid, Addr pc, void *vp_history)
+{
+    const unsigned idx = index(pc);
+    if (findEntry(pc) && inFlight[idx])
+        --inFlight[idx];
+}
+
+StrideValuePredictor *
+StrideValuePredictorParams::create()
+{
+    return new StrideValuePredictor(this);
+}
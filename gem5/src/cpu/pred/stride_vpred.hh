@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_PRED_STRIDE_VPRED_HH__
+#define __CPU_PRED_STRIDE_VPRED_HH__
+
+#include <vector>
+
+#include "cpu/pred/last_value_vpred.hh"
+#include "params/StrideValuePredictor.hh"
+
+/**
+ * Predicts that an instruction produces the last value it committed
+ * plus a stride. The entries count the instances of the instruction
+ * in flight, so that the n-th one is predicted as the last value plus
+ * n strides. The confidence grows while the stride repeats.
+ */
+class StrideValuePredictor : public LastValuePredictor
+{
+  public:
+    StrideValuePredictor(const StrideValuePredictorParams *params);
+
+  protected:
+    bool lookup(ThreadID tid, Addr pc, RegVal &value,
+                void * &vp_history) override;
+
+    void train(ThreadID tid, Addr pc, RegVal value,
+               void *vp_history) override;
+
+    void squashLookup(ThreadID tid, Addr pc, void *vp_history) override;
+
+  private:
+    /** Stride of the entries of the table. */
+    std::vector<RegVal> strides;
+
+    /** Number of the looked up instances of each entry in flight. */
+    std::vector<unsigned> inFlight;
+};
+
+#endif // __CPU_PRED_STRIDE_VPRED_HH__
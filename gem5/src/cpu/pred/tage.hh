@@ -53,6 +53,7 @@
 
 #include <vector>
 
+#include "base/pool_alloc.hh"
 #include "base/types.hh"
 #include "cpu/pred/bpred_unit.hh"
 #include "cpu/pred/tage_base.hh"
@@ -63,7 +64,7 @@ class TAGE: public BPredUnit
   protected:
     TAGEBase *tage;
 
-    struct TageBranchInfo {
+    struct TageBranchInfo : public PoolAllocated<TageBranchInfo> {
         TAGEBase::BranchInfo *tageBranchInfo;
 
         TageBranchInfo(TAGEBase &tage) : tageBranchInfo(tage.makeBranchInfo())
@@ -53,6 +53,7 @@
 
 #include <vector>
 
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "cpu/static_inst.hh"
 #include "params/TAGEBase.hh"
@@ -68,13 +69,13 @@ class TAGEBase : public SimObject
   protected:
     // Prediction Structures
 
-    // Tage Entry
+    // Tage Entry, the tag goes first so that an entry fits in 4 bytes
     struct TageEntry
     {
-        int8_t ctr;
         uint16_t tag;
+        int8_t ctr;
         uint8_t u;
-        TageEntry() : ctr(0), tag(0), u(0) { }
+        TageEntry() : tag(0), ctr(0), u(0) { }
     };
 
     // Folded History Table - compressed history
@@ -121,7 +122,7 @@ class TAGEBase : public SimObject
     };
 
     // Primary branch history entry
-    struct BranchInfo
+    struct BranchInfo : public PoolAllocated<BranchInfo>
     {
         int pathHist;
         int ptGhist;
@@ -138,9 +139,9 @@ class TAGEBase : public SimObject
         bool pseudoNewAlloc;
         Addr branchPC;
 
-        // Pointer to dynamically allocated storage
-        // to save table indices and folded histories.
-        // To do one call to new instead of five.
+        // Pointer to storage to save table indices and folded
+        // histories, recycled by the TAGE tables (see
+        // TAGEBase::allocStorage()).
         int *storage;
 
         // Pointers to actual saved array within the dynamically
@@ -154,6 +155,8 @@ class TAGEBase : public SimObject
         // for stats purposes
         unsigned provider;
 
+        const TAGEBase &tage;
+
         BranchInfo(const TAGEBase &tage)
             : pathHist(0), ptGhist(0),
               hitBank(0), hitBankIndex(0),
@@ -162,10 +165,10 @@ class TAGEBase : public SimObject
               tagePred(false), altTaken(false),
               condBranch(false), longestMatchPred(false),
               pseudoNewAlloc(false), branchPC(0),
-              provider(-1)
+              provider(-1), tage(tage)
         {
             int sz = tage.nHistoryTables + 1;
-            storage = new int [sz * 5];
+            storage = tage.allocStorage();
             tableIndices = storage;
             tableTags = storage + sz;
             ci = tableTags + sz;
@@ -175,12 +178,40 @@ class TAGEBase : public SimObject
 
         virtual ~BranchInfo()
         {
-            delete[] storage;
+            tage.freeStorage(storage);
         }
     };
 
     virtual BranchInfo *makeBranchInfo();
 
+  private:
+    /**
+     * Get storage for the indices and folded histories of a
+     * BranchInfo. The storage of deleted BranchInfos is reused, so
+     * that predicting a branch doesn't need an allocation once the
+     * pipeline is full of branches.
+     */
+    int *
+    allocStorage() const
+    {
+        if (freeStorageList.empty())
+            return new int [(nHistoryTables + 1) * 5];
+        int *storage = freeStorageList.back();
+        freeStorageList.pop_back();
+        return storage;
+    }
+
+    void
+    freeStorage(int *storage) const
+    {
+        freeStorageList.push_back(storage);
+    }
+
+    /** Storage of the deleted BranchInfos */
+    mutable std::vector<int *> freeStorageList;
+
+  public:
+
     /**
      * Computes the index used to access the
      * bimodal table.
@@ -43,6 +43,7 @@
 #ifndef __CPU_PRED_TAGE_SC_L
 #define __CPU_PRED_TAGE_SC_L
 
+#include "base/pool_alloc.hh"
 #include "cpu/pred/ltage.hh"
 #include "cpu/pred/statistical_corrector.hh"
 #include "params/TAGE_SC_L.hh"
@@ -62,7 +63,11 @@ class TAGE_SC_L_TAGE : public TAGEBase {
     const bool truncatePathHist;
 
   public:
-    struct BranchInfo : public TAGEBase::BranchInfo {
+    struct BranchInfo : public TAGEBase::BranchInfo,
+                        public PoolAllocated<BranchInfo> {
+        using PoolAllocated<BranchInfo>::operator new;
+        using PoolAllocated<BranchInfo>::operator delete;
+
         bool lowConf;
         bool highConf;
         bool altConf;
@@ -162,8 +167,12 @@ class TAGE_SC_L: public LTAGE
 
   protected:
 
-    struct TageSCLBranchInfo : public LTageBranchInfo
+    struct TageSCLBranchInfo : public LTageBranchInfo,
+                               public PoolAllocated<TageSCLBranchInfo>
     {
+        using PoolAllocated<TageSCLBranchInfo>::operator new;
+        using PoolAllocated<TageSCLBranchInfo>::operator delete;
+
         StatisticalCorrector::BranchInfo *scBranchInfo;
 
         TageSCLBranchInfo(TAGEBase &tage, StatisticalCorrector &sc,
@@ -0,0 +1,204 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/pred/trace_replay.hh"
+
+#include <zlib.h>
+
+#include <cstring>
+#include <vector>
+
+#include "base/logging.hh"
+#include "cpu/pred/branch_trace.hh"
+#include "sim/sim_exit.hh"
+
+namespace {
+
+TheISA::ExtMachInst traceMachInst;
+
+/** Instruction carrying the properties of a traced branch */
+class TraceBranchInst : public StaticInst
+{
+  public:
+    TraceBranchInst(uint8_t trace_flags)
+        : StaticInst("trace branch", traceMachInst, No_OpClass)
+    {
+        flags[IsControl] = true;
+        flags[IsCondControl] = trace_flags & BranchTrace::Conditional;
+        flags[IsUncondControl] = !(trace_flags & BranchTrace::Conditional);
+        flags[IsIndirectControl] = trace_flags & BranchTrace::Indirect;
+        flags[IsDirectControl] = !(trace_flags & BranchTrace::Indirect);
+        flags[IsCall] = trace_flags & BranchTrace::Call;
+        flags[IsReturn] = trace_flags & BranchTrace::Return;
+    }
+
+    Fault
+    execute(ExecContext *xc, Trace::InstRecord *traceData) const override
+    {
+        panic("Trace branches can't be executed");
+    }
+
+    void
+    advancePC(TheISA::PCState &pcState) const override
+    {
+        pcState.advance();
+    }
+
+    std::string
+    generateDisassembly(Addr pc, const SymbolTable *symtab) const override
+    {
+        return mnemonic;
+    }
+};
+
+} // anonymous namespace
+
+BranchTraceReplay::BranchTraceReplay(const BranchTraceReplayParams *p)
+    : SimObject(p), branchPred(p->branch_pred), traceFile(p->trace_file),
+      maxInsts(p->max_insts),
+      replayEvent([this]{ replay(); }, name() + ".replay")
+{
+}
+
+void
+BranchTraceReplay::startup()
+{
+    schedule(replayEvent, curTick());
+}
+
+const StaticInstPtr &
+BranchTraceReplay::branchInst(uint8_t flags)
+{
+    StaticInstPtr &inst = branchInsts[flags & ~BranchTrace::Taken];
+    if (!inst)
+        inst = new TraceBranchInst(flags);
+    return inst;
+}
+
+void
+BranchTraceReplay::replay()
+{
+    gzFile trace = gzopen(traceFile.c_str(), "rb");
+    if (!trace)
+        fatal("Can't open branch trace %s", traceFile);
+
+    char magic[sizeof(BranchTrace::magic)];
+    if (gzread(trace, magic, sizeof(magic)) != sizeof(magic) ||
+        memcmp(magic, BranchTrace::magic, sizeof(magic)) != 0) {
+        fatal("%s is not a branch trace", traceFile);
+    }
+
+    const ThreadID tid = 0;
+    InstSeqNum seq_num = 0;
+    Counter num_insts = 0;
+    std::vector<BranchTrace::Record> buffer(4096);
+    bool done = false;
+    while (!done) {
+        const int bytes = gzread(trace, buffer.data(),
+            buffer.size() * sizeof(BranchTrace::Record));
+        if (bytes <= 0)
+            break;
+
+        const size_t records = bytes / sizeof(BranchTrace::Record);
+        for (size_t i = 0; i < records && !done; ++i) {
+            const BranchTrace::Record &rec = buffer[i];
+            const bool taken = rec.flags & BranchTrace::Taken;
+            const bool cond = rec.flags & BranchTrace::Conditional;
+            const StaticInstPtr &inst = branchInst(rec.flags);
+
+            TheISA::PCState pc(rec.pc);
+            const bool pred_taken =
+                branchPred->predict(inst, ++seq_num, pc, tid);
+            if (pred_taken != taken ||
+                (taken && pc.instAddr() != rec.target)) {
+                branchPred->squash(seq_num, TheISA::PCState(rec.target),
+                                   taken, tid);
+                ++mispredicts;
+                if (cond)
+                    ++condMispredicts;
+            }
+            branchPred->update(seq_num, tid);
+
+            ++branches;
+            if (cond)
+                ++condBranches;
+            num_insts += rec.insts;
+            done = maxInsts && num_insts >= maxInsts;
+        }
+    }
+    gzclose(trace);
+
+    insts += num_insts;
+    exitSimLoop("branch trace replayed");
+}
+
+void
+BranchTraceReplay::regStats()
+{
+    SimObject::regStats();
+
+    insts
+        .name(name() + ".insts")
+        .desc("Number of instructions in the replayed trace")
+        ;
+    branches
+        .name(name() + ".branches")
+        .desc("Number of branches replayed")
+        ;
+    condBranches
+        .name(name() + ".condBranches")
+        .desc("Number of conditional branches replayed")
+        ;
+    mispredicts
+        .name(name() + ".mispredicts")
+        .desc("Number of mispredicted branches (direction or target)")
+        ;
+    condMispredicts
+        .name(name() + ".condMispredicts")
+        .desc("Number of mispredicted conditional branches")
+        ;
+    mpki
+        .name(name() + ".mpki")
+        .desc("Mispredicted branches per thousand instructions")
+        .precision(4)
+        ;
+    mpki = mispredicts * 1000 / insts;
+    condMpki
+        .name(name() + ".condMpki")
+        .desc("Mispredicted conditional branches per thousand instructions")
+        .precision(4)
+        ;
+    condMpki = condMispredicts * 1000 / insts;
+}
+
+BranchTraceReplay *
+BranchTraceReplayParams::create()
+{
+    return new BranchTraceReplay(this);
+}
@@ -0,0 +1,84 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_PRED_TRACE_REPLAY_HH__
+#define __CPU_PRED_TRACE_REPLAY_HH__
+
+#include <array>
+#include <string>
+
+#include "base/statistics.hh"
+#include "cpu/pred/bpred_unit.hh"
+#include "cpu/static_inst.hh"
+#include "params/BranchTraceReplay.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Replays a branch trace (see cpu/pred/branch_trace.hh) on a branch
+ * predictor. Each branch is predicted, squashed with the correct
+ * outcome if it was mispredicted, and committed right away, the same
+ * sequence of calls a CPU without other branches in flight does. As
+ * no CPU is simulated, a predictor can be evaluated on long traces
+ * in a short time.
+ */
+class BranchTraceReplay : public SimObject
+{
+  public:
+    BranchTraceReplay(const BranchTraceReplayParams *p);
+
+    void startup() override;
+    void regStats() override;
+
+  private:
+    /** Replay the whole trace and exit the simulation loop */
+    void replay();
+
+    /** Get the instruction standing in for a branch with these flags */
+    const StaticInstPtr &branchInst(uint8_t flags);
+
+    BPredUnit *branchPred;
+    const std::string traceFile;
+    const Counter maxInsts;
+
+    EventFunctionWrapper replayEvent;
+
+    /** Instructions standing in for the branches, indexed by flags */
+    std::array<StaticInstPtr, 32> branchInsts;
+
+    Stats::Scalar insts;
+    Stats::Scalar branches;
+    Stats::Scalar condBranches;
+    Stats::Scalar mispredicts;
+    Stats::Scalar condMispredicts;
+    Stats::Formula mpki;
+    Stats::Formula condMpki;
+};
+
+#endif // __CPU_PRED_TRACE_REPLAY_HH__
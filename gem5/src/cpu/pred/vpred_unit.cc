@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/pred/vpred_unit.hh"
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/ValuePred.hh"
+
+VPredUnit::VPredUnit(const Params *params)
+    : SimObject(params),
+      numThreads(params->numThreads),
+      instShiftAmt(params->instShiftAmt),
+      predHist(numThreads),
+      _loadsOnly(params->loadsOnly)
+{
+}
+
+void
+VPredUnit::regStats()
+{
+    SimObject::regStats();
+
+    lookups
+        .name(name() + ".lookups")
+        .desc("Number of value predictor lookups")
+        ;
+
+    predicted
+        .name(name() + ".predicted")
+        .desc("Number of confident value predictions")
+        ;
+
+    correct
+        .name(name() + ".correct")
+        .desc("Number of committed confident predictions that were correct")
+        ;
+
+    incorrect
+        .name(name() + ".incorrect")
+        .desc("Number of committed confident predictions that were "
+              "incorrect")
+        ;
+
+    coverage
+        .name(name() + ".coverage")
+        .desc("Fraction of the lookups that were confident")
+        .precision(6)
+        ;
+    coverage = predicted / lookups;
+
+    accuracy
+        .name(name() + ".accuracy")
+        .desc("Fraction of the committed confident predictions that were "
+              "correct")
+        .precision(6)
+        ;
+    accuracy = correct / (correct + incorrect);
+}
+
+void
+VPredUnit::drainSanityCheck() const
+{
+    // We shouldn't have any outstanding lookups when we are drained
+    for (const auto &ph : predHist)
+        assert(ph.empty());
+}
+
+bool
+VPredUnit::predict(ThreadID tid, InstSeqNum seq_num, Addr pc, RegVal &value)
+{
+    ++lookups;
+
+    void *vp_history = nullptr;
+    const bool confident = lookup(tid, pc, value, vp_history);
+    if (confident)
+        ++predicted;
+
+    DPRINTF(ValuePred, "[tid:%i] [sn:%llu] Value of PC %#x predicted as "
+            "%#x (%s)\n", tid, seq_num, pc, value,
+            confident ? "confident" : "not confident");
+
+    assert(predHist[tid].empty() || predHist[tid].back().seqNum < seq_num);
+    predHist[tid].push_back({ seq_num, pc, value, confident, vp_history });
+
+    return confident;
+}
+
+void
+VPredUnit::update(ThreadID tid, InstSeqNum seq_num, RegVal value)
+{
+    auto &ph = predHist[tid];
+
+    // The instructions commit in order, so anything older than this
+    // one never will
+    while (!ph.empty() && ph.front().seqNum < seq_num) {
+        squashLookup(tid, ph.front().pc, ph.front().vpHistory);
+        ph.pop_front();
+    }
+
+    if (ph.empty() || ph.front().seqNum != seq_num)
+        return;
+
+    const PredictorHistory &entry = ph.front();
+    if (entry.confident) {
+        if (entry.value == value) {
+            ++correct;
+        } else {
+            ++incorrect;
+        }
+    }
+
+    DPRINTF(ValuePred, "[tid:%i] [sn:%llu] Committed value %#x of PC %#x, "
+            "predicted %#x\n", tid, seq_num, value, entry.pc, entry.value);
+
+    train(tid, entry.pc, value, entry.vpHistory);
+    ph.pop_front();
+}
+
+void
+VPredUnit::squash(ThreadID tid, InstSeqNum squashed_sn)
+{
+    auto &ph = predHist[tid];
+
+    // Undo the youngest lookups first
+    while (!ph.empty() && ph.back().seqNum > squashed_sn) {
+        DPRINTF(ValuePred, "[tid:%i] [sn:%llu] Squashing value prediction "
+                "of PC %#x\n", tid, ph.back().seqNum, ph.back().pc);
+        squashLookup(tid, ph.back().pc, ph.back().vpHistory);
+        ph.pop_back();
+    }
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_PRED_VPRED_UNIT_HH__
+#define __CPU_PRED_VPRED_UNIT_HH__
+
+#include <deque>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "cpu/inst_seq.hh"
+#include "params/ValuePredictor.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * Basically a wrapper class to hold value predictors. The CPU looks
+ * up the value of an instruction when it renames it, and may forward
+ * the value to the dependents if the predictor is confident. The
+ * predictions are kept in order until the instructions commit, which
+ * trains the predictor with the actual value, or get squashed.
+ */
+class VPredUnit : public SimObject
+{
+  public:
+    typedef ValuePredictorParams Params;
+
+    VPredUnit(const Params *p);
+
+    void regStats() override;
+
+    /** Whether only the loads should be looked up. */
+    bool loadsOnly() const { return _loadsOnly; }
+
+    /**
+     * Looks up the value an instruction produces.
+     * @param tid The thread of the instruction.
+     * @param seq_num The sequence number of the instruction.
+     * @param pc The address of the instruction.
+     * @param value The predicted value.
+     * @return Whether the prediction is confident enough to be used.
+     */
+    bool predict(ThreadID tid, InstSeqNum seq_num, Addr pc, RegVal &value);
+
+    /**
+     * Trains the predictor with the value a committed instruction
+     * produced. Does nothing if the instruction wasn't looked up.
+     */
+    void update(ThreadID tid, InstSeqNum seq_num, RegVal value);
+
+    /** Squashes the predictions younger than the given instruction. */
+    void squash(ThreadID tid, InstSeqNum squashed_sn);
+
+    /** Tells the predictor the outcome of a committed branch. */
+    virtual void branchCommitted(ThreadID tid, Addr pc, bool taken) {}
+
+    void drainSanityCheck() const;
+
+  protected:
+    /**
+     * Looks up the value of an instruction in the predictor.
+     * @param vp_history Pointer that will be set to an object that
+     * has the predictor state needed to train or squash the lookup.
+     * @return Whether the predictor is confident of the value.
+     */
+    virtual bool lookup(ThreadID tid, Addr pc, RegVal &value,
+                        void * &vp_history) = 0;
+
+    /**
+     * Trains the predictor with the actual value of an instruction,
+     * and deletes the history of the lookup.
+     */
+    virtual void train(ThreadID tid, Addr pc, RegVal value,
+                       void *vp_history) = 0;
+
+    /** Undoes a lookup and deletes its history. */
+    virtual void squashLookup(ThreadID tid, Addr pc, void *vp_history) = 0;
+
+    /** Index of an instruction address in a table of the given size. */
+    unsigned
+    tableIndex(Addr pc, unsigned size) const
+    {
+        return (pc >> instShiftAmt) & (size - 1);
+    }
+
+    /** Number of the threads of the CPU. */
+    const unsigned numThreads;
+
+    /** Number of bits to shift the instruction addresses by. */
+    const unsigned instShiftAmt;
+
+  private:
+    struct PredictorHistory
+    {
+        InstSeqNum seqNum;
+        Addr pc;
+        RegVal value;
+        bool confident;
+        void *vpHistory;
+    };
+
+    /** Lookups of the in-flight instructions of each thread. */
+    std::vector<std::deque<PredictorHistory>> predHist;
+
+    const bool _loadsOnly;
+
+    /** Stat for the number of lookups. */
+    Stats::Scalar lookups;
+    /** Stat for the number of confident predictions. */
+    Stats::Scalar predicted;
+    /** Stat for the number of confident predictions that committed
+     * with the predicted value. */
+    Stats::Scalar correct;
+    /** Stat for the number of confident predictions that committed
+     * with another value. */
+    Stats::Scalar incorrect;
+    /** Stat for the fraction of lookups that were confident. */
+    Stats::Formula coverage;
+    /** Stat for the fraction of committed predictions that were
+     * correct. */
+    Stats::Formula accuracy;
+};
+
+#endif // __CPU_PRED_VPRED_UNIT_HH__
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/pred/vtage_vpred.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+
+VTAGEValuePredictor::VTAGEValuePredictor(
+        const VTAGEValuePredictorParams *params)
+    : VPredUnit(params),
+      baseTableSize(params->baseTableSize),
+      logTaggedSize(params->logTaggedSize),
+      historyLengths(params->historyLengths),
+      tagBits(params->tagBits),
+      confidenceBits(params->confidenceBits),
+      baseTable(baseTableSize, Entry(confidenceBits)),
+      taggedTables(historyLengths.size(),
+                   std::vector<Entry>(1 << logTaggedSize,
+                                      Entry(confidenceBits))),
+      globalHistory(numThreads, 0)
+{
+    fatal_if(!isPowerOf2(baseTableSize),
+             "Invalid VTAGE base table size %u, it must be a power of 2.",
+             baseTableSize);
+    fatal_if(tagBits < 2, "VTAGE tags must have at least 2 bits.");
+    for (auto length : historyLengths) {
+        fatal_if(length == 0 || length > 64,
+                 "Invalid VTAGE history length %u, it must be between 1 "
+                 "and 64.", length);
+    }
+}
+
+Addr
+VTAGEValuePredictor::fold(uint64_t history, unsigned length, unsigned width)
+{
+    if (length < 64)
+        history &= mask(length);
+
+    Addr folded = 0;
+    for (unsigned i = 0; i < length; i += width)
+        folded ^= history >> i;
+    return folded & mask(width);
+}
+
+bool
+VTAGEValuePredictor::updateEntry(Entry &entry, RegVal value)
+{
+    if (entry.value == value) {
+        ++entry.confidence;
+        return true;
+    }
+
+    // Only replace the value once the confidence dropped to zero, so
+    // that an occasional outlier doesn't evict a stable value
+    if (entry.confidence == 0)
+        entry.value = value;
+    entry.confidence.reset();
+    return false;
+}
+
+bool
+VTAGEValuePredictor::lookup(ThreadID tid, Addr pc, RegVal &value,
+                            void * &vp_history)
+{
+    VTAGEHistory *history = new VTAGEHistory;
+    vp_history = history;
+
+    const Addr addr = pc >> instShiftAmt;
+    const uint64_t ghr = globalHistory[tid];
+    history->provider = -1;
+    for (int i = 0; i < historyLengths.size(); ++i) {
+        const unsigned length = historyLengths[i];
+        const unsigned idx = (addr ^ fold(ghr, length, logTaggedSize)) &
+            mask(logTaggedSize);
+        const Addr tag = (addr ^ fold(ghr, length, tagBits) ^
+                          (fold(ghr, length, tagBits - 1) << 1)) &
+            mask(tagBits);
+        history->index.push_back(idx);
+        history->tag.push_back(tag);
+        if (taggedTables[i][idx].tag == tag)
+            history->provider = i;
+    }
+
+    const Entry &entry = history->provider < 0 ?
+        baseTable[tableIndex(pc, baseTableSize)] :
+        taggedTables[history->provider][history->index[history->provider]];
+    value = entry.value;
+    return entry.confidence.isSaturated();
+}
+
+void
+VTAGEValuePredictor::train(ThreadID tid, Addr pc, RegVal value,
+                           void *vp_history)
+{
+    VTAGEHistory *history = static_cast<VTAGEHistory *>(vp_history);
+    const int provider = history->provider;
+
+    Entry &entry = provider < 0 ?
+        baseTable[tableIndex(pc, baseTableSize)] :
+        taggedTables[provider][history->index[provider]];
+    const bool hit = provider < 0 || entry.tag == history->tag[provider];
+
+    // The entry may have been reallocated since the lookup
+    if (!hit) {
+        delete history;
+        return;
+    }
+
+    if (updateEntry(entry, value)) {
+        if (provider >= 0)
+            ++entry.useful;
+        delete history;
+        return;
+    }
+
+    if (provider >= 0)
+        --entry.useful;
+
+    // Allocate an entry in a table with a longer history
+    bool allocated = false;
+    for (int i = provider + 1; i < historyLengths.size(); ++i) {
+        Entry &victim = taggedTables[i][history->index[i]];
+        if (victim.useful == 0) {
+            victim.tag = history->tag[i];
+            victim.value = value;
+            victim.confidence.reset();
+            allocated = true;
+            break;
+        }
+    }
+
+    if (!allocated) {
+        for (int i = provider + 1; i < historyLengths.size(); ++i)
+            --taggedTables[i][history->index[i]].useful;
+    }
+
+    delete history;
+}
+
+void
+VTAGEValuePredictor::squashLookup(ThreadID tid, Addr pc, void *vp_history)
+{
+    delete static_cast<VTAGEHistory *>(vp_history);
+}
+
+void
+VTAGEValuePredictor::branchCommitted(ThreadID tid, Addr pc, bool taken)
+{
+    globalHistory[tid] = (globalHistory[tid] << 1) | taken;
+}
+
+VTAGEValuePredictor *
+VTAGEValuePredictorParams::create()
+{
+    return new VTAGEValuePredictor(this);
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_PRED_VTAGE_VPRED_HH__
+#define __CPU_PRED_VTAGE_VPRED_HH__
+
+#include <vector>
+
+#include "base/sat_counter.hh"
+#include "cpu/pred/vpred_unit.hh"
+#include "params/VTAGEValuePredictor.hh"
+
+/**
+ * Value predictor based on the VTAGE design (Perais and Seznec,
+ * HPCA 2014). An untagged table indexed by the instruction address
+ * provides the default prediction, and a set of tagged tables indexed
+ * by the address and increasingly long global branch histories
+ * override it when they hit. The longest hitting table provides the
+ * prediction.
+ *
+ * The global history is made of the outcomes of the committed
+ * branches, so there is nothing to repair on a squash.
+ */
+class VTAGEValuePredictor : public VPredUnit
+{
+  public:
+    VTAGEValuePredictor(const VTAGEValuePredictorParams *params);
+
+    void branchCommitted(ThreadID tid, Addr pc, bool taken) override;
+
+  protected:
+    bool lookup(ThreadID tid, Addr pc, RegVal &value,
+                void * &vp_history) override;
+
+    void train(ThreadID tid, Addr pc, RegVal value,
+               void *vp_history) override;
+
+    void squashLookup(ThreadID tid, Addr pc, void *vp_history) override;
+
+  private:
+    struct Entry
+    {
+        Entry(unsigned confidence_bits)
+            : tag(0), value(0), confidence(confidence_bits), useful(2)
+        {}
+
+        Addr tag;
+        RegVal value;
+        SatCounter confidence;
+        SatCounter useful;
+    };
+
+    /** State of a lookup needed to train the predictor. */
+    struct VTAGEHistory
+    {
+        /** Index of the instruction in each tagged table. */
+        std::vector<unsigned> index;
+        /** Tag of the instruction in each tagged table. */
+        std::vector<Addr> tag;
+        /** Tagged table that provided the prediction, -1 for the
+         * base table. */
+        int provider;
+    };
+
+    /** Folds the given number of bits of a history into a width. */
+    static Addr fold(uint64_t history, unsigned length, unsigned width);
+
+    /**
+     * Updates an entry with the actual value.
+     * @return Whether the entry predicted the value.
+     */
+    static bool updateEntry(Entry &entry, RegVal value);
+
+    const unsigned baseTableSize;
+
+    const unsigned logTaggedSize;
+
+    const std::vector<unsigned> historyLengths;
+
+    const unsigned tagBits;
+
+    const unsigned confidenceBits;
+
+    std::vector<Entry> baseTable;
+
+    std::vector<std::vector<Entry>> taggedTables;
+
+    /** Committed global branch history of each thread. */
+    std::vector<uint64_t> globalHistory;
+};
+
+#endif // __CPU_PRED_VTAGE_VPRED_HH__
@@ -0,0 +1,185 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/probes/function_profiler.hh"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+#include "base/loader/symtab.hh"
+#include "base/output.hh"
+#include "cpu/base.hh"
+#include "params/FunctionProfiler.hh"
+#include "sim/core.hh"
+
+FunctionProfiler::FunctionProfiler(const FunctionProfilerParams *p)
+    : ProbeListenerObject(p), cpu(p->cpu), interval(p->interval),
+      flamegraph(p->flamegraph), countdown(p->interval), lastSample(0),
+      branches(0), loads(0), stores(0),
+      profileStream(simout.create(name() + ".txt"))
+{
+    fatal_if(!interval, "%s: The sampling interval must be non-zero.\n",
+             name());
+}
+
+void
+FunctionProfiler::regProbeListeners()
+{
+    typedef ProbeListenerArg<FunctionProfiler, uint64_t> Listener;
+    listeners.push_back(new Listener(this, "RetiredInstsPC",
+                                     &FunctionProfiler::retiredInst));
+    listeners.push_back(new Listener(this, "RetiredBranches",
+                                     &FunctionProfiler::retiredBranches));
+    listeners.push_back(new Listener(this, "RetiredLoads",
+                                     &FunctionProfiler::retiredLoads));
+    listeners.push_back(new Listener(this, "RetiredStores",
+                                     &FunctionProfiler::retiredStores));
+}
+
+void
+FunctionProfiler::retiredInst(const uint64_t &pc)
+{
+    if (--countdown == 0) {
+        countdown = interval;
+        sample(pc);
+    }
+}
+
+void
+FunctionProfiler::sample(Addr pc)
+{
+    Cycles now = cpu->curCycle();
+
+    Counts &counts = pcCounts[pc];
+    counts.samples++;
+    counts.cycles += now - lastSample;
+    counts.branches += branches;
+    counts.loads += loads;
+    counts.stores += stores;
+
+    lastSample = now;
+    branches = 0;
+    loads = 0;
+    stores = 0;
+    samples++;
+}
+
+void
+FunctionProfiler::regStats()
+{
+    ProbeListenerObject::regStats();
+
+    samples
+        .name(name() + ".samples")
+        .desc("Number of committed instructions sampled")
+        ;
+
+    functions
+        .name(name() + ".functions")
+        .desc("Number of functions seen in the samples")
+        ;
+
+    unresolvedSamples
+        .name(name() + ".unresolvedSamples")
+        .desc("Number of samples at a PC without a symbol")
+        ;
+}
+
+void
+FunctionProfiler::resetStats()
+{
+    ProbeListenerObject::resetStats();
+
+    pcCounts.clear();
+    lastSample = cpu->curCycle();
+    branches = 0;
+    loads = 0;
+    stores = 0;
+}
+
+void
+FunctionProfiler::preDumpStats()
+{
+    ProbeListenerObject::preDumpStats();
+
+    // Resolve the sampled PCs now that they are needed.
+    std::map<std::string, Counts> func_counts;
+    Counter unresolved = 0;
+    for (const auto &pc_counts : pcCounts) {
+        std::string symbol;
+        Addr sym_addr;
+        if (!debugSymbolTable ||
+            !debugSymbolTable->findNearestSymbol(pc_counts.first, symbol,
+                                                 sym_addr)) {
+            symbol = "[unknown]";
+            unresolved += pc_counts.second.samples;
+        }
+        auto ret = func_counts.emplace(symbol, Counts());
+        ret.first->second += pc_counts.second;
+    }
+    functions = func_counts.size();
+    unresolvedSamples = unresolved;
+
+    std::vector<const std::pair<const std::string, Counts> *> sorted;
+    for (const auto &func : func_counts)
+        sorted.push_back(&func);
+    std::stable_sort(sorted.begin(), sorted.end(),
+        [](const std::pair<const std::string, Counts> *a,
+           const std::pair<const std::string, Counts> *b) {
+            return a->second.samples > b->second.samples;
+        });
+
+    std::ostream &os = *profileStream->stream();
+    ccprintf(os, "# %s at tick %d, a sample every %d instructions\n",
+             name(), curTick(), interval);
+    ccprintf(os, "# %10s %12s %10s %10s %10s  %s\n", "samples", "cycles",
+             "branches", "loads", "stores", "function");
+    for (const auto *func : sorted) {
+        const Counts &c = func->second;
+        ccprintf(os, "  %10d %12d %10d %10d %10d  %s\n", c.samples,
+                 c.cycles, c.branches, c.loads, c.stores, func->first);
+    }
+    ccprintf(os, "\n");
+    os.flush();
+
+    if (flamegraph) {
+        OutputStream *folded = simout.create(name() + ".folded");
+        for (const auto *func : sorted) {
+            ccprintf(*folded->stream(), "%s;%s %d\n", cpu->name(),
+                     func->first, func->second.samples);
+        }
+        simout.close(folded);
+    }
+}
+
+FunctionProfiler *
+FunctionProfilerParams::create()
+{
+    return new FunctionProfiler(this);
+}
@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __CPU_PROBES_FUNCTION_PROFILER_HH__
+#define __CPU_PROBES_FUNCTION_PROFILER_HH__
+
+#include <string>
+#include <unordered_map>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/probe/probe.hh"
+
+class BaseCPU;
+class OutputStream;
+struct FunctionProfilerParams;
+
+/**
+ * Statistical guest profiler. Every interval committed instructions
+ * the PC of the committing instruction is sampled, and the cycles,
+ * branches, loads and stores since the previous sample are charged to
+ * it. Samples are kept per PC and only resolved to functions through
+ * the debug symbol table when the stats are dumped, so profiling costs
+ * a counter decrement per instruction.
+ *
+ * At every stats dump, the profile since the last reset is appended to
+ * \<name\>.txt in the output directory. With flamegraph set, the
+ * samples are also written to \<name\>.folded in the folded stack
+ * format used by flamegraph.pl. Only the sampled function is known,
+ * so each stack is the CPU followed by that function.
+ */
+class FunctionProfiler : public ProbeListenerObject
+{
+  public:
+    FunctionProfiler(const FunctionProfilerParams *p);
+
+    void regProbeListeners() override;
+
+    void regStats() override;
+    void resetStats() override;
+    void preDumpStats() override;
+
+  protected:
+    /** Events charged to a PC or a function */
+    struct Counts
+    {
+        Counter samples;
+        Counter cycles;
+        Counter branches;
+        Counter loads;
+        Counter stores;
+
+        Counts &
+        operator+=(const Counts &other)
+        {
+            samples += other.samples;
+            cycles += other.cycles;
+            branches += other.branches;
+            loads += other.loads;
+            stores += other.stores;
+            return *this;
+        }
+    };
+
+    /** @{
+     * @name Probe listeners
+     */
+    void retiredInst(const uint64_t &pc);
+    void retiredBranches(const uint64_t &count) { branches += count; }
+    void retiredLoads(const uint64_t &count) { loads += count; }
+    void retiredStores(const uint64_t &count) { stores += count; }
+    /** @} */
+
+    /** Take a sample at a PC */
+    void sample(Addr pc);
+
+    BaseCPU *cpu;
+    const Counter interval;
+    const bool flamegraph;
+
+    /** Instructions left until the next sample */
+    Counter countdown;
+    /** Cycle of the last sample */
+    Cycles lastSample;
+    /** Events since the last sample */
+    Counter branches;
+    Counter loads;
+    Counter stores;
+
+    /** Samples per PC since the last stats reset */
+    std::unordered_map<Addr, Counts> pcCounts;
+
+    OutputStream *profileStream;
+
+    /** @{
+     * @name Statistics
+     */
+    Stats::Scalar samples;
+    Stats::Scalar functions;
+    Stats::Scalar unresolvedSamples;
+    /** @} */
+};
+
+#endif // __CPU_PROBES_FUNCTION_PROFILER_HH__
@@ -0,0 +1,164 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/sampling_controller.hh"
+
+#include <cmath>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "cpu/base.hh"
+#include "debug/Sampling.hh"
+#include "params/SamplingController.hh"
+#include "sim/core.hh"
+
+SamplingController::SamplingController(const Params *p)
+    : SimObject(p), detailedCPUs(p->detailed_cpus),
+      confidenceZ(p->confidence_z), measuring(false), startTick(0),
+      startInsts(p->detailed_cpus.size(), 0), samples(0), mean(0.0),
+      m2(0.0)
+{
+    fatal_if(p->fast_cpus.empty() ||
+             p->fast_cpus.size() != p->detailed_cpus.size(),
+             "%s: Need the same, non-zero, number of fast and detailed "
+             "CPUs.\n", name());
+    fatal_if(p->measure_insts == 0,
+             "%s: The measurement must be at least one instruction.\n",
+             name());
+}
+
+void
+SamplingController::regStats()
+{
+    SimObject::regStats();
+
+    statSamples
+        .method(this, &SamplingController::numSamples)
+        .name(name() + ".samples")
+        .desc("Number of samples measured")
+        ;
+
+    statCPIMean
+        .method(this, &SamplingController::cpiMean)
+        .name(name() + ".cpi")
+        .desc("Mean CPI of the samples")
+        .precision(6)
+        ;
+
+    statCPIStdev
+        .method(this, &SamplingController::cpiStdev)
+        .name(name() + ".cpiStdev")
+        .desc("Standard deviation of the CPI of the samples")
+        .precision(6)
+        ;
+
+    statCPIConfidence
+        .method(this, &SamplingController::cpiConfidence)
+        .name(name() + ".cpiConfidence")
+        .desc("Half-width of the confidence interval of the mean CPI")
+        .precision(6)
+        ;
+
+    statCPIRelativeError
+        .method(this, &SamplingController::cpiRelativeError)
+        .name(name() + ".cpiRelativeError")
+        .desc("Confidence interval relative to the mean CPI")
+        .precision(6)
+        ;
+}
+
+void
+SamplingController::startSample()
+{
+    panic_if(measuring, "%s: Sample started twice.\n", name());
+
+    measuring = true;
+    startTick = curTick();
+    for (int i = 0; i < detailedCPUs.size(); ++i)
+        startInsts[i] = detailedCPUs[i]->totalInsts();
+
+    DPRINTF(Sampling, "Sample %d started\n", samples);
+}
+
+void
+SamplingController::endSample()
+{
+    panic_if(!measuring, "%s: Sample ended without being started.\n",
+             name());
+    measuring = false;
+
+    // The CPUs measure the same period, so count the cycles of each
+    // one over the same number of ticks.
+    const Tick ticks = curTick() - startTick;
+    double cycles = 0;
+    Counter insts = 0;
+    for (int i = 0; i < detailedCPUs.size(); ++i) {
+        cycles += double(ticks) / detailedCPUs[i]->clockPeriod();
+        insts += detailedCPUs[i]->totalInsts() - startInsts[i];
+    }
+
+    if (!insts) {
+        warn("%s: No instructions committed in sample %d, ignoring it.\n",
+             name(), samples);
+        return;
+    }
+
+    const double cpi = cycles / insts;
+    ++samples;
+    const double delta = cpi - mean;
+    mean += delta / samples;
+    m2 += delta * (cpi - mean);
+
+    DPRINTF(Sampling, "Sample %d: %d insts, CPI %f (mean: %f +- %f)\n",
+            samples - 1, insts, cpi, mean, cpiConfidence());
+}
+
+double
+SamplingController::cpiStdev() const
+{
+    return samples > 1 ? std::sqrt(m2 / (samples - 1)) : 0.0;
+}
+
+double
+SamplingController::cpiConfidence() const
+{
+    return samples ? confidenceZ * cpiStdev() / std::sqrt(samples) : 0.0;
+}
+
+double
+SamplingController::cpiRelativeError() const
+{
+    return mean > 0 ? cpiConfidence() / mean : 0.0;
+}
+
+SamplingController *
+SamplingControllerParams::create()
+{
+    return new SamplingController(this);
+}
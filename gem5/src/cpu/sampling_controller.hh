@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_SAMPLING_CONTROLLER_HH__
+#define __CPU_SAMPLING_CONTROLLER_HH__
+
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "sim/sim_object.hh"
+
+class BaseCPU;
+struct SamplingControllerParams;
+
+/**
+ * Statistics of a SMARTS-style sampled simulation.
+ *
+ * The switching between the fast and the detailed CPUs is driven from
+ * Python (see SamplingController.run()), which calls startSample() and
+ * endSample() around each measurement. The controller records the CPI
+ * of each sample and keeps a running mean and variance of them. Since
+ * the samples span many stats resets, the statistics are computed from
+ * these running values rather than accumulated in regular stats.
+ */
+class SamplingController : public SimObject
+{
+  public:
+    typedef SamplingControllerParams Params;
+    SamplingController(const Params *p);
+
+    void regStats() override;
+
+    /** Start measuring a sample on the detailed CPUs. */
+    void startSample();
+
+    /** Finish the current sample and record its CPI. */
+    void endSample();
+
+    /** @{ */
+    /** Statistics over all the samples taken so far */
+    Counter numSamples() const { return samples; }
+    double cpiMean() const { return samples ? mean : 0.0; }
+    double cpiStdev() const;
+    /** Half-width of the confidence interval of the mean CPI */
+    double cpiConfidence() const;
+    /** cpiConfidence() relative to the mean CPI */
+    double cpiRelativeError() const;
+    /** @} */
+
+  private:
+    const std::vector<BaseCPU *> detailedCPUs;
+    const double confidenceZ;
+
+    /** Is a sample being measured? */
+    bool measuring;
+
+    /** Tick and instruction counts when the current sample started */
+    Tick startTick;
+    std::vector<Counter> startInsts;
+
+    /** Running statistics of the sample CPIs (Welford's algorithm) */
+    Counter samples;
+    double mean;
+    double m2;
+
+    Stats::Value statSamples;
+    Stats::Value statCPIMean;
+    Stats::Value statCPIStdev;
+    Stats::Value statCPIConfidence;
+    Stats::Value statCPIRelativeError;
+};
+
+#endif // __CPU_SAMPLING_CONTROLLER_HH__
@@ -40,6 +40,7 @@
 
 from m5.params import *
 from m5.objects.BaseSimpleCPU import BaseSimpleCPU
+from m5.objects.BranchTraceProbe import BranchTraceProbe
 from m5.objects.SimPoint import SimPoint
 
 class AtomicSimpleCPU(BaseSimpleCPU):
@@ -61,8 +62,19 @@ class AtomicSimpleCPU(BaseSimpleCPU):
     width = Param.Int(1, "CPU width")
     simulate_data_stalls = Param.Bool(False, "Simulate dcache stall cycles")
     simulate_inst_stalls = Param.Bool(False, "Simulate icache stall cycles")
+    mem_backdoors = Param.Bool(False, "Access memory through backdoors "
+        "handed out by the caches and memories when the stalls are not "
+        "simulated, bypassing the timing and statistics of the memory "
+        "system (useful when fast-forwarding)")
+    bb_cache_size = Param.Unsigned(0, "Number of decoded basic blocks to "
+        "cache when the instruction stalls are not simulated, 0 to disable. "
+        "The instructions of a cached block are not fetched from the "
+        "instruction cache (useful when fast-forwarding)")
 
     def addSimPointProbe(self, interval):
         simpoint = SimPoint()
         simpoint.interval = interval
         self.probeListener = simpoint
+
+    def addBranchTraceProbe(self, trace_file):
+        self.branchTraceProbe = BranchTraceProbe(trace_file=trace_file)
@@ -52,3 +52,5 @@ class BaseSimpleCPU(BaseCPU):
             exit(1)
 
     branchPred = Param.BranchPredictor(NULL, "Branch Predictor")
+    countRegAccesses = Param.Bool(True, "Count the register file accesses "
+        "in the stats, disable to speed up fast-forwarding")
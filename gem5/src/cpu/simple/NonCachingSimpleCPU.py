@@ -58,3 +58,7 @@ class NonCachingSimpleCPU(AtomicSimpleCPU):
     def support_take_over(cls):
         return True
 
+    # Access the physical memory directly through backdoors to its
+    # backing store, only MMIO and accesses with side effects are sent
+    # as packets
+    mem_backdoors = True
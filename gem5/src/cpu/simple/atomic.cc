@@ -43,6 +43,9 @@
 
 #include "cpu/simple/atomic.hh"
 
+#include <algorithm>
+#include <cstring>
+
 #include "arch/locked_mem.hh"
 #include "arch/mmapped_ipr.hh"
 #include "arch/utility.hh"
@@ -74,6 +77,9 @@ AtomicSimpleCPU::init()
     data_read_req->setContext(cid);
     data_write_req->setContext(cid);
     data_amo_req->setContext(cid);
+
+    icacheBackdoors.setLineSize(cacheLineSize());
+    dcacheBackdoors.setLineSize(cacheLineSize());
 }
 
 AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
@@ -83,11 +89,19 @@ AtomicSimpleCPU::AtomicSimpleCPU(AtomicSimpleCPUParams *p)
       width(p->width), locked(false),
       simulate_data_stalls(p->simulate_data_stalls),
       simulate_inst_stalls(p->simulate_inst_stalls),
+      bbCache(simulate_inst_stalls ? 0 : p->bb_cache_size),
+      curBlock(nullptr), curBlockInst(0), recBlock(nullptr),
       icachePort(name() + ".icache_port", this),
       dcachePort(name() + ".dcache_port", this),
+      icacheBackdoors(p->mem_backdoors && !simulate_inst_stalls),
+      dcacheBackdoors(p->mem_backdoors && !simulate_data_stalls),
       dcache_access(false), dcache_latency(0),
       ppCommit(nullptr)
 {
+    fatal_if(bbCache.enabled() && numThreads > 1,
+             "The basic block cache of %s only supports a single thread.",
+             name());
+
     _status = Idle;
     ifetch_req = std::make_shared<Request>();
     data_read_req = std::make_shared<Request>();
@@ -103,6 +117,32 @@ AtomicSimpleCPU::~AtomicSimpleCPU()
     }
 }
 
+void
+AtomicSimpleCPU::regStats()
+{
+    BaseSimpleCPU::regStats();
+
+    bbCacheHits
+        .name(name() + ".bbCacheHits")
+        .desc("Number of basic blocks found in the cache")
+        ;
+
+    bbCacheMisses
+        .name(name() + ".bbCacheMisses")
+        .desc("Number of basic blocks that were not in the cache")
+        ;
+
+    bbCacheInsts
+        .name(name() + ".bbCacheInsts")
+        .desc("Number of instructions executed from cached basic blocks")
+        ;
+
+    bbCacheInvalidations
+        .name(name() + ".bbCacheInvalidations")
+        .desc("Number of cached basic blocks dropped because of writes")
+        ;
+}
+
 DrainState
 AtomicSimpleCPU::drain()
 {
@@ -153,6 +193,9 @@ AtomicSimpleCPU::drainResume()
     DPRINTF(SimpleCPU, "Resume\n");
     verifyMemoryMode();
 
+    // The memory may have been changed while we were drained
+    flushBBCache();
+
     assert(!threadContexts.empty());
 
     _status = BaseSimpleCPU::Idle;
@@ -201,6 +244,10 @@ AtomicSimpleCPU::switchOut()
     assert(!tickEvent.scheduled());
     assert(_status == BaseSimpleCPU::Running || _status == Idle);
     assert(isCpuDrained());
+
+    icacheBackdoors.clear();
+    dcacheBackdoors.clear();
+    flushBBCache();
 }
 
 
@@ -280,6 +327,264 @@ AtomicSimpleCPU::sendPacket(MasterPort &port, const PacketPtr &pkt)
     return port.sendAtomic(pkt);
 }
 
+MemBackdoorPtr
+AtomicSimpleCPU::BackdoorSet::find(Addr addr, Addr size) const
+{
+    auto it = lines.find(addr & lineMask);
+    if (it != lines.end() && it->second->range().contains(addr + size - 1))
+        return it->second;
+
+    for (auto bd : wide) {
+        if (bd->range().contains(addr) &&
+            bd->range().contains(addr + size - 1)) {
+            return bd;
+        }
+    }
+    return nullptr;
+}
+
+bool
+AtomicSimpleCPU::BackdoorSet::access(const PacketPtr &pkt) const
+{
+    const Addr addr = pkt->getAddr();
+    const Addr size = pkt->getSize();
+    MemBackdoorPtr bd = find(addr, size);
+    if (!bd)
+        return false;
+
+    uint8_t *host = bd->ptr() + (addr - bd->range().start());
+    if (pkt->isRead() && bd->readable()) {
+        memcpy(pkt->getPtr<uint8_t>(), host, size);
+        return true;
+    } else if (pkt->isWrite() && bd->writeable()) {
+        memcpy(host, pkt->getConstPtr<uint8_t>(), size);
+        return true;
+    }
+    return false;
+}
+
+void
+AtomicSimpleCPU::BackdoorSet::add(MemBackdoorPtr backdoor)
+{
+    const AddrRange &range = backdoor->range();
+    if (!backdoor->ptr() || range.interleaved())
+        return;
+
+    if ((range.start() & lineMask) == (range.end() & lineMask)) {
+        auto &slot = lines[range.start() & lineMask];
+        if (slot == backdoor)
+            return;
+        slot = backdoor;
+    } else {
+        if (std::find(wide.begin(), wide.end(), backdoor) != wide.end())
+            return;
+        wide.push_back(backdoor);
+    }
+
+    backdoor->addInvalidationCallback(
+        [this](const MemBackdoor &bd) { remove(bd); });
+}
+
+void
+AtomicSimpleCPU::BackdoorSet::remove(const MemBackdoor &backdoor)
+{
+    auto it = lines.find(backdoor.range().start() & lineMask);
+    if (it != lines.end() && it->second == &backdoor)
+        lines.erase(it);
+
+    wide.erase(std::remove(wide.begin(), wide.end(), &backdoor), wide.end());
+}
+
+void
+AtomicSimpleCPU::BackdoorSet::clear()
+{
+    lines.clear();
+    wide.clear();
+}
+
+const AtomicSimpleCPU::BasicBlockCache::Block *
+AtomicSimpleCPU::BasicBlockCache::find(Addr paddr,
+                                       const TheISA::PCState &pc) const
+{
+    auto it = blocks.find(paddr);
+    if (it == blocks.end() || !(it->second.pc == pc))
+        return nullptr;
+    return &it->second;
+}
+
+AtomicSimpleCPU::BasicBlockCache::Block *
+AtomicSimpleCPU::BasicBlockCache::allocate(Addr paddr,
+                                           const TheISA::PCState &pc)
+{
+    auto it = blocks.find(paddr);
+    if (it == blocks.end()) {
+        if (blocks.size() >= maxBlocks)
+            clear();
+        it = blocks.emplace(paddr, Block()).first;
+        pages[page(paddr)].push_back(paddr);
+    }
+
+    // A block decoded in another mode is simply replaced
+    Block &block = it->second;
+    block.paddr = paddr;
+    block.pc = pc;
+    block.insts.clear();
+    return &block;
+}
+
+unsigned
+AtomicSimpleCPU::BasicBlockCache::invalidate(Addr paddr, Addr size)
+{
+    unsigned dropped = 0;
+    for (Addr p = page(paddr); p <= page(paddr + size - 1); ++p) {
+        auto it = pages.find(p);
+        if (it == pages.end())
+            continue;
+
+        for (auto start : it->second)
+            blocks.erase(start);
+        dropped += it->second.size();
+        pages.erase(it);
+    }
+    return dropped;
+}
+
+void
+AtomicSimpleCPU::BasicBlockCache::clear()
+{
+    blocks.clear();
+    pages.clear();
+}
+
+const AtomicSimpleCPU::BasicBlockCache::Inst *
+AtomicSimpleCPU::nextCachedInst(const TheISA::PCState &pc)
+{
+    if (curBlockInst < curBlock->insts.size() &&
+        curBlock->insts[curBlockInst].pc == pc) {
+        return &curBlock->insts[curBlockInst++];
+    }
+
+    // Either the block is done or the thread left it
+    curBlock = nullptr;
+    return nullptr;
+}
+
+const AtomicSimpleCPU::BasicBlockCache::Inst *
+AtomicSimpleCPU::startBlock(Addr paddr, const TheISA::PCState &pc,
+                           bool first_fetch)
+{
+    using Cache = BasicBlockCache;
+
+    if (recBlock) {
+        // Keep recording as long as the instructions are on the same
+        // page, as the block is only translated once
+        if (Cache::page(paddr) == Cache::page(recBlock->paddr) &&
+            Cache::page(pc.instAddr()) ==
+                Cache::page(recBlock->pc.instAddr()) &&
+            (!first_fetch || recBlock->insts.size() < Cache::MaxInsts)) {
+            return nullptr;
+        }
+        recBlock = nullptr;
+    }
+
+    // Only the instructions that start in the fetched bytes start a
+    // block
+    if (!first_fetch)
+        return nullptr;
+
+    const Cache::Block *block = bbCache.find(paddr, pc);
+    if (block && !block->insts.empty()) {
+        ++bbCacheHits;
+        curBlock = block;
+        curBlockInst = 1;
+        return &block->insts[0];
+    }
+
+    ++bbCacheMisses;
+    recBlock = bbCache.allocate(paddr, pc);
+    return nullptr;
+}
+
+void
+AtomicSimpleCPU::endBlock(const Fault &fault)
+{
+    // Instructions that write the state the decoder depends on (e.g.,
+    // the processor mode) are serializing, and so are exceptions in
+    // full system
+    if (fault != NoFault) {
+        if (FullSystem)
+            flushBBCache();
+        curBlock = nullptr;
+        recBlock = nullptr;
+        return;
+    }
+
+    // Nothing was executed if the instruction needs more bytes
+    if (!curStaticInst)
+        return;
+
+    if ((curStaticInst->isSerializeAfter() ||
+         curStaticInst->isSquashAfter()) && !curStaticInst->isSyscall()) {
+        flushBBCache();
+        return;
+    }
+
+    if (recBlock && (curStaticInst->isControl() ||
+                     curStaticInst->isSerializing() ||
+                     curStaticInst->isNonSpeculative() ||
+                     curStaticInst->isQuiesce())) {
+        recBlock = nullptr;
+    }
+}
+
+void
+AtomicSimpleCPU::invalidateCode(Addr paddr, Addr size)
+{
+    const unsigned dropped = bbCache.invalidate(paddr, size);
+    if (dropped) {
+        DPRINTF(SimpleCPU, "Dropped %d cached blocks written by %#x\n",
+                dropped, paddr);
+        bbCacheInvalidations += dropped;
+        curBlock = nullptr;
+        recBlock = nullptr;
+    }
+}
+
+void
+AtomicSimpleCPU::flushBBCache()
+{
+    bbCache.clear();
+    curBlock = nullptr;
+    recBlock = nullptr;
+}
+
+Tick
+AtomicSimpleCPU::accessMem(MasterPort &port, BackdoorSet &backdoors,
+                           const PacketPtr &pkt)
+{
+    const RequestPtr &req = pkt->req;
+
+    // Only plain accesses can bypass the memory system. Anything with
+    // side effects beyond moving data (LLSC, swaps, cache maintenance,
+    // ...) has to go through the ports.
+    if (!backdoors.enabled || req->isUncacheable() ||
+        req->isStrictlyOrdered() || req->isLLSC() || req->isLockedRMW() ||
+        req->isSwap() || req->isPrefetch() || req->isCacheMaintenance() ||
+        req->isSecure() || req->getFlags().isSet(Request::STORE_NO_DATA) ||
+        !req->getByteEnable().empty()) {
+        return sendPacket(port, pkt);
+    }
+
+    if (backdoors.access(pkt))
+        return 0;
+
+    MemBackdoorPtr backdoor = nullptr;
+    const Tick latency = port.sendAtomicBackdoor(pkt, backdoor);
+    if (backdoor)
+        backdoors.add(backdoor);
+    return latency;
+}
+
 Tick
 AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
 {
@@ -305,6 +610,8 @@ AtomicSimpleCPU::AtomicCPUDPort::recvAtomicSnoop(PacketPtr pkt)
         for (auto &t_info : cpu->threadInfo) {
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
+        if (cpu->bbCache.enabled())
+            cpu->invalidateCode(pkt->getAddr(), pkt->getSize());
     }
 
     return 0;
@@ -332,6 +639,9 @@ AtomicSimpleCPU::AtomicCPUDPort::recvFunctionalSnoop(PacketPtr pkt)
             TheISA::handleLockedSnoop(t_info->thread, pkt, cacheBlockMask);
         }
     }
+
+    if ((pkt->isInvalidate() || pkt->isWrite()) && cpu->bbCache.enabled())
+        cpu->invalidateCode(pkt->getAddr(), pkt->getSize());
 }
 
 bool
@@ -411,7 +721,8 @@ AtomicSimpleCPU::readMem(Addr addr, uint8_t * data, unsigned size,
             if (req->isMmappedIpr()) {
                 dcache_latency += TheISA::handleIprRead(thread->getTC(), &pkt);
             } else {
-                dcache_latency += sendPacket(dcachePort, &pkt);
+                dcache_latency += accessMem(dcachePort, dcacheBackdoors,
+                                            &pkt);
             }
             dcache_access = true;
 
@@ -517,10 +828,14 @@ AtomicSimpleCPU::writeMem(uint8_t *data, unsigned size, Addr addr,
                     dcache_latency +=
                         TheISA::handleIprWrite(thread->getTC(), &pkt);
                 } else {
-                    dcache_latency += sendPacket(dcachePort, &pkt);
+                    dcache_latency += accessMem(dcachePort, dcacheBackdoors,
+                                                &pkt);
 
                     // Notify other threads on this CPU of write
                     threadSnoop(&pkt, curThread);
+
+                    if (bbCache.enabled())
+                        invalidateCode(req->getPaddr(), req->getSize());
                 }
                 dcache_access = true;
                 assert(!pkt.isError());
@@ -613,6 +928,9 @@ AtomicSimpleCPU::amoMem(Addr addr, uint8_t* data, unsigned size,
             dcache_latency += TheISA::handleIprRead(thread->getTC(), &pkt);
         else {
             dcache_latency += sendPacket(dcachePort, &pkt);
+
+            if (bbCache.enabled())
+                invalidateCode(req->getPaddr(), req->getSize());
         }
 
         dcache_access = true;
@@ -671,13 +989,28 @@ AtomicSimpleCPU::tick()
 
         TheISA::PCState pcState = thread->pcState();
 
-        bool needToFetch = !isRomMicroPC(pcState.microPC()) &&
+        // The instructions of a cached basic block are neither
+        // translated, fetched nor decoded again
+        const BasicBlockCache::Inst *cached_inst =
+            curBlock ? nextCachedInst(pcState) : nullptr;
+
+        bool needToFetch = !cached_inst &&
+                           !isRomMicroPC(pcState.microPC()) &&
                            !curMacroStaticInst;
         if (needToFetch) {
             ifetch_req->taskId(taskId());
             setupFetchRequest(ifetch_req);
             fault = thread->itb->translateAtomic(ifetch_req, thread->getTC(),
                                                  BaseTLB::Execute);
+
+            if (fault == NoFault && bbCache.enabled()) {
+                cached_inst = startBlock(ifetch_req->getPaddr(), pcState,
+                                         t_info.fetchOffset == 0);
+                needToFetch = !cached_inst;
+            }
+        } else if (recBlock && isRomMicroPC(pcState.microPC())) {
+            // The microcode ROM isn't part of any block
+            recBlock = nullptr;
         }
 
         if (fault == NoFault) {
@@ -697,7 +1030,8 @@ AtomicSimpleCPU::tick()
                     Packet ifetch_pkt = Packet(ifetch_req, MemCmd::ReadReq);
                     ifetch_pkt.dataStatic(&inst);
 
-                    icache_latency = sendPacket(icachePort, &ifetch_pkt);
+                    icache_latency = accessMem(icachePort, icacheBackdoors,
+                                               &ifetch_pkt);
 
                     assert(!ifetch_pkt.isError());
 
@@ -706,7 +1040,18 @@ AtomicSimpleCPU::tick()
                 //}
             }
 
-            preExecute();
+            if (cached_inst) {
+                preExecute(cached_inst->staticInst, cached_inst->macroop,
+                           cached_inst->decodedPC);
+                ++bbCacheInsts;
+            } else {
+                preExecute();
+                if (recBlock && curStaticInst) {
+                    recBlock->insts.push_back({ pcState, thread->pcState(),
+                                                curStaticInst,
+                                                curMacroStaticInst });
+                }
+            }
 
             Tick stall_ticks = 0;
             if (curStaticInst) {
@@ -753,6 +1098,10 @@ AtomicSimpleCPU::tick()
             }
 
         }
+
+        if (bbCache.enabled())
+            endBlock(fault);
+
         if (fault != NoFault || !t_info.stayAtPC)
             advancePC(fault);
     }
@@ -43,8 +43,15 @@
 #ifndef __CPU_SIMPLE_ATOMIC_HH__
 #define __CPU_SIMPLE_ATOMIC_HH__
 
+#include <unordered_map>
+#include <vector>
+
+#include "arch/types.hh"
+#include "base/statistics.hh"
+
 #include "cpu/simple/base.hh"
 #include "cpu/simple/exec_context.hh"
+#include "mem/backdoor.hh"
 #include "mem/request.hh"
 #include "params/AtomicSimpleCPU.hh"
 #include "sim/probe/probe.hh"
@@ -105,6 +112,172 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
     virtual Tick sendPacket(MasterPort &port, const PacketPtr &pkt);
 
+    /**
+     * Backdoors handed out by the memory system through one of the
+     * ports. Backdoors are looked up by cache line, and the ones
+     * covering more than a line (e.g., a whole memory) are kept in a
+     * short list that is searched linearly.
+     */
+    class BackdoorSet
+    {
+      public:
+        BackdoorSet(bool _enabled) : enabled(_enabled), lineMask(0) {}
+
+        /** Whether the backdoors of this set are used at all. */
+        const bool enabled;
+
+        void setLineSize(Addr line_size) { lineMask = ~(line_size - 1); }
+
+        /**
+         * Complete the access through a backdoor if there is one that
+         * covers it with the right permissions.
+         *
+         * @return true if the access was done through a backdoor.
+         */
+        bool access(const PacketPtr &pkt) const;
+
+        /** Start using a backdoor, until it is invalidated. */
+        void add(MemBackdoorPtr backdoor);
+
+        /** Drop all backdoors. */
+        void clear();
+
+      private:
+        MemBackdoorPtr find(Addr addr, Addr size) const;
+        void remove(const MemBackdoor &backdoor);
+
+        Addr lineMask;
+        std::unordered_map<Addr, MemBackdoorPtr> lines;
+        std::vector<MemBackdoorPtr> wide;
+    };
+
+    /**
+     * Basic blocks of decoded instructions, looked up by the physical
+     * address of their first instruction. The instructions of a block
+     * are executed again without translating their address, fetching
+     * or decoding them as long as the thread follows the block. A
+     * block ends at the first control, serializing or nonspeculative
+     * instruction or at the end of a page, and the blocks of a page
+     * are dropped when the page is written.
+     */
+    class BasicBlockCache
+    {
+      public:
+        BasicBlockCache(unsigned max_blocks) : maxBlocks(max_blocks) {}
+
+        /** Maximum number of instructions of a block. */
+        static const unsigned MaxInsts = 64;
+
+        struct Inst
+        {
+            /** PC state of the thread before decoding the instruction. */
+            TheISA::PCState pc;
+            /** PC state of the thread once the instruction is decoded. */
+            TheISA::PCState decodedPC;
+            StaticInstPtr staticInst;
+            StaticInstPtr macroop;
+        };
+
+        struct Block
+        {
+            Addr paddr;
+            TheISA::PCState pc;
+            std::vector<Inst> insts;
+        };
+
+        /** Whether the cache is used at all. */
+        bool enabled() const { return maxBlocks != 0; }
+
+        /**
+         * Find the block starting at an instruction.
+         * @return The block, nullptr if there is none.
+         */
+        const Block *find(Addr paddr, const TheISA::PCState &pc) const;
+
+        /**
+         * Start a new, empty, block at an instruction. The cache is
+         * flushed if it is full.
+         */
+        Block *allocate(Addr paddr, const TheISA::PCState &pc);
+
+        /**
+         * Drop the blocks of the pages a write overlaps.
+         * @return The number of blocks dropped.
+         */
+        unsigned invalidate(Addr paddr, Addr size);
+
+        /** Drop all blocks. */
+        void clear();
+
+        /** Page number of a physical address. */
+        static Addr page(Addr paddr) { return paddr >> TheISA::PageShift; }
+
+      private:
+        const unsigned maxBlocks;
+        std::unordered_map<Addr, Block> blocks;
+        /** Start address of the blocks of each page. */
+        std::unordered_map<Addr, std::vector<Addr>> pages;
+    };
+
+    BasicBlockCache bbCache;
+
+    /** Cached block being executed, nullptr if none. */
+    const BasicBlockCache::Block *curBlock;
+
+    /** Index of the next instruction of the cached block. */
+    unsigned curBlockInst;
+
+    /** Block being filled with the executed instructions, if any. */
+    BasicBlockCache::Block *recBlock;
+
+    /**
+     * Return the next instruction of the cached block being executed
+     * if the thread is still following the block.
+     */
+    const BasicBlockCache::Inst *nextCachedInst(const TheISA::PCState &pc);
+
+    /**
+     * Look up the basic block cache once the address of an
+     * instruction is translated, and start executing a cached block
+     * or recording a new one.
+     * @param first_fetch Whether this is the first fetch of the
+     * instruction, as opposed to one that gets more of its bytes.
+     * @return The first instruction of the cached block, nullptr if
+     * the instruction has to be fetched.
+     */
+    const BasicBlockCache::Inst *startBlock(Addr paddr,
+                                            const TheISA::PCState &pc,
+                                            bool first_fetch);
+
+    /**
+     * Stop recording the current block after an instruction that
+     * ends it, and flush the cache if the instruction may have
+     * changed how the following ones are decoded.
+     */
+    void endBlock(const Fault &fault);
+
+    /** Drop the cached blocks of the pages a write overlaps. */
+    void invalidateCode(Addr paddr, Addr size);
+
+    /** Drop all the cached blocks. */
+    void flushBBCache();
+
+    /** Stat for the number of blocks found in the cache. */
+    Stats::Scalar bbCacheHits;
+    /** Stat for the number of blocks that were not in the cache. */
+    Stats::Scalar bbCacheMisses;
+    /** Stat for the number of instructions executed from the cache. */
+    Stats::Scalar bbCacheInsts;
+    /** Stat for the number of blocks dropped because of writes. */
+    Stats::Scalar bbCacheInvalidations;
+
+    /**
+     * Send a packet to the memory system, going through a backdoor
+     * instead if the request allows it and one is available.
+     */
+    Tick accessMem(MasterPort &port, BackdoorSet &backdoors,
+                   const PacketPtr &pkt);
+
     /**
      * An AtomicCPUPort overrides the default behaviour of the
      * recvAtomicSnoop and ignores the packet instead of panicking. It
@@ -159,6 +332,9 @@ class AtomicSimpleCPU : public BaseSimpleCPU
     AtomicCPUPort icachePort;
     AtomicCPUDPort dcachePort;
 
+    BackdoorSet icacheBackdoors;
+    BackdoorSet dcacheBackdoors;
+
 
     RequestPtr ifetch_req;
     RequestPtr data_read_req;
@@ -184,6 +360,8 @@ class AtomicSimpleCPU : public BaseSimpleCPU
 
   public:
 
+    void regStats() override;
+
     DrainState drain() override;
     void drainResume() override;
 
@@ -102,7 +102,8 @@ BaseSimpleCPU::BaseSimpleCPU(BaseSimpleCPUParams *p)
             thread = new SimpleThread(this, i, p->system, p->workload[i],
                                       p->itb, p->dtb, p->isa[i]);
         }
-        threadInfo.push_back(new SimpleExecContext(this, thread));
+        threadInfo.push_back(new SimpleExecContext(this, thread,
+                                                   p->countRegAccesses));
         ThreadContext *tc = thread->getTC();
         threadContexts.push_back(tc);
     }
@@ -483,7 +484,7 @@ BaseSimpleCPU::setupFetchRequest(const RequestPtr &req)
 
 
 void
-BaseSimpleCPU::preExecute()
+BaseSimpleCPU::startExecute()
 {
     SimpleExecContext &t_info = *threadInfo[curThread];
     SimpleThread* thread = t_info.thread;
@@ -501,6 +502,15 @@ BaseSimpleCPU::preExecute()
     // check for instruction-count-based events
     comInstEventQueue[curThread]->serviceEvents(t_info.numInst);
     system->instEventQueue.serviceEvents(system->totalNumInsts);
+}
+
+void
+BaseSimpleCPU::preExecute()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
+    startExecute();
 
     // decode the instruction
     inst = gtoh(inst);
@@ -550,6 +560,32 @@ BaseSimpleCPU::preExecute()
         curStaticInst = curMacroStaticInst->fetchMicroop(pcState.microPC());
     }
 
+    finishDecode();
+}
+
+void
+BaseSimpleCPU::preExecute(const StaticInstPtr &static_inst,
+                          const StaticInstPtr &macroop,
+                          const TheISA::PCState &pc)
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+
+    startExecute();
+
+    t_info.stayAtPC = false;
+    t_info.thread->pcState(pc);
+    curStaticInst = static_inst;
+    curMacroStaticInst = macroop;
+
+    finishDecode();
+}
+
+void
+BaseSimpleCPU::finishDecode()
+{
+    SimpleExecContext &t_info = *threadInfo[curThread];
+    SimpleThread* thread = t_info.thread;
+
     //If we decoded an instruction this "tick", record information about it.
     if (curStaticInst) {
 #if TRACING_ON
@@ -131,6 +131,14 @@ class BaseSimpleCPU : public BaseCPU
     void checkForInterrupts();
     void setupFetchRequest(const RequestPtr &req);
     void preExecute();
+    /**
+     * Set up the execution of an instruction that was decoded
+     * earlier, instead of decoding it again.
+     * @param pc PC state of the thread once the instruction is decoded.
+     */
+    void preExecute(const StaticInstPtr &static_inst,
+                    const StaticInstPtr &macroop,
+                    const TheISA::PCState &pc);
     void postExecute();
     void advancePC(const Fault &fault);
 
@@ -177,6 +185,11 @@ class BaseSimpleCPU : public BaseCPU
     void serializeThread(CheckpointOut &cp, ThreadID tid) const override;
     void unserializeThread(CheckpointIn &cp, ThreadID tid) override;
 
+  private:
+    /** Common part of preExecute before the instruction is decoded. */
+    void startExecute();
+    /** Common part of preExecute once the instruction is decoded. */
+    void finishDecode();
 };
 
 #endif // __CPU_SIMPLE_BASE_HH__
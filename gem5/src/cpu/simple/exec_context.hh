@@ -166,18 +166,32 @@ class SimpleExecContext : public ExecContext {
    // Instruction mix histogram by OpClass
    Stats::Vector statExecutedInstType;
 
+  private:
+    /** Whether the register file accesses are counted in the stats. */
+    const bool countRegAccesses;
+
+    /** Count a register file access if they are counted at all. */
+    void
+    countRegAccess(Stats::Scalar &stat) const
+    {
+        if (countRegAccesses)
+            stat++;
+    }
+
   public:
     /** Constructor */
-    SimpleExecContext(BaseSimpleCPU* _cpu, SimpleThread* _thread)
+    SimpleExecContext(BaseSimpleCPU* _cpu, SimpleThread* _thread,
+                      bool count_reg_accesses = true)
         : cpu(_cpu), thread(_thread), fetchOffset(0), stayAtPC(false),
-        numInst(0), numOp(0), numLoad(0), lastIcacheStall(0), lastDcacheStall(0)
+        numInst(0), numOp(0), numLoad(0), lastIcacheStall(0),
+        lastDcacheStall(0), countRegAccesses(count_reg_accesses)
     { }
 
     /** Reads an integer register. */
     RegVal
     readIntRegOperand(const StaticInst *si, int idx) override
     {
-        numIntRegReads++;
+        countRegAccess(numIntRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isIntReg());
         return thread->readIntReg(reg.index());
@@ -187,7 +201,7 @@ class SimpleExecContext : public ExecContext {
     void
     setIntRegOperand(const StaticInst *si, int idx, RegVal val) override
     {
-        numIntRegWrites++;
+        countRegAccess(numIntRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isIntReg());
         thread->setIntReg(reg.index(), val);
@@ -198,7 +212,7 @@ class SimpleExecContext : public ExecContext {
     RegVal
     readFloatRegOperandBits(const StaticInst *si, int idx) override
     {
-        numFpRegReads++;
+        countRegAccess(numFpRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isFloatReg());
         return thread->readFloatReg(reg.index());
@@ -209,7 +223,7 @@ class SimpleExecContext : public ExecContext {
     void
     setFloatRegOperandBits(const StaticInst *si, int idx, RegVal val) override
     {
-        numFpRegWrites++;
+        countRegAccess(numFpRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isFloatReg());
         thread->setFloatReg(reg.index(), val);
@@ -219,7 +233,7 @@ class SimpleExecContext : public ExecContext {
     const VecRegContainer &
     readVecRegOperand(const StaticInst *si, int idx) const override
     {
-        numVecRegReads++;
+        countRegAccess(numVecRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isVecReg());
         return thread->readVecReg(reg);
@@ -229,7 +243,7 @@ class SimpleExecContext : public ExecContext {
     VecRegContainer &
     getWritableVecRegOperand(const StaticInst *si, int idx) override
     {
-        numVecRegWrites++;
+        countRegAccess(numVecRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecReg());
         return thread->getWritableVecReg(reg);
@@ -240,7 +254,7 @@ class SimpleExecContext : public ExecContext {
     setVecRegOperand(const StaticInst *si, int idx,
                      const VecRegContainer& val) override
     {
-        numVecRegWrites++;
+        countRegAccess(numVecRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecReg());
         thread->setVecReg(reg, val);
@@ -253,7 +267,7 @@ class SimpleExecContext : public ExecContext {
     VecLaneT<VecElem, true>
     readVecLaneOperand(const StaticInst *si, int idx) const
     {
-        numVecRegReads++;
+        countRegAccess(numVecRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isVecReg());
         return thread->readVecLane<VecElem>(reg);
@@ -288,7 +302,7 @@ class SimpleExecContext : public ExecContext {
     setVecLaneOperandT(const StaticInst *si, int idx,
             const LD& val)
     {
-        numVecRegWrites++;
+        countRegAccess(numVecRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecReg());
         return thread->setVecLane(reg, val);
@@ -319,7 +333,7 @@ class SimpleExecContext : public ExecContext {
     VecElem
     readVecElemOperand(const StaticInst *si, int idx) const override
     {
-        numVecRegReads++;
+        countRegAccess(numVecRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isVecElem());
         return thread->readVecElem(reg);
@@ -330,7 +344,7 @@ class SimpleExecContext : public ExecContext {
     setVecElemOperand(const StaticInst *si, int idx,
                       const VecElem val) override
     {
-        numVecRegWrites++;
+        countRegAccess(numVecRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecElem());
         thread->setVecElem(reg, val);
@@ -339,7 +353,7 @@ class SimpleExecContext : public ExecContext {
     const VecPredRegContainer&
     readVecPredRegOperand(const StaticInst *si, int idx) const override
     {
-        numVecPredRegReads++;
+        countRegAccess(numVecPredRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isVecPredReg());
         return thread->readVecPredReg(reg);
@@ -348,7 +362,7 @@ class SimpleExecContext : public ExecContext {
     VecPredRegContainer&
     getWritableVecPredRegOperand(const StaticInst *si, int idx) override
     {
-        numVecPredRegWrites++;
+        countRegAccess(numVecPredRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecPredReg());
         return thread->getWritableVecPredReg(reg);
@@ -358,7 +372,7 @@ class SimpleExecContext : public ExecContext {
     setVecPredRegOperand(const StaticInst *si, int idx,
                          const VecPredRegContainer& val) override
     {
-        numVecPredRegWrites++;
+        countRegAccess(numVecPredRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isVecPredReg());
         thread->setVecPredReg(reg, val);
@@ -367,7 +381,7 @@ class SimpleExecContext : public ExecContext {
     RegVal
     readCCRegOperand(const StaticInst *si, int idx) override
     {
-        numCCRegReads++;
+        countRegAccess(numCCRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isCCReg());
         return thread->readCCReg(reg.index());
@@ -376,7 +390,7 @@ class SimpleExecContext : public ExecContext {
     void
     setCCRegOperand(const StaticInst *si, int idx, RegVal val) override
     {
-        numCCRegWrites++;
+        countRegAccess(numCCRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isCCReg());
         thread->setCCReg(reg.index(), val);
@@ -385,7 +399,7 @@ class SimpleExecContext : public ExecContext {
     RegVal
     readMiscRegOperand(const StaticInst *si, int idx) override
     {
-        numIntRegReads++;
+        countRegAccess(numIntRegReads);
         const RegId& reg = si->srcRegIdx(idx);
         assert(reg.isMiscReg());
         return thread->readMiscReg(reg.index());
@@ -394,7 +408,7 @@ class SimpleExecContext : public ExecContext {
     void
     setMiscRegOperand(const StaticInst *si, int idx, RegVal val) override
     {
-        numIntRegWrites++;
+        countRegAccess(numIntRegWrites);
         const RegId& reg = si->destRegIdx(idx);
         assert(reg.isMiscReg());
         thread->setMiscReg(reg.index(), val);
@@ -407,7 +421,7 @@ class SimpleExecContext : public ExecContext {
     RegVal
     readMiscReg(int misc_reg) override
     {
-        numIntRegReads++;
+        countRegAccess(numIntRegReads);
         return thread->readMiscReg(misc_reg);
     }
 
@@ -418,7 +432,7 @@ class SimpleExecContext : public ExecContext {
     void
     setMiscReg(int misc_reg, RegVal val) override
     {
-        numIntRegWrites++;
+        countRegAccess(numIntRegWrites);
         thread->setMiscReg(misc_reg, val);
     }
 
@@ -44,6 +44,44 @@ NonCachingSimpleCPU::NonCachingSimpleCPU(NonCachingSimpleCPUParams *p)
 {
 }
 
+void
+NonCachingSimpleCPU::init()
+{
+    AtomicSimpleCPU::init();
+
+    if (icacheBackdoors.enabled || dcacheBackdoors.enabled) {
+        for (const auto &store : system->getPhysMem().getBackingStore()) {
+            if (!store.inAddrMap)
+                continue;
+            memBackdoors.emplace_back(new MemBackdoor(
+                store.range, store.pmem,
+                MemBackdoor::Flags(MemBackdoor::Readable |
+                                   MemBackdoor::Writeable)));
+        }
+    }
+
+    if (!switchedOut())
+        addMemBackdoors();
+}
+
+void
+NonCachingSimpleCPU::takeOverFrom(BaseCPU *oldCPU)
+{
+    AtomicSimpleCPU::takeOverFrom(oldCPU);
+    addMemBackdoors();
+}
+
+void
+NonCachingSimpleCPU::addMemBackdoors()
+{
+    for (auto &backdoor : memBackdoors) {
+        if (icacheBackdoors.enabled)
+            icacheBackdoors.add(backdoor.get());
+        if (dcacheBackdoors.enabled)
+            dcacheBackdoors.add(backdoor.get());
+    }
+}
+
 void
 NonCachingSimpleCPU::verifyMemoryMode() const
 {
@@ -40,22 +40,41 @@
 #ifndef __CPU_SIMPLE_NONCACHING_HH__
 #define __CPU_SIMPLE_NONCACHING_HH__
 
+#include <memory>
+#include <vector>
+
 #include "cpu/simple/atomic.hh"
+#include "mem/backdoor.hh"
 #include "params/NonCachingSimpleCPU.hh"
 
 /**
  * The NonCachingSimpleCPU is an AtomicSimpleCPU using the
  * 'atomic_noncaching' memory mode instead of just 'atomic'.
+ *
+ * When mem_backdoors is set, the CPU accesses all of the physical
+ * memory through backdoors to the backing store, set up when the CPU
+ * becomes active. Only MMIO and accesses with side effects (LLSC,
+ * uncacheable, ...) are sent as packets.
  */
 class NonCachingSimpleCPU : public AtomicSimpleCPU
 {
   public:
     NonCachingSimpleCPU(NonCachingSimpleCPUParams *p);
 
+    void init() override;
+    void takeOverFrom(BaseCPU *oldCPU) override;
+
     void verifyMemoryMode() const override;
 
   protected:
     Tick sendPacket(MasterPort &port, const PacketPtr &pkt) override;
+
+  private:
+    /** Hand the backdoors to the whole memory to the backdoor sets */
+    void addMemBackdoors();
+
+    /** Backdoors to the backing store of the physical memory */
+    std::vector<std::unique_ptr<MemBackdoor>> memBackdoors;
 };
 
 #endif // __CPU_SIMPLE_NONCACHING_HH__
@@ -46,3 +46,6 @@ class SimPoint(ProbeListenerObject):
 
     interval = Param.UInt64(100000000, "Interval Size (insts)")
     profile_file = Param.String("simpoint.bb.gz", "BBV (output) file")
+    binary_format = Param.Bool(False,
+        "Write the BBVs in a compact binary format instead of the text "
+        "format of SimPoint 3.2")
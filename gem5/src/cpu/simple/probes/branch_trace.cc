@@ -0,0 +1,120 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/simple/probes/branch_trace.hh"
+
+#include "base/callback.hh"
+#include "sim/sim_exit.hh"
+
+namespace {
+
+const size_t bufferSize = 4096;
+
+} // anonymous namespace
+
+BranchTraceProbe::BranchTraceProbe(const BranchTraceProbeParams *p)
+    : ProbeListenerObject(p), traceStream(nullptr), insts(0)
+{
+    traceStream = simout.create(p->trace_file, true);
+    if (!traceStream)
+        fatal("unable to open branch trace_file");
+    traceStream->stream()->write(BranchTrace::magic,
+                                 sizeof(BranchTrace::magic));
+
+    buffer.reserve(bufferSize);
+    registerExitCallback(
+        new MakeCallback<BranchTraceProbe, &BranchTraceProbe::flush>(this));
+}
+
+BranchTraceProbe::~BranchTraceProbe()
+{
+    flush();
+    simout.close(traceStream);
+}
+
+void
+BranchTraceProbe::regProbeListeners()
+{
+    typedef ProbeListenerArg<BranchTraceProbe,
+                             std::pair<SimpleThread*, StaticInstPtr>>
+        CommitListener;
+    listeners.push_back(new CommitListener(this, "Commit",
+                                           &BranchTraceProbe::commit));
+}
+
+void
+BranchTraceProbe::commit(const std::pair<SimpleThread*, StaticInstPtr> &p)
+{
+    const StaticInstPtr &inst = p.second;
+
+    if (inst->isMicroop() && !inst->isLastMicroop())
+        return;
+
+    ++insts;
+    if (!inst->isControl())
+        return;
+
+    // The thread hasn't moved to the next instruction yet
+    const TheISA::PCState &pc = p.first->pcState();
+
+    BranchTrace::Record rec = {};
+    rec.pc = pc.instAddr();
+    rec.target = pc.nextInstAddr();
+    rec.insts = insts;
+    rec.flags = (pc.branching() ? BranchTrace::Taken : 0) |
+        (inst->isCondCtrl() ? BranchTrace::Conditional : 0) |
+        (inst->isIndirectCtrl() ? BranchTrace::Indirect : 0) |
+        (inst->isCall() ? BranchTrace::Call : 0) |
+        (inst->isReturn() ? BranchTrace::Return : 0);
+
+    buffer.push_back(rec);
+    insts = 0;
+
+    if (buffer.size() == bufferSize)
+        flush();
+}
+
+void
+BranchTraceProbe::flush()
+{
+    if (buffer.empty())
+        return;
+
+    traceStream->stream()->write(
+        reinterpret_cast<const char *>(buffer.data()),
+        buffer.size() * sizeof(BranchTrace::Record));
+    traceStream->stream()->flush();
+    buffer.clear();
+}
+
+BranchTraceProbe *
+BranchTraceProbeParams::create()
+{
+    return new BranchTraceProbe(this);
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
+#define __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
+
+#include <vector>
+
+#include "base/output.hh"
+#include "cpu/pred/branch_trace.hh"
+#include "cpu/simple_thread.hh"
+#include "params/BranchTraceProbe.hh"
+#include "sim/probe/probe.hh"
+
+/**
+ * Probe writing the committed branches of a simple CPU to a trace
+ * (see cpu/pred/branch_trace.hh) that can be replayed on a branch
+ * predictor by BranchTraceReplay.
+ */
+class BranchTraceProbe : public ProbeListenerObject
+{
+  public:
+    BranchTraceProbe(const BranchTraceProbeParams *params);
+    ~BranchTraceProbe();
+
+    void regProbeListeners() override;
+
+    /** Record the committed instruction if it is a branch */
+    void commit(const std::pair<SimpleThread*, StaticInstPtr> &p);
+
+    /** Write the buffered records to the trace */
+    void flush();
+
+  private:
+    /** Pointer to the trace output stream */
+    OutputStream *traceStream;
+
+    /** Instructions committed since the last branch */
+    uint32_t insts;
+
+    /** Records waiting to be written to the trace */
+    std::vector<BranchTrace::Record> buffer;
+};
+
+#endif // __CPU_SIMPLE_PROBES_BRANCH_TRACE_HH__
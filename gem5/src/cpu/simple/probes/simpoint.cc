@@ -40,20 +40,26 @@
 
 #include "cpu/simple/probes/simpoint.hh"
 
+#include <algorithm>
+
 #include "base/output.hh"
 
 SimPoint::SimPoint(const SimPointParams *p)
     : ProbeListenerObject(p),
       intervalSize(p->interval),
+      binaryOutput(p->binary_format),
       intervalCount(0),
       intervalDrift(0),
       simpointStream(NULL),
+      bbCache(bbCacheSize, BBCacheEntry{BasicBlockRange(0, 0), 0}),
       currentBBV(0, 0),
       currentBBVInstCount(0)
 {
-    simpointStream = simout.create(p->profile_file, false);
+    simpointStream = simout.create(p->profile_file, binaryOutput);
     if (!simpointStream)
         fatal("unable to open SimPoint profile_file");
+    if (binaryOutput)
+        simpointStream->stream()->write("BBV1", 4);
 }
 
 SimPoint::~SimPoint()
@@ -93,54 +99,78 @@ SimPoint::profile(const std::pair<SimpleThread*, StaticInstPtr>& p)
     if (inst->isControl()) {
         currentBBV.second = thread->pcState().instAddr();
 
-        auto map_itr = bbMap.find(currentBBV);
-        if (map_itr == bbMap.end()){
-            // If a new (previously unseen) basic block is found,
-            // add a new unique id, record num of insts and insert into bbMap.
-            BBInfo info;
-            info.id = bbMap.size() + 1;
-            info.insts = currentBBVInstCount;
-            info.count = currentBBVInstCount;
-            bbMap.insert(std::make_pair(currentBBV, info));
-        } else {
-            // If basic block is seen before, just increment the count by the
-            // number of insts in basic block.
-            BBInfo& info = map_itr->second;
-            info.count += currentBBVInstCount;
-        }
+        const uint32_t id = blockId(currentBBV);
+        if (!bbCounts[id - 1])
+            bbTouched.push_back(id);
+        bbCounts[id - 1] += currentBBVInstCount;
         currentBBVInstCount = 0;
 
         // Reached end of interval if the sum of the current inst count
         // (intervalCount) and the excessive inst count from the previous
         // interval (intervalDrift) is greater than/equal to the interval size.
         if (intervalCount + intervalDrift >= intervalSize) {
-            // summarize interval and display BBV info
-            std::vector<std::pair<uint64_t, uint64_t> > counts;
-            for (auto map_itr = bbMap.begin(); map_itr != bbMap.end();
-                    ++map_itr) {
-                BBInfo& info = map_itr->second;
-                if (info.count != 0) {
-                    counts.push_back(std::make_pair(info.id, info.count));
-                    info.count = 0;
-                }
-            }
-            std::sort(counts.begin(), counts.end());
-
-            // Print output BBV info
-            *simpointStream->stream() << "T";
-            for (auto cnt_itr = counts.begin(); cnt_itr != counts.end();
-                    ++cnt_itr) {
-                *simpointStream->stream() << ":" << cnt_itr->first
-                                << ":" << cnt_itr->second << " ";
-            }
-            *simpointStream->stream() << "\n";
-
+            dumpInterval();
             intervalDrift = (intervalCount + intervalDrift) - intervalSize;
             intervalCount = 0;
         }
     }
 }
 
+uint32_t
+SimPoint::blockId(const BasicBlockRange &bb)
+{
+    BBCacheEntry &entry =
+        bbCache[(bb.second ^ (bb.first >> 2)) & (bbCacheSize - 1)];
+    if (entry.id && entry.bb == bb)
+        return entry.id;
+
+    auto ins = bbIds.emplace(bb, bbIds.size() + 1);
+    if (ins.second) {
+        // A new (previously unseen) basic block gets the next ID
+        bbCounts.push_back(0);
+    }
+    entry.bb = bb;
+    entry.id = ins.first->second;
+    return entry.id;
+}
+
+void
+SimPoint::writeVarint(uint64_t val)
+{
+    std::ostream &os = *simpointStream->stream();
+    while (val >= 0x80) {
+        os.put(char((val & 0x7f) | 0x80));
+        val >>= 7;
+    }
+    os.put(char(val));
+}
+
+void
+SimPoint::dumpInterval()
+{
+    std::sort(bbTouched.begin(), bbTouched.end());
+
+    std::ostream &os = *simpointStream->stream();
+    if (binaryOutput) {
+        writeVarint(bbTouched.size());
+        uint32_t last_id = 0;
+        for (auto id : bbTouched) {
+            writeVarint(id - last_id);
+            writeVarint(bbCounts[id - 1]);
+            last_id = id;
+        }
+    } else {
+        os << "T";
+        for (auto id : bbTouched)
+            os << ":" << id << ":" << bbCounts[id - 1] << " ";
+        os << "\n";
+    }
+
+    for (auto id : bbTouched)
+        bbCounts[id - 1] = 0;
+    bbTouched.clear();
+}
+
 /** SimPoint SimObject */
 SimPoint*
 SimPointParams::create()
@@ -42,6 +42,7 @@
 #define __CPU_SIMPLE_PROBES_SIMPOINT_HH__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/output.hh"
 #include "cpu/simple_thread.hh"
@@ -50,6 +51,13 @@
 
 /**
  * Probe for SimPoints BBV generation
+ *
+ * By default, the BBVs are written in the text format read by
+ * SimPoint 3.2. With binary_format set, the profile starts with the
+ * magic "BBV1" and each interval is written as the LEB128 encoded
+ * number of blocks executed, followed by a (block ID delta, count)
+ * pair of LEB128 values per block, in increasing order of block ID.
+ * util/bbv_to_text.py converts such a profile to the text format.
  */
 
 /**
@@ -90,9 +98,24 @@ class SimPoint : public ProbeListenerObject
     void profile(const std::pair<SimpleThread*, StaticInstPtr>&);
 
   private:
+    /**
+     * Get the dense ID of a basic block, assigning the next free one
+     * if the block hasn't been seen before. IDs start at 1.
+     */
+    uint32_t blockId(const BasicBlockRange &bb);
+
+    /** Write the BBV of the interval that just ended */
+    void dumpInterval();
+
+    /** Write an unsigned LEB128 encoded value to the profile */
+    void writeVarint(uint64_t val);
+
     /** SimPoint profiling interval size in instructions */
     const uint64_t intervalSize;
 
+    /** Write the BBVs in the compact binary format */
+    const bool binaryOutput;
+
     /** Inst count in current basic block */
     uint64_t intervalCount;
     /** Excess inst count from previous interval*/
@@ -100,18 +123,25 @@ class SimPoint : public ProbeListenerObject
     /** Pointer to SimPoint BBV output stream */
     OutputStream *simpointStream;
 
-    /** Basic Block information */
-    struct BBInfo {
-        /** Unique ID */
-        uint64_t id;
-        /** Num of static insts in BB */
-        uint64_t insts;
-        /** Accumulated dynamic inst count executed by BB */
-        uint64_t count;
+    /** IDs of all previously seen basic blocks */
+    std::unordered_map<BasicBlockRange, uint32_t> bbIds;
+
+    /**
+     * Direct-mapped cache of recently executed blocks in front of
+     * bbIds, so that a hot block is found with a single compare.
+     */
+    struct BBCacheEntry {
+        BasicBlockRange bb;
+        uint32_t id;
     };
+    static const size_t bbCacheSize = 4096;
+    std::vector<BBCacheEntry> bbCache;
+
+    /** Dynamic inst count of each block in this interval, by ID - 1 */
+    std::vector<uint64_t> bbCounts;
+    /** IDs of the blocks executed in this interval */
+    std::vector<uint32_t> bbTouched;
 
-    /** Hash table containing all previously seen basic blocks */
-    std::unordered_map<BasicBlockRange, BBInfo> bbMap;
     /** Currently executing basic block */
     BasicBlockRange currentBBV;
     /** inst count in current basic block */
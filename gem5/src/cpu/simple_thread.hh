@@ -92,7 +92,7 @@ namespace Kernel {
  * examples.
  */
 
-class SimpleThread : public ThreadState, public ThreadContext
+class SimpleThread final : public ThreadState, public ThreadContext
 {
   protected:
     typedef TheISA::MachInst MachInst;
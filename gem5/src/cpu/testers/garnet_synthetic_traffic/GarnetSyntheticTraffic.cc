@@ -30,9 +30,12 @@
 
 #include "cpu/testers/garnet_synthetic_traffic/GarnetSyntheticTraffic.hh"
 
+#include <algorithm>
 #include <cmath>
+#include <fstream>
 #include <iomanip>
 #include <set>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -51,6 +54,10 @@ using namespace std;
 
 int TESTER_NETWORK=0;
 
+// Size in bytes of a control message in the network (see
+// Network.control_msg_size), used to pick the vnet of trace packets
+static const int CONTROL_MSG_SIZE = 8;
+
 bool
 GarnetSyntheticTraffic::CpuPort::recvTimingResp(PacketPtr pkt)
 {
@@ -67,6 +74,10 @@ GarnetSyntheticTraffic::CpuPort::recvReqRetry()
 void
 GarnetSyntheticTraffic::sendPkt(PacketPtr pkt)
 {
+    // the deadlock check starts with the first outstanding packet
+    if (numPacketsSent == numPacketsCompleted)
+        lastResponseCycle = curCycle();
+
     if (!cachePort.sendTimingReq(pkt)) {
         retryPkt = pkt; // RubyPort will retry sending
     }
@@ -81,21 +92,30 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params *p)
       retryPkt(NULL),
       size(p->memory_size),
       blockSizeBits(p->block_offset),
+      lastResponseCycle(0),
       numDestinations(p->num_dest),
       simCycles(p->sim_cycles),
       numPacketsMax(p->num_packets_max),
       numPacketsSent(0),
+      numPacketsCompleted(0),
       singleSender(p->single_sender),
       singleDest(p->single_dest),
       trafficType(p->traffic_type),
       injRate(p->inj_rate),
       injVnet(p->inj_vnet),
       precision(p->precision),
+      injProcessName(p->inj_process),
+      onCycles(p->on_cycles),
+      offCycles(p->off_cycles),
+      traceFile(p->trace_file),
+      nextInjection(0),
+      burstEnd(0),
+      noMoreInjections(false),
+      trace(nullptr),
+      traceIndex(0),
       responseLimit(p->response_limit),
       masterId(p->system->getMasterId(this))
 {
-    // set up counters
-    noResponseCycles = 0;
     schedule(tickEvent, 0);
 
     initTrafficType();
@@ -104,6 +124,18 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params *p)
     }
     traffic = trafficStringToEnum[trafficType];
 
+    initInjectionProcess();
+    if (processStringToEnum.count(injProcessName) == 0) {
+        fatal("Unknown Injection Process: %s!\n", injProcessName);
+    }
+    injProcess = processStringToEnum[injProcessName];
+
+    fatal_if(injProcess == ON_OFF_ && (onCycles < 1 || offCycles < 1),
+             "%s: on_cycles and off_cycles must be at least 1\n", name());
+    fatal_if(injProcess == TRACE_ && traceFile.empty(),
+             "%s: the trace injection process needs a trace_file\n",
+             name());
+
     id = TESTER_NETWORK++;
     DPRINTF(GarnetSyntheticTraffic,"Config Created: Name = %s , and id = %d\n",
             name(), id);
@@ -122,6 +154,24 @@ void
 GarnetSyntheticTraffic::init()
 {
     numPacketsSent = 0;
+
+    if (injProcess == BERNOULLI_)
+        return;
+
+    // The event-driven processes only wake up when a packet is due
+    if (injProcess == TRACE_) {
+        const auto &traces = loadTrace(traceFile, numDestinations);
+        if (id < traces.size())
+            trace = &traces[id];
+    } else if (injProcess == ON_OFF_) {
+        // start with a burst
+        burstEnd = geometricGap(1.0 / onCycles);
+    }
+
+    if (senderEnabled())
+        scheduleNextInjection(Cycles(0));
+    else
+        noMoreInjections = true;
 }
 
 
@@ -134,18 +184,169 @@ GarnetSyntheticTraffic::completeRequest(PacketPtr pkt)
             pkt->req->getPaddr());
 
     assert(pkt->isResponse());
-    noResponseCycles = 0;
+    lastResponseCycle = curCycle();
+    numPacketsCompleted++;
     delete pkt;
 }
 
+bool
+GarnetSyntheticTraffic::senderEnabled() const
+{
+    if (numPacketsMax >= 0 && numPacketsSent >= numPacketsMax)
+        return false;
+
+    if (singleSender >= 0 && id != singleSender)
+        return false;
+
+    return true;
+}
+
+Cycles
+GarnetSyntheticTraffic::geometricGap(double probability)
+{
+    if (probability >= 1)
+        return Cycles(1);
+
+    // inverse transform sampling, with u in (0, 1]
+    const double u = 1.0 - random_mt.random<double>();
+    return Cycles(1 + (uint64_t)floor(log(u) / log(1.0 - probability)));
+}
+
+void
+GarnetSyntheticTraffic::scheduleNextInjection(Cycles from)
+{
+    if (injProcess == TRACE_) {
+        if (trace == nullptr || traceIndex >= trace->size())
+            noMoreInjections = true;
+        else
+            nextInjection = (*trace)[traceIndex].time;
+        return;
+    }
+
+    if (injRate <= 0) {
+        noMoreInjections = true;
+        return;
+    }
+
+    nextInjection = from + geometricGap(injRate) - Cycles(1);
+    if (injProcess != ON_OFF_)
+        return;
+
+    // The process is memoryless, so a packet due after the end of the
+    // burst is dropped and the next one is drawn from the start of the
+    // next burst
+    while (nextInjection >= burstEnd) {
+        const Cycles burst_start = burstEnd + geometricGap(1.0 / offCycles);
+        burstEnd = burst_start + geometricGap(1.0 / onCycles);
+        nextInjection = burst_start + geometricGap(injRate) - Cycles(1);
+    }
+}
+
+void
+GarnetSyntheticTraffic::injectDuePkts()
+{
+    while (!noMoreInjections && nextInjection <= curCycle()) {
+        if (!senderEnabled()) {
+            noMoreInjections = true;
+            break;
+        }
+
+        if (injProcess == TRACE_) {
+            const TraceRecord &record = (*trace)[traceIndex++];
+            injectPkt(record.destination, record.vnet);
+        } else {
+            generatePkt();
+        }
+
+        scheduleNextInjection(curCycle() + Cycles(1));
+    }
+}
+
+const std::vector<std::vector<GarnetSyntheticTraffic::TraceRecord>> &
+GarnetSyntheticTraffic::loadTrace(const std::string &file_name,
+                                  int num_destinations)
+{
+    static std::map<std::string, std::vector<std::vector<TraceRecord>>>
+        traces;
+
+    auto it = traces.find(file_name);
+    if (it != traces.end())
+        return it->second;
+
+    std::ifstream file(file_name);
+    if (!file)
+        fatal("Can't open network trace %s\n", file_name);
+
+    // One packet per line: time (cycles) src dst vnet [size (bytes)].
+    // A negative vnet picks the data vnet if the packet is larger than
+    // a control message, and the first control vnet otherwise.
+    std::vector<std::vector<TraceRecord>> &sources = traces[file_name];
+    std::string line;
+    for (int line_no = 1; std::getline(file, line); line_no++) {
+        const size_t start = line.find_first_not_of(" \t");
+        if (start == std::string::npos || line[start] == '#')
+            continue;
+
+        std::istringstream fields(line);
+        uint64_t time;
+        unsigned src, dst;
+        int vnet, msg_size = CONTROL_MSG_SIZE;
+        if (!(fields >> time >> src >> dst >> vnet))
+            fatal("%s:%d: malformed trace record\n", file_name, line_no);
+        fields >> msg_size;
+
+        fatal_if(dst >= num_destinations, "%s:%d: destination %d out of "
+                 "range\n", file_name, line_no, dst);
+        fatal_if(vnet > 2, "%s:%d: vnet %d out of range\n", file_name,
+                 line_no, vnet);
+        if (vnet < 0)
+            vnet = msg_size > CONTROL_MSG_SIZE ? 2 : 0;
+
+        if (src >= sources.size())
+            sources.resize(src + 1);
+        sources[src].push_back(TraceRecord{Cycles(time), dst, vnet});
+    }
+
+    for (auto &records : sources) {
+        std::stable_sort(records.begin(), records.end(),
+                         [](const TraceRecord &a, const TraceRecord &b)
+                         { return a.time < b.time; });
+    }
+
+    return sources;
+}
+
 
 void
 GarnetSyntheticTraffic::tick()
 {
-    if (++noResponseCycles >= responseLimit) {
+    if (numPacketsCompleted < numPacketsSent &&
+        curCycle() - lastResponseCycle >= responseLimit) {
         fatal("%s deadlocked at cycle %d\n", name(), curTick());
     }
 
+    if (injProcess != BERNOULLI_) {
+        injectDuePkts();
+
+        if (curTick() >= simCycles) {
+            exitSimLoop("Network Tester completed simCycles");
+            return;
+        }
+
+        // Wake up for the next packet, the deadlock check or the end
+        // of the simulation, whichever comes first
+        Cycles wakeup = ticksToCycles(simCycles - curTick());
+        if (!noMoreInjections)
+            wakeup = std::min(wakeup, nextInjection - curCycle());
+        if (numPacketsCompleted < numPacketsSent) {
+            wakeup = std::min(wakeup, lastResponseCycle + responseLimit -
+                              curCycle());
+        }
+        if (!tickEvent.scheduled())
+            schedule(tickEvent, clockEdge(wakeup));
+        return;
+    }
+
     // make new request based on injection rate
     // (injection rate's range depends on precision)
     // - generate a random number between 0 and 10^precision
@@ -159,18 +360,8 @@ GarnetSyntheticTraffic::tick()
         sendAllowedThisCycle = false;
 
     // always generatePkt unless fixedPkts or singleSender is enabled
-    if (sendAllowedThisCycle) {
-        bool senderEnable = true;
-
-        if (numPacketsMax >= 0 && numPacketsSent >= numPacketsMax)
-            senderEnable = false;
-
-        if (singleSender >= 0 && id != singleSender)
-            senderEnable = false;
-
-        if (senderEnable)
-            generatePkt();
-    }
+    if (sendAllowedThisCycle && senderEnabled())
+        generatePkt();
 
     // Schedule wakeup
     if (curTick() >= simCycles)
@@ -242,6 +433,23 @@ GarnetSyntheticTraffic::generatePkt()
         fatal("Unknown Traffic Type: %s!\n", traffic);
     }
 
+    // Inject in specific Vnet
+    // Vnet 0 and 1 are for control packets (1-flit)
+    // Vnet 2 is for data packets (5-flit)
+    int injReqType = injVnet;
+
+    if (injReqType < 0 || injReqType > 2)
+    {
+        // randomly inject in any vnet
+        injReqType = random_mt.random(0, 2);
+    }
+
+    injectPkt(destination, injReqType);
+}
+
+void
+GarnetSyntheticTraffic::injectPkt(unsigned destination, int injReqType)
+{
     // The source of the packets is a cache.
     // The destination of the packets is a directory.
     // The destination bits are embedded in the address after byte-offset.
@@ -278,17 +486,6 @@ GarnetSyntheticTraffic::generatePkt()
     RequestPtr req = nullptr;
     Request::Flags flags;
 
-    // Inject in specific Vnet
-    // Vnet 0 and 1 are for control packets (1-flit)
-    // Vnet 2 is for data packets (5-flit)
-    int injReqType = injVnet;
-
-    if (injReqType < 0 || injReqType > 2)
-    {
-        // randomly inject in any vnet
-        injReqType = random_mt.random(0, 2);
-    }
-
     if (injReqType == 0) {
         // generate packet for virtual network 0
         requestType = MemCmd::ReadReq;
@@ -335,6 +532,15 @@ GarnetSyntheticTraffic::initTrafficType()
     trafficStringToEnum["uniform_random"] = UNIFORM_RANDOM_;
 }
 
+void
+GarnetSyntheticTraffic::initInjectionProcess()
+{
+    processStringToEnum["bernoulli"] = BERNOULLI_;
+    processStringToEnum["geometric"] = GEOMETRIC_;
+    processStringToEnum["on_off"] = ON_OFF_;
+    processStringToEnum["trace"] = TRACE_;
+}
+
 void
 GarnetSyntheticTraffic::doRetry()
 {
@@ -32,6 +32,8 @@
 #define __CPU_GARNET_SYNTHETIC_TRAFFIC_HH__
 
 #include <set>
+#include <string>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "mem/port.hh"
@@ -52,6 +54,12 @@ enum TrafficType {BIT_COMPLEMENT_ = 0,
                   UNIFORM_RANDOM_ = 7,
                   NUM_TRAFFIC_PATTERNS_};
 
+enum InjectionProcess {BERNOULLI_ = 0,
+                       GEOMETRIC_ = 1,
+                       ON_OFF_ = 2,
+                       TRACE_ = 3,
+                       NUM_INJECTION_PROCESSES_};
+
 class Packet;
 class GarnetSyntheticTraffic : public ClockedObject
 {
@@ -61,6 +69,14 @@ class GarnetSyntheticTraffic : public ClockedObject
 
     void init() override;
 
+    /** A packet of a network trace */
+    struct TraceRecord
+    {
+        Cycles time;
+        unsigned destination;
+        int vnet;
+    };
+
     // main simulation loop (one cycle)
     void tick();
 
@@ -112,15 +128,17 @@ class GarnetSyntheticTraffic : public ClockedObject
     int id;
 
     std::map<std::string, TrafficType> trafficStringToEnum;
+    std::map<std::string, InjectionProcess> processStringToEnum;
 
     unsigned blockSizeBits;
 
-    Tick noResponseCycles;
+    Cycles lastResponseCycle;
 
     int numDestinations;
     Tick simCycles;
     int numPacketsMax;
     int numPacketsSent;
+    int numPacketsCompleted;
     int singleSender;
     int singleDest;
 
@@ -130,15 +148,57 @@ class GarnetSyntheticTraffic : public ClockedObject
     int injVnet;
     int precision;
 
+    std::string injProcessName; // string
+    InjectionProcess injProcess; // enum from string
+    double onCycles;
+    double offCycles;
+    std::string traceFile;
+
+    // Cycle of the next injection, and end of the current burst for
+    // the on-off process. No injection is due if noMoreInjections.
+    Cycles nextInjection;
+    Cycles burstEnd;
+    bool noMoreInjections;
+
+    // Packets of the trace sent by this node, in time order
+    const std::vector<TraceRecord> *trace;
+    size_t traceIndex;
+
     const Cycles responseLimit;
 
     MasterID masterId;
 
     void completeRequest(PacketPtr pkt);
 
+    bool senderEnabled() const;
+
     void generatePkt();
+    void injectPkt(unsigned destination, int vnet);
     void sendPkt(PacketPtr pkt);
     void initTrafficType();
+    void initInjectionProcess();
+
+    /**
+     * Draw the number of cycles until the next event of a Bernoulli
+     * process with the given probability per cycle, at least 1.
+     */
+    Cycles geometricGap(double probability);
+
+    /**
+     * Compute the cycle of the next injection after the given cycle
+     * for the event-driven processes.
+     */
+    void scheduleNextInjection(Cycles after);
+
+    /** Inject the packets due at the current cycle. */
+    void injectDuePkts();
+
+    /**
+     * Parse a network trace, shared by all the testers reading the
+     * same file, into the packets sent by each node.
+     */
+    static const std::vector<std::vector<TraceRecord>> &
+    loadTrace(const std::string &file_name, int num_destinations);
 
     void doRetry();
 
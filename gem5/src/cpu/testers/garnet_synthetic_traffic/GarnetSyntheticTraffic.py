@@ -51,6 +51,18 @@ class GarnetSyntheticTraffic(ClockedObject):
                                 Default is to inject in all three vnets")
     precision = Param.Int(3, "Number of digits of precision \
                               after decimal point")
+    inj_process = Param.String("bernoulli", "Injection process: bernoulli \
+                        (checked every cycle), geometric (same process, \
+                        only waking up when a packet is due), on_off \
+                        (geometric within bursts) or trace")
+    on_cycles = Param.Float(100, "Mean length of the bursts in cycles \
+                                  for the on_off process")
+    off_cycles = Param.Float(900, "Mean length of the idle periods \
+                                   between bursts in cycles for the \
+                                   on_off process")
+    trace_file = Param.String("", "Network trace replayed by the trace \
+                        process, one packet per line: \
+                        time (cycles) src dst vnet [size (bytes)]")
     response_limit = Param.Cycles(5000000, "Cycles before exiting \
                                             due to lack of progress")
     test = MasterPort("Port to the memory system to test")
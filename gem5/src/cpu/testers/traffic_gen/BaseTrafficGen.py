@@ -83,6 +83,17 @@ class BaseTrafficGen(ClockedObject):
     progress_check = Param.Latency('1ms', "Time before exiting " \
                                    "due to lack of progress")
 
+    # Send up to this many packets of the periodic generators (linear,
+    # random and DRAM) in a single event. The packets of a burst are
+    # sent back to back and the generator keeps its average rate,
+    # which trades timing accuracy for simulation speed
+    max_burst = Param.Unsigned(1, "Maximum packets sent per event")
+
+    # Inflate compressed traces ahead of the trace generators in a
+    # separate host thread rather than in the simulation thread
+    trace_read_ahead = Param.Bool(True,
+                                  "Decompress traces in a separate thread")
+
     # Generator type used for applying Stream and/or Substream IDs to requests
     stream_gen = Param.StreamGenType('none',
         "Generator for adding Stream and/or Substream ID's to requests")
@@ -60,6 +60,8 @@ class PyTrafficGen(BaseTrafficGen):
         PyBindMethod("createRandom"),
         PyBindMethod("createDram"),
         PyBindMethod("createDramRot"),
+        PyBindMethod("createProfile"),
+        PyBindMethod("createSweep"),
     ]
 
     @cxxMethod(override=True)
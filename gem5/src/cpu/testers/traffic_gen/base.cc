@@ -51,8 +51,10 @@
 #include "cpu/testers/traffic_gen/exit_gen.hh"
 #include "cpu/testers/traffic_gen/idle_gen.hh"
 #include "cpu/testers/traffic_gen/linear_gen.hh"
+#include "cpu/testers/traffic_gen/profile_gen.hh"
 #include "cpu/testers/traffic_gen/random_gen.hh"
 #include "cpu/testers/traffic_gen/stream_gen.hh"
+#include "cpu/testers/traffic_gen/sweep_gen.hh"
 #include "debug/Checkpoint.hh"
 #include "debug/TrafficGen.hh"
 #include "enums/AddrMap.hh"
@@ -72,7 +74,9 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams* p)
     : ClockedObject(p),
       system(p->system),
       elasticReq(p->elastic_req),
+      traceReadAhead(p->trace_read_ahead),
       progressCheck(p->progress_check),
+      maxBurst(p->max_burst),
       noProgressEvent([this]{ noProgress(); }, name()),
       nextTransitionTick(0),
       nextPacketTick(0),
@@ -81,6 +85,7 @@ BaseTrafficGen::BaseTrafficGen(const BaseTrafficGenParams* p)
       retryPkt(NULL),
       retryPktTick(0), blockedWaitingResp(false),
       updateEvent([this]{ update(); }, name()),
+      waitingResp(0),
       stats(this),
       masterID(system->getMasterId(this)),
       streamGenerator(StreamGen::create(p))
@@ -174,57 +179,97 @@ BaseTrafficGen::update()
 
     // if we have reached the time for the next state transition, then
     // perform the transition
+    bool sent = false;
     if (curTick() >= nextTransitionTick) {
         transition();
     } else {
         assert(curTick() >= nextPacketTick);
-        // get the next packet and try to send it
-        PacketPtr pkt = activeGenerator->getNextPacket();
+        sendNextPacket();
+        sent = true;
+    }
+
+    // if we are waiting for a retry or for a response, do not schedule any
+    // further events, in the case of a transition or a successful send, go
+    // ahead and determine when the next update should take place
+    if (retryPkt == NULL) {
+        nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
+        if (sent && maxBurst > 1 && activeGenerator->periodic())
+            sendBurst();
+        if (retryPkt == NULL)
+            scheduleUpdate();
+    }
+}
 
-        // If generating stream/substream IDs are enabled,
-        // try to pick and assign them to the new packet
-        if (streamGenerator) {
-            auto sid = streamGenerator->pickStreamID();
-            auto ssid = streamGenerator->pickSubStreamID();
+void
+BaseTrafficGen::sendNextPacket()
+{
+    // get the next packet and try to send it
+    PacketPtr pkt = activeGenerator->getNextPacket();
 
-            pkt->req->setStreamId(sid);
+    // If generating stream/substream IDs are enabled,
+    // try to pick and assign them to the new packet
+    if (streamGenerator) {
+        auto sid = streamGenerator->pickStreamID();
+        auto ssid = streamGenerator->pickSubStreamID();
 
-            if (streamGenerator->ssidValid()) {
-                pkt->req->setSubStreamId(ssid);
-            }
+        pkt->req->setStreamId(sid);
+
+        if (streamGenerator->ssidValid()) {
+            pkt->req->setSubStreamId(ssid);
         }
+    }
 
-        // suppress packets that are not destined for a memory, such as
-        // device accesses that could be part of a trace
-        if (pkt && system->isMemAddr(pkt->getAddr())) {
-            stats.numPackets++;
-            // Only attempts to send if not blocked by pending responses
-            blockedWaitingResp = allocateWaitingRespSlot(pkt);
-            if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
-                retryPkt = pkt;
-                retryPktTick = curTick();
-            }
-        } else if (pkt) {
-            DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
-                    pkt->cmdString(), pkt->getAddr());
-
-            ++stats.numSuppressed;
-            if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
-                warn("%s suppressed %d packets with non-memory addresses\n",
-                     name(), stats.numSuppressed.value());
-
-            delete pkt;
-            pkt = nullptr;
+    // suppress packets that are not destined for a memory, such as
+    // device accesses that could be part of a trace
+    if (pkt && system->isMemAddr(pkt->getAddr())) {
+        stats.numPackets++;
+        // Only attempts to send if not blocked by pending responses
+        blockedWaitingResp = allocateWaitingRespSlot(pkt);
+        if (blockedWaitingResp || !port.sendTimingReq(pkt)) {
+            retryPkt = pkt;
+            retryPktTick = curTick();
         }
+    } else if (pkt) {
+        DPRINTF(TrafficGen, "Suppressed packet %s 0x%x\n",
+                pkt->cmdString(), pkt->getAddr());
+
+        ++stats.numSuppressed;
+        if (!(static_cast<int>(stats.numSuppressed.value()) % 10000))
+            warn("%s suppressed %d packets with non-memory addresses\n",
+                 name(), stats.numSuppressed.value());
+
+        delete pkt;
+        pkt = nullptr;
     }
+}
+
+void
+BaseTrafficGen::sendBurst()
+{
+    // Tick at which the last packet of the burst was due, the ticks
+    // given by a periodic generator are relative to the current tick
+    Tick burst_tick = curTick();
+    for (unsigned burst = 1; burst < maxBurst; ++burst) {
+        if (nextPacketTick == MaxTick)
+            return;
+
+        const Tick due = burst_tick + (nextPacketTick - curTick());
+        if (due >= nextTransitionTick) {
+            // the packet belongs to the next state
+            nextPacketTick = due;
+            return;
+        }
+        burst_tick = due;
+
+        sendNextPacket();
+        if (retryPkt != NULL)
+            return;
 
-    // if we are waiting for a retry or for a response, do not schedule any
-    // further events, in the case of a transition or a successful send, go
-    // ahead and determine when the next update should take place
-    if (retryPkt == NULL) {
         nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
-        scheduleUpdate();
     }
+
+    if (nextPacketTick != MaxTick)
+        nextPacketTick = burst_tick + (nextPacketTick - curTick());
 }
 
 void
@@ -270,7 +315,15 @@ BaseTrafficGen::scheduleUpdate()
 
     // schedule next update event based on either the next execute
     // tick or the next transition, which ever comes first
-    const Tick nextEventTick = std::min(nextPacketTick, nextTransitionTick);
+    Tick nextEventTick = std::min(nextPacketTick, nextTransitionTick);
+
+    // a generator waiting for responses is woken up by them, so only
+    // wake up for the next transition
+    if (activeGenerator->waitingForResponse()) {
+        if (nextTransitionTick == MaxTick)
+            return;
+        nextEventTick = nextTransitionTick;
+    }
 
     DPRINTF(TrafficGen, "Next event scheduled at %lld\n", nextEventTick);
 
@@ -448,40 +501,77 @@ BaseTrafficGen::createDramRot(Tick duration,
                                                    max_seq_count_per_rank));
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createSweep(Tick duration,
+                            Addr start_addr, Addr end_addr, Addr blocksize,
+                            uint8_t read_percent,
+                            unsigned int step_outstanding,
+                            unsigned int max_outstanding,
+                            unsigned int step_samples,
+                            unsigned int saturation_percent)
+{
+    return std::shared_ptr<BaseGen>(new SweepGen(*this, masterID,
+                                                 duration, start_addr,
+                                                 end_addr, blocksize,
+                                                 read_percent,
+                                                 step_outstanding,
+                                                 max_outstanding,
+                                                 step_samples,
+                                                 saturation_percent));
+}
+
 std::shared_ptr<BaseGen>
 BaseTrafficGen::createTrace(Tick duration,
                             const std::string& trace_file, Addr addr_offset)
 {
 #if HAVE_PROTOBUF
     return std::shared_ptr<BaseGen>(
-        new TraceGen(*this, masterID, duration, trace_file, addr_offset));
+        new TraceGen(*this, masterID, duration, trace_file, addr_offset,
+                     traceReadAhead));
 #else
     panic("Can't instantiate trace generation without Protobuf support!\n");
 #endif
 }
 
+std::shared_ptr<BaseGen>
+BaseTrafficGen::createProfile(Tick duration,
+                              const std::string& profile_file,
+                              Addr addr_offset)
+{
+    return std::shared_ptr<BaseGen>(
+        new ProfileGen(*this, masterID, duration, profile_file,
+                       addr_offset));
+}
+
 bool
 BaseTrafficGen::recvTimingResp(PacketPtr pkt)
 {
-    auto iter = waitingResp.find(pkt->req);
-
-    panic_if(iter == waitingResp.end(), "%s: "
+    panic_if(!waitingResp || pkt->req->masterId() != masterID, "%s: "
             "Received unexpected response [%s reqPtr=%x]\n",
                pkt->print(), pkt->req);
 
-    assert(iter->second <= curTick());
+    const Tick sent = pkt->req->time();
+    assert(sent <= curTick());
 
     if (pkt->isWrite()) {
         ++stats.totalWrites;
         stats.bytesWritten += pkt->req->getSize();
-        stats.totalWriteLatency += curTick() - iter->second;
+        stats.totalWriteLatency += curTick() - sent;
     } else {
         ++stats.totalReads;
         stats.bytesRead += pkt->req->getSize();
-        stats.totalReadLatency += curTick() - iter->second;
+        stats.totalReadLatency += curTick() - sent;
     }
 
-    waitingResp.erase(iter);
+    --waitingResp;
+
+    // a generator waiting for this response has to be woken up, unless
+    // we were blocked, in which case the retry takes care of it
+    const bool wake = !blockedWaitingResp && retryPkt == NULL &&
+        activeGenerator && activeGenerator->waitingForResponse();
+
+    if (activeGenerator)
+        activeGenerator->recvResponse(pkt, curTick() - sent);
 
     delete pkt;
 
@@ -491,5 +581,14 @@ BaseTrafficGen::recvTimingResp(PacketPtr pkt)
         retryReq();
     }
 
+    if (wake && !activeGenerator->waitingForResponse() &&
+        drainState() == DrainState::Running) {
+        // the update event may be pending for the next transition
+        if (updateEvent.scheduled())
+            deschedule(updateEvent);
+        nextPacketTick = activeGenerator->nextPacketTick(elasticReq, 0);
+        scheduleUpdate();
+    }
+
     return true;
 }
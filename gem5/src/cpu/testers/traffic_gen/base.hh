@@ -82,12 +82,21 @@ class BaseTrafficGen : public ClockedObject
      */
     const bool elasticReq;
 
+    /** Decompress the traces of trace generators in a separate thread */
+    const bool traceReadAhead;
+
     /**
      * Time to tolerate waiting for retries (not making progress),
      * until we declare things broken.
      */
     const Tick progressCheck;
 
+    /**
+     * Maximum number of packets of a periodic generator sent in a
+     * single update.
+     */
+    const unsigned maxBurst;
+
   private:
     /**
      * Receive a retry from the neighbouring port and attempt to
@@ -102,6 +111,18 @@ class BaseTrafficGen : public ClockedObject
     /** Transition to the next generator */
     void transition();
 
+    /** Get the next packet from the active generator and send it */
+    void sendNextPacket();
+
+    /**
+     * Send the packets following the one sent by an update right
+     * away, up to maxBurst packets in total. The time at which each
+     * packet would have been sent is accumulated, and nextPacketTick
+     * is set at the end of the burst, so the generator keeps its
+     * average rate while only paying for one event per burst.
+     */
+    void sendBurst();
+
     /**
      * Schedule the update event based on nextPacketTick and
      * nextTransitionTick.
@@ -174,26 +195,28 @@ class BaseTrafficGen : public ClockedObject
     bool blockedWaitingResp;
 
     /**
-     * Puts this packet in the waitingResp list and returns true if
-     * we are above the maximum number of oustanding requests.
+     * Counts this packet as waiting for a response and returns true
+     * if we are above the maximum number of oustanding requests.
      */
     bool allocateWaitingRespSlot(PacketPtr pkt)
     {
-        assert(waitingResp.find(pkt->req) == waitingResp.end());
         assert(pkt->needsResponse());
 
-        waitingResp[pkt->req] = curTick();
+        ++waitingResp;
 
         return (maxOutstandingReqs > 0) &&
-               (waitingResp.size() > maxOutstandingReqs);
+               (waitingResp > maxOutstandingReqs);
     }
 
     /** Event for scheduling updates */
     EventFunctionWrapper updateEvent;
 
   protected: // Stats
-    /** Reqs waiting for response **/
-    std::unordered_map<RequestPtr,Tick> waitingResp;
+    /**
+     * Number of reqs waiting for response. A req is sent on the tick
+     * it is created, so its latency is derived from its time.
+     */
+    int waitingResp;
 
     struct StatGroup : public Stats::Group {
         StatGroup(Stats::Group *parent);
@@ -293,10 +316,21 @@ class BaseTrafficGen : public ClockedObject
         unsigned int nbr_of_ranks,
         unsigned int max_seq_count_per_rank);
 
+    std::shared_ptr<BaseGen> createSweep(
+        Tick duration,
+        Addr start_addr, Addr end_addr, Addr blocksize,
+        uint8_t read_percent, unsigned int step_outstanding,
+        unsigned int max_outstanding, unsigned int step_samples,
+        unsigned int saturation_percent);
+
     std::shared_ptr<BaseGen> createTrace(
         Tick duration,
         const std::string& trace_file, Addr addr_offset);
 
+    std::shared_ptr<BaseGen> createProfile(
+        Tick duration,
+        const std::string& profile_file, Addr addr_offset);
+
   protected:
     void start();
 
@@ -67,14 +67,13 @@ BaseGen::getPacket(Addr addr, unsigned size, const MemCmd& cmd,
     // bits
     req->setPC(((Addr)masterID) << 2);
 
-    // Embed it in a packet
+    // Embed it in a packet, small payloads are stored in the packet
     PacketPtr pkt = new Packet(req, cmd);
-
-    uint8_t* pkt_data = new uint8_t[req->getSize()];
-    pkt->dataDynamic(pkt_data);
+    pkt->allocate();
 
     if (cmd.isWrite()) {
-        std::fill_n(pkt_data, req->getSize(), (uint8_t)masterID);
+        std::fill_n(pkt->getPtr<uint8_t>(), req->getSize(),
+                    (uint8_t)masterID);
     }
 
     return pkt;
@@ -132,6 +132,34 @@ class BaseGen
      */
     virtual Tick nextPacketTick(bool elastic, Tick delay) const = 0;
 
+    /**
+     * Are the ticks returned by nextPacketTick relative to the current
+     * tick (e.g. a fixed or random period)? If so, the packets of the
+     * generator can be sent in bursts.
+     *
+     * @return true if the generator is periodic
+     */
+    virtual bool periodic() const { return false; }
+
+    /**
+     * Is the generator holding back its next packet until responses
+     * to the outstanding ones are received (closed-loop generation)?
+     * While waiting, the traffic generator only wakes up again on a
+     * response or a transition.
+     *
+     * @return true if the generator waits for a response
+     */
+    virtual bool waitingForResponse() const { return false; }
+
+    /**
+     * Notify the generator of a response. The response may belong to
+     * a request sent by a previous generator. By default do nothing.
+     *
+     * @param pkt response packet
+     * @param latency ticks since the request was sent
+     */
+    virtual void recvResponse(PacketPtr pkt, Tick latency) { }
+
 };
 
 class StochasticGen : public BaseGen
@@ -144,6 +172,8 @@ class StochasticGen : public BaseGen
                   Tick min_period, Tick max_period,
                   uint8_t read_percent, Addr data_limit);
 
+    bool periodic() const override { return true; }
+
   protected:
     /** Start of address range */
     const Addr startAddr;
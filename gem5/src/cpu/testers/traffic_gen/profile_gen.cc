@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "cpu/testers/traffic_gen/profile_gen.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+
+void
+ProfileGen::Distribution::add(uint64_t count)
+{
+    cumulative.push_back(total() + count);
+}
+
+size_t
+ProfileGen::Distribution::pick() const
+{
+    assert(!empty());
+    const uint64_t val = random_mt.random<uint64_t>(0, total() - 1);
+    return std::upper_bound(cumulative.begin(), cumulative.end(), val) -
+        cumulative.begin();
+}
+
+ProfileGen::ProfileGen(SimObject &obj, MasterID master_id, Tick _duration,
+                       const std::string &profile_file, Addr addr_offset)
+    : BaseGen(obj, master_id, _duration),
+      startAddr(0), endAddr(0), blockSize(0), addrOffset(addr_offset),
+      readPercent(0), lastCold(0)
+{
+    parse(profile_file);
+}
+
+void
+ProfileGen::parse(const std::string &profile_file)
+{
+    std::ifstream in(profile_file);
+    fatal_if(!in.good(), "%s: Could not open profile %s.", name(),
+             profile_file);
+
+    std::string line;
+    std::getline(in, line);
+    fatal_if(line != "PROFILE 1", "%s: %s is not a traffic profile.",
+             name(), profile_file);
+
+    uint64_t cold = 0;
+    uint64_t random_strides = 0;
+    while (std::getline(in, line)) {
+        std::istringstream is(line);
+        std::string keyword;
+        if (!(is >> keyword) || keyword[0] == '#')
+            continue;
+
+        if (keyword == "BLOCK_SIZE") {
+            is >> blockSize;
+        } else if (keyword == "RANGE") {
+            is >> startAddr >> endAddr;
+        } else if (keyword == "READ_PERCENT") {
+            is >> readPercent;
+        } else if (keyword == "SIZE") {
+            unsigned size;
+            uint64_t count;
+            is >> size >> count;
+            sizes.push_back(size);
+            sizeDist.add(count);
+        } else if (keyword == "ITT" || keyword == "REUSE") {
+            Bin bin;
+            uint64_t count;
+            is >> bin.low >> bin.high >> count;
+            fatal_if(!is.fail() && bin.high <= bin.low,
+                     "%s: Empty %s bin in %s.", name(), keyword,
+                     profile_file);
+            if (keyword == "ITT") {
+                ittBins.push_back(bin);
+                ittDist.add(count);
+            } else {
+                reuseBins.push_back(bin);
+                reuseDist.add(count);
+            }
+        } else if (keyword == "COLD") {
+            is >> cold;
+        } else if (keyword == "STRIDE") {
+            int64_t stride;
+            uint64_t count;
+            is >> stride >> count;
+            strides.push_back(stride);
+            strideDist.add(count);
+        } else if (keyword == "RANDOM_STRIDE") {
+            is >> random_strides;
+        } else {
+            fatal("%s: Unknown keyword %s in profile %s.", name(), keyword,
+                  profile_file);
+        }
+
+        fatal_if(is.fail(), "%s: Malformed line in profile %s: %s",
+                 name(), profile_file, line);
+    }
+
+    fatal_if(blockSize == 0 || endAddr <= startAddr,
+             "%s: Profile %s needs a block size and an address range.",
+             name(), profile_file);
+    fatal_if(sizeDist.empty() || ittDist.empty(),
+             "%s: Profile %s needs request sizes and inter-arrival times.",
+             name(), profile_file);
+
+    // The last entries stand for the accesses to new blocks, and for
+    // the new blocks that don't follow any of the strides
+    reuseBins.push_back(Bin{0, 0});
+    reuseDist.add(std::max<uint64_t>(cold, 1));
+    strides.push_back(0);
+    strideDist.add(random_strides);
+
+    startAddr += addrOffset;
+    endAddr += addrOffset;
+}
+
+void
+ProfileGen::enter()
+{
+    stack.clear();
+    lastCold = startAddr;
+}
+
+Addr
+ProfileGen::coldBlock()
+{
+    const Addr num_blocks = (endAddr - startAddr) / blockSize;
+    const size_t idx = strideDist.empty() ? strides.size() - 1 :
+        strideDist.pick();
+
+    Addr block;
+    if (idx == strides.size() - 1) {
+        block = random_mt.random<Addr>(0, num_blocks - 1);
+    } else {
+        // Take the stride from the last new block, wrapping around at
+        // the ends of the range
+        const int64_t last = (lastCold - startAddr) / blockSize;
+        int64_t next = (last + strides[idx]) % (int64_t)num_blocks;
+        if (next < 0)
+            next += num_blocks;
+        block = next;
+    }
+
+    lastCold = startAddr + block * blockSize;
+    return lastCold;
+}
+
+PacketPtr
+ProfileGen::getNextPacket()
+{
+    const bool is_read = random_mt.random<double>() * 100 < readPercent;
+
+    Addr addr;
+    const size_t bin_idx = reuseDist.pick();
+    if (bin_idx == reuseBins.size() - 1 || stack.empty()) {
+        addr = coldBlock();
+    } else {
+        // Access the block at a stack distance drawn from the bin,
+        // limited by the blocks accessed so far
+        const Bin &bin = reuseBins[bin_idx];
+        const uint64_t distance = std::min<uint64_t>(
+            random_mt.random<uint64_t>(bin.low, bin.high - 1),
+            stack.size() - 1);
+        auto it = stack.end() - 1 - distance;
+        addr = *it;
+        stack.erase(it);
+    }
+
+    stack.push_back(addr);
+    if (stack.size() > maxStackDepth)
+        stack.pop_front();
+
+    const unsigned size = sizes[sizeDist.pick()];
+
+    DPRINTF(TrafficGen, "ProfileGen::getNextPacket: %c to addr %x, "
+            "size %d\n", is_read ? 'r' : 'w', addr, size);
+
+    return getPacket(addr, size, is_read ? MemCmd::ReadReq :
+                     MemCmd::WriteReq);
+}
+
+Tick
+ProfileGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    const Bin &bin = ittBins[ittDist.pick()];
+    Tick wait = random_mt.random<Tick>(bin.low, bin.high - 1);
+
+    // compensate for the delay experienced to not be elastic, by
+    // default the value we generate is from the time we are
+    // asked, so the elasticity happens automatically
+    if (!elastic) {
+        if (wait < delay)
+            wait = 0;
+        else
+            wait -= delay;
+    }
+
+    return curTick() + wait;
+}
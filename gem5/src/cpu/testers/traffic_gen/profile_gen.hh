@@ -0,0 +1,160 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Declaration of the profile generator that synthesizes a stream of
+ * requests with the statistics of a captured packet trace.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_PROFILE_GEN_HH__
+#define __CPU_TRAFFIC_GEN_PROFILE_GEN_HH__
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+/**
+ * The profile generator replays a statistical profile of a packet
+ * trace, as fitted by util/profile_packet_trace.py, instead of the
+ * trace itself. The profile holds the read/write mix, the request
+ * sizes, the inter-arrival times, the LRU stack distance of the
+ * blocks that are accessed again and the strides between the blocks
+ * accessed for the first time. Every request draws from these
+ * distributions, so the stream matches the trace in its statistics
+ * rather than packet by packet.
+ *
+ * The profile is a text file with one distribution entry per line:
+ * <pre>
+ * PROFILE 1
+ * BLOCK_SIZE <bytes>
+ * RANGE <start address> <end address>
+ * READ_PERCENT <percent>
+ * SIZE <bytes> <count>
+ * ITT <min ticks> <max ticks> <count>
+ * REUSE <min distance> <max distance> <count>
+ * COLD <count>
+ * STRIDE <blocks> <count>
+ * RANDOM_STRIDE <count>
+ * </pre>
+ * The ITT and REUSE ranges exclude their upper bound.
+ */
+class ProfileGen : public BaseGen
+{
+
+  public:
+
+    /**
+     * Create a profile generator.
+     *
+     * @param obj SimObject owning this generator
+     * @param master_id MasterID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param profile_file File to read the profile from
+     * @param addr_offset Positive offset to add to the addresses
+     */
+    ProfileGen(SimObject &obj, MasterID master_id, Tick _duration,
+               const std::string &profile_file, Addr addr_offset);
+
+    void enter();
+
+    PacketPtr getNextPacket();
+
+    Tick nextPacketTick(bool elastic, Tick delay) const;
+
+  private:
+
+    /** A bin of a distribution, drawn from uniformly */
+    struct Bin
+    {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    /**
+     * A discrete distribution, picking an entry with a probability
+     * proportional to its count in the profile.
+     */
+    struct Distribution
+    {
+        /** Cumulative count of the entries */
+        std::vector<uint64_t> cumulative;
+
+        void add(uint64_t count);
+        bool empty() const { return cumulative.empty() ||
+                                    cumulative.back() == 0; }
+        uint64_t total() const { return empty() ? 0 : cumulative.back(); }
+
+        /** Pick the index of an entry */
+        size_t pick() const;
+    };
+
+    /** Read and check the profile */
+    void parse(const std::string &profile_file);
+
+    /** Address of a block that is accessed for the first time */
+    Addr coldBlock();
+
+    /** Largest reuse distance that is tracked */
+    static const size_t maxStackDepth = 1 << 20;
+
+    /** Start and end of the address range, including the offset */
+    Addr startAddr;
+    Addr endAddr;
+
+    Addr blockSize;
+    const Addr addrOffset;
+
+    double readPercent;
+
+    std::vector<unsigned> sizes;
+    Distribution sizeDist;
+
+    std::vector<Bin> ittBins;
+    Distribution ittDist;
+
+    /** Reuse bins followed by a last entry for cold accesses */
+    std::vector<Bin> reuseBins;
+    Distribution reuseDist;
+
+    /** Strides followed by a last entry for random strides */
+    std::vector<int64_t> strides;
+    Distribution strideDist;
+
+    /** LRU stack of the blocks accessed, most recent at the back */
+    std::deque<Addr> stack;
+
+    /** The last block accessed for the first time */
+    Addr lastCold;
+};
+
+#endif
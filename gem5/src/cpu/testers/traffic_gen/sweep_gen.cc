@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "cpu/testers/traffic_gen/sweep_gen.hh"
+
+#include "base/logging.hh"
+#include "base/random.hh"
+#include "base/trace.hh"
+#include "debug/TrafficGen.hh"
+#include "sim/core.hh"
+
+SweepGen::SweepGen(SimObject &obj, MasterID master_id, Tick _duration,
+                   Addr start_addr, Addr end_addr, Addr _blocksize,
+                   uint8_t read_percent, unsigned step_outstanding,
+                   unsigned max_outstanding, unsigned step_samples,
+                   unsigned saturation_percent)
+    : BaseGen(obj, master_id, _duration),
+      startAddr(start_addr), endAddr(end_addr), blocksize(_blocksize),
+      readPercent(read_percent), stepOutstanding(step_outstanding),
+      maxOutstanding(max_outstanding), stepSamples(step_samples),
+      saturationPercent(saturation_percent),
+      enterTick(0), outstanding(0), concurrency(0), done(false),
+      stepStart(0), stepBytes(0), lastBandwidth(0)
+{
+    if (readPercent > 100)
+        fatal("%s cannot have more than 100%% reads", name());
+
+    if (stepOutstanding == 0 || stepSamples == 0)
+        fatal("%s needs at least one request and one sample per step",
+              name());
+
+    if (maxOutstanding < stepOutstanding)
+        fatal("%s cannot have fewer outstanding requests than a step",
+              name());
+}
+
+void
+SweepGen::enter()
+{
+    enterTick = curTick();
+    outstanding = 0;
+    concurrency = stepOutstanding;
+    done = false;
+    stepStart = curTick();
+    stepBytes = 0;
+    lastBandwidth = 0;
+    latencies.reset();
+}
+
+PacketPtr
+SweepGen::getNextPacket()
+{
+    // choose if we generate a read or a write here
+    bool isRead = readPercent != 0 &&
+        (readPercent == 100 || random_mt.random(0, 100) < readPercent);
+
+    // address of the request, rounded down to the start of the block
+    Addr addr = random_mt.random(startAddr, endAddr - 1);
+    addr -= addr % blocksize;
+
+    DPRINTF(TrafficGen, "SweepGen::getNextPacket: %c to addr %x, "
+            "size %d, %d outstanding\n", isRead ? 'r' : 'w', addr,
+            blocksize, outstanding);
+
+    ++outstanding;
+
+    return getPacket(addr, blocksize,
+                     isRead ? MemCmd::ReadReq : MemCmd::WriteReq);
+}
+
+Tick
+SweepGen::nextPacketTick(bool elastic, Tick delay) const
+{
+    // The next request goes out as soon as there is room for it,
+    // waitingForResponse holds it back otherwise
+    return done ? MaxTick : curTick();
+}
+
+bool
+SweepGen::waitingForResponse() const
+{
+    return !done && outstanding >= concurrency;
+}
+
+void
+SweepGen::recvResponse(PacketPtr pkt, Tick latency)
+{
+    // Ignore the responses to the requests of a previous state
+    if (done || outstanding == 0 || pkt->req->time() < enterTick)
+        return;
+
+    --outstanding;
+    stepBytes += pkt->getSize();
+    latencies.sample(latency);
+
+    if (latencies.count() == stepSamples)
+        endStep();
+}
+
+void
+SweepGen::endStep()
+{
+    const Tick elapsed = curTick() - stepStart;
+    const double bandwidth = elapsed ?
+        stepBytes * SimClock::Float::s / elapsed : 0;
+
+    inform("%s: %d outstanding: %.2f MB/s, latency p50 %.1f ns, "
+           "p99 %.1f ns, p99.9 %.1f ns\n", name(), concurrency,
+           bandwidth / 1e6,
+           latencies.percentile(50) / SimClock::Float::ns,
+           latencies.percentile(99) / SimClock::Float::ns,
+           latencies.percentile(99.9) / SimClock::Float::ns);
+
+    if (lastBandwidth > 0 &&
+        bandwidth < lastBandwidth * (1 + saturationPercent / 100.0)) {
+        inform("%s: saturated at %d outstanding requests\n", name(),
+               concurrency);
+        done = true;
+    } else if (concurrency + stepOutstanding > maxOutstanding) {
+        inform("%s: reached %d outstanding requests without saturating\n",
+               name(), concurrency);
+        done = true;
+    } else {
+        concurrency += stepOutstanding;
+        lastBandwidth = bandwidth;
+        stepStart = curTick();
+        stepBytes = 0;
+        latencies.reset();
+    }
+}
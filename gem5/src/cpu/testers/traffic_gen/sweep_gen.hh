@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/**
+ * @file
+ * Declaration of the sweep generator that measures the load/latency
+ * curve of the memory system in closed loop.
+ */
+
+#ifndef __CPU_TRAFFIC_GEN_SWEEP_GEN_HH__
+#define __CPU_TRAFFIC_GEN_SWEEP_GEN_HH__
+
+#include "base/hdr_histogram.hh"
+#include "base_gen.hh"
+#include "mem/packet.hh"
+
+/**
+ * The sweep generator is a closed-loop generator: rather than sending
+ * requests with a given period, it keeps a number of requests
+ * outstanding, and sends a new one as soon as a response comes
+ * back. The offered load is swept by raising the number of
+ * outstanding requests step by step. Each step lasts a fixed number
+ * of responses, after which the bandwidth and the latency
+ * percentiles (p50, p99 and p99.9) of the step are reported. The
+ * sweep stops once the bandwidth no longer grows by more than a
+ * given percentage from one step to the next, i.e. once the memory
+ * system is saturated, or once the maximum number of outstanding
+ * requests is reached. A single state thus gives the full
+ * bandwidth/latency curve of the memory system.
+ *
+ * The addresses are picked randomly in a range, aligned to the
+ * block size, as in the random generator.
+ */
+class SweepGen : public BaseGen
+{
+
+  public:
+
+    /**
+     * Create a sweep generator.
+     *
+     * @param obj SimObject owning this generator
+     * @param master_id MasterID related to the memory requests
+     * @param _duration duration of this state before transitioning
+     * @param start_addr Start address
+     * @param end_addr End address
+     * @param _blocksize Size used for transactions injected
+     * @param read_percent Percent of transactions that are reads
+     * @param step_outstanding Outstanding requests added at each step,
+     *                         and outstanding requests of the first step
+     * @param max_outstanding Upper limit of outstanding requests
+     * @param step_samples Responses measured at each step
+     * @param saturation_percent Bandwidth increase between two steps
+     *                           under which the sweep stops
+     */
+    SweepGen(SimObject &obj, MasterID master_id, Tick _duration,
+             Addr start_addr, Addr end_addr, Addr _blocksize,
+             uint8_t read_percent, unsigned step_outstanding,
+             unsigned max_outstanding, unsigned step_samples,
+             unsigned saturation_percent);
+
+    void enter() override;
+
+    PacketPtr getNextPacket() override;
+
+    Tick nextPacketTick(bool elastic, Tick delay) const override;
+
+    bool waitingForResponse() const override;
+
+    void recvResponse(PacketPtr pkt, Tick latency) override;
+
+  private:
+
+    /** Report the current step, and either start the next one or stop */
+    void endStep();
+
+    /** Start of address range */
+    const Addr startAddr;
+
+    /** End of address range */
+    const Addr endAddr;
+
+    /** Blocksize and address increment */
+    const Addr blocksize;
+
+    /** Percent of generated transactions that should be reads */
+    const uint8_t readPercent;
+
+    const unsigned stepOutstanding;
+    const unsigned maxOutstanding;
+    const unsigned stepSamples;
+    const unsigned saturationPercent;
+
+    /** Tick the generator was entered, older requests are not ours */
+    Tick enterTick;
+
+    /** Requests of this generator waiting for a response */
+    unsigned outstanding;
+
+    /** Outstanding requests targeted by the current step */
+    unsigned concurrency;
+
+    /** Is the sweep over? */
+    bool done;
+
+    /** Start of the current step */
+    Tick stepStart;
+
+    /** Bytes transferred in the current step */
+    uint64_t stepBytes;
+
+    /** Bandwidth of the previous step in bytes/s, 0 for the first step */
+    double lastBandwidth;
+
+    /** Latency of the responses of the current step */
+    HdrHistogram latencies;
+};
+
+#endif
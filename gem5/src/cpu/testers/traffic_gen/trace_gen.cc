@@ -49,8 +49,9 @@
 #include "debug/TrafficGen.hh"
 #include "proto/packet.pb.h"
 
-TraceGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+TraceGen::InputStream::InputStream(const std::string& filename,
+                                   bool read_ahead)
+    : trace(filename, read_ahead)
 {
     init();
 }
@@ -121,8 +121,9 @@ class TraceGen : public BaseGen
          * Create a trace input stream for a given file name.
          *
          * @param filename Path to the file to read from
+         * @param read_ahead Decompress the trace in a separate thread
          */
-        InputStream(const std::string& filename);
+        InputStream(const std::string& filename, bool read_ahead);
 
         /**
          * Reset the stream such that it can be played once
@@ -157,11 +158,13 @@ class TraceGen : public BaseGen
      * @param _duration duration of this state before transitioning
      * @param trace_file File to read the transactions from
      * @param addr_offset Positive offset to add to trace address
+     * @param read_ahead Decompress the trace in a separate thread
      */
     TraceGen(SimObject &obj, MasterID master_id, Tick _duration,
-             const std::string& trace_file, Addr addr_offset)
+             const std::string& trace_file, Addr addr_offset,
+             bool read_ahead)
         : BaseGen(obj, master_id, _duration),
-          trace(trace_file),
+          trace(trace_file, read_ahead),
           tickOffset(0),
           addrOffset(addr_offset),
           traceComplete(false)
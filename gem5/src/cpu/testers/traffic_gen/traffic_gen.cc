@@ -179,6 +179,42 @@ TrafficGen::parseConfig()
 
                     states[id] = createTrace(duration, traceFile, addrOffset);
                     DPRINTF(TrafficGen, "State: %d TraceGen\n", id);
+                } else if (mode == "PROFILE") {
+                    string profileFile;
+                    Addr addrOffset;
+
+                    is >> profileFile >> addrOffset;
+                    profileFile = resolveFile(profileFile);
+
+                    states[id] = createProfile(duration, profileFile,
+                                               addrOffset);
+                    DPRINTF(TrafficGen, "State: %d ProfileGen\n", id);
+                } else if (mode == "SWEEP") {
+                    uint32_t read_percent;
+                    Addr start_addr;
+                    Addr end_addr;
+                    Addr blocksize;
+                    unsigned int step_outstanding;
+                    unsigned int max_outstanding;
+                    unsigned int step_samples;
+                    unsigned int saturation_percent;
+
+                    is >> read_percent >> start_addr >> end_addr >>
+                        blocksize >> step_outstanding >> max_outstanding >>
+                        step_samples >> saturation_percent;
+
+                    DPRINTF(TrafficGen, "SWEEP, addr %x to %x, size %d,"
+                            " %d to %d outstanding, %d%% reads\n",
+                            start_addr, end_addr, blocksize,
+                            step_outstanding, max_outstanding,
+                            read_percent);
+
+                    states[id] = createSweep(duration, start_addr, end_addr,
+                                             blocksize, read_percent,
+                                             step_outstanding,
+                                             max_outstanding, step_samples,
+                                             saturation_percent);
+                    DPRINTF(TrafficGen, "State: %d SweepGen\n", id);
                 } else if (mode == "IDLE") {
                     states[id] = createIdle(duration);
                     DPRINTF(TrafficGen, "State: %d IdleGen\n", id);
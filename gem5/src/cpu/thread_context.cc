@@ -53,6 +53,7 @@
 #include "debug/Quiesce.hh"
 #include "kern/kernel_stats.hh"
 #include "params/BaseCPU.hh"
+#include "sim/eventq.hh"
 #include "sim/full_system.hh"
 
 void
@@ -142,6 +143,12 @@ ThreadContext::quiesce()
         getKernelStats()->quiesce();
 }
 
+void
+ThreadContext::remoteActivate()
+{
+    EventQueue::ScopedMigration migrate(getCpuPtr()->eventQueue());
+    activate();
+}
 
 void
 ThreadContext::quiesceTick(Tick resume)
@@ -177,6 +177,14 @@ class ThreadContext
     /// Set the status to Halted.
     virtual void halt() = 0;
 
+    /**
+     * Set the status to Active from code that may run on another event
+     * queue, e.g. a syscall on a different core waking this thread.
+     * Execution migrates to the event queue of the owning CPU for the
+     * duration of the call.
+     */
+    void remoteActivate();
+
     /// Quiesce thread context
     void quiesce();
 
@@ -32,7 +32,9 @@
 #ifndef __BASE_TIMEBUF_HH__
 #define __BASE_TIMEBUF_HH__
 
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <cstring>
 #include <vector>
 
@@ -49,6 +51,13 @@ class TimeBuffer
     std::vector<char *> index;
     unsigned base;
 
+    /** Only reset the entries that may have been written, see
+     *  setDirtyTracking(). */
+    bool trackDirty;
+
+    /** Whether each entry may have been written since its reset. */
+    std::vector<uint8_t> dirty;
+
     void valid(int idx) const
     {
         assert (idx >= -past && idx <= future);
@@ -131,15 +140,16 @@ class TimeBuffer
             set(index - 1);
             return wire(this, i);
         }
-        T &operator*() const { return *buffer->access(index); }
-        T *operator->() const { return buffer->access(index); }
+        T &operator*() const { return *buffer->accessWire(index); }
+        T *operator->() const { return buffer->accessWire(index); }
     };
 
 
   public:
     TimeBuffer(int p, int f)
         : past(p), future(f), size(past + future + 1),
-          data(new char[size * sizeof(T)]), index(size), base(0)
+          data(new char[size * sizeof(T)]), index(size), base(0),
+          trackDirty(false), dirty(size, 0)
     {
         assert(past >= 0 && future >= 0);
         char *ptr = data;
@@ -154,7 +164,7 @@ class TimeBuffer
     }
 
     TimeBuffer()
-        : data(NULL)
+        : data(NULL), trackDirty(false)
     {
     }
 
@@ -175,6 +185,22 @@ class TimeBuffer
         return _id;
     }
 
+    /**
+     * Only reset the entries that were accessed for writing when they
+     * go out of the buffer, so that idle cycles don't have to clear
+     * and rebuild a whole T every time the buffer advances. Any access
+     * through access() or operator[] counts as a write, as does any
+     * access through a wire at the present or the future. Wires into
+     * the past are considered read-only, so this must only be turned
+     * on for buffers whose readers never write through their wires.
+     */
+    void setDirtyTracking(bool enable)
+    {
+        trackDirty = enable;
+        // Anything may have been written before
+        std::fill(dirty.begin(), dirty.end(), 1);
+    }
+
     void
     advance()
     {
@@ -184,9 +210,14 @@ class TimeBuffer
         int ptr = base + future;
         if (ptr >= (int)size)
             ptr -= size;
+
+        if (trackDirty && !dirty[ptr])
+            return;
+
         (reinterpret_cast<T *>(index[ptr]))->~T();
         std::memset(index[ptr], 0, sizeof(T));
         new (index[ptr]) T;
+        dirty[ptr] = 0;
     }
 
   protected:
@@ -207,10 +238,22 @@ class TimeBuffer
         return vector_index;
     }
 
+    /** Access through a wire, which only writes at idx >= 0. */
+    T *accessWire(int idx)
+    {
+        int vector_index = calculateVectorIndex(idx);
+
+        if (idx >= 0)
+            dirty[vector_index] = 1;
+
+        return reinterpret_cast<T *>(index[vector_index]);
+    }
+
   public:
     T *access(int idx)
     {
         int vector_index = calculateVectorIndex(idx);
+        dirty[vector_index] = 1;
 
         return reinterpret_cast<T *>(index[vector_index]);
     }
@@ -218,6 +261,7 @@ class TimeBuffer
     T &operator[](int idx)
     {
         int vector_index = calculateVectorIndex(idx);
+        dirty[vector_index] = 1;
 
         return reinterpret_cast<T &>(*index[vector_index]);
     }
@@ -87,3 +87,8 @@ class TraceCPU(BaseCPU):
     progressMsgInterval = Param.Unsigned(0, "Interval of committed "\
                                          "instructions at which to print a"\
                                          " progress msg")
+
+    # Compressed traces are inflated ahead of the replay in a separate
+    # host thread, which takes decompression off the simulation thread.
+    traceReadAhead = Param.Bool(True, "Decompress the traces in a "\
+                                "separate thread")
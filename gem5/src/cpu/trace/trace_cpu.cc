@@ -54,7 +54,8 @@ TraceCPU::TraceCPU(TraceCPUParams *params)
         dataMasterID(params->system->getMasterId(this, "data")),
         instTraceFile(params->instTraceFile),
         dataTraceFile(params->dataTraceFile),
-        icacheGen(*this, ".iside", icachePort, instMasterID, instTraceFile),
+        icacheGen(*this, ".iside", icachePort, instMasterID, instTraceFile,
+                  params->traceReadAhead),
         dcacheGen(*this, ".dside", dcachePort, dataMasterID, dataTraceFile,
                   params),
         icacheNextEvent([this]{ schedIcacheNext(); }, name()),
@@ -323,19 +324,17 @@ TraceCPU::ElasticDataGen::init()
     if (DTRACE(TraceCPUData)) {
         printReadyList();
     }
-    auto free_itr = readyList.begin();
+    const ReadyNode &free_node = readyList.front();
     DPRINTF(TraceCPUData, "Execute tick of the first dependency free node %lli"
-            " is %d.\n", free_itr->seqNum, free_itr->execTick);
+            " is %d.\n", free_node.seqNum, free_node.execTick);
     // Return the execute tick of the earliest ready node so that an event
     // can be scheduled to call execute()
-    return (free_itr->execTick);
+    return free_node.execTick;
 }
 
 void
 TraceCPU::ElasticDataGen::adjustInitTraceOffset(Tick& offset) {
-    for (auto& free_node : readyList) {
-        free_node.execTick -= offset;
-    }
+    readyList.adjustTicks(offset);
 }
 
 void
@@ -371,6 +370,7 @@ TraceCPU::ElasticDataGen::readNextWindow()
         // to returning false.
         if (!trace.read(new_node)) {
             DPRINTF(TraceCPUData, "\tTrace complete!\n");
+            delete new_node;
             traceComplete = true;
             return false;
         }
@@ -456,14 +456,12 @@ TraceCPU::ElasticDataGen::execute()
         }
     }
     // Proceed to execute from readyList
-    auto graph_itr = depGraph.begin();
-    auto free_itr = readyList.begin();
     // Iterate through readyList until the next free node has its execute
     // tick later than curTick or the end of readyList is reached
-    while (free_itr->execTick <= curTick() && free_itr != readyList.end()) {
+    while (!readyList.empty() && readyList.front().execTick <= curTick()) {
 
         // Get pointer to the node to be executed
-        graph_itr = depGraph.find(free_itr->seqNum);
+        auto graph_itr = depGraph.find(readyList.front().seqNum);
         assert(graph_itr != depGraph.end());
         GraphNode* node_ptr = graph_itr->second;
 
@@ -491,6 +489,7 @@ TraceCPU::ElasticDataGen::execute()
         // as a retry from cache will bring the control to execute(). The
         // first node in readyList then, will be the failed node.
         if (retryPkt) {
+            readyList.pinFront();
             break;
         }
 
@@ -548,7 +547,7 @@ TraceCPU::ElasticDataGen::execute()
         }
 
         // After executing the node, remove from readyList and delete node.
-        readyList.erase(free_itr);
+        readyList.pop();
         // If it is a cacheable load which was sent, don't delete
         // just yet.  Delete it in completeMemAccess() after the
         // response is received. If it is an strictly ordered
@@ -568,8 +567,6 @@ TraceCPU::ElasticDataGen::execute()
             // remove from graph
             depGraph.erase(graph_itr);
         }
-        // Point to first node to continue to next iteration of while loop
-        free_itr = readyList.begin();
     } // end of while loop
 
     // Print readyList, sizes of queues and resource status after updating
@@ -599,7 +596,7 @@ TraceCPU::ElasticDataGen::execute()
     // list is empty then check if the next pending node has resources
     // available to issue. If yes, then schedule an event for the next cycle.
     if (!readyList.empty()) {
-        Tick next_event_tick = std::max(readyList.begin()->execTick,
+        Tick next_event_tick = std::max(readyList.front().execTick,
                                         curTick());
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
@@ -795,7 +792,7 @@ TraceCPU::ElasticDataGen::completeMemAccess(PacketPtr pkt)
         // are pending nodes in the depFreeQueue. The checking is done in the
         // execute() control flow, so schedule an event to go via that flow.
         Tick next_event_tick = readyList.empty() ? owner.clockEdge(Cycles(1)) :
-            std::max(readyList.begin()->execTick, owner.clockEdge(Cycles(1)));
+            std::max(readyList.front().execTick, owner.clockEdge(Cycles(1)));
         DPRINTF(TraceCPUData, "Attempting to schedule @%lli.\n",
                 next_event_tick);
         owner.schedDcacheNextEvent(next_event_tick);
@@ -810,50 +807,10 @@ TraceCPU::ElasticDataGen::addToSortedReadyList(NodeSeqNum seq_num,
     ready_node.seqNum = seq_num;
     ready_node.execTick = exec_tick;
 
-    // Iterator to readyList
-    auto itr = readyList.begin();
-
-    // If the readyList is empty, simply insert the new node at the beginning
-    // and return
-    if (itr == readyList.end()) {
-        readyList.insert(itr, ready_node);
-        maxReadyListSize = std::max<double>(readyList.size(),
-                                              maxReadyListSize.value());
-        return;
-    }
-
-    // If the new node has its execution tick equal to the first node in the
-    // list then go to the next node. If the first node in the list failed
-    // to execute, its position as the first is thus maintained.
-    if (retryPkt)
-        if (retryPkt->req->getReqInstSeqNum() == itr->seqNum)
-            itr++;
-
-    // Increment the iterator and compare the node pointed to by it to the new
-    // node till the position to insert the new node is found.
-    bool found = false;
-    while (!found && itr != readyList.end()) {
-        // If the execution tick of the new node is less than the node then
-        // this is the position to insert
-        if (exec_tick < itr->execTick)
-            found = true;
-        // If the execution tick of the new node is equal to the node then
-        // sort in ascending order of sequence numbers
-        else if (exec_tick == itr->execTick) {
-            // If the sequence number of the new node is less than the node
-            // then this is the position to insert
-            if (seq_num < itr->seqNum)
-                found = true;
-            // Else go to next node
-            else
-                itr++;
-        }
-        // If the execution tick of the new node is greater than the node then
-        // go to the next node
-        else
-            itr++;
-    }
-    readyList.insert(itr, ready_node);
+    // Nodes are ordered by execution tick and then by sequence number. If
+    // the first node in the list failed to execute it is pinned at the
+    // front, so its position as the first is maintained.
+    readyList.push(ready_node);
     // Update the stat for max size reached of the readyList
     maxReadyListSize = std::max<double>(readyList.size(),
                                           maxReadyListSize.value());
@@ -862,18 +819,16 @@ TraceCPU::ElasticDataGen::addToSortedReadyList(NodeSeqNum seq_num,
 void
 TraceCPU::ElasticDataGen::printReadyList() {
 
-    auto itr = readyList.begin();
-    if (itr == readyList.end()) {
+    if (readyList.empty()) {
         DPRINTF(TraceCPUData, "readyList is empty.\n");
         return;
     }
     DPRINTF(TraceCPUData, "Printing readyList:\n");
-    while (itr != readyList.end()) {
-        auto graph_itr = depGraph.find(itr->seqNum);
+    for (const auto &ready_node : readyList.sorted()) {
+        auto graph_itr = depGraph.find(ready_node.seqNum);
         GraphNode* node_ptr M5_VAR_USED = graph_itr->second;
-        DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", itr->seqNum,
-            node_ptr->typeToStr(), itr->execTick);
-        itr++;
+        DPRINTFR(TraceCPUData, "\t%lld(%s), %lld\n", ready_node.seqNum,
+            node_ptr->typeToStr(), ready_node.execTick);
     }
 }
 
@@ -1257,8 +1212,8 @@ TraceCPU::DcachePort::recvReqRetry()
 
 TraceCPU::ElasticDataGen::InputStream::InputStream(
     const std::string& filename,
-    const double time_multiplier)
-    : trace(filename),
+    const double time_multiplier, bool read_ahead)
+    : trace(filename, read_ahead),
       timeMultiplier(time_multiplier),
       microOpCount(0)
 {
@@ -1287,7 +1242,7 @@ TraceCPU::ElasticDataGen::InputStream::reset()
 bool
 TraceCPU::ElasticDataGen::InputStream::read(GraphNode* element)
 {
-    ProtoMessage::InstDepRecord pkt_msg;
+    ProtoMessage::InstDepRecord &pkt_msg = depRecord;
     if (trace.read(pkt_msg)) {
         // Required fields
         element->seqNum = pkt_msg.seq_num();
@@ -1470,8 +1425,9 @@ TraceCPU::ElasticDataGen::GraphNode::typeToStr() const
     return Record::RecordType_Name(type);
 }
 
-TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename)
-    : trace(filename)
+TraceCPU::FixedRetryGen::InputStream::InputStream(const std::string& filename,
+                                                  bool read_ahead)
+    : trace(filename, read_ahead)
 {
     // Create a protobuf message for the header and read it from the stream
     ProtoMessage::PacketHeader header_msg;
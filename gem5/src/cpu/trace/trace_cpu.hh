@@ -42,13 +42,16 @@
 #ifndef __CPU_TRACE_TRACE_CPU_HH__
 #define __CPU_TRACE_TRACE_CPU_HH__
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
+#include <functional>
 #include <queue>
 #include <set>
 #include <unordered_map>
 
 #include "arch/registers.hh"
+#include "base/pool_alloc.hh"
 #include "base/statistics.hh"
 #include "cpu/base.hh"
 #include "debug/TraceCPUData.hh"
@@ -404,8 +407,9 @@ class TraceCPU : public BaseCPU
              * Create a trace input stream for a given file name.
              *
              * @param filename Path to the file to read from
+             * @param read_ahead Decompress the trace in a separate thread
              */
-            InputStream(const std::string& filename);
+            InputStream(const std::string& filename, bool read_ahead);
 
             /**
              * Reset the stream such that it can be played once
@@ -428,11 +432,11 @@ class TraceCPU : public BaseCPU
         /* Constructor */
         FixedRetryGen(TraceCPU& _owner, const std::string& _name,
                    MasterPort& _port, MasterID master_id,
-                   const std::string& trace_file)
+                   const std::string& trace_file, bool read_ahead)
             : owner(_owner),
               port(_port),
               masterID(master_id),
-              trace(trace_file),
+              trace(trace_file, read_ahead),
               genName(owner.name() + ".fixedretry" + _name),
               retryPkt(nullptr),
               delta(0),
@@ -573,9 +577,10 @@ class TraceCPU : public BaseCPU
          * The struct GraphNode stores an instruction in the trace file. The
          * format of the trace file favours constructing a dependency graph of
          * the execution and this struct is used to encapsulate the request
-         * data as well as pointers to its dependent GraphNodes.
+         * data as well as pointers to its dependent GraphNodes. A node
+         * is created for every record in the trace, so they are pooled.
          */
-        class GraphNode {
+        class GraphNode : public PoolAllocated<GraphNode> {
 
           public:
             /**
@@ -689,6 +694,102 @@ class TraceCPU : public BaseCPU
 
             /** The tick at which the ready node must be executed */
             Tick execTick;
+
+            /** Order nodes by execute tick, then by sequence number */
+            bool
+            operator>(const ReadyNode &other) const
+            {
+                return execTick > other.execTick ||
+                    (execTick == other.execTick && seqNum > other.seqNum);
+            }
+        };
+
+        /**
+         * The nodes that are ready to execute, kept in a binary heap
+         * ordered by execute tick and sequence number. A node whose
+         * request is waiting for a retry from the cache is pinned at
+         * the front so that nodes becoming ready in the meantime don't
+         * overtake it.
+         */
+        class ReadyQueue
+        {
+          public:
+            ReadyQueue() : pinned(false) {}
+
+            bool empty() const { return !pinned && heap.empty(); }
+
+            size_t size() const { return heap.size() + pinned; }
+
+            /** The earliest node, or the pinned one */
+            const ReadyNode &
+            front() const
+            {
+                assert(!empty());
+                return pinned ? head : heap.front();
+            }
+
+            void
+            push(const ReadyNode &node)
+            {
+                heap.push_back(node);
+                std::push_heap(heap.begin(), heap.end(),
+                               std::greater<ReadyNode>());
+            }
+
+            /** Remove the front node */
+            void
+            pop()
+            {
+                if (pinned) {
+                    pinned = false;
+                } else {
+                    std::pop_heap(heap.begin(), heap.end(),
+                                  std::greater<ReadyNode>());
+                    heap.pop_back();
+                }
+            }
+
+            /** Keep the front node at the front until it is popped */
+            void
+            pinFront()
+            {
+                if (pinned)
+                    return;
+                head = front();
+                pop();
+                pinned = true;
+            }
+
+            /** Move the execute tick of all the nodes back by offset */
+            void
+            adjustTicks(Tick offset)
+            {
+                // A uniform shift keeps the heap ordered
+                for (auto &node : heap)
+                    node.execTick -= offset;
+                if (pinned)
+                    head.execTick -= offset;
+            }
+
+            /** Get the nodes in execution order, for debugging */
+            std::vector<ReadyNode>
+            sorted() const
+            {
+                std::vector<ReadyNode> nodes(heap);
+                std::sort_heap(nodes.begin(), nodes.end(),
+                               std::greater<ReadyNode>());
+                std::reverse(nodes.begin(), nodes.end());
+                if (pinned)
+                    nodes.insert(nodes.begin(), head);
+                return nodes;
+            }
+
+          private:
+            std::vector<ReadyNode> heap;
+
+            /** The pinned node, valid if pinned is set */
+            ReadyNode head;
+            bool pinned;
         };
 
         /**
@@ -816,6 +917,13 @@ class TraceCPU : public BaseCPU
              * trace and used to process the dependency trace
              */
             uint32_t windowSize;
+
+            /**
+             * Message the records are parsed into, kept around so that
+             * the storage of its repeated fields is reused
+             */
+            ProtoMessage::InstDepRecord depRecord;
+
           public:
 
             /**
@@ -823,9 +931,10 @@ class TraceCPU : public BaseCPU
              *
              * @param filename Path to the file to read from
              * @param time_multiplier used to scale the compute delays
+             * @param read_ahead Decompress the trace in a separate thread
              */
             InputStream(const std::string& filename,
-                        const double time_multiplier);
+                        const double time_multiplier, bool read_ahead);
 
             /**
              * Reset the stream such that it can be played once
@@ -859,7 +968,8 @@ class TraceCPU : public BaseCPU
             : owner(_owner),
               port(_port),
               masterID(master_id),
-              trace(trace_file, 1.0 / params->freqMultiplier),
+              trace(trace_file, 1.0 / params->freqMultiplier,
+                    params->traceReadAhead),
               genName(owner.name() + ".elastic" + _name),
               retryPkt(nullptr),
               traceComplete(false),
@@ -871,6 +981,8 @@ class TraceCPU : public BaseCPU
         {
             DPRINTF(TraceCPUData, "Window size in the trace is %d.\n",
                     windowSize);
+            // The graph holds up to two windows, don't rehash as it fills
+            depGraph.reserve(2 * windowSize);
         }
 
         /**
@@ -942,8 +1054,8 @@ class TraceCPU : public BaseCPU
         PacketPtr executeMemReq(GraphNode* node_ptr);
 
         /**
-         * Add a ready node to the readyList. When inserting, ensure the nodes
-         * are sorted in ascending order of their execute ticks.
+         * Add a ready node to the readyList, which keeps the nodes in
+         * ascending order of their execute ticks.
          *
          * @param seq_num seq. num of ready node
          * @param exec_tick the execute tick of the ready node
@@ -1043,8 +1155,8 @@ class TraceCPU : public BaseCPU
          */
         std::queue<const GraphNode*> depFreeQueue;
 
-        /** List of nodes that are ready to execute */
-        std::list<ReadyNode> readyList;
+        /** Nodes that are ready to execute */
+        ReadyQueue readyList;
 
         /** Stats for data memory accesses replayed. */
         Stats::Scalar maxDependents;
@@ -93,6 +93,20 @@ class DmaDevice(PioDevice):
         "Substream identifier used by an IOMMU to distinguish amongst "
         "several devices attached to it")
 
+    # In atomic mode, DMAs can copy whole ranges through the backdoors
+    # of the memories rather than send a packet per cache line. The
+    # crossbars only hand out backdoors when nothing above them needs
+    # to be snooped.
+    mem_backdoors = Param.Bool(False, "Do atomic DMAs through memory "
+                               "backdoors when possible")
+    # In timing mode, DMAs can be done as bursts, which move the data
+    # functionally and complete after a latency and the time the data
+    # takes at the burst bandwidth, rather than timing every packet.
+    dma_bursts = Param.Bool(False, "Model timing DMAs as bursts")
+    dma_burst_bandwidth = Param.MemoryBandwidth('12.8GB/s',
+        "Bandwidth of DMA bursts")
+    dma_burst_latency = Param.Latency('100ns', "Latency of DMA bursts")
+
     def addIommuProperty(self, state, node):
         """
         This method takes an FdtState and a FdtNode as parameters, and
@@ -187,6 +187,14 @@ class Gicv3Its(BasicPioDevice):
     # ID_bits [12:8] = 0b11111: ITS supports 31 EventID bits
     gits_typer = Param.UInt64(0x30023F01, "GITS_TYPER RO value")
 
+    device_cache_entries = Param.Unsigned(64,
+        "Number of cached device table entries (0 disables the cache)")
+    itt_cache_entries = Param.Unsigned(256,
+        "Number of cached interrupt translation table entries "
+        "(0 disables the cache)")
+    collection_cache_entries = Param.Unsigned(64,
+        "Number of cached collection table entries (0 disables the cache)")
+
     def generateDeviceTree(self, state):
         node = self.generateBasicPioDeviceNode(state, "gic-its", self.pio_addr,
                                                self.pio_size)
@@ -40,6 +40,8 @@
 
 #include "dev/arm/generic_timer.hh"
 
+#include <algorithm>
+
 #include "arch/arm/system.hh"
 #include "debug/Timer.hh"
 #include "dev/arm/base_gic.hh"
@@ -48,7 +50,8 @@
 #include "params/GenericTimerMem.hh"
 
 SystemCounter::SystemCounter()
-    : _freq(0), _period(0), _resetTick(0), _regCntkctl(0)
+    : _freq(0), _period(0), _resetTick(0), _valueTick(MaxTick), _value(0),
+      _regCntkctl(0)
 {
     setFreq(0x01800000);
 }
@@ -63,6 +66,7 @@ SystemCounter::setFreq(uint32_t freq)
     _freq = freq;
     _period = (1.0 / freq) * SimClock::Frequency;
     _resetTick = curTick();
+    _valueTick = MaxTick;
 }
 
 void
@@ -87,6 +91,7 @@ SystemCounter::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_freq);
     UNSERIALIZE_SCALAR(_period);
     UNSERIALIZE_SCALAR(_resetTick);
+    _valueTick = MaxTick;
 }
 
 
@@ -98,8 +103,34 @@ ArchTimer::ArchTimer(const std::string &name,
     : _name(name), _parent(parent), _systemCounter(sysctr),
       _interrupt(interrupt),
       _control(0), _counterLimit(0), _offset(0),
-      _counterLimitReachedEvent([this]{ counterLimitReached(); }, name)
+      _counterLimitReachedEvent([this]{ deadlineReached(); }, name),
+      _deadline(MaxTick)
+{
+}
+
+void
+ArchTimer::setDeadline(Tick when)
+{
+    if (when == _deadline)
+        return;
+
+    _deadline = when;
+
+    if (_deadlineChanged) {
+        _deadlineChanged();
+    } else if (when == MaxTick) {
+        if (_counterLimitReachedEvent.scheduled())
+            _parent.deschedule(_counterLimitReachedEvent);
+    } else {
+        _parent.reschedule(_counterLimitReachedEvent, when, true);
+    }
+}
+
+void
+ArchTimer::deadlineReached()
 {
+    _deadline = MaxTick;
+    counterLimitReached();
 }
 
 void
@@ -124,16 +155,16 @@ ArchTimer::counterLimitReached()
 void
 ArchTimer::updateCounter()
 {
-    if (_counterLimitReachedEvent.scheduled())
-        _parent.deschedule(_counterLimitReachedEvent);
     if (value() >= _counterLimit) {
+        setDeadline(MaxTick);
         counterLimitReached();
     } else {
         _control.istatus = 0;
         if (scheduleEvents()) {
             const auto period(_systemCounter.period());
-            _parent.schedule(_counterLimitReachedEvent,
-                 curTick() + (_counterLimit - value()) * period);
+            setDeadline(curTick() + (_counterLimit - value()) * period);
+        } else {
+            setDeadline(MaxTick);
         }
     }
 }
@@ -207,8 +238,7 @@ ArchTimer::unserialize(CheckpointIn &cp)
 DrainState
 ArchTimer::drain()
 {
-    if (_counterLimitReachedEvent.scheduled())
-        _parent.deschedule(_counterLimitReachedEvent);
+    setDeadline(MaxTick);
 
     return DrainState::Drained;
 }
@@ -219,6 +249,31 @@ ArchTimer::drainResume()
     updateCounter();
 }
 
+void
+GenericTimer::CoreTimers::updateEvent()
+{
+    const Tick when = std::min({physS.deadline(), physNS.deadline(),
+                                virt.deadline(), hyp.deadline()});
+
+    if (when == MaxTick) {
+        if (event.scheduled())
+            parent.deschedule(event);
+    } else if (!event.scheduled() || event.when() != when) {
+        parent.reschedule(event, when, true);
+    }
+}
+
+void
+GenericTimer::CoreTimers::eventFired()
+{
+    for (ArchTimer *timer : {&physS, &physNS, &virt, &hyp}) {
+        if (timer->deadline() <= curTick())
+            timer->deadlineReached();
+    }
+
+    updateEvent();
+}
+
 GenericTimer::GenericTimer(GenericTimerParams *p)
     : ClockedObject(p),
       system(*p->system)
@@ -41,6 +41,8 @@
 #ifndef __DEV_ARM_GENERIC_TIMER_HH__
 #define __DEV_ARM_GENERIC_TIMER_HH__
 
+#include <functional>
+
 #include "arch/arm/isa_device.hh"
 #include "arch/arm/system.hh"
 #include "base/bitunion.hh"
@@ -69,6 +71,10 @@ class SystemCounter : public Serializable
     /// Tick when the counter was reset.
     Tick _resetTick;
 
+    /// Tick of the last value() evaluation and the value it returned.
+    mutable Tick _valueTick;
+    mutable uint64_t _value;
+
     /// Kernel event stream control register
     uint32_t _regCntkctl;
     /// Hypervisor event stream control register
@@ -82,7 +88,13 @@ class SystemCounter : public Serializable
     {
         if (_freq == 0)
             return 0;  // Counter is still off.
-        return (curTick() - _resetTick) / _period;
+        // The counter is read by every timer update, often several
+        // times per tick, so only divide when time has moved on.
+        if (_valueTick != curTick()) {
+            _valueTick = curTick();
+            _value = (curTick() - _resetTick) / _period;
+        }
+        return _value;
     }
 
     /// Returns the counter frequency.
@@ -146,6 +158,19 @@ class ArchTimer : public Serializable, public Drainable
     void counterLimitReached();
     EventFunctionWrapper _counterLimitReachedEvent;
 
+    /// Tick when the upcounter reaches the limit, MaxTick if the timer
+    /// doesn't need to be woken up.
+    Tick _deadline;
+    /// Owner of the event shared with other timers, if any.
+    std::function<void()> _deadlineChanged;
+
+    /**
+     * Move the deadline of the timer. The event is only touched if the
+     * deadline really changes, and timers sharing an event just notify
+     * the owner of that event.
+     */
+    void setDeadline(Tick when);
+
     virtual bool scheduleEvents() { return true; }
 
   public:
@@ -177,6 +202,24 @@ class ArchTimer : public Serializable, public Drainable
     /// Returns the value of the counter which this timer relies on.
     uint64_t value() const;
 
+    /// Returns the tick the timer needs to be woken up at.
+    Tick deadline() const { return _deadline; }
+
+    /**
+     * Let the caller schedule a single event for this timer and others
+     * instead of this timer scheduling its own.
+     *
+     * @param deadline_changed Called every time the deadline changes.
+     */
+    void
+    shareEvent(std::function<void()> deadline_changed)
+    {
+        _deadlineChanged = deadline_changed;
+    }
+
+    /// Called by the shared event once the deadline has passed.
+    void deadlineReached();
+
     // Serializable
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -248,8 +291,14 @@ class GenericTimer : public ClockedObject
                    _irqVirt),
               hyp(csprintf("%s.hyp_timer%d", parent.name(), cpu),
                    system, parent, parent.systemCounter,
-                   _irqHyp)
-        {}
+                   _irqHyp),
+              parent(parent),
+              event([this]{ eventFired(); },
+                    csprintf("%s.timer_event%d", parent.name(), cpu))
+        {
+            for (ArchTimer *timer : {&physS, &physNS, &virt, &hyp})
+                timer->shareEvent([this]{ updateEvent(); });
+        }
 
         ArmInterruptPin const *irqPhysS;
         ArmInterruptPin const *irqPhysNS;
@@ -261,6 +310,16 @@ class GenericTimer : public ClockedObject
         ArchTimerKvm virt;
         ArchTimerKvm hyp;
 
+        /**
+         * A single event per core, scheduled for the earliest deadline
+         * of its timers, so reprogramming one of the timers doesn't
+         * require moving more than one event in the queue.
+         */
+        GenericTimer &parent;
+        EventFunctionWrapper event;
+        void updateEvent();
+        void eventFired();
+
       private:
         // Disable copying
         CoreTimers(const CoreTimers &c);
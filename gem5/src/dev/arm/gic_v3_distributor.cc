@@ -44,6 +44,7 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "debug/GIC.hh"
 #include "dev/arm/gic_v3.hh"
@@ -82,6 +83,7 @@ Gicv3Distributor::Gicv3Distributor(Gicv3 * gic, uint32_t it_lines)
       irqGrpmod(it_lines, 0),
       irqNsacr(it_lines, 0),
       irqAffinityRouting(it_lines, 0),
+      irqCandidates(divCeil(it_lines, 64), 0),
       gicdTyper(0),
       gicdPidr0(0x92),
       gicdPidr1(0xb4),
@@ -552,6 +554,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
                 }
 
                 irqEnabled[int_id] = true;
+                updateCandidate(int_id);
             }
         }
 
@@ -581,6 +584,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
                 }
 
                 irqEnabled[int_id] = false;
+                updateCandidate(int_id);
             }
         }
 
@@ -610,6 +614,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
                 DPRINTF(GIC, "Gicv3Distributor::write() (GICD_ISPENDR): "
                         "int_id %d (SPI) pending bit set\n", int_id);
                 irqPending[int_id] = true;
+                updateCandidate(int_id);
             }
         }
 
@@ -638,6 +643,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
 
             if (clear) {
                 irqPending[int_id] = false;
+                updateCandidate(int_id);
                 clearIrqCpuInterface(int_id);
             }
         }
@@ -664,6 +670,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
 
             if (active) {
                 irqActive[int_id] = 1;
+                updateCandidate(int_id);
             }
         }
 
@@ -693,6 +700,7 @@ Gicv3Distributor::write(Addr addr, uint64_t data, size_t size,
                 }
 
                 irqActive[int_id] = false;
+                updateCandidate(int_id);
             }
         }
 
@@ -997,6 +1005,7 @@ Gicv3Distributor::sendInt(uint32_t int_id)
     panic_if(int_id < Gicv3::SGI_MAX + Gicv3::PPI_MAX, "Invalid SPI!");
     panic_if(int_id > itLines, "Invalid SPI!");
     irqPending[int_id] = true;
+    updateCandidate(int_id);
     DPRINTF(GIC, "Gicv3Distributor::sendInt(): "
             "int_id %d (SPI) pending bit set\n", int_id);
     update();
@@ -1008,6 +1017,7 @@ Gicv3Distributor::deassertSPI(uint32_t int_id)
     panic_if(int_id < Gicv3::SGI_MAX + Gicv3::PPI_MAX, "Invalid SPI!");
     panic_if(int_id > itLines, "Invalid SPI!");
     irqPending[int_id] = false;
+    updateCandidate(int_id);
     clearIrqCpuInterface(int_id);
 
     update();
@@ -1062,13 +1072,13 @@ void
 Gicv3Distributor::update()
 {
     // Find the highest priority pending SPI
-    for (int int_id = Gicv3::SGI_MAX + Gicv3::PPI_MAX; int_id < itLines;
-         int_id++) {
-        Gicv3::GroupId int_group = getIntGroup(int_id);
-        bool group_enabled = groupEnabled(int_group);
+    for (int word = 0; word < irqCandidates.size(); word++) {
+        for (uint64_t bits = irqCandidates[word]; bits; bits &= bits - 1) {
+            const int int_id = word * 64 + findLsbSet(bits);
+            Gicv3::GroupId int_group = getIntGroup(int_id);
 
-        if (irqPending[int_id] && irqEnabled[int_id] &&
-            !irqActive[int_id] && group_enabled) {
+            if (!groupEnabled(int_group))
+                continue;
 
             // Find the cpu interface where to route the interrupt
             Gicv3CPUInterface *target_cpu_interface = route(int_id);
@@ -1144,12 +1154,14 @@ Gicv3Distributor::activateIRQ(uint32_t int_id)
 {
     irqPending[int_id] = false;
     irqActive[int_id] = true;
+    updateCandidate(int_id);
 }
 
 void
 Gicv3Distributor::deactivateIRQ(uint32_t int_id)
 {
     irqActive[int_id] = false;
+    updateCandidate(int_id);
 }
 
 void
@@ -1188,4 +1200,7 @@ Gicv3Distributor::unserialize(CheckpointIn & cp)
     UNSERIALIZE_CONTAINER(irqGrpmod);
     UNSERIALIZE_CONTAINER(irqNsacr);
     UNSERIALIZE_CONTAINER(irqAffinityRouting);
+
+    for (int int_id = 0; int_id < itLines; int_id++)
+        updateCandidate(int_id);
 }
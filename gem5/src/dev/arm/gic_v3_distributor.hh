@@ -160,6 +160,13 @@ class Gicv3Distributor : public Serializable
     std::vector <uint8_t> irqNsacr;
     std::vector <IROUTER> irqAffinityRouting;
 
+    /**
+     * One bit per SPI that is pending, enabled and not active. This is
+     * kept up to date whenever one of those states changes so that
+     * update() only visits the interrupts that can be signalled.
+     */
+    std::vector <uint64_t> irqCandidates;
+
     uint32_t gicdTyper;
     uint32_t gicdPidr0;
     uint32_t gicdPidr1;
@@ -215,6 +222,17 @@ class Gicv3Distributor : public Serializable
 
     Gicv3::IntStatus intStatus(uint32_t int_id) const;
 
+    inline void
+    updateCandidate(uint32_t int_id)
+    {
+        const uint64_t mask = 1ULL << (int_id % 64);
+
+        if (irqPending[int_id] && irqEnabled[int_id] && !irqActive[int_id])
+            irqCandidates[int_id / 64] |= mask;
+        else
+            irqCandidates[int_id / 64] &= ~mask;
+    }
+
     inline bool isNotSPI(uint32_t int_id) const
     {
         if (int_id < (Gicv3::SGI_MAX + Gicv3::PPI_MAX) || int_id >= itLines) {
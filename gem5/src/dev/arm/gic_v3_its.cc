@@ -150,6 +150,8 @@ ItsProcess::writeDeviceTable(Yield &yield, uint32_t device_id, DTE dte)
 
     DPRINTF(ITS, "Writing DTE at address %#x: %#x\n", address, dte);
 
+    its.deviceCache.insert(device_id, dte);
+
     doWrite(yield, address, &dte, sizeof(dte));
 }
 
@@ -159,6 +161,8 @@ ItsProcess::writeIrqTranslationTable(
 {
     const Addr address = itt_base + (event_id * sizeof(itte));
 
+    its.ittCache.insert(address, itte);
+
     doWrite(yield, address, &itte, sizeof(itte));
 
     DPRINTF(ITS, "Writing ITTE at address %#x: %#x\n", address, itte);
@@ -171,6 +175,8 @@ ItsProcess::writeIrqCollectionTable(
     const Addr base = its.pageAddress(Gicv3Its::COLLECTION_TABLE);
     const Addr address = base + (collection_id * sizeof(cte));
 
+    its.collectionCache.insert(collection_id, cte);
+
     doWrite(yield, address, &cte, sizeof(cte));
 
     DPRINTF(ITS, "Writing CTE at address %#x: %#x\n", address, cte);
@@ -179,11 +185,15 @@ ItsProcess::writeIrqCollectionTable(
 uint64_t
 ItsProcess::readDeviceTable(Yield &yield, uint32_t device_id)
 {
-    uint64_t dte;
+    DTE dte;
+    if (its.deviceCache.lookup(device_id, dte))
+        return dte;
+
     const Addr base = its.pageAddress(Gicv3Its::DEVICE_TABLE);
     const Addr address = base + (device_id * sizeof(dte));
 
     doRead(yield, address, &dte, sizeof(dte));
+    its.deviceCache.insert(device_id, dte);
 
     DPRINTF(ITS, "Reading DTE at address %#x: %#x\n", address, dte);
     return dte;
@@ -193,10 +203,14 @@ uint64_t
 ItsProcess::readIrqTranslationTable(
     Yield &yield, const Addr itt_base, uint32_t event_id)
 {
-    uint64_t itte;
+    ITTE itte;
     const Addr address = itt_base + (event_id * sizeof(itte));
 
+    if (its.ittCache.lookup(address, itte))
+        return itte;
+
     doRead(yield, address, &itte, sizeof(itte));
+    its.ittCache.insert(address, itte);
 
     DPRINTF(ITS, "Reading ITTE at address %#x: %#x\n", address, itte);
     return itte;
@@ -205,11 +219,15 @@ ItsProcess::readIrqTranslationTable(
 uint64_t
 ItsProcess::readIrqCollectionTable(Yield &yield, uint32_t collection_id)
 {
-    uint64_t cte;
+    CTE cte;
+    if (its.collectionCache.lookup(collection_id, cte))
+        return cte;
+
     const Addr base = its.pageAddress(Gicv3Its::COLLECTION_TABLE);
     const Addr address = base + (collection_id * sizeof(cte));
 
     doRead(yield, address, &cte, sizeof(cte));
+    its.collectionCache.insert(collection_id, cte);
 
     DPRINTF(ITS, "Reading CTE at address %#x: %#x\n", address, cte);
     return cte;
@@ -508,6 +526,9 @@ ItsCommand::inv(Yield &yield, CommandEntry &command)
         terminate(yield);
     }
 
+    // Refetch the translation rather than using a cached copy
+    its.ittCache.erase(dte.ittAddress + command.eventId * sizeof(ITTE));
+
     ITTE itte = readIrqTranslationTable(
         yield, dte.ittAddress, command.eventId);
 
@@ -523,8 +544,8 @@ ItsCommand::inv(Yield &yield, CommandEntry &command)
         its.incrementReadPointer();
         terminate(yield);
     }
-    // Do nothing since caching is currently not supported in
-    // Redistributor
+    // Nothing else to do: the Redistributor doesn't cache the LPI
+    // configuration table.
 }
 
 void
@@ -577,6 +598,10 @@ ItsCommand::mapd(Yield &yield, CommandEntry &command)
     dte.ittAddress = mbits(command.raw[2], 51, 8);
     dte.ittRange = bits(command.raw[1], 4, 0);
 
+    // The ITT of the device may be moved or freed by software once it
+    // has been unmapped, so stop trusting any cached translation.
+    its.ittCache.clear();
+
     writeDeviceTable(yield, command.deviceId, dte);
 }
 
@@ -781,6 +806,9 @@ Gicv3Its::Gicv3Its(const Gicv3ItsParams *params)
    gitsCbaser(0), gitsCreadr(0),
    gitsCwriter(0), gitsIidr(0),
    tableBases(NUM_BASER_REGS, 0),
+   deviceCache(params->device_cache_entries),
+   ittCache(params->itt_cache_entries),
+   collectionCache(params->collection_cache_entries),
    masterId(params->system->getMasterId(this)),
    gic(nullptr),
    commandEvent([this] { checkCommandQueue(); }, name()),
@@ -972,6 +1000,11 @@ Gicv3Its::write(PacketPtr pkt)
             const uint64_t val = pkt->getLE<uint64_t>() & w_mask;
 
             tableBases[baser_index] = table_base | val;
+
+            // The tables may have moved
+            deviceCache.clear();
+            ittCache.clear();
+            collectionCache.clear();
             break;
         } else {
             panic("Unrecognized register access\n");
@@ -1286,6 +1319,10 @@ Gicv3Its::moveAllPendingState(
         rd1->lpiPendingTablePtr,
         0, sizeof(lpi_pending_table));
 
+    // Both pending tables changed behind the redistributors' back
+    rd1->pendingLPIsValid = false;
+    rd2->pendingLPIsValid = false;
+
     rd2->updateDistributor();
 }
 
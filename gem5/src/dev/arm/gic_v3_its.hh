@@ -41,6 +41,7 @@
 #define __DEV_ARM_GICV3_ITS_H__
 
 #include <queue>
+#include <unordered_map>
 
 #include "base/coroutine.hh"
 #include "dev/dma_device.hh"
@@ -319,6 +320,57 @@ class Gicv3Its : public BasicPioDevice
     void moveAllPendingState(
         Gicv3Redistributor *rd1, Gicv3Redistributor *rd2);
 
+    /**
+     * Write-through cache of the entries of one of the ITS tables. The
+     * tables in memory are owned by the ITS, software only changes them
+     * through commands, and every command updating an entry goes through
+     * ItsProcess, which keeps the cache coherent. A capacity of zero
+     * disables the cache.
+     */
+    template <class Entry>
+    class TableCache
+    {
+      public:
+        explicit TableCache(size_t _capacity) : capacity(_capacity) {}
+
+        bool
+        lookup(uint64_t key, Entry &entry) const
+        {
+            auto it = entries.find(key);
+            if (it == entries.end())
+                return false;
+
+            entry = it->second;
+            return true;
+        }
+
+        void
+        insert(uint64_t key, Entry entry)
+        {
+            if (!capacity)
+                return;
+
+            if (entries.size() >= capacity && !entries.count(key))
+                entries.erase(entries.begin());
+
+            entries[key] = entry;
+        }
+
+        void erase(uint64_t key) { entries.erase(key); }
+        void clear() { entries.clear(); }
+
+      private:
+        const size_t capacity;
+        std::unordered_map<uint64_t, Entry> entries;
+    };
+
+    /** Cached DTEs, indexed by DeviceID */
+    TableCache<DTE> deviceCache;
+    /** Cached ITTEs, indexed by the address of the entry */
+    TableCache<ITTE> ittCache;
+    /** Cached CTEs, indexed by CollectionID */
+    TableCache<CTE> collectionCache;
+
   private:
     std::queue<ItsAction> packetsToRetry;
     uint32_t masterId;
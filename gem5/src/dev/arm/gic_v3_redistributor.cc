@@ -66,6 +66,7 @@ Gicv3Redistributor::Gicv3Redistributor(Gicv3 * gic, uint32_t cpu_id)
       irqConfig(Gicv3::SGI_MAX + Gicv3::PPI_MAX, Gicv3::INT_EDGE_TRIGGERED),
       irqGrpmod(Gicv3::SGI_MAX + Gicv3::PPI_MAX, 0),
       irqNsacr(Gicv3::SGI_MAX + Gicv3::PPI_MAX, 0),
+      irqCandidates(0),
       DPG1S(false),
       DPG1NS(false),
       DPG0(false),
@@ -73,6 +74,7 @@ Gicv3Redistributor::Gicv3Redistributor(Gicv3 * gic, uint32_t cpu_id)
       lpiConfigurationTablePtr(0),
       lpiIDBits(0),
       lpiPendingTablePtr(0),
+      pendingLPIsValid(false),
       addrRangeSize(gic->params()->gicv4 ? 0x40000 : 0x20000)
 {
 }
@@ -412,6 +414,8 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
     switch (addr) {
       case GICR_CTLR: {
           // GICR_TYPER.LPIS is 0 so EnableLPIs is RES0
+          if (!EnableLPIs && (data & GICR_CTLR_ENABLE_LPIS))
+              pendingLPIsValid = false;
           EnableLPIs = data & GICR_CTLR_ENABLE_LPIS;
           DPG1S = data & GICR_CTLR_DPG1S;
           DPG1NS = data & GICR_CTLR_DPG1NS;
@@ -464,6 +468,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
 
             if (enable) {
                 irqEnabled[int_id] = true;
+                updateCandidate(int_id);
             }
 
             DPRINTF(GIC, "Gicv3Redistributor::write(): "
@@ -485,6 +490,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
 
             if (disable) {
                 irqEnabled[int_id] = false;
+                updateCandidate(int_id);
             }
 
             DPRINTF(GIC, "Gicv3Redistributor::write(): "
@@ -509,6 +515,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
                         "(GICR_ISPENDR0): int_id %d (PPI) "
                         "pending bit set\n", int_id);
                 irqPending[int_id] = true;
+                updateCandidate(int_id);
             }
         }
 
@@ -528,6 +535,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
 
             if (clear) {
                 irqPending[int_id] = false;
+                updateCandidate(int_id);
             }
         }
 
@@ -551,6 +559,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
                 }
 
                 irqActive[int_id] = true;
+                updateCandidate(int_id);
             }
         }
 
@@ -574,6 +583,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
                 }
 
                 irqActive[int_id] = false;
+                updateCandidate(int_id);
             }
         }
 
@@ -666,6 +676,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
               lpiIDBits = 0xf;
           }
 
+          pendingLPIsValid = false;
           break;
       }
 
@@ -683,6 +694,7 @@ Gicv3Redistributor::write(Addr addr, uint64_t data, size_t size,
         // InnerCache, bits [9:7]
         //   000 Device-nGnRnE
         lpiPendingTablePtr = data & 0xFFFFFFFFF0000;
+        pendingLPIsValid = false;
         break;
 
       case GICR_INVLPIR: { // Redistributor Invalidate LPI Register
@@ -707,6 +719,7 @@ Gicv3Redistributor::sendPPInt(uint32_t int_id)
     assert((int_id >= Gicv3::SGI_MAX) &&
            (int_id < Gicv3::SGI_MAX + Gicv3::PPI_MAX));
     irqPending[int_id] = true;
+    updateCandidate(int_id);
     DPRINTF(GIC, "Gicv3Redistributor::sendPPInt(): "
             "int_id %d (PPI) pending bit set\n", int_id);
     updateDistributor();
@@ -744,6 +757,7 @@ Gicv3Redistributor::sendSGI(uint32_t int_id, Gicv3::GroupId group, bool ns)
     if (!forward) return;
 
     irqPending[int_id] = true;
+    updateCandidate(int_id);
     DPRINTF(GIC, "Gicv3ReDistributor::sendSGI(): "
             "int_id %d (SGI) pending bit set\n", int_id);
     updateDistributor();
@@ -780,12 +794,12 @@ Gicv3Redistributor::updateDistributor()
 void
 Gicv3Redistributor::update()
 {
-    for (int int_id = 0; int_id < Gicv3::SGI_MAX + Gicv3::PPI_MAX; int_id++) {
+    for (uint32_t bits = irqCandidates; bits; bits &= bits - 1) {
+        const int int_id = findLsbSet(bits);
         Gicv3::GroupId int_group = getIntGroup(int_id);
         bool group_enabled = distributor->groupEnabled(int_group);
 
-        if (irqPending[int_id] && irqEnabled[int_id] &&
-                !irqActive[int_id] && group_enabled) {
+        if (group_enabled) {
             if ((irqPriority[int_id] < cpuInterface->hppi.prio) ||
                 /*
                  * Multiple pending ints with same priority.
@@ -803,40 +817,29 @@ Gicv3Redistributor::update()
 
     // Check LPIs
     if (EnableLPIs) {
+        if (!pendingLPIsValid)
+            loadPendingLPIs();
 
         const uint32_t largest_lpi_id = 1 << (lpiIDBits + 1);
-        const uint32_t number_lpis = largest_lpi_id - SMALLEST_LPI_ID + 1;
 
-        uint8_t lpi_pending_table[largest_lpi_id / 8];
-        uint8_t lpi_config_table[number_lpis];
+        // LPIs are always Non-secure Group 1 interrupts,
+        // in a system where two Security states are enabled.
+        Gicv3::GroupId lpi_group = Gicv3::G1NS;
+        bool group_enabled = distributor->groupEnabled(lpi_group);
 
-        memProxy->readBlob(lpiPendingTablePtr,
-                           lpi_pending_table,
-                           sizeof(lpi_pending_table));
+        for (auto it = pendingLPIs.lower_bound(SMALLEST_LPI_ID);
+             group_enabled && it != pendingLPIs.end() &&
+                 *it < largest_lpi_id; ++it) {
+            const uint32_t lpi_id = *it;
 
-        memProxy->readBlob(lpiConfigurationTablePtr,
-                           lpi_config_table,
-                           sizeof(lpi_config_table));
+            // Only the configuration of the pending LPIs is fetched
+            uint8_t config_byte;
+            memProxy->readBlob(
+                lpiConfigurationTablePtr + (lpi_id - SMALLEST_LPI_ID),
+                &config_byte, sizeof(config_byte));
+            LPIConfigurationTableEntry config_entry = config_byte;
 
-        for (int lpi_id = SMALLEST_LPI_ID; lpi_id < largest_lpi_id;
-             lpi_id++) {
-            uint32_t lpi_pending_entry_byte = lpi_id / 8;
-            uint8_t lpi_pending_entry_bit_position = lpi_id % 8;
-            bool lpi_is_pending = lpi_pending_table[lpi_pending_entry_byte] &
-                                  1 << lpi_pending_entry_bit_position;
-            uint32_t lpi_configuration_entry_index = lpi_id - SMALLEST_LPI_ID;
-
-            LPIConfigurationTableEntry config_entry =
-                lpi_config_table[lpi_configuration_entry_index];
-
-            bool lpi_is_enable = config_entry.enable;
-
-            // LPIs are always Non-secure Group 1 interrupts,
-            // in a system where two Security states are enabled.
-            Gicv3::GroupId lpi_group = Gicv3::G1NS;
-            bool group_enabled = distributor->groupEnabled(lpi_group);
-
-            if (lpi_is_pending && lpi_is_enable && group_enabled) {
+            if (config_entry.enable) {
                 uint8_t lpi_priority = config_entry.priority << 2;
 
                 if ((lpi_priority < cpuInterface->hppi.prio) ||
@@ -879,13 +882,31 @@ Gicv3Redistributor::writeEntryLPI(uint32_t lpi_id, uint8_t lpi_pending_entry)
 bool
 Gicv3Redistributor::isPendingLPI(uint32_t lpi_id)
 {
-    // Fetch the LPI pending entry from memory
-    uint8_t lpi_pending_entry = readEntryLPI(lpi_id);
+    if (!pendingLPIsValid)
+        loadPendingLPIs();
 
-    uint8_t lpi_pending_entry_bit_position = lpi_id % 8;
-    bool is_set = lpi_pending_entry & (1 << lpi_pending_entry_bit_position);
+    return pendingLPIs.count(lpi_id);
+}
+
+void
+Gicv3Redistributor::loadPendingLPIs()
+{
+    const uint32_t largest_lpi_id = 1 << (lpiIDBits + 1);
+    std::vector<uint8_t> lpi_pending_table(largest_lpi_id / 8);
+
+    memProxy->readBlob(lpiPendingTablePtr, lpi_pending_table.data(),
+                       lpi_pending_table.size());
+
+    pendingLPIs.clear();
+    for (uint32_t byte = SMALLEST_LPI_ID / 8;
+         byte < lpi_pending_table.size(); byte++) {
+        for (uint32_t bit = 0; bit < 8; bit++) {
+            if (lpi_pending_table[byte] & (1 << bit))
+                pendingLPIs.insert(byte * 8 + bit);
+        }
+    }
 
-    return is_set;
+    pendingLPIsValid = true;
 }
 
 void
@@ -906,11 +927,7 @@ Gicv3Redistributor::setClrLPI(uint64_t data, bool set)
         return;
     }
 
-    // Fetch the LPI pending entry from memory
-    uint8_t lpi_pending_entry = readEntryLPI(lpi_id);
-
-    uint8_t lpi_pending_entry_bit_position = lpi_id % 8;
-    bool is_set = lpi_pending_entry & (1 << lpi_pending_entry_bit_position);
+    bool is_set = isPendingLPI(lpi_id);
 
     if (set) {
         if (is_set) {
@@ -919,7 +936,7 @@ Gicv3Redistributor::setClrLPI(uint64_t data, bool set)
             return;
         }
 
-        lpi_pending_entry |= 1 << (lpi_pending_entry_bit_position);
+        pendingLPIs.insert(lpi_id);
     } else {
         if (!is_set) {
             // Writes to GICR_SETLPIR have not effect if the pINTID field
@@ -927,12 +944,20 @@ Gicv3Redistributor::setClrLPI(uint64_t data, bool set)
             return;
         }
 
-        lpi_pending_entry &= ~(1 << (lpi_pending_entry_bit_position));
+        pendingLPIs.erase(lpi_id);
 
         // Remove the pending state from the cpu interface
         cpuInterface->resetHppi(lpi_id);
     }
 
+    // Write the pending entry through to memory
+    const uint32_t first_lpi_id = lpi_id & ~0x7;
+    uint8_t lpi_pending_entry = 0;
+    for (uint32_t bit = 0; bit < 8; bit++) {
+        if (pendingLPIs.count(first_lpi_id + bit))
+            lpi_pending_entry |= 1 << bit;
+    }
+
     writeEntryLPI(lpi_id, lpi_pending_entry);
 
     updateDistributor();
@@ -969,12 +994,14 @@ Gicv3Redistributor::activateIRQ(uint32_t int_id)
 {
     irqPending[int_id] = false;
     irqActive[int_id] = true;
+    updateCandidate(int_id);
 }
 
 void
 Gicv3Redistributor::deactivateIRQ(uint32_t int_id)
 {
     irqActive[int_id] = false;
+    updateCandidate(int_id);
 }
 
 uint32_t
@@ -1060,4 +1087,8 @@ Gicv3Redistributor::unserialize(CheckpointIn & cp)
     UNSERIALIZE_SCALAR(lpiConfigurationTablePtr);
     UNSERIALIZE_SCALAR(lpiIDBits);
     UNSERIALIZE_SCALAR(lpiPendingTablePtr);
+    pendingLPIsValid = false;
+
+    for (int int_id = 0; int_id < Gicv3::SGI_MAX + Gicv3::PPI_MAX; int_id++)
+        updateCandidate(int_id);
 }
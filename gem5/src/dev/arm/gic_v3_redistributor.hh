@@ -43,6 +43,8 @@
 #ifndef __DEV_ARM_GICV3_REDISTRIBUTOR_H__
 #define __DEV_ARM_GICV3_REDISTRIBUTOR_H__
 
+#include <set>
+
 #include "base/addr_range.hh"
 #include "dev/arm/gic_v3.hh"
 #include "sim/serialize.hh"
@@ -161,6 +163,12 @@ class Gicv3Redistributor : public Serializable
     std::vector <uint8_t> irqGrpmod;
     std::vector <uint8_t> irqNsacr;
 
+    /**
+     * One bit per SGI/PPI that is pending, enabled and not active, kept
+     * up to date so that update() only visits these interrupts.
+     */
+    uint32_t irqCandidates;
+
     bool DPG1S;
     bool DPG1NS;
     bool DPG0;
@@ -170,6 +178,17 @@ class Gicv3Redistributor : public Serializable
     uint8_t lpiIDBits;
     Addr lpiPendingTablePtr;
 
+    /**
+     * Pending LPIs, held here instead of being fetched from the pending
+     * table for every access. The set is loaded from the table the first
+     * time it's needed after the table moves, LPIs are enabled or a
+     * checkpoint is restored, and every change is written through to
+     * the table.
+     */
+    std::set<uint32_t> pendingLPIs;
+    bool pendingLPIsValid;
+    void loadPendingLPIs();
+
     BitUnion8(LPIConfigurationTableEntry)
         Bitfield<7, 2> priority;
         Bitfield<1> res1;
@@ -213,6 +232,16 @@ class Gicv3Redistributor : public Serializable
 
     Gicv3::GroupId getIntGroup(int int_id) const;
     Gicv3::IntStatus intStatus(uint32_t int_id) const;
+
+    inline void
+    updateCandidate(uint32_t int_id)
+    {
+        if (irqPending[int_id] && irqEnabled[int_id] && !irqActive[int_id])
+            irqCandidates |= 1U << int_id;
+        else
+            irqCandidates &= ~(1U << int_id);
+    }
+
     uint8_t readEntryLPI(uint32_t intid);
     void writeEntryLPI(uint32_t intid, uint8_t lpi_entry);
     bool isPendingLPI(uint32_t intid);
@@ -82,6 +82,19 @@ SMMUv3BaseCache::decodePolicyName(const std::string &policy_name)
     }
 }
 
+size_t
+SMMUv3BaseCache::hashSetIdx(uint64_t key, size_t num_sets)
+{
+    if (num_sets == 1)
+        return 0;
+
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+
+    return key % num_sets;
+}
+
 void
 SMMUv3BaseCache::regStats(const std::string &name)
 {
@@ -214,7 +227,7 @@ SMMUTLB::lookupAnyVA(uint32_t sid, uint32_t ssid, bool updStats)
 {
     const Entry *result = NULL;
 
-    for (size_t s = 0; s < sets.size(); s++) {
+    for (size_t s = 0; s < sets.size() && !result; s++) {
         Set &set = sets[s];
 
         for (size_t i = 0; i < set.size(); i++) {
@@ -358,13 +371,13 @@ SMMUTLB::invalidateAll()
 size_t
 SMMUTLB::pickSetIdx(Addr va) const
 {
-    return (va >> 12) % sets.size();
+    return hashSetIdx(va >> 12, sets.size());
 }
 
 size_t
 SMMUTLB::pickSetIdx(uint32_t sid, uint32_t ssid) const
 {
-    return (sid^ssid) % sets.size();
+    return hashSetIdx((uint64_t(ssid) << 32) | sid, sets.size());
 }
 
 size_t
@@ -584,7 +597,8 @@ ARMArchTLB::invalidateAll()
 size_t
 ARMArchTLB::pickSetIdx(Addr va, uint16_t asid, uint16_t vmid) const
 {
-    return ((va >> 12) ^ asid ^ vmid) % sets.size();
+    return hashSetIdx((va >> 12) ^ (uint64_t(asid) << 48) ^
+                      (uint64_t(vmid) << 32), sets.size());
 }
 
 size_t
@@ -764,7 +778,7 @@ IPACache::invalidateAll()
 size_t
 IPACache::pickSetIdx(Addr va, uint16_t vmid) const
 {
-    return ((va >> 12) ^ vmid) % sets.size();
+    return hashSetIdx((va >> 12) ^ (uint64_t(vmid) << 48), sets.size());
 }
 
 size_t
@@ -928,7 +942,7 @@ ConfigCache::invalidateAll()
 size_t
 ConfigCache::pickSetIdx(uint32_t sid, uint32_t ssid) const
 {
-    return (sid^ssid) % sets.size();
+    return hashSetIdx((uint64_t(ssid) << 32) | sid, sets.size());
 }
 
 size_t
@@ -1185,7 +1199,7 @@ WalkCache::pickSetIdx(Addr va, Addr vaMask,
             panic("bad stage");
     }
 
-    return ((va >> findLsbSet(vaMask)) % size) + offset;
+    return hashSetIdx(va >> findLsbSet(vaMask), size) + offset;
 }
 
 size_t
@@ -82,6 +82,13 @@ class SMMUv3BaseCache
 
     static int decodePolicyName(const std::string &policy_name);
 
+    /**
+     * Map a lookup key to a set. The key bits are mixed before they are
+     * reduced so that strided page numbers (e.g. DMA buffers spaced by
+     * a power of two) spread over all sets instead of aliasing.
+     */
+    static size_t hashSetIdx(uint64_t key, size_t num_sets);
+
   public:
     SMMUv3BaseCache(const std::string &policy_name, uint32_t seed);
     virtual ~SMMUv3BaseCache() {}
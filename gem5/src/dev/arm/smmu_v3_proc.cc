@@ -194,10 +194,7 @@ SMMUProcess::doBroadcastSignal(SMMUSignal &sig)
 void
 SMMUProcess::scheduleWakeup(Tick when)
 {
-    auto *ep = new EventWrapper<
-        SMMUProcess, &SMMUProcess::wakeup> (this, true);
-
-    smmu.schedule(ep, when);
+    smmu.scheduleOneShot([this]{ wakeup(); }, when);
 }
 
 SMMUAction
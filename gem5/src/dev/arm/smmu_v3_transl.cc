@@ -108,9 +108,9 @@ SMMUTranslationProcess::~SMMUTranslationProcess()
 void
 SMMUTranslationProcess::beginTransaction(const SMMUTranslRequest &req)
 {
+    // The coroutine was created by the constructor and is parked on its
+    // initial yield, so there is no need to create another one here.
     request = req;
-
-    reinit();
 }
 
 void
@@ -126,6 +126,7 @@ SMMUTranslationProcess::resumeTransaction()
     DPRINTF(SMMUv3, "Resume at tick = %d. Fault duration = %d (%.3fus)\n",
         resumeTick, resumeTick-faultTick, (resumeTick-faultTick) / 1e6);
 
+    reinit();
     beginTransaction(request);
 
     smmu.runProcessTiming(this, request.pkt);
@@ -270,7 +271,12 @@ SMMUTranslationProcess::smmuTranslation(Yield &yield)
         }
     }
 
-    if (haveConfig && !smmuTLBLookup(yield, tr)) {
+    if (haveConfig && !context.stage1Enable && !context.stage2Enable) {
+        // Fast path for streams in bypass mode: there is nothing to look
+        // up or walk, and caching the identity mapping in the main TLB
+        // would only evict useful translations.
+        tr = bypass(request.addr);
+    } else if (haveConfig && !smmuTLBLookup(yield, tr)) {
         // SMMU main TLB miss
 
         // Need PTW slot to proceed
@@ -281,14 +287,11 @@ SMMUTranslationProcess::smmuTranslation(Yield &yield)
 
         if (context.stage1Enable) {
             tr = translateStage1And2(yield, request.addr);
-        } else if (context.stage2Enable) {
-            tr = translateStage2(yield, request.addr, true);
         } else {
-            tr = bypass(request.addr);
+            tr = translateStage2(yield, request.addr, true);
         }
 
-        if (context.stage1Enable || context.stage2Enable)
-            smmu.ptwTimeDist.sample(curTick() - ptwStartTick);
+        smmu.ptwTimeDist.sample(curTick() - ptwStartTick);
 
         // Free PTW slot
         doSemaphoreUp(smmu.ptwSem);
@@ -45,9 +45,12 @@
 
 #include "dev/dma_device.hh"
 
+#include <algorithm>
+#include <cstring>
 #include <utility>
 
 #include "base/chunk_generator.hh"
+#include "base/intmath.hh"
 #include "debug/DMA.hh"
 #include "debug/Drain.hh"
 #include "mem/port_proxy.hh"
@@ -55,13 +58,18 @@
 #include "sim/system.hh"
 
 DmaPort::DmaPort(ClockedObject *dev, System *s,
-                 uint32_t sid, uint32_t ssid)
+                 uint32_t sid, uint32_t ssid,
+                 bool use_backdoors, bool _bursts,
+                 double burst_bandwidth, Tick burst_latency)
     : MasterPort(dev->name() + ".dma", dev),
       device(dev), sys(s), masterId(s->getMasterId(dev)),
       sendEvent([this]{ sendDma(); }, dev->name()),
       pendingCount(0), inRetry(false),
       defaultSid(sid),
-      defaultSSid(ssid)
+      defaultSSid(ssid),
+      useBackdoors(use_backdoors),
+      bursts(_bursts), burstBandwidth(burst_bandwidth),
+      burstLatency(burst_latency)
 { }
 
 void
@@ -120,7 +128,9 @@ DmaPort::recvTimingResp(PacketPtr pkt)
 }
 
 DmaDevice::DmaDevice(const Params *p)
-    : PioDevice(p), dmaPort(this, sys, p->sid, p->ssid)
+    : PioDevice(p), dmaPort(this, sys, p->sid, p->ssid, p->mem_backdoors,
+                            p->dma_bursts, p->dma_burst_bandwidth,
+                            p->dma_burst_latency)
 { }
 
 void
@@ -154,6 +164,20 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    uint8_t *data, uint32_t sid, uint32_t ssid, Tick delay,
                    Request::Flags flag)
 {
+    // the transfers that only move data can take the fast paths,
+    // which don't queue any packets
+    const bool plain = data && !flag.isSet(Request::UNCACHEABLE);
+    if (plain && useBackdoors && sys->isAtomicMode() &&
+        transmitList.empty()) {
+        dmaAtomicBackdoor(cmd, addr, size, event, data, sid, ssid, delay,
+                          flag);
+        return std::make_shared<Request>(addr, size, flag, masterId);
+    }
+    if (plain && bursts && sys->isTimingMode()) {
+        dmaBurst(cmd, addr, size, event, data, sid, ssid, delay, flag);
+        return std::make_shared<Request>(addr, size, flag, masterId);
+    }
+
     // one DMA request sender state for every action, that is then
     // split into many requests and packets based on the block size,
     // i.e. cache line size
@@ -198,6 +222,108 @@ DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
     return req;
 }
 
+void
+DmaPort::dmaAtomicBackdoor(Packet::Command cmd, Addr addr, int size,
+                           Event *event, uint8_t *data, uint32_t sid,
+                           uint32_t ssid, Tick delay, Request::Flags flag)
+{
+    const bool is_write = MemCmd(cmd).isWrite();
+    const Addr end = addr + size;
+    const Addr line_size = sys->cacheLineSize();
+
+    // as in dmaAction, the completion is delayed by the latency of the
+    // last access, which is nothing through a backdoor
+    Tick lat = 0;
+    for (Addr cur = addr; cur < end; ) {
+        MemBackdoorPtr bd = findBackdoor(cur, is_write);
+        if (bd) {
+            const Addr len = std::min(end, bd->range().end() + 1) - cur;
+            uint8_t *host = bd->ptr() + (cur - bd->range().start());
+            DPRINTF(DMA, "--Backdoor DMA for addr: %#x size: %d\n",
+                    cur, len);
+            if (is_write)
+                memcpy(host, data + (cur - addr), len);
+            else
+                memcpy(data + (cur - addr), host, len);
+            cur += len;
+            lat = 0;
+            continue;
+        }
+
+        const Addr len = std::min(end, roundDown(cur, line_size) +
+                                  line_size) - cur;
+        RequestPtr req = std::make_shared<Request>(cur, len, flag, masterId);
+        req->setStreamId(sid);
+        req->setSubStreamId(ssid);
+        req->taskId(ContextSwitchTaskId::DMA);
+        Packet pkt(req, cmd);
+        pkt.dataStatic(data + (cur - addr));
+
+        DPRINTF(DMA, "--Sending DMA for addr: %#x size: %d\n", cur, len);
+        MemBackdoorPtr backdoor = nullptr;
+        lat = sendAtomicBackdoor(&pkt, backdoor);
+        if (backdoor)
+            addBackdoor(backdoor);
+        cur += len;
+    }
+
+    if (event)
+        device->schedule(event, curTick() + lat + delay);
+}
+
+void
+DmaPort::dmaBurst(Packet::Command cmd, Addr addr, int size, Event *event,
+                  uint8_t *data, uint32_t sid, uint32_t ssid, Tick delay,
+                  Request::Flags flag)
+{
+    // functional accesses see the data in the caches, a line at a time
+    for (ChunkGenerator gen(addr, size, sys->cacheLineSize());
+         !gen.done(); gen.next()) {
+        RequestPtr req = std::make_shared<Request>(
+            gen.addr(), gen.size(), flag, masterId);
+        req->setStreamId(sid);
+        req->setSubStreamId(ssid);
+        req->taskId(ContextSwitchTaskId::DMA);
+        Packet pkt(req, cmd);
+        pkt.dataStatic(data + gen.complete());
+        sendFunctional(&pkt);
+    }
+
+    const Tick burst = burstLatency + Tick(size * burstBandwidth);
+    DPRINTF(DMA, "--Burst DMA for addr: %#x size: %d takes %d\n",
+            addr, size, burst);
+    if (event)
+        device->schedule(event, curTick() + burst + delay);
+}
+
+MemBackdoorPtr
+DmaPort::findBackdoor(Addr addr, bool is_write) const
+{
+    for (auto bd : backdoors) {
+        if (bd->range().contains(addr) &&
+            (is_write ? bd->writeable() : bd->readable())) {
+            return bd;
+        }
+    }
+    return nullptr;
+}
+
+void
+DmaPort::addBackdoor(MemBackdoorPtr backdoor)
+{
+    if (!backdoor->ptr() || backdoor->range().interleaved() ||
+        std::find(backdoors.begin(), backdoors.end(), backdoor) !=
+        backdoors.end()) {
+        return;
+    }
+
+    backdoors.push_back(backdoor);
+    backdoor->addInvalidationCallback([this](const MemBackdoor &bd) {
+        backdoors.erase(std::remove(backdoors.begin(), backdoors.end(), &bd),
+                        backdoors.end());
+    });
+}
+
 RequestPtr
 DmaPort::dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
                    uint8_t *data, Tick delay, Request::Flags flag)
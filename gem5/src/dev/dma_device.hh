@@ -47,9 +47,11 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
 
 #include "base/circlebuf.hh"
 #include "dev/io_device.hh"
+#include "mem/backdoor.hh"
 #include "params/DmaDevice.hh"
 #include "sim/drain.hh"
 #include "sim/system.hh"
@@ -89,6 +91,29 @@ class DmaPort : public MasterPort, public Drainable
      */
     void handleResp(PacketPtr pkt, Tick delay = 0);
 
+    /**
+     * Do an atomic DMA through the backdoors of the memories, copying
+     * all that a backdoor covers at once, and sending packets of a
+     * cache line to get the backdoors for the rest.
+     */
+    void dmaAtomicBackdoor(Packet::Command cmd, Addr addr, int size,
+                           Event *event, uint8_t *data, uint32_t sid,
+                           uint32_t ssid, Tick delay, Request::Flags flag);
+
+    /**
+     * Do a timing DMA as a burst, moving the data functionally and
+     * completing after the latency and transfer time of the burst.
+     */
+    void dmaBurst(Packet::Command cmd, Addr addr, int size, Event *event,
+                  uint8_t *data, uint32_t sid, uint32_t ssid, Tick delay,
+                  Request::Flags flag);
+
+    /** A backdoor this port may use to access an address. */
+    MemBackdoorPtr findBackdoor(Addr addr, bool is_write) const;
+
+    /** Start using a backdoor, until it is invalidated. */
+    void addBackdoor(MemBackdoorPtr backdoor);
+
     struct DmaReqState : public Packet::SenderState
     {
         /** Event to call on the device when this transaction (all packets)
@@ -140,6 +165,21 @@ class DmaPort : public MasterPort, public Drainable
     /** Default substreamId */
     const uint32_t defaultSSid;
 
+    /** Whether atomic DMAs go through backdoors when they can */
+    const bool useBackdoors;
+
+    /** The backdoors handed out to this port */
+    std::vector<MemBackdoorPtr> backdoors;
+
+    /** Whether timing DMAs are modelled as bursts */
+    const bool bursts;
+
+    /** Bandwidth of the bursts, in ticks per byte */
+    const double burstBandwidth;
+
+    /** Latency of the bursts */
+    const Tick burstLatency;
+
   protected:
 
     bool recvTimingResp(PacketPtr pkt) override;
@@ -150,7 +190,9 @@ class DmaPort : public MasterPort, public Drainable
   public:
 
     DmaPort(ClockedObject *dev, System *s,
-            uint32_t sid = 0, uint32_t ssid = 0);
+            uint32_t sid = 0, uint32_t ssid = 0,
+            bool use_backdoors = false, bool _bursts = false,
+            double burst_bandwidth = 0, Tick burst_latency = 0);
 
     RequestPtr
     dmaAction(Packet::Command cmd, Addr addr, int size, Event *event,
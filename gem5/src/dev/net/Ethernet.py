@@ -62,6 +62,8 @@ class EtherLink(SimObject):
     int1 = EtherInt("interface 1")
     delay = Param.Latency('0us', "packet transmit delay")
     delay_var = Param.Latency('0ns', "packet transmit delay variability")
+    batch_window = Param.Latency('0ns', "deliver the packets arriving "
+        "within this window as a batch (delays packets by up to the window)")
     speed = Param.NetworkBandwidth('1Gbps', "link speed")
     dump = Param.EtherDump(NULL, "dump object")
 
@@ -80,8 +82,17 @@ class DistEtherLink(SimObject):
     server_name = Param.String('localhost', "Message server name")
     server_port = Param.UInt32('2200', "Message server port")
     is_switch = Param.Bool(False, "true if this a link in etherswitch")
+    is_uplink = Param.Bool(False, "true if this link connects an "
+        "etherswitch to an upper level switch (is_switch must be set and "
+        "num_nodes must match the other links of the switch)")
     dist_sync_on_pseudo_op = Param.Bool(False, "Start sync with pseudo_op")
     num_nodes = Param.UInt32('2', "Number of simulate nodes")
+    shm_transport = Param.Bool(False, "Exchange messages through shared "
+        "memory, all gem5 processes must run on the same host")
+    shm_dir = Param.String('/dev/shm', "Directory for the shared memory "
+        "channel files")
+    shm_ring_size = Param.MemorySize('4MB', "Size of each direction of a "
+        "shared memory channel")
 
 class EtherBus(SimObject):
     type = 'EtherBus'
@@ -117,6 +128,9 @@ if buildEnv['USE_TUNTAP']:
         tun_clone_device = Param.String('/dev/net/tun',
                                         "Path to the tun clone device node")
         tap_device_name = Param.String('gem5-tap', "Tap device name")
+        offload = Param.Bool(False, "Let the host offload checksums and "
+            "TCP segmentation, offloaded frames are completed before they "
+            "enter the simulation")
 
 class EtherTapStub(EtherTapBase):
     type = 'EtherTapStub'
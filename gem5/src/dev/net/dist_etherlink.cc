@@ -90,12 +90,14 @@ DistEtherLink::DistEtherLink(const Params *p)
         sync_repeat = p->delay;
     }
 
-    // create the dist (TCP) interface to talk to the peer gem5 processes.
+    // create the dist (TCP or shared memory) interface to talk to the peer
+    // gem5 processes.
     distIface = new TCPIface(p->server_name, p->server_port,
                              p->dist_rank, p->dist_size,
                              p->sync_start, sync_repeat, this,
                              p->dist_sync_on_pseudo_op, p->is_switch,
-                             p->num_nodes);
+                             p->num_nodes, p->shm_transport, p->shm_dir,
+                             p->shm_ring_size, p->is_uplink);
 
     localIface = new LocalIface(name() + ".int0", txLink, rxLink, distIface);
 }
@@ -46,6 +46,7 @@
 #include <queue>
 #include <thread>
 
+#include "base/intmath.hh"
 #include "base/random.hh"
 #include "base/trace.hh"
 #include "cpu/thread_context.hh"
@@ -64,6 +65,7 @@ unsigned DistIface::distIfaceNum = 0;
 unsigned DistIface::recvThreadsNum = 0;
 DistIface *DistIface::master = nullptr;
 bool DistIface::isSwitch = false;
+DistIface *DistIface::uplink = nullptr;
 
 void
 DistIface::Sync::init(Tick start_tick, Tick repeat_tick)
@@ -106,6 +108,12 @@ DistIface::SyncSwitch::SyncSwitch(int num_nodes)
     nextAt = std::numeric_limits<Tick>::max();
     nextRepeat = std::numeric_limits<Tick>::max();
     isAbort = false;
+    upperRepeat = std::numeric_limits<Tick>::max();
+    upperAt = 0;
+    waitUplink = false;
+    upCkpt = ReqType::none;
+    upExit = ReqType::none;
+    upStopSync = ReqType::none;
 }
 
 DistIface::SyncNode::SyncNode()
@@ -159,6 +167,9 @@ DistIface::SyncSwitch::run(bool same_tick)
 {
     std::unique_lock<std::mutex> sync_lock(lock);
     Header header;
+    // A barrier that is neither periodic nor taken for a checkpoint
+    // (re)starts the periodic sync.
+    const bool start = !same_tick && !doCkpt;
     // Wait for the sync requests from the nodes
     if (waitNum > 0) {
         auto lf = [this]{ return waitNum == 0; };
@@ -168,6 +179,16 @@ DistIface::SyncSwitch::run(bool same_tick)
     if (isAbort) // sync aborted
         return false;
     assert(!same_tick || (nextAt == curTick()));
+    if (DistIface::uplink) {
+        // The requests of the nodes are decided by the upper level
+        // switch. Periodic barriers in between the ones with the upper
+        // level switch are completed locally.
+        collectUplinkReqs();
+        if (!same_tick || curTick() >= upperAt) {
+            if (!runUplink(start, sync_lock))
+                return false;
+        }
+    }
     waitNum = numNodes;
     // Complete the global synchronisation
     header.msgType = MsgType::cmdSyncAck;
@@ -197,6 +218,110 @@ DistIface::SyncSwitch::run(bool same_tick)
     return true;
 }
 
+void
+DistIface::SyncSwitch::collectUplinkReqs()
+{
+    // Immediate requests are recorded by progress() right away, collective
+    // ones are forwarded once all nodes asked for them.
+    if (numCkptReq == numNodes) {
+        numCkptReq = 0;
+        if (upCkpt == ReqType::none)
+            upCkpt = ReqType::collective;
+    }
+    if (numExitReq == numNodes) {
+        numExitReq = 0;
+        if (upExit == ReqType::none)
+            upExit = ReqType::collective;
+    }
+    if (numStopSyncReq == numNodes) {
+        numStopSyncReq = 0;
+        if (upStopSync == ReqType::none)
+            upStopSync = ReqType::collective;
+    }
+}
+
+bool
+DistIface::SyncSwitch::runUplink(bool start,
+                                 std::unique_lock<std::mutex> &sync_lock)
+{
+    Header header;
+
+    // Act as a compute node of the upper level switch
+    header.msgType = MsgType::cmdSyncReq;
+    header.sendTick = std::max(nextAt, curTick());
+    header.syncRepeat = upperRepeat;
+    header.needCkpt = upCkpt;
+    header.needExit = upExit;
+    header.needStopSync = upStopSync;
+    upCkpt = ReqType::none;
+    upExit = ReqType::none;
+    upStopSync = ReqType::none;
+    waitUplink = true;
+    DistIface::uplink->sendUplinkCmd(header);
+
+    auto lf = [this]{ return !waitUplink || isAbort; };
+    cv.wait(sync_lock, lf);
+    if (isAbort) // sync aborted
+        return false;
+
+    if (start) {
+        // Round the local interval down to make every barrier with the
+        // upper level switch a local barrier, too.
+        if (nextRepeat >= upperRepeat) {
+            nextRepeat = upperRepeat;
+        } else {
+            Tick n = divCeil(upperRepeat, nextRepeat);
+            while (upperRepeat % n)
+                n++;
+            nextRepeat = upperRepeat / n;
+        }
+        upperAt = nextAt;
+        inform("Local dist sync repeats %lu, upper level sync repeats %lu\n",
+               nextRepeat, upperRepeat);
+    } else if (curTick() >= upperAt) {
+        upperAt = curTick() + upperRepeat;
+    }
+    return true;
+}
+
+void
+DistIface::SyncSwitch::initUplink(Tick start_tick, Tick repeat_tick)
+{
+    if (start_tick < nextAt)
+        nextAt = start_tick;
+
+    if (repeat_tick == 0)
+        panic("Dist synchronisation interval must be greater than zero");
+
+    if (repeat_tick < upperRepeat)
+        upperRepeat = repeat_tick;
+}
+
+bool
+DistIface::SyncSwitch::progressUplink(Tick send_tick,
+                                      Tick next_repeat,
+                                      ReqType do_ckpt,
+                                      ReqType do_exit,
+                                      ReqType do_stop_sync)
+{
+    std::unique_lock<std::mutex> sync_lock(lock);
+    if (isAbort) // sync aborted
+        return false;
+    assert(waitUplink);
+
+    nextAt = send_tick;
+    upperRepeat = next_repeat;
+    doCkpt = (do_ckpt != ReqType::none);
+    doExit = (do_exit != ReqType::none);
+    doStopSync = (do_stop_sync != ReqType::none);
+
+    waitUplink = false;
+    sync_lock.unlock();
+    cv.notify_one();
+    // The receive thread must finish when simulation is about to exit
+    return !doExit;
+}
+
 bool
 DistIface::SyncSwitch::progress(Tick send_tick,
                                  Tick sync_repeat,
@@ -214,16 +339,24 @@ DistIface::SyncSwitch::progress(Tick send_tick,
     if (nextRepeat > sync_repeat)
         nextRepeat = sync_repeat;
 
+    // Immediate requests have to be granted by the upper level switch
+    // if there is one
     if (need_ckpt == ReqType::collective)
         numCkptReq++;
+    else if (need_ckpt == ReqType::immediate && DistIface::uplink)
+        upCkpt = ReqType::immediate;
     else if (need_ckpt == ReqType::immediate)
         doCkpt = true;
     if (need_exit == ReqType::collective)
         numExitReq++;
+    else if (need_exit == ReqType::immediate && DistIface::uplink)
+        upExit = ReqType::immediate;
     else if (need_exit == ReqType::immediate)
         doExit = true;
     if (need_stop_sync == ReqType::collective)
         numStopSyncReq++;
+    else if (need_stop_sync == ReqType::immediate && DistIface::uplink)
+        upStopSync = ReqType::immediate;
     else if (need_stop_sync == ReqType::immediate)
         doStopSync = true;
 
@@ -506,8 +639,9 @@ DistIface::RecvScheduler::pushPacket(EthPacketPtr new_packet,
     DPRINTF(DistEthernetPkt, "DistIface::recvScheduler::pushPacket "
             "send_tick:%llu send_delay:%llu link_delay:%llu recv_tick:%llu\n",
             send_tick, send_delay, linkDelay, recv_tick);
-    // Every packet must be sent and arrive in the same quantum
-    assert(send_tick > master->syncEvent->when() -
+    // Every packet must be sent and arrive in the same quantum (packets
+    // from an upper level switch are sent in its longer quantum)
+    assert(fromUplink || send_tick > master->syncEvent->when() -
            master->syncEvent->repeat);
     // No packet may be scheduled for receive in the arrival quantum
     assert(send_tick + send_delay + linkDelay > master->syncEvent->when());
@@ -609,10 +743,11 @@ DistIface::DistIface(unsigned dist_rank,
                      Tick sync_repeat,
                      EventManager *em,
                      bool use_pseudo_op,
-                     bool is_switch, int num_nodes) :
+                     bool is_switch, int num_nodes, bool is_uplink) :
     syncStart(sync_start), syncRepeat(sync_repeat),
-    recvThread(nullptr), recvScheduler(em), syncStartOnPseudoOp(use_pseudo_op),
-    rank(dist_rank), size(dist_size)
+    recvThread(nullptr), recvScheduler(em, is_uplink),
+    syncStartOnPseudoOp(use_pseudo_op),
+    rank(dist_rank), size(dist_size), isUplink(is_uplink)
 {
     DPRINTF(DistEthernet, "DistIface() ctor rank:%d\n",dist_rank);
     isMaster = false;
@@ -628,6 +763,11 @@ DistIface::DistIface(unsigned dist_rank,
         master = this;
         isMaster = true;
     }
+    if (is_uplink) {
+        panic_if(!is_switch, "Uplink configured for a compute node");
+        panic_if(uplink, "Only one uplink per switch is supported");
+        uplink = this;
+    }
     distIfaceId = distIfaceNum;
     distIfaceNum++;
 }
@@ -645,6 +785,8 @@ DistIface::~DistIface()
     }
     if (this == master)
         master = nullptr;
+    if (this == uplink)
+        uplink = nullptr;
 }
 
 void
@@ -702,6 +844,15 @@ DistIface::recvThreadFunc(Event *recv_done, Tick link_delay)
             recvScheduler.pushPacket(new_packet,
                                      header.sendTick,
                                      header.sendDelay);
+        } else if (isUplink) {
+            // sync ack from the upper level switch
+            if (!sync->progressUplink(header.sendTick,
+                                      header.syncRepeat,
+                                      header.needCkpt,
+                                      header.needExit,
+                                      header.needStopSync))
+                // Finish receiver thread if simulation is about to exit
+                break;
         } else {
             // everything else must be synchronisation related command
             if (!sync->progress(header.sendTick,
@@ -801,7 +952,10 @@ DistIface::init(const Event *done_event, Tick link_delay)
     // might have different requirements. The singleton sync object
     // will select the minimum values for both params.
     assert(sync != nullptr);
-    sync->init(syncStart, syncRepeat);
+    if (isUplink)
+        sync->initUplink(syncStart, syncRepeat);
+    else
+        sync->init(syncStart, syncRepeat);
 
     // Initialize the seed for random generator to avoid the same sequence
     // in all gem5 peer processes
@@ -68,7 +68,15 @@
  * transmission delay to ensure that a corresponding receive event can always
  * be scheduled for any message coming in from a peer gem5 process.
  *
- *
+ * 4. Optionally build a synchronisation tree out of several switch
+ * processes. A rack level switch has an extra "uplink" to an upper level
+ * switch. It runs local barriers with its compute nodes at the sync
+ * interval of its own links and only every few of them (at the sync
+ * interval of the uplink) does it join a barrier with the upper level
+ * switch. Compute nodes in different racks therefore only wait for each
+ * other at the (usually much longer) upper level intervals. The local
+ * interval is rounded down so that every upper level barrier is also a
+ * local one.
  *
  * This interface is an abstract class. It can work with various low level
  * send/receive service implementations (e.g. TCP/IP, MPI,...). A TCP
@@ -196,6 +204,27 @@ class DistIface : public Drainable, public Serializable
         virtual void requestExit(ReqType req) = 0;
         virtual void requestStopSync(ReqType req) = 0;
 
+        /**
+         * Initialize the sync params of the link to the upper level
+         * switch.
+         */
+        virtual void initUplink(Tick start, Tick repeat) {
+            panic("Uplink configured for a compute node");
+        }
+        /**
+         * Callback when the receiver thread of the uplink gets a sync ack
+         * message from the upper level switch.
+         *
+         * @return false if the receiver thread needs to stop
+         */
+        virtual bool progressUplink(Tick send_tick,
+                                    Tick next_repeat,
+                                    ReqType do_ckpt,
+                                    ReqType do_exit,
+                                    ReqType do_stop_sync) {
+            panic("Uplink configured for a compute node");
+        }
+
         void drainComplete();
 
         virtual void serialize(CheckpointOut &cp) const override = 0;
@@ -256,6 +285,37 @@ class DistIface : public Drainable, public Serializable
          *  Number of connected simulated nodes
          */
         unsigned numNodes;
+        /**
+         * Sync interval with the upper level switch
+         */
+        Tick upperRepeat;
+        /**
+         * Tick of the next barrier with the upper level switch
+         */
+        Tick upperAt;
+        /**
+         * Flag is set while waiting for the ack of the upper level switch
+         */
+        bool waitUplink;
+        /** @{
+         * @name Requests to forward to the upper level switch
+         */
+        ReqType upCkpt;
+        ReqType upExit;
+        ReqType upStopSync;
+        /** @} */
+
+        /**
+         * Collect the requests of the nodes that the upper level switch
+         * has to decide about.
+         */
+        void collectUplinkReqs();
+        /**
+         * Complete a barrier with the upper level switch.
+         *
+         * @return true if the sync completes, false if it gets aborted
+         */
+        bool runUplink(bool start, std::unique_lock<std::mutex> &sync_lock);
 
       public:
         SyncSwitch(int num_nodes);
@@ -278,6 +338,13 @@ class DistIface : public Drainable, public Serializable
             panic("Switch requested stop sync");
         }
 
+        void initUplink(Tick start, Tick repeat) override;
+        bool progressUplink(Tick send_tick,
+                            Tick next_repeat,
+                            ReqType do_ckpt,
+                            ReqType do_exit,
+                            ReqType do_stop_sync) override;
+
         void serialize(CheckpointOut &cp) const override;
         void unserialize(CheckpointIn &cp) override;
     };
@@ -407,6 +474,11 @@ class DistIface : public Drainable, public Serializable
          * recalculated due to changed link latencies at a resume
          */
         bool ckptRestore;
+        /**
+         * Flag to set if the packets come from an upper level switch (and
+         * thus they are sent in the sync interval of that switch)
+         */
+        bool fromUplink;
 
       public:
         /**
@@ -414,10 +486,11 @@ class DistIface : public Drainable, public Serializable
          *
          * @param em The event manager associated with the simulated Ethernet
          * link.
+         * @param is_uplink The link connects to an upper level switch.
          */
-        RecvScheduler(EventManager *em) :
+        RecvScheduler(EventManager *em, bool is_uplink) :
             prevRecvTick(0), recvDone(nullptr), linkDelay(0),
-            eventManager(em), ckptRestore(false) {}
+            eventManager(em), ckptRestore(false), fromUplink(is_uplink) {}
 
         /**
          *  Initialize network link parameters.
@@ -494,6 +567,10 @@ class DistIface : public Drainable, public Serializable
     unsigned distIfaceId;
 
     bool isMaster;
+    /**
+     * Is this the link of a switch to an upper level switch?
+     */
+    bool isUplink;
 
   private:
     /**
@@ -521,6 +598,10 @@ class DistIface : public Drainable, public Serializable
      * Is this node a switch?
      */
      static bool isSwitch;
+    /**
+     * The link to the upper level switch (if this is a rack level switch)
+     */
+    static DistIface *uplink;
 
   private:
     /**
@@ -535,6 +616,11 @@ class DistIface : public Drainable, public Serializable
      * @param header Meta info describing the command (e.g. sync request)
      */
     virtual void sendCmd(const Header &header) = 0;
+    /**
+     * Send out a control command to the upper level switch.
+     * @param header Meta info describing the command (e.g. sync request)
+     */
+    virtual void sendUplinkCmd(const Header &header) = 0;
     /**
      * Receive a header (i.e. meta info describing a data packet or a control command)
      * from the remote end.
@@ -572,6 +658,7 @@ class DistIface : public Drainable, public Serializable
      * @param sync_start Start tick for dist synchronisation
      * @param sync_repeat Frequency for dist synchronisation
      * @param em The event manager associated with the simulated Ethernet link
+     * @param is_uplink The link connects a switch to an upper level switch
      */
     DistIface(unsigned dist_rank,
               unsigned dist_size,
@@ -580,7 +667,8 @@ class DistIface : public Drainable, public Serializable
               EventManager *em,
               bool use_pseudo_op,
               bool is_switch,
-              int num_nodes);
+              int num_nodes,
+              bool is_uplink);
 
     virtual ~DistIface();
     /**
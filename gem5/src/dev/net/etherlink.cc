@@ -70,9 +70,9 @@ EtherLink::EtherLink(const Params *p)
     : SimObject(p)
 {
     link[0] = new Link(name() + ".link0", this, 0, p->speed,
-                       p->delay, p->delay_var, p->dump);
+                       p->delay, p->delay_var, p->batch_window, p->dump);
     link[1] = new Link(name() + ".link1", this, 1, p->speed,
-                       p->delay, p->delay_var, p->dump);
+                       p->delay, p->delay_var, p->batch_window, p->dump);
 
     interface[0] = new Interface(name() + ".int0", link[0], link[1]);
     interface[1] = new Interface(name() + ".int1", link[1], link[0]);
@@ -107,9 +107,11 @@ EtherLink::Interface::Interface(const string &name, Link *tx, Link *rx)
 }
 
 EtherLink::Link::Link(const string &name, EtherLink *p, int num,
-                      double rate, Tick delay, Tick delay_var, EtherDump *d)
+                      double rate, Tick delay, Tick delay_var,
+                      Tick batch_window, EtherDump *d)
     : objName(name), parent(p), number(num), txint(NULL), rxint(NULL),
-      ticksPerByte(rate), linkDelay(delay), delayVar(delay_var), dump(d),
+      ticksPerByte(rate), linkDelay(delay), delayVar(delay_var),
+      batchWindow(batch_window), dump(d),
       doneEvent([this]{ txDone(); }, name),
       txQueueEvent([this]{ processTxQueue(); }, name)
 { }
@@ -146,7 +148,8 @@ EtherLink::Link::txDone()
         DPRINTF(Ethernet, "packet delayed: delay=%d\n", linkDelay);
         txQueue.emplace_back(std::make_pair(curTick() + linkDelay, packet));
         if (!txQueueEvent.scheduled())
-            parent->schedule(txQueueEvent, txQueue.front().first);
+            parent->schedule(txQueueEvent,
+                             txQueue.front().first + batchWindow);
     } else {
         assert(txQueue.empty());
         txComplete(packet);
@@ -161,18 +164,19 @@ EtherLink::Link::txDone()
 void
 EtherLink::Link::processTxQueue()
 {
-    auto cur(txQueue.front());
-    txQueue.pop_front();
-
-    // Schedule a new event to process the next packet in the queue.
-    if (!txQueue.empty()) {
-        auto next(txQueue.front());
-        assert(next.first > curTick());
-        parent->schedule(txQueueEvent, next.first);
+    assert(!txQueue.empty() && txQueue.front().first <= curTick());
+
+    // Deliver every packet that has arrived by now. Without a batch
+    // window this is exactly the packet at the head of the queue.
+    while (!txQueue.empty() && txQueue.front().first <= curTick()) {
+        EthPacketPtr cur(std::move(txQueue.front().second));
+        txQueue.pop_front();
+        txComplete(cur);
     }
 
-    assert(cur.first == curTick());
-    txComplete(cur.second);
+    // Schedule a new event to process the next packets in the queue.
+    if (!txQueue.empty())
+        parent->schedule(txQueueEvent, txQueue.front().first + batchWindow);
 }
 
 bool
@@ -258,7 +262,8 @@ EtherLink::Link::unserialize(const string &base, CheckpointIn &cp)
         }
 
         if (!txQueue.empty())
-            parent->schedule(txQueueEvent, txQueue.front().first);
+            parent->schedule(txQueueEvent,
+                             txQueue.front().first + batchWindow);
     } else {
         // We can't reliably convert in-flight packets from old
         // checkpoints. In fact, gem5 hasn't been able to load these
@@ -83,6 +83,11 @@ class EtherLink : public SimObject
         const double ticksPerByte;
         const Tick linkDelay;
         const Tick delayVar;
+        /**
+         * Packets arriving within this window after the first pending
+         * one are delivered together by a single event
+         */
+        const Tick batchWindow;
         EtherDump *const dump;
 
       protected:
@@ -94,9 +99,9 @@ class EtherLink : public SimObject
         EventFunctionWrapper doneEvent;
 
         /**
-         * Maintain a queue of in-flight packets. Assume that the
-         * delay is non-zero and constant (i.e., at most one packet
-         * per tick).
+         * Maintain a queue of in-flight packets and their arrival
+         * ticks. Assume that the delay is non-zero and constant (i.e.,
+         * the queue is sorted by arrival tick).
          */
         std::deque<std::pair<Tick, EthPacketPtr>> txQueue;
 
@@ -107,7 +112,8 @@ class EtherLink : public SimObject
 
       public:
         Link(const std::string &name, EtherLink *p, int num,
-             double rate, Tick delay, Tick delay_var, EtherDump *dump);
+             double rate, Tick delay, Tick delay_var, Tick batch_window,
+             EtherDump *dump);
         ~Link() {}
 
         const std::string name() const { return objName; }
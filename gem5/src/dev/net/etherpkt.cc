@@ -30,14 +30,116 @@
 
 #include "dev/net/etherpkt.hh"
 
+#include <array>
 #include <iostream>
+#include <vector>
 
 #include "base/inet.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "sim/serialize.hh"
 
 using namespace std;
 
+namespace {
+
+/**
+ * Per-thread cache of packet data buffers, grouped in power of two size
+ * classes. Buffers can be freed by another thread than the one that
+ * allocated them (e.g. packets received by a dist-gem5 receiver thread),
+ * they then simply move to the pool of that thread.
+ */
+class BufferPool
+{
+  public:
+    /** Smallest size class (256 bytes) */
+    static const int MinShift = 8;
+    /** Largest size class (64 KiB), larger buffers aren't cached */
+    static const int MaxShift = 16;
+    /** Maximum number of cached buffers per size class */
+    static const size_t MaxCached = 256;
+
+    ~BufferPool()
+    {
+        destroyed = true;
+        for (auto &buffers : classes) {
+            for (auto buf : buffers)
+                delete [] buf;
+        }
+    }
+
+    static int
+    sizeClass(unsigned size)
+    {
+        return size <= (1U << MinShift) ? MinShift : ceilLog2(size);
+    }
+
+    uint8_t *
+    alloc(unsigned size)
+    {
+        const int shift = sizeClass(size);
+        if (shift > MaxShift)
+            return new uint8_t[size];
+
+        auto &buffers = classes[shift - MinShift];
+        if (buffers.empty())
+            return new uint8_t[1U << shift];
+
+        uint8_t *buf = buffers.back();
+        buffers.pop_back();
+        return buf;
+    }
+
+    void
+    free(uint8_t *buf, unsigned size)
+    {
+        const int shift = sizeClass(size);
+        if (shift > MaxShift) {
+            delete [] buf;
+            return;
+        }
+
+        auto &buffers = classes[shift - MinShift];
+        if (buffers.size() >= MaxCached)
+            delete [] buf;
+        else
+            buffers.push_back(buf);
+    }
+
+    /**
+     * Set once the pool of this thread has been destroyed at thread exit,
+     * packets may still be freed after that.
+     */
+    static thread_local bool destroyed;
+
+  private:
+    std::array<std::vector<uint8_t *>, MaxShift - MinShift + 1> classes;
+};
+
+thread_local bool BufferPool::destroyed = false;
+thread_local BufferPool bufferPool;
+
+} // anonymous namespace
+
+uint8_t *
+EthPacketData::allocBuffer(unsigned size)
+{
+    // Buffers always have the size of their class so that they can be
+    // handed out again for any size of the class.
+    if (BufferPool::destroyed)
+        return new uint8_t[size];
+    return bufferPool.alloc(size);
+}
+
+void
+EthPacketData::freeBuffer(uint8_t *buf, unsigned size)
+{
+    if (!BufferPool::destroyed)
+        bufferPool.free(buf, size);
+    else
+        delete [] buf;
+}
+
 void
 EthPacketData::serialize(const string &base, CheckpointOut &cp) const
 {
@@ -66,7 +168,7 @@ EthPacketData::unserialize(const string &base, CheckpointIn &cp)
     }
     assert(length <= bufLength);
     if (!data)
-        data = new uint8_t[bufLength];
+        data = allocBuffer(bufLength);
     arrayParamIn(cp, base + ".data", data, length);
     if (!optParamIn(cp, base + ".simLength", simLength))
         simLength = length;
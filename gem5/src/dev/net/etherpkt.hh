@@ -78,10 +78,29 @@ class EthPacketData
     { }
 
     explicit EthPacketData(unsigned size)
-        : data(new uint8_t[size]), bufLength(size), length(0), simLength(0)
+        : data(allocBuffer(size)), bufLength(size), length(0), simLength(0)
     { }
 
-    ~EthPacketData() { if (data) delete [] data; }
+    ~EthPacketData() { if (data) freeBuffer(data, bufLength); }
+
+    /**
+     * Allocate a data buffer of at least size bytes.
+     *
+     * Buffers are recycled through per-thread pools of power of two
+     * sized buffers. Most packets of a simulation are of a handful of
+     * sizes (e.g. the NICs allocate a maximum sized frame for every
+     * packet they transmit), so this avoids a heap allocation per
+     * packet.
+     */
+    static uint8_t *allocBuffer(unsigned size);
+    /**
+     * Return a buffer allocated by allocBuffer() to the pool of the
+     * calling thread.
+     *
+     * @param buf The buffer
+     * @param size Size of the buffer (as passed to allocBuffer() or less)
+     */
+    static void freeBuffer(uint8_t *buf, unsigned size);
 
     void serialize(const std::string &base, CheckpointOut &cp) const;
     void unserialize(const std::string &base, CheckpointIn &cp);
@@ -53,12 +53,15 @@
 #include <fcntl.h>
 #include <netinet/in.h>
 #include <sys/ioctl.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cstring>
 #include <deque>
 #include <string>
 
+#include "base/inet.hh"
 #include "base/logging.hh"
 #include "base/pollevent.hh"
 #include "base/socket.hh"
@@ -192,6 +195,12 @@ EtherTapBase::sendSimulated(void *data, size_t len)
     packet->simLength = len;
     memcpy(packet->data, data, len);
 
+    sendSimulated(packet);
+}
+
+void
+EtherTapBase::sendSimulated(EthPacketPtr packet)
+{
     DPRINTF(Ethernet, "EtherTap real->sim len=%d\n", packet->length);
     DDUMP(EthernetData, packet->data, packet->length);
     if (!packetBuffer.empty() || !interface->sendPacket(packet)) {
@@ -401,7 +410,34 @@ EtherTapStub::sendReal(const void *data, size_t len)
 
 #if USE_TUNTAP
 
-EtherTap::EtherTap(const Params *p) : EtherTapBase(p)
+namespace {
+
+/** Largest frame the host hands over with TCP segmentation offload */
+const int MaxTsoFrame = 65536 + 18;
+
+/** One's complement sum of a buffer in network byte order */
+uint16_t
+csumAdd(const uint8_t *buf, size_t len)
+{
+    uint32_t sum = 0;
+    for (; len > 1; buf += 2, len -= 2) {
+        uint16_t word;
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+    }
+    if (len) {
+        uint16_t word = 0;
+        memcpy(&word, buf, 1);
+        sum += word;
+    }
+    while (sum >> 16)
+        sum = (sum & 0xffff) + (sum >> 16);
+    return sum;
+}
+
+} // anonymous namespace
+
+EtherTap::EtherTap(const Params *p) : EtherTapBase(p), vnetHdr(false)
 {
     int fd = open(p->tun_clone_device.c_str(), O_RDWR | O_NONBLOCK);
     if (fd < 0)
@@ -410,10 +446,34 @@ EtherTap::EtherTap(const Params *p) : EtherTapBase(p)
     struct ifreq ifr;
     memset(&ifr, 0, sizeof(ifr));
     ifr.ifr_flags = IFF_TAP | IFF_NO_PI;
+    if (p->offload)
+        ifr.ifr_flags |= IFF_VNET_HDR;
     strncpy(ifr.ifr_name, p->tap_device_name.c_str(), IFNAMSIZ - 1);
 
     if (ioctl(fd, TUNSETIFF, (void *)&ifr) < 0)
         panic("Failed to access tap device %s.\n", ifr.ifr_name);
+
+    if (p->offload) {
+        // Let the host skip checksums and TCP segmentation, we complete
+        // them before the frames enter the simulation.
+        const int hdr_size = sizeof(VnetHdr);
+        const unsigned offloads = TUN_F_CSUM | TUN_F_TSO4 | TUN_F_TSO6;
+        if (ioctl(fd, TUNSETVNETHDRSZ, &hdr_size) < 0)
+            panic("Failed to set the vnet header size of %s.\n",
+                  ifr.ifr_name);
+        if (ioctl(fd, TUNSETOFFLOAD, offloads) < 0)
+            warn("Failed to enable offloads on tap device %s.\n",
+                 ifr.ifr_name);
+        vnetHdr = true;
+
+        // Make room for the largest TSO frame
+        if (buflen < MaxTsoFrame + hdr_size) {
+            delete [] buffer;
+            buflen = MaxTsoFrame + hdr_size;
+            buffer = new uint8_t[buflen];
+        }
+    }
+
     // fd now refers to the tap device.
     tap = fd;
     pollFd(tap);
@@ -443,21 +503,131 @@ EtherTap::recvReal(int revent)
             panic("Failed to read from tap device.\n");
         }
 
-        sendSimulated(buffer, ret);
+        if (vnetHdr) {
+            VnetHdr vnet_hdr;
+            panic_if(ret < sizeof(vnet_hdr),
+                     "Truncated frame from tap device.\n");
+            memcpy(&vnet_hdr, buffer, sizeof(vnet_hdr));
+            recvOffloaded(vnet_hdr, buffer + sizeof(vnet_hdr),
+                          ret - sizeof(vnet_hdr));
+        } else {
+            sendSimulated(buffer, ret);
+        }
+    }
+}
+
+void
+EtherTap::recvOffloaded(const VnetHdr &vnet_hdr, uint8_t *data, size_t len)
+{
+    const uint8_t gso_type = vnet_hdr.gsoType & ~GSO_ECN;
+
+    if (gso_type == GSO_NONE) {
+        if (vnet_hdr.flags & F_NEEDS_CSUM) {
+            // The checksum field holds the sum of the pseudo header, add
+            // the rest of the packet to it.
+            const size_t start = vnet_hdr.csumStart;
+            const size_t field = start + vnet_hdr.csumOffset;
+            if (field + sizeof(uint16_t) > len) {
+                warn_once("EtherTap: Dropping frame with an invalid "
+                          "checksum offset.\n");
+                return;
+            }
+            uint16_t csum = ~csumAdd(data + start, len - start);
+            memcpy(data + field, &csum, sizeof(csum));
+        }
+        sendSimulated(data, len);
+        return;
+    }
+
+    EthPacketPtr packet = make_shared<EthPacketData>(len);
+    memcpy(packet->data, data, len);
+    packet->length = len;
+    packet->simLength = len;
+
+    Net::IpPtr ip(packet);
+    Net::Ip6Ptr ip6(packet);
+    Net::TcpPtr tcp;
+    if (gso_type == GSO_TCPV4 && ip)
+        tcp = ip;
+    else if (gso_type == GSO_TCPV6 && ip6)
+        tcp = Net::TcpPtr(ip6);
+
+    if (!tcp || vnet_hdr.gsoSize == 0) {
+        warn_once("EtherTap: Dropping frame with unsupported offload "
+                  "(gso type %d).\n", gso_type);
+        return;
+    }
+
+    const unsigned hdr_len = tcp.pstart();
+    const unsigned payload_len = packet->length - hdr_len;
+    const unsigned mss = vnet_hdr.gsoSize;
+    const uint32_t seq = tcp->seq();
+    const uint8_t flags = tcp->th_flags;
+    const uint16_t ip_id = ip ? ip->id() : 0;
+
+    DPRINTF(Ethernet, "EtherTap segmenting TSO frame len=%d mss=%d\n",
+            packet->length, mss);
+
+    for (unsigned off = 0; off < payload_len; off += mss) {
+        const unsigned seg_len = std::min(mss, payload_len - off);
+
+        EthPacketPtr seg = make_shared<EthPacketData>(hdr_len + seg_len);
+        memcpy(seg->data, packet->data, hdr_len);
+        memcpy(seg->data + hdr_len, packet->data + hdr_len + off, seg_len);
+        seg->length = hdr_len + seg_len;
+        seg->simLength = seg->length;
+
+        Net::TcpPtr seg_tcp;
+        if (ip) {
+            Net::IpPtr seg_ip(seg);
+            seg_ip->len(seg->length - seg_ip.off());
+            seg_ip->id(ip_id + off / mss);
+            seg_ip->sum(0);
+            seg_ip->sum(cksum(seg_ip));
+            seg_tcp = seg_ip;
+        } else {
+            Net::Ip6Ptr seg_ip6(seg);
+            seg_ip6->plen(seg->length - seg_ip6.off() - seg_ip6->hlen());
+            seg_tcp = Net::TcpPtr(seg_ip6);
+        }
+
+        // FIN and PSH only belong to the last segment, CWR to the first
+        uint8_t seg_flags = flags;
+        if (off + seg_len < payload_len)
+            seg_flags &= ~(TH_FIN | TH_PUSH);
+        if (off > 0)
+            seg_flags &= ~TH_CWR;
+        seg_tcp->flags(seg_flags);
+        seg_tcp->seq(seq + off);
+        seg_tcp->sum(0);
+        seg_tcp->sum(cksum(seg_tcp));
+
+        sendSimulated(seg);
     }
 }
 
 bool
 EtherTap::sendReal(const void *data, size_t len)
 {
-    int n;
+    ssize_t n;
     pollfd pfd[1];
     pfd->fd = tap;
     pfd->events = POLLOUT;
 
+    // Frames from the simulation are complete, the header just tells the
+    // host so.
+    VnetHdr vnet_hdr;
+    memset(&vnet_hdr, 0, sizeof(vnet_hdr));
+    struct iovec iov[] = {
+        { &vnet_hdr, sizeof(vnet_hdr) },
+        { const_cast<void *>(data), len },
+    };
+    const ssize_t frame_len = len + (vnetHdr ? sizeof(vnet_hdr) : 0);
+
     // `tap` is a nonblock fd. Here we try to write until success, and use
     // poll to make a blocking wait.
-    while ((n = write(tap, data, len)) != len) {
+    while ((n = vnetHdr ? writev(tap, iov, 2) : write(tap, data, len)) !=
+           frame_len) {
         if (errno != EAGAIN)
             panic("Failed to write data to tap device.\n");
         pfd->revents = 0;
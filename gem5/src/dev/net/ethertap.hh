@@ -105,6 +105,7 @@ class EtherTapBase : public SimObject
 
     bool recvSimulated(EthPacketPtr packet);
     void sendSimulated(void *data, size_t len);
+    void sendSimulated(EthPacketPtr packet);
 
   protected:
     std::queue<EthPacketPtr> packetBuffer;
@@ -187,8 +188,44 @@ class EtherTap : public EtherTapBase
   protected:
     int tap;
 
+    /**
+     * Header preceding every frame when offloads are enabled (struct
+     * virtio_net_hdr in linux/virtio_net.h)
+     */
+    struct VnetHdr {
+        uint8_t flags;
+        uint8_t gsoType;
+        uint16_t hdrLen;
+        uint16_t gsoSize;
+        uint16_t csumStart;
+        uint16_t csumOffset;
+    };
+
+    /** @{
+     * @name VnetHdr flags and GSO types
+     */
+    static const uint8_t F_NEEDS_CSUM = 1;
+    static const uint8_t GSO_NONE = 0;
+    static const uint8_t GSO_TCPV4 = 1;
+    static const uint8_t GSO_TCPV6 = 4;
+    static const uint8_t GSO_ECN = 0x80;
+    /** @} */
+
+    /**
+     * Every frame is preceded by a virtio net header describing the
+     * offloads the host applied to it
+     */
+    bool vnetHdr;
+
     void recvReal(int revent) override;
     bool sendReal(const void *data, size_t len) override;
+
+    /**
+     * Hand a frame received with offloads over to the simulation. A
+     * partial checksum is completed and a TSO frame is split into MSS
+     * sized segments, the simulated NICs only see regular frames.
+     */
+    void recvOffloaded(const VnetHdr &vnet_hdr, uint8_t *data, size_t len);
 };
 #endif
 
@@ -0,0 +1,342 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory message channel implementation for dist-gem5 runs.
+ */
+
+#include "dev/net/shm_channel.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <ctime>
+#include <thread>
+#include <vector>
+
+#include "base/logging.hh"
+
+/** Ring buffer indices, kept in separate cache lines per side */
+struct ShmChannel::Ring
+{
+    /** Bytes written by the producer */
+    alignas(64) std::atomic<uint64_t> head;
+    /** Futex word the producer bumps when it adds data */
+    std::atomic<uint32_t> dataSeq;
+    /** The consumer is sleeping on dataSeq */
+    std::atomic<uint32_t> readerWaiting;
+
+    /** Bytes read by the consumer */
+    alignas(64) std::atomic<uint64_t> tail;
+    /** Futex word the consumer bumps when it frees space */
+    std::atomic<uint32_t> spaceSeq;
+    /** The producer is sleeping on spaceSeq */
+    std::atomic<uint32_t> writerWaiting;
+};
+
+/** Header of the shared mapping, followed by the ring data */
+struct ShmChannel::Layout
+{
+    char magic[8];
+    uint64_t ringSize;
+    std::atomic<uint32_t> closed;
+    /** Ring 0 is written by the creator, ring 1 by the other side */
+    Ring rings[2];
+};
+
+namespace {
+
+const char channelMagic[8] = { 'G', 'E', 'M', '5', 'S', 'H', 'M', '1' };
+
+/** Offset of the ring data in the mapping */
+const size_t dataOffset = 4096;
+
+/** Number of times to poll before going to sleep */
+const unsigned spinCount = 1000;
+
+/**
+ * Sleep on a futex word while it holds val.
+ *
+ * @return true if the wait timed out.
+ */
+bool
+futexWait(std::atomic<uint32_t> &word, uint32_t val)
+{
+#if defined(__linux__)
+    // Wake up regularly to check if the peer is still around
+    struct timespec timeout = { 0, 100 * 1000 * 1000 };
+    const long ret = syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word),
+                             FUTEX_WAIT, val, &timeout, nullptr, 0);
+    return ret == -1 && errno == ETIMEDOUT;
+#else
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+    return word.load() == val;
+#endif
+}
+
+void
+futexWake(std::atomic<uint32_t> &word)
+{
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&word),
+            FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+} // anonymous namespace
+
+ShmChannel *
+ShmChannel::create(const std::string &dir, size_t ring_size)
+{
+    const std::string tmpl(dir + "/gem5-dist-XXXXXX");
+    std::vector<char> path(tmpl.begin(), tmpl.end());
+    path.push_back('\0');
+
+    const int fd = mkstemp(path.data());
+    if (fd < 0) {
+        fatal("Can't create a shared memory channel in %s: %s\n",
+              dir, strerror(errno));
+    }
+
+    return new ShmChannel(path.data(), fd, ring_size);
+}
+
+ShmChannel *
+ShmChannel::attach(const std::string &path)
+{
+    const int fd = open(path.c_str(), O_RDWR);
+    if (fd < 0) {
+        fatal("Can't open shared memory channel %s: %s\n",
+              path, strerror(errno));
+    }
+
+    return new ShmChannel(path, fd, 0);
+}
+
+ShmChannel::ShmChannel(const std::string &path, int fd, size_t ring_size)
+    : _path(path), mapSize(0), layout(nullptr), ringSize(ring_size)
+{
+    static_assert(sizeof(Layout) <= dataOffset,
+                  "The channel header has to fit in front of the data");
+
+    const bool creator(ring_size != 0);
+    if (creator) {
+        mapSize = dataOffset + 2 * ringSize;
+        if (ftruncate(fd, mapSize) != 0) {
+            fatal("Can't size shared memory channel %s: %s\n",
+                  path, strerror(errno));
+        }
+    } else {
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+            fatal("Can't stat %s: %s\n", path, strerror(errno));
+        mapSize = st.st_size;
+    }
+
+    void *base = mmap(nullptr, mapSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        fatal("Can't map shared memory channel %s: %s\n",
+              path, strerror(errno));
+    }
+
+    layout = static_cast<Layout *>(base);
+    if (creator) {
+        // The file is zero filled, which initialises the indices
+        layout->ringSize = ringSize;
+        std::memcpy(layout->magic, channelMagic, sizeof(channelMagic));
+    } else {
+        if (mapSize < dataOffset ||
+            std::memcmp(layout->magic, channelMagic, sizeof(channelMagic))) {
+            fatal("%s isn't a dist-gem5 shared memory channel\n", path);
+        }
+        ringSize = layout->ringSize;
+        if (mapSize != dataOffset + 2 * ringSize)
+            fatal("Shared memory channel %s is truncated\n", path);
+    }
+
+    uint8_t *data = static_cast<uint8_t *>(base) + dataOffset;
+    const unsigned tx(creator ? 0 : 1);
+    txRing = &layout->rings[tx];
+    txData = data + tx * ringSize;
+    rxRing = &layout->rings[1 - tx];
+    rxData = data + (1 - tx) * ringSize;
+}
+
+ShmChannel::~ShmChannel()
+{
+    munmap(layout, mapSize);
+}
+
+void
+ShmChannel::unlink()
+{
+    if (::unlink(_path.c_str()) != 0)
+        warn("Can't remove shared memory channel %s: %s\n",
+             _path, strerror(errno));
+}
+
+bool
+ShmChannel::closed() const
+{
+    return layout->closed.load() != 0;
+}
+
+void
+ShmChannel::close()
+{
+    layout->closed.store(1);
+    for (Ring &r : layout->rings) {
+        r.dataSeq.fetch_add(1);
+        futexWake(r.dataSeq);
+        r.spaceSeq.fetch_add(1);
+        futexWake(r.spaceSeq);
+    }
+}
+
+void
+ShmChannel::wake(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiting)
+{
+    seq.fetch_add(1);
+    if (waiting.load())
+        futexWake(seq);
+}
+
+bool
+ShmChannel::wait(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiting,
+                 const std::function<bool()> &ready)
+{
+    // The peer usually responds quickly, avoid the system calls
+    for (unsigned i = 0; i < spinCount; ++i) {
+        if (ready())
+            return true;
+    }
+
+    while (true) {
+        const uint32_t val(seq.load());
+        if (ready())
+            return true;
+        if (closed())
+            return false;
+
+        // Announce that we are about to sleep and check again, the
+        // other side either sees the flag or we see its progress.
+        waiting.store(1);
+        const bool timed_out(!ready() && futexWait(seq, val));
+        waiting.store(0);
+
+        if (timed_out && alive && !alive())
+            return false;
+    }
+}
+
+bool
+ShmChannel::write(const uint8_t *buf, size_t length)
+{
+    Ring &r(*txRing);
+    while (length) {
+        const uint64_t head(r.head.load(std::memory_order_relaxed));
+        auto space = [&]() { return ringSize - (head - r.tail.load()); };
+        if (space() == 0 &&
+            !wait(r.spaceSeq, r.writerWaiting,
+                  [&]() { return space() != 0; })) {
+            return false;
+        }
+
+        const size_t chunk(std::min<size_t>(length, space()));
+        const size_t offset(head % ringSize);
+        const size_t first(std::min(chunk, ringSize - offset));
+        std::memcpy(txData + offset, buf, first);
+        std::memcpy(txData, buf + first, chunk - first);
+
+        r.head.store(head + chunk);
+        wake(r.dataSeq, r.readerWaiting);
+
+        buf += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
+
+bool
+ShmChannel::send(const void *buf, size_t length,
+                 const void *buf2, size_t length2)
+{
+    std::lock_guard<std::mutex> lock(sendLock);
+    if (closed())
+        return false;
+
+    return write(static_cast<const uint8_t *>(buf), length) &&
+        write(static_cast<const uint8_t *>(buf2), length2);
+}
+
+bool
+ShmChannel::recv(void *buf, size_t length)
+{
+    std::lock_guard<std::mutex> lock(recvLock);
+    Ring &r(*rxRing);
+    uint8_t *dst(static_cast<uint8_t *>(buf));
+    while (length) {
+        const uint64_t tail(r.tail.load(std::memory_order_relaxed));
+        auto avail = [&]() { return r.head.load() - tail; };
+        if (avail() == 0 &&
+            !wait(r.dataSeq, r.readerWaiting,
+                  [&]() { return avail() != 0; })) {
+            return false;
+        }
+
+        const size_t chunk(std::min<size_t>(length, avail()));
+        const size_t offset(tail % ringSize);
+        const size_t first(std::min(chunk, ringSize - offset));
+        std::memcpy(dst, rxData + offset, first);
+        std::memcpy(dst + first, rxData, chunk - first);
+
+        r.tail.store(tail + chunk);
+        wake(r.spaceSeq, r.writerWaiting);
+
+        dst += chunk;
+        length -= chunk;
+    }
+
+    return true;
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Shared memory message channel for dist-gem5 runs on a single host.
+ */
+
+#ifndef __DEV_NET_SHM_CHANNEL_HH__
+#define __DEV_NET_SHM_CHANNEL_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+
+/**
+ * Bidirectional message channel between two gem5 processes on the same
+ * host.
+ *
+ * The channel lives in a shared file mapping holding one ring buffer
+ * per direction. Each ring is a single-producer single-consumer byte
+ * stream: the producer only updates the head and the consumer only
+ * updates the tail, so the processes never share a lock. A side that
+ * has to wait for data or space spins briefly and then sleeps on a
+ * futex in the mapping. The other side only makes the wake-up system
+ * call if the waiter announced itself.
+ *
+ * Threads of the same process are serialised by a local mutex on each
+ * side, which keeps the rings single-producer and single-consumer.
+ */
+class ShmChannel
+{
+  public:
+    /**
+     * Callback used while waiting to check if the peer is still
+     * alive.
+     */
+    typedef std::function<bool()> AliveFunc;
+
+    /**
+     * Create a new channel.
+     *
+     * @param dir Directory to create the backing file in, it should be
+     * on a memory file system such as /dev/shm.
+     * @param ring_size Size of the ring of each direction in bytes.
+     */
+    static ShmChannel *create(const std::string &dir, size_t ring_size);
+
+    /**
+     * Attach to a channel created by another process.
+     *
+     * @param path Backing file of the channel.
+     */
+    static ShmChannel *attach(const std::string &path);
+
+    ~ShmChannel();
+
+    /** Path of the backing file */
+    const std::string &path() const { return _path; }
+
+    /** Remove the backing file once both sides have attached. */
+    void unlink();
+
+    /** Install a callback to detect a peer that died. */
+    void setAliveCheck(AliveFunc func) { alive = func; }
+
+    /**
+     * Send a message made of up to two parts, e.g., a header and a
+     * payload. The parts aren't interleaved with other messages.
+     *
+     * @return false if the channel has been closed.
+     */
+    bool send(const void *buf, size_t length,
+              const void *buf2 = nullptr, size_t length2 = 0);
+
+    /**
+     * Receive exactly length bytes, blocking until they are available.
+     *
+     * @return false if the channel has been closed.
+     */
+    bool recv(void *buf, size_t length);
+
+    /** Close the channel and wake up everybody waiting on it. */
+    void close();
+
+  private:
+    struct Ring;
+    struct Layout;
+
+    ShmChannel(const std::string &path, int fd, size_t ring_size);
+
+    /** Write part of a message, the send lock must be held */
+    bool write(const uint8_t *buf, size_t length);
+
+    /**
+     * Wait until ready() returns true.
+     *
+     * @param seq Futex word bumped by the other side on progress.
+     * @param waiting Flag telling the other side to wake us up.
+     * @return false if the channel was closed or the peer is gone.
+     */
+    bool wait(std::atomic<uint32_t> &seq, std::atomic<uint32_t> &waiting,
+              const std::function<bool()> &ready);
+
+    /** Wake up a thread sleeping on a futex word if it asked for it */
+    static void wake(std::atomic<uint32_t> &seq,
+                     std::atomic<uint32_t> &waiting);
+
+    bool closed() const;
+
+    std::string _path;
+    size_t mapSize;
+    Layout *layout;
+    size_t ringSize;
+
+    Ring *txRing;
+    uint8_t *txData;
+    Ring *rxRing;
+    uint8_t *rxData;
+
+    AliveFunc alive;
+
+    std::mutex sendLock;
+    std::mutex recvLock;
+};
+
+#endif // __DEV_NET_SHM_CHANNEL_HH__
@@ -47,6 +47,7 @@
 #include <arpa/inet.h>
 #include <netdb.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #include <sys/socket.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -58,6 +59,7 @@
 #include "base/types.hh"
 #include "debug/DistEthernet.hh"
 #include "debug/DistEthernetCmd.hh"
+#include "dev/net/shm_channel.hh"
 #include "sim/sim_exit.hh"
 
 #if defined(__FreeBSD__)
@@ -75,7 +77,7 @@
 using namespace std;
 
 std::vector<std::pair<TCPIface::NodeInfo, int> > TCPIface::nodes;
-vector<int> TCPIface::sockRegistry;
+vector<TCPIface *> TCPIface::ifaceRegistry;
 int TCPIface::fdStatic = -1;
 bool TCPIface::anyListening = false;
 
@@ -83,12 +85,17 @@ TCPIface::TCPIface(string server_name, unsigned server_port,
                    unsigned dist_rank, unsigned dist_size,
                    Tick sync_start, Tick sync_repeat,
                    EventManager *em, bool use_pseudo_op, bool is_switch,
-                   int num_nodes) :
+                   int num_nodes, bool use_shm, const string &shm_dir,
+                   size_t shm_ring_size, bool is_uplink) :
     DistIface(dist_rank, dist_size, sync_start, sync_repeat, em, use_pseudo_op,
-              is_switch, num_nodes), serverName(server_name),
-    serverPort(server_port), isSwitch(is_switch), listening(false)
+              is_switch, num_nodes, is_uplink), serverName(server_name),
+    serverPort(server_port), isSwitch(is_switch && !is_uplink),
+    useShm(use_shm), shmDir(shm_dir), shmRingSize(shm_ring_size),
+    channel(nullptr), listening(false)
 {
-    if (is_switch && isMaster) {
+    // The first switch link (which is not an uplink) listens for all
+    // connections
+    if (isSwitch && !anyListening) {
         while (!listen(serverPort)) {
             DPRINTF(DistEthernet, "TCPIface(listen): Can't bind port %d\n",
                     serverPort);
@@ -188,10 +195,11 @@ TCPIface::establishConnection()
         sendTCP(sock, &ni, sizeof(ni));
     } else { // this is not a switch
         connect();
-        // send link info
+        // send link info (a switch has a single uplink to the upper level
+        // switch)
         ni.rank = rank;
-        ni.distIfaceId = distIfaceId;
-        ni.distIfaceNum = distIfaceNum;
+        ni.distIfaceId = isUplink ? 0 : distIfaceId;
+        ni.distIfaceNum = isUplink ? 1 : distIfaceNum;
         sendTCP(sock, &ni, sizeof(ni));
         DPRINTF(DistEthernet, "Connected, waiting for ack (distIfaceId:%d\n",
                 distIfaceId);
@@ -201,7 +209,59 @@ TCPIface::establishConnection()
         inform("Link okay  (iface:%d -> switch iface:%d)", distIfaceId,
                ni.distIfaceId);
     }
-    sockRegistry.push_back(sock);
+
+    if (useShm)
+        establishShm();
+
+    ifaceRegistry.push_back(this);
+}
+
+void
+TCPIface::establishShm()
+{
+    const uint32_t shm_magic = 0x53484d31; // "SHM1"
+    struct ShmInfo
+    {
+        uint32_t magic;
+        char path[256];
+    } info;
+
+    if (isSwitch) {
+        // The compute node creates the channel, we attach to it
+        if (!recvTCP(sock, &info, sizeof(info)) || info.magic != shm_magic)
+            panic("Failed to receive shared memory channel info, are all "
+                  "gem5 processes using the shared memory transport?");
+        info.path[sizeof(info.path) - 1] = '\0';
+        channel = ShmChannel::attach(info.path);
+        sendTCP(sock, &shm_magic, sizeof(shm_magic));
+    } else {
+        channel = ShmChannel::create(shmDir, shmRingSize);
+        panic_if(channel->path().size() >= sizeof(info.path),
+                 "Shared memory channel path too long: %s",
+                 channel->path());
+        memset(&info, 0, sizeof(info));
+        info.magic = shm_magic;
+        strcpy(info.path, channel->path().c_str());
+        sendTCP(sock, &info, sizeof(info));
+
+        uint32_t ack;
+        if (!recvTCP(sock, &ack, sizeof(ack)) || ack != shm_magic)
+            panic("Failed to attach shared memory channel");
+        // Both sides have the channel mapped, the file isn't needed
+        // anymore.
+        channel->unlink();
+    }
+
+    // Nothing is sent through the socket from now on, so it only
+    // becomes readable when the peer closes it.
+    const int peer_sock = sock;
+    channel->setAliveCheck([peer_sock]() {
+            struct pollfd pfd = { peer_sock, POLLIN, 0 };
+            return poll(&pfd, 1, 0) == 0;
+        });
+
+    DPRINTF(DistEthernet, "Using shared memory channel %s\n",
+            channel->path());
 }
 
 void
@@ -256,6 +316,11 @@ TCPIface::~TCPIface()
 {
     int M5_VAR_USED ret;
 
+    if (channel) {
+        channel->close();
+        delete channel;
+    }
+
     ret = close(sock);
     assert(ret == 0);
 }
@@ -296,11 +361,35 @@ TCPIface::recvTCP(int sock, void *buf, unsigned length)
     return (ret == length);
 }
 
+void
+TCPIface::sendMsg(const void *buf, unsigned length,
+                  const void *payload, unsigned payload_length)
+{
+    if (channel) {
+        if (!channel->send(buf, length, payload, payload_length)) {
+            exitSimLoop("Shared memory channel closed, simulation "
+                        "is exiting");
+        }
+    } else {
+        sendTCP(sock, buf, length);
+        if (payload_length)
+            sendTCP(sock, payload, payload_length);
+    }
+}
+
+bool
+TCPIface::recvMsg(void *buf, unsigned length)
+{
+    if (channel)
+        return channel->recv(buf, length);
+    else
+        return recvTCP(sock, buf, length);
+}
+
 void
 TCPIface::sendPacket(const Header &header, const EthPacketPtr &packet)
 {
-    sendTCP(sock, &header, sizeof(header));
-    sendTCP(sock, packet->data, packet->length);
+    sendMsg(&header, sizeof(header), packet->data, packet->length);
 }
 
 void
@@ -311,14 +400,25 @@ TCPIface::sendCmd(const Header &header)
     // Global commands (i.e. sync request) are always sent by the master
     // DistIface. The transfer method is simply implemented as point-to-point
     // messages for now
-    for (auto s: sockRegistry)
-        sendTCP(s, (void*)&header, sizeof(header));
+    for (auto i: ifaceRegistry) {
+        if (!i->isUplink)
+            i->sendMsg(&header, sizeof(header));
+    }
+}
+
+void
+TCPIface::sendUplinkCmd(const Header &header)
+{
+    DPRINTF(DistEthernetCmd, "TCPIface::sendUplinkCmd() type: %d\n",
+            static_cast<int>(header.msgType));
+    assert(isUplink);
+    sendMsg(&header, sizeof(header));
 }
 
 bool
 TCPIface::recvHeader(Header &header)
 {
-    bool ret = recvTCP(sock, &header, sizeof(header));
+    bool ret = recvMsg(&header, sizeof(header));
     DPRINTF(DistEthernetCmd, "TCPIface::recvHeader() type: %d ret: %d\n",
             static_cast<int>(header.msgType), ret);
     return ret;
@@ -328,7 +428,7 @@ void
 TCPIface::recvPacket(const Header &header, EthPacketPtr &packet)
 {
     packet = make_shared<EthPacketData>(header.dataPacketLength);
-    bool ret = recvTCP(sock, packet->data, header.dataPacketLength);
+    bool ret = recvMsg(packet->data, header.dataPacketLength);
     panic_if(!ret, "Error while reading socket");
     packet->simLength = header.simLength;
     packet->length = header.dataPacketLength;
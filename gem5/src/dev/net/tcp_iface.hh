@@ -48,6 +48,11 @@
  * simulates a switch box) via a stream socket. The server process
  * transfers messages and co-ordinates the synchronisation among the gem5
  * peers.
+ *
+ * When all gem5 processes run on the same host, the messages can be
+ * exchanged through a shared memory channel instead. The stream socket
+ * is then only used to establish the connection (so the switch ports
+ * are assigned as usual) and to detect that a peer has gone away.
  */
 #ifndef __DEV_NET_TCP_IFACE_HH__
 #define __DEV_NET_TCP_IFACE_HH__
@@ -58,6 +63,7 @@
 #include "dev/net/dist_iface.hh"
 
 class EventManager;
+class ShmChannel;
 
 class TCPIface : public DistIface
 {
@@ -70,8 +76,21 @@ class TCPIface : public DistIface
     std::string serverName;
     int serverPort;
 
+    /**
+     * Accept the connection from the peer (the uplink of a switch connects
+     * to an upper level switch instead)
+     */
     bool isSwitch;
 
+    /** Exchange messages through shared memory */
+    bool useShm;
+    /** Directory for the shared memory channel files */
+    std::string shmDir;
+    /** Size of each direction of the shared memory channel */
+    size_t shmRingSize;
+    /** Shared memory channel to the peer, if any */
+    ShmChannel *channel;
+
     bool listening;
     static bool anyListening;
     static int fdStatic;
@@ -88,9 +107,9 @@ class TCPIface : public DistIface
     };
     static std::vector<std::pair<NodeInfo, int> > nodes;
     /**
-     * Storage for all opened sockets
+     * Storage for all connected interfaces
      */
-    static std::vector<int> sockRegistry;
+    static std::vector<TCPIface *> ifaceRegistry;
 
   private:
 
@@ -112,6 +131,31 @@ class TCPIface : public DistIface
      * @param length Exact size of the expected message in bytes.
      */
     bool recvTCP(int sock, void *buf, unsigned length);
+
+    /**
+     * Send a message to the peer through the active transport.
+     *
+     * @param buf Start address of the message.
+     * @param length Size of the message in bytes.
+     * @param payload Optional payload sent right after the message.
+     * @param payload_length Size of the payload in bytes.
+     */
+    void sendMsg(const void *buf, unsigned length,
+                 const void *payload = nullptr, unsigned payload_length = 0);
+
+    /**
+     * Receive the next incoming message through the active transport.
+     *
+     * @param buf Start address of buffer to store the message.
+     * @param length Exact size of the expected message in bytes.
+     */
+    bool recvMsg(void *buf, unsigned length);
+
+    /**
+     * Move the connection to a shared memory channel once the socket
+     * has been connected.
+     */
+    void establishShm();
     bool listen(int port);
     void accept();
     void connect();
@@ -127,6 +171,8 @@ class TCPIface : public DistIface
 
     void sendCmd(const Header &header) override;
 
+    void sendUplinkCmd(const Header &header) override;
+
     bool recvHeader(Header &header) override;
 
     void recvPacket(const Header &header, EthPacketPtr &packet) override;
@@ -144,11 +190,19 @@ class TCPIface : public DistIface
      * @param sync_repeat The frequency of dist synchronisation.
      * @param em The EventManager object associated with the simulated
      * Ethernet link.
+     * @param use_shm Exchange messages through shared memory.
+     * @param shm_dir Directory for the shared memory channel files.
+     * @param shm_ring_size Size of each direction of a shared memory
+     * channel.
+     * @param is_uplink The link connects this switch to an upper level
+     * switch (which acts as the server).
      */
     TCPIface(std::string server_name, unsigned server_port,
              unsigned dist_rank, unsigned dist_size,
              Tick sync_start, Tick sync_repeat, EventManager *em,
-             bool use_pseudo_op, bool is_switch, int num_nodes);
+             bool use_pseudo_op, bool is_switch, int num_nodes,
+             bool use_shm=false, const std::string &shm_dir="",
+             size_t shm_ring_size=0, bool is_uplink=false);
 
     ~TCPIface() override;
 };
@@ -57,4 +57,12 @@ class CopyEngine(PciDevice):
     latBeforeBegin = Param.Latency('20ns', "Latency after a DMA command is seen before it's proccessed")
     latAfterCompletion = Param.Latency('20ns', "Latency after a DMA command is complete before it's reported as such")
 
+    functionalCopy = Param.Bool(False, "Move the data of a copy "
+        "functionally and only charge the time it would take instead of "
+        "simulating every DMA packet")
+    copyLatency = Param.Latency('100ns', "Fixed latency of a copy when "
+        "copying functionally")
+    copyBandwidth = Param.MemoryBandwidth('8GB/s', "Bandwidth of a copy "
+        "when copying functionally")
+
 
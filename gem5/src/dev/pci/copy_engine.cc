@@ -83,6 +83,9 @@ CopyEngine::CopyEngineChannel::CopyEngineChannel(CopyEngine *_ce, int cid)
       ce(_ce), channelId(cid), busy(false), underReset(false),
       refreshNext(false), latBeforeBegin(ce->params()->latBeforeBegin),
       latAfterCompletion(ce->params()->latAfterCompletion),
+      functionalCopy(ce->params()->functionalCopy),
+      copyLatency(ce->params()->copyLatency),
+      copyBandwidth(ce->params()->copyBandwidth),
       completionDataReg(0), nextState(Idle),
       fetchCompleteEvent([this]{ fetchDescComplete(); }, name()),
       addrCompleteEvent([this]{ fetchAddrComplete(); }, name()),
@@ -505,6 +508,17 @@ CopyEngine::CopyEngineChannel::readCopyBytes()
     DPRINTF(DMACopyEngine, "Reading %d bytes from buffer to memory location %#x(%#x)\n",
            curDmaDesc->len, curDmaDesc->dest,
            ce->pciToDma(curDmaDesc->src));
+
+    if (functionalCopy) {
+        // The read is folded into the write, which is charged the time
+        // of the whole copy.
+        ce->sys->physProxy.readBlob(ce->pciToDma(curDmaDesc->src),
+                                    copyBuffer, curDmaDesc->len);
+        nextState = DMAWrite;
+        writeCopyBytes();
+        return;
+    }
+
     cePort.dmaAction(MemCmd::ReadReq, ce->pciToDma(curDmaDesc->src),
                      curDmaDesc->len, &readCompleteEvent, copyBuffer, 0);
 }
@@ -527,8 +541,15 @@ CopyEngine::CopyEngineChannel::writeCopyBytes()
            curDmaDesc->len, curDmaDesc->dest,
            ce->pciToDma(curDmaDesc->dest));
 
-    cePort.dmaAction(MemCmd::WriteReq, ce->pciToDma(curDmaDesc->dest),
-                     curDmaDesc->len, &writeCompleteEvent, copyBuffer, 0);
+    if (functionalCopy) {
+        ce->sys->physProxy.writeBlob(ce->pciToDma(curDmaDesc->dest),
+                                     copyBuffer, curDmaDesc->len);
+        ce->schedule(writeCompleteEvent, curTick() + copyLatency +
+                     Tick(curDmaDesc->len * copyBandwidth));
+    } else {
+        cePort.dmaAction(MemCmd::WriteReq, ce->pciToDma(curDmaDesc->dest),
+                         curDmaDesc->len, &writeCompleteEvent, copyBuffer, 0);
+    }
 
     ce->bytesCopied[channelId] += curDmaDesc->len;
     ce->copiesProcessed[channelId]++;
@@ -79,6 +79,12 @@ class CopyEngine : public PciDevice
         Tick latBeforeBegin;
         Tick latAfterCompletion;
 
+        /** Copy through the backdoor and charge a modelled duration */
+        bool functionalCopy;
+        Tick copyLatency;
+        /** Ticks per byte of a functional copy */
+        double copyBandwidth;
+
         uint64_t completionDataReg;
 
         enum ChannelState {
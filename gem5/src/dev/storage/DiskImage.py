@@ -38,11 +38,16 @@ class DiskImage(SimObject):
 class RawDiskImage(DiskImage):
     type = 'RawDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
+    direct_io = Param.Bool(False, "Bypass the host page cache")
+    readahead = Param.Unsigned(256, "Sectors the host reads ahead of " \
+                               "sequential reads in the background")
 
 class CowDiskImage(DiskImage):
     type = 'CowDiskImage'
     cxx_header = "dev/storage/disk_image.hh"
     child = Param.DiskImage(RawDiskImage(read_only=True),
                             "child image")
-    table_size = Param.Int(65536, "initial table size")
+    # The overlay is sized after the child, this is only kept for the
+    # configs that still set it
+    table_size = Param.Int(65536, "unused")
     image_file = ""
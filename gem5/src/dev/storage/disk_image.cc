@@ -34,16 +34,22 @@
 
 #include "dev/storage/disk_image.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cerrno>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 #include <string>
 
 #include "base/callback.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/DiskImageRead.hh"
@@ -53,12 +59,52 @@
 
 using namespace std;
 
+////////////////////////////////////////////////////////////////////////
+//
+// Disk image
+//
+std::streampos
+DiskImage::readSectors(uint8_t *data, std::streampos offset,
+                       unsigned count) const
+{
+    uint64_t done = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        std::streampos ret = read(data + i * SectorSize,
+                                 offset + streamoff(i));
+        done += ret;
+        if (ret != SectorSize)
+            break;
+    }
+    return done;
+}
+
+std::streampos
+DiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                        unsigned count)
+{
+    uint64_t done = 0;
+    for (unsigned i = 0; i < count; ++i) {
+        std::streampos ret = write(data + i * SectorSize,
+                                  offset + streamoff(i));
+        done += ret;
+        if (ret != SectorSize)
+            break;
+    }
+    return done;
+}
+
 ////////////////////////////////////////////////////////////////////////
 //
 // Raw Disk image
 //
+
+// Alignment of the buffers of direct I/O, which covers the logical
+// block size of the common host devices
+static const uint64_t directIOAlign = 4096;
+
 RawDiskImage::RawDiskImage(const Params* p)
-    : DiskImage(p), disk_size(0)
+    : DiskImage(p), fd(-1), directIO(p->direct_io),
+      readahead(p->readahead * SectorSize), nextRead(0), disk_size(0)
 { open(p->image_file, p->read_only); }
 
 RawDiskImage::~RawDiskImage()
@@ -83,11 +129,22 @@ RawDiskImage::open(const string &filename, bool rd_only)
         readonly = rd_only;
         file = filename;
 
-        ios::openmode mode = ios::in | ios::binary;
-        if (!readonly)
-            mode |= ios::out;
-        stream.open(file.c_str(), mode);
-        if (!stream.is_open())
+        int flags = readonly ? O_RDONLY : O_RDWR;
+#ifdef O_DIRECT
+        if (directIO)
+            flags |= O_DIRECT;
+#else
+        warn_if(directIO, "Direct I/O is not supported on this host\n");
+        directIO = false;
+#endif
+        fd = ::open(file.c_str(), flags);
+        if (fd < 0 && directIO) {
+            warn("Can't open %s for direct I/O, using the page cache\n",
+                 filename);
+            directIO = false;
+            fd = ::open(file.c_str(), readonly ? O_RDONLY : O_RDWR);
+        }
+        if (fd < 0)
             panic("Error opening %s", filename);
     }
 }
@@ -95,46 +152,116 @@ RawDiskImage::open(const string &filename, bool rd_only)
 void
 RawDiskImage::close()
 {
-    stream.close();
+    if (fd >= 0)
+        ::close(fd);
+    fd = -1;
 }
 
 std::streampos
 RawDiskImage::size() const
 {
     if (disk_size == 0) {
-        if (!stream.is_open())
+        if (fd < 0)
             panic("file not open!\n");
-        stream.seekg(0, ios::end);
-        disk_size = stream.tellg();
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+            panic("Could not get the size of %s", file);
+        disk_size = st.st_size;
     }
 
     return disk_size / SectorSize;
 }
 
+uint64_t
+RawDiskImage::transfer(bool is_write, uint8_t *data, uint64_t len,
+                       uint64_t pos) const
+{
+    // direct I/O needs aligned buffers, the ones of the devices are
+    // not necessarily
+    uint8_t *buf = data;
+    void *bounce = nullptr;
+    if (directIO && (uintptr_t)data % directIOAlign != 0) {
+        if (posix_memalign(&bounce, directIOAlign, len) != 0)
+            panic("Could not allocate a buffer for direct I/O");
+        buf = (uint8_t *)bounce;
+        if (is_write)
+            memcpy(buf, data, len);
+    }
+
+    uint64_t done = 0;
+    while (done < len) {
+        ssize_t ret = is_write ?
+            pwrite(fd, buf + done, len - done, pos + done) :
+            pread(fd, buf + done, len - done, pos + done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+#ifdef O_DIRECT
+        if (ret < 0 && errno == EINVAL && directIO) {
+            // the device has larger blocks than the sectors
+            warn("Direct I/O failed on %s, using the page cache\n", file);
+            directIO = false;
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) & ~O_DIRECT);
+            continue;
+        }
+#endif
+        if (ret <= 0)
+            break;
+        done += ret;
+    }
+
+    if (bounce) {
+        if (!is_write)
+            memcpy(data, buf, done);
+        free(bounce);
+    }
+    return done;
+}
+
 std::streampos
 RawDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+RawDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekg(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
+    const uint64_t pos = offset * SectorSize;
+    const uint64_t len = count * SectorSize;
+    const uint64_t done = transfer(false, data, len, pos);
 
-    streampos pos = stream.tellg();
-    stream.read((char *)data, SectorSize);
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageRead, data, done);
 
-    DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageRead, data, SectorSize);
+#ifdef POSIX_FADV_WILLNEED
+    // have the host read the sectors following a sequential read in
+    // the background, so that the next ones are in the page cache by
+    // the time the simulated disk gets to them
+    if (readahead && !directIO && pos == nextRead)
+        posix_fadvise(fd, pos + len, readahead, POSIX_FADV_WILLNEED);
+#endif
+    nextRead = pos + len;
 
-    return stream.tellg() - pos;
+    return done;
 }
 
 std::streampos
-RawDiskImage::write(const uint8_t *data, std::streampos offset)
+RawDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
 {
     if (!initialized)
         panic("RawDiskImage not initialized");
@@ -142,19 +269,15 @@ RawDiskImage::write(const uint8_t *data, std::streampos offset)
     if (readonly)
         panic("Cannot write to a read only disk image");
 
-    if (!stream.is_open())
+    if (fd < 0)
         panic("file not open!\n");
 
-    stream.seekp(offset * SectorSize, ios::beg);
-    if (!stream.good())
-        panic("Could not seek to location in file");
-
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n",
+            (uint64_t)offset, count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    streampos pos = stream.tellp();
-    stream.write((const char *)data, SectorSize);
-    return stream.tellp() - pos;
+    return transfer(true, const_cast<uint8_t *>(data), count * SectorSize,
+                    offset * SectorSize);
 }
 
 RawDiskImage *
@@ -167,9 +290,14 @@ RawDiskImageParams::create()
 //
 // Copy on Write Disk image
 //
-const uint32_t CowDiskImage::VersionMajor = 1;
+const uint32_t CowDiskImage::VersionMajor = 2;
 const uint32_t CowDiskImage::VersionMinor = 0;
 
+// Overlay files start with this magic, the files of sector tables
+// written before the overlays existed with the legacy one
+static const char overlayMagic[] = "GEM5COW2";
+static const char legacyMagic[] = "COWDISK!";
+
 class CowDiskCallback : public Callback
 {
   private:
@@ -181,15 +309,28 @@ class CowDiskCallback : public Callback
 };
 
 CowDiskImage::CowDiskImage(const Params *p)
-    : DiskImage(p), filename(p->image_file), child(p->child), table(NULL)
+    : DiskImage(p), filename(p->image_file), child(p->child), fd(-1),
+      sharedMap(false), overlay(nullptr), overlaySize(0),
+      sectors(child->size()), bitmap(nullptr), sectorData(nullptr)
 {
     if (filename.empty()) {
-        initSectorTable(p->table_size);
+        map(-1, false);
     } else {
-        if (!open(filename)) {
+        if (!open(filename, !p->read_only)) {
             if (p->read_only)
                 fatal("could not open read-only file");
-            initSectorTable(p->table_size);
+
+            // start from an empty overlay file, which is sparse
+            int new_fd = ::open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+            const OverlayHeader header = layout();
+            if (new_fd < 0 ||
+                ftruncate(new_fd, header.dataOffset +
+                          sectors * SectorSize) != 0 ||
+                pwrite(new_fd, &header, sizeof(header), 0) !=
+                sizeof(header)) {
+                panic("Could not create %s", filename);
+            }
+            map(new_fd, true);
         }
 
         if (!p->read_only)
@@ -199,13 +340,67 @@ CowDiskImage::CowDiskImage(const Params *p)
 
 CowDiskImage::~CowDiskImage()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
+    unmap();
+}
+
+CowDiskImage::OverlayHeader
+CowDiskImage::layout() const
+{
+    OverlayHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, overlayMagic, sizeof(header.magic));
+    header.version = VersionMajor;
+    header.sectorSize = SectorSize;
+    header.sectors = sectors;
+
+    // the chunks of the sectors are aligned in the file, so that the
+    // ones that were never written are holes
+    const uint64_t chunk_size = ChunkSectors * SectorSize;
+    header.bitmapOffset = chunk_size;
+    header.dataOffset = header.bitmapOffset +
+        roundUp(divCeil(sectors, ChunkSectors) * ChunkSectors / 8,
+                chunk_size);
+    return header;
+}
 
-    while (i != end) {
-        delete (*i).second;
-        ++i;
+void
+CowDiskImage::map(int new_fd, bool shared)
+{
+    const OverlayHeader header = layout();
+    const uint64_t size = header.dataOffset + sectors * SectorSize;
+
+    uint8_t *mem;
+    if (new_fd < 0) {
+        // anonymous memory only takes up space where it is written
+        mem = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                              -1, 0);
+    } else {
+        mem = (uint8_t *)mmap(NULL, size, PROT_READ | PROT_WRITE,
+                              shared ? MAP_SHARED : MAP_PRIVATE, new_fd, 0);
     }
+    if (mem == (uint8_t *)MAP_FAILED)
+        panic("Could not map the overlay of %s", name());
+
+    unmap();
+    fd = new_fd;
+    sharedMap = shared;
+    overlay = mem;
+    overlaySize = size;
+    bitmap = (uint64_t *)(overlay + header.bitmapOffset);
+    sectorData = overlay + header.dataOffset;
+    initialized = true;
+}
+
+void
+CowDiskImage::unmap()
+{
+    if (overlay)
+        munmap(overlay, overlaySize);
+    if (fd >= 0)
+        ::close(fd);
+    overlay = nullptr;
+    fd = -1;
 }
 
 void
@@ -216,6 +411,16 @@ CowDiskImage::notifyFork()
         inform("Disabling saving of COW image in forked child process.\n");
         filename = "";
     }
+
+    // keep the writes of the child out of the overlay file of the
+    // parent, the file already holds the writes so far
+    if (sharedMap) {
+        if (mmap(overlay, overlaySize, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+            panic("Could not remap the overlay of %s", name());
+        }
+        sharedMap = false;
+    }
 }
 
 void
@@ -247,8 +452,37 @@ SafeReadSwap(ifstream &stream, T &data)
     data = letoh(data); //is this the proper byte order conversion?
 }
 
+void
+SafeWrite(ofstream &stream, const void *data, int count)
+{
+    stream.write((const char *)data, count);
+    if (!stream.is_open())
+        panic("file not open");
+
+    if (stream.eof())
+        panic("premature end-of-file");
+
+    if (stream.bad() || stream.fail())
+        panic("error reading cowdisk image");
+}
+
+template<class T>
+void
+SafeWrite(ofstream &stream, const T &data)
+{
+    SafeWrite(stream, &data, sizeof(data));
+}
+
+template<class T>
+void
+SafeWriteSwap(ofstream &stream, const T &data)
+{
+    T swappeddata = letoh(data); //is this the proper byte order conversion?
+    SafeWrite(stream, &swappeddata, sizeof(data));
+}
+
 bool
-CowDiskImage::open(const string &file)
+CowDiskImage::open(const string &file, bool shared)
 {
     ifstream stream(file.c_str());
     if (!stream.is_open())
@@ -257,78 +491,71 @@ CowDiskImage::open(const string &file)
     if (stream.fail() || stream.bad())
         panic("Error opening %s", file);
 
-    uint64_t magic;
-    SafeRead(stream, magic);
+    char magic[8];
+    SafeRead(stream, magic, sizeof(magic));
+    if (memcmp(magic, legacyMagic, sizeof(magic)) == 0) {
+        openLegacy(stream, file);
+        return true;
+    }
+    stream.close();
 
-    if (memcmp(&magic, "COWDISK!", sizeof(magic)) != 0)
+    if (memcmp(magic, overlayMagic, sizeof(magic)) != 0)
         panic("Could not open %s: Invalid magic", file);
 
+    int new_fd = ::open(file.c_str(), shared ? O_RDWR : O_RDONLY);
+    OverlayHeader header;
+    if (new_fd < 0 ||
+        pread(new_fd, &header, sizeof(header), 0) != sizeof(header)) {
+        panic("Error opening %s", file);
+    }
+
+    const OverlayHeader expected = layout();
+    if (header.version != VersionMajor || header.sectorSize != SectorSize)
+        panic("Could not open %s: invalid version %d != %d",
+              file, header.version, VersionMajor);
+    if (header.sectors != expected.sectors ||
+        header.bitmapOffset != expected.bitmapOffset ||
+        header.dataOffset != expected.dataOffset) {
+        panic("Could not open %s: it has %d sectors, the child has %d",
+              file, header.sectors, sectors);
+    }
+
+    map(new_fd, shared);
+    return true;
+}
+
+void
+CowDiskImage::openLegacy(ifstream &stream, const string &file)
+{
     uint32_t major, minor;
     SafeReadSwap(stream, major);
     SafeReadSwap(stream, minor);
 
-    if (major != VersionMajor && minor != VersionMinor)
+    if (major != 1 || minor != 0)
         panic("Could not open %s: invalid version %d.%d != %d.%d",
-              file, major, minor, VersionMajor, VersionMinor);
+              file, major, minor, 1, 0);
+
+    // the sectors are copied to an anonymous overlay, from which the
+    // file is saved in the current format
+    map(-1, false);
 
     uint64_t sector_count;
     SafeReadSwap(stream, sector_count);
-    table = new SectorTable(sector_count);
-
 
     for (uint64_t i = 0; i < sector_count; i++) {
         uint64_t offset;
         SafeReadSwap(stream, offset);
+        if (offset >= sectors)
+            panic("Could not open %s: sector %d is out of bounds",
+                  file, offset);
 
-        Sector *sector = new Sector;
-        SafeRead(stream, sector, sizeof(Sector));
-
-        assert(table->find(offset) == table->end());
-        (*table)[offset] = sector;
+        SafeRead(stream, sectorData + offset * SectorSize, SectorSize);
+        bitmap[offset / 64] |= ULL(1) << (offset % 64);
     }
 
     stream.close();
-
-    initialized = true;
-    return true;
-}
-
-void
-CowDiskImage::initSectorTable(int hash_size)
-{
-    table = new SectorTable(hash_size);
-
-    initialized = true;
-}
-
-void
-SafeWrite(ofstream &stream, const void *data, int count)
-{
-    stream.write((const char *)data, count);
-    if (!stream.is_open())
-        panic("file not open");
-
-    if (stream.eof())
-        panic("premature end-of-file");
-
-    if (stream.bad() || stream.fail())
-        panic("error reading cowdisk image");
 }
 
-template<class T>
-void
-SafeWrite(ofstream &stream, const T &data)
-{
-    SafeWrite(stream, &data, sizeof(data));
-}
-
-template<class T>
-void
-SafeWriteSwap(ofstream &stream, const T &data)
-{
-    T swappeddata = letoh(data); //is this the proper byte order conversion?
-    SafeWrite(stream, &swappeddata, sizeof(data));
-}
 void
 CowDiskImage::save() const
 {
@@ -337,51 +564,73 @@ CowDiskImage::save() const
     // called because there is no easy way to unregister the exit
     // callback.
     if (!filename.empty())
-        save(filename);}
+        save(filename);
+}
 
 void
 CowDiskImage::save(const string &file) const
 {
     if (!initialized)
-        panic("RawDiskImage not initialized");
-
-    ofstream stream(file.c_str());
-    if (!stream.is_open() || stream.fail() || stream.bad())
-        panic("Error opening %s", file);
-
-    uint64_t magic;
-    memcpy(&magic, "COWDISK!", sizeof(magic));
-    SafeWrite(stream, magic);
+        panic("CowDiskImage not initialized");
 
-    SafeWriteSwap(stream, (uint32_t)VersionMajor);
-    SafeWriteSwap(stream, (uint32_t)VersionMinor);
-    SafeWriteSwap(stream, (uint64_t)table->size());
+    // the writes are already in the file
+    if (sharedMap && file == filename) {
+        if (msync(overlay, overlaySize, MS_SYNC) != 0)
+            panic("Error saving %s", file);
+        return;
+    }
 
-    uint64_t size = table->size();
-    SectorTable::iterator iter = table->begin();
-    SectorTable::iterator end = table->end();
+    int out = ::open(file.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out < 0)
+        panic("Error opening %s", file);
 
-    for (uint64_t i = 0; i < size; i++) {
-        if (iter == end)
-            panic("Incorrect Table Size during save of COW disk image");
+    const OverlayHeader header = layout();
+    if (ftruncate(out, overlaySize) != 0)
+        panic("Error saving %s", file);
+
+    // only the chunks holding sectors are written, the rest of the
+    // file is left as holes
+    auto put = [&](const void *data, uint64_t len, uint64_t offset) {
+        if (pwrite(out, data, len, offset) != (ssize_t)len)
+            panic("Error saving %s", file);
+    };
+
+    const uint64_t words = ChunkSectors / 64;
+    const uint64_t chunk_size = ChunkSectors * SectorSize;
+    const uint64_t chunks = divCeil(sectors, ChunkSectors);
+    put(&header, sizeof(header), 0);
+    for (uint64_t c = 0; c < chunks; ++c) {
+        const uint64_t *chunk_bits = bitmap + c * words;
+        if (all_of(chunk_bits, chunk_bits + words,
+                   [](uint64_t w) { return w == 0; })) {
+            continue;
+        }
 
-        SafeWriteSwap(stream, (uint64_t)(*iter).first);
-        SafeWrite(stream, (*iter).second->data, sizeof(Sector));
-        ++iter;
+        put(chunk_bits, words * sizeof(uint64_t),
+            header.bitmapOffset + c * words * sizeof(uint64_t));
+        put(sectorData + c * chunk_size,
+            min(chunk_size, (sectors - c * ChunkSectors) * SectorSize),
+            header.dataOffset + c * chunk_size);
     }
 
-    stream.close();
+    if (::close(out) != 0)
+        panic("Error saving %s", file);
 }
 
 void
 CowDiskImage::writeback()
 {
-    SectorTable::iterator i = table->begin();
-    SectorTable::iterator end = table->end();
-
-    while (i != end) {
-        child->write((*i).second->data, (*i).first);
-        ++i;
+    // write the runs of sectors in the overlay to the child
+    uint64_t run = 0;
+    for (uint64_t s = 0; s <= sectors; ++s) {
+        if (s < sectors && holds(s))
+            continue;
+
+        if (s > run) {
+            child->writeSectors(sectorData + run * SectorSize, run,
+                                s - run);
+        }
+        run = s + 1;
     }
 }
 
@@ -391,51 +640,86 @@ CowDiskImage::size() const
 
 std::streampos
 CowDiskImage::read(uint8_t *data, std::streampos offset) const
+{
+    return readSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::readSectors(uint8_t *data, std::streampos offset,
+                          unsigned count) const
 {
     if (!initialized)
         panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t first = offset;
+    if (first + count > sectors)
         panic("access out of bounds");
 
-    SectorTable::const_iterator i = table->find(offset);
-    if (i == table->end())
-        return child->read(data, offset);
-    else {
-        memcpy(data, (*i).second->data, SectorSize);
-        DPRINTF(DiskImageRead, "read: offset=%d\n", (uint64_t)offset);
-        DDUMP(DiskImageRead, data, SectorSize);
-        return SectorSize;
+    // the sectors that were never written are read from the child, a
+    // run of them at a time, and the others from the overlay
+    uint64_t done = 0;
+    unsigned run = 0;
+    for (unsigned i = 0; i <= count; ++i) {
+        const bool in_child = i < count && !holds(first + i);
+        if (i < count && in_child == !holds(first + run))
+            continue;
+
+        if (i > run) {
+            const uint64_t len = (i - run) * SectorSize;
+            if (holds(first + run)) {
+                memcpy(data + run * SectorSize,
+                       sectorData + (first + run) * SectorSize, len);
+                done += len;
+            } else {
+                const uint64_t ret =
+                    child->readSectors(data + run * SectorSize,
+                                       first + run, i - run);
+                done += ret;
+                if (ret != len)
+                    return done;
+            }
+        }
+        run = i;
     }
+
+    DPRINTF(DiskImageRead, "read: offset=%d count=%d\n", first, count);
+    DDUMP(DiskImageRead, data, done);
+
+    return done;
 }
 
 std::streampos
 CowDiskImage::write(const uint8_t *data, std::streampos offset)
+{
+    return writeSectors(data, offset, 1);
+}
+
+std::streampos
+CowDiskImage::writeSectors(const uint8_t *data, std::streampos offset,
+                           unsigned count)
 {
     if (!initialized)
-        panic("RawDiskImage not initialized");
+        panic("CowDiskImage not initialized");
 
-    if (offset > size())
+    const uint64_t first = offset;
+    if (first + count > sectors)
         panic("access out of bounds");
 
-    SectorTable::iterator i = table->find(offset);
-    if (i == table->end()) {
-        Sector *sector = new Sector;
-        memcpy(sector, data, SectorSize);
-        table->insert(make_pair(offset, sector));
-    } else {
-        memcpy((*i).second->data, data, SectorSize);
-    }
+    memcpy(sectorData + first * SectorSize, data, count * SectorSize);
+    for (uint64_t s = first; s < first + count; ++s)
+        bitmap[s / 64] |= ULL(1) << (s % 64);
 
-    DPRINTF(DiskImageWrite, "write: offset=%d\n", (uint64_t)offset);
-    DDUMP(DiskImageWrite, data, SectorSize);
+    DPRINTF(DiskImageWrite, "write: offset=%d count=%d\n", first, count);
+    DDUMP(DiskImageWrite, data, count * SectorSize);
 
-    return SectorSize;
+    return count * SectorSize;
 }
 
 void
 CowDiskImage::serialize(CheckpointOut &cp) const
 {
+    // the checkpoint refers to a copy of the overlay, which only
+    // holds the chunks that were written
     string cowFilename = name() + ".cow";
     SERIALIZE_SCALAR(cowFilename);
     save(CheckpointIn::dir() + "/" + cowFilename);
@@ -447,7 +731,10 @@ CowDiskImage::unserialize(CheckpointIn &cp)
     string cowFilename;
     UNSERIALIZE_SCALAR(cowFilename);
     cowFilename = cp.cptDir + "/" + cowFilename;
-    open(cowFilename);
+    // map the overlay of the checkpoint copy-on-write, which leaves
+    // it untouched for the other runs restoring it
+    if (!open(cowFilename))
+        fatal("Could not open COW image %s", cowFilename);
 }
 
 CowDiskImage *
@@ -36,8 +36,8 @@
 #define __DEV_STORAGE_DISK_IMAGE_HH__
 
 #include <fstream>
-#include <unordered_map>
 
+#include "base/types.hh"
 #include "params/CowDiskImage.hh"
 #include "params/DiskImage.hh"
 #include "params/RawDiskImage.hh"
@@ -64,6 +64,30 @@ class DiskImage : public SimObject
                                 std::streampos offset) const = 0;
     virtual std::streampos write(const uint8_t *data,
                                  std::streampos offset) = 0;
+
+    /**
+     * Read a range of consecutive sectors, which images override to
+     * do it in one go rather than a sector at a time.
+     *
+     * @param data Buffer of count sectors
+     * @param offset First sector to read
+     * @param count Number of sectors to read
+     * @return The number of bytes read
+     */
+    virtual std::streampos readSectors(uint8_t *data, std::streampos offset,
+                                       unsigned count) const;
+
+    /**
+     * Write a range of consecutive sectors.
+     *
+     * @param data Buffer of count sectors
+     * @param offset First sector to write
+     * @param count Number of sectors to write
+     * @return The number of bytes written
+     */
+    virtual std::streampos writeSectors(const uint8_t *data,
+                                        std::streampos offset,
+                                        unsigned count);
 };
 
 /**
@@ -72,11 +96,26 @@ class DiskImage : public SimObject
 class RawDiskImage : public DiskImage
 {
   protected:
-    mutable std::fstream stream;
+    int fd;
     std::string file;
     bool readonly;
+    // Bypass the host page cache, until the host refuses to
+    mutable bool directIO;
+    // Bytes read ahead of sequential reads
+    const uint64_t readahead;
+    // Byte following the last read, to tell sequential reads
+    mutable uint64_t nextRead;
     mutable std::streampos disk_size;
 
+    /**
+     * Read or write a range of bytes of the image, going through a
+     * suitably aligned buffer for direct I/O.
+     *
+     * @return The number of bytes transferred
+     */
+    uint64_t transfer(bool is_write, uint8_t *data, uint64_t len,
+                      uint64_t pos) const;
+
   public:
     typedef RawDiskImageParams Params;
     RawDiskImage(const Params *p);
@@ -91,6 +130,11 @@ class RawDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 /**
@@ -102,6 +146,13 @@ class RawDiskImage : public DiskImage
  * This object is designed to provide a mechanism for persistant
  * changes to a main disk image, or to provide a place for temporary
  * changes to the image to take place that later may be thrown away.
+ *
+ * The written sectors live in an overlay as large as the child, with
+ * a bitmap of the sectors it holds, which is mapped from a sparse
+ * overlay file or from anonymous memory, so that only the chunks
+ * that are written take up space. Overlay files are saved and
+ * checkpointed a chunk at a time, and restored by mapping them
+ * copy-on-write, so runs restoring the same checkpoint share them.
  */
 class CowDiskImage : public DiskImage
 {
@@ -109,16 +160,55 @@ class CowDiskImage : public DiskImage
     static const uint32_t VersionMajor;
     static const uint32_t VersionMinor;
 
+    /** Sectors of the chunks the overlay is saved in */
+    static const uint64_t ChunkSectors = 128;
+
   protected:
-    struct Sector {
-        uint8_t data[SectorSize];
+    struct OverlayHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t sectorSize;
+        uint64_t sectors;
+        // Offsets of the sector bitmap and of the sectors
+        uint64_t bitmapOffset;
+        uint64_t dataOffset;
     };
-    typedef std::unordered_map<uint64_t, Sector *> SectorTable;
 
-  protected:
     std::string filename;
     DiskImage *child;
-    SectorTable *table;
+
+    // The overlay file, -1 if the overlay is anonymous memory
+    int fd;
+    // Whether writes go to the overlay file
+    bool sharedMap;
+    uint8_t *overlay;
+    uint64_t overlaySize;
+
+    uint64_t sectors;
+    // The bitmap of the sectors in the overlay, two words a chunk
+    uint64_t *bitmap;
+    uint8_t *sectorData;
+
+    bool
+    holds(uint64_t sector) const
+    {
+        return bitmap[sector / 64] & (ULL(1) << (sector % 64));
+    }
+
+    /** Layout of an overlay of the size of the child. */
+    OverlayHeader layout() const;
+
+    /**
+     * Map an overlay file, or anonymous memory if fd is -1.
+     *
+     * @param shared Whether writes go to the file
+     */
+    void map(int fd, bool shared);
+    void unmap();
+
+    /** Read a file in the format of the sector tables of old. */
+    void openLegacy(std::ifstream &stream, const std::string &file);
 
   public:
     typedef CowDiskImageParams Params;
@@ -127,8 +217,13 @@ class CowDiskImage : public DiskImage
 
     void notifyFork() override;
 
-    void initSectorTable(int hash_size);
-    bool open(const std::string &file);
+    /**
+     * Open an overlay file, which is mapped copy-on-write unless
+     * shared is set.
+     *
+     * @return false if there is no such file
+     */
+    bool open(const std::string &file, bool shared = false);
     void save() const;
     void save(const std::string &file) const;
     void writeback();
@@ -140,6 +235,11 @@ class CowDiskImage : public DiskImage
 
     std::streampos read(uint8_t *data, std::streampos offset) const override;
     std::streampos write(const uint8_t *data, std::streampos offset) override;
+
+    std::streampos readSectors(uint8_t *data, std::streampos offset,
+                               unsigned count) const override;
+    std::streampos writeSectors(const uint8_t *data, std::streampos offset,
+                                unsigned count) override;
 };
 
 void SafeRead(std::ifstream &stream, void *data, int count);
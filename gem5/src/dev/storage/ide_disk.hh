@@ -329,9 +329,9 @@ class IdeDisk : public SimObject
     void dmaWriteDone();
     EventFunctionWrapper dmaWriteEvent;
 
-    // Disk image read/write
-    void readDisk(uint32_t sector, uint8_t *data);
-    void writeDisk(uint32_t sector, uint8_t *data);
+    // Disk image read/write, of count consecutive sectors
+    void readDisk(uint32_t sector, uint8_t *data, uint32_t count = 1);
+    void writeDisk(uint32_t sector, uint8_t *data, uint32_t count = 1);
 
     // State machine management
     void updateState(DevAction_t action);
@@ -0,0 +1,53 @@
+# -*- mode:python -*-
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.objects.Ethernet import EtherInt
+from m5.objects.VirtIO import VirtIODeviceBase
+
+class VirtIONet(VirtIODeviceBase):
+    type = 'VirtIONet'
+    cxx_header = 'dev/virtio/net.hh'
+
+    interface = EtherInt("Ethernet Interface")
+
+    hardware_address = Param.EthernetAddr(NextEthernetAddr,
+        "Ethernet Hardware Address")
+    rx_filter = Param.Bool(True,
+        "Drop received unicast packets addressed to other devices")
+
+    queue_pairs = Param.Unsigned(1, "Number of receive/transmit queue pairs")
+    queue_size = Param.Unsigned(256, "Receive/transmit queue size "
+                                "(descriptors)")
+    ctrl_queue_size = Param.Unsigned(64, "Control queue size (descriptors)")
+
+    fifo_size = Param.Unsigned(256, "Packets buffered per receive queue and "
+                               "for transmission")
+    intr_delay = Param.Latency('0ns', "Time to coalesce interrupts over, "
+                               "0 to interrupt after every batch")
@@ -46,7 +46,7 @@
 VirtDescriptor::VirtDescriptor(PortProxy &_memProxy, VirtQueue &_queue,
                                Index descIndex)
     : memProxy(&_memProxy), queue(&_queue), _index(descIndex),
-      desc{0, 0, 0, 0}
+      desc{0, 0, 0, 0}, table(nullptr)
 {
 }
 
@@ -66,6 +66,10 @@ VirtDescriptor::operator=(VirtDescriptor &&rhs) noexcept
     queue = std::move(rhs.queue);
     _index = std::move(rhs._index);
     desc = std::move(rhs.desc);
+    // Indirect tables refer to themselves and are repopulated with
+    // the chain anyway.
+    table = nullptr;
+    indirect.clear();
 
     return *this;
 }
@@ -73,6 +77,8 @@ VirtDescriptor::operator=(VirtDescriptor &&rhs) noexcept
 void
 VirtDescriptor::update()
 {
+    table = nullptr;
+
     const Addr vq_addr(queue->getAddress());
     // Check if the queue has been initialized yet
     if (vq_addr == 0)
@@ -92,15 +98,62 @@ VirtDescriptor::update()
 void
 VirtDescriptor::updateChain()
 {
+    update();
+    if (desc.flags & VRING_DESC_F_INDIRECT) {
+        updateIndirect();
+        return;
+    }
+
     VirtDescriptor *desc(this);
-    do {
+    while ((desc = desc->next()) != NULL && desc != this)
         desc->update();
-    } while ((desc = desc->next()) != NULL && desc != this);
 
     if (desc == this)
         panic("Loop in descriptor chain!\n");
 }
 
+void
+VirtDescriptor::updateIndirect()
+{
+    const size_t count(desc.len / sizeof(vring_desc));
+    if (desc.flags & VRING_DESC_F_NEXT || count == 0 ||
+        desc.len % sizeof(vring_desc)) {
+        panic("Invalid indirect descriptor (len: %i, flags: 0x%x)\n",
+              desc.len, desc.flags);
+    }
+
+    // Fetch the whole table with a single access
+    vring_desc guest_table[count];
+    memProxy->readBlob(desc.addr, guest_table, desc.len);
+
+    indirect.clear();
+    indirect.reserve(count);
+    for (Index i = 0; i < count; ++i) {
+        indirect.emplace_back(*memProxy, *queue, i);
+        indirect.back().desc = vtoh_legacy(guest_table[i]);
+        indirect.back().table = &indirect;
+        DPRINTF(VIO,
+                "VirtDescriptor(%i.%i): Addr: 0x%x, Len: %i, Flags: 0x%x, "
+                "Next: 0x%x\n",
+                _index, i, indirect.back().desc.addr,
+                indirect.back().desc.len, indirect.back().desc.flags,
+                indirect.back().desc.next);
+    }
+
+    // Stand in for the first element of the table, the chain then
+    // continues in the table.
+    desc = indirect[0].desc;
+    table = &indirect;
+
+    size_t length(1);
+    for (const VirtDescriptor *d = next(); d; d = d->next()) {
+        if (++length > count)
+            panic("Loop in indirect descriptor chain!\n");
+        if (d->desc.flags & VRING_DESC_F_INDIRECT)
+            panic("Nested indirect descriptor table!\n");
+    }
+}
+
 void
 VirtDescriptor::dump() const
 {
@@ -133,10 +186,15 @@ VirtDescriptor::dumpChain() const
 VirtDescriptor *
 VirtDescriptor::next() const
 {
-    if (hasNext()) {
-        return queue->getDescriptor(desc.next);
-    } else {
+    if (!hasNext()) {
         return NULL;
+    } else if (table) {
+        if (desc.next >= table->size())
+            panic("Indirect descriptor refers to entry %i of %i\n",
+                  desc.next, table->size());
+        return &(*table)[desc.next];
+    } else {
+        return queue->getDescriptor(desc.next);
     }
 }
 
@@ -227,7 +285,8 @@ VirtDescriptor::chainSize() const
 VirtQueue::VirtQueue(PortProxy &proxy, uint16_t size)
     : _size(size), _address(0), memProxy(proxy),
       avail(proxy, size), used(proxy, size),
-      _last_avail(0)
+      _last_avail(0), _avail_cached(0),
+      _used_valid(false), _used_signalled(0), eventIdx(false)
 {
     descriptors.reserve(_size);
     for (int i = 0; i < _size; ++i)
@@ -265,19 +324,40 @@ VirtQueue::setAddress(Addr address)
     _address = address;
     avail.setAddress(addr_avail);
     used.setAddress(addr_used);
+
+    // Nothing is known about the new rings yet
+    _avail_cached = _last_avail;
+    _used_valid = false;
 }
 
 VirtDescriptor *
 VirtQueue::consumeDescriptor()
 {
-    avail.read();
-    DPRINTF(VIO, "consumeDescriptor: _last_avail: %i, avail.idx: %i (->%i)\n",
-            _last_avail, avail.header.index,
-            avail.ring[_last_avail % used.ring.size()]);
-    if (_last_avail == avail.header.index)
-        return NULL;
+    if (_last_avail == _avail_cached) {
+        // Fetch all the elements the guest has made available since
+        // the last time with a single access.
+        avail.readHeader();
+        DPRINTF(VIO, "consumeDescriptor: _last_avail: %i, avail.idx: %i\n",
+                _last_avail, avail.header.index);
+        if (_last_avail == avail.header.index) {
+            // Ask to be notified as soon as more descriptors arrive
+            if (eventIdx) {
+                const uint16_t event(htov_legacy(_last_avail));
+                memProxy.writeBlob(used.eventAddr(), &event, sizeof(event));
+            }
+            return NULL;
+        }
 
-    VirtDescriptor::Index index(avail.ring[_last_avail % used.ring.size()]);
+        const uint16_t pending(avail.header.index - _last_avail);
+        if (pending > avail.ring.size())
+            panic("Guest made %i descriptors available in a queue of %i\n",
+                  pending, avail.ring.size());
+        avail.readEntries(_last_avail % avail.ring.size(), pending);
+        _avail_cached = avail.header.index;
+    }
+
+    VirtDescriptor::Index index(avail.ring[_last_avail % avail.ring.size()]);
+    DPRINTF(VIO, "consumeDescriptor: ->%i\n", index);
     ++_last_avail;
 
     VirtDescriptor *d(&descriptors[index]);
@@ -289,15 +369,49 @@ VirtQueue::consumeDescriptor()
 void
 VirtQueue::produceDescriptor(VirtDescriptor *desc, uint32_t len)
 {
-    used.readHeader();
+    // The device is the only writer of the used ring, so its header
+    // only needs to be read once.
+    if (!_used_valid) {
+        used.readHeader();
+        _used_signalled = used.header.index;
+        _used_valid = true;
+    }
     DPRINTF(VIO, "produceDescriptor: dscIdx: %i, len: %i, used.idx: %i\n",
             desc->index(), len, used.header.index);
 
-    struct vring_used_elem &e(used.ring[used.header.index % used.ring.size()]);
+    const uint16_t slot(used.header.index % used.ring.size());
+    struct vring_used_elem &e(used.ring[slot]);
     e.id = desc->index();
     e.len = len;
     used.header.index += 1;
-    used.write();
+
+    // The element has to be visible to the guest before the index
+    // that publishes it.
+    used.writeEntry(slot);
+    used.writeHeader();
+}
+
+bool
+VirtQueue::wantsInterrupt()
+{
+    if (!hasProduced())
+        return false;
+
+    const uint16_t old_idx(_used_signalled);
+    const uint16_t new_idx(used.header.index);
+    _used_signalled = new_idx;
+
+    if (eventIdx) {
+        // Interrupt if the index the guest asked for has been passed
+        uint16_t event;
+        memProxy.readBlob(avail.eventAddr(), &event, sizeof(event));
+        event = vtoh_legacy(event);
+        return (uint16_t)(new_idx - event - 1) <
+            (uint16_t)(new_idx - old_idx);
+    } else {
+        avail.readHeader();
+        return !(avail.header.flags & VRING_AVAIL_F_NO_INTERRUPT);
+    }
 }
 
 void
@@ -326,7 +440,8 @@ VirtIODeviceBase::VirtIODeviceBase(Params *params, DeviceId id,
                                    size_t config_size, FeatureBits features)
     : SimObject(params),
       guestFeatures(0),
-      deviceId(id), configSize(config_size), deviceFeatures(features),
+      deviceId(id), configSize(config_size),
+      deviceFeatures(features | F_INDIRECT_DESC | F_EVENT_IDX),
       _deviceStatus(0), _queueSelect(0),
       transKick(NULL)
 {
@@ -355,6 +470,7 @@ VirtIODeviceBase::unserialize(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(_queueSelect);
     for (QueueID i = 0; i < _queues.size(); ++i)
         _queues[i]->unserializeSection(cp, csprintf("_queues.%i", i));
+    updateQueueFeatures();
 }
 
 void
@@ -366,6 +482,7 @@ VirtIODeviceBase::reset()
 
     for (QueueID i = 0; i < _queues.size(); ++i)
         _queues[i]->setAddress(0);
+    updateQueueFeatures();
 }
 
 void
@@ -391,6 +508,32 @@ VirtIODeviceBase::setGuestFeatures(FeatureBits features)
               deviceFeatures, features);
     }
     guestFeatures = features;
+    updateQueueFeatures();
+}
+
+void
+VirtIODeviceBase::updateQueueFeatures()
+{
+    for (auto q : _queues)
+        q->setEventIdx(guestFeatures & F_EVENT_IDX);
+}
+
+bool
+VirtIODeviceBase::wantsInterrupt()
+{
+    bool produced(false);
+    for (auto q : _queues)
+        produced = produced || q->hasProduced();
+
+    // Always deliver interrupts that aren't caused by the queues
+    if (!produced)
+        return true;
+
+    bool wanted(false);
+    for (auto q : _queues)
+        wanted = q->wantsInterrupt() || wanted;
+
+    return wanted;
 }
 
 
@@ -40,6 +40,9 @@
 #ifndef __DEV_VIRTIO_BASE_HH__
 #define __DEV_VIRTIO_BASE_HH__
 
+#include <algorithm>
+#include <vector>
+
 #include "arch/isa_traits.hh"
 #include "base/bitunion.hh"
 #include "base/callback.hh"
@@ -164,7 +167,14 @@ class VirtDescriptor
     /** Populate this descriptor with data from the guest. */
     void update();
 
-    /** Populate this descriptor chain with data from the guest. */
+    /**
+     * Populate this descriptor chain with data from the guest.
+     *
+     * If the descriptor refers to an indirect descriptor table, the
+     * whole table is read at once and this descriptor takes the
+     * place of its first element. Device models can then follow the
+     * chain as if it was stored in the queue.
+     */
     void updateChain();
     /** @} */
 
@@ -239,6 +249,9 @@ class VirtDescriptor
     /**
      * Get the pointer to the next descriptor in a chain.
      *
+     * @note The next descriptor of the head of an indirect chain is
+     * an element of its indirect table rather than of the queue.
+     *
      * @return Pointer to the next descriptor or NULL if this is the
      * last element in a chain.
      */
@@ -293,6 +306,9 @@ class VirtDescriptor
     // Prevent copying
     VirtDescriptor(const VirtDescriptor &other);
 
+    /** Read the indirect table this descriptor refers to. */
+    void updateIndirect();
+
     /** Pointer to memory proxy */
     PortProxy *memProxy;
     /** Pointer to virtqueue owning this descriptor */
@@ -303,6 +319,14 @@ class VirtDescriptor
 
     /** Underlying descriptor */
     vring_desc desc;
+
+    /**
+     * Descriptor table the next pointer refers to, NULL if it refers
+     * to the virtqueue.
+     */
+    std::vector<VirtDescriptor> *table;
+    /** Indirect descriptors of a chain starting at this descriptor */
+    std::vector<VirtDescriptor> indirect;
 };
 
 /**
@@ -392,6 +416,36 @@ public:
     void produceDescriptor(VirtDescriptor *desc, uint32_t len);
     /** @} */
 
+    /** @{
+     * @name Notification Suppression
+     */
+    /**
+     * Enable the event index feature (VIRTIO_RING_F_EVENT_IDX).
+     *
+     * With event indices, the guest tells the device which used
+     * descriptor it wants to be interrupted for and the device tells
+     * the guest which available descriptor it wants to be notified
+     * about.
+     */
+    void setEventIdx(bool enable) { eventIdx = enable; }
+
+    /**
+     * Check if descriptors have been produced since the last call to
+     * wantsInterrupt().
+     */
+    bool hasProduced() const {
+        return _used_valid && _used_signalled != used.header.index;
+    }
+
+    /**
+     * Check if the guest wants an interrupt for the descriptors
+     * produced since the last call.
+     *
+     * @return true if the guest should be interrupted.
+     */
+    bool wantsInterrupt();
+    /** @} */
+
     /** @{
      * @name Device Model Callbacks
      */
@@ -505,6 +559,65 @@ public:
             _proxy.writeBlob(_base, &out, sizeof(out));
         }
 
+        /**
+         * Update a single element of the ring with data from the
+         * guest.
+         *
+         * @param idx Offset of the element in the ring.
+         */
+        void readEntry(Index idx) {
+            assert(_base != 0);
+            T temp;
+            _proxy.readBlob(_base + sizeof(header) + idx * sizeof(T),
+                            &temp, sizeof(T));
+            ring[idx] = vtoh_legacy(temp);
+        }
+
+        /**
+         * Write a single element of the ring to guest memory.
+         *
+         * @param idx Offset of the element in the ring.
+         */
+        void writeEntry(Index idx) {
+            assert(_base != 0);
+            const T temp(htov_legacy(ring[idx]));
+            _proxy.writeBlob(_base + sizeof(header) + idx * sizeof(T),
+                             &temp, sizeof(T));
+        }
+
+        /**
+         * Update a range of the ring with data from the guest.
+         *
+         * @param first Offset of the first element.
+         * @param count Number of elements, the range may wrap.
+         */
+        void readEntries(Index first, Index count) {
+            assert(_base != 0);
+            const Index size(ring.size());
+            while (count) {
+                const Index chunk(std::min<Index>(count, size - first));
+                T temp[chunk];
+                _proxy.readBlob(_base + sizeof(header) + first * sizeof(T),
+                                temp, sizeof(T) * chunk);
+                for (Index i = 0; i < chunk; ++i)
+                    ring[first + i] = vtoh_legacy(temp[i]);
+                first = (first + chunk) % size;
+                count -= chunk;
+            }
+        }
+
+        /**
+         * Get the address of the event index following the ring.
+         *
+         * The avail ring is followed by the index of the used ring
+         * the guest wants to be interrupted for, and the used ring by
+         * the index of the avail ring the device wants to be notified
+         * for.
+         */
+        Addr eventAddr() const {
+            return _base + sizeof(header) + ring.size() * sizeof(T);
+        }
+
         void read() {
             readHeader();
 
@@ -552,6 +665,20 @@ public:
      * ring */
     uint16_t _last_avail;
 
+    /** Offset of the last element of the avail ring read from the
+     * guest. The elements in [_last_avail, _avail_cached) are valid
+     * in avail.ring. */
+    uint16_t _avail_cached;
+
+    /** Is the index in the used ring header in sync with the guest? */
+    bool _used_valid;
+    /** Used ring index when the guest was last considered for an
+     * interrupt */
+    uint16_t _used_signalled;
+
+    /** Event index feature enabled */
+    bool eventIdx;
+
     /** Vector of pre-created descriptors indexed by their index into
      * the queue. */
     std::vector<VirtDescriptor> descriptors;
@@ -572,6 +699,16 @@ class VirtIODeviceBase : public SimObject
   public:
     typedef uint16_t QueueID;
     typedef uint32_t FeatureBits;
+
+    /** @{
+     * @name Feature bits common to all devices
+     */
+    /** Support indirect descriptor tables */
+    static const FeatureBits F_INDIRECT_DESC =
+        (1 << VIRTIO_RING_F_INDIRECT_DESC);
+    /** Support notification suppression through event indices */
+    static const FeatureBits F_EVENT_IDX = (1 << VIRTIO_RING_F_EVENT_IDX);
+    /** @} */
     /** This is a VirtQueue address as exposed through the low-level
      * interface.\ The address needs to be multiplied by the page size
      * (seems to be hardcoded to 4096 in the spec) to get the real
@@ -619,7 +756,8 @@ class VirtIODeviceBase : public SimObject
      */
     void kick() {
         assert(transKick);
-        transKick->process();
+        if (wantsInterrupt())
+            transKick->process();
     };
 
     /**
@@ -854,6 +992,15 @@ class VirtIODeviceBase : public SimObject
     /** @} */
 
   private:
+    /**
+     * Check if the guest wants to be interrupted for the descriptors
+     * produced since the last kick.
+     */
+    bool wantsInterrupt();
+
+    /** Tell the queues which notification features are in use */
+    void updateQueueFeatures();
+
     /** Convenience method to get the currently selected queue */
     const VirtQueue &getCurrentQueue() const;
     /** Convenience method to get the currently selected queue */
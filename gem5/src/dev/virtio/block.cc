@@ -80,12 +80,12 @@ VirtIOBlock::read(const BlkRequest &req, VirtDescriptor *desc_chain,
     if (size % SectorSize != 0)
         panic("Unexpected request/sector size relationship\n");
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.read(&data[offset], sector) != SectorSize) {
-            warn("Failed to read sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    const size_t done = image.readSectors(&data[0], sector,
+                                          size / SectorSize);
+    if (done != size) {
+        warn("Failed to read sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     desc_chain->chainWrite(off_data, &data[0], size);
@@ -109,12 +109,12 @@ VirtIOBlock::write(const BlkRequest &req, VirtDescriptor *desc_chain,
 
     desc_chain->chainRead(off_data, &data[0], size);
 
-    for (Addr offset = 0; offset < size; offset += SectorSize) {
-        if (image.write(&data[offset], sector) != SectorSize) {
-            warn("Failed to write sector %i\n", sector);
-            return S_IOERR;
-        }
-        ++sector;
+    const size_t done = image.writeSectors(&data[0], sector,
+                                           size / SectorSize);
+    if (done != size) {
+        warn("Failed to write sectors %i-%i\n", sector,
+             sector + size / SectorSize - 1);
+        return S_IOERR;
     }
 
     return S_OK;
@@ -0,0 +1,450 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "dev/virtio/net.hh"
+
+#include <algorithm>
+#include <cstring>
+
+#include "base/cprintf.hh"
+#include "debug/VIONet.hh"
+#include "params/VirtIONet.hh"
+#include "sim/system.hh"
+
+namespace {
+
+void
+serializeFifo(const std::string &base, const std::deque<EthPacketPtr> &fifo,
+              CheckpointOut &cp)
+{
+    const unsigned size = fifo.size();
+    paramOut(cp, base + ".size", size);
+    for (unsigned i = 0; i < size; ++i)
+        fifo[i]->serialize(csprintf("%s.pkt%i", base, i), cp);
+}
+
+void
+unserializeFifo(const std::string &base, std::deque<EthPacketPtr> &fifo,
+                CheckpointIn &cp)
+{
+    unsigned size;
+    paramIn(cp, base + ".size", size);
+    fifo.clear();
+    for (unsigned i = 0; i < size; ++i) {
+        EthPacketPtr pkt = std::make_shared<EthPacketData>();
+        pkt->unserialize(csprintf("%s.pkt%i", base, i), cp);
+        fifo.push_back(pkt);
+    }
+}
+
+} // anonymous namespace
+
+VirtIONet::VirtIONet(Params *params)
+    : VirtIODeviceBase(params, ID_NET, sizeof(Config),
+                       F_MAC | F_STATUS |
+                       (params->queue_pairs > 1 ? F_CTRL_VQ | F_MQ : 0)),
+      intrEvent([this]{ interrupt(); }, name()),
+      macAddr(params->hardware_address), rxFilter(params->rx_filter),
+      fifoSize(params->fifo_size), intrDelay(params->intr_delay),
+      maxPairs(params->queue_pairs), curPairs(1),
+      qCtrl(params->system->physProxy, params->ctrl_queue_size, *this),
+      rxFifo(params->queue_pairs), txStalled(params->queue_pairs, false),
+      interface(name() + ".int0", *this)
+{
+    if (maxPairs < 1)
+        fatal("%s: At least one queue pair is needed\n", name());
+    if (fifoSize < 1)
+        fatal("%s: The packet FIFOs need room for a packet\n", name());
+
+    for (unsigned pair = 0; pair < maxPairs; ++pair) {
+        qRx.emplace_back(new RxQueue(params->system->physProxy,
+                                     params->queue_size, *this, pair));
+        qTx.emplace_back(new TxQueue(params->system->physProxy,
+                                     params->queue_size, *this, pair));
+        registerQueue(*qRx.back());
+        registerQueue(*qTx.back());
+    }
+    // The control queue is only needed to select the number of pairs
+    if (maxPairs > 1)
+        registerQueue(qCtrl);
+
+    std::memcpy(config.mac, macAddr.bytes(), ETH_ADDR_LEN);
+    config.status = S_LINK_UP;
+    config.max_virtqueue_pairs = maxPairs;
+}
+
+VirtIONet::~VirtIONet()
+{
+}
+
+void
+VirtIONet::readConfig(PacketPtr pkt, Addr cfgOffset)
+{
+    Config cfg_out(config);
+    cfg_out.status = htov_legacy(config.status);
+    cfg_out.max_virtqueue_pairs = htov_legacy(config.max_virtqueue_pairs);
+
+    readConfigBlob(pkt, cfgOffset, (uint8_t *)&cfg_out);
+}
+
+void
+VirtIONet::reset()
+{
+    VirtIODeviceBase::reset();
+
+    curPairs = 1;
+    for (auto &fifo : rxFifo)
+        fifo.clear();
+    txFifo.clear();
+    std::fill(txStalled.begin(), txStalled.end(), false);
+
+    if (intrEvent.scheduled())
+        deschedule(intrEvent);
+}
+
+Port &
+VirtIONet::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "interface")
+        return interface;
+    return VirtIODeviceBase::getPort(if_name, idx);
+}
+
+bool
+VirtIONet::recvPacket(EthPacketPtr pkt)
+{
+    if (!getDeviceStatus().driver_ok) {
+        DPRINTF(VIONet, "Driver not ready, dropping packet\n");
+        return true;
+    }
+
+    Net::EthPtr eth(pkt);
+    if (rxFilter && eth->dst().unicast() && !(eth->dst() == macAddr)) {
+        DPRINTF(VIONet, "Filtered packet to %s\n", eth->dst());
+        return true;
+    }
+
+    const unsigned pair = rxSelect(pkt);
+    std::deque<EthPacketPtr> &fifo = rxFifo[pair];
+    if (fifo.size() >= fifoSize) {
+        DPRINTF(VIONet, "Receive FIFO %i full, dropping packet\n", pair);
+        ++droppedPackets;
+        return false;
+    }
+
+    DPRINTF(VIONet, "Received packet (len: %i) on pair %i\n",
+            pkt->length, pair);
+    fifo.push_back(pkt);
+    rxDeliver(pair);
+    return true;
+}
+
+unsigned
+VirtIONet::rxSelect(const EthPacketPtr &pkt) const
+{
+    if (curPairs == 1)
+        return 0;
+
+    Net::EthPtr eth(pkt);
+    Net::IpPtr ip(eth);
+    if (!ip)
+        return 0;
+
+    // XOR the source and destination so that both directions of a
+    // flow end up on the same pair.
+    uint32_t hash = ip->src() ^ ip->dst();
+    Net::TcpPtr tcp(ip);
+    Net::UdpPtr udp(ip);
+    if (tcp)
+        hash ^= tcp->sport() ^ tcp->dport();
+    else if (udp)
+        hash ^= udp->sport() ^ udp->dport();
+
+    hash ^= hash >> 16;
+    hash ^= hash >> 8;
+    return hash % curPairs;
+}
+
+void
+VirtIONet::rxDeliver(unsigned pair)
+{
+    RxQueue &q = *qRx[pair];
+    std::deque<EthPacketPtr> &fifo = rxFifo[pair];
+    if (!q.getAddress())
+        return;
+
+    unsigned count = 0;
+    VirtDescriptor *d;
+    while (!fifo.empty() && (d = q.consumeDescriptor())) {
+        EthPacketPtr pkt = fifo.front();
+        fifo.pop_front();
+
+        const size_t len = sizeof(NetHeader) + pkt->length;
+        if (d->chainSize() < len) {
+            warn_once("%s: Receive buffer too small for a %i byte packet\n",
+                      name(), pkt->length);
+            ++droppedPackets;
+            q.produceDescriptor(d, 0);
+        } else {
+            NetHeader hdr;
+            std::memset(&hdr, 0, sizeof(hdr));
+            d->chainWrite(0, (uint8_t *)&hdr, sizeof(hdr));
+            d->chainWrite(sizeof(hdr), pkt->data, pkt->length);
+            q.produceDescriptor(d, len);
+
+            ++rxPackets;
+            rxBytes += pkt->length;
+        }
+        ++count;
+    }
+
+    if (count) {
+        DPRINTF(VIONet, "Delivered %i packets on pair %i\n", count, pair);
+        postInterrupt();
+    }
+}
+
+void
+VirtIONet::txConsume(unsigned pair)
+{
+    TxQueue &q = *qTx[pair];
+    if (!q.getAddress())
+        return;
+
+    unsigned count = 0;
+    bool stalled;
+    do {
+        VirtDescriptor *d;
+        while (txFifo.size() < fifoSize && (d = q.consumeDescriptor())) {
+            const size_t size = d->chainSize();
+            if (size < sizeof(NetHeader)) {
+                warn_once("%s: Ignoring truncated transmit descriptor\n",
+                          name());
+            } else {
+                const unsigned len = size - sizeof(NetHeader);
+                EthPacketPtr pkt = std::make_shared<EthPacketData>(len);
+                d->chainRead(sizeof(NetHeader), pkt->data, len);
+                pkt->length = len;
+                pkt->simLength = len;
+                txFifo.push_back(pkt);
+            }
+
+            // The packet has been copied, so the buffer can be handed
+            // back to the guest right away.
+            q.produceDescriptor(d, 0);
+            ++count;
+        }
+
+        stalled = txFifo.size() >= fifoSize;
+        txTransmit();
+    } while (stalled && txFifo.size() < fifoSize);
+    txStalled[pair] = stalled;
+
+    if (count) {
+        DPRINTF(VIONet, "Consumed %i packets on pair %i\n", count, pair);
+        ++txNotifies;
+        txDescriptors += count;
+        postInterrupt();
+    }
+}
+
+void
+VirtIONet::txTransmit()
+{
+    while (!txFifo.empty()) {
+        EthPacketPtr pkt = txFifo.front();
+        if (!interface.sendPacket(pkt)) {
+            DPRINTF(VIONet, "Link busy, %i packets queued\n",
+                    txFifo.size());
+            return;
+        }
+
+        ++txPackets;
+        txBytes += pkt->length;
+        txFifo.pop_front();
+    }
+}
+
+void
+VirtIONet::txDone()
+{
+    txTransmit();
+
+    for (unsigned pair = 0; pair < maxPairs; ++pair) {
+        if (txStalled[pair] && txFifo.size() < fifoSize)
+            txConsume(pair);
+    }
+}
+
+void
+VirtIONet::postInterrupt()
+{
+    if (intrDelay == 0)
+        interrupt();
+    else if (!intrEvent.scheduled())
+        schedule(intrEvent, curTick() + intrDelay);
+}
+
+void
+VirtIONet::interrupt()
+{
+    ++interrupts;
+    kick();
+}
+
+void
+VirtIONet::CtrlQueue::onNotifyDescriptor(VirtDescriptor *desc)
+{
+    CtrlHeader hdr;
+    desc->chainRead(0, (uint8_t *)&hdr, sizeof(hdr));
+    const size_t data_size(desc->chainSize() - sizeof(CtrlHeader) -
+                           sizeof(CtrlAck));
+
+    CtrlAck ack = CTRL_ERR;
+    if (hdr.cls == CTRL_MQ && hdr.cmd == CTRL_MQ_VQ_PAIRS_SET &&
+        data_size >= sizeof(uint16_t)) {
+        uint16_t pairs;
+        desc->chainRead(sizeof(hdr), (uint8_t *)&pairs, sizeof(pairs));
+        pairs = vtoh_legacy(pairs);
+        if (pairs >= 1 && pairs <= parent.maxPairs) {
+            DPRINTF(VIONet, "Using %i queue pairs\n", pairs);
+            parent.curPairs = pairs;
+            ack = CTRL_OK;
+        }
+    } else {
+        warn("%s: Unsupported control command %i.%i\n", name(),
+             hdr.cls, hdr.cmd);
+    }
+
+    desc->chainWrite(sizeof(hdr) + data_size, &ack, sizeof(ack));
+    produceDescriptor(desc, sizeof(ack));
+    parent.kick();
+}
+
+DrainState
+VirtIONet::drain()
+{
+    // Don't keep a coalesced interrupt across a checkpoint
+    if (intrEvent.scheduled()) {
+        deschedule(intrEvent);
+        interrupt();
+    }
+
+    return DrainState::Drained;
+}
+
+void
+VirtIONet::drainResume()
+{
+    // Restart transmission of packets that were queued when the
+    // simulation was drained or checkpointed.
+    txDone();
+}
+
+void
+VirtIONet::serialize(CheckpointOut &cp) const
+{
+    VirtIODeviceBase::serialize(cp);
+
+    SERIALIZE_SCALAR(curPairs);
+    for (unsigned pair = 0; pair < maxPairs; ++pair)
+        serializeFifo(csprintf("rxFifo%i", pair), rxFifo[pair], cp);
+    serializeFifo("txFifo", txFifo, cp);
+}
+
+void
+VirtIONet::unserialize(CheckpointIn &cp)
+{
+    VirtIODeviceBase::unserialize(cp);
+
+    UNSERIALIZE_SCALAR(curPairs);
+    // Look for transmit descriptors on all queues when resuming
+    std::fill(txStalled.begin(), txStalled.end(), true);
+    for (unsigned pair = 0; pair < maxPairs; ++pair)
+        unserializeFifo(csprintf("rxFifo%i", pair), rxFifo[pair], cp);
+    unserializeFifo("txFifo", txFifo, cp);
+}
+
+void
+VirtIONet::regStats()
+{
+    VirtIODeviceBase::regStats();
+
+    txPackets
+        .name(name() + ".txPackets")
+        .desc("Number of packets transmitted")
+        ;
+
+    txBytes
+        .name(name() + ".txBytes")
+        .desc("Number of bytes transmitted")
+        ;
+
+    rxPackets
+        .name(name() + ".rxPackets")
+        .desc("Number of packets received")
+        ;
+
+    rxBytes
+        .name(name() + ".rxBytes")
+        .desc("Number of bytes received")
+        ;
+
+    droppedPackets
+        .name(name() + ".droppedPackets")
+        .desc("Number of received packets that were dropped")
+        ;
+
+    txNotifies
+        .name(name() + ".txNotifies")
+        .desc("Number of transmit notifications that found packets")
+        ;
+
+    txDescriptors
+        .name(name() + ".txDescriptors")
+        .desc("Number of transmit descriptors consumed")
+        ;
+
+    interrupts
+        .name(name() + ".interrupts")
+        .desc("Number of interrupts posted to the guest")
+        ;
+
+    txBatchSize
+        .name(name() + ".txBatchSize")
+        .desc("Average number of descriptors consumed per notification")
+        .precision(2)
+        ;
+    txBatchSize = txDescriptors / txNotifies;
+}
+
+VirtIONet *
+VirtIONetParams::create()
+{
+    return new VirtIONet(this);
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __DEV_VIRTIO_NET_HH__
+#define __DEV_VIRTIO_NET_HH__
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "base/inet.hh"
+#include "base/statistics.hh"
+#include "dev/net/etherint.hh"
+#include "dev/net/etherpkt.hh"
+#include "dev/virtio/base.hh"
+#include "sim/eventq.hh"
+
+struct VirtIONetParams;
+
+/**
+ * VirtIO network device
+ *
+ * The network device uses the following queues:
+ *  -# Receive queue 0 (from host to guest)
+ *  -# Transmit queue 0 (from guest to host)
+ *  -# ...
+ *  -# Receive queue N-1
+ *  -# Transmit queue N-1
+ *  -# Control queue
+ *
+ * The device offers N queue pairs through the multiqueue feature. The
+ * guest selects how many of them it uses through the control queue,
+ * received packets are spread over the active pairs by hashing their
+ * IP addresses and ports so that a flow always uses the same pair.
+ *
+ * Descriptors are processed in batches: a notification consumes
+ * every pending descriptor of a queue (as long as the FIFO has room)
+ * and the guest is interrupted once for the whole batch. Interrupts
+ * can additionally be coalesced over a fixed delay.
+ *
+ * Only the legacy header without mergeable receive buffers is
+ * supported, and no offloads are offered, so every packet is a
+ * complete Ethernet frame preceded by a NetHeader.
+ *
+ * @see http://docs.oasis-open.org/virtio/virtio/v1.0/virtio-v1.0.html
+ */
+class VirtIONet : public VirtIODeviceBase
+{
+  public:
+    typedef VirtIONetParams Params;
+    VirtIONet(Params *params);
+    virtual ~VirtIONet();
+
+    void readConfig(PacketPtr pkt, Addr cfgOffset) override;
+    void reset() override;
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    DrainState drain() override;
+    void drainResume() override;
+
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
+    void regStats() override;
+
+  protected:
+    static const DeviceId ID_NET = 0x01;
+
+    /**
+     * Network device configuration structure
+     *
+     * @note This needs to be changed if the supported feature set
+     * changes!
+     */
+    struct Config {
+        uint8_t mac[ETH_ADDR_LEN];
+        uint16_t status;
+        uint16_t max_virtqueue_pairs;
+    } M5_ATTR_PACKED;
+    Config config;
+
+    /** @{
+     * @name Feature bits
+     */
+    static const FeatureBits F_MAC = (1 << 5);
+    static const FeatureBits F_STATUS = (1 << 16);
+    static const FeatureBits F_CTRL_VQ = (1 << 17);
+    static const FeatureBits F_MQ = (1 << 22);
+    /** @} */
+
+    /** Link status bit in Config::status */
+    static const uint16_t S_LINK_UP = 1;
+
+    /** Legacy header preceding every packet in both directions */
+    struct NetHeader {
+        uint8_t flags;
+        uint8_t gso_type;
+        uint16_t hdr_len;
+        uint16_t gso_size;
+        uint16_t csum_start;
+        uint16_t csum_offset;
+    } M5_ATTR_PACKED;
+
+    /** @{
+     * @name Control queue commands
+     */
+    struct CtrlHeader {
+        uint8_t cls;
+        uint8_t cmd;
+    } M5_ATTR_PACKED;
+
+    typedef uint8_t CtrlAck;
+    static const CtrlAck CTRL_OK = 0;
+    static const CtrlAck CTRL_ERR = 1;
+
+    static const uint8_t CTRL_MQ = 4;
+    static const uint8_t CTRL_MQ_VQ_PAIRS_SET = 0;
+    /** @} */
+
+  protected:
+    /** Virtqueue for packets going from the host to the guest. */
+    class RxQueue : public VirtQueue
+    {
+      public:
+        RxQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent,
+                unsigned _pair)
+            : VirtQueue(proxy, size), parent(_parent), pair(_pair) {}
+
+        /** The guest has posted new buffers */
+        void onNotify() override { parent.rxDeliver(pair); }
+
+        std::string name() const {
+            return csprintf("%s.qRx%i", parent.name(), pair);
+        }
+
+      protected:
+        VirtIONet &parent;
+        const unsigned pair;
+    };
+
+    /** Virtqueue for packets going from the guest to the host. */
+    class TxQueue : public VirtQueue
+    {
+      public:
+        TxQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent,
+                unsigned _pair)
+            : VirtQueue(proxy, size), parent(_parent), pair(_pair) {}
+
+        /** The guest has posted new packets */
+        void onNotify() override { parent.txConsume(pair); }
+
+        std::string name() const {
+            return csprintf("%s.qTx%i", parent.name(), pair);
+        }
+
+      protected:
+        VirtIONet &parent;
+        const unsigned pair;
+    };
+
+    /** Virtqueue for device configuration commands. */
+    class CtrlQueue : public VirtQueue
+    {
+      public:
+        CtrlQueue(PortProxy &proxy, uint16_t size, VirtIONet &_parent)
+            : VirtQueue(proxy, size), parent(_parent) {}
+
+        void onNotifyDescriptor(VirtDescriptor *desc) override;
+
+        std::string name() const { return parent.name() + ".qCtrl"; }
+
+      protected:
+        VirtIONet &parent;
+    };
+
+    /** Ethernet interface of the device */
+    class Interface : public EtherInt
+    {
+      public:
+        Interface(const std::string &name, VirtIONet &_parent)
+            : EtherInt(name), parent(_parent) {}
+
+        bool recvPacket(EthPacketPtr pkt) override {
+            return parent.recvPacket(pkt);
+        }
+        void sendDone() override { parent.txDone(); }
+
+      protected:
+        VirtIONet &parent;
+    };
+
+  protected:
+    /** @{
+     * @name Receive path
+     */
+    /** Accept a packet from the wire */
+    bool recvPacket(EthPacketPtr pkt);
+    /** Select the queue pair of a received packet */
+    unsigned rxSelect(const EthPacketPtr &pkt) const;
+    /** Copy pending packets of a pair into guest buffers */
+    void rxDeliver(unsigned pair);
+    /** @} */
+
+    /** @{
+     * @name Transmit path
+     */
+    /** Fetch a batch of packets from a transmit queue */
+    void txConsume(unsigned pair);
+    /** Send queued packets to the wire */
+    void txTransmit();
+    /** The link is ready for another packet */
+    void txDone();
+    /** @} */
+
+    /**
+     * Request an interrupt, coalescing it with other requests if an
+     * interrupt delay is configured.
+     */
+    void postInterrupt();
+    /** Deliver a coalesced interrupt */
+    void interrupt();
+    EventFunctionWrapper intrEvent;
+
+    /** Hardware address of the device */
+    const Net::EthAddr macAddr;
+    /** Drop received unicast packets that aren't addressed to us */
+    const bool rxFilter;
+
+    /** Maximum number of packets queued per direction and pair */
+    const unsigned fifoSize;
+    /** Interrupt coalescing delay */
+    const Tick intrDelay;
+
+    /** Number of queue pairs offered to the guest */
+    const unsigned maxPairs;
+    /** Number of queue pairs selected by the guest */
+    unsigned curPairs;
+
+    std::vector<std::unique_ptr<RxQueue>> qRx;
+    std::vector<std::unique_ptr<TxQueue>> qTx;
+    CtrlQueue qCtrl;
+
+    /** Received packets waiting for guest buffers, per pair */
+    std::vector<std::deque<EthPacketPtr>> rxFifo;
+    /** Packets waiting for the link, from all pairs */
+    std::deque<EthPacketPtr> txFifo;
+    /** Transmit queues that stopped on a full FIFO */
+    std::vector<bool> txStalled;
+
+    Interface interface;
+
+    /** @{
+     * @name Statistics
+     */
+    Stats::Scalar txPackets;
+    Stats::Scalar txBytes;
+    Stats::Scalar rxPackets;
+    Stats::Scalar rxBytes;
+    Stats::Scalar droppedPackets;
+    Stats::Scalar txNotifies;
+    Stats::Scalar txDescriptors;
+    Stats::Scalar interrupts;
+    Stats::Formula txBatchSize;
+    /** @} */
+};
+
+#endif // __DEV_VIRTIO_NET_HH__
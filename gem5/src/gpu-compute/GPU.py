@@ -155,6 +155,16 @@ class Shader(ClockedObject):
 
     cpu_pointer = Param.BaseCPU(NULL, "pointer to base CPU")
     translation = Param.Bool(False, "address translation");
+    remote_cu_latency = Param.Cycles(10, "Latency of the messages from CUs "
+                                     "on another event queue to the "
+                                     "dispatcher")
+
+    # The CUs may run on other event queues, they notify the dispatcher
+    # through events
+    def lookaheadLinks(self):
+        latency = int(self.remote_cu_latency) * \
+            self.clk_domain.clockPeriod()
+        return [(self, cu, latency) for cu in self.CUs]
 
 class ClDriver(EmulatedDriver):
     type = 'ClDriver'
@@ -173,6 +183,20 @@ class GpuDispatcher(DmaDevice):
 
     cl_driver = Param.ClDriver('pointer to driver')
 
+    # Kernel sampling: launches are grouped by kernel and grid size, only
+    # the first instances of each group are simulated in detail and the
+    # others complete after the mean duration of those instances
+    kernel_samples = Param.Unsigned(0, "Number of instances of each kernel "
+                                    "and grid size simulated in detail, 0 "
+                                    "simulates all the kernels in detail")
+    kernel_resample_period = Param.Unsigned(0, "Simulate every nth "
+                                            "extrapolated instance in detail "
+                                            "again, 0 never does")
+
+    # The dispatcher calls into the shader directly
+    def lookaheadLinks(self):
+        return [(self, self.shader_pointer, None)]
+
 class MemType(Enum): vals = [
     'M_U8',
     'M_U16',
@@ -56,6 +56,7 @@
 #include "gpu-compute/vector_register_file.hh"
 #include "gpu-compute/wavefront.hh"
 #include "mem/page_table.hh"
+#include "sim/lookahead.hh"
 #include "sim/process.hh"
 
 ComputeUnit::ComputeUnit(const Params *p) : ClockedObject(p), fetchStage(p),
@@ -76,6 +77,9 @@ ComputeUnit::ComputeUnit(const Params *p) : ClockedObject(p), fetchStage(p),
     coalescerToVrfBusWidth(p->coalescer_to_vrf_bus_width),
     req_tick_latency(p->mem_req_latency * p->clk_domain->clockPeriod()),
     resp_tick_latency(p->mem_resp_latency * p->clk_domain->clockPeriod()),
+    tickEvent([this]{ processTick(); }, "Compute unit tick",
+              false, Event::CPU_Tick_Pri),
+    tick_cnt(0), sa_n(0),
     _masterId(p->system->getMasterId(this, "ComputeUnit")),
     lds(*p->localDataStore), _cacheLineSize(p->system->cacheLineSize()),
     globalSeqNum(0), wavefrontSize(p->wfSize),
@@ -157,6 +161,10 @@ ComputeUnit::ComputeUnit(const Params *p) : ClockedObject(p), fetchStage(p),
     }
 
     numVecRegsPerSimd = vrf[0]->numRegs();
+
+    wakeupSeq = 0;
+    sleeping = false;
+    sleepSeq = 0;
 }
 
 ComputeUnit::~ComputeUnit()
@@ -204,10 +212,12 @@ ComputeUnit::updateEvents() {
         uint32_t vecSize = timestampVec.size();
         uint32_t i = 0;
         while (i < vecSize) {
-            if (timestampVec[i] <= shader->tick_cnt) {
+            if (timestampVec[i] <= tick_cnt) {
                 std::pair<uint32_t, uint32_t> regInfo = regIdxVec[i];
                 vrf[regInfo.first]->markReg(regInfo.second, sizeof(uint32_t),
                                             statusVec[i]);
+                // waves may be parked on this register
+                wakeup();
                 timestampVec.erase(timestampVec.begin() + i);
                 regIdxVec.erase(regIdxVec.begin() + i);
                 statusVec.erase(statusVec.begin() + i);
@@ -360,6 +370,12 @@ ComputeUnit::StartWorkgroup(NDRange *ndr)
         }
     }
     ++barrier_id;
+
+    wakeup();
+
+    // the shader only clocks the CUs on its own event queue
+    if (!onShaderQueue() && !tickEvent.scheduled())
+        schedule(tickEvent, curTick() + shader->ticks(1));
 }
 
 int
@@ -533,7 +549,41 @@ ComputeUnit::cedeSIMD(int simdId, int wfSlotId)
 void
 ComputeUnit::exec()
 {
+    tick_cnt = curTick();
+
+    bool applied_adds = false;
+
+    // apply any scheduled adds
+    for (int i = 0; i < sa_n; ++i) {
+        if (sa_when[i] <= tick_cnt) {
+            applied_adds = true;
+            *sa_val[i] += sa_x[i];
+            sa_val.erase(sa_val.begin() + i);
+            sa_x.erase(sa_x.begin() + i);
+            sa_when.erase(sa_when.begin() + i);
+            --sa_n;
+            --i;
+        }
+    }
+
+    // the scheduled adds update the outstanding request counters that
+    // parked wavefronts wait on
+    if (applied_adds)
+        wakeup();
+
     updateEvents();
+
+    if (sleeping && sleepSeq == wakeupSeq) {
+        // no wave can make progress and the pipeline is drained, so
+        // only account for the idle cycle
+        execStage.exec();
+        scoreboardCheckStage.idleCycle();
+
+        sleepCycles++;
+        totalCycles++;
+        return;
+    }
+
     // Execute pipeline stages in reverse order to simulate
     // the pipeline latency
     globalMemoryPipe.exec();
@@ -543,15 +593,89 @@ ComputeUnit::exec()
     scoreboardCheckStage.exec();
     fetchStage.exec();
 
+    sleeping = scoreboardCheckStage.idle() && fetchStage.idle() &&
+        globalMemoryPipe.idle() && localMemoryPipe.idle();
+
+    for (int unitId = 0; sleeping && unitId < dispatchList.size();
+         ++unitId) {
+        sleeping = dispatchList[unitId].second == EMPTY;
+    }
+
+    sleepSeq = wakeupSeq;
+
     totalCycles++;
 }
 
+void
+ComputeUnit::ScheduleAdd(uint32_t *val, Tick when, int x)
+{
+    sa_val.push_back(val);
+    sa_when.push_back(tick_cnt + when);
+    sa_x.push_back(x);
+    ++sa_n;
+}
+
+bool
+ComputeUnit::onShaderQueue() const
+{
+    return eventQueue() == shader->eventQueue();
+}
+
+void
+ComputeUnit::processTick()
+{
+    if (!isDone()) {
+        exec();
+        schedule(tickEvent, curTick() + shader->ticks(1));
+    }
+}
+
+void
+ComputeUnit::notifyWgCompl(Wavefront *w)
+{
+    GpuDispatcher *dispatcher = shader->dispatcher;
+
+    if (onShaderQueue()) {
+        dispatcher->notifyWgCompl(w->kernId);
+        return;
+    }
+
+    int kern_id = w->kernId;
+    dispatcher->schedule(new EventFunctionWrapper(
+        [dispatcher, kern_id]{ dispatcher->notifyWgCompl(kern_id); },
+        "CU work group completion", true),
+        curTick() + shader->remoteCuLatency);
+}
+
+void
+ComputeUnit::scheduleDispatch()
+{
+    GpuDispatcher *dispatcher = shader->dispatcher;
+
+    if (onShaderQueue()) {
+        dispatcher->scheduleDispatch();
+        return;
+    }
+
+    dispatcher->schedule(new EventFunctionWrapper(
+        [dispatcher]{ dispatcher->scheduleDispatch(); },
+        "CU dispatch request", true),
+        curTick() + shader->remoteCuLatency);
+}
+
 void
 ComputeUnit::init()
 {
+    // The dispatcher migrates to the event queue of a CU to start work
+    // groups on it, which can't be reconciled with the clocks of the
+    // lookahead synchronization
+    fatal_if(lookaheadSync && !onShaderQueue(),
+             "%s: CUs on another event queue than the shader need quantum "
+             "based synchronization.\n", name());
+
     // Initialize CU Bus models
-    glbMemToVrfBus.init(&shader->tick_cnt, shader->ticks(1));
-    locMemToVrfBus.init(&shader->tick_cnt, shader->ticks(1));
+    glbMemToVrfBus.init(&tick_cnt, shader->ticks(1));
+    locMemToVrfBus.init(&tick_cnt, shader->ticks(1));
     nextGlbMemBus = 0;
     nextLocMemBus = 0;
     fatal_if(numGlbMemUnits > 1,
@@ -559,7 +683,7 @@ ComputeUnit::init()
     vrfToGlobalMemPipeBus.resize(numGlbMemUnits);
     for (int j = 0; j < numGlbMemUnits; ++j) {
         vrfToGlobalMemPipeBus[j] = WaitClass();
-        vrfToGlobalMemPipeBus[j].init(&shader->tick_cnt, shader->ticks(1));
+        vrfToGlobalMemPipeBus[j].init(&tick_cnt, shader->ticks(1));
     }
 
     fatal_if(numLocMemUnits > 1,
@@ -567,7 +691,7 @@ ComputeUnit::init()
     vrfToLocalMemPipeBus.resize(numLocMemUnits);
     for (int j = 0; j < numLocMemUnits; ++j) {
         vrfToLocalMemPipeBus[j] = WaitClass();
-        vrfToLocalMemPipeBus[j].init(&shader->tick_cnt, shader->ticks(1));
+        vrfToLocalMemPipeBus[j].init(&tick_cnt, shader->ticks(1));
     }
     vectorRegsReserved.resize(numSIMDs, 0);
     aluPipe.resize(numSIMDs);
@@ -575,12 +699,12 @@ ComputeUnit::init()
 
     for (int i = 0; i < numSIMDs + numLocMemUnits + numGlbMemUnits; ++i) {
         wfWait[i] = WaitClass();
-        wfWait[i].init(&shader->tick_cnt, shader->ticks(1));
+        wfWait[i].init(&tick_cnt, shader->ticks(1));
     }
 
     for (int i = 0; i < numSIMDs; ++i) {
         aluPipe[i] = WaitClass();
-        aluPipe[i].init(&shader->tick_cnt, shader->ticks(1));
+        aluPipe[i].init(&tick_cnt, shader->ticks(1));
     }
 
     // Setup space for call args
@@ -627,6 +751,8 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
     int index = sender_state->port_index;
     GPUDynInstPtr gpuDynInst = sender_state->_gpuDynInst;
 
+    computeUnit->wakeup();
+
     // Is the packet returned a Kernel End or Barrier
     if (pkt->req->isKernel() && pkt->req->isRelease()) {
         Wavefront *w =
@@ -638,7 +764,7 @@ ComputeUnit::DataPort::recvTimingResp(PacketPtr pkt)
                     computeUnit->cu_id, w->simdId, w->wfSlotId,
                     w->wfDynId, w->kernId);
 
-            computeUnit->shader->dispatcher->notifyWgCompl(w);
+            computeUnit->notifyWgCompl(w);
             w->status = Wavefront::S_STOPPED;
         } else {
             w->outstandingReqs--;
@@ -711,6 +837,7 @@ ComputeUnit::DataPort::recvReqRetry()
 bool
 ComputeUnit::SQCPort::recvTimingResp(PacketPtr pkt)
 {
+    computeUnit->wakeup();
     computeUnit->fetchStage.processFetchReturn(pkt);
 
     return true;
@@ -785,7 +912,7 @@ ComputeUnit::sendRequest(GPUDynInstPtr gpuDynInst, int index, PacketPtr pkt)
             Addr paddr;
 
             if (!p->pTable->translate(vaddr, paddr)) {
-                if (!p->fixupStackFault(vaddr)) {
+                if (!p->fixupFault(vaddr)) {
                     panic("CU%d: WF[%d][%d]: Fault on addr %#x!\n",
                           cu_id, gpuDynInst->simdId, gpuDynInst->wfSlotId,
                           vaddr);
@@ -983,6 +1110,8 @@ ComputeUnit::DataPort::processMemRespEvent(PacketPtr pkt)
 
     assert(gpuDynInst);
 
+    compute_unit->wakeup();
+
     DPRINTF(GPUPort, "CU%d: WF[%d][%d]: Response for addr %#x, index %d\n",
             compute_unit->cu_id, gpuDynInst->simdId, gpuDynInst->wfSlotId,
             pkt->req->getPaddr(), index);
@@ -1598,6 +1727,12 @@ ComputeUnit::regStats()
         .desc("number of cycles the CU ran for")
         ;
 
+    sleepCycles
+        .name(name() + ".num_sleep_cycles")
+        .desc("number of cycles the CU pipeline was idle waiting for "
+              "memory or register updates")
+        ;
+
     ipc
         .name(name() + ".ipc")
         .desc("Instructions per cycle (this CU only)")
@@ -1827,6 +1962,7 @@ ComputeUnit::LDSPort::recvTimingResp(PacketPtr packet)
     delete packet;
 
     computeUnit->localMemoryPipe.getLMRespFIFO().push(gpuDynInst);
+    computeUnit->wakeup();
     return true;
 }
 
@@ -238,6 +238,55 @@ class ComputeUnit : public ClockedObject
 
     void updateEvents();
 
+    /**
+     * Wake up the pipeline and all parked wavefronts. This must be called
+     * on every event that can unblock a wavefront waiting on a busy
+     * register or on its outstanding memory requests, and on every event
+     * that gives the pipeline new work.
+     */
+    void wakeup() { ++wakeupSeq; }
+    // bumped by every wakeup; waves parked before it are awake again
+    uint64_t wakeupSeq;
+    // the pipeline found no work and skips its stages until a wakeup
+    bool sleeping;
+    uint64_t sleepSeq;
+
+    /**
+     * @{
+     * @name Event queue of the CU
+     *
+     * A CU may run on another event queue than the shader and the
+     * dispatcher. It then clocks itself, and its messages to the
+     * dispatcher are sent as events that arrive one remote CU latency
+     * later.
+     */
+    bool onShaderQueue() const;
+    void processTick();
+    EventFunctionWrapper tickEvent;
+
+    // the work group of w has completed
+    void notifyWgCompl(Wavefront *w);
+    // a wavefront has finished, try to dispatch more work
+    void scheduleDispatch();
+    /** @} */
+
+    // curTick() of the current exec(), the time base of the wait
+    // counters and scheduled adds of this CU
+    uint64_t tick_cnt;
+
+    // Size of scheduled add queue
+    uint32_t sa_n;
+
+    // Pointer to value to be increments
+    std::vector<uint32_t*> sa_val;
+    // When to do the increment
+    std::vector<uint64_t> sa_when;
+    // Amount to increment by
+    std::vector<int32_t> sa_x;
+
+    // Schedule a 32-bit value to be incremented some time in the future
+    void ScheduleAdd(uint32_t *val, Tick when, int x);
+
     // this hash map will keep track of page divergence
     // per memory instruction per wavefront. The hash map
     // is cleared in GPUDynInst::updateStats() in gpu_dyn_inst.cc.
@@ -355,6 +404,9 @@ class ComputeUnit : public ClockedObject
     Stats::Scalar numVecOpsExecuted;
     // Total cycles that something is running on the GPU
     Stats::Scalar totalCycles;
+    // Cycles the pipeline was skipped because no wavefront could make
+    // progress
+    Stats::Scalar sleepCycles;
     Stats::Formula vpc; // vector ops per cycle
     Stats::Formula ipc; // vector instructions per cycle
     Stats::Distribution controlFlowDivergenceDist;
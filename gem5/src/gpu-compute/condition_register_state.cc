@@ -76,7 +76,7 @@ ConditionRegisterState::exec(GPUDynInstPtr ii, Wavefront *w)
             w->computeUnit->
                 registerEvent(w->simdId, ii->getRegisterIndex(i, ii),
                               ii->getOperandSize(i),
-                              w->computeUnit->shader->tick_cnt +
+                              w->computeUnit->tick_cnt +
                               w->computeUnit->shader->ticks(pipeLen), 0);
         }
     }
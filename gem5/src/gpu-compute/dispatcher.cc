@@ -38,6 +38,8 @@
 
 #include "gpu-compute/dispatcher.hh"
 
+#include <algorithm>
+
 #include "cpu/base.hh"
 #include "debug/GPUDisp.hh"
 #include "gpu-compute/cl_driver.hh"
@@ -54,7 +56,9 @@ GpuDispatcher::GpuDispatcher(const Params *p)
       dispatchCount(0), dispatchActive(false), cpu(p->cpu),
       shader(p->shader_pointer), driver(p->cl_driver),
       tickEvent([this]{ exec(); }, "GPU Dispatcher tick",
-                false, Event::CPU_Tick_Pri)
+                false, Event::CPU_Tick_Pri),
+      numKernelSamples(p->kernel_samples),
+      kernelResamplePeriod(p->kernel_resample_period), numExtrapolating(0)
 {
     shader->handshake(this);
     driver->handshake(this);
@@ -71,6 +75,29 @@ GpuDispatcher::GpuDispatcher(const Params *p)
     .name(name() + ".num_kernel_launched")
     .desc("number of kernel launched")
     ;
+
+    num_kernelExtrapolated
+    .name(name() + ".num_kernel_extrapolated")
+    .desc("number of kernels launched without simulating them")
+    ;
+
+    simulatedKernelTicks
+    .name(name() + ".simulated_kernel_ticks")
+    .desc("total duration of the kernels simulated in detail")
+    ;
+
+    extrapolatedKernelTicks
+    .name(name() + ".extrapolated_kernel_ticks")
+    .desc("total extrapolated duration of the kernels not simulated")
+    ;
+
+    kernelTickWeight
+    .name(name() + ".kernel_tick_weight")
+    .desc("weight of the detailed GPU statistics when extrapolating them "
+          "to all the kernels")
+    ;
+    kernelTickWeight = (simulatedKernelTicks + extrapolatedKernelTicks) /
+        simulatedKernelTicks;
 }
 
 GpuDispatcher *GpuDispatcherParams::create()
@@ -88,6 +115,9 @@ GpuDispatcher::serialize(CheckpointOut &cp) const
 
     if (ndRange.wg_disp_rem)
         fatal("Checkpointing not supported during active workgroup execution");
+    if (numExtrapolating)
+        fatal("Checkpointing not supported with extrapolated kernels "
+              "in flight");
 
     if (tickEvent.scheduled())
         event_tick = tickEvent.when();
@@ -227,13 +257,37 @@ GpuDispatcher::write(PacketPtr pkt)
         ndr->numDispLeft = (volatile uint32_t*)curTask.numDispLeft;
         ndr->dispatchId = nextId;
         ndr->curCid = pkt->req->contextId();
-        DPRINTF(GPUDisp, "launching kernel %d\n",nextId);
-        execIds.push(nextId);
+        ndr->launchTick = curTick();
+
+        Tick duration = sampleKernel(*ndr);
+        ndr->extrapolated = duration != 0;
+
+        if (ndr->extrapolated) {
+            // the kernel isn't simulated, it completes once its
+            // extrapolated duration has elapsed
+            DPRINTF(GPUDisp, "extrapolating kernel %d, %d ticks\n", nextId,
+                    duration);
+            ndr->wg_disp_rem = false;
+            ndr->numWgCompleted = ndr->numWgTotal;
+            ++numExtrapolating;
+            ++num_kernelExtrapolated;
+            extrapolatedKernelTicks += duration;
+
+            int kern_id = nextId;
+            schedule(new EventFunctionWrapper([this, kern_id]{
+                         --numExtrapolating;
+                         kernelDone(kern_id);
+                     }, "GPU extrapolated kernel completion", true),
+                     curTick() + duration);
+        } else {
+            DPRINTF(GPUDisp, "launching kernel %d\n",nextId);
+            execIds.push(nextId);
+        }
         ++nextId;
 
         dispatchActive = true;
 
-        if (!tickEvent.scheduled()) {
+        if (!ndr->extrapolated && !tickEvent.scheduled()) {
             schedule(&tickEvent, curTick() + shader->ticks(1));
         }
     } else {
@@ -307,36 +361,44 @@ GpuDispatcher::exec()
 }
 
 void
-GpuDispatcher::notifyWgCompl(Wavefront *w)
+GpuDispatcher::notifyWgCompl(int kern_id)
 {
-    int kern_id = w->kernId;
     DPRINTF(GPUDisp, "notify WgCompl %d\n",kern_id);
     assert(ndRangeMap[kern_id].dispatchId == kern_id);
     ndRangeMap[kern_id].numWgCompleted++;
 
     if (ndRangeMap[kern_id].numWgCompleted == ndRangeMap[kern_id].numWgTotal) {
-        ndRangeMap[kern_id].execDone = true;
-        doneIds.push(kern_id);
+        recordKernelSample(ndRangeMap[kern_id]);
+        kernelDone(kern_id);
+    } else if (!tickEvent.scheduled()) {
+        schedule(&tickEvent, curTick() + shader->ticks(1));
+    }
+}
 
-        if (ndRangeMap[kern_id].addrToNotify) {
-            accessUserVar(cpu, (uint64_t)(ndRangeMap[kern_id].addrToNotify), 1,
-                          0);
-        }
+void
+GpuDispatcher::kernelDone(int kern_id)
+{
+    ndRangeMap[kern_id].execDone = true;
+    doneIds.push(kern_id);
 
-        accessUserVar(cpu, (uint64_t)(ndRangeMap[kern_id].numDispLeft), 0, -1);
+    if (ndRangeMap[kern_id].addrToNotify) {
+        accessUserVar(cpu, (uint64_t)(ndRangeMap[kern_id].addrToNotify), 1,
+                      0);
+    }
 
-        // update event end time (in nano-seconds)
-        if (ndRangeMap[kern_id].q.depends) {
-            HostState *host_state = (HostState*)ndRangeMap[kern_id].q.depends;
-            uint64_t event;
-            shader->ReadMem((uint64_t)(&host_state->event), &event,
-                            sizeof(uint64_t), 0);
+    accessUserVar(cpu, (uint64_t)(ndRangeMap[kern_id].numDispLeft), 0, -1);
 
-            uint64_t end = curTick() / 1000;
+    // update event end time (in nano-seconds)
+    if (ndRangeMap[kern_id].q.depends) {
+        HostState *host_state = (HostState*)ndRangeMap[kern_id].q.depends;
+        uint64_t event;
+        shader->ReadMem((uint64_t)(&host_state->event), &event,
+                        sizeof(uint64_t), 0);
 
-            shader->WriteMem((uint64_t)(&((_cl_event*)event)->end), &end,
-                             sizeof(uint64_t), 0);
-        }
+        uint64_t end = curTick() / 1000;
+
+        shader->WriteMem((uint64_t)(&((_cl_event*)event)->end), &end,
+                         sizeof(uint64_t), 0);
     }
 
     if (!tickEvent.scheduled()) {
@@ -344,6 +406,56 @@ GpuDispatcher::notifyWgCompl(Wavefront *w)
     }
 }
 
+GpuDispatcher::KernelSignature
+GpuDispatcher::kernelSignature(const HsaQueueEntry &task)
+{
+    return KernelSignature(task.code_ptr, task.gdSize[0], task.gdSize[1],
+                           task.gdSize[2]);
+}
+
+Tick
+GpuDispatcher::sampleKernel(const NDRange &ndr)
+{
+    if (!numKernelSamples)
+        return 0;
+
+    KernelSamples &samples = kernelSamples[kernelSignature(ndr.q)];
+    ++samples.launched;
+
+    // simulate the first instances, and all the instances until one
+    // of them has completed so there is something to extrapolate from
+    if (samples.simulated < numKernelSamples || !samples.completed) {
+        ++samples.simulated;
+        return 0;
+    }
+
+    // periodically resimulate an instance to follow phase changes
+    if (kernelResamplePeriod &&
+        (samples.launched - samples.simulated) % kernelResamplePeriod == 0) {
+        ++samples.simulated;
+        return 0;
+    }
+
+    return std::max<Tick>(samples.ticks / samples.completed, 1);
+}
+
+void
+GpuDispatcher::recordKernelSample(const NDRange &ndr)
+{
+    Tick duration = curTick() - ndr.launchTick;
+    simulatedKernelTicks += duration;
+
+    if (!numKernelSamples)
+        return;
+
+    KernelSamples &samples = kernelSamples[kernelSignature(ndr.q)];
+    ++samples.completed;
+    samples.ticks += duration;
+
+    DPRINTF(GPUDisp, "kernel %d took %d ticks, %d samples\n",
+            ndr.dispatchId, duration, samples.completed);
+}
+
 void
 GpuDispatcher::scheduleDispatch()
 {
@@ -38,7 +38,9 @@
 #ifndef __GPU_DISPATCHER_HH__
 #define __GPU_DISPATCHER_HH__
 
+#include <map>
 #include <queue>
+#include <tuple>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -95,9 +97,48 @@ class GpuDispatcher : public DmaDevice
         typedef std::unordered_map<uint64_t, uint64_t> TranslationBuffer;
         TranslationBuffer tlb;
 
+        // Launches are sampled per kernel code and grid size
+        typedef std::tuple<uint64_t, uint32_t, uint32_t, uint32_t>
+            KernelSignature;
+
+        struct KernelSamples
+        {
+            // instances launched so far
+            unsigned launched = 0;
+            // instances simulated in detail
+            unsigned simulated = 0;
+            // completed detailed instances and their total duration
+            unsigned completed = 0;
+            Tick ticks = 0;
+        };
+
+        std::map<KernelSignature, KernelSamples> kernelSamples;
+
+        // number of detailed instances per signature, 0 disables sampling
+        const unsigned numKernelSamples;
+        // resimulate every nth extrapolated instance
+        const unsigned kernelResamplePeriod;
+        // kernels waiting for their extrapolated completion
+        unsigned numExtrapolating;
+
+        static KernelSignature kernelSignature(const HsaQueueEntry &task);
+        /**
+         * Decide whether a kernel launch is simulated in detail and
+         * return its extrapolated duration if it isn't, 0 otherwise.
+         */
+        Tick sampleKernel(const NDRange &ndr);
+        /** Record the duration of a kernel simulated in detail. */
+        void recordKernelSample(const NDRange &ndr);
+        /** Notify the host that a kernel has completed. */
+        void kernelDone(int kern_id);
+
     public:
         /*statistics*/
         Stats::Scalar num_kernelLaunched;
+        Stats::Scalar num_kernelExtrapolated;
+        Stats::Scalar simulatedKernelTicks;
+        Stats::Scalar extrapolatedKernelTicks;
+        Stats::Formula kernelTickWeight;
         GpuDispatcher(const Params *p);
 
         ~GpuDispatcher() { }
@@ -105,7 +146,7 @@ class GpuDispatcher : public DmaDevice
         void exec();
         virtual void serialize(CheckpointOut &cp) const override;
         virtual void unserialize(CheckpointIn &cp) override;
-        void notifyWgCompl(Wavefront *w);
+        void notifyWgCompl(int kern_id);
         void scheduleDispatch();
         void accessUserVar(BaseCPU *cpu, uint64_t addr, int val, int off);
 
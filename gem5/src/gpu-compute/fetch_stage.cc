@@ -73,6 +73,18 @@ FetchStage::exec()
     }
 }
 
+bool
+FetchStage::idle() const
+{
+    for (int j = 0; j < numSIMDs; ++j) {
+        if (!fetchUnit[j].idle()) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 void
 FetchStage::processFetchReturn(PacketPtr pkt)
 {
@@ -60,6 +60,7 @@ class FetchStage
     void exec();
     void processFetchReturn(PacketPtr pkt);
     void fetch(PacketPtr pkt, Wavefront *wave);
+    bool idle() const;
 
     // Stats related variables and methods
     std::string name() { return _name; }
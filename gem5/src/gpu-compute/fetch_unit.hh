@@ -62,6 +62,8 @@ class FetchUnit
     void initiateFetch(Wavefront *wavefront);
     void fetch(PacketPtr pkt, Wavefront *wavefront);
     void processFetchReturn(PacketPtr pkt);
+    // no wave is waiting to be fetched
+    bool idle() const { return fetchQueue.empty(); }
     static uint32_t globalFetchUnitID;
 
   private:
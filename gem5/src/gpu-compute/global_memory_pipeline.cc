@@ -90,16 +90,16 @@ GlobalMemPipeline::exec()
         completeRequest(m);
 
         // Decrement outstanding register count
-        computeUnit->shader->ScheduleAdd(&w->outstandingReqs, m->time, -1);
+        computeUnit->ScheduleAdd(&w->outstandingReqs, m->time, -1);
 
         if (m->isStore() || m->isAtomic()) {
-            computeUnit->shader->ScheduleAdd(&w->outstandingReqsWrGm,
-                                             m->time, -1);
+            computeUnit->ScheduleAdd(&w->outstandingReqsWrGm,
+                                     m->time, -1);
         }
 
         if (m->isLoad() || m->isAtomic()) {
-            computeUnit->shader->ScheduleAdd(&w->outstandingReqsRdGm,
-                                             m->time, -1);
+            computeUnit->ScheduleAdd(&w->outstandingReqsRdGm,
+                                     m->time, -1);
         }
 
         // Mark write bus busy for appropriate amount of time
@@ -150,6 +150,21 @@ GlobalMemPipeline::exec()
     }
 }
 
+bool
+GlobalMemPipeline::idle() const
+{
+    if (!gmIssuedRequests.empty()) {
+        return false;
+    }
+
+    if (outOfOrderDataDelivery) {
+        return gmReturnedLoads.empty() && gmReturnedStores.empty();
+    }
+
+    return gmOrderedRespBuffer.empty() ||
+        !gmOrderedRespBuffer.begin()->second.second;
+}
+
 GPUDynInstPtr
 GlobalMemPipeline::getNextReadyResp()
 {
@@ -115,6 +115,13 @@ class GlobalMemPipeline
         return (gmIssuedRequests.size() + pendReqs) < gmQueueSize;
     }
 
+    /**
+     * no request waits to be issued and no response is ready to be
+     * written back, i.e., the pipeline has nothing to do until a new
+     * response arrives from the memory system.
+     */
+    bool idle() const;
+
     const std::string &name() const { return _name; }
     void regStats();
 
@@ -76,6 +76,12 @@ class LocalMemPipeline
         return (lmIssuedRequests.size() + pendReqs) < lmQueueSize;
     }
 
+    bool
+    idle() const
+    {
+        return lmIssuedRequests.empty() && lmReturnedRequests.empty();
+    }
+
     const std::string& name() const { return _name; }
     void regStats();
 
@@ -65,6 +65,11 @@ struct NDRange
     volatile uint32_t *numDispLeft;
     int dispatchId;
     int curCid; // Current context id
+
+    // tick at which the kernel was launched
+    Tick launchTick;
+    // the kernel is not simulated, its duration is extrapolated
+    bool extrapolated;
 };
 
 #endif // __NDRANGE_HH__
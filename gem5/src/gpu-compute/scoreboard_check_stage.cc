@@ -50,7 +50,7 @@ ScoreboardCheckStage::ScoreboardCheckStage(const ComputeUnitParams *p)
       vectorAluInstAvail(nullptr),
       lastGlbMemSimd(-1),
       lastShrMemSimd(-1), glbMemInstAvail(nullptr),
-      shrMemInstAvail(nullptr)
+      shrMemInstAvail(nullptr), numAwakeWaves(0)
 {
 }
 
@@ -136,6 +136,8 @@ ScoreboardCheckStage::exec()
         readyList[unitId]->clear();
     }
 
+    numAwakeWaves = 0;
+
     // iterate over the Wavefronts of all SIMD units
     for (int unitId = 0; unitId < numSIMDs; ++unitId) {
         for (int wvId = 0; wvId < computeUnit->shader->n_wf; ++wvId) {
@@ -144,6 +146,16 @@ ScoreboardCheckStage::exec()
             Wavefront *curWave = waveStatusList[unitId]->at(wvId).first;
             collectStatistics(curWave, unitId);
 
+            // stopped waves are never ready, and nothing a parked wave
+            // waits on has changed since it was last analyzed
+            if (curWave->status == Wavefront::S_STOPPED ||
+                curWave->isParked()) {
+                continue;
+            }
+
+            ++numAwakeWaves;
+            curWave->waitingForWakeup = false;
+
             if (curWave->ready(Wavefront::I_ALU)) {
                 readyList[unitId]->push_back(curWave);
                 waveStatusList[unitId]->at(wvId).second = READY;
@@ -163,11 +175,28 @@ ScoreboardCheckStage::exec()
             } else if (curWave->ready(Wavefront::I_PRIVATE)) {
                 readyList[computeUnit->GlbMemUnitId()]->push_back(curWave);
                 waveStatusList[unitId]->at(wvId).second = READY;
+            } else if (curWave->waitingForWakeup) {
+                curWave->parked = true;
+                curWave->parkedSeq = computeUnit->wakeupSeq;
+                --numAwakeWaves;
             }
         }
     }
 }
 
+void
+ScoreboardCheckStage::idleCycle()
+{
+    initStatistics();
+
+    for (int unitId = 0; unitId < numSIMDs; ++unitId) {
+        for (int wvId = 0; wvId < computeUnit->shader->n_wf; ++wvId) {
+            collectStatistics(waveStatusList[unitId]->at(wvId).first,
+                              unitId);
+        }
+    }
+}
+
 void
 ScoreboardCheckStage::regStats()
 {
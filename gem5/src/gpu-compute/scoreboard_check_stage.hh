@@ -60,6 +60,10 @@ enum WAVE_STATUS
  * hazards are considered while marking a wave "ready"
  * for execution. After analysis, the ready waves are
  * added to readyList.
+ *
+ * Waves that wait on a busy register or on memory requests
+ * that already left the pipeline are parked, and are not
+ * analyzed again until the CU wakes up.
  */
 class ScoreboardCheckStage
 {
@@ -69,6 +73,15 @@ class ScoreboardCheckStage
     void init(ComputeUnit *cu);
     void exec();
 
+    /**
+     * Collect the per-cycle statistics of a cycle in which the CU
+     * pipeline sleeps, without analyzing any wave.
+     */
+    void idleCycle();
+
+    /** No wave can make progress before the next CU wakeup */
+    bool idle() const { return !numAwakeWaves; }
+
     // Stats related variables and methods
     const std::string& name() const { return _name; }
     void regStats();
@@ -100,6 +113,9 @@ class ScoreboardCheckStage
     std::vector<std::vector<std::pair<Wavefront*, WAVE_STATUS>>*>
         waveStatusList;
 
+    // number of running waves that were not parked last cycle
+    int numAwakeWaves;
+
     std::string _name;
 };
 
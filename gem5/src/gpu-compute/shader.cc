@@ -59,8 +59,9 @@ Shader::Shader(const Params *p)
       impl_kern_boundary_sync(p->impl_kern_boundary_sync),
       separate_acquire_release(p->separate_acquire_release), coissue_return(1),
       trace_vgpr_all(1), n_cu((p->CUs).size()), n_wf(p->n_wf),
-      globalMemSize(p->globalmem), nextSchedCu(0), sa_n(0), tick_cnt(0),
-      box_tick_cnt(0), start_tick_cnt(0)
+      globalMemSize(p->globalmem), nextSchedCu(0), tick_cnt(0),
+      box_tick_cnt(0), start_tick_cnt(0),
+      remoteCuLatency(ticks(p->remote_cu_latency))
 {
 
     cuList.resize(n_cu);
@@ -153,21 +154,12 @@ Shader::exec()
     tick_cnt = curTick();
     box_tick_cnt = curTick() - start_tick_cnt;
 
-    // apply any scheduled adds
-    for (int i = 0; i < sa_n; ++i) {
-        if (sa_when[i] <= tick_cnt) {
-            *sa_val[i] += sa_x[i];
-            sa_val.erase(sa_val.begin() + i);
-            sa_x.erase(sa_x.begin() + i);
-            sa_when.erase(sa_when.begin() + i);
-            --sa_n;
-            --i;
-        }
+    // clock all of the cu's on our event queue, the others clock
+    // themselves
+    for (int i = 0; i < n_cu; ++i) {
+        if (cuList[i]->onShaderQueue())
+            cuList[i]->exec();
     }
-
-    // clock all of the cu's
-    for (int i = 0; i < n_cu; ++i)
-        cuList[i]->exec();
 }
 
 bool
@@ -181,19 +173,35 @@ Shader::dispatch_workgroups(NDRange *ndr)
         //Every time we try a CU, update nextSchedCu
         nextSchedCu = (nextSchedCu + 1) % n_cu;
 
-        // dispatch workgroup iff the following two conditions are met:
-        // (a) wg_rem is true - there are unassigned workgroups in the grid
-        // (b) there are enough free slots in cu cuList[i] for this wg
-        if (ndr->wg_disp_rem && cuList[curCu]->ReadyWorkgroup(ndr)) {
-            scheduledSomething = true;
-            DPRINTF(GPUDisp, "Dispatching a workgroup to CU %d\n", curCu);
+        ComputeUnit *cu = cuList[curCu];
+        bool started = false;
+        {
+            // Work groups are started on the event queue of the CU. The
+            // CUs only talk back through events, so nothing else runs
+            // on our queue in the meantime.
+            EventQueue::ScopedMigration migrate(cu->eventQueue());
+
+            // dispatch workgroup iff the following two conditions are met:
+            // (a) wg_rem is true - there are unassigned workgroups in the
+            //     grid
+            // (b) there are enough free slots in cu cuList[i] for this wg
+            if (ndr->wg_disp_rem && cu->ReadyWorkgroup(ndr)) {
+                DPRINTF(GPUDisp, "Dispatching a workgroup to CU %d\n",
+                        curCu);
+
+                // ticks() member function translates cycles to simulation
+                // ticks. CUs on other queues clock themselves.
+                if (cu->onShaderQueue() && !tickEvent.scheduled()) {
+                    schedule(tickEvent, curTick() + this->ticks(1));
+                }
 
-            // ticks() member function translates cycles to simulation ticks.
-            if (!tickEvent.scheduled()) {
-                schedule(tickEvent, curTick() + this->ticks(1));
+                cu->StartWorkgroup(ndr);
+                started = true;
             }
+        }
 
-            cuList[curCu]->StartWorkgroup(ndr);
+        if (started) {
+            scheduledSomething = true;
             ndr->wgId[0]++;
             ndr->globalWgId++;
             if (ndr->wgId[0] * ndr->q.wgSize[0] >= ndr->q.gdSize[0]) {
@@ -303,7 +311,7 @@ bool
 Shader::busy()
 {
     for (int i_cu = 0; i_cu < n_cu; ++i_cu) {
-        if (!cuList[i_cu]->isDone()) {
+        if (cuList[i_cu]->onShaderQueue() && !cuList[i_cu]->isDone()) {
             return true;
         }
     }
@@ -311,15 +319,6 @@ Shader::busy()
     return false;
 }
 
-void
-Shader::ScheduleAdd(uint32_t *val,Tick when,int x)
-{
-    sa_val.push_back(val);
-    sa_when.push_back(tick_cnt + when);
-    sa_x.push_back(x);
-    ++sa_n;
-}
-
 
 void
 Shader::processTick()
@@ -135,16 +135,6 @@ class Shader : public ClockedObject
     // Tracks CU that rr dispatcher should attempt scheduling
     int nextSchedCu;
 
-    // Size of scheduled add queue
-    uint32_t sa_n;
-
-    // Pointer to value to be increments
-    std::vector<uint32_t*> sa_val;
-    // When to do the increment
-    std::vector<uint64_t> sa_when;
-    // Amount to increment by
-    std::vector<int32_t> sa_x;
-
     // List of Compute Units (CU's)
     std::vector<ComputeUnit*> cuList;
 
@@ -154,6 +144,10 @@ class Shader : public ClockedObject
 
     GpuDispatcher *dispatcher;
 
+    // Latency of the messages from CUs on another event queue to the
+    // dispatcher
+    Tick remoteCuLatency;
+
     Shader(const Params *p);
     ~Shader();
     virtual void init();
@@ -164,8 +158,6 @@ class Shader : public ClockedObject
     // Check to see if shader is busy
     bool busy();
 
-    // Schedule a 32-bit value to be incremented some time in the future
-    void ScheduleAdd(uint32_t *val, Tick when, int x);
     bool processTimingPacket(PacketPtr pkt);
 
     void AccessMem(uint64_t address, void *ptr, uint32_t size, int cu_id,
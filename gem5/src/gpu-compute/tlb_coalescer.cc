@@ -143,8 +143,10 @@ TLBCoalescer::updatePhysAddresses(PacketPtr pkt)
 {
     Addr virt_page_addr = roundDown(pkt->req->getVaddr(), TheISA::PageBytes);
 
+    const coalescedReq &coalesced = issuedTranslationsTable[virt_page_addr];
+
     DPRINTF(GPUTLB, "Update phys. addr. for %d coalesced reqs for page %#x\n",
-            issuedTranslationsTable[virt_page_addr].size(), virt_page_addr);
+            coalesced.size(), virt_page_addr);
 
     TheISA::GpuTLB::TranslationState *sender_state =
         safe_cast<TheISA::GpuTLB::TranslationState*>(pkt->senderState);
@@ -163,8 +165,8 @@ TLBCoalescer::updatePhysAddresses(PacketPtr pkt)
     Addr phys_page_paddr = pkt->req->getPaddr();
     phys_page_paddr &= ~(page_size - 1);
 
-    for (int i = 0; i < issuedTranslationsTable[virt_page_addr].size(); ++i) {
-        PacketPtr local_pkt = issuedTranslationsTable[virt_page_addr][i];
+    for (int i = 0; i < coalesced.size(); ++i) {
+        PacketPtr local_pkt = coalesced[i];
         TheISA::GpuTLB::TranslationState *sender_state =
             safe_cast<TheISA::GpuTLB::TranslationState*>(
                     local_pkt->senderState);
@@ -278,21 +280,19 @@ TLBCoalescer::CpuSidePort::recvTimingReq(PacketPtr pkt)
     // given coalescingWindow.
     int64_t tick_index = sender_state->issueTime / coalescer->coalescingWindow;
 
-    if (coalescer->coalescerFIFO.count(tick_index)) {
-        coalescedReq_cnt = coalescer->coalescerFIFO[tick_index].size();
-    }
+    std::vector<coalescedReq> &reqs = coalescer->coalescerFIFO[tick_index];
+    coalescedReq_cnt = reqs.size();
 
     // see if we can coalesce the incoming pkt with another
     // coalesced request with the same tick_index
     for (int i = 0; i < coalescedReq_cnt; ++i) {
-        first_packet = coalescer->coalescerFIFO[tick_index][i][0];
+        first_packet = reqs[i][0];
 
         if (coalescer->canCoalesce(pkt, first_packet)) {
-            coalescer->coalescerFIFO[tick_index][i].push_back(pkt);
+            reqs[i].push_back(pkt);
 
             DPRINTF(GPUTLB, "Coalesced req %i w/ tick_index %d has %d reqs\n",
-                    i, tick_index,
-                    coalescer->coalescerFIFO[tick_index][i].size());
+                    i, tick_index, reqs[i].size());
 
             didCoalesce = true;
             break;
@@ -306,13 +306,10 @@ TLBCoalescer::CpuSidePort::recvTimingReq(PacketPtr pkt)
         if (update_stats)
             coalescer->coalescedAccesses++;
 
-        std::vector<PacketPtr> new_array;
-        new_array.push_back(pkt);
-        coalescer->coalescerFIFO[tick_index].push_back(new_array);
+        reqs.emplace_back(1, pkt);
 
         DPRINTF(GPUTLB, "coalescerFIFO[%d] now has %d coalesced reqs after "
-                "push\n", tick_index,
-                coalescer->coalescerFIFO[tick_index].size());
+                "push\n", tick_index, reqs.size());
     }
 
     //schedule probeTLBEvent next cycle to send the
@@ -483,9 +480,9 @@ TLBCoalescer::processProbeTLBEvent()
                 DPRINTF(GPUTLB, "Successfully sent TLB request for page %#x",
                        virt_page_addr);
 
-                //copy coalescedReq to issuedTranslationsTable
-                issuedTranslationsTable[virt_page_addr]
-                    = iter->second[vector_index];
+                //move coalescedReq to issuedTranslationsTable
+                issuedTranslationsTable[virt_page_addr] =
+                    std::move(iter->second[vector_index]);
 
                 //erase the entry of this coalesced req
                 iter->second.erase(iter->second.begin() + vector_index);
@@ -39,6 +39,7 @@
 #include <list>
 #include <queue>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "arch/generic/tlb.hh"
@@ -47,6 +48,7 @@
 #include "arch/x86/pagetable.hh"
 #include "arch/x86/regs/segment.hh"
 #include "base/logging.hh"
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "gpu-compute/gpu_tlb.hh"
 #include "mem/port.hh"
@@ -107,7 +109,10 @@ class TLBCoalescer : public ClockedObject
      * option is to change it to curTick(), so we coalesce based
      * on the receive time.
      */
-    typedef std::unordered_map<int64_t, std::vector<coalescedReq>> CoalescingFIFO;
+    typedef std::unordered_map<int64_t, std::vector<coalescedReq>,
+        std::hash<int64_t>, std::equal_to<int64_t>,
+        PoolAllocator<std::pair<const int64_t, std::vector<coalescedReq>>>>
+        CoalescingFIFO;
 
     CoalescingFIFO coalescerFIFO;
 
@@ -120,7 +125,9 @@ class TLBCoalescer : public ClockedObject
      * The rules that determine which requests we can coalesce are
      * specified in the canCoalesce() method.
      */
-    typedef std::unordered_map<Addr, coalescedReq> CoalescingTable;
+    typedef std::unordered_map<Addr, coalescedReq, std::hash<Addr>,
+        std::equal_to<Addr>,
+        PoolAllocator<std::pair<const Addr, coalescedReq>>> CoalescingTable;
 
     CoalescingTable issuedTranslationsTable;
 
@@ -183,7 +183,7 @@ VectorRegisterFile::exec(GPUDynInstPtr ii, Wavefront *w)
                 // schedule an event for marking the register as ready
                 computeUnit->registerEvent(w->simdId, physReg,
                                            ii->getOperandSize(i),
-                                           computeUnit->shader->tick_cnt +
+                                           computeUnit->tick_cnt +
                                            computeUnit->shader->ticks(pipeLen),
                                            0);
             }
@@ -204,7 +204,7 @@ VectorRegisterFile::exec(uint64_t dynamic_id, Wavefront *w,
     for (int i = 0; i < regVec.size(); ++i) {
         // mark the destination VGPR as free when the timestamp expires
         computeUnit->registerEvent(w->simdId, regVec[i], operandSize,
-                                   computeUnit->shader->tick_cnt + timestamp +
+                                   computeUnit->tick_cnt + timestamp +
                                    computeUnit->shader->ticks(delay), 0);
     }
 
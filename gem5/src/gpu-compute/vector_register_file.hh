@@ -88,6 +88,15 @@ class VectorRegisterFile : public SimObject
         vgprState->write<T>(regIdx, value, threadId);
     }
 
+    // Access all the lanes of a register at once. Unlike read() and
+    // write(), the accesses aren't traced.
+    template<typename T>
+    T *
+    lanes(int regIdx)
+    {
+        return vgprState->lanes<T>(regIdx);
+    }
+
     uint8_t regBusy(int idx, uint32_t operandSize) const;
     uint8_t regNxtBusy(int idx, uint32_t operandSize) const;
 
@@ -86,6 +86,19 @@ class VecRegisterState
         *p0 = value;
     }
 
+    // All the lanes of a register, as an array of wf_size values
+    template<typename T>
+    T *
+    lanes(int regIdx)
+    {
+        assert(sizeof(T) == 4 || sizeof(T) == 8);
+        if (sizeof(T) == 4) {
+            return (T*)s_reg[regIdx].data();
+        } else {
+            return (T*)d_reg[regIdx].data();
+        }
+    }
+
     // (Single Precision) Vector Register File size.
     int regSize() { return s_reg.size(); }
 
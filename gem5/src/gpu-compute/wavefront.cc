@@ -71,6 +71,9 @@ Wavefront::Wavefront(const Params *p)
     barrierCnt = 0;
     oldBarrierCnt = 0;
     stalledAtBarrier = false;
+    waitingForWakeup = false;
+    parked = false;
+    parkedSeq = 0;
 
     memTraceBusy = 0;
     oldVgprTcnt = 0xffffffffffffffffll;
@@ -159,6 +162,13 @@ Wavefront::start(uint64_t _wf_dyn_id,uint64_t _base_ptr)
     wfDynId = _wf_dyn_id;
     basePtr = _base_ptr;
     status = S_RUNNING;
+    parked = false;
+}
+
+bool
+Wavefront::isParked() const
+{
+    return parked && parkedSeq == computeUnit->wakeupSeq;
 }
 
 bool
@@ -368,6 +378,7 @@ Wavefront::ready(itype_e type)
 
         // Are there in pipe or outstanding memory requests?
         if ((outstandingReqs + memReqsInPipe) > 0) {
+            waitingForWakeup = !memReqsInPipe;
             return 0;
         }
 
@@ -389,6 +400,7 @@ Wavefront::ready(itype_e type)
 
         // Are there in pipe or outstanding memory requests?
         if ((outstandingReqs + memReqsInPipe) > 0) {
+            waitingForWakeup = !memReqsInPipe;
             return 0;
         }
 
@@ -408,6 +420,7 @@ Wavefront::ready(itype_e type)
         }
 
         if (!computeUnit->vrf[simdId]->operandsReady(this, ii)) {
+            waitingForWakeup = true;
             return 0;
         }
         ready_inst = true;
@@ -416,14 +429,17 @@ Wavefront::ready(itype_e type)
         if (ii->isLoad() || ii->isAtomic() || ii->isMemFence()) {
             // Are there in pipe or outstanding global memory write requests?
             if ((outstandingReqsWrGm + wrGmReqsInPipe) > 0) {
+                waitingForWakeup = !wrGmReqsInPipe;
                 return 0;
             }
         }
 
         if (ii->isStore() || ii->isAtomic() || ii->isMemFence()) {
             // Are there in pipe or outstanding global memory read requests?
-            if ((outstandingReqsRdGm + rdGmReqsInPipe) > 0)
+            if ((outstandingReqsRdGm + rdGmReqsInPipe) > 0) {
+                waitingForWakeup = !rdGmReqsInPipe;
                 return 0;
+            }
         }
 
         if (!glbMemIssueRdy) {
@@ -447,6 +463,7 @@ Wavefront::ready(itype_e type)
             return 0;
         }
         if (!computeUnit->vrf[simdId]->operandsReady(this, ii)) {
+            waitingForWakeup = true;
             return 0;
         }
         ready_inst = true;
@@ -454,12 +471,14 @@ Wavefront::ready(itype_e type)
         // Here for Shared memory instruction
         if (ii->isLoad() || ii->isAtomic() || ii->isMemFence()) {
             if ((outstandingReqsWrLm + wrLmReqsInPipe) > 0) {
+                waitingForWakeup = !wrLmReqsInPipe;
                 return 0;
             }
         }
 
         if (ii->isStore() || ii->isAtomic() || ii->isMemFence()) {
             if ((outstandingReqsRdLm + rdLmReqsInPipe) > 0) {
+                waitingForWakeup = !rdLmReqsInPipe;
                 return 0;
             }
         }
@@ -484,6 +503,7 @@ Wavefront::ready(itype_e type)
             return 0;
         }
         if (!computeUnit->vrf[simdId]->operandsReady(this, ii)) {
+            waitingForWakeup = true;
             return 0;
         }
         ready_inst = true;
@@ -524,6 +544,7 @@ Wavefront::ready(itype_e type)
         }
         // are all the operands ready? (RAW, WAW and WAR depedencies met?)
         if (!computeUnit->vrf[simdId]->operandsReady(this, ii)) {
+            waitingForWakeup = true;
             return 0;
         }
         ready_inst = true;
@@ -641,6 +662,10 @@ Wavefront::updateResources()
 void
 Wavefront::exec()
 {
+    // the wave may have been parked on registers reserved by the
+    // instruction it is about to execute
+    parked = false;
+
     // ---- Exit if wavefront is inactive ----------------------------- //
 
     if (status == S_STOPPED || status == S_RETURNING ||
@@ -255,6 +255,20 @@ class Wavefront : public SimObject
     // Flag to stall a wave on barrier
     bool stalledAtBarrier;
 
+    /**
+     * Set by ready() when the oldest instruction waits on a busy register
+     * or on memory requests that already left the pipeline. Neither can
+     * change before the CU wakes up (see ComputeUnit::wakeup()) or the
+     * wave executes its in-flight instruction.
+     */
+    bool waitingForWakeup;
+    /** The wave is parked off the scoreboard until the next wakeup */
+    bool parked;
+    /** Wakeup sequence number of the CU when the wave was parked */
+    uint64_t parkedSeq;
+
+    bool isParked() const;
+
     // a pointer to the fraction of the LDS allocated
     // to this workgroup (thus this wavefront)
     LdsChunk *ldsChunk;
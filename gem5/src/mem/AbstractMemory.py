@@ -67,3 +67,11 @@ class AbstractMemory(ClockedObject):
     # configuration information about the physical memory layout to
     # the kernel, e.g. using ATAG or ACPI
     conf_table_reported = Param.Bool(True, "Report to configuration table")
+
+    # Host NUMA node the backing store of this memory is placed on,
+    # typically the node of the simulation thread servicing the event
+    # queue of the memory. A backing store shared by memories on
+    # different nodes, e.g. interleaved channels, is interleaved
+    # across their nodes.
+    host_numa_node = Param.Int(-1, "Host NUMA node of the backing store " \
+                                   "(-1 for the default host policy)")
@@ -52,3 +52,6 @@ class Bridge(ClockedObject):
     delay = Param.Latency('0ns', "The latency of this bridge")
     ranges = VectorParam.AddrRange([AllMemory],
                                    "Address ranges to pass through the bridge")
+
+    def lookaheadLatency(self):
+        return self.delay.getValue()
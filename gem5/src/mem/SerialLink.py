@@ -63,3 +63,11 @@ class SerialLink(ClockedObject):
         "link. (aka. lane width)")
     link_speed = Param.UInt64(1, "Gb/s Speed of each parallel lane inside the"
         "serial link. (aka. lane speed)")
+    # Packets are serialized back to back, but only handed on at the end
+    # of each window, with one event per window rather than per packet.
+    # This trades up to a window of extra latency for fewer events.
+    batch_window = Param.Latency('0ns', "Window in which packets leaving "
+        "the serial link are batched (0 to send every packet on its own)")
+
+    def lookaheadLatency(self):
+        return self.delay.getValue()
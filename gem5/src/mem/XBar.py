@@ -86,6 +86,21 @@ class BaseXBar(ClockedObject):
     use_default_range = Param.Bool(False, "Perform address mapping for " \
                                        "the default port")
 
+    # When a port that got a retry from a layer does not resend in
+    # zero time, the layer is normally held until the next clock edge
+    # before it retries the next waiting port. With batched retries the
+    # layer moves on to the next waiting port straight away, so a long
+    # list of waiting ports does not cost one release event per port.
+    batch_retries = Param.Bool(False, "Retry the waiting ports of a " \
+                                   "layer in one go")
+
+    # Same bound as the one registered by BaseXBar::init() for
+    # lookahead synchronization.
+    def lookaheadLatency(self):
+        cycles = min(int(self.frontend_latency) + int(self.forward_latency),
+                     int(self.response_latency))
+        return cycles * self.clk_domain.clockPeriod()
+
 class NoncoherentXBar(BaseXBar):
     type = 'NoncoherentXBar'
     cxx_header = "mem/noncoherent_xbar.hh"
@@ -117,8 +132,20 @@ class CoherentXBar(BaseXBar):
     point_of_unification = Param.Bool(False, "Consider this crossbar the " \
                                       "point of unification")
 
+    # Address ranges that no cache above this crossbar keeps copies
+    # of, e.g. device memory. Requests to these ranges are not snooped
+    # and do not touch the snoop filter, as in a non-coherent crossbar.
+    noncoherent_ranges = VectorParam.AddrRange([], "Address ranges that " \
+                                               "are never cached above")
+
     system = Param.System(Parent.any, "System that the crossbar belongs to.")
 
+# Layout of the snoop filter entries. The hash map allocates a node
+# per tracked line, while the set-associative layout keeps the entries
+# in flat arrays, with a small hash map for lines that do not fit in
+# their set.
+class SnoopFilterStorage(Enum): vals = ['hash_map', 'set_associative']
+
 class SnoopFilter(SimObject):
     type = 'SnoopFilter'
     cxx_header = "mem/snoop_filter.hh"
@@ -132,6 +159,12 @@ class SnoopFilter(SimObject):
     # Sanity check on max capacity to track, adjust if needed.
     max_capacity = Param.MemorySize('8MB', "Maximum capacity of snoop filter")
 
+    # The set-associative layout is sized from max_capacity, which
+    # should then be set to the combined capacity of the caches above.
+    storage = Param.SnoopFilterStorage('hash_map',
+                                       "Layout of the snoop filter entries")
+    assoc = Param.Unsigned(8, "Associativity of the set-associative layout")
+
 # We use a coherent crossbar to connect multiple masters to the L2
 # caches. Normally this crossbar would be part of the cache itself.
 class L2XBar(CoherentXBar):
@@ -62,7 +62,7 @@ AbstractMemory::AbstractMemory(const Params *p) :
              (MemBackdoor::Flags)(MemBackdoor::Readable |
                                   MemBackdoor::Writeable)),
     confTableReported(p->conf_table_reported), inAddrMap(p->in_addr_map),
-    kvmMap(p->kvm_map), _system(NULL),
+    kvmMap(p->kvm_map), hostNumaNode(p->host_numa_node), _system(NULL),
     stats(*this)
 {
 }
@@ -126,6 +126,9 @@ class AbstractMemory : public ClockedObject
     // Should KVM map this memory for the guest
     const bool kvmMap;
 
+    // Host NUMA node of the backing store, or -1 if not bound
+    const int hostNumaNode;
+
     std::list<LockedAddr> lockedAddrList;
 
     // helper function for checkLockedAddrs(): we really want to
@@ -308,6 +311,14 @@ class AbstractMemory : public ClockedObject
      */
     bool isKvmMap() const { return kvmMap; }
 
+    /**
+     * Get the host NUMA node the backing store of this memory should
+     * be placed on.
+     *
+     * @return The node, or -1 to leave placement to the host
+     */
+    int getHostNumaNode() const { return hostNumaNode; }
+
     /**
      * Perform an untimed memory access and update all the state
      * (e.g. locked addresses) and statistics accordingly. The packet
@@ -53,6 +53,7 @@
 #include "base/trace.hh"
 #include "debug/Bridge.hh"
 #include "params/Bridge.hh"
+#include "sim/lookahead.hh"
 
 Bridge::BridgeSlavePort::BridgeSlavePort(const std::string& _name,
                                          Bridge& _bridge,
@@ -104,6 +105,19 @@ Bridge::init()
     if (!slavePort.isConnected() || !masterPort.isConnected())
         fatal("Both ports of a bridge must be connected.\n");
 
+    // every packet crossing the bridge is delayed by at least the
+    // bridge latency, whichever side of the bridge the queues are on
+    if (lookaheadSync) {
+        const Tick latency =
+            static_cast<const BridgeParams *>(params())->delay;
+        registerLookahead(slavePort.getPeerEventQueue(), eventQueue(),
+                          latency);
+        registerLookahead(masterPort.getPeerEventQueue(), eventQueue(),
+                          latency);
+        registerLookahead(slavePort.getPeerEventQueue(),
+                          masterPort.getPeerEventQueue(), latency);
+    }
+
     // notify the master side  of our address ranges
     slavePort.sendRangeChange();
 }
@@ -41,7 +41,7 @@
 
 from m5.params import *
 from m5.proxy import *
-from m5.SimObject import SimObject
+from m5.SimObject import SimObject, cxxMethod
 
 from m5.objects.ClockedObject import ClockedObject
 from m5.objects.Compressors import BaseCacheCompressor
@@ -110,6 +110,23 @@ class BaseCache(ClockedObject):
     sequential_access = Param.Bool(False,
         "Whether to access tags and data sequentially")
 
+    checkpoint_contents = Param.Bool(False,
+        "Save the cache contents in checkpoints, so that the cache starts " \
+        "warm when they are restored")
+
+    # In functional warming mode atomic accesses only warm up the tags and
+    # replacement state, keeping the cache write-through, which is much
+    # faster than modelling it while fast-forwarding.
+    functional_warming = Param.Bool(False,
+        "Only warm up the cache contents on atomic accesses")
+    warming = Param.Bool(True,
+        "Whether functional warming starts enabled (see setWarming)")
+
+    @cxxMethod
+    def setWarming(self, enable):
+        """Start or stop warming the cache in functional warming mode"""
+        pass
+
     cpu_side = SlavePort("Upstream port closer to the CPU and/or device")
     mem_side = MasterPort("Downstream port closer to memory")
 
@@ -157,3 +174,25 @@ class NoncoherentCache(BaseCache):
     # writebacks would be unnecessary traffic to the main memory.
     writeback_clean = False
 
+
+class SlicedCache(Cache):
+    type = 'SlicedCache'
+    cxx_header = 'mem/cache/sliced_cache.hh'
+
+    num_slices = Param.Unsigned(8, "Number of slices")
+    slice_hash_bits = Param.Unsigned(0, "Number of address bits above the " \
+        "set index of a slice that are folded to select the slice (0 for " \
+        "all)")
+
+    tags = BaseSetAssoc(indexing_policy=SlicedSetAssociative())
+    slice_indexing = Param.SlicedSetAssociative(Self.tags.indexing_policy,
+        "Indexing policy mapping addresses to slices")
+
+    slice_latencies = VectorParam.Cycles([],
+        "Latency to reach each slice, e.g. the mesh hops to the slice " \
+        "(empty for none)")
+    slice_occupancy = Param.Cycles(1,
+        "Cycles the bank of a slice is busy on each access")
+    mshrs_per_slice = Param.Unsigned(0,
+        "Number of MSHRs of each slice (0 to only limit the total number " \
+        "of MSHRs)")
@@ -48,9 +48,17 @@
 
 #include "mem/cache/base.hh"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
 #include "base/compiler.hh"
 #include "base/logging.hh"
 #include "debug/Cache.hh"
+#include "debug/Checkpoint.hh"
 #include "debug/CacheComp.hh"
 #include "debug/CachePort.hh"
 #include "debug/CacheRepl.hh"
@@ -98,6 +106,9 @@ BaseCache::BaseCache(const BaseCacheParams *p, unsigned blk_size)
       fillLatency(p->data_latency),
       responseLatency(p->response_latency),
       sequentialAccess(p->sequential_access),
+      checkpointContents(p->checkpoint_contents),
+      functionalWarming(p->functional_warming),
+      warming(p->warming),
       numTarget(p->tgts_per_mshr),
       forwardSnoops(true),
       clusivity(p->clusivity),
@@ -539,9 +550,135 @@ BaseCache::recvTimingResp(PacketPtr pkt)
 }
 
 
+namespace {
+
+/**
+ * Sender state marking the writes that a cache in functional warming mode
+ * already accounted for.
+ */
+struct WarmedWriteState : public Packet::SenderState
+{
+};
+
+} // anonymous namespace
+
+CacheBlk *
+BaseCache::warmingFill(PacketPtr pkt, PacketList &writebacks)
+{
+    // Fetch the whole line in shared state, as a clean miss would, so
+    // that the caches below warm up on our misses only
+    Packet fill_pkt(pkt->req, MemCmd::ReadSharedReq, blkSize);
+    fill_pkt.allocate();
+    memSidePort.sendAtomic(&fill_pkt);
+    assert(fill_pkt.isResponse());
+
+    CacheBlk *blk = allocateBlock(&fill_pkt, writebacks);
+    if (blk) {
+        blk->status |= BlkReadable;
+        blk->whenReady = curTick();
+        std::memcpy(blk->data, fill_pkt.getConstPtr<uint8_t>(), blkSize);
+    }
+    return blk;
+}
+
+Tick
+BaseCache::warmingAccess(PacketPtr pkt)
+{
+    const Addr addr = pkt->getAddr();
+    const bool is_secure = pkt->isSecure();
+    PacketList writebacks;
+    Tick lat = 0;
+
+    const bool cacheable = !pkt->req->isUncacheable() &&
+        !pkt->req->isCacheMaintenance() && !pkt->isLLSC();
+    const bool plain_read = warming && cacheable && pkt->isRead() &&
+        !pkt->isWrite() && !pkt->needsWritable();
+    const bool plain_write = warming && cacheable &&
+        (pkt->cmd == MemCmd::WriteReq || pkt->cmd == MemCmd::WriteLineReq);
+    const bool eviction = cacheable && (pkt->cmd == MemCmd::CleanEvict ||
+        pkt->cmd == MemCmd::WritebackClean);
+
+    if (plain_read) {
+        Cycles tag_lat;
+        CacheBlk *blk = tags->accessBlock(addr, is_secure, tag_lat);
+        if (!blk) {
+            blk = warmingFill(pkt, writebacks);
+        }
+
+        if (blk && blk->isReadable()) {
+            pkt->setDataFromBlock(blk->data, blkSize);
+            if (pkt->fromCache() && !blk->isWritable()) {
+                pkt->setHasSharers();
+            }
+        } else {
+            lat = memSidePort.sendAtomic(pkt);
+        }
+    } else if (plain_write) {
+        // Writes from a cache above that is warming up were already
+        // accounted for there
+        CacheBlk *blk;
+        const bool warmed = pkt->findNextSenderState<WarmedWriteState>();
+        if (warmed) {
+            blk = tags->findBlock(addr, is_secure);
+        } else {
+            Cycles tag_lat;
+            blk = tags->accessBlock(addr, is_secure, tag_lat);
+            if (!blk) {
+                blk = warmingFill(pkt, writebacks);
+            }
+        }
+
+        // The line is always written through, so the data below is up
+        // to date, and any other copy is invalidated on the way
+        if (warmed) {
+            lat = memSidePort.sendAtomic(pkt);
+        } else {
+            WarmedWriteState warmed_state;
+            pkt->pushSenderState(&warmed_state);
+            lat = memSidePort.sendAtomic(pkt);
+            pkt->popSenderState();
+        }
+
+        if (blk) {
+            pkt->writeDataToBlock(blk->data, blkSize);
+        }
+    } else if (eviction) {
+        // The eviction of a line we also hold doesn't need to go any
+        // further, as snoop filters below still see us as a holder
+        if (!tags->findBlock(addr, is_secure)) {
+            lat = memSidePort.sendAtomic(pkt);
+        }
+    } else {
+        // Anything that could make our copy stale drops it first,
+        // writing it back if it was dirtied before warming started
+        if (pkt->isWrite() || pkt->isInvalidate() || pkt->needsWritable()) {
+            CacheBlk *blk = tags->findBlock(addr, is_secure);
+            if (blk) {
+                evictBlock(blk, writebacks);
+                doWritebacksAtomic(writebacks);
+            }
+        }
+        lat = memSidePort.sendAtomic(pkt);
+    }
+
+    // Evictions caused by the allocations, after the fill has been seen
+    // below
+    doWritebacksAtomic(writebacks);
+
+    if (pkt->needsResponse() && !pkt->isResponse()) {
+        pkt->makeAtomicResponse();
+    }
+
+    return lat;
+}
+
 Tick
 BaseCache::recvAtomic(PacketPtr pkt)
 {
+    if (functionalWarming) {
+        return warmingAccess(pkt);
+    }
+
     // should assert here that there are no outstanding MSHRs or
     // writebacks... that would mean that someone used an atomic
     // access in timing mode
@@ -619,6 +756,60 @@ BaseCache::recvAtomic(PacketPtr pkt)
     return lat * clockPeriod();
 }
 
+Tick
+BaseCache::recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor)
+{
+    const Tick lat = recvAtomic(pkt);
+
+    // only plain accesses within a single block get a backdoor, and
+    // secure blocks are left out as the backdoor does not carry the
+    // security state. Warming caches hand out none, as accesses through
+    // a backdoor would not update the replacement state
+    if (functionalWarming || pkt->req->isUncacheable() ||
+        pkt->req->isCacheMaintenance() || pkt->isLLSC() || pkt->isSecure() ||
+        pkt->getOffset(blkSize) + pkt->getSize() > blkSize) {
+        return lat;
+    }
+
+    CacheBlk *blk = tags->findBlock(pkt->getAddr(), pkt->isSecure());
+    if (!blk || !blk->isValid() || !blk->isReadable())
+        return lat;
+
+    auto &bd = backdoors[blk];
+    if (!bd) {
+        bd.reset(new MemBackdoor(RangeSize(regenerateBlkAddr(blk), blkSize),
+                                 blk->data, MemBackdoor::Readable));
+    }
+
+    // the state of the block can only have improved since the
+    // backdoor was handed out, as any downgrade invalidates it
+    if (!isReadOnly && blk->isWritable() && blk->isDirty())
+        bd->writeable(true);
+
+    DPRINTF(Cache, "%s: backdoor %s (%s) for %s\n", __func__,
+            bd->range().to_string(), bd->writeable() ? "rw" : "ro",
+            blk->print());
+
+    backdoor = bd.get();
+    return lat;
+}
+
+void
+BaseCache::doInvalidateBackdoor(const CacheBlk *blk)
+{
+    auto it = backdoors.find(blk);
+    if (it == backdoors.end())
+        return;
+
+    DPRINTF(Cache, "%s: invalidating backdoor %s\n", __func__,
+            it->second->range().to_string());
+
+    // keep the backdoor alive until all its holders have dropped it
+    std::unique_ptr<MemBackdoor> bd = std::move(it->second);
+    backdoors.erase(it);
+    bd->invalidate();
+}
+
 void
 BaseCache::functionalAccess(PacketPtr pkt, bool from_cpu_side)
 {
@@ -1037,6 +1228,13 @@ BaseCache::access(PacketPtr pkt, CacheBlk *&blk, Cycles &lat,
     DPRINTF(Cache, "%s for %s %s\n", __func__, pkt->print(),
             blk ? "hit " + blk->print() : "miss");
 
+    if (blk && (pkt->fromCache() || pkt->req->isCacheMaintenance())) {
+        // a cache above may end up with its own copy of the block, or
+        // the block may change state, neither of which a backdoor
+        // would see
+        invalidateBackdoor(blk);
+    }
+
     if (pkt->req->isCacheMaintenance()) {
         // A cache maintenance operation is always forwarded to the
         // memory below even if the block is found in dirty state.
@@ -1489,6 +1687,8 @@ BaseCache::allocateBlock(const PacketPtr pkt, PacketList &writebacks)
 void
 BaseCache::invalidateBlock(CacheBlk *blk)
 {
+    invalidateBackdoor(blk);
+
     // If handling a block present in the Tags, let it do its invalidation
     // process, which will update stats and invalidate the block itself
     if (blk != tempBlock) {
@@ -1534,6 +1734,7 @@ BaseCache::writebackBlk(CacheBlk *blk)
     if (blk->isWritable()) {
         // not asserting shared means we pass the block in modified
         // state, mark our own block non-writeable
+        invalidateBackdoor(blk);
         blk->status &= ~BlkWritable;
     } else {
         // we are in the Owned state, tell the receiver
@@ -1579,6 +1780,7 @@ BaseCache::writecleanBlk(CacheBlk *blk, Request::Flags dest, PacketId id)
     if (blk->isWritable()) {
         // not asserting shared means we pass the block in modified
         // state, mark our own block non-writeable
+        invalidateBackdoor(blk);
         blk->status &= ~BlkWritable;
     } else {
         // we are in the Owned state, tell the receiver
@@ -1644,6 +1846,8 @@ BaseCache::writebackVisitor(CacheBlk &blk)
 
         memSidePort.sendFunctional(&packet);
 
+        // writes through a backdoor would not mark the block dirty
+        invalidateBackdoor(&blk);
         blk.status &= ~BlkDirty;
     }
 }
@@ -1805,24 +2009,208 @@ BaseCache::sendWriteQueuePacket(WriteQueueEntry* wq_entry)
     }
 }
 
+void
+BaseCache::serializeContents(CheckpointOut &cp) const
+{
+    unsigned num_blocks = 0;
+    std::vector<uint64_t> repl_state;
+    std::vector<unsigned> blk_index;
+    std::vector<Addr> blk_addr;
+    std::vector<CacheBlk::State> blk_status;
+    std::vector<int> blk_master;
+    std::vector<uint32_t> blk_task;
+    std::vector<unsigned> blk_ref_count;
+    std::vector<uint8_t> blk_data;
+
+    // The replacement state of invalid blocks is also saved, as they take
+    // part in replacement decisions
+    tags->forEachBlk([&](CacheBlk &blk) {
+        repl_state.push_back(tags->getReplacementState(&blk));
+        if (blk.isValid()) {
+            blk_index.push_back(num_blocks);
+            blk_addr.push_back(tags->regenerateBlkAddr(&blk));
+            blk_status.push_back(blk.status);
+            blk_master.push_back(blk.srcMasterId);
+            blk_task.push_back(blk.task_id);
+            blk_ref_count.push_back(blk.refCount);
+            blk_data.insert(blk_data.end(), blk.data, blk.data + blkSize);
+        }
+        num_blocks++;
+    });
+
+    // Master IDs depend on the order in which the masters registered, so
+    // save their names to map them to the IDs of the restored system
+    std::vector<std::string> masters;
+    for (MasterID id = 0; id < system->maxMasters(); id++)
+        masters.push_back(system->getMasterName(id));
+
+    DPRINTF(Checkpoint, "Serializing %d valid blocks of %s\n",
+            blk_index.size(), name());
+
+    SERIALIZE_SCALAR(num_blocks);
+    SERIALIZE_SCALAR(blkSize);
+    SERIALIZE_CONTAINER(repl_state);
+    SERIALIZE_CONTAINER(blk_index);
+    SERIALIZE_CONTAINER(blk_addr);
+    SERIALIZE_CONTAINER(blk_status);
+    SERIALIZE_CONTAINER(blk_master);
+    SERIALIZE_CONTAINER(blk_task);
+    SERIALIZE_CONTAINER(blk_ref_count);
+    SERIALIZE_CONTAINER(masters);
+
+    // The data is kept in its own file, as memories do
+    std::string filename = name() + ".blocks";
+    SERIALIZE_SCALAR(filename);
+
+    const std::string filepath = CheckpointIn::dir() + "/" + filename;
+    gzFile data_file = gzopen(filepath.c_str(), "wb");
+    if (data_file == NULL)
+        fatal("Can't open cache checkpoint file '%s'\n", filename);
+
+    if (!blk_data.empty() &&
+        gzwrite(data_file, blk_data.data(), blk_data.size()) !=
+        (int)blk_data.size()) {
+        fatal("Write failed on cache checkpoint file '%s'\n", filename);
+    }
+
+    if (gzclose(data_file))
+        fatal("Close failed on cache checkpoint file '%s'\n", filename);
+}
+
+void
+BaseCache::unserializeContents(CheckpointIn &cp)
+{
+    // Visit order of the blocks in the restored cache
+    std::vector<CacheBlk*> blks;
+    tags->forEachBlk([&blks](CacheBlk &blk) { blks.push_back(&blk); });
+
+    unsigned num_blocks;
+    UNSERIALIZE_SCALAR(num_blocks);
+    unsigned blk_size;
+    paramIn(cp, "blkSize", blk_size);
+    fatal_if(num_blocks != blks.size() || blk_size != blkSize,
+             "%s: The checkpoint holds %d blocks of %d bytes, but the cache "
+             "has %d blocks of %d bytes.\n", name(), num_blocks, blk_size,
+             blks.size(), blkSize);
+
+    std::vector<uint64_t> repl_state;
+    std::vector<unsigned> blk_index;
+    std::vector<Addr> blk_addr;
+    std::vector<CacheBlk::State> blk_status;
+    std::vector<int> blk_master;
+    std::vector<uint32_t> blk_task;
+    std::vector<unsigned> blk_ref_count;
+    std::vector<std::string> masters;
+    UNSERIALIZE_CONTAINER(repl_state);
+    UNSERIALIZE_CONTAINER(blk_index);
+    UNSERIALIZE_CONTAINER(blk_addr);
+    UNSERIALIZE_CONTAINER(blk_status);
+    UNSERIALIZE_CONTAINER(blk_master);
+    UNSERIALIZE_CONTAINER(blk_task);
+    UNSERIALIZE_CONTAINER(blk_ref_count);
+    UNSERIALIZE_CONTAINER(masters);
+
+    std::string filename;
+    UNSERIALIZE_SCALAR(filename);
+    const std::string filepath = cp.cptDir + "/" + filename;
+
+    std::vector<uint8_t> blk_data(blk_index.size() * blkSize);
+    gzFile data_file = gzopen(filepath.c_str(), "rb");
+    if (data_file == NULL)
+        fatal("Can't open cache checkpoint file '%s'\n", filename);
+    if (!blk_data.empty() &&
+        gzread(data_file, blk_data.data(), blk_data.size()) !=
+        (int)blk_data.size()) {
+        fatal("Read failed on cache checkpoint file '%s'\n", filename);
+    }
+    gzclose(data_file);
+
+    DPRINTF(Checkpoint, "Unserializing %d valid blocks of %s\n",
+            blk_index.size(), name());
+
+    // Map the saved master IDs to the ones of this system. Blocks brought
+    // by masters that no longer exist are attributed to writebacks
+    const MasterID wb_master_id = Request::wbMasterId;
+    std::vector<MasterID> master_ids;
+    for (const auto &master : masters) {
+        const MasterID id = system->lookupMasterId(master);
+        master_ids.push_back(id == Request::invldMasterId ?
+                             wb_master_id : id);
+    }
+
+    for (std::size_t i = 0; i < blk_index.size(); i++) {
+        CacheBlk *blk = blks[blk_index[i]];
+        const uint8_t *data = blk_data.data() + i * blkSize;
+        assert(!blk->isValid());
+
+        // Fill the block as allocateBlock() would, but into the saved
+        // location
+        const bool is_secure = blk_status[i] & BlkSecure;
+        const MasterID master_id = blk_master[i] >= 0 &&
+            blk_master[i] < master_ids.size() ?
+            master_ids[blk_master[i]] : wb_master_id;
+        RequestPtr req = std::make_shared<Request>(
+            blk_addr[i], blkSize, 0, master_id);
+        if (is_secure)
+            req->setFlags(Request::SECURE);
+        req->taskId(blk_task[i]);
+        Packet pkt(req, MemCmd::ReadResp);
+
+        if (compressor) {
+            std::size_t blk_size_bits = blkSize*8;
+            Cycles compression_lat = Cycles(0);
+            Cycles decompression_lat = Cycles(0);
+            compressor->compress(reinterpret_cast<const uint64_t*>(data),
+                                 compression_lat, decompression_lat,
+                                 blk_size_bits);
+            compressor->setSizeBits(blk, blk_size_bits);
+            compressor->setDecompressionLatency(blk, decompression_lat);
+        }
+
+        tags->insertBlock(&pkt, blk);
+
+        // Restore the coherence state, leaving the bits managed by the
+        // tags untouched
+        blk->status |= blk_status[i] &
+            (BlkWritable | BlkReadable | BlkDirty | BlkHWPrefetched);
+        blk->refCount = blk_ref_count[i];
+        blk->whenReady = curTick();
+        std::memcpy(blk->data, data, blkSize);
+    }
+
+    // Inserting the blocks reset their replacement state, so restore it
+    // once all of them are in place, in increasing order
+    std::vector<unsigned> order(blks.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&repl_state](unsigned a, unsigned b)
+                     { return repl_state[a] < repl_state[b]; });
+    for (const auto idx : order)
+        tags->setReplacementState(blks[idx], repl_state[idx]);
+}
+
 void
 BaseCache::serialize(CheckpointOut &cp) const
 {
     bool dirty(isDirty());
 
-    if (dirty) {
+    if (dirty && !checkpointContents) {
         warn("*** The cache still contains dirty data. ***\n");
         warn("    Make sure to drain the system using the correct flags.\n");
         warn("    This checkpoint will not restore correctly " \
              "and dirty data in the cache will be lost!\n");
     }
 
-    // Since we don't checkpoint the data in the cache, any dirty data
+    // Unless the contents of the cache are checkpointed, any dirty data
     // will be lost when restoring from a checkpoint of a system that
     // wasn't drained properly. Flag the checkpoint as invalid if the
     // cache contains dirty data.
-    bool bad_checkpoint(dirty);
+    bool bad_checkpoint(dirty && !checkpointContents);
     SERIALIZE_SCALAR(bad_checkpoint);
+
+    SERIALIZE_SCALAR(checkpointContents);
+    if (checkpointContents)
+        serializeContents(cp);
 }
 
 void
@@ -1833,8 +2221,16 @@ BaseCache::unserialize(CheckpointIn &cp)
     if (bad_checkpoint) {
         fatal("Restoring from checkpoints with dirty caches is not "
               "supported in the classic memory system. Please remove any "
-              "caches or drain them properly before taking checkpoints.\n");
+              "caches or drain them properly before taking checkpoints, "
+              "or set checkpoint_contents.\n");
     }
+
+    // The contents are restored whenever the checkpoint has them, as they
+    // may hold dirty data
+    bool has_contents = false;
+    optParamIn(cp, "checkpointContents", has_contents, false);
+    if (has_contents)
+        unserializeContents(cp);
 }
 
 
@@ -2366,6 +2762,18 @@ BaseCache::CpuSidePort::recvAtomic(PacketPtr pkt)
     }
 }
 
+Tick
+BaseCache::CpuSidePort::recvAtomicBackdoor(PacketPtr pkt,
+                                           MemBackdoorPtr &backdoor)
+{
+    if (cache->system->bypassCaches()) {
+        // Forward the request if the system is in cache bypass mode.
+        return cache->memSidePort.sendAtomicBackdoor(pkt, backdoor);
+    } else {
+        return cache->recvAtomicBackdoor(pkt, backdoor);
+    }
+}
+
 void
 BaseCache::CpuSidePort::recvFunctional(PacketPtr pkt)
 {
@@ -54,7 +54,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "base/addr_range.hh"
 #include "base/statistics.hh"
@@ -63,6 +65,7 @@
 #include "debug/Cache.hh"
 #include "debug/CachePort.hh"
 #include "enums/Clusivity.hh"
+#include "mem/backdoor.hh"
 #include "mem/cache/cache_blk.hh"
 #include "mem/cache/compressors/base.hh"
 #include "mem/cache/mshr_queue.hh"
@@ -298,6 +301,9 @@ class BaseCache : public ClockedObject
 
         virtual Tick recvAtomic(PacketPtr pkt) override;
 
+        virtual Tick recvAtomicBackdoor(PacketPtr pkt,
+                                        MemBackdoorPtr &backdoor) override;
+
         virtual void recvFunctional(PacketPtr pkt) override;
 
         virtual AddrRangeList getAddrRanges() const override;
@@ -362,6 +368,16 @@ class BaseCache : public ClockedObject
      */
     TempCacheBlk *tempBlock;
 
+    /**
+     * Backdoors into the data of blocks in this cache, indexed by the
+     * block they cover. A backdoor is only valid as long as the block
+     * keeps its coherence state, so it is invalidated whenever the
+     * block is invalidated, loses its writable permission, or is
+     * handed to a cache above.
+     */
+    std::unordered_map<const CacheBlk *,
+                       std::unique_ptr<MemBackdoor>> backdoors;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -562,6 +578,67 @@ class BaseCache : public ClockedObject
      */
     virtual Tick recvAtomic(PacketPtr pkt);
 
+    /**
+     * Performs an atomic access in functional warming mode. The cache is
+     * kept write-through and clean, so that the data below is always up
+     * to date: reads are satisfied by the cache, and misses fetch the
+     * line in shared state, while writes update the cached copy and are
+     * always sent below. Only the tags and replacement state are warmed
+     * up; no latency is modelled and the cache stats are not updated.
+     * Accesses that need more care (uncacheable, LL/SC, atomic
+     * operations, requests for ownership, ...) drop the cached copy and
+     * go below unchanged.
+     *
+     * Writes are marked on their way down, so that lower level caches
+     * update their copy without treating the write as an access of their
+     * own, as they would only see the eventual writeback.
+     *
+     * @param pkt The request to perform.
+     * @return The number of ticks required for the access.
+     */
+    Tick warmingAccess(PacketPtr pkt);
+
+    /**
+     * Fetch the line of a request from below in functional warming mode
+     * and allocate it.
+     *
+     * @param pkt The request that missed.
+     * @param writebacks List for any evictions caused by the allocation.
+     * @return The allocated block, or nullptr if it couldn't be allocated.
+     */
+    CacheBlk *warmingFill(PacketPtr pkt, PacketList &writebacks);
+
+    /**
+     * Performs the access specified by the request, and hands out a
+     * backdoor to the block if the access leaves it in this cache.
+     *
+     * The backdoor points at the data of the block in this cache. It
+     * is readable as long as the block is valid, and is only
+     * writeable if the block is already dirty and writable, since
+     * writes through the backdoor bypass the dirty bit.
+     *
+     * @param pkt The request to perform.
+     * @param backdoor Set to the backdoor to the block, if any.
+     * @return The number of ticks required for the access.
+     */
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
+    /**
+     * Invalidate any backdoor handed out for a block. Must be called
+     * before the state of a block changes in a way that makes direct
+     * accesses to its data unsafe.
+     *
+     * @param blk Block that is about to change state
+     */
+    void
+    invalidateBackdoor(const CacheBlk *blk)
+    {
+        if (!backdoors.empty())
+            doInvalidateBackdoor(blk);
+    }
+
+    void doInvalidateBackdoor(const CacheBlk *blk);
+
     /**
      * Snoop for the provided request in the cache and return the estimated
      * time taken.
@@ -864,6 +941,23 @@ class BaseCache : public ClockedObject
      */
     const bool sequentialAccess;
 
+    /**
+     * Whether the contents of the cache are saved in checkpoints.
+     */
+    const bool checkpointContents;
+
+    /**
+     * Whether atomic accesses only warm the cache up.
+     * @sa warmingAccess()
+     */
+    const bool functionalWarming;
+
+    /**
+     * Whether functional warming currently updates the cache, or lets
+     * the accesses go around it.
+     */
+    bool warming;
+
     /** The number of targets for each MSHR. */
     const int numTarget;
 
@@ -1086,7 +1180,17 @@ class BaseCache : public ClockedObject
 
     const AddrRangeList &getAddrRanges() const { return addrRanges; }
 
-    MSHR *allocateMissBuffer(PacketPtr pkt, Tick time, bool sched_send = true)
+    /**
+     * Start or stop warming the cache up in functional warming mode, e.g.
+     * to only warm it during the last instructions before switching to a
+     * detailed CPU. While stopped, atomic accesses go around the cache.
+     *
+     * @param enable Whether the cache should be warmed up.
+     */
+    void setWarming(bool enable) { warming = enable; }
+
+    virtual MSHR *allocateMissBuffer(PacketPtr pkt, Tick time,
+                                     bool sched_send = true)
     {
         MSHR *mshr = mshrQueue.allocate(pkt->getBlockAddr(blkSize), blkSize,
                                         pkt, time, order++,
@@ -1267,10 +1371,32 @@ class BaseCache : public ClockedObject
      */
     bool sendWriteQueuePacket(WriteQueueEntry* wq_entry);
 
+    /**
+     * Save the contents of the cache: the address, coherence state and
+     * data of the valid blocks, and the replacement state of all blocks.
+     * The blocks are identified by the order in which the tags visit
+     * them, so the checkpoint can only be restored into a cache with the
+     * same organization. The contents don't depend on the memory mode,
+     * so a checkpoint taken in atomic mode can be restored in timing mode.
+     *
+     * @param cp The checkpoint.
+     */
+    void serializeContents(CheckpointOut &cp) const;
+
+    /**
+     * Restore the contents saved by serializeContents(). Blocks are
+     * inserted as if they were filled, and the replacement state is
+     * restored afterwards.
+     *
+     * @param cp The checkpoint.
+     */
+    void unserializeContents(CheckpointIn &cp);
+
     /**
      * Serialize the state of the caches
      *
-     * We currently don't support checkpointing cache state, so this panics.
+     * Unless checkpoint_contents is set, only a flag telling whether the
+     * cache held dirty data, which is lost, is saved.
      */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -879,6 +879,7 @@ Cache::serviceMSHRTargets(MSHR *mshr, const PacketPtr pkt, CacheBlk *blk)
         if (is_invalidate || mshr->hasPostInvalidate()) {
             invalidateBlock(blk);
         } else if (mshr->hasPostDowngrade()) {
+            invalidateBackdoor(blk);
             blk->status &= ~BlkWritable;
         }
     }
@@ -1116,8 +1117,10 @@ Cache::handleSnoop(PacketPtr pkt, CacheBlk *blk, bool is_timing,
         // which means we go from Modified to Owned (and will respond
         // below), remain in Owned (and will respond below), from
         // Exclusive to Shared, or remain in Shared
-        if (!pkt->req->isUncacheable())
+        if (!pkt->req->isUncacheable()) {
+            invalidateBackdoor(blk);
             blk->status &= ~BlkWritable;
+        }
         DPRINTF(Cache, "new state is %s\n", blk->print());
     }
 
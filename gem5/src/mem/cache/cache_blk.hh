@@ -125,6 +125,15 @@ class CacheBlk : public ReplaceableEntry
      */
     Tick tickInserted;
 
+    /**
+     * Neighbours of the block in the age list of its task, and the age
+     * bucket the block is in. Only meaningful if the block is valid, and
+     * only used by the tags to keep the age stats up to date.
+     */
+    CacheBlk *ageYounger;
+    CacheBlk *ageOlder;
+    uint8_t ageBucket;
+
   protected:
     /**
      * Represents that the indicated thread context has a "lock" on
@@ -168,7 +177,8 @@ class CacheBlk : public ReplaceableEntry
     std::list<Lock> lockList;
 
   public:
-    CacheBlk() : data(nullptr), tickInserted(0)
+    CacheBlk() : data(nullptr), tickInserted(0), ageYounger(nullptr),
+                 ageOlder(nullptr), ageBucket(0)
     {
         invalidate();
     }
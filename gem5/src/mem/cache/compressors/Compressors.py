@@ -36,6 +36,8 @@ class BaseCacheCompressor(SimObject):
     cxx_header = "mem/cache/compressors/base.hh"
 
     block_size = Param.Int(Parent.cache_line_size, "Block size in bytes")
+    result_cache_size = Param.Unsigned(0, "Number of compression results " \
+        "remembered by line contents (0 disables the result cache)")
 
 class BDI(BaseCacheCompressor):
     type = 'BDI'
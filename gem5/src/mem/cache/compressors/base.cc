@@ -36,6 +36,7 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <cstring>
 #include <string>
 
 #include "debug/CacheComp.hh"
@@ -73,17 +74,55 @@ BaseCacheCompressor::CompressionData::getSize() const
 }
 
 BaseCacheCompressor::BaseCacheCompressor(const Params *p)
-    : SimObject(p), blkSize(p->block_size)
+    : SimObject(p), blkSize(p->block_size),
+      resultCache(p->result_cache_size)
 {
 }
 
+uint64_t
+BaseCacheCompressor::hashLine(const uint64_t* data) const
+{
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (std::size_t i = 0; i < blkSize/8; i++) {
+        hash = (hash ^ data[i]) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+    }
+    return hash ? hash : 1;
+}
+
 void
 BaseCacheCompressor::compress(const uint64_t* data, Cycles& comp_lat,
                               Cycles& decomp_lat, std::size_t& comp_size_bits)
 {
-    // Apply compression
-    std::unique_ptr<CompressionData> comp_data =
-        compress(data, comp_lat, decomp_lat);
+    std::shared_ptr<const CompressionData> comp_data;
+
+    // Look for a previous compression of the same contents
+    ResultCacheEntry* entry = nullptr;
+    uint64_t hash = 0;
+    if (!resultCache.empty()) {
+        hash = hashLine(data);
+        entry = &resultCache[hash % resultCache.size()];
+        if (entry->hash == hash &&
+            !std::memcmp(entry->line.data(), data, blkSize)) {
+            comp_data = entry->compData;
+            comp_lat = entry->compLat;
+            decomp_lat = entry->decompLat;
+            resultCacheHits++;
+        }
+    }
+
+    if (!comp_data) {
+        // Apply compression
+        comp_data = compress(data, comp_lat, decomp_lat);
+
+        if (entry) {
+            entry->hash = hash;
+            entry->line.assign(data, data + blkSize/8);
+            entry->compData = comp_data;
+            entry->compLat = comp_lat;
+            entry->decompLat = decomp_lat;
+        }
+    }
 
     // If we are in debug mode apply decompression just after the compression.
     // If the results do not match, we've got an error
@@ -103,6 +142,7 @@ BaseCacheCompressor::compress(const uint64_t* data, Cycles& comp_lat,
 
     // Update stats
     compressionSize[std::ceil(std::log2(comp_size_bits))]++;
+    updateStats(comp_data.get());
 
     // Print debug information
     DPRINTF(CacheComp, "Compressed cache line from %d to %d bits. " \
@@ -165,5 +205,10 @@ BaseCacheCompressor::regStats()
         compressionSize.subdesc(i, "Number of blocks that compressed to fit " \
                                    "in " + std::to_string(1 << i) + " bits");
     }
+
+    resultCacheHits
+        .name(name() + ".result_cache_hits")
+        .desc("Number of compressions found in the result cache")
+        ;
 }
 
@@ -39,6 +39,8 @@
 #define __MEM_CACHE_COMPRESSORS_BASE_HH__
 
 #include <cstdint>
+#include <memory>
+#include <vector>
 
 #include "base/statistics.hh"
 #include "base/types.hh"
@@ -72,6 +74,9 @@ class BaseCacheCompressor : public SimObject {
     /** Number of blocks that were compressed to this power of two size. */
     Stats::Vector compressionSize;
 
+    /** Number of compressions whose result was found in the result cache. */
+    Stats::Scalar resultCacheHits;
+
     /**
      * @}
      */
@@ -100,6 +105,52 @@ class BaseCacheCompressor : public SimObject {
     virtual void decompress(const CompressionData* comp_data,
                               uint64_t* cache_line) = 0;
 
+    /**
+     * Update the compressor specific stats with the result of a
+     * compression. It is called for every compressed line, including the
+     * ones whose result was found in the result cache, so compressors must
+     * not update these stats within compress().
+     *
+     * @param comp_data Compressed cache line.
+     */
+    virtual void updateStats(const CompressionData* comp_data) {}
+
+  private:
+    /**
+     * An entry of the result cache. Lines with identical contents always
+     * compress to the same result, so workloads that write the same data
+     * over and over (zeroed pages, memsets) don't need to run the
+     * compression algorithm again.
+     */
+    struct ResultCacheEntry
+    {
+        /** Hash of the line contents, 0 if the entry is invalid. */
+        uint64_t hash;
+
+        /** Contents of the line, to tell hash collisions apart. */
+        std::vector<uint64_t> line;
+
+        /** The result of the compression. */
+        std::shared_ptr<const CompressionData> compData;
+
+        /** Latencies of the compression. */
+        Cycles compLat;
+        Cycles decompLat;
+
+        ResultCacheEntry() : hash(0) {}
+    };
+
+    /** Direct-mapped cache of compression results, indexed by hash. */
+    std::vector<ResultCacheEntry> resultCache;
+
+    /**
+     * Hash the contents of a cache line. Never returns 0.
+     *
+     * @param data The cache line.
+     * @return The hash of the line contents.
+     */
+    uint64_t hashLine(const uint64_t* data) const;
+
   public:
     /** Convenience typedef. */
      typedef BaseCacheCompressorParams Params;
@@ -317,10 +317,53 @@ BDI::isSameValuePackable(const uint64_t* data) const
                            {return entry == rep_value;});
 }
 
+template <class TB, class TD>
+bool
+BDI::fitsBaseDelta(const uint64_t* data) const
+{
+    static_assert(std::is_unsigned<TB>::value, "Bases must be unsigned");
+
+    // A value v fits a delta from base b iff (v - b) is within
+    // [-limit, limit], i.e. iff (v - b + limit) <= 2 * limit when computed
+    // with the (wrapping) arithmetic of the base type
+    const TB limit = ULLONG_MAX>>((BYTES_PER_QWORD-sizeof(TD))*CHAR_BIT+1);
+    const TB range = 2 * limit;
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(data);
+    const std::size_t num_values = blkSize/sizeof(TB);
+
+    // The explicit base is the first value that does not fit the zero base
+    std::size_t i = 0;
+    TB base = 0;
+    for (; i < num_values; i++) {
+        std::memcpy(&base, bytes + i*sizeof(TB), sizeof(TB));
+        if (TB(base + limit) > range) {
+            break;
+        }
+    }
+
+    // Every following value must fit one of the two bases
+    bool fits = true;
+    for (std::size_t j = i + 1; j < num_values; j++) {
+        TB value;
+        std::memcpy(&value, bytes + j*sizeof(TB), sizeof(TB));
+        fits &= (TB(value + limit) <= range) |
+                (TB(value - base + limit) <= range);
+    }
+    return fits;
+}
+
 template <class TB, class TD>
 std::unique_ptr<BDI::BDICompData>
 BDI::tryCompress(const uint64_t* data, const uint8_t encoding) const
 {
+    // Most lines are not compressible with most encodings, so reject them
+    // before allocating the compressed data
+    static_assert(BDI_DEFAULT_MAX_NUM_BASES == 2,
+                  "fitsBaseDelta() assumes a single explicit base");
+    if (!fitsBaseDelta<TB, TD>(data)) {
+        return std::unique_ptr<BDICompData>{};
+    }
+
     // Instantiate compressor
     auto temp_data = std::unique_ptr<BDICompDataBaseDelta<TB, TD>>(
         new BDICompDataBaseDelta<TB, TD>(encoding, blkSize));
@@ -437,9 +480,6 @@ BDI::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
         comp_lat = Cycles(blkSize/base_delta_ratio);
     }
 
-    // Update stats
-    encodingStats[bdi_data->getEncoding()]++;
-
     // Pack compression results (1 extra cycle)
     comp_lat += Cycles(1);
 
@@ -453,6 +493,12 @@ BDI::compress(const uint64_t* data, Cycles& comp_lat, Cycles& decomp_lat)
     return std::move(bdi_data);
 }
 
+void
+BDI::updateStats(const CompressionData* comp_data)
+{
+    encodingStats[static_cast<const BDICompData*>(comp_data)->getEncoding()]++;
+}
+
 void
 BDI::regStats()
 {
@@ -119,6 +119,20 @@ class BDI : public BaseCacheCompressor
      */
     bool isSameValuePackable(const uint64_t* data) const;
 
+    /**
+     * Check if the cache line can be encoded with the implicit zero base
+     * and one explicit base, without building the compressed data. The
+     * checks are branch-free over the values of the line so that compilers
+     * vectorize them, which makes rejecting an encoding cheap.
+     *
+     * @tparam TB Type of a base entry.
+     * @tparam TD Type of a delta entry.
+     * @param data The cache line.
+     * @return True if every value fits a delta of one of the bases.
+     */
+    template <class TB, class TD>
+    bool fitsBaseDelta(const uint64_t* data) const;
+
     /**
      * Instantiate a BaseDelta compressor with given TB and TD, and try to
      * compress the cache line. If the compression fails, it returns a nullptr.
@@ -155,6 +169,13 @@ class BDI : public BaseCacheCompressor
     void decompress(const BaseCacheCompressor::CompressionData* comp_data,
                                            uint64_t* data) override;
 
+    /**
+     * Count the encoding of a compressed line.
+     *
+     * @param comp_data Compressed cache line.
+     */
+    void updateStats(const CompressionData* comp_data) override;
+
   public:
     /** Convenience typedef. */
     typedef BDIParams Params;
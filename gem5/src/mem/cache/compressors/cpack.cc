@@ -53,6 +53,7 @@ CPack::CPack(const Params *p)
     : BaseCacheCompressor(p), dictionarySize(2*blkSize/8)
 {
     dictionary.resize(dictionarySize);
+    dictionaryWords.resize(dictionarySize);
 
     resetDictionary();
 }
@@ -66,6 +67,7 @@ CPack::resetDictionary()
     // Set all entries as 0
     std::array<uint8_t, 4> zero_word = {0, 0, 0, 0};
     std::fill(dictionary.begin(), dictionary.end(), zero_word);
+    std::fill(dictionaryWords.begin(), dictionaryWords.end(), 0);
 }
 
 std::unique_ptr<CPack::Pattern>
@@ -84,23 +86,34 @@ CPack::compressWord(const uint32_t data)
     std::unique_ptr<Pattern> pattern =
         PatternFactory::getPattern(bytes, {0, 0, 0, 0}, -1);
 
-    // Search for word on dictionary
+    // Search for word on dictionary. The dictionary patterns are mutually
+    // exclusive and smaller the more upper bytes match (MMMM, then MMMX,
+    // then MMXX), so the best entry is the first one with the longest
+    // match, which is found without instantiating a pattern per entry
+    unsigned best_match = 0;
+    std::size_t best_index = 0;
     for (std::size_t i = 0; i < numEntries; i++) {
-        // Try matching input with possible patterns
-        std::unique_ptr<Pattern> temp_pattern =
-            PatternFactory::getPattern(bytes, dictionary[i], i);
+        const uint32_t diff = data ^ dictionaryWords[i];
+        const unsigned match = (diff == 0) + ((diff >> 8) == 0) +
+                               ((diff >> 16) == 0);
+        if (match > best_match) {
+            best_match = match;
+            best_index = i;
+        }
+    }
 
-        // Check if found pattern is better than previous
+    // Check if the dictionary pattern is better than the no-match one
+    if (best_match > 0) {
+        std::unique_ptr<Pattern> temp_pattern = PatternFactory::getPattern(
+            bytes, dictionary[best_index], best_index);
         if (temp_pattern->getSizeBits() < pattern->getSizeBits()) {
             pattern = std::move(temp_pattern);
         }
     }
 
-    // Update stats
-    patternStats[pattern->getPatternNumber()]++;
-
     // Push into dictionary
     if ((numEntries < dictionarySize) && pattern->shouldAllocate()) {
+        dictionaryWords[numEntries] = data;
         dictionary[numEntries++] = bytes;
     }
 
@@ -169,6 +182,8 @@ CPack::decompressWord(const Pattern* pattern)
     // Decompress the match. If the decompressed value must be added to
     // the dictionary, do it
     if (pattern->decompress(*entry_it, data)) {
+        dictionaryWords[numEntries] =
+            (((((data[3] << 8) | data[2]) << 8) | data[1]) << 8) | data[0];
         dictionary[numEntries++] = data;
     }
 
@@ -201,6 +216,15 @@ CPack::decompress(const CompressionData* comp_data, uint64_t* data)
     }
 }
 
+void
+CPack::updateStats(const CompressionData* comp_data)
+{
+    const CompData* cpack_comp_data = static_cast<const CompData*>(comp_data);
+    for (const auto& entry : cpack_comp_data->entries) {
+        patternStats[entry->getPatternNumber()]++;
+    }
+}
+
 void
 CPack::regStats()
 {
@@ -126,6 +126,12 @@ class CPack : public BaseCacheCompressor
      */
     std::vector<std::array<uint8_t, 4>> dictionary;
 
+    /**
+     * The dictionary entries as words, so that an input word can be
+     * matched against all of them at once.
+     */
+    std::vector<uint32_t> dictionaryWords;
+
     /**
      * Dictionary size.
      */
@@ -190,6 +196,13 @@ class CPack : public BaseCacheCompressor
      */
     void decompress(const CompressionData* comp_data, uint64_t* data) override;
 
+    /**
+     * Count the patterns of a compressed line.
+     *
+     * @param comp_data Compressed cache line.
+     */
+    void updateStats(const CompressionData* comp_data) override;
+
   public:
     /** Convenience typedef. */
      typedef CPackParams Params;
@@ -55,6 +55,7 @@
 #include <string>
 #include <vector>
 
+#include "base/pool_allocator.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/cache/queue_entry.hh"
@@ -162,7 +163,11 @@ class MSHR : public QueueEntry, public Printable
         {}
     };
 
-    class TargetList : public std::list<Target> {
+    /**
+     * The targets of an MSHR. Targets come and go with every miss, so
+     * the list nodes are recycled through a pool.
+     */
+    class TargetList : public std::list<Target, PoolAllocator<Target>> {
 
       public:
         bool needsWritable;
@@ -323,7 +328,7 @@ class MSHR : public QueueEntry, public Printable
     };
 
     /** A list of MSHRs. */
-    typedef std::list<MSHR *> List;
+    typedef std::list<MSHR *, PoolAllocator<MSHR *>> List;
     /** MSHR list iterator. */
     typedef List::iterator Iterator;
 
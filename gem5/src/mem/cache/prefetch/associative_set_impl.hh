@@ -56,8 +56,9 @@ Entry*
 AssociativeSet<Entry>::findEntry(Addr addr, bool is_secure) const
 {
     Addr tag = indexingPolicy->extractTag(addr);
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates selected_entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
 
     for (const auto& location : selected_entries) {
         Entry* entry = static_cast<Entry *>(location);
@@ -81,8 +82,9 @@ Entry*
 AssociativeSet<Entry>::findVictim(Addr addr)
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates selected_entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
     Entry* victim = static_cast<Entry*>(replacementPolicy->getVictim(
                             selected_entries));
     // There is only one eviction for this replacement
@@ -95,8 +97,9 @@ template<class Entry>
 std::vector<Entry *>
 AssociativeSet<Entry>::getPossibleEntries(const Addr addr) const
 {
-    std::vector<ReplaceableEntry *> selected_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates selected_entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
     std::vector<Entry *> entries(selected_entries.size(), nullptr);
 
     unsigned int idx = 0;
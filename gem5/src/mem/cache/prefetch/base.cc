@@ -148,19 +148,19 @@ BasePrefetcher::observeAccess(const PacketPtr &pkt, bool miss) const
 bool
 BasePrefetcher::inCache(Addr addr, bool is_secure) const
 {
-    return cache->inCache(addr, is_secure);
+    return cache && cache->inCache(addr, is_secure);
 }
 
 bool
 BasePrefetcher::inMissQueue(Addr addr, bool is_secure) const
 {
-    return cache->inMissQueue(addr, is_secure);
+    return cache && cache->inMissQueue(addr, is_secure);
 }
 
 bool
 BasePrefetcher::hasBeenPrefetched(Addr addr, bool is_secure) const
 {
-    return cache->hasBeenPrefetched(addr, is_secure);
+    return cache && cache->hasBeenPrefetched(addr, is_secure);
 }
 
 bool
@@ -211,7 +211,14 @@ BasePrefetcher::probeNotify(const PacketPtr &pkt, bool miss)
         panic("Request must have a physical address");
     }
 
-    if (hasBeenPrefetched(pkt->getAddr(), pkt->isSecure())) {
+    notifyAccess(pkt, miss, hasBeenPrefetched(pkt->getAddr(),
+                                              pkt->isSecure()));
+}
+
+void
+BasePrefetcher::notifyAccess(const PacketPtr &pkt, bool miss, bool prefetched)
+{
+    if (prefetched) {
         usefulPrefetches += 1;
     }
 
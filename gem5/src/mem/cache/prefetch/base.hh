@@ -369,6 +369,16 @@ class BasePrefetcher : public ClockedObject
      */
     void probeNotify(const PacketPtr &pkt, bool miss);
 
+    /**
+     * Train the prefetcher on an access. This is the part of the probe
+     * notification that doesn't depend on the parent cache, so that the
+     * prefetcher can also be fed accesses without one.
+     * @param pkt The memory request of the access
+     * @param miss whether the access missed in the cache
+     * @param prefetched whether the accessed block was prefetched
+     */
+    void notifyAccess(const PacketPtr &pkt, bool miss, bool prefetched);
+
     /**
      * Add a SimObject and a probe name to listen events from
      * @param obj The SimObject pointer to listen from
@@ -90,8 +90,103 @@ QueuedPrefetcher::DeferredPacket::finish(const Fault &fault,
     owner->translationComplete(this, failed);
 }
 
+QueuedPrefetcher::iterator
+QueuedPrefetcher::DeferredQueue::position(int32_t priority)
+{
+    // The first level of a lower priority
+    auto lvl = levels.upper_bound(priority);
+    return lvl == levels.end() ? packets.end() : lvl->second;
+}
+
+void
+QueuedPrefetcher::DeferredQueue::link(iterator it)
+{
+    // Packets go to the end of their level, so the first packet of the
+    // level only changes if the level is new
+    levels.emplace(it->priority, it);
+
+    if (indexed) {
+        const bool inserted = index.emplace(
+            Key(it->pfInfo.getAddr(), it->pfInfo.isSecure()), it).second;
+        panic_if(!inserted, "Prefetch to %#x queued twice.\n",
+                 it->pfInfo.getAddr());
+    }
+}
+
+void
+QueuedPrefetcher::DeferredQueue::unlink(iterator it)
+{
+    auto lvl = levels.find(it->priority);
+    assert(lvl != levels.end());
+    if (lvl->second == it) {
+        auto next = std::next(it);
+        if (next != packets.end() && next->priority == it->priority) {
+            lvl->second = next;
+        } else {
+            levels.erase(lvl);
+        }
+    }
+
+    if (indexed) {
+        index.erase(Key(it->pfInfo.getAddr(), it->pfInfo.isSecure()));
+    }
+}
+
+QueuedPrefetcher::iterator
+QueuedPrefetcher::DeferredQueue::find(Addr addr, bool is_secure)
+{
+    assert(indexed);
+    auto entry = index.find(Key(addr, is_secure));
+    return entry == index.end() ? packets.end() : entry->second;
+}
+
+QueuedPrefetcher::iterator
+QueuedPrefetcher::DeferredQueue::find(const DeferredPacket *dp)
+{
+    if (indexed) {
+        iterator it = find(dp->pfInfo.getAddr(), dp->pfInfo.isSecure());
+        return (it != packets.end() && &(*it) == dp) ? it : packets.end();
+    }
+
+    for (iterator it = packets.begin(); it != packets.end(); ++it) {
+        if (&(*it) == dp)
+            return it;
+    }
+    return packets.end();
+}
+
+QueuedPrefetcher::iterator
+QueuedPrefetcher::DeferredQueue::lowestPriority()
+{
+    assert(!levels.empty());
+    return levels.rbegin()->second;
+}
+
+void
+QueuedPrefetcher::DeferredQueue::push(const DeferredPacket &dp)
+{
+    link(packets.insert(position(dp.priority), dp));
+}
+
+QueuedPrefetcher::iterator
+QueuedPrefetcher::DeferredQueue::erase(iterator it)
+{
+    unlink(it);
+    return packets.erase(it);
+}
+
+void
+QueuedPrefetcher::DeferredQueue::setPriority(iterator it, int32_t priority)
+{
+    unlink(it);
+    it->priority = priority;
+    packets.splice(position(priority), packets, it);
+    link(it);
+}
+
 QueuedPrefetcher::QueuedPrefetcher(const QueuedPrefetcherParams *p)
-    : BasePrefetcher(p), queueSize(p->queue_size),
+    : BasePrefetcher(p), pfq(p->queue_filter),
+      pfqMissingTranslation(p->queue_filter), queueSize(p->queue_size),
       missingTranslationQueueSize(
         p->max_prefetch_requests_with_pending_translation),
       latency(p->latency), queueSquash(p->queue_squash),
@@ -146,7 +241,14 @@ QueuedPrefetcher::notify(const PacketPtr &pkt, const PrefetchInfo &pfi)
     bool is_secure = pfi.isSecure();
 
     // Squash queued prefetches if demand miss to same line
-    if (queueSquash) {
+    if (queueSquash && queueFilter) {
+        // Queued addresses are unique and indexed
+        auto itr = pfq.find(blk_addr, is_secure);
+        if (itr != pfq.end()) {
+            delete itr->pkt;
+            pfq.erase(itr);
+        }
+    } else if (queueSquash) {
         auto itr = pfq.begin();
         while (itr != pfq.end()) {
             if (itr->pfInfo.getAddr() == blk_addr &&
@@ -212,7 +314,7 @@ QueuedPrefetcher::getPacket()
     }
 
     PacketPtr pkt = pfq.front().pkt;
-    pfq.pop_front();
+    pfq.erase(pfq.begin());
 
     pfIssued++;
     issuedPrefetches += 1;
@@ -268,13 +370,7 @@ QueuedPrefetcher::processMissingTranslations(unsigned max)
 void
 QueuedPrefetcher::translationComplete(DeferredPacket *dp, bool failed)
 {
-    auto it = pfqMissingTranslation.begin();
-    while (it != pfqMissingTranslation.end()) {
-        if (&(*it) == dp) {
-            break;
-        }
-        it++;
-    }
+    auto it = pfqMissingTranslation.find(dp);
     assert(it != pfqMissingTranslation.end());
     if (!failed) {
         DPRINTF(HWPrefetch, "%s Translation of vaddr %#x succeeded: "
@@ -303,38 +399,26 @@ QueuedPrefetcher::translationComplete(DeferredPacket *dp, bool failed)
 }
 
 bool
-QueuedPrefetcher::alreadyInQueue(std::list<DeferredPacket> &queue,
+QueuedPrefetcher::alreadyInQueue(DeferredQueue &queue,
                                  const PrefetchInfo &pfi, int32_t priority)
 {
-    bool found = false;
-    iterator it;
-    for (it = queue.begin(); it != queue.end() && !found; it++) {
-        found = it->pfInfo.sameAddr(pfi);
+    iterator it = queue.find(pfi.getAddr(), pfi.isSecure());
+    if (it == queue.end()) {
+        return false;
     }
 
-    /* If the address is already in the queue, update priority and leave */
-    if (it != queue.end()) {
-        pfBufferHit++;
-        if (it->priority < priority) {
-            /* Update priority value and position in the queue */
-            it->priority = priority;
-            iterator prev = it;
-            while (prev != queue.begin()) {
-                prev--;
-                /* If the packet has higher priority, swap */
-                if (*it > *prev) {
-                    std::swap(*it, *prev);
-                    it = prev;
-                }
-            }
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue, priority updated\n");
-        } else {
-            DPRINTF(HWPrefetch, "Prefetch addr already in "
-                "prefetch queue\n");
-        }
+    /* The address is already in the queue, update priority and leave */
+    pfBufferHit++;
+    if (it->priority < priority) {
+        /* Update priority value and position in the queue */
+        queue.setPriority(it, priority);
+        DPRINTF(HWPrefetch, "Prefetch addr already in "
+            "prefetch queue, priority updated\n");
+    } else {
+        DPRINTF(HWPrefetch, "Prefetch addr already in "
+            "prefetch queue\n");
     }
-    return found;
+    return true;
 }
 
 RequestPtr
@@ -447,48 +531,18 @@ QueuedPrefetcher::insert(const PacketPtr &pkt, PrefetchInfo &new_pfi,
 }
 
 void
-QueuedPrefetcher::addToQueue(std::list<DeferredPacket> &queue,
-                             DeferredPacket &dpp)
+QueuedPrefetcher::addToQueue(DeferredQueue &queue, DeferredPacket &dpp)
 {
     /* Verify prefetch buffer space for request */
     if (queue.size() == queueSize) {
         pfRemovedFull++;
-        /* Lowest priority packet */
-        iterator it = queue.end();
-        panic_if (it == queue.begin(),
-            "Prefetch queue is both full and empty!");
-        --it;
-        /* Look for oldest in that level of priority */
-        panic_if (it == queue.begin(),
-            "Prefetch queue is full with 1 element!");
-        iterator prev = it;
-        bool cont = true;
-        /* While not at the head of the queue */
-        while (cont && prev != queue.begin()) {
-            prev--;
-            /* While at the same level of priority */
-            cont = prev->priority == it->priority;
-            if (cont)
-                /* update pointer */
-                it = prev;
-        }
+        /* Oldest packet of the lowest priority */
+        iterator it = queue.lowestPriority();
         DPRINTF(HWPrefetch, "Prefetch queue full, removing lowest priority "
                             "oldest packet, addr: %#x\n",it->pfInfo.getAddr());
         delete it->pkt;
         queue.erase(it);
     }
 
-    if (queue.size() == 0) {
-        queue.emplace_back(dpp);
-    } else {
-        iterator it = queue.end();
-        do {
-            --it;
-        } while (it != queue.begin() && dpp > *it);
-        /* If we reach the head, we have to see if the new element is new head
-         * or not */
-        if (it == queue.begin() && dpp <= *it)
-            it++;
-        queue.insert(it, dpp);
-    }
+    queue.push(dpp);
 }
@@ -41,9 +41,13 @@
 #define __MEM_CACHE_PREFETCH_QUEUED_HH__
 
 #include <cstdint>
+#include <functional>
 #include <list>
+#include <map>
+#include <unordered_map>
 #include <utility>
 
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "mem/cache/prefetch/base.hh"
@@ -131,11 +135,121 @@ class QueuedPrefetcher : public BasePrefetcher
         void startTranslation(BaseTLB *tlb);
     };
 
-    std::list<DeferredPacket> pfq;
-    std::list<DeferredPacket> pfqMissingTranslation;
+    /**
+     * A queue of deferred packets, sorted by decreasing priority and in
+     * insertion order within a priority level. The first packet of each
+     * priority level is tracked, so inserting a packet or finding the
+     * packet to drop from a full queue doesn't walk the queue. When the
+     * queue is indexed, the packets can also be looked up by address
+     * in constant time, which requires their addresses to be unique.
+     *
+     * Queued packets never move in memory, since the TLB keeps pointers
+     * to the packets it is translating.
+     */
+    class DeferredQueue
+    {
+      public:
+        typedef std::list<DeferredPacket, PoolAllocator<DeferredPacket>>
+            List;
+        typedef List::iterator iterator;
+        typedef List::const_iterator const_iterator;
+
+      private:
+        /** The packets, in queue order. */
+        List packets;
+
+        /** First packet of each priority level, highest priority first. */
+        std::map<int32_t, iterator, std::greater<int32_t>> levels;
+
+        /** Address and security state of a packet. */
+        typedef std::pair<Addr, bool> Key;
+
+        struct KeyHash
+        {
+            std::size_t
+            operator()(const Key &key) const
+            {
+                return std::hash<Addr>()(key.first) ^ key.second;
+            }
+        };
+
+        /** Packets by address, only used if the queue is indexed. */
+        std::unordered_map<Key, iterator, KeyHash, std::equal_to<Key>,
+                           PoolAllocator<std::pair<const Key, iterator>>>
+            index;
+
+        /** Whether the packets are indexed by address. */
+        const bool indexed;
+
+        /**
+         * Get the position at which a packet of the given priority has
+         * to be inserted to come after all the packets of a higher or
+         * equal priority.
+         */
+        iterator position(int32_t priority);
+
+        /** Add a packet that was just put in the queue to the lookups. */
+        void link(iterator it);
+
+        /** Remove a packet that is about to leave the lookups. */
+        void unlink(iterator it);
+
+      public:
+        DeferredQueue(bool _indexed) : indexed(_indexed) {}
+
+        bool empty() const { return packets.empty(); }
+        std::size_t size() const { return packets.size(); }
+
+        iterator begin() { return packets.begin(); }
+        iterator end() { return packets.end(); }
+        const_iterator begin() const { return packets.begin(); }
+        const_iterator end() const { return packets.end(); }
+
+        DeferredPacket &front() { return packets.front(); }
+        const DeferredPacket &front() const { return packets.front(); }
+
+        /**
+         * Find the packet to the given address. The queue must be
+         * indexed.
+         *
+         * @param addr The address of the packet.
+         * @param is_secure The security state of the packet.
+         * @return The packet, end() if there is none.
+         */
+        iterator find(Addr addr, bool is_secure);
+
+        /**
+         * Get the position of a packet in the queue.
+         *
+         * @param dp The queued packet.
+         * @return The position of the packet, end() if it isn't queued.
+         */
+        iterator find(const DeferredPacket *dp);
+
+        /**
+         * Get the oldest packet of the lowest priority level, which is
+         * the one dropped when the queue is full. The queue must not be
+         * empty.
+         */
+        iterator lowestPriority();
+
+        /** Insert a copy of the packet according to its priority. */
+        void push(const DeferredPacket &dp);
+
+        /** Remove a packet from the queue. */
+        iterator erase(iterator it);
+
+        /**
+         * Change the priority of a packet and move it to the end of its
+         * new priority level.
+         */
+        void setPriority(iterator it, int32_t priority);
+    };
+
+    using iterator = DeferredQueue::iterator;
 
-    using const_iterator = std::list<DeferredPacket>::const_iterator;
-    using iterator = std::list<DeferredPacket>::iterator;
+    DeferredQueue pfq;
+    DeferredQueue pfqMissingTranslation;
 
     // PARAMETERS
 
@@ -201,7 +315,7 @@ class QueuedPrefetcher : public BasePrefetcher
      * @param queue selected queue to use
      * @param dpp DeferredPacket to add
      */
-    void addToQueue(std::list<DeferredPacket> &queue, DeferredPacket &dpp);
+    void addToQueue(DeferredQueue &queue, DeferredPacket &dpp);
 
     /**
      * Starts the translations of the queued prefetches with a
@@ -229,8 +343,8 @@ class QueuedPrefetcher : public BasePrefetcher
      * @param priority priority of the prefetch request to be added
      * @return True if the prefetch request was found in the queue
      */
-    bool alreadyInQueue(std::list<DeferredPacket> &queue,
-                        const PrefetchInfo &pfi, int32_t priority);
+    bool alreadyInQueue(DeferredQueue &queue, const PrefetchInfo &pfi,
+                        int32_t priority);
 
     /**
      * Returns the maxmimum number of prefetch requests that are allowed
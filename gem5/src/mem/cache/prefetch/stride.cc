@@ -232,14 +232,14 @@ StridePrefetcher::PCTable::findVictim(Addr pc)
     int set = pcHash(pc);
 
     // Get possible entries to be victimized
-    std::vector<ReplaceableEntry*> possible_entries;
+    CandidateBuffer possible_entries;
     for (auto& entry : entries[set]) {
         possible_entries.push_back(&entry);
     }
 
     // Choose victim based on replacement policy
     StrideEntry* victim = static_cast<StrideEntry*>(
-        replacementPolicy->getVictim(possible_entries));
+        replacementPolicy->getVictim(possible_entries.candidates()));
 
     DPRINTF(HWPrefetch, "Victimizing lookup table[%d][%d].\n",
             victim->getSet(), victim->getWay());
@@ -0,0 +1,303 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/cache/prefetch/trainer.hh"
+
+#include <algorithm>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/HWPrefetch.hh"
+#include "mem/cache/prefetch/base.hh"
+#include "params/PrefetchTrainer.hh"
+#include "proto/packet.pb.h"
+#include "proto/protoio.hh"
+#include "sim/core.hh"
+#include "sim/sim_exit.hh"
+
+void
+PrefetchTrainer::BlockList::push(Addr blk)
+{
+    assert(!contains(blk));
+    blocks.push_front(blk);
+    index.emplace(blk, blocks.begin());
+}
+
+bool
+PrefetchTrainer::BlockList::touch(Addr blk)
+{
+    auto it = index.find(blk);
+    if (it == index.end())
+        return false;
+    blocks.splice(blocks.begin(), blocks, it->second);
+    return true;
+}
+
+bool
+PrefetchTrainer::BlockList::erase(Addr blk)
+{
+    auto it = index.find(blk);
+    if (it == index.end())
+        return false;
+    blocks.erase(it->second);
+    index.erase(it);
+    return true;
+}
+
+void
+PrefetchTrainer::BlockList::pop()
+{
+    assert(!blocks.empty());
+    index.erase(blocks.back());
+    blocks.pop_back();
+}
+
+PrefetchTrainer::PrefetchTrainer(const PrefetchTrainerParams *p)
+    : SimObject(p), prefetcher(p->prefetcher), traceFiles(p->trace_files),
+      blkSize(p->block_size), filterSize(p->filter_size),
+      bufferSize(p->buffer_size), batchSize(p->batch_size), nextTrace(0),
+      traceStart(0), traceFirstTick(0), batchPos(0),
+      trainEvent([this]{ processBatch(); }, name())
+{
+    fatal_if(!isPowerOf2(blkSize), "%s: block size must be a power of 2.",
+             name());
+    fatal_if(filterSize == 0 || bufferSize == 0 || batchSize == 0,
+             "%s: the filter, buffer and batch sizes can't be zero.",
+             name());
+    batch.reserve(batchSize);
+}
+
+PrefetchTrainer::~PrefetchTrainer()
+{
+}
+
+void
+PrefetchTrainer::startup()
+{
+    schedule(trainEvent, curTick());
+}
+
+bool
+PrefetchTrainer::decodeBatch()
+{
+    batch.clear();
+    batchPos = 0;
+
+    ProtoMessage::Packet pkt_msg;
+    while (batch.size() < batchSize) {
+        if (!trace) {
+            if (nextTrace == traceFiles.size())
+                break;
+
+            const std::string &filename = traceFiles[nextTrace++];
+            trace.reset(new ProtoInputStream(filename));
+            ProtoMessage::PacketHeader header_msg;
+            fatal_if(!trace->read(header_msg),
+                     "Failed to read packet header from %s.", filename);
+            fatal_if(header_msg.tick_freq() != SimClock::Frequency,
+                     "%s was recorded with a tick frequency of %d, "
+                     "expected %d.", filename, header_msg.tick_freq(),
+                     SimClock::Frequency);
+
+            DPRINTF(HWPrefetch, "Training on %s.\n", filename);
+            traceStart = curTick();
+            traceFirstTick = MaxTick;
+        }
+
+        if (!trace->read(pkt_msg)) {
+            trace.reset();
+            continue;
+        }
+
+        // Traces are replayed back to back, each one starting when
+        // the previous one ended
+        if (traceFirstTick == MaxTick)
+            traceFirstTick = pkt_msg.tick();
+
+        Access access;
+        access.tick = traceStart +
+            (pkt_msg.tick() - std::min<Tick>(pkt_msg.tick(), traceFirstTick));
+        access.cmd = MemCmd(pkt_msg.cmd());
+        access.addr = pkt_msg.addr();
+        access.size = pkt_msg.size();
+        access.flags = pkt_msg.has_flags() ? pkt_msg.flags() : 0;
+        access.masterId = pkt_msg.has_pkt_id() ? pkt_msg.pkt_id() : 0;
+        access.hasPC = pkt_msg.has_pc();
+        access.pc = access.hasPC ? pkt_msg.pc() : 0;
+
+        // Only demand reads and writes train the prefetcher
+        if (access.cmd.isRequest() && (access.cmd.isRead() ||
+                                       access.cmd.isWrite())) {
+            batch.push_back(access);
+        }
+    }
+
+    return !batch.empty();
+}
+
+void
+PrefetchTrainer::processBatch()
+{
+    EventQueue *eventq = eventQueue();
+
+    while (batchPos < batch.size() || decodeBatch()) {
+        const Access &access = batch[batchPos];
+        const Tick when = std::max(curTick(), access.tick);
+
+        if (when > curTick()) {
+            if (!eventq->empty() && eventq->nextTick() <= when) {
+                // An event of the prefetcher is due first, let the
+                // event loop service it
+                schedule(trainEvent, when);
+                return;
+            }
+
+            // Nothing else happens until then
+            eventq->setCurTick(when);
+        }
+
+        train(access);
+        ++batchPos;
+    }
+
+    exitSimLoop("prefetcher training complete");
+}
+
+PacketPtr
+PrefetchTrainer::createPacket(const Access &access) const
+{
+    RequestPtr req = std::make_shared<Request>(
+        access.addr, access.size, access.flags, access.masterId);
+    if (access.hasPC)
+        req->setPC(access.pc);
+
+    PacketPtr pkt = new Packet(req, access.cmd);
+    pkt->allocate();
+    std::fill(pkt->getPtr<uint8_t>(),
+              pkt->getPtr<uint8_t>() + pkt->getSize(), 0);
+    return pkt;
+}
+
+void
+PrefetchTrainer::train(const Access &access)
+{
+    const Addr blk_addr = access.addr & ~Addr(blkSize - 1);
+    const bool prefetched = buffer.erase(blk_addr);
+    const bool hit = prefetched || filter.touch(blk_addr);
+
+    accesses++;
+    if (prefetched) {
+        prefetchHits++;
+    } else if (!hit) {
+        misses++;
+    }
+
+    PacketPtr pkt = createPacket(access);
+    prefetcher->notifyAccess(pkt, !hit, prefetched);
+
+    if (!hit || prefetched) {
+        // The block is filled, or was filled by the prefetch
+        if (!hit)
+            prefetcher->notifyFill(pkt);
+        if (filter.size() == filterSize)
+            filter.pop();
+        filter.push(blk_addr);
+    }
+    delete pkt;
+
+    issuePrefetches();
+}
+
+void
+PrefetchTrainer::issuePrefetches()
+{
+    while (PacketPtr pkt = prefetcher->getPacket()) {
+        const Addr blk_addr = pkt->getAddr() & ~Addr(blkSize - 1);
+        if (filter.contains(blk_addr) || buffer.contains(blk_addr)) {
+            // The cache would drop the prefetch
+            redundant++;
+        } else {
+            issued++;
+            if (buffer.size() == bufferSize) {
+                buffer.pop();
+                unused++;
+            }
+            buffer.push(blk_addr);
+            prefetcher->notifyFill(pkt);
+        }
+        delete pkt;
+    }
+}
+
+void
+PrefetchTrainer::regStats()
+{
+    SimObject::regStats();
+
+    accesses
+        .name(name() + ".accesses")
+        .desc("number of demand accesses fed to the prefetcher");
+
+    misses
+        .name(name() + ".misses")
+        .desc("number of demand accesses that missed and weren't prefetched");
+
+    prefetchHits
+        .name(name() + ".prefetch_hits")
+        .desc("number of demand accesses to prefetched blocks");
+
+    issued
+        .name(name() + ".issued")
+        .desc("number of prefetches issued to the prefetch buffer");
+
+    redundant
+        .name(name() + ".redundant")
+        .desc("number of prefetches to blocks already present");
+
+    unused
+        .name(name() + ".unused")
+        .desc("number of prefetched blocks evicted before being accessed");
+
+    coverage
+        .name(name() + ".coverage")
+        .desc("fraction of the misses removed by the prefetcher");
+    coverage = prefetchHits / (prefetchHits + misses);
+
+    accuracy
+        .name(name() + ".accuracy")
+        .desc("fraction of the issued prefetches that were accessed");
+    accuracy = prefetchHits / issued;
+}
+
+PrefetchTrainer*
+PrefetchTrainerParams::create()
+{
+    return new PrefetchTrainer(this);
+}
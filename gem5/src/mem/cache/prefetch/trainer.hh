@@ -0,0 +1,212 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/* @file
+ * Standalone training of a prefetcher on recorded access streams
+ */
+
+#ifndef __MEM_CACHE_PREFETCH_TRAINER_HH__
+#define __MEM_CACHE_PREFETCH_TRAINER_HH__
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/packet.hh"
+#include "sim/eventq.hh"
+#include "sim/sim_object.hh"
+
+class BasePrefetcher;
+class ProtoInputStream;
+struct PrefetchTrainerParams;
+
+/**
+ * Feed recorded memory accesses to a prefetcher without simulating a
+ * cache hierarchy. The accesses are read from packet traces, e.g.
+ * those written by a MemTraceProbe, and handed to the prefetcher in
+ * batches as if it observed them at the port of a cache. The blocks it
+ * asks for go to a prefetch buffer, so the coverage and accuracy of
+ * the prefetcher can be measured orders of magnitude faster than in a
+ * full simulation.
+ *
+ * The cache is approximated by a fully associative LRU filter. An
+ * access that finds its block neither in the filter nor in the prefetch
+ * buffer is reported to the prefetcher as a miss. A demand access to
+ * a prefetched block counts as a useful prefetch and moves the block
+ * to the filter. Prefetches are issued as soon as they are generated.
+ *
+ * Nothing but the trainer and the prefetcher is simulated. Training
+ * starts with the simulation and exits the simulation loop once all
+ * the traces have been fed. Time jumps to the tick of each trace
+ * record, unless an event of the prefetcher is due first, in which
+ * case the event loop gets to service it before training resumes.
+ *
+ * The prefetcher must train on physical addresses and has no TLB, so
+ * page crossing prefetches are dropped.
+ */
+class PrefetchTrainer : public SimObject
+{
+  private:
+    /** A decoded trace record. */
+    struct Access
+    {
+        Tick tick;
+        MemCmd cmd;
+        Addr addr;
+        unsigned size;
+        Request::FlagsType flags;
+        MasterID masterId;
+        Addr pc;
+        bool hasPC;
+    };
+
+    /** A set of blocks kept in insertion or recency order. */
+    class BlockList
+    {
+      private:
+        /** The blocks, most recent first. */
+        std::list<Addr> blocks;
+
+        /** Position of each block in the list. */
+        std::unordered_map<Addr, std::list<Addr>::iterator> index;
+
+      public:
+        bool contains(Addr blk) const { return index.count(blk) != 0; }
+
+        std::size_t size() const { return blocks.size(); }
+
+        /** Add a block that isn't in the list as the most recent one. */
+        void push(Addr blk);
+
+        /**
+         * Make a block the most recent one.
+         * @return false if the block isn't in the list.
+         */
+        bool touch(Addr blk);
+
+        /**
+         * Remove a block.
+         * @return false if the block isn't in the list.
+         */
+        bool erase(Addr blk);
+
+        /** Remove the least recent block. */
+        void pop();
+    };
+
+    /** The trained prefetcher. */
+    BasePrefetcher *prefetcher;
+
+    /** Packet traces to read the accesses from. */
+    const std::vector<std::string> traceFiles;
+
+    /** Block size of the trained prefetcher. */
+    const unsigned blkSize;
+
+    /** Capacity of the filter approximating the cache, in blocks. */
+    const unsigned filterSize;
+
+    /** Capacity of the prefetch buffer, in blocks. */
+    const unsigned bufferSize;
+
+    /** Number of trace records decoded at once. */
+    const unsigned batchSize;
+
+    /** Blocks in the cache, most recently used first. */
+    BlockList filter;
+
+    /** Prefetched blocks not accessed yet, youngest first. */
+    BlockList buffer;
+
+    /** Trace file being read. */
+    std::unique_ptr<ProtoInputStream> trace;
+
+    /** Index of the next trace file to open. */
+    unsigned nextTrace;
+
+    /** Tick the current trace file starts at. */
+    Tick traceStart;
+
+    /** Tick of the first record of the current trace file. */
+    Tick traceFirstTick;
+
+    /** Decoded records. */
+    std::vector<Access> batch;
+
+    /** Next record of the batch to feed. */
+    std::size_t batchPos;
+
+    /**
+     * Decode the next batch of records, opening the next trace file
+     * when needed.
+     * @return false once all the trace files are exhausted.
+     */
+    bool decodeBatch();
+
+    /** Feed records until the traces are exhausted or time must pass. */
+    void processBatch();
+
+    EventFunctionWrapper trainEvent;
+
+    /**
+     * Build the packet of an access as seen by the prefetcher.
+     * @param access The trace record.
+     * @return A packet the caller has to delete.
+     */
+    PacketPtr createPacket(const Access &access) const;
+
+    /** Feed an access to the prefetcher. */
+    void train(const Access &access);
+
+    /** Issue all the prefetches the prefetcher has queued. */
+    void issuePrefetches();
+
+    Stats::Scalar accesses;
+    Stats::Scalar misses;
+    Stats::Scalar prefetchHits;
+    Stats::Scalar issued;
+    Stats::Scalar redundant;
+    Stats::Scalar unused;
+    Stats::Formula coverage;
+    Stats::Formula accuracy;
+
+  public:
+    PrefetchTrainer(const PrefetchTrainerParams *p);
+    ~PrefetchTrainer();
+
+    void startup() override;
+    void regStats() override;
+};
+
+#endif // __MEM_CACHE_PREFETCH_TRAINER_HH__
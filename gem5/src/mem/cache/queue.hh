@@ -52,7 +52,9 @@
 #include <cassert>
 #include <string>
 #include <type_traits>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
@@ -101,6 +103,65 @@ class Queue : public Drainable
     /** Holds non allocated entries. */
     typename Entry::List freeList;
 
+    /**
+     * Allocated entries hashed by block address. Each bucket chains
+     * its entries in allocation order through QueueEntry::nextInBucket,
+     * so looking up an address does not have to go through all the
+     * allocated entries.
+     */
+    std::vector<QueueEntry *> index;
+
+    /** Number of bits of the bucket number in the index. */
+    const int indexBits;
+
+    /**
+     * Get the index bucket of a block address.
+     *
+     * @param blk_addr The block address.
+     * @return The bucket the address hashes to.
+     */
+    QueueEntry *&bucket(Addr blk_addr)
+    {
+        // Fibonacci hashing, spreads block aligned addresses evenly
+        return index[(blk_addr * 0x9e3779b97f4a7c15ULL) >> (64 - indexBits)];
+    }
+
+    QueueEntry *bucket(Addr blk_addr) const
+    {
+        return index[(blk_addr * 0x9e3779b97f4a7c15ULL) >> (64 - indexBits)];
+    }
+
+    /**
+     * Add a newly allocated entry to the address index. Must be
+     * called once the address of the entry is set.
+     *
+     * @param entry The allocated entry.
+     */
+    void addToIndex(Entry *entry)
+    {
+        QueueEntry **link = &bucket(entry->blkAddr);
+        while (*link)
+            link = &(*link)->nextInBucket;
+        *link = entry;
+        entry->nextInBucket = nullptr;
+    }
+
+    /**
+     * Remove an entry that is being deallocated from the address index.
+     *
+     * @param entry The entry to remove.
+     */
+    void removeFromIndex(Entry *entry)
+    {
+        QueueEntry **link = &bucket(entry->blkAddr);
+        while (*link != entry) {
+            assert(*link);
+            link = &(*link)->nextInBucket;
+        }
+        *link = entry->nextInBucket;
+        entry->nextInBucket = nullptr;
+    }
+
     typename Entry::Iterator addToReadyList(Entry* entry)
     {
         if (readyList.empty() ||
@@ -132,8 +193,9 @@ class Queue : public Drainable
      */
     Queue(const std::string &_label, int num_entries, int reserve) :
         label(_label), numEntries(num_entries + reserve),
-        numReserve(reserve), entries(numEntries), _numInService(0),
-        allocated(0)
+        numReserve(reserve), entries(numEntries),
+        index(1 << ceilLog2(2 * numEntries), nullptr),
+        indexBits(ceilLog2(2 * numEntries)), _numInService(0), allocated(0)
     {
         for (int i = 0; i < numEntries; ++i) {
             freeList.push_back(&entries[i]);
@@ -166,7 +228,8 @@ class Queue : public Drainable
     Entry* findMatch(Addr blk_addr, bool is_secure,
                      bool ignore_uncacheable = true) const
     {
-        for (const auto& entry : allocatedList) {
+        for (QueueEntry *e = bucket(blk_addr); e; e = e->nextInBucket) {
+            Entry *entry = static_cast<Entry *>(e);
             // we ignore any entries allocated for uncacheable
             // accesses and simply ignore them when matching, in the
             // cache we never check for matches when adding new
@@ -237,6 +300,7 @@ class Queue : public Drainable
      */
     void deallocate(Entry *entry)
     {
+        removeFromIndex(entry);
         allocatedList.erase(entry->allocIter);
         freeList.push_front(entry);
         allocated--;
@@ -37,11 +37,6 @@
 #include "params/BaseReplacementPolicy.hh"
 #include "sim/sim_object.hh"
 
-/**
- * Replacement candidates as chosen by the indexing policy.
- */
-typedef std::vector<ReplaceableEntry*> ReplacementCandidates;
-
 /**
  * A common base class of cache replacement policy objects.
  */
@@ -96,6 +91,26 @@ class BaseReplacementPolicy : public SimObject
     virtual ReplaceableEntry* getVictim(
                            const ReplacementCandidates& candidates) const = 0;
 
+    /**
+     * Get the state of a replacement data entry, so that it can be saved in
+     * checkpoints. Policies that keep no per-entry state do not need to
+     * override it.
+     *
+     * @param replacement_data Replacement data to be saved.
+     * @return The state of the entry.
+     */
+    virtual uint64_t getState(const std::shared_ptr<ReplacementData>&
+                                        replacement_data) const { return 0; }
+
+    /**
+     * Restore the state of a replacement data entry from a checkpoint.
+     *
+     * @param replacement_data Replacement data to be restored.
+     * @param state The state returned by getState().
+     */
+    virtual void setState(const std::shared_ptr<ReplacementData>&
+                              replacement_data, uint64_t state) const {}
+
     /**
      * Instantiate a replacement data entry.
      *
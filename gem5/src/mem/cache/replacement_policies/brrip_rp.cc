@@ -138,6 +138,26 @@ BRRIPRP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+BRRIPRP::getState(
+    const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    std::shared_ptr<BRRIPReplData> casted_replacement_data =
+        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    return (uint64_t(uint8_t(casted_replacement_data->rrpv)) << 1) |
+           casted_replacement_data->valid;
+}
+
+void
+BRRIPRP::setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                   uint64_t state) const
+{
+    std::shared_ptr<BRRIPReplData> casted_replacement_data =
+        std::static_pointer_cast<BRRIPReplData>(replacement_data);
+    casted_replacement_data->rrpv = SatCounter(numRRPVBits, state >> 1);
+    casted_replacement_data->valid = state & 1;
+}
+
 std::shared_ptr<ReplacementData>
 BRRIPRP::instantiateEntry()
 {
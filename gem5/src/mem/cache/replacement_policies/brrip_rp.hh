@@ -156,6 +156,24 @@ class BRRIPRP : public BaseReplacementPolicy
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Get the state of a replacement data entry, to save it in checkpoints.
+     *
+     * @param replacement_data Replacement data to be saved.
+     * @return The RRPV of the entry, shifted, and its validity in bit 0.
+     */
+    uint64_t getState(const std::shared_ptr<ReplacementData>&
+                                        replacement_data) const override;
+
+    /**
+     * Restore the state of a replacement data entry from a checkpoint.
+     *
+     * @param replacement_data Replacement data to be restored.
+     * @param state The state returned by getState().
+     */
+    void setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  uint64_t state) const override;
+
     /**
      * Instantiate a replacement data entry.
      *
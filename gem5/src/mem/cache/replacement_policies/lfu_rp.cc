@@ -83,6 +83,21 @@ LFURP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+LFURP::getState(const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    return std::static_pointer_cast<LFUReplData>(
+        replacement_data)->refCount;
+}
+
+void
+LFURP::setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                 uint64_t state) const
+{
+    std::static_pointer_cast<LFUReplData>(
+        replacement_data)->refCount = state;
+}
+
 std::shared_ptr<ReplacementData>
 LFURP::instantiateEntry()
 {
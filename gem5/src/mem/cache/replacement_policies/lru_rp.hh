@@ -106,6 +106,24 @@ class LRURP : public BaseReplacementPolicy
     ReplaceableEntry* getVictim(const ReplacementCandidates& candidates) const
                                                                      override;
 
+    /**
+     * Get the state of a replacement data entry, to save it in checkpoints.
+     *
+     * @param replacement_data Replacement data to be saved.
+     * @return The last touch tick of the entry.
+     */
+    uint64_t getState(const std::shared_ptr<ReplacementData>&
+                                        replacement_data) const override;
+
+    /**
+     * Restore the state of a replacement data entry from a checkpoint.
+     *
+     * @param replacement_data Replacement data to be restored.
+     * @param state The state returned by getState().
+     */
+    void setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                  uint64_t state) const override;
+
     /**
      * Instantiate a replacement data entry.
      *
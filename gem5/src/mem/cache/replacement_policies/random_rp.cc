@@ -86,6 +86,22 @@ RandomRP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+RandomRP::getState(
+    const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    return std::static_pointer_cast<RandomReplData>(
+        replacement_data)->valid;
+}
+
+void
+RandomRP::setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                    uint64_t state) const
+{
+    std::static_pointer_cast<RandomReplData>(
+        replacement_data)->valid = state;
+}
+
 std::shared_ptr<ReplacementData>
 RandomRP::instantiateEntry()
 {
@@ -31,8 +31,11 @@
 #ifndef __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 #define __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH__
 
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 /**
  * The replacement data needed by replacement policies. Each replacement policy
@@ -101,4 +104,110 @@ class ReplaceableEntry
     uint32_t getWay() const { return _way; }
 };
 
+/**
+ * Replacement candidates as chosen by the indexing policy. This is a
+ * view of entries that are stored elsewhere, e.g. in the sets of the
+ * indexing policy or in a CandidateBuffer, so candidates can be passed
+ * around without copying or allocating. The view is only valid as long
+ * as the storage it refers to.
+ */
+class ReplacementCandidates
+{
+  private:
+    /** First candidate. */
+    ReplaceableEntry* const* first;
+
+    /** Number of candidates. */
+    std::size_t count;
+
+  public:
+    typedef ReplaceableEntry* const* const_iterator;
+
+    ReplacementCandidates(ReplaceableEntry* const* _first, std::size_t _count)
+        : first(_first), count(_count)
+    {}
+
+    /** View all the entries of a vector. */
+    ReplacementCandidates(const std::vector<ReplaceableEntry*> &entries)
+        : first(entries.data()), count(entries.size())
+    {}
+
+    const_iterator begin() const { return first; }
+    const_iterator end() const { return first + count; }
+
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+
+    ReplaceableEntry*
+    operator[](std::size_t idx) const
+    {
+        assert(idx < count);
+        return first[idx];
+    }
+};
+
+/**
+ * Storage for replacement candidates that have to be gathered from
+ * different places, e.g. one per way with skewed associativity. The
+ * candidates of the common associativities are kept in the buffer
+ * itself, and only larger candidate sets fall back to the heap, so a
+ * buffer allocated on the stack makes gathering candidates allocation
+ * free.
+ */
+class CandidateBuffer
+{
+  public:
+    /** Number of candidates that fit in the buffer itself. */
+    static const std::size_t InlineSize = 16;
+
+  private:
+    /** Inline storage for the candidates. */
+    ReplaceableEntry* inlineEntries[InlineSize];
+
+    /** Storage used once the candidates do not fit inline. */
+    std::vector<ReplaceableEntry*> overflow;
+
+    /** Number of candidates in the buffer. */
+    std::size_t count;
+
+  public:
+    CandidateBuffer() : count(0) {}
+
+    CandidateBuffer(const CandidateBuffer &) = delete;
+    CandidateBuffer &operator=(const CandidateBuffer &) = delete;
+
+    /** Drop all the candidates. */
+    void
+    clear()
+    {
+        overflow.clear();
+        count = 0;
+    }
+
+    /** Add a candidate. */
+    void
+    push_back(ReplaceableEntry* entry)
+    {
+        if (count < InlineSize) {
+            inlineEntries[count] = entry;
+        } else {
+            if (count == InlineSize) {
+                overflow.assign(inlineEntries, inlineEntries + InlineSize);
+            }
+            overflow.push_back(entry);
+        }
+        ++count;
+    }
+
+    std::size_t size() const { return count; }
+
+    /** Get a view of the candidates in the buffer. */
+    ReplacementCandidates
+    candidates() const
+    {
+        return ReplacementCandidates(
+            count <= InlineSize ? inlineEntries : overflow.data(), count);
+    }
+};
+
 #endif // __MEM_CACHE_REPLACEMENT_POLICIES_REPLACEABLE_ENTRY_HH_
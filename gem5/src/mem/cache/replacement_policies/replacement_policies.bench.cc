@@ -0,0 +1,188 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <vector>
+
+#include "base/bench/benchmark.hh"
+#include "mem/cache/replacement_policies/brrip_rp.hh"
+#include "mem/cache/replacement_policies/fifo_rp.hh"
+#include "mem/cache/replacement_policies/lru_rp.hh"
+#include "mem/cache/replacement_policies/random_rp.hh"
+#include "mem/cache/replacement_policies/tree_plru_rp.hh"
+#include "params/BRRIPRP.hh"
+#include "params/FIFORP.hh"
+#include "params/LRURP.hh"
+#include "params/RandomRP.hh"
+#include "params/TreePLRURP.hh"
+
+namespace {
+
+const unsigned assoc = 16;
+const unsigned blkSize = 64;
+
+/**
+ * A set associative tag array, with just enough of a cache around the
+ * replacement policy to drive it with an address stream: the blocks
+ * of the set are searched, a hit touches the block, and a miss
+ * replaces the victim picked by the policy.
+ */
+class TagArray
+{
+  private:
+    struct Block : public ReplaceableEntry
+    {
+        Addr tag = MaxAddr;
+    };
+
+    BaseReplacementPolicy &policy;
+    const unsigned numSets;
+    std::vector<Block> blocks;
+    /** Pointers to the blocks, the candidates of a set are a slice */
+    std::vector<ReplaceableEntry *> entries;
+
+  public:
+    TagArray(BaseReplacementPolicy &_policy, unsigned num_sets)
+        : policy(_policy), numSets(num_sets), blocks(num_sets * assoc),
+          entries(num_sets * assoc)
+    {
+        for (unsigned set = 0; set < numSets; ++set) {
+            for (unsigned way = 0; way < assoc; ++way) {
+                Block &blk = blocks[set * assoc + way];
+                blk.setPosition(set, way);
+                blk.replacementData = policy.instantiateEntry();
+                entries[set * assoc + way] = &blk;
+            }
+        }
+    }
+
+    bool
+    access(Addr addr)
+    {
+        const Addr block = addr / blkSize;
+        const unsigned set = block % numSets;
+        const Addr tag = block / numSets;
+
+        Block *ways = &blocks[set * assoc];
+        for (unsigned way = 0; way < assoc; ++way) {
+            if (ways[way].tag == tag) {
+                policy.touch(ways[way].replacementData);
+                return true;
+            }
+        }
+
+        const ReplacementCandidates candidates(&entries[set * assoc], assoc);
+        Block *victim = static_cast<Block *>(policy.getVictim(candidates));
+        victim->tag = tag;
+        policy.reset(victim->replacementData);
+        return false;
+    }
+};
+
+/** Run the address stream through a tag array of state.arg() sets */
+void
+accessTags(Bench::State &state, BaseReplacementPolicy &policy)
+{
+    TagArray tags(policy, state.arg());
+
+    // The footprint is four times the size of the tag array, so there
+    // are hits and misses
+    const auto addrs = Bench::addresses(1 << 16,
+                                        4 * state.arg() * assoc * blkSize);
+    size_t next = 0;
+    uint64_t hits = 0;
+    for (auto _ : state) {
+        hits += tags.access(addrs[next]);
+        next = (next + 1) % addrs.size();
+    }
+    Bench::doNotOptimize(hits);
+    state.setItemsProcessed(state.iterations());
+}
+
+template <class Params>
+void
+initParams(Params &params, const char *name)
+{
+    params.name = name;
+    params.eventq_index = 0;
+}
+
+} // anonymous namespace
+
+static void
+replacementLRU(Bench::State &state)
+{
+    LRURPParams params;
+    initParams(params, "lru");
+    LRURP policy(&params);
+    accessTags(state, policy);
+}
+BENCHMARK(replacementLRU)->arg(64)->arg(1024);
+
+static void
+replacementFIFO(Bench::State &state)
+{
+    FIFORPParams params;
+    initParams(params, "fifo");
+    FIFORP policy(&params);
+    accessTags(state, policy);
+}
+BENCHMARK(replacementFIFO)->arg(64)->arg(1024);
+
+static void
+replacementRandom(Bench::State &state)
+{
+    RandomRPParams params;
+    initParams(params, "random");
+    RandomRP policy(&params);
+    accessTags(state, policy);
+}
+BENCHMARK(replacementRandom)->arg(64)->arg(1024);
+
+static void
+replacementTreePLRU(Bench::State &state)
+{
+    TreePLRURPParams params;
+    initParams(params, "tree_plru");
+    params.num_leaves = assoc;
+    TreePLRURP policy(&params);
+    accessTags(state, policy);
+}
+BENCHMARK(replacementTreePLRU)->arg(64)->arg(1024);
+
+static void
+replacementRRIP(Bench::State &state)
+{
+    BRRIPRPParams params;
+    initParams(params, "rrip");
+    params.num_bits = 2;
+    params.hit_priority = false;
+    params.btp = 100;
+    BRRIPRP policy(&params);
+    accessTags(state, policy);
+}
+BENCHMARK(replacementRRIP)->arg(64)->arg(1024);
@@ -125,6 +125,27 @@ SecondChanceRP::getVictim(const ReplacementCandidates& candidates) const
     return victim;
 }
 
+uint64_t
+SecondChanceRP::getState(
+    const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    std::shared_ptr<SecondChanceReplData> casted_replacement_data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    return (casted_replacement_data->tickInserted << 1) |
+           casted_replacement_data->hasSecondChance;
+}
+
+void
+SecondChanceRP::setState(
+    const std::shared_ptr<ReplacementData>& replacement_data,
+    uint64_t state) const
+{
+    std::shared_ptr<SecondChanceReplData> casted_replacement_data =
+        std::static_pointer_cast<SecondChanceReplData>(replacement_data);
+    casted_replacement_data->tickInserted = state >> 1;
+    casted_replacement_data->hasSecondChance = state & 1;
+}
+
 std::shared_ptr<ReplacementData>
 SecondChanceRP::instantiateEntry()
 {
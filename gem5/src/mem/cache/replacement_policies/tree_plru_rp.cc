@@ -193,6 +193,30 @@ TreePLRURP::getVictim(const ReplacementCandidates& candidates) const
     return candidates[tree_index - (numLeaves - 1)];
 }
 
+uint64_t
+TreePLRURP::getState(
+    const std::shared_ptr<ReplacementData>& replacement_data) const
+{
+    std::shared_ptr<TreePLRUReplData> casted_replacement_data =
+        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    const uint64_t leaf = casted_replacement_data->index - (numLeaves - 1);
+    const PLRUTree* tree = casted_replacement_data->tree.get();
+    return leaf < tree->size() ? (*tree)[leaf] : 0;
+}
+
+void
+TreePLRURP::setState(const std::shared_ptr<ReplacementData>& replacement_data,
+                      uint64_t state) const
+{
+    std::shared_ptr<TreePLRUReplData> casted_replacement_data =
+        std::static_pointer_cast<TreePLRUReplData>(replacement_data);
+    const uint64_t leaf = casted_replacement_data->index - (numLeaves - 1);
+    PLRUTree* tree = casted_replacement_data->tree.get();
+    if (leaf < tree->size()) {
+        (*tree)[leaf] = state;
+    }
+}
+
 std::shared_ptr<ReplacementData>
 TreePLRURP::instantiateEntry()
 {
@@ -0,0 +1,226 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Definitions of a cache split in address-hashed slices.
+ */
+
+#include "mem/cache/sliced_cache.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "debug/Cache.hh"
+#include "mem/cache/mshr.hh"
+#include "mem/cache/tags/indexing_policies/sliced_set_associative.hh"
+#include "params/SlicedCache.hh"
+
+SlicedCache::SlicedCache(const SlicedCacheParams *p)
+    : Cache(p), slicing(p->slice_indexing), numSlices(p->num_slices),
+      sliceLatencies(p->slice_latencies),
+      sliceOccupancy(p->slice_occupancy),
+      mshrsPerSlice(p->mshrs_per_slice), sliceBusyUntil(numSlices, 0),
+      sliceMSHRs(numSlices, 0), fullSlices(0), sliceStats(*this)
+{
+    fatal_if(!slicing, "A sliced cache needs the SlicedSetAssociative "
+             "indexing policy");
+    fatal_if(slicing->getNumSlices() != numSlices, "The indexing policy "
+             "has %d slices, but the cache has %d", slicing->getNumSlices(),
+             numSlices);
+    fatal_if(!sliceLatencies.empty() && sliceLatencies.size() != numSlices,
+             "There must be either no slice latencies or one per slice");
+
+    sliceLatencies.resize(numSlices, Cycles(0));
+}
+
+void
+SlicedCache::recvTimingReq(PacketPtr pkt)
+{
+    // Requests that another cache responds to do not access the banks
+    if (!pkt->cacheResponding()) {
+        const uint32_t slice = slicing->extractSlice(pkt->getAddr());
+
+        // Account for the trip to the slice and the wait for its bank in
+        // the header delay, so that the access, as well as any miss sent
+        // out of the slice, happen after them
+        const Tick arrival = curTick() + pkt->headerDelay +
+            cyclesToTicks(sliceLatencies[slice]);
+        const Tick start = std::max(arrival, sliceBusyUntil[slice]);
+        sliceBusyUntil[slice] = start + cyclesToTicks(sliceOccupancy);
+        pkt->headerDelay = start - curTick();
+
+        DPRINTF(Cache, "%s for %s in slice %d, waited %d ticks for the "
+                "bank\n", __func__, pkt->print(), slice, start - arrival);
+
+        sliceStats.sliceAccesses[slice]++;
+        sliceStats.sliceBankConflictCycles[slice] +=
+            ticksToCycles(start - arrival);
+    }
+
+    Cache::recvTimingReq(pkt);
+}
+
+Tick
+SlicedCache::recvAtomic(PacketPtr pkt)
+{
+    if (pkt->cacheResponding()) {
+        return Cache::recvAtomic(pkt);
+    }
+
+    // Bank contention is only modelled in timing mode
+    const uint32_t slice = slicing->extractSlice(pkt->getAddr());
+    sliceStats.sliceAccesses[slice]++;
+
+    return Cache::recvAtomic(pkt) + cyclesToTicks(sliceLatencies[slice]);
+}
+
+MSHR *
+SlicedCache::allocateMissBuffer(PacketPtr pkt, Tick time, bool sched_send)
+{
+    MSHR *mshr = Cache::allocateMissBuffer(pkt, time, sched_send);
+
+    if (mshrsPerSlice) {
+        // The entry may have been released and allocated again while in
+        // a single call to the base cache
+        releaseSliceMSHR(mshr);
+
+        const uint32_t slice = slicing->extractSlice(pkt->getAddr());
+        mshrSlices[mshr] = slice;
+        if (++sliceMSHRs[slice] == mshrsPerSlice) {
+            ++fullSlices;
+            sliceStats.sliceMSHRFull[slice]++;
+        }
+
+        updateSliceBlocking();
+    }
+
+    return mshr;
+}
+
+void
+SlicedCache::recvTimingResp(PacketPtr pkt)
+{
+    // The packet may be gone after it has been handled
+    const MSHR *mshr = dynamic_cast<const MSHR*>(pkt->senderState);
+
+    Cache::recvTimingResp(pkt);
+
+    // An MSHR in use always has targets
+    if (mshrsPerSlice && mshr && !mshr->hasTargets()) {
+        releaseSliceMSHR(mshr);
+        updateSliceBlocking();
+    }
+}
+
+bool
+SlicedCache::sendMSHRQueuePacket(MSHR* mshr)
+{
+    const bool waiting_retry = Cache::sendMSHRQueuePacket(mshr);
+
+    // Squashed prefetches release their MSHR without being sent
+    if (mshrsPerSlice && !mshr->hasTargets()) {
+        releaseSliceMSHR(mshr);
+        updateSliceBlocking();
+    }
+
+    return waiting_retry;
+}
+
+void
+SlicedCache::releaseSliceMSHR(const MSHR *mshr)
+{
+    auto it = mshrSlices.find(mshr);
+    if (it == mshrSlices.end()) {
+        return;
+    }
+
+    const uint32_t slice = it->second;
+    mshrSlices.erase(it);
+    if (sliceMSHRs[slice]-- == mshrsPerSlice) {
+        --fullSlices;
+    }
+}
+
+void
+SlicedCache::updateSliceBlocking()
+{
+    // Slices share the blocking cause of a full MSHR queue, so do not
+    // unblock while the queue itself is full, and block again if the
+    // queue got unblocked while a slice is still full
+    const bool blocked_mshrs = blocked & (1 << Blocked_NoMSHRs);
+    if (fullSlices && !blocked_mshrs) {
+        setBlocked(Blocked_NoMSHRs);
+    } else if (!fullSlices && blocked_mshrs && !mshrQueue.isFull()) {
+        clearBlocked(Blocked_NoMSHRs);
+    }
+}
+
+SlicedCache::SlicedCacheStats::SlicedCacheStats(SlicedCache &c)
+    : Stats::Group(&c), cache(c),
+
+    sliceAccesses(this, "slice_accesses",
+                  "number of requests serviced by each slice"),
+    sliceBankConflictCycles(this, "slice_bank_conflict_cycles",
+                            "cycles requests waited for the bank of each "
+                            "slice"),
+    sliceMSHRFull(this, "slice_mshr_full",
+                  "number of times each slice ran out of MSHRs")
+{
+}
+
+void
+SlicedCache::SlicedCacheStats::regStats()
+{
+    using namespace Stats;
+
+    Stats::Group::regStats();
+
+    sliceAccesses
+        .init(cache.numSlices)
+        .flags(total | nozero | nonan)
+        ;
+    sliceBankConflictCycles
+        .init(cache.numSlices)
+        .flags(total | nozero | nonan)
+        ;
+    sliceMSHRFull
+        .init(cache.numSlices)
+        .flags(total | nozero | nonan)
+        ;
+}
+
+SlicedCache*
+SlicedCacheParams::create()
+{
+    assert(tags);
+    assert(replacement_policy);
+
+    return new SlicedCache(this);
+}
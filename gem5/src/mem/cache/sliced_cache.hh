@@ -0,0 +1,142 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Describes a cache split in address-hashed slices.
+ */
+
+#ifndef __MEM_CACHE_SLICED_CACHE_HH__
+#define __MEM_CACHE_SLICED_CACHE_HH__
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "base/types.hh"
+#include "mem/cache/cache.hh"
+#include "mem/packet.hh"
+#include "sim/clocked_object.hh"
+
+class MSHR;
+class SlicedSetAssociative;
+struct SlicedCacheParams;
+
+/**
+ * A coherent cache made of several slices, such as the shared last-level
+ * cache of a mesh, modelled as a single object rather than as a cache per
+ * slice behind a crossbar with interleaved address ranges.
+ *
+ * The slice of an address is selected by the SlicedSetAssociative indexing
+ * policy of the tags. Every request first travels to its slice, which
+ * adds the slice's latency, and then waits for the slice's bank to be
+ * free, each access keeping the bank busy for a number of cycles. Each
+ * slice may also be limited to a number of outstanding misses. As the
+ * cache has a single CPU-side port, it stops accepting requests whenever
+ * a slice runs out of MSHRs.
+ */
+class SlicedCache : public Cache
+{
+  protected:
+    /** The indexing policy that maps addresses to slices. */
+    const SlicedSetAssociative *slicing;
+
+    /** The number of slices. */
+    const uint32_t numSlices;
+
+    /** The latency to reach each slice. */
+    std::vector<Cycles> sliceLatencies;
+
+    /** The cycles a slice's bank is busy on each access. */
+    const Cycles sliceOccupancy;
+
+    /** The number of MSHRs of each slice, 0 if unlimited. */
+    const unsigned mshrsPerSlice;
+
+    /** Tick at which the bank of each slice is free again. */
+    std::vector<Tick> sliceBusyUntil;
+
+    /** The number of MSHRs in use by each slice. */
+    std::vector<unsigned> sliceMSHRs;
+
+    /** The slice of each MSHR in use. */
+    std::unordered_map<const MSHR*, uint32_t> mshrSlices;
+
+    /** The number of slices that have all of their MSHRs in use. */
+    uint32_t fullSlices;
+
+    /**
+     * Release the MSHR of a slice, if the MSHR is accounted for.
+     *
+     * @param mshr The MSHR that was deallocated.
+     */
+    void releaseSliceMSHR(const MSHR *mshr);
+
+    /**
+     * Block the cache if any slice is out of MSHRs, or unblock it once
+     * all of them have free MSHRs again.
+     */
+    void updateSliceBlocking();
+
+    void recvTimingReq(PacketPtr pkt) override;
+
+    void recvTimingResp(PacketPtr pkt) override;
+
+    Tick recvAtomic(PacketPtr pkt) override;
+
+    MSHR *allocateMissBuffer(PacketPtr pkt, Tick time,
+                             bool sched_send = true) override;
+
+    struct SlicedCacheStats : public Stats::Group
+    {
+        SlicedCacheStats(SlicedCache &c);
+
+        void regStats() override;
+
+        const SlicedCache &cache;
+
+        /** Number of requests serviced by each slice. */
+        Stats::Vector sliceAccesses;
+
+        /** Cycles requests waited for the bank of each slice. */
+        Stats::Vector sliceBankConflictCycles;
+
+        /** Number of times each slice ran out of MSHRs. */
+        Stats::Vector sliceMSHRFull;
+    } sliceStats;
+
+  public:
+    /** Instantiates a sliced cache object. */
+    SlicedCache(const SlicedCacheParams *p);
+
+    bool sendMSHRQueuePacket(MSHR* mshr) override;
+};
+
+#endif // __MEM_CACHE_SLICED_CACHE_HH__
@@ -84,6 +84,12 @@ class BaseSetAssoc(BaseTags):
     replacement_policy = Param.BaseReplacementPolicy(
         Parent.replacement_policy, "Replacement policy")
 
+    # Keep a copy of the tag, valid and secure state of each block in
+    # an array packed per set, so that a lookup compares the tags of a
+    # set in one sweep rather than going through the blocks. Requires
+    # a set associative indexing policy.
+    packed_tags = Param.Bool(False, "Look up tags in a packed tag array")
+
 class SectorTags(BaseTags):
     type = 'SectorTags'
     cxx_header = "mem/cache/tags/sector_tags.hh"
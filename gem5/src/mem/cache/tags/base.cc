@@ -65,11 +65,21 @@ BaseTags::BaseTags(const Params *p)
       warmupBound((p->warmup_percentage/100.0) * (p->size / p->block_size)),
       warmedUp(false), numBlocks(p->size / p->block_size),
       dataBlks(new uint8_t[p->size]), // Allocate data storage in one big chunk
+      taskAges(ContextSwitchTaskId::NumTaskId),
       stats(*this)
 {
     registerExitCallback(new BaseTagsCallback(this));
 }
 
+BaseTags::TaskAges::TaskAges()
+{
+    for (unsigned i = 0; i < NumAgeBuckets; ++i) {
+        youngest[i] = nullptr;
+        oldest[i] = nullptr;
+        count[i] = 0;
+    }
+}
+
 ReplaceableEntry*
 BaseTags::findBlockBySetAndWay(int set, int way) const
 {
@@ -83,8 +93,9 @@ BaseTags::findBlock(Addr addr, bool is_secure) const
     Addr tag = extractTag(addr);
 
     // Find possible entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
 
     // Search for block
     for (const auto& location : entries) {
@@ -115,6 +126,7 @@ BaseTags::insertBlock(const PacketPtr pkt, CacheBlk *blk)
     // Insert block with tag, src master id and task id
     blk->insert(extractTag(pkt->getAddr()), pkt->isSecure(), master_id,
                 pkt->req->taskId());
+    insertAge(blk);
 
     // Check if cache warm up is done
     if (!warmedUp && stats.tagsInUse.value() >= warmupBound) {
@@ -149,41 +161,95 @@ BaseTags::cleanupRefs()
 }
 
 void
-BaseTags::computeStatsVisitor(CacheBlk &blk)
+BaseTags::pushAge(TaskAges &ages, CacheBlk *blk, unsigned bucket)
 {
-    if (blk.isValid()) {
-        assert(blk.task_id < ContextSwitchTaskId::NumTaskId);
-        stats.occupanciesTaskId[blk.task_id]++;
-        assert(blk.tickInserted <= curTick());
-        Tick age = curTick() - blk.tickInserted;
-
-        int age_index;
-        if (age / SimClock::Int::us < 10) { // <10us
-            age_index = 0;
-        } else if (age / SimClock::Int::us < 100) { // <100us
-            age_index = 1;
-        } else if (age / SimClock::Int::ms < 1) { // <1ms
-            age_index = 2;
-        } else if (age / SimClock::Int::ms < 10) { // <10ms
-            age_index = 3;
-        } else
-            age_index = 4; // >10ms
-
-        stats.ageTaskId[blk.task_id][age_index]++;
+    blk->ageBucket = bucket;
+    blk->ageYounger = nullptr;
+    blk->ageOlder = ages.youngest[bucket];
+    if (ages.youngest[bucket]) {
+        ages.youngest[bucket]->ageYounger = blk;
+    } else {
+        ages.oldest[bucket] = blk;
     }
+    ages.youngest[bucket] = blk;
+    ++ages.count[bucket];
+}
+
+void
+BaseTags::unlinkAge(TaskAges &ages, CacheBlk *blk)
+{
+    const unsigned bucket = blk->ageBucket;
+    assert(ages.count[bucket] > 0);
+
+    if (blk->ageYounger) {
+        blk->ageYounger->ageOlder = blk->ageOlder;
+    } else {
+        ages.youngest[bucket] = blk->ageOlder;
+    }
+    if (blk->ageOlder) {
+        blk->ageOlder->ageYounger = blk->ageYounger;
+    } else {
+        ages.oldest[bucket] = blk->ageYounger;
+    }
+    blk->ageYounger = nullptr;
+    blk->ageOlder = nullptr;
+    --ages.count[bucket];
+}
+
+void
+BaseTags::insertAge(CacheBlk *blk)
+{
+    assert(blk->task_id < ContextSwitchTaskId::NumTaskId);
+    std::unique_ptr<TaskAges> &ages = taskAges[blk->task_id];
+    if (!ages)
+        ages.reset(new TaskAges());
+    pushAge(*ages, blk, 0);
+}
+
+void
+BaseTags::removeAge(CacheBlk *blk)
+{
+    assert(blk->task_id < ContextSwitchTaskId::NumTaskId);
+    assert(taskAges[blk->task_id]);
+    unlinkAge(*taskAges[blk->task_id], blk);
 }
 
 void
 BaseTags::computeStats()
 {
+    // Minimum age of the blocks in each bucket but the first one
+    const Tick min_age[NumAgeBuckets - 1] = {
+        10 * SimClock::Int::us, // >=10us
+        100 * SimClock::Int::us, // >=100us
+        SimClock::Int::ms, // >=1ms
+        10 * SimClock::Int::ms, // >=10ms
+    };
+
     for (unsigned i = 0; i < ContextSwitchTaskId::NumTaskId; ++i) {
-        stats.occupanciesTaskId[i] = 0;
-        for (unsigned j = 0; j < 5; ++j) {
-            stats.ageTaskId[i][j] = 0;
+        TaskAges *ages = taskAges[i].get();
+        if (!ages)
+            continue;
+
+        // Blocks have grown older since the last dump, move the ones
+        // that crossed a bucket boundary to the next bucket.
+        for (unsigned j = 0; j < NumAgeBuckets - 1; ++j) {
+            CacheBlk *blk;
+            while ((blk = ages->oldest[j]) != nullptr) {
+                assert(blk->tickInserted <= curTick());
+                if (curTick() - blk->tickInserted < min_age[j])
+                    break;
+                unlinkAge(*ages, blk);
+                pushAge(*ages, blk, j + 1);
+            }
         }
-    }
 
-    forEachBlk([this](CacheBlk &blk) { computeStatsVisitor(blk); });
+        unsigned occupancy = 0;
+        for (unsigned j = 0; j < NumAgeBuckets; ++j) {
+            stats.ageTaskId[i][j] = ages->count[j];
+            occupancy += ages->count[j];
+        }
+        stats.occupanciesTaskId[i] = occupancy;
+    }
 }
 
 std::string
@@ -263,7 +329,7 @@ BaseTags::BaseTagStats::regStats()
         ;
 
     ageTaskId
-        .init(ContextSwitchTaskId::NumTaskId, 5)
+        .init(ContextSwitchTaskId::NumTaskId, NumAgeBuckets)
         .flags(nozero | nonan)
         ;
 
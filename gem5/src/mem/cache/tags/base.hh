@@ -52,7 +52,9 @@
 #include <cassert>
 #include <cstdint>
 #include <functional>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "base/callback.hh"
 #include "base/logging.hh"
@@ -102,6 +104,32 @@ class BaseTags : public ClockedObject
     /** The data blocks, 1 per cache block. */
     std::unique_ptr<uint8_t[]> dataBlks;
 
+    /** Number of age buckets of the age stats. */
+    static const unsigned NumAgeBuckets = 5;
+
+    /**
+     * The valid blocks of a task, kept in one list per age bucket. New
+     * blocks are added as the youngest block of the first bucket, and
+     * blocks only move from the oldest end of a bucket to the youngest
+     * end of the next one, so every list stays sorted by insertion tick.
+     * This makes the occupancy and age stats cheap to maintain since a
+     * stats dump only visits the blocks that changed buckets.
+     */
+    struct TaskAges
+    {
+        /** Youngest block of each bucket. */
+        CacheBlk *youngest[NumAgeBuckets];
+        /** Oldest block of each bucket. */
+        CacheBlk *oldest[NumAgeBuckets];
+        /** Number of blocks in each bucket. */
+        unsigned count[NumAgeBuckets];
+
+        TaskAges();
+    };
+
+    /** Age lists of each task id, allocated when first used. */
+    std::vector<std::unique_ptr<TaskAges>> taskAges;
+
     /**
      * TODO: It would be good if these stats were acquired after warmup.
      */
@@ -260,6 +288,7 @@ class BaseTags : public ClockedObject
         stats.totalRefs += blk->refCount;
         stats.sampledRefs++;
 
+        removeAge(blk);
         blk->invalidate();
     }
 
@@ -340,6 +369,28 @@ class BaseTags : public ClockedObject
      */
     virtual bool anyBlk(std::function<bool(CacheBlk &)> visitor) = 0;
 
+    /**
+     * Get the replacement state of a block, to save it in checkpoints.
+     * When a checkpoint is restored, the states of all blocks are set in
+     * increasing order, so tags without a replacement policy can encode
+     * the recency of their blocks in it.
+     *
+     * @param blk The block.
+     * @return The replacement state of the block.
+     */
+    virtual uint64_t getReplacementState(const CacheBlk *blk) const
+    {
+        return 0;
+    }
+
+    /**
+     * Restore the replacement state of a block from a checkpoint.
+     *
+     * @param blk The block.
+     * @param state The state returned by getReplacementState().
+     */
+    virtual void setReplacementState(CacheBlk *blk, uint64_t state) {}
+
   private:
     /**
      * Update the reference stats using data from the input block
@@ -349,11 +400,36 @@ class BaseTags : public ClockedObject
     void cleanupRefsVisitor(CacheBlk &blk);
 
     /**
-     * Update the occupancy and age stats using data from the input block
+     * Add a newly inserted block to the age list of its task.
      *
-     * @param blk The input block
+     * @param blk The inserted block.
+     */
+    void insertAge(CacheBlk *blk);
+
+    /**
+     * Remove a block that is about to be invalidated from the age list of
+     * its task.
+     *
+     * @param blk The block to remove.
+     */
+    void removeAge(CacheBlk *blk);
+
+    /**
+     * Add a block as the youngest block of an age bucket.
+     *
+     * @param ages The age lists of the block's task.
+     * @param blk The block to add.
+     * @param bucket The age bucket.
+     */
+    void pushAge(TaskAges &ages, CacheBlk *blk, unsigned bucket);
+
+    /**
+     * Unlink a block from the age bucket it is in.
+     *
+     * @param ages The age lists of the block's task.
+     * @param blk The block to unlink.
      */
-    void computeStatsVisitor(CacheBlk &blk);
+    void unlinkAge(TaskAges &ages, CacheBlk *blk);
 };
 
 class BaseTagsCallback : public Callback
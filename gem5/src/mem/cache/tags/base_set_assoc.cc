@@ -47,19 +47,33 @@
 
 #include "mem/cache/tags/base_set_assoc.hh"
 
+#include <algorithm>
 #include <string>
 
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 
+const Addr BaseSetAssoc::InvalidKey;
+
 BaseSetAssoc::BaseSetAssoc(const Params *p)
     :BaseTags(p), allocAssoc(p->assoc), blks(p->size / p->block_size),
      sequentialAccess(p->sequential_access),
-     replacementPolicy(p->replacement_policy)
+     replacementPolicy(p->replacement_policy), assoc(p->assoc),
+     packedTags(p->packed_tags),
+     setIndexing(dynamic_cast<SetAssociative*>(p->indexing_policy))
 {
     // Check parameters
     if (blkSize < 4 || !isPowerOf2(blkSize)) {
         fatal("Block size must be at least 4 and a power of 2");
     }
+
+    fatal_if(packedTags && !setIndexing, "Packed tags require a set "
+             "associative indexing policy");
+
+    if (packedTags) {
+        tagKeys.resize(numBlocks, InvalidKey);
+        keyBlks.resize(numBlocks, nullptr);
+    }
 }
 
 void
@@ -78,6 +92,9 @@ BaseSetAssoc::tagsInit()
 
         // Associate a replacement data entry to the block
         blk->replacementData = replacementPolicy->instantiateEntry();
+
+        if (packedTags)
+            keyBlks[blk->getSet() * assoc + blk->getWay()] = blk;
     }
 }
 
@@ -91,6 +108,33 @@ BaseSetAssoc::invalidate(CacheBlk *blk)
 
     // Invalidate replacement data
     replacementPolicy->invalidate(blk->replacementData);
+
+    updateKey(blk);
+}
+
+CacheBlk*
+BaseSetAssoc::findBlock(Addr addr, bool is_secure) const
+{
+    if (!packedTags)
+        return BaseTags::findBlock(addr, is_secure);
+
+    const Addr key = tagKey(extractTag(addr), is_secure);
+    const unsigned first = setIndexing->extractSet(addr) * assoc;
+    const Addr *keys = &tagKeys[first];
+
+    // Compare up to 64 ways in a branch-free sweep the compiler can
+    // vectorize, and only then pick the matching way, if any
+    for (unsigned base = 0; base < assoc; base += 64) {
+        const unsigned ways = std::min(assoc - base, 64U);
+        uint64_t hits = 0;
+        for (unsigned way = 0; way < ways; ++way)
+            hits |= uint64_t(keys[base + way] == key) << way;
+
+        if (hits)
+            return keyBlks[first + base + ctz64(hits)];
+    }
+
+    return nullptr;
 }
 
 BaseSetAssoc *
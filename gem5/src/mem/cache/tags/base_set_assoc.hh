@@ -61,6 +61,7 @@
 #include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "mem/cache/tags/base.hh"
 #include "mem/cache/tags/indexing_policies/base.hh"
+#include "mem/cache/tags/indexing_policies/set_associative.hh"
 #include "mem/packet.hh"
 #include "params/BaseSetAssoc.hh"
 
@@ -86,6 +87,52 @@ class BaseSetAssoc : public BaseTags
     /** Replacement policy */
     BaseReplacementPolicy *replacementPolicy;
 
+    /** The associativity of the cache. */
+    const unsigned assoc;
+
+    /** Whether lookups go through the packed tag array. */
+    const bool packedTags;
+
+    /**
+     * The set associative indexing policy, only used with packed
+     * tags, where the set of an address must not depend on the way.
+     */
+    SetAssociative *setIndexing;
+
+    /**
+     * Lookup keys of the blocks, indexed by set and way. A key holds
+     * the tag and the secure bit of a valid block, and InvalidKey if
+     * the block is not valid.
+     */
+    std::vector<Addr> tagKeys;
+
+    /** The blocks, in the same order as the keys. */
+    std::vector<CacheBlk*> keyBlks;
+
+    /** Key of a block that is not valid. */
+    static const Addr InvalidKey = MaxAddr;
+
+    /**
+     * Build the lookup key of a block. Tags are shifted down
+     * addresses, so there is always room for the secure bit.
+     */
+    static Addr
+    tagKey(Addr tag, bool is_secure)
+    {
+        return tag << 1 | (is_secure ? 1 : 0);
+    }
+
+    /** Update the lookup key of a block after it changed. */
+    void
+    updateKey(const CacheBlk *blk)
+    {
+        if (packedTags) {
+            tagKeys[blk->getSet() * assoc + blk->getWay()] =
+                blk->isValid() ? tagKey(blk->tag, blk->isSecure()) :
+                                 InvalidKey;
+        }
+    }
+
   public:
     /** Convenience typedef. */
      typedef BaseSetAssocParams Params;
@@ -113,6 +160,16 @@ class BaseSetAssoc : public BaseTags
      */
     void invalidate(CacheBlk *blk) override;
 
+    /**
+     * Find a block, comparing all the keys of the set at once when
+     * using packed tags.
+     *
+     * @param addr The address to find.
+     * @param is_secure True if the target memory space is secure.
+     * @return Pointer to the cache block if found.
+     */
+    CacheBlk *findBlock(Addr addr, bool is_secure) const override;
+
     /**
      * Access block and update replacement data. May not succeed, in which case
      * nullptr is returned. This has all the implications of a cache access and
@@ -170,8 +227,9 @@ class BaseSetAssoc : public BaseTags
                          std::vector<CacheBlk*>& evict_blks) const override
     {
         // Get possible entries to be victimized
-        const std::vector<ReplaceableEntry*> entries =
-            indexingPolicy->getPossibleEntries(addr);
+        CandidateBuffer buffer;
+        const ReplacementCandidates entries =
+            indexingPolicy->getPossibleEntries(addr, buffer);
 
         // Choose replacement victim from replacement candidates
         CacheBlk* victim = static_cast<CacheBlk*>(replacementPolicy->getVictim(
@@ -193,6 +251,7 @@ class BaseSetAssoc : public BaseTags
     {
         // Insert block
         BaseTags::insertBlock(pkt, blk);
+        updateKey(blk);
 
         // Increment tag counter
         stats.tagsInUse++;
@@ -245,6 +304,16 @@ class BaseSetAssoc : public BaseTags
         }
         return false;
     }
+
+    uint64_t getReplacementState(const CacheBlk *blk) const override
+    {
+        return replacementPolicy->getState(blk->replacementData);
+    }
+
+    void setReplacementState(CacheBlk *blk, uint64_t state) override
+    {
+        replacementPolicy->setState(blk->replacementData, state);
+    }
 };
 
 #endif //__MEM_CACHE_TAGS_BASE_SET_ASSOC_HH__
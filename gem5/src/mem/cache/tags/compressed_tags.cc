@@ -106,8 +106,9 @@ CompressedTags::findVictim(Addr addr, const bool is_secure,
                            std::vector<CacheBlk*>& evict_blks) const
 {
     // Get all possible locations of this superblock
-    const std::vector<ReplaceableEntry*> superblock_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates superblock_entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
 
     // Check if the superblock this address belongs to has been allocated. If
     // so, try co-allocating
@@ -229,6 +229,23 @@ FALRU::insertBlock(const PacketPtr pkt, CacheBlk *blk)
     tagHash[std::make_pair(blk->tag, blk->isSecure())] = falruBlk;
 }
 
+uint64_t
+FALRU::getReplacementState(const CacheBlk *blk) const
+{
+    uint64_t position = 0;
+    for (const FALRUBlk* it = tail; it != blk; it = it->prev) {
+        assert(it != nullptr);
+        position++;
+    }
+    return position;
+}
+
+void
+FALRU::setReplacementState(CacheBlk *blk, uint64_t state)
+{
+    moveToHead(static_cast<FALRUBlk*>(blk));
+}
+
 void
 FALRU::moveToHead(FALRUBlk *blk)
 {
@@ -272,6 +272,24 @@ class FALRU : public BaseTags
         return false;
     }
 
+    /**
+     * Get the position of a block in the LRU list, counting from the tail,
+     * so that blocks are moved to the head from the LRU to the MRU when
+     * restoring a checkpoint.
+     *
+     * @param blk The block.
+     * @return The number of blocks less recently used than blk.
+     */
+    uint64_t getReplacementState(const CacheBlk *blk) const override;
+
+    /**
+     * Make a block the MRU.
+     *
+     * @param blk The block.
+     * @param state The state returned by getReplacementState().
+     */
+    void setReplacementState(CacheBlk *blk, uint64_t state) override;
+
   private:
     /**
      * Mechanism that allows us to simultaneously collect miss
@@ -53,3 +53,15 @@ class SkewedAssociative(BaseIndexingPolicy):
     type = 'SkewedAssociative'
     cxx_class = 'SkewedAssociative'
     cxx_header = "mem/cache/tags/indexing_policies/skewed_associative.hh"
+
+class SlicedSetAssociative(BaseIndexingPolicy):
+    type = 'SlicedSetAssociative'
+    cxx_class = 'SlicedSetAssociative'
+    cxx_header = \
+        "mem/cache/tags/indexing_policies/sliced_set_associative.hh"
+
+    # Get the slicing from the parent (cache)
+    num_slices = Param.Unsigned(Parent.num_slices, "number of slices")
+    slice_hash_bits = Param.Unsigned(Parent.slice_hash_bits,
+        "number of address bits above the set index of a slice that are " \
+        "folded to select the slice (0 for all)")
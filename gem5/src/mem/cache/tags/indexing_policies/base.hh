@@ -52,11 +52,10 @@
 
 #include <vector>
 
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
 #include "params/BaseIndexingPolicy.hh"
 #include "sim/sim_object.hh"
 
-class ReplaceableEntry;
-
 /**
  * A common base class for indexing table locations. Classes that inherit
  * from it determine hash functions that should be applied based on the set
@@ -143,11 +142,33 @@ class BaseIndexingPolicy : public SimObject
      * Should be called immediately before ReplacementPolicy's findVictim()
      * not to break cache resizing.
      *
+     * The entries are either a view of the policy's own sets or are
+     * gathered in the given buffer, so no allocation happens in the
+     * common case. The returned candidates are only valid as long as
+     * the buffer, and until the next call using the same buffer.
+     *
      * @param addr The addr to a find possible entries for.
+     * @param buffer Storage for entries that must be gathered.
      * @return The possible entries.
      */
-    virtual std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr)
-                                                                    const = 0;
+    virtual ReplacementCandidates getPossibleEntries(const Addr addr,
+        CandidateBuffer &buffer) const = 0;
+
+    /**
+     * Find all possible entries for insertion and replacement of an address
+     * and copy them to a vector. Prefer the buffer based version on hot
+     * paths.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @return The possible entries.
+     */
+    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
+    {
+        CandidateBuffer buffer;
+        const ReplacementCandidates entries =
+            getPossibleEntries(addr, buffer);
+        return std::vector<ReplaceableEntry*>(entries.begin(), entries.end());
+    }
 
     /**
      * Regenerate an entry's address from its tag and assigned indexing bits.
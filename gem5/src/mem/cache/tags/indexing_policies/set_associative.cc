@@ -69,8 +69,9 @@ SetAssociative::regenerateAddr(const Addr tag, const ReplaceableEntry* entry)
     return (tag << tagShift) | (entry->getSet() << setShift);
 }
 
-std::vector<ReplaceableEntry*>
-SetAssociative::getPossibleEntries(const Addr addr) const
+ReplacementCandidates
+SetAssociative::getPossibleEntries(const Addr addr,
+                                   CandidateBuffer &buffer) const
 {
     return sets[extractSet(addr)];
 }
@@ -81,7 +81,7 @@ class ReplaceableEntry;
  */
 class SetAssociative : public BaseIndexingPolicy
 {
-  private:
+  public:
     /**
      * Apply a hash function to calculate address set.
      *
@@ -90,7 +90,6 @@ class SetAssociative : public BaseIndexingPolicy
      */
     uint32_t extractSet(const Addr addr) const;
 
-  public:
     /**
      * Convenience typedef.
      */
@@ -111,12 +110,15 @@ class SetAssociative : public BaseIndexingPolicy
      * Should be called immediately before ReplacementPolicy's findVictim()
      * not to break cache resizing.
      * Returns entries in all ways belonging to the set of the address.
+     * The entries are a view of the set itself, so the buffer is unused.
      *
      * @param addr The addr to a find possible entries for.
+     * @param buffer Storage for entries that must be gathered.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                     override;
+    ReplacementCandidates getPossibleEntries(const Addr addr,
+        CandidateBuffer &buffer) const override;
+    using BaseIndexingPolicy::getPossibleEntries;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
@@ -205,18 +205,19 @@ SkewedAssociative::regenerateAddr(const Addr tag,
            ((deskew(addr_set, entry->getWay()) & setMask) << setShift);
 }
 
-std::vector<ReplaceableEntry*>
-SkewedAssociative::getPossibleEntries(const Addr addr) const
+ReplacementCandidates
+SkewedAssociative::getPossibleEntries(const Addr addr,
+                                      CandidateBuffer &buffer) const
 {
-    std::vector<ReplaceableEntry*> entries;
+    buffer.clear();
 
     // Parse all ways
     for (uint32_t way = 0; way < assoc; ++way) {
         // Apply hash to get set, and get way entry in it
-        entries.push_back(sets[extractSet(addr, way)][way]);
+        buffer.push_back(sets[extractSet(addr, way)][way]);
     }
 
-    return entries;
+    return buffer.candidates();
 }
 
 SkewedAssociative *
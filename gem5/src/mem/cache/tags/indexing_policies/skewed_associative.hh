@@ -157,10 +157,12 @@ class SkewedAssociative : public BaseIndexingPolicy
      * not to break cache resizing.
      *
      * @param addr The addr to a find possible entries for.
+     * @param buffer Storage the entries of each way are gathered in.
      * @return The possible entries.
      */
-    std::vector<ReplaceableEntry*> getPossibleEntries(const Addr addr) const
-                                                                   override;
+    ReplacementCandidates getPossibleEntries(const Addr addr,
+        CandidateBuffer &buffer) const override;
+    using BaseIndexingPolicy::getPossibleEntries;
 
     /**
      * Regenerate an entry's address from its tag and assigned set and way.
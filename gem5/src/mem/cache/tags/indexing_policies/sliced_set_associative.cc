@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Definitions of a sliced set associative indexing policy.
+ */
+
+#include "mem/cache/tags/indexing_policies/sliced_set_associative.hh"
+
+#include "base/bitfield.hh"
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "mem/cache/replacement_policies/replaceable_entry.hh"
+
+SlicedSetAssociative::SlicedSetAssociative(const Params *p)
+    : BaseIndexingPolicy(p), numSlices(p->num_slices),
+      sliceBits(floorLog2(numSlices)), setsPerSlice(numSets / numSlices),
+      sliceSetBits(floorLog2(setsPerSlice)),
+      hashShift(setShift + sliceSetBits),
+      hashMask(p->slice_hash_bits ? mask(p->slice_hash_bits) : ~Addr(0))
+{
+    fatal_if(!isPowerOf2(numSlices), "The number of slices must be non-zero "
+             "and a power of 2");
+    fatal_if(numSlices > numSets, "There must be at least one set per "
+             "slice");
+    fatal_if(p->slice_hash_bits && p->slice_hash_bits < sliceBits,
+             "At least %d address bits must be hashed to select among %d "
+             "slices", sliceBits, numSlices);
+}
+
+uint32_t
+SlicedSetAssociative::fold(Addr bits) const
+{
+    if (sliceBits == 0) {
+        return 0;
+    }
+
+    uint32_t folded = 0;
+    for (; bits; bits >>= sliceBits) {
+        folded ^= bits & (numSlices - 1);
+    }
+    return folded;
+}
+
+uint32_t
+SlicedSetAssociative::extractSlice(const Addr addr) const
+{
+    return fold((addr >> hashShift) & hashMask);
+}
+
+uint32_t
+SlicedSetAssociative::extractSet(const Addr addr) const
+{
+    return (extractSlice(addr) << sliceSetBits) |
+        ((addr >> setShift) & (setsPerSlice - 1));
+}
+
+Addr
+SlicedSetAssociative::regenerateAddr(const Addr tag,
+                                     const ReplaceableEntry* entry) const
+{
+    const uint32_t set = entry->getSet();
+    const uint32_t slice = set >> sliceSetBits;
+
+    // The tag holds all the folded bits but the lowest ones, which have
+    // to be the remaining difference to the folded value.
+    const Addr low_bits = slice ^ fold(tag & (hashMask >> sliceBits));
+
+    return (tag << tagShift) | (low_bits << hashShift) |
+        ((set & (setsPerSlice - 1)) << setShift);
+}
+
+ReplacementCandidates
+SlicedSetAssociative::getPossibleEntries(const Addr addr,
+                                         CandidateBuffer &buffer) const
+{
+    return sets[extractSet(addr)];
+}
+
+SlicedSetAssociative*
+SlicedSetAssociativeParams::create()
+{
+    return new SlicedSetAssociative(this);
+}
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Declaration of a sliced set associative indexing policy.
+ */
+
+#ifndef __MEM_CACHE_INDEXING_POLICIES_SLICED_SET_ASSOCIATIVE_HH__
+#define __MEM_CACHE_INDEXING_POLICIES_SLICED_SET_ASSOCIATIVE_HH__
+
+#include "base/types.hh"
+#include "mem/cache/tags/indexing_policies/base.hh"
+#include "params/SlicedSetAssociative.hh"
+
+class ReplaceableEntry;
+
+/**
+ * A set associative indexing policy for caches that are physically split
+ * in slices, such as the shared last-level cache of a mesh. The sets are
+ * evenly distributed among the slices, and each slice is indexed as a
+ * regular set associative cache by the address bits directly above the
+ * block offset.
+ *
+ * The slice of an address is found by XOR-folding the address bits above
+ * the slice's set index into as many bits as needed to identify a slice,
+ * so that consecutive pages and strided accesses are spread over all
+ * slices. As the lowest folded bits are not part of the tag, they are
+ * recovered from the slice when regenerating an address.
+ *
+ * @sa \ref gem5MemorySystem "gem5 Memory System"
+ */
+class SlicedSetAssociative : public BaseIndexingPolicy
+{
+  protected:
+    /** The number of slices. */
+    const uint32_t numSlices;
+
+    /** The number of bits needed to identify a slice. */
+    const int sliceBits;
+
+    /** The number of sets in each slice. */
+    const uint32_t setsPerSlice;
+
+    /** The number of set index bits within a slice. */
+    const int sliceSetBits;
+
+    /** The amount to shift the address to get the bits to be folded. */
+    const int hashShift;
+
+    /** Mask of the folded bits, after shifting them by hashShift. */
+    const Addr hashMask;
+
+    /**
+     * XOR-fold a value into sliceBits bits.
+     *
+     * @param bits The value to fold.
+     * @return The folded value.
+     */
+    uint32_t fold(Addr bits) const;
+
+  public:
+    /** Convenience typedef. */
+    typedef SlicedSetAssociativeParams Params;
+
+    /**
+     * Construct and initialize this policy.
+     */
+    SlicedSetAssociative(const Params *p);
+
+    /**
+     * Destructor.
+     */
+    ~SlicedSetAssociative() {};
+
+    /**
+     * Get the number of slices.
+     *
+     * @return The number of slices.
+     */
+    uint32_t getNumSlices() const { return numSlices; }
+
+    /**
+     * Calculate the slice an address maps to.
+     *
+     * @param addr The address to calculate the slice for.
+     * @return The slice index.
+     */
+    uint32_t extractSlice(const Addr addr) const;
+
+    /**
+     * Calculate the set of an address. The sets of a slice are contiguous.
+     *
+     * @param addr The address to calculate the set for.
+     * @return The set index.
+     */
+    uint32_t extractSet(const Addr addr) const;
+
+    /**
+     * Find all possible entries for insertion and replacement of an address.
+     * Returns entries in all ways belonging to the set of the address.
+     * The entries are a view of the set itself, so the buffer is unused.
+     *
+     * @param addr The addr to a find possible entries for.
+     * @param buffer Storage for entries that must be gathered.
+     * @return The possible entries.
+     */
+    ReplacementCandidates getPossibleEntries(const Addr addr,
+        CandidateBuffer &buffer) const override;
+    using BaseIndexingPolicy::getPossibleEntries;
+
+    /**
+     * Regenerate an entry's address from its tag and assigned set. The
+     * slice of the set is used to undo the folding.
+     *
+     * @param tag The tag bits.
+     * @param entry The entry.
+     * @return the entry's original addr value.
+     */
+    Addr regenerateAddr(const Addr tag, const ReplaceableEntry* entry) const
+                                                                   override;
+};
+
+#endif //__MEM_CACHE_INDEXING_POLICIES_SLICED_SET_ASSOCIATIVE_HH__
@@ -204,8 +204,9 @@ SectorTags::findBlock(Addr addr, bool is_secure) const
     const Addr offset = extractSectorOffset(addr);
 
     // Find all possible sector entries that may contain the given address
-    const std::vector<ReplaceableEntry*> entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
 
     // Search for block
     for (const auto& sector : entries) {
@@ -225,8 +226,9 @@ SectorTags::findVictim(Addr addr, const bool is_secure, const std::size_t size,
                        std::vector<CacheBlk*>& evict_blks) const
 {
     // Get possible entries to be victimized
-    const std::vector<ReplaceableEntry*> sector_entries =
-        indexingPolicy->getPossibleEntries(addr);
+    CandidateBuffer buffer;
+    const ReplacementCandidates sector_entries =
+        indexingPolicy->getPossibleEntries(addr, buffer);
 
     // Check if the sector this address belongs to has been allocated
     Addr tag = extractTag(addr);
@@ -290,6 +292,22 @@ SectorTags::forEachBlk(std::function<void(CacheBlk &)> visitor)
     }
 }
 
+uint64_t
+SectorTags::getReplacementState(const CacheBlk *blk) const
+{
+    const SectorBlk* sector_blk =
+        static_cast<const SectorSubBlk*>(blk)->getSectorBlock();
+    return replacementPolicy->getState(sector_blk->replacementData);
+}
+
+void
+SectorTags::setReplacementState(CacheBlk *blk, uint64_t state)
+{
+    const SectorBlk* sector_blk =
+        static_cast<const SectorSubBlk*>(blk)->getSectorBlock();
+    replacementPolicy->setState(sector_blk->replacementData, state);
+}
+
 bool
 SectorTags::anyBlk(std::function<bool(CacheBlk &)> visitor)
 {
@@ -195,6 +195,22 @@ class SectorTags : public BaseTags
      * @param visitor Visitor to call on each block.
      */
     bool anyBlk(std::function<bool(CacheBlk &)> visitor) override;
+
+    /**
+     * Get the replacement state of the sector of a sub-block.
+     *
+     * @param blk The sub-block.
+     * @return The replacement state of its sector.
+     */
+    uint64_t getReplacementState(const CacheBlk *blk) const override;
+
+    /**
+     * Restore the replacement state of the sector of a sub-block.
+     *
+     * @param blk The sub-block.
+     * @param state The state returned by getReplacementState().
+     */
+    void setReplacementState(CacheBlk *blk, uint64_t state) override;
 };
 
 #endif //__MEM_CACHE_TAGS_SECTOR_TAGS_HH__
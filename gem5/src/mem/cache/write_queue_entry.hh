@@ -54,6 +54,7 @@
 #include <list>
 #include <string>
 
+#include "base/pool_allocator.hh"
 #include "base/printable.hh"
 #include "base/types.hh"
 #include "mem/cache/queue_entry.hh"
@@ -76,7 +77,7 @@ class WriteQueueEntry : public QueueEntry, public Printable
     friend class WriteQueue;
 
   public:
-    class TargetList : public std::list<Target> {
+    class TargetList : public std::list<Target, PoolAllocator<Target>> {
 
       public:
 
@@ -88,7 +89,8 @@ class WriteQueueEntry : public QueueEntry, public Printable
     };
 
     /** A list of write queue entriess. */
-    typedef std::list<WriteQueueEntry *> List;
+    typedef std::list<WriteQueueEntry *,
+                      PoolAllocator<WriteQueueEntry *>> List;
     /** WriteQueueEntry list iterator. */
     typedef List::iterator Iterator;
 
@@ -50,6 +50,8 @@
 
 #include "mem/coherent_xbar.hh"
 
+#include <algorithm>
+
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
@@ -63,6 +65,8 @@ CoherentXBar::CoherentXBar(const CoherentXBarParams *p)
       maxRoutingTableSizeCheck(p->max_routing_table_size),
       pointOfCoherency(p->point_of_coherency),
       pointOfUnification(p->point_of_unification),
+      nonCoherentRanges(p->noncoherent_ranges.begin(),
+                        p->noncoherent_ranges.end()),
 
       snoops(this, "snoops", "Total snoops (count)"),
       snoopTraffic(this, "snoopTraffic", "Total snoop traffic (bytes)"),
@@ -193,7 +197,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
     // the request
     const bool is_destination = isDestination(pkt);
 
-    const bool snoop_caches = !system->bypassCaches() &&
+    const bool snoop_caches = isCoherent(pkt) &&
         pkt->cmd != MemCmd::WriteClean;
     if (snoop_caches) {
         assert(pkt->snoopDelay == 0);
@@ -422,7 +426,7 @@ CoherentXBar::recvTimingReq(PacketPtr pkt, PortID slave_port_id)
 
         rsp_pkt->makeResponse();
 
-        if (snoopFilter && !system->bypassCaches()) {
+        if (snoopFilter && isCoherent(rsp_pkt)) {
             // let the snoop filter inspect the response and update its state
             snoopFilter->updateResponse(rsp_pkt, *slavePorts[rsp_port_id]);
         }
@@ -478,7 +482,7 @@ CoherentXBar::recvTimingResp(PacketPtr pkt, PortID master_port_id)
     // determine how long to be crossbar layer is busy
     Tick packetFinishTime = clockEdge(Cycles(1)) + pkt->payloadDelay;
 
-    if (snoopFilter && !system->bypassCaches()) {
+    if (snoopFilter && isCoherent(pkt)) {
         // let the snoop filter inspect the response and update its state
         snoopFilter->updateResponse(pkt, *slavePorts[slave_port_id]);
     }
@@ -744,7 +748,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
     // the request
     const bool is_destination = isDestination(pkt);
 
-    const bool snoop_caches = !system->bypassCaches() &&
+    const bool snoop_caches = isCoherent(pkt) &&
         pkt->cmd != MemCmd::WriteClean;
     if (snoop_caches) {
         // forward to all snoopers but the source
@@ -804,6 +808,16 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
                 pkt->clearWriteThrough();
             }
 
+            // a backdoor below the crossbar would bypass any cache or
+            // snooping master above it, so only pass it on if there
+            // is nobody but the requestor to snoop
+            if (backdoor && snoop_caches &&
+                std::any_of(snoopPorts.begin(), snoopPorts.end(),
+                            [this, slave_port_id](QueuedSlavePort *p)
+                            { return p != slavePorts[slave_port_id]; })) {
+                backdoor = nullptr;
+            }
+
             // forward the request to the appropriate destination
             auto master = masterPorts[master_port_id];
             response_latency = backdoor ?
@@ -824,7 +838,7 @@ CoherentXBar::recvAtomicBackdoor(PacketPtr pkt, PortID slave_port_id,
 
 
     // if lower levels have replied, tell the snoop filter
-    if (!system->bypassCaches() && snoopFilter && pkt->isResponse()) {
+    if (snoopFilter && pkt->isResponse() && isCoherent(pkt)) {
         snoopFilter->updateResponse(pkt, *slavePorts[slave_port_id]);
     }
 
@@ -293,6 +293,9 @@ class CoherentXBar : public BaseXBar
     /** Is this crossbar the point of unification? **/
     const bool pointOfUnification;
 
+    /** Address ranges that no cache above this crossbar holds */
+    const std::vector<AddrRange> nonCoherentRanges;
+
     /**
      * Upstream caches need this packet until true is returned, so
      * hold it for deletion until a subsequent call
@@ -418,8 +421,31 @@ class CoherentXBar : public BaseXBar
             (pkt->req->isToPOU() && pointOfUnification);
     }
 
-    Stats::Scalar snoops;
-    Stats::Scalar snoopTraffic;
+    /**
+     * Determine if the packet needs to be seen by the caches above
+     * this crossbar and by the snoop filter. This is not the case
+     * when caches are bypassed, or for packets that target one of the
+     * non-coherent ranges.
+     *
+     * @param pkt The processed packet
+     *
+     * @return Whether the packet takes the coherent path
+     */
+    bool
+    isCoherent(const PacketPtr pkt) const
+    {
+        if (system->bypassCaches())
+            return false;
+
+        for (const auto &r : nonCoherentRanges) {
+            if (r.contains(pkt->getAddr()))
+                return false;
+        }
+        return true;
+    }
+
+    Stats::ShardedScalar snoops;
+    Stats::ShardedScalar snoopTraffic;
     Stats::Distribution snoopFanout;
 
   public:
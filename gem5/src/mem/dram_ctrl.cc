@@ -47,6 +47,8 @@
 
 #include "mem/dram_ctrl.hh"
 
+#include <algorithm>
+
 #include "base/bitfield.hh"
 #include "base/trace.hh"
 #include "debug/DRAM.hh"
@@ -654,6 +656,10 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
             retryWrReq = true;
             stats.numWrRetry++;
             return false;
+        } else if (!admitRequest(pkt)) {
+            DPRINTF(DRAM, "Write partition throttled, not accepting\n");
+            retryWrReq = true;
+            return false;
         } else {
             addToWriteQueue(pkt, dram_pkt_count);
             stats.writeReqs++;
@@ -668,6 +674,10 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
             retryRdReq = true;
             stats.numRdRetry++;
             return false;
+        } else if (!admitRequest(pkt)) {
+            DPRINTF(DRAM, "Read partition throttled, not accepting\n");
+            retryRdReq = true;
+            return false;
         } else {
             addToReadQueue(pkt, dram_pkt_count);
             stats.readReqs++;
@@ -678,6 +688,17 @@ DRAMCtrl::recvTimingReq(PacketPtr pkt)
     return true;
 }
 
+void
+DRAMCtrl::regulationRetry()
+{
+    // at most one request is waiting for a retry
+    if (retryRdReq || retryWrReq) {
+        retryRdReq = false;
+        retryWrReq = false;
+        port.sendRetryReq();
+    }
+}
+
 void
 DRAMCtrl::processRespondEvent()
 {
@@ -770,6 +791,77 @@ DRAMCtrl::processRespondEvent()
     }
 }
 
+void
+DRAMCtrl::DRAMPacketQueue::push_back(DRAMPacket *dram_pkt)
+{
+    const iterator it = packets.insert(packets.end(), dram_pkt);
+    const uint64_t pos = nextPos++;
+
+    if (dram_pkt->bankId >= banks.size())
+        banks.resize(dram_pkt->bankId + 1);
+
+    BankIndex& bank = banks[dram_pkt->bankId];
+    auto& row = bank.rows[dram_pkt->row];
+    if (row.empty())
+        bank.heads.emplace(pos, dram_pkt->row);
+    row.emplace_back(pos, it);
+}
+
+DRAMCtrl::DRAMPacketQueue::iterator
+DRAMCtrl::DRAMPacketQueue::erase(iterator it)
+{
+    const DRAMPacket *dram_pkt = *it;
+    BankIndex& bank = banks[dram_pkt->bankId];
+    auto row_it = bank.rows.find(dram_pkt->row);
+    assert(row_it != bank.rows.end());
+    auto& row = row_it->second;
+
+    // packets are mostly taken from the front of their row
+    auto entry = std::find_if(row.begin(), row.end(),
+                              [it](const Entry& e) { return e.second == it; });
+    assert(entry != row.end());
+
+    if (entry == row.begin()) {
+        bank.heads.erase(std::make_pair(entry->first, dram_pkt->row));
+        row.pop_front();
+        if (row.empty())
+            bank.rows.erase(row_it);
+        else
+            bank.heads.emplace(row.front().first, dram_pkt->row);
+    } else {
+        row.erase(entry);
+    }
+
+    return packets.erase(it);
+}
+
+const DRAMCtrl::DRAMPacketQueue::Entry *
+DRAMCtrl::DRAMPacketQueue::oldestToRow(uint16_t bank_id, uint32_t row) const
+{
+    if (bank_id >= banks.size())
+        return nullptr;
+
+    const auto& rows = banks[bank_id].rows;
+    auto row_it = rows.find(row);
+    return row_it == rows.end() ? nullptr : &row_it->second.front();
+}
+
+const DRAMCtrl::DRAMPacketQueue::Entry *
+DRAMCtrl::DRAMPacketQueue::oldestNotToRow(uint16_t bank_id,
+                                          uint32_t row) const
+{
+    if (bank_id >= banks.size())
+        return nullptr;
+
+    // at most the first head is to the excluded row
+    const BankIndex& bank = banks[bank_id];
+    for (const auto& head : bank.heads) {
+        if (head.second != row)
+            return &bank.rows.find(head.second)->second.front();
+    }
+    return nullptr;
+}
+
 DRAMCtrl::DRAMPacketQueue::iterator
 DRAMCtrl::chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
@@ -808,111 +900,111 @@ DRAMCtrl::chooseNext(DRAMPacketQueue& queue, Tick extra_col_delay)
 DRAMCtrl::DRAMPacketQueue::iterator
 DRAMCtrl::chooseNextFRFCFS(DRAMPacketQueue& queue, Tick extra_col_delay)
 {
-    // Only determine this if needed
-    vector<uint32_t> earliest_banks(ranksPerChannel, 0);
-
-    // Has minBankPrep been called to populate earliest_banks?
-    bool filled_earliest_banks = false;
-    // can the PRE/ACT sequence be done without impacting utlization?
-    bool hidden_bank_prep = false;
+    // This picks the same packet as walking the queue in order: the
+    // oldest row hit that can issue seamlessly wins outright.
+    // Failing that, the candidates are the oldest row hit (prepped),
+    // and the oldest packet that is not a row hit but goes to one of
+    // the earliest banks. The latter is preferred if its bank can be
+    // prepared behind the scenes, or if there is no row hit at all.
+    // With the packets indexed by bank and row, every candidate is
+    // found by looking at each bank once.
 
-    // search for seamless row hits first, if no seamless row hit is
-    // found then determine if there are other packets that can be issued
-    // without incurring additional bus delay due to bank timing
-    // Will select closed rows first to enable more open row possibilies
-    // in future selections
-    bool found_hidden_bank = false;
+    // time we need to issue a column command to be seamless
+    const Tick min_col_at = std::max(nextBurstAt + extra_col_delay, curTick());
 
-    // remember if we found a row hit, not seamless, but bank prepped
-    // and ready
-    bool found_prepped_pkt = false;
+    const DRAMPacketQueue::Entry *seamless_pkt = nullptr;
+    const DRAMPacketQueue::Entry *prepped_pkt = nullptr;
+
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        if (!queue.hasBank(bank_id))
+            continue;
+
+        // skip banks of ranks that are not available
+        const Rank& rank = *ranks[bank_id / banksPerRank];
+        if (!rank.inRefIdleState())
+            continue;
+
+        const Bank& bank = rank.banks[bank_id % banksPerRank];
+        const DRAMPacketQueue::Entry *hit =
+            queue.oldestToRow(bank_id, bank.openRow);
+        if (!hit)
+            continue;
+
+        const Tick col_allowed_at = (*hit->second)->isRead() ?
+            bank.rdAllowedAt : bank.wrAllowedAt;
+
+        // no additional rank-to-rank or same bank-group delays, or we
+        // switched read/write and might as well go for the row hit
+        if (col_allowed_at <= min_col_at) {
+            if (!seamless_pkt || hit->first < seamless_pkt->first)
+                seamless_pkt = hit;
+        } else if (!prepped_pkt || hit->first < prepped_pkt->first) {
+            prepped_pkt = hit;
+        }
+    }
 
-    // if we have no row hit, prepped or not, and no seamless packet,
-    // just go for the earliest possible
-    bool found_earliest_pkt = false;
+    if (seamless_pkt) {
+        DPRINTF(DRAM, "%s Seamless row buffer hit in bank %d\n", __func__,
+                (*seamless_pkt->second)->bankId);
+        return seamless_pkt->second;
+    }
 
-    auto selected_pkt_it = queue.end();
+    // Only determine this if needed
+    vector<uint32_t> earliest_banks;
+    // can the PRE/ACT sequence be done without impacting utlization?
+    bool hidden_bank_prep = false;
+    bool filled_earliest_banks = false;
 
-    // time we need to issue a column command to be seamless
-    const Tick min_col_at = std::max(nextBurstAt + extra_col_delay, curTick());
+    const DRAMPacketQueue::Entry *earliest_pkt = nullptr;
 
-    for (auto i = queue.begin(); i != queue.end() ; ++i) {
-        DRAMPacket* dram_pkt = *i;
-        const Bank& bank = dram_pkt->bankRef;
-        const Tick col_allowed_at = dram_pkt->isRead() ? bank.rdAllowedAt :
-                                                         bank.wrAllowedAt;
+    for (uint16_t bank_id = 0; bank_id < queue.numBanks(); ++bank_id) {
+        if (!queue.hasBank(bank_id))
+            continue;
 
-        DPRINTF(DRAM, "%s checking packet in bank %d\n",
-                __func__, dram_pkt->bankRef.bank);
+        const Rank& rank = *ranks[bank_id / banksPerRank];
+        if (!rank.inRefIdleState())
+            continue;
 
-        // check if rank is not doing a refresh and thus is available, if not,
-        // jump to the next packet
-        if (dram_pkt->rankRef.inRefIdleState()) {
+        const Bank& bank = rank.banks[bank_id % banksPerRank];
+        const DRAMPacketQueue::Entry *miss =
+            queue.oldestNotToRow(bank_id, bank.openRow);
+        if (!miss)
+            continue;
 
-            DPRINTF(DRAM,
-                    "%s bank %d - Rank %d available\n", __func__,
-                    dram_pkt->bankRef.bank, dram_pkt->rankRef.rank);
-
-            // check if it is a row hit
-            if (bank.openRow == dram_pkt->row) {
-                // no additional rank-to-rank or same bank-group
-                // delays, or we switched read/write and might as well
-                // go for the row hit
-                if (col_allowed_at <= min_col_at) {
-                    // FCFS within the hits, giving priority to
-                    // commands that can issue seamlessly, without
-                    // additional delay, such as same rank accesses
-                    // and/or different bank-group accesses
-                    DPRINTF(DRAM, "%s Seamless row buffer hit\n", __func__);
-                    selected_pkt_it = i;
-                    // no need to look through the remaining queue entries
-                    break;
-                } else if (!found_hidden_bank && !found_prepped_pkt) {
-                    // if we did not find a packet to a closed row that can
-                    // issue the bank commands without incurring delay, and
-                    // did not yet find a packet to a prepped row, remember
-                    // the current one
-                    selected_pkt_it = i;
-                    found_prepped_pkt = true;
-                    DPRINTF(DRAM, "%s Prepped row buffer hit\n", __func__);
-                }
-            } else if (!found_earliest_pkt) {
-                // if we have not initialised the bank status, do it
-                // now, and only once per scheduling decisions
-                if (!filled_earliest_banks) {
-                    // determine entries with earliest bank delay
-                    std::tie(earliest_banks, hidden_bank_prep) =
-                        minBankPrep(queue, min_col_at);
-                    filled_earliest_banks = true;
-                }
+        if (!filled_earliest_banks) {
+            // determine entries with earliest bank delay
+            std::tie(earliest_banks, hidden_bank_prep) =
+                minBankPrep(queue, min_col_at);
+            filled_earliest_banks = true;
+        }
 
-                // bank is amongst first available banks
-                // minBankPrep will give priority to packets that can
-                // issue seamlessly
-                if (bits(earliest_banks[dram_pkt->rank],
-                         dram_pkt->bank, dram_pkt->bank)) {
-                    found_earliest_pkt = true;
-                    found_hidden_bank = hidden_bank_prep;
-
-                    // give priority to packets that can issue
-                    // bank commands 'behind the scenes'
-                    // any additional delay if any will be due to
-                    // col-to-col command requirements
-                    if (hidden_bank_prep || !found_prepped_pkt)
-                        selected_pkt_it = i;
-                }
-            }
-        } else {
-            DPRINTF(DRAM, "%s bank %d - Rank %d not available\n", __func__,
-                    dram_pkt->bankRef.bank, dram_pkt->rankRef.rank);
+        // bank is amongst first available banks
+        const uint8_t rank_idx = bank_id / banksPerRank;
+        const uint8_t bank_idx = bank_id % banksPerRank;
+        if (bits(earliest_banks[rank_idx], bank_idx, bank_idx) &&
+            (!earliest_pkt || miss->first < earliest_pkt->first)) {
+            earliest_pkt = miss;
         }
     }
 
-    if (selected_pkt_it == queue.end()) {
-        DPRINTF(DRAM, "%s no available ranks found\n", __func__);
+    // give priority to packets that can issue bank commands 'behind
+    // the scenes', any additional delay if any will be due to
+    // col-to-col command requirements
+    if (earliest_pkt && (hidden_bank_prep || !prepped_pkt)) {
+        DPRINTF(DRAM, "%s Earliest bank %d, hidden prep %d\n", __func__,
+                (*earliest_pkt->second)->bankId, hidden_bank_prep);
+        return earliest_pkt->second;
+    }
+
+    if (prepped_pkt) {
+        DPRINTF(DRAM, "%s Prepped row buffer hit in bank %d\n", __func__,
+                (*prepped_pkt->second)->bankId);
+        return prepped_pkt->second;
     }
 
-    return selected_pkt_it;
+    DPRINTF(DRAM, "%s no available ranks found\n", __func__);
+
+    return queue.end();
 }
 
 void
@@ -1445,12 +1537,12 @@ DRAMCtrl::processNextReqEvent()
 
             bool read_found = false;
             DRAMPacketQueue::iterator to_read;
-            uint8_t prio = numPriorities();
 
-            for (auto queue = readQueue.rbegin();
-                 queue != readQueue.rend(); ++queue) {
+            // only visit the priorities with queued reads
+            for (int prio = topPriority(READ); prio >= 0;
+                 prio = topPriority(READ, prio)) {
 
-                prio--;
+                auto queue = &readQueue[prio];
 
                 DPRINTF(QOS,
                         "DRAM controller checking READ queue [%d] priority [%d elements]\n",
@@ -1528,12 +1620,12 @@ DRAMCtrl::processNextReqEvent()
 
         bool write_found = false;
         DRAMPacketQueue::iterator to_write;
-        uint8_t prio = numPriorities();
 
-        for (auto queue = writeQueue.rbegin();
-             queue != writeQueue.rend(); ++queue) {
+        // only visit the priorities with queued writes
+        for (int prio = topPriority(WRITE); prio >= 0;
+             prio = topPriority(WRITE, prio)) {
 
-            prio--;
+            auto queue = &writeQueue[prio];
 
             DPRINTF(QOS,
                     "DRAM controller checking WRITE queue [%d] priority [%d elements]\n",
@@ -1654,23 +1746,19 @@ DRAMCtrl::minBankPrep(const DRAMPacketQueue& queue,
     // delay on the data bus
     bool hidden_bank_prep = false;
 
-    // determine if we have queued transactions targetting the
-    // bank in question
-    vector<bool> got_waiting(ranksPerChannel * banksPerRank, false);
-    for (const auto& p : queue) {
-        if (p->rankRef.inRefIdleState())
-            got_waiting[p->bankId] = true;
-    }
-
     // Find command with optimal bank timing
     // Will prioritize commands that can issue seamlessly.
     for (int i = 0; i < ranksPerChannel; i++) {
+        // only consider ranks that are not refreshing
+        if (!ranks[i]->inRefIdleState())
+            continue;
+
         for (int j = 0; j < banksPerRank; j++) {
             uint16_t bank_id = i * banksPerRank + j;
 
             // if we have waiting requests for the bank, and it is
             // amongst the first available, update the mask
-            if (got_waiting[bank_id]) {
+            if (queue.hasBank(bank_id)) {
                 // make sure this rank is not currently refreshing.
                 assert(ranks[i]->inRefIdleState());
                 // simplistic approximation of when the bank can issue
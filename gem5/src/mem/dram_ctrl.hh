@@ -55,8 +55,12 @@
 #define __MEM_DRAM_CTRL_HH__
 
 #include <deque>
+#include <list>
+#include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/callback.hh"
@@ -719,9 +723,81 @@ class DRAMCtrl : public QoS::MemCtrl
 
     };
 
-    // The DRAM packets are store in a multiple dequeue structure,
-    // based on their QoS priority
-    typedef std::deque<DRAMPacket*> DRAMPacketQueue;
+    /**
+     * A queue of DRAM packets in arrival order. Besides the queue
+     * itself, the packets are indexed by bank and row, so that the
+     * scheduler can find the oldest packet to a given row, or to any
+     * other row of a bank, without walking the whole queue.
+     *
+     * The queue offers the subset of the std::deque interface used by
+     * the controller and the QoS escalation, so the index is kept up
+     * to date whoever moves packets around.
+     */
+    class DRAMPacketQueue
+    {
+      private:
+        typedef std::list<DRAMPacket*> Packets;
+
+      public:
+        typedef Packets::iterator iterator;
+        typedef Packets::const_iterator const_iterator;
+
+        /** A packet in the queue and its position in queue order. */
+        typedef std::pair<uint64_t, iterator> Entry;
+
+        DRAMPacketQueue() : nextPos(0) {}
+
+        iterator begin() { return packets.begin(); }
+        iterator end() { return packets.end(); }
+        const_iterator begin() const { return packets.begin(); }
+        const_iterator end() const { return packets.end(); }
+
+        size_t size() const { return packets.size(); }
+        bool empty() const { return packets.empty(); }
+
+        void push_back(DRAMPacket *dram_pkt);
+        iterator erase(iterator it);
+
+        /** Number of banks that can be looked up in the index. */
+        size_t numBanks() const { return banks.size(); }
+
+        /** Whether any packet in the queue targets a bank. */
+        bool
+        hasBank(uint16_t bank_id) const
+        {
+            return bank_id < banks.size() && !banks[bank_id].heads.empty();
+        }
+
+        /**
+         * Oldest packet to a row of a bank.
+         *
+         * @return The packet, or nullptr if there is none
+         */
+        const Entry *oldestToRow(uint16_t bank_id, uint32_t row) const;
+
+        /**
+         * Oldest packet to a bank that is not to the given row.
+         *
+         * @return The packet, or nullptr if there is none
+         */
+        const Entry *oldestNotToRow(uint16_t bank_id, uint32_t row) const;
+
+      private:
+        struct BankIndex
+        {
+            /** Packets to each row, in queue order. */
+            std::unordered_map<uint32_t, std::deque<Entry>> rows;
+
+            /** Position of the oldest packet to each row, and the row. */
+            std::set<std::pair<uint64_t, uint32_t>> heads;
+        };
+
+        Packets packets;
+        std::vector<BankIndex> banks;
+
+        /** Position of the next packet added to the queue. */
+        uint64_t nextPos;
+    };
 
     /**
      * Bunch of things requires to setup "events" in gem5
@@ -1192,6 +1268,8 @@ class DRAMCtrl : public QoS::MemCtrl
     void recvFunctional(PacketPtr pkt);
     bool recvTimingReq(PacketPtr pkt);
 
+    void regulationRetry() override;
+
 };
 
 #endif //__MEM_DRAM_CTRL_HH__
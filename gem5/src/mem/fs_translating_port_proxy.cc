@@ -48,6 +48,7 @@
 
 #include "mem/fs_translating_port_proxy.hh"
 
+#include "arch/generic/tlb.hh"
 #include "arch/vtophys.hh"
 #include "base/chunk_generator.hh"
 #include "cpu/base.hh"
@@ -56,22 +57,66 @@
 
 FSTranslatingPortProxy::FSTranslatingPortProxy(ThreadContext *tc)
     : PortProxy(tc->getCpuPtr()->getSendFunctional(),
-                tc->getSystemPtr()->cacheLineSize()), _tc(tc)
+                tc->getSystemPtr()->cacheLineSize()), _tc(tc),
+      transCache(), cachedItb(NULL), cachedDtb(NULL),
+      itbGeneration(0), dtbGeneration(0)
 {
 }
 
 FSTranslatingPortProxy::FSTranslatingPortProxy(
         SendFunctionalFunc func, unsigned int cacheLineSize)
-    : PortProxy(func, cacheLineSize), _tc(NULL)
+    : PortProxy(func, cacheLineSize), _tc(NULL),
+      transCache(), cachedItb(NULL), cachedDtb(NULL),
+      itbGeneration(0), dtbGeneration(0)
 {
 }
 
 FSTranslatingPortProxy::FSTranslatingPortProxy(
         MasterPort &port, unsigned int cacheLineSize)
-    : PortProxy(port, cacheLineSize), _tc(NULL)
+    : PortProxy(port, cacheLineSize), _tc(NULL),
+      transCache(), cachedItb(NULL), cachedDtb(NULL),
+      itbGeneration(0), dtbGeneration(0)
 {
 }
 
+Addr
+FSTranslatingPortProxy::translate(Addr vaddr) const
+{
+    if (!_tc)
+        return TheISA::vtophys(vaddr);
+
+    const BaseTLB *itb = _tc->getITBPtr();
+    const BaseTLB *dtb = _tc->getDTBPtr();
+
+    // TLBs that don't track generations can't tell us when to drop
+    // cached translations
+    if (!itb->generation() || !dtb->generation())
+        return TheISA::vtophys(_tc, vaddr);
+
+    if (itb != cachedItb || dtb != cachedDtb ||
+        itb->generation() != itbGeneration ||
+        dtb->generation() != dtbGeneration) {
+        for (auto &entry : transCache)
+            entry.valid = false;
+        cachedItb = itb;
+        cachedDtb = dtb;
+        itbGeneration = itb->generation();
+        dtbGeneration = dtb->generation();
+    }
+
+    const Addr vpage = vaddr >> TheISA::PageShift;
+    const Addr offset = vaddr & (TheISA::PageBytes - 1);
+    CachedTranslation &entry = transCache[vpage % TranslationCacheSize];
+    if (entry.valid && entry.vpage == vpage)
+        return (entry.ppage << TheISA::PageShift) | offset;
+
+    const Addr paddr = TheISA::vtophys(_tc, vaddr);
+    entry.valid = true;
+    entry.vpage = vpage;
+    entry.ppage = paddr >> TheISA::PageShift;
+    return paddr;
+}
+
 bool
 FSTranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
 {
@@ -79,10 +124,7 @@ FSTranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
     for (ChunkGenerator gen(addr, size, TheISA::PageBytes); !gen.done();
          gen.next())
     {
-        if (_tc)
-            paddr = TheISA::vtophys(_tc,gen.addr());
-        else
-            paddr = TheISA::vtophys(gen.addr());
+        paddr = translate(gen.addr());
 
         PortProxy::readBlobPhys(paddr, 0, p, gen.size());
         p = static_cast<uint8_t *>(p) + gen.size();
@@ -98,10 +140,7 @@ FSTranslatingPortProxy::tryWriteBlob(
     for (ChunkGenerator gen(addr, size, TheISA::PageBytes); !gen.done();
          gen.next())
     {
-        if (_tc)
-            paddr = TheISA::vtophys(_tc,gen.addr());
-        else
-            paddr = TheISA::vtophys(gen.addr());
+        paddr = translate(gen.addr());
 
         PortProxy::writeBlobPhys(paddr, 0, p, gen.size());
         p = static_cast<const uint8_t *>(p) + gen.size();
@@ -116,10 +155,7 @@ FSTranslatingPortProxy::tryMemsetBlob(Addr address, uint8_t v, int size) const
     for (ChunkGenerator gen(address, size, TheISA::PageBytes); !gen.done();
          gen.next())
     {
-        if (_tc)
-            paddr = TheISA::vtophys(_tc,gen.addr());
-        else
-            paddr = TheISA::vtophys(gen.addr());
+        paddr = translate(gen.addr());
 
         PortProxy::memsetBlobPhys(paddr, 0, v, gen.size());
     }
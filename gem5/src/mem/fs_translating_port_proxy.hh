@@ -59,8 +59,10 @@
 #ifndef __MEM_FS_TRANSLATING_PORT_PROXY_HH__
 #define __MEM_FS_TRANSLATING_PORT_PROXY_HH__
 
+#include "arch/isa_traits.hh"
 #include "mem/port_proxy.hh"
 
+class BaseTLB;
 class ThreadContext;
 
 /**
@@ -75,6 +77,28 @@ class FSTranslatingPortProxy : public PortProxy
   private:
     ThreadContext* _tc;
 
+    /**
+     * Cache of recent page translations. Entries are only used as long
+     * as the TLBs of the thread context are the same ones and haven't
+     * started a new generation, i.e. no invalidation or change of the
+     * translation context happened in between.
+     */
+    struct CachedTranslation
+    {
+        bool valid;
+        Addr vpage;
+        Addr ppage;
+    };
+    static const int TranslationCacheSize = 64;
+    mutable CachedTranslation transCache[TranslationCacheSize];
+    mutable const BaseTLB *cachedItb;
+    mutable const BaseTLB *cachedDtb;
+    mutable uint64_t itbGeneration;
+    mutable uint64_t dtbGeneration;
+
+    /** Translate a virtual address, using the cache if possible */
+    Addr translate(Addr vaddr) const;
+
   public:
 
     FSTranslatingPortProxy(ThreadContext* tc);
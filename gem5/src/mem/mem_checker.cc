@@ -40,8 +40,17 @@
 
 #include "mem/mem_checker.hh"
 
+#include <algorithm>
 #include <cassert>
 
+std::vector<MemChecker::Transaction>::iterator
+MemChecker::WriteCluster::findWrite(MemChecker::Serial serial)
+{
+    return std::find_if(writes.begin(), writes.end(),
+                        [serial](const Transaction &write)
+                        { return write.serial == serial; });
+}
+
 void
 MemChecker::WriteCluster::startWrite(MemChecker::Serial serial, Tick _start,
                                      uint8_t data)
@@ -65,14 +74,14 @@ MemChecker::WriteCluster::startWrite(MemChecker::Serial serial, Tick _start,
     }
 
     // Create new transaction, and denote completion time to be in the future.
-    writes.insert(std::make_pair(serial,
-                  MemChecker::Transaction(serial, _start, TICK_FUTURE, data)));
+    writes.emplace_back(
+        MemChecker::Transaction(serial, _start, TICK_FUTURE, data));
 }
 
 void
 MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complete)
 {
-    auto it = writes.find(serial);
+    auto it = findWrite(serial);
 
     if (it == writes.end()) {
         warn("Could not locate write transaction: serial = %d, complete = %d\n",
@@ -81,8 +90,8 @@ MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complet
     }
 
     // Record completion time of the write
-    assert(it->second.complete == TICK_FUTURE);
-    it->second.complete = _complete;
+    assert(it->complete == TICK_FUTURE);
+    it->complete = _complete;
 
     // Update max completion time for the cluster
     if (completeMax < _complete) {
@@ -103,10 +112,13 @@ MemChecker::WriteCluster::completeWrite(MemChecker::Serial serial, Tick _complet
 void
 MemChecker::WriteCluster::abortWrite(MemChecker::Serial serial)
 {
-    if (!writes.erase(serial)) {
+    auto it = findWrite(serial);
+
+    if (it == writes.end()) {
         warn("Could not locate write transaction: serial = %d\n", serial);
         return;
     }
+    writes.erase(it);
 
     if (--numIncomplete == 0 && !writes.empty()) {
         // This write cluster is now complete, and we can assign the current
@@ -142,9 +154,13 @@ MemChecker::ByteTracker::inExpectedData(Tick start, Tick complete, uint8_t data)
     // preceding & overlapping writes.
     for (auto cluster = writeClusters.rbegin();
          cluster != writeClusters.rend() && wc_overlap; ++cluster) {
-        for (const auto& addr_write : cluster->writes) {
-            const Transaction& write = addr_write.second;
+        // A complete cluster spans all its writes, so if it completed
+        // before the last observation, every write in it would be
+        // ignored below; skip it as a whole.
+        if (cluster->isComplete() && cluster->complete < last_obs.start)
+            continue;
 
+        for (const Transaction& write : cluster->writes) {
             if (write.complete < last_obs.start) {
                 // If this write transaction completed before the last
                 // observation, we ignore it as the last_observation has the
@@ -339,12 +355,41 @@ MemChecker::completeRead(MemChecker::Serial serial, Tick complete,
     return result;
 }
 
+std::vector<MemChecker::ByteTracker>
+MemChecker::newLineTracker(Addr line_addr) const
+{
+    std::vector<ByteTracker> line;
+    line.reserve(LINE_SIZE);
+    for (Addr i = 0; i < LINE_SIZE; ++i) {
+        line.emplace_back(line_addr + i, this);
+    }
+    return line;
+}
+
 void
 MemChecker::reset(Addr addr, size_t size)
 {
-    for (size_t i = 0; i < size; ++i) {
-        byte_trackers.erase(addr + i);
+    const Addr end = addr + size;
+
+    while (addr < end) {
+        const Addr line_addr = addr & ~(LINE_SIZE - 1);
+        const Addr line_end = std::min(line_addr + LINE_SIZE, end);
+
+        auto it = line_trackers.find(line_addr);
+        if (it != line_trackers.end()) {
+            if (addr == line_addr && line_end == line_addr + LINE_SIZE) {
+                // The whole line is reset, drop it until it is used again
+                line_trackers.erase(it);
+            } else {
+                for (Addr a = addr; a < line_end; ++a) {
+                    it->second[a - line_addr] = ByteTracker(a, this);
+                }
+            }
+        }
+        addr = line_end;
     }
+
+    lastLine = NULL;
 }
 
 MemChecker*
@@ -48,6 +48,7 @@
 #include <vector>
 
 #include "base/logging.hh"
+#include "base/pool_allocator.hh"
 #include "base/trace.hh"
 #include "base/types.hh"
 #include "debug/MemChecker.hh"
@@ -182,31 +183,45 @@ class MemChecker : public SimObject
         Tick complete;  //!< Completion of last write in cluster
 
         /**
-         * Map of Serial --> Transaction of all writes in cluster; contains
-         * all, in-flight or already completed.
+         * All writes in cluster, in-flight or already completed, in the
+         * order they were started. Clusters only hold the few writes
+         * that overlap each other, so they are searched linearly.
          */
-        std::unordered_map<Serial, Transaction> writes;
+        std::vector<Transaction> writes;
 
       private:
+        /**
+         * Find a write of this cluster.
+         *
+         * @param serial Unique identifier of the write.
+         * @return Iterator to the write, or writes.end() if not found.
+         */
+        std::vector<Transaction>::iterator findWrite(Serial serial);
+
         Tick completeMax;
         size_t numIncomplete;
     };
 
-    typedef std::list<Transaction> TransactionList;
-    typedef std::list<WriteCluster> WriteClusterList;
+    /**
+     * Transactions and write clusters come and go with every access to
+     * a location, so their list nodes are recycled through a pool.
+     */
+    typedef std::list<Transaction, PoolAllocator<Transaction>>
+        TransactionList;
+    typedef std::list<WriteCluster, PoolAllocator<WriteCluster>>
+        WriteClusterList;
 
     /**
      * The ByteTracker keeps track of transactions for the *same byte* -- all
      * outstanding reads, the completed reads (and what they observed) and write
      * clusters (see WriteCluster).
      */
-    class ByteTracker : public Named
+    class ByteTracker
     {
       public:
 
-        ByteTracker(Addr addr = 0, const MemChecker *parent = NULL)
-            : Named((parent != NULL ? parent->name() : "") +
-                     csprintf(".ByteTracker@%#llx", addr))
+        ByteTracker(Addr _addr = 0, const MemChecker *_parent = NULL)
+            : addr(_addr), parent(_parent)
         {
             // The initial transaction has start == complete == TICK_INITIAL,
             // indicating that there has been no real write to this location;
@@ -216,6 +231,19 @@ class MemChecker : public SimObject
                                 DATA_INITIAL));
         }
 
+        /**
+         * Get the name, useful for DPRINTFs. The name is only built on
+         * demand, as there is a tracker for every byte of every line
+         * that is accessed.
+         *
+         * @return Name of the checker, followed by the tracked address
+         */
+        std::string name() const
+        {
+            return (parent != NULL ? parent->name() : "") +
+                csprintf(".ByteTracker@%#llx", addr);
+        }
+
         /**
          * Starts a read transaction.
          *
@@ -346,13 +374,21 @@ class MemChecker : public SimObject
 
       private:
 
+        /** Address of the tracked byte */
+        Addr addr;
+
+        /** Checker owning this tracker, for debug printing */
+        const MemChecker *parent;
+
         /**
          * Maintains a map of Serial -> Transaction for all outstanding reads.
          *
          * Use an ordered map here, as this makes pruneTransactions() more
          * efficient (find first outstanding read).
          */
-        std::map<Serial, Transaction> outstandingReads;
+        std::map<Serial, Transaction, std::less<Serial>,
+                 PoolAllocator<std::pair<const Serial, Transaction>>>
+            outstandingReads;
 
         /**
          * List of completed reads, i.e. observations of reads.
@@ -372,9 +408,16 @@ class MemChecker : public SimObject
 
   public:
 
+    /**
+     * Byte trackers are allocated and looked up for a whole line at a
+     * time. Must be a power of two.
+     */
+    static const Addr LINE_SIZE = 64;
+
     MemChecker(const MemCheckerParams *p)
         : SimObject(p),
-          nextSerial(SERIAL_INITIAL)
+          nextSerial(SERIAL_INITIAL),
+          lastLineAddr(0), lastLine(NULL)
     {}
 
     virtual ~MemChecker() {}
@@ -450,7 +493,10 @@ class MemChecker : public SimObject
      * the reset with serial S.
      */
     void reset()
-    { byte_trackers.clear(); }
+    {
+        line_trackers.clear();
+        lastLine = NULL;
+    }
 
     /**
      * Resets an address-range. This may be useful in case other unmonitored
@@ -479,14 +525,30 @@ class MemChecker : public SimObject
      */
     ByteTracker* getByteTracker(Addr addr)
     {
-        auto it = byte_trackers.find(addr);
-        if (it == byte_trackers.end()) {
-            it = byte_trackers.insert(
-                std::make_pair(addr, ByteTracker(addr, this))).first;
+        const Addr line_addr = addr & ~(LINE_SIZE - 1);
+
+        // Accesses are mostly to one line at a time, so remember the
+        // line looked up last to save the hash lookup for every byte
+        if (lastLine == NULL || line_addr != lastLineAddr) {
+            auto it = line_trackers.find(line_addr);
+            if (it == line_trackers.end()) {
+                it = line_trackers.emplace(line_addr,
+                                           newLineTracker(line_addr)).first;
+            }
+            lastLineAddr = line_addr;
+            lastLine = it->second.data();
         }
-        return &it->second;
+        return &lastLine[addr - line_addr];
     };
 
+    /**
+     * Creates fresh byte trackers for a line.
+     *
+     * @param line_addr Line aligned address
+     * @return Trackers for all bytes of the line
+     */
+    std::vector<ByteTracker> newLineTracker(Addr line_addr) const;
+
   private:
     /**
      * Detailed error message of the last violation in completeRead.
@@ -500,17 +562,27 @@ class MemChecker : public SimObject
     Serial nextSerial;
 
     /**
-     * Maintain a map of address --> byte-tracker. Per-byte entries are
-     * initialized as needed.
+     * Maintain a map of line address --> byte-trackers of the line. The
+     * entries of a line are initialized on the first access to any of
+     * its bytes.
      *
      * The required space for this obviously grows with the number of distinct
-     * addresses used for a particular workload. The used size is independent on
+     * lines used for a particular workload. The used size is independent on
      * the number of nodes in the system, those may affect the size of per-byte
      * tracking information.
      *
      * Access via getByteTracker()!
      */
-    std::unordered_map<Addr, ByteTracker> byte_trackers;
+    std::unordered_map<Addr, std::vector<ByteTracker>> line_trackers;
+
+    /** Address of the line looked up last */
+    Addr lastLineAddr;
+
+    /**
+     * Trackers of the line looked up last, NULL if invalid. Pointers to
+     * the elements of an unordered_map stay valid until they are erased.
+     */
+    ByteTracker *lastLine;
 };
 
 inline MemChecker::Serial
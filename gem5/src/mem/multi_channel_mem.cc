@@ -0,0 +1,280 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/multi_channel_mem.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/trace.hh"
+#include "debug/AddrRanges.hh"
+
+MultiChannelMemory::MultiChannelMemory(const MultiChannelMemoryParams *p)
+    : SimObject(p), slavePort(name() + ".slave", *this),
+      gotRanges(p->port_master_connection_count, false), numGotRanges(0),
+      retryReqChannel(InvalidPortID), respBlocked(false)
+{
+    for (int i = 0; i < p->port_master_connection_count; ++i) {
+        channelPorts.push_back(new ChannelPort(csprintf("%s.master[%d]",
+                                                        name(), i),
+                                               *this, i));
+    }
+}
+
+Port &
+MultiChannelMemory::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "slave") {
+        return slavePort;
+    } else if (if_name == "master" && idx < channelPorts.size()) {
+        return *channelPorts[idx];
+    } else {
+        return SimObject::getPort(if_name, idx);
+    }
+}
+
+void
+MultiChannelMemory::init()
+{
+    if (!slavePort.isConnected())
+        fatal("%s: slave port is not connected\n", name());
+    if (channelPorts.empty())
+        fatal("%s: no memory channels connected\n", name());
+}
+
+void
+MultiChannelMemory::regStats()
+{
+    SimObject::regStats();
+
+    using namespace Stats;
+
+    const int channels = channelPorts.size();
+
+    readReqs
+        .init(channels)
+        .name(name() + ".readReqs")
+        .desc("Number of read requests per channel")
+        .flags(total);
+
+    writeReqs
+        .init(channels)
+        .name(name() + ".writeReqs")
+        .desc("Number of write requests per channel")
+        .flags(total);
+
+    bytesRead
+        .init(channels)
+        .name(name() + ".bytesRead")
+        .desc("Number of bytes read per channel")
+        .flags(total);
+
+    bytesWritten
+        .init(channels)
+        .name(name() + ".bytesWritten")
+        .desc("Number of bytes written per channel")
+        .flags(total);
+
+    for (int i = 0; i < channels; ++i) {
+        const std::string &peer = channelPorts[i]->getPeer().name();
+        readReqs.subname(i, peer);
+        writeReqs.subname(i, peer);
+        bytesRead.subname(i, peer);
+        bytesWritten.subname(i, peer);
+    }
+}
+
+PortID
+MultiChannelMemory::findChannel(PacketPtr pkt) const
+{
+    auto it = channelMap.contains(pkt->getAddrRange());
+    if (it == channelMap.end())
+        panic("%s: no channel for %s\n", name(), pkt->print());
+    return it->second;
+}
+
+void
+MultiChannelMemory::recordRequest(PortID channel, const MemCmd &cmd,
+                                  unsigned size)
+{
+    if (cmd.isRead()) {
+        ++readReqs[channel];
+        bytesRead[channel] += size;
+    } else if (cmd.isWrite()) {
+        ++writeReqs[channel];
+        bytesWritten[channel] += size;
+    }
+}
+
+void
+MultiChannelMemory::recvFunctional(PacketPtr pkt)
+{
+    channelPorts[findChannel(pkt)]->sendFunctional(pkt);
+}
+
+Tick
+MultiChannelMemory::recvAtomic(PacketPtr pkt)
+{
+    const PortID channel = findChannel(pkt);
+    recordRequest(channel, pkt->cmd, pkt->getSize());
+    return channelPorts[channel]->sendAtomic(pkt);
+}
+
+Tick
+MultiChannelMemory::recvAtomicBackdoor(PacketPtr pkt,
+                                       MemBackdoorPtr &backdoor)
+{
+    const PortID channel = findChannel(pkt);
+    recordRequest(channel, pkt->cmd, pkt->getSize());
+    return channelPorts[channel]->sendAtomicBackdoor(pkt, backdoor);
+}
+
+bool
+MultiChannelMemory::recvTimingReq(PacketPtr pkt)
+{
+    assert(retryReqChannel == InvalidPortID);
+
+    const PortID channel = findChannel(pkt);
+    // The channel may already have freed a packet that doesn't need
+    // a response once it is accepted, so grab what the stats need
+    const MemCmd cmd = pkt->cmd;
+    const unsigned size = pkt->getSize();
+
+    if (!channelPorts[channel]->sendTimingReq(pkt)) {
+        retryReqChannel = channel;
+        return false;
+    }
+
+    recordRequest(channel, cmd, size);
+    return true;
+}
+
+bool
+MultiChannelMemory::recvTimingResp(PortID channel, PacketPtr pkt)
+{
+    // While the upstream port is blocked, hold back the responses of
+    // the other channels too so that they are retried in order
+    if (respBlocked || !slavePort.sendTimingResp(pkt)) {
+        respBlocked = true;
+        if (std::find(retryRespChannels.begin(), retryRespChannels.end(),
+                      channel) == retryRespChannels.end()) {
+            retryRespChannels.push_back(channel);
+        }
+        return false;
+    }
+    return true;
+}
+
+void
+MultiChannelMemory::recvReqRetry(PortID channel)
+{
+    // Only the channel that refused the request can unblock the
+    // upstream port
+    if (channel != retryReqChannel)
+        return;
+
+    retryReqChannel = InvalidPortID;
+    slavePort.sendRetryReq();
+}
+
+void
+MultiChannelMemory::recvRespRetry()
+{
+    respBlocked = false;
+
+    // A channel refused again is put back on the list, and the ones
+    // after it find the port blocked and queue up behind it
+    std::vector<PortID> waiting;
+    waiting.swap(retryRespChannels);
+    for (auto channel : waiting)
+        channelPorts[channel]->sendRetryResp();
+}
+
+void
+MultiChannelMemory::recvRangeChange(PortID channel)
+{
+    DPRINTF(AddrRanges, "Received range change from channel %d\n",
+            channel);
+
+    if (!gotRanges[channel]) {
+        gotRanges[channel] = true;
+        ++numGotRanges;
+    }
+
+    // Wait until all channels have reported before building the map,
+    // and rebuild it from scratch on later changes
+    if (numGotRanges < channelPorts.size())
+        return;
+
+    channelMap.clear();
+    for (PortID i = 0; i < channelPorts.size(); ++i) {
+        for (const auto &r : channelPorts[i]->getAddrRanges()) {
+            DPRINTF(AddrRanges, "Adding range %s for channel %d\n",
+                    r.to_string(), i);
+            if (channelMap.insert(r, i) == channelMap.end()) {
+                fatal("%s: channel %s range %s overlaps with another "
+                      "channel\n", name(),
+                      channelPorts[i]->getPeer().name(), r.to_string());
+            }
+        }
+    }
+
+    // Merge the interleaved ranges the same way the crossbar does,
+    // relying on the map keeping them sorted
+    ranges.clear();
+    std::vector<AddrRange> intlv_ranges;
+    for (const auto &r : channelMap) {
+        if (r.first.interleaved()) {
+            if (!intlv_ranges.empty() &&
+                !intlv_ranges.back().mergesWith(r.first)) {
+                ranges.push_back(AddrRange(intlv_ranges));
+                intlv_ranges.clear();
+            }
+            intlv_ranges.push_back(r.first);
+        } else {
+            ranges.push_back(r.first);
+        }
+    }
+    if (!intlv_ranges.empty())
+        ranges.push_back(AddrRange(intlv_ranges));
+
+    slavePort.sendRangeChange();
+}
+
+AddrRangeList
+MultiChannelMemory::getAddrRanges() const
+{
+    return ranges;
+}
+
+MultiChannelMemory *
+MultiChannelMemoryParams::create()
+{
+    return new MultiChannelMemory(this);
+}
@@ -0,0 +1,223 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ * Declaration of a router that fronts multiple memory channels.
+ */
+
+#ifndef __MEM_MULTI_CHANNEL_MEM_HH__
+#define __MEM_MULTI_CHANNEL_MEM_HH__
+
+#include <vector>
+
+#include "base/addr_range_map.hh"
+#include "base/statistics.hh"
+#include "mem/port.hh"
+#include "params/MultiChannelMemory.hh"
+#include "sim/sim_object.hh"
+
+/**
+ * A multi-channel memory presents a set of memory channels, typically
+ * interleaved DRAM controllers, as a single slave port. Requests are
+ * routed to the channel owning their address without any added
+ * latency and without scheduling events, so the channels see exactly
+ * the same traffic as when connected to the memory bus directly. This
+ * avoids the extra crossbar hop, and its layer and retry events, that
+ * configurations otherwise need when the channels sit behind one
+ * port.
+ *
+ * Flow control is passed through. A request refused by a channel is
+ * retried upstream when that channel asks for a retry, and channels
+ * whose responses were refused are given a retry once the upstream
+ * port is ready again.
+ */
+class MultiChannelMemory : public SimObject
+{
+  public:
+
+    MultiChannelMemory(const MultiChannelMemoryParams *p);
+
+    Port &getPort(const std::string &if_name,
+                  PortID idx=InvalidPortID) override;
+
+    void init() override;
+
+    void regStats() override;
+
+  protected:
+
+    class MemSidePort : public SlavePort
+    {
+      public:
+
+        MemSidePort(const std::string &_name, MultiChannelMemory &_mem)
+            : SlavePort(_name, &_mem), mem(_mem)
+        { }
+
+      protected:
+
+        void
+        recvFunctional(PacketPtr pkt) override
+        {
+            mem.recvFunctional(pkt);
+        }
+
+        Tick
+        recvAtomic(PacketPtr pkt) override
+        {
+            return mem.recvAtomic(pkt);
+        }
+
+        Tick
+        recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor) override
+        {
+            return mem.recvAtomicBackdoor(pkt, backdoor);
+        }
+
+        bool
+        recvTimingReq(PacketPtr pkt) override
+        {
+            return mem.recvTimingReq(pkt);
+        }
+
+        void
+        recvRespRetry() override
+        {
+            mem.recvRespRetry();
+        }
+
+        AddrRangeList
+        getAddrRanges() const override
+        {
+            return mem.getAddrRanges();
+        }
+
+      private:
+
+        MultiChannelMemory &mem;
+    };
+
+    class ChannelPort : public MasterPort
+    {
+      public:
+
+        ChannelPort(const std::string &_name, MultiChannelMemory &_mem,
+                    PortID _id)
+            : MasterPort(_name, &_mem, _id), mem(_mem)
+        { }
+
+      protected:
+
+        bool
+        recvTimingResp(PacketPtr pkt) override
+        {
+            return mem.recvTimingResp(id, pkt);
+        }
+
+        void
+        recvReqRetry() override
+        {
+            mem.recvReqRetry(id);
+        }
+
+        void
+        recvRangeChange() override
+        {
+            mem.recvRangeChange(id);
+        }
+
+      private:
+
+        MultiChannelMemory &mem;
+    };
+
+    /** Port facing the rest of the memory system */
+    MemSidePort slavePort;
+
+    /** One port per channel */
+    std::vector<ChannelPort *> channelPorts;
+
+    /** Map from address ranges to the channel owning them */
+    AddrRangeMap<PortID, 3> channelMap;
+
+    /** Merged ranges of all channels, as reported upstream */
+    AddrRangeList ranges;
+
+    /** Channels that reported their ranges so far */
+    std::vector<bool> gotRanges;
+
+    /** Number of channels that reported their ranges so far */
+    unsigned numGotRanges;
+
+    /** Channel that refused the last request, if any */
+    PortID retryReqChannel;
+
+    /** Set while the upstream port is refusing responses */
+    bool respBlocked;
+
+    /** Channels waiting for a response retry, in the order refused */
+    std::vector<PortID> retryRespChannels;
+
+    Stats::Vector readReqs;
+    Stats::Vector writeReqs;
+    Stats::Vector bytesRead;
+    Stats::Vector bytesWritten;
+
+    /**
+     * Find the channel owning an address.
+     *
+     * @param pkt Packet to route.
+     * @return Index of the channel port.
+     */
+    PortID findChannel(PacketPtr pkt) const;
+
+    /** Count an accepted request in the per-channel stats. */
+    void recordRequest(PortID channel, const MemCmd &cmd, unsigned size);
+
+    void recvFunctional(PacketPtr pkt);
+
+    Tick recvAtomic(PacketPtr pkt);
+
+    Tick recvAtomicBackdoor(PacketPtr pkt, MemBackdoorPtr &backdoor);
+
+    bool recvTimingReq(PacketPtr pkt);
+
+    bool recvTimingResp(PortID channel, PacketPtr pkt);
+
+    void recvReqRetry(PortID channel);
+
+    void recvRespRetry();
+
+    void recvRangeChange(PortID channel);
+
+    AddrRangeList getAddrRanges() const;
+};
+
+#endif // __MEM_MULTI_CHANNEL_MEM_HH__
@@ -36,6 +36,7 @@
 #ifndef __MEM_MULTI_LEVEL_PAGE_TABLE_HH__
 #define __MEM_MULTI_LEVEL_PAGE_TABLE_HH__
 
+#include <mutex>
 #include <string>
 
 #include "base/types.hh"
@@ -215,6 +216,7 @@ public:
     void
     map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags = 0) override
     {
+        std::lock_guard<std::recursive_mutex> lock(tableLock);
         EmulationPageTable::map(vaddr, paddr, size, flags);
 
         Final entry;
@@ -235,6 +237,7 @@ public:
     void
     remap(Addr vaddr, int64_t size, Addr new_vaddr) override
     {
+        std::lock_guard<std::recursive_mutex> lock(tableLock);
         EmulationPageTable::remap(vaddr, size, new_vaddr);
 
         Final old_entry, new_entry;
@@ -258,6 +261,7 @@ public:
     void
     unmap(Addr vaddr, int64_t size) override
     {
+        std::lock_guard<std::recursive_mutex> lock(tableLock);
         EmulationPageTable::unmap(vaddr, size);
 
         Final entry;
@@ -227,6 +227,8 @@ MemCmd::commandInfo[] =
       InvalidCmd, "InvalidateResp" }
 };
 
+__thread void *Packet::freeList = nullptr;
+
 AddrRange
 Packet::getAddrRange() const
 {
@@ -356,6 +356,16 @@ class Packet : public Printable
     // Quality of Service priority value
     uint8_t _qosValue;
 
+    /**
+     * Storage for the data of small accesses, which saves allocating
+     * a separate buffer for most accesses up to a cache line.
+     */
+    static const unsigned inlineDataSize = 64;
+    uint8_t inlineData[inlineDataSize];
+
+    //! Retired packets owned by the current thread.
+    static __thread void *freeList;
+
   public:
 
     /**
@@ -931,6 +941,31 @@ class Packet : public Printable
         deleteData();
     }
 
+    /**
+     * Packets are allocated and freed at a high rate, so recycle
+     * them through a per-thread free list. A packet may be freed by
+     * another thread than the one that allocated it, in which case it
+     * simply migrates to that thread's list.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        assert(size == sizeof(Packet));
+        if (!freeList)
+            return ::operator new(size);
+
+        void *p = freeList;
+        freeList = *static_cast<void **>(p);
+        return p;
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        *static_cast<void **>(p) = freeList;
+        freeList = p;
+    }
+
     /**
      * Take a request packet and modify it in place to be suitable for
      * returning as a response to that request.
@@ -1239,7 +1274,7 @@ class Packet : public Printable
     void
     deleteData()
     {
-        if (flags.isSet(DYNAMIC_DATA))
+        if (flags.isSet(DYNAMIC_DATA) && data != inlineData)
             delete [] data;
 
         flags.clear(STATIC_DATA|DYNAMIC_DATA);
@@ -1255,7 +1290,8 @@ class Packet : public Printable
         if (hasData() || hasRespData()) {
             assert(flags.noneSet(STATIC_DATA|DYNAMIC_DATA));
             flags.set(DYNAMIC_DATA);
-            data = new uint8_t[getSize()];
+            data = getSize() <= inlineDataSize ? inlineData :
+                new uint8_t[getSize()];
         }
     }
 
@@ -52,6 +52,7 @@ PacketQueue::PacketQueue(EventManager& _em, const std::string& _label,
                          bool force_order,
                          bool disable_sanity_check)
     : em(_em), sendEvent([this]{ processSendEvent(); }, _sendEventName),
+      inSendBatch(false), batchNextSend(MaxTick),
       _disableSanityCheck(disable_sanity_check),
       forceOrder(force_order),
       label(_label), waitingOnRetry(false)
@@ -161,6 +162,12 @@ PacketQueue::schedSendEvent(Tick when)
         return;
     }
 
+    if (inSendBatch) {
+        // processSendEvent takes care of the event when done
+        batchNextSend = std::min(batchNextSend, when);
+        return;
+    }
+
     if (when != MaxTick) {
         // we cannot go back in time, and to be consistent we stick to
         // one tick in the future
@@ -221,7 +228,19 @@ void
 PacketQueue::processSendEvent()
 {
     assert(!waitingOnRetry);
-    sendDeferredPacket();
+
+    // send all the packets that are due rather than scheduling a new
+    // event for each of them, and stop when the peer refuses one
+    inSendBatch = true;
+    do {
+        batchNextSend = MaxTick;
+        sendDeferredPacket();
+    } while (!waitingOnRetry && deferredPacketReady());
+    inSendBatch = false;
+
+    // the last send knows best when the next one is due, also
+    // accounting for any packet queued while sending
+    schedSendEvent(batchNextSend);
 }
 
 DrainState
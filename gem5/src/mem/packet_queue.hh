@@ -52,7 +52,7 @@
  * for the flow control of the port.
  */
 
-#include <list>
+#include <deque>
 
 #include "mem/port.hh"
 #include "sim/drain.hh"
@@ -75,7 +75,12 @@ class PacketQueue : public Drainable
         {}
     };
 
-    typedef std::list<DeferredPacket> DeferredPacketList;
+    /**
+     * Packets are nearly always appended or taken from the front, so
+     * use a deque rather than a list to avoid allocating a node per
+     * packet.
+     */
+    typedef std::deque<DeferredPacket> DeferredPacketList;
 
     /** A list of outgoing packets. */
     DeferredPacketList transmitList;
@@ -89,6 +94,16 @@ class PacketQueue : public Drainable
     /** Event used to call processSendEvent. */
     EventFunctionWrapper sendEvent;
 
+    /**
+     * Set while processSendEvent is sending all the packets that are
+     * due. Any send event requested in the meantime is only recorded,
+     * and the event is scheduled once when the batch is done.
+     */
+    bool inSendBatch;
+
+    /** Earliest send time requested while sending a batch. */
+    Tick batchNextSend;
+
      /*
       * Optionally disable the sanity check
       * on the size of the transmitList. The
@@ -37,7 +37,10 @@
  */
 #include "mem/page_table.hh"
 
+#include <algorithm>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "base/compiler.hh"
 #include "base/trace.hh"
@@ -45,76 +48,168 @@
 #include "sim/faults.hh"
 #include "sim/serialize.hh"
 
+EmulationPageTable::PTableItr
+EmulationPageTable::find(Addr vaddr)
+{
+    auto it = pTable.upper_bound(vaddr);
+    if (it == pTable.begin())
+        return pTable.end();
+    --it;
+    return vaddr - it->first < it->second.size ? it : pTable.end();
+}
+
+EmulationPageTable::PTableItr
+EmulationPageTable::findOverlap(Addr vaddr, Addr size)
+{
+    auto it = find(vaddr);
+    if (it != pTable.end())
+        return it;
+    it = pTable.lower_bound(vaddr);
+    if (it != pTable.end() && it->first - vaddr < size)
+        return it;
+    return pTable.end();
+}
+
+void
+EmulationPageTable::split(Addr vaddr)
+{
+    auto it = find(vaddr);
+    if (it == pTable.end() || it->first == vaddr)
+        return;
+
+    Range &range = it->second;
+    const Addr offset = vaddr - it->first;
+    pTable.emplace_hint(std::next(it), vaddr,
+            Range{range.size - offset, range.paddr + offset, range.flags});
+    range.size = offset;
+}
+
+void
+EmulationPageTable::mergeNext(PTableItr it)
+{
+    auto next = std::next(it);
+    if (next == pTable.end())
+        return;
+
+    Range &range = it->second;
+    if (it->first + range.size == next->first &&
+            range.paddr + range.size == next->second.paddr &&
+            range.flags == next->second.flags) {
+        range.size += next->second.size;
+        pTable.erase(next);
+    }
+}
+
+void
+EmulationPageTable::insert(Addr vaddr, const Range &range)
+{
+    auto it = pTable.emplace_hint(pTable.lower_bound(vaddr), vaddr, range);
+    mergeNext(it);
+    if (it != pTable.begin())
+        mergeNext(std::prev(it));
+}
+
 void
 EmulationPageTable::map(Addr vaddr, Addr paddr, int64_t size, uint64_t flags)
 {
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
     bool clobber = flags & Clobber;
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
     DPRINTF(MMU, "Allocating Page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        if (it != pTable.end()) {
-            // already mapped
-            panic_if(!clobber,
-                     "EmulationPageTable::allocate: addr %#x already mapped",
-                     vaddr);
-            it->second = Entry(paddr, flags);
-        } else {
-            pTable.emplace(vaddr, Entry(paddr, flags));
-        }
+    if (size <= 0)
+        return;
+
+    const Addr bytes = roundUp(size, pageSize);
+    lastRange = pTable.end();
 
-        size -= pageSize;
-        vaddr += pageSize;
-        paddr += pageSize;
+    auto overlap = findOverlap(vaddr, bytes);
+    if (overlap != pTable.end()) {
+        // already mapped
+        panic_if(!clobber,
+                 "EmulationPageTable::allocate: addr %#x already mapped",
+                 std::max(vaddr, overlap->first));
+        split(vaddr);
+        split(vaddr + bytes);
+        pTable.erase(pTable.lower_bound(vaddr),
+                     pTable.lower_bound(vaddr + bytes));
     }
+
+    insert(vaddr, Range{bytes, paddr, flags});
 }
 
 void
 EmulationPageTable::remap(Addr vaddr, int64_t size, Addr new_vaddr)
 {
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
     assert(pageOffset(vaddr) == 0);
     assert(pageOffset(new_vaddr) == 0);
 
     DPRINTF(MMU, "moving pages from vaddr %08p to %08p, size = %d\n", vaddr,
             new_vaddr, size);
 
-    while (size > 0) {
-        auto new_it M5_VAR_USED = pTable.find(new_vaddr);
-        auto old_it = pTable.find(vaddr);
-        assert(old_it != pTable.end() && new_it == pTable.end());
+    if (size <= 0)
+        return;
 
-        pTable.emplace(new_vaddr, old_it->second);
-        pTable.erase(old_it);
-        size -= pageSize;
-        vaddr += pageSize;
-        new_vaddr += pageSize;
-    }
+    const Addr bytes = roundUp(size, pageSize);
+    lastRange = pTable.end();
+
+    split(vaddr);
+    split(vaddr + bytes);
+    auto first = pTable.lower_bound(vaddr);
+    auto last = pTable.lower_bound(vaddr + bytes);
+
+    std::vector<std::pair<Addr, Range>> moved(first, last);
+    pTable.erase(first, last);
+
+    Addr M5_VAR_USED moved_bytes = 0;
+    for (const auto &range : moved)
+        moved_bytes += range.second.size;
+    assert(moved_bytes == bytes && isUnmapped(new_vaddr, bytes));
+
+    for (const auto &range : moved)
+        insert(range.first - vaddr + new_vaddr, range.second);
 }
 
 void
 EmulationPageTable::getMappings(std::vector<std::pair<Addr, Addr>> *addr_maps)
 {
-    for (auto &iter : pTable)
-        addr_maps->push_back(std::make_pair(iter.first, iter.second.paddr));
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
+    for (auto &iter : pTable) {
+        for (Addr offset = 0; offset < iter.second.size; offset += pageSize) {
+            addr_maps->push_back(std::make_pair(iter.first + offset,
+                                                iter.second.paddr + offset));
+        }
+    }
 }
 
 void
 EmulationPageTable::unmap(Addr vaddr, int64_t size)
 {
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
     assert(pageOffset(vaddr) == 0);
 
     DPRINTF(MMU, "Unmapping page: %#x-%#x\n", vaddr, vaddr + size);
 
-    while (size > 0) {
-        auto it = pTable.find(vaddr);
-        assert(it != pTable.end());
-        pTable.erase(it);
-        size -= pageSize;
-        vaddr += pageSize;
-    }
+    if (size <= 0)
+        return;
+
+    const Addr bytes = roundUp(size, pageSize);
+    lastRange = pTable.end();
+
+    split(vaddr);
+    split(vaddr + bytes);
+    auto first = pTable.lower_bound(vaddr);
+    auto last = pTable.lower_bound(vaddr + bytes);
+
+    Addr M5_VAR_USED unmapped_bytes = 0;
+    for (auto it = first; it != last; ++it)
+        unmapped_bytes += it->second.size;
+    assert(unmapped_bytes == bytes);
+
+    pTable.erase(first, last);
 }
 
 bool
@@ -123,21 +218,28 @@ EmulationPageTable::isUnmapped(Addr vaddr, int64_t size)
     // starting address must be page aligned
     assert(pageOffset(vaddr) == 0);
 
-    for (int64_t offset = 0; offset < size; offset += pageSize)
-        if (pTable.find(vaddr + offset) != pTable.end())
-            return false;
-
-    return true;
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
+    return size <= 0 || findOverlap(vaddr, size) == pTable.end();
 }
 
 const EmulationPageTable::Entry *
 EmulationPageTable::lookup(Addr vaddr)
 {
+    // Each host thread gets its own copy of the returned entry.
+    static thread_local Entry entry;
+
     Addr page_addr = pageAlign(vaddr);
-    PTableItr iter = pTable.find(page_addr);
-    if (iter == pTable.end())
-        return nullptr;
-    return &(iter->second);
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
+    if (lastRange == pTable.end() || page_addr < lastRange->first ||
+            page_addr - lastRange->first >= lastRange->second.size) {
+        lastRange = find(page_addr);
+        if (lastRange == pTable.end())
+            return nullptr;
+    }
+
+    const Range &range = lastRange->second;
+    entry = Entry(range.paddr + (page_addr - lastRange->first), range.flags);
+    return &entry;
 }
 
 bool
@@ -172,6 +274,7 @@ EmulationPageTable::translate(const RequestPtr &req)
 void
 EmulationPageTable::serialize(CheckpointOut &cp) const
 {
+    std::lock_guard<std::recursive_mutex> lock(tableLock);
     paramOut(cp, "ptable.size", pTable.size());
 
     PTable::size_type count = 0;
@@ -179,6 +282,7 @@ EmulationPageTable::serialize(CheckpointOut &cp) const
         ScopedCheckpointSection sec(cp, csprintf("Entry%d", count++));
 
         paramOut(cp, "vaddr", pte.first);
+        paramOut(cp, "size", pte.second.size);
         paramOut(cp, "paddr", pte.second.paddr);
         paramOut(cp, "flags", pte.second.flags);
     }
@@ -191,17 +295,21 @@ EmulationPageTable::unserialize(CheckpointIn &cp)
     int count;
     paramIn(cp, "ptable.size", count);
 
+    lastRange = pTable.end();
     for (int i = 0; i < count; ++i) {
         ScopedCheckpointSection sec(cp, csprintf("Entry%d", i));
 
         Addr vaddr;
         UNSERIALIZE_SCALAR(vaddr);
+        // Old checkpoints store a single page per entry.
+        Addr size;
+        if (!UNSERIALIZE_OPT_SCALAR(size))
+            size = pageSize;
         Addr paddr;
         uint64_t flags;
         UNSERIALIZE_SCALAR(paddr);
         UNSERIALIZE_SCALAR(flags);
 
-        pTable.emplace(vaddr, Entry(paddr, flags));
+        insert(vaddr, Range{size, paddr, flags});
     }
 }
-
@@ -37,8 +37,9 @@
 #ifndef __MEM_PAGE_TABLE_HH__
 #define __MEM_PAGE_TABLE_HH__
 
+#include <map>
+#include <mutex>
 #include <string>
-#include <unordered_map>
 
 #include "base/intmath.hh"
 #include "base/types.hh"
@@ -60,20 +61,64 @@ class EmulationPageTable : public Serializable
     };
 
   protected:
-    typedef std::unordered_map<Addr, Entry> PTable;
+    /**
+     * A range of virtual pages mapped to contiguous physical pages with
+     * the same flags. Mappings are stored as ranges rather than pages,
+     * so large regions (or huge pages) take a single entry and mapping
+     * or unmapping them doesn't depend on their size.
+     */
+    struct Range
+    {
+        Addr size;
+        Addr paddr;
+        uint64_t flags;
+    };
+
+    /** Mapped ranges indexed by their first virtual address */
+    typedef std::map<Addr, Range> PTable;
     typedef PTable::iterator PTableItr;
     PTable pTable;
 
+    /** Range the last lookup hit, pTable.end() if none */
+    PTableItr lastRange;
+
+    /**
+     * Protects the table and the lookup cache. A table shared by the
+     * threads of a process is used by CPUs that may run on different
+     * event queues. The lock is recursive so that derived tables can
+     * hold it across their own updates and the base class ones.
+     */
+    mutable std::recursive_mutex tableLock;
+
     const Addr pageSize;
     const Addr offsetMask;
 
     const uint64_t _pid;
     const std::string _name;
 
+    /** Find the range containing vaddr, pTable.end() if there is none. */
+    PTableItr find(Addr vaddr);
+
+    /** Find the first range overlapping a region, if any. */
+    PTableItr findOverlap(Addr vaddr, Addr size);
+
+    /** Split the range containing vaddr so that a range starts there. */
+    void split(Addr vaddr);
+
+    /**
+     * Add a range to an unmapped region, merging it with its
+     * neighbours when they are contiguous.
+     */
+    void insert(Addr vaddr, const Range &range);
+
+    /** Merge a range with the next one if they are contiguous. */
+    void mergeNext(PTableItr it);
+
   public:
 
     EmulationPageTable(
             const std::string &__name, uint64_t _pid, Addr _pageSize) :
+            lastRange(pTable.end()),
             pageSize(_pageSize), offsetMask(mask(floorLog2(_pageSize))),
             _pid(_pid), _name(__name), shared(false)
     {
@@ -130,7 +175,8 @@ class EmulationPageTable : public Serializable
     /**
      * Lookup function
      * @param vaddr The virtual address.
-     * @return The page table entry corresponding to vaddr.
+     * @return The page table entry corresponding to vaddr. It stays
+     * valid until the next call to lookup from the same host thread.
      */
     const Entry *lookup(Addr vaddr);
 
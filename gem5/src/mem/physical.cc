@@ -40,18 +40,44 @@
 #include "mem/physical.hh"
 
 #include <fcntl.h>
+#include <sys/file.h>
 #include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <sys/user.h>
 #include <unistd.h>
 #include <zlib.h>
 
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#include "config/have_userfaultfd.hh"
+
+#if HAVE_USERFAULTFD
+#include <linux/userfaultfd.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
 #include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
 #include <string>
+#include <thread>
 
+#include "base/intmath.hh"
+#include "base/str.hh"
 #include "base/trace.hh"
 #include "debug/AddrRanges.hh"
 #include "debug/Checkpoint.hh"
@@ -69,16 +95,624 @@
 #endif
 #endif
 
+/**
+ * Huge pages are only supported on Linux. Anonymous hugetlbfs
+ * mappings have to be a multiple of the huge page size, which is
+ * assumed to be the 2 MiB default of the common hosts.
+ */
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0
+#endif
+static const uint64_t hugePageSize = ULL(2) << 20;
+
+/**
+ * Memory policies of mbind(2), defined here to not depend on the
+ * libnuma headers.
+ */
+#if defined(__linux__) && defined(SYS_mbind)
+static const int mpolPreferred = 1;
+static const int mpolInterleave = 3;
+#endif
+
 using namespace std;
 
+/**
+ * Chunked store files start with a header, followed by the compressed
+ * chunks, the bitmap of the pages that are stored, and the table of
+ * the chunks. Every chunk covers a fixed number of pages, of which
+ * only the ones that are not all zero are compressed, back to back.
+ */
+static const char chunkedStoreMagic[] = "GPMC";
+static const uint32_t chunkedStoreVersion = 1;
+
+// A chunk owns whole bytes of the bitmap, so threads never share one
+static const uint64_t chunkPages = 256;
+static_assert(chunkPages % 8 == 0, "Chunks must own whole bitmap bytes");
+
+struct ChunkedStoreHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint64_t size;
+    uint64_t pageSize;
+    uint64_t chunkPages;
+    // Offset of the page bitmap, which the chunk table and the path
+    // of the parent store follow
+    uint64_t indexOffset;
+    // Length of the path of the parent store of a delta store,
+    // relative to the directory of the store, 0 for a full store
+    uint64_t parentLength;
+};
+
+struct ChunkEntry
+{
+    uint64_t offset;
+    // Compressed size, 0 if all the pages of the chunk are zero
+    uint64_t size;
+};
+
+static bool
+isZeroPage(const uint8_t *page, uint64_t len)
+{
+    return page[0] == 0 && memcmp(page, page + 1, len - 1) == 0;
+}
+
+/**
+ * Digest of the contents of a page, telling if it changed between
+ * two checkpoints.
+ */
+static uint64_t
+pageDigest(const uint8_t *page, uint64_t len)
+{
+    uint64_t digest = len;
+    uint64_t i = 0;
+    for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, page + i, sizeof(word));
+        digest = (digest ^ word) * ULL(0x9e3779b97f4a7c15);
+        digest ^= digest >> 29;
+    }
+    for (; i < len; ++i)
+        digest = (digest ^ page[i]) * ULL(0x100000001b3);
+    return digest;
+}
+
+/** Directory of a file path, including the last '/' */
+static string
+dirName(const string &path)
+{
+    return path.substr(0, path.rfind('/') + 1);
+}
+
+/** Path of a file relative to a directory, both absolute */
+static string
+relativePath(const string &dir, const string &file)
+{
+    vector<string> from, to;
+    tokenize(from, dir, '/');
+    tokenize(to, file, '/');
+
+    size_t common = 0;
+    while (common < from.size() && common + 1 < to.size() &&
+           from[common] == to[common]) {
+        ++common;
+    }
+
+    string path;
+    for (size_t i = common; i < from.size(); ++i)
+        path += "../";
+    for (size_t i = common; i < to.size(); ++i)
+        path += (i == common ? "" : "/") + to[i];
+    return path;
+}
+
+static string
+absolutePath(const string &path)
+{
+    char *abs_path = realpath(path.c_str(), nullptr);
+    if (!abs_path)
+        fatal("Can't resolve the path of '%s'\n", path);
+    string str(abs_path);
+    free(abs_path);
+    return str;
+}
+
+/**
+ * Call func for every index up to n, on up to num_threads threads
+ * including the calling one.
+ */
+static void
+parallelFor(uint64_t n, unsigned num_threads,
+            const function<void(uint64_t)> &func)
+{
+    atomic<uint64_t> next(0);
+    auto worker = [&]() {
+        for (uint64_t i = next++; i < n; i = next++)
+            func(i);
+    };
+
+    vector<thread> threads;
+    for (uint64_t t = 1; t < min<uint64_t>(num_threads, n); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto &t : threads)
+        t.join();
+}
+
+static void
+writeAll(int fd, const void *buf, uint64_t len, uint64_t offset,
+         const string &filepath)
+{
+    const uint8_t *data = static_cast<const uint8_t *>(buf);
+    for (uint64_t done = 0; done < len; ) {
+        ssize_t ret = pwrite(fd, data + done, len - done, offset + done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            fatal("Write failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+        done += ret;
+    }
+}
+
+static void
+readAll(int fd, void *buf, uint64_t len, uint64_t offset,
+        const string &filepath)
+{
+    uint8_t *data = static_cast<uint8_t *>(buf);
+    for (uint64_t done = 0; done < len; ) {
+        ssize_t ret = pread(fd, data + done, len - done, offset + done);
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret <= 0)
+            fatal("Read failed on physical memory checkpoint file '%s'\n",
+                  filepath);
+        done += ret;
+    }
+}
+
+/**
+ * The header, page bitmap and chunk table of a chunked store file,
+ * which is kept open to read the chunks from.
+ */
+struct ChunkedStoreIndex
+{
+    const string filepath;
+    int fd;
+    ChunkedStoreHeader header;
+    vector<uint8_t> bitmap;
+    vector<ChunkEntry> table;
+    string parent;
+
+    uint64_t numPages;
+    uint64_t numChunks;
+    uint64_t chunkSize;
+
+    ChunkedStoreIndex(const string &_filepath, AddrRange range);
+    ~ChunkedStoreIndex() { close(fd); }
+
+    bool stored(uint64_t p) const { return bitmap[p / 8] & (1 << (p % 8)); }
+};
+
+ChunkedStoreIndex::ChunkedStoreIndex(const string &_filepath,
+                                     AddrRange range)
+    : filepath(_filepath), fd(open(filepath.c_str(), O_RDONLY))
+{
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    readAll(fd, &header, sizeof(header), 0, filepath);
+    if (memcmp(header.magic, chunkedStoreMagic, sizeof(header.magic)) ||
+        header.version != chunkedStoreVersion) {
+        fatal("'%s' is not a chunked physical memory checkpoint file\n",
+              filepath);
+    }
+    if (header.size != range.size())
+        fatal("Physical memory checkpoint file '%s' does not match the "
+              "size of range %s\n", filepath, range.to_string());
+
+    numPages = divCeil(header.size, header.pageSize);
+    numChunks = divCeil(numPages, header.chunkPages);
+    chunkSize = header.chunkPages * header.pageSize;
+
+    bitmap.resize(divCeil(numPages, 8));
+    table.resize(numChunks);
+    parent.resize(header.parentLength);
+    uint64_t offset = header.indexOffset;
+    readAll(fd, bitmap.data(), bitmap.size(), offset, filepath);
+    offset += bitmap.size();
+    readAll(fd, table.data(), table.size() * sizeof(ChunkEntry), offset,
+            filepath);
+    offset += table.size() * sizeof(ChunkEntry);
+    readAll(fd, &parent[0], parent.size(), offset, filepath);
+}
+
+/**
+ * Decompress the pages a store holds of a chunk into the memory of
+ * the chunk, leaving the other pages of the chunk untouched.
+ *
+ * @param index The index of the store
+ * @param chunk The chunk to restore
+ * @param chunk_mem The memory of the first page of the chunk
+ */
+static void
+restoreChunk(const ChunkedStoreIndex &index, uint64_t chunk,
+             uint8_t *chunk_mem)
+{
+    const ChunkEntry &entry = index.table[chunk];
+    if (entry.size == 0)
+        return;
+
+    const uint64_t size = index.header.size;
+    const uint64_t page_size = index.header.pageSize;
+    const uint64_t first = chunk * index.header.chunkPages;
+    const uint64_t end = min(index.numPages, first + index.header.chunkPages);
+    uint64_t pages_len = 0;
+    for (uint64_t p = first; p < end; ++p) {
+        if (index.stored(p))
+            pages_len += min(page_size, size - p * page_size);
+    }
+
+    static thread_local vector<uint8_t> compressed;
+    static thread_local vector<uint8_t> pages;
+    compressed.resize(entry.size);
+    pages.resize(pages_len);
+    readAll(index.fd, compressed.data(), entry.size, entry.offset,
+            index.filepath);
+
+    uLongf len = pages_len;
+    if (uncompress(pages.data(), &len, compressed.data(),
+                   entry.size) != Z_OK || len != pages_len) {
+        fatal("Physical memory checkpoint file '%s' is corrupted\n",
+              index.filepath);
+    }
+
+    const uint8_t *page = pages.data();
+    for (uint64_t p = first; p < end; ++p) {
+        if (!index.stored(p))
+            continue;
+        const uint64_t page_len = min(page_size, size - p * page_size);
+        memcpy(chunk_mem + (p - first) * page_size, page, page_len);
+        page += page_len;
+    }
+}
+
+/**
+ * Open a chunked store and the parent stores it refers to.
+ *
+ * @return The stores, the oldest parent first
+ */
+static vector<unique_ptr<ChunkedStoreIndex>>
+readStoreChain(const string &filepath, AddrRange range)
+{
+    // a delta store only holds the pages that changed since its
+    // parent, so the stores are applied from the oldest parent on
+    vector<unique_ptr<ChunkedStoreIndex>> chain;
+    for (string path = filepath; ; ) {
+        chain.emplace(chain.begin(), new ChunkedStoreIndex(path, range));
+        const string &parent = chain.front()->parent;
+        if (parent.empty())
+            break;
+        DPRINTF(Checkpoint, "Restoring parent store %s\n", parent);
+        path = dirName(path) + parent;
+    }
+    return chain;
+}
+
+/**
+ * Decompress a chain of stores into memory that is all zero, like
+ * the pages left out of a full store.
+ */
+static void
+restoreStoreChain(const vector<unique_ptr<ChunkedStoreIndex>> &chain,
+                  uint8_t *pmem, unsigned num_threads)
+{
+    for (const auto &index : chain) {
+        parallelFor(index->numChunks, num_threads, [&](uint64_t chunk) {
+            restoreChunk(*index, chunk, pmem + chunk * index->chunkSize);
+        });
+    }
+}
+
+#if HAVE_USERFAULTFD
+/**
+ * Restores chunked stores on demand. The backing stores are
+ * registered with a userfaultfd, so the first touch of any of their
+ * pages faults, whether it comes from a memory, a backdoor, KVM or
+ * the host, and a thread services the faults by decompressing the
+ * whole chunk of the page into place. Forking pages in everything
+ * first, as the children are not registered.
+ */
+class LazyRestorer
+{
+  private:
+    struct Store
+    {
+        uint8_t *pmem;
+        uint64_t size;
+        uint64_t pageSize;
+        uint64_t chunkSize;
+        uint64_t numChunks;
+        // The stores to apply, the oldest parent first
+        vector<unique_ptr<ChunkedStoreIndex>> chain;
+        unique_ptr<atomic<bool>[]> loaded;
+    };
+
+    static LazyRestorer *instance;
+
+    const int uffd;
+
+    // Guards the list, not the stores, which only go away with the
+    // backing stores they restore
+    mutex storesLock;
+    list<Store> stores;
+
+    LazyRestorer(int fd);
+
+    Store *find(const uint8_t *addr);
+
+    /** Copy a chunk into place, unless it has already been. */
+    void fill(Store &store, uint64_t chunk);
+
+    /** Main loop of the thread servicing the faults. */
+    void serviceFaults();
+
+    static void prepareFork();
+    static void forkedChild();
+
+  public:
+    /** The restorer, or nullptr if userfaultfd can't be used. */
+    static LazyRestorer *get();
+
+    /**
+     * Register a backing store to be restored from a chain of
+     * stores, which the restorer takes over.
+     *
+     * @return false if the backing store can't be restored lazily
+     */
+    bool add(uint8_t *pmem, uint64_t size,
+             vector<unique_ptr<ChunkedStoreIndex>> &chain);
+
+    /** Forget a backing store that is about to be unmapped. */
+    void remove(const uint8_t *pmem);
+
+    /** Restore the chunks of a backing store that are still left. */
+    void pageIn(const uint8_t *pmem, unsigned num_threads);
+};
+
+LazyRestorer *LazyRestorer::instance = nullptr;
+
+LazyRestorer::LazyRestorer(int fd)
+    : uffd(fd)
+{
+    static bool registered = false;
+    if (!registered)
+        pthread_atfork(prepareFork, nullptr, forkedChild);
+    registered = true;
+
+    thread(&LazyRestorer::serviceFaults, this).detach();
+}
+
+LazyRestorer *
+LazyRestorer::get()
+{
+    static bool unavailable = false;
+    if (instance || unavailable)
+        return instance;
+
+    int fd = syscall(__NR_userfaultfd, O_CLOEXEC);
+    struct uffdio_api api;
+    memset(&api, 0, sizeof(api));
+    api.api = UFFD_API;
+    if (fd < 0 || ioctl(fd, UFFDIO_API, &api) != 0) {
+        warn("userfaultfd is not available (%s), restoring memory "
+             "eagerly\n", strerror(errno));
+        if (fd >= 0)
+            close(fd);
+        unavailable = true;
+        return nullptr;
+    }
+
+    instance = new LazyRestorer(fd);
+    return instance;
+}
+
+bool
+LazyRestorer::add(uint8_t *pmem, uint64_t size,
+                  vector<unique_ptr<ChunkedStoreIndex>> &chain)
+{
+    // the faults are serviced a host page at a time at least, and all
+    // the stores have to agree on the chunks
+    const ChunkedStoreHeader &header = chain.back()->header;
+    if (header.pageSize != sysconf(_SC_PAGESIZE))
+        return false;
+    for (const auto &index : chain) {
+        if (index->header.pageSize != header.pageSize ||
+            index->header.chunkPages != header.chunkPages) {
+            return false;
+        }
+    }
+
+    // drop anything the backing store holds, so that every page
+    // faults when it is first touched
+    const uint64_t map_size = roundUp(size, header.pageSize);
+    madvise(pmem, map_size, MADV_DONTNEED);
+
+    struct uffdio_register reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.range.start = (uintptr_t)pmem;
+    reg.range.len = map_size;
+    reg.mode = UFFDIO_REGISTER_MODE_MISSING;
+    if (ioctl(uffd, UFFDIO_REGISTER, &reg) != 0) {
+        warn("Can't register the backing store with userfaultfd (%s), "
+             "restoring memory eagerly\n", strerror(errno));
+        return false;
+    }
+
+    lock_guard<mutex> lock(storesLock);
+    stores.emplace_back();
+    Store &store = stores.back();
+    store.pmem = pmem;
+    store.size = size;
+    store.pageSize = header.pageSize;
+    store.chunkSize = chain.back()->chunkSize;
+    store.numChunks = chain.back()->numChunks;
+    store.chain.swap(chain);
+    store.loaded.reset(new atomic<bool>[store.numChunks]);
+    for (uint64_t c = 0; c < store.numChunks; ++c)
+        store.loaded[c] = false;
+    return true;
+}
+
+void
+LazyRestorer::remove(const uint8_t *pmem)
+{
+    lock_guard<mutex> lock(storesLock);
+    stores.remove_if([pmem](const Store &s) { return s.pmem == pmem; });
+}
+
+LazyRestorer::Store *
+LazyRestorer::find(const uint8_t *addr)
+{
+    lock_guard<mutex> lock(storesLock);
+    for (auto &store : stores) {
+        if (addr >= store.pmem && addr < store.pmem + store.size)
+            return &store;
+    }
+    return nullptr;
+}
+
+void
+LazyRestorer::fill(Store &store, uint64_t chunk)
+{
+    if (store.loaded[chunk])
+        return;
+
+    const uint64_t offset = chunk * store.chunkSize;
+    const uint64_t len = min(store.chunkSize,
+                             roundUp(store.size - offset, store.pageSize));
+
+    static thread_local vector<uint8_t> buf;
+    buf.assign(len, 0);
+    for (const auto &index : store.chain)
+        restoreChunk(*index, chunk, buf.data());
+
+    // another thread may have raced us to some of the pages, which
+    // are skipped
+    struct uffdio_copy copy;
+    for (uint64_t done = 0; done < len; ) {
+        memset(&copy, 0, sizeof(copy));
+        copy.dst = (uintptr_t)(store.pmem + offset + done);
+        copy.src = (uintptr_t)(buf.data() + done);
+        copy.len = len - done;
+        if (ioctl(uffd, UFFDIO_COPY, &copy) == 0)
+            break;
+        if (errno != EEXIST && errno != EAGAIN)
+            fatal("Can't restore physical memory from '%s' (%s)\n",
+                  store.chain.back()->filepath, strerror(errno));
+        done += max<int64_t>(copy.copy, 0);
+        if (errno == EEXIST)
+            done += store.pageSize;
+    }
+
+    store.loaded[chunk] = true;
+}
+
+void
+LazyRestorer::serviceFaults()
+{
+    while (true) {
+        struct uffd_msg msg;
+        ssize_t ret = read(uffd, &msg, sizeof(msg));
+        if (ret < 0 && errno == EINTR)
+            continue;
+        if (ret != sizeof(msg))
+            fatal("Can't read from userfaultfd (%s)\n", strerror(errno));
+        if (msg.event != UFFD_EVENT_PAGEFAULT)
+            continue;
+
+        const uint8_t *addr = (const uint8_t *)msg.arg.pagefault.address;
+        Store *store = find(addr);
+        if (!store)
+            panic("Fault at %p outside of the lazily restored memory\n",
+                  addr);
+
+        const uint64_t chunk = (addr - store->pmem) / store->chunkSize;
+        fill(*store, chunk);
+
+        // the fault may have raced with a page in of the chunk
+        const uint64_t offset = chunk * store->chunkSize;
+        struct uffdio_range range;
+        range.start = (uintptr_t)(store->pmem + offset);
+        range.len = min(store->chunkSize,
+                        roundUp(store->size - offset, store->pageSize));
+        ioctl(uffd, UFFDIO_WAKE, &range);
+    }
+}
+
+void
+LazyRestorer::pageIn(const uint8_t *pmem, unsigned num_threads)
+{
+    Store *store = find(pmem);
+    if (!store)
+        return;
+
+    parallelFor(store->numChunks, num_threads, [&](uint64_t chunk) {
+        fill(*store, chunk);
+    });
+}
+
+void
+LazyRestorer::prepareFork()
+{
+    if (!instance)
+        return;
+
+    for (auto &store : instance->stores)
+        instance->pageIn(store.pmem, 1);
+}
+
+void
+LazyRestorer::forkedChild()
+{
+    // the child doesn't have the thread servicing the faults, and
+    // its memory is not registered
+    instance = nullptr;
+}
+#endif
+
 PhysicalMemory::PhysicalMemory(const string& _name,
                                const vector<AbstractMemory*>& _memories,
-                               bool mmap_using_noreserve) :
-    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve)
+                               bool mmap_using_noreserve,
+                               bool mmap_using_hugetlb,
+                               bool mmap_using_thp,
+                               bool raw_checkpoint_stores,
+                               unsigned checkpoint_threads,
+                               bool delta_checkpoints,
+                               bool lazy_restore,
+                               const string &image_dir) :
+    _name(_name), size(0), mmapUsingNoReserve(mmap_using_noreserve),
+    mmapUsingHugeTLB(mmap_using_hugetlb), mmapUsingTHP(mmap_using_thp),
+    rawCheckpointStores(raw_checkpoint_stores),
+    checkpointThreads(checkpoint_threads ? checkpoint_threads :
+                      max(1u, thread::hardware_concurrency())),
+    deltaCheckpoints(delta_checkpoints), lazyRestore(lazy_restore),
+    imageDir(image_dir)
 {
     if (mmap_using_noreserve)
         warn("Not reserving swap space. May cause SIGSEGV on actual usage\n");
 
+    if (lazy_restore && !HAVE_USERFAULTFD)
+        warn("Lazy restores need userfaultfd, restoring memory eagerly\n");
+    else if (lazy_restore && (mmap_using_hugetlb || delta_checkpoints))
+        warn("Lazy restores don't work with huge pages or delta "
+             "checkpoints, restoring memory eagerly\n");
+
+    if (mmap_using_hugetlb && MAP_HUGETLB == 0)
+        warn("Huge pages are not supported on this host, "
+             "using normal pages\n");
+
     // add the memories from the system to the address map as
     // appropriate
     for (const auto& m : _memories) {
@@ -202,16 +836,50 @@ PhysicalMemory::createBackingStore(AddrRange range,
         map_flags |= MAP_NORESERVE;
     }
 
-    uint8_t* pmem = (uint8_t*) mmap(NULL, range.size(),
-                                    PROT_READ | PROT_WRITE,
-                                    map_flags, -1, 0);
+    uint8_t* pmem = (uint8_t*) MAP_FAILED;
+
+    // try to get pages from the hugetlbfs pool first, and fall back
+    // to normal pages if the pool is too small
+    if (mmapUsingHugeTLB && MAP_HUGETLB != 0) {
+        if (range.size() % hugePageSize == 0) {
+            pmem = (uint8_t*) mmap(NULL, range.size(),
+                                   PROT_READ | PROT_WRITE,
+                                   map_flags | MAP_HUGETLB, -1, 0);
+            warn_if(pmem == (uint8_t*) MAP_FAILED,
+                    "Could not mmap range %s using huge pages (%s), "
+                    "using normal pages\n", range.to_string(),
+                    strerror(errno));
+        } else {
+            warn("Range %s is not a multiple of the huge page size, "
+                 "using normal pages\n", range.to_string());
+        }
+    }
 
     if (pmem == (uint8_t*) MAP_FAILED) {
-        perror("mmap");
-        fatal("Could not mmap %d bytes for range %s!\n", range.size(),
-              range.to_string());
+        pmem = (uint8_t*) mmap(NULL, range.size(),
+                               PROT_READ | PROT_WRITE,
+                               map_flags, -1, 0);
+
+        if (pmem == (uint8_t*) MAP_FAILED) {
+            perror("mmap");
+            fatal("Could not mmap %d bytes for range %s!\n", range.size(),
+                  range.to_string());
+        }
+
+#if defined(MADV_HUGEPAGE)
+        // ask the host to back the store with transparent huge pages
+        if (mmapUsingTHP && madvise(pmem, range.size(), MADV_HUGEPAGE) != 0)
+            warn("Could not advise transparent huge pages for range %s "
+                 "(%s)\n", range.to_string(), strerror(errno));
+#else
+        warn_if(mmapUsingTHP, "Transparent huge pages are not supported "
+                "on this host\n");
+#endif
     }
 
+    // the placement must be set before the store is touched
+    placeBackingStore(pmem, range.size(), _memories);
+
     // remember this backing store so we can checkpoint it and unmap
     // it appropriately
     backingStore.emplace_back(range, pmem,
@@ -225,11 +893,55 @@ PhysicalMemory::createBackingStore(AddrRange range,
     }
 }
 
+void
+PhysicalMemory::placeBackingStore(uint8_t *pmem, uint64_t size,
+                                  const vector<AbstractMemory*>& _memories)
+{
+    set<int> nodes;
+    for (const auto& m : _memories) {
+        if (m->getHostNumaNode() >= 0)
+            nodes.insert(m->getHostNumaNode());
+    }
+
+    if (nodes.empty())
+        return;
+
+#if defined(__linux__) && defined(SYS_mbind)
+    const int bits = sizeof(unsigned long) * CHAR_BIT;
+    vector<unsigned long> mask(*nodes.rbegin() / bits + 1, 0);
+    for (auto n : nodes)
+        mask[n / bits] |= 1UL << (n % bits);
+
+    // a single node is only preferred, so that a node running out of
+    // memory does not take down the simulation
+    const int mode = nodes.size() == 1 ? mpolPreferred : mpolInterleave;
+
+    DPRINTF(AddrRanges, "Placing backing store of %s on %d host node(s)\n",
+            _memories.front()->name(), nodes.size());
+
+    // the kernel expects the number of nodes plus one
+    if (syscall(SYS_mbind, pmem, size, mode, mask.data(),
+                mask.size() * bits + 1, 0) != 0) {
+        warn("Could not place backing store of %s on the requested host "
+             "NUMA nodes (%s)\n", _memories.front()->name(),
+             strerror(errno));
+    }
+#else
+    warn("Host NUMA placement is not supported on this host, ignoring "
+         "the node of %s\n", _memories.front()->name());
+#endif
+}
+
 PhysicalMemory::~PhysicalMemory()
 {
     // unmap the backing store
-    for (auto& s : backingStore)
+    for (auto& s : backingStore) {
+#if HAVE_USERFAULTFD
+        if (lazyRestore && LazyRestorer::get())
+            LazyRestorer::get()->remove(s.pmem);
+#endif
         munmap((char*)s.pmem, s.range.size());
+    }
 }
 
 bool
@@ -238,6 +950,19 @@ PhysicalMemory::isMemAddr(Addr addr) const
     return addrMap.contains(addr) != addrMap.end();
 }
 
+uint8_t *
+PhysicalMemory::hostAddr(Addr addr, Addr &size) const
+{
+    for (const auto &entry : backingStore) {
+        if (entry.range.contains(addr)) {
+            const Addr offset = addr - entry.range.start();
+            size = entry.range.size() - offset;
+            return entry.pmem + offset;
+        }
+    }
+    return nullptr;
+}
+
 AddrRangeList
 PhysicalMemory::getConfAddrRanges() const
 {
@@ -317,6 +1042,12 @@ PhysicalMemory::serialize(CheckpointOut &cp) const
     unsigned int store_id = 0;
     // store each backing store memory segment in a file
     for (auto& s : backingStore) {
+#if HAVE_USERFAULTFD
+        // restore what is left of a lazily restored store in
+        // parallel, rather than fault it in a chunk at a time
+        if (lazyRestore && LazyRestorer::get())
+            LazyRestorer::get()->pageIn(s.pmem, checkpointThreads);
+#endif
         ScopedCheckpointSection sec(cp, csprintf("store%d", store_id));
         serializeStore(cp, store_id++, s.range, s.pmem);
     }
@@ -338,34 +1069,56 @@ PhysicalMemory::serializeStore(CheckpointOut &cp, unsigned int store_id,
     SERIALIZE_SCALAR(filename);
     SERIALIZE_SCALAR(range_size);
 
-    // write memory file
     string filepath = CheckpointIn::dir() + "/" + filename.c_str();
-    gzFile compressed_mem = gzopen(filepath.c_str(), "wb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'\n",
-              filename);
 
-    uint64_t pass_size = 0;
+    bool raw_store = rawCheckpointStores;
+    if (raw_store) {
+        SERIALIZE_SCALAR(raw_store);
+        serializeRawStore(filepath, range, pmem);
+        return;
+    }
 
-    // gzwrite fails if (int)len < 0 (gzwrite returns int)
-    for (uint64_t written = 0; written < range.size();
-         written += pass_size) {
-        pass_size = (uint64_t)INT_MAX < (range.size() - written) ?
-            (uint64_t)INT_MAX : (range.size() - written);
+    bool chunked_store = true;
+    SERIALIZE_SCALAR(chunked_store);
+    serializeChunkedStore(filepath, store_id, range, pmem);
+}
 
-        if (gzwrite(compressed_mem, pmem + written,
-                    (unsigned int) pass_size) != (int) pass_size) {
-            fatal("Write failed on physical memory checkpoint file '%s'\n",
-                  filename);
+void
+PhysicalMemory::serializeRawStore(const string &filepath, AddrRange range,
+                                  uint8_t* pmem) const
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    // size the file up front and only write the pages that are not
+    // all zero, leaving holes in the file for the rest
+    if (ftruncate(fd, range.size()) != 0)
+        fatal("Can't resize physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    for (uint64_t offset = 0; offset < range.size(); offset += page_size) {
+        const uint64_t len = min(page_size, range.size() - offset);
+        const uint8_t *page = pmem + offset;
+        if (all_of(page, page + len, [](uint8_t b) { return b == 0; }))
+            continue;
+
+        for (uint64_t done = 0; done < len; ) {
+            ssize_t ret = pwrite(fd, page + done, len - done, offset + done);
+            if (ret < 0 && errno == EINTR)
+                continue;
+            if (ret <= 0)
+                fatal("Write failed on physical memory checkpoint file "
+                      "'%s'\n", filepath);
+            done += ret;
         }
     }
 
-    // close the compressed stream and check that the exit status
-    // is zero
-    if (gzclose(compressed_mem))
+    if (close(fd) != 0)
         fatal("Close failed on physical memory checkpoint file '%s'\n",
-              filename);
-
+              filepath);
 }
 
 void
@@ -405,11 +1158,6 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
     UNSERIALIZE_SCALAR(filename);
     string filepath = cp.cptDir + "/" + filename;
 
-    // mmap memoryfile
-    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
-    if (compressed_mem == NULL)
-        fatal("Can't open physical memory checkpoint file '%s'", filename);
-
     // we've already got the actual backing store mapped
     uint8_t* pmem = backingStore[store_id].pmem;
     AddrRange range = backingStore[store_id].range;
@@ -424,6 +1172,32 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Memory range size has changed! Saw %lld, expected %lld\n",
               range_size, range.size());
 
+    // stores in checkpoints written before the raw format existed
+    // are always compressed
+    bool raw_store = false;
+    optParamIn(cp, "raw_store", raw_store, false);
+    if (raw_store) {
+        mapRawStore(filepath, range, pmem);
+        return;
+    }
+
+    bool chunked_store = false;
+    optParamIn(cp, "chunked_store", chunked_store, false);
+    if (chunked_store) {
+        if (!imageDir.empty())
+            mapSharedImage(filepath, range, pmem);
+        else
+            unserializeChunkedStore(filepath, range, pmem);
+        if (deltaCheckpoints)
+            trackStore(store_id, filepath);
+        return;
+    }
+
+    // stores of older checkpoints are a single gzip stream
+    gzFile compressed_mem = gzopen(filepath.c_str(), "rb");
+    if (compressed_mem == NULL)
+        fatal("Can't open physical memory checkpoint file '%s'", filename);
+
     uint64_t curr_size = 0;
     long* temp_page = new long[chunk_size];
     long* pmem_current;
@@ -452,3 +1226,276 @@ PhysicalMemory::unserializeStore(CheckpointIn &cp)
         fatal("Close failed on physical memory checkpoint file '%s'\n",
               filename);
 }
+
+void
+PhysicalMemory::serializeChunkedStore(const string &filepath,
+                                      unsigned int store_id, AddrRange range,
+                                      uint8_t* pmem) const
+{
+    int fd = open(filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    const uint64_t size = range.size();
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    const uint64_t num_pages = divCeil(size, page_size);
+    const uint64_t num_chunks = divCeil(num_pages, chunkPages);
+
+    vector<uint8_t> bitmap(divCeil(num_pages, 8));
+    vector<ChunkEntry> table(num_chunks);
+
+    // a delta store holds the pages that changed since its parent,
+    // including the ones that became zero
+    storeDigests.resize(backingStore.size());
+    parentStores.resize(backingStore.size());
+    vector<uint64_t> &digests = storeDigests[store_id];
+    const string abs_dir = deltaCheckpoints ?
+        absolutePath(dirName(filepath)) : "";
+    const string abs_filepath =
+        abs_dir + "/" + filepath.substr(filepath.rfind('/') + 1);
+    // a store overwriting its parent has to be a full one
+    const bool delta = deltaCheckpoints &&
+        !parentStores[store_id].empty() &&
+        parentStores[store_id] != abs_filepath;
+    string parent;
+    if (delta) {
+        parent = relativePath(abs_dir, parentStores[store_id]);
+        DPRINTF(Checkpoint, "Storing the pages changed since %s\n", parent);
+    }
+    if (deltaCheckpoints)
+        digests.resize(num_pages);
+
+    auto compress_chunk = [&](uint64_t chunk, vector<uint8_t> &out) {
+        // gather the pages to store
+        static thread_local vector<uint8_t> pages;
+        pages.clear();
+
+        const uint64_t end = min(num_pages, (chunk + 1) * chunkPages);
+        for (uint64_t p = chunk * chunkPages; p < end; ++p) {
+            const uint8_t *page = pmem + p * page_size;
+            const uint64_t len = min(page_size, size - p * page_size);
+            if (deltaCheckpoints) {
+                const uint64_t digest = pageDigest(page, len);
+                const bool changed = digest != digests[p];
+                digests[p] = digest;
+                if (delta && !changed)
+                    continue;
+            }
+            if (!delta && isZeroPage(page, len))
+                continue;
+            bitmap[p / 8] |= 1 << (p % 8);
+            pages.insert(pages.end(), page, page + len);
+        }
+
+        out.clear();
+        if (pages.empty())
+            return;
+
+        uLongf out_len = compressBound(pages.size());
+        out.resize(out_len);
+        if (compress2(out.data(), &out_len, pages.data(), pages.size(),
+                      Z_BEST_SPEED) != Z_OK) {
+            fatal("Compression failed on physical memory checkpoint "
+                  "file '%s'\n", filepath);
+        }
+        out.resize(out_len);
+    };
+
+    // compress a batch of chunks in parallel, then write them in
+    // order, which bounds the memory holding compressed chunks
+    const uint64_t batch = checkpointThreads * 4;
+    vector<vector<uint8_t>> compressed(batch);
+    uint64_t offset = sizeof(ChunkedStoreHeader);
+    for (uint64_t first = 0; first < num_chunks; first += batch) {
+        const uint64_t count = min(batch, num_chunks - first);
+        parallelFor(count, checkpointThreads, [&](uint64_t i) {
+            compress_chunk(first + i, compressed[i]);
+        });
+
+        for (uint64_t i = 0; i < count; ++i) {
+            ChunkEntry &entry = table[first + i];
+            entry.offset = offset;
+            entry.size = compressed[i].size();
+            writeAll(fd, compressed[i].data(), entry.size, offset, filepath);
+            offset += entry.size;
+        }
+    }
+
+    ChunkedStoreHeader header;
+    memcpy(header.magic, chunkedStoreMagic, sizeof(header.magic));
+    header.version = chunkedStoreVersion;
+    header.size = size;
+    header.pageSize = page_size;
+    header.chunkPages = chunkPages;
+    header.indexOffset = offset;
+    header.parentLength = parent.size();
+
+    writeAll(fd, bitmap.data(), bitmap.size(), offset, filepath);
+    offset += bitmap.size();
+    writeAll(fd, table.data(), table.size() * sizeof(ChunkEntry), offset,
+             filepath);
+    offset += table.size() * sizeof(ChunkEntry);
+    writeAll(fd, parent.data(), parent.size(), offset, filepath);
+    writeAll(fd, &header, sizeof(header), 0, filepath);
+
+    if (close(fd) != 0)
+        fatal("Close failed on physical memory checkpoint file '%s'\n",
+              filepath);
+
+    if (deltaCheckpoints)
+        parentStores[store_id] = abs_filepath;
+}
+
+void
+PhysicalMemory::unserializeChunkedStore(const string &filepath,
+                                        AddrRange range, uint8_t* pmem)
+{
+    vector<unique_ptr<ChunkedStoreIndex>> chain =
+        readStoreChain(filepath, range);
+
+#if HAVE_USERFAULTFD
+    if (lazyRestore && !mmapUsingHugeTLB && !deltaCheckpoints) {
+        LazyRestorer *restorer = LazyRestorer::get();
+        if (restorer && restorer->add(pmem, range.size(), chain)) {
+            DPRINTF(Checkpoint, "Restoring physical memory %s lazily\n",
+                    filepath);
+            return;
+        }
+    }
+#endif
+
+    restoreStoreChain(chain, pmem, checkpointThreads);
+}
+
+void
+PhysicalMemory::mapSharedImage(const string &filepath, AddrRange range,
+                               uint8_t* pmem)
+{
+    vector<unique_ptr<ChunkedStoreIndex>> chain =
+        readStoreChain(filepath, range);
+
+    // the image is named after the files it is decompressed from, so
+    // that rewriting any of them makes a new one
+    uint64_t key = ULL(0xcbf29ce484222325);
+    auto hash = [&key](const void *data, size_t len) {
+        const uint8_t *bytes = static_cast<const uint8_t *>(data);
+        for (size_t i = 0; i < len; ++i)
+            key = (key ^ bytes[i]) * ULL(0x100000001b3);
+    };
+    for (const auto &index : chain) {
+        const string path = absolutePath(index->filepath);
+        struct stat st;
+        if (fstat(index->fd, &st) != 0)
+            fatal("Can't stat physical memory checkpoint file '%s'\n",
+                  index->filepath);
+        hash(path.data(), path.size());
+        hash(&st.st_size, sizeof(st.st_size));
+        hash(&st.st_mtime, sizeof(st.st_mtime));
+    }
+    const string image = csprintf("%s/%016x.img", imageDir, key);
+
+    // the image only appears once it is complete, so it can be mapped
+    // right away if it is there
+    if (::access(image.c_str(), R_OK) != 0) {
+        // only one of the processes restoring the same checkpoint
+        // decompresses the image, the others wait for it
+        const string lock_path = csprintf("%s/%016x.lock", imageDir, key);
+        int lock_fd = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (lock_fd < 0 || flock(lock_fd, LOCK_EX) != 0)
+            fatal("Can't lock memory image '%s'\n", lock_path);
+
+        if (::access(image.c_str(), R_OK) != 0) {
+            DPRINTF(Checkpoint, "Decompressing %s to memory image %s\n",
+                    filepath, image);
+
+            const string tmp_path = image + ".tmp";
+            int fd = open(tmp_path.c_str(), O_RDWR | O_CREAT | O_TRUNC,
+                          0644);
+            if (fd < 0 || ftruncate(fd, range.size()) != 0)
+                fatal("Can't create memory image '%s'\n", tmp_path);
+
+            uint8_t *mem = (uint8_t *)mmap(NULL, range.size(),
+                                           PROT_READ | PROT_WRITE,
+                                           MAP_SHARED, fd, 0);
+            if (mem == (uint8_t *)MAP_FAILED)
+                fatal("Can't mmap memory image '%s'\n", tmp_path);
+            restoreStoreChain(chain, mem, checkpointThreads);
+            munmap(mem, range.size());
+
+            if (fsync(fd) != 0 || close(fd) != 0 ||
+                rename(tmp_path.c_str(), image.c_str()) != 0) {
+                fatal("Can't write memory image '%s'\n", image);
+            }
+        }
+
+        close(lock_fd);
+    }
+
+    mapRawStore(image, range, pmem);
+}
+
+void
+PhysicalMemory::trackStore(unsigned int store_id, const string &filepath)
+{
+    const uint8_t *pmem = backingStore[store_id].pmem;
+    const uint64_t size = backingStore[store_id].range.size();
+    const uint64_t page_size = sysconf(_SC_PAGESIZE);
+    const uint64_t num_pages = divCeil(size, page_size);
+
+    storeDigests.resize(backingStore.size());
+    parentStores.resize(backingStore.size());
+    vector<uint64_t> &digests = storeDigests[store_id];
+    digests.resize(num_pages);
+
+    parallelFor(divCeil(num_pages, chunkPages), checkpointThreads,
+                [&](uint64_t chunk) {
+        const uint64_t end = min(num_pages, (chunk + 1) * chunkPages);
+        for (uint64_t p = chunk * chunkPages; p < end; ++p) {
+            digests[p] = pageDigest(pmem + p * page_size,
+                                    min(page_size, size - p * page_size));
+        }
+    });
+
+    parentStores[store_id] = absolutePath(filepath);
+}
+
+void
+PhysicalMemory::mapRawStore(const string &filepath, AddrRange range,
+                            uint8_t* pmem)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Can't open physical memory checkpoint file '%s'\n",
+              filepath);
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size != range.size())
+        fatal("Physical memory checkpoint file '%s' does not match the "
+              "size of range %s\n", filepath, range.to_string());
+
+    int map_flags = MAP_PRIVATE | MAP_FIXED;
+    if (mmapUsingNoReserve)
+        map_flags |= MAP_NORESERVE;
+
+    // replace the anonymous backing store by a private mapping of the
+    // file at the same address, so that the memories and any
+    // backdoors keep pointing at valid memory. Pages are read from
+    // the file the first time they are touched, and written pages are
+    // copied and never make it back to the checkpoint.
+    uint8_t* mapped = (uint8_t*) mmap(pmem, range.size(),
+                                      PROT_READ | PROT_WRITE,
+                                      map_flags, fd, 0);
+    if (mapped == (uint8_t*) MAP_FAILED) {
+        perror("mmap");
+        fatal("Could not mmap physical memory checkpoint file '%s'\n",
+              filepath);
+    }
+    assert(mapped == pmem);
+
+    // the mapping keeps its own reference to the file
+    close(fd);
+
+    DPRINTF(Checkpoint, "Mapped physical memory %s for range %s\n",
+            filepath, range.to_string());
+}
@@ -129,6 +129,34 @@ class PhysicalMemory : public Serializable
     // Let the user choose if we reserve swap space when calling mmap
     const bool mmapUsingNoReserve;
 
+    // Let the user choose if the backing store uses hugetlbfs pages
+    const bool mmapUsingHugeTLB;
+
+    // Let the user choose if we advise transparent huge pages
+    const bool mmapUsingTHP;
+
+    // Let the user choose if the stores are checkpointed uncompressed
+    const bool rawCheckpointStores;
+
+    // Number of threads compressing the stores in checkpoints
+    const unsigned checkpointThreads;
+
+    // Let the user choose if the stores are checkpointed as deltas
+    const bool deltaCheckpoints;
+
+    // Let the user choose if compressed stores are restored on demand
+    const bool lazyRestore;
+
+    // Directory of the memory images shared between the processes
+    // restoring the same checkpoint, empty if the stores are private
+    const std::string imageDir;
+
+    // Digests of the pages of the stores at the last checkpoint, and
+    // the files of these checkpointed stores, which delta stores
+    // refer to
+    mutable std::vector<std::vector<uint64_t>> storeDigests;
+    mutable std::vector<std::string> parentStores;
+
     // The physical memory used to provide the memory in the simulated
     // system
     std::vector<BackingStoreEntry> backingStore;
@@ -153,6 +181,19 @@ class PhysicalMemory : public Serializable
                             bool conf_table_reported,
                             bool in_addr_map, bool kvm_map);
 
+    /**
+     * Place a backing store on the host NUMA nodes requested by the
+     * memories it provides storage for. If they all ask for the same
+     * node the store is bound to it, and if they ask for different
+     * nodes the store is interleaved across them.
+     *
+     * @param pmem Start of the backing store
+     * @param size Size of the backing store
+     * @param memories The memories this backing store maps to
+     */
+    void placeBackingStore(uint8_t *pmem, uint64_t size,
+                           const std::vector<AbstractMemory*>& _memories);
+
   public:
 
     /**
@@ -160,7 +201,14 @@ class PhysicalMemory : public Serializable
      */
     PhysicalMemory(const std::string& _name,
                    const std::vector<AbstractMemory*>& _memories,
-                   bool mmap_using_noreserve);
+                   bool mmap_using_noreserve,
+                   bool mmap_using_hugetlb = false,
+                   bool mmap_using_thp = false,
+                   bool raw_checkpoint_stores = false,
+                   unsigned checkpoint_threads = 0,
+                   bool delta_checkpoints = false,
+                   bool lazy_restore = false,
+                   const std::string &image_dir = "");
 
     /**
      * Unmap all the backing store we have used.
@@ -182,6 +230,15 @@ class PhysicalMemory : public Serializable
      */
     bool isMemAddr(Addr addr) const;
 
+    /**
+     * Get the host memory backing a physical address.
+     *
+     * @param addr A physical address
+     * @param size Set to the number of bytes backed contiguously from addr
+     * @return Pointer to the host memory, nullptr if there is none
+     */
+    uint8_t *hostAddr(Addr addr, Addr &size) const;
+
     /**
      * Get the memory ranges for all memories that are to be reported
      * to the configuration table. The ranges are merged before they
@@ -265,6 +322,83 @@ class PhysicalMemory : public Serializable
      */
     void unserializeStore(CheckpointIn &cp);
 
+  private:
+
+    /**
+     * Write a backing store to an uncompressed file that can be
+     * mapped directly on restore. Pages that are all zero are left
+     * as holes in the file.
+     *
+     * @param filepath Path of the file to write
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeRawStore(const std::string &filepath, AddrRange range,
+                           uint8_t* pmem) const;
+
+    /**
+     * Map an uncompressed store file copy-on-write in place of a
+     * backing store.
+     *
+     * @param filepath Path of the file to map
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void mapRawStore(const std::string &filepath, AddrRange range,
+                     uint8_t* pmem);
+
+    /**
+     * Write a backing store to a file of independently compressed
+     * chunks, which are compressed in parallel. Pages that are all
+     * zero are only recorded in a bitmap of the pages. With delta
+     * checkpoints, only the pages that changed since the parent store
+     * are written once there is one.
+     *
+     * @param filepath Path of the file to write
+     * @param store_id Unique identifier of this backing store
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void serializeChunkedStore(const std::string &filepath,
+                               unsigned int store_id, AddrRange range,
+                               uint8_t* pmem) const;
+
+    /**
+     * Read a file of compressed chunks into a backing store,
+     * decompressing the chunks in parallel. The parent stores of a
+     * delta store are read first. With lazy restores, the chunks are
+     * only decompressed when one of their pages is first touched.
+     *
+     * @param filepath Path of the file to read
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void unserializeChunkedStore(const std::string &filepath,
+                                 AddrRange range, uint8_t* pmem);
+
+    /**
+     * Map the decompressed image of a chunked store in place of a
+     * backing store. The image lives in the image directory and is
+     * shared by all the processes restoring the same checkpoint, which
+     * share its pages until they write them. The first process to get
+     * to it decompresses it.
+     *
+     * @param filepath Path of the chunked store
+     * @param range The address range of this backing store
+     * @param pmem The host pointer to this backing store
+     */
+    void mapSharedImage(const std::string &filepath, AddrRange range,
+                        uint8_t* pmem);
+
+    /**
+     * Compute the page digests of a restored backing store, which
+     * makes its checkpoint file the parent of the next delta store.
+     *
+     * @param store_id Unique identifier of this backing store
+     * @param filepath Path of the file the store was restored from
+     */
+    void trackStore(unsigned int store_id, const std::string &filepath);
+
 };
 
 #endif //__MEM_PHYSICAL_HH__
@@ -95,6 +95,12 @@ MasterPort::getAddrRanges() const
     return _slavePort->getAddrRanges();
 }
 
+EventQueue *
+MasterPort::getPeerEventQueue() const
+{
+    return _slavePort->owner.eventQueue();
+}
+
 void
 MasterPort::printAddr(Addr a)
 {
@@ -121,6 +127,12 @@ SlavePort::~SlavePort()
 {
 }
 
+EventQueue *
+SlavePort::getPeerEventQueue() const
+{
+    return _masterPort->owner.eventQueue();
+}
+
 void
 SlavePort::slaveUnbind()
 {
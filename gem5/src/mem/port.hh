@@ -115,6 +115,12 @@ class MasterPort : public Port, public AtomicRequestProtocol,
      */
     AddrRangeList getAddrRanges() const;
 
+    /**
+     * Get the event queue of the object owning the connected slave
+     * port.
+     */
+    EventQueue *getPeerEventQueue() const;
+
     /**
      * Inject a PrintReq for the given address to print the state of
      * that address throughout the memory system.  For debugging.
@@ -279,6 +285,12 @@ class SlavePort : public Port, public AtomicResponseProtocol,
      */
     bool isSnooping() const { return _masterPort->isSnooping(); }
 
+    /**
+     * Get the event queue of the object owning the connected master
+     * port.
+     */
+    EventQueue *getPeerEventQueue() const;
+
     /**
      * Called by the owner to send a range change
      */
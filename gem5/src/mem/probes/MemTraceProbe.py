@@ -54,3 +54,14 @@ class MemTraceProbe(BaseMemProbe):
 
     # System object to look up the name associated with a master ID
     system = Param.System(Parent.any, "System the probe belongs to")
+
+    # Only trace a sample of the packets in a window of time
+    sample_interval = Param.Unsigned(1, "Trace every Nth packet")
+    trace_start = Param.Tick(0, "Tick to start tracing at")
+    trace_stop = Param.Tick(MaxTick, "Tick to stop tracing at")
+
+    # Keep the most recent packets in memory and only write them out
+    # when the statistics are dumped (e.g., by the m5 dumpstats
+    # pseudo-op) or at exit, rather than writing every packet
+    buffer_size = Param.Unsigned(0, "Number of packets to keep in a ring " \
+                                 "buffer, 0 to write packets immediately")
@@ -55,6 +55,11 @@ class StackDistProbe(BaseMemProbe):
     # enable verification stack
     verify = Param.Bool(False, "Verify behaviuor with reference implementation")
 
+    # spatially hashed sampling (SHARDS), only a fraction of the cache
+    # lines are tracked and their stack distances are scaled by the
+    # inverse of that fraction
+    sample_rate = Param.Float(1.0, "Fraction of the cache lines sampled")
+
     # linear histogram bins and enable/disable
     linear_hist_bins = Param.Unsigned('16', "Bins in linear histograms")
     disable_linear_hists = Param.Bool(False, "Disable linear histograms")
@@ -40,6 +40,9 @@
 
 #include "mem/probes/mem_footprint.hh"
 
+#include <algorithm>
+
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "params/MemFootprintProbe.hh"
 
@@ -49,16 +52,29 @@ MemFootprintProbe::MemFootprintProbe(MemFootprintProbeParams *p)
       pageSizeLg2(floorLog2(p->page_size)),
       totalCacheLinesInMem(p->system->memSize() / p->system->cacheLineSize()),
       totalPagesInMem(p->system->memSize() / p->page_size),
-      cacheLines(),
-      cacheLinesAll(),
-      pages(),
-      pagesAll(),
+      wordsPerPage(divCeil(p->page_size / p->system->cacheLineSize(), 64)),
+      lastChunkNum(0),
+      lastChunk(nullptr),
+      curInterval(1),
+      cacheLines(0),
+      cacheLinesAll(0),
+      pages(0),
+      pagesAll(0),
       system(p->system)
 {
     fatal_if(!isPowerOf2(system->cacheLineSize()),
              "MemFootprintProbe expects cache line size is power of 2.");
     fatal_if(!isPowerOf2(p->page_size),
              "MemFootprintProbe expects page size parameter is power of 2");
+    fatal_if(p->page_size < system->cacheLineSize(),
+             "MemFootprintProbe expects page size is at least a cache line");
+}
+
+MemFootprintProbe::Chunk::Chunk(unsigned words_per_page)
+    : linesAll(words_per_page << pagesPerChunkLg2, 0),
+      lines(words_per_page << pagesPerChunkLg2, 0),
+      interval(1 << pagesPerChunkLg2, 0)
+{
 }
 
 void
@@ -89,11 +105,18 @@ MemFootprintProbe::regStats()
             this));
 }
 
-void
-MemFootprintProbe::insertAddr(Addr addr, AddrSet *set, uint64_t limit)
+MemFootprintProbe::Chunk &
+MemFootprintProbe::getChunk(Addr page)
 {
-    set->insert(addr);
-    assert(set->size() <= limit);
+    const Addr chunk_num = page >> pagesPerChunkLg2;
+    if (!lastChunk || chunk_num != lastChunkNum) {
+        auto &chunk = chunks[chunk_num];
+        if (!chunk)
+            chunk.reset(new Chunk(wordsPerPage));
+        lastChunkNum = chunk_num;
+        lastChunk = chunk.get();
+    }
+    return *lastChunk;
 }
 
 void
@@ -102,27 +125,60 @@ MemFootprintProbe::handleRequest(const ProbePoints::PacketInfo &pi)
     if (!pi.cmd.isRequest() || !system->isMemAddr(pi.addr))
         return;
 
-    const Addr cl_addr = (pi.addr >> cacheLineSizeLg2) << cacheLineSizeLg2;
-    const Addr page_addr = (pi.addr >> pageSizeLg2) << pageSizeLg2;
-    insertAddr(cl_addr, &cacheLines, totalCacheLinesInMem);
-    insertAddr(cl_addr, &cacheLinesAll, totalCacheLinesInMem);
-    insertAddr(page_addr, &pages, totalPagesInMem);
-    insertAddr(page_addr, &pagesAll, totalPagesInMem);
+    const Addr page = pi.addr >> pageSizeLg2;
+    const unsigned page_idx = page & mask(pagesPerChunkLg2);
+    const Addr line = (pi.addr >> cacheLineSizeLg2) &
+        mask(pageSizeLg2 - cacheLineSizeLg2);
+    const unsigned word = page_idx * wordsPerPage + line / 64;
+    const uint64_t bit = ULL(1) << (line % 64);
+
+    Chunk &chunk = getChunk(page);
+
+    // First access to the page in this interval, clear the lines
+    // left over from an earlier interval
+    if (chunk.interval[page_idx] != curInterval) {
+        auto first = chunk.lines.begin() + page_idx * wordsPerPage;
+        std::fill(first, first + wordsPerPage, 0);
+        chunk.interval[page_idx] = curInterval;
+        ++pages;
+    }
+
+    if (!(chunk.linesAll[word] & bit)) {
+        // A page is new if none of its lines has been touched before
+        unsigned touched = 0;
+        for (unsigned i = 0; i < wordsPerPage; ++i)
+            touched += popCount(chunk.linesAll[page_idx * wordsPerPage + i]);
+        if (!touched)
+            ++pagesAll;
+
+        chunk.linesAll[word] |= bit;
+        ++cacheLinesAll;
+    }
+
+    if (!(chunk.lines[word] & bit)) {
+        chunk.lines[word] |= bit;
+        ++cacheLines;
+    }
 
-    assert(cacheLines.size() <= cacheLinesAll.size());
-    assert(pages.size() <= pagesAll.size());
+    assert(cacheLinesAll <= totalCacheLinesInMem);
+    assert(pagesAll <= totalPagesInMem);
+    assert(cacheLines <= cacheLinesAll);
+    assert(pages <= pagesAll);
 
-    fpCacheLine = cacheLines.size() << cacheLineSizeLg2;
-    fpCacheLineTotal = cacheLinesAll.size() << cacheLineSizeLg2;
-    fpPage = pages.size() << pageSizeLg2;
-    fpPageTotal = pagesAll.size() << pageSizeLg2;
+    fpCacheLine = cacheLines << cacheLineSizeLg2;
+    fpCacheLineTotal = cacheLinesAll << cacheLineSizeLg2;
+    fpPage = pages << pageSizeLg2;
+    fpPageTotal = pagesAll << pageSizeLg2;
 }
 
 void
 MemFootprintProbe::statReset()
 {
-    cacheLines.clear();
-    pages.clear();
+    // Start a new interval, the line bitmaps of the previous one are
+    // cleared lazily when their page is next touched
+    ++curInterval;
+    cacheLines = 0;
+    pages = 0;
 }
 
 MemFootprintProbe *
@@ -41,7 +41,9 @@
 #ifndef __MEM_PROBES_MEM_FOOTPRINT_HH__
 #define __MEM_PROBES_MEM_FOOTPRINT_HH__
 
-#include <unordered_set>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "base/callback.hh"
 #include "mem/packet.hh"
@@ -53,11 +55,15 @@ struct MemFootprintProbeParams;
 
 /// Probe to track footprint of accessed memory
 /// Two granularity of footprint measurement i.e. cache line and page
+///
+/// The touched cache lines are kept in a two level radix structure: a
+/// hash map of chunks of pages, each holding a bitmap of the lines of
+/// its pages. The bitmaps of the current interval are tagged with the
+/// interval they belong to, so a stat reset only starts a new interval
+/// and the stale bitmaps are cleared when their page is next touched.
 class MemFootprintProbe : public BaseMemProbe
 {
   public:
-    typedef std::unordered_set<Addr> AddrSet;
-
     MemFootprintProbe(MemFootprintProbeParams *p);
     void regStats() override;
     // Fix footprint tracking state on stat reset
@@ -70,8 +76,27 @@ class MemFootprintProbe : public BaseMemProbe
     const uint8_t pageSizeLg2;
     const uint64_t totalCacheLinesInMem;
     const uint64_t totalPagesInMem;
+    /// Number of 64-bit words in the line bitmap of a page
+    const unsigned wordsPerPage;
+
+    /// Number of pages in a chunk (log2)
+    static const unsigned pagesPerChunkLg2 = 9;
+
+    /// Line bitmaps of a naturally aligned group of pages
+    struct Chunk
+    {
+        Chunk(unsigned words_per_page);
 
-    void insertAddr(Addr addr, AddrSet *set, uint64_t limit);
+        /// Lines touched since simulation begin
+        std::vector<uint64_t> linesAll;
+        /// Lines touched in the interval of their page
+        std::vector<uint64_t> lines;
+        /// Interval in which each page was last touched
+        std::vector<uint64_t> interval;
+    };
+
+    /// Get the chunk holding a page, allocating it on first use
+    Chunk &getChunk(Addr page);
     void handleRequest(const ProbePoints::PacketInfo &pkt_info) override;
 
     /// Footprint at cache line size granularity
@@ -83,14 +108,23 @@ class MemFootprintProbe : public BaseMemProbe
     /// Footprint at page granularity, since simulation begin
     Stats::Scalar fpPageTotal;
 
-    // Addr set to track unique cache lines accessed
-    AddrSet cacheLines;
-    // Addr set to track unique cache lines accessed since simulation begin
-    AddrSet cacheLinesAll;
-    // Addr set to track unique pages accessed
-    AddrSet pages;
-    // Addr set to track unique pages accessed since simulation begin
-    AddrSet pagesAll;
+    // Chunks of pages touched since simulation begin, by chunk number
+    std::unordered_map<Addr, std::unique_ptr<Chunk>> chunks;
+    // Last chunk looked up, accesses are usually to the same region
+    Addr lastChunkNum;
+    Chunk *lastChunk;
+
+    // Current interval, starting at 1 so untouched pages are in none
+    uint64_t curInterval;
+
+    // Number of unique cache lines accessed
+    uint64_t cacheLines;
+    // Number of unique cache lines accessed since simulation begin
+    uint64_t cacheLinesAll;
+    // Number of unique pages accessed
+    uint64_t pages;
+    // Number of unique pages accessed since simulation begin
+    uint64_t pagesAll;
     System *system;
 };
 
@@ -43,6 +43,7 @@
 #include "base/callback.hh"
 #include "base/output.hh"
 #include "params/MemTraceProbe.hh"
+#include "base/statistics.hh"
 #include "proto/packet.pb.h"
 #include "sim/system.hh"
 
@@ -50,8 +51,18 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
     : BaseMemProbe(p),
       traceStream(nullptr),
       system(p->system),
-      withPC(p->with_pc)
+      withPC(p->with_pc),
+      sampleInterval(p->sample_interval),
+      sampleCount(0),
+      traceStart(p->trace_start),
+      traceStop(p->trace_stop),
+      buffer(p->buffer_size),
+      bufferHead(0),
+      bufferCount(0)
 {
+    fatal_if(sampleInterval == 0, "%s: sample_interval must be non-zero.",
+             name());
+
     std::string filename;
     if (p->trace_file != "") {
         // If the trace file is not specified as an absolute path,
@@ -72,13 +83,22 @@ MemTraceProbe::MemTraceProbe(MemTraceProbeParams *p)
                                   (p->trace_compress ? ".gz" : ""));
     }
 
-    traceStream = new ProtoOutputStream(filename);
+    // Compress in a separate thread, so that tracing doesn't slow the
+    // simulation down more than it has to
+    traceStream = new ProtoOutputStream(filename, true);
 
     // Register a callback to compensate for the destructor not
     // being called. The callback forces the stream to flush and
     // closes the output file.
     registerExitCallback(
         new MakeCallback<MemTraceProbe, &MemTraceProbe::closeStreams>(this));
+
+    // Write out the buffered packets whenever the stats are dumped
+    if (!buffer.empty()) {
+        Stats::registerDumpCallback(
+            new MakeCallback<MemTraceProbe, &MemTraceProbe::flushBuffer>(
+                this));
+    }
 }
 
 void
@@ -102,16 +122,44 @@ MemTraceProbe::startup()
 void
 MemTraceProbe::closeStreams()
 {
-    if (traceStream != NULL)
+    if (traceStream != NULL) {
+        flushBuffer();
         delete traceStream;
+        traceStream = NULL;
+    }
 }
 
 void
-MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+MemTraceProbe::flushBuffer()
+{
+    if (traceStream == NULL)
+        return;
+
+    ProtoMessage::Packet pkt_msg;
+    for (; bufferCount != 0; --bufferCount) {
+        const BufferedPacket &bp = buffer[bufferHead];
+        bufferHead = (bufferHead + 1) % buffer.size();
+
+        pkt_msg.Clear();
+        pkt_msg.set_tick(bp.tick);
+        pkt_msg.set_cmd(bp.cmd);
+        pkt_msg.set_flags(bp.flags);
+        pkt_msg.set_addr(bp.addr);
+        pkt_msg.set_size(bp.size);
+        if (withPC && bp.pc != 0)
+            pkt_msg.set_pc(bp.pc);
+        pkt_msg.set_pkt_id(bp.master);
+
+        traceStream->write(pkt_msg);
+    }
+}
+
+void
+MemTraceProbe::writePacket(Tick tick, const ProbePoints::PacketInfo &pkt_info)
 {
     ProtoMessage::Packet pkt_msg;
 
-    pkt_msg.set_tick(curTick());
+    pkt_msg.set_tick(tick);
     pkt_msg.set_cmd(pkt_info.cmd.toInt());
     pkt_msg.set_flags(pkt_info.flags);
     pkt_msg.set_addr(pkt_info.addr);
@@ -123,6 +171,39 @@ MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
     traceStream->write(pkt_msg);
 }
 
+void
+MemTraceProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
+{
+    const Tick now = curTick();
+    if (now < traceStart || now >= traceStop)
+        return;
+
+    if (++sampleCount < sampleInterval)
+        return;
+    sampleCount = 0;
+
+    if (buffer.empty()) {
+        writePacket(now, pkt_info);
+        return;
+    }
+
+    // Overwrite the oldest packet once the buffer is full
+    size_t idx = (bufferHead + bufferCount) % buffer.size();
+    if (bufferCount == buffer.size())
+        bufferHead = (bufferHead + 1) % buffer.size();
+    else
+        ++bufferCount;
+
+    BufferedPacket &bp = buffer[idx];
+    bp.tick = now;
+    bp.addr = pkt_info.addr;
+    bp.pc = pkt_info.pc;
+    bp.flags = pkt_info.flags;
+    bp.size = pkt_info.size;
+    bp.cmd = pkt_info.cmd.toInt();
+    bp.master = pkt_info.master;
+}
+
 
 MemTraceProbe *
 MemTraceProbeParams::create()
@@ -40,6 +40,8 @@
 #ifndef __MEM_PROBES_MEM_TRACE_HH__
 #define __MEM_PROBES_MEM_TRACE_HH__
 
+#include <vector>
+
 #include "mem/packet.hh"
 #include "mem/probes/base.hh"
 #include "proto/protoio.hh"
@@ -61,6 +63,15 @@ class MemTraceProbe : public BaseMemProbe
      */
     void closeStreams();
 
+    /**
+     * Write the packets held in the ring buffer to the trace, oldest
+     * first, and empty the buffer.
+     */
+    void flushBuffer();
+
+    /** Write a packet to the trace stream */
+    void writePacket(Tick tick, const ProbePoints::PacketInfo &pkt_info);
+
     void startup() override;
 
   protected:
@@ -72,8 +83,39 @@ class MemTraceProbe : public BaseMemProbe
 
   private:
 
+    /** A packet waiting in the ring buffer */
+    struct BufferedPacket
+    {
+        Tick tick;
+        Addr addr;
+        Addr pc;
+        Request::FlagsType flags;
+        uint32_t size;
+        int cmd;
+        MasterID master;
+    };
+
     /** Include the Program Counter in the memory trace */
     const bool withPC;
+
+    /** Trace every sampleInterval'th packet */
+    const unsigned sampleInterval;
+
+    /** Number of packets seen since the last one traced */
+    unsigned sampleCount;
+
+    /** Window of time in which packets are traced */
+    const Tick traceStart;
+    const Tick traceStop;
+
+    /** Ring buffer of the most recent packets, empty if not buffering */
+    std::vector<BufferedPacket> buffer;
+
+    /** Index of the oldest packet in the ring buffer */
+    size_t bufferHead;
+
+    /** Number of packets in the ring buffer */
+    size_t bufferCount;
 };
 
 #endif //__MEM_PROBES_MEM_TRACE_HH__
@@ -39,12 +39,19 @@
 
 #include "mem/probes/stack_dist.hh"
 
+#include <cmath>
+#include <limits>
+
 #include "params/StackDistProbe.hh"
 #include "sim/system.hh"
 
 StackDistProbe::StackDistProbe(StackDistProbeParams *p)
     : BaseMemProbe(p),
       lineSize(p->line_size),
+      sampleRate(p->sample_rate),
+      sampleThreshold(p->sample_rate < 1.0 ?
+                      p->sample_rate * std::pow(2.0, 64) :
+                      std::numeric_limits<uint64_t>::max()),
       disableLinearHists(p->disable_linear_hists),
       disableLogHists(p->disable_log_hists),
       calc(p->verify)
@@ -52,6 +59,24 @@ StackDistProbe::StackDistProbe(StackDistProbeParams *p)
     fatal_if(p->system->cacheLineSize() > p->line_size,
              "The stack distance probe must use a cache line size that is "
              "larger or equal to the system's cahce line size.");
+    fatal_if(p->sample_rate <= 0.0 || p->sample_rate > 1.0,
+             "The stack distance probe sample rate must be in (0, 1].");
+}
+
+bool
+StackDistProbe::isSampled(Addr aligned_addr) const
+{
+    if (sampleRate >= 1.0)
+        return true;
+
+    // Mix the bits of the line address (splitmix64 finalizer) so that
+    // the hash is uniformly distributed for strided addresses
+    uint64_t hash = aligned_addr / lineSize;
+    hash = (hash ^ (hash >> 30)) * ULL(0xbf58476d1ce4e5b9);
+    hash = (hash ^ (hash >> 27)) * ULL(0x94d049bb133111eb);
+    hash = hash ^ (hash >> 31);
+
+    return hash < sampleThreshold;
 }
 
 void
@@ -106,12 +131,19 @@ StackDistProbe::handleRequest(const ProbePoints::PacketInfo &pkt_info)
     // Align the address to a cache line size
     const Addr aligned_addr(roundDown(pkt_info.addr, lineSize));
 
-    // Calculate the stack distance
-    const uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
+    // Only the sampled cache lines are tracked
+    if (!isSampled(aligned_addr))
+        return;
+
+    // Calculate the stack distance, only the sampled lines are on the
+    // stack so scale it back to all the lines
+    uint64_t sd(calc.calcStackDistAndUpdate(aligned_addr).first);
     if (sd == StackDistCalc::Infinity) {
         infiniteSD++;
         return;
     }
+    if (sampleRate < 1.0)
+        sd = sd / sampleRate;
 
     // Sample the stack distance of the address in linear bins
     if (!disableLinearHists) {
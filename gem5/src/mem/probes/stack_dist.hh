@@ -57,10 +57,27 @@ class StackDistProbe : public BaseMemProbe
   protected:
     void handleRequest(const ProbePoints::PacketInfo &pkt_info) override;
 
+    /**
+     * Check if a cache line is sampled. The line address is hashed so
+     * that a line is either always or never sampled, and a fraction
+     * sampleRate of the lines is sampled, independently of their
+     * access pattern.
+     *
+     * @param aligned_addr Address of the cache line
+     * @return true if the cache line is sampled
+     */
+    bool isSampled(Addr aligned_addr) const;
+
   protected:
     // Cache line size to simulate
     const unsigned lineSize;
 
+    // Fraction of the cache lines whose stack distances are tracked
+    const double sampleRate;
+
+    // Hash threshold below which a cache line is sampled
+    const uint64_t sampleThreshold;
+
     // Disable the linear histograms
     const bool disableLinearHists;
 
@@ -38,6 +38,7 @@
 from m5.params import *
 from m5.objects.AbstractMemory import AbstractMemory
 from m5.objects.QoSTurnaround import *
+from m5.objects.QoSMemPartition import *
 
 # QoS Queue Selection policy used to select packets among same-QoS queues
 class QoSQPolicy(Enum): vals = ["fifo", "lifo", "lrg"]
@@ -76,6 +77,10 @@ class QoSMemCtrl(AbstractMemory):
     qos_priority_escalation = Param.Bool(False,
         "Enables QoS priority escalation")
 
+    # Memory partitions regulated by the controller (timing mode only)
+    qos_partitions = VectorParam.QoSMemPartition([],
+        "Bandwidth regulated memory partitions")
+
     # Master ID to be mapped to service parameters in QoS schedulers
     qos_masters = VectorParam.String(['']* 16,
         "Master Names to be mapped to service parameters in QoS scheduler")
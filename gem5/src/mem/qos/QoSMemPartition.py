@@ -0,0 +1,57 @@
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.params import *
+from m5.SimObject import SimObject
+
+# Bandwidth regulation of a memory partition (MPAM style), the partition
+# of a request is its partition ID or, for requests without one, the
+# partition listing the master issuing it.
+class QoSMemPartition(SimObject):
+    type = 'QoSMemPartition'
+    cxx_header = "mem/qos/partition.hh"
+    cxx_class = 'QoS::MemPartition'
+
+    partition_id = Param.UInt16("Partition ID carried by the requests")
+
+    masters = VectorParam.String([],
+        "Masters whose requests without a partition ID belong to the "
+        "partition")
+
+    min_bandwidth = Param.MemoryBandwidth('0GB/s',
+        "Bandwidth below which the partition's requests get the highest "
+        "QoS priority (0 for no guarantee)")
+    max_bandwidth = Param.MemoryBandwidth('0GB/s',
+        "Bandwidth above which the partition is regulated (0 for no "
+        "limit)")
+    hard_limit = Param.Bool(True,
+        "Refuse requests above the maximum bandwidth, rather than only "
+        "giving them the lowest QoS priority")
+    burst_size = Param.MemorySize('1kB',
+        "Bytes a partition can accumulate while below its bandwidths")
@@ -38,6 +38,9 @@
 from m5.params import *
 from m5.objects.QoSMemCtrl import *
 
+# Distribution of the variable part of the response latency
+class QoSMemSinkLatency(Enum): vals = ['constant', 'uniform', 'exponential']
+
 class QoSMemSinkCtrl(QoSMemCtrl):
     type = 'QoSMemSinkCtrl'
     cxx_header = "mem/qos/mem_sink.hh"
@@ -60,4 +63,25 @@ class QoSMemSinkCtrl(QoSMemCtrl):
     # response latency - time to issue a response once a request is serviced
     response_latency = Param.Latency("20ns", "Memory response latency")
 
+    # analytical memory model, everything is disabled by default so
+    # that the controller is a plain sink
+
+    # variable latency added to the response latency
+    latency_distribution = Param.QoSMemSinkLatency('constant',
+        "Distribution of the variable response latency")
+    latency_var = Param.Latency("0ns",
+        "Variable response latency, the upper bound of a uniform "
+        "distribution or the mean of an exponential one")
+
+    # bandwidth cap, transfers queue behind each other on the data bus
+    bandwidth = Param.MemoryBandwidth("0GB/s",
+        "Peak bandwidth (0 for unlimited)")
+
+    # row buffer approximation: the address bits above the row buffer
+    # select the bank, the ones above the banks the row
+    banks = Param.Unsigned(0, "Number of banks (0 to ignore row hits)")
+    row_buffer_size = Param.MemorySize("1kB", "Row buffer size per bank")
+    row_miss_latency = Param.Latency("15ns",
+        "Response latency added by a row buffer miss")
+
 
@@ -51,10 +51,16 @@ MemCtrl::MemCtrl(const QoSMemCtrlParams * p)
     _numPriorities(p->qos_priorities),
     qosPriorityEscalation(p->qos_priority_escalation),
     qosSyncroScheduler(p->qos_syncro_scheduler),
+    partitions(p->qos_partitions),
+    regulationEvent([this]{ regulationRetry(); }, name()),
+    readPrioMask(0), writePrioMask(0),
     totalReadQueueSize(0), totalWriteQueueSize(0),
     busState(READ), busStateNext(READ),
     stats(*this)
 {
+    fatal_if(p->qos_priorities > 64,
+             "%s: at most 64 QoS priorities are supported\n", name());
+
     // Set the priority policy
     if (policy) {
         policy->setMemCtrl(this);
@@ -82,6 +88,22 @@ void
 MemCtrl::init()
 {
     AbstractMemory::init();
+
+    for (auto part : partitions) {
+        part->setMemCtrl(this);
+
+        fatal_if(!partitionIds.emplace(part->partitionId, part).second,
+                 "%s: duplicate memory partition ID %d\n", name(),
+                 part->partitionId);
+
+        for (const auto &master : part->masters) {
+            MasterID m_id = _system->lookupMasterId(master);
+            fatal_if(m_id == Request::invldMasterId,
+                     "%s: unknown master %s in partition %s\n", name(),
+                     master, part->name());
+            partitionMasters[m_id] = part;
+        }
+    }
 }
 
 void
@@ -103,12 +125,15 @@ MemCtrl::logRequest(BusState dir, MasterID m_id, uint8_t qos,
     if (dir == READ) {
         readQueueSizes[qos] += entries;
         totalReadQueueSize += entries;
+        updatePrioMask(readPrioMask, qos, readQueueSizes[qos]);
     } else if (dir == WRITE) {
         writeQueueSizes[qos] += entries;
         totalWriteQueueSize += entries;
+        updatePrioMask(writePrioMask, qos, writeQueueSizes[qos]);
     }
 
     packetPriorities[m_id][qos] += entries;
+    updatePrioMask(masterPrioMask[m_id], qos, packetPriorities[m_id][qos]);
     for (auto j = 0; j < entries; ++j) {
         requestTimes[m_id][addr].push_back(curTick());
     }
@@ -159,9 +184,11 @@ MemCtrl::logResponse(BusState dir, MasterID m_id, uint8_t qos,
     if (dir == READ) {
         readQueueSizes[qos] -= entries;
         totalReadQueueSize -= entries;
+        updatePrioMask(readPrioMask, qos, readQueueSizes[qos]);
     } else if (dir == WRITE) {
         writeQueueSizes[qos] -= entries;
         totalWriteQueueSize -= entries;
+        updatePrioMask(writePrioMask, qos, writeQueueSizes[qos]);
     }
 
     panic_if(packetPriorities[m_id][qos] == 0,
@@ -169,6 +196,7 @@ MemCtrl::logResponse(BusState dir, MasterID m_id, uint8_t qos,
              " %d", masters[m_id], qos);
 
     packetPriorities[m_id][qos] -= entries;
+    updatePrioMask(masterPrioMask[m_id], qos, packetPriorities[m_id][qos]);
 
     for (auto j = 0; j < entries; ++j) {
         auto it = requestTimes[m_id].find(addr);
@@ -239,6 +267,70 @@ MemCtrl::schedule(const PacketPtr pkt)
     }
 }
 
+MemPartition*
+MemCtrl::getPartition(const PacketPtr pkt) const
+{
+    if (partitions.empty())
+        return nullptr;
+
+    assert(pkt->req);
+
+    if (pkt->req->partitionId()) {
+        auto it = partitionIds.find(pkt->req->partitionId());
+        return it != partitionIds.end() ? it->second : nullptr;
+    }
+
+    auto it = partitionMasters.find(pkt->req->masterId());
+    return it != partitionMasters.end() ? it->second : nullptr;
+}
+
+uint8_t
+MemCtrl::regulatePriority(const PacketPtr pkt, uint8_t prio)
+{
+    MemPartition* part = getPartition(pkt);
+    if (!part)
+        return prio;
+
+    switch (part->regulation()) {
+      case MemPartition::BelowMin:
+        prio = numPriorities() - 1;
+        break;
+      case MemPartition::AboveMax:
+        prio = 0;
+        break;
+      default:
+        break;
+    }
+
+    DPRINTF(QOS,
+            "QoSMemCtrl::regulatePriority partition %s priority %d\n",
+            part->name(), prio);
+
+    return prio;
+}
+
+bool
+MemCtrl::admitRequest(const PacketPtr pkt)
+{
+    MemPartition* part = getPartition(pkt);
+    if (!part || part->admit(pkt->getSize()))
+        return true;
+
+    const Tick when = part->nextAdmission();
+
+    DPRINTF(QOS,
+            "QoSMemCtrl::admitRequest partition %s over its maximum "
+            "bandwidth, refusing until %d\n", part->name(), when);
+
+    if (!regulationEvent.scheduled()) {
+        schedule(regulationEvent, when);
+    } else if (regulationEvent.when() > when) {
+        reschedule(regulationEvent, when);
+    }
+
+    return false;
+}
+
 MemCtrl::BusState
 MemCtrl::selectNextBusState()
 {
@@ -273,6 +365,7 @@ MemCtrl::addMaster(MasterID m_id)
     if (!hasMaster(m_id)) {
         masters.emplace(m_id, _system->getMasterName(m_id));
         packetPriorities[m_id].resize(numPriorities(), 0);
+        masterPrioMask[m_id] = 0;
 
         DPRINTF(QOS,
                 "QoSMemCtrl::addMaster registering"
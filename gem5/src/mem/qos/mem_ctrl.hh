@@ -37,8 +37,10 @@
  * Authors: Matteo Andreozzi
  */
 
+#include "base/bitfield.hh"
 #include "debug/QOS.hh"
 #include "mem/abstract_mem.hh"
+#include "mem/qos/partition.hh"
 #include "mem/qos/q_policy.hh"
 #include "mem/qos/policy.hh"
 #include "params/QoSMemCtrl.hh"
@@ -86,12 +88,33 @@ class MemCtrl: public AbstractMemory
      */
     const bool qosSyncroScheduler;
 
+    /** Bandwidth regulated memory partitions */
+    const std::vector<MemPartition*> partitions;
+
+    /** Hash of partition ID - memory partition */
+    std::unordered_map<uint16_t, MemPartition*> partitionIds;
+
+    /** Hash of master ID - memory partition of untagged requests */
+    std::unordered_map<MasterID, MemPartition*> partitionMasters;
+
+    /**
+     * Retries a request refused by the bandwidth regulation once its
+     * partition can be admitted again
+     */
+    EventFunctionWrapper regulationEvent;
+
     /** Hash of master ID - master name */
     std::unordered_map<MasterID, const std::string> masters;
 
     /** Hash of masters - number of packets queued per priority */
     std::unordered_map<MasterID, std::vector<uint64_t> > packetPriorities;
 
+    /**
+     * Hash of masters - bitmask of the priorities holding packets of
+     * the master, so that escalation only visits those priorities
+     */
+    std::unordered_map<MasterID, uint64_t> masterPrioMask;
+
     /** Hash of masters - address of request - queue of times of request */
     std::unordered_map<MasterID,
             std::unordered_map<uint64_t, std::deque<uint64_t>> > requestTimes;
@@ -108,6 +131,12 @@ class MemCtrl: public AbstractMemory
     /** Write request packets queue length in #packets, per QoS priority */
     std::vector<uint64_t> writeQueueSizes;
 
+    /** Bitmask of the priorities with a non-empty read queue */
+    uint64_t readPrioMask;
+
+    /** Bitmask of the priorities with a non-empty write queue */
+    uint64_t writePrioMask;
+
     /** Total read request packets queue length in #packets */
     uint64_t totalReadQueueSize;
 
@@ -161,6 +190,23 @@ class MemCtrl: public AbstractMemory
      */
     void addMaster(const MasterID m_id);
 
+    /**
+     * Sets or clears the bit of a priority in a bitmask depending on
+     * whether the related counter is non-zero
+     *
+     * @param mask bitmask to update
+     * @param prio QoS priority
+     * @param count current counter value for the priority
+     */
+    static void
+    updatePrioMask(uint64_t &mask, uint8_t prio, uint64_t count)
+    {
+        if (count)
+            mask |= ULL(1) << prio;
+        else
+            mask &= ~(ULL(1) << prio);
+    }
+
     /**
      * Called upon receiving a request or
      * updates statistics and updates queues status
@@ -205,6 +251,46 @@ class MemCtrl: public AbstractMemory
     uint8_t schedule(MasterID m_id, uint64_t data);
     uint8_t schedule(const PacketPtr pkt);
 
+    /**
+     * Gets the memory partition of a packet: the one with the
+     * partition ID of the request or, without partition ID, the one
+     * listing the master of the request.
+     *
+     * @param pkt pointer to the Packet
+     * @return the partition, nullptr if the packet belongs to none
+     */
+    MemPartition* getPartition(const PacketPtr pkt) const;
+
+    /**
+     * Adjusts the QoS priority of a packet to the bandwidth regulation
+     * of its memory partition: the highest priority under the minimum
+     * bandwidth, the lowest over the maximum bandwidth.
+     *
+     * @param pkt pointer to the Packet
+     * @param prio priority assigned by the QoS policy
+     * @return regulated QoS priority value
+     */
+    uint8_t regulatePriority(const PacketPtr pkt, uint8_t prio);
+
+    /**
+     * Admits a timing request according to the bandwidth regulation of
+     * its memory partition. It must be called once the controller is
+     * otherwise ready to accept the request. A refused request must be
+     * retried as for a full queue: the controller's regulationRetry()
+     * is called once the partition can be admitted again.
+     *
+     * @param pkt pointer to the Packet
+     * @return true if the request is admitted
+     */
+    bool admitRequest(const PacketPtr pkt);
+
+    /**
+     * Called when a partition refused by the bandwidth regulation can
+     * be admitted again, the controller should retry any refused
+     * request.
+     */
+    virtual void regulationRetry() {}
+
     /**
      * Returns next bus direction (READ or WRITE)
      * based on configured policy.
@@ -319,6 +405,26 @@ class MemCtrl: public AbstractMemory
     uint64_t getWriteQueueSize(const uint8_t prio) const
     { return writeQueueSizes[prio]; }
 
+    /**
+     * Gets the highest priority with a non-empty queue in the given
+     * direction, optionally restricted to the priorities below a given
+     * one. Walking all the non-empty queues from the highest priority
+     * down is done as:
+     * for (int p = topPriority(dir); p >= 0; p = topPriority(dir, p))
+     *
+     * @param dir bus direction of the queues
+     * @param below only consider the priorities lower than this one
+     * @return the priority, or -1 if there is none
+     */
+    int
+    topPriority(BusState dir, unsigned below = 64) const
+    {
+        uint64_t prios = dir == READ ? readPrioMask : writePrioMask;
+        if (below < 64)
+            prios &= mask(below);
+        return prios ? findMsbSet(prios) : -1;
+    }
+
     /**
      * Gets the total combined READ queues size
      *
@@ -392,6 +498,10 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
                         masters[m_id], tgt_prio);
                 readQueueSizes[curr_prio] -= moved_entries;
                 readQueueSizes[tgt_prio] += moved_entries;
+                updatePrioMask(readPrioMask, curr_prio,
+                               readQueueSizes[curr_prio]);
+                updatePrioMask(readPrioMask, tgt_prio,
+                               readQueueSizes[tgt_prio]);
             } else if (pkt->isWrite()) {
                 panic_if(writeQueueSizes[curr_prio] < moved_entries,
                          "QoSMemCtrl::escalate master %s negative WRITE "
@@ -399,6 +509,10 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
                         masters[m_id], tgt_prio);
                 writeQueueSizes[curr_prio] -= moved_entries;
                 writeQueueSizes[tgt_prio] += moved_entries;
+                updatePrioMask(writePrioMask, curr_prio,
+                               writeQueueSizes[curr_prio]);
+                updatePrioMask(writePrioMask, tgt_prio,
+                               writeQueueSizes[tgt_prio]);
             }
 
             // Change QoS priority and move packet
@@ -415,6 +529,10 @@ MemCtrl::escalateQueues(Queues& queues, uint64_t queue_entry_size,
 
             packetPriorities[m_id][curr_prio] -= moved_entries;
             packetPriorities[m_id][tgt_prio] += moved_entries;
+            updatePrioMask(masterPrioMask[m_id], curr_prio,
+                           packetPriorities[m_id][curr_prio]);
+            updatePrioMask(masterPrioMask[m_id], tgt_prio,
+                           packetPriorities[m_id][tgt_prio]);
         } else {
             // Increment iterator to next location in the queue
             it++;
@@ -437,10 +555,14 @@ MemCtrl::escalate(std::initializer_list<Queues*> queues,
             "%d (currently %d packets)\n",masters[m_id], m_id, tgt_prio,
             packetPriorities[m_id][tgt_prio]);
 
-    for (uint8_t curr_prio = 0; curr_prio < numPriorities(); ++curr_prio) {
-        // Skip target priority
-        if (curr_prio == tgt_prio)
-            continue;
+    // Only visit the priorities holding packets of this master, skipping
+    // the target priority. The mask is a copy as escalateQueues updates
+    // the master's one while moving packets.
+    uint64_t src_prios = masterPrioMask[m_id] & ~(ULL(1) << tgt_prio);
+
+    while (src_prios) {
+        const uint8_t curr_prio = findLsbSet(src_prios);
+        src_prios &= ~(ULL(1) << curr_prio);
 
         // Process other priority packet
         while (packetPriorities[m_id][curr_prio] > 0) {
@@ -477,7 +599,7 @@ MemCtrl::qosSchedule(std::initializer_list<Queues*> queues,
                      const PacketPtr pkt)
 {
     // Schedule packet.
-    uint8_t pkt_priority = schedule(pkt);
+    uint8_t pkt_priority = regulatePriority(pkt, schedule(pkt));
 
     assert(pkt_priority < numPriorities());
 
@@ -37,6 +37,10 @@
  * Author: Matteo Andreozzi
  */
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/random.hh"
 #include "debug/Drain.hh"
 #include "debug/QOS.hh"
 #include "mem_sink.hh"
@@ -47,6 +51,10 @@ namespace QoS {
 MemSinkCtrl::MemSinkCtrl(const QoSMemSinkCtrlParams* p)
   : MemCtrl(p), requestLatency(p->request_latency),
     responseLatency(p->response_latency),
+    latencyDistribution(p->latency_distribution),
+    latencyVar(p->latency_var), bandwidth(p->bandwidth), busBusyUntil(0),
+    banks(p->banks), rowBufferSize(p->row_buffer_size),
+    rowMissLatency(p->row_miss_latency), openRows(banks, MaxAddr),
     memoryPacketSize(p->memory_packet_size),
     readBufferSize(p->read_buffer_size),
     writeBufferSize(p->write_buffer_size), port(name() + ".port", *this),
@@ -93,7 +101,51 @@ MemSinkCtrl::recvAtomic(PacketPtr pkt)
              __func__);
 
     access(pkt);
-    return responseLatency;
+    return accessLatency(pkt);
+}
+
+Tick
+MemSinkCtrl::accessLatency(const PacketPtr pkt)
+{
+    Tick latency = responseLatency;
+
+    if (banks) {
+        const Addr row = pkt->getAddr() / rowBufferSize;
+        Addr& open_row = openRows[row % banks];
+
+        if (open_row == row / banks) {
+            rowHits++;
+        } else {
+            rowMisses++;
+            latency += rowMissLatency;
+            open_row = row / banks;
+        }
+    }
+
+    switch (latencyDistribution) {
+      case Enums::QoSMemSinkLatency::uniform:
+        latency += random_mt.random<Tick>(0, latencyVar);
+        break;
+      case Enums::QoSMemSinkLatency::exponential:
+        latency += static_cast<Tick>(
+            -std::log(1.0 - random_mt.random<double>()) * latencyVar);
+        break;
+      default:
+        break;
+    }
+
+    // With a bandwidth cap the data bus is a single server queue: the
+    // transfer starts once the earlier ones are done
+    if (bandwidth) {
+        const Tick start = std::max(curTick(), busBusyUntil);
+        busBusyUntil = start + static_cast<Tick>(pkt->getSize() * bandwidth);
+
+        totBusQueueLat += start - curTick();
+        numBusAccesses++;
+        latency += busBusyUntil - curTick();
+    }
+
+    return latency;
 }
 
 void
@@ -153,6 +205,11 @@ MemSinkCtrl::recvTimingReq(PacketPtr pkt)
             retryRdReq = true;
             numReadRetries++;
             req_accepted = false;
+        } else if (!admitRequest(pkt)) {
+            DPRINTF(QOS,
+                    "%s Read partition throttled, not accepting\n", __func__);
+            retryRdReq = true;
+            req_accepted = false;
         } else {
             // Enqueue the incoming packet into corresponding
             // QoS priority queue
@@ -167,6 +224,12 @@ MemSinkCtrl::recvTimingReq(PacketPtr pkt)
             retryWrReq = true;
             numWriteRetries++;
             req_accepted = false;
+        } else if (!admitRequest(pkt)) {
+            DPRINTF(QOS,
+                    "%s Write partition throttled, not accepting\n",
+                    __func__);
+            retryWrReq = true;
+            req_accepted = false;
         } else {
             // Enqueue the incoming packet into corresponding QoS
             // priority queue
@@ -184,8 +247,10 @@ MemSinkCtrl::recvTimingReq(PacketPtr pkt)
                    required_entries);
     }
 
-    // Check if we have to process next request event
-    if (!nextReqEvent.scheduled()) {
+    // Check if we have to process next request event, a throttled
+    // request may have been refused with empty queues
+    if (!nextReqEvent.scheduled() &&
+        (getTotalReadQueueSize() || getTotalWriteQueueSize())) {
         DPRINTF(QOS,
                 "%s scheduling next request at "
                 "time %d (next is %d)\n", __func__,
@@ -195,6 +260,17 @@ MemSinkCtrl::recvTimingReq(PacketPtr pkt)
     return req_accepted;
 }
 
+void
+MemSinkCtrl::regulationRetry()
+{
+    // At most one request is waiting for a retry
+    if (retryRdReq || retryWrReq) {
+        retryRdReq = false;
+        retryWrReq = false;
+        port.sendRetryReq();
+    }
+}
+
 void
 MemSinkCtrl::processNextReqEvent()
 {
@@ -232,31 +308,27 @@ MemSinkCtrl::processNextReqEvent()
         }
     }
 
-    uint8_t curr_prio = numPriorities();
+    // Any non-empty queue provides a packet: serve the highest one
+    const int curr_prio = topPriority(busState);
 
-    for (auto queue = (*queue_ptr).rbegin();
-         queue != (*queue_ptr).rend(); ++queue) {
-
-        curr_prio--;
+    if (curr_prio >= 0) {
+        auto queue = &(*queue_ptr)[curr_prio];
 
         DPRINTF(QOS,
                 "%s checking %s queue [%d] priority [%d packets]\n",
                 __func__, (busState == READ? "READ" : "WRITE"),
                 curr_prio, queue->size());
 
-        if (!queue->empty()) {
-            // Call the queue policy to select packet from priority queue
-            auto p_it = queuePolicy->selectPacket(&(*queue));
-            pkt = *p_it;
-            queue->erase(p_it);
+        // Call the queue policy to select packet from priority queue
+        auto p_it = queuePolicy->selectPacket(queue);
+        pkt = *p_it;
+        queue->erase(p_it);
 
-            DPRINTF(QOS,
-                    "%s scheduling packet address %d for master %s from "
-                    "priority queue %d\n", __func__, pkt->getAddr(),
-                    _system->getMasterName(pkt->req->masterId()),
-                    curr_prio);
-            break;
-        }
+        DPRINTF(QOS,
+                "%s scheduling packet address %d for master %s from "
+                "priority queue %d\n", __func__, pkt->getAddr(),
+                _system->getMasterName(pkt->req->masterId()),
+                curr_prio);
     }
 
     assert(pkt);
@@ -281,18 +353,20 @@ MemSinkCtrl::processNextReqEvent()
     // into a response
     access(pkt);
 
+    const Tick latency = accessLatency(pkt);
+
     // Log the response
     logResponse(pkt->isRead()? READ : WRITE,
                 pkt->req->masterId(),
                 pkt->qosValue(),
                 pkt->getAddr(),
-                removed_entries, responseLatency);
+                removed_entries, latency);
 
     // Schedule the response
-    port.schedTimingResp(pkt, curTick() + responseLatency);
+    port.schedTimingResp(pkt, curTick() + latency);
     DPRINTF(QOS,
             "%s response scheduled at time %d\n",
-            __func__, curTick() + responseLatency);
+            __func__, curTick() + latency);
 
     // Finally - handle retry requests - this handles control
     // to the port, so do it last
@@ -340,6 +414,20 @@ MemSinkCtrl::regStats()
         .desc("Number of read retries");
     numWriteRetries.name(name() + ".numWriteRetries")
         .desc("Number of write retries");
+
+    rowHits.name(name() + ".rowHits")
+        .desc("Number of row buffer hits");
+    rowMisses.name(name() + ".rowMisses")
+        .desc("Number of row buffer misses");
+
+    totBusQueueLat.name(name() + ".totBusQueueLat")
+        .desc("Total ticks spent waiting for the data bus");
+    numBusAccesses.name(name() + ".numBusAccesses")
+        .desc("Number of bandwidth capped accesses");
+    avgBusQueueLat.name(name() + ".avgBusQueueLat")
+        .desc("Average ticks spent waiting for the data bus")
+        .precision(2);
+    avgBusQueueLat = totBusQueueLat / numBusAccesses;
 }
 
 MemSinkCtrl::MemoryPort::MemoryPort(const std::string& n,
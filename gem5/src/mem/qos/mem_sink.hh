@@ -41,6 +41,7 @@
 #ifndef __MEM_QOS_MEM_SINK_HH__
 #define __MEM_QOS_MEM_SINK_HH__
 
+#include "enums/QoSMemSinkLatency.hh"
 #include "mem/qos/mem_ctrl.hh"
 #include "mem/qport.hh"
 #include "params/QoSMemSinkCtrl.hh"
@@ -53,6 +54,12 @@ namespace QoS {
  * The QoS Memory Sink is a lightweight memory controller with QoS
  * support. It is meant to provide a QoS aware simple memory system
  * without the need of using a complex DRAM memory controller
+ *
+ * The response latency can optionally follow an analytical model,
+ * making the sink a fast stand-in for a DRAM controller: a random
+ * variable latency, a bandwidth cap queueing the transfers behind
+ * each other and an approximation of the row buffer hits of a number
+ * of banks selected by the address bits.
  */
 class MemSinkCtrl : public MemCtrl
 {
@@ -151,6 +158,30 @@ class MemSinkCtrl : public MemCtrl
     /** Memory response latency (ticks) */
     const Tick responseLatency;
 
+    /** Distribution of the variable response latency */
+    const Enums::QoSMemSinkLatency latencyDistribution;
+
+    /** Variable response latency bound or mean (ticks) */
+    const Tick latencyVar;
+
+    /** Ticks per byte transferred, 0 for unlimited bandwidth */
+    const double bandwidth;
+
+    /** Tick until which the data bus is busy with earlier transfers */
+    Tick busBusyUntil;
+
+    /** Number of banks of the row buffer approximation, 0 if unused */
+    const unsigned banks;
+
+    /** Row buffer size per bank in bytes */
+    const uint64_t rowBufferSize;
+
+    /** Response latency added by a row buffer miss (ticks) */
+    const Tick rowMissLatency;
+
+    /** Open row of each bank */
+    std::vector<Addr> openRows;
+
     /** Memory packet size in bytes */
     const uint64_t memoryPacketSize;
 
@@ -178,6 +209,24 @@ class MemSinkCtrl : public MemCtrl
     /** Count the number of write retries */
     Stats::Scalar numWriteRetries;
 
+    /** Count the number of row buffer hits and misses */
+    Stats::Scalar rowHits;
+    Stats::Scalar rowMisses;
+
+    /** Total and average time spent waiting for the data bus */
+    Stats::Scalar totBusQueueLat;
+    Stats::Scalar numBusAccesses;
+    Stats::Formula avgBusQueueLat;
+
+    /**
+     * Computes the response latency of an access following the
+     * analytical model, updating the state of the banks and data bus.
+     *
+     * @param pkt pointer to memory packet
+     * @return response latency in ticks
+     */
+    Tick accessLatency(const PacketPtr pkt);
+
     /**
      * QoS-aware (per priority) incoming read requests packets queue
      */
@@ -238,6 +287,9 @@ class MemSinkCtrl : public MemCtrl
     */
     bool recvTimingReq(PacketPtr pkt);
 
+    /** Retries a request refused by the bandwidth regulation */
+    void regulationRetry() override;
+
     /** Registers statistics */
     void regStats() override;
 };
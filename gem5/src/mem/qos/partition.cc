@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "mem/qos/partition.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mem/qos/mem_ctrl.hh"
+
+namespace QoS {
+
+MemPartition::MemPartition(const Params* p)
+  : SimObject(p), partitionId(p->partition_id), masters(p->masters),
+    memCtrl(nullptr),
+    minRate(p->min_bandwidth ? 1.0 / p->min_bandwidth : 0),
+    maxRate(p->max_bandwidth ? 1.0 / p->max_bandwidth : 0),
+    hardLimit(p->hard_limit), burstSize(p->burst_size),
+    minTokens(burstSize), maxTokens(burstSize), lastRefill(0),
+    throttledSince(MaxTick), stats(*this)
+{
+    fatal_if(partitionId == 0,
+             "%s: partition ID 0 is reserved for requests without a "
+             "partition\n", name());
+    fatal_if(minRate && maxRate && minRate > maxRate,
+             "%s: minimum bandwidth above the maximum\n", name());
+    fatal_if(burstSize == 0, "%s: empty bucket\n", name());
+}
+
+void
+MemPartition::setMemCtrl(MemCtrl* mem)
+{
+    fatal_if(memCtrl && memCtrl != mem,
+             "%s: partition regulated by more than one memory controller\n",
+             name());
+    memCtrl = mem;
+}
+
+void
+MemPartition::refill()
+{
+    const double elapsed = curTick() - lastRefill;
+    lastRefill = curTick();
+
+    minTokens = std::min(burstSize, minTokens + elapsed * minRate);
+    maxTokens = std::min(burstSize, maxTokens + elapsed * maxRate);
+}
+
+MemPartition::Regulation
+MemPartition::regulation()
+{
+    refill();
+
+    if (minRate && minTokens > 0)
+        return BelowMin;
+    if (maxRate && maxTokens < 0)
+        return AboveMax;
+    return Regular;
+}
+
+bool
+MemPartition::admit(unsigned bytes)
+{
+    const Regulation state = regulation();
+
+    if (state == AboveMax && hardLimit) {
+        if (throttledSince == MaxTick)
+            throttledSince = curTick();
+        stats.throttledRequests++;
+        return false;
+    }
+
+    if (throttledSince != MaxTick) {
+        stats.throttledCycles +=
+            memCtrl->ticksToCycles(curTick() - throttledSince);
+        throttledSince = MaxTick;
+    }
+
+    if (state == BelowMin)
+        stats.belowMinRequests++;
+    else if (state == AboveMax)
+        stats.aboveMaxRequests++;
+    stats.bytes += bytes;
+
+    // The minimum bucket debt is bounded so that a partition running
+    // well above its minimum regains its guarantee after a burst
+    if (minRate)
+        minTokens = std::max(-burstSize, minTokens - bytes);
+    if (maxRate)
+        maxTokens -= bytes;
+
+    return true;
+}
+
+Tick
+MemPartition::nextAdmission() const
+{
+    assert(maxRate && maxTokens < 0);
+    return lastRefill + static_cast<Tick>(std::ceil(-maxTokens / maxRate));
+}
+
+MemPartition::PartitionStats::PartitionStats(MemPartition &p)
+    : Stats::Group(&p),
+
+    ADD_STAT(bytes, "Number of bytes admitted"),
+    ADD_STAT(belowMinRequests,
+             "Number of requests admitted below the minimum bandwidth"),
+    ADD_STAT(aboveMaxRequests,
+             "Number of requests admitted above the maximum bandwidth"),
+    ADD_STAT(throttledRequests,
+             "Number of requests refused above the maximum bandwidth"),
+    ADD_STAT(throttledCycles,
+             "Number of memory controller cycles requests were refused")
+{
+}
+
+} // namespace QoS
+
+QoS::MemPartition *
+QoSMemPartitionParams::create()
+{
+    return new QoS::MemPartition(this);
+}
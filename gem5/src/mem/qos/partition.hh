@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __MEM_QOS_PARTITION_HH__
+#define __MEM_QOS_PARTITION_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/statistics.hh"
+#include "params/QoSMemPartition.hh"
+#include "sim/sim_object.hh"
+
+namespace QoS {
+
+class MemCtrl;
+
+/**
+ * QoS Memory Partition
+ *
+ * Bandwidth regulation of a memory partition (in the style of Arm
+ * MPAM) at the admission of the memory controller. Two token buckets
+ * track the bandwidth used by the partition against its minimum and
+ * maximum bandwidth: a partition under its minimum gets the highest
+ * QoS priority, a partition over its maximum gets the lowest one or,
+ * with a hard limit, has its requests refused until the bucket has
+ * refilled.
+ */
+class MemPartition : public SimObject
+{
+  public:
+    using Params = QoSMemPartitionParams;
+    MemPartition(const Params* p);
+
+    /** Regulation state of the partition */
+    enum Regulation {
+        BelowMin,
+        Regular,
+        AboveMax
+    };
+
+    /**
+     * Setting a pointer to the Memory Controller regulating the
+     * partition.
+     */
+    void setMemCtrl(MemCtrl* mem);
+
+    /**
+     * Gets the regulation state of the partition at the current tick
+     *
+     * @return regulation state
+     */
+    Regulation regulation();
+
+    /**
+     * Admits a request of the partition, accounting for its bandwidth,
+     * unless the partition is over its hard bandwidth limit.
+     *
+     * @param bytes size of the request
+     * @return true if the request is admitted
+     */
+    bool admit(unsigned bytes);
+
+    /**
+     * Gets the tick at which a refused request will be admitted
+     *
+     * @return tick
+     */
+    Tick nextAdmission() const;
+
+    /** Partition ID carried by the requests */
+    const uint16_t partitionId;
+
+    /** Masters whose requests without partition ID belong here */
+    const std::vector<std::string> masters;
+
+  protected:
+    /** Refills the token buckets up to the current tick */
+    void refill();
+
+    /** Pointer to the memory controller regulating the partition */
+    MemCtrl* memCtrl;
+
+    /** Minimum and maximum bandwidth in bytes per tick, 0 if unset */
+    const double minRate;
+    const double maxRate;
+
+    /** Refuse requests above the maximum bandwidth */
+    const bool hardLimit;
+
+    /** Depth of the token buckets in bytes */
+    const double burstSize;
+
+    /** Tokens of the minimum bandwidth bucket */
+    double minTokens;
+
+    /**
+     * Tokens of the maximum bandwidth bucket, the bucket goes negative
+     * when a request is larger than the available tokens
+     */
+    double maxTokens;
+
+    /** Tick the buckets were last refilled at */
+    Tick lastRefill;
+
+    /** Tick the first refused request was refused at, MaxTick if none */
+    Tick throttledSince;
+
+    struct PartitionStats : public Stats::Group
+    {
+        PartitionStats(MemPartition &p);
+
+        /** Bytes admitted */
+        Stats::Scalar bytes;
+        /** Requests admitted under the minimum bandwidth */
+        Stats::Scalar belowMinRequests;
+        /** Requests admitted over the maximum bandwidth */
+        Stats::Scalar aboveMaxRequests;
+        /** Requests refused over the maximum bandwidth */
+        Stats::Scalar throttledRequests;
+        /** Controller cycles the partition's requests were refused for */
+        Stats::Scalar throttledCycles;
+    } stats;
+};
+
+} // namespace QoS
+
+#endif /* __MEM_QOS_PARTITION_HH__ */
@@ -39,12 +39,14 @@
 
 #include "mem/qos/policy_pf.hh"
 
+#include <algorithm>
+
 #include "mem/request.hh"
 
 namespace QoS {
 
 PropFairPolicy::PropFairPolicy(const Params* p)
-  : Policy(p), weight(p->weight)
+  : Policy(p), weight(p->weight), decay(1.0)
 {
     fatal_if(weight < 0 || weight > 1,
         "weight must be a value between 0 and 1");
@@ -62,7 +64,8 @@ PropFairPolicy::initMaster(const Master master, const double score)
     assert(m_id != Request::invldMasterId);
 
     // Setting the Initial score for the selected master.
-    history.push_back(std::make_pair(m_id, score));
+    history.push_back(std::make_pair(m_id, score / decay));
+    std::sort(history.begin(), history.end(), higherScore);
 
     fatal_if(history.size() > memCtrl->numPriorities(),
         "Policy's maximum number of masters is currently dictated "
@@ -81,41 +84,36 @@ PropFairPolicy::initMasterObj(const SimObject* master, const double score)
     initMaster(master, score);
 }
 
-double
-PropFairPolicy::updateScore(
-    const double old_score, const uint64_t served_bytes) const
-{
-    return ((1.0 - weight) * old_score) + (weight * served_bytes);
-}
-
 uint8_t
 PropFairPolicy::schedule(const MasterID pkt_mid, const uint64_t pkt_size)
 {
-    auto sort_pred =
-    [] (const MasterHistory& lhs, const MasterHistory& rhs)
-    { return lhs.second > rhs.second; };
-
-    // Sorting in reverse in base of personal history:
+    // History is sorted in reverse in base of personal history:
     // First elements have higher history/score -> lower priority.
-    // The qos priority is the position in the sorted vector.
-    std::sort(history.begin(), history.end(), sort_pred);
-
-    const double served_bytes = static_cast<double>(pkt_size);
+    auto m_hist = std::find_if(history.begin(), history.end(),
+        [pkt_mid] (const MasterHistory& h) { return h.first == pkt_mid; });
 
+    // The qos priority is the position in the sorted vector.
     uint8_t pkt_priority = 0;
-    for (auto m_hist = history.begin(); m_hist != history.end(); m_hist++) {
-
-        MasterID curr_mid = m_hist->first;
-        double& curr_score = m_hist->second;
+    if (m_hist != history.end())
+        pkt_priority = std::distance(history.begin(), m_hist);
+
+    // Decay every score at once. This keeps the order of the masters,
+    // fold the factor into the scores before it underflows.
+    decay *= 1.0 - weight;
+    if (decay < 1e-100) {
+        for (auto& h : history)
+            h.second *= decay;
+        decay = 1.0;
+    }
 
-        if (curr_mid == pkt_mid) {
-            // The qos priority is the position in the sorted vector.
-            pkt_priority = std::distance(history.begin(), m_hist);
+    if (m_hist != history.end()) {
+        m_hist->second += weight * static_cast<double>(pkt_size) / decay;
 
-            curr_score = updateScore(curr_score, served_bytes);
-        } else {
-            curr_score = updateScore(curr_score, 0);
-        }
+        // Only the served master's score grew: move it ahead of the
+        // masters it now exceeds
+        auto pos = std::upper_bound(history.begin(), m_hist, *m_hist,
+                                    higherScore);
+        std::rotate(pos, m_hist, m_hist + 1);
     }
 
     return pkt_priority;
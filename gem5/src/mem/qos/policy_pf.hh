@@ -55,6 +55,11 @@ namespace QoS {
  *
  * This is the formula used by the policy
  * ((1.0 - weight) * old_score) + (weight * served_bytes);
+ *
+ * Every master's score decays at each scheduling decision. Rather than
+ * updating all the scores, the policy keeps a common decay factor and
+ * only updates the score of the served master, keeping the masters
+ * sorted as it goes.
  */
 class PropFairPolicy : public Policy
 {
@@ -100,16 +105,31 @@ class PropFairPolicy : public Policy
     template <typename Master>
     void initMaster(const Master master, const double score);
 
-    inline double
-    updateScore(const double old_score, const uint64_t served_bytes) const;
+    /** Orders the masters by decreasing score */
+    static bool
+    higherScore(const std::pair<MasterID, double>& lhs,
+                const std::pair<MasterID, double>& rhs)
+    {
+        return lhs.second > rhs.second;
+    }
 
   protected:
     /** PF Policy weight */
     const double weight;
 
-    /** history is keeping track of every master's score */
+    /**
+     * history is keeping track of every master's score, divided by
+     * the decay factor and sorted by decreasing score
+     */
     using MasterHistory = std::pair<MasterID, double>;
     std::vector<MasterHistory> history;
+
+    /**
+     * Product of the (1 - weight) decays applied since the scores were
+     * last renormalised; a master's score is its history entry times
+     * this factor.
+     */
+    double decay;
 };
 
 } // namespace QoS
@@ -39,9 +39,6 @@
 
 #include "mem/qos/q_policy.hh"
 
-#include <unordered_map>
-#include <utility>
-
 #include "debug/QOS.hh"
 #include "enums/QoSQPolicy.hh"
 #include "mem/qos/mem_ctrl.hh"
@@ -66,11 +63,10 @@ QueuePolicy::PacketQueue::iterator
 LrgQueuePolicy::selectPacket(PacketQueue* q)
 {
     QueuePolicy::PacketQueue::iterator ret = q->end();
+    uint64_t ret_grant = 0;
 
-    // Tracks one packet per master in the queue
-    std::unordered_map<MasterID, QueuePolicy::PacketQueue::iterator> track;
-
-    // Cycle queue only once
+    // Cycle queue only once, remembering the first packet of the least
+    // recently granted master
     for (auto pkt_it = q->begin(); pkt_it != q->end(); ++pkt_it) {
 
         const auto& pkt = *pkt_it;
@@ -84,63 +80,39 @@ LrgQueuePolicy::selectPacket(PacketQueue* q)
                      "from queue with id %d\n", m_id);
 
         // Check if this is a known master.
-        panic_if(memCtrl->hasMaster(m_id),
+        auto grant = lastGrant.find(m_id);
+        panic_if(grant == lastGrant.end(),
                  "%s: Unrecognized Master\n", __func__);
 
-        panic_if(toServe.size() > 0,
-                 "%s: toServe list is empty\n", __func__);
-
-        if (toServe.front() == m_id) {
-            DPRINTF(QOS, "QoSQPolicy::lrg matched to served "
-                         "master id %d\n", m_id);
-            // This packet matches the MasterID to be served next
-            // move toServe front to back
-            toServe.push_back(m_id);
-            toServe.pop_front();
-
-            return pkt_it;
-        }
-
-        // The master generating the packet is not first in the toServe list
-        // (Doesn't have the highest priority among masters)
-        // Check if this is the first packet seen with its master ID
-        // and remember it. Then keep looping over the remaining packets
-        // in the queue.
-        if (track.find(m_id) == track.end()) {
-            track[m_id] = pkt_it;
-            DPRINTF(QOS, "QoSQPolicy::lrg tracking a packet for "
-                         "master id %d\n", m_id);
+        // Only the first packet of each master can be selected
+        if (ret == q->end() || grant->second < ret_grant) {
+            ret = pkt_it;
+            ret_grant = grant->second;
         }
     }
 
-    // If here, the current master to be serviced doesn't have a pending
-    // packet in the queue: look for the next master in the list.
-    for (const auto& masterId : toServe) {
-        DPRINTF(QOS, "QoSQPolicy::lrg evaluating alternative "
-                     "master id %d\n", masterId);
-
-        if (track.find(masterId) != track.end()) {
-            ret = track[masterId];
-            DPRINTF(QOS, "QoSQPolicy::lrg master id "
-                         "%d selected for service\n", masterId);
-
-            return ret;
-        }
+    if (ret == q->end()) {
+        DPRINTF(QOS, "QoSQPolicy::lrg no packet was serviced\n");
+        return ret;
     }
 
-    DPRINTF(QOS, "QoSQPolicy::lrg no packet was serviced\n");
+    MasterID m_id = (*ret)->req->masterId();
+    DPRINTF(QOS, "QoSQPolicy::lrg master id "
+                 "%d selected for service\n", m_id);
+
+    // The selected master becomes the most recently granted one
+    lastGrant[m_id] = ++grants;
 
-    // Ret will be : packet to serve if any found or queue begin
-    // (end if queue is empty)
     return ret;
 }
 
 void
 LrgQueuePolicy::enqueuePacket(PacketPtr pkt)
 {
+    // New masters are queued behind the known ones
     MasterID m_id = pkt->masterId();
-    if (!memCtrl->hasMaster(m_id)) {
-        toServe.push_back(m_id);
+    if (lastGrant.find(m_id) == lastGrant.end()) {
+        lastGrant.emplace(m_id, ++grants);
     }
 };
 
@@ -41,7 +41,7 @@
 #define __MEM_QOS_Q_POLICY_HH__
 
 #include <deque>
-#include <unordered_set>
+#include <unordered_map>
 
 #include "mem/packet.hh"
 #include "params/QoSMemCtrl.hh"
@@ -162,7 +162,7 @@ class LrgQueuePolicy : public QueuePolicy
 {
   public:
     LrgQueuePolicy(const QoSMemCtrlParams* p)
-      : QueuePolicy(p)
+      : QueuePolicy(p), grants(0)
     {}
 
     void enqueuePacket(PacketPtr pkt) override;
@@ -179,10 +179,14 @@ class LrgQueuePolicy : public QueuePolicy
   protected:
     /**
      * Support structure for lrg algorithms:
-     * keeps track of serviced masters,
-     * always serve the front element.
+     * keeps track of the grant each master was last serviced with
+     * (or registered with, if never serviced). The master with the
+     * oldest grant is the least recently granted one.
      */
-    std::list<MasterID> toServe;
+    std::unordered_map<MasterID, uint64_t> lastGrant;
+
+    /** Number of grants handed out so far */
+    uint64_t grants;
 };
 
 } // namespace QoS
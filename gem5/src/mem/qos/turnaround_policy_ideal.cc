@@ -39,6 +39,8 @@
 
 #include "turnaround_policy_ideal.hh"
 
+#include <algorithm>
+
 #include "params/QoSTurnaroundPolicyIdeal.hh"
 
 namespace QoS {
@@ -54,24 +56,16 @@ MemCtrl::BusState
 TurnaroundPolicyIdeal::selectBusState()
 {
     auto bus_state = memCtrl->getBusState();
-    const auto num_priorities = memCtrl->numPriorities();
 
     // QoS-aware turnaround policy
-    // Loop for every queue in the memory controller.
-    for (uint8_t i = 0; i < num_priorities; i++) {
-
-        // Starting from top priority queues first
-        uint8_t queue_idx = num_priorities - i - 1;
+    // Only the highest priority holding data in either direction counts
+    const int queue_idx = std::max(memCtrl->topPriority(MemCtrl::READ),
+                                   memCtrl->topPriority(MemCtrl::WRITE));
 
+    if (queue_idx >= 0) {
         const uint64_t readq_size = memCtrl->getReadQueueSize(queue_idx);
         const uint64_t writeq_size = memCtrl->getWriteQueueSize(queue_idx);
 
-        // No data for current priority: both the read queue
-        // and write queue are empty.
-        if ((readq_size == 0) && (writeq_size == 0)) {
-            continue;
-        }
-
         // Data found - select state
         if (readq_size == 0) {
             bus_state = MemCtrl::WRITE;
@@ -90,8 +84,6 @@ TurnaroundPolicyIdeal::selectBusState()
                 (bus_state != memCtrl->getBusState()) ?
                 "turnaround" : "staying",
                 (bus_state == MemCtrl::READ)? "READ" : "WRITE");
-        // State selected - exit loop
-        break;
     }
 
     return bus_state;
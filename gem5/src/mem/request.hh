@@ -349,6 +349,12 @@ class Request
      */
     uint32_t _taskId;
 
+    /**
+     * The memory partition (e.g. an MPAM PARTID) the request belongs
+     * to, used for bandwidth regulation. Partition 0 means none.
+     */
+    uint16_t _partitionId;
+
     union {
         struct {
             /**
@@ -400,7 +406,8 @@ class Request
      */
     Request()
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(0),
           _reqInstSeqNum(0), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -409,7 +416,8 @@ class Request
     Request(Addr paddr, unsigned size, Flags flags, MasterID mid,
             InstSeqNum seq_num, ContextID cid)
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(0),
           _reqInstSeqNum(seq_num), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -426,7 +434,8 @@ class Request
      */
     Request(Addr paddr, unsigned size, Flags flags, MasterID mid)
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(0),
           _reqInstSeqNum(0), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -436,7 +445,8 @@ class Request
 
     Request(Addr paddr, unsigned size, Flags flags, MasterID mid, Tick time)
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(0),
           _reqInstSeqNum(0), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -447,7 +457,8 @@ class Request
     Request(Addr paddr, unsigned size, Flags flags, MasterID mid, Tick time,
             Addr pc)
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(pc),
           _reqInstSeqNum(0), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -459,7 +470,8 @@ class Request
     Request(uint64_t asid, Addr vaddr, unsigned size, Flags flags,
             MasterID mid, Addr pc, ContextID cid)
         : _paddr(0), _size(0), _masterId(invldMasterId), _time(0),
-          _taskId(ContextSwitchTaskId::Unknown), _asid(0), _vaddr(0),
+          _taskId(ContextSwitchTaskId::Unknown), _partitionId(0),
+          _asid(0), _vaddr(0),
           _extraData(0), _contextId(0), _pc(0),
           _reqInstSeqNum(0), atomicOpFunctor(nullptr), translateDelta(0),
           accessDelta(0), depth(0)
@@ -471,6 +483,7 @@ class Request
     Request(uint64_t asid, Addr vaddr, unsigned size, Flags flags,
             MasterID mid, Addr pc, ContextID cid,
             AtomicOpFunctorPtr atomic_op)
+        : _partitionId(0)
     {
         setVirt(asid, vaddr, size, flags, mid, pc, std::move(atomic_op));
         setContext(cid);
@@ -483,7 +496,8 @@ class Request
           _memSpaceConfigFlags(other._memSpaceConfigFlags),
           privateFlags(other.privateFlags),
           _time(other._time),
-          _taskId(other._taskId), _asid(other._asid), _vaddr(other._vaddr),
+          _taskId(other._taskId), _partitionId(other._partitionId),
+          _asid(other._asid), _vaddr(other._vaddr),
           _extraData(other._extraData), _contextId(other._contextId),
           _pc(other._pc), _reqInstSeqNum(other._reqInstSeqNum),
           translateDelta(other.translateDelta),
@@ -731,6 +745,19 @@ class Request
         _taskId = id;
     }
 
+    /** Accessor for the memory partition ID, 0 if none. */
+    uint16_t
+    partitionId() const
+    {
+        return _partitionId;
+    }
+
+    void
+    partitionId(uint16_t id)
+    {
+        _partitionId = id;
+    }
+
     /** Accessor function for asid.*/
     uint64_t
     getAsid() const
@@ -28,8 +28,34 @@
 
 #include "mem/ruby/common/Consumer.hh"
 
+#include <algorithm>
+
 using namespace std;
 
+Consumer::Consumer(ClockedObject *_em)
+    : m_last_wakeup(MaxTick),
+      m_wakeup_event([this]{ processWakeup(); }, _em->name() + ".wakeup"),
+      em(_em)
+{
+}
+
+Consumer::~Consumer()
+{
+    if (m_wakeup_event.scheduled())
+        em->deschedule(m_wakeup_event);
+}
+
+bool
+Consumer::alreadyScheduled(Tick time) const
+{
+    // A wakeup at a clock edge covers the rest of the edge, even once
+    // it has been serviced.
+    if (time == m_last_wakeup && time >= em->clockEdge())
+        return true;
+    return binary_search(m_pending_wakeups.begin(), m_pending_wakeups.end(),
+                         time);
+}
+
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
@@ -39,17 +65,29 @@ Consumer::scheduleEvent(Cycles timeDelta)
 void
 Consumer::scheduleEventAbsolute(Tick evt_time)
 {
-    if (!alreadyScheduled(evt_time)) {
-        // This wakeup is not redundant
-        auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
-
-        em->schedule(evt, evt_time);
-        insertScheduledWakeupTime(evt_time);
-    }
-
-    Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    if (alreadyScheduled(evt_time))
+        return;
+
+    // This wakeup is not redundant
+    m_pending_wakeups.insert(upper_bound(m_pending_wakeups.begin(),
+                                         m_pending_wakeups.end(), evt_time),
+                             evt_time);
+    if (!m_wakeup_event.scheduled())
+        em->schedule(m_wakeup_event, evt_time);
+    else if (evt_time < m_wakeup_event.when())
+        em->reschedule(m_wakeup_event, evt_time);
+}
+
+void
+Consumer::processWakeup()
+{
+    assert(!m_pending_wakeups.empty() &&
+           m_pending_wakeups.front() == curTick());
+    m_pending_wakeups.erase(m_pending_wakeups.begin());
+    m_last_wakeup = curTick();
+
+    wakeup();
+
+    if (!m_pending_wakeups.empty() && !m_wakeup_event.scheduled())
+        em->schedule(m_wakeup_event, m_pending_wakeups.front());
 }
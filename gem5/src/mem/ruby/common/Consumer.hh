@@ -36,45 +36,59 @@
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
 class Consumer
 {
   public:
-    Consumer(ClockedObject *_em)
-        : em(_em)
-    {
-    }
+    Consumer(ClockedObject *_em);
 
-    virtual
-    ~Consumer()
-    { }
+    virtual ~Consumer();
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
-    virtual void storeEventInfo(int info) {}
 
-    bool
-    alreadyScheduled(Tick time)
-    {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
-    }
+    /**
+     * Notification that a message was enqueued in one of the buffers
+     * consumed by this object.
+     *
+     * @param vnet Virtual network of the buffer.
+     * @param link Incoming link of the buffer.
+     */
+    virtual void storeEventInfo(int vnet, int link) {}
 
-    void
-    insertScheduledWakeupTime(Tick time)
-    {
-        m_scheduled_wakeups.insert(time);
-    }
+    bool alreadyScheduled(Tick time) const;
 
     void scheduleEventAbsolute(Tick timeAbs);
 
+    /**
+     * Get the event queue the wakeups of this consumer are serviced on.
+     * The scheduled wakeups are only to be updated from this queue.
+     *
+     * @return The event queue of the consumer.
+     */
+    EventQueue *consumerEventQueue() const { return em->eventQueue(); }
+
   protected:
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    void processWakeup();
+
+    /**
+     * Pending wakeup times in increasing order. There are usually only
+     * a few of them, all in the near future, so a sorted array is much
+     * cheaper to update than a tree, and a single event scheduled for
+     * the earliest one services them all in turn.
+     */
+    std::vector<Tick> m_pending_wakeups;
+
+    /** Time of the last wakeup. */
+    Tick m_last_wakeup;
+
+    EventFunctionWrapper m_wakeup_event;
     ClockedObject *em;
 };
 
@@ -103,7 +103,7 @@ NetDest::broadcast(MachineType machineType)
 
 //For Princeton Network
 std::vector<NodeID>
-NetDest::getAllDest()
+NetDest::getAllDest() const
 {
     std::vector<NodeID> dest;
     dest.clear();
@@ -139,11 +139,10 @@ NetDest::smallestElement() const
 {
     assert(count() > 0);
     for (int i = 0; i < m_bits.size(); i++) {
-        for (NodeID j = 0; j < m_bits[i].getSize(); j++) {
-            if (m_bits[i].isElement(j)) {
-                MachineID mach = {MachineType_from_base_level(i), j};
-                return mach;
-            }
+        if (!m_bits[i].isEmpty()) {
+            MachineID mach = {MachineType_from_base_level(i),
+                              m_bits[i].smallestElement()};
+            return mach;
         }
     }
     panic("No smallest element of an empty set.");
@@ -152,12 +151,10 @@ NetDest::smallestElement() const
 MachineID
 NetDest::smallestElement(MachineType machine) const
 {
-    int size = m_bits[MachineType_base_level(machine)].getSize();
-    for (NodeID j = 0; j < size; j++) {
-        if (m_bits[MachineType_base_level(machine)].isElement(j)) {
-            MachineID mach = {machine, j};
-            return mach;
-        }
+    const Set &set = m_bits[MachineType_base_level(machine)];
+    if (!set.isEmpty()) {
+        MachineID mach = {machine, set.smallestElement()};
+        return mach;
     }
 
     panic("No smallest element of given MachineType.");
@@ -246,8 +243,7 @@ NetDest::isElement(MachineID element) const
 void
 NetDest::resize()
 {
-    m_bits.resize(MachineType_base_level(MachineType_NUM));
-    assert(m_bits.size() == MachineType_NUM);
+    assert(MachineType_base_level(MachineType_NUM) == m_bits.size());
 
     for (int i = 0; i < m_bits.size(); i++) {
         m_bits[i].setSize(MachineType_base_count((MachineType)i));
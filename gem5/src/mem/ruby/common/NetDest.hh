@@ -29,6 +29,7 @@
 #ifndef __MEM_RUBY_COMMON_NETDEST_HH__
 #define __MEM_RUBY_COMMON_NETDEST_HH__
 
+#include <array>
 #include <iostream>
 #include <vector>
 
@@ -79,7 +80,7 @@ class NetDest
     bool isEmpty() const;
 
     // For Princeton Network
-    std::vector<NodeID> getAllDest();
+    std::vector<NodeID> getAllDest() const;
 
     MachineID smallestElement() const;
     MachineID smallestElement(MachineType machine) const;
@@ -105,7 +106,10 @@ class NetDest
 
     NodeID bitIndex(NodeID index) const { return index; }
 
-    std::vector<Set> m_bits;  // a vector of bit vectors - i.e. Sets
+    // One bit vector, i.e. Set, per machine type. The sets are kept
+    // inline so that copying the destination of a message doesn't
+    // allocate anything.
+    std::array<Set, MachineType_NUM> m_bits;
 };
 
 inline std::ostream&
@@ -36,6 +36,7 @@
 #include <cassert>
 #include <iostream>
 
+#include "base/bitfield.hh"
 #include "base/logging.hh"
 #include "mem/ruby/common/TypeDefines.hh"
 
@@ -189,9 +190,12 @@ class Set
 
     NodeID smallestElement() const
     {
-        for (int i = 0; i < m_nSize; ++i) {
-            if (bits.test(i)) {
-                return i;
+        // Look for the first bit a word at a time
+        const std::bitset<NUMBER_BITS_PER_SET> word_mask(~0ULL);
+        for (int i = 0; i < m_nSize; i += 64) {
+            const uint64_t word = ((bits >> i) & word_mask).to_ullong();
+            if (word) {
+                return i + findLsbSet(word);
             }
         }
         panic("No smallest element of an empty set.");
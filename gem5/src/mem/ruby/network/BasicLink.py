@@ -48,6 +48,15 @@ class BasicExtLink(BasicLink):
     int_node = Param.BasicRouter("ID of internal node")
     bandwidth_factor = 16 # only used by simple network
 
+    # The controller and the router can be on different event queues.
+    # The controller enqueues into the network with at least a cycle of
+    # latency, and the router delivers with the link latency.
+    def lookaheadLinks(self):
+        latency = min(self.ext_node.clk_domain.clockPeriod(),
+                      int(self.latency) *
+                      self.int_node.clk_domain.clockPeriod())
+        return [(self.ext_node, self.int_node, latency)]
+
 class BasicIntLink(BasicLink):
     type = 'BasicIntLink'
     cxx_header = "mem/ruby/network/BasicLink.hh"
@@ -60,3 +69,9 @@ class BasicIntLink(BasicLink):
 
     # only used by simple network
     bandwidth_factor = 16
+
+    # Messages are delivered to the destination router with the link
+    # latency of the source router
+    def lookaheadLinks(self):
+        latency = int(self.latency) * self.src_node.clk_domain.clockPeriod()
+        return [(self.src_node, self.dst_node, latency)]
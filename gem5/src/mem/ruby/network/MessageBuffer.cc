@@ -36,6 +36,7 @@
 #include "base/stl_helpers.hh"
 #include "debug/RubyQueue.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/lookahead.hh"
 
 using namespace std;
 using m5::stl_helpers::operator<<;
@@ -45,7 +46,9 @@ MessageBuffer::MessageBuffer(const Params *p)
     m_max_size(p->buffer_size), m_time_last_time_size_checked(0),
     m_time_last_time_enqueue(0), m_time_last_time_pop(0),
     m_last_arrival_time(0), m_strict_fifo(p->ordered),
-    m_randomization(p->randomization)
+    m_randomization(p->randomization), m_producer(NULL),
+    m_producer_latency(0), m_cross_queue(false), m_cross_size(0),
+    m_cross_last_arrival_time(0), m_cross_msg_counter(0)
 {
     m_msg_counter = 0;
     m_consumer = NULL;
@@ -65,12 +68,57 @@ MessageBuffer::MessageBuffer(const Params *p)
     m_dequeue_callback = nullptr;
 }
 
+void
+MessageBuffer::setProducer(ClockedObject *producer, Tick latency)
+{
+    if (m_producer != NULL && m_producer != producer) {
+        fatal("Trying to connect %s to MessageBuffer %s, which is already "
+              "fed by %s.\n", producer->name(), name(), m_producer->name());
+    }
+    m_producer = producer;
+    m_producer_latency = latency;
+}
+
+void
+MessageBuffer::startup()
+{
+    SimObject::startup();
+
+    if (m_producer == NULL || m_consumer == NULL) {
+        return;
+    }
+
+    EventQueue *producer_queue = m_producer->eventQueue();
+    EventQueue *consumer_queue = m_consumer->consumerEventQueue();
+    if (producer_queue == consumer_queue) {
+        return;
+    }
+
+    // The random delays are drawn from the global random number
+    // generator, which is not thread safe.
+    fatal_if(m_randomization || RubySystem::getRandomization(),
+             "MessageBuffer %s connects two event queues and can't be "
+             "randomized.\n", name());
+    fatal_if(m_producer_latency == 0, "MessageBuffer %s connects two event "
+             "queues without latency.\n", name());
+
+    DPRINTF(RubyQueue, "Crossing from event queue %s to %s with a "
+            "lookahead of %d ticks\n", producer_queue->name(),
+            consumer_queue->name(), m_producer_latency);
+
+    m_cross_queue = true;
+    if (lookaheadSync) {
+        registerLookahead(producer_queue, consumer_queue,
+                          m_producer_latency);
+    }
+}
+
 unsigned int
 MessageBuffer::getSize(Tick curTime)
 {
     if (m_time_last_time_size_checked != curTime) {
         m_time_last_time_size_checked = curTime;
-        m_size_last_time_size_checked = m_prio_heap.size();
+        m_size_last_time_size_checked = numMessages();
     }
 
     return m_size_last_time_size_checked;
@@ -85,6 +133,18 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         return true;
     }
 
+    // a producer on another event queue only sees the slots the consumer
+    // freed once it has been told so
+    if (isRemote()) {
+        if (m_cross_size + n <= m_max_size) {
+            return true;
+        }
+        DPRINTF(RubyQueue, "n: %d, size seen by producer: %d, "
+                "m_max_size: %d\n", n, m_cross_size, m_max_size);
+        m_not_avail_count++;
+        return false;
+    }
+
     // determine the correct size for the current cycle
     // pop operations shouldn't effect the network's visible size
     // until schd cycle, but enqueue operations effect the visible
@@ -94,7 +154,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
 
     if (m_time_last_time_pop < current_time) {
         // no pops this cycle - heap and stall queue size is correct
-        current_size = m_prio_heap.size();
+        current_size = numMessages();
         current_stall_size = m_stall_map_size;
     } else {
         if (m_time_last_time_enqueue < current_time) {
@@ -117,7 +177,7 @@ MessageBuffer::areNSlotsAvailable(unsigned int n, Tick current_time)
         DPRINTF(RubyQueue, "n: %d, current_size: %d, heap size: %d, "
                 "m_max_size: %d\n",
                 n, current_size + current_stall_size,
-                m_prio_heap.size(), m_max_size);
+                numMessages(), m_max_size);
         m_not_avail_count++;
         return false;
     }
@@ -127,7 +187,7 @@ const Message*
 MessageBuffer::peek() const
 {
     DPRINTF(RubyQueue, "Peeking at head of queue.\n");
-    const Message* msg_ptr = m_prio_heap.front().get();
+    const Message* msg_ptr = headMessage().get();
     assert(msg_ptr);
 
     DPRINTF(RubyQueue, "Message: %s\n", (*msg_ptr));
@@ -149,6 +209,42 @@ random_time()
 void
 MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
 {
+    if (isRemote()) {
+        // The message is handed to the queue of the consumer, and only
+        // becomes part of the buffer when it arrives. Randomization is
+        // not supported across queues (see startup()).
+        assert(delta > 0);
+        const Tick arrival_time = current_time + delta;
+        panic_if(arrival_time < curTick() + m_producer_latency,
+                 "Message enqueued in %s with less than the lookahead of "
+                 "%d ticks\n", name(), m_producer_latency);
+        if (m_strict_fifo && arrival_time < m_cross_last_arrival_time) {
+            panic("FIFO ordering violated: %s name: %s current time: %d "
+                  "delta: %d arrival_time: %d last arrival_time: %d\n",
+                  *this, name(), current_time, delta, arrival_time,
+                  m_cross_last_arrival_time);
+        }
+        m_cross_last_arrival_time = arrival_time;
+        m_cross_size++;
+
+        Message* msg_ptr = message.get();
+        assert(msg_ptr != NULL);
+        msg_ptr->updateDelayedTicks(current_time);
+        msg_ptr->setLastEnqueueTime(arrival_time);
+        msg_ptr->setMsgCounter(++m_cross_msg_counter);
+
+        DPRINTF(RubyQueue, "Enqueue from another event queue "
+                "arrival_time: %lld, Message: %s\n", arrival_time,
+                *msg_ptr);
+
+        // Deliver the messages before the consumer wakes up on the same
+        // tick
+        m_consumer->consumerEventQueue()->scheduleOneShot(
+            [this, message]{ deliverMessage(message); }, arrival_time,
+            Event::Delayed_Writeback_Pri);
+        return;
+    }
+
     // record current time incase we have a pop that also adjusts my size
     if (m_time_last_time_enqueue < current_time) {
         m_msgs_this_cycle = 0;  // first msg this cycle
@@ -207,9 +303,7 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     msg_ptr->setLastEnqueueTime(arrival_time);
     msg_ptr->setMsgCounter(m_msg_counter);
 
-    // Insert the message into the priority heap
-    m_prio_heap.push_back(message);
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    insertMessage(message);
     // Increment the number of messages statistic
     m_buf_msgs++;
 
@@ -219,7 +313,7 @@ MessageBuffer::enqueue(MsgPtr message, Tick current_time, Tick delta)
     // Schedule the wakeup
     assert(m_consumer != NULL);
     m_consumer->scheduleEventAbsolute(arrival_time);
-    m_consumer->storeEventInfo(m_vnet_id);
+    m_consumer->storeEventInfo(m_vnet_id, m_input_link_id);
 }
 
 Tick
@@ -229,7 +323,7 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     assert(isReady(current_time));
 
     // get MsgPtr of the message about to be dequeued
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = headMessage();
 
     // get the delay cycles
     message->updateDelayedTicks(current_time);
@@ -240,27 +334,86 @@ MessageBuffer::dequeue(Tick current_time, bool decrement_messages)
     // record previous size and time so the current buffer size isn't
     // adjusted until schd cycle
     if (m_time_last_time_pop < current_time) {
-        m_size_at_cycle_start = m_prio_heap.size();
+        m_size_at_cycle_start = numMessages();
         m_stalled_at_cycle_start = m_stall_map_size;
         m_time_last_time_pop = current_time;
     }
 
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
-    m_prio_heap.pop_back();
+    popMessage();
     if (decrement_messages) {
         // If the message will be removed from the queue, decrement the
         // number of message in the queue.
         m_buf_msgs--;
     }
 
-    // if a dequeue callback was requested, call it now
-    if (m_dequeue_callback) {
+    if (m_cross_queue && decrement_messages) {
+        // Let the producer know, on its own queue, that the slot is free,
+        // which also calls the dequeue callback it may have registered
+        m_producer->scheduleOneShot([this]{ releaseSlot(); },
+                                    curTick() + m_producer_latency,
+                                    Event::Delayed_Writeback_Pri);
+    } else if (m_dequeue_callback) {
+        // if a dequeue callback was requested, call it now
         m_dequeue_callback();
     }
 
     return delay;
 }
 
+void
+MessageBuffer::deliverMessage(MsgPtr message)
+{
+    assert(message->getLastEnqueueTime() == curTick());
+
+    m_msg_counter++;
+    insertMessage(message);
+    m_buf_msgs++;
+
+    DPRINTF(RubyQueue, "Deliver Message: %s\n", *(message.get()));
+
+    assert(m_consumer != NULL);
+    m_consumer->scheduleEventAbsolute(curTick());
+    m_consumer->storeEventInfo(m_vnet_id, m_input_link_id);
+}
+
+void
+MessageBuffer::insertMessage(const MsgPtr &message)
+{
+    if (m_fifo.empty() || !(m_fifo.back() > message)) {
+        m_fifo.push_back(message);
+    } else {
+        m_prio_heap.push_back(message);
+        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
+                  greater<MsgPtr>());
+    }
+}
+
+MsgPtr
+MessageBuffer::popMessage()
+{
+    MsgPtr message;
+    if (headInFifo()) {
+        message = std::move(m_fifo.front());
+        m_fifo.pop_front();
+    } else {
+        pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+        message = std::move(m_prio_heap.back());
+        m_prio_heap.pop_back();
+    }
+    return message;
+}
+
+void
+MessageBuffer::releaseSlot()
+{
+    assert(m_cross_size > 0);
+    m_cross_size--;
+
+    if (m_dequeue_callback) {
+        m_dequeue_callback();
+    }
+}
+
 void
 MessageBuffer::registerDequeueCallback(std::function<void()> callback)
 {
@@ -276,6 +429,7 @@ MessageBuffer::unregisterDequeueCallback()
 void
 MessageBuffer::clear()
 {
+    m_fifo.clear();
     m_prio_heap.clear();
 
     m_msg_counter = 0;
@@ -291,14 +445,12 @@ MessageBuffer::recycle(Tick current_time, Tick recycle_latency)
 {
     DPRINTF(RubyQueue, "Recycling.\n");
     assert(isReady(current_time));
-    MsgPtr node = m_prio_heap.front();
-    pop_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    MsgPtr node = popMessage();
 
     Tick future_time = current_time + recycle_latency;
     node->setLastEnqueueTime(future_time);
 
-    m_prio_heap.back() = node;
-    push_heap(m_prio_heap.begin(), m_prio_heap.end(), greater<MsgPtr>());
+    insertMessage(node);
     m_consumer->scheduleEventAbsolute(future_time);
 }
 
@@ -309,9 +461,7 @@ MessageBuffer::reanalyzeList(list<MsgPtr> &lt, Tick schdTick)
         MsgPtr m = lt.front();
         assert(m->getLastEnqueueTime() <= schdTick);
 
-        m_prio_heap.push_back(m);
-        push_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                  greater<MsgPtr>());
+        insertMessage(m);
 
         m_consumer->scheduleEventAbsolute(schdTick);
 
@@ -366,7 +516,7 @@ MessageBuffer::stallMessage(Addr addr, Tick current_time)
     DPRINTF(RubyQueue, "Stalling due to %#x\n", addr);
     assert(isReady(current_time));
     assert(getOffset(addr) == 0);
-    MsgPtr message = m_prio_heap.front();
+    MsgPtr message = headMessage();
 
     // Since the message will just be moved to stall map, indicate that the
     // buffer should not decrement the m_buf_msgs statistic
@@ -391,15 +541,16 @@ MessageBuffer::print(ostream& out) const
     }
 
     vector<MsgPtr> copy(m_prio_heap);
-    sort_heap(copy.begin(), copy.end(), greater<MsgPtr>());
+    copy.insert(copy.end(), m_fifo.begin(), m_fifo.end());
+    sort(copy.begin(), copy.end(), greater<MsgPtr>());
     ccprintf(out, "%s] %s", copy, name());
 }
 
 bool
 MessageBuffer::isReady(Tick current_time) const
 {
-    return ((m_prio_heap.size() > 0) &&
-        (m_prio_heap.front()->getLastEnqueueTime() <= current_time));
+    return ((numMessages() > 0) &&
+        (headMessage()->getLastEnqueueTime() <= current_time));
 }
 
 void
@@ -442,11 +593,15 @@ MessageBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    // Check the priority heap and write any messages that may
+    // Check the queued messages and write any messages that may
     // correspond to the address in the packet.
-    for (unsigned int i = 0; i < m_prio_heap.size(); ++i) {
-        Message *msg = m_prio_heap[i].get();
-        if (msg->functionalWrite(pkt)) {
+    for (const auto &message : m_fifo) {
+        if (message->functionalWrite(pkt)) {
+            num_functional_writes++;
+        }
+    }
+    for (const auto &message : m_prio_heap) {
+        if (message->functionalWrite(pkt)) {
             num_functional_writes++;
         }
     }
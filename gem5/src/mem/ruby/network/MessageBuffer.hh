@@ -36,9 +36,12 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <iostream>
+#include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "base/trace.hh"
@@ -68,10 +71,7 @@ class MessageBuffer : public SimObject
     void
     delayHead(Tick current_time, Tick delta)
     {
-        MsgPtr m = m_prio_heap.front();
-        std::pop_heap(m_prio_heap.begin(), m_prio_heap.end(),
-                      std::greater<MsgPtr>());
-        m_prio_heap.pop_back();
+        MsgPtr m = popMessage();
         enqueue(m, current_time, delta);
     }
 
@@ -91,13 +91,25 @@ class MessageBuffer : public SimObject
 
     Consumer* getConsumer() { return m_consumer; }
 
+    /**
+     * Set the object that enqueues messages into this buffer, along with
+     * the minimum latency of its enqueues. If the producer turns out to
+     * be on another event queue than the consumer, the messages, as well
+     * as the slots they free, are passed between the two queues through
+     * events, and the latency is registered as their lookahead.
+     *
+     * @param producer The object enqueueing into the buffer.
+     * @param latency The minimum latency of an enqueue, in ticks.
+     */
+    void setProducer(ClockedObject *producer, Tick latency);
+
     bool getOrdered() { return m_strict_fifo; }
 
     //! Function for extracting the message at the head of the
     //! message queue.  The function assumes that the queue is nonempty.
     const Message* peek() const;
 
-    const MsgPtr &peekMsgPtr() const { return m_prio_heap.front(); }
+    const MsgPtr &peekMsgPtr() const { return headMessage(); }
 
     void enqueue(MsgPtr message, Tick curTime, Tick delta);
 
@@ -109,7 +121,7 @@ class MessageBuffer : public SimObject
     void unregisterDequeueCallback();
 
     void recycle(Tick current_time, Tick recycle_latency);
-    bool isEmpty() const { return m_prio_heap.size() == 0; }
+    bool isEmpty() const { return numMessages() == 0; }
     bool isStallMapEmpty() { return m_stall_msg_map.size() == 0; }
     unsigned int getStallMapSize() { return m_stall_msg_map.size(); }
 
@@ -128,6 +140,8 @@ class MessageBuffer : public SimObject
         return RubyDummyPort::instance();
     }
 
+    void startup() override;
+
     void regStats() override;
 
     // Function for figuring out if any of the messages in the buffer need
@@ -139,17 +153,71 @@ class MessageBuffer : public SimObject
   private:
     void reanalyzeList(std::list<MsgPtr> &, Tick);
 
+    //! Add a message to the ordered messages.
+    void insertMessage(const MsgPtr &message);
+
+    //! Whether the next message is at the head of the FIFO rather than
+    //! in the heap.
+    bool
+    headInFifo() const
+    {
+        return !m_fifo.empty() &&
+            (m_prio_heap.empty() || m_prio_heap.front() > m_fifo.front());
+    }
+
+    //! Get the next message. There must be one.
+    const MsgPtr &
+    headMessage() const
+    {
+        return headInFifo() ? m_fifo.front() : m_prio_heap.front();
+    }
+
+    //! Remove and return the next message. There must be one.
+    MsgPtr popMessage();
+
+    unsigned int numMessages() const
+    {
+        return m_prio_heap.size() + m_fifo.size();
+    }
+
+    //! Whether the caller is on the other side of an event queue
+    //! crossing, that is, it is a producer on another queue than the
+    //! consumer.
+    bool isRemote() const
+    {
+        return m_cross_queue &&
+            curEventQueue() != m_consumer->consumerEventQueue();
+    }
+
+    //! Insert a message enqueued from another event queue. Runs on the
+    //! queue of the consumer when the message arrives.
+    void deliverMessage(MsgPtr message);
+
+    //! Tell the producer on another event queue that a message left the
+    //! buffer. Runs on the queue of the producer.
+    void releaseSlot();
+
   private:
     // Data Members (m_ prefix)
     //! Consumer to signal a wakeup(), can be NULL
     Consumer* m_consumer;
+
+    /**
+     * The messages of the buffer, ordered by arrival time and enqueue
+     * order. Most messages arrive no earlier than the last message
+     * enqueued, so they are appended to a FIFO. Only the others, e.g.
+     * messages with a shorter latency, randomized or recycled messages,
+     * and messages that are no longer stalled, go to the heap, and
+     * the head of the buffer is the earlier of the two heads.
+     */
+    std::deque<MsgPtr> m_fifo;
     std::vector<MsgPtr> m_prio_heap;
 
     std::function<void()> m_dequeue_callback;
 
-    // use a std::map for the stalled messages as this container is
-    // sorted and ensures a well-defined iteration order
-    typedef std::map<Addr, std::list<MsgPtr> > StallMsgMapType;
+    // The iteration order of the stalled messages doesn't matter since
+    // they are put back in order of arrival time and enqueue order
+    typedef std::unordered_map<Addr, std::list<MsgPtr> > StallMsgMapType;
 
     /**
      * A map from line addresses to lists of stalled messages for that line.
@@ -205,6 +273,19 @@ class MessageBuffer : public SimObject
     int m_input_link_id;
     int m_vnet_id;
 
+    //! Object enqueueing into this buffer, can be NULL
+    ClockedObject *m_producer;
+    //! Minimum latency of the enqueues of the producer
+    Tick m_producer_latency;
+    //! Whether the producer and the consumer are on different queues
+    bool m_cross_queue;
+
+    // variables only used by the producer when it is on another event
+    // queue than the consumer
+    unsigned int m_cross_size;
+    Tick m_cross_last_arrival_time;
+    uint64_t m_cross_msg_counter;
+
     Stats::Average m_buf_msgs;
     Stats::Average m_stall_time;
     Stats::Scalar m_stall_count;
@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "mem/ruby/network/analytical/AnalyticalNetwork.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/intmath.hh"
+#include "base/logging.hh"
+#include "debug/RubyNetwork.hh"
+#include "mem/ruby/network/BasicLink.hh"
+#include "mem/ruby/network/BasicRouter.hh"
+#include "mem/ruby/network/MessageBuffer.hh"
+
+AnalyticalNetwork::AnalyticalNetwork(const Params *p)
+    : Network(p), Consumer(this), m_epoch(p->epoch),
+      m_max_utilization(p->max_utilization),
+      m_routes(p->routers.size()), m_ext_in_link(m_nodes, -1),
+      m_ext_in_switch(m_nodes, -1), m_epoch_start(0)
+{
+    fatal_if(m_max_utilization <= 0 || m_max_utilization >= 1,
+             "The maximum link utilization of %s has to be in (0, 1)",
+             name());
+    fatal_if(m_epoch == 0, "The epoch of %s can't be empty", name());
+
+    for (auto router : p->routers)
+        m_router_latency.push_back(router->params()->latency);
+}
+
+void
+AnalyticalNetwork::init()
+{
+    Network::init();
+
+    // The topology pointer should have already been initialized in
+    // the parent class network constructor.
+    assert(m_topology_ptr != NULL);
+    m_topology_ptr->createLinks(this);
+
+    computePaths();
+
+    for (int node = 0; node < m_nodes; node++) {
+        for (auto buffer : m_toNetQueues[node]) {
+            if (buffer != nullptr)
+                buffer->setConsumer(this);
+        }
+
+        // The shortest path has an external link in each direction
+        for (auto buffer : m_fromNetQueues[node]) {
+            if (buffer != nullptr)
+                buffer->setProducer(this, cyclesToTicks(Cycles(2)));
+        }
+    }
+
+    m_last_arrival.resize(m_nodes);
+    for (auto &arrivals : m_last_arrival)
+        arrivals.resize(m_virtual_networks, 0);
+}
+
+int
+AnalyticalNetwork::addLink(BasicLink *link)
+{
+    fatal_if(link->m_latency == 0, "Link %s of %s has no latency",
+             link->name(), name());
+    fatal_if(link->m_bandwidth_factor <= 0, "Link %s of %s has no "
+             "bandwidth", link->name(), name());
+
+    m_links.push_back(Link{ link->m_latency, link->m_bandwidth_factor,
+                            0, 0.0 });
+    return m_links.size() - 1;
+}
+
+// From a switch to an endpoint node
+void
+AnalyticalNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                                  const NetDest& routing_table_entry)
+{
+    assert(dest < m_nodes);
+    assert(src < m_routes.size());
+
+    m_routes[src].push_back(Route{ addLink(link), -1, link->m_weight,
+                                   routing_table_entry });
+}
+
+// From an endpoint node to a switch
+void
+AnalyticalNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                                 const NetDest& routing_table_entry)
+{
+    assert(src < m_nodes);
+    assert(dest < m_routes.size());
+
+    m_ext_in_link[src] = addLink(link);
+    m_ext_in_switch[src] = dest;
+}
+
+// From a switch to a switch
+void
+AnalyticalNetwork::makeInternalLink(SwitchID src, SwitchID dest,
+                                    BasicLink* link,
+                                    const NetDest& routing_table_entry,
+                                    PortDirection src_outport,
+                                    PortDirection dst_inport)
+{
+    assert(src < m_routes.size() && dest < m_routes.size());
+
+    m_routes[src].push_back(Route{ addLink(link), (int)dest,
+                                   link->m_weight, routing_table_entry });
+}
+
+void
+AnalyticalNetwork::computePaths()
+{
+    // The nodes are numbered as in NetDest::getAllDest()
+    m_machines.resize(m_nodes);
+    for (int type = 0; type < MachineType_NUM; type++) {
+        for (int i = 0; i < MachineType_base_count((MachineType)type); i++) {
+            m_machines[MachineType_base_number((MachineType)type) + i] =
+                MachineID{ (MachineType)type, (NodeID)i };
+        }
+    }
+
+    m_path_offset.resize(m_nodes * m_nodes + 1);
+    m_path_latency.resize(m_nodes * m_nodes);
+    m_path_links.clear();
+
+    for (int src = 0; src < m_nodes; src++) {
+        for (int dest = 0; dest < m_nodes; dest++) {
+            const int path = src * m_nodes + dest;
+            m_path_offset[path] = m_path_links.size();
+            m_path_latency[path] = Cycles(0);
+
+            // Nodes that aren't connected can't send messages
+            if (m_ext_in_link[src] == -1)
+                continue;
+
+            Cycles latency = m_links[m_ext_in_link[src]].latency;
+            m_path_links.push_back(m_ext_in_link[src]);
+
+            // Follow the route with the lowest weight at each switch,
+            // the first one on a tie, as an ordered vnet would
+            int sw = m_ext_in_switch[src];
+            for (int hops = 0; sw != -1; hops++) {
+                fatal_if(hops > m_routes.size(), "%s: Routing loop from "
+                         "node %d to node %d", name(), src, dest);
+
+                const Route *next = nullptr;
+                for (const auto &route : m_routes[sw]) {
+                    if (route.destinations.isElement(m_machines[dest]) &&
+                        (!next || route.weight < next->weight)) {
+                        next = &route;
+                    }
+                }
+                fatal_if(!next, "%s: No route from node %d to node %d",
+                         name(), src, dest);
+
+                latency += m_router_latency[sw] +
+                    m_links[next->link].latency;
+                m_path_links.push_back(next->link);
+                sw = next->next_switch;
+            }
+
+            m_path_latency[path] = latency;
+        }
+    }
+    m_path_offset[m_nodes * m_nodes] = m_path_links.size();
+}
+
+void
+AnalyticalNetwork::updateUtilization()
+{
+    const Cycles elapsed = curCycle() - m_epoch_start;
+    if (elapsed < m_epoch)
+        return;
+
+    for (auto &link : m_links) {
+        link.utilization = std::min(m_max_utilization,
+            (double)link.bytes / ((double)elapsed * link.bandwidth));
+        link.bytes = 0;
+    }
+    m_epoch_start = curCycle();
+}
+
+Cycles
+AnalyticalNetwork::deliver(NodeID src, NodeID dest, int vnet,
+                           const MsgPtr &msg, int bytes, Tick now)
+{
+    const int path = src * m_nodes + dest;
+    panic_if(m_path_offset[path] == m_path_offset[path + 1],
+             "%s: Node %d sent a message without being connected", name(),
+             src);
+
+    // The message is serialized at the slowest link, and its tail
+    // follows the head with that many cycles minus one. It also waits
+    // for the messages ahead of it at every link. With a deterministic
+    // service time s and utilization u, the mean waiting time of an
+    // M/D/1 queue is u * s / (2 * (1 - u)).
+    Cycles serialization(0);
+    double queueing = 0;
+    for (int i = m_path_offset[path]; i < m_path_offset[path + 1]; i++) {
+        Link &link = m_links[m_path_links[i]];
+        const Cycles s(divCeil(bytes, link.bandwidth));
+        serialization = std::max(serialization, s);
+        queueing += link.utilization * (double)s /
+            (2 * (1 - link.utilization));
+        link.bytes += bytes;
+    }
+
+    const Cycles queueing_cycles((uint64_t)queueing);
+    const Cycles latency = m_path_latency[path] + serialization - Cycles(1) +
+        queueing_cycles;
+
+    Tick arrival = now + cyclesToTicks(latency);
+    if (isVNetOrdered(vnet)) {
+        arrival = std::max(arrival, m_last_arrival[dest][vnet]);
+        m_last_arrival[dest][vnet] = arrival;
+    }
+
+    DPRINTF(RubyNetwork, "Delivering message from node %d to node %d on "
+            "vnet %d in %d cycles\n", src, dest, vnet, latency);
+
+    m_fromNetQueues[dest][vnet]->enqueue(msg, now, arrival - now);
+
+    m_total_queueing_latency += queueing_cycles;
+    return ticksToCycles(arrival - now);
+}
+
+void
+AnalyticalNetwork::wakeup()
+{
+    const Tick now = clockEdge();
+    bool stalled = false;
+
+    updateUtilization();
+
+    for (NodeID src = 0; src < m_nodes; src++) {
+        for (int vnet = 0; vnet < m_toNetQueues[src].size(); vnet++) {
+            MessageBuffer *buffer = m_toNetQueues[src][vnet];
+            while (buffer != nullptr && buffer->isReady(now)) {
+                const MsgPtr &msg = buffer->peekMsgPtr();
+                const std::vector<NodeID> dests =
+                    msg->getDestination().getAllDest();
+
+                // Only send the message once all destinations can
+                // take it
+                bool space = true;
+                for (NodeID dest : dests) {
+                    space = space && m_fromNetQueues[dest][vnet]->
+                        areNSlotsAvailable(1, now);
+                }
+                if (!space) {
+                    stalled = true;
+                    break;
+                }
+
+                const int bytes =
+                    MessageSizeType_to_int(msg->getMessageSize());
+                for (NodeID dest : dests) {
+                    MsgPtr copy = msg;
+                    if (dests.size() > 1) {
+                        // Each destination gets its own copy, which only
+                        // lists that destination
+                        copy = msg->clone();
+                        copy->getDestination().clear();
+                        copy->getDestination().add(m_machines[dest]);
+                    }
+
+                    m_total_latency += deliver(src, dest, vnet, copy,
+                                               bytes, now);
+                    m_messages++;
+                }
+
+                buffer->dequeue(now);
+            }
+        }
+    }
+
+    // Retry once the destinations have made room
+    if (stalled)
+        scheduleEvent(Cycles(1));
+}
+
+void
+AnalyticalNetwork::regStats()
+{
+    Network::regStats();
+
+    m_messages
+        .name(name() + ".messages")
+        .desc("Number of messages delivered")
+        ;
+    m_total_latency
+        .name(name() + ".total_latency")
+        .desc("Total network latency of the messages, in cycles")
+        ;
+    m_total_queueing_latency
+        .name(name() + ".total_queueing_latency")
+        .desc("Total estimated queueing latency of the messages, in cycles")
+        ;
+
+    m_avg_latency
+        .name(name() + ".average_latency")
+        .desc("Average network latency of the messages, in cycles")
+        ;
+    m_avg_latency = m_total_latency / m_messages;
+
+    m_avg_queueing_latency
+        .name(name() + ".average_queueing_latency")
+        .desc("Average estimated queueing latency, in cycles")
+        ;
+    m_avg_queueing_latency = m_total_queueing_latency / m_messages;
+}
+
+void
+AnalyticalNetwork::print(std::ostream& out) const
+{
+    out << "[AnalyticalNetwork]";
+}
+
+AnalyticalNetwork *
+AnalyticalNetworkParams::create()
+{
+    return new AnalyticalNetwork(this);
+}
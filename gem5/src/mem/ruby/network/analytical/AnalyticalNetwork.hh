@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * A network that doesn't model the routers and links, but computes
+ * the latency of each message from its path through the topology.
+ *
+ * The latency of a message is the sum of the latencies of the links
+ * and routers on its path, the serialization latency at the link with
+ * the least bandwidth (as in a cut-through network), and an estimate of
+ * the queueing delay at each link. The queueing delay is the waiting
+ * time of an M/D/1 queue whose utilization is the one the link had
+ * during the last epoch. The message is then enqueued directly in the
+ * destination buffer, so that it is delivered with a single event.
+ */
+
+#ifndef __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+#define __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
+
+#include <iostream>
+#include <vector>
+
+#include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/common/NetDest.hh"
+#include "mem/ruby/network/Network.hh"
+#include "params/AnalyticalNetwork.hh"
+
+class AnalyticalNetwork : public Network, public Consumer
+{
+  public:
+    typedef AnalyticalNetworkParams Params;
+    AnalyticalNetwork(const Params *p);
+
+    void init() override;
+
+    void wakeup() override;
+
+    void collateStats() override {}
+    void regStats() override;
+
+    bool isVNetOrdered(int vnet) const { return m_ordered[vnet]; }
+
+    // Methods used by Topology to setup the network
+    void makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
+                     const NetDest& routing_table_entry) override;
+    void makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
+                    const NetDest& routing_table_entry) override;
+    void makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
+                          const NetDest& routing_table_entry,
+                          PortDirection src_outport,
+                          PortDirection dst_inport) override;
+
+    void print(std::ostream& out) const override;
+
+    // The messages in flight are in the buffers of the destinations
+    bool functionalRead(Packet *pkt) override { return false; }
+    uint32_t functionalWrite(Packet *pkt) override { return 0; }
+
+  private:
+    /** A unidirectional link. */
+    struct Link
+    {
+        Cycles latency;
+        //! Bytes per cycle
+        int bandwidth;
+        //! Bytes sent since the start of the epoch
+        uint64_t bytes;
+        //! Utilization of the link during the last epoch
+        double utilization;
+    };
+
+    /** An output link of a switch. */
+    struct Route
+    {
+        int link;
+        //! Switch at the other end, or -1 for an external link
+        int next_switch;
+        int weight;
+        NetDest destinations;
+    };
+
+    int addLink(BasicLink *link);
+
+    /** Compute the path and static latency between all nodes. */
+    void computePaths();
+
+    /** Update the link utilizations if the epoch is over. */
+    void updateUtilization();
+
+    /**
+     * Send a copy of a message to one of its destinations.
+     *
+     * @return The latency of the message in cycles.
+     */
+    Cycles deliver(NodeID src, NodeID dest, int vnet, const MsgPtr &msg,
+                   int bytes, Tick now);
+
+    const Cycles m_epoch;
+    const double m_max_utilization;
+
+    std::vector<Link> m_links;
+    std::vector<Cycles> m_router_latency;
+    std::vector<std::vector<Route>> m_routes;
+
+    //! Machine of each node
+    std::vector<MachineID> m_machines;
+
+    // Link from each node to its switch, and that switch
+    std::vector<int> m_ext_in_link;
+    std::vector<int> m_ext_in_switch;
+
+    // The links of the path from node src to node dest are
+    // m_path_links[m_path_offset[src * m_nodes + dest]] up to the
+    // next offset
+    std::vector<int> m_path_offset;
+    std::vector<int> m_path_links;
+    std::vector<Cycles> m_path_latency;
+
+    //! Last arrival time at each [dest][vnet] buffer, for ordered vnets
+    std::vector<std::vector<Tick>> m_last_arrival;
+
+    Cycles m_epoch_start;
+
+    Stats::Scalar m_messages;
+    Stats::Scalar m_total_latency;
+    Stats::Scalar m_total_queueing_latency;
+    Stats::Formula m_avg_latency;
+    Stats::Formula m_avg_queueing_latency;
+};
+
+inline std::ostream&
+operator<<(std::ostream& out, const AnalyticalNetwork& obj)
+{
+    obj.print(out);
+    out << std::flush;
+    return out;
+}
+
+#endif // __MEM_RUBY_NETWORK_ANALYTICAL_ANALYTICALNETWORK_HH__
@@ -43,9 +43,15 @@ enum VC_state_type {IDLE_, VC_AB_, ACTIVE_, NUM_VC_STATE_TYPE_};
 enum VNET_type {CTRL_VNET_, DATA_VNET_, NULL_VNET_, NUM_VNET_TYPE_};
 enum flit_stage {I_, VA_, SA_, ST_, LT_, NUM_FLIT_STAGE_};
 enum link_type { EXT_IN_, EXT_OUT_, INT_, NUM_LINK_TYPES_ };
-enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2,
+enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2, ADAPTIVE_ = 3,
                         NUM_ROUTING_ALGORITHM_};
 
+// Ids of the port directions used by the built-in routing algorithms.
+// Other directions of a topology get the following ids
+// (see RoutingUnit::directionId()).
+enum PortDirectionId { LOCAL_DIRN_ = 0, NORTH_DIRN_, SOUTH_DIRN_, EAST_DIRN_,
+                       WEST_DIRN_, NUM_FIXED_DIRN_ };
+
 struct RouteInfo
 {
     // destination format for table-based routing
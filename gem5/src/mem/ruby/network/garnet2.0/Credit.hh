@@ -35,8 +35,10 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_CREDIT_HH__
 
 #include <cassert>
+#include <cstddef>
 #include <iostream>
 
+#include "base/pool_allocator.hh"
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
@@ -53,6 +55,23 @@ class Credit : public flit
 
     bool is_free_signal() { return m_is_free_signal; }
 
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(Credit))
+            return ::operator new(size);
+        return PoolAllocator<Credit>().allocate(1);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(Credit))
+            ::operator delete(p);
+        else
+            PoolAllocator<Credit>().deallocate(static_cast<Credit *>(p), 1);
+    }
+
   private:
     bool m_is_free_signal;
 };
@@ -56,6 +56,17 @@ class GarnetIntLink(BasicIntLink):
     network_link = Param.NetworkLink(NetworkLink(), "forward link")
     credit_link  = Param.CreditLink(CreditLink(), "backward flow-control link")
 
+    # Each link is serviced on the event queue of the router that feeds
+    # it, and hands the flits (credits) to the other router with the
+    # link latency
+    def lookaheadLinks(self):
+        latency = int(self.latency) * \
+            min(self.src_node.clk_domain.clockPeriod(),
+                self.dst_node.clk_domain.clockPeriod())
+        return [(self.src_node, self.network_link, None),
+                (self.dst_node, self.credit_link, None),
+                (self.src_node, self.dst_node, latency)]
+
 # Exterior fixed pipeline links between a router and a controller
 class GarnetExtLink(BasicExtLink):
     type = 'GarnetExtLink'
@@ -77,3 +88,14 @@ class GarnetExtLink(BasicExtLink):
     # Out uni-directional link
     _cls.append(CreditLink());
     credit_links = VectorParam.CreditLink(_cls, "backward flow-control links")
+
+    # The network interfaces deliver messages a cycle after they arrive.
+    # The links out of the router are serviced on its event queue, the
+    # ones out of the network interface on the queue of the network
+    # (see GarnetNetwork.lookaheadLinks).
+    def lookaheadLinks(self):
+        latency = min(self.ext_node.clk_domain.clockPeriod(),
+                      self.int_node.clk_domain.clockPeriod())
+        return [(self.ext_node, self.int_node, latency),
+                (self.int_node, self.network_links[1], None),
+                (self.int_node, self.credit_links[0], None)]
@@ -35,7 +35,9 @@
 
 #include <cassert>
 
+#include "base/callback.hh"
 #include "base/cast.hh"
+#include "base/output.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
@@ -46,10 +48,26 @@
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
 
+namespace {
+
+// Layout version of the sample file, see util/garnet_samples.py
+const uint32_t SAMPLE_FILE_VERSION = 1;
+const char SAMPLE_FILE_MAGIC[8] = { 'G', 'A', 'R', 'N', 'E', 'T', 'T', 'S' };
+
+template <typename T>
+void
+writeRaw(ostream &os, const T &value)
+{
+    os.write(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+} // anonymous namespace
+
 /*
  * GarnetNetwork sets up the routers and links and collects stats.
  * Default parameters (GarnetNetwork.py) can be overwritten from command line
@@ -57,7 +75,9 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p)
+    : Network(p), m_sample_interval(p->sample_interval),
+      m_sample_file(nullptr),
+      m_sample_event([this]{ sample(); }, name() + ".sample")
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -65,6 +85,11 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    m_partitioned = p->partitioned;
+
+    // The counters are sampled from the event queue of the network
+    fatal_if(m_partitioned && m_sample_interval != 0, "%s: a partitioned "
+             "network can't be sampled", name());
 
     m_enable_fault_model = p->enable_fault_model;
     if (m_enable_fault_model)
@@ -112,6 +137,25 @@ GarnetNetwork::init()
     assert(m_topology_ptr != NULL);
     m_topology_ptr->createLinks(this);
 
+    // The interfaces update the statistics of the network as they go,
+    // so they have to be on its event queue. The controllers talk to
+    // the interfaces through message buffers, and the routers of a
+    // partitioned network talk to each other through links that hand
+    // the flits over to the event queue of the consumer, so those can
+    // be on other event queues. Each link has to be on the event queue
+    // of the object that feeds it (see make*Link()).
+    for (auto router : m_routers) {
+        fatal_if(!m_partitioned && router->eventQueue() != eventQueue(),
+                 "Garnet router %s must be on the event queue of the "
+                 "network unless the network is partitioned",
+                 router->name());
+    }
+    for (auto ni : m_nis) {
+        fatal_if(ni->eventQueue() != eventQueue(), "Garnet network "
+                 "interface %s must be on the event queue of the network",
+                 ni->name());
+    }
+
     // Initialize topology specific parameters
     if (getNumRows() > 0) {
         // Only for Mesh topology
@@ -141,10 +185,27 @@ GarnetNetwork::init()
             router->printFaultVector(cout);
         }
     }
+
+    if (m_sample_interval != 0) {
+        m_sample_file = simout.create(params()->sample_file, true);
+        writeSampleHeader();
+        registerExitCallback(new MakeCallback<GarnetNetwork,
+                             &GarnetNetwork::closeSampleFile>(this, true));
+    }
+}
+
+void
+GarnetNetwork::startup()
+{
+    Network::startup();
+
+    if (m_sample_interval != 0)
+        schedule(m_sample_event, clockEdge(m_sample_interval));
 }
 
 GarnetNetwork::~GarnetNetwork()
 {
+    closeSampleFile();
     deletePointers(m_routers);
     deletePointers(m_nis);
     deletePointers(m_networklinks);
@@ -173,6 +234,9 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    checkLinkQueue(net_link, m_nis[src]);
+    checkLinkQueue(credit_link, m_routers[dest]);
+    m_link_ends.push_back(LinkEnds{(int)src, (int)dest});
 
     PortDirection dst_inport_dirn = "Local";
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
@@ -202,6 +266,9 @@ GarnetNetwork::makeExtOutLink(SwitchID src, NodeID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    checkLinkQueue(net_link, m_routers[src]);
+    checkLinkQueue(credit_link, m_nis[dest]);
+    m_link_ends.push_back(LinkEnds{(int)src, (int)dest});
 
     PortDirection src_outport_dirn = "Local";
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
@@ -230,6 +297,9 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
 
     m_networklinks.push_back(net_link);
     m_creditlinks.push_back(credit_link);
+    checkLinkQueue(net_link, m_routers[src]);
+    checkLinkQueue(credit_link, m_routers[dest]);
+    m_link_ends.push_back(LinkEnds{(int)src, (int)dest});
 
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
@@ -237,6 +307,88 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
                                link->m_weight, credit_link);
 }
 
+void
+GarnetNetwork::checkLinkQueue(NetworkLink *link,
+                              ClockedObject *source) const
+{
+    fatal_if(link->eventQueue() != source->eventQueue(), "Garnet link %s "
+             "must be on the event queue of %s", link->name(),
+             source->name());
+}
+
+/*
+ * The sample file starts with a header describing the network:
+ *   magic (8 bytes), version (uint32), sample interval in ticks (uint64),
+ *   number of rows (int32, -1 if not a mesh), number of routers and
+ *   number of flit links (uint32), then the type (uint32, see
+ *   link_type), source and destination (int32) of each link.
+ * Each sample then holds, in host byte order:
+ *   tick (uint64), the flits sent over each link since the previous
+ *   sample (uint32 per link), then the crossbar traversals since the
+ *   previous sample and the flits buffered at sample time (uint32 each)
+ *   of each router.
+ */
+
+void
+GarnetNetwork::writeSampleHeader()
+{
+    ostream &os = *m_sample_file->stream();
+
+    os.write(SAMPLE_FILE_MAGIC, sizeof(SAMPLE_FILE_MAGIC));
+    writeRaw(os, SAMPLE_FILE_VERSION);
+    writeRaw(os, (uint64_t)cyclesToTicks(m_sample_interval));
+    writeRaw(os, (int32_t)m_num_rows);
+    writeRaw(os, (uint32_t)m_routers.size());
+    writeRaw(os, (uint32_t)m_networklinks.size());
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        writeRaw(os, (uint32_t)m_networklinks[i]->getType());
+        writeRaw(os, (int32_t)m_link_ends[i].src);
+        writeRaw(os, (int32_t)m_link_ends[i].dst);
+    }
+
+    m_last_link_flits.assign(m_networklinks.size(), 0);
+    m_last_crossbar_activity.assign(m_routers.size(), 0);
+}
+
+void
+GarnetNetwork::sample()
+{
+    // The counters restart from zero when the stats are reset
+    vector<uint32_t> record;
+    record.reserve(m_networklinks.size() + 2 * m_routers.size());
+
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        const unsigned int flits = m_networklinks[i]->getLinkUtilization();
+        const unsigned int last = m_last_link_flits[i];
+        record.push_back(flits >= last ? flits - last : flits);
+        m_last_link_flits[i] = flits;
+    }
+
+    for (int i = 0; i < m_routers.size(); i++) {
+        const double activity = m_routers[i]->get_crossbar_activity();
+        const double last = m_last_crossbar_activity[i];
+        record.push_back(activity >= last ? activity - last : activity);
+        record.push_back(m_routers[i]->get_num_buffered_flits());
+        m_last_crossbar_activity[i] = activity;
+    }
+
+    ostream &os = *m_sample_file->stream();
+    writeRaw(os, (uint64_t)curTick());
+    os.write(reinterpret_cast<const char *>(record.data()),
+             record.size() * sizeof(uint32_t));
+
+    schedule(m_sample_event, clockEdge(m_sample_interval));
+}
+
+void
+GarnetNetwork::closeSampleFile()
+{
+    if (m_sample_file) {
+        simout.close(m_sample_file);
+        m_sample_file = nullptr;
+    }
+}
+
 // Total routers in the network
 int
 GarnetNetwork::getNumRouters()
@@ -41,8 +41,10 @@
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "params/GarnetNetwork.hh"
+#include "sim/eventq.hh"
 
 class FaultModel;
+class OutputStream;
 class NetworkInterface;
 class Router;
 class NetDest;
@@ -55,8 +57,15 @@ class GarnetNetwork : public Network
     typedef GarnetNetworkParams Params;
     GarnetNetwork(const Params *p);
 
+    const Params *
+    params() const
+    {
+        return static_cast<const Params *>(_params);
+    }
+
     ~GarnetNetwork();
     void init();
+    void startup() override;
 
     // Configuration (set externally)
 
@@ -72,6 +81,7 @@ class GarnetNetwork : public Network
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
+    bool isPartitioned() const { return m_partitioned; }
     FaultModel* fault_model;
 
 
@@ -153,6 +163,7 @@ class GarnetNetwork : public Network
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
     bool m_enable_fault_model;
+    bool m_partitioned;
 
     // Statistical variables
     Stats::Vector m_packets_received;
@@ -190,6 +201,31 @@ class GarnetNetwork : public Network
     GarnetNetwork(const GarnetNetwork& obj);
     GarnetNetwork& operator=(const GarnetNetwork& obj);
 
+    // A link is serviced with the object that feeds it
+    void checkLinkQueue(NetworkLink *link, ClockedObject *source) const;
+
+    // Append the activity of the links and routers since the last
+    // sample to the time series, see GarnetNetwork.sample_interval
+    void sample();
+    void writeSampleHeader();
+    void closeSampleFile();
+
+    // Ends of the flit links, indexed like m_networklinks. These are
+    // router ids, or node ids for the network interface end of the
+    // external links.
+    struct LinkEnds
+    {
+        int src;
+        int dst;
+    };
+
+    Cycles m_sample_interval;
+    OutputStream *m_sample_file;
+    EventFunctionWrapper m_sample_event;
+    std::vector<LinkEnds> m_link_ends;
+    std::vector<unsigned int> m_last_link_flits;
+    std::vector<double> m_last_crossbar_activity;
+
     std::vector<VNET_type > m_vnet_type;
     std::vector<Router *> m_routers;   // All Routers in Network
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
@@ -43,11 +43,37 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        "0: Weight-based Table, 1: XY, 2: Custom, 3: Adaptive (Mesh)");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold")
+    partitioned = Param.Bool(False, "let the routers be on other event "
+                             "queues than the network interfaces")
+    sample_interval = Param.Cycles(0, "interval at which the activity of "
+        "the links and routers is sampled to sample_file, 0 to disable")
+    sample_file = Param.String("garnet_samples.bin",
+        "time series of the link and router activity, in the output "
+        "directory (see util/garnet_samples.py)")
+
+    # The network interfaces, and the statistics they update, stay on
+    # the event queue of the network. Unless the network is partitioned,
+    # so do the routers (see GarnetNetwork::init()). Otherwise, the
+    # routers and the links they feed can be cut from the rest of the
+    # network at the links between them, with the link latency as
+    # lookahead.
+    def lookaheadLinks(self):
+        if not self.partitioned:
+            return [(self, router, None) for router in self.routers]
+
+        links = [(self, ni, None) for ni in self.netifs]
+        for link in self.ext_links:
+            latency = int(link.latency) * \
+                link.int_node.clk_domain.clockPeriod()
+            links += [(self, link.int_node, latency),
+                      (self, link.network_links[0], None),
+                      (self, link.credit_links[1], None)]
+        return links
 
 class GarnetNetworkInterface(ClockedObject):
     type = 'GarnetNetworkInterface'
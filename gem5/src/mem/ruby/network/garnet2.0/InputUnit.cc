@@ -33,6 +33,7 @@
 
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
 
+#include "base/logging.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
@@ -42,12 +43,14 @@ using namespace std;
 using m5::stl_helpers::deletePointers;
 
 InputUnit::InputUnit(int id, PortDirection direction, Router *router)
-            : Consumer(router)
+            : Consumer(router), m_num_buffered(0), m_occupied_vcs(0)
 {
     m_id = id;
     m_direction = direction;
     m_router = router;
     m_num_vcs = m_router->get_num_vcs();
+    fatal_if(m_num_vcs > 64, "Garnet supports at most 64 VCs per port, "
+             "%d requested", m_num_vcs);
     m_vc_per_vnet = m_router->get_vc_per_vnet();
 
     m_num_buffer_reads.resize(m_num_vcs/m_vc_per_vnet);
@@ -98,8 +101,7 @@ InputUnit::wakeup()
             set_vc_active(vc, m_router->curCycle());
 
             // Route computation for this vc
-            int outport = m_router->route_compute(t_flit->get_route(),
-                m_id, m_direction);
+            int outport = m_router->route_compute(t_flit->get_route(), m_id);
 
             // Update output port in VC
             // All flits in this packet will use this output port
@@ -113,6 +115,8 @@ InputUnit::wakeup()
 
         // Buffer the flit
         m_vcs[vc]->insertFlit(t_flit);
+        m_num_buffered++;
+        m_occupied_vcs |= 1ULL << vc;
 
         int vnet = vc/m_vc_per_vnet;
         // number of writes same as reads
@@ -109,9 +109,21 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return m_vcs[vc]->getTopFlit();
+        assert(m_num_buffered > 0);
+        m_num_buffered--;
+        flit *t_flit = m_vcs[vc]->getTopFlit();
+        if (m_vcs[vc]->isEmpty())
+            m_occupied_vcs &= ~(1ULL << vc);
+        return t_flit;
     }
 
+    // Whether any VC of this port holds a flit, the switch allocator
+    // skips the ports that don't
+    inline bool has_buffered_flits() const { return m_num_buffered > 0; }
+    inline int get_num_buffered() const { return m_num_buffered; }
+    // Bitmask of the VCs holding at least one flit
+    inline uint64_t get_occupied_vcs() const { return m_occupied_vcs; }
+
     inline bool
     need_stage(int vc, flit_stage stage, Cycles time)
     {
@@ -161,6 +173,9 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel *> m_vcs;
+    // Number of flits buffered across all the VCs
+    int m_num_buffered;
+    uint64_t m_occupied_vcs;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
@@ -127,6 +127,13 @@ NetworkInterface::addNode(vector<MessageBuffer *>& in,
             it->setConsumer(this);
         }
     }
+
+    // Messages are handed to the protocol a cycle after they arrive
+    for (auto& it : out) {
+        if (it != nullptr) {
+            it->setProducer(this, cyclesToTicks(Cycles(1)));
+        }
+    }
 }
 
 void
@@ -33,14 +33,17 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
+#include "base/logging.hh"
+#include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
+#include "sim/lookahead.hh"
 
 NetworkLink::NetworkLink(const Params *p)
     : ClockedObject(p), Consumer(this), m_id(p->link_id),
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
+      link_srcQueue(nullptr), m_cross_queue(false), m_link_utilized(0),
       m_vc_load(p->vcs_per_vnet * p->virt_nets)
 {
 }
@@ -62,16 +65,54 @@ NetworkLink::setSourceQueue(flitBuffer *srcQueue)
     link_srcQueue = srcQueue;
 }
 
+void
+NetworkLink::startup()
+{
+    ClockedObject::startup();
+
+    if (link_consumer == nullptr ||
+        link_consumer->consumerEventQueue() == eventQueue()) {
+        return;
+    }
+
+    fatal_if(m_latency == 0, "Garnet link %s connects two event queues "
+             "without latency", name());
+
+    DPRINTF(RubyNetwork, "Link %s crosses from event queue %s to %s\n",
+            name(), eventQueue()->name(),
+            link_consumer->consumerEventQueue()->name());
+
+    m_cross_queue = true;
+    if (lookaheadSync) {
+        registerLookahead(eventQueue(), link_consumer->consumerEventQueue(),
+                          cyclesToTicks(m_latency));
+    }
+}
+
 void
 NetworkLink::wakeup()
 {
     if (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
+
+        if (m_cross_queue) {
+            // Deliver the flit before the consumer wakes up on the
+            // same tick
+            Consumer *consumer = link_consumer;
+            flitBuffer *buffer = linkBuffer;
+            consumer->consumerEventQueue()->scheduleOneShot(
+                [consumer, buffer, t_flit] {
+                    buffer->insert(t_flit);
+                    consumer->scheduleEventAbsolute(curTick());
+                }, clockEdge(m_latency), Event::Delayed_Writeback_Pri);
+            return;
+        }
+
+        linkBuffer->insert(t_flit);
+        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
     }
 }
 
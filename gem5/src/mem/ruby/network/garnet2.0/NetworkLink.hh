@@ -58,6 +58,7 @@ class NetworkLink : public ClockedObject, public Consumer
     link_type getType() { return m_type; }
     void print(std::ostream& out) const {}
     int get_id() const { return m_id; }
+    void startup() override;
     void wakeup();
 
     unsigned int getLinkUtilization() const { return m_link_utilized; }
@@ -81,6 +82,12 @@ class NetworkLink : public ClockedObject, public Consumer
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
 
+    // Whether the consumer is on another event queue. The link is
+    // serviced on the queue of its source, so the flits are then handed
+    // to the consumer's queue when they arrive, and linkBuffer is only
+    // accessed from there.
+    bool m_cross_queue;
+
     // Statistical variables
     unsigned int m_link_utilized;
     std::vector<unsigned int> m_vc_load;
@@ -77,6 +77,7 @@ Router::init()
 {
     BasicRouter::init();
 
+    m_routing_unit->init();
     m_sw_alloc->init();
     m_switch->init();
 }
@@ -159,9 +160,9 @@ Router::getInportDirection(int inport)
 }
 
 int
-Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
+Router::route_compute(const RouteInfo &route, int inport)
 {
-    return m_routing_unit->outportCompute(route, inport, inport_dirn);
+    return m_routing_unit->outportCompute(route, inport);
 }
 
 void
@@ -233,6 +234,21 @@ Router::collateStats()
     m_crossbar_activity = m_switch->get_crossbar_activity();
 }
 
+double
+Router::get_crossbar_activity() const
+{
+    return m_switch->get_crossbar_activity();
+}
+
+int
+Router::get_num_buffered_flits() const
+{
+    int num_flits = 0;
+    for (auto input_unit : m_input_unit)
+        num_flits += input_unit->get_num_buffered();
+    return num_flits;
+}
+
 void
 Router::resetStats()
 {
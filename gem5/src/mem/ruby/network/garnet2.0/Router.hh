@@ -87,11 +87,15 @@ class Router : public BasicRouter, public Consumer
 
     GarnetNetwork* get_net_ptr()                    { return m_network_ptr; }
     std::vector<InputUnit *>& get_inputUnit_ref()   { return m_input_unit; }
+
+    // Activity counters sampled by the network
+    double get_crossbar_activity() const;
+    int get_num_buffered_flits() const;
     std::vector<OutputUnit *>& get_outputUnit_ref() { return m_output_unit; }
     PortDirection getOutportDirection(int outport);
     PortDirection getInportDirection(int inport);
 
-    int route_compute(RouteInfo route, int inport, PortDirection direction);
+    int route_compute(const RouteInfo &route, int inport);
     void grant_switch(int inport, flit *t_flit);
     void schedule_wakeup(Cycles time);
 
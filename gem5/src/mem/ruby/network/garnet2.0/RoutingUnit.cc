@@ -33,13 +33,17 @@
 
 #include "mem/ruby/network/garnet2.0/RoutingUnit.hh"
 
+#include <algorithm>
+
 #include "base/cast.hh"
 #include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
 RoutingUnit::RoutingUnit(Router *router)
+    : m_use_own_random(false)
 {
     m_router = router;
     m_routing_table.clear();
@@ -58,6 +62,53 @@ RoutingUnit::addWeight(int link_weight)
     m_weight_table.push_back(link_weight);
 }
 
+/*
+ * The routing table is compiled into a list of candidate output links
+ * per destination when the router is initialized, so that routing a
+ * packet doesn't have to intersect the NetDest of every link.
+ */
+
+void
+RoutingUnit::init()
+{
+    if (m_router->get_net_ptr()->isPartitioned()) {
+        m_use_own_random = true;
+        m_random.init(m_router->get_id());
+    }
+
+    const int num_dests = MachineType_base_number(MachineType_NUM);
+    std::vector<std::vector<NodeID>> link_dests(m_routing_table.size());
+
+    // Identify the minimum weight of the links towards each destination
+    m_dest_weight.assign(num_dests, INFINITE_);
+    for (int link = 0; link < m_routing_table.size(); link++) {
+        link_dests[link] = m_routing_table[link].getAllDest();
+        for (NodeID dest : link_dests[link]) {
+            m_dest_weight[dest] = std::min(m_dest_weight[dest],
+                                           m_weight_table[link]);
+        }
+    }
+
+    // Collect the links with this minimum weight, in link order
+    std::vector<std::vector<int>> candidates(num_dests);
+    for (int link = 0; link < m_routing_table.size(); link++) {
+        for (NodeID dest : link_dests[link]) {
+            if (m_weight_table[link] == m_dest_weight[dest])
+                candidates[dest].push_back(link);
+        }
+    }
+
+    m_dest_offset.resize(num_dests + 1);
+    m_dest_outports.clear();
+    for (int dest = 0; dest < num_dests; dest++) {
+        m_dest_offset[dest] = m_dest_outports.size();
+        m_dest_outports.insert(m_dest_outports.end(),
+                               candidates[dest].begin(),
+                               candidates[dest].end());
+    }
+    m_dest_offset[num_dests] = m_dest_outports.size();
+}
+
 /*
  * This is the default routing algorithm in garnet.
  * The routing table is populated during topology creation.
@@ -66,7 +117,7 @@ RoutingUnit::addWeight(int link_weight)
  */
 
 int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+RoutingUnit::lookupRoutingTable(int vnet, NodeID dest_ni)
 {
     // First find all possible output link candidates
     // For ordered vnet, just choose the first
@@ -75,30 +126,54 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     // To have a strict ordering between links, they should be given
     // different weights in the topology file
 
-    int output_link = -1;
-    int min_weight = INFINITE_;
-    std::vector<int> output_link_candidates;
-    int num_candidates = 0;
+    const int first = m_dest_offset[dest_ni];
+    const int num_candidates = m_dest_offset[dest_ni + 1] - first;
 
-    // Identify the minimum weight among the candidate output links
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-        if (m_weight_table[link] <= min_weight)
-            min_weight = m_weight_table[link];
-        }
+    if (num_candidates == 0) {
+        fatal("Fatal Error:: No Route exists from this Router.");
+        exit(0);
     }
 
-    // Collect all candidate output links with this minimum weight
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
+    // Randomly select any candidate output link
+    int candidate = 0;
+    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
+        candidate = randomCandidate(num_candidates);
 
-            if (m_weight_table[link] == min_weight) {
+    return m_dest_outports[first + candidate];
+}
 
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
-        }
+/*
+ * Lookup for a destination set that may contain several nodes. The
+ * candidates are the links with the minimum weight among all links
+ * towards any of the destinations.
+ */
+
+int
+RoutingUnit::lookupRoutingTable(int vnet, const NetDest &net_dest)
+{
+    const std::vector<NodeID> dests = net_dest.getAllDest();
+    if (dests.size() == 1)
+        return lookupRoutingTable(vnet, dests[0]);
+
+    int min_weight = INFINITE_;
+    for (NodeID dest : dests)
+        min_weight = std::min(min_weight, m_dest_weight[dest]);
+
+    // A link with the minimum weight towards any destination has the
+    // minimum weight towards that destination as well, so it is one
+    // of its candidates
+    std::vector<bool> is_candidate(m_routing_table.size(), false);
+    for (NodeID dest : dests) {
+        if (m_dest_weight[dest] != min_weight)
+            continue;
+        for (int i = m_dest_offset[dest]; i < m_dest_offset[dest + 1]; i++)
+            is_candidate[m_dest_outports[i]] = true;
+    }
+
+    std::vector<int> output_link_candidates;
+    for (int link = 0; link < is_candidate.size(); link++) {
+        if (is_candidate[link])
+            output_link_candidates.push_back(link);
     }
 
     if (output_link_candidates.size() == 0) {
@@ -109,25 +184,81 @@ RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
     // Randomly select any candidate output link
     int candidate = 0;
     if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+        candidate = randomCandidate(output_link_candidates.size());
 
-    output_link = output_link_candidates.at(candidate);
-    return output_link;
+    return output_link_candidates.at(candidate);
 }
 
+int
+RoutingUnit::randomCandidate(int n)
+{
+    if (m_use_own_random)
+        return m_random.random<int>(0, n - 1);
+    return rand() % n;
+}
+
+int
+RoutingUnit::directionId(const PortDirection &dirn)
+{
+    // Ids of the directions used by the built-in algorithms are fixed,
+    // others are numbered in the order they are first seen
+    static std::vector<PortDirection> dirns =
+        { "Local", "North", "South", "East", "West" };
+
+    auto it = std::find(dirns.begin(), dirns.end(), dirn);
+    if (it != dirns.end())
+        return it - dirns.begin();
+
+    dirns.push_back(dirn);
+    return dirns.size() - 1;
+}
 
 void
 RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
 {
-    m_inports_dirn2idx[inport_dirn] = inport_idx;
-    m_inports_idx2dirn[inport_idx]  = inport_dirn;
+    const int dirn = directionId(inport_dirn);
+    if (dirn >= m_inports_dirn2idx.size())
+        m_inports_dirn2idx.resize(dirn + 1, -1);
+    if (inport_idx >= m_inports_idx2dirn.size())
+        m_inports_idx2dirn.resize(inport_idx + 1, -1);
+
+    m_inports_dirn2idx[dirn] = inport_idx;
+    m_inports_idx2dirn[inport_idx] = dirn;
 }
 
 void
 RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 {
-    m_outports_dirn2idx[outport_dirn] = outport_idx;
-    m_outports_idx2dirn[outport_idx]  = outport_dirn;
+    const int dirn = directionId(outport_dirn);
+    if (dirn >= m_outports_dirn2idx.size())
+        m_outports_dirn2idx.resize(dirn + 1, -1);
+    if (outport_idx >= m_outports_idx2dirn.size())
+        m_outports_idx2dirn.resize(outport_idx + 1, -1);
+
+    m_outports_dirn2idx[dirn] = outport_idx;
+    m_outports_idx2dirn[outport_idx] = dirn;
+}
+
+int
+RoutingUnit::outportInDirection(int dirn)
+{
+    panic_if(dirn >= m_outports_dirn2idx.size() ||
+             m_outports_dirn2idx[dirn] == -1,
+             "Router %d has no outport in direction %d",
+             m_router->get_id(), dirn);
+    return m_outports_dirn2idx[dirn];
+}
+
+int
+RoutingUnit::freeCredits(int outport, int vnet)
+{
+    OutputUnit *output_unit = m_router->get_outputUnit_ref()[outport];
+    const int vc_per_vnet = m_router->get_vc_per_vnet();
+
+    int credits = 0;
+    for (int vc = vnet * vc_per_vnet; vc < (vnet + 1) * vc_per_vnet; vc++)
+        credits += output_unit->get_credit_count(vc);
+    return credits;
 }
 
 // outportCompute() is called by the InputUnit
@@ -137,20 +268,24 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 // table is provided here.
 
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
-                            PortDirection inport_dirn)
+RoutingUnit::outportCompute(const RouteInfo &route, int inport)
 {
     int outport = -1;
 
+    // Garnet splits multicast messages into one packet per destination
+    // NI, so the route is looked up by destination NI rather than by
+    // route.net_dest.
     if (route.dest_router == m_router->get_id()) {
 
         // Multiple NIs may be connected to this router,
         // all with output port direction = "Local"
         // Get exact outport id from table
-        outport = lookupRoutingTable(route.vnet, route.net_dest);
+        outport = lookupRoutingTable(route.vnet, route.dest_ni);
         return outport;
     }
 
+    const int inport_dirn = m_inports_idx2dirn[inport];
+
     // Routing Algorithm set in GarnetNetwork.py
     // Can be over-ridden from command line using --routing-algorithm = 1
     RoutingAlgorithm routing_algorithm =
@@ -158,14 +293,16 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 
     switch (routing_algorithm) {
         case TABLE_:  outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
         case XY_:     outport =
             outportComputeXY(route, inport, inport_dirn); break;
+        case ADAPTIVE_: outport =
+            outportComputeAdaptive(route, inport, inport_dirn); break;
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
         default: outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
     }
 
     assert(outport != -1);
@@ -176,11 +313,11 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 // Only for reference purpose in a Mesh
 // By default Garnet uses the routing table
 int
-RoutingUnit::outportComputeXY(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo &route,
                               int inport,
-                              PortDirection inport_dirn)
+                              int inport_dirn)
 {
-    PortDirection outport_dirn = "Unknown";
+    int outport_dirn = -1;
 
     int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
     int num_cols = m_router->get_net_ptr()->getNumCols();
@@ -205,21 +342,21 @@ RoutingUnit::outportComputeXY(RouteInfo route,
 
     if (x_hops > 0) {
         if (x_dirn) {
-            assert(inport_dirn == "Local" || inport_dirn == "West");
-            outport_dirn = "East";
+            assert(inport_dirn == LOCAL_DIRN_ || inport_dirn == WEST_DIRN_);
+            outport_dirn = EAST_DIRN_;
         } else {
-            assert(inport_dirn == "Local" || inport_dirn == "East");
-            outport_dirn = "West";
+            assert(inport_dirn == LOCAL_DIRN_ || inport_dirn == EAST_DIRN_);
+            outport_dirn = WEST_DIRN_;
         }
     } else if (y_hops > 0) {
         if (y_dirn) {
             // "Local" or "South" or "West" or "East"
-            assert(inport_dirn != "North");
-            outport_dirn = "North";
+            assert(inport_dirn != NORTH_DIRN_);
+            outport_dirn = NORTH_DIRN_;
         } else {
             // "Local" or "North" or "West" or "East"
-            assert(inport_dirn != "South");
-            outport_dirn = "South";
+            assert(inport_dirn != SOUTH_DIRN_);
+            outport_dirn = SOUTH_DIRN_;
         }
     } else {
         // x_hops == 0 and y_hops == 0
@@ -228,15 +365,64 @@ RoutingUnit::outportComputeXY(RouteInfo route,
         panic("x_hops == y_hops == 0");
     }
 
-    return m_outports_dirn2idx[outport_dirn];
+    return outportInDirection(outport_dirn);
+}
+
+// Minimal adaptive routing for a Mesh, using the west-first turn
+// model to avoid deadlocks: packets that have to go west do so
+// first. Otherwise, the packet may go towards the destination in
+// either dimension, and takes the outport with the most free credits
+// in its vnet. Ties go to the X dimension, as in XY routing.
+int
+RoutingUnit::outportComputeAdaptive(const RouteInfo &route,
+                                    int inport,
+                                    int inport_dirn)
+{
+    int M5_VAR_USED num_rows = m_router->get_net_ptr()->getNumRows();
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_rows > 0 && num_cols > 0);
+
+    int my_id = m_router->get_id();
+    int my_x = my_id % num_cols;
+    int my_y = my_id / num_cols;
+
+    int dest_id = route.dest_router;
+    int dest_x = dest_id % num_cols;
+    int dest_y = dest_id / num_cols;
+
+    // already checked that in outportCompute() function
+    assert(!(dest_x == my_x && dest_y == my_y));
+
+    if (dest_x < my_x) {
+        assert(inport_dirn == LOCAL_DIRN_ || inport_dirn == EAST_DIRN_);
+        return outportInDirection(WEST_DIRN_);
+    }
+
+    int x_outport = -1;
+    if (dest_x > my_x)
+        x_outport = outportInDirection(EAST_DIRN_);
+
+    int y_outport = -1;
+    if (dest_y > my_y)
+        y_outport = outportInDirection(NORTH_DIRN_);
+    else if (dest_y < my_y)
+        y_outport = outportInDirection(SOUTH_DIRN_);
+
+    if (x_outport == -1)
+        return y_outport;
+    if (y_outport == -1)
+        return x_outport;
+
+    return freeCredits(y_outport, route.vnet) >
+        freeCredits(x_outport, route.vnet) ? y_outport : x_outport;
 }
 
 // Template for implementing custom routing algorithm
 // using port directions. (Example adaptive)
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo &route,
                                  int inport,
-                                 PortDirection inport_dirn)
+                                 int inport_dirn)
 {
     panic("%s placeholder executed", __FUNCTION__);
 }
@@ -34,6 +34,9 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 
+#include <vector>
+
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -47,43 +50,78 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
-    int outportCompute(RouteInfo route,
-                      int inport,
-                      PortDirection inport_dirn);
+
+    // Compile the routing table, once all ports have been added
+    void init();
+
+    int outportCompute(const RouteInfo &route, int inport);
 
     // Topology-agnostic Routing Table based routing (default)
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
     // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    int  lookupRoutingTable(int vnet, NodeID dest_ni);
+    int  lookupRoutingTable(int vnet, const NetDest &net_dest);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
     void addOutDirection(PortDirection outport_dirn, int outport);
 
+    // Integer id of a port direction, see PortDirectionId
+    static int directionId(const PortDirection &dirn);
+
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo &route,
                          int inport,
-                         PortDirection inport_dirn);
+                         int inport_dirn);
+
+    // Minimal adaptive (west-first) routing for Mesh
+    int outportComputeAdaptive(const RouteInfo &route,
+                               int inport,
+                               int inport_dirn);
 
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo &route,
                              int inport,
-                             PortDirection inport_dirn);
+                             int inport_dirn);
 
   private:
+    // Outport in the given direction, which has to exist
+    int outportInDirection(int dirn);
+
+    // Free credits of the VCs of a vnet at an outport
+    int freeCredits(int outport, int vnet);
+
+    // Random choice among n candidate outports
+    int randomCandidate(int n);
+
     Router *m_router;
 
+    // Per-router generator used instead of rand() when the routers of
+    // a partitioned network are on different event queues, which keeps
+    // the routes independent of the order the queues run in
+    bool m_use_own_random;
+    Random m_random;
+
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
 
-    // Inport and Outport direction to idx maps
-    std::map<PortDirection, int> m_inports_dirn2idx;
-    std::map<int, PortDirection> m_inports_idx2dirn;
-    std::map<int, PortDirection> m_outports_idx2dirn;
-    std::map<PortDirection, int> m_outports_dirn2idx;
+    // Compiled routing table. The candidate outports for destination
+    // d, i.e. the links with the minimum weight towards d, are
+    // m_dest_outports[m_dest_offset[d]] to
+    // m_dest_outports[m_dest_offset[d + 1] - 1], in increasing order.
+    std::vector<int> m_dest_weight;
+    std::vector<int> m_dest_offset;
+    std::vector<int> m_dest_outports;
+
+    // Inport and Outport direction id to idx maps, -1 if there
+    // is no port in a direction
+    std::vector<int> m_inports_dirn2idx;
+    std::vector<int> m_inports_idx2dirn;
+    std::vector<int> m_outports_idx2dirn;
+    std::vector<int> m_outports_dirn2idx;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
@@ -33,6 +33,10 @@
 
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
 
+#include <algorithm>
+
+#include "base/bitfield.hh"
+#include "base/logging.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
@@ -48,6 +52,7 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_retry = false;
 }
 
 void
@@ -58,9 +63,13 @@ SwitchAllocator::init()
 
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
+    fatal_if(m_num_inports > 64, "Garnet supports at most 64 input ports "
+             "per router, router %d has %d", m_router->get_id(),
+             m_num_inports);
+
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
-    m_port_requests.resize(m_num_outports);
+    m_port_requests.resize(m_num_outports, 0);
     m_vc_winners.resize(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
@@ -68,14 +77,9 @@ SwitchAllocator::init()
     }
 
     for (int i = 0; i < m_num_outports; i++) {
-        m_port_requests[i].resize(m_num_inports);
         m_vc_winners[i].resize(m_num_inports);
 
         m_round_robin_inport[i] = 0;
-
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false; // [outport][inport]
-        }
     }
 }
 
@@ -85,12 +89,16 @@ SwitchAllocator::init()
  * output VC is assigned to the winning flits of each output port.
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
- * next cycle for peforming SA for any flits ready next cycle.
+ * next cycle if a flit left in SA can make progress then. Flits that
+ * wait for a credit or a free VC don't keep the router awake, the
+ * credit wakes it up when it arrives.
  */
 
 void
 SwitchAllocator::wakeup()
 {
+    m_retry = false;
+
     arbitrate_inports(); // First stage of allocation
     arbitrate_outports(); // Second stage of allocation
 
@@ -114,12 +122,24 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
+        // Only the VCs holding a flit can be in SA. Visit them starting
+        // from the round robin pointer: first the VCs at or above it,
+        // then the ones below it.
+        const uint64_t occupied = m_input_unit[inport]->get_occupied_vcs();
+        if (occupied == 0)
+            continue;
+
+        const uint64_t above = ~0ULL << m_round_robin_invc[inport];
+        const uint64_t order[2] = { occupied & above, occupied & ~above };
 
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        bool requested = false;
+        for (int half = 0; half < 2 && !requested; half++) {
+            for (uint64_t vcs = order[half]; vcs != 0; vcs &= vcs - 1) {
+                const int invc = findLsbSet(vcs);
 
-            if (m_input_unit[inport]->need_stage(invc, SA_,
-                m_router->curCycle())) {
+                if (!m_input_unit[inport]->need_stage(invc, SA_,
+                    m_router->curCycle()))
+                    continue;
 
                 // This flit is in SA stage
 
@@ -128,26 +148,26 @@ SwitchAllocator::arbitrate_inports()
 
                 // check if the flit in this InputVC is allowed to be sent
                 // send_allowed conditions described in that function.
-                bool make_request =
-                    send_allowed(inport, invc, outport, outvc);
+                if (!send_allowed(inport, invc, outport, outvc))
+                    continue;
 
-                if (make_request) {
-                    m_input_arbiter_activity++;
-                    m_port_requests[outport][inport] = true;
-                    m_vc_winners[outport][inport]= invc;
+                m_input_arbiter_activity++;
+                m_port_requests[outport] |= 1ULL << inport;
+                m_vc_winners[outport][inport]= invc;
 
-                    // Update Round Robin pointer to the next VC
-                    m_round_robin_invc[inport] = invc + 1;
-                    if (m_round_robin_invc[inport] >= m_num_vcs)
-                        m_round_robin_invc[inport] = 0;
+                // The other flits of the port may be able to go
+                // next cycle
+                if (m_input_unit[inport]->get_num_buffered() > 1)
+                    m_retry = true;
 
-                    break; // got one vc winner for this port
-                }
-            }
+                // Update Round Robin pointer to the next VC
+                m_round_robin_invc[inport] = invc + 1;
+                if (m_round_robin_invc[inport] >= m_num_vcs)
+                    m_round_robin_invc[inport] = 0;
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+                requested = true; // got one vc winner for this port
+                break;
+            }
         }
     }
 }
@@ -173,96 +193,96 @@ SwitchAllocator::arbitrate_outports()
     // Again do round robin arbitration on these requests
     // Independent arbiter at each output port
     for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_inport[outport];
-
-        for (int inport_iter = 0; inport_iter < m_num_inports;
-                 inport_iter++) {
-
-            // inport has a request this cycle for outport
-            if (m_port_requests[outport][inport]) {
-
-                // grant this outport to this inport
-                int invc = m_vc_winners[outport][inport];
-
-                int outvc = m_input_unit[inport]->get_outvc(invc);
-                if (outvc == -1) {
-                    // VC Allocation - select any free VC from outport
-                    outvc = vc_allocate(outport, inport, invc);
-                }
-
-                // remove flit from Input VC
-                flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
-
-                DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
-                                     "granted outvc %d at outport %d "
-                                     "to invc %d at inport %d to flit %s at "
-                                     "time: %lld\n",
-                        m_router->get_id(), outvc,
-                        m_router->getPortDirectionName(
-                            m_output_unit[outport]->get_direction()),
-                        invc,
-                        m_router->getPortDirectionName(
-                            m_input_unit[inport]->get_direction()),
-                            *t_flit,
-                        m_router->curCycle());
-
-
-                // Update outport field in the flit since this is
-                // used by CrossbarSwitch code to send it out of
-                // correct outport.
-                // Note: post route compute in InputUnit,
-                // outport is updated in VC, but not in flit
-                t_flit->set_outport(outport);
-
-                // set outvc (i.e., invc for next hop) in flit
-                // (This was updated in VC by vc_allocate, but not in flit)
-                t_flit->set_vc(outvc);
-
-                // decrement credit in outvc
-                m_output_unit[outport]->decrement_credit(outvc);
-
-                // flit ready for Switch Traversal
-                t_flit->advance_stage(ST_, m_router->curCycle());
-                m_router->grant_switch(inport, t_flit);
-                m_output_arbiter_activity++;
-
-                if ((t_flit->get_type() == TAIL_) ||
-                    t_flit->get_type() == HEAD_TAIL_) {
-
-                    // This Input VC should now be empty
-                    assert(!(m_input_unit[inport]->isReady(invc,
-                        m_router->curCycle())));
-
-                    // Free this VC
-                    m_input_unit[inport]->set_vc_idle(invc,
-                        m_router->curCycle());
-
-                    // Send a credit back
-                    // along with the information that this VC is now idle
-                    m_input_unit[inport]->increment_credit(invc, true,
-                        m_router->curCycle());
-                } else {
-                    // Send a credit back
-                    // but do not indicate that the VC is idle
-                    m_input_unit[inport]->increment_credit(invc, false,
-                        m_router->curCycle());
-                }
-
-                // remove this request
-                m_port_requests[outport][inport] = false;
-
-                // Update Round Robin pointer
-                m_round_robin_inport[outport] = inport + 1;
-                if (m_round_robin_inport[outport] >= m_num_inports)
-                    m_round_robin_inport[outport] = 0;
-
-                break; // got a input winner for this outport
-            }
+        const uint64_t requests = m_port_requests[outport];
+
+        // No input requested this outport
+        if (requests == 0)
+            continue;
+
+        // The inputs that lose arbitration retry next cycle
+        if (requests & (requests - 1))
+            m_retry = true;
 
-            inport++;
-            if (inport >= m_num_inports)
-                inport = 0;
+        // The winner is the first requesting inport at or after the
+        // round robin pointer, wrapping around
+        const uint64_t above =
+            requests & (~0ULL << m_round_robin_inport[outport]);
+        const int inport = findLsbSet(above != 0 ? above : requests);
+
+        // grant this outport to this inport
+        int invc = m_vc_winners[outport][inport];
+
+        int outvc = m_input_unit[inport]->get_outvc(invc);
+        if (outvc == -1) {
+            // VC Allocation - select any free VC from outport
+            outvc = vc_allocate(outport, inport, invc);
         }
+
+        // remove flit from Input VC
+        flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
+
+        DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
+                             "granted outvc %d at outport %d "
+                             "to invc %d at inport %d to flit %s at "
+                             "time: %lld\n",
+                m_router->get_id(), outvc,
+                m_router->getPortDirectionName(
+                    m_output_unit[outport]->get_direction()),
+                invc,
+                m_router->getPortDirectionName(
+                    m_input_unit[inport]->get_direction()),
+                    *t_flit,
+                m_router->curCycle());
+
+
+        // Update outport field in the flit since this is
+        // used by CrossbarSwitch code to send it out of
+        // correct outport.
+        // Note: post route compute in InputUnit,
+        // outport is updated in VC, but not in flit
+        t_flit->set_outport(outport);
+
+        // set outvc (i.e., invc for next hop) in flit
+        // (This was updated in VC by vc_allocate, but not in flit)
+        t_flit->set_vc(outvc);
+
+        // decrement credit in outvc
+        m_output_unit[outport]->decrement_credit(outvc);
+
+        // flit ready for Switch Traversal
+        t_flit->advance_stage(ST_, m_router->curCycle());
+        m_router->grant_switch(inport, t_flit);
+        m_output_arbiter_activity++;
+
+        if ((t_flit->get_type() == TAIL_) ||
+            t_flit->get_type() == HEAD_TAIL_) {
+
+            // This Input VC should now be empty
+            assert(!(m_input_unit[inport]->isReady(invc,
+                m_router->curCycle())));
+
+            // Free this VC
+            m_input_unit[inport]->set_vc_idle(invc,
+                m_router->curCycle());
+
+            // Send a credit back
+            // along with the information that this VC is now idle
+            m_input_unit[inport]->increment_credit(invc, true,
+                m_router->curCycle());
+        } else {
+            // Send a credit back
+            // but do not indicate that the VC is idle
+            m_input_unit[inport]->increment_credit(invc, false,
+                m_router->curCycle());
+        }
+
+        // remove this request
+        m_port_requests[outport] &= ~(1ULL << inport);
+
+        // Update Round Robin pointer
+        m_round_robin_inport[outport] = inport + 1;
+        if (m_round_robin_inport[outport] >= m_num_inports)
+            m_round_robin_inport[outport] = 0;
     }
 }
 
@@ -329,6 +349,8 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
                (m_input_unit[inport]->get_outport(temp_vc) == outport) &&
                (m_input_unit[inport]->get_enqueue_time(temp_vc) <
                     t_enqueue_time)) {
+                // May be unblocked by the older flit leaving
+                m_retry = true;
                 return false;
             }
         }
@@ -350,16 +372,21 @@ SwitchAllocator::vc_allocate(int outport, int inport, int invc)
     return outvc;
 }
 
-// Wakeup the router next cycle to perform SA again
-// if there are flits ready.
+// Wakeup the router next cycle to perform SA again if there are
+// flits ready that don't wait for a credit.
 void
 SwitchAllocator::check_for_wakeup()
 {
+    if (!m_retry)
+        return;
+
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
-            if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
+        for (uint64_t vcs = m_input_unit[i]->get_occupied_vcs(); vcs != 0;
+             vcs &= vcs - 1) {
+            if (m_input_unit[i]->need_stage(findLsbSet(vcs), SA_,
+                                            nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
             }
@@ -381,11 +408,7 @@ SwitchAllocator::get_vnet(int invc)
 void
 SwitchAllocator::clear_request_vector()
 {
-    for (int i = 0; i < m_num_outports; i++) {
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false;
-        }
-    }
+    std::fill(m_port_requests.begin(), m_port_requests.end(), 0);
 }
 
 void
@@ -81,7 +81,11 @@ class SwitchAllocator : public Consumer
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
-    std::vector<std::vector<bool>> m_port_requests;
+    // Bitmask of the inports requesting each outport
+    std::vector<uint64_t> m_port_requests;
+    // Whether a flit that can make progress without a credit
+    // arriving is left waiting for SA after this cycle
+    bool m_retry;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
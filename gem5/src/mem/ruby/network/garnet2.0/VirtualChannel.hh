@@ -62,6 +62,8 @@ class VirtualChannel
         return m_input_buffer->isReady(curTime);
     }
 
+    inline bool isEmpty() { return m_input_buffer->isEmpty(); }
+
     inline void
     insertFlit(flit *t_flit)
     {
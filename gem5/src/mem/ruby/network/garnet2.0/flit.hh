@@ -35,8 +35,10 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_FLIT_HH__
 
 #include <cassert>
+#include <cstddef>
 #include <iostream>
 
+#include "base/pool_allocator.hh"
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
@@ -56,7 +58,7 @@ class flit
     Cycles get_time() { return m_time; }
     int get_vnet() { return m_vnet; }
     int get_vc() { return m_vc; }
-    RouteInfo get_route() { return m_route; }
+    const RouteInfo &get_route() const { return m_route; }
     MsgPtr& get_msg_ptr() { return m_msg_ptr; }
     flit_type get_type() { return m_type; }
     std::pair<flit_stage, Cycles> get_stage() { return m_stage; }
@@ -99,6 +101,28 @@ class flit
 
     bool functionalWrite(Packet *pkt);
 
+    /**
+     * Every packet allocates and frees a few flits and credits, so
+     * they are recycled through a per-thread pool. Objects of derived
+     * classes that don't have their own pool use the global heap.
+     */
+    static void *
+    operator new(std::size_t size)
+    {
+        if (size != sizeof(flit))
+            return ::operator new(size);
+        return PoolAllocator<flit>().allocate(1);
+    }
+
+    static void
+    operator delete(void *p, std::size_t size)
+    {
+        if (size != sizeof(flit))
+            ::operator delete(p);
+        else
+            PoolAllocator<flit>().deallocate(static_cast<flit *>(p), 1);
+    }
+
   protected:
     int m_id;
     int m_vnet;
@@ -34,11 +34,13 @@
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 
 flitBuffer::flitBuffer()
+    : m_head(0), m_count(0)
 {
     max_size = INFINITE_;
 }
 
 flitBuffer::flitBuffer(int maximum_size)
+    : m_head(0), m_count(0)
 {
     max_size = maximum_size;
 }
@@ -46,13 +48,13 @@ flitBuffer::flitBuffer(int maximum_size)
 bool
 flitBuffer::isEmpty()
 {
-    return (m_buffer.size() == 0);
+    return (getSize() == 0);
 }
 
 bool
 flitBuffer::isReady(Cycles curTime)
 {
-    if (m_buffer.size() != 0 ) {
+    if (getSize() != 0 ) {
         flit *t_flit = peekTopFlit();
         if (t_flit->get_time() <= curTime)
             return true;
@@ -63,13 +65,13 @@ flitBuffer::isReady(Cycles curTime)
 void
 flitBuffer::print(std::ostream& out) const
 {
-    out << "[flitBuffer: " << m_buffer.size() << "] " << std::endl;
+    out << "[flitBuffer: " << getSize() << "] " << std::endl;
 }
 
 bool
 flitBuffer::isFull()
 {
-    return (m_buffer.size() >= max_size);
+    return (getSize() >= max_size);
 }
 
 void
@@ -83,11 +85,39 @@ flitBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    for (unsigned int i = 0; i < m_buffer.size(); ++i) {
-        if (m_buffer[i]->functionalWrite(pkt)) {
+    for (std::size_t i = 0; i < m_count; ++i) {
+        if (m_ring[(m_head + i) & (m_ring.size() - 1)]->functionalWrite(pkt)) {
+            num_functional_writes++;
+        }
+    }
+
+    for (unsigned int i = 0; i < m_heap.size(); ++i) {
+        if (m_heap[i]->functionalWrite(pkt)) {
             num_functional_writes++;
         }
     }
 
     return num_functional_writes;
 }
+
+void
+flitBuffer::growRing()
+{
+    std::vector<flit *> ring(m_ring.empty() ? 4 : 2 * m_ring.size());
+    for (std::size_t i = 0; i < m_count; ++i)
+        ring[i] = m_ring[(m_head + i) & (m_ring.size() - 1)];
+
+    m_ring.swap(ring);
+    m_head = 0;
+}
+
+void
+flitBuffer::moveRingToHeap()
+{
+    // A sorted array already is a valid heap
+    for (std::size_t i = 0; i < m_count; ++i)
+        m_heap.push_back(m_ring[(m_head + i) & (m_ring.size() - 1)]);
+
+    m_head = 0;
+    m_count = 0;
+}
@@ -35,12 +35,22 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_FLITBUFFER_HH__
 
 #include <algorithm>
+#include <cassert>
+#include <cstddef>
 #include <iostream>
 #include <vector>
 
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
+/**
+ * Buffer of flits ordered by time, then by flit id.
+ *
+ * Most buffers receive their flits in order, so they are kept in a
+ * FIFO ring. When a flit arrives that is older than the youngest one
+ * in the ring, the contents are moved to a binary heap which is used
+ * until the buffer drains.
+ */
 class flitBuffer
 {
   public:
@@ -52,34 +62,72 @@ class flitBuffer
     void print(std::ostream& out) const;
     bool isFull();
     void setMaxSize(int maximum);
-    int getSize() const { return m_buffer.size(); }
+    int getSize() const { return m_count + m_heap.size(); }
 
     flit *
     getTopFlit()
     {
-        flit *f = m_buffer.front();
-        std::pop_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
-        m_buffer.pop_back();
+        if (!m_heap.empty()) {
+            flit *f = m_heap.front();
+            std::pop_heap(m_heap.begin(), m_heap.end(), flit::greater);
+            m_heap.pop_back();
+            return f;
+        }
+
+        assert(m_count > 0);
+        flit *f = m_ring[m_head];
+        m_head = (m_head + 1) & (m_ring.size() - 1);
+        m_count--;
         return f;
     }
 
     flit *
     peekTopFlit()
     {
-        return m_buffer.front();
+        return m_heap.empty() ? m_ring[m_head] : m_heap.front();
     }
 
     void
     insert(flit *flt)
     {
-        m_buffer.push_back(flt);
-        std::push_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
+        if (m_heap.empty()) {
+            if (m_count == 0 || !flit::greater(ringBack(), flt)) {
+                if (m_count == m_ring.size())
+                    growRing();
+                m_ring[(m_head + m_count) & (m_ring.size() - 1)] = flt;
+                m_count++;
+                return;
+            }
+            moveRingToHeap();
+        }
+
+        m_heap.push_back(flt);
+        std::push_heap(m_heap.begin(), m_heap.end(), flit::greater);
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    std::vector<flit *> m_buffer;
+    flit *
+    ringBack() const
+    {
+        return m_ring[(m_head + m_count - 1) & (m_ring.size() - 1)];
+    }
+
+    /** Double the ring capacity, which is kept a power of two. */
+    void growRing();
+
+    /** Move the (sorted) ring contents to the heap. */
+    void moveRingToHeap();
+
+    /** In order flits, the capacity is zero or a power of two. */
+    std::vector<flit *> m_ring;
+    std::size_t m_head;
+    std::size_t m_count;
+
+    /** Used instead of the ring after an out of order insertion. */
+    std::vector<flit *> m_heap;
+
     int max_size;
 };
 
@@ -30,6 +30,7 @@
 
 #include <algorithm>
 
+#include "base/bitfield.hh"
 #include "base/cast.hh"
 #include "base/random.hh"
 #include "debug/RubyNetwork.hh"
@@ -55,6 +56,10 @@ PerfectSwitch::PerfectSwitch(SwitchID sid, Switch *sw, uint32_t virt_nets)
     m_round_robin_start = 0;
     m_wakeups_wo_switch = 0;
     m_virtual_networks = virt_nets;
+    m_link_order_identity = true;
+
+    m_pending_port_count.resize(m_virtual_networks);
+    m_pending_ports.resize(m_virtual_networks);
 }
 
 void
@@ -73,6 +78,12 @@ PerfectSwitch::addInPort(const vector<MessageBuffer*>& in)
     NodeID port = m_in.size();
     m_in.push_back(in);
 
+    for (int i = 0; i < m_virtual_networks; ++i) {
+        m_pending_port_count[i].push_back(0);
+        if (port % 64 == 0)
+            m_pending_ports[i].push_back(0);
+    }
+
     for (int i = 0; i < in.size(); ++i) {
         if (in[i] != nullptr) {
             in[i]->setConsumer(this);
@@ -112,27 +123,38 @@ PerfectSwitch::operateVnet(int vnet)
     }
 
     if (m_pending_message_count[vnet] > 0) {
-        // for all input ports, use round robin scheduling
-        for (int counter = 0; counter < m_in.size(); counter++) {
-            // Round robin scheduling
-            incoming++;
-            if (incoming >= m_in.size()) {
-                incoming = 0;
-            }
-
-            // Is there a message waiting?
-            if (m_in[incoming].size() <= vnet) {
-                continue;
-            }
+        // for all input ports with pending messages, use round robin
+        // scheduling starting after the previous start
+        int first = incoming + 1;
+        if (first >= m_in.size()) {
+            first = 0;
+        }
 
-            MessageBuffer *buffer = m_in[incoming][vnet];
-            if (buffer == nullptr) {
-                continue;
-            }
+        for (int port = nextPendingPort(vnet, first); port < m_in.size();
+             port = nextPendingPort(vnet, port + 1)) {
+            operateMessageBuffer(m_in[port][vnet], port, vnet);
+        }
+        for (int port = nextPendingPort(vnet, 0); port < first;
+             port = nextPendingPort(vnet, port + 1)) {
+            operateMessageBuffer(m_in[port][vnet], port, vnet);
+        }
+    }
+}
 
-            operateMessageBuffer(buffer, incoming, vnet);
+int
+PerfectSwitch::nextPendingPort(int vnet, int from) const
+{
+    const vector<uint64_t> &pending = m_pending_ports[vnet];
+    for (int word = from / 64; word < pending.size(); word++) {
+        uint64_t ports = pending[word];
+        if (word == from / 64) {
+            ports &= ~0ULL << (from % 64);
+        }
+        if (ports != 0) {
+            return word * 64 + findLsbSet(ports);
         }
     }
+    return m_in.size();
 }
 
 void
@@ -142,9 +164,9 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
     MsgPtr msg_ptr;
     Message *net_msg_ptr = NULL;
 
-    // temporary vectors to store the routing results
-    vector<LinkID> output_links;
-    vector<NetDest> output_link_destinations;
+    // vectors to store the routing results
+    vector<LinkID> &output_links = m_output_links;
+    vector<NetDest> &output_link_destinations = m_output_link_destinations;
     Tick current_time = m_switch->clockEdge();
 
     while (buffer->isReady(current_time)) {
@@ -169,9 +191,12 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
         if (m_network_ptr->getAdaptiveRouting()) {
             if (m_network_ptr->isVNetOrdered(vnet)) {
                 // Don't adaptively route
-                for (int out = 0; out < m_out.size(); out++) {
-                    m_link_order[out].m_link = out;
-                    m_link_order[out].m_value = 0;
+                if (!m_link_order_identity) {
+                    for (int out = 0; out < m_out.size(); out++) {
+                        m_link_order[out].m_link = out;
+                        m_link_order[out].m_value = 0;
+                    }
+                    m_link_order_identity = true;
                 }
             } else {
                 // Find how clogged each link is
@@ -189,13 +214,14 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
 
                 // Look at the most empty link first
                 sort(m_link_order.begin(), m_link_order.end());
+                m_link_order_identity = false;
             }
         }
 
         for (int i = 0; i < m_routing_table.size(); i++) {
             // pick the next link to look at
             int link = m_link_order[i].m_link;
-            NetDest dst = m_routing_table[link];
+            const NetDest &dst = m_routing_table[link];
             DPRINTF(RubyNetwork, "dst: %s\n", dst);
 
             if (!msg_dsts.intersectionIsNotEmpty(dst))
@@ -255,6 +281,10 @@ PerfectSwitch::operateMessageBuffer(MessageBuffer *buffer, int incoming,
         // Dequeue msg
         buffer->dequeue(current_time);
         m_pending_message_count[vnet]--;
+        if (--m_pending_port_count[vnet][incoming] == 0) {
+            m_pending_ports[vnet][incoming / 64] &=
+                ~(1ULL << (incoming % 64));
+        }
 
         // Enqueue it - for all outgoing queues
         for (int i=0; i<output_links.size(); i++) {
@@ -307,9 +337,12 @@ PerfectSwitch::wakeup()
 }
 
 void
-PerfectSwitch::storeEventInfo(int info)
+PerfectSwitch::storeEventInfo(int vnet, int link)
 {
-    m_pending_message_count[info]++;
+    m_pending_message_count[vnet]++;
+    if (m_pending_port_count[vnet][link]++ == 0) {
+        m_pending_ports[vnet][link / 64] |= 1ULL << (link % 64);
+    }
 }
 
 void
@@ -74,7 +74,7 @@ class PerfectSwitch : public Consumer
     int getOutLinks() const { return m_out.size(); }
 
     void wakeup();
-    void storeEventInfo(int info);
+    void storeEventInfo(int vnet, int link);
 
     void clearStats();
     void collateStats();
@@ -88,6 +88,10 @@ class PerfectSwitch : public Consumer
     void operateVnet(int vnet);
     void operateMessageBuffer(MessageBuffer *b, int incoming, int vnet);
 
+    // First input port at or after from with pending messages in the
+    // vnet, or the number of input ports if there is none
+    int nextPendingPort(int vnet, int from) const;
+
     const SwitchID m_switch_id;
     Switch * const m_switch;
 
@@ -97,6 +101,12 @@ class PerfectSwitch : public Consumer
 
     std::vector<NetDest> m_routing_table;
     std::vector<LinkOrder> m_link_order;
+    // Whether m_link_order lists the links in order
+    bool m_link_order_identity;
+
+    // Routing results, kept to reuse their storage
+    std::vector<LinkID> m_output_links;
+    std::vector<NetDest> m_output_link_destinations;
 
     uint32_t m_virtual_networks;
     int m_round_robin_start;
@@ -104,6 +114,12 @@ class PerfectSwitch : public Consumer
 
     SimpleNetwork* m_network_ptr;
     std::vector<int> m_pending_message_count;
+
+    // Messages in each [vnet][inport] buffer, and a bitmask per vnet
+    // of the input ports that have some, so that a wakeup only has to
+    // look at those
+    std::vector<std::vector<int>> m_pending_port_count;
+    std::vector<std::vector<uint64_t>> m_pending_ports;
 };
 
 inline std::ostream&
@@ -83,6 +83,8 @@ Throttle::addLinks(const vector<MessageBuffer*>& in_vec,
 
         // Set consumer and description
         in_ptr->setConsumer(this);
+        out_ptr->setProducer(m_switch,
+                             m_switch->cyclesToTicks(m_link_latency));
         string desc = "[Queue to Throttle " + to_string(m_switch_id) + " " +
             to_string(m_node) + "]";
     }
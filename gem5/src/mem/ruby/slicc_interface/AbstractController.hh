@@ -119,6 +119,24 @@ class AbstractController : public ClockedObject, public Consumer
     virtual int functionalWrite(const Addr &addr, PacketPtr) = 0;
     int functionalMemoryWrite(PacketPtr);
 
+    //! Install a line recorded in a checkpoint directly in a stable
+    //! state matching the recorded access, without any message. Returns
+    //! false if the controller can't install the line, in which case
+    //! the access is replayed. Protocols support direct warmup by
+    //! defining this function in SLICC.
+    virtual bool
+    installWarmupLine(const Addr &addr, const RubyRequestType &type,
+                      const DataBlock &data)
+    { return false; }
+
+    //! Called on every other controller once a line has been installed
+    //! in the given controller, so that e.g. the directory can record
+    //! the new owner or sharer of the line.
+    virtual void
+    warmupLineInstalled(const Addr &addr, const RubyRequestType &type,
+                        const MachineID &holder)
+    { }
+
     //! Function for enqueuing a prefetch request
     virtual void enqueuePrefetch(const Addr &, const RubyRequestType&)
     { fatal("Prefetches not implemented!");}
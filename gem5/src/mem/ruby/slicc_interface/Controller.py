@@ -71,3 +71,9 @@ class RubyController(ClockedObject):
 
     memory = MasterPort("Port for attaching a memory controller")
     system = Param.System(Parent.any, "system object parameter")
+
+    # The sequencers call into their controller directly
+    def lookaheadLinks(self):
+        from m5.objects.Sequencer import RubyPort
+        return [(self, value, None) for value in self._values.values()
+                if isinstance(value, RubyPort)]
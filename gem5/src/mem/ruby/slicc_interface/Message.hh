@@ -32,7 +32,9 @@
 #include <iostream>
 #include <memory>
 #include <stack>
+#include <utility>
 
+#include "base/pool_allocator.hh"
 #include "mem/packet.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/protocol/MessageSizeType.hh"
@@ -126,6 +128,19 @@ operator>(const MsgPtr &lhs, const MsgPtr &rhs)
     return l->getLastEnqueueTime() > r->getLastEnqueueTime();
 }
 
+/**
+ * Create a message. Messages are created and destroyed at a high rate,
+ * so the storage of each message type, reference count included, is
+ * recycled through a pool instead of going back to the heap.
+ */
+template <class T, class... Args>
+inline std::shared_ptr<T>
+makeMessage(Args&&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
 inline std::ostream&
 operator<<(std::ostream& out, const Message& obj)
 {
@@ -31,7 +31,6 @@
 #define __MEM_RUBY_STRUCTURES_CACHEMEMORY_HH__
 
 #include <string>
-#include <unordered_map>
 #include <vector>
 
 #include "base/statistics.hh"
@@ -55,6 +54,7 @@ class CacheMemory : public SimObject
     ~CacheMemory();
 
     void init();
+    bool threadSafeInit() const override { return true; }
 
     // Public Methods
     // perform a cache access and see if we hit or not.  Return true on a hit.
@@ -160,6 +160,12 @@ class CacheMemory : public SimObject
     int findTagInSet(int64_t line, Addr tag) const;
     int findTagInSetIgnorePermissions(int64_t cacheSet, Addr tag) const;
 
+    // Index of a block in the flat tag and entry arrays
+    size_t blockIndex(int64_t cacheSet, int way) const
+    {
+        return cacheSet * m_cache_assoc + way;
+    }
+
     // Private copy constructor and assignment operator
     CacheMemory(const CacheMemory& obj);
     CacheMemory& operator=(const CacheMemory& obj);
@@ -168,10 +174,26 @@ class CacheMemory : public SimObject
     // Data Members (m_prefix)
     bool m_is_instruction_only_cache;
 
-    // The first index is the # of cache lines.
-    // The second index is the the amount associativity.
-    std::unordered_map<Addr, int> m_tag_index;
-    std::vector<std::vector<AbstractCacheEntry*> > m_cache;
+    /**
+     * Tags and entries of all the blocks, indexed by set * assoc + way.
+     * The tags of a set are contiguous so that a lookup only scans a
+     * few cache lines of the host instead of hashing the address and
+     * chasing a pointer per way. The tag of an unused way is
+     * invalidTag.
+     */
+    std::vector<Addr> m_tags;
+    std::vector<AbstractCacheEntry*> m_entries;
+
+    static const Addr invalidTag = MaxAddr;
+
+    /**
+     * The block found by the last lookup. Protocols typically look the
+     * same line up several times while handling a message, so check it
+     * before scanning the set. It's only a hint: the tag of the block
+     * is compared again before it is used.
+     */
+    mutable Addr m_last_tag;
+    mutable size_t m_last_idx;
 
     AbstractReplacementPolicy *m_replacementPolicy_ptr;
 
@@ -43,7 +43,10 @@
 
 #include "mem/ruby/structures/DirectoryMemory.hh"
 
+#include <algorithm>
+
 #include "base/addr_range.hh"
+#include "base/bitfield.hh"
 #include "base/intmath.hh"
 #include "debug/RubyCache.hh"
 #include "debug/RubyStats.hh"
@@ -54,7 +57,9 @@
 using namespace std;
 
 DirectoryMemory::DirectoryMemory(const Params *p)
-    : SimObject(p), addrRanges(p->addr_ranges.begin(), p->addr_ranges.end())
+    : SimObject(p), m_entries(NULL), m_sparse(p->sparse),
+      m_max_entries(p->max_entries), m_num_allocated(0),
+      addrRanges(p->addr_ranges.begin(), p->addr_ranges.end())
 {
     m_size_bytes = 0;
     for (const auto &r: addrRanges) {
@@ -62,26 +67,106 @@ DirectoryMemory::DirectoryMemory(const Params *p)
     }
     m_size_bits = floorLog2(m_size_bytes);
     m_num_entries = 0;
+
+    for (const auto &perm : p->evictable_permissions)
+        m_evictable.push_back(string_to_AccessPermission(perm));
+    fatal_if(m_max_entries && m_evictable.empty(),
+             "%s: A directory cache needs evictable permissions", name());
 }
 
 void
 DirectoryMemory::init()
 {
     m_num_entries = m_size_bytes / RubySystem::getBlockSizeBytes();
-    m_entries = new AbstractEntry*[m_num_entries];
-    for (int i = 0; i < m_num_entries; i++)
-        m_entries[i] = NULL;
+    if (m_sparse) {
+        m_pages.resize(divCeil(m_num_entries, 1ULL << pageBits), NULL);
+    } else {
+        m_entries = new AbstractEntry*[m_num_entries];
+        for (int i = 0; i < m_num_entries; i++)
+            m_entries[i] = NULL;
+    }
 }
 
 DirectoryMemory::~DirectoryMemory()
 {
     // free up all the directory entries
-    for (uint64_t i = 0; i < m_num_entries; i++) {
-        if (m_entries[i] != NULL) {
-            delete m_entries[i];
+    if (m_sparse) {
+        for (auto page : m_pages) {
+            if (!page)
+                continue;
+            for (uint64_t i = 0; i < (1ULL << pageBits); i++)
+                delete page[i];
+            delete [] page;
+        }
+    } else {
+        for (uint64_t i = 0; i < m_num_entries; i++) {
+            if (m_entries[i] != NULL) {
+                delete m_entries[i];
+            }
+        }
+        delete [] m_entries;
+    }
+}
+
+AbstractEntry **
+DirectoryMemory::findSlot(uint64_t idx) const
+{
+    assert(idx < m_num_entries);
+    if (!m_sparse)
+        return &m_entries[idx];
+
+    AbstractEntry **page = m_pages[idx >> pageBits];
+    return page ? &page[idx & mask(pageBits)] : nullptr;
+}
+
+AbstractEntry *&
+DirectoryMemory::allocateSlot(uint64_t idx)
+{
+    assert(idx < m_num_entries);
+    if (!m_sparse)
+        return m_entries[idx];
+
+    AbstractEntry **&page = m_pages[idx >> pageBits];
+    if (!page) {
+        page = new AbstractEntry*[1ULL << pageBits];
+        std::fill(page, page + (1ULL << pageBits), nullptr);
+    }
+    return page[idx & mask(pageBits)];
+}
+
+void
+DirectoryMemory::touch(uint64_t idx)
+{
+    auto it = m_lru_pos.find(idx);
+    assert(it != m_lru_pos.end());
+    m_lru.splice(m_lru.begin(), m_lru, it->second);
+}
+
+bool
+DirectoryMemory::evict()
+{
+    // Entries that can't be evicted yet are moved to the front so
+    // that the next search doesn't look at them again right away.
+    for (int i = 0; i < maxVictimSearch && !m_lru.empty(); i++) {
+        const uint64_t idx = m_lru.back();
+        AbstractEntry *&slot = *findSlot(idx);
+        const AccessPermission perm = slot->getPermission();
+        if (std::find(m_evictable.begin(), m_evictable.end(), perm) ==
+            m_evictable.end()) {
+            m_lru.splice(m_lru.begin(), m_lru, std::prev(m_lru.end()));
+            continue;
         }
+
+        DPRINTF(RubyCache, "Evicting directory entry %d\n", idx);
+        delete slot;
+        slot = NULL;
+        m_lru.pop_back();
+        m_lru_pos.erase(idx);
+        m_num_allocated--;
+        m_evictions++;
+        return true;
     }
-    delete [] m_entries;
+    return false;
 }
 
 bool
@@ -116,8 +201,12 @@ DirectoryMemory::lookup(Addr address)
     DPRINTF(RubyCache, "Looking up address: %#x\n", address);
 
     uint64_t idx = mapAddressToLocalIdx(address);
-    assert(idx < m_num_entries);
-    return m_entries[idx];
+    AbstractEntry **slot = findSlot(idx);
+    if (!slot || !*slot)
+        return NULL;
+    if (m_max_entries)
+        touch(idx);
+    return *slot;
 }
 
 AbstractEntry*
@@ -128,9 +217,22 @@ DirectoryMemory::allocate(Addr address, AbstractEntry *entry)
     DPRINTF(RubyCache, "Looking up address: %#x\n", address);
 
     idx = mapAddressToLocalIdx(address);
-    assert(idx < m_num_entries);
+    AbstractEntry **slot = findSlot(idx);
+    if (m_max_entries && !(slot && *slot)) {
+        if (m_num_allocated >= m_max_entries && !evict()) {
+            warn_once("%s: No evictable entry in a full directory, "
+                      "exceeding its capacity", name());
+            m_overflows++;
+        }
+        m_lru.push_front(idx);
+        m_lru_pos[idx] = m_lru.begin();
+        m_num_allocated++;
+    } else if (m_max_entries) {
+        touch(idx);
+    }
+
     entry->changePermission(AccessPermission_Read_Only);
-    m_entries[idx] = entry;
+    allocateSlot(idx) = entry;
 
     return entry;
 }
@@ -140,6 +242,25 @@ DirectoryMemory::print(ostream& out) const
 {
 }
 
+void
+DirectoryMemory::regStats()
+{
+    SimObject::regStats();
+
+    m_evictions
+        .name(name() + ".evictions")
+        .desc("Number of entries evicted from the directory cache")
+        .flags(Stats::nozero)
+        ;
+
+    m_overflows
+        .name(name() + ".overflows")
+        .desc("Number of entries allocated in a full directory cache "
+              "without a victim")
+        .flags(Stats::nozero)
+        ;
+}
+
 void
 DirectoryMemory::recordRequestType(DirectoryRequestType requestType) {
     DPRINTF(RubyStats, "Recorded statistic: %s\n",
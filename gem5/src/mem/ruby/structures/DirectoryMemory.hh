@@ -42,9 +42,13 @@
 #define __MEM_RUBY_STRUCTURES_DIRECTORYMEMORY_HH__
 
 #include <iostream>
+#include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "base/addr_range.hh"
+#include "base/statistics.hh"
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/DirectoryRequestType.hh"
 #include "mem/ruby/slicc_interface/AbstractEntry.hh"
@@ -59,6 +63,7 @@ class DirectoryMemory : public SimObject
     ~DirectoryMemory();
 
     void init();
+    bool threadSafeInit() const override { return true; }
 
     /**
      * Return the index in the directory based on an address
@@ -82,14 +87,63 @@ class DirectoryMemory : public SimObject
     void print(std::ostream& out) const;
     void recordRequestType(DirectoryRequestType requestType);
 
+    void regStats() override;
+
   private:
     // Private copy constructor and assignment operator
     DirectoryMemory(const DirectoryMemory& obj);
     DirectoryMemory& operator=(const DirectoryMemory& obj);
 
+    /**
+     * Get the slot of an entry, or nullptr if the page holding it
+     * hasn't been allocated yet.
+     */
+    AbstractEntry **findSlot(uint64_t idx) const;
+
+    /** Get the slot of an entry, allocating its page if needed. */
+    AbstractEntry *&allocateSlot(uint64_t idx);
+
+    /** Mark an entry of the directory cache as most recently used. */
+    void touch(uint64_t idx);
+
+    /**
+     * Make room for a new entry in a full directory cache.
+     *
+     * @return false if no entry could be evicted.
+     */
+    bool evict();
+
   private:
     const std::string m_name;
     AbstractEntry **m_entries;
+
+    /**
+     * In sparse mode, the entries are allocated in pages of
+     * 2^pageBits slots the first time a block of the page is touched.
+     */
+    const bool m_sparse;
+    static const int pageBits = 12;
+    std::vector<AbstractEntry **> m_pages;
+
+    /**
+     * Directory cache. When max_entries is set, the allocated entries
+     * are kept in LRU order (most recently used first) and the least
+     * recently used entry with an evictable permission is deleted when
+     * a new entry doesn't fit. Protocols find a fresh entry the next
+     * time they look the block up, so only entries that are in their
+     * initial state may be evicted.
+     */
+    const uint64_t m_max_entries;
+    std::vector<AccessPermission> m_evictable;
+    uint64_t m_num_allocated;
+    std::list<uint64_t> m_lru;
+    std::unordered_map<uint64_t, std::list<uint64_t>::iterator> m_lru_pos;
+
+    /** Entries looked at before giving up on finding a victim. */
+    static const int maxVictimSearch = 64;
+
+    Stats::Scalar m_evictions;
+    Stats::Scalar m_overflows;
     // int m_size;  // # of memory module blocks this directory is
                     // responsible for
     uint64_t m_size_bytes;
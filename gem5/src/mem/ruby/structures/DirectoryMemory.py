@@ -49,3 +49,16 @@ class RubyDirectoryMemory(SimObject):
     cxx_header = "mem/ruby/structures/DirectoryMemory.hh"
     addr_ranges = VectorParam.AddrRange(
         Parent.addr_ranges, "Address range this directory responds to")
+
+    sparse = Param.Bool(False, "Allocate the directory in pages of "
+                        "entries on first touch instead of reserving an "
+                        "entry for every block up front")
+    max_entries = Param.UInt64(0, "Number of entries the directory can "
+                               "hold, 0 for unbounded. When it's full, "
+                               "allocating an entry evicts the least "
+                               "recently used evictable entry")
+    evictable_permissions = VectorParam.String(["Read_Write"],
+        "Access permissions of the entries that can be evicted. Entries "
+        "with these permissions must be in the state a newly allocated "
+        "entry starts in, since evicted entries are recreated from "
+        "scratch on their next access")
@@ -30,17 +30,33 @@
 #define __MEM_RUBY_STRUCTURES_TBETABLE_HH__
 
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
+#include "base/intmath.hh"
 #include "mem/ruby/common/Address.hh"
 
+/**
+ * Table of the transient buffer entries of a controller.
+ *
+ * All the entries are allocated up front, since the number of TBEs is
+ * a hard bound, so allocating and deallocating a TBE never touches the
+ * heap and the address of an entry stays the same for as long as it
+ * is allocated. Entries are found through an open-addressing index
+ * with linear probing, which is kept at most half full.
+ */
 template<class ENTRY>
 class TBETable
 {
   public:
     TBETable(int number_of_TBEs)
-        : m_number_of_TBEs(number_of_TBEs)
+        : m_entries(number_of_TBEs),
+          m_index(number_of_TBEs > 0 ? 2 << ceilLog2(number_of_TBEs) : 2),
+          m_index_bits(floorLog2(m_index.size())), m_reset_entry(),
+          m_number_of_TBEs(number_of_TBEs)
     {
+        m_free.reserve(number_of_TBEs);
+        for (int i = number_of_TBEs - 1; i >= 0; i--)
+            m_free.push_back(i);
     }
 
     bool isPresent(Addr address) const;
@@ -49,7 +65,7 @@ class TBETable
     bool
     areNSlotsAvailable(int n, Tick current_time) const
     {
-        return (m_number_of_TBEs - m_map.size()) >= n;
+        return m_free.size() >= n;
     }
 
     ENTRY *lookup(Addr address);
@@ -62,8 +78,33 @@ class TBETable
     TBETable(const TBETable& obj);
     TBETable& operator=(const TBETable& obj);
 
+    /** An index bucket, the entry is -1 if the bucket is empty. */
+    struct Bucket
+    {
+        Addr address;
+        int entry;
+
+        Bucket() : address(0), entry(-1) {}
+    };
+
+    /** Home bucket of an address. */
+    size_t
+    hash(Addr address) const
+    {
+        return (address * 0x9e3779b97f4a7c15ULL) >> (64 - m_index_bits);
+    }
+
+    /** Bucket holding the address, or the empty bucket ending its run. */
+    size_t findBucket(Addr address) const;
+
     // Data Members (m_prefix)
-    std::unordered_map<Addr, ENTRY> m_map;
+    std::vector<ENTRY> m_entries;
+    std::vector<int> m_free;
+    std::vector<Bucket> m_index;
+    int m_index_bits;
+
+    /** Value entries are reset to when they are allocated. */
+    const ENTRY m_reset_entry;
 
   private:
     int m_number_of_TBEs;
@@ -78,13 +119,24 @@ operator<<(std::ostream& out, const TBETable<ENTRY>& obj)
     return out;
 }
 
+template<class ENTRY>
+inline size_t
+TBETable<ENTRY>::findBucket(Addr address) const
+{
+    const size_t mask = m_index.size() - 1;
+    size_t i = hash(address);
+    while (m_index[i].entry != -1 && m_index[i].address != address)
+        i = (i + 1) & mask;
+    return i;
+}
+
 template<class ENTRY>
 inline bool
 TBETable<ENTRY>::isPresent(Addr address) const
 {
     assert(address == makeLineAddress(address));
-    assert(m_map.size() <= m_number_of_TBEs);
-    return !!m_map.count(address);
+    assert(m_free.size() <= m_number_of_TBEs);
+    return m_index[findBucket(address)].entry != -1;
 }
 
 template<class ENTRY>
@@ -92,8 +144,14 @@ inline void
 TBETable<ENTRY>::allocate(Addr address)
 {
     assert(!isPresent(address));
-    assert(m_map.size() < m_number_of_TBEs);
-    m_map[address] = ENTRY();
+    assert(!m_free.empty());
+    const int entry = m_free.back();
+    m_free.pop_back();
+    m_entries[entry] = m_reset_entry;
+
+    Bucket &bucket = m_index[findBucket(address)];
+    bucket.address = address;
+    bucket.entry = entry;
 }
 
 template<class ENTRY>
@@ -101,8 +159,23 @@ inline void
 TBETable<ENTRY>::deallocate(Addr address)
 {
     assert(isPresent(address));
-    assert(m_map.size() > 0);
-    m_map.erase(address);
+    assert(m_free.size() < m_number_of_TBEs);
+    size_t hole = findBucket(address);
+    m_free.push_back(m_index[hole].entry);
+
+    // Move back the following buckets of the run that can't be found
+    // from their home bucket anymore once the hole is emptied, so
+    // that lookups don't need tombstones.
+    const size_t mask = m_index.size() - 1;
+    for (size_t i = (hole + 1) & mask; m_index[i].entry != -1;
+         i = (i + 1) & mask) {
+        const size_t home = hash(m_index[i].address);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            m_index[hole] = m_index[i];
+            hole = i;
+        }
+    }
+    m_index[hole].entry = -1;
 }
 
 // looks an address up in the cache
@@ -110,8 +183,8 @@ template<class ENTRY>
 inline ENTRY*
 TBETable<ENTRY>::lookup(Addr address)
 {
-  if (m_map.find(address) != m_map.end()) return &(m_map.find(address)->second);
-  return NULL;
+    const int entry = m_index[findBucket(address)].entry;
+    return entry == -1 ? NULL : &m_entries[entry];
 }
 
 
@@ -30,6 +30,7 @@
 #include "mem/ruby/system/CacheRecorder.hh"
 
 #include "debug/RubyCacheTrace.hh"
+#include "mem/ruby/slicc_interface/AbstractController.hh"
 #include "mem/ruby/system/RubySystem.hh"
 #include "mem/ruby/system/Sequencer.hh"
 
@@ -148,6 +149,52 @@ CacheRecorder::enqueueNextFetchRequest()
     }
 }
 
+uint64_t
+CacheRecorder::installRecords(
+    const std::vector<AbstractController *> &controllers)
+{
+    // Blocks larger than the current ones are split when they are
+    // replayed, leave that to enqueueNextFetchRequest().
+    if (m_block_size_bytes != RubySystem::getBlockSizeBytes()) {
+        return 0;
+    }
+
+    const uint64_t record_size = sizeof(TraceRecord) + m_block_size_bytes;
+    uint64_t kept_size = 0;
+    uint64_t installed = 0;
+    DataBlock data;
+
+    for (uint64_t offset = m_bytes_read; offset < m_uncompressed_trace_size;
+         offset += record_size) {
+        TraceRecord* rec = (TraceRecord*)(m_uncompressed_trace + offset);
+        AbstractController *cntrl = controllers[rec->m_cntrl_id];
+
+        data.setData(rec->m_data, 0, m_block_size_bytes);
+        if (cntrl->installWarmupLine(rec->m_data_address, rec->m_type,
+                                     data)) {
+            DPRINTF(RubyCacheTrace, "Installed %s\n", *rec);
+            for (auto other : controllers) {
+                if (other != cntrl) {
+                    other->warmupLineInstalled(rec->m_data_address,
+                                               rec->m_type,
+                                               cntrl->getMachineID());
+                }
+            }
+            installed++;
+        } else {
+            // Keep the record to replay it
+            if (kept_size != offset - m_bytes_read) {
+                memmove(m_uncompressed_trace + m_bytes_read + kept_size,
+                        rec, record_size);
+            }
+            kept_size += record_size;
+        }
+    }
+
+    m_uncompressed_trace_size = m_bytes_read + kept_size;
+    return installed;
+}
+
 void
 CacheRecorder::addRecord(int cntrl, Addr data_addr, Addr pc_addr,
                          RubyRequestType type, Tick time, DataBlock& data)
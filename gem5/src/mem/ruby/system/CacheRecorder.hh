@@ -43,6 +43,7 @@
 #include "mem/ruby/common/TypeDefines.hh"
 #include "mem/ruby/protocol/RubyRequestType.hh"
 
+class AbstractController;
 class Sequencer;
 
 /*!
@@ -97,6 +98,25 @@ class CacheRecorder
      */
     void enqueueNextFetchRequest();
 
+    /*!
+     * Function for installing the recorded cache contents directly in
+     * the controllers, without simulating any access. The records the
+     * controllers can't install are kept and fetched by subsequent
+     * calls to enqueueNextFetchRequest().
+     *
+     * @param controllers The controllers, indexed like the records.
+     * @return The number of records installed.
+     */
+    uint64_t installRecords(
+        const std::vector<AbstractController *> &controllers);
+
+    //! Whether there are records left to fetch
+    bool
+    hasRecordsToFetch() const
+    {
+        return m_bytes_read < m_uncompressed_trace_size;
+    }
+
   private:
     // Private copy constructor and assignment operator
     CacheRecorder(const CacheRecorder& obj);
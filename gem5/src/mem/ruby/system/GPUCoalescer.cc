@@ -145,6 +145,10 @@ GPUCoalescer::GPUCoalescer(const Params *p)
 
     m_runningGarnetStandalone = p->garnet_standalone;
     assumingRfOCoherence = p->assume_rfo;
+
+    // the number of outstanding requests is bounded, don't rehash
+    m_writeRequestTable.reserve(m_max_outstanding_requests);
+    m_readRequestTable.reserve(m_max_outstanding_requests);
 }
 
 GPUCoalescer::~GPUCoalescer()
@@ -163,31 +167,31 @@ GPUCoalescer::wakeup()
     RequestTable::iterator read = m_readRequestTable.begin();
     RequestTable::iterator read_end = m_readRequestTable.end();
     for (; read != read_end; ++read) {
-        GPUCoalescerRequest* request = read->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
+        const GPUCoalescerRequest &request = read->second;
+        if (current_time - request.issue_time < m_deadlock_threshold)
             continue;
 
         panic("Possible Deadlock detected. Aborting!\n"
              "version: %d request.paddr: 0x%x m_readRequestTable: %d "
              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_readRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time - request->issue_time)*clockPeriod());
+              request.pkt->getAddr(), m_readRequestTable.size(),
+              current_time * clockPeriod(), request.issue_time * clockPeriod(),
+              (current_time - request.issue_time)*clockPeriod());
     }
 
     RequestTable::iterator write = m_writeRequestTable.begin();
     RequestTable::iterator write_end = m_writeRequestTable.end();
     for (; write != write_end; ++write) {
-        GPUCoalescerRequest* request = write->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
+        const GPUCoalescerRequest &request = write->second;
+        if (current_time - request.issue_time < m_deadlock_threshold)
             continue;
 
         panic("Possible Deadlock detected. Aborting!\n"
              "version: %d request.paddr: 0x%x m_writeRequestTable: %d "
              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_writeRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time - request->issue_time) * clockPeriod());
+              request.pkt->getAddr(), m_writeRequestTable.size(),
+              current_time * clockPeriod(), request.issue_time * clockPeriod(),
+              (current_time - request.issue_time) * clockPeriod());
     }
 
     total_outstanding += m_writeRequestTable.size();
@@ -339,31 +343,25 @@ GPUCoalescer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
         (request_type == RubyRequestType_FLUSH)) {
 
         pair<RequestTable::iterator, bool> r =
-          m_writeRequestTable.insert(RequestTable::value_type(line_addr,
-                                       (GPUCoalescerRequest*) NULL));
+            m_writeRequestTable.emplace(line_addr,
+                GPUCoalescerRequest(pkt, request_type, curCycle()));
         if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new GPUCoalescerRequest(pkt, request_type,
-                                                curCycle());
             DPRINTF(GPUCoalescer,
                     "Inserting write request for paddr %#x for type %d\n",
-                    pkt->req->getPaddr(), i->second->m_type);
+                    pkt->req->getPaddr(), r.first->second.m_type);
             m_outstanding_count++;
         } else {
             return true;
         }
     } else {
         pair<RequestTable::iterator, bool> r =
-            m_readRequestTable.insert(RequestTable::value_type(line_addr,
-                                        (GPUCoalescerRequest*) NULL));
+            m_readRequestTable.emplace(line_addr,
+                GPUCoalescerRequest(pkt, request_type, curCycle()));
 
         if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new GPUCoalescerRequest(pkt, request_type,
-                                             curCycle());
             DPRINTF(GPUCoalescer,
                     "Inserting read request for paddr %#x for type %d\n",
-                    pkt->req->getPaddr(), i->second->m_type);
+                    pkt->req->getPaddr(), r.first->second.m_type);
             m_outstanding_count++;
         } else {
             return true;
@@ -495,7 +493,9 @@ GPUCoalescer::writeCallback(Addr address,
 
     RequestTable::iterator i = m_writeRequestTable.find(address);
     assert(i != m_writeRequestTable.end());
-    GPUCoalescerRequest* request = i->second;
+    // the table entry goes away, keep a copy for the callback
+    GPUCoalescerRequest entry = i->second;
+    GPUCoalescerRequest* request = &entry;
 
     m_writeRequestTable.erase(i);
     markRemoved();
@@ -577,7 +577,9 @@ GPUCoalescer::readCallback(Addr address,
     DPRINTF(GPUCoalescer, "read callback for address %#x\n", address);
     RequestTable::iterator i = m_readRequestTable.find(address);
     assert(i != m_readRequestTable.end());
-    GPUCoalescerRequest* request = i->second;
+    // the table entry goes away, keep a copy for the callback
+    GPUCoalescerRequest entry = i->second;
+    GPUCoalescerRequest* request = &entry;
 
     m_readRequestTable.erase(i);
     markRemoved();
@@ -623,11 +625,16 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
     // update the data
     //
     // MUST AD DOING THIS FOR EACH REQUEST IN COALESCER
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::iterator coalesced =
+        reqCoalescer.find(request_line_address);
+    assert(coalesced != reqCoalescer.end());
+    const std::vector<RequestDesc> &requests = coalesced->second;
+    int len = requests.size();
     std::vector<PacketPtr> mylist;
+    mylist.reserve(len);
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(type == reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = requests[i].pkt;
+        assert(type == requests[i].primaryType);
         request_address = pkt->getAddr();
         request_line_address = makeLineAddress(pkt->getAddr());
         if (pkt->getPtr<uint8_t>()) {
@@ -666,9 +673,7 @@ GPUCoalescer::hitCallback(GPUCoalescerRequest* srequest,
 
         mylist.push_back(pkt);
     }
-    delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    eraseCoalescedLine(coalesced);
 
 
 
@@ -681,6 +686,28 @@ GPUCoalescer::empty() const
     return m_writeRequestTable.empty() && m_readRequestTable.empty();
 }
 
+std::vector<RequestDesc> &
+GPUCoalescer::insertCoalescedLine(Addr line_addr)
+{
+    std::vector<RequestDesc> requests;
+    if (!freeRequestLists.empty()) {
+        requests = std::move(freeRequestLists.back());
+        freeRequestLists.pop_back();
+    }
+
+    auto r = reqCoalescer.emplace(line_addr, std::move(requests));
+    assert(r.second);
+    return r.first->second;
+}
+
+void
+GPUCoalescer::eraseCoalescedLine(CoalescingTable::iterator line)
+{
+    line->second.clear();
+    freeRequestLists.push_back(std::move(line->second));
+    reqCoalescer.erase(line);
+}
+
 // Analyzes the packet to see if this request can be coalesced.
 // If request can be coalesced, this request is added to the reqCoalescer table
 // and makeRequest returns RequestStatus_Issued;
@@ -835,33 +862,40 @@ GPUCoalescer::makeRequest(PacketPtr pkt)
 
     // Check if this request can be coalesced with previous
     // requests from this cycle.
-    if (!reqCoalescer.count(line_addr)) {
+    CoalescingTable::iterator coalesced = reqCoalescer.find(line_addr);
+    std::vector<RequestDesc> *requests;
+    if (coalesced == reqCoalescer.end()) {
         // This is the first access to this cache line.
         // A new request to the memory subsystem has to be
         // made in the next cycle for this cache line, so
         // add this line addr to the "newRequests" queue
         newRequests.push_back(line_addr);
+        requests = &insertCoalescedLine(line_addr);
 
     // There was a request to this cache line in this cycle,
     // let us see if we can coalesce this request with the previous
     // requests from this cycle
-    } else if (primary_type !=
-               reqCoalescer[line_addr][0].primaryType) {
-        // can't coalesce loads, stores and atomics!
-        return RequestStatus_Aliased;
-    } else if (pkt->req->isLockedRMW() ||
-               reqCoalescer[line_addr][0].pkt->req->isLockedRMW()) {
-        // can't coalesce locked accesses, but can coalesce atomics!
-        return RequestStatus_Aliased;
-    } else if (pkt->req->hasContextId() && pkt->req->isRelease() &&
-               pkt->req->contextId() !=
-               reqCoalescer[line_addr][0].pkt->req->contextId()) {
-        // can't coalesce releases from different wavefronts
-        return RequestStatus_Aliased;
+    } else {
+        requests = &coalesced->second;
+        const RequestDesc &first = requests->front();
+
+        if (primary_type != first.primaryType) {
+            // can't coalesce loads, stores and atomics!
+            return RequestStatus_Aliased;
+        } else if (pkt->req->isLockedRMW() ||
+                   first.pkt->req->isLockedRMW()) {
+            // can't coalesce locked accesses, but can coalesce atomics!
+            return RequestStatus_Aliased;
+        } else if (pkt->req->hasContextId() && pkt->req->isRelease() &&
+                   pkt->req->contextId() !=
+                   first.pkt->req->contextId()) {
+            // can't coalesce releases from different wavefronts
+            return RequestStatus_Aliased;
+        }
     }
 
     // in addition to the packet, we need to save both request types
-    reqCoalescer[line_addr].emplace_back(pkt, primary_type, secondary_type);
+    requests->emplace_back(pkt, primary_type, secondary_type);
     if (!issueEvent.scheduled())
         schedule(issueEvent, curTick());
     // TODO: issue hardware prefetches here
@@ -903,9 +937,10 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     uint32_t blockSize = RubySystem::getBlockSizeBytes();
     std::vector<bool> accessMask(blockSize,false);
     std::vector< std::pair<int,AtomicOpFunctor*> > atomicOps;
-    uint32_t tableSize = reqCoalescer[line_addr].size();
+    const std::vector<RequestDesc> &requests = reqCoalescer.at(line_addr);
+    uint32_t tableSize = requests.size();
     for (int i = 0; i < tableSize; i++) {
-        PacketPtr tmpPkt = reqCoalescer[line_addr][i].pkt;
+        PacketPtr tmpPkt = requests[i].pkt;
         uint32_t tmpOffset = (tmpPkt->getAddr()) - line_addr;
         uint32_t tmpSize = tmpPkt->getSize();
         if (tmpPkt->isAtomicOp()) {
@@ -922,7 +957,7 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     }
     std::shared_ptr<RubyRequest> msg;
     if (pkt->isAtomicOp()) {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -931,7 +966,7 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
                               dataBlock, atomicOps,
                               accessScope, accessSegment);
     } else {
-        msg = std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
+        msg = makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
                               pkt->getPtr<uint8_t>(),
                               pkt->getSize(), pc, secondary_type,
                               RubyAccessMode_Supervisor, pkt,
@@ -956,16 +991,14 @@ GPUCoalescer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
-std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
+template <class TABLE>
+static void
+printRequestTable(ostream &out, const TABLE &table)
 {
     out << "[";
-    for (auto i = map.begin(); i != map.end(); ++i)
-        out << " " << i->first << "=" << i->second;
+    for (auto i = table.begin(); i != table.end(); ++i)
+        out << " " << i->first << "=" << i->second.m_type;
     out << " ]";
-
-    return out;
 }
 
 void
@@ -973,9 +1006,11 @@ GPUCoalescer::print(ostream& out) const
 {
     out << "[GPUCoalescer: " << m_version
         << ", outstanding requests: " << m_outstanding_count
-        << ", read request table: " << m_readRequestTable
-        << ", write request table: " << m_writeRequestTable
-        << "]";
+        << ", read request table: ";
+    printRequestTable(out, m_readRequestTable);
+    out << ", write request table: ";
+    printRequestTable(out, m_writeRequestTable);
+    out << "]";
 }
 
 // this can be called from setState whenever coherence permissions are
@@ -1006,7 +1041,7 @@ GPUCoalescer::completeIssue()
         // first request for each cacheline, the remaining requests
         // can be coalesced with the first request. So, only
         // one request is issued per cacheline.
-        RequestDesc info = reqCoalescer[newRequests[i]][0];
+        RequestDesc info = reqCoalescer.at(newRequests[i]).front();
         PacketPtr pkt = info.pkt;
         DPRINTF(GPUCoalescer, "Completing for newReq %d: paddr %#x\n",
                 i, pkt->req->getPaddr());
@@ -1060,7 +1095,9 @@ GPUCoalescer::atomicCallback(Addr address,
 
     RequestTable::iterator i = m_writeRequestTable.find(address);
     assert(i != m_writeRequestTable.end());
-    GPUCoalescerRequest* srequest = i->second;
+    // the table entry goes away, keep a copy for the callback
+    GPUCoalescerRequest entry = i->second;
+    GPUCoalescerRequest* srequest = &entry;
 
     m_writeRequestTable.erase(i);
     markRemoved();
@@ -1079,12 +1116,16 @@ GPUCoalescer::atomicCallback(Addr address,
     Addr request_address = pkt->getAddr();
     Addr request_line_address = makeLineAddress(pkt->getAddr());
 
-    int len = reqCoalescer[request_line_address].size();
+    CoalescingTable::iterator coalesced =
+        reqCoalescer.find(request_line_address);
+    assert(coalesced != reqCoalescer.end());
+    const std::vector<RequestDesc> &requests = coalesced->second;
+    int len = requests.size();
     std::vector<PacketPtr> mylist;
+    mylist.reserve(len);
     for (int i = 0; i < len; ++i) {
-        PacketPtr pkt = reqCoalescer[request_line_address][i].pkt;
-        assert(srequest->m_type ==
-               reqCoalescer[request_line_address][i].primaryType);
+        PacketPtr pkt = requests[i].pkt;
+        assert(srequest->m_type == requests[i].primaryType);
         request_address = (pkt->getAddr());
         request_line_address = makeLineAddress(request_address);
         if (pkt->getPtr<uint8_t>() &&
@@ -1114,9 +1155,7 @@ GPUCoalescer::atomicCallback(Addr address,
 
         mylist.push_back(pkt);
     }
-    delete srequest;
-    reqCoalescer.erase(request_line_address);
-    assert(!reqCoalescer.count(request_line_address));
+    eraseCoalescedLine(coalesced);
 
     completeHitCallback(mylist, len);
 }
@@ -1172,8 +1211,7 @@ GPUCoalescer::mapAddrToPkt(Addr address)
 {
     RequestTable::iterator i = m_readRequestTable.find(address);
     assert(i != m_readRequestTable.end());
-    GPUCoalescerRequest* request = i->second;
-    return request->pkt;
+    return i->second.pkt;
 }
 
 void
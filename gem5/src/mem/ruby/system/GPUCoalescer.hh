@@ -38,7 +38,9 @@
 
 #include <iostream>
 #include <unordered_map>
+#include <vector>
 
+#include "base/pool_allocator.hh"
 #include "base/statistics.hh"
 #include "mem/request.hh"
 #include "mem/ruby/common/Address.hh"
@@ -91,8 +93,6 @@ class RequestDesc
     RubyRequestType secondaryType;
 };
 
-std::ostream& operator<<(std::ostream& out, const GPUCoalescerRequest& obj);
-
 class GPUCoalescer : public RubyPort
 {
   public:
@@ -270,11 +270,27 @@ class GPUCoalescer : public RubyPort
     // The secondary request type comprises a subset of RubyRequestTypes that
     // are understood by the L1 Controller. A primary request type can be any
     // RubyRequestType.
-    typedef std::unordered_map<Addr, std::vector<RequestDesc>> CoalescingTable;
+    //
+    // The tables are keyed by line address. Their nodes come from a pool
+    // and the lists of coalesced requests are recycled, so that a steady
+    // stream of requests does not touch the heap.
+    template <class T>
+    using LineTable = std::unordered_map<Addr, T, std::hash<Addr>,
+        std::equal_to<Addr>, PoolAllocator<std::pair<const Addr, T>>>;
+
+    typedef LineTable<std::vector<RequestDesc>> CoalescingTable;
     CoalescingTable reqCoalescer;
     std::vector<Addr> newRequests;
+    // Emptied request lists kept for reuse
+    std::vector<std::vector<RequestDesc>> freeRequestLists;
+
+    /** Start coalescing the requests of this cycle to a new line. */
+    std::vector<RequestDesc> &insertCoalescedLine(Addr line_addr);
+    /** Drop the coalesced requests to a line and recycle their list. */
+    void eraseCoalescedLine(CoalescingTable::iterator line);
 
-    typedef std::unordered_map<Addr, GPUCoalescerRequest*> RequestTable;
+    // Outstanding requests are stored by value in their table
+    typedef LineTable<GPUCoalescerRequest> RequestTable;
     RequestTable m_writeRequestTable;
     RequestTable m_readRequestTable;
     // Global outstanding request count, across all request tables
@@ -58,7 +58,8 @@ bool RubySystem::m_cooldown_enabled = false;
 
 RubySystem::RubySystem(const Params *p)
     : ClockedObject(p), m_access_backing_store(p->access_backing_store),
-      m_cache_recorder(NULL)
+      m_direct_warmup(p->direct_warmup),
+      m_detailed_stats(p->detailed_stats), m_cache_recorder(NULL)
 {
     m_randomization = p->randomization;
 
@@ -131,9 +132,21 @@ RubySystem::makeCacheRecorder(uint8_t *uncompressed_trace,
                                          sequencer_map, block_size_bytes);
 }
 
+void
+RubySystem::checkSingleEventQueue(const char *what) const
+{
+    for (auto cntrl : m_abs_cntrl_vec) {
+        fatal_if(cntrl->eventQueue() != eventQueue(), "Ruby %s needs all "
+                 "the controllers on the event queue of the Ruby system, "
+                 "but %s is not", what, cntrl->name());
+    }
+}
+
 void
 RubySystem::memWriteback()
 {
+    checkSingleEventQueue("cache cooldown");
+
     m_cooldown_enabled = true;
 
     // Make the trace so we know what to write back.
@@ -349,18 +362,37 @@ RubySystem::startup()
     // state was checkpointed.
 
     if (m_warmup_enabled) {
-        DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
-        // save the current tick value
-        Tick curtick_original = curTick();
-        // save the event queue head
-        Event* eventq_head = eventq->replaceHead(NULL);
-        // set curTick to 0 and reset Ruby System's clock
-        setCurTick(0);
-        resetClock();
-
-        // Schedule an event to start cache warmup
-        enqueueRubyEvent(curTick());
-        simulate();
+        checkSingleEventQueue("cache warmup");
+
+        // Install what the controllers support directly, the rest of
+        // the lines are fetched below.
+        if (m_direct_warmup) {
+            uint64_t installed M5_VAR_USED =
+                m_cache_recorder->installRecords(m_abs_cntrl_vec);
+            DPRINTF(RubyCacheTrace, "Installed %d lines directly\n",
+                    installed);
+        }
+
+        if (m_cache_recorder->hasRecordsToFetch()) {
+            DPRINTF(RubyCacheTrace, "Starting ruby cache warmup\n");
+            // save the current tick value
+            Tick curtick_original = curTick();
+            // save the event queue head
+            Event* eventq_head = eventq->replaceHead(NULL);
+            // set curTick to 0 and reset Ruby System's clock
+            setCurTick(0);
+            resetClock();
+
+            // Schedule an event to start cache warmup
+            enqueueRubyEvent(curTick());
+            simulate();
+
+            // Restore eventq head
+            eventq->replaceHead(eventq_head);
+            // Restore curTick and Ruby System's clock
+            setCurTick(curtick_original);
+            resetClock();
+        }
 
         delete m_cache_recorder;
         m_cache_recorder = NULL;
@@ -368,12 +400,6 @@ RubySystem::startup()
         if (m_systems_to_warmup == 0) {
             m_warmup_enabled = false;
         }
-
-        // Restore eventq head
-        eventq->replaceHead(eventq_head);
-        // Restore curTick and Ruby System's clock
-        setCurTick(curtick_original);
-        resetClock();
     }
 
     resetStats();
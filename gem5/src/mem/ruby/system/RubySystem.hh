@@ -65,6 +65,7 @@ class RubySystem : public ClockedObject
     SimpleMemory *getPhysMem() { return m_phys_mem; }
     Cycles getStartCycle() { return m_start_cycle; }
     bool getAccessBackingStore() { return m_access_backing_store; }
+    bool getDetailedStats() const { return m_detailed_stats; }
 
     // Public Methods
     Profiler*
@@ -96,9 +97,7 @@ class RubySystem : public ClockedObject
     bool eventQueueEmpty() { return eventq->empty(); }
     void enqueueRubyEvent(Tick tick)
     {
-        auto e = new EventFunctionWrapper(
-            [this]{ processRubyEvent(); }, "RubyEvent");
-        schedule(e, tick);
+        scheduleOneShot([this]{ processRubyEvent(); }, tick);
     }
 
   private:
@@ -117,6 +116,14 @@ class RubySystem : public ClockedObject
                                      uint64_t uncompressed_trace_size);
 
     void processRubyEvent();
+
+    /**
+     * Check that all the controllers are on the event queue of the Ruby
+     * system, which the cache warmup and cooldown simulate on alone.
+     *
+     * @param what The operation requiring a single event queue.
+     */
+    void checkSingleEventQueue(const char *what) const;
   private:
     // configuration parameters
     static bool m_randomization;
@@ -129,6 +136,8 @@ class RubySystem : public ClockedObject
     static bool m_cooldown_enabled;
     SimpleMemory *m_phys_mem;
     const bool m_access_backing_store;
+    const bool m_direct_warmup;
+    const bool m_detailed_stats;
 
     Network* m_network;
     std::vector<AbstractController *> m_abs_cntrl_vec;
@@ -48,6 +48,13 @@ class RubySystem(ClockedObject):
     access_backing_store = Param.Bool(False, "Use phys_mem as the functional \
         store and only use ruby for timing.")
 
+    detailed_stats = Param.Bool(True, "Profile the latency of the "
+        "sequencer requests per request type and responding machine")
+
+    direct_warmup = Param.Bool(False, "Restore the cache contents of a "
+        "checkpoint by installing the lines directly in the controllers "
+        "that support it instead of replaying the accesses")
+
     # Profiler related configuration variables
     hot_lines = Param.Bool(False, "")
     all_instructions = Param.Bool(False, "")
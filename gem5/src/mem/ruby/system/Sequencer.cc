@@ -29,6 +29,7 @@
 #include "mem/ruby/system/Sequencer.hh"
 
 #include "arch/x86/ldstflags.hh"
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
 #include "cpu/testers/rubytest/RubyTester.hh"
@@ -46,6 +47,60 @@
 
 using namespace std;
 
+SequencerRequestTable::SequencerRequestTable(int max_requests)
+    : m_slots(max_requests > 0 ? 2 << ceilLog2(max_requests) : 2),
+      m_index_bits(floorLog2(m_slots.size())), m_size(0)
+{
+}
+
+size_t
+SequencerRequestTable::findSlot(Addr line) const
+{
+    const size_t mask = m_slots.size() - 1;
+    size_t i = hash(line);
+    while (m_slots[i].request && m_slots[i].line != line)
+        i = (i + 1) & mask;
+    return i;
+}
+
+void
+SequencerRequestTable::insert(Addr line, SequencerRequest *request,
+                              bool write)
+{
+    assert(request);
+    Slot &slot = m_slots[findSlot(line)];
+    assert(!slot.request);
+    panic_if(2 * (m_size + 1) > m_slots.size(),
+             "Too many outstanding sequencer requests");
+    slot.line = line;
+    slot.request = request;
+    slot.write = write;
+    m_size++;
+}
+
+SequencerRequest *
+SequencerRequestTable::remove(Addr line)
+{
+    size_t hole = findSlot(line);
+    SequencerRequest *request = m_slots[hole].request;
+    assert(request);
+
+    // Move back the following slots of the run that can't be found
+    // from their home slot anymore once the hole is emptied.
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = (hole + 1) & mask; m_slots[i].request;
+         i = (i + 1) & mask) {
+        const size_t home = hash(m_slots[i].line);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            m_slots[hole] = m_slots[i];
+            hole = i;
+        }
+    }
+    m_slots[hole].request = nullptr;
+    m_size--;
+    return request;
+}
+
 Sequencer *
 RubySequencerParams::create()
 {
@@ -53,10 +108,12 @@ RubySequencerParams::create()
 }
 
 Sequencer::Sequencer(const Params *p)
-    : RubyPort(p), m_IncompleteTimes(MachineType_NUM),
+    : RubyPort(p), m_requestTable(p->max_outstanding_requests),
+      m_IncompleteTimes(MachineType_NUM),
       deadlockCheckEvent([this]{ wakeup(); }, "Sequencer deadlock check")
 {
     m_outstanding_count = 0;
+    m_detailed_stats = p->ruby_system->getDetailedStats();
 
     m_instCache_ptr = p->icache;
     m_dataCache_ptr = p->dcache;
@@ -85,42 +142,22 @@ Sequencer::wakeup()
     Cycles current_time = curCycle();
 
     // Check across all outstanding requests
-    int total_outstanding = 0;
-
-    RequestTable::iterator read = m_readRequestTable.begin();
-    RequestTable::iterator read_end = m_readRequestTable.end();
-    for (; read != read_end; ++read) {
-        SequencerRequest* request = read->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
-            continue;
-
-        panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_readRequestTable: %d "
-              "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_readRequestTable.size(),
-              current_time * clockPeriod(), request->issue_time * clockPeriod(),
-              (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
-    }
-
-    RequestTable::iterator write = m_writeRequestTable.begin();
-    RequestTable::iterator write_end = m_writeRequestTable.end();
-    for (; write != write_end; ++write) {
-        SequencerRequest* request = write->second;
-        if (current_time - request->issue_time < m_deadlock_threshold)
+    for (const auto &slot : m_requestTable.slots()) {
+        SequencerRequest* request = slot.request;
+        if (!request ||
+            current_time - request->issue_time < m_deadlock_threshold)
             continue;
 
         panic("Possible Deadlock detected. Aborting!\n"
-              "version: %d request.paddr: 0x%x m_writeRequestTable: %d "
+              "version: %d request.paddr: 0x%x %s requests: %d "
               "current time: %u issue_time: %d difference: %d\n", m_version,
-              request->pkt->getAddr(), m_writeRequestTable.size(),
+              request->pkt->getAddr(), slot.write ? "write" : "read",
+              m_requestTable.size(),
               current_time * clockPeriod(), request->issue_time * clockPeriod(),
               (current_time * clockPeriod()) - (request->issue_time * clockPeriod()));
     }
 
-    total_outstanding += m_writeRequestTable.size();
-    total_outstanding += m_readRequestTable.size();
-
-    assert(m_outstanding_count == total_outstanding);
+    assert(m_outstanding_count == m_requestTable.size());
 
     if (m_outstanding_count > 0) {
         // If there are still outstanding requests, keep checking
@@ -161,8 +198,7 @@ void Sequencer::resetStats()
 RequestStatus
 Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
 {
-    assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
+    assert(m_outstanding_count == m_requestTable.size());
 
     // See if we should schedule a deadlock check
     if (!deadlockCheckEvent.scheduled() &&
@@ -181,63 +217,39 @@ Sequencer::insertRequest(PacketPtr pkt, RubyRequestType request_type)
         return RequestStatus_Aliased;
     }
 
-    // Create a default entry, mapping the address to NULL, the cast is
-    // there to make gcc 4.4 happy
-    RequestTable::value_type default_entry(line_addr,
-                                           (SequencerRequest*) NULL);
-
-    if ((request_type == RubyRequestType_ST) ||
+    const bool write = (request_type == RubyRequestType_ST) ||
         (request_type == RubyRequestType_RMW_Read) ||
         (request_type == RubyRequestType_RMW_Write) ||
         (request_type == RubyRequestType_Load_Linked) ||
         (request_type == RubyRequestType_Store_Conditional) ||
         (request_type == RubyRequestType_Locked_RMW_Read) ||
         (request_type == RubyRequestType_Locked_RMW_Write) ||
-        (request_type == RubyRequestType_FLUSH)) {
-
-        // Check if there is any outstanding read request for the same
-        // cache line.
-        if (m_readRequestTable.count(line_addr) > 0) {
-            m_store_waiting_on_load++;
-            return RequestStatus_Aliased;
-        }
-
-        pair<RequestTable::iterator, bool> r =
-            m_writeRequestTable.insert(default_entry);
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
-        } else {
-          // There is an outstanding write request for the cache line
-          m_store_waiting_on_store++;
-          return RequestStatus_Aliased;
-        }
-    } else {
-        // Check if there is any outstanding write request for the same
-        // cache line.
-        if (m_writeRequestTable.count(line_addr) > 0) {
-            m_load_waiting_on_store++;
-            return RequestStatus_Aliased;
-        }
-
-        pair<RequestTable::iterator, bool> r =
-            m_readRequestTable.insert(default_entry);
-
-        if (r.second) {
-            RequestTable::iterator i = r.first;
-            i->second = new SequencerRequest(pkt, request_type, curCycle());
-            m_outstanding_count++;
+        (request_type == RubyRequestType_FLUSH);
+
+    // Check if there is any outstanding request for the same cache line
+    if (const SequencerRequestTable::Slot *pending =
+            m_requestTable.lookup(line_addr)) {
+        if (write) {
+            if (pending->write)
+                m_store_waiting_on_store++;
+            else
+                m_store_waiting_on_load++;
         } else {
-            // There is an outstanding read request for the cache line
-            m_load_waiting_on_load++;
-            return RequestStatus_Aliased;
+            if (pending->write)
+                m_load_waiting_on_store++;
+            else
+                m_load_waiting_on_load++;
         }
+        return RequestStatus_Aliased;
     }
 
+    m_requestTable.insert(line_addr,
+                          new SequencerRequest(pkt, request_type, curCycle()),
+                          write);
+    m_outstanding_count++;
+
     m_outstandReqHist.sample(m_outstanding_count);
-    assert(m_outstanding_count ==
-        (m_writeRequestTable.size() + m_readRequestTable.size()));
+    assert(m_outstanding_count == m_requestTable.size());
 
     return RequestStatus_Ready;
 }
@@ -246,8 +258,7 @@ void
 Sequencer::markRemoved()
 {
     m_outstanding_count--;
-    assert(m_outstanding_count ==
-           m_writeRequestTable.size() + m_readRequestTable.size());
+    assert(m_outstanding_count == m_requestTable.size());
 }
 
 void
@@ -315,6 +326,16 @@ Sequencer::recordMissLatency(const Cycles cycles, const RubyRequestType type,
                              Cycles firstResponseTime, Cycles completionTime)
 {
     m_latencyHist.sample(cycles);
+
+    // Fast path, most requests are L1 hits
+    if (!m_detailed_stats) {
+        if (isExternalHit)
+            m_missLatencyHist.sample(cycles);
+        else
+            m_hitLatencyHist.sample(cycles);
+        return;
+    }
+
     m_typeLatencyHist[type]->sample(cycles);
 
     if (isExternalHit) {
@@ -361,13 +382,10 @@ Sequencer::writeCallback(Addr address, DataBlock& data,
                          const Cycles firstResponseTime)
 {
     assert(address == makeLineAddress(address));
-    assert(m_writeRequestTable.count(makeLineAddress(address)));
+    assert(m_requestTable.lookup(address) &&
+           m_requestTable.lookup(address)->write);
 
-    RequestTable::iterator i = m_writeRequestTable.find(address);
-    assert(i != m_writeRequestTable.end());
-    SequencerRequest* request = i->second;
-
-    m_writeRequestTable.erase(i);
+    SequencerRequest* request = m_requestTable.remove(address);
     markRemoved();
 
     assert((request->m_type == RubyRequestType_ST) ||
@@ -416,13 +434,10 @@ Sequencer::readCallback(Addr address, DataBlock& data,
                         Cycles firstResponseTime)
 {
     assert(address == makeLineAddress(address));
-    assert(m_readRequestTable.count(makeLineAddress(address)));
-
-    RequestTable::iterator i = m_readRequestTable.find(address);
-    assert(i != m_readRequestTable.end());
-    SequencerRequest* request = i->second;
+    assert(m_requestTable.lookup(address) &&
+           !m_requestTable.lookup(address)->write);
 
-    m_readRequestTable.erase(i);
+    SequencerRequest* request = m_requestTable.remove(address);
     markRemoved();
 
     assert((request->m_type == RubyRequestType_LD) ||
@@ -523,7 +538,7 @@ Sequencer::hitCallback(SequencerRequest* srequest, DataBlock& data,
 bool
 Sequencer::empty() const
 {
-    return m_writeRequestTable.empty() && m_readRequestTable.empty();
+    return m_requestTable.empty();
 }
 
 RequestStatus
@@ -634,12 +649,12 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     // check if the packet has data as for example prefetch and flush
     // requests do not
     std::shared_ptr<RubyRequest> msg =
-        std::make_shared<RubyRequest>(clockEdge(), pkt->getAddr(),
-                                      pkt->isFlush() ?
-                                      nullptr : pkt->getPtr<uint8_t>(),
-                                      pkt->getSize(), pc, secondary_type,
-                                      RubyAccessMode_Supervisor, pkt,
-                                      PrefetchBit_No, proc_id, core_id);
+        makeMessage<RubyRequest>(clockEdge(), pkt->getAddr(),
+                                 pkt->isFlush() ?
+                                 nullptr : pkt->getPtr<uint8_t>(),
+                                 pkt->getSize(), pc, secondary_type,
+                                 RubyAccessMode_Supervisor, pkt,
+                                 PrefetchBit_No, proc_id, core_id);
 
     DPRINTFR(ProtocolTrace, "%15s %3s %10s%20s %6s>%-6s %#x %s\n",
             curTick(), m_version, "Seq", "Begin", "", "",
@@ -654,29 +669,19 @@ Sequencer::issueRequest(PacketPtr pkt, RubyRequestType secondary_type)
     m_mandatory_q_ptr->enqueue(msg, clockEdge(), latency);
 }
 
-template <class KEY, class VALUE>
-std::ostream &
-operator<<(ostream &out, const std::unordered_map<KEY, VALUE> &map)
-{
-    auto i = map.begin();
-    auto end = map.end();
-
-    out << "[";
-    for (; i != end; ++i)
-        out << " " << i->first << "=" << i->second;
-    out << " ]";
-
-    return out;
-}
-
 void
 Sequencer::print(ostream& out) const
 {
     out << "[Sequencer: " << m_version
         << ", outstanding requests: " << m_outstanding_count
-        << ", read request table: " << m_readRequestTable
-        << ", write request table: " << m_writeRequestTable
-        << "]";
+        << ", request table: [";
+    for (const auto &slot : m_requestTable.slots()) {
+        if (slot.request) {
+            out << " " << slot.line << "="
+                << RubyRequestType_to_string(slot.request->m_type);
+        }
+    }
+    out << " ]]";
 }
 
 // this can be called from setState whenever coherence permissions are
@@ -725,28 +730,31 @@ Sequencer::regStats()
     // These statistical variables are not for display.
     // The profiler will collate these across different
     // sequencers and display those collated statistics.
+    // The latency histograms are sampled on every request, so they
+    // buffer their samples and bucket them in bulk.
+    const int latencyBuffer = 32;
     m_outstandReqHist.init(10);
-    m_latencyHist.init(10);
-    m_hitLatencyHist.init(10);
-    m_missLatencyHist.init(10);
+    m_latencyHist.init(10, latencyBuffer);
+    m_hitLatencyHist.init(10, latencyBuffer);
+    m_missLatencyHist.init(10, latencyBuffer);
 
     for (int i = 0; i < RubyRequestType_NUM; i++) {
         m_typeLatencyHist.push_back(new Stats::Histogram());
-        m_typeLatencyHist[i]->init(10);
+        m_typeLatencyHist[i]->init(10, latencyBuffer);
 
         m_hitTypeLatencyHist.push_back(new Stats::Histogram());
-        m_hitTypeLatencyHist[i]->init(10);
+        m_hitTypeLatencyHist[i]->init(10, latencyBuffer);
 
         m_missTypeLatencyHist.push_back(new Stats::Histogram());
-        m_missTypeLatencyHist[i]->init(10);
+        m_missTypeLatencyHist[i]->init(10, latencyBuffer);
     }
 
     for (int i = 0; i < MachineType_NUM; i++) {
         m_hitMachLatencyHist.push_back(new Stats::Histogram());
-        m_hitMachLatencyHist[i]->init(10);
+        m_hitMachLatencyHist[i]->init(10, latencyBuffer);
 
         m_missMachLatencyHist.push_back(new Stats::Histogram());
-        m_missMachLatencyHist[i]->init(10);
+        m_missMachLatencyHist[i]->init(10, latencyBuffer);
 
         m_IssueToInitialDelayHist.push_back(new Stats::Histogram());
         m_IssueToInitialDelayHist[i]->init(10);
@@ -767,10 +775,10 @@ Sequencer::regStats()
 
         for (int j = 0; j < MachineType_NUM; j++) {
             m_hitTypeMachLatencyHist[i].push_back(new Stats::Histogram());
-            m_hitTypeMachLatencyHist[i][j]->init(10);
+            m_hitTypeMachLatencyHist[i][j]->init(10, latencyBuffer);
 
             m_missTypeMachLatencyHist[i].push_back(new Stats::Histogram());
-            m_missTypeMachLatencyHist[i][j]->init(10);
+            m_missTypeMachLatencyHist[i][j]->init(10, latencyBuffer);
         }
     }
 }
@@ -30,7 +30,7 @@
 #define __MEM_RUBY_SYSTEM_SEQUENCER_HH__
 
 #include <iostream>
-#include <unordered_map>
+#include <vector>
 
 #include "mem/ruby/common/Address.hh"
 #include "mem/ruby/protocol/MachineType.hh"
@@ -54,6 +54,61 @@ struct SequencerRequest
 
 std::ostream& operator<<(std::ostream& out, const SequencerRequest& obj);
 
+/**
+ * Outstanding requests of a sequencer, keyed by line address. A line
+ * has at most one outstanding request, read or write, since all the
+ * other requests to the line are aliased and retried. The number of
+ * outstanding requests is bounded, so the table is a flat array that
+ * is never resized, indexed with linear probing and kept at most half
+ * full.
+ */
+class SequencerRequestTable
+{
+  public:
+    struct Slot
+    {
+        Addr line;
+        SequencerRequest *request;
+        bool write;
+
+        Slot() : line(0), request(nullptr), write(false) {}
+    };
+
+    explicit SequencerRequestTable(int max_requests);
+
+    /** Slot of the request to the line, nullptr if there is none. */
+    const Slot *
+    lookup(Addr line) const
+    {
+        const Slot &slot = m_slots[findSlot(line)];
+        return slot.request ? &slot : nullptr;
+    }
+
+    void insert(Addr line, SequencerRequest *request, bool write);
+
+    /** Remove the request to the line and return it. */
+    SequencerRequest *remove(Addr line);
+
+    size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    const std::vector<Slot> &slots() const { return m_slots; }
+
+  private:
+    size_t
+    hash(Addr line) const
+    {
+        return (line * 0x9e3779b97f4a7c15ULL) >> (64 - m_index_bits);
+    }
+
+    /** Slot holding the line, or the empty slot ending its run. */
+    size_t findSlot(Addr line) const;
+
+    std::vector<Slot> m_slots;
+    int m_index_bits;
+    size_t m_size;
+};
+
 class Sequencer : public RubyPort
 {
   public:
@@ -186,11 +241,11 @@ class Sequencer : public RubyPort
     Cycles m_data_cache_hit_latency;
     Cycles m_inst_cache_hit_latency;
 
-    typedef std::unordered_map<Addr, SequencerRequest*> RequestTable;
-    RequestTable m_writeRequestTable;
-    RequestTable m_readRequestTable;
-    // Global outstanding request count, across all request tables
+    SequencerRequestTable m_requestTable;
+    // Global outstanding request count
     int m_outstanding_count;
+    // Whether to profile the latencies per request type and machine
+    bool m_detailed_stats;
     bool m_deadlock_check_scheduled;
 
     //! Counters for recording aliasing information.
@@ -214,7 +214,7 @@ VIPERCoalescer::invL1()
         Addr addr = m_dataCache_ptr->getAddressAtIdx(i);
         // Evict Read-only data
         RubyRequestType request_type = RubyRequestType_REPLACEMENT;
-        std::shared_ptr<RubyRequest> msg = std::make_shared<RubyRequest>(
+        std::shared_ptr<RubyRequest> msg = makeMessage<RubyRequest>(
             clockEdge(), addr, (uint8_t*) 0, 0, 0,
             request_type, RubyAccessMode_Supervisor,
             nullptr);
@@ -245,7 +245,7 @@ VIPERCoalescer::wbL1()
         Addr addr = m_dataCache_ptr->getAddressAtIdx(i);
         // Write dirty data back
         RubyRequestType request_type = RubyRequestType_FLUSH;
-        std::shared_ptr<RubyRequest> msg = std::make_shared<RubyRequest>(
+        std::shared_ptr<RubyRequest> msg = makeMessage<RubyRequest>(
             clockEdge(), addr, (uint8_t*) 0, 0, 0,
             request_type, RubyAccessMode_Supervisor,
             nullptr);
@@ -273,7 +273,7 @@ VIPERCoalescer::invwbL1()
         Addr addr = m_dataCache_ptr->getAddressAtIdx(i);
         // Evict Read-only data
         RubyRequestType request_type = RubyRequestType_REPLACEMENT;
-        std::shared_ptr<RubyRequest> msg = std::make_shared<RubyRequest>(
+        std::shared_ptr<RubyRequest> msg = makeMessage<RubyRequest>(
             clockEdge(), addr, (uint8_t*) 0, 0, 0,
             request_type, RubyAccessMode_Supervisor,
             nullptr);
@@ -289,7 +289,7 @@ VIPERCoalescer::invwbL1()
         Addr addr = m_dataCache_ptr->getAddressAtIdx(i);
         // Write dirty data back
         RubyRequestType request_type = RubyRequestType_FLUSH;
-        std::shared_ptr<RubyRequest> msg = std::make_shared<RubyRequest>(
+        std::shared_ptr<RubyRequest> msg = makeMessage<RubyRequest>(
             clockEdge(), addr, (uint8_t*) 0, 0, 0,
             request_type, RubyAccessMode_Supervisor,
             nullptr);
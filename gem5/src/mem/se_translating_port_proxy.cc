@@ -75,8 +75,12 @@ SETranslatingPortProxy::tryReadBlob(Addr addr, void *p, int size) const
     for (ChunkGenerator gen(addr, size, PageBytes); !gen.done(); gen.next()) {
         Addr paddr;
 
-        if (!pTable->translate(gen.addr(),paddr))
-            return false;
+        if (!pTable->translate(gen.addr(), paddr)) {
+            // The page may belong to the executable and not be loaded.
+            if (!process->loadLazyPage(gen.addr()))
+                return false;
+            pTable->translate(gen.addr(), paddr);
+        }
 
         PortProxy::readBlobPhys(paddr, 0, bytes + prevSize, gen.size());
         prevSize += gen.size();
@@ -96,12 +100,14 @@ SETranslatingPortProxy::tryWriteBlob(Addr addr, const void *p, int size) const
         Addr paddr;
 
         if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
+            if (process->loadLazyPage(gen.addr())) {
+                // The page belongs to the executable.
+            } else if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
             } else if (allocating == NextPage) {
                 // check if we've accessed the next page on the stack
-                if (!process->fixupStackFault(gen.addr()))
+                if (!process->fixupFault(gen.addr()))
                     panic("Page table fault when accessing virtual address %#x "
                             "during functional write\n", gen.addr());
             } else {
@@ -125,7 +131,9 @@ SETranslatingPortProxy::tryMemsetBlob(Addr addr, uint8_t val, int size) const
         Addr paddr;
 
         if (!pTable->translate(gen.addr(), paddr)) {
-            if (allocating == Always) {
+            if (process->loadLazyPage(gen.addr())) {
+                pTable->translate(gen.addr(), paddr);
+            } else if (allocating == Always) {
                 process->allocateMem(roundDown(gen.addr(), PageBytes),
                                      PageBytes);
                 pTable->translate(gen.addr(), paddr);
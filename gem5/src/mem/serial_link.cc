@@ -55,6 +55,7 @@
 #include "base/trace.hh"
 #include "debug/SerialLink.hh"
 #include "params/SerialLink.hh"
+#include "sim/lookahead.hh"
 
 SerialLink::SerialLinkSlavePort::SerialLinkSlavePort(const std::string& _name,
                                          SerialLink& _serial_link,
@@ -67,7 +68,8 @@ SerialLink::SerialLinkSlavePort::SerialLinkSlavePort(const std::string& _name,
       ranges(_ranges.begin(), _ranges.end()),
       outstandingResponses(0), retryReq(false),
       respQueueLimit(_resp_limit),
-      sendEvent([this]{ trySendTiming(); }, _name)
+      sendEvent([this]{ trySendTiming(); }, _name),
+      nextSerialized(0)
 {
 }
 
@@ -77,7 +79,8 @@ SerialLink::SerialLinkMasterPort::SerialLinkMasterPort(const std::string&
                                            Cycles _delay, int _req_limit)
     : MasterPort(_name, &_serial_link), serial_link(_serial_link),
       slavePort(_slavePort), delay(_delay), reqQueueLimit(_req_limit),
-      sendEvent([this]{ trySendTiming(); }, _name)
+      sendEvent([this]{ trySendTiming(); }, _name),
+      nextSerialized(0)
 {
 }
 
@@ -88,7 +91,8 @@ SerialLink::SerialLink(SerialLinkParams *p)
       masterPort(p->name + ".master", *this, slavePort,
                  ticksToCycles(p->delay), p->req_size),
       num_lanes(p->num_lanes),
-      link_speed(p->link_speed)
+      link_speed(p->link_speed),
+      batchWindow(p->batch_window)
 
 {
 }
@@ -112,6 +116,19 @@ SerialLink::init()
     if (!slavePort.isConnected() || !masterPort.isConnected())
         fatal("Both ports of a serial_link must be connected.\n");
 
+    // every packet crossing the link is delayed by at least the link
+    // latency, whichever side of the link the queues are on
+    if (lookaheadSync) {
+        const Tick latency =
+            static_cast<const SerialLinkParams *>(params())->delay;
+        registerLookahead(slavePort.getPeerEventQueue(), eventQueue(),
+                          latency);
+        registerLookahead(masterPort.getPeerEventQueue(), eventQueue(),
+                          latency);
+        registerLookahead(slavePort.getPeerEventQueue(),
+                          masterPort.getPeerEventQueue(), latency);
+    }
+
     // notify the master side  of our address ranges
     slavePort.sendRangeChange();
 }
@@ -147,9 +164,8 @@ SerialLink::SerialLinkMasterPort::recvTimingResp(PacketPtr pkt)
     // have to wait to receive the whole packet. So we only account for the
     // deserialization latency.
     Cycles cycles = delay;
-    cycles += Cycles(divCeil(pkt->getSize() * 8, serial_link.num_lanes
-                * serial_link.link_speed));
-     Tick t = serial_link.clockEdge(cycles);
+    cycles += serial_link.serializationCycles(pkt);
+    Tick t = serial_link.clockEdge(cycles);
 
     //@todo: If the processor sends two uncached requests towards HMC and the
     // second one is smaller than the first one. It may happen that the second
@@ -208,8 +224,7 @@ SerialLink::SerialLinkSlavePort::recvTimingReq(PacketPtr pkt)
             // serial link, we should account for its deserialization latency
             // only.
             Cycles cycles = delay;
-            cycles += Cycles(divCeil(pkt->getSize() * 8,
-                    serial_link.num_lanes * serial_link.link_speed));
+            cycles += serial_link.serializationCycles(pkt);
             Tick t = serial_link.clockEdge(cycles);
 
             //@todo: If the processor sends two uncached requests towards HMC
@@ -246,7 +261,7 @@ SerialLink::SerialLinkMasterPort::schedTimingReq(PacketPtr pkt, Tick when)
     // should already be an event scheduled for sending the head
     // packet.
     if (transmitList.empty()) {
-        serial_link.schedule(sendEvent, when);
+        serial_link.schedule(sendEvent, serial_link.windowEnd(when));
     }
 
     assert(transmitList.size() != reqQueueLimit);
@@ -263,53 +278,68 @@ SerialLink::SerialLinkSlavePort::schedTimingResp(PacketPtr pkt, Tick when)
     // should already be an event scheduled for sending the head
     // packet.
     if (transmitList.empty()) {
-        serial_link.schedule(sendEvent, when);
+        serial_link.schedule(sendEvent, serial_link.windowEnd(when));
     }
 
     transmitList.emplace_back(DeferredPacket(pkt, when));
 }
 
+Tick
+SerialLink::serializedTick(Tick ready, PacketPtr pkt) const
+{
+    // Without batching the packet starts serialization now, otherwise
+    // as soon as it was ready within the current window
+    const Tick start =
+        std::max(ready, curTick() - std::min(curTick(), batchWindow));
+    return clockEdge(serializationCycles(pkt)) - (curTick() - start);
+}
+
 void
 SerialLink::SerialLinkMasterPort::trySendTiming()
 {
     assert(!transmitList.empty());
 
-    DeferredPacket req = transmitList.front();
+    bool sent = false;
+
+    // Send all the requests of the current window back to back, each
+    // one once the previous one has been serialized
+    while (!transmitList.empty()) {
+        DeferredPacket req = transmitList.front();
+        const Tick ready = std::max(req.tick, nextSerialized);
+
+        if (serial_link.windowEnd(ready) > curTick()) {
+            DPRINTF(SerialLink, "Scheduling next send\n");
+            serial_link.schedule(sendEvent, serial_link.windowEnd(ready));
+            break;
+        }
 
-    assert(req.tick <= curTick());
+        PacketPtr pkt = req.pkt;
 
-    PacketPtr pkt = req.pkt;
+        DPRINTF(SerialLink, "trySend request addr 0x%x, queue size %d\n",
+                pkt->getAddr(), transmitList.size());
 
-    DPRINTF(SerialLink, "trySend request addr 0x%x, queue size %d\n",
-            pkt->getAddr(), transmitList.size());
+        // if the send failed, then we try again once we receive a
+        // retry, and therefore there is no need to take any action
+        if (!sendTimingReq(pkt))
+            break;
 
-    if (sendTimingReq(pkt)) {
         // send successful
         transmitList.pop_front();
+        sent = true;
 
         DPRINTF(SerialLink, "trySend request successful\n");
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_req = transmitList.front();
-            DPRINTF(SerialLink, "Scheduling next send\n");
-
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
-            serial_link.schedule(sendEvent, std::max(next_req.tick, t));
-        }
-
-        // if we have stalled a request due to a full request queue,
-        // then send a retry at this point, also note that if the
-        // request we stalled was waiting for the response queue
-        // rather than the request queue we might stall it again
-        slavePort.retryStalledReq();
+        // Make sure bandwidth limitation is met
+        nextSerialized = transmitList.empty() ? 0 :
+            serial_link.serializedTick(ready, pkt);
     }
 
-    // if the send failed, then we try again once we receive a retry,
-    // and therefore there is no need to take any action
+    // if we have stalled a request due to a full request queue,
+    // then send a retry at this point, also note that if the
+    // request we stalled was waiting for the response queue
+    // rather than the request queue we might stall it again
+    if (sent)
+        slavePort.retryStalledReq();
 }
 
 void
@@ -317,47 +347,52 @@ SerialLink::SerialLinkSlavePort::trySendTiming()
 {
     assert(!transmitList.empty());
 
-    DeferredPacket resp = transmitList.front();
+    bool sent = false;
+
+    // Send all the responses of the current window back to back, each
+    // one once the previous one has been serialized
+    while (!transmitList.empty()) {
+        DeferredPacket resp = transmitList.front();
+        const Tick ready = std::max(resp.tick, nextSerialized);
+
+        if (serial_link.windowEnd(ready) > curTick()) {
+            DPRINTF(SerialLink, "Scheduling next send\n");
+            serial_link.schedule(sendEvent, serial_link.windowEnd(ready));
+            break;
+        }
 
-    assert(resp.tick <= curTick());
+        PacketPtr pkt = resp.pkt;
 
-    PacketPtr pkt = resp.pkt;
+        DPRINTF(SerialLink, "trySend response addr 0x%x, outstanding %d\n",
+                pkt->getAddr(), outstandingResponses);
 
-    DPRINTF(SerialLink, "trySend response addr 0x%x, outstanding %d\n",
-            pkt->getAddr(), outstandingResponses);
+        // if the send failed, then we try again once we receive a
+        // retry, and therefore there is no need to take any action
+        if (!sendTimingResp(pkt))
+            break;
 
-    if (sendTimingResp(pkt)) {
         // send successful
         transmitList.pop_front();
+        sent = true;
+
         DPRINTF(SerialLink, "trySend response successful\n");
 
         assert(outstandingResponses != 0);
         --outstandingResponses;
 
-        // If there are more packets to send, schedule event to try again.
-        if (!transmitList.empty()) {
-            DeferredPacket next_resp = transmitList.front();
-            DPRINTF(SerialLink, "Scheduling next send\n");
-
-            // Make sure bandwidth limitation is met
-            Cycles cycles = Cycles(divCeil(pkt->getSize() * 8,
-                serial_link.num_lanes * serial_link.link_speed));
-            Tick t = serial_link.clockEdge(cycles);
-            serial_link.schedule(sendEvent, std::max(next_resp.tick, t));
-        }
-
-        // if there is space in the request queue and we were stalling
-        // a request, it will definitely be possible to accept it now
-        // since there is guaranteed space in the response queue
-        if (!masterPort.reqQueueFull() && retryReq) {
-            DPRINTF(SerialLink, "Request waiting for retry, now retrying\n");
-            retryReq = false;
-            sendRetryReq();
-        }
+        // Make sure bandwidth limitation is met
+        nextSerialized = transmitList.empty() ? 0 :
+            serial_link.serializedTick(ready, pkt);
     }
 
-    // if the send failed, then we try again once we receive a retry,
-    // and therefore there is no need to take any action
+    // if there is space in the request queue and we were stalling
+    // a request, it will definitely be possible to accept it now
+    // since there is guaranteed space in the response queue
+    if (sent && !masterPort.reqQueueFull() && retryReq) {
+        DPRINTF(SerialLink, "Request waiting for retry, now retrying\n");
+        retryReq = false;
+        sendRetryReq();
+    }
 }
 
 void
@@ -55,6 +55,7 @@
 
 #include <deque>
 
+#include "base/intmath.hh"
 #include "base/types.hh"
 #include "mem/port.hh"
 #include "params/SerialLink.hh"
@@ -149,6 +150,13 @@ class SerialLink : public ClockedObject
         /** Send event for the response queue. */
         EventFunctionWrapper sendEvent;
 
+        /**
+         * Tick by which the last response sent has been serialized, and
+         * before which the next one cannot leave. Zero when the queue
+         * is empty.
+         */
+        Tick nextSerialized;
+
       public:
 
         /**
@@ -249,6 +257,13 @@ class SerialLink : public ClockedObject
         /** Send event for the request queue. */
         EventFunctionWrapper sendEvent;
 
+        /**
+         * Tick by which the last request sent has been serialized, and
+         * before which the next one cannot leave. Zero when the queue
+         * is empty.
+         */
+        Tick nextSerialized;
+
       public:
 
         /**
@@ -314,6 +329,44 @@ class SerialLink : public ClockedObject
     /** Speed of each link (Gb/s) in this serial link */
     uint64_t link_speed;
 
+    /** Window in which packets leaving the link are batched */
+    const Tick batchWindow;
+
+    /**
+     * Number of cycles it takes to (de)serialize a packet.
+     *
+     * @param pkt packet crossing the link
+     * @return serialization delay
+     */
+    Cycles serializationCycles(PacketPtr pkt) const
+    {
+        return Cycles(divCeil(pkt->getSize() * 8, num_lanes * link_speed));
+    }
+
+    /**
+     * Determine when a packet sent now has been serialized. Within a
+     * batching window, the packets are sent at the end of the window,
+     * but serialized back to back from when they were ready.
+     *
+     * @param ready tick at which the packet was ready to be sent
+     * @param pkt packet sent
+     * @return tick at which the next packet can be sent
+     */
+    Tick serializedTick(Tick ready, PacketPtr pkt) const;
+
+    /**
+     * Determine when to send a packet that is ready at a given tick,
+     * i.e. at the end of the batching window the tick falls in.
+     *
+     * @param ready tick at which the packet is ready to be sent
+     * @return tick at which to send the packet
+     */
+    Tick windowEnd(Tick ready) const
+    {
+        return batchWindow ? divCeil(ready, batchWindow) * batchWindow :
+            ready;
+    }
+
   public:
 
     Port &getPort(const std::string &if_name,
@@ -40,10 +40,16 @@ import slicc.util as util
 from slicc.symbols import SymbolTable
 
 class SLICC(Grammar):
-    def __init__(self, filename, base_dir, verbose=False, traceback=False, **kwargs):
+    def __init__(self, filename, base_dir, verbose=False, traceback=False,
+                 dispatch='switch', profile_transitions=False, **kwargs):
         self.protocol = None
         self.traceback = traceback
         self.verbose = verbose
+        # How the transitions are dispatched in the generated code:
+        # 'switch' or 'table'
+        self.dispatch = dispatch
+        # Whether the generated code counts the host time per transition
+        self.profile_transitions = profile_transitions
         self.symtab = SymbolTable(self)
         self.base_dir = base_dir
 
@@ -209,6 +209,114 @@ class StateMachine(Symbol):
                 in_msg_bufs[buf_name].append(port)
         return port_to_buf_map, in_msg_bufs, msg_bufs
 
+    def transitionParams(self):
+        '''The TBE and cache entry parameters the transition code takes,
+        as (declaration, name) pairs'''
+        params = []
+        if self.TBEType != None:
+            params.append(('%s*& m_tbe_ptr' % self.TBEType.c_ident,
+                           'm_tbe_ptr'))
+        if self.EntryType != None:
+            params.append(('%s*& m_cache_entry_ptr' % self.EntryType.c_ident,
+                           'm_cache_entry_ptr'))
+        return params
+
+    def transitionCases(self, clock='clockEdge()'):
+        '''Generate the code of every transition and group the
+        transitions that share the same code. Returns an ordered map
+        from the code to the transitions it implements.'''
+
+        ident = self.ident
+        args = ', '.join([ name for decl, name in self.transitionParams() ] +
+                         [ 'addr' ])
+
+        cases = OrderedDict()
+        for trans in self.transitions:
+            case = self.symtab.codeFormatter()
+            # Only set next_state if it changes
+            if trans.state != trans.nextState:
+                if trans.nextState.isWildcard():
+                    # When * is encountered as an end state of a transition,
+                    # the next state is determined by calling the
+                    # machine-specific getNextState function. The next state
+                    # is determined before any actions of the transition
+                    # execute, and therefore the next state calculation cannot
+                    # depend on any of the transitionactions.
+                    case('next_state = getNextState(addr);')
+                else:
+                    ns_ident = trans.nextState.ident
+                    case('next_state = ${ident}_State_${ns_ident};')
+
+            actions = trans.actions
+            request_types = trans.request_types
+
+            # Check for resources
+            case_sorter = []
+            res = trans.resources
+            for key,val in res.iteritems():
+                val = '''
+if (!%s.areNSlotsAvailable(%s, %s))
+    return TransitionResult_ResourceStall;
+''' % (key.code, val, clock)
+                case_sorter.append(val)
+
+            # Check all of the request_types for resource constraints
+            for request_type in request_types:
+                val = '''
+if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
+    return TransitionResult_ResourceStall;
+}
+''' % (self.ident, request_type.ident)
+                case_sorter.append(val)
+
+            # Emit the code sequences in a sorted order.  This makes the
+            # output deterministic (without this the output order can vary
+            # since Map's keys() on a vector of pointers is not deterministic
+            for c in sorted(case_sorter):
+                case("$c")
+
+            # Record access types for this transition
+            for request_type in request_types:
+                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
+
+            # Figure out if we stall
+            stall = False
+            for action in actions:
+                if action.ident == "z_stall":
+                    stall = True
+                    break
+
+            if stall:
+                case('return TransitionResult_ProtocolStall;')
+            else:
+                for action in actions:
+                    case('${{action.ident}}($args);')
+                case('return TransitionResult_Valid;')
+
+            case = str(case)
+
+            # Look to see if this transition code is unique.
+            if case not in cases:
+                cases[case] = []
+
+            cases[case].append(trans)
+
+        return cases
+
+    def transitionHandlers(self):
+        '''Name the handler of each unique transition code for the table
+        dispatch, after the first transition using it.'''
+        # The clock edge is read once per handler, it can't change
+        # while a transition executes.
+        handlers = OrderedDict()
+        for case,transitions in self.transitionCases('now').iteritems():
+            first = transitions[0]
+            name = 'transition_%s_%s' % (first.state.ident, first.event.ident)
+            if 'areNSlotsAvailable' in case:
+                case = 'const Tick now = clockEdge();\n' + case
+            handlers[name] = (case, transitions)
+        return handlers
+
     def writeCodeFiles(self, path, includes):
         self.printControllerPython(path)
         self.printControllerHH(path)
@@ -319,7 +427,13 @@ class $c_ident : public AbstractController
     uint64_t getEventCount(${ident}_Event event);
     bool isPossible(${ident}_State state, ${ident}_Event event);
     uint64_t getTransitionCount(${ident}_State state, ${ident}_Event event);
-
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+    uint64_t getTransitionHostTime(${ident}_State state,
+                                   ${ident}_Event event);
+''')
+        code('''
 private:
 ''')
 
@@ -363,10 +477,35 @@ TransitionResult doTransitionWorker(${ident}_Event event,
 
         code('''
                                     Addr addr);
+''')
+
+        if self.symtab.slicc.dispatch == 'table':
+            params = ''.join([ ', %s' % decl
+                               for decl, name in self.transitionParams() ])
+            code('''
+
+// Transition handlers, indexed by state and event
+typedef TransitionResult (${c_ident}::*TransitionHandler)(
+    ${ident}_State& next_state$params, Addr addr);
+static const TransitionHandler
+    s_transition_table[${ident}_State_NUM][${ident}_Event_NUM];
+''')
+            for name in self.transitionHandlers():
+                code('TransitionResult $name(${ident}_State& next_state'
+                     '$params, Addr addr);')
+
+        code('''
 
 int m_counters[${ident}_State_NUM][${ident}_Event_NUM];
 int m_event_counters[${ident}_Event_NUM];
 bool m_possible[${ident}_State_NUM][${ident}_Event_NUM];
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+uint64_t m_host_time[${ident}_State_NUM][${ident}_Event_NUM];
+static std::vector<std::vector<Stats::Vector *> > hostTimeVec;
+''')
+        code('''
 
 static std::vector<Stats::Vector *> eventVec;
 static std::vector<std::vector<Stats::Vector *> > transVec;
@@ -454,6 +593,7 @@ void unset_tbe(${{self.TBEType.c_ident}}*& m_tbe_ptr);
 #include <unistd.h>
 
 #include <cassert>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <typeinfo>
@@ -501,6 +641,12 @@ ${c_ident}Params::create()
 int $c_ident::m_num_controllers = 0;
 std::vector<Stats::Vector *>  $c_ident::eventVec;
 std::vector<std::vector<Stats::Vector *> >  $c_ident::transVec;
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+std::vector<std::vector<Stats::Vector *> >  $c_ident::hostTimeVec;
+''')
+        code('''
 
 // for adding information to the protocol debug trace
 stringstream ${ident}_transitionComment;
@@ -554,6 +700,10 @@ for (int state = 0; state < ${ident}_State_NUM; state++) {
 for (int event = 0; event < ${ident}_Event_NUM; event++) {
     m_event_counters[event] = 0;
 }
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+memset(m_host_time, 0, sizeof(m_host_time));
 ''')
         code.dedent()
         code('''
@@ -593,6 +743,11 @@ $c_ident::initNetQueues()
 m_net_ptr->set${network}NetQueue(m_version + base, $vid->getOrdered(), $vnet,
                                  "$vnet_type", $vid);
 ''')
+                    # Enqueues take at least a cycle, which is the
+                    # lookahead towards the network
+                    if network == "To":
+                        code('$vid->setProducer(this, '
+                             'cyclesToTicks(Cycles(1)));')
                 # Set Priority
                 if "rank" in var:
                     code('$vid->setPriority(${{var["rank"]}})')
@@ -772,6 +927,30 @@ $c_ident::regStats()
                 transVec[state].push_back(t);
             }
         }
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+
+        for (${ident}_State state = ${ident}_State_FIRST;
+             state < ${ident}_State_NUM; ++state) {
+
+            hostTimeVec.push_back(std::vector<Stats::Vector *>());
+
+            for (${ident}_Event event = ${ident}_Event_FIRST;
+                 event < ${ident}_Event_NUM; ++event) {
+
+                Stats::Vector *t = new Stats::Vector();
+                t->init(m_num_controllers);
+                t->name(params()->ruby_system->name() + ".${c_ident}." +
+                        ${ident}_State_to_string(state) +
+                        "." + ${ident}_Event_to_string(event) + ".host_ns");
+                t->desc("Host time spent in the transition (ns)");
+                t->flags(Stats::total | Stats::oneline | Stats::nozero);
+                hostTimeVec[state].push_back(t);
+            }
+        }
+''')
+        code('''
     }
 }
 
@@ -803,6 +982,14 @@ $c_ident::collateStats()
                 assert(it != rs->m_abstract_controls[MachineType_${ident}].end());
                 (*transVec[state][event])[i] =
                     (($c_ident *)(*it).second)->getTransitionCount(state, event);
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+                (*hostTimeVec[state][event])[i] =
+                    (($c_ident *)(*it).second)->getTransitionHostTime(state,
+                                                                      event);
+''')
+        code('''
             }
         }
     }
@@ -840,6 +1027,18 @@ $c_ident::getTransitionCount(${ident}_State state,
 {
     return m_counters[state][event];
 }
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+
+uint64_t
+$c_ident::getTransitionHostTime(${ident}_State state,
+                                ${ident}_Event event)
+{
+    return m_host_time[state][event];
+}
+''')
+        code('''
 
 int
 $c_ident::getNumControllers()
@@ -876,6 +1075,13 @@ void $c_ident::resetStats()
     for (int event = 0; event < ${ident}_Event_NUM; event++) {
         m_event_counters[event] = 0;
     }
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+
+    memset(m_host_time, 0, sizeof(m_host_time));
+''')
+        code('''
 
     AbstractController::resetStats();
 }
@@ -1167,6 +1373,10 @@ ${ident}_Controller::wakeup()
 // ${ident}: ${{self.short}}
 
 #include <cassert>
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('#include <chrono>')
+        code('''
 
 #include "base/logging.hh"
 #include "base/trace.hh"
@@ -1216,6 +1426,13 @@ DPRINTF(RubyGenerated, "%s, Time: %lld, state: %s, event: %s, addr: %#x\\n",
         *this, curCycle(), ${ident}_State_to_string(state),
         ${ident}_Event_to_string(event), addr);
 
+''')
+        if self.symtab.slicc.profile_transitions:
+            code('''
+const std::chrono::steady_clock::time_point host_start =
+    std::chrono::steady_clock::now();
+''')
+        code('''
 TransitionResult result =
 ''')
         if self.TBEType != None and self.EntryType != None:
@@ -1227,6 +1444,13 @@ TransitionResult result =
         else:
             code('doTransitionWorker(event, state, next_state, addr);')
 
+        if self.symtab.slicc.profile_transitions:
+            code('''
+m_host_time[state][event] +=
+    std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - host_start).count();
+''')
+
         port_to_buf_map, in_msg_bufs, msg_bufs = self.getBufferMaps(ident)
 
         code('''
@@ -1299,102 +1523,32 @@ ${ident}_Controller::doTransitionWorker(${ident}_Event event,
         code('''
                                         Addr addr)
 {
-    switch(HASH_FUN(state, event)) {
 ''')
 
-        # This map will allow suppress generating duplicate code
-        cases = OrderedDict()
-
-        for trans in self.transitions:
-            case_string = "%s_State_%s, %s_Event_%s" % \
-                (self.ident, trans.state.ident, self.ident, trans.event.ident)
-
-            case = self.symtab.codeFormatter()
-            # Only set next_state if it changes
-            if trans.state != trans.nextState:
-                if trans.nextState.isWildcard():
-                    # When * is encountered as an end state of a transition,
-                    # the next state is determined by calling the
-                    # machine-specific getNextState function. The next state
-                    # is determined before any actions of the transition
-                    # execute, and therefore the next state calculation cannot
-                    # depend on any of the transitionactions.
-                    case('next_state = getNextState(addr);')
-                else:
-                    ns_ident = trans.nextState.ident
-                    case('next_state = ${ident}_State_${ns_ident};')
-
-            actions = trans.actions
-            request_types = trans.request_types
-
-            # Check for resources
-            case_sorter = []
-            res = trans.resources
-            for key,val in res.iteritems():
-                val = '''
-if (!%s.areNSlotsAvailable(%s, clockEdge()))
-    return TransitionResult_ResourceStall;
-''' % (key.code, val)
-                case_sorter.append(val)
-
-            # Check all of the request_types for resource constraints
-            for request_type in request_types:
-                val = '''
-if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
-    return TransitionResult_ResourceStall;
-}
-''' % (self.ident, request_type.ident)
-                case_sorter.append(val)
-
-            # Emit the code sequences in a sorted order.  This makes the
-            # output deterministic (without this the output order can vary
-            # since Map's keys() on a vector of pointers is not deterministic
-            for c in sorted(case_sorter):
-                case("$c")
-
-            # Record access types for this transition
-            for request_type in request_types:
-                case('recordRequestType(${ident}_RequestType_${{request_type.ident}}, addr);')
-
-            # Figure out if we stall
-            stall = False
-            for action in actions:
-                if action.ident == "z_stall":
-                    stall = True
-                    break
-
-            if stall:
-                case('return TransitionResult_ProtocolStall;')
-            else:
-                if self.TBEType != None and self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, m_cache_entry_ptr, addr);')
-                elif self.TBEType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_tbe_ptr, addr);')
-                elif self.EntryType != None:
-                    for action in actions:
-                        case('${{action.ident}}(m_cache_entry_ptr, addr);')
-                else:
-                    for action in actions:
-                        case('${{action.ident}}(addr);')
-                case('return TransitionResult_Valid;')
+        if self.symtab.slicc.dispatch == 'table':
+            self.printTransitionTable(code)
+        else:
+            self.printTransitionSwitch(code)
 
-            case = str(case)
+        code.write(path, "%s_Transitions.cc" % self.ident)
 
-            # Look to see if this transition code is unique.
-            if case not in cases:
-                cases[case] = []
+    def printTransitionSwitch(self, code):
+        '''Output the body of doTransitionWorker as a switch statement
+        over the state and event'''
+        ident = self.ident
 
-            cases[case].append(case_string)
+        code('''
+    switch(HASH_FUN(state, event)) {
+''')
 
         # Walk through all of the unique code blocks and spit out the
         # corresponding case statement elements
-        for case,transitions in cases.iteritems():
+        for case,transitions in self.transitionCases().iteritems():
             # Iterative over all the multiple transitions that share
             # the same code
             for trans in transitions:
-                code('  case HASH_FUN($trans):')
+                code('  case HASH_FUN(${ident}_State_${{trans.state.ident}}, '
+                     '${ident}_Event_${{trans.event.ident}}):')
             code('    $case\n')
 
         code('''
@@ -1407,7 +1561,69 @@ if (!checkResourceAvailable(%s_RequestType_%s, addr)) {
     return TransitionResult_Valid;
 }
 ''')
-        code.write(path, "%s_Transitions.cc" % self.ident)
+
+    def printTransitionTable(self, code):
+        '''Output the body of doTransitionWorker as a lookup in a table
+        of handlers, one per unique transition code, followed by the
+        table and the handlers'''
+        ident = self.ident
+        c_ident = "%s_Controller" % self.ident
+        params = self.transitionParams()
+        decls = ''.join([ ', %s' % decl for decl, name in params ])
+        args = ''.join([ ', %s' % name for decl, name in params ])
+
+        code('''
+    const TransitionHandler handler = s_transition_table[state][event];
+    if (handler == nullptr) {
+        panic("Invalid transition\\n"
+              "%s time: %d addr: %#x event: %s state: %s\\n",
+              name(), curCycle(), addr, event, state);
+    }
+
+    return (this->*handler)(next_state$args, addr);
+}
+''')
+
+        handlers = self.transitionHandlers()
+        entries = {}
+        for name,(case, transitions) in handlers.iteritems():
+            for trans in transitions:
+                entries[(trans.state.ident, trans.event.ident)] = name
+
+        # The rows and columns follow the order in which the states and
+        # events are declared, which is the order of the enumerations.
+        code('''
+
+const ${c_ident}::TransitionHandler
+${c_ident}::s_transition_table[${ident}_State_NUM][${ident}_Event_NUM] = {
+''')
+        code.indent()
+        for state in self.states.itervalues():
+            code('// ${ident}_State_${{state.ident}}')
+            code('{')
+            code.indent()
+            for event in self.events.itervalues():
+                name = entries.get((state.ident, event.ident))
+                if name:
+                    code('&${c_ident}::$name,')
+                else:
+                    code('nullptr, // ${{event.ident}}')
+            code.dedent()
+            code('},')
+        code.dedent()
+        code('};')
+
+        for name,(case, transitions) in handlers.iteritems():
+            code('''
+
+TransitionResult
+${c_ident}::$name(${ident}_State& next_state$decls, Addr addr)
+{
+''')
+            code.indent()
+            code('$case')
+            code.dedent()
+            code('}')
 
 
     # **************************
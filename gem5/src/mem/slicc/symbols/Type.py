@@ -291,7 +291,7 @@ $klass ${{self.c_ident}}$parent
 MsgPtr
 clone() const
 {
-     return std::shared_ptr<Message>(new ${{self.c_ident}}(*this));
+     return makeMessage<${{self.c_ident}}>(*this);
 }
 ''')
         else:
@@ -44,22 +44,97 @@
 
 #include "mem/snoop_filter.hh"
 
+#include "base/intmath.hh"
 #include "base/logging.hh"
 #include "base/trace.hh"
 #include "debug/SnoopFilter.hh"
 #include "sim/system.hh"
 
 const int SnoopFilter::SNOOP_MASK_SIZE;
+const Addr SnoopFilter::InvalidTag;
+
+SnoopFilter::SnoopFilter(const SnoopFilterParams *p)
+    : SimObject(p), numSets(0), assoc(p->assoc), usedWays(0),
+      linesize(p->system->cacheLineSize()),
+      lineShift(floorLog2(p->system->cacheLineSize())),
+      lookupLatency(p->lookup_latency),
+      maxEntryCount(p->max_capacity / p->system->cacheLineSize())
+{
+    if (p->storage == Enums::set_associative) {
+        fatal_if(assoc == 0, "%s: associativity must be non-zero\n", name());
+        fatal_if(maxEntryCount < assoc, "%s: capacity of %d lines is "
+                 "smaller than the associativity\n", name(), maxEntryCount);
+
+        // round down to a power of two so that the set can be picked
+        // from the line address bits
+        numSets = 1ULL << floorLog2(maxEntryCount / assoc);
+        tags.resize(numSets * assoc, InvalidTag);
+        items.resize(numSets * assoc);
+    }
+}
+
+SnoopFilter::SnoopItem *
+SnoopFilter::findItem(Addr line_addr)
+{
+    if (numSets) {
+        const size_t first = setIndex(line_addr) * assoc;
+        const Addr *set_tags = &tags[first];
+        for (unsigned way = 0; way < assoc; ++way) {
+            if (set_tags[way] == line_addr)
+                return &items[first + way];
+        }
+
+        if (cachedLocations.empty())
+            return nullptr;
+    }
+
+    auto sf_it = cachedLocations.find(line_addr);
+    return sf_it == cachedLocations.end() ? nullptr : &sf_it->second;
+}
+
+SnoopFilter::SnoopItem &
+SnoopFilter::allocateItem(Addr line_addr)
+{
+    SnoopItem *sf_item = findItem(line_addr);
+    if (sf_item)
+        return *sf_item;
+
+    if (numSets) {
+        const size_t first = setIndex(line_addr) * assoc;
+        Addr *set_tags = &tags[first];
+        for (unsigned way = 0; way < assoc; ++way) {
+            if (set_tags[way] == InvalidTag) {
+                set_tags[way] = line_addr;
+                ++usedWays;
+                items[first + way] = SnoopItem();
+                return items[first + way];
+            }
+        }
+
+        // The set is full. We can't drop a tracked line without
+        // invalidating it in the caches above, so keep it on the side.
+        setConflicts++;
+    }
+
+    return cachedLocations.emplace(line_addr, SnoopItem()).first->second;
+}
 
 void
-SnoopFilter::eraseIfNullEntry(SnoopFilterCache::iterator& sf_it)
+SnoopFilter::eraseIfNullEntry(Addr line_addr, SnoopItem *sf_item)
 {
-    SnoopItem& sf_item = sf_it->second;
-    if ((sf_item.requested | sf_item.holder).none()) {
-        cachedLocations.erase(sf_it);
-        DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
-                __func__);
+    if ((sf_item->requested | sf_item->holder).any())
+        return;
+
+    if (numSets && sf_item >= items.data() &&
+        sf_item < items.data() + items.size()) {
+        assert(tags[sf_item - items.data()] == line_addr);
+        tags[sf_item - items.data()] = InvalidTag;
+        --usedWays;
+    } else {
+        cachedLocations.erase(line_addr);
     }
+    DPRINTF(SnoopFilter, "%s:   Removed SF entry.\n",
+            __func__);
 }
 
 std::pair<SnoopFilter::SnoopList, Cycles>
@@ -76,8 +151,9 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
         line_addr |= LineSecure;
     }
     SnoopMask req_port = portToMask(slave_port);
-    reqLookupResult.it = cachedLocations.find(line_addr);
-    bool is_hit = (reqLookupResult.it != cachedLocations.end());
+    reqLookupResult.item = findItem(line_addr);
+    reqLookupResult.lineAddr = line_addr;
+    bool is_hit = reqLookupResult.item;
 
     // If the snoop filter has no entry, and we should not allocate,
     // do not create a new snoop filter entry, simply return a NULL
@@ -85,12 +161,11 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
     if (!is_hit && !allocate)
         return snoopDown(lookupLatency);
 
-    // If no hit in snoop filter create a new element and update iterator
-    if (!is_hit) {
-        reqLookupResult.it =
-            cachedLocations.emplace(line_addr, SnoopItem()).first;
-    }
-    SnoopItem& sf_item = reqLookupResult.it->second;
+    // If no hit in snoop filter create a new element and update the
+    // lookup result
+    if (!is_hit)
+        reqLookupResult.item = &allocateItem(line_addr);
+    SnoopItem& sf_item = *reqLookupResult.item;
     SnoopMask interested = sf_item.holder | sf_item.requested;
 
     // Store unmodified value of snoop filter item in temp storage in
@@ -157,26 +232,27 @@ SnoopFilter::lookupRequest(const Packet* cpkt, const SlavePort& slave_port)
 void
 SnoopFilter::finishRequest(bool will_retry, Addr addr, bool is_secure)
 {
-    if (reqLookupResult.it != cachedLocations.end()) {
+    if (reqLookupResult.item) {
         // since we rely on the caller, do a basic check to ensure
         // that finishRequest is being called following lookupRequest
         Addr line_addr = (addr & ~(Addr(linesize - 1)));
         if (is_secure) {
             line_addr |= LineSecure;
         }
-        assert(reqLookupResult.it->first == line_addr);
+        assert(reqLookupResult.lineAddr == line_addr);
         if (will_retry) {
             SnoopItem retry_item = reqLookupResult.retryItem;
             // Undo any changes made in lookupRequest to the snoop filter
             // entry if the request will come again. retryItem holds
             // the previous value of the snoopfilter entry.
-            reqLookupResult.it->second = retry_item;
+            *reqLookupResult.item = retry_item;
 
             DPRINTF(SnoopFilter, "%s:   restored SF value %x.%x\n",
                     __func__,  retry_item.requested, retry_item.holder);
         }
 
-        eraseIfNullEntry(reqLookupResult.it);
+        eraseIfNullEntry(line_addr, reqLookupResult.item);
+        reqLookupResult.item = nullptr;
     }
 }
 
@@ -191,10 +267,10 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = (sf_it != cachedLocations.end());
+    SnoopItem *sf_entry = findItem(line_addr);
+    bool is_hit = sf_entry;
 
-    panic_if(!is_hit && (cachedLocations.size() >= maxEntryCount),
+    panic_if(!is_hit && (numItems() >= maxEntryCount),
              "snoop filter exceeded capacity of %d cache blocks\n",
              maxEntryCount);
 
@@ -204,7 +280,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
     if (!is_hit)
         return snoopDown(lookupLatency);
 
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     SnoopMask interested = (sf_item.holder | sf_item.requested);
 
@@ -234,7 +310,7 @@ SnoopFilter::lookupSnoop(const Packet* cpkt)
         sf_item.holder = 0;
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_entry);
     }
 
     return snoopSelected(maskToPortList(interested), lookupLatency);
@@ -264,7 +340,7 @@ SnoopFilter::updateSnoopResponse(const Packet* cpkt,
     }
     SnoopMask rsp_mask = portToMask(rsp_port);
     SnoopMask req_mask = portToMask(req_port);
-    SnoopItem& sf_item = cachedLocations[line_addr];
+    SnoopItem& sf_item = allocateItem(line_addr);
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -311,18 +387,17 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    bool is_hit = sf_it != cachedLocations.end();
+    SnoopItem *sf_entry = findItem(line_addr);
 
     // Nothing to do if it is not a hit
-    if (!is_hit)
+    if (!sf_entry)
         return;
 
     // If the snoop response has no sharers the line is passed in
     // Modified state, and we know that there are no other copies, or
     // they will all be invalidated imminently
     if (!cpkt->hasSharers()) {
-        SnoopItem& sf_item = sf_it->second;
+        SnoopItem& sf_item = *sf_entry;
 
         DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
@@ -330,7 +405,7 @@ SnoopFilter::updateSnoopForward(const Packet* cpkt,
         DPRINTF(SnoopFilter, "%s:   new SF value %x.%x\n",
                 __func__, sf_item.requested, sf_item.holder);
 
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_entry);
     }
 }
 
@@ -352,12 +427,12 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
     if (cpkt->isSecure()) {
         line_addr |= LineSecure;
     }
-    auto sf_it = cachedLocations.find(line_addr);
-    if (sf_it == cachedLocations.end())
+    SnoopItem *sf_entry = findItem(line_addr);
+    if (!sf_entry)
         return;
 
     SnoopMask slave_mask = portToMask(slave_port);
-    SnoopItem& sf_item = sf_it->second;
+    SnoopItem& sf_item = *sf_entry;
 
     DPRINTF(SnoopFilter, "%s:   old SF value %x.%x\n",
             __func__,  sf_item.requested, sf_item.holder);
@@ -376,7 +451,7 @@ SnoopFilter::updateResponse(const Packet* cpkt, const SlavePort& slave_port)
         if (cpkt->isInvalidate()) {
             sf_item.holder &= ~slave_mask;
         }
-        eraseIfNullEntry(sf_it);
+        eraseIfNullEntry(line_addr, sf_entry);
     } else {
         // Any other response implies that a cache above will have the
         // block.
@@ -419,6 +494,11 @@ SnoopFilter::regStats()
         .name(name() + ".hit_multi_snoops")
         .desc("Number of snoops hitting in the snoop filter with multiple "\
               "(>1) holders of the requested data.");
+
+    setConflicts
+        .name(name() + ".set_conflicts")
+        .desc("Number of lines that did not fit in their set and were "\
+              "tracked on the side.");
 }
 
 SnoopFilter *
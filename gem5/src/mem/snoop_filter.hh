@@ -48,7 +48,9 @@
 #include <bitset>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "enums/SnoopFilterStorage.hh"
 #include "mem/packet.hh"
 #include "mem/port.hh"
 #include "mem/qport.hh"
@@ -93,12 +95,7 @@ class SnoopFilter : public SimObject {
 
     typedef std::vector<QueuedSlavePort*> SnoopList;
 
-    SnoopFilter (const SnoopFilterParams *p) :
-        SimObject(p), reqLookupResult(cachedLocations.end()),
-        linesize(p->system->cacheLineSize()), lookupLatency(p->lookup_latency),
-        maxEntryCount(p->max_capacity / p->system->cacheLineSize())
-    {
-    }
+    SnoopFilter (const SnoopFilterParams *p);
 
     /**
      * Init a new snoop filter and tell it about all the slave ports
@@ -221,6 +218,30 @@ class SnoopFilter : public SimObject {
      */
     typedef std::unordered_map<Addr, SnoopItem> SnoopFilterCache;
 
+    /**
+     * Find the item tracking a line.
+     *
+     * @param line_addr Line address, including the LineStatus bits.
+     * @return The item, or nullptr if the line is not tracked.
+     */
+    SnoopItem *findItem(Addr line_addr);
+
+    /**
+     * Find the item tracking a line, and allocate an empty one if
+     * the line is not tracked yet.
+     *
+     * @param line_addr Line address, including the LineStatus bits.
+     * @return The item tracking the line.
+     */
+    SnoopItem &allocateItem(Addr line_addr);
+
+    /** Number of lines currently tracked. */
+    size_t
+    numItems() const
+    {
+        return usedWays + cachedLocations.size();
+    }
+
     /**
      * Simple factory methods for standard return values.
      */
@@ -257,11 +278,44 @@ class SnoopFilter : public SimObject {
     /**
      * Removes snoop filter items which have no requesters and no holders.
      */
-    void eraseIfNullEntry(SnoopFilterCache::iterator& sf_it);
+    void eraseIfNullEntry(Addr line_addr, SnoopItem *sf_item);
+
+    /** Set holding the line in the set-associative layout. */
+    size_t
+    setIndex(Addr line_addr) const
+    {
+        return (line_addr >> lineShift) & (numSets - 1);
+    }
 
-    /** Simple hash set of cached addresses. */
+    /**
+     * Simple hash set of cached addresses. In the set-associative
+     * layout, this only holds the lines that did not fit in their set.
+     */
     SnoopFilterCache cachedLocations;
 
+    /** Tag of an unused way in the set-associative layout. */
+    static const Addr InvalidTag = MaxAddr;
+
+    /**
+     * Line addresses in the set-associative layout, numSets x assoc.
+     * The tags of a set are contiguous so that they can be compared
+     * in a single pass, and are kept apart from the much larger items
+     * to keep that pass within a cache line or two.
+     */
+    std::vector<Addr> tags;
+
+    /** Items of the set-associative layout, parallel to tags. */
+    std::vector<SnoopItem> items;
+
+    /** Number of sets in the set-associative layout, 0 if unused. */
+    size_t numSets;
+
+    /** Ways per set in the set-associative layout. */
+    const unsigned assoc;
+
+    /** Number of valid ways in the set-associative layout. */
+    size_t usedWays;
+
     /**
      * A request lookup must be followed by a call to finishRequest to inform
      * the operation's success. If a retry is needed, however, all changes
@@ -269,8 +323,11 @@ class SnoopFilter : public SimObject {
      * This structure keeps track of the state previous to such changes.
      */
     struct ReqLookupResult {
-        /** Iterator used to store the result from lookupRequest. */
-        SnoopFilterCache::iterator it;
+        /** Item found or allocated by lookupRequest, if any. */
+        SnoopItem *item;
+
+        /** Line address of the item. */
+        Addr lineAddr;
 
         /**
          * Variable to temporarily store value of snoopfilter entry
@@ -279,17 +336,10 @@ class SnoopFilter : public SimObject {
          */
         SnoopItem retryItem;
 
-        /**
-         * The constructor must be informed of the internal cache's end
-         * iterator, so do not allow the compiler to implictly define it.
-         *
-         * @param end_it Iterator to the end of the internal cache.
-         */
-        ReqLookupResult(SnoopFilterCache::iterator end_it)
-            : it(end_it), retryItem{0, 0}
+        ReqLookupResult()
+            : item(nullptr), lineAddr(0), retryItem{0, 0}
         {
         }
-        ReqLookupResult() = delete;
     } reqLookupResult;
 
     /** List of all attached snooping slave ports. */
@@ -298,6 +348,8 @@ class SnoopFilter : public SimObject {
     std::vector<PortID> localSlavePortIds;
     /** Cache line size. */
     const unsigned linesize;
+    /** Log2 of the cache line size. */
+    const unsigned lineShift;
     /** Latency for doing a lookup in the filter */
     const Cycles lookupLatency;
     /** Max capacity in terms of cache blocks tracked, for sanity checking */
@@ -319,6 +371,8 @@ class SnoopFilter : public SimObject {
     Stats::Scalar totSnoops;
     Stats::Scalar hitSingleSnoops;
     Stats::Scalar hitMultiSnoops;
+
+    Stats::Scalar setConflicts;
 };
 
 inline SnoopFilter::SnoopMask
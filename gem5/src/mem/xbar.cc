@@ -54,6 +54,7 @@
 #include "debug/AddrRanges.hh"
 #include "debug/Drain.hh"
 #include "debug/XBar.hh"
+#include "sim/lookahead.hh"
 
 BaseXBar::BaseXBar(const BaseXBarParams *p)
     : ClockedObject(p),
@@ -65,6 +66,7 @@ BaseXBar::BaseXBar(const BaseXBarParams *p)
                           p->port_master_connection_count, false),
       gotAllAddrRanges(false), defaultPortID(InvalidPortID),
       useDefaultRange(p->use_default_range),
+      batchRetries(p->batch_retries),
 
       transDist(this, "trans_dist", "Transaction distribution"),
       pktCount(this, "pkt_count",
@@ -83,6 +85,33 @@ BaseXBar::~BaseXBar()
         delete s;
 }
 
+void
+BaseXBar::init()
+{
+    ClockedObject::init();
+
+    if (!lookaheadSync)
+        return;
+
+    // packets are forwarded with the crossbar latency annotated as
+    // header delay, so that is the minimum time it takes for anything
+    // to cross between the neighbours of the crossbar
+    std::vector<EventQueue *> queues(1, eventQueue());
+    for (auto m : masterPorts)
+        if (m->isConnected())
+            queues.push_back(m->getPeerEventQueue());
+    for (auto s : slavePorts)
+        if (s->isConnected())
+            queues.push_back(s->getPeerEventQueue());
+
+    const Tick latency =
+        cyclesToTicks(std::min(Cycles(frontendLatency + forwardLatency),
+                               responseLatency));
+    for (auto a = queues.begin(); a != queues.end(); ++a)
+        for (auto b = a + 1; b != queues.end(); ++b)
+            registerLookahead(*a, *b, latency);
+}
+
 Port &
 BaseXBar::getPort(const std::string &if_name, PortID idx)
 {
@@ -278,14 +307,19 @@ BaseXBar::Layer<SrcType, DstType>::retryWaiting()
     // update the state
     state = RETRY;
 
-    // set the retrying port to the front of the retry list and pop it
-    // off the list
-    SrcType* retryingPort = waitingForLayer.front();
-    waitingForLayer.pop_front();
+    do {
+        // set the retrying port to the front of the retry list and pop
+        // it off the list
+        SrcType* retryingPort = waitingForLayer.front();
+        waitingForLayer.pop_front();
+
+        // tell the port to retry, which in some cases ends up calling
+        // the layer again
+        sendRetry(retryingPort);
 
-    // tell the port to retry, which in some cases ends up calling the
-    // layer again
-    sendRetry(retryingPort);
+        // with batched retries, keep going until a port uses the
+        // layer or nobody is left waiting
+    } while (xbar.batchRetries && state == RETRY && !waitingForLayer.empty());
 
     // If the layer is still in the retry state, sendTiming wasn't
     // called in zero time (e.g. the cache does this when a writeback
@@ -387,6 +387,10 @@ class BaseXBar : public ClockedObject
        addresses not handled by another port to default device. */
     const bool useDefaultRange;
 
+    /** If true, layers retry all waiting ports that don't resend in
+        zero time without waiting for the next clock edge. */
+    const bool batchRetries;
+
     BaseXBar(const BaseXBarParams *p);
 
     /**
@@ -396,9 +400,11 @@ class BaseXBar : public ClockedObject
      * size are two-dimensional vectors that are indexed by the
      * slave port and master port id (thus the neighbouring master and
      * neighbouring slave), summing up both directions (request and
-     * response).
+     * response). The transaction distribution is updated by all the
+     * requestors, which can run on different threads when simulating
+     * with several event queues, so it uses per-thread storage.
      */
-    Stats::Vector transDist;
+    Stats::ShardedVector transDist;
     Stats::Vector2d pktCount;
     Stats::Vector2d pktSize;
 
@@ -406,6 +412,8 @@ class BaseXBar : public ClockedObject
 
     virtual ~BaseXBar();
 
+    void init() override;
+
     /** A function used to return the port associated with this object. */
     Port &getPort(const std::string &if_name,
                   PortID idx=InvalidPortID) override;
@@ -39,14 +39,119 @@
 
 #include "proto/protoio.hh"
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
 #include "base/logging.hh"
 
 using namespace std;
 using namespace google::protobuf;
 
-ProtoOutputStream::ProtoOutputStream(const string& filename) :
+WriteBehindOutputStream::WriteBehindOutputStream(
+    io::ZeroCopyOutputStream *_sink)
+    : sink(_sink), produced(0), consumed(0), stopping(false), byteCount(0)
+{
+    for (auto &c : chunks) {
+        c.data.reset(new uint8_t[chunkSize]);
+        c.size = 0;
+    }
+    thread = std::thread([this]{ drain(); });
+}
+
+WriteBehindOutputStream::~WriteBehindOutputStream()
+{
+    const uint64_t idx = produced.load(std::memory_order_relaxed);
+    if (chunks[idx % numChunks].size != 0)
+        publish();
+    stopping.store(true, std::memory_order_release);
+    thread.join();
+}
+
+void
+WriteBehindOutputStream::publish()
+{
+    const uint64_t idx = produced.load(std::memory_order_relaxed);
+    produced.store(idx + 1, std::memory_order_release);
+
+    // Wait for the next chunk to be written out before reusing it
+    while (idx + 1 - consumed.load(std::memory_order_acquire) == numChunks)
+        std::this_thread::yield();
+    chunks[(idx + 1) % numChunks].size = 0;
+}
+
+void
+WriteBehindOutputStream::drain()
+{
+    while (true) {
+        const uint64_t idx = consumed.load(std::memory_order_relaxed);
+        if (produced.load(std::memory_order_acquire) == idx) {
+            // The last chunk is published before the stream asks us
+            // to stop, so look at the ring once more
+            if (stopping.load(std::memory_order_acquire) &&
+                produced.load(std::memory_order_acquire) == idx) {
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        const Chunk &chunk = chunks[idx % numChunks];
+        int pos = 0;
+        while (pos < chunk.size) {
+            void *block;
+            int block_size;
+            if (!sink->Next(&block, &block_size))
+                panic("Failed to write to the output stream\n");
+            const int n = std::min(block_size, chunk.size - pos);
+            memcpy(block, chunk.data.get() + pos, n);
+            pos += n;
+            if (n < block_size)
+                sink->BackUp(block_size - n);
+        }
+        consumed.store(idx + 1, std::memory_order_release);
+    }
+}
+
+bool
+WriteBehindOutputStream::Next(void** block, int* block_size)
+{
+    Chunk *chunk = &chunks[produced.load(std::memory_order_relaxed) %
+                           numChunks];
+    if (chunk->size == chunkSize) {
+        publish();
+        chunk = &chunks[produced.load(std::memory_order_relaxed) %
+                        numChunks];
+    }
+
+    *block = chunk->data.get() + chunk->size;
+    *block_size = chunkSize - chunk->size;
+    chunk->size = chunkSize;
+    byteCount += *block_size;
+    return true;
+}
+
+void
+WriteBehindOutputStream::BackUp(int count)
+{
+    Chunk &chunk = chunks[produced.load(std::memory_order_relaxed) %
+                          numChunks];
+    assert(count >= 0 && count <= chunk.size);
+    chunk.size -= count;
+    byteCount -= count;
+}
+
+ProtoOutputStream::ProtoOutputStream(const string& filename,
+                                     bool write_behind) :
     fileStream(filename.c_str(), ios::out | ios::binary | ios::trunc),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+    wrappedFileStream(NULL), gzipStream(NULL), writeBehindStream(NULL),
+    zeroCopyStream(NULL)
 {
     if (!fileStream.good())
         panic("Could not open %s for writing\n", filename);
@@ -59,6 +164,12 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
         filename.substr(filename.find_last_of('.') + 1) == "gz") {
         gzipStream = new io::GzipOutputStream(wrappedFileStream);
         zeroCopyStream = gzipStream;
+        // Compressing is where the time goes, so that is what the
+        // write-behind thread takes over
+        if (write_behind) {
+            writeBehindStream = new WriteBehindOutputStream(gzipStream);
+            zeroCopyStream = writeBehindStream;
+        }
     } else {
         zeroCopyStream = wrappedFileStream;
     }
@@ -73,6 +184,10 @@ ProtoOutputStream::ProtoOutputStream(const string& filename) :
 
 ProtoOutputStream::~ProtoOutputStream()
 {
+    // Let the write-behind thread finish before closing the streams
+    // it writes to
+    delete writeBehindStream;
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL)
         delete gzipStream;
@@ -95,22 +210,192 @@ ProtoOutputStream::write(const Message& msg)
     msg.SerializeWithCachedSizes(&codedStream);
 }
 
-ProtoInputStream::ProtoInputStream(const string& filename) :
-    fileStream(filename.c_str(), ios::in | ios::binary), fileName(filename),
-    useGzip(false),
-    wrappedFileStream(NULL), gzipStream(NULL), zeroCopyStream(NULL)
+MappedInputStream::MappedInputStream(const uint8_t *_data, uint64_t _size)
+    : data(_data), size(_size), pos(0), lastBlockSize(0)
 {
-    if (!fileStream.good())
+}
+
+bool
+MappedInputStream::Next(const void** block, int* block_size)
+{
+    if (pos == size) {
+        lastBlockSize = 0;
+        return false;
+    }
+
+    *block = data + pos;
+    lastBlockSize = size - pos > maxBlockSize ? maxBlockSize : size - pos;
+    *block_size = lastBlockSize;
+    pos += lastBlockSize;
+    return true;
+}
+
+void
+MappedInputStream::BackUp(int count)
+{
+    assert(count >= 0 && count <= lastBlockSize);
+    pos -= count;
+    lastBlockSize = 0;
+}
+
+bool
+MappedInputStream::Skip(int count)
+{
+    lastBlockSize = 0;
+    if (count > size - pos) {
+        pos = size;
+        return false;
+    }
+    pos += count;
+    return true;
+}
+
+ReadAheadInputStream::ReadAheadInputStream(io::ZeroCopyInputStream *_source)
+    : source(_source), produced(0), consumed(0), sourceDone(false),
+      stopping(false), haveChunk(false), chunkPos(0), lastBlockSize(0),
+      byteCount(0)
+{
+    for (auto &c : chunks) {
+        c.data.reset(new uint8_t[chunkSize]);
+        c.size = 0;
+    }
+    thread = std::thread([this]{ fill(); });
+}
+
+ReadAheadInputStream::~ReadAheadInputStream()
+{
+    stopping.store(true, std::memory_order_relaxed);
+    thread.join();
+}
+
+void
+ReadAheadInputStream::fill()
+{
+    while (!stopping.load(std::memory_order_relaxed)) {
+        const uint64_t idx = produced.load(std::memory_order_relaxed);
+        if (idx - consumed.load(std::memory_order_acquire) == numChunks) {
+            // The reader is far enough behind, there is no point in
+            // spinning while it catches up
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        Chunk &chunk = chunks[idx % numChunks];
+        chunk.size = 0;
+        bool exhausted = false;
+        while (chunk.size < chunkSize) {
+            const void *block;
+            int block_size;
+            if (!source->Next(&block, &block_size)) {
+                exhausted = true;
+                break;
+            }
+            const int n = std::min(block_size, chunkSize - chunk.size);
+            memcpy(chunk.data.get() + chunk.size, block, n);
+            chunk.size += n;
+            if (n < block_size)
+                source->BackUp(block_size - n);
+        }
+
+        if (chunk.size != 0)
+            produced.store(idx + 1, std::memory_order_release);
+        if (exhausted) {
+            sourceDone.store(true, std::memory_order_release);
+            return;
+        }
+    }
+}
+
+bool
+ReadAheadInputStream::Next(const void** block, int* block_size)
+{
+    const uint64_t idx = consumed.load(std::memory_order_relaxed);
+    if (haveChunk && chunkPos == chunks[idx % numChunks].size) {
+        // Hand the chunk back to the thread
+        haveChunk = false;
+        chunkPos = 0;
+        consumed.store(idx + 1, std::memory_order_release);
+    }
+
+    if (!haveChunk) {
+        const uint64_t next = consumed.load(std::memory_order_relaxed);
+        while (produced.load(std::memory_order_acquire) == next) {
+            // Check for the end of the stream before looking at the
+            // ring once more, the thread fills its last chunk before
+            // it declares it's done
+            if (sourceDone.load(std::memory_order_acquire) &&
+                produced.load(std::memory_order_acquire) == next) {
+                lastBlockSize = 0;
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        haveChunk = true;
+    }
+
+    const Chunk &chunk = chunks[consumed.load(std::memory_order_relaxed) %
+                                numChunks];
+    *block = chunk.data.get() + chunkPos;
+    lastBlockSize = *block_size = chunk.size - chunkPos;
+    chunkPos = chunk.size;
+    byteCount += lastBlockSize;
+    return true;
+}
+
+void
+ReadAheadInputStream::BackUp(int count)
+{
+    assert(count >= 0 && count <= lastBlockSize);
+    chunkPos -= count;
+    byteCount -= count;
+    lastBlockSize = 0;
+}
+
+bool
+ReadAheadInputStream::Skip(int count)
+{
+    const void *block;
+    int block_size;
+    while (count > 0) {
+        if (!Next(&block, &block_size))
+            return false;
+        if (block_size > count) {
+            BackUp(block_size - count);
+            return true;
+        }
+        count -= block_size;
+    }
+    return true;
+}
+
+ProtoInputStream::ProtoInputStream(const string& filename, bool read_ahead) :
+    fileName(filename), mapping(NULL), mappingSize(0), useGzip(false),
+    readAhead(read_ahead), wrappedFileStream(NULL), gzipStream(NULL),
+    readAheadStream(NULL), zeroCopyStream(NULL), codedStream(NULL)
+{
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
         panic("Could not open %s for reading\n", filename);
 
-    // check the magic number to see if this is a gzip stream
-    unsigned char bytes[2];
-    fileStream.read((char*) bytes, 2);
-    useGzip = fileStream.good() && bytes[0] == 0x1f && bytes[1] == 0x8b;
+    struct stat sb;
+    if (fstat(fd, &sb) != 0)
+        panic("Could not stat %s\n", filename);
+    mappingSize = sb.st_size;
+
+    // An empty file can't be mapped, and fails the magic number check
+    // below anyway
+    if (mappingSize != 0) {
+        mapping = mmap(NULL, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping == MAP_FAILED)
+            panic("Could not map %s: %s\n", filename, strerror(errno));
+        // The trace is read front to back, let the kernel read ahead
+        madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+    }
+    close(fd);
 
-    // seek to the start of the input file and clear any flags
-    fileStream.clear();
-    fileStream.seekg(0, ifstream::beg);
+    // check the magic number to see if this is a gzip stream
+    const uint8_t *bytes = static_cast<const uint8_t *>(mapping);
+    useGzip = mappingSize >= 2 && bytes[0] == 0x1f && bytes[1] == 0x8b;
 
     createStreams();
 }
@@ -120,22 +405,29 @@ ProtoInputStream::createStreams()
 {
     // All streams should be NULL at this point
     assert(wrappedFileStream == NULL && gzipStream == NULL &&
-           zeroCopyStream == NULL);
+           readAheadStream == NULL && zeroCopyStream == NULL &&
+           codedStream == NULL);
 
-    // Wrap the input file in a zero copy stream, that in turn is
-    // wrapped in a gzip stream if the filename ends with .gz. The
-    // latter stream is in turn wrapped in a coded stream
-    wrappedFileStream = new io::IstreamInputStream(&fileStream);
+    // Wrap the mapped file in a zero copy stream, that in turn is
+    // wrapped in a gzip stream if the file is compressed. The latter
+    // stream is in turn wrapped in a coded stream. Reading ahead only
+    // pays off when there is something to decompress.
+    wrappedFileStream = new MappedInputStream(
+        static_cast<const uint8_t *>(mapping), mappingSize);
     if (useGzip) {
         gzipStream = new io::GzipInputStream(wrappedFileStream);
         zeroCopyStream = gzipStream;
+        if (readAhead) {
+            readAheadStream = new ReadAheadInputStream(gzipStream);
+            zeroCopyStream = readAheadStream;
+        }
     } else {
         zeroCopyStream = wrappedFileStream;
     }
+    codedStream = new io::CodedInputStream(zeroCopyStream);
 
     uint32_t magic_check;
-    io::CodedInputStream codedStream(zeroCopyStream);
-    if (!codedStream.ReadLittleEndian32(&magic_check) ||
+    if (!codedStream->ReadLittleEndian32(&magic_check) ||
         magic_check != magicNumber)
         panic("Input file %s is not a valid gem5 proto format.\n",
               fileName);
@@ -144,6 +436,16 @@ ProtoInputStream::createStreams()
 void
 ProtoInputStream::destroyStreams()
 {
+    // The coded stream hands back what it buffered to the stream it
+    // wraps, so it has to go first
+    delete codedStream;
+    codedStream = NULL;
+
+    // Stop the read-ahead thread before pulling the streams it reads
+    // from away under its feet
+    delete readAheadStream;
+    readAheadStream = NULL;
+
     // As the compression is optional, see if the stream exists
     if (gzipStream != NULL) {
         delete gzipStream;
@@ -159,7 +461,8 @@ ProtoInputStream::destroyStreams()
 ProtoInputStream::~ProtoInputStream()
 {
     destroyStreams();
-    fileStream.close();
+    if (mapping != NULL)
+        munmap(mapping, mappingSize);
 }
 
 
@@ -167,9 +470,6 @@ void
 ProtoInputStream::reset()
 {
     destroyStreams();
-    // seek to the start of the input file and clear any flags
-    fileStream.clear();
-    fileStream.seekg(0, ifstream::beg);
     createStreams();
 }
 
@@ -180,14 +480,18 @@ ProtoInputStream::read(Message& msg)
     // a limit when parsing the message, then popping the limit again
     uint32_t size;
 
-    // Due to the byte limit of the coded stream we create it for
-    // every single mesage (based on forum discussions around the size
-    // limitation)
-    io::CodedInputStream codedStream(zeroCopyStream);
-    if (codedStream.ReadVarint32(&size)) {
-        io::CodedInputStream::Limit limit = codedStream.PushLimit(size);
-        if (msg.ParseFromCodedStream(&codedStream)) {
-            codedStream.PopLimit(limit);
+    // Rather than creating a coded stream for every single message,
+    // swap in a fresh one once in a while, before it runs into the
+    // byte limit of older protobuf versions
+    if (codedStream->CurrentPosition() > maxCodedStreamBytes) {
+        delete codedStream;
+        codedStream = new io::CodedInputStream(zeroCopyStream);
+    }
+
+    if (codedStream->ReadVarint32(&size)) {
+        io::CodedInputStream::Limit limit = codedStream->PushLimit(size);
+        if (msg.ParseFromCodedStream(codedStream)) {
+            codedStream->PopLimit(limit);
             // All went well, the message is parsed and the limit is
             // popped again
             return true;
@@ -51,7 +51,10 @@
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/message.h>
 
+#include <atomic>
 #include <fstream>
+#include <memory>
+#include <thread>
 
 /**
  * A ProtoStream provides the shared functionality of the input and
@@ -81,6 +84,80 @@ class ProtoStream
     /** @} */
 };
 
+/**
+ * A zero-copy output stream passing the data on to another stream
+ * from a host thread of its own. The data is collected in chunks
+ * that the thread drains through a single producer, single consumer
+ * ring without any locking, so that the writer only waits when the
+ * ring is full. The wrapped stream must not be used by anyone else
+ * while the write-behind stream exists.
+ */
+class WriteBehindOutputStream :
+    public google::protobuf::io::ZeroCopyOutputStream
+{
+
+  public:
+
+    /**
+     * Create a write-behind stream and start its thread.
+     *
+     * @param sink Stream the data is written to
+     */
+    WriteBehindOutputStream(google::protobuf::io::ZeroCopyOutputStream *sink);
+
+    /**
+     * Pass on all the data written so far and stop the thread.
+     */
+    ~WriteBehindOutputStream();
+
+    bool Next(void** data, int* size) override;
+    void BackUp(int count) override;
+    int64_t ByteCount() const override { return byteCount; }
+
+  private:
+
+    /// Number of chunks in the ring
+    static const unsigned numChunks = 16;
+
+    /// Size of a chunk in bytes
+    static const int chunkSize = 256 * 1024;
+
+    struct Chunk
+    {
+        std::unique_ptr<uint8_t[]> data;
+        int size;
+    };
+
+    /**
+     * Hand the chunk being filled over to the thread.
+     */
+    void publish();
+
+    /**
+     * Body of the write-behind thread, copying the chunks to the sink
+     * stream until the stream is destroyed.
+     */
+    void drain();
+
+    google::protobuf::io::ZeroCopyOutputStream *sink;
+
+    Chunk chunks[numChunks];
+
+    /// Number of chunks handed over to the thread so far
+    std::atomic<uint64_t> produced;
+
+    /// Number of chunks written by the thread
+    std::atomic<uint64_t> consumed;
+
+    /// Set to ask the thread to stop once the ring is empty
+    std::atomic<bool> stopping;
+
+    /// Number of bytes written to the stream
+    int64_t byteCount;
+
+    std::thread thread;
+};
+
 /**
  * A ProtoOutputStream wraps a coded stream, potentially with
  * compression, based on looking at the file name. Writing to the
@@ -99,8 +176,10 @@ class ProtoOutputStream : public ProtoStream
      * ends with .gz then the file will be compressed accordinly.
      *
      * @param filename Path to the file to create or truncate
+     * @param write_behind Compress the file in a separate thread
      */
-    ProtoOutputStream(const std::string& filename);
+    ProtoOutputStream(const std::string& filename,
+                      bool write_behind = false);
 
     /**
      * Destruct the output stream, and also flush and close the
@@ -127,17 +206,144 @@ class ProtoOutputStream : public ProtoStream
     /// Optional Gzip stream to wrap the Zero Copy stream
     google::protobuf::io::GzipOutputStream* gzipStream;
 
+    /// Optional stream feeding the Gzip stream from a thread
+    WriteBehindOutputStream* writeBehindStream;
+
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyOutputStream* zeroCopyStream;
 
 };
 
+/**
+ * A zero-copy input stream handing out the contents of a file mapped
+ * in memory, so that neither a read system call nor a copy is needed
+ * to get at the data. Unlike ArrayInputStream it copes with buffers
+ * that are larger than what fits in an int.
+ */
+class MappedInputStream : public google::protobuf::io::ZeroCopyInputStream
+{
+
+  public:
+
+    /**
+     * Create a stream over a buffer that outlives it.
+     *
+     * @param data Start of the buffer
+     * @param size Size of the buffer in bytes
+     */
+    MappedInputStream(const uint8_t *data, uint64_t size);
+
+    bool Next(const void** data, int* size) override;
+    void BackUp(int count) override;
+    bool Skip(int count) override;
+    int64_t ByteCount() const override { return pos; }
+
+  private:
+
+    /// Maximum number of bytes handed out by a single call to Next
+    static const uint64_t maxBlockSize = 1ULL << 30;
+
+    const uint8_t *data;
+    const uint64_t size;
+    uint64_t pos;
+
+    /// Size of the block returned by the last call to Next
+    int lastBlockSize;
+};
+
+/**
+ * A zero-copy input stream pulling the data of another stream from a
+ * host thread of its own. The thread stays a bounded number of
+ * chunks ahead of the reader, so that the reader only waits when the
+ * thread falls behind. The chunks are handed over through a single
+ * producer, single consumer ring without any locking. The wrapped
+ * stream must not be used by anyone else while the read-ahead stream
+ * exists.
+ */
+class ReadAheadInputStream : public google::protobuf::io::ZeroCopyInputStream
+{
+
+  public:
+
+    /**
+     * Create a read-ahead stream and start its thread.
+     *
+     * @param source Stream the data is read from
+     */
+    ReadAheadInputStream(google::protobuf::io::ZeroCopyInputStream *source);
+
+    /**
+     * Stop the thread and wait for it to finish.
+     */
+    ~ReadAheadInputStream();
+
+    bool Next(const void** data, int* size) override;
+    void BackUp(int count) override;
+    bool Skip(int count) override;
+    int64_t ByteCount() const override { return byteCount; }
+
+  private:
+
+    /// Number of chunks in the ring
+    static const unsigned numChunks = 16;
+
+    /// Size of a chunk in bytes
+    static const int chunkSize = 256 * 1024;
+
+    struct Chunk
+    {
+        std::unique_ptr<uint8_t[]> data;
+        int size;
+    };
+
+    /**
+     * Body of the read-ahead thread, copying the source stream into
+     * the ring until it runs dry or the stream is destroyed.
+     */
+    void fill();
+
+    google::protobuf::io::ZeroCopyInputStream *source;
+
+    Chunk chunks[numChunks];
+
+    /// Number of chunks filled by the thread so far
+    std::atomic<uint64_t> produced;
+
+    /// Number of chunks the reader is done with
+    std::atomic<uint64_t> consumed;
+
+    /// Set by the thread once the source stream is exhausted
+    std::atomic<bool> sourceDone;
+
+    /// Set to ask the thread to stop
+    std::atomic<bool> stopping;
+
+    /// True if the reader holds the chunk at index consumed
+    bool haveChunk;
+
+    /// Offset of the next byte to hand out in the current chunk
+    int chunkPos;
+
+    /// Size of the block returned by the last call to Next
+    int lastBlockSize;
+
+    /// Number of bytes handed out to the reader
+    int64_t byteCount;
+
+    std::thread thread;
+};
+
 /**
  * A ProtoInputStream wraps a coded stream, potentially with
  * decompression, based on looking at the file name. Reading from the
  * stream is done on a per-message basis to avoid having to deal with
  * huge data structures. The latter assumes the length of each message
  * is encoded in the stream when it is written.
+ *
+ * The file is mapped in memory rather than read, and the messages of
+ * an uncompressed trace are parsed straight out of the mapping. A
+ * compressed trace can optionally be inflated ahead of the reader in
+ * a separate thread.
  */
 class ProtoInputStream : public ProtoStream
 {
@@ -149,8 +355,9 @@ class ProtoInputStream : public ProtoStream
      * ends with .gz then the file will be decompressed accordingly.
      *
      * @param filename Path to the file to read from
+     * @param read_ahead Decompress the file in a separate thread
      */
-    ProtoInputStream(const std::string& filename);
+    ProtoInputStream(const std::string& filename, bool read_ahead = false);
 
     /**
      * Destruct the input stream, and also close the underlying file
@@ -183,24 +390,43 @@ class ProtoInputStream : public ProtoStream
      */
     void destroyStreams();
 
-    /// Underlying file input stream
-    std::ifstream fileStream;
+    /**
+     * Number of bytes read through a coded stream before it is
+     * replaced, to stay clear of the total byte limit that older
+     * protobuf versions enforce.
+     */
+    static const int maxCodedStreamBytes = 32 << 20;
 
     /// Hold on to the file name for debug messages
     const std::string fileName;
 
+    /// The whole input file mapped in memory
+    void *mapping;
+
+    /// Size of the mapping in bytes
+    uint64_t mappingSize;
+
     /// Boolean flag to remember whether we use gzip or not
     bool useGzip;
 
-    /// Zero Copy stream wrapping the STL input stream
-    google::protobuf::io::IstreamInputStream* wrappedFileStream;
+    /// Decompress in a separate thread, only used with gzip
+    const bool readAhead;
+
+    /// Zero Copy stream wrapping the mapped file
+    MappedInputStream* wrappedFileStream;
 
     /// Optional Gzip stream to wrap the Zero Copy stream
     google::protobuf::io::GzipInputStream* gzipStream;
 
+    /// Optional stream decompressing the Gzip stream in a thread
+    ReadAheadInputStream* readAheadStream;
+
     /// Top-level zero-copy stream, either with compression or not
     google::protobuf::io::ZeroCopyInputStream* zeroCopyStream;
 
+    /// Coded stream the messages are parsed from
+    google::protobuf::io::CodedInputStream* codedStream;
+
 };
 
 #endif //__PROTO_PROTOIO_HH
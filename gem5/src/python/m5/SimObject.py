@@ -1508,30 +1508,32 @@ class SimObject(object):
             if port != None:
                 port.unproxy(self)
 
-    def print_ini(self, ini_file):
-        print('[' + self.path() + ']', file=ini_file)    # .ini section header
-
-        instanceDict[self.path()] = self
-
+    # the (name, value) pairs of the .ini section of this object
+    def ini_entries(self):
         if hasattr(self, 'type'):
-            print('type=%s' % self.type, file=ini_file)
+            yield 'type', self.type
 
         if len(self._children.keys()):
-            print('children=%s' %
-                  ' '.join(self._children[n].get_name()
-                           for n in sorted(self._children.keys())),
-                  file=ini_file)
+            yield 'children', ' '.join(self._children[n].get_name()
+                                       for n in sorted(self._children.keys()))
 
         for param in sorted(self._params.keys()):
             value = self._values.get(param)
             if value != None:
-                print('%s=%s' % (param, self._values[param].ini_str()),
-                      file=ini_file)
+                yield param, value.ini_str()
 
         for port_name in sorted(self._ports.keys()):
             port = self._port_refs.get(port_name, None)
             if port != None:
-                print('%s=%s' % (port_name, port.ini_str()), file=ini_file)
+                yield port_name, port.ini_str()
+
+    def print_ini(self, ini_file):
+        print('[' + self.path() + ']', file=ini_file)    # .ini section header
+
+        instanceDict[self.path()] = self
+
+        for name, value in self.ini_entries():
+            print('%s=%s' % (name, value), file=ini_file)
 
         print(file=ini_file)        # blank line between objects
 
@@ -1663,6 +1665,24 @@ class SimObject(object):
         for (attr, portRef) in sorted(self._port_refs.items()):
             portRef.ccConnect()
 
+    # Minimum latency in ticks of a packet crossing this object from one
+    # of its ports to another, or None if there is none. Only objects
+    # with a latency may end up on another event queue than their peers
+    # when the event queues are partitioned automatically.
+    # Can be overloaded by the inheriting class
+    def lookaheadLatency(self):
+        return None
+
+    # Links between objects that are not connected through ports, e.g.,
+    # the network links of Ruby, as (object, object, latency) tuples with
+    # the minimum latency in ticks of anything crossing the link, or None
+    # if the objects have to share an event queue. The objects at the
+    # ends of a link no longer follow the event queue of their parent
+    # when the event queues are partitioned automatically.
+    # Can be overloaded by the inheriting class
+    def lookaheadLinks(self):
+        return []
+
     # Default function for generating the device structure.
     # Can be overloaded by the inheriting class
     def generateDeviceTree(self, state):
@@ -0,0 +1,206 @@
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Upgrade old text checkpoints as they are restored
+
+The upgraders of util/cpt_upgraders are built into gem5 and applied to
+the entries of a checkpoint once they have been read for the restore,
+rather than by rewriting m5.cpt with util/cpt_upgrader.py first. The
+upgraded checkpoint only lives in memory, the files are left as they
+are.
+
+"""
+
+from __future__ import print_function
+from __future__ import absolute_import
+
+from six.moves import configparser
+
+from m5.util import fatal, inform
+
+class _CheckpointView(object):
+    """The subset of the ConfigParser interface used by the upgraders,
+    on the entries of a checkpoint being restored"""
+
+    def __init__(self, entries):
+        self._entries = entries
+
+    def sections(self):
+        return sorted(self._entries.sections())
+
+    def has_section(self, section):
+        return self._entries.sectionExists(section)
+
+    def add_section(self, section):
+        if self.has_section(section):
+            raise configparser.DuplicateSectionError(section)
+        self._entries.createSection(section)
+
+    def remove_section(self, section):
+        return self._entries.removeSection(section)
+
+    def options(self, section):
+        if not self.has_section(section):
+            raise configparser.NoSectionError(section)
+        return sorted(self._entries.entries(section))
+
+    def has_option(self, section, option):
+        return self._entries.entryExists(section, option)
+
+    def get(self, section, option, raw=False):
+        value = self._entries.find(section, option)
+        if value is None:
+            if not self.has_section(section):
+                raise configparser.NoSectionError(section)
+            raise configparser.NoOptionError(option, section)
+        return value
+
+    def getint(self, section, option):
+        return int(self.get(section, option))
+
+    def items(self, section, raw=False):
+        return [ (option, self.get(section, option))
+                 for option in self.options(section) ]
+
+    def set(self, section, option, value):
+        if not self.has_section(section):
+            raise configparser.NoSectionError(section)
+        self._entries.set(section, option, str(value))
+
+    def remove_option(self, section, option):
+        if not self.has_section(section):
+            raise configparser.NoSectionError(section)
+        return self._entries.removeEntry(section, option)
+
+class _Upgrader(object):
+    def __init__(self, tag, source):
+        self.tag = tag
+        exec(compile(source, tag + '.py', 'exec'), {}, self.__dict__)
+
+        if isinstance(self.__dict__.get('depends', []), str):
+            self.depends = [ self.depends ]
+        else:
+            self.depends = list(self.__dict__.get('depends', []))
+
+        fwd_depends = self.__dict__.get('fwd_depends', [])
+        self.fwd_depends = [ fwd_depends ] if isinstance(fwd_depends, str) \
+                           else list(fwd_depends)
+
+        if not hasattr(self, 'upgrader') and not hasattr(self, 'downgrader'):
+            fatal("No upgrader or downgrader method for %s", tag)
+
+    def apply(self, cpt, tags):
+        if hasattr(self, 'upgrader'):
+            self.upgrader(cpt)
+            tags.add(self.tag)
+        else:
+            self.downgrader(cpt)
+            tags.remove(self.tag)
+
+_upgraders = None
+
+def _loadUpgraders():
+    """The upgraders by tag, with their dependencies resolved as
+    util/cpt_upgrader.py does"""
+
+    global _upgraders
+    if _upgraders is not None:
+        return _upgraders
+
+    from m5.cpt_upgraders import upgraders as sources
+
+    _upgraders = {}
+    legacy = {}
+    for name, source in sources.items():
+        upg = _Upgrader(name, source)
+        _upgraders[upg.tag] = upg
+        if hasattr(upg, 'legacy_version'):
+            legacy[upg.legacy_version] = upg
+
+    # Legacy versions depend on the previous one
+    i = 3
+    while i in legacy:
+        legacy[i].depends = [ legacy[i - 1].tag ]
+        i += 1
+
+    for tag, upg in _upgraders.items():
+        for fd in upg.fwd_depends:
+            _upgraders[fd].depends.append(tag)
+
+    return _upgraders
+
+def upgrade(ckpt):
+    """Apply the missing upgraders to a checkpoint being restored.
+
+    This must be done before any state is restored. Binary checkpoints
+    are only written by versions of gem5 that have all the current
+    upgraders and are left alone.
+
+    """
+
+    entries = ckpt.textEntries()
+    if entries is None:
+        return
+
+    cpt = _CheckpointView(entries)
+    upgraders = _loadUpgraders()
+
+    if cpt.has_option('root', 'cpt_ver'):
+        # Legacy linear checkpoint version
+        legacy = dict((u.legacy_version, u) for u in upgraders.values()
+                      if hasattr(u, 'legacy_version'))
+        tags = set(legacy[i].tag
+                   for i in range(2, cpt.getint('root', 'cpt_ver') + 1))
+        cpt.remove_option('root', 'cpt_ver')
+    elif cpt.has_option('Globals', 'version_tags'):
+        tags = set(cpt.get('Globals', 'version_tags').split())
+    else:
+        fatal("No version information in the checkpoint")
+
+    upgrade_tags = set(t for t, u in upgraders.items()
+                       if hasattr(u, 'upgrader'))
+    downgrade_tags = set(upgraders) - upgrade_tags
+    to_apply = (upgrade_tags - tags) | (downgrade_tags & tags)
+    if not to_apply:
+        return
+
+    applied = []
+    while to_apply:
+        ready = sorted(t for t in to_apply
+                       if all(d in tags for d in upgraders[t].depends))
+        if not ready:
+            fatal("Can't resolve the dependencies of the checkpoint "
+                  "upgrades %s", ' '.join(sorted(to_apply)))
+
+        for tag in ready:
+            upgraders[tag].apply(cpt, tags)
+            applied.append(tag)
+
+        to_apply -= set(ready)
+
+    cpt.set('Globals', 'version_tags', ' '.join(sorted(tags)))
+    inform("Upgraded the checkpoint with: %s", ' '.join(applied))
@@ -120,6 +120,16 @@ def parse_options():
     option("--stats-help",
            action="callback", callback=_stats_help,
            help="Display documentation for available stat visitors")
+    option("--stats-allow", metavar="GLOB[,GLOB]", action='append',
+           split=',',
+           help="Only keep the stats matching one of the patterns, e.g., "
+           "'system.cpu*.ipc'. Other stats are neither updated nor output")
+    option("--stats-deny", metavar="GLOB[,GLOB]", action='append',
+           split=',',
+           help="Disable the stats matching one of the patterns")
+    option("--stats-host-counters", action="store_true", default=False,
+           help="Count host cycles, instructions, LLC misses, branch misses "
+           "and page faults of every simulation thread with perf_event")
 
     # Configuration Options
     group("Configuration Options")
@@ -132,6 +142,12 @@ def parse_options():
     option("--dot-dvfs-config", metavar="FILE", default=None,
         help="Create DOT & pdf outputs of the DVFS configuration" + \
              " [Default: %default]")
+    option("--init-threads", metavar="N", type="int", default=1,
+        help="Number of threads running the thread-safe init() and "
+             "loadState() of the objects [Default: %default]")
+    option("--compile-config", metavar="FILE", default=None,
+        help="Write the resolved configuration in a binary form that "
+             "m5.instantiateCompiled() creates from C++ [Default: %default]")
 
     # Debugging options
     group("Debugging Options")
@@ -147,7 +163,13 @@ def parse_options():
     option("--debug-end", metavar="TICK", type='int',
         help="End debug output at TICK")
     option("--debug-file", metavar="FILE", default="cout",
-        help="Sets the output file for debug [Default: %default]")
+        help="Sets the output file for debug. Files ending with .bin or "
+        ".bin.gz get a binary trace that util/decode_debug_trace.py "
+        "formats [Default: %default]")
+    option("--debug-history", metavar="N", type='int', default=0,
+        help="Keep the last N debug messages in memory while debug output "
+        "is stopped, and write them out when it starts again, e.g. by a "
+        "DebugTrigger [Default: %default]")
     option("--debug-ignore", metavar="EXPR", action='append', split=':',
         help="Ignore EXPR sim objects")
     option("--remote-gdb-port", type='int', default=7000,
@@ -365,6 +387,12 @@ def main(*args):
 
     # set stats options
     stats.addStatVisitor(options.stats_file)
+    for pattern in options.stats_allow or []:
+        stats.allowStats(pattern)
+    for pattern in options.stats_deny or []:
+        stats.denyStats(pattern)
+    if options.stats_host_counters:
+        stats.enableHostCounters()
 
     # Disable listeners unless running interactively or explicitly
     # enabled
@@ -425,6 +453,10 @@ def main(*args):
         _check_tracing()
         trace.ignore(ignore)
 
+    if options.debug_history:
+        _check_tracing()
+        trace.history(options.debug_history)
+
     sys.argv = arguments
     sys.path = [ os.path.dirname(sys.argv[0]) ] + sys.path
 
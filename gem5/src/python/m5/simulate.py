@@ -44,6 +44,7 @@ from __future__ import print_function
 
 import atexit
 import os
+import struct
 import sys
 
 # import the wrapped C++ functions
@@ -51,6 +52,7 @@ import _m5.drain
 import _m5.core
 from _m5.stats import updateEvents as updateStatEvents
 
+from . import cpt_upgrade
 from . import stats
 from . import SimObject
 from . import ticks
@@ -58,8 +60,9 @@ from . import objects
 from m5.util.dot_writer import do_dot, do_dvfs_dot
 from m5.util.dot_writer_ruby import do_ruby_dot
 
-from .util import fatal
+from .util import fatal, inform, warn
 from .util import attrdict
+from .params import PortRef, VectorPortRef
 
 # define a MaxTick parameter, unsigned 64 bit
 MaxTick = 2**64 - 1
@@ -92,6 +95,13 @@ def instantiate(ckpt_dir=None):
     # Unproxy in sorted order for determinism
     for obj in root.descendants(): obj.unproxyParams()
 
+    # Now that all the ports are connected, spread the objects over the
+    # event queues if the user asked for it
+    if _eventq_partition:
+        _partition(root, options.outdir, **_eventq_partition)
+    elif _eventq_check:
+        _checkQueueLinks(root, _queueLinks(list(root.descendants())))
+
     if options.dump_config:
         ini_file = open(os.path.join(options.outdir, options.dump_config), 'w')
         # Print ini sections in sorted order for easier diffing
@@ -99,6 +109,10 @@ def instantiate(ckpt_dir=None):
             obj.print_ini(ini_file)
         ini_file.close()
 
+    if options.compile_config:
+        writeCompiledConfig(root,
+            os.path.join(options.outdir, options.compile_config))
+
     if options.json_config:
         try:
             import json
@@ -121,7 +135,7 @@ def instantiate(ckpt_dir=None):
     for obj in root.descendants(): obj.connectPorts()
 
     # Do a second pass to finish initializing the sim objects
-    for obj in root.descendants(): obj.init()
+    _runPhase(root, 'init', _m5.core.initObjects)
 
     # Do a third pass to initialize statistics
     stats._bindStatHierarchy(root)
@@ -146,8 +160,9 @@ def instantiate(ckpt_dir=None):
     if ckpt_dir:
         _drain_manager.preCheckpointRestore()
         ckpt = _m5.core.getCheckpoint(ckpt_dir)
+        cpt_upgrade.upgrade(ckpt)
         _m5.core.unserializeGlobals(ckpt);
-        for obj in root.descendants(): obj.loadState(ckpt)
+        _runPhase(root, 'loadState', _m5.core.loadStateObjects, ckpt)
     else:
         for obj in root.descendants(): obj.initState()
 
@@ -155,13 +170,108 @@ def instantiate(ckpt_dir=None):
     # a checkpoint, If so, this call will shift them to be at a valid time.
     updateStatEvents()
 
+def writeCompiledConfig(root, filename):
+    """Write the resolved configuration of root in the binary form read
+    by instantiateCompiled(), see sim/cxx_config_binary.hh"""
+
+    def put_u32(f, val):
+        f.write(struct.pack('<I', val))
+
+    def put_string(f, s):
+        s = s.encode('utf-8')
+        put_u32(f, len(s))
+        f.write(s)
+
+    ticks.fixGlobalFrequency()
+    objs = sorted(root.descendants(), key=lambda o: o.path())
+    with open(filename, 'wb') as f:
+        f.write(b'GCFG')
+        put_u32(f, 1)
+        f.write(struct.pack('<Q', _m5.core.getClockFrequency()))
+        put_u32(f, len(objs))
+        for obj in objs:
+            entries = list(obj.ini_entries())
+            put_string(f, obj.path())
+            put_u32(f, len(entries))
+            for name, value in entries:
+                put_string(f, name)
+                put_string(f, str(value))
+
+# The C++ config manager of a config created by instantiateCompiled()
+_compiled_config = None
+
+def instantiateCompiled(filename, ckpt_dir=None):
+    """Create the simulated system from a config compiled by an earlier
+    run with --compile-config instead of from Python SimObjects. The
+    objects are created, connected and initialised in C++, which saves
+    most of the start up time of large configs. There must not be a
+    Python Root, and gem5 must have been built with --with-cxx-config.
+
+    Parts of the config that only exist in Python, e.g., SimObject
+    methods overridden in Python, are not available in the compiled
+    config.
+
+    """
+
+    global _compiled_config
+
+    if objects.Root.getInstance():
+        fatal("instantiateCompiled() can't be used with a Python Root")
+    if not hasattr(_m5.core, 'instantiateCompiled'):
+        fatal("Compiled configs need gem5 to be built with --with-cxx-config")
+
+    stats.initSimStats()
+    _compiled_config = _m5.core.instantiateCompiled(filename)
+    stats.enable()
+
+    if ckpt_dir:
+        _drain_manager.preCheckpointRestore()
+        ckpt = _compiled_config.getCheckpoint(ckpt_dir)
+        cpt_upgrade.upgrade(ckpt)
+        _m5.core.unserializeGlobals(ckpt);
+        _compiled_config.loadState(ckpt)
+    else:
+        _compiled_config.initState()
+
+    updateStatEvents()
+
+def _runPhase(root, method, run_objects, *args):
+    """Call a method on all the objects of root, in order. Runs of
+    objects that only implement the method in C++ are handed to
+    run_objects, which calls the thread-safe ones from several threads
+    (see --init-threads)."""
+    from m5 import options
+
+    def python_method(obj):
+        if not isinstance(obj.getCCObject(), _m5.param_SimObject.SimObject):
+            return True
+        for cls in type(obj).__mro__:
+            if cls is SimObject.SimObject:
+                return False
+            if method in cls.__dict__:
+                return True
+        return False
+
+    objs = []
+    for obj in root.descendants():
+        if python_method(obj):
+            run_objects(objs, *(args + (options.init_threads, )))
+            objs = []
+            getattr(obj, method)(*args)
+        else:
+            objs.append(obj.getCCObject())
+    run_objects(objs, *(args + (options.init_threads, )))
+
 need_startup = True
 def simulate(*args, **kwargs):
     global need_startup
 
     if need_startup:
-        root = objects.Root.getInstance()
-        for obj in root.descendants(): obj.startup()
+        if _compiled_config:
+            _compiled_config.startup()
+        else:
+            root = objects.Root.getInstance()
+            for obj in root.descendants(): obj.startup()
         need_startup = False
 
         # Python exit handlers happen in reverse order.
@@ -215,22 +325,33 @@ def drain():
     assert _drain_manager.isDrained(), "Drain state inconsistent"
 
 def memWriteback(root):
+    if _compiled_config:
+        _compiled_config.memWriteback()
+        return
+
     for obj in root.descendants():
         obj.memWriteback()
 
 def memInvalidate(root):
+    if _compiled_config:
+        _compiled_config.memInvalidate()
+        return
+
     for obj in root.descendants():
         obj.memInvalidate()
 
-def checkpoint(dir):
+def checkpoint(dir, text=False):
+    """Write a checkpoint to dir. Checkpoints are written in a binary
+    format unless text is set, in which case they are written in the
+    INI text format of older versions."""
     root = objects.Root.getInstance()
-    if not isinstance(root, objects.Root):
+    if not isinstance(root, objects.Root) and not _compiled_config:
         raise TypeError("Checkpoint must be called on a root object.")
 
     drain()
     memWriteback(root)
     print("Writing checkpoint")
-    _m5.core.serializeAll(dir)
+    _m5.core.serializeAll(dir, text)
 
 def _changeMemoryMode(system, mode):
     if not isinstance(system, (objects.Root, objects.System)):
@@ -316,6 +437,10 @@ def switchCpus(system, cpuList, verbose=True):
         new_cpu.takeOverFrom(old_cpu)
 
 def notifyFork(root):
+    if _compiled_config:
+        _compiled_config.notifyFork()
+        return
+
     for obj in root.descendants():
         obj.notifyFork()
 
@@ -371,6 +496,431 @@ def fork(simout="%(parent)s.f%(fork_seq)i"):
 
     return pid
 
+class Snapshot(object):
+    """In-process snapshot of the simulator for rolling back.
+
+    Taking a snapshot forks the simulator. The parent process keeps
+    the state at the snapshot, including the guest memory which the
+    processes share copy-on-write, and the child goes on simulating.
+    Rolling back ends the child, and the parent forks a new child that
+    resumes from take() again, so the rollback takes as long as a
+    fork.
+
+    snap = m5.Snapshot()
+    run = snap.take()
+    # configure the run depending on run, the number of rollbacks
+    m5.simulate(...)
+    if run < 3:
+        snap.rollback()
+
+    The state of the simulator, such as the stats, is the one of the
+    snapshot after a rollback, so stats have to be dumped before
+    rolling back. When the last child exits, the parent exits with
+    the same status. As with fork(), the simulator can't have any
+    listeners enabled, and threads such as the ones of multi-queue
+    simulation are not copied to the children.
+
+    Keyword Arguments:
+      simout -- Output directory of the runs, formatted as for fork()
+                with run the number of rollbacks. The runs share the
+                output directory of the simulator by default.
+    """
+
+    def __init__(self, simout=None):
+        self.simout = simout
+        self.run = 0
+        self._pipe = None
+
+    def take(self):
+        """Take the snapshot, and return the number of rollbacks."""
+        from m5 import options
+
+        if not _m5.core.listenersDisabled():
+            raise RuntimeError("Can not snapshot a simulator with " \
+                               "listeners enabled")
+        if self._pipe is not None:
+            raise RuntimeError("Snapshot has already been taken")
+
+        drain()
+        sys.stdout.flush()
+        sys.stderr.flush()
+        parent = options.outdir
+
+        while True:
+            rfd, wfd = os.pipe()
+            pid = os.fork()
+            if pid == 0:
+                os.close(rfd)
+                self._pipe = wfd
+                notifyFork(objects.Root.getInstance())
+                if self.simout is not None:
+                    options.outdir = self.simout % {
+                        "parent" : parent,
+                        "run" : self.run,
+                        "pid" : os.getpid(),
+                    }
+                    _m5.core.setOutputDir(options.outdir)
+                return self.run
+
+            # The child writes to the pipe when it rolls back, and it
+            # is closed without a write when the child exits.
+            os.close(wfd)
+            rollback = os.read(rfd, 1)
+            os.close(rfd)
+            _, status = os.waitpid(pid, 0)
+            if not rollback:
+                if os.WIFSIGNALED(status):
+                    os._exit(128 + os.WTERMSIG(status))
+                os._exit(os.WEXITSTATUS(status))
+
+            self.run += 1
+
+    def rollback(self):
+        """Go back to the snapshot, take() returns again."""
+        if self._pipe is None:
+            raise RuntimeError("Rolling back without a snapshot")
+
+        sys.stdout.flush()
+        sys.stderr.flush()
+        os.write(self._pipe, b"r")
+        os._exit(0)
+
+def sweep(points, run, max_children=None,
+          simout="%(parent)s.s%(point)i"):
+    """Fan the simulation out over the points of a parameter sweep.
+
+    The simulator forks a child for every point, starting from its
+    current state, so the setup and warmup simulated so far are shared
+    by the whole sweep. A child calls run(point), which applies the
+    point through the runtime interfaces of the objects, such as the
+    ones changing a replacement policy or a prefetch degree, and
+    simulates. What run returns has to be picklable, and is sent back
+    to the parent.
+
+    m5.simulate(warmup)
+    results = m5.sweep([1, 2, 4, 8], run_with_degree, max_children=4)
+
+    As with fork(), the simulator can't have any listeners enabled,
+    and the children don't have the threads of multi-queue
+    simulation.
+
+    Keyword Arguments:
+      max_children -- Number of children simulating at once, one per
+                      host core by default.
+      simout -- Output directory of the children, formatted as for
+                fork() with point the index of the point.
+
+    Return Value:
+      What run returned for each of the points, in order, or None for
+      the children that failed.
+    """
+    import multiprocessing
+    import pickle
+    import select
+    import traceback
+    from m5 import options
+
+    if not _m5.core.listenersDisabled():
+        raise RuntimeError("Can not sweep a simulator with listeners enabled")
+
+    points = list(points)
+    if max_children is None:
+        max_children = multiprocessing.cpu_count()
+    if max_children < 1:
+        raise ValueError("A sweep needs at least one child at a time")
+
+    drain()
+    sys.stdout.flush()
+    sys.stderr.flush()
+    parent = options.outdir
+
+    results = [ None ] * len(points)
+    # The children send back their results through a pipe each, which
+    # are read as the results come in so that no child blocks on a
+    # full pipe.
+    running = {}
+    next_point = 0
+    while next_point < len(points) or running:
+        while next_point < len(points) and len(running) < max_children:
+            rfd, wfd = os.pipe()
+            pid = os.fork()
+            if pid == 0:
+                os.close(rfd)
+                notifyFork(objects.Root.getInstance())
+                options.outdir = simout % {
+                    "parent" : parent,
+                    "point" : next_point,
+                    "pid" : os.getpid(),
+                }
+                _m5.core.setOutputDir(options.outdir)
+
+                status = 0
+                try:
+                    data = pickle.dumps(run(points[next_point]), 2)
+                    while data:
+                        data = data[os.write(wfd, data):]
+                except:
+                    # the child must never return to the script
+                    traceback.print_exc()
+                    status = 1
+                sys.stdout.flush()
+                sys.stderr.flush()
+                os._exit(status)
+
+            os.close(wfd)
+            running[rfd] = (next_point, pid, [])
+            next_point += 1
+
+        ready, _, _ = select.select(list(running.keys()), [], [])
+        for rfd in ready:
+            point, pid, chunks = running[rfd]
+            chunk = os.read(rfd, 65536)
+            if chunk:
+                chunks.append(chunk)
+                continue
+
+            os.close(rfd)
+            del running[rfd]
+            _, status = os.waitpid(pid, 0)
+            if os.WIFSIGNALED(status):
+                warn("Sweep point %d was killed by signal %d" % \
+                     (point, os.WTERMSIG(status)))
+            elif os.WEXITSTATUS(status) != 0:
+                warn("Sweep point %d failed with status %d" % \
+                     (point, os.WEXITSTATUS(status)))
+            elif chunks:
+                results[point] = pickle.loads(b"".join(chunks))
+
+    return results
+
+_eventq_partition = None
+def partitionEventQueues(num_queues=None, load=None, mapping=None,
+                         tolerance=0.1,
+                         output="eventq_partition.json"):
+    """Assign the SimObjects to event queues when instantiating.
+
+    The instantiated port graph is cut into num_queues partitions.
+    Only objects with a lookahead latency (see
+    SimObject.lookaheadLatency) may end up on a different queue than
+    the objects they are connected to, and the cuts are made through
+    the objects with the largest latency first.  Links that are not
+    made of ports, such as the Ruby network links, are reported by
+    SimObject.lookaheadLinks.  Objects without any connected port or
+    such link share the queue of their parent.
+
+    The load of a partition is the sum of the load of its objects, one
+    per object unless load is given.  The partitions are kept within
+    tolerance of the average load where possible.  The resulting
+    mapping from object path to queue index is written to output in
+    the output directory so that it can be reused.
+
+    If sim_quantum is not set on the root, it is set to the smallest
+    latency of the links between two queues.
+
+    Arguments:
+      num_queues -- Number of event queues.
+      load -- Dictionary (or JSON file name) mapping object paths to
+              their load, e.g., the number of events serviced in a
+              profiling run.  Objects not listed have no load.
+      mapping -- Dictionary (or JSON file name) from object path to
+                 event queue index, as written by a previous run.  The
+                 partitioning is skipped if it is given.
+      tolerance -- Load imbalance allowed when grouping objects.
+      output -- Name of the mapping file, None to not write it.
+    """
+
+    global _eventq_partition
+
+    if mapping is None and not num_queues:
+        fatal("Need either a number of event queues or a mapping to "
+              "partition the event queues")
+
+    _eventq_partition = {
+        "num_queues" : num_queues,
+        "load" : load,
+        "mapping" : mapping,
+        "tolerance" : tolerance,
+        "output" : output,
+        }
+
+_eventq_check = False
+def checkEventQueues():
+    """Check the event queues assigned by hand when instantiating.
+
+    Objects on different event queues must only be connected through
+    objects with a lookahead latency or links with a latency, as for
+    partitionEventQueues. If sim_quantum is not set on the root, it is
+    set to the smallest latency of the links between two queues.
+    """
+
+    global _eventq_check
+    _eventq_check = True
+
+def _loadJson(value):
+    if value is None or isinstance(value, dict):
+        return value
+
+    import json
+    with open(value) as f:
+        return json.load(f)
+
+def _peers(obj):
+    for ref in obj._port_refs.values():
+        elements = ref.elements if isinstance(ref, VectorPortRef) else [ref]
+        for el in elements:
+            if isinstance(el.peer, PortRef):
+                yield el.peer.simobj
+
+def _lookahead(obj):
+    latency = obj.lookaheadLatency()
+    return latency if latency else None
+
+class _UnionFind(object):
+    def __init__(self):
+        self.parent = {}
+
+    def find(self, x):
+        root = x
+        while self.parent.get(root, root) is not root:
+            root = self.parent[root]
+        # Path compression
+        while x is not root:
+            self.parent[x], x = root, self.parent.get(x, x)
+        return root
+
+    def union(self, x, y):
+        x, y = self.find(x), self.find(y)
+        if x is not y:
+            self.parent[y] = x
+        return x
+
+def _linkedObjects(objs):
+    links = [link for obj in objs for link in obj.lookaheadLinks()]
+    linked = set()
+    for a, b, latency in links:
+        linked.add(a)
+        linked.add(b)
+    return links, linked
+
+def _partitionGraph(root, num_queues, load, tolerance):
+    objs = list(root.descendants())
+    index = dict((obj, i) for i, obj in enumerate(objs))
+
+    # Group the objects that have to share a queue
+    groups = _UnionFind()
+    links = []
+    obj_links, linked = _linkedObjects(objs)
+    for a, b, latency in obj_links:
+        if latency:
+            links.append((latency, a, b))
+        else:
+            groups.union(a, b)
+
+    for obj in objs:
+        peers = list(_peers(obj))
+        if not peers and obj not in linked and obj._parent is not None:
+            groups.union(obj._parent, obj)
+
+        for peer in peers:
+            latencies = [l for l in (_lookahead(obj), _lookahead(peer))
+                         if l is not None]
+            if latencies:
+                links.append((min(latencies), obj, peer))
+            else:
+                groups.union(obj, peer)
+
+    group_load = {}
+    for obj in objs:
+        g = groups.find(obj)
+        weight = load.get(obj.path(), 0) if load is not None else 1
+        group_load[g] = group_load.get(g, 0) + weight
+
+    total = sum(group_load.values())
+    capacity = float(total) / num_queues * (1 + tolerance)
+
+    # Keep the shortest links inside a partition, as long as the load
+    # permits, since they limit how far the queues can run ahead of
+    # each other.
+    links.sort(key=lambda l: (l[0], index[l[1]], index[l[2]]))
+    parts = _UnionFind()
+    part_load = dict(group_load)
+    for latency, a, b in links:
+        pa, pb = parts.find(groups.find(a)), parts.find(groups.find(b))
+        if pa is pb or part_load[pa] + part_load[pb] > capacity:
+            continue
+        parts.union(pa, pb)
+        part_load[pa] += part_load.pop(pb)
+
+    # Pack the partitions into the queues, largest first, starting with
+    # the partition of the root so that it ends up on queue 0.
+    part_of = lambda obj: parts.find(groups.find(obj))
+    root_part = part_of(root)
+    pending = sorted(part_load.keys(),
+                     key=lambda p: (p is not root_part, -part_load[p],
+                                    index[p]))
+    queue_load = [0] * num_queues
+    queue_of = {}
+    for p in pending:
+        q = queue_load.index(min(queue_load))
+        queue_of[p] = q
+        queue_load[q] += part_load[p]
+
+    mapping = dict((obj.path(), queue_of[part_of(obj)]) for obj in objs)
+
+    inform("Partitioned %d objects into %d event queues, load: %s",
+           len(objs), num_queues, " ".join(str(l) for l in queue_load))
+
+    return mapping, links
+
+def _partition(root, outdir, num_queues, load, mapping, tolerance, output):
+    mapping = _loadJson(mapping)
+    objs = list(root.descendants())
+    if mapping is None:
+        mapping, links = _partitionGraph(root, num_queues,
+                                         _loadJson(load), tolerance)
+    else:
+        links = _queueLinks(objs)
+
+    for obj in objs:
+        path = obj.path()
+        if path in mapping:
+            obj.eventq_index = mapping[path]
+        else:
+            warn("No event queue for %s in the partition, keeping %d",
+                 path, obj.eventq_index)
+            mapping[path] = int(obj.eventq_index)
+
+    _checkQueueLinks(root, links)
+
+    if output:
+        import json
+        with open(os.path.join(outdir, output), 'w') as f:
+            json.dump(mapping, f, indent=4, sort_keys=True)
+
+def _queueLinks(objs):
+    links = [(_lookahead(obj) or 0, obj, peer) for obj in objs
+             for peer in _peers(obj)]
+    links += [(latency or 0, a, b)
+              for a, b, latency in _linkedObjects(objs)[0]]
+    return links
+
+def _checkQueueLinks(root, links):
+    # Check the links between queues, they set the quantum
+    cut = [l for l in links
+           if int(l[1].eventq_index) != int(l[2].eventq_index)]
+    if cut:
+        lookahead = min(l[0] for l in cut)
+        if not lookahead:
+            fatal("Objects without lookahead latency on different event "
+                  "queues: %s and %s", *[o.path() for o in
+                                         min(cut, key=lambda l: l[0])[1:]])
+        if not int(root.sim_quantum):
+            inform("Setting sim_quantum to %d ticks", lookahead)
+            root.sim_quantum = lookahead
+        elif int(root.sim_quantum) > lookahead:
+            warn("sim_quantum is larger than the smallest latency between "
+                 "two event queues (%d ticks)", lookahead)
+
 from _m5.core import disableAllListeners, listenersDisabled
 from _m5.core import listenersLoopbackOnly
 from _m5.core import curTick
@@ -187,6 +187,35 @@ def _hdf5Factory(fn, chunking=10, desc=True, formulas=True):
 
     return _m5.stats.initHDF5(fn, chunking, desc, formulas)
 
+@_url_factory([ "bin", ])
+def _binaryFactory(fn, changed=False, desc=False, formulas=True):
+    """Output stats in a compact binary format.
+
+    The names of the stats are stored once, and each stat dump only
+    stores the raw values. This makes dumps cheap enough to be taken
+    frequently, e.g., to get time series from periodic stat dumps. The
+    file is compressed if its name ends with .gz.
+
+    The util/read_binary_stats.py script converts a binary stat file
+    to a pandas DataFrame or to CSV.
+
+    Known limitations:
+      * Sparse histograms are not supported.
+      * Prerequisites are ignored, all stats are stored in every dump.
+
+    Parameters:
+      * changed (bool): Only store the values that changed since the
+        previous dump (default: False)
+      * desc (bool): Output stat descriptions (default: False)
+      * formulas (bool): Output derived stats (default: True)
+
+    Example:
+      bin://stats.bin.gz?changed=True;formulas=False
+
+    """
+
+    return _m5.stats.initBinary(fn, changed, desc, formulas)
+
 def addStatVisitor(url):
     """Add a stat visitor specified using a URL string
 
@@ -235,13 +264,32 @@ def printStatVisitorTypes():
         # Try to extract the factory doc string
         print_doc(inspect.getdoc(factory))
 
+def enableHostCounters():
+    """Report the host performance counters of every simulation thread
+    as stats. This has to be called before the stats are enabled."""
+    _m5.stats.enableHostCounters()
+
 def initSimStats():
     _m5.stats.initSimStats()
     _m5.stats.registerPythonStatsHandlers()
 
+def _rootGroup():
+    """The C++ stat group of the root object, which is the Python Root or
+    the root of a compiled config (see m5.instantiateCompiled())"""
+
+    root = Root.getInstance()
+    if root:
+        return root.getCCObject()
+
+    from m5 import simulate
+    if simulate._compiled_config:
+        return simulate._compiled_config.root()
+
+    return None
+
 def _visit_groups(visitor, root=None):
     if root is None:
-        root = Root.getInstance()
+        root = _rootGroup()
     for group in root.getStatGroups().values():
         visitor(group)
         _visit_groups(visitor, root=group)
@@ -281,6 +329,46 @@ def _bindStatHierarchy(root):
     for name, obj in root._children.items():
         _bind_obj(name, obj)
 
+# Glob patterns selecting the stats to keep and the stats to disable
+allow_patterns = []
+deny_patterns = []
+
+def allowStats(pattern):
+    """Only keep the stats matching a glob pattern
+
+    Stats are matched using their full name, e.g.,
+    'system.cpu*.committedInsts'. Once an allow pattern has been added,
+    the stats that don't match any of the allow patterns are
+    disabled. Disabled stats are not output and updates to them are
+    ignored, which saves the cost of maintaining them. The patterns
+    must be added before the stats are enabled by m5.instantiate().
+
+    Stats that are not output, e.g., the per-sequencer Ruby stats
+    that are collated by the profiler, are never disabled. Formulas
+    are computed from other stats, which must be kept as well.
+
+    """
+
+    allow_patterns.append(pattern)
+
+def denyStats(pattern):
+    """Disable the stats matching a glob pattern
+
+    Deny patterns are applied after the allow patterns, see
+    allowStats().
+
+    """
+
+    deny_patterns.append(pattern)
+
+def _filterStats():
+    """Disable the stats rejected by the allow and deny patterns"""
+
+    if not allow_patterns and not deny_patterns:
+        return
+
+    _m5.stats.filterStats(allow_patterns, deny_patterns)
+
 names = []
 stats_dict = {}
 stats_list = []
@@ -289,52 +377,47 @@ def enable():
     enabled, all statistics must be created and initialized and once
     the package is enabled, no more statistics can be created.'''
 
-    def check_stat(group, stat):
-        if not stat.check() or not stat.baseCheck():
-            fatal("statistic '%s' (%d) was not properly initialized " \
-                  "by a regStats() function\n", stat.name, stat.id)
-
-        if not (stat.flags & flags.display):
-            stat.name = "__Stat%06d" % stat.id
-
+    # The stats are indexed by name in C++, which saves walking the
+    # stat groups from Python here and for every dump.
+    _m5.stats.buildIndex(_rootGroup())
+    _m5.stats.enableIndexedStats()
 
     # Legacy stat
     global stats_list
     stats_list = list(_m5.stats.statsList())
-
-    for stat in stats_list:
-        check_stat(None, stat)
-
     stats_list.sort(key=lambda s: s.name.split('.'))
     for stat in stats_list:
         stats_dict[stat.name] = stat
-        stat.enable()
-
 
-    # New stats
-    _visit_stats(check_stat)
-    _visit_stats(lambda g, s: s.enable())
+    _filterStats()
 
     _m5.stats.enable();
 
+def findStats(pattern):
+    '''Names of the stats matching a glob pattern, e.g.,
+    'system.cpu*.ipc'. The stats must be enabled.'''
+
+    return _m5.stats.findStats(pattern)
+
+def values(names):
+    '''Current values of some stats as a numpy array, in the order of
+    the names. Vectors and formulas are summed, and other stats and
+    unknown names get NaN.'''
+
+    return _m5.stats.statValues(list(names))
+
 def prepare():
     '''Prepare all stats for data access.  This must be done before
     dumping and serialization.'''
 
-    # Legacy stats
-    for stat in stats_list:
-        stat.prepare()
-
-    # New stats
-    _visit_stats(lambda g, s: s.prepare())
+    _m5.stats.prepareAll()
 
 def _dump_to_visitor(visitor, root=None):
-    # Legacy stats
     if root is None:
-        for stat in stats_list:
-            stat.visit(visitor)
+        _m5.stats.visitAll(visitor)
+        return
 
-    # New stats
+    # New stats of a sub-tree
     def dump_group(group):
         for stat in group.getStats():
             stat.visit(visitor)
@@ -344,13 +427,11 @@ def _dump_to_visitor(visitor, root=None):
             dump_group(g)
             visitor.endGroup()
 
-    if root is not None:
-        for p in root.path_list():
-            visitor.beginGroup(p)
-    dump_group(root if root is not None else Root.getInstance())
-    if root is not None:
-        for p in reversed(root.path_list()):
-            visitor.endGroup()
+    for p in root.path_list():
+        visitor.beginGroup(p)
+    dump_group(root)
+    for p in reversed(root.path_list()):
+        visitor.endGroup()
 
 lastDump = 0
 
@@ -372,7 +453,7 @@ def dump(root=None):
     if new_dump:
         _m5.stats.processDumpQueue()
         # Notify new-style stats group that we are about to dump stats.
-        sim_root = Root.getInstance()
+        sim_root = _rootGroup()
         if sim_root:
             sim_root.preDumpStats();
         prepare()
@@ -387,13 +468,12 @@ def reset():
     '''Reset all statistics to the base state'''
 
     # call reset stats on all SimObjects
-    root = Root.getInstance()
+    root = _rootGroup()
     if root:
         root.resetStats()
 
     # call any other registered legacy stats reset callbacks
-    for stat in stats_list:
-        stat.reset()
+    _m5.stats.resetLegacyStats()
 
     _m5.stats.processResetQueue()
 
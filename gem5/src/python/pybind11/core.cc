@@ -50,18 +50,26 @@
 #include "python/pybind11/core.hh"
 
 #include <ctime>
+#include <memory>
 
 #include "base/addr_range.hh"
 #include "base/inet.hh"
+#include "base/inifile.hh"
 #include "base/logging.hh"
 #include "base/random.hh"
 #include "base/socket.hh"
 #include "base/types.hh"
+#include "config/use_cxx_config.hh"
 #include "sim/core.hh"
 #include "sim/drain.hh"
 #include "sim/serialize.hh"
 #include "sim/sim_object.hh"
 
+#if USE_CXX_CONFIG
+#include "sim/cxx_config_binary.hh"
+#include "sim/cxx_manager.hh"
+#endif
+
 namespace py = pybind11;
 
 /** Resolve a SimObject name using the Pybind configuration */
@@ -75,6 +83,10 @@ PybindSimObjectResolver pybindSimObjectResolver;
 SimObject *
 PybindSimObjectResolver::resolveSimObject(const std::string &name)
 {
+    // Objects may restore their state from other threads, which don't
+    // hold the GIL (see SimObject::loadStateAll()).
+    py::gil_scoped_acquire gil;
+
     // TODO
     py::module m = py::module::import("m5.SimObject");
     auto f = m.attr("resolveSimObject");
@@ -137,7 +149,35 @@ init_serialize(py::module &m_native)
         m, "Serializable")
         ;
 
+    py::class_<IniFile>(m, "IniFile")
+        .def("sections", [](const IniFile &ini) {
+            std::vector<std::string> names;
+            ini.getSectionNames(names);
+            return names;
+        })
+        .def("entries", [](const IniFile &ini, const std::string &section) {
+            std::vector<std::string> names;
+            ini.getEntryNames(section, names);
+            return names;
+        })
+        .def("find", [](const IniFile &ini, const std::string &section,
+                        const std::string &entry) -> py::object {
+            std::string value;
+            if (!ini.find(section, entry, value))
+                return py::none();
+            return py::str(value);
+        })
+        .def("entryExists", &IniFile::entryExists)
+        .def("sectionExists", &IniFile::sectionExists)
+        .def("set", &IniFile::set)
+        .def("createSection", &IniFile::createSection)
+        .def("removeEntry", &IniFile::removeEntry)
+        .def("removeSection", &IniFile::removeSection)
+        ;
+
     py::class_<CheckpointIn>(m, "CheckpointIn")
+        .def("textEntries", &CheckpointIn::textEntries,
+             py::return_value_policy::reference_internal)
         ;
 }
 
@@ -202,6 +242,78 @@ init_net(py::module &m_native)
         ;
 }
 
+#if USE_CXX_CONFIG
+/**
+ * Create the objects of a compiled config, see
+ * m5.instantiateCompiled(). The objects go through the same steps as
+ * in m5.instantiate(), up to but not including initState/loadState.
+ */
+static CxxConfigManager *
+instantiateCompiled(const std::string &filename)
+{
+    static bool directory_initialized = false;
+    if (!directory_initialized) {
+        cxxConfigInit();
+        directory_initialized = true;
+    }
+
+    // The config and its manager are needed until the end of the
+    // simulation, like the objects they create.
+    CxxBinaryConfig *config = new CxxBinaryConfig;
+    if (!config->load(filename))
+        fatal("Can't load compiled config %s\n", filename);
+
+    if (!clockFrequencyFixed()) {
+        setClockFrequency(config->frequency());
+        fixClockFrequency();
+    } else if (getClockFrequency() != config->frequency()) {
+        fatal("%s was compiled for %d ticks/s, the frequency is fixed at "
+              "%d ticks/s\n", filename, config->frequency(),
+              getClockFrequency());
+    }
+
+    CxxConfigManager *manager = new CxxConfigManager(*config);
+    try {
+        manager->instantiate(true, true);
+    } catch (CxxConfigManager::Exception &e) {
+        fatal("Config problem in compiled config %s: %s: %s\n",
+              filename, e.name, e.message);
+    }
+
+    return manager;
+}
+
+static void
+init_cxx_config(py::module &m_core)
+{
+    py::class_<CxxConfigManager>(m_core, "CxxConfigManager")
+        .def("initState", &CxxConfigManager::initState)
+        .def("startup", &CxxConfigManager::startup)
+        .def("loadState", &CxxConfigManager::loadState)
+        .def("memWriteback", [](CxxConfigManager &manager) {
+            manager.forEachObject(&SimObject::memWriteback);
+        })
+        .def("memInvalidate", [](CxxConfigManager &manager) {
+            manager.forEachObject(&SimObject::memInvalidate);
+        })
+        .def("notifyFork", [](CxxConfigManager &manager) {
+            manager.forEachObject(&SimObject::notifyFork);
+        })
+        .def("getCheckpoint", [](CxxConfigManager &manager,
+                                 const std::string &cpt_dir) {
+            return new CheckpointIn(cpt_dir,
+                                    manager.getSimObjectResolver());
+        })
+        .def("root", [](CxxConfigManager &manager) {
+            return manager.findObject("root");
+        }, py::return_value_policy::reference)
+        ;
+
+    m_core.def("instantiateCompiled", &instantiateCompiled,
+               py::return_value_policy::reference);
+}
+#endif
+
 void
 pybind_init_core(py::module &m_native)
 {
@@ -268,14 +380,35 @@ pybind_init_core(py::module &m_native)
      * Serialization helpers
      */
     m_core
-        .def("serializeAll", &Serializable::serializeAll)
+        .def("serializeAll", &Serializable::serializeAll,
+             py::arg("cpt_dir"), py::arg("text") = false)
         .def("unserializeGlobals", &Serializable::unserializeGlobals)
         .def("getCheckpoint", [](const std::string &cpt_dir) {
             return new CheckpointIn(cpt_dir, pybindSimObjectResolver);
         })
 
+        /* The GIL is released when several threads are used so that
+         * objects can use the resolver from the other threads */
+        .def("initObjects", [](const std::vector<SimObject *> &objs,
+                               unsigned num_threads) {
+            std::unique_ptr<py::gil_scoped_release> release;
+            if (num_threads > 1)
+                release.reset(new py::gil_scoped_release);
+            SimObject::initAll(objs, num_threads);
+        })
+        .def("loadStateObjects", [](const std::vector<SimObject *> &objs,
+                                    CheckpointIn &cp, unsigned num_threads) {
+            std::unique_ptr<py::gil_scoped_release> release;
+            if (num_threads > 1)
+                release.reset(new py::gil_scoped_release);
+            SimObject::loadStateAll(objs, cp, num_threads);
+        })
+
         ;
 
+#if USE_CXX_CONFIG
+    init_cxx_config(m_core);
+#endif
 
     init_drain(m_native);
     init_serialize(m_native);
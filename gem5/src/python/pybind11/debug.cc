@@ -45,9 +45,11 @@
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
+#include <cstring>
 #include <map>
 #include <vector>
 
+#include "base/binary_logger.hh"
 #include "base/debug.hh"
 #include "base/output.hh"
 #include "base/trace.hh"
@@ -62,12 +64,26 @@ extern int allFlagsVersion;
 static void
 output(const char *filename)
 {
+    // Files named *.bin or *.bin.gz get the raw messages, to be
+    // formatted offline by util/decode_debug_trace.py
+    auto ends_with = [filename](const char *suffix) {
+        const size_t len = strlen(filename), slen = strlen(suffix);
+        return len >= slen && strcmp(filename + len - slen, suffix) == 0;
+    };
+    const bool binary = ends_with(".bin") || ends_with(".bin.gz");
+
     OutputStream *file_stream = simout.find(filename);
 
     if (!file_stream)
-        file_stream = simout.create(filename);
-
-    Trace::setDebugLogger(new Trace::OstreamLogger(*file_stream->stream()));
+        file_stream = simout.create(filename, binary);
+
+    if (binary) {
+        Trace::setDebugLogger(
+            new Trace::BinaryLogger(*file_stream->stream()));
+    } else {
+        Trace::setDebugLogger(
+            new Trace::OstreamLogger(*file_stream->stream()));
+    }
 }
 
 static void
@@ -115,5 +131,6 @@ pybind_init_debug(py::module &m_native)
         .def("ignore", &ignore)
         .def("enable", &Trace::enable)
         .def("disable", &Trace::disable)
+        .def("history", &Trace::setHistory)
         ;
 }
@@ -43,10 +43,13 @@
 
 #include "config/use_hdf5.hh"
 
+#include "pybind11/numpy.h"
 #include "pybind11/pybind11.h"
 #include "pybind11/stl.h"
 
 #include "base/statistics.hh"
+#include "base/stats/binary.hh"
+#include "base/stats/index.hh"
 #include "base/stats/text.hh"
 #if USE_HDF5
 #include "base/stats/hdf5.hh"
@@ -83,6 +86,7 @@ pybind_init_stats(py::module &m_native)
     m
         .def("initSimStats", &Stats::initSimStats)
         .def("initText", &Stats::initText, py::return_value_policy::reference)
+        .def("initBinary", &Stats::initBinary)
 #if USE_HDF5
         .def("initHDF5", &Stats::initHDF5)
 #endif
@@ -90,12 +94,39 @@ pybind_init_stats(py::module &m_native)
              &Stats::registerPythonStatsHandlers)
         .def("schedStatEvent", &Stats::schedStatEvent)
         .def("periodicStatDump", &Stats::periodicStatDump)
+        .def("enableHostCounters", &Stats::enableHostCounters)
         .def("updateEvents", &Stats::updateEvents)
         .def("processResetQueue", &Stats::processResetQueue)
         .def("processDumpQueue", &Stats::processDumpQueue)
         .def("enable", &Stats::enable)
         .def("enabled", &Stats::enabled)
         .def("statsList", &Stats::statsList)
+
+        .def("buildIndex", [](Stats::Group *root) {
+                Stats::statsIndex().build(root);
+            })
+        .def("enableIndexedStats", []() { Stats::statsIndex().enable(); })
+        .def("filterStats", [](const std::vector<std::string> &allow,
+                               const std::vector<std::string> &deny) {
+                Stats::statsIndex().filter(allow, deny);
+            })
+        .def("prepareAll", []() { Stats::statsIndex().prepare(); })
+        .def("visitAll", [](Stats::Output &output) {
+                Stats::statsIndex().visit(output);
+            })
+        .def("resetLegacyStats", []() { Stats::statsIndex().resetLegacy(); })
+        .def("findStat", [](const std::string &name) {
+                return Stats::statsIndex().find(name);
+            }, py::return_value_policy::reference)
+        .def("findStats", [](const std::string &pattern) {
+                return Stats::statsIndex().matchNames(pattern);
+            })
+        .def("statValues", [](const std::vector<std::string> &names) {
+                const std::vector<Stats::Result> values =
+                    Stats::statsIndex().values(names);
+                return py::array_t<Stats::Result>(values.size(),
+                                                  values.data());
+            })
         ;
 
     py::class_<Stats::Output>(m, "Output")
@@ -117,6 +148,7 @@ pybind_init_stats(py::module &m_native)
         .def("check", &Stats::Info::check)
         .def("baseCheck", &Stats::Info::baseCheck)
         .def("enable", &Stats::Info::enable)
+        .def("disable", &Stats::Info::disable)
         .def("prepare", &Stats::Info::prepare)
         .def("reset", &Stats::Info::reset)
         .def("zero", &Stats::Info::zero)
@@ -72,6 +72,10 @@ class SrcClockDomain(ClockDomain):
     # Defaults to maximum performance
     init_perf_level = Param.UInt32(0, "Initial performance level")
 
+    # Period in ticks of the initial performance level
+    def clockPeriod(self):
+        return self.clock[int(self.init_perf_level)].getValue()
+
 # Derived clock domain with a parent clock domain and a frequency
 # divider
 class DerivedClockDomain(ClockDomain):
@@ -79,3 +83,6 @@ class DerivedClockDomain(ClockDomain):
     cxx_header = "sim/clock_domain.hh"
     clk_domain = Param.ClockDomain("Parent clock domain")
     clk_divider = Param.Unsigned(1, "Frequency divider")
+
+    def clockPeriod(self):
+        return self.clk_domain.clockPeriod() * int(self.clk_divider)
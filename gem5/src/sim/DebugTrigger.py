@@ -0,0 +1,69 @@
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+from m5.params import *
+from m5.proxy import *
+from m5.SimObject import SimObject
+
+class DebugTriggerAction(Enum): vals = ['start', 'stop']
+
+class DebugTrigger(SimObject):
+    """Start or stop debug tracing when a condition is met during the
+    simulation. A trigger fires when any of its conditions is met: an
+    instruction at 'pc' commits on one of 'cpus', a packet to
+    'addr_ranges' goes through one of 'mem_managers', 'stat' reaches
+    'threshold', or the pseudo-op 'pseudo_op' runs. A start trigger
+    disables the tracing it controls until it fires. Combined with
+    --debug-history, the messages leading to the trigger are written out
+    as well."""
+    type = 'DebugTrigger'
+    cxx_header = "sim/debug_trigger.hh"
+
+    action = Param.DebugTriggerAction('start', "Start or stop tracing")
+    flags = VectorParam.String([], "Debug flags to enable or disable "
+                               "(all tracing if empty)")
+    delay = Param.Latency('0t', "Delay between the trigger and the action")
+    count = Param.Unsigned(1, "Number of times the trigger can fire "
+                           "(0 for no limit)")
+
+    pc = Param.Addr(MaxAddr, "PC of the instruction to trigger on")
+    cpus = VectorParam.SimObject([], "CPUs to watch for 'pc'")
+    pc_probe_name = Param.String("RetiredInstsPC",
+                                 "Probe of the committed PCs")
+
+    addr_ranges = VectorParam.AddrRange([], "Addresses to trigger on")
+    mem_managers = VectorParam.SimObject([],
+                                         "Probe managers to watch for "
+                                         "'addr_ranges'")
+    mem_probe_name = Param.String("PktRequest", "Memory request probe")
+
+    stat = Param.String("", "Name of a scalar or vector stat to watch")
+    threshold = Param.Float(0.0, "Value of 'stat' to trigger on")
+    stat_period = Param.Latency('1us', "Period of the checks of 'stat'")
+
+    pseudo_op = Param.Int(-1, "Function number of the pseudo-op to "
+                          "trigger on (-1 for none)")
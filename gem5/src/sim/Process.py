@@ -46,6 +46,8 @@ class Process(SimObject):
     useArchPT = Param.Bool('false', 'maintain an in-memory version of the page\
                             table in an architecture-specific format')
     kvmInSE = Param.Bool('false', 'initialize the process for KvmCPU in SE')
+    lazyLoad = Param.Bool(True, 'load each page of the executable when it '
+                          'is first touched')
     maxStackSize = Param.MemorySize('64MB', 'maximum size of the stack')
 
     uid = Param.Int(100, 'user id')
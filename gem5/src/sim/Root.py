@@ -32,6 +32,9 @@ from m5.SimObject import SimObject
 from m5.params import *
 from m5.util import fatal
 
+class EventQueueBackend(Enum): vals = ['linked_list', 'calendar']
+class EventQueueReplay(Enum): vals = ['off', 'record', 'replay']
+
 class Root(SimObject):
 
     _the_instance = None
@@ -68,6 +71,38 @@ class Root(SimObject):
     # Needs to be set explicitly for a multi-eventq simulation.
     sim_quantum = Param.Tick(0, "simulation quantum")
 
+    # Let the quantum grow up to sim_quantum_max while the queues don't
+    # schedule events on each other. It falls back to sim_quantum as soon
+    # as they do. Events that arrive late are moved to the receiver's
+    # current tick.
+    sim_quantum_max = Param.Tick(0, "maximum adaptive simulation quantum "
+                                 "(0 for a fixed quantum)")
+
+    # Synchronize the main event queues using the latencies of the links
+    # (bridges, crossbars, serial links) that connect them. The queues
+    # still meet every sim_quantum, which can then be set much larger.
+    lookahead_sync = Param.Bool(False, "use link-latency lookahead to "
+                                "synchronize multiple event queues")
+
+    # Record the order in which the event queues pick up the events
+    # scheduled by other threads, or replay it from an earlier run, to
+    # make multi-queue simulation deterministic. Needs a fixed quantum
+    # (lookahead_sync disabled).
+    eventq_replay = Param.EventQueueReplay('off', "record or replay the "
+                                           "cross-queue event order")
+    eventq_replay_log = Param.String("eventq_replay.log", "replay log, "
+                                     "in the output directory if recording")
+
+    # Sample the host time spent servicing events, see eventprofile.txt
+    # in the output directory
+    event_profile_interval = Param.UInt32(0, "time one in this many events "
+                                          "(0 to disable)")
+
+    # Data structure used to sort the pending events of the main event
+    # queues. Both backends service events in exactly the same order.
+    eventq_backend = Param.EventQueueBackend('linked_list',
+        "data structure used to sort pending events")
+
     full_system = Param.Bool("if this is a full system simulation")
 
     # Time syncing prevents the simulation from running faster than real time.
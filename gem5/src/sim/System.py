@@ -76,6 +76,42 @@ class System(SimObject):
     mmap_using_noreserve = Param.Bool(False, "mmap the backing store " \
                                           "without reserving swap")
 
+    # Large memories see a lot of host TLB misses when accessed through
+    # the backing store. The backing store can be backed by huge pages,
+    # either from the preallocated hugetlbfs pool (MAP_HUGETLB), or by
+    # asking for transparent huge pages. If huge pages are not
+    # available, the backing store falls back to normal pages.
+    mmap_using_hugetlb = Param.Bool(False, "mmap the backing store " \
+                                        "using hugetlbfs pages")
+    mmap_using_thp = Param.Bool(False, "Advise transparent huge pages " \
+                                    "for the backing store")
+
+    # Checkpoints normally store the backing store compressed, and a
+    # restore has to decompress all of it. Raw stores are written as
+    # sparse uncompressed files that a restore maps copy-on-write, so
+    # restoring is constant time and untouched pages are never read.
+    raw_checkpoint_stores = Param.Bool(False, "Checkpoint the backing " \
+                                           "store uncompressed for mmap")
+    # Compressed stores are split into chunks that are compressed and
+    # decompressed in parallel.
+    checkpoint_store_threads = Param.Unsigned(0, "Threads compressing the " \
+        "backing store in checkpoints, 0 for one per host core")
+    # Delta stores only hold the pages that changed since the previous
+    # checkpoint of the run, or since the checkpoint it was restored
+    # from, and refer to the store of that checkpoint for the rest.
+    delta_checkpoints = Param.Bool(False, "Only store the pages changed " \
+        "since the previous checkpoint")
+    # Lazy restores decompress the chunks of a compressed store the
+    # first time they are touched, rather than all of them up front.
+    lazy_checkpoint_restore = Param.Bool(False, "Restore the backing " \
+        "store on demand as its pages are touched")
+    # Compressed stores can instead be decompressed once to an image
+    # in a common directory, which all the processes restoring the
+    # checkpoint map copy-on-write and share until they write to it.
+    # The images are not cleaned up.
+    checkpoint_image_dir = Param.String("", "Directory of the memory " \
+        "images shared between restores, empty to restore privately")
+
     # The memory ranges are to be populated when creating the system
     # such that these can be passed from the I/O subsystem through an
     # I/O bridge or cache
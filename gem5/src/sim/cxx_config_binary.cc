@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "sim/cxx_config_binary.hh"
+
+#include <cstring>
+#include <fstream>
+
+#include "base/logging.hh"
+#include "base/str.hh"
+
+namespace {
+
+const char binaryConfigMagic[] = "GCFG";
+const uint32_t binaryConfigVersion = 1;
+
+bool
+getU32(std::istream &is, uint32_t &val)
+{
+    unsigned char buf[4];
+    if (!is.read(reinterpret_cast<char *>(buf), sizeof(buf)))
+        return false;
+
+    val = 0;
+    for (int i = 0; i < 4; ++i)
+        val |= uint32_t(buf[i]) << (8 * i);
+    return true;
+}
+
+bool
+getU64(std::istream &is, uint64_t &val)
+{
+    uint32_t low, high;
+    if (!getU32(is, low) || !getU32(is, high))
+        return false;
+
+    val = uint64_t(high) << 32 | low;
+    return true;
+}
+
+bool
+getString(std::istream &is, std::string &str)
+{
+    uint32_t len;
+    if (!getU32(is, len))
+        return false;
+
+    str.resize(len);
+    return len == 0 || is.read(&str[0], len);
+}
+
+} // anonymous namespace
+
+const std::string *
+CxxBinaryConfig::findEntry(const std::string &object_name,
+    const std::string &entry_name) const
+{
+    auto obj = objects.find(object_name);
+    if (obj == objects.end())
+        return nullptr;
+
+    auto entry = obj->second.find(entry_name);
+    if (entry == obj->second.end())
+        return nullptr;
+
+    return &entry->second;
+}
+
+bool
+CxxBinaryConfig::getParam(const std::string &object_name,
+    const std::string &param_name,
+    std::string &value) const
+{
+    const std::string *entry = findEntry(object_name, param_name);
+    if (entry)
+        value = *entry;
+
+    return entry != nullptr;
+}
+
+bool
+CxxBinaryConfig::getParamVector(const std::string &object_name,
+    const std::string &param_name,
+    std::vector<std::string> &values) const
+{
+    const std::string *entry = findEntry(object_name, param_name);
+    if (entry)
+        tokenize(values, *entry, ' ', true);
+
+    return entry != nullptr;
+}
+
+bool
+CxxBinaryConfig::getPortPeers(const std::string &object_name,
+    const std::string &port_name,
+    std::vector<std::string> &peers) const
+{
+    return getParamVector(object_name, port_name, peers);
+}
+
+bool
+CxxBinaryConfig::objectExists(const std::string &object_name) const
+{
+    return objects.find(object_name) != objects.end();
+}
+
+void
+CxxBinaryConfig::getAllObjectNames(std::vector<std::string> &list) const
+{
+    list.insert(list.end(), objectNames.begin(), objectNames.end());
+}
+
+void
+CxxBinaryConfig::getObjectChildren(const std::string &object_name,
+    std::vector<std::string> &children, bool return_paths) const
+{
+    if (!getParamVector(object_name, "children", children))
+        return;
+
+    if (return_paths && object_name != "root") {
+        for (auto i = children.begin(); i != children.end(); ++i)
+            *i = object_name + "." + *i;
+    }
+}
+
+bool
+CxxBinaryConfig::load(const std::string &filename)
+{
+    std::ifstream is(filename, std::ios::in | std::ios::binary);
+    if (!is)
+        return false;
+
+    char magic[4];
+    uint32_t version;
+    if (!is.read(magic, sizeof(magic)) ||
+        std::memcmp(magic, binaryConfigMagic, sizeof(magic)) != 0 ||
+        !getU32(is, version)) {
+        warn("%s is not a compiled config\n", filename);
+        return false;
+    }
+
+    if (version != binaryConfigVersion) {
+        warn("%s: Unsupported compiled config version %d\n",
+             filename, version);
+        return false;
+    }
+
+    uint32_t num_objects;
+    if (!getU64(is, ticksPerSecond) || !getU32(is, num_objects))
+        return false;
+
+    objects.clear();
+    objectNames.clear();
+    objectNames.reserve(num_objects);
+
+    for (uint32_t i = 0; i < num_objects; ++i) {
+        std::string path;
+        uint32_t num_entries;
+        if (!getString(is, path) || !getU32(is, num_entries))
+            return false;
+
+        Entries &entries = objects[path];
+        objectNames.push_back(path);
+        for (uint32_t j = 0; j < num_entries; ++j) {
+            std::string name, value;
+            if (!getString(is, name) || !getString(is, value))
+                return false;
+            entries[name] = std::move(value);
+        }
+    }
+
+    return true;
+}
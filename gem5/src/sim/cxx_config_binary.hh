@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/**
+ * @file
+ *
+ *  Compiled config reading wrapper for use with CxxConfigManager
+ */
+
+#ifndef __SIM_CXX_CONFIG_BINARY_HH__
+#define __SIM_CXX_CONFIG_BINARY_HH__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "sim/cxx_config.hh"
+
+/**
+ * CxxConfigManager interface for compiled configs. A compiled config
+ * holds the same objects and values as a config.ini, in a binary form
+ * written by m5.instantiate() (see --compile-config) that is quicker
+ * to read. It also records the global tick frequency so that the
+ * config can be instantiated without the Python Root.
+ *
+ * The format, all integers being little endian, is:
+ *   "GCFG", u32 version, u64 ticks per second, u32 number of objects,
+ *   and for each object:
+ *     string path, u32 number of entries, and for each entry:
+ *       string name, string value
+ * where strings are a u32 length followed by the characters.
+ */
+class CxxBinaryConfig : public CxxConfigFileBase
+{
+  protected:
+    typedef std::map<std::string, std::string> Entries;
+
+    /** Entries of the objects, by path */
+    std::map<std::string, Entries> objects;
+
+    /** Object paths in file order */
+    std::vector<std::string> objectNames;
+
+    Tick ticksPerSecond;
+
+    const std::string *findEntry(const std::string &object_name,
+        const std::string &entry_name) const;
+
+  public:
+    CxxBinaryConfig() : ticksPerSecond(0) { }
+
+    bool getParam(const std::string &object_name,
+        const std::string &param_name,
+        std::string &value) const;
+
+    bool getParamVector(const std::string &object_name,
+        const std::string &param_name,
+        std::vector<std::string> &values) const;
+
+    bool getPortPeers(const std::string &object_name,
+        const std::string &port_name,
+        std::vector<std::string> &peers) const;
+
+    bool objectExists(const std::string &object_name) const;
+
+    void getAllObjectNames(std::vector<std::string> &list) const;
+
+    void getObjectChildren(const std::string &object_name,
+        std::vector<std::string> &children,
+        bool return_paths = false) const;
+
+    bool load(const std::string &filename);
+
+    /** Global tick frequency the config was resolved with */
+    Tick frequency() const { return ticksPerSecond; }
+};
+
+#endif // __SIM_CXX_CONFIG_BINARY_HH__
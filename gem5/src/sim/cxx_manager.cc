@@ -589,7 +589,30 @@ CxxConfigManager::forEachObject(void (SimObject::*mem_func)())
 }
 
 void
-CxxConfigManager::instantiate(bool build_all)
+CxxConfigManager::bindStatGroups()
+{
+    for (auto i = objectsByName.begin(); i != objectsByName.end(); ++i) {
+        const std::string &object_name = i->first;
+        if (object_name == "root")
+            continue;
+
+        std::size_t dot_i = object_name.rfind('.');
+        std::string parent_name = dot_i == std::string::npos ?
+            "root" : object_name.substr(0, dot_i);
+        std::string group_name = object_name.substr(dot_i + 1);
+
+        auto parent = objectsByName.find(parent_name);
+        if (parent == objectsByName.end())
+            throw Exception(object_name, "Can't find parent stat group");
+
+        DPRINTF(CxxConfig, "Binding stat group %s to %s\n",
+            group_name, parent_name);
+        parent->second->addStatGroup(group_name.c_str(), i->second);
+    }
+}
+
+void
+CxxConfigManager::instantiate(bool build_all, bool stat_hierarchy)
 {
     if (build_all) {
         findAllObjects();
@@ -600,7 +623,13 @@ CxxConfigManager::instantiate(bool build_all)
     forEachObject(&SimObject::init);
 
     DPRINTF(CxxConfig, "Registering stats\n");
-    forEachObject(&SimObject::regStats);
+    if (stat_hierarchy) {
+        bindStatGroups();
+        // Registering the root registers the stats of all the groups
+        findObject("root")->regStats();
+    } else {
+        forEachObject(&SimObject::regStats);
+    }
 
     DPRINTF(CxxConfig, "Registering probe points\n");
     forEachObject(&SimObject::regProbePoints);
@@ -273,8 +273,17 @@ class CxxConfigManager
      *
      *  If you want to set some parameters before completing instantiation,
      *  call findObjectParams on the objects you want to modify, then call
-     *  instantiate */
-    void instantiate(bool build_all = true);
+     *  instantiate.
+     *
+     *  If stat_hierarchy is true, the objects are added to the stat
+     *  groups of their parents (see bindStatGroups) and their stats are
+     *  registered from the root object, as m5.instantiate() does */
+    void instantiate(bool build_all = true, bool stat_hierarchy = false);
+
+    /** Add each object to the stat group of its parent in the config,
+     *  under the last component of its name, so that the stats of all
+     *  the objects can be reached from the root object */
+    void bindStatGroups();
 
     /** Call initState on all objects */
     void initState();
@@ -0,0 +1,224 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/debug_trigger.hh"
+
+#include <algorithm>
+
+#include "base/logging.hh"
+#include "base/stats/info.hh"
+#include "base/trace.hh"
+#include "debug/DebugTrigger.hh"
+#include "params/DebugTrigger.hh"
+
+std::vector<DebugTrigger *> DebugTrigger::pseudoOpTriggers;
+
+DebugTrigger::DebugTrigger(DebugTriggerParams *p)
+    : SimObject(p),
+      start(p->action == Enums::start),
+      delay(p->delay), count(p->count), fired(0),
+      pc(p->pc), addrRanges(p->addr_ranges),
+      statName(p->stat), threshold(p->threshold),
+      statPeriod(p->stat_period), stat(nullptr), belowThreshold(true),
+      pseudoOpFunc(p->pseudo_op),
+      actEvent([this]{ act(); }, name() + ".act", false,
+               Event::Debug_Enable_Pri),
+      statEvent([this]{ checkStat(); }, name() + ".checkStat", false,
+                Event::Stat_Event_Pri)
+{
+    for (const auto &flag_name : p->flags) {
+        Debug::Flag *flag = Debug::findFlag(flag_name);
+        fatal_if(!flag, "%s: Unknown debug flag '%s'.", name(), flag_name);
+        flags.push_back(flag);
+    }
+
+    fatal_if(!p->cpus.empty() && pc == MaxAddr,
+             "%s: CPUs to watch, but no PC to trigger on.", name());
+    fatal_if(!p->mem_managers.empty() && addrRanges.empty(),
+             "%s: Probe managers to watch, but no addresses to trigger on.",
+             name());
+    fatal_if(!statName.empty() && statPeriod == 0,
+             "%s: The stat period can't be 0.", name());
+
+    if (pseudoOpFunc >= 0)
+        pseudoOpTriggers.push_back(this);
+}
+
+DebugTrigger::~DebugTrigger()
+{
+    for (auto it = pseudoOpTriggers.begin(); it != pseudoOpTriggers.end();
+         ++it) {
+        if (*it == this) {
+            pseudoOpTriggers.erase(it);
+            break;
+        }
+    }
+}
+
+void
+DebugTrigger::init()
+{
+    SimObject::init();
+
+    if (!start)
+        return;
+
+    if (flags.empty()) {
+        Trace::disable();
+    } else {
+        for (auto flag : flags)
+            flag->disable();
+    }
+}
+
+void
+DebugTrigger::startup()
+{
+    SimObject::startup();
+
+    if (statName.empty())
+        return;
+
+    // The stats get their final names once they have been registered
+    for (auto info : Stats::statsList()) {
+        if (info->name == statName) {
+            stat = info;
+            break;
+        }
+    }
+    fatal_if(!stat, "%s: Unknown stat '%s'.", name(), statName);
+    fatal_if(!dynamic_cast<Stats::ScalarInfo *>(stat) &&
+             !dynamic_cast<Stats::VectorInfo *>(stat),
+             "%s: Stat '%s' is neither a scalar nor a vector.", name(),
+             statName);
+
+    belowThreshold = statValue() < threshold;
+    schedule(statEvent, curTick() + statPeriod);
+}
+
+void
+DebugTrigger::regProbeListeners()
+{
+    const DebugTriggerParams *p(
+        dynamic_cast<const DebugTriggerParams *>(params()));
+    assert(p);
+
+    for (auto obj : p->cpus) {
+        pcListeners.emplace_back(new PCListener(
+            *this, obj->getProbeManager(), p->pc_probe_name));
+    }
+
+    for (auto obj : p->mem_managers) {
+        packetListeners.emplace_back(new PacketListener(
+            *this, obj->getProbeManager(), p->mem_probe_name));
+    }
+}
+
+void
+DebugTrigger::PacketListener::notify(const ProbePoints::PacketInfo &pkt_info)
+{
+    const AddrRange pkt_range =
+        RangeSize(pkt_info.addr, std::max<Addr>(pkt_info.size, 1));
+    for (const auto &range : parent.addrRanges) {
+        if (range.intersects(pkt_range)) {
+            parent.fire();
+            return;
+        }
+    }
+}
+
+void
+DebugTrigger::pseudoOp(uint8_t func)
+{
+    for (auto trigger : pseudoOpTriggers) {
+        if (trigger->pseudoOpFunc == func)
+            trigger->fire();
+    }
+}
+
+void
+DebugTrigger::fire()
+{
+    if (count != 0 && fired >= count)
+        return;
+
+    ++fired;
+    DPRINTF(DebugTrigger, "Fired (%d)\n", fired);
+
+    if (delay == 0)
+        act();
+    else if (!actEvent.scheduled())
+        schedule(actEvent, curTick() + delay);
+}
+
+void
+DebugTrigger::act()
+{
+    if (flags.empty()) {
+        if (start)
+            Trace::enable();
+        else
+            Trace::disable();
+        return;
+    }
+
+    for (auto flag : flags) {
+        if (start)
+            flag->enable();
+        else
+            flag->disable();
+    }
+}
+
+Stats::Result
+DebugTrigger::statValue() const
+{
+    if (auto scalar = dynamic_cast<const Stats::ScalarInfo *>(stat))
+        return scalar->result();
+    return static_cast<const Stats::VectorInfo *>(stat)->total();
+}
+
+void
+DebugTrigger::checkStat()
+{
+    // Fire when the stat crosses the threshold, not while it stays
+    // above it
+    const bool below = statValue() < threshold;
+    if (belowThreshold && !below)
+        fire();
+    belowThreshold = below;
+
+    if (count == 0 || fired < count)
+        schedule(statEvent, curTick() + statPeriod);
+}
+
+DebugTrigger *
+DebugTriggerParams::create()
+{
+    return new DebugTrigger(this);
+}
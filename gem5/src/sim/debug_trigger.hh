@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __SIM_DEBUG_TRIGGER_HH__
+#define __SIM_DEBUG_TRIGGER_HH__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/addr_range.hh"
+#include "base/debug.hh"
+#include "base/statistics.hh"
+#include "enums/DebugTriggerAction.hh"
+#include "sim/eventq.hh"
+#include "sim/probe/mem.hh"
+#include "sim/probe/pmu.hh"
+#include "sim/sim_object.hh"
+
+struct DebugTriggerParams;
+
+/**
+ * Starts or stops debug tracing when a condition is met, instead of at
+ * a fixed tick like --debug-start and --debug-end. The conditions are
+ * the commit of an instruction at a given PC, an access to a range of
+ * addresses, a stat reaching a threshold and a pseudo-op, and the
+ * trigger fires when any of them is met. The PCs and addresses come
+ * from probes, so that nothing is added to the simulation of the
+ * objects that aren't watched.
+ *
+ * The trigger either starts or stops the tracing controlled by
+ * Trace::enable() and Trace::disable(), or enables or disables a set
+ * of debug flags. A start trigger holds its tracing off from the
+ * start of the simulation until it fires.
+ */
+class DebugTrigger : public SimObject
+{
+  public:
+    DebugTrigger(DebugTriggerParams *p);
+    ~DebugTrigger();
+
+    void init() override;
+    void startup() override;
+    void regProbeListeners() override;
+
+    /** Fire the triggers waiting for a pseudo-op */
+    static void pseudoOp(uint8_t func);
+
+  protected:
+    class PCListener : public ProbeListenerArgBase<uint64_t>
+    {
+      public:
+        PCListener(DebugTrigger &_parent, ProbeManager *pm,
+                   const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent)
+        {}
+
+        void
+        notify(const uint64_t &pc) override
+        {
+            if (pc == parent.pc)
+                parent.fire();
+        }
+
+      protected:
+        DebugTrigger &parent;
+    };
+
+    class PacketListener
+        : public ProbeListenerArgBase<ProbePoints::PacketInfo>
+    {
+      public:
+        PacketListener(DebugTrigger &_parent, ProbeManager *pm,
+                       const std::string &name)
+            : ProbeListenerArgBase(pm, name), parent(_parent)
+        {}
+
+        void notify(const ProbePoints::PacketInfo &pkt_info) override;
+
+      protected:
+        DebugTrigger &parent;
+    };
+
+    /** Schedule the action, unless the trigger has fired enough */
+    void fire();
+
+    /** Start or stop tracing */
+    void act();
+
+    /** Check the stat and fire if it reached the threshold */
+    void checkStat();
+
+    /** Current value of the stat */
+    Stats::Result statValue() const;
+
+    const bool start;
+    std::vector<Debug::Flag *> flags;
+    const Tick delay;
+    const unsigned count;
+    unsigned fired;
+
+    const Addr pc;
+    const std::vector<AddrRange> addrRanges;
+
+    const std::string statName;
+    const Stats::Result threshold;
+    const Tick statPeriod;
+    Stats::Info *stat;
+    /** Was the stat below the threshold at the last check? */
+    bool belowThreshold;
+
+    const int pseudoOpFunc;
+
+    std::vector<std::unique_ptr<PCListener>> pcListeners;
+    std::vector<std::unique_ptr<PacketListener>> packetListeners;
+
+    EventFunctionWrapper actEvent;
+    EventFunctionWrapper statEvent;
+
+    /** Triggers waiting for a pseudo-op */
+    static std::vector<DebugTrigger *> pseudoOpTriggers;
+};
+
+#endif // __SIM_DEBUG_TRIGGER_HH__
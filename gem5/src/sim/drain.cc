@@ -68,16 +68,22 @@ DrainManager::tryDrain()
     panic_if(_count != 0,
              "Drain counter must be zero at the start of a drain cycle\n");
 
-    DPRINTF(Drain, "Trying to drain %u objects.\n", drainableCount());
     _state = DrainState::Draining;
-    for (auto *obj : _allDrainable) {
-        DrainState status = obj->dmDrain();
-        if (DTRACE(Drain) && status != DrainState::Drained) {
-            SimObject *temp = dynamic_cast<SimObject*>(obj);
-            if (temp)
-                DPRINTF(Drain, "Failed to drain %s\n", temp->name());
-        }
-        _count += status == DrainState::Drained ? 0 : 1;
+
+    // Another round is needed anyway if an object that was busy in
+    // the previous round still is, so don't bother with the rest.
+    std::vector<Drainable *> busy;
+    busy.swap(_busyDrainable);
+    if (!busy.empty()) {
+        DPRINTF(Drain, "Trying to drain %u busy objects.\n", busy.size());
+        for (auto *obj : busy)
+            drainOne(obj);
+    }
+
+    if (_count == 0) {
+        DPRINTF(Drain, "Trying to drain %u objects.\n", drainableCount());
+        for (auto *obj : _allDrainable)
+            drainOne(obj);
     }
 
     if (_count == 0) {
@@ -91,6 +97,22 @@ DrainManager::tryDrain()
     }
 }
 
+void
+DrainManager::drainOne(Drainable *obj)
+{
+    DrainState status = obj->dmDrain();
+    if (status == DrainState::Drained)
+        return;
+
+    if (DTRACE(Drain)) {
+        SimObject *temp = dynamic_cast<SimObject*>(obj);
+        if (temp)
+            DPRINTF(Drain, "Failed to drain %s\n", temp->name());
+    }
+    _count++;
+    _busyDrainable.push_back(obj);
+}
+
 void
 DrainManager::resume()
 {
@@ -115,6 +137,7 @@ DrainManager::resume()
     // DrainManager, which means we have to resume objects until all
     // objects are in the Running state.
     _state = DrainState::Resuming;
+    _busyDrainable.clear();
 
     do {
         DPRINTF(Drain, "Resuming %u objects.\n", drainableCount());
@@ -171,6 +194,10 @@ DrainManager::unregisterDrainable(Drainable *obj)
     auto o = std::find(_allDrainable.begin(), _allDrainable.end(), obj);
     assert(o != _allDrainable.end());
     _allDrainable.erase(o);
+
+    auto b = std::find(_busyDrainable.begin(), _busyDrainable.end(), obj);
+    if (b != _busyDrainable.end())
+        _busyDrainable.erase(b);
 }
 
 bool
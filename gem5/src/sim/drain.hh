@@ -113,6 +113,13 @@ class DrainManager
      * this method should be called again. This cycle should continue
      * until this method returns true.
      *
+     * Objects that were still draining in the previous call are
+     * drained first. If any of them is still busy, the other objects
+     * aren't polled, which makes every call but the first and the
+     * last cost O(busy objects). The last call always polls all
+     * objects since draining one object may have made another one
+     * busy again.
+     *
      * @return true if all objects were drained successfully, false if
      * more simulation is needed.
      */
@@ -153,6 +160,12 @@ class DrainManager
     void unregisterDrainable(Drainable *obj);
 
   private:
+    /**
+     * Drain an object, and count and remember it if it isn't done
+     * yet.
+     */
+    void drainOne(Drainable *obj);
+
     /**
      * Helper function to check if all Drainable objects are in a
      * specific state.
@@ -171,6 +184,9 @@ class DrainManager
     /** Set of all drainable objects */
     std::vector<Drainable *> _allDrainable;
 
+    /** Objects that were still draining at the end of the last round */
+    std::vector<Drainable *> _busyDrainable;
+
     /**
      * Number of objects still draining. This is flagged atomic since
      * it can be manipulated by SimObjects living in different
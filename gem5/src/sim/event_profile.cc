@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_profile.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <vector>
+
+#include "base/callback.hh"
+#include "base/cprintf.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+
+namespace {
+
+std::mutex profilesMutex;
+std::vector<EventProfile *> profiles;
+
+struct DumpCallback : public Callback
+{
+    void process() override { EventProfile::dumpAll(); }
+};
+
+DumpCallback dumpCallback;
+
+//! Strip the suffix added to the object name by the event wrappers.
+std::string
+objectName(const std::string &name)
+{
+    const auto pos = name.rfind(".wrapped_");
+    return pos == std::string::npos ? name : name.substr(0, pos);
+}
+
+} // anonymous namespace
+
+EventProfile::EventProfile(const std::string &queue_name, unsigned _interval)
+    : queueName(queue_name), interval(_interval), countdown(_interval)
+{
+    assert(interval > 0);
+
+    std::lock_guard<std::mutex> lock(profilesMutex);
+    if (profiles.empty())
+        registerExitCallback(&dumpCallback);
+    profiles.push_back(this);
+}
+
+void
+EventProfile::sampledProcess(Event *event)
+{
+    // The event may delete itself, so get its name first. Events that
+    // don't name themselves would get a different name per instance,
+    // so only keep their description.
+    std::string name = event->name();
+    if (name == event->Event::name())
+        name = "(unnamed)";
+    Entry &entry = entries[Key(objectName(name), event->description())];
+
+    const auto start = std::chrono::steady_clock::now();
+    event->process();
+    const auto end = std::chrono::steady_clock::now();
+
+    entry.samples++;
+    entry.hostNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+        end - start).count();
+}
+
+void
+EventProfile::dumpAll()
+{
+    std::lock_guard<std::mutex> lock(profilesMutex);
+
+    std::map<Key, Entry> merged;
+    uint64_t total_ns = 0;
+    for (const auto p : profiles) {
+        for (const auto &e : p->entries) {
+            Entry &m = merged[e.first];
+            m.samples += e.second.samples * p->interval;
+            m.hostNs += e.second.hostNs * p->interval;
+            total_ns += e.second.hostNs * p->interval;
+        }
+    }
+
+    std::vector<std::pair<Key, Entry>> sorted(merged.begin(), merged.end());
+    std::sort(sorted.begin(), sorted.end(),
+              [](const std::pair<Key, Entry> &a,
+                 const std::pair<Key, Entry> &b)
+              { return a.second.hostNs > b.second.hostNs; });
+
+    OutputStream *table = simout.create("eventprofile.txt");
+    std::ostream &os = *table->stream();
+    ccprintf(os, "# Host time spent servicing events, estimated from 1 in "
+             "%d events\n", profiles.empty() ? 0 : profiles[0]->interval);
+    ccprintf(os, "# %7s %12s %14s %10s  %s\n", "time(%)", "host(s)",
+             "events", "ns/event", "object description");
+    for (const auto &e : sorted) {
+        const Entry &m = e.second;
+        ccprintf(os, "%9.2f %12.3f %14d %10.1f  %s %s\n",
+                 total_ns ? 100.0 * m.hostNs / total_ns : 0.0,
+                 m.hostNs / 1e9, m.samples, (double)m.hostNs / m.samples,
+                 e.first.first, e.first.second);
+    }
+    simout.close(table);
+
+    // One frame per queue, level of the object hierarchy, and event
+    // description, weighted by the host time in ns.
+    OutputStream *folded = simout.create("eventprofile.folded");
+    for (const auto p : profiles) {
+        for (const auto &e : p->entries) {
+            std::string stack = e.first.first;
+            std::replace(stack.begin(), stack.end(), '.', ';');
+            ccprintf(*folded->stream(), "%s;%s;%s %d\n", p->queueName,
+                     stack, e.first.second, e.second.hostNs * p->interval);
+        }
+    }
+    simout.close(folded);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Sampling profiler of the host time spent servicing events
+ */
+
+#ifndef __SIM_EVENT_PROFILE_HH__
+#define __SIM_EVENT_PROFILE_HH__
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/types.hh"
+#include "sim/eventq.hh"
+
+/**
+ * Host time and number of events serviced by one event queue,
+ * attributed to the name of the event (usually the name of the owning
+ * SimObject) and its description.
+ *
+ * Only every Nth event is timed, and the totals are extrapolated from
+ * the samples, so the overhead of the events that are not sampled is a
+ * single counter decrement. The profiles of all queues are merged and
+ * written to eventprofile.txt, sorted by host time, and to
+ * eventprofile.folded, in the folded stack format used by flamegraph
+ * tools, in the output directory when the simulator exits.
+ */
+class EventProfile
+{
+  private:
+    typedef std::pair<std::string, std::string> Key;
+
+    struct Entry
+    {
+        Counter samples;
+        uint64_t hostNs;
+
+        Entry() : samples(0), hostNs(0) {}
+    };
+
+    const std::string queueName;
+    const unsigned interval;
+    unsigned countdown;
+    std::map<Key, Entry> entries;
+
+    void sampledProcess(Event *event);
+
+  public:
+    EventProfile(const std::string &queue_name, unsigned interval);
+
+    //! Process an event, timing it if it is sampled.
+    void
+    process(Event *event)
+    {
+        if (--countdown) {
+            event->process();
+        } else {
+            countdown = interval;
+            sampledProcess(event);
+        }
+    }
+
+    //! Write the merged profiles of all event queues.
+    static void dumpAll();
+};
+
+#endif // __SIM_EVENT_PROFILE_HH__
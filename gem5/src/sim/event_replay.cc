@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/event_replay.hh"
+
+#include <fstream>
+#include <thread>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "sim/core.hh"
+#include "sim/eventq.hh"
+
+std::vector<EventReplay *> EventReplay::replays;
+std::string EventReplay::logName;
+
+namespace {
+
+const char logMagic[8] = { 'g', 'e', 'm', '5', 'r', 'p', 'l', '1' };
+
+struct DumpCallback : public Callback
+{
+    void process() override { EventReplay::dumpAll(); }
+};
+
+DumpCallback dumpCallback;
+
+void
+writeVarint(std::ostream &os, uint64_t v)
+{
+    while (v >= 0x80) {
+        os.put(static_cast<char>(v | 0x80));
+        v >>= 7;
+    }
+    os.put(static_cast<char>(v));
+}
+
+uint64_t
+readVarint(std::istream &is)
+{
+    uint64_t v = 0;
+    for (unsigned shift = 0; shift < 64; shift += 7) {
+        const int c = is.get();
+        fatal_if(c == EOF, "Truncated event replay log.\n");
+        v |= uint64_t(c & 0x7f) << shift;
+        if (!(c & 0x80))
+            return v;
+    }
+    fatal("Corrupt event replay log.\n");
+}
+
+} // anonymous namespace
+
+EventReplay::EventReplay(EventQueue &_eventq, uint32_t _index, Mode _mode)
+    : eventq(_eventq), index(_index), mode(_mode), sendSeq(0),
+      incoming(nullptr), nextEntry(0), exhausted(false)
+{
+}
+
+void
+EventReplay::asyncInsert(Event *event, EventReplay &sender)
+{
+    Insertion *ins = new Insertion{ event, sender.index, sender.sendSeq++,
+                                    nullptr };
+    Insertion *top = incoming.load(std::memory_order_relaxed);
+    do {
+        ins->next = top;
+    } while (!incoming.compare_exchange_weak(top, ins,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed));
+}
+
+EventReplay::Insertion *
+EventReplay::takeIncoming()
+{
+    Insertion *top = incoming.exchange(nullptr, std::memory_order_acquire);
+    Insertion *first = nullptr;
+    while (top) {
+        Insertion *below = top->next;
+        top->next = first;
+        first = top;
+        top = below;
+    }
+    return first;
+}
+
+void
+EventReplay::handleAsyncInsertions()
+{
+    if (mode == Mode::Record)
+        record();
+    else
+        replay();
+}
+
+void
+EventReplay::record()
+{
+    Insertion *ins = takeIncoming();
+    while (ins) {
+        log.push_back(Entry{ eventq.opCount, ins->src, ins->seq });
+        eventq.insertAsync(ins->event);
+
+        Insertion *following = ins->next;
+        delete ins;
+        ins = following;
+    }
+}
+
+void
+EventReplay::replay()
+{
+    auto take = [this]() {
+        Insertion *ins = takeIncoming();
+        while (ins) {
+            pending[Tag(ins->src, ins->seq)] = ins->event;
+            Insertion *following = ins->next;
+            delete ins;
+            ins = following;
+        }
+    };
+
+    take();
+    while (!exhausted) {
+        if (nextEntry == log.size()) {
+            if (pending.empty())
+                return;
+            warn("%s: End of the event replay log, the simulation isn't "
+                 "deterministic anymore.\n", eventq.name());
+            exhausted = true;
+            break;
+        }
+
+        const Entry &e = log[nextEntry];
+        panic_if(e.pos < eventq.opCount, "%s: Event replay diverged, "
+                 "expected an insertion at %d but at %d now.\n",
+                 eventq.name(), e.pos, eventq.opCount);
+        if (e.pos != eventq.opCount)
+            return;
+
+        auto it = pending.find(Tag(e.src, e.seq));
+        if (it == pending.end()) {
+            // The sender is about to send it
+            std::this_thread::yield();
+            take();
+            continue;
+        }
+
+        Event *event = it->second;
+        pending.erase(it);
+        ++nextEntry;
+        eventq.insertAsync(event);
+    }
+
+    for (const auto &p : pending)
+        eventq.insertAsync(p.second);
+    pending.clear();
+}
+
+void
+EventReplay::enable(Mode mode, const std::string &name)
+{
+    assert(replays.empty());
+    logName = name;
+
+    for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+        replays.push_back(new EventReplay(*mainEventQueue[i], i, mode));
+        mainEventQueue[i]->replay = replays.back();
+    }
+
+    if (mode == Mode::Record) {
+        registerExitCallback(&dumpCallback);
+        return;
+    }
+
+    std::ifstream is(name, std::ios::binary);
+    fatal_if(!is, "Can't open event replay log %s.\n", name);
+
+    char magic[sizeof(logMagic)];
+    is.read(magic, sizeof(magic));
+    fatal_if(!is || !std::equal(magic, magic + sizeof(magic), logMagic),
+             "%s is not an event replay log.\n", name);
+
+    const uint64_t queues = readVarint(is);
+    fatal_if(queues != numMainEventQueues, "Event replay log %s was "
+             "recorded with %d event queues, not %d.\n", name, queues,
+             numMainEventQueues);
+
+    for (auto r : replays) {
+        const uint64_t entries = readVarint(is);
+        r->log.reserve(entries);
+        Counter pos = 0;
+        for (uint64_t i = 0; i < entries; ++i) {
+            pos += readVarint(is);
+            const uint32_t src = readVarint(is);
+            const uint64_t seq = readVarint(is);
+            r->log.push_back(Entry{ pos, src, seq });
+        }
+    }
+}
+
+void
+EventReplay::dumpAll()
+{
+    OutputStream *os = simout.create(logName, true, true);
+    std::ostream &out = *os->stream();
+
+    out.write(logMagic, sizeof(logMagic));
+    writeVarint(out, replays.size());
+    for (const auto r : replays) {
+        writeVarint(out, r->log.size());
+        Counter pos = 0;
+        for (const auto &e : r->log) {
+            writeVarint(out, e.pos - pos);
+            writeVarint(out, e.src);
+            writeVarint(out, e.seq);
+            pos = e.pos;
+        }
+    }
+
+    simout.close(os);
+}
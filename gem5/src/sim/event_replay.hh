@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Record and replay of the asynchronous insertions of multi-queue
+ * simulation
+ */
+
+#ifndef __SIM_EVENT_REPLAY_HH__
+#define __SIM_EVENT_REPLAY_HH__
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/types.hh"
+
+class Event;
+class EventQueue;
+
+/**
+ * Record or replay the order in which events scheduled by other
+ * threads are inserted into an event queue.
+ *
+ * With multiple event queues, the only source of nondeterminism (host
+ * signals aside) is when a queue picks up the events other threads
+ * added to its async queue, relative to its own insertions and
+ * services, e.g., which events sent right after a quantum barrier make
+ * it into the queue at that barrier. Everything else follows from the
+ * order of the operations on each queue.
+ *
+ * When recording, every asynchronous insertion is tagged with the
+ * sending queue and a per-sender sequence number, and the position at
+ * which it was inserted (the number of insertions and services the
+ * queue did before) is logged. When replaying, asynchronous insertions
+ * that arrive early are held back until they are due, and the queue
+ * waits for the ones that haven't arrived yet. This only makes a
+ * queue wait for events that the sender is about to send anyway, so
+ * the simulation still runs in parallel.
+ *
+ * Global events use the same path, so the order of stat dumps, exits
+ * and quantum synchronizations is replayed as well.
+ */
+class EventReplay
+{
+  public:
+    enum class Mode { Record, Replay };
+
+  private:
+    struct Insertion
+    {
+        Event *event;
+        uint32_t src;
+        uint64_t seq;
+        Insertion *next;
+    };
+
+    struct Entry
+    {
+        Counter pos;
+        uint32_t src;
+        uint64_t seq;
+    };
+
+    typedef std::pair<uint32_t, uint64_t> Tag;
+
+    EventQueue &eventq;
+    const uint32_t index;
+    const Mode mode;
+
+    //! Number of events the thread servicing this queue sent to other
+    //! queues (the sequence number of the next one).
+    uint64_t sendSeq;
+
+    //! Tagged insertions from other threads, latest first.
+    std::atomic<Insertion *> incoming;
+
+    //! Logged insertions, and the next one to replay.
+    std::vector<Entry> log;
+    size_t nextEntry;
+    bool exhausted;
+
+    //! Insertions that arrived before they were due
+    std::map<Tag, Event *> pending;
+
+    //! Take the incoming insertions, in the order they were sent.
+    Insertion *takeIncoming();
+
+    void record();
+    void replay();
+
+    static std::vector<EventReplay *> replays;
+    static std::string logName;
+
+  public:
+    EventReplay(EventQueue &eventq, uint32_t index, Mode mode);
+
+    //! Add an event scheduled by another thread. Thread safe.
+    void asyncInsert(Event *event, EventReplay &sender);
+
+    //! Insert the events that are due into the queue.
+    void handleAsyncInsertions();
+
+    /**
+     * Start recording or replaying on all main event queues.
+     *
+     * @param mode Record or replay.
+     * @param name Name of the log, in the output directory when
+     *        recording.
+     */
+    static void enable(Mode mode, const std::string &name);
+
+    //! Write the recorded logs.
+    static void dumpAll();
+};
+
+#endif // __SIM_EVENT_REPLAY_HH__
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "base/bench/benchmark.hh"
+#include "sim/eventq.hh"
+
+/**
+ * The classic hold model: service the earliest event, and schedule it
+ * again a few clock periods later, keeping the number of pending
+ * events constant. Most events land on clock edges, so many of them
+ * share a tick, as in a simulation.
+ *
+ * Arguments: number of pending events, and backend (0 for the linked
+ * list, 1 for the calendar queue).
+ */
+static void
+eventQueueHold(Bench::State &state)
+{
+    const Tick period = 500;
+    std::mt19937_64 rng(1);
+
+    std::vector<Tick> delays(1 << 16);
+    for (auto &delay : delays)
+        delay = period * (1 + rng() % 8);
+
+    // The events outlive the queue, which deschedules them
+    std::vector<std::unique_ptr<EventFunctionWrapper>> events;
+    EventQueue eventq("bench");
+    eventq.setBackend(state.arg(1) ? EventQueue::Backend::Calendar :
+                      EventQueue::Backend::LinkedList);
+    EventQueue *old_eventq = curEventQueue();
+    curEventQueue(&eventq);
+
+    for (int64_t i = 0; i < state.arg(0); ++i) {
+        events.emplace_back(new EventFunctionWrapper([]{}, "bench"));
+        eventq.schedule(events.back().get(), delays[i % delays.size()]);
+    }
+
+    size_t next = 0;
+    for (auto _ : state) {
+        Event *event = eventq.getHead();
+        eventq.serviceOne();
+        eventq.schedule(event, eventq.getCurTick() + delays[next]);
+        next = (next + 1) % delays.size();
+    }
+    state.setItemsProcessed(state.iterations());
+
+    curEventQueue(old_eventq);
+}
+BENCHMARK(eventQueueHold)
+    ->args({16, 0})->args({16, 1})
+    ->args({256, 0})->args({256, 1})
+    ->args({4096, 0})->args({4096, 1});
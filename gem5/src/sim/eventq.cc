@@ -32,6 +32,7 @@
  *          Steve Raasch
  */
 
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <string>
@@ -43,11 +44,35 @@
 #include "cpu/smt.hh"
 #include "debug/Checkpoint.hh"
 #include "sim/core.hh"
+#include "sim/event_profile.hh"
+#include "sim/event_replay.hh"
 #include "sim/eventq_impl.hh"
 
 using namespace std;
 
 Tick simQuantum = 0;
+Tick simQuantumMin = 0;
+Tick simQuantumMax = 0;
+
+EventQueue::Backend EventQueue::defaultBackend =
+    EventQueue::Backend::LinkedList;
+
+namespace {
+
+//! Smallest number of buckets of a calendar queue.
+const size_t calMinBuckets = 16;
+//! Width of a bucket until the calendar has seen enough bins.
+const Tick calInitialWidth = 1000;
+//! Number of bins used to estimate the width of a bucket.
+const size_t calSampleSize = 32;
+
+bool
+binLess(const Event *l, const Event *r)
+{
+    return *l < *r;
+}
+
+} // anonymous namespace
 
 //
 // Main Event Queues
@@ -117,6 +142,13 @@ Event::insertBefore(Event *event, Event *curr)
 void
 EventQueue::insert(Event *event)
 {
+    ++opCount;
+
+    if (backend == Backend::Calendar) {
+        calInsert(event);
+        return;
+    }
+
     // Deal with the head case
     if (!head || *event <= *head) {
         head = Event::insertBefore(event, head);
@@ -176,6 +208,11 @@ EventQueue::remove(Event *event)
 
     assert(event->queue == this);
 
+    if (backend == Backend::Calendar) {
+        calRemove(event);
+        return;
+    }
+
     // deal with an event on the head's 'in bin' list (event has the same
     // time as the head)
     if (*head == *event) {
@@ -200,13 +237,172 @@ EventQueue::remove(Event *event)
     prev->nextBin = Event::removeItem(event, curr);
 }
 
+void
+EventQueue::calInsert(Event *event)
+{
+    Event **link = &calBuckets[calBucket(event->when())];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    Event *curr = *link;
+    if (curr && *curr == *event) {
+        // Push the event on top of the existing bin
+        event->nextBin = curr->nextBin;
+        event->nextInBin = curr;
+        *link = event;
+        if (head == curr)
+            head = event;
+        return;
+    }
+
+    event->nextBin = curr;
+    event->nextInBin = NULL;
+    *link = event;
+    ++calBins;
+
+    if (!head || *event < *head)
+        head = event;
+
+    if (calBins > 2 * calBuckets.size())
+        calResize(2 * calBuckets.size());
+}
+
+void
+EventQueue::calRemove(Event *event)
+{
+    Event **link = &calBuckets[calBucket(event->when())];
+    while (*link && **link < *event)
+        link = &(*link)->nextBin;
+
+    Event *top = *link;
+    if (!top || *top != *event)
+        panic("event not found!");
+
+    const bool emptied = event == top && !top->nextInBin;
+    *link = Event::removeItem(event, top);
+
+    if (!emptied) {
+        if (head == top)
+            head = *link;
+        return;
+    }
+
+    --calBins;
+    if (head == top)
+        head = calFindMin(top->when());
+
+    if (calBins < calBuckets.size() / 2 && calBuckets.size() > calMinBuckets)
+        calResize(calBuckets.size() / 2);
+}
+
+void
+EventQueue::calLinkBin(Event *bin)
+{
+    Event **link = &calBuckets[calBucket(bin->when())];
+    while (*link && **link < *bin)
+        link = &(*link)->nextBin;
+
+    bin->nextBin = *link;
+    *link = bin;
+}
+
 Event *
-EventQueue::serviceOne()
+EventQueue::calFindMin(Tick from) const
+{
+    if (calBins == 0)
+        return NULL;
+
+    // Scan one year worth of days starting with the day containing
+    // 'from'. Since no bin is earlier than 'from', the first bucket
+    // whose first bin falls in the day being scanned holds the
+    // earliest bin.
+    const size_t mask = calBuckets.size() - 1;
+    const Tick last_day = MaxTick / calWidth;
+    Tick day = from / calWidth;
+    for (size_t i = 0; i < calBuckets.size(); ++i) {
+        Event *first = calBuckets[day & mask];
+        if (first && first->when() / calWidth <= day)
+            return first;
+        if (day == last_day)
+            break;
+        ++day;
+    }
+
+    // All bins are more than a year away, search directly.
+    Event *min = NULL;
+    for (auto first : calBuckets) {
+        if (first && (!min || *first < *min))
+            min = first;
+    }
+    return min;
+}
+
+void
+EventQueue::calResize(size_t buckets)
+{
+    std::vector<Event *> bins;
+    for (auto first : calBuckets) {
+        for (Event *bin = first; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+
+    // Estimate the width of a day from the average separation of the
+    // bins at the front of the queue, ignoring separations larger
+    // than twice the average (Brown's heuristic).
+    const size_t samples = std::min(bins.size(), calSampleSize);
+    if (samples > 1) {
+        std::partial_sort(bins.begin(), bins.begin() + samples, bins.end(),
+                          binLess);
+        const Tick avg = (bins[samples - 1]->when() - bins[0]->when()) /
+            (samples - 1);
+
+        Tick sum = 0;
+        Tick count = 0;
+        for (size_t i = 1; i < samples; ++i) {
+            const Tick gap = bins[i]->when() - bins[i - 1]->when();
+            if (gap / 2 <= avg) {
+                sum += gap;
+                ++count;
+            }
+        }
+
+        const Tick mean = count ? sum / count : 0;
+        if (mean)
+            calWidth = mean > MaxTick / 3 ? MaxTick : 3 * mean;
+    }
+
+    calBuckets.assign(buckets, NULL);
+    for (auto bin : bins)
+        calLinkBin(bin);
+}
+
+void
+EventQueue::popHead()
 {
-    std::lock_guard<EventQueue> lock(*this);
     Event *event = head;
     Event *next = head->nextInBin;
-    event->flags.clear(Event::Scheduled);
+
+    if (backend == Backend::Calendar) {
+        // The head is always the first bin of its bucket
+        Event *&first = calBuckets[calBucket(event->when())];
+        assert(first == event);
+
+        if (next) {
+            next->nextBin = event->nextBin;
+            first = next;
+            head = next;
+        } else {
+            first = event->nextBin;
+            --calBins;
+            head = calFindMin(event->when());
+
+            if (calBins < calBuckets.size() / 2 &&
+                calBuckets.size() > calMinBuckets) {
+                calResize(calBuckets.size() / 2);
+            }
+        }
+        return;
+    }
 
     if (next) {
         // update the next bin pointer since it could be stale
@@ -219,13 +415,88 @@ EventQueue::serviceOne()
         // the 'in bin' list and point to the next bin list
         head = head->nextBin;
     }
+}
+
+std::vector<Event *>
+EventQueue::getBins() const
+{
+    std::vector<Event *> bins;
+    if (backend == Backend::Calendar) {
+        bins.reserve(calBins);
+        for (auto first : calBuckets) {
+            for (Event *bin = first; bin; bin = bin->nextBin)
+                bins.push_back(bin);
+        }
+        std::sort(bins.begin(), bins.end(), binLess);
+    } else {
+        for (Event *bin = head; bin; bin = bin->nextBin)
+            bins.push_back(bin);
+    }
+    return bins;
+}
+
+void
+EventQueue::setBackend(Backend b)
+{
+    if (b == backend)
+        return;
+
+    // Bins are moved as a whole, which keeps the order of the events
+    // within a bin.
+    std::vector<Event *> bins(getBins());
+
+    backend = b;
+    head = NULL;
+    calBuckets.assign(calMinBuckets, NULL);
+    calBins = 0;
+
+    if (backend == Backend::Calendar) {
+        for (auto bin : bins)
+            calLinkBin(bin);
+        calBins = bins.size();
+
+        size_t buckets = calMinBuckets;
+        while (buckets < calBins)
+            buckets *= 2;
+        if (calBins > 1)
+            calResize(buckets);
+
+        head = bins.empty() ? NULL : bins.front();
+    } else {
+        for (auto it = bins.rbegin(); it != bins.rend(); ++it) {
+            (*it)->nextBin = head;
+            head = *it;
+        }
+    }
+}
+
+void
+EventQueue::enableProfiling(unsigned interval)
+{
+    if (!profile)
+        profile = new EventProfile(name(), interval);
+}
+
+Event *
+EventQueue::serviceOne()
+{
+    std::lock_guard<EventQueue> lock(*this);
+    Event *event = head;
+    event->flags.clear(Event::Scheduled);
+
+    popHead();
+    ++opCount;
 
     // handle action
     if (!event->squashed()) {
         // forward current cycle to the time when this event occurs.
         setCurTick(event->when());
+        ++processedEvents;
 
-        event->process();
+        if (profile)
+            profile->process(event);
+        else
+            event->process();
         if (event->isExitEvent()) {
             assert(!event->flags.isSet(Event::Managed) ||
                    !event->flags.isSet(Event::IsMainQueue)); // would be silly
@@ -300,15 +571,12 @@ EventQueue::dump() const
     if (empty())
         cprintf("<No Events>\n");
     else {
-        Event *nextBin = head;
-        while (nextBin) {
-            Event *nextInBin = nextBin;
+        for (auto bin : getBins()) {
+            Event *nextInBin = bin;
             while (nextInBin) {
                 nextInBin->dump();
                 nextInBin = nextInBin->nextInBin;
             }
-
-            nextBin = nextBin->nextBin;
         }
     }
 
@@ -323,8 +591,34 @@ EventQueue::debugVerify() const
     Tick time = 0;
     short priority = 0;
 
-    Event *nextBin = head;
-    while (nextBin) {
+    if (backend == Backend::Calendar) {
+        size_t bins = 0;
+        for (size_t i = 0; i < calBuckets.size(); ++i) {
+            for (Event *bin = calBuckets[i]; bin; bin = bin->nextBin) {
+                if (calBucket(bin->when()) != i) {
+                    cprintf("bin in wrong bucket!");
+                    bin->dump();
+                    return false;
+                }
+                if (bin->nextBin && !(*bin < *bin->nextBin)) {
+                    cprintf("bucket not sorted!");
+                    bin->dump();
+                    return false;
+                }
+                ++bins;
+            }
+        }
+        if (bins != calBins) {
+            cprintf("bin count mismatch!");
+            return false;
+        }
+        if (head != calFindMin(0)) {
+            cprintf("head is not the first bin!");
+            return false;
+        }
+    }
+
+    for (auto nextBin : getBins()) {
         Event *nextInBin = nextBin;
         while (nextInBin) {
             if (nextInBin->when() < time) {
@@ -350,8 +644,6 @@ EventQueue::debugVerify() const
 
             nextInBin = nextInBin->nextInBin;
         }
-
-        nextBin = nextBin->nextBin;
     }
 
     return true;
@@ -361,6 +653,24 @@ Event*
 EventQueue::replaceHead(Event* s)
 {
     Event* t = head;
+
+    if (backend == Backend::Calendar) {
+        if (!s) {
+            calStashed.swap(calBuckets);
+            calStashedBins = calBins;
+            calStashedWidth = calWidth;
+            calBuckets.assign(calMinBuckets, NULL);
+            calBins = 0;
+        } else {
+            panic_if(calStashed.empty(),
+                     "No calendar to restore in replaceHead()");
+            calBuckets.swap(calStashed);
+            calBins = calStashedBins;
+            calWidth = calStashedWidth;
+            calStashed.clear();
+        }
+    }
+
     head = s;
     return t;
 }
@@ -414,28 +724,71 @@ Event::dump() const
 }
 
 EventQueue::EventQueue(const string &n)
-    : objName(n), head(NULL), _curTick(0)
+    : objName(n), head(NULL), _curTick(0), backend(defaultBackend),
+      calBuckets(calMinBuckets, NULL), calWidth(calInitialWidth), calBins(0),
+      calStashedBins(0), calStashedWidth(0), async_queue(nullptr),
+      crossQueueSchedules(0), lateAsyncInsertions(0), processedEvents(0),
+      profile(nullptr), replay(nullptr), opCount(0)
 {
 }
 
 void
 EventQueue::asyncInsert(Event *event)
 {
-    async_queue_mutex.lock();
-    async_queue.push_back(event);
-    async_queue_mutex.unlock();
+    if (replay) {
+        EventReplay *sender = curEventQueue()->replay;
+        panic_if(!sender, "%s: Event replay can't track events scheduled "
+                 "from %s.\n", name(), curEventQueue()->name());
+        replay->asyncInsert(event, *sender);
+        return;
+    }
+
+    Event *top = async_queue.load(std::memory_order_relaxed);
+    do {
+        event->nextBin = top;
+    } while (!async_queue.compare_exchange_weak(top, event,
+                                                std::memory_order_release,
+                                                std::memory_order_relaxed));
 }
 
 void
-EventQueue::handleAsyncInsertions()
+EventQueue::doHandleAsyncInsertions()
 {
     assert(this == curEventQueue());
-    async_queue_mutex.lock();
 
-    while (!async_queue.empty()) {
-        insert(async_queue.front());
-        async_queue.pop_front();
+    if (replay) {
+        replay->handleAsyncInsertions();
+        return;
     }
 
-    async_queue_mutex.unlock();
+    Event *top = async_queue.exchange(nullptr, std::memory_order_acquire);
+
+    // The stack holds the most recent event first, reverse it to
+    // insert the events in the order they were scheduled. Global
+    // events rely on this to have the same order in all queues.
+    Event *first = nullptr;
+    while (top) {
+        Event *next = top->nextBin;
+        top->nextBin = first;
+        first = top;
+        top = next;
+    }
+
+    while (first) {
+        Event *next = first->nextBin;
+        insertAsync(first);
+        first = next;
+    }
+}
+
+void
+EventQueue::insertAsync(Event *event)
+{
+    // The sender didn't know the quantum would be this long, move the
+    // event to now rather than back in time.
+    if (event->when() < getCurTick() && simQuantumMax > simQuantumMin) {
+        event->setWhen(getCurTick(), this);
+        ++lateAsyncInsertions;
+    }
+    insert(event);
 }
@@ -39,6 +39,7 @@
 #define __SIM_EVENTQ_HH__
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <climits>
 #include <functional>
@@ -46,6 +47,9 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "base/flags.hh"
 #include "base/types.hh"
@@ -53,6 +57,8 @@
 #include "sim/serialize.hh"
 
 class EventQueue;       // forward declaration
+class EventProfile;
+class EventReplay;
 class BaseGlobalEvent;
 
 //! Simulation Quantum for multiple eventq simulation.
@@ -62,6 +68,13 @@ class BaseGlobalEvent;
 //! Queue B should be at least simQuantum ticks away in future.
 extern Tick simQuantum;
 
+//! Bounds of an adaptive simulation quantum. When simQuantumMax is
+//! larger than simQuantumMin, the quantum starts at simQuantumMin and
+//! is adapted to the cross-queue traffic at every synchronization
+//! (see GlobalSyncEvent). simQuantum always holds the current value.
+extern Tick simQuantumMin;
+extern Tick simQuantumMax;
+
 //! Current number of allocated main event queues.
 extern uint32_t numMainEventQueues;
 
@@ -491,16 +504,107 @@ operator!=(const Event &l, const Event &r)
  */
 class EventQueue
 {
+  public:
+    /**
+     * Data structure used to keep the pending events sorted.
+     *
+     * Both backends keep events with the same time and priority in a
+     * LIFO 'bin' and service them in exactly the same order.
+     *
+     * LinkedList: A sorted linked list of bins. Insertion is linear
+     * in the number of distinct (time, priority) pairs.
+     *
+     * Calendar: Bins are hashed into the 'days' of a calendar queue
+     * (R. Brown, CACM 1988) whose size and day width adapt to the
+     * number and spacing of the bins, which makes insertion constant
+     * time on average.
+     */
+    enum class Backend { LinkedList, Calendar };
+
+    //! Backend used by newly created event queues.
+    static Backend defaultBackend;
+
   private:
     std::string objName;
     Event *head;
     Tick _curTick;
 
-    //! Mutex to protect async queue.
-    std::mutex async_queue_mutex;
+    Backend backend;
 
-    //! List of events added by other threads to this event queue.
-    std::list<Event*> async_queue;
+    /**
+     * @{
+     * @name Calendar queue state
+     *
+     * Each bucket holds a list of bin tops sorted by (time,
+     * priority), linked through their nextBin pointers. The head of
+     * the queue is cached in 'head', just like for the linked list.
+     */
+    std::vector<Event *> calBuckets;
+    //! Width of a bucket in ticks.
+    Tick calWidth;
+    //! Number of bins stored in the calendar.
+    size_t calBins;
+    //! Calendar stashed away by replaceHead().
+    std::vector<Event *> calStashed;
+    size_t calStashedBins;
+    Tick calStashedWidth;
+    /** @} */
+
+    size_t
+    calBucket(Tick when) const
+    {
+        return (when / calWidth) & (calBuckets.size() - 1);
+    }
+
+    void calInsert(Event *event);
+    void calRemove(Event *event);
+    //! Link a complete bin into its bucket.
+    void calLinkBin(Event *bin);
+    //! Find the first bin, all bins are known to be at or after 'from'.
+    Event *calFindMin(Tick from) const;
+    void calResize(size_t buckets);
+
+    //! Remove the head of the queue, the caller is responsible for
+    //! updating the event's flags.
+    void popHead();
+
+    //! Get the tops of all bins, sorted by (time, priority).
+    std::vector<Event *> getBins() const;
+
+    /**
+     * Events added by other threads to this event queue.
+     *
+     * This is an intrusive lock-free stack, linked through the
+     * nextBin pointer of the events, which is unused until the event
+     * is inserted into the queue. Any thread can push events, but only
+     * the thread owning the queue takes them, and it always takes the
+     * whole stack at once which avoids the ABA problem.
+     */
+    std::atomic<Event *> async_queue;
+
+    //! Number of events the thread servicing this queue scheduled on
+    //! other queues since the last call to resetCrossQueueSchedules().
+    Counter crossQueueSchedules;
+
+    //! Number of asynchronous insertions that would have been in the
+    //! past. This can only happen with an adaptive simulation quantum.
+    Counter lateAsyncInsertions;
+
+    //! Number of events processed, squashed events excluded.
+    Counter processedEvents;
+
+    //! Host time profile of the serviced events, NULL unless enabled.
+    EventProfile *profile;
+
+    //! Record or replay of the asynchronous insertions, NULL unless
+    //! enabled.
+    EventReplay *replay;
+
+    //! Number of insertions and serviced events, which positions the
+    //! asynchronous insertions in a replay log.
+    Counter opCount;
+
+    friend class EventReplay;
 
     /**
      * Lock protecting event handling.
@@ -534,6 +638,11 @@ class EventQueue
     //! owning thread, should call this function instead of insert().
     void asyncInsert(Event *event);
 
+    //! Insert an event scheduled by another thread.
+    void insertAsync(Event *event);
+
+    void doHandleAsyncInsertions();
+
     EventQueue(const EventQueue &);
 
   public:
@@ -622,6 +731,23 @@ class EventQueue
     //! the owning thread.
     void reschedule(Event *event, Tick when, bool always = false);
 
+    /**
+     * Schedule a callable to be invoked once at the given time.
+     *
+     * This is a cheaper alternative to allocating an auto-deleting
+     * EventFunctionWrapper. The callable is stored inline in the
+     * event and the event storage is recycled through a per-thread
+     * free list for each callable type, so scheduling a one-shot
+     * event normally doesn't touch the heap.
+     *
+     * @param callable Function object to call when the event fires.
+     * @param when Time at which the callable is invoked.
+     * @param p Priority of the event.
+     */
+    template <typename F>
+    void scheduleOneShot(F &&callable, Tick when,
+                         EventBase::Priority p = EventBase::Default_Pri);
+
     Tick nextTick() const { return head->when(); }
     void setCurTick(Tick newVal) { _curTick = newVal; }
     Tick getCurTick() const { return _curTick; }
@@ -657,8 +783,48 @@ class EventQueue
 
     bool debugVerify() const;
 
+    //! Get the data structure used to sort pending events.
+    Backend getBackend() const { return backend; }
+
+    /**
+     * Switch to a different data structure for the pending
+     * events. Pending events are migrated and keep their relative
+     * order.
+     */
+    void setBackend(Backend b);
+
+    /**
+     * Start attributing the host time spent servicing events to the
+     * event names (see EventProfile).
+     *
+     * @param interval Time one in this many events.
+     */
+    void enableProfiling(unsigned interval);
+
     //! Function for moving events from the async_queue to the main queue.
-    void handleAsyncInsertions();
+    void
+    handleAsyncInsertions()
+    {
+        if (hasAsyncInsertions() || replay)
+            doHandleAsyncInsertions();
+    }
+
+    //! Get the number of events scheduled on other queues since the
+    //! last reset. Only safe to call while all threads are synchronized.
+    Counter getCrossQueueSchedules() const { return crossQueueSchedules; }
+    void resetCrossQueueSchedules() { crossQueueSchedules = 0; }
+
+    Counter getLateAsyncInsertions() const { return lateAsyncInsertions; }
+
+    Counter getProcessedEvents() const { return processedEvents; }
+
+    //! Check if there are any events in the async_queue. This is cheap
+    //! and doesn't need any locking.
+    bool
+    hasAsyncInsertions() const
+    {
+        return async_queue.load(std::memory_order_relaxed) != nullptr;
+    }
 
     /**
      *  Function to signal that the event loop should be woken up because
@@ -680,6 +846,9 @@ class EventQueue
      *  different set of events can run without disturbing events that have
      *  already been scheduled. Already scheduled events can be processed
      *  by replacing the original head back.
+     *  With the calendar backend, the whole calendar is stashed away
+     *  when the head is replaced by NULL and the original head must be
+     *  put back once the queue is empty again.
      *  USING THIS FUNCTION CAN BE DANGEROUS TO THE HEALTH OF THE SIMULATOR.
      *  NOT RECOMMENDED FOR USE.
      */
@@ -776,6 +945,14 @@ class EventManager
         eventq->reschedule(event, when, always);
     }
 
+    template <typename F>
+    void
+    scheduleOneShot(F &&callable, Tick when,
+                    EventBase::Priority p = EventBase::Default_Pri)
+    {
+        eventq->scheduleOneShot(std::forward<F>(callable), when, p);
+    }
+
     void wakeupEventQueue(Tick when = (Tick)-1)
     {
         eventq->wakeup(when);
@@ -844,4 +1021,57 @@ class EventFunctionWrapper : public Event
     const char *description() const { return "EventFunctionWrapped"; }
 };
 
+/**
+ * Auto-deleting event invoking a callable, used by
+ * EventQueue::scheduleOneShot().
+ *
+ * The storage of retired events is kept on a free list instead of
+ * being returned to the heap. There is one free list per callable
+ * type and thread, so allocating and freeing never needs a lock, even
+ * if the event is retired by a different thread than the one that
+ * created it.
+ */
+template <typename F>
+class OneShotEvent : public Event
+{
+  private:
+    F callback;
+
+    //! Retired events of this type owned by the current thread.
+    static __thread void *freeList;
+
+  public:
+    template <typename G>
+    OneShotEvent(G &&_callback, Priority p)
+        : Event(p, AutoDelete), callback(std::forward<G>(_callback))
+    {
+    }
+
+    void process() override { callback(); }
+
+    const char *description() const override { return "OneShotEvent"; }
+
+    static void *
+    operator new(std::size_t size)
+    {
+        assert(size == sizeof(OneShotEvent));
+        if (!freeList)
+            return ::operator new(size);
+
+        void *p = freeList;
+        freeList = *static_cast<void **>(p);
+        return p;
+    }
+
+    static void
+    operator delete(void *p)
+    {
+        *static_cast<void **>(p) = freeList;
+        freeList = p;
+    }
+};
+
+template <typename F>
+__thread void *OneShotEvent<F>::freeList = nullptr;
+
 #endif // __SIM_EVENTQ_HH__
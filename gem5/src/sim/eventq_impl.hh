@@ -54,6 +54,8 @@ EventQueue::schedule(Event *event, Tick when, bool global)
     //    a total order amongst the global events. See global_event.{cc,hh}
     //    for more explanation.
     if (inParallelMode && (this != curEventQueue() || global)) {
+        if (!global)
+            curEventQueue()->crossQueueSchedules++;
         asyncInsert(event);
     } else {
         insert(event);
@@ -106,4 +108,12 @@ EventQueue::reschedule(Event *event, Tick when, bool always)
         event->trace("rescheduled");
 }
 
+template <typename F>
+inline void
+EventQueue::scheduleOneShot(F &&callable, Tick when, EventBase::Priority p)
+{
+    schedule(new OneShotEvent<typename std::decay<F>::type>(
+                 std::forward<F>(callable), p), when);
+}
+
 #endif // __SIM_EVENTQ_IMPL_HH__
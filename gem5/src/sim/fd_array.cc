@@ -40,6 +40,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "base/logging.hh"
@@ -284,6 +285,7 @@ FDArray::restoreFileOffsets()
 int
 FDArray::allocFD(std::shared_ptr<FDEntry> in)
 {
+    std::lock_guard<std::mutex> lock(_fdLock);
     for (int i = 0; i < _fdArray.size(); i++) {
         std::shared_ptr<FDEntry> fdp = _fdArray[i];
         if (!fdp) {
@@ -320,6 +322,7 @@ std::shared_ptr<FDEntry>
 FDArray::getFDEntry(int tgt_fd)
 {
     assert(0 <= tgt_fd && tgt_fd < _fdArray.size());
+    std::lock_guard<std::mutex> lock(_fdLock);
     return _fdArray[tgt_fd];
 }
 
@@ -327,6 +330,7 @@ void
 FDArray::setFDEntry(int tgt_fd, std::shared_ptr<FDEntry> fdep)
 {
     assert(0 <= tgt_fd && tgt_fd < _fdArray.size());
+    std::lock_guard<std::mutex> lock(_fdLock);
     _fdArray[tgt_fd] = fdep;
 }
 
@@ -336,6 +340,7 @@ FDArray::closeFDEntry(int tgt_fd)
     if (tgt_fd >= _fdArray.size() || tgt_fd < 0)
         return -EBADF;
 
+    std::lock_guard<std::mutex> lock(_fdLock);
     int sim_fd = -1;
     auto hbfdp = std::dynamic_pointer_cast<HBFDEntry>(_fdArray[tgt_fd]);
     if (hbfdp)
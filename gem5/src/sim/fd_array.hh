@@ -38,6 +38,7 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "sim/fd_entry.hh"
@@ -137,6 +138,12 @@ class FDArray
     static constexpr size_t _numFDs {1024};
     std::array<std::shared_ptr<FDEntry>, _numFDs> _fdArray;
 
+    /**
+     * Serialise changes to the array. The threads of a process share it
+     * and may run on different event queues.
+     */
+    mutable std::mutex _fdLock;
+
     /**
      * Hold param strings passed from the Process class which indicate
      * the filename for each of the corresponding files or some keyword
@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/futex_map.hh"
+
+#include <algorithm>
+
+#include "cpu/base.hh"
+#include "sim/eventq.hh"
+
+int
+FutexMap::wakeup(Addr addr, uint64_t tgid, int count)
+{
+    std::vector<ThreadContext *> woken;
+    {
+        std::lock_guard<std::mutex> lock(futexLock);
+        auto it = queues.find(FutexKey(addr, tgid));
+
+        if (it == queues.end())
+            return 0;
+
+        auto &waiterList = it->second;
+
+        while (!waiterList.empty() && woken.size() < count) {
+            WaiterState *waiter = waiterList.front();
+            woken.push_back(waiter->tc);
+            waiterList.erase(waiter);
+        }
+    }
+
+    activate(woken);
+    return woken.size();
+}
+
+void
+FutexMap::suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
+                         int bitmask)
+{
+    std::lock_guard<std::mutex> lock(futexLock);
+    WaiterState &waiter = waiters.emplace(tc, tc).first->second;
+
+    // A thread halted while waiting (e.g., by exit_group) may still be
+    // on a queue when its context is reused.
+    if (waiter.list)
+        waiter.list->erase(&waiter);
+
+    waiter.bitmask = bitmask;
+    queues[FutexKey(addr, tgid)].push_back(&waiter);
+
+    /**
+     * Suspend the thread context while holding the lock so that a
+     * waker can't activate it before it is suspended.
+     */
+    tc->suspend();
+}
+
+int
+FutexMap::wakeup_bitset(Addr addr, uint64_t tgid, int bitmask)
+{
+    std::vector<ThreadContext *> woken;
+    {
+        std::lock_guard<std::mutex> lock(futexLock);
+        auto it = queues.find(FutexKey(addr, tgid));
+
+        if (it == queues.end())
+            return 0;
+
+        auto &waiterList = it->second;
+        WaiterState *waiter = waiterList.front();
+
+        while (waiter) {
+            if (waiter->checkMask(bitmask)) {
+                woken.push_back(waiter->tc);
+                waiter = waiterList.erase(waiter);
+            } else {
+                waiter = waiter->next;
+            }
+        }
+    }
+
+    activate(woken);
+    return woken.size();
+}
+
+int
+FutexMap::requeue(Addr addr1, uint64_t tgid, int count, int count2,
+                  Addr addr2)
+{
+    std::vector<ThreadContext *> woken;
+    int requeued = 0;
+    {
+        std::lock_guard<std::mutex> lock(futexLock);
+        auto it1 = queues.find(FutexKey(addr1, tgid));
+
+        if (it1 == queues.end())
+            return 0;
+
+        auto &waiterList1 = it1->second;
+
+        while (!waiterList1.empty() && woken.size() < count) {
+            WaiterState *waiter = waiterList1.front();
+            woken.push_back(waiter->tc);
+            waiterList1.erase(waiter);
+        }
+
+        if (!waiterList1.empty() && count2 > 0) {
+            // References to the elements of an unordered_map survive
+            // rehashing, so waiterList1 stays valid.
+            auto &waiterList2 = queues[FutexKey(addr2, tgid)];
+
+            while (!waiterList1.empty() && requeued < count2) {
+                WaiterState *waiter = waiterList1.front();
+                waiterList1.erase(waiter);
+                waiterList2.push_back(waiter);
+                requeued++;
+            }
+        }
+    }
+
+    activate(woken);
+    return woken.size() + requeued;
+}
+
+void
+FutexMap::activate(std::vector<ThreadContext *> &woken)
+{
+    if (woken.empty())
+        return;
+
+    auto queue = [](ThreadContext *tc) {
+        return tc->getCpuPtr()->eventQueue();
+    };
+
+    std::stable_sort(woken.begin(), woken.end(),
+        [&queue](ThreadContext *a, ThreadContext *b) {
+            return queue(a) < queue(b);
+        });
+
+    for (auto first = woken.begin(); first != woken.end(); ) {
+        EventQueue *eq = queue(*first);
+        EventQueue::ScopedMigration migrate(eq);
+        for (; first != woken.end() && queue(*first) == eq; ++first)
+            (*first)->activate();
+    }
+}
@@ -33,7 +33,9 @@
 #ifndef __FUTEX_MAP_HH__
 #define __FUTEX_MAP_HH__
 
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include <cpu/thread_context.hh>
 
@@ -79,27 +81,30 @@ namespace std {
     };
 }
 
+class WaiterList;
+
 /**
  * WaiterState defines internal state of a waiter thread. The state
  * includes a pointer to the thread's context and its associated bitmask.
+ *
+ * A thread waits on at most one futex at a time, so every thread
+ * context owns a single WaiterState that is linked into the wait queue
+ * of the futex it is waiting on. Waiting and waking therefore don't
+ * allocate memory.
  */
 class WaiterState {
   public:
     ThreadContext* tc;
     int bitmask;
 
-    /**
-     * this constructor is used if futex ops with bitset are used
-     */
-    WaiterState(ThreadContext* _tc, int _bitmask)
-      : tc(_tc), bitmask(_bitmask)
-    { }
+    /** Wait queue the thread is on, if any, and its links in it */
+    WaiterList *list;
+    WaiterState *prev;
+    WaiterState *next;
 
-    /**
-     * if bitset is not defined, just set bitmask to 0xffffffff
-     */
     WaiterState(ThreadContext* _tc)
-      : tc(_tc), bitmask(0xffffffff)
+      : tc(_tc), bitmask(0xffffffff), list(nullptr),
+        prev(nullptr), next(nullptr)
     { }
 
     /**
@@ -113,114 +118,89 @@ class WaiterState {
     }
 };
 
-typedef std::list<WaiterState> WaiterList;
+/**
+ * Intrusive FIFO of the threads waiting on a futex.
+ */
+class WaiterList {
+  public:
+    WaiterList() : head(nullptr), tail(nullptr) {}
+
+    bool empty() const { return !head; }
+    WaiterState *front() const { return head; }
+
+    void
+    push_back(WaiterState *w)
+    {
+        w->list = this;
+        w->prev = tail;
+        w->next = nullptr;
+        if (tail)
+            tail->next = w;
+        else
+            head = w;
+        tail = w;
+    }
+
+    /** Unlink a waiter, returning the one that followed it */
+    WaiterState *
+    erase(WaiterState *w)
+    {
+        WaiterState *next = w->next;
+        if (w->prev)
+            w->prev->next = next;
+        else
+            head = next;
+        if (next)
+            next->prev = w->prev;
+        else
+            tail = w->prev;
+        w->list = nullptr;
+        w->prev = w->next = nullptr;
+        return next;
+    }
+
+  private:
+    WaiterState *head;
+    WaiterState *tail;
+};
 
 /**
  * FutexMap class holds a map of all futexes used in the system
+ *
+ * The threads of a process may run on different event queues, so all
+ * operations on the map are serialised by a lock. Woken waiters are
+ * activated after the lock is released, migrating to the event queue
+ * of their CPU, to avoid holding the lock while waiting for another
+ * queue.
+ *
+ * The wait queue of a futex is kept when it becomes empty since the
+ * same futexes tend to be used over and over again.
  */
-class FutexMap : public std::unordered_map<FutexKey, WaiterList>
+class FutexMap
 {
   public:
     /** Inserts a futex into the map with one waiting TC */
     void
     suspend(Addr addr, uint64_t tgid, ThreadContext *tc)
     {
-        FutexKey key(addr, tgid);
-        auto it = find(key);
-
-        if (it == end()) {
-            WaiterList waiterList {WaiterState(tc)};
-            insert({key, waiterList});
-        } else {
-            it->second.push_back(WaiterState(tc));
-        }
-
-        /** Suspend the thread context */
-        tc->suspend();
+        suspend_bitset(addr, tgid, tc, 0xffffffff);
     }
 
     /** Wakes up at most count waiting threads on a futex */
-    int
-    wakeup(Addr addr, uint64_t tgid, int count)
-    {
-        FutexKey key(addr, tgid);
-        auto it = find(key);
-
-        if (it == end())
-            return 0;
-
-        int woken_up = 0;
-        auto &waiterList = it->second;
-
-        while (!waiterList.empty() && woken_up < count) {
-            waiterList.front().tc->activate();
-            waiterList.pop_front();
-            woken_up++;
-        }
-
-        if (waiterList.empty())
-            erase(it);
-
-        return woken_up;
-    }
+    int wakeup(Addr addr, uint64_t tgid, int count);
 
     /**
      * inserts a futex into the map with one waiting TC
      * associates the waiter with a given bitmask
      */
-    void
-    suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
-                   int bitmask)
-    {
-        FutexKey key(addr, tgid);
-        auto it = find(key);
-
-        if (it == end()) {
-            WaiterList waiterList {WaiterState(tc, bitmask)};
-            insert({key, waiterList});
-        } else {
-            it->second.push_back(WaiterState(tc, bitmask));
-        }
-
-        /** Suspend the thread context */
-        tc->suspend();
-    }
+    void suspend_bitset(Addr addr, uint64_t tgid, ThreadContext *tc,
+                        int bitmask);
 
     /**
      * Wakes up all waiters waiting on the addr and associated with the
      * given bitset
      */
-    int
-    wakeup_bitset(Addr addr, uint64_t tgid, int bitmask)
-    {
-        FutexKey key(addr, tgid);
-        auto it = find(key);
-
-        if (it == end())
-            return 0;
-
-        int woken_up = 0;
-
-        auto &waiterList = it->second;
-        auto iter = waiterList.begin();
-
-        while (iter != waiterList.end()) {
-            WaiterState& waiter = *iter;
-
-            if (waiter.checkMask(bitmask)) {
-                waiter.tc->activate();
-                iter = waiterList.erase(iter);
-                woken_up++;
-            } else {
-                ++iter;
-            }
-        }
-
-        if (waiterList.empty())
-            erase(it);
-
-        return woken_up;
-    }
+    int wakeup_bitset(Addr addr, uint64_t tgid, int bitmask);
 
     /**
      * This operation wakes a given number (val) of waiters. If there are
@@ -232,49 +212,22 @@ class FutexMap : public std::unordered_map<FutexKey, WaiterList>
      * The return value is the number of waiters that are woken or
      * requeued.
      */
-    int
-    requeue(Addr addr1, uint64_t tgid, int count, int count2, Addr addr2)
-    {
-        FutexKey key1(addr1, tgid);
-        auto it1 = find(key1);
-
-        if (it1 == end())
-            return 0;
-
-        int woken_up = 0;
-        auto &waiterList1 = it1->second;
-
-        while (!waiterList1.empty() && woken_up < count) {
-            waiterList1.front().tc->activate();
-            waiterList1.pop_front();
-            woken_up++;
-        }
-
-        WaiterList tmpList;
-        int requeued = 0;
+    int requeue(Addr addr1, uint64_t tgid, int count, int count2,
+                Addr addr2);
 
-        while (!waiterList1.empty() && requeued < count2) {
-          auto w = waiterList1.front();
-          waiterList1.pop_front();
-          tmpList.push_back(w);
-          requeued++;
-        }
-
-        FutexKey key2(addr2, tgid);
-        auto it2 = find(key2);
-
-        if (it2 == end() && requeued > 0) {
-            insert({key2, tmpList});
-        } else {
-            it2->second.insert(it2->second.end(),
-                               tmpList.begin(), tmpList.end());
-        }
+  private:
+    /**
+     * Activate the waiters removed from the map. Waiters are grouped by
+     * event queue so that execution migrates once per queue.
+     */
+    static void activate(std::vector<ThreadContext *> &woken);
 
-        if (waiterList1.empty())
-            erase(it1);
+    /** Wait queues indexed by futex */
+    std::unordered_map<FutexKey, WaiterList> queues;
+    /** Wait queue entry of every thread context that ever waited */
+    std::unordered_map<ThreadContext *, WaiterState> waiters;
 
-        return woken_up + requeued;
-    }
+    std::mutex futexLock;
 };
 
 #endif // __FUTEX_MAP_HH__
@@ -31,6 +31,8 @@
 
 #include "sim/global_event.hh"
 
+#include <algorithm>
+
 std::mutex BaseGlobalEvent::globalQMutex;
 
 BaseGlobalEvent::BaseGlobalEvent(Priority p, Flags f)
@@ -151,9 +153,35 @@ GlobalSyncEvent::BarrierEvent::process()
     curEventQueue()->handleAsyncInsertions();
 }
 
+void
+GlobalSyncEvent::adaptRepeat(Tick min, Tick max)
+{
+    assert(min <= max);
+    minRepeat = min;
+    maxRepeat = max;
+    repeat = min;
+}
+
 void
 GlobalSyncEvent::process()
 {
+    // All other threads are waiting on the barrier, so the per-queue
+    // counters can be accessed safely.
+    if (maxRepeat > minRepeat) {
+        Counter cross_queue = 0;
+        for (uint32_t i = 0; i < numMainEventQueues; ++i) {
+            cross_queue += mainEventQueue[i]->getCrossQueueSchedules();
+            mainEventQueue[i]->resetCrossQueueSchedules();
+        }
+
+        if (cross_queue)
+            repeat = minRepeat;
+        else
+            repeat = std::min(maxRepeat, 2 * repeat);
+
+        simQuantum = repeat;
+    }
+
     if (repeat) {
         schedule(curTick() + repeat);
     }
@@ -219,20 +219,37 @@ class GlobalSyncEvent : public BaseGlobalEventTemplate<GlobalSyncEvent>
     };
 
     GlobalSyncEvent(Priority p, Flags f)
-        : Base(p, f), repeat(0)
+        : Base(p, f), repeat(0), minRepeat(0), maxRepeat(0)
     { }
 
     GlobalSyncEvent(Tick when, Tick _repeat, Priority p, Flags f)
-        : Base(p, f), repeat(_repeat)
+        : Base(p, f), repeat(_repeat), minRepeat(0), maxRepeat(0)
     {
         schedule(when);
     }
 
+    /**
+     * Adapt the repeat interval to the cross-queue traffic.
+     *
+     * After a period without any events scheduled across queues, the
+     * interval is doubled up to max. As soon as a period with
+     * cross-queue traffic is seen, it drops back to min, which must be
+     * short enough to guarantee that no cross-queue event can be
+     * scheduled in the past. simQuantum follows the interval so that
+     * global events are still scheduled after the next
+     * synchronization.
+     */
+    void adaptRepeat(Tick min, Tick max);
+
     void process();
 
     const char *description() const;
 
     Tick repeat;
+
+  private:
+    Tick minRepeat;
+    Tick maxRepeat;
 };
 
 
@@ -39,6 +39,8 @@
 
 #include "sim/linear_solver.hh"
 
+#include <algorithm>
+
 std::vector <double>
 LinearSystem::solve() const
 {
@@ -85,3 +87,101 @@ LinearSystem::solve() const
 
     return ret;
 }
+
+SparseLinearSystem::SparseLinearSystem(const LinearSystem &ls)
+    : order(ls.size()), diag(order, 0.0), useCG(true), dense(ls)
+{
+    // Keep the non-zero coefficients, negated so that the matrix of a
+    // nodal system is positive definite
+    for (unsigned row = 0; row < order; row++) {
+        rowStart.push_back(column.size());
+        for (unsigned i = 0; i < order; i++) {
+            const double coef = ls[row][i];
+            if (coef == 0.0)
+                continue;
+            column.push_back(i);
+            value.push_back(-coef);
+            if (i == row)
+                diag[row] = -coef;
+            // The conjugate gradient needs a symmetric matrix
+            if (coef != ls[i][row])
+                useCG = false;
+        }
+        if (diag[row] <= 0.0)
+            useCG = false;
+    }
+    rowStart.push_back(column.size());
+}
+
+bool
+SparseLinearSystem::solveCG(const std::vector <double> &cnt,
+                            std::vector <double> &x) const
+{
+    // Solve -A x = cnt, r is the residual, z the preconditioned
+    // residual and p the search direction
+    std::vector <double> r(order), z(order), p(order), q(order);
+    double norm_b = 0, rz = 0;
+    for (unsigned row = 0; row < order; row++) {
+        double ax = 0;
+        for (unsigned k = rowStart[row]; k < rowStart[row + 1]; k++)
+            ax += value[k] * x[column[k]];
+        r[row] = cnt[row] - ax;
+        z[row] = r[row] / diag[row];
+        p[row] = z[row];
+        rz += r[row] * z[row];
+        norm_b += cnt[row] * cnt[row];
+    }
+
+    const double tolerance = 1e-20 * std::max(norm_b, 1.0);
+    for (unsigned iter = 0; iter <= 2 * order; iter++) {
+        double rr = 0;
+        for (unsigned row = 0; row < order; row++)
+            rr += r[row] * r[row];
+        if (rr <= tolerance)
+            return true;
+
+        double pq = 0;
+        for (unsigned row = 0; row < order; row++) {
+            q[row] = 0;
+            for (unsigned k = rowStart[row]; k < rowStart[row + 1]; k++)
+                q[row] += value[k] * p[column[k]];
+            pq += p[row] * q[row];
+        }
+        if (pq <= 0.0)
+            return false;
+
+        const double alpha = rz / pq;
+        double rz_next = 0;
+        for (unsigned row = 0; row < order; row++) {
+            x[row] += alpha * p[row];
+            r[row] -= alpha * q[row];
+            z[row] = r[row] / diag[row];
+            rz_next += r[row] * z[row];
+        }
+
+        const double beta = rz_next / rz;
+        for (unsigned row = 0; row < order; row++)
+            p[row] = z[row] + beta * p[row];
+        rz = rz_next;
+    }
+
+    return false;
+}
+
+std::vector <double>
+SparseLinearSystem::solve(const std::vector <double> &cnt,
+                          const std::vector <double> &guess) const
+{
+    assert(cnt.size() == order && guess.size() == order);
+
+    std::vector <double> x = guess;
+    if (useCG && solveCG(cnt, x))
+        return x;
+
+    // Fall back to the dense solver, whose equations are of the form
+    // sum(coef * x) + cnt = 0
+    LinearSystem ls = dense;
+    for (unsigned row = 0; row < order; row++)
+        ls[row][ls[row].cnt()] = cnt[row];
+    return ls.solve();
+}
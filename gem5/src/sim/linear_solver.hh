@@ -83,6 +83,11 @@ class LinearEquation {
         return eq[unkw];
     }
 
+    double operator[] (unsigned unkw) const {
+        assert(unkw < eq.size());
+        return eq[unkw];
+    }
+
     // Get a string representation
     std::string toStr() const {
         std::ostringstream oss;
@@ -118,6 +123,13 @@ class LinearSystem {
         return matrix[eq];
     }
 
+    const LinearEquation & operator[] (unsigned eq) const {
+        assert(eq < matrix.size());
+        return matrix[eq];
+    }
+
+    unsigned size() const { return matrix.size(); }
+
     std::string toStr() const {
         std::string r;
         for (auto & eq: matrix)
@@ -131,4 +143,53 @@ class LinearSystem {
     std::vector < LinearEquation > matrix;
 };
 
+/**
+ * This class holds the coefficients of a linear system in a sparse
+ * (compressed row) form, so the system can be solved repeatedly for
+ * different constant terms. Symmetric systems with a negative diagonal
+ * (like the nodal equations of a thermal circuit) are solved with a
+ * Jacobi preconditioned conjugate gradient, starting from a guess of
+ * the solution. Any other system, or one the iteration fails to
+ * converge on, is solved by Gauss elimination of the dense system.
+ */
+class SparseLinearSystem {
+  public:
+    /**
+     * @param ls System to take the coefficients from, its constant
+     *           terms are ignored
+     */
+    SparseLinearSystem(const LinearSystem &ls);
+
+    /**
+     * Solve the system for the given constant terms
+     *
+     * @param cnt Constant term of each equation
+     * @param guess Initial guess of the solution (e.g. the previous one)
+     * @return Value of each unknown
+     */
+    std::vector <double> solve(const std::vector <double> &cnt,
+                               const std::vector <double> &guess) const;
+
+  private:
+    /** Solve with the conjugate gradient, false if it doesn't converge */
+    bool solveCG(const std::vector <double> &cnt,
+                 std::vector <double> &x) const;
+
+    /** Number of unknowns */
+    unsigned order;
+
+    /** Negated coefficients in compressed row form */
+    std::vector <unsigned> rowStart;
+    std::vector <unsigned> column;
+    std::vector <double> value;
+    /** Negated diagonal, the Jacobi preconditioner */
+    std::vector <double> diag;
+
+    /** The negated system is symmetric positive definite */
+    bool useCG;
+
+    /** Coefficients for the fallback solver */
+    LinearSystem dense;
+};
+
 #endif
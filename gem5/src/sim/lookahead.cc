@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/lookahead.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/logging.hh"
+#include "sim/eventq.hh"
+
+bool lookaheadSync = false;
+
+namespace {
+
+/**
+ * Clock published by a queue. Every event the owning thread
+ * schedules on another queue from now on happens at or after the
+ * published clock plus the lookahead of the link. Padded to a cache
+ * line to avoid false sharing between the simulation threads.
+ */
+struct PublishedClock
+{
+    std::atomic<Tick> clock;
+    char pad[64 - sizeof(std::atomic<Tick>)];
+
+    PublishedClock() : clock(0) {}
+};
+
+//! Minimum latency between each pair of queues, indexed [src][dst].
+std::vector<std::vector<Tick>> lookahead;
+
+//! Upstream queues and link latency, indexed by destination queue.
+std::vector<std::vector<std::pair<uint32_t, Tick>>> upstream;
+
+//! Published clock of each queue.
+std::vector<PublishedClock> clocks;
+
+int
+queueIndex(EventQueue *q)
+{
+    auto it = std::find(mainEventQueue.begin(), mainEventQueue.end(), q);
+    return it == mainEventQueue.end() ? -1 : it - mainEventQueue.begin();
+}
+
+void
+resize()
+{
+    if (lookahead.size() >= numMainEventQueues)
+        return;
+
+    lookahead.resize(numMainEventQueues);
+    for (auto &row : lookahead)
+        row.resize(numMainEventQueues, MaxTick);
+    upstream.resize(numMainEventQueues);
+}
+
+void
+addLink(uint32_t src, uint32_t dst, Tick latency)
+{
+    if (latency >= lookahead[src][dst])
+        return;
+
+    lookahead[src][dst] = latency;
+
+    auto &links = upstream[dst];
+    auto it = std::find_if(links.begin(), links.end(),
+                           [src](const std::pair<uint32_t, Tick> &l)
+                           { return l.first == src; });
+    if (it != links.end())
+        it->second = latency;
+    else
+        links.emplace_back(src, latency);
+}
+
+/**
+ * Compute the time before which no event from an upstream queue can
+ * arrive at the given queue.
+ */
+Tick
+horizon(uint32_t dst)
+{
+    Tick safe = MaxTick;
+    for (const auto &l : upstream[dst]) {
+        const Tick c = clocks[l.first].clock.load(std::memory_order_acquire);
+        safe = std::min(safe, c > MaxTick - l.second ? MaxTick :
+                        c + l.second);
+    }
+    return safe;
+}
+
+} // anonymous namespace
+
+void
+registerLookahead(EventQueue *a, EventQueue *b, Tick latency)
+{
+    if (a == b)
+        return;
+
+    const int ia = queueIndex(a);
+    const int ib = queueIndex(b);
+    if (ia < 0 || ib < 0)
+        panic("Lookahead can only be registered between main event queues");
+
+    fatal_if(latency == 0,
+             "Zero lookahead between %s and %s, queues can't be "
+             "synchronized conservatively.", a->name(), b->name());
+
+    resize();
+    addLink(ia, ib, latency);
+    addLink(ib, ia, latency);
+}
+
+Tick
+getLookahead(EventQueue *src, EventQueue *dst)
+{
+    const int is = queueIndex(src);
+    const int id = queueIndex(dst);
+    if (is < 0 || id < 0 || is >= lookahead.size() ||
+        id >= lookahead.size()) {
+        return MaxTick;
+    }
+    return lookahead[is][id];
+}
+
+void
+resetLookaheadClocks(Tick when)
+{
+    resize();
+    if (clocks.size() < numMainEventQueues)
+        clocks = std::vector<PublishedClock>(numMainEventQueues);
+
+    for (auto &c : clocks)
+        c.clock.store(when, std::memory_order_relaxed);
+}
+
+void
+waitForLookahead(EventQueue *eventq)
+{
+    // The index of a queue never changes once the simulation
+    // threads have been created, so cache it per thread.
+    static __thread EventQueue *cached_queue = nullptr;
+    static __thread uint32_t cached_index = 0;
+    if (cached_queue != eventq) {
+        const int idx = queueIndex(eventq);
+        assert(idx >= 0);
+        cached_queue = eventq;
+        cached_index = idx;
+    }
+
+    PublishedClock &own = clocks[cached_index];
+    while (true) {
+        // Anything our upstream queues scheduled before publishing
+        // their current clock is visible in the async queue now.
+        const Tick safe = horizon(cached_index);
+        eventq->handleAsyncInsertions();
+
+        const Tick next = eventq->nextTick();
+        if (next < safe) {
+            own.clock.store(next, std::memory_order_release);
+            return;
+        }
+
+        // We won't service anything before the horizon, so announce
+        // it. This is the null message that lets queues waiting on
+        // each other make progress.
+        if (safe > own.clock.load(std::memory_order_relaxed))
+            own.clock.store(safe, std::memory_order_release);
+
+        std::this_thread::yield();
+    }
+}
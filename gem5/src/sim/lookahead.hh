@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Lookahead-based conservative synchronization of the main event queues
+ */
+
+#ifndef __SIM_LOOKAHEAD_HH__
+#define __SIM_LOOKAHEAD_HH__
+
+#include "base/types.hh"
+
+class EventQueue;
+
+/**
+ * Enable lookahead-based synchronization between the main event
+ * queues.
+ *
+ * With a fixed simQuantum, every event scheduled from queue A onto
+ * queue B has to be at least simQuantum ticks into the future, and
+ * all queues meet at a barrier at the end of each quantum. In
+ * lookahead mode, objects that connect two queues (bridges, crossbars,
+ * serial links, ...) register the minimum latency of a message
+ * crossing between them using registerLookahead(). A queue then only
+ * services an event once every queue that can send it events is known
+ * to be far enough ahead that no earlier event can arrive (the
+ * Chandy-Misra-Bryant condition). Queues without a registered link
+ * between them never wait on each other.
+ *
+ * simQuantum still bounds how far the queues may drift apart since
+ * global events (exit, stat dumps) are scheduled simQuantum into the
+ * future. It can typically be set much larger than in quantum-only
+ * mode.
+ */
+extern bool lookaheadSync;
+
+/**
+ * Register the minimum latency of a connection between two event
+ * queues. Registering a link between the same queue is a no-op, and
+ * multiple registrations keep the minimum latency. The link is
+ * assumed to be bidirectional.
+ *
+ * The latency is a promise made by the caller: every event scheduled
+ * by a thread servicing one of the queues onto the other queue must
+ * be at least this many ticks into the future of the scheduling
+ * thread.
+ *
+ * @param a One end of the connection.
+ * @param b The other end of the connection.
+ * @param latency Minimum latency of a message between the queues.
+ */
+void registerLookahead(EventQueue *a, EventQueue *b, Tick latency);
+
+/**
+ * Get the minimum registered latency for events crossing from src to
+ * dst.
+ *
+ * @return The latency in ticks, or MaxTick if no link is registered.
+ */
+Tick getLookahead(EventQueue *src, EventQueue *dst);
+
+/**
+ * Reset the published clocks of all queues. Must be called before
+ * the simulation threads enter the event loop.
+ *
+ * @param when Current tick of all main event queues.
+ */
+void resetLookaheadClocks(Tick when);
+
+/**
+ * Block until the head of the given event queue is safe to service.
+ *
+ * The function repeatedly merges asynchronous insertions into the
+ * queue and publishes a lower bound on the time of the next event
+ * serviced by the calling thread, until all upstream queues have
+ * published clocks that guarantee no earlier event can arrive.
+ *
+ * @param eventq Event queue serviced by the calling thread.
+ */
+void waitForLookahead(EventQueue *eventq);
+
+#endif // __SIM_LOOKAHEAD_HH__
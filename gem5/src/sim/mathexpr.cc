@@ -40,6 +40,7 @@
 #include "sim/mathexpr.hh"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <regex>
 #include <string>
@@ -165,6 +166,85 @@ MathExpr::eval(const Node *n, EvalCallback fn) const {
     return 0;
 }
 
+bool
+MathExpr::compile(ResolveCallback fn)
+{
+    program.clear();
+    stack.clear();
+    return compile(root, fn, 0);
+}
+
+bool
+MathExpr::compile(const Node *n, ResolveCallback fn, unsigned depth)
+{
+    Instr instr {n->op, n->value, 0};
+
+    if (n->op == sVariable) {
+        const int var = fn(n->variable);
+        if (var < 0)
+            return false;
+        instr.var = var;
+    }
+
+    // Operands are pushed left to right, so the operand stack is at
+    // most as deep as the tree
+    if (depth >= stack.size())
+        stack.resize(depth + 1);
+
+    if (n->l && !compile(n->l, fn, depth))
+        return false;
+    if (n->r && !compile(n->r, fn, n->l ? depth + 1 : depth))
+        return false;
+
+    program.push_back(instr);
+    return true;
+}
+
+double
+MathExpr::evalCompiled(const std::vector<double> &values) const
+{
+    double *top = stack.data();
+
+    for (const auto &instr : program) {
+        switch (instr.op) {
+          case sValue:
+            *top++ = instr.value;
+            break;
+          case sVariable:
+            *top++ = values[instr.var];
+            break;
+          case uNeg:
+            top[-1] = -top[-1];
+            break;
+          case bAdd:
+            --top;
+            top[-1] += top[0];
+            break;
+          case bSub:
+            --top;
+            top[-1] -= top[0];
+            break;
+          case bMul:
+            --top;
+            top[-1] *= top[0];
+            break;
+          case bDiv:
+            --top;
+            top[-1] /= top[0];
+            break;
+          case bPow:
+            --top;
+            top[-1] = std::pow(top[-1], top[0]);
+            break;
+          default:
+            panic("Invalid instruction!\n");
+        }
+    }
+
+    assert(top == stack.data() + 1);
+    return stack[0];
+}
+
 std::string
 MathExpr::toStr(Node *n, std::string prefix) const {
     std::string ret;
@@ -44,6 +44,7 @@
 #include <array>
 #include <functional>
 #include <string>
+#include <vector>
 
 class MathExpr {
   public:
@@ -68,6 +69,30 @@ class MathExpr {
      */
     double eval(EvalCallback fn) const { return eval(root, fn); }
 
+    typedef std::function<int(const std::string &)> ResolveCallback;
+
+    /**
+     * Compiles the expression into a flat program in postfix order,
+     * so it can be evaluated repeatedly without walking the tree or
+     * looking up variables by name
+     *
+     * @param fn A callback function mapping each variable to an index
+     *           in the values passed to evalCompiled, or to a negative
+     *           value if the variable is unknown
+     *
+     * @return false if a variable could not be resolved
+     */
+    bool compile(ResolveCallback fn);
+
+    /**
+     * Evaluates the compiled expression
+     *
+     * @param values The values of the variables, by resolved index
+     *
+     * @return The value for this expression
+     */
+    double evalCompiled(const std::vector<double> &values) const;
+
   private:
     enum Operator {
         bAdd, bSub, bMul, bDiv, bPow, uNeg, sValue, sVariable, nInvalid
@@ -121,6 +146,23 @@ class MathExpr {
 
     /** Eval a node */
     double eval(const Node *n, EvalCallback fn) const;
+
+    /** Instruction of a compiled expression */
+    struct Instr {
+        Operator op;
+        // Constant of sValue, or variable index of sVariable
+        double value;
+        unsigned var;
+    };
+
+    /** Compile a node and its children, return false on failure */
+    bool compile(const Node *n, ResolveCallback fn, unsigned depth);
+
+    /** Compiled expression in postfix order */
+    std::vector<Instr> program;
+
+    /** Operand stack for the evaluation of the compiled expression */
+    mutable std::vector<double> stack;
 };
 
 #endif
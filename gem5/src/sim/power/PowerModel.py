@@ -66,3 +66,9 @@ class PowerModel(SimObject):
 
     # Ambient temperature to be used when no thermal model is present
     ambient_temp = Param.Float(25.0, "Ambient temperature")
+
+    # Power is evaluated whenever it is queried (by the stats or the
+    # thermal model) unless a sampling period is set, in which case it
+    # is evaluated at that period and the last sample is reported
+    sample_period = Param.Latency('0ns', "Power sampling period "
+                                  "(0 to evaluate power on every query)")
@@ -39,6 +39,8 @@
 
 #include "sim/power/mathexpr_powermodel.hh"
 
+#include <algorithm>
+#include <functional>
 #include <string>
 
 #include "base/statistics.hh"
@@ -48,7 +50,7 @@
 #include "sim/sim_object.hh"
 
 MathExprPowerModel::MathExprPowerModel(const Params *p)
-    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st), failed(false)
+    : PowerModelState(p), dyn_expr(p->dyn), st_expr(p->st)
 {
     // Calculate the name of the object we belong to
     std::vector<std::string> path;
@@ -64,6 +66,7 @@ MathExprPowerModel::startup()
 {
     // Create a map with stats and pointers for quick access
     // Has to be done here, since we need access to the statsList
+    std::unordered_map<std::string, Stats::Info*> stats_map;
     for (auto & i: Stats::statsList()) {
         if (i->name.find(basename) == 0) {
             // Add stats for this sim object and its child objects
@@ -74,11 +77,13 @@ MathExprPowerModel::startup()
         }
     }
 
-    tryEval(st_expr);
-    const bool st_failed = failed;
-
-    tryEval(dyn_expr);
-    const bool dyn_failed = failed;
+    using namespace std::placeholders;
+    const bool st_failed = !st_expr.compile(
+        std::bind(&MathExprPowerModel::resolve, this, _1,
+                  std::cref(stats_map), std::ref(stVars)));
+    const bool dyn_failed = !dyn_expr.compile(
+        std::bind(&MathExprPowerModel::resolve, this, _1,
+                  std::cref(stats_map), std::ref(dynVars)));
 
     if (st_failed || dyn_failed) {
         const auto *p = dynamic_cast<const Params *>(params());
@@ -89,66 +94,86 @@ MathExprPowerModel::startup()
               st_failed && dyn_failed ? "\n" : "",
               dyn_failed ? p->dyn : "");
     }
+
+    values.resize(variables.size());
 }
 
-double
-MathExprPowerModel::eval(const MathExpr &expr) const
+int
+MathExprPowerModel::resolve(
+    const std::string &name,
+    const std::unordered_map<std::string, Stats::Info*> &stats_map,
+    std::vector<unsigned> &vars)
 {
-    const double value = tryEval(expr);
+    using namespace Stats;
 
-    // This shouldn't happen unless something went wrong the equations
-    // were verified in startup().
-    panic_if(failed, "Failed to evaluate power expression '%s'\n",
-             expr.toStr());
+    // Variables used by both expressions are only added once
+    unsigned var = 0;
+    while (var < variableNames.size() && variableNames[var] != name)
+        ++var;
+
+    if (var == variableNames.size()) {
+        // Automatic variables:
+        Variable v { Variable::Temp, nullptr, nullptr };
+        if (name == "temp") {
+            v.kind = Variable::Temp;
+        } else if (name == "voltage") {
+            v.kind = Variable::Voltage;
+        } else if (name == "clock_period") {
+            v.kind = Variable::ClockPeriod;
+        } else {
+            // Try to cast the stat, only these are supported right now
+            const auto it = stats_map.find(name);
+            if (it == stats_map.cend()) {
+                warn("Failed to find stat '%s'\n", name);
+                return -1;
+            }
+
+            const Info *info = it->second;
+            if ((v.scalar = dynamic_cast<const ScalarInfo *>(info)))
+                v.kind = Variable::Scalar;
+            else if ((v.formula = dynamic_cast<const FormulaInfo *>(info)))
+                v.kind = Variable::Formula;
+            else
+                panic("Unknown stat type!\n");
+        }
 
-    return value;
-}
+        variables.push_back(v);
+        variableNames.push_back(name);
+    }
 
-double
-MathExprPowerModel::tryEval(const MathExpr &expr) const
-{
-    failed = false;
-    const double value = expr.eval(
-        std::bind(&MathExprPowerModel::getStatValue,
-                  this, std::placeholders::_1)
-        );
+    if (std::find(vars.begin(), vars.end(), var) == vars.end())
+        vars.push_back(var);
 
-    return value;
+    return var;
 }
 
-
 double
-MathExprPowerModel::getStatValue(const std::string &name) const
+MathExprPowerModel::eval(const MathExpr &expr,
+                         const std::vector<unsigned> &vars) const
 {
-    using namespace Stats;
-
-    // Automatic variables:
-    if (name == "temp") {
-        return _temp;
-    } else if (name == "voltage") {
-        return clocked_object->voltage();
-    } else if (name=="clock_period") {
-        return clocked_object->clockPeriod();
-    } 
-
-    // Try to cast the stat, only these are supported right now
-    const auto it = stats_map.find(name);
-    if (it == stats_map.cend()) {
-        warn("Failed to find stat '%s'\n", name);
-        failed = true;
-        return 0;
+    // Read each variable of the expression once
+    for (auto i : vars) {
+        const Variable &var = variables[i];
+        switch (var.kind) {
+          case Variable::Temp:
+            values[i] = _temp;
+            break;
+          case Variable::Voltage:
+            values[i] = clocked_object->voltage();
+            break;
+          case Variable::ClockPeriod:
+            values[i] = clocked_object->clockPeriod();
+            break;
+          case Variable::Scalar:
+            values[i] = var.scalar->value();
+            break;
+          case Variable::Formula:
+            values[i] = var.formula->total();
+            break;
+        }
     }
 
-    const Info *info = it->second;
-
-    auto si = dynamic_cast<const ScalarInfo *>(info);
-    if (si)
-        return si->value();
-    auto fi = dynamic_cast<const FormulaInfo *>(info);
-    if (fi)
-        return fi->total();
-
-    panic("Unknown stat type!\n");
+    return expr.evalCompiled(values);
 }
 
 void
@@ -41,6 +41,7 @@
 #define __SIM_MATHEXPR_POWERMODEL_PM_HH__
 
 #include <unordered_map>
+#include <vector>
 
 #include "params/MathExprPowerModel.hh"
 #include "sim/mathexpr.hh"
@@ -48,11 +49,17 @@
 
 namespace Stats {
     class Info;
+    class ScalarInfo;
+    class FormulaInfo;
 }
 
 /**
  * A Equation power model. The power is represented as a combination
  * of some stats and automatic variables (like temperature).
+ *
+ * The expressions are compiled at startup, with their variables
+ * resolved to the stats and automatic variables they refer to, so an
+ * evaluation reads each variable once and runs the compiled programs.
  */
 class MathExprPowerModel : public PowerModelState
 {
@@ -66,46 +73,50 @@ class MathExprPowerModel : public PowerModelState
      *
      * @return Power (Watts) consumed by this object (dynamic component)
      */
-    double getDynamicPower() const { return eval(dyn_expr); }
+    double getDynamicPower() const override { return eval(dyn_expr, dynVars); }
 
     /**
      * Get the static power consumption.
      *
      * @return Power (Watts) consumed by this object (static component)
      */
-    double getStaticPower() const { return eval(st_expr); }
+    double getStaticPower() const override { return eval(st_expr, stVars); }
 
-    /**
-     * Get the value for a variable (maps to a stat)
-     *
-     * @param name Name of the variable to retrieve the value from
-     *
-     * @return Power (Watts) consumed by this object (static component)
-     */
-    double getStatValue(const std::string & name) const;
+    void startup() override;
 
-    void startup();
-
-    void regStats();
+    void regStats() override;
 
   private:
     /**
-     * Evaluate an expression in the context of this object, fatal if
-     * evaluation fails.
+     * Evaluate an expression in the context of this object.
      *
      * @param expr Expression to evaluate
+     * @param vars Variables used by the expression
      * @return Value of expression.
      */
-    double eval(const MathExpr &expr) const;
+    double eval(const MathExpr &expr,
+                const std::vector<unsigned> &vars) const;
+
+    /** Source of the value of a variable of the expressions */
+    struct Variable {
+        enum Kind { Temp, Voltage, ClockPeriod, Scalar, Formula };
+        Kind kind;
+        const Stats::ScalarInfo *scalar;
+        const Stats::FormulaInfo *formula;
+    };
 
     /**
-     * Evaluate an expression in the context of this object, set
-     * failed if evaluation failed.
+     * Map a variable to its index in values, adding it to the
+     * variables if it is new
      *
-     * @param expr Expression to evaluate
-     * @return Value of expression.
+     * @param name Name of the variable (a stat or automatic variable)
+     * @param stats_map Stats visible to this power model, by name
+     * @param vars Variables used by the expression being compiled
+     * @return Index of the variable, or -1 if it can't be resolved
      */
-    double tryEval(const MathExpr &expr) const;
+    int resolve(const std::string &name,
+                const std::unordered_map<std::string, Stats::Info*> &stats_map,
+                std::vector<unsigned> &vars);
 
     // Math expressions for dynamic and static power
     MathExpr dyn_expr, st_expr;
@@ -113,12 +124,15 @@ class MathExprPowerModel : public PowerModelState
     // Basename of the object in the gem5 stats hierachy
     std::string basename;
 
-    // Map that contains relevant stats for this power model
-    std::unordered_map<std::string, Stats::Info*> stats_map;
+    // Variables of the expressions and their names
+    std::vector<Variable> variables;
+    std::vector<std::string> variableNames;
+
+    // Variables used by the dynamic and static power expressions
+    std::vector<unsigned> dynVars, stVars;
 
-    // Did the expression fail to evaluate (e.g., because a stat value
-    // can't be resolved)
-    mutable bool failed;
+    // Current values of the variables
+    mutable std::vector<double> values;
 };
 
 #endif
@@ -52,7 +52,10 @@ PowerModelState::PowerModelState(const Params *p)
 
 PowerModel::PowerModel(const Params *p)
     : SimObject(p), states_pm(p->pm), subsystem(p->subsystem),
-      clocked_object(NULL), power_model_type(p->pm_type)
+      clocked_object(NULL), power_model_type(p->pm_type),
+      samplePeriod(p->sample_period),
+      sampledDynamicPower(0), sampledStaticPower(0),
+      sampleEvent([this]{ samplePower(); }, name())
 {
     panic_if(subsystem == NULL,
              "Subsystem is NULL! This is not acceptable for a PowerModel!\n");
@@ -89,6 +92,24 @@ PowerModel::regProbePoints()
     ));
 }
 
+void
+PowerModel::startup()
+{
+    if (samplePeriod)
+        schedule(sampleEvent, curTick());
+}
+
+void
+PowerModel::samplePower()
+{
+    // All the power states are evaluated together, and the stats and
+    // the thermal model report this sample until the next one
+    sampledDynamicPower = evalDynamicPower();
+    sampledStaticPower = evalStaticPower();
+
+    schedule(sampleEvent, curTick() + samplePeriod);
+}
+
 PowerModel*
 PowerModelParams::create()
 {
@@ -97,6 +118,18 @@ PowerModelParams::create()
 
 double
 PowerModel::getDynamicPower() const
+{
+    return samplePeriod ? sampledDynamicPower : evalDynamicPower();
+}
+
+double
+PowerModel::getStaticPower() const
+{
+    return samplePeriod ? sampledStaticPower : evalStaticPower();
+}
+
+double
+PowerModel::evalDynamicPower() const
 {
     assert(clocked_object);
 
@@ -122,7 +155,7 @@ PowerModel::getDynamicPower() const
 }
 
 double
-PowerModel::getStaticPower() const
+PowerModel::evalStaticPower() const
 {
     assert(clocked_object);
 
@@ -44,6 +44,7 @@
 #include "enums/PMType.hh"
 #include "params/PowerModel.hh"
 #include "params/PowerModelState.hh"
+#include "sim/eventq.hh"
 #include "sim/probe/probe.hh"
 
 class SimObject;
@@ -154,9 +155,20 @@ class PowerModel : public SimObject
 
     virtual void regProbePoints();
 
+    void startup() override;
+
     void thermalUpdateCallback(const double & temp);
 
   protected:
+    /** Evaluate the dynamic power of all the power states. */
+    double evalDynamicPower() const;
+
+    /** Evaluate the static power of all the power states. */
+    double evalStaticPower() const;
+
+    /** Evaluate and record the power, and schedule the next sample. */
+    void samplePower();
+
     /** Listener class to catch thermal events */
     class ThermalProbeListener : public ProbeListenerArgBase<double>
     {
@@ -190,6 +202,15 @@ class PowerModel : public SimObject
 
     /** The type of power model - collects all power, static or dynamic only */
     Enums::PMType power_model_type;
+
+    /** Power sampling period, 0 if power is evaluated on every query */
+    const Tick samplePeriod;
+
+    /** Power at the last sample */
+    double sampledDynamicPower;
+    double sampledStaticPower;
+
+    EventFunctionWrapper sampleEvent;
 };
 
 #endif
@@ -220,20 +220,21 @@ void
 ThermalModel::doStep()
 {
     // Calculate new temperatures!
-    // For each node in the system, create the kirchhoff nodal equation
-    LinearSystem ls(eq_nodes.size());
-    for (unsigned i = 0; i < eq_nodes.size(); i++) {
-        auto n = eq_nodes[i];
-        LinearEquation node_equation (eq_nodes.size());
-        for (auto e : entities) {
-            LinearEquation eq = e->getEquation(n, eq_nodes.size(), _step);
-            node_equation = node_equation + eq;
-        }
-        ls[i] = node_equation;
+    // Only the constant terms of the kirchhoff nodal equations
+    // change, collect them from the entities connected to each node
+    std::vector <double> cnt(eq_nodes.size(), 0.0);
+    std::vector <double> temps(eq_nodes.size());
+    for (auto &term : terms) {
+        LinearEquation eq = term.entity->getEquation(eq_nodes[term.node],
+                                                     eq_nodes.size(), _step);
+        cnt[term.node] += eq[eq.cnt()];
     }
+    for (unsigned i = 0; i < eq_nodes.size(); i++)
+        temps[i] = eq_nodes[i]->temp;
 
-    // Get temperatures for this iteration
-    std::vector <double> temps = ls.solve();
+    // Get temperatures for this iteration, starting from the current
+    // ones as they change slowly
+    temps = system->solve(cnt, temps);
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->temp = temps[i];
 
@@ -274,6 +275,33 @@ ThermalModel::startup()
     for (unsigned i = 0; i < eq_nodes.size(); i++)
         eq_nodes[i]->id = i;
 
+    // For each node in the system, create the kirchhoff nodal equation
+    // and keep track of the entities connected to it
+    LinearSystem ls(eq_nodes.size());
+    for (unsigned i = 0; i < eq_nodes.size(); i++) {
+        auto n = eq_nodes[i];
+        LinearEquation node_equation (eq_nodes.size());
+        for (auto e : entities) {
+            LinearEquation eq = e->getEquation(n, eq_nodes.size(), _step);
+            bool connected = false;
+            for (unsigned j = 0; j < eq_nodes.size(); j++)
+                connected = connected || eq[j] != 0.0;
+            if (connected)
+                terms.push_back(Term { e, i });
+            node_equation = node_equation + eq;
+        }
+        ls[i] = node_equation;
+    }
+
+    // Domains only contribute a constant term (their power)
+    for (auto dom : domains) {
+        auto n = dom->getNode();
+        if (!n->isref)
+            terms.push_back(Term { dom, static_cast<unsigned>(n->id) });
+    }
+
+    system.reset(new SparseLinearSystem(ls));
+
     // Schedule first thermal update
     schedule(stepEvent, curTick() + SimClock::Int::s * _step);
 }
@@ -40,6 +40,7 @@
 #ifndef __SIM_THERMAL_MODEL_HH__
 #define __SIM_THERMAL_MODEL_HH__
 
+#include <memory>
 #include <vector>
 
 #include "params/ThermalCapacitor.hh"
@@ -47,6 +48,7 @@
 #include "params/ThermalReference.hh"
 #include "params/ThermalResistor.hh"
 #include "sim/clocked_object.hh"
+#include "sim/linear_solver.hh"
 #include "sim/power/thermal_domain.hh"
 #include "sim/power/thermal_entity.hh"
 #include "sim/power/thermal_node.hh"
@@ -180,6 +182,20 @@ class ThermalModel : public ClockedObject
     std::vector <ThermalNode*> nodes;
     std::vector <ThermalNode*> eq_nodes;
 
+    /**
+     * Coefficients of the nodal equations. They only depend on the
+     * circuit and the step, so they are set up once and only the
+     * constant terms are computed at every step.
+     */
+    std::unique_ptr<SparseLinearSystem> system;
+
+    /** Entity contributing to the equation of a node */
+    struct Term {
+        ThermalEntity *entity;
+        unsigned node;
+    };
+    std::vector <Term> terms;
+
     /** Stepping event to update the model values */
     EventFunctionWrapper stepEvent;
 
@@ -281,6 +281,11 @@ class ProbePointArg : public ProbePoint
                         listeners.end());
     }
 
+    /**
+     * @brief whether any ProbeListener is on the notify list.
+     */
+    bool hasListeners() const { return !listeners.empty(); }
+
     /**
      * @brief called at the ProbePoint call site, passes arg to each listener.
      * @param arg the argument to pass to each listener.
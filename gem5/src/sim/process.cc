@@ -49,10 +49,13 @@
 #include <fcntl.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <array>
 #include <climits>
 #include <csignal>
+#include <cstring>
 #include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -103,6 +106,7 @@ Process::Process(ProcessParams *params, EmulationPageTable *pTable,
       _pid(params->pid), _ppid(params->ppid),
       _pgid(params->pgid), drivers(params->drivers),
       fds(make_shared<FDArray>(params->input, params->output, params->errout)),
+      lazyImage(make_shared<LazyImage>()), lazyLoad(params->lazyLoad),
       childClearTID(0)
 {
     if (_pid >= System::maxPID)
@@ -130,13 +134,14 @@ Process::Process(ProcessParams *params, EmulationPageTable *pTable,
     sigchld = new bool();
 
     if (!debugSymbolTable) {
+        // Only parse the symbols if something looks them up.
         debugSymbolTable = new SymbolTable();
-        if (!objFile->loadGlobalSymbols(debugSymbolTable) ||
-            !objFile->loadLocalSymbols(debugSymbolTable) ||
-            !objFile->loadWeakSymbols(debugSymbolTable)) {
-            delete debugSymbolTable;
-            debugSymbolTable = nullptr;
-        }
+        ObjectFile *obj = objFile;
+        debugSymbolTable->deferLoad([obj](SymbolTable *symtab) {
+            obj->loadGlobalSymbols(symtab);
+            obj->loadLocalSymbols(symtab);
+            obj->loadWeakSymbols(symtab);
+        });
     }
 }
 
@@ -166,6 +171,7 @@ Process::clone(ThreadContext *otc, ThreadContext *ntc,
         proxy.setPageTable(np->pTable);
 
         np->memState = memState;
+        np->lazyImage = lazyImage;
     } else {
         /**
          * Duplicate the process memory address space. The state needs to be
@@ -182,6 +188,12 @@ Process::clone(ThreadContext *otc, ThreadContext *ntc,
         }
 
         *np->memState = *memState;
+
+        // The pages of the executable the parent hasn't touched yet can
+        // still be loaded lazily by either process.
+        std::lock_guard<std::mutex> lock(lazyImage->lock);
+        np->lazyImage->segments = lazyImage->segments;
+        np->lazyImage->pending = lazyImage->pending;
     }
 
     if (CLONE_FILES & flags) {
@@ -296,12 +308,103 @@ void
 Process::allocateMem(Addr vaddr, int64_t size, bool clobber)
 {
     int npages = divCeil(size, (int64_t)PageBytes);
+
+    // New memory replaces any untouched page of the executable.
+    {
+        std::lock_guard<std::mutex> lock(lazyImage->lock);
+        dropLazyPages(vaddr, vaddr + npages * PageBytes);
+    }
+
     Addr paddr = system->allocPhysPages(npages);
     pTable->map(vaddr, paddr, size,
                 clobber ? EmulationPageTable::Clobber :
                           EmulationPageTable::MappingFlags(0));
 }
 
+void
+Process::dropLazyPages(Addr start, Addr end)
+{
+    auto &pending = lazyImage->pending;
+    auto it = pending.upper_bound(start);
+    if (it != pending.begin() && std::prev(it)->second > start)
+        --it;
+
+    while (it != pending.end() && it->first < end) {
+        Addr range_start = it->first;
+        Addr range_end = it->second;
+        it = pending.erase(it);
+        if (range_start < start)
+            pending[range_start] = start;
+        if (range_end > end)
+            it = pending.emplace(end, range_end).first;
+    }
+}
+
+void
+Process::loadSegments()
+{
+    if (!lazyLoad) {
+        objFile->loadSegments(initVirtMem);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(lazyImage->lock);
+    lazyImage->segments.clear();
+    objFile->appendSegments(lazyImage->segments);
+
+    auto &pending = lazyImage->pending;
+    for (const auto &seg : lazyImage->segments) {
+        Addr start = roundDown(seg.base, PageBytes);
+        Addr end = roundUp(seg.base + seg.size, PageBytes);
+
+        // Merge with the ranges the segment overlaps or touches.
+        auto it = pending.upper_bound(start);
+        if (it != pending.begin() && std::prev(it)->second >= start)
+            --it;
+        while (it != pending.end() && it->first <= end) {
+            start = std::min(start, it->first);
+            end = std::max(end, it->second);
+            it = pending.erase(it);
+        }
+        pending[start] = end;
+    }
+}
+
+bool
+Process::loadLazyPage(Addr vaddr)
+{
+    std::lock_guard<std::mutex> lock(lazyImage->lock);
+    Addr page = roundDown(vaddr, PageBytes);
+
+    auto &pending = lazyImage->pending;
+    auto it = pending.upper_bound(page);
+    if (it == pending.begin() || std::prev(it)->second <= page)
+        return false;
+
+    dropLazyPages(page, page + PageBytes);
+
+    // Build the page the way loadSegments() would have, later segments
+    // overwriting earlier ones.
+    std::vector<uint8_t> buf(PageBytes, 0);
+    for (const auto &seg : lazyImage->segments) {
+        Addr start = std::max<Addr>(seg.base, page);
+        Addr end = std::min<Addr>(seg.base + seg.size, page + PageBytes);
+        if (start >= end)
+            continue;
+        if (seg.data) {
+            std::memcpy(&buf[start - page], seg.data + (start - seg.base),
+                        end - start);
+        } else {
+            std::memset(&buf[start - page], 0, end - start);
+        }
+    }
+
+    Addr paddr = system->allocPhysPages(1);
+    pTable->map(page, paddr, PageBytes);
+    system->physProxy.writeBlob(paddr, buf.data(), PageBytes);
+    return true;
+}
+
 void
 Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
                        ThreadContext *new_tc, bool allocate_page)
@@ -322,8 +425,11 @@ Process::replicatePage(Addr vaddr, Addr new_paddr, ThreadContext *old_tc,
 }
 
 bool
-Process::fixupStackFault(Addr vaddr)
+Process::fixupFault(Addr vaddr)
 {
+    if (loadLazyPage(vaddr))
+        return true;
+
     Addr stack_min = memState->getStackMin();
     Addr stack_base = memState->getStackBase();
     Addr max_stack_size = memState->getMaxStackSize();
@@ -356,6 +462,22 @@ Process::serialize(CheckpointOut &cp) const
 {
     memState->serialize(cp);
     pTable->serialize(cp);
+
+    std::vector<Addr> lazy_start, lazy_end;
+    {
+        std::lock_guard<std::mutex> lock(lazyImage->lock);
+        for (const auto &range : lazyImage->pending) {
+            lazy_start.push_back(range.first);
+            lazy_end.push_back(range.second);
+        }
+    }
+    arrayParamOut(cp, "lazyPages.start", lazy_start);
+    arrayParamOut(cp, "lazyPages.end", lazy_end);
+
+    // The segments of a relocated interpreter depend on its bias.
+    ObjectFile *interp = objFile->getInterpreter();
+    if (interp && interp->relocatable())
+        paramOut(cp, "interpBias", interp->bias());
     /**
      * Checkpoints for file descriptors currently do not work. Need to
      * come back and fix them at a later date.
@@ -369,6 +491,30 @@ Process::unserialize(CheckpointIn &cp)
 {
     memState->unserialize(cp);
     pTable->unserialize(cp);
+
+    // Checkpoints without lazily loaded pages have the whole executable
+    // in memory already.
+    if (cp.entryExists(Serializable::currentSection(), "lazyPages.start")) {
+        std::vector<Addr> lazy_start, lazy_end;
+        arrayParamIn(cp, "lazyPages.start", lazy_start);
+        arrayParamIn(cp, "lazyPages.end", lazy_end);
+        fatal_if(lazy_start.size() != lazy_end.size(),
+                 "Malformed lazily loaded page list in checkpoint");
+
+        ObjectFile *interp = objFile->getInterpreter();
+        Addr interp_bias;
+        if (interp && interp->relocatable() &&
+            optParamIn(cp, "interpBias", interp_bias)) {
+            interp->updateBias(interp_bias);
+        }
+
+        std::lock_guard<std::mutex> lock(lazyImage->lock);
+        lazyImage->segments.clear();
+        objFile->appendSegments(lazyImage->segments);
+        lazyImage->pending.clear();
+        for (int i = 0; i < lazy_start.size(); i++)
+            lazyImage->pending[lazy_start[i]] = lazy_end[i];
+    }
     /**
      * Checkpoints for file descriptors currently do not work. Need to
      * come back and fix them at a later date.
@@ -37,10 +37,13 @@
 #include <inttypes.h>
 
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
 #include "arch/registers.hh"
+#include "base/loader/object_file.hh"
 #include "base/statistics.hh"
 #include "base/types.hh"
 #include "config/the_isa.hh"
@@ -53,7 +56,6 @@
 struct ProcessParams;
 
 class EmulatedDriver;
-class ObjectFile;
 class EmulationPageTable;
 class SyscallDesc;
 class SyscallReturn;
@@ -113,9 +115,27 @@ class Process : public SimObject
 
     void allocateMem(Addr vaddr, int64_t size, bool clobber = false);
 
-    /// Attempt to fix up a fault at vaddr by allocating a page on the stack.
+    /// Attempt to fix up a fault at vaddr by loading a page of the
+    /// executable or by allocating a page on the stack.
     /// @return Whether the fault has been fixed.
-    bool fixupStackFault(Addr vaddr);
+    bool fixupFault(Addr vaddr);
+
+    /**
+     * Load the page containing vaddr if it belongs to the executable
+     * and hasn't been touched yet.
+     * @return Whether a page has been loaded.
+     */
+    bool loadLazyPage(Addr vaddr);
+
+    /**
+     * Load the segments of the executable and its interpreter. With
+     * lazyLoad, pages are only copied into memory when first touched.
+     */
+    void loadSegments();
+
+    /// Forget the untouched pages of the executable in [start, end).
+    /// The caller must hold the lock of lazyImage.
+    void dropLazyPages(Addr start, Addr end);
 
     // After getting registered with system object, tell process which
     // system-wide context id it is assigned.
@@ -247,6 +267,22 @@ class Process : public SimObject
     bool *exitGroup;
     std::shared_ptr<MemState> memState;
 
+    /**
+     * Segments of the executable that are loaded a page at a time when
+     * first touched, along with the pages that haven't been touched
+     * yet. Like the page table, this is shared by processes sharing
+     * their address space.
+     */
+    struct LazyImage
+    {
+        std::vector<ObjectFile::Segment> segments;
+        /** Untouched pages, as ranges from their start to their end */
+        std::map<Addr, Addr> pending;
+        std::mutex lock;
+    };
+    std::shared_ptr<LazyImage> lazyImage;
+    bool lazyLoad;
+
     /**
      * Calls a futex wakeup at the address specified by this pointer when
      * this process exits.
@@ -69,6 +69,7 @@
 #include "dev/net/dist_iface.hh"
 #include "kern/kernel_stats.hh"
 #include "params/BaseCPU.hh"
+#include "sim/debug_trigger.hh"
 #include "sim/full_system.hh"
 #include "sim/initparam_keys.hh"
 #include "sim/process.hh"
@@ -100,6 +101,8 @@ pseudoInst(ThreadContext *tc, uint8_t func, uint8_t subfunc)
 
     DPRINTF(PseudoInst, "PseudoInst::pseudoInst(%i, %i)\n", func, subfunc);
 
+    DebugTrigger::pseudoOp(func);
+
     // We need to do this in a slightly convoluted way since
     // getArgument() might have side-effects on arg_num. We could have
     // used the Argument class, but due to the possible side effects
@@ -35,8 +35,10 @@
 #include "base/trace.hh"
 #include "config/the_isa.hh"
 #include "debug/TimeSync.hh"
+#include "sim/event_replay.hh"
 #include "sim/eventq_impl.hh"
 #include "sim/full_system.hh"
+#include "sim/lookahead.hh"
 #include "sim/root.hh"
 
 Root *Root::_root = NULL;
@@ -116,12 +118,39 @@ Root::Root(RootParams *p)
     lastTime.setTimer();
 
     simQuantum = p->sim_quantum;
+    simQuantumMin = p->sim_quantum;
+    simQuantumMax = p->sim_quantum_max;
+    if (simQuantumMax && simQuantumMax < simQuantumMin)
+        fatal("sim_quantum_max must not be smaller than sim_quantum");
+    lookaheadSync = p->lookahead_sync;
+
+    // Some queues have already been created by the objects
+    // instantiated before us, so convert them too.
+    EventQueue::defaultBackend = p->eventq_backend == Enums::calendar ?
+        EventQueue::Backend::Calendar : EventQueue::Backend::LinkedList;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        mainEventQueue[i]->setBackend(EventQueue::defaultBackend);
 }
 
 void
 Root::startup()
 {
     timeSyncEnable(params()->time_sync_enable);
+
+    if (params()->eventq_replay != Enums::off && numMainEventQueues > 1) {
+        fatal_if(lookaheadSync,
+                 "Event replay doesn't support lookahead synchronization.");
+        EventReplay::enable(params()->eventq_replay == Enums::record ?
+                            EventReplay::Mode::Record :
+                            EventReplay::Mode::Replay,
+                            params()->eventq_replay_log);
+    }
+
+    if (params()->event_profile_interval) {
+        for (uint32_t i = 0; i < numMainEventQueues; ++i)
+            mainEventQueue[i]->enableProfiling(
+                params()->event_profile_interval);
+    }
 }
 
 void
@@ -74,7 +74,7 @@ using namespace std;
 int Serializable::ckptMaxCount = 0;
 int Serializable::ckptCount = 0;
 int Serializable::ckptPrevCount = -1;
-std::stack<std::string> Serializable::path;
+thread_local std::stack<std::string> Serializable::path;
 
 /////////////////////////////
 
@@ -112,8 +112,7 @@ Globals::unserialize(CheckpointIn &cp)
     paramIn(cp, "curTick", unserializedCurTick);
 
     const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, "version_tags", str)) {
+    if (!cp.entryExists(section, "version_tags")) {
         warn("**********************************************************\n");
         warn("!!!! Checkpoint uses an old versioning scheme.        !!!!\n");
         warn("Run the checkpoint upgrader (util/cpt_upgrader.py) on your "
@@ -187,18 +186,21 @@ Serializable::unserializeSection(CheckpointIn &cp, const char *name)
 }
 
 void
-Serializable::serializeAll(const string &cpt_dir)
+Serializable::serializeAll(const string &cpt_dir, bool text)
 {
     string dir = CheckpointIn::setDir(cpt_dir);
     if (mkdir(dir.c_str(), 0775) == -1 && errno != EEXIST)
             fatal("couldn't mkdir %s\n", dir);
 
     string cpt_file = dir + CheckpointIn::baseFilename;
-    ofstream outstream(cpt_file.c_str());
+    ofstream outstream(cpt_file.c_str(), ios::binary);
     time_t t = time(NULL);
     if (!outstream.is_open())
         fatal("Unable to open file %s for writing\n", cpt_file.c_str());
-    outstream << "## checkpoint generated: " << ctime(&t);
+    if (text)
+        outstream << "## checkpoint generated: " << ctime(&t);
+    else
+        BinaryCheckpoint::writeHeader(outstream);
 
     globals.serializeSection(outstream, "Globals");
 
@@ -237,7 +239,10 @@ Serializable::ScopedCheckpointSection::nameOut(CheckpointOut &cp)
 {
     DPRINTF(Checkpoint, "ScopedCheckpointSection::nameOut: %s\n",
             Serializable::currentSection());
-    cp << "\n[" << Serializable::currentSection() << "]\n";
+    if (BinaryCheckpoint::enabled(cp))
+        BinaryCheckpoint::writeSection(cp, Serializable::currentSection());
+    else
+        cp << "\n[" << Serializable::currentSection() << "]\n";
 }
 
 const std::string &
@@ -271,9 +276,17 @@ CheckpointIn::dir()
 }
 
 CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
-    : db(new IniFile), objNameResolver(resolver), cptDir(setDir(cpt_dir))
+    : db(nullptr), binary(nullptr), objNameResolver(resolver),
+      cptDir(setDir(cpt_dir))
 {
     string filename = cptDir + "/" + CheckpointIn::baseFilename;
+    if (BinaryCheckpoint::isBinary(filename)) {
+        binary = new BinaryCheckpoint;
+        binary->load(filename);
+        return;
+    }
+
+    db = new IniFile;
     if (!db->load(filename)) {
         fatal("Can't load checkpoint file '%s'\n", filename);
     }
@@ -282,17 +295,33 @@ CheckpointIn::CheckpointIn(const string &cpt_dir, SimObjectResolver &resolver)
 CheckpointIn::~CheckpointIn()
 {
     delete db;
+    delete binary;
+}
+
+const BinaryCheckpoint::Value *
+CheckpointIn::findValue(const string &section, const string &entry) const
+{
+    return binary ? binary->find(section, entry) : nullptr;
 }
 
 bool
 CheckpointIn::entryExists(const string &section, const string &entry)
 {
+    if (binary)
+        return binary->find(section, entry) != nullptr;
     return db->entryExists(section, entry);
 }
 
 bool
 CheckpointIn::find(const string &section, const string &entry, string &value)
 {
+    if (binary) {
+        const BinaryCheckpoint::Value *val = binary->find(section, entry);
+        if (!val)
+            return false;
+        value = val->toString();
+        return true;
+    }
     return db->find(section, entry, value);
 }
 
@@ -302,7 +331,7 @@ CheckpointIn::findObj(const string &section, const string &entry,
 {
     string path;
 
-    if (!db->find(section, entry, path))
+    if (!find(section, entry, path))
         return false;
 
     value = objNameResolver.resolveSimObject(path);
@@ -312,6 +341,8 @@ CheckpointIn::findObj(const string &section, const string &entry,
 bool
 CheckpointIn::sectionExists(const string &section)
 {
+    if (binary)
+        return binary->sectionExists(section);
     return db->sectionExists(section);
 }
 
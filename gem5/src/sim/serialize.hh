@@ -55,13 +55,17 @@
 #include <iostream>
 #include <list>
 #include <map>
+#include <memory>
+#include <sstream>
 #include <stack>
 #include <set>
+#include <type_traits>
 #include <vector>
 
 #include "base/bitunion.hh"
 #include "base/logging.hh"
 #include "base/str.hh"
+#include "sim/serialize_binary.hh"
 
 class IniFile;
 class SimObject;
@@ -75,6 +79,9 @@ class CheckpointIn
 
     IniFile *db;
 
+    /** Contents of a binary checkpoint, db is only used otherwise */
+    BinaryCheckpoint *binary;
+
     SimObjectResolver &objNameResolver;
 
   public:
@@ -90,9 +97,25 @@ class CheckpointIn
                  SimObject *&value);
 
 
+    /**
+     * Find the typed value of an entry of a binary checkpoint.
+     * @return The value, nullptr if the entry doesn't exist or the
+     * checkpoint is a text one.
+     */
+    const BinaryCheckpoint::Value *findValue(const std::string &section,
+                                             const std::string &entry) const;
+
     bool entryExists(const std::string &section, const std::string &entry);
     bool sectionExists(const std::string &section);
 
+    /**
+     * Entries of a text checkpoint, which the checkpoint upgraders
+     * (see m5.cpt_upgrade) update in place before the state is
+     * restored.
+     * @return The entries, nullptr for a binary checkpoint.
+     */
+    IniFile *textEntries() { return db; }
+
     // The following static functions have to do with checkpoint
     // creation rather than restoration.  This class makes a handy
     // namespace for them though.  Currently no Checkpoint object is
@@ -260,11 +283,17 @@ class Serializable
     static int ckptCount;
     static int ckptMaxCount;
     static int ckptPrevCount;
-    static void serializeAll(const std::string &cpt_dir);
+    /**
+     * Write a checkpoint of all the SimObjects, in the binary format
+     * unless text is set, in which case the INI text format is used.
+     */
+    static void serializeAll(const std::string &cpt_dir, bool text = false);
     static void unserializeGlobals(CheckpointIn &cp);
 
   private:
-    static std::stack<std::string> path;
+    /** Active section path, per thread since objects may restore their
+     *  state concurrently (see SimObject::loadStateAll()) */
+    static thread_local std::stack<std::string> path;
 };
 
 //
@@ -369,10 +398,113 @@ parseParam(const std::string &s, std::string &value)
     return true;
 }
 
+//
+// Values of binary checkpoints. Numbers are stored as they are, and
+// anything else as the string showParam() formats it to.
+//
+template <class T>
+typename std::enable_if<std::is_arithmetic<T>::value>::type
+binaryParamOut(CheckpointOut &os, const std::string &name,
+               const T *param, size_t size)
+{
+    BinaryCheckpoint::writeEntry(os, name, BinaryCheckpoint::kindOf<T>(),
+                                 sizeof(T), size, param);
+}
+
+template <class T>
+typename std::enable_if<!std::is_arithmetic<T>::value>::type
+binaryParamOut(CheckpointOut &os, const std::string &name,
+               const T *param, size_t size)
+{
+    std::vector<std::string> strings;
+    strings.reserve(size);
+    for (size_t i = 0; i < size; ++i) {
+        std::ostringstream ss;
+        showParam(ss, param[i]);
+        strings.push_back(ss.str());
+    }
+    BinaryCheckpoint::writeEntry(os, name, strings);
+}
+
+template <class T>
+void
+binaryParamOut(CheckpointOut &os, const std::string &name,
+               const BitUnionType<T> *param, size_t size)
+{
+    std::vector<BitUnionBaseType<T>> storage(param, param + size);
+    binaryParamOut(os, name, storage.data(), size);
+}
+
+template <class T>
+void
+binaryParamOut(CheckpointOut &os, const std::string &name,
+               const std::vector<T> &param)
+{
+    binaryParamOut(os, name, param.data(), param.size());
+}
+
+inline void
+binaryParamOut(CheckpointOut &os, const std::string &name,
+               const std::vector<bool> &param)
+{
+    std::unique_ptr<bool[]> values(new bool[param.size()]);
+    std::copy(param.begin(), param.end(), values.get());
+    binaryParamOut(os, name, values.get(), param.size());
+}
+
+template <class T>
+typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+binaryParamIn(const BinaryCheckpoint::Value &val, size_t i, T &param)
+{
+    if (val.kind == BinaryCheckpoint::String)
+        return parseParam(val.strings[i], param);
+
+    param = val.number<T>(i);
+    return true;
+}
+
+template <class T>
+typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type
+binaryParamIn(const BinaryCheckpoint::Value &val, size_t i, T &param)
+{
+    return parseParam(val.element(i), param);
+}
+
+template <class T>
+bool
+binaryParamIn(const BinaryCheckpoint::Value &val, size_t i,
+              BitUnionType<T> &param)
+{
+    BitUnionBaseType<T> storage = BitUnionBaseType<T>();
+    auto res = binaryParamIn(val, i, storage);
+    param = storage;
+    return res;
+}
+
+/** Find the value of an entry in a checkpoint of either format */
+template <class T>
+bool
+findParam(CheckpointIn &cp, const std::string &section,
+          const std::string &name, T &param)
+{
+    if (const BinaryCheckpoint::Value *val = cp.findValue(section, name)) {
+        return val->count == 1 ? binaryParamIn(*val, 0, param) :
+            parseParam(val->toString(), param);
+    }
+
+    std::string str;
+    return cp.find(section, name, str) && parseParam(str, param);
+}
+
 template <class T>
 void
 paramOut(CheckpointOut &os, const std::string &name, const T &param)
 {
+    if (BinaryCheckpoint::enabled(os)) {
+        binaryParamOut(os, name, &param, 1);
+        return;
+    }
+
     os << name << "=";
     showParam(os, param);
     os << "\n";
@@ -383,8 +515,7 @@ void
 paramIn(CheckpointIn &cp, const std::string &name, T &param)
 {
     const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, name, str) || !parseParam(str, param)) {
+    if (!findParam(cp, section, name, param)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
     }
 }
@@ -395,8 +526,7 @@ optParamIn(CheckpointIn &cp, const std::string &name,
            T &param, bool warn = true)
 {
     const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, name, str) || !parseParam(str, param)) {
+    if (!findParam(cp, section, name, param)) {
         if (warn)
             warn("optional parameter %s:%s not present\n", section, name);
         return false;
@@ -410,6 +540,11 @@ void
 arrayParamOut(CheckpointOut &os, const std::string &name,
               const std::vector<T> &param)
 {
+    if (BinaryCheckpoint::enabled(os)) {
+        binaryParamOut(os, name, param);
+        return;
+    }
+
     typename std::vector<T>::size_type size = param.size();
     os << name << "=";
     if (size > 0)
@@ -426,6 +561,11 @@ void
 arrayParamOut(CheckpointOut &os, const std::string &name,
               const std::list<T> &param)
 {
+    if (BinaryCheckpoint::enabled(os)) {
+        binaryParamOut(os, name, std::vector<T>(param.begin(), param.end()));
+        return;
+    }
+
     typename std::list<T>::const_iterator it = param.begin();
 
     os << name << "=";
@@ -445,6 +585,11 @@ void
 arrayParamOut(CheckpointOut &os, const std::string &name,
               const std::set<T> &param)
 {
+    if (BinaryCheckpoint::enabled(os)) {
+        binaryParamOut(os, name, std::vector<T>(param.begin(), param.end()));
+        return;
+    }
+
     typename std::set<T>::const_iterator it = param.begin();
 
     os << name << "=";
@@ -464,6 +609,11 @@ void
 arrayParamOut(CheckpointOut &os, const std::string &name,
               const T *param, unsigned size)
 {
+    if (BinaryCheckpoint::enabled(os)) {
+        binaryParamOut(os, name, param, size);
+        return;
+    }
+
     os << name << "=";
     if (size > 0)
         showParam(os, param[0]);
@@ -475,20 +625,38 @@ arrayParamOut(CheckpointOut &os, const std::string &name,
 }
 
 /**
- * Extract values stored in the checkpoint, and assign them to the provided
- * array container.
+ * Extract the values of an array stored in the checkpoint. The values
+ * of binary checkpoints are converted, and the ones of text
+ * checkpoints are parsed.
  *
  * @param cp The checkpoint to be parsed.
  * @param name Name of the container.
- * @param param The array container.
- * @param size The expected number of entries to be extracted.
+ * @param values The extracted values.
  */
 template <class T>
 void
-arrayParamIn(CheckpointIn &cp, const std::string &name,
-             T *param, unsigned size)
+arrayValuesIn(CheckpointIn &cp, const std::string &name,
+              std::vector<T> &values)
 {
     const std::string &section(Serializable::currentSection());
+    values.clear();
+
+    if (const BinaryCheckpoint::Value *val = cp.findValue(section, name)) {
+        values.reserve(val->count);
+        for (size_t i = 0; i < val->count; ++i) {
+            // need to parse into local variable to handle vector<bool>,
+            // for which operator[] returns a special reference class
+            // that's not the same as 'bool&', (since it's a packed
+            // vector)
+            T scalar_value;
+            if (!binaryParamIn(*val, i, scalar_value)) {
+                fatal("could not parse \"%s\"", val->toString());
+            }
+            values.push_back(scalar_value);
+        }
+        return;
+    }
+
     std::string str;
     if (!cp.find(section, name, str)) {
         fatal("Can't unserialize '%s:%s'\n", section, name);
@@ -501,18 +669,8 @@ arrayParamIn(CheckpointIn &cp, const std::string &name,
 
     tokenize(tokens, str, ' ');
 
-    // Need this if we were doing a vector
-    // value.resize(tokens.size());
-
-    fatal_if(tokens.size() != size,
-             "Array size mismatch on %s:%s (Got %u, expected %u)'\n",
-             section, name, tokens.size(), size);
-
+    values.reserve(tokens.size());
     for (std::vector<std::string>::size_type i = 0; i < tokens.size(); i++) {
-        // need to parse into local variable to handle vector<bool>,
-        // for which operator[] returns a special reference class
-        // that's not the same as 'bool&', (since it's a packed
-        // vector)
         T scalar_value;
         if (!parseParam(tokens[i], scalar_value)) {
             std::string err("could not parse \"");
@@ -523,111 +681,65 @@ arrayParamIn(CheckpointIn &cp, const std::string &name,
             fatal(err);
         }
 
-        // assign parsed value to vector
-        param[i] = scalar_value;
+        values.push_back(scalar_value);
     }
 }
 
+/**
+ * Extract values stored in the checkpoint, and assign them to the provided
+ * array container.
+ *
+ * @param cp The checkpoint to be parsed.
+ * @param name Name of the container.
+ * @param param The array container.
+ * @param size The expected number of entries to be extracted.
+ */
 template <class T>
 void
-arrayParamIn(CheckpointIn &cp, const std::string &name, std::vector<T> &param)
+arrayParamIn(CheckpointIn &cp, const std::string &name,
+             T *param, unsigned size)
 {
     const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, name, str)) {
-        fatal("Can't unserialize '%s:%s'\n", section, name);
-    }
 
-    // code below stolen from VectorParam<T>::parse().
-    // it would be nice to unify these somehow...
+    // Arrays of binary checkpoints are usually copied as they are
+    const BinaryCheckpoint::Value *val = cp.findValue(section, name);
+    if (val && val->count == size && val->copyTo(param))
+        return;
 
-    std::vector<std::string> tokens;
-
-    tokenize(tokens, str, ' ');
+    std::vector<T> values;
+    arrayValuesIn(cp, name, values);
 
-    // Need this if we were doing a vector
-    // value.resize(tokens.size());
-
-    param.resize(tokens.size());
-
-    for (std::vector<std::string>::size_type i = 0; i < tokens.size(); i++) {
-        // need to parse into local variable to handle vector<bool>,
-        // for which operator[] returns a special reference class
-        // that's not the same as 'bool&', (since it's a packed
-        // vector)
-        T scalar_value;
-        if (!parseParam(tokens[i], scalar_value)) {
-            std::string err("could not parse \"");
-
-            err += str;
-            err += "\"";
+    fatal_if(values.size() != size,
+             "Array size mismatch on %s:%s (Got %u, expected %u)'\n",
+             section, name, values.size(), size);
 
-            fatal(err);
-        }
+    std::copy(values.begin(), values.end(), param);
+}
 
-        // assign parsed value to vector
-        param[i] = scalar_value;
-    }
+template <class T>
+void
+arrayParamIn(CheckpointIn &cp, const std::string &name, std::vector<T> &param)
+{
+    arrayValuesIn(cp, name, param);
 }
 
 template <class T>
 void
 arrayParamIn(CheckpointIn &cp, const std::string &name, std::list<T> &param)
 {
-    const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, name, str)) {
-        fatal("Can't unserialize '%s:%s'\n", section, name);
-    }
-    param.clear();
-
-    std::vector<std::string> tokens;
-    tokenize(tokens, str, ' ');
-
-    for (std::vector<std::string>::size_type i = 0; i < tokens.size(); i++) {
-        T scalar_value;
-        if (!parseParam(tokens[i], scalar_value)) {
-            std::string err("could not parse \"");
-
-            err += str;
-            err += "\"";
-
-            fatal(err);
-        }
-
-        // assign parsed value to vector
-        param.push_back(scalar_value);
-    }
+    std::vector<T> values;
+    arrayValuesIn(cp, name, values);
+    param.assign(values.begin(), values.end());
 }
 
 template <class T>
 void
 arrayParamIn(CheckpointIn &cp, const std::string &name, std::set<T> &param)
 {
-    const std::string &section(Serializable::currentSection());
-    std::string str;
-    if (!cp.find(section, name, str)) {
-        fatal("Can't unserialize '%s:%s'\n", section, name);
-    }
+    std::vector<T> values;
+    arrayValuesIn(cp, name, values);
     param.clear();
-
-    std::vector<std::string> tokens;
-    tokenize(tokens, str, ' ');
-
-    for (std::vector<std::string>::size_type i = 0; i < tokens.size(); i++) {
-        T scalar_value;
-        if (!parseParam(tokens[i], scalar_value)) {
-            std::string err("could not parse \"");
-
-            err += str;
-            err += "\"";
-
-            fatal(err);
-        }
-
-        // assign parsed value to vector
-        param.insert(scalar_value);
-    }
+    param.insert(values.begin(), values.end());
 }
 
 void
@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include "sim/serialize_binary.hh"
+
+#include <fstream>
+#include <ios>
+#include <limits>
+#include <sstream>
+
+#include "base/logging.hh"
+
+namespace {
+
+const char cptMagic[] = "GCPT";
+const uint32_t cptVersion = 1;
+
+/** Index of the stream word marking binary checkpoints */
+int
+binaryIndex()
+{
+    static const int index = std::ios_base::xalloc();
+    return index;
+}
+
+void
+putU32(std::ostream &os, uint32_t val)
+{
+    os.write(reinterpret_cast<const char *>(&val), sizeof(val));
+}
+
+void
+putString(std::ostream &os, const std::string &str)
+{
+    putU32(os, str.size());
+    os.write(str.data(), str.size());
+}
+
+/** Reader of the records of a loaded checkpoint */
+class Reader
+{
+  public:
+    Reader(const char *begin, const char *end, const std::string &filename)
+        : pos(begin), end(end), filename(filename)
+    {}
+
+    bool done() const { return pos == end; }
+
+    const char *
+    take(size_t size)
+    {
+        fatal_if(size > size_t(end - pos),
+                 "Checkpoint file '%s' is truncated.", filename);
+        const char *p = pos;
+        pos += size;
+        return p;
+    }
+
+    template <class T>
+    T
+    get()
+    {
+        T val;
+        std::memcpy(&val, take(sizeof(val)), sizeof(val));
+        return val;
+    }
+
+    std::string
+    getString()
+    {
+        const uint32_t size = get<uint32_t>();
+        return std::string(take(size), size);
+    }
+
+  private:
+    const char *pos;
+    const char *end;
+    const std::string &filename;
+};
+
+} // anonymous namespace
+
+std::string
+BinaryCheckpoint::Value::element(size_t i) const
+{
+    switch (kind) {
+      case String:
+        return strings[i];
+      case Bool:
+        return number<bool>(i) ? "true" : "false";
+      case Signed:
+        return std::to_string(number<int64_t>(i));
+      case Unsigned:
+        return std::to_string(number<uint64_t>(i));
+      default: {
+          // Enough digits to read the same value back
+          std::ostringstream ss;
+          if (size == sizeof(float)) {
+              ss.precision(std::numeric_limits<float>::max_digits10);
+              ss << number<float>(i);
+          } else if (size == sizeof(double)) {
+              ss.precision(std::numeric_limits<double>::max_digits10);
+              ss << number<double>(i);
+          } else {
+              ss.precision(std::numeric_limits<long double>::max_digits10);
+              ss << number<long double>(i);
+          }
+          return ss.str();
+      }
+    }
+}
+
+std::string
+BinaryCheckpoint::Value::toString() const
+{
+    std::string str;
+    for (size_t i = 0; i < count; ++i) {
+        if (i != 0)
+            str += " ";
+        str += element(i);
+    }
+    return str;
+}
+
+bool
+BinaryCheckpoint::isBinary(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(cptMagic) - 1];
+    return file.read(magic, sizeof(magic)) &&
+        std::memcmp(magic, cptMagic, sizeof(magic)) == 0;
+}
+
+void
+BinaryCheckpoint::load(const std::string &filename)
+{
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    fatal_if(!file, "Can't load checkpoint file '%s'\n", filename);
+
+    contents.resize(file.tellg());
+    file.seekg(0);
+    fatal_if(!file.read(contents.data(), contents.size()),
+             "Can't load checkpoint file '%s'\n", filename);
+
+    Reader reader(contents.data(), contents.data() + contents.size(),
+                  filename);
+    fatal_if(std::memcmp(reader.take(4), cptMagic, 4) != 0,
+             "'%s' isn't a binary checkpoint.", filename);
+    const uint32_t version = reader.get<uint32_t>();
+    fatal_if(version != cptVersion,
+             "Unsupported binary checkpoint version %d in '%s'.",
+             version, filename);
+
+    Section *section = nullptr;
+    while (!reader.done()) {
+        const char tag = reader.get<char>();
+        if (tag == 'S') {
+            section = &sections[reader.getString()];
+            continue;
+        }
+
+        fatal_if(tag != 'E' || !section,
+                 "Checkpoint file '%s' is corrupted.", filename);
+
+        const std::string name = reader.getString();
+        Value &val = (*section)[name];
+        val.kind = static_cast<Kind>(reader.get<uint8_t>());
+        val.size = reader.get<uint8_t>();
+        val.count = reader.get<uint32_t>();
+        const uint64_t bytes = reader.get<uint64_t>();
+        val.data = reader.take(bytes);
+
+        if (val.kind == String) {
+            Reader strings(val.data, val.data + bytes, filename);
+            val.strings.reserve(val.count);
+            for (uint32_t i = 0; i < val.count; ++i)
+                val.strings.push_back(strings.getString());
+        } else {
+            fatal_if(val.kind > Bool || uint64_t(val.count) * val.size != bytes,
+                     "Entry %s of checkpoint file '%s' is corrupted.",
+                     name, filename);
+        }
+    }
+}
+
+const BinaryCheckpoint::Value *
+BinaryCheckpoint::find(const std::string &section,
+                       const std::string &entry) const
+{
+    auto s = sections.find(section);
+    if (s == sections.end())
+        return nullptr;
+
+    auto e = s->second.find(entry);
+    return e == s->second.end() ? nullptr : &e->second;
+}
+
+bool
+BinaryCheckpoint::sectionExists(const std::string &section) const
+{
+    return sections.find(section) != sections.end();
+}
+
+void
+BinaryCheckpoint::writeHeader(std::ostream &os)
+{
+    os.iword(binaryIndex()) = 1;
+    os.write(cptMagic, 4);
+    putU32(os, cptVersion);
+}
+
+bool
+BinaryCheckpoint::enabled(std::ostream &os)
+{
+    return os.iword(binaryIndex()) != 0;
+}
+
+void
+BinaryCheckpoint::writeSection(std::ostream &os, const std::string &name)
+{
+    os.put('S');
+    putString(os, name);
+}
+
+void
+BinaryCheckpoint::writeEntry(std::ostream &os, const std::string &name,
+                             Kind kind, size_t size, size_t count,
+                             const void *data)
+{
+    const uint64_t bytes = size * count;
+    os.put('E');
+    putString(os, name);
+    os.put(kind);
+    os.put(size);
+    putU32(os, count);
+    os.write(reinterpret_cast<const char *>(&bytes), sizeof(bytes));
+    os.write(static_cast<const char *>(data), bytes);
+}
+
+void
+BinaryCheckpoint::writeEntry(std::ostream &os, const std::string &name,
+                             const std::vector<std::string> &strings)
+{
+    uint64_t bytes = 0;
+    for (const auto &str : strings)
+        bytes += sizeof(uint32_t) + str.size();
+
+    os.put('E');
+    putString(os, name);
+    os.put(String);
+    os.put(0);
+    putU32(os, strings.size());
+    os.write(reinterpret_cast<const char *>(&bytes), sizeof(bytes));
+    for (const auto &str : strings)
+        putString(os, str);
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/* @file
+ * Binary checkpoint format
+ */
+
+#ifndef __SIM_SERIALIZE_BINARY_HH__
+#define __SIM_SERIALIZE_BINARY_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Binary checkpoints hold the same sections and entries as the text
+ * checkpoints, but the values are stored with their type instead of
+ * being formatted, and arrays of numbers are stored as a single raw
+ * block. Restoring them doesn't parse anything, and arrays of the
+ * type they were written with are copied in one go.
+ *
+ * The file starts with the magic "GCPT" and a 32-bit version,
+ * followed by records starting with a tag:
+ * <ul>
+ *   <li>'S': the start of a section, with its name.
+ *   <li>'E': an entry of the current section, with its name, the kind
+ *     and size of its elements, the number of elements and the size
+ *     of the data in bytes, followed by the data. Strings are stored
+ *     as a 32-bit length and the characters.
+ * </ul>
+ * Names are stored like strings. Numbers are stored in the byte
+ * order of the host, which is little endian on the supported hosts.
+ *
+ * A checkpoint is written in this format when the stream it is
+ * written to has been started by writeHeader().
+ */
+class BinaryCheckpoint
+{
+  public:
+    /** Kind of the elements of an entry */
+    enum Kind : uint8_t
+    {
+        String = 0,
+        Signed,
+        Unsigned,
+        Float,
+        Bool,
+    };
+
+    template <class T>
+    static constexpr Kind
+    kindOf()
+    {
+        return std::is_same<T, bool>::value ? Bool :
+            std::is_floating_point<T>::value ? Float :
+            std::is_signed<T>::value ? Signed : Unsigned;
+    }
+
+    /** The value of an entry, pointing in the loaded checkpoint */
+    struct Value
+    {
+        Kind kind;
+        /** Size of an element, in bytes */
+        uint8_t size;
+        uint32_t count;
+        const char *data;
+        /** Elements of a string entry */
+        std::vector<std::string> strings;
+
+        /** Element i of a number entry converted to T */
+        template <class T>
+        T
+        number(size_t i) const
+        {
+            const char *p = data + i * size;
+            switch (kind) {
+              case Bool:
+                return static_cast<T>(load<uint8_t>(p) != 0);
+              case Float:
+                if (size == sizeof(float))
+                    return static_cast<T>(load<float>(p));
+                else if (size == sizeof(double))
+                    return static_cast<T>(load<double>(p));
+                else
+                    return static_cast<T>(load<long double>(p));
+              case Signed:
+                switch (size) {
+                  case 1: return static_cast<T>(load<int8_t>(p));
+                  case 2: return static_cast<T>(load<int16_t>(p));
+                  case 4: return static_cast<T>(load<int32_t>(p));
+                  default: return static_cast<T>(load<int64_t>(p));
+                }
+              default:
+                switch (size) {
+                  case 1: return static_cast<T>(load<uint8_t>(p));
+                  case 2: return static_cast<T>(load<uint16_t>(p));
+                  case 4: return static_cast<T>(load<uint32_t>(p));
+                  default: return static_cast<T>(load<uint64_t>(p));
+                }
+            }
+        }
+
+        /**
+         * Copy the elements to an array of the type they were written
+         * with.
+         * @return False if the types differ.
+         */
+        template <class T>
+        typename std::enable_if<std::is_arithmetic<T>::value, bool>::type
+        copyTo(T *dest) const
+        {
+            if (kind != kindOf<T>() || size != sizeof(T))
+                return false;
+            std::memcpy(dest, data, count * sizeof(T));
+            return true;
+        }
+
+        template <class T>
+        typename std::enable_if<!std::is_arithmetic<T>::value, bool>::type
+        copyTo(T *dest) const
+        {
+            return false;
+        }
+
+        /** Element i formatted as in a text checkpoint */
+        std::string element(size_t i) const;
+
+        /** The elements separated by spaces, as in a text checkpoint */
+        std::string toString() const;
+
+      private:
+        template <class T>
+        static T
+        load(const char *p)
+        {
+            T val;
+            std::memcpy(&val, p, sizeof(val));
+            return val;
+        }
+    };
+
+    /** Check if a checkpoint file is in the binary format */
+    static bool isBinary(const std::string &filename);
+
+    /** Load a binary checkpoint, fatal if it can't be read */
+    void load(const std::string &filename);
+
+    /** Find an entry, nullptr if it doesn't exist */
+    const Value *find(const std::string &section,
+                      const std::string &entry) const;
+
+    bool sectionExists(const std::string &section) const;
+
+    /** Start a binary checkpoint in a stream */
+    static void writeHeader(std::ostream &os);
+
+    /** Check if a stream holds a binary checkpoint */
+    static bool enabled(std::ostream &os);
+
+    static void writeSection(std::ostream &os, const std::string &name);
+
+    /** Write an entry of count elements of the given kind and size */
+    static void writeEntry(std::ostream &os, const std::string &name,
+                           Kind kind, size_t size, size_t count,
+                           const void *data);
+
+    /** Write an entry of strings */
+    static void writeEntry(std::ostream &os, const std::string &name,
+                           const std::vector<std::string> &strings);
+
+  private:
+    typedef std::unordered_map<std::string, Value> Section;
+
+    /** The contents of the file, which the values point in */
+    std::vector<char> contents;
+
+    std::unordered_map<std::string, Section> sections;
+};
+
+#endif // __SIM_SERIALIZE_BINARY_HH__
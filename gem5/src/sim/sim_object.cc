@@ -32,6 +32,10 @@
 
 #include "sim/sim_object.hh"
 
+#include <atomic>
+#include <functional>
+#include <thread>
+
 #include "base/logging.hh"
 #include "base/match.hh"
 #include "base/trace.hh"
@@ -145,6 +149,60 @@ SimObject::serializeAll(CheckpointOut &cp)
    }
 }
 
+/**
+ * Call func on objects in order. Runs of consecutive objects for which
+ * thread_safe is true are handed out to a pool of num_threads threads,
+ * including the calling one, and the run completes before the next
+ * object.
+ */
+static void
+runPhase(const vector<SimObject *> &objs, unsigned num_threads,
+         bool (SimObject::*thread_safe)() const,
+         const function<void(SimObject *)> &func)
+{
+    auto first = objs.begin();
+    while (first != objs.end()) {
+        if (num_threads <= 1 || !((*first)->*thread_safe)()) {
+            func(*first++);
+            continue;
+        }
+
+        auto last = first;
+        while (last != objs.end() && ((*last)->*thread_safe)())
+            ++last;
+
+        const size_t count = last - first;
+        atomic<size_t> next(0);
+        auto worker = [&]() {
+            for (size_t i = next++; i < count; i = next++)
+                func(first[i]);
+        };
+
+        vector<thread> threads;
+        for (size_t t = 1; t < min<size_t>(num_threads, count); ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (auto &t : threads)
+            t.join();
+
+        first = last;
+    }
+}
+
+void
+SimObject::initAll(const vector<SimObject *> &objs, unsigned num_threads)
+{
+    runPhase(objs, num_threads, &SimObject::threadSafeInit,
+             [](SimObject *obj) { obj->init(); });
+}
+
+void
+SimObject::loadStateAll(const vector<SimObject *> &objs, CheckpointIn &cp,
+                        unsigned num_threads)
+{
+    runPhase(objs, num_threads, &SimObject::threadSafeLoadState,
+             [&cp](SimObject *obj) { obj->loadState(cp); });
+}
 
 #ifdef DEBUG
 //
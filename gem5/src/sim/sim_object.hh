@@ -147,6 +147,22 @@ class SimObject : public EventManager, public Serializable, public Drainable,
      */
     virtual void initState();
 
+    /**
+     * Whether init() only uses the state of this object, in which case
+     * it may run concurrently with the init() of other objects (see
+     * initAll()). A thread-safe init() must not schedule events or use
+     * other objects.
+     */
+    virtual bool threadSafeInit() const { return false; }
+
+    /**
+     * Whether loadState() may run concurrently with the loadState() of
+     * other objects (see loadStateAll()), with the same restrictions as
+     * threadSafeInit(). The checkpoint itself is safe to read from
+     * several threads.
+     */
+    virtual bool threadSafeLoadState() const { return false; }
+
     /**
      * Register probe points for this object.
      */
@@ -219,6 +235,21 @@ class SimObject : public EventManager, public Serializable, public Drainable,
      */
     static void serializeAll(CheckpointOut &cp);
 
+    /**
+     * Call init() on objects in order, except that the init() of runs
+     * of consecutive objects with a thread-safe init() are spread over
+     * num_threads threads.
+     */
+    static void initAll(const std::vector<SimObject *> &objs,
+                        unsigned num_threads);
+
+    /**
+     * Call loadState() on objects in order, spreading runs of objects
+     * with a thread-safe loadState() over num_threads threads.
+     */
+    static void loadStateAll(const std::vector<SimObject *> &objs,
+                             CheckpointIn &cp, unsigned num_threads);
+
 #ifdef DEBUG
   public:
     bool doDebugBreak;
@@ -38,9 +38,11 @@
 
 #include "base/logging.hh"
 #include "base/pollevent.hh"
+#include "base/statistics.hh"
 #include "base/types.hh"
 #include "sim/async.hh"
 #include "sim/eventq_impl.hh"
+#include "sim/lookahead.hh"
 #include "sim/sim_events.hh"
 #include "sim/sim_exit.hh"
 #include "sim/stat_control.hh"
@@ -64,8 +66,11 @@ Event *doSimLoop(EventQueue *);
  * repeated until the simulation terminates.
  */
 static void
-thread_loop(EventQueue *queue)
+thread_loop(EventQueue *queue, uint32_t index)
 {
+    Stats::threadShard = index;
+    Stats::startHostCounters(index);
+
     while (true) {
         threadBarrier->wait();
         doSimLoop(queue);
@@ -74,6 +79,10 @@ thread_loop(EventQueue *queue)
 
 GlobalSimLoopExitEvent *simulate_limit_event = nullptr;
 
+//! Event synchronizing the queues every quantum, reused across calls
+//! to simulate() since it allocates an event per queue.
+static GlobalSyncEvent *quantum_event = nullptr;
+
 /** Simulate for num_cycles additional cycles.  If num_cycles is -1
  * (the default), do not limit simulation; some other event must
  * terminate the loop.  Exported to Python.
@@ -95,9 +104,12 @@ simulate(Tick num_cycles)
         // handles queue 0, so we only need to allocate new threads
         // for queues 1..N-1.  We'll call these the "subordinate" threads.
         for (uint32_t i = 1; i < numMainEventQueues; i++) {
-            threads.push_back(new std::thread(thread_loop, mainEventQueue[i]));
+            threads.push_back(
+                new std::thread(thread_loop, mainEventQueue[i], i));
         }
 
+        Stats::startHostCounters(0);
+
         threads_initialized = true;
         simulate_limit_event =
             new GlobalSimLoopExitEvent(mainEventQueue[0]->getCurTick(),
@@ -113,14 +125,27 @@ simulate(Tick num_cycles)
 
     simulate_limit_event->reschedule(num_cycles);
 
-    GlobalSyncEvent *quantum_event = NULL;
     if (numMainEventQueues > 1) {
         if (simQuantum == 0) {
             fatal("Quantum for multi-eventq simulation not specified");
         }
 
-        quantum_event = new GlobalSyncEvent(curTick() + simQuantum, simQuantum,
-                            EventBase::Progress_Event_Pri, 0);
+        // Start from the smallest quantum, the adapted one may not suit
+        // this part of the simulation.
+        if (simQuantumMax > simQuantumMin)
+            simQuantum = simQuantumMin;
+
+        if (!quantum_event) {
+            quantum_event = new GlobalSyncEvent(
+                EventBase::Progress_Event_Pri, 0);
+        }
+        quantum_event->repeat = simQuantum;
+        quantum_event->schedule(curTick() + simQuantum);
+        if (simQuantumMax > simQuantumMin)
+            quantum_event->adaptRepeat(simQuantumMin, simQuantumMax);
+
+        if (lookaheadSync)
+            resetLookaheadClocks(curTick());
 
         inParallelMode = true;
     }
@@ -142,11 +167,8 @@ simulate(Tick num_cycles)
         dynamic_cast<GlobalSimLoopExitEvent *>(global_event);
     assert(global_exit_event != NULL);
 
-    //! Delete the simulation quantum event.
-    if (quantum_event != NULL) {
+    if (quantum_event)
         quantum_event->deschedule();
-        delete quantum_event;
-    }
 
     return global_exit_event;
 }
@@ -216,6 +238,11 @@ doSimLoop(EventQueue *eventq)
             }
         }
 
+        // In lookahead mode, wait until no upstream queue can send us
+        // an event that precedes the head of our queue.
+        if (lookaheadSync && inParallelMode)
+            waitForLookahead(eventq);
+
         Event *exit_event = eventq->serviceOne();
         if (exit_event != NULL) {
             return exit_event;
@@ -48,17 +48,26 @@
 
 #include "sim/stat_control.hh"
 
+#include <cerrno>
 #include <fstream>
 #include <iostream>
 #include <list>
+#include <memory>
+#include <mutex>
 
 #include "base/callback.hh"
 #include "base/hostinfo.hh"
+#include "base/logging.hh"
 #include "base/statistics.hh"
 #include "base/time.hh"
+#include "config/have_perf_event.hh"
 #include "cpu/base.hh"
 #include "sim/global_event.hh"
 
+#if HAVE_PERF_EVENT
+#include "cpu/kvm/perfevent.hh"
+#endif
+
 using namespace std;
 
 Stats::Formula simSeconds;
@@ -104,6 +113,30 @@ statFinalTick()
     return curTick();
 }
 
+Tick
+statSimQuantum()
+{
+    return simQuantum;
+}
+
+Counter
+statLateAsyncInsertions()
+{
+    Counter late = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        late += mainEventQueue[i]->getLateAsyncInsertions();
+    return late;
+}
+
+Counter
+statProcessedEvents()
+{
+    Counter events = 0;
+    for (uint32_t i = 0; i < numMainEventQueues; ++i)
+        events += mainEventQueue[i]->getProcessedEvents();
+    return events;
+}
+
 SimTicksReset simTicksReset;
 
 struct Global
@@ -111,11 +144,16 @@ struct Global
     Stats::Formula hostInstRate;
     Stats::Formula hostOpRate;
     Stats::Formula hostTickRate;
+    Stats::Formula hostEventRate;
     Stats::Value hostMemory;
     Stats::Value hostSeconds;
 
     Stats::Value simInsts;
     Stats::Value simOps;
+    Stats::Value simEvents;
+
+    Stats::Value simQuantum;
+    Stats::Value simQuantumLate;
 
     Global();
 };
@@ -138,6 +176,13 @@ Global::Global()
         .prereq(simOps)
         ;
 
+    simEvents
+        .functor(statProcessedEvents)
+        .name("sim_events")
+        .desc("Number of events processed")
+        .precision(0)
+        ;
+
     simSeconds
         .name("sim_seconds")
         .desc("Number of seconds simulated")
@@ -162,6 +207,21 @@ Global::Global()
               "(restored from checkpoints and never reset)")
         ;
 
+    simQuantum
+        .functor(statSimQuantum)
+        .name("sim_quantum")
+        .desc("Current quantum of multi-queue simulation (ticks)")
+        .prereq(simQuantum)
+        ;
+
+    simQuantumLate
+        .functor(statLateAsyncInsertions)
+        .name("sim_quantum_late_events")
+        .desc("Cross-queue events moved forward because they arrived "
+              "after their scheduled tick")
+        .prereq(simQuantumLate)
+        ;
+
     hostInstRate
         .name("host_inst_rate")
         .desc("Simulator instruction rate (inst/s)")
@@ -196,10 +256,17 @@ Global::Global()
         .precision(0)
         ;
 
+    hostEventRate
+        .name("host_event_rate")
+        .desc("Simulator event rate (events/s)")
+        .precision(0)
+        ;
+
     simSeconds = simTicks / simFreq;
     hostInstRate = simInsts / hostSeconds;
     hostOpRate = simOps / hostSeconds;
     hostTickRate = simTicks / hostSeconds;
+    hostEventRate = simEvents / hostSeconds;
 
     registerResetCallback(&simTicksReset);
 }
@@ -210,6 +277,175 @@ initSimStats()
     static Global global;
 }
 
+#if HAVE_PERF_EVENT
+
+/**
+ * Host events counted for every simulation thread. The counters of a
+ * thread are opened by the thread itself, but they're read by the
+ * thread dumping the stats.
+ */
+struct HostCounters
+{
+    struct EventType
+    {
+        const char *name;
+        const char *desc;
+        uint32_t type;
+        uint64_t config;
+    };
+
+    static const int NumEvents = 5;
+    static const EventType eventTypes[NumEvents];
+
+    static const uint32_t MaxThreads = ShardedStor::MaxShards;
+
+    std::mutex lock;
+    std::unique_ptr<PerfKvmCounter> counters[MaxThreads][NumEvents];
+    /** Values of the counters at the last reset */
+    uint64_t base[MaxThreads][NumEvents];
+
+    Stats::Vector events[NumEvents];
+    Stats::Formula hostIPC;
+
+    HostCounters();
+
+    void start(uint32_t thread);
+
+    uint64_t read(uint32_t thread, int event);
+
+    /** Copy the counters to the stats before a dump */
+    void update();
+
+    /** Start a new stats interval */
+    void reset();
+};
+
+const HostCounters::EventType HostCounters::eventTypes[] = {
+    { "host_cycles", "Host cycles spent simulating",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { "host_insts", "Host instructions executed simulating",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { "host_llc_misses", "Host last level cache misses",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { "host_branch_misses", "Host mispredicted branches",
+      PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { "host_page_faults", "Host page faults",
+      PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+};
+
+HostCounters::HostCounters()
+{
+    for (int e = 0; e < NumEvents; ++e) {
+        events[e]
+            .init(MaxThreads)
+            .name(eventTypes[e].name)
+            .desc(csprintf("%s, per simulation thread", eventTypes[e].desc))
+            .flags(total | nozero)
+            ;
+    }
+
+    hostIPC
+        .name("host_ipc")
+        .desc("Host instructions per cycle")
+        .precision(2)
+        ;
+
+    hostIPC = events[1] / events[0];
+
+    for (auto &thread_base : base) {
+        for (auto &b : thread_base)
+            b = 0;
+    }
+
+    registerDumpCallback(
+        new MakeCallback<HostCounters, &HostCounters::update>(this, true));
+    registerResetCallback(
+        new MakeCallback<HostCounters, &HostCounters::reset>(this, true));
+}
+
+void
+HostCounters::start(uint32_t thread)
+{
+    fatal_if(thread >= MaxThreads, "Host counters support at most %d "
+             "simulation threads.", MaxThreads);
+
+    std::lock_guard<std::mutex> guard(lock);
+    for (int e = 0; e < NumEvents; ++e) {
+        if (counters[thread][e])
+            continue;
+
+        PerfKvmCounterConfig config(eventTypes[e].type,
+                                    eventTypes[e].config);
+        std::unique_ptr<PerfKvmCounter> counter(new PerfKvmCounter());
+        if (counter->tryAttach(config, 0)) {
+            counters[thread][e] = std::move(counter);
+        } else {
+            warn("Failed to count %s on simulation thread %d (%i), "
+                 "check /proc/sys/kernel/perf_event_paranoid.\n",
+                 eventTypes[e].name, thread, errno);
+        }
+    }
+}
+
+uint64_t
+HostCounters::read(uint32_t thread, int event)
+{
+    return counters[thread][event] ? counters[thread][event]->read() : 0;
+}
+
+void
+HostCounters::update()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (uint32_t t = 0; t < MaxThreads; ++t) {
+        for (int e = 0; e < NumEvents; ++e) {
+            if (counters[t][e])
+                events[e][t] = read(t, e) - base[t][e];
+        }
+    }
+}
+
+void
+HostCounters::reset()
+{
+    std::lock_guard<std::mutex> guard(lock);
+    for (uint32_t t = 0; t < MaxThreads; ++t) {
+        for (int e = 0; e < NumEvents; ++e)
+            base[t][e] = read(t, e);
+    }
+}
+
+HostCounters *hostCounters = nullptr;
+
+void
+enableHostCounters()
+{
+    if (!hostCounters)
+        hostCounters = new HostCounters();
+}
+
+void
+startHostCounters(uint32_t thread)
+{
+    if (hostCounters)
+        hostCounters->start(thread);
+}
+
+#else
+
+void
+enableHostCounters()
+{
+    warn("Host counters need perf_event support, ignoring.\n");
+}
+
+void
+startHostCounters(uint32_t thread)
+{
+}
+
+#endif
+
 /**
  * Event to dump and/or reset the statistics.
  */
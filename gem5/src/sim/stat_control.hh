@@ -84,6 +84,20 @@ void schedStatEvent(bool dump, bool reset, Tick when = curTick(),
  * @param period The period at which the dumping should occur.
  */
 void periodicStatDump(Tick period = 0);
+
+/**
+ * Count host events (cycles, instructions, LLC misses, branch misses
+ * and page faults) with perf_event for every simulation thread, and
+ * report them as the host_* stats. This needs to be called before the
+ * stats are enabled.
+ */
+void enableHostCounters();
+
+/**
+ * Start the host counters of the calling thread, which simulates the
+ * event queues of the given index, if they are enabled.
+ */
+void startHostCounters(uint32_t thread);
 } // namespace Stats
 
 #endif // __SIM_STAT_CONTROL_HH__
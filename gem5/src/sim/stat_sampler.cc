@@ -0,0 +1,206 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "sim/stat_sampler.hh"
+
+#include <cmath>
+
+#include "base/callback.hh"
+#include "base/logging.hh"
+#include "base/output.hh"
+#include "base/stats/index.hh"
+#include "base/stats/info.hh"
+#include "base/trace.hh"
+#include "debug/StatSampler.hh"
+#include "params/StatSampler.hh"
+#include "sim/core.hh"
+
+namespace {
+
+/** Name of a value of a stat, its index if it has no subname */
+std::string
+subname(const std::vector<std::string> &subnames, size_t i)
+{
+    if (i < subnames.size() && !subnames[i].empty())
+        return subnames[i];
+    else
+        return std::to_string(i);
+}
+
+} // anonymous namespace
+
+StatSampler::StatSampler(const StatSamplerParams *p)
+    : ClockedObject(p), patterns(p->stats), period(p->period),
+      bufferSize(p->buffer_size), file(simout.create(p->file, true)),
+      writer(file->stream()),
+      sampleEvent([this]{ sample(); }, name() + ".sample", false,
+                  Event::Stat_Event_Pri)
+{
+    fatal_if(period == 0, "%s: The sampling period can't be 0.", name());
+    fatal_if(bufferSize == 0, "%s: The buffer size can't be 0.", name());
+
+    writer.putHeader();
+
+    registerExitCallback(
+        new MakeCallback<StatSampler, &StatSampler::flush>(this, true));
+}
+
+StatSampler::~StatSampler()
+{
+    simout.close(file);
+}
+
+void
+StatSampler::startup()
+{
+    ClockedObject::startup();
+
+    // The stats are indexed once they're enabled, before startup
+    size_t num_columns = 0;
+    for (const auto &pattern : patterns) {
+        const std::vector<std::string> names =
+            Stats::statsIndex().matchNames(pattern);
+        if (names.empty())
+            warn("%s: No stats match '%s'.\n", name(), pattern);
+
+        for (const auto &stat_name : names) {
+            const Stats::Info *info = Stats::statsIndex().find(stat_name);
+            size_t num_values;
+            if (dynamic_cast<const Stats::ScalarInfo *>(info)) {
+                num_values = 1;
+            } else if (auto vector =
+                       dynamic_cast<const Stats::VectorInfo *>(info)) {
+                num_values = vector->result().size();
+            } else {
+                warn("%s: Only scalars, vectors and formulas can be "
+                     "sampled, ignoring %s.\n", name(), stat_name);
+                continue;
+            }
+
+            sampled.push_back(
+                Sampled{ stat_name, info, num_values, num_columns });
+            num_columns += num_values;
+        }
+    }
+
+    DPRINTF(StatSampler, "Sampling %d stats, %d values\n", sampled.size(),
+            num_columns);
+
+    columns.resize(num_columns);
+    for (auto &column : columns)
+        column.reserve(bufferSize);
+    ticks.reserve(bufferSize);
+
+    writeSchema();
+
+    schedule(sampleEvent, clockEdge(period));
+}
+
+void
+StatSampler::writeSchema()
+{
+    writer.putU8('S');
+    writer.putU32(sampled.size() + 1);
+
+    writer.putString("sample_tick");
+    writer.putString("");
+    writer.putU8(Stats::Binary::ScalarKind);
+    writer.putU32(1);
+    writer.putU32(0);
+
+    for (const auto &s : sampled) {
+        writer.putString(s.name);
+        writer.putString("");
+        if (auto vector = dynamic_cast<const Stats::VectorInfo *>(s.info)) {
+            writer.putU8(dynamic_cast<const Stats::FormulaInfo *>(s.info) ?
+                         Stats::Binary::FormulaKind :
+                         Stats::Binary::VectorKind);
+            writer.putU32(s.numValues);
+            writer.putU32(s.numValues);
+            for (size_t i = 0; i < s.numValues; ++i)
+                writer.putString(subname(vector->subnames, i));
+        } else {
+            writer.putU8(Stats::Binary::ScalarKind);
+            writer.putU32(1);
+            writer.putU32(0);
+        }
+    }
+}
+
+void
+StatSampler::sample()
+{
+    ticks.push_back(curTick());
+
+    for (const auto &s : sampled) {
+        if (auto scalar = dynamic_cast<const Stats::ScalarInfo *>(s.info)) {
+            columns[s.column].push_back(scalar->result());
+            continue;
+        }
+
+        // The number of values is fixed by the schema
+        const Stats::VResult &result =
+            static_cast<const Stats::VectorInfo *>(s.info)->result();
+        for (size_t i = 0; i < s.numValues; ++i) {
+            columns[s.column + i].push_back(
+                i < result.size() ? result[i] : NAN);
+        }
+    }
+
+    if (ticks.size() >= bufferSize)
+        flush();
+
+    schedule(sampleEvent, clockEdge(period));
+}
+
+void
+StatSampler::flush()
+{
+    DPRINTF(StatSampler, "Writing %d samples\n", ticks.size());
+
+    for (size_t row = 0; row < ticks.size(); ++row) {
+        writer.putU8('D');
+        writer.putU32(columns.size() + 1);
+        writer.putDouble(ticks[row]);
+        for (const auto &column : columns)
+            writer.putDouble(column[row]);
+    }
+
+    ticks.clear();
+    for (auto &column : columns)
+        column.clear();
+
+    file->stream()->flush();
+}
+
+StatSampler *
+StatSamplerParams::create()
+{
+    return new StatSampler(this);
+}
@@ -0,0 +1,103 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __SIM_STAT_SAMPLER_HH__
+#define __SIM_STAT_SAMPLER_HH__
+
+#include <string>
+#include <vector>
+
+#include "base/stats/binary.hh"
+#include "sim/clocked_object.hh"
+#include "sim/eventq.hh"
+
+class OutputStream;
+struct StatSamplerParams;
+
+namespace Stats {
+class Info;
+}
+
+/**
+ * Samples the values of a selection of stats every period, which is
+ * much cheaper than a periodic dump of all the stats when only a few
+ * of them are needed. The stats are selected by glob patterns matched
+ * against the stats index when the simulation starts. Scalars take a
+ * single value, and vectors and formulas one value per element.
+ *
+ * The samples are kept in memory with a column per value, and written
+ * out as full dumps of the binary stats format when the buffer is full
+ * and at the end of the simulation. The first value of every dump is
+ * the tick of the sample.
+ */
+class StatSampler : public ClockedObject
+{
+  public:
+    StatSampler(const StatSamplerParams *p);
+    ~StatSampler();
+
+    void startup() override;
+
+    /** Write out the buffered samples */
+    void flush();
+
+  protected:
+    /** A sampled stat */
+    struct Sampled
+    {
+        std::string name;
+        const Stats::Info *info;
+        /** Number of values, fixed when the stat is selected */
+        size_t numValues;
+        /** First column of the values */
+        size_t column;
+    };
+
+    void sample();
+
+    void writeSchema();
+
+    const std::vector<std::string> patterns;
+    const Cycles period;
+    const size_t bufferSize;
+
+    OutputStream *file;
+    Stats::BinaryWriter writer;
+
+    std::vector<Sampled> sampled;
+
+    /** Ticks of the buffered samples */
+    std::vector<Tick> ticks;
+    /** Buffered values, a column per sampled value */
+    std::vector<std::vector<double>> columns;
+
+    EventFunctionWrapper sampleEvent;
+};
+
+#endif // __SIM_STAT_SAMPLER_HH__
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include "sim/stats_server.hh"
+
+#include <unistd.h>
+
+#include <sstream>
+
+#include "base/atomicio.hh"
+#include "base/logging.hh"
+#include "base/statistics.hh"
+#include "base/stats/json.hh"
+#include "base/trace.hh"
+#include "debug/StatsServer.hh"
+#include "params/StatsServer.hh"
+#include "sim/global_event.hh"
+#include "sim/root.hh"
+
+namespace {
+
+/**
+ * Event taking a snapshot of the stats. It's a global event so that
+ * all the simulation threads are stopped while the stats are read.
+ */
+class SnapshotEvent : public GlobalEvent
+{
+  private:
+    StatsServer *server;
+
+  public:
+    SnapshotEvent(Tick when, StatsServer *_server)
+        : GlobalEvent(when, Stat_Event_Pri, 0), server(_server)
+    {
+    }
+
+    void process() override { server->snapshot(); }
+
+    const char *description() const override { return "StatsSnapshot"; }
+};
+
+} // anonymous namespace
+
+StatsServer::StatsServer(const StatsServerParams *p)
+    : SimObject(p), period(p->period), listenEvent(nullptr)
+{
+    fatal_if(period == 0, "%s: The snapshot period can't be 0.", name());
+
+    if (p->port)
+        listen(p->port);
+}
+
+StatsServer::~StatsServer()
+{
+    delete listenEvent;
+}
+
+void
+StatsServer::listen(int port)
+{
+    if (ListenSocket::allDisabled()) {
+        warn_once("Sockets disabled, not accepting stats connections");
+        return;
+    }
+
+    while (!listener.listen(port, true)) {
+        DPRINTF(StatsServer, "Can't bind port %d\n", port);
+        port++;
+    }
+
+    ccprintf(std::cerr, "%s: Listening for stats connections on port %d\n",
+             name(), port);
+
+    listenEvent = new ListenEvent(this, listener.getfd(), POLLIN);
+    pollQueue.schedule(listenEvent);
+}
+
+void
+StatsServer::startup()
+{
+    SimObject::startup();
+
+    scheduleSnapshot(curTick() + period);
+}
+
+void
+StatsServer::scheduleSnapshot(Tick when)
+{
+    new SnapshotEvent(when, this);
+}
+
+void
+StatsServer::accept()
+{
+    const int fd = listener.accept(true);
+    if (fd == -1)
+        return;
+
+    DPRINTF(StatsServer, "Sending a snapshot of %d bytes\n",
+            snapshotData.size());
+
+    if (snapshotData.empty()) {
+        const char message[] = "{}\n";
+        atomic_write(fd, message, sizeof(message) - 1);
+    } else {
+        atomic_write(fd, snapshotData.data(), snapshotData.size());
+    }
+    ::close(fd);
+}
+
+void
+StatsServer::visitGroup(Stats::Output &output, Stats::Group &group)
+{
+    for (auto info : group.getStats()) {
+        info->prepare();
+        info->visit(output);
+    }
+
+    for (const auto &g : group.getStatGroups()) {
+        output.beginGroup(g.first.c_str());
+        visitGroup(output, *g.second);
+        output.endGroup();
+    }
+}
+
+void
+StatsServer::snapshot()
+{
+    // Same walk as the dumps from Python: the legacy stats, which have
+    // their full name, and then the stat groups from the root.
+    std::ostringstream stream;
+    Stats::Json output(stream, curTick());
+
+    output.begin();
+    for (auto info : Stats::statsList()) {
+        info->prepare();
+        info->visit(output);
+    }
+    visitGroup(output, *Root::root());
+    output.end();
+
+    snapshotData = stream.str();
+
+    DPRINTF(StatsServer, "Snapshot of %d bytes\n", snapshotData.size());
+
+    scheduleSnapshot(curTick() + period);
+}
+
+StatsServer *
+StatsServerParams::create()
+{
+    return new StatsServer(this);
+}
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef __SIM_STATS_SERVER_HH__
+#define __SIM_STATS_SERVER_HH__
+
+#include <string>
+
+#include "base/pollevent.hh"
+#include "base/socket.hh"
+#include "sim/sim_object.hh"
+
+struct StatsServerParams;
+
+namespace Stats {
+class Group;
+class Output;
+}
+
+/**
+ * Serves the latest snapshot of the stats to the clients connecting to
+ * a TCP port, so that the stats of a long simulation can be looked at
+ * while it runs. The snapshot is taken periodically by a global event,
+ * when all the simulation threads are stopped, and doesn't dump or
+ * reset the stats. Every client gets the snapshot as a JSON object
+ * (see Stats::Json) and is then disconnected.
+ */
+class StatsServer : public SimObject
+{
+  public:
+    StatsServer(const StatsServerParams *p);
+    ~StatsServer();
+
+    void startup() override;
+
+    /** Take a snapshot of the stats */
+    void snapshot();
+
+  protected:
+    class ListenEvent : public PollEvent
+    {
+      protected:
+        StatsServer *server;
+
+      public:
+        ListenEvent(StatsServer *s, int fd, int e)
+            : PollEvent(fd, e), server(s)
+        {}
+
+        void process(int revent) override { server->accept(); }
+    };
+
+    void listen(int port);
+
+    /** Send the latest snapshot to a new client */
+    void accept();
+
+    /** Visit the stats of a group and of its subgroups */
+    void visitGroup(Stats::Output &output, Stats::Group &group);
+
+    /** Schedule the next snapshot */
+    void scheduleSnapshot(Tick when);
+
+    const Tick period;
+
+    ListenSocket listener;
+    ListenEvent *listenEvent;
+
+    /** Latest snapshot */
+    std::string snapshotData;
+};
+
+#endif // __SIM_STATS_SERVER_HH__
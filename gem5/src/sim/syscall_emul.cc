@@ -35,6 +35,8 @@
 #include <sys/syscall.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <climits>
 #include <csignal>
 #include <iostream>
 #include <mutex>
@@ -44,10 +46,13 @@
 #include "base/chunk_generator.hh"
 #include "base/trace.hh"
 #include "config/the_isa.hh"
+#include "cpu/base.hh"
 #include "cpu/thread_context.hh"
 #include "dev/net/dist_iface.hh"
 #include "mem/page_table.hh"
+#include "mem/physical.hh"
 #include "sim/byteswap.hh"
+#include "sim/eventq.hh"
 #include "sim/process.hh"
 #include "sim/sim_exit.hh"
 #include "sim/syscall_debug_macros.hh"
@@ -63,6 +68,43 @@ warnUnsupportedOS(std::string syscall_name)
     warn("Cannot invoke %s on host operating system.", syscall_name);
 }
 
+bool
+hostBufferIovecs(ThreadContext *tc, Addr addr, size_t size,
+                 std::vector<struct iovec> &iovs)
+{
+    System *sys = tc->getSystemPtr();
+    if (!sys->bypassCaches())
+        return false;
+
+    EmulationPageTable *pt = tc->getProcessPtr()->pTable;
+    const Addr page_bytes = sys->getPageBytes();
+    while (size > 0) {
+        Addr paddr;
+        if (!pt->translate(addr, paddr))
+            return false;
+
+        Addr avail;
+        uint8_t *host = sys->getPhysMem().hostAddr(paddr, avail);
+        if (!host)
+            return false;
+
+        const size_t chunk = std::min<Addr>(
+            {size, avail, page_bytes - pt->pageOffset(addr)});
+        if (!iovs.empty() && (uint8_t *)iovs.back().iov_base +
+                iovs.back().iov_len == host) {
+            iovs.back().iov_len += chunk;
+        } else if (iovs.size() < IOV_MAX) {
+            iovs.push_back({host, chunk});
+        } else {
+            return false;
+        }
+
+        addr += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
 SyscallReturn
 unimplementedFunc(SyscallDesc *desc, int callnum, ThreadContext *tc)
 {
@@ -151,7 +193,10 @@ exitImpl(SyscallDesc *desc, int callnum, ThreadContext *tc, bool group)
                  * all threads in the group.
                  */
                 if (*(p->exitGroup)) {
-                    sys->threadContexts[i]->halt();
+                    ThreadContext *walk_tc = sys->threadContexts[i];
+                    EventQueue::ScopedMigration migrate(
+                        walk_tc->getCpuPtr()->eventQueue());
+                    walk_tc->halt();
                 } else {
                     last_thread = false;
                 }
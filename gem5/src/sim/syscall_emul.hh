@@ -87,6 +87,7 @@
 #include <cerrno>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "arch/generic/tlb.hh"
 #include "arch/utility.hh"
@@ -122,6 +123,22 @@
 
 void warnUnsupportedOS(std::string syscall_name);
 
+/**
+ * Describe a buffer in target user space with host iovecs pointing
+ * straight at the simulated memory backing it, so that data moves
+ * between host file descriptors and the simulated memory without an
+ * intermediate copy. Host memory only holds the latest data when the
+ * caches are bypassed, and the whole buffer has to be mapped, so
+ * callers need to fall back to a BufferArg when this fails.
+ *
+ * @param addr Address of the buffer in target user space.
+ * @param size Size of the buffer.
+ * @param iovs Vector the iovecs of the buffer are appended to.
+ * @return true if the buffer can be accessed through iovs.
+ */
+bool hostBufferIovecs(ThreadContext *tc, Addr addr, size_t size,
+                      std::vector<struct iovec> &iovs);
+
 /// Handler for unimplemented syscalls that we haven't thought about.
 SyscallReturn unimplementedFunc(SyscallDesc *desc, int num, ThreadContext *tc);
 
@@ -1626,7 +1643,8 @@ cloneFunc(SyscallDesc *desc, int callnum, ThreadContext *tc)
         cpc.advance();
         ctc->pcState(cpc);
     }
-    ctc->activate();
+    // The new thread may run on a CPU with a different event queue.
+    ctc->remoteActivate();
 
     return cp->pid();
 }
@@ -1675,10 +1693,26 @@ readvFunc(SyscallDesc *desc, int callnum, ThreadContext *tc)
     uint64_t tiov_base = p->getSyscallArg(tc, index);
     size_t count = p->getSyscallArg(tc, index);
     typename OS::tgt_iovec tiov[count];
-    struct iovec hiov[count];
     for (size_t i = 0; i < count; ++i) {
         prox.readBlob(tiov_base + (i * sizeof(typename OS::tgt_iovec)),
                       &tiov[i], sizeof(typename OS::tgt_iovec));
+    }
+
+    // Read straight into the simulated memory if possible
+    std::vector<struct iovec> direct_iovs;
+    bool direct = true;
+    for (size_t i = 0; i < count && direct; ++i) {
+        direct = hostBufferIovecs(tc, TheISA::gtoh(tiov[i].iov_base),
+                                  TheISA::gtoh(tiov[i].iov_len),
+                                  direct_iovs);
+    }
+    if (direct) {
+        int result = readv(sim_fd, direct_iovs.data(), direct_iovs.size());
+        return (result == -1) ? -errno : result;
+    }
+
+    struct iovec hiov[count];
+    for (size_t i = 0; i < count; ++i) {
         hiov[i].iov_len = TheISA::gtoh(tiov[i].iov_len);
         hiov[i].iov_base = new char [hiov[i].iov_len];
     }
@@ -1714,15 +1748,30 @@ writevFunc(SyscallDesc *desc, int callnum, ThreadContext *tc)
     PortProxy &prox = tc->getVirtProxy();
     uint64_t tiov_base = p->getSyscallArg(tc, index);
     size_t count = p->getSyscallArg(tc, index);
-    struct iovec hiov[count];
+    typename OS::tgt_iovec tiov[count];
     for (size_t i = 0; i < count; ++i) {
-        typename OS::tgt_iovec tiov;
-
         prox.readBlob(tiov_base + i*sizeof(typename OS::tgt_iovec),
-                      &tiov, sizeof(typename OS::tgt_iovec));
-        hiov[i].iov_len = TheISA::gtoh(tiov.iov_len);
+                      &tiov[i], sizeof(typename OS::tgt_iovec));
+    }
+
+    // Write straight from the simulated memory if possible
+    std::vector<struct iovec> direct_iovs;
+    bool direct = true;
+    for (size_t i = 0; i < count && direct; ++i) {
+        direct = hostBufferIovecs(tc, TheISA::gtoh(tiov[i].iov_base),
+                                  TheISA::gtoh(tiov[i].iov_len),
+                                  direct_iovs);
+    }
+    if (direct) {
+        int result = writev(sim_fd, direct_iovs.data(), direct_iovs.size());
+        return (result == -1) ? -errno : result;
+    }
+
+    struct iovec hiov[count];
+    for (size_t i = 0; i < count; ++i) {
+        hiov[i].iov_len = TheISA::gtoh(tiov[i].iov_len);
         hiov[i].iov_base = new char [hiov[i].iov_len];
-        prox.readBlob(TheISA::gtoh(tiov.iov_base), hiov[i].iov_base,
+        prox.readBlob(TheISA::gtoh(tiov[i].iov_base), hiov[i].iov_base,
                       hiov[i].iov_len);
     }
 
@@ -1924,10 +1973,16 @@ pwrite64Func(SyscallDesc *desc, int num, ThreadContext *tc)
         return -EBADF;
     int sim_fd = ffdp->getSimFD();
 
-    BufferArg bufArg(bufPtr, nbytes);
-    bufArg.copyIn(tc->getVirtProxy());
+    int bytes_written;
+    std::vector<struct iovec> iovs;
+    if (nbytes > 0 && hostBufferIovecs(tc, bufPtr, nbytes, iovs)) {
+        bytes_written = pwritev(sim_fd, iovs.data(), iovs.size(), offset);
+    } else {
+        BufferArg bufArg(bufPtr, nbytes);
+        bufArg.copyIn(tc->getVirtProxy());
 
-    int bytes_written = pwrite(sim_fd, bufArg.bufferPtr(), nbytes, offset);
+        bytes_written = pwrite(sim_fd, bufArg.bufferPtr(), nbytes, offset);
+    }
 
     return (bytes_written == -1) ? -errno : bytes_written;
 }
@@ -2630,11 +2685,17 @@ readFunc(SyscallDesc *desc, int num, ThreadContext *tc)
         && !(hbfdp->getFlags() & OS::TGT_O_NONBLOCK))
         return SyscallReturn::retry();
 
-    BufferArg buf_arg(buf_ptr, nbytes);
-    int bytes_read = read(sim_fd, buf_arg.bufferPtr(), nbytes);
+    int bytes_read;
+    std::vector<struct iovec> iovs;
+    if (nbytes > 0 && hostBufferIovecs(tc, buf_ptr, nbytes, iovs)) {
+        bytes_read = readv(sim_fd, iovs.data(), iovs.size());
+    } else {
+        BufferArg buf_arg(buf_ptr, nbytes);
+        bytes_read = read(sim_fd, buf_arg.bufferPtr(), nbytes);
 
-    if (bytes_read > 0)
-        buf_arg.copyOut(tc->getVirtProxy());
+        if (bytes_read > 0)
+            buf_arg.copyOut(tc->getVirtProxy());
+    }
 
     return (bytes_read == -1) ? -errno : bytes_read;
 }
@@ -2654,8 +2715,12 @@ writeFunc(SyscallDesc *desc, int num, ThreadContext *tc)
         return -EBADF;
     int sim_fd = hbfdp->getSimFD();
 
-    BufferArg buf_arg(buf_ptr, nbytes);
-    buf_arg.copyIn(tc->getVirtProxy());
+    std::vector<struct iovec> iovs;
+    const bool direct =
+        nbytes > 0 && hostBufferIovecs(tc, buf_ptr, nbytes, iovs);
+    BufferArg buf_arg(buf_ptr, direct ? 0 : nbytes);
+    if (!direct)
+        buf_arg.copyIn(tc->getVirtProxy());
 
     struct pollfd pfd;
     pfd.fd = sim_fd;
@@ -2673,7 +2738,9 @@ writeFunc(SyscallDesc *desc, int num, ThreadContext *tc)
             return SyscallReturn::retry();
     }
 
-    int bytes_written = write(sim_fd, buf_arg.bufferPtr(), nbytes);
+    int bytes_written = direct ?
+        writev(sim_fd, iovs.data(), iovs.size()) :
+        write(sim_fd, buf_arg.bufferPtr(), nbytes);
 
     if (bytes_written != -1)
         fsync(sim_fd);
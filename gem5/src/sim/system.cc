@@ -48,6 +48,7 @@
 #include "sim/system.hh"
 
 #include <algorithm>
+#include <mutex>
 
 #include "arch/remote_gdb.hh"
 #include "arch/utility.hh"
@@ -103,7 +104,11 @@ System::System(Params *p)
 #else
       kvmVM(nullptr),
 #endif
-      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve),
+      physmem(name() + ".physmem", p->memories, p->mmap_using_noreserve,
+              p->mmap_using_hugetlb, p->mmap_using_thp,
+              p->raw_checkpoint_stores, p->checkpoint_store_threads,
+              p->delta_checkpoints, p->lazy_checkpoint_restore,
+              p->checkpoint_image_dir),
       memoryMode(p->mem_mode),
       _cacheLineSize(p->cache_line_size),
       workItemsBegin(0),
@@ -378,6 +383,7 @@ System::validKvmEnvironment() const
 Addr
 System::allocPhysPages(int npages)
 {
+    std::lock_guard<std::mutex> lock(pagePtrLock);
     Addr return_addr = pagePtr << PageShift;
     pagePtr += npages;
 
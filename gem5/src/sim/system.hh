@@ -47,6 +47,7 @@
 #ifndef __SYSTEM_HH__
 #define __SYSTEM_HH__
 
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -212,6 +213,8 @@ class System : public SimObject
     int numRunningContexts();
 
     Addr pagePtr;
+    /** Serialises page allocation from CPUs on different event queues */
+    std::mutex pagePtrLock;
 
     uint64_t init_param;
 
@@ -599,6 +602,9 @@ class System : public SimObject
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
 
+    /** Restoring the memories only touches the state of this system */
+    bool threadSafeLoadState() const override { return true; }
+
     void drainResume() override;
 
   public:
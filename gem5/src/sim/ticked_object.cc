@@ -57,9 +57,16 @@ Ticked::Ticked(ClockedObject &object_,
 
 void
 Ticked::processClockEvent() {
+    Cycles delta(1);
+    if (!running) {
+        // End of a sleep(), account for the skipped cycles in one go
+        running = true;
+        delta = cyclesSinceLastStopped();
+    }
+
     ++tickCycles;
-    ++numCycles;
-    countCycles(Cycles(1));
+    numCycles += delta;
+    countCycles(delta);
     evaluate();
     if (running)
         object.schedule(event, object.clockEdge(Cycles(1)));
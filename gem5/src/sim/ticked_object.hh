@@ -55,6 +55,11 @@ class TickedObjectParams;
 /** Ticked attaches gem5's event queue/scheduler to evaluate
  *  calls and provides a start/stop interface to ticking.
  *
+ *  An idle object can either stop() until an external wakeup calls
+ *  start(), or sleep() for a known number of cycles. In both cases no
+ *  events are scheduled while idle and the skipped cycles are credited
+ *  to numCycles and countCycles in bulk when ticking resumes.
+ *
  *  Ticked is not a ClockedObject but can be attached to one by
  *  inheritance and by calling regStats, serialize/unserialize */
 class Ticked : public Serializable
@@ -100,13 +105,16 @@ class Ticked : public Serializable
      *  imported, be sure to register it *before* calling this regStats */
     void regStats();
 
-    /** Start ticking */
+    /** Start ticking, this also wakes the object up from a sleep */
     void
     start()
     {
         if (!running) {
+            const Tick next = object.clockEdge(Cycles(1));
             if (!event.scheduled())
-                object.schedule(event, object.clockEdge(Cycles(1)));
+                object.schedule(event, next);
+            else if (event.when() > next)
+                object.reschedule(event, next);
             running = true;
             numCycles += cyclesSinceLastStopped();
             countCycles(cyclesSinceLastStopped());
@@ -131,14 +139,33 @@ class Ticked : public Serializable
     void
     stop()
     {
+        if (event.scheduled())
+            object.deschedule(event);
         if (running) {
-            if (event.scheduled())
-                object.deschedule(event);
             running = false;
             resetLastStopped();
         }
     }
 
+    /**
+     * Stop ticking until the given number of cycles from now, or until
+     * start() is called if that happens earlier. Can be called from
+     * evaluate().
+     *
+     * @param cycles Number of cycles until the next evaluate(), must
+     * be at least one.
+     */
+    void
+    sleep(Cycles cycles)
+    {
+        assert(cycles > 0);
+        stop();
+        object.schedule(event, object.clockEdge(cycles));
+    }
+
+    /** Is ticking stopped until the end of a sleep() or a start()? */
+    bool sleeping() const { return !running && event.scheduled(); }
+
     /** Checkpoint lastStopped */
     void serialize(CheckpointOut &cp) const override;
     void unserialize(CheckpointIn &cp) override;
@@ -287,6 +287,24 @@ Scheduler::scheduleStarvationEvent()
 
 void
 Scheduler::runReady()
+{
+    // Delta cycles usually make processes runnable for the next one,
+    // which reschedules this event at the current time. If nothing else
+    // is in front of it, start that cycle right away instead of going
+    // through the event queue.
+    for (unsigned batched = 0; ; batched++) {
+        runCycle();
+
+        if (!readyEvent.scheduled() || eq->getHead() != &readyEvent ||
+                batched == MaxBatchedCycles) {
+            break;
+        }
+        deschedule(&readyEvent);
+    }
+}
+
+void
+Scheduler::runCycle()
 {
     scheduleTimeAdvancesEvent();
 
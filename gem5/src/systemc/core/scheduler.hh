@@ -104,7 +104,9 @@ typedef NodeList<Channel> ChannelList;
  *
  * If any processes became runnable during the delta notification phase, the
  * readyEvent will have been scheduled and will be waiting and ready to run
- * again, effectively starting the next delta cycle.
+ * again, effectively starting the next delta cycle. When the readyEvent is
+ * the next event in the queue anyway, that cycle is started directly from
+ * the current one, up to a limited number of cycles.
  *
  * TIMED NOTIFICATION PHASE
  *
@@ -421,7 +423,12 @@ class Scheduler
     }
 
     void runReady();
+    // Run the evaluate, update and delta notification phases once.
+    void runCycle();
     EventWrapper<Scheduler, &Scheduler::runReady> readyEvent;
+    // Delta cycles run by one readyEvent before returning to gem5, so that
+    // gem5 still gets to check for exit requests.
+    static const unsigned MaxBatchedCycles = 1000;
     void scheduleReadyEvent();
 
     void pause();
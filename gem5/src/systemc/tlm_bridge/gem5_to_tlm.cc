@@ -114,9 +114,15 @@ packet2payload(PacketPtr packet)
         SC_REPORT_FATAL("Gem5ToTlmBridge", "No R/W packet");
     }
 
-    // Attach the packet pointer to the TLM transaction to keep track.
-    auto *extension = new Gem5SystemC::Gem5Extension(packet);
-    trans->set_auto_extension(extension);
+    // Attach the packet pointer to the TLM transaction to keep track. The
+    // extension isn't freed when the payload goes back to the memory
+    // manager, so recycled payloads already have one.
+    Gem5SystemC::Gem5Extension *extension = nullptr;
+    trans->get_extension(extension);
+    if (extension)
+        extension->setPacket(packet);
+    else
+        trans->set_extension(new Gem5SystemC::Gem5Extension(packet));
 
     return trans;
 }
@@ -183,14 +189,11 @@ template <unsigned int BITWIDTH>
 MemBackdoorPtr
 Gem5ToTlmBridge<BITWIDTH>::getBackdoor(tlm::tlm_generic_payload &trans)
 {
-    sc_dt::uint64 start = trans.get_address();
-    sc_dt::uint64 end = start + trans.get_data_length();
-
     // Check for a back door we already know about.
-    AddrRange r(start, end);
+    AddrRange r = RangeSize(trans.get_address(), trans.get_data_length());
     auto it = backdoorMap.contains(r);
     if (it != backdoorMap.end())
-        return it->second;
+        return it->second.backdoor;
 
     // If not, ask the target for one.
     tlm::tlm_dmi dmi_data;
@@ -205,11 +208,49 @@ Gem5ToTlmBridge<BITWIDTH>::getBackdoor(tlm::tlm_generic_payload &trans)
     backdoor->readable(dmi_data.is_read_allowed());
     backdoor->writeable(dmi_data.is_write_allowed());
 
-    backdoorMap.insert(dmi_r, backdoor);
+    backdoorMap.insert(dmi_r, DmiRegion{ backdoor,
+            dmi_data.get_read_latency().value(),
+            dmi_data.get_write_latency().value() });
 
     return backdoor;
 }
 
+template <unsigned int BITWIDTH>
+const typename Gem5ToTlmBridge<BITWIDTH>::DmiRegion *
+Gem5ToTlmBridge<BITWIDTH>::accessDmi(PacketPtr packet)
+{
+    if (backdoorMap.empty())
+        return nullptr;
+
+    // Anything with side effects beyond reading or writing the data has
+    // to be seen by the target.
+    if ((packet->cmd != MemCmd::ReadReq && packet->cmd != MemCmd::WriteReq) ||
+            (packet->req->getFlags() & Request::NO_ACCESS)) {
+        return nullptr;
+    }
+
+    auto it = backdoorMap.contains(packet->getAddrRange());
+    if (it == backdoorMap.end())
+        return nullptr;
+
+    const DmiRegion &region = it->second;
+    MemBackdoorPtr backdoor = region.backdoor;
+    uint8_t *host = backdoor->ptr() +
+        (packet->getAddr() - backdoor->range().start());
+
+    if (packet->isRead()) {
+        if (!backdoor->readable())
+            return nullptr;
+        packet->setData(host);
+    } else {
+        if (!backdoor->writeable())
+            return nullptr;
+        packet->writeData(host);
+    }
+
+    return &region;
+}
+
 // Similar to TLM's blocking transport (LT)
 template <unsigned int BITWIDTH>
 Tick
@@ -218,6 +259,16 @@ Gem5ToTlmBridge<BITWIDTH>::recvAtomic(PacketPtr packet)
     panic_if(packet->cacheResponding(),
              "Should not see packets where cache is responding");
 
+    // Loosely timed targets let us bypass them through DMI, like a TLM
+    // initiator would.
+    if (auto *region = accessDmi(packet)) {
+        Tick latency = packet->isRead() ?
+            region->readLatency : region->writeLatency;
+        if (packet->needsResponse())
+            packet->makeResponse();
+        return latency;
+    }
+
     // Prepare the transaction.
     auto *trans = packet2payload(packet);
 
@@ -244,6 +295,15 @@ Gem5ToTlmBridge<BITWIDTH>::recvAtomicBackdoor(
     panic_if(packet->cacheResponding(),
              "Should not see packets where cache is responding");
 
+    if (auto *region = accessDmi(packet)) {
+        Tick latency = packet->isRead() ?
+            region->readLatency : region->writeLatency;
+        backdoor = region->backdoor;
+        if (packet->needsResponse())
+            packet->makeResponse();
+        return latency;
+    }
+
     sc_core::sc_time delay = sc_core::SC_ZERO_TIME;
 
     // Prepare the transaction.
@@ -414,6 +474,9 @@ template <unsigned int BITWIDTH>
 void
 Gem5ToTlmBridge<BITWIDTH>::recvFunctional(PacketPtr packet)
 {
+    if (accessDmi(packet))
+        return;
+
     // Prepare the transaction.
     auto *trans = packet2payload(packet);
 
@@ -452,8 +515,8 @@ Gem5ToTlmBridge<BITWIDTH>::invalidate_direct_mem_ptr(
         if (it == backdoorMap.end())
             break;
 
-        it->second->invalidate();
-        delete it->second;
+        it->second.backdoor->invalidate();
+        delete it->second.backdoor;
         backdoorMap.erase(it);
     };
 }
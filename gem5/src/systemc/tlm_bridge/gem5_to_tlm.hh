@@ -170,8 +170,25 @@ class Gem5ToTlmBridge : public Gem5ToTlmBridgeBase
     void pec(Gem5SystemC::PayloadEvent<Gem5ToTlmBridge<BITWIDTH>> *pe,
              tlm::tlm_generic_payload &trans, const tlm::tlm_phase &phase);
 
+    /** A DMI region granted by the target and its access latencies */
+    struct DmiRegion
+    {
+        MemBackdoorPtr backdoor;
+        Tick readLatency;
+        Tick writeLatency;
+    };
+
     MemBackdoorPtr getBackdoor(tlm::tlm_generic_payload &trans);
-    AddrRangeMap<MemBackdoorPtr> backdoorMap;
+    AddrRangeMap<DmiRegion> backdoorMap;
+
+    /**
+     * Access the data of a plain read or write packet directly if the
+     * target already granted a DMI region covering it.
+     *
+     * @return The region which served the access, nullptr if the packet
+     * has to go through the socket.
+     */
+    const DmiRegion *accessDmi(PacketPtr packet);
 
     // The gem5 port interface.
     Tick recvAtomic(PacketPtr packet);
@@ -69,6 +69,13 @@ Gem5Extension::getPacket()
     return packet;
 }
 
+void
+Gem5Extension::setPacket(PacketPtr _packet)
+{
+    packet = _packet;
+    pipeThrough = false;
+}
+
 tlm::tlm_extension_base *
 Gem5Extension::clone() const
 {
@@ -57,6 +57,8 @@ class Gem5Extension: public tlm::tlm_extension<Gem5Extension>
     static Gem5Extension &getExtension(
             const tlm::tlm_generic_payload &payload);
     PacketPtr getPacket();
+    /** Reuse the extension for another packet. */
+    void setPacket(PacketPtr _packet);
 
     bool isPipeThrough() const { return pipeThrough; }
     void setPipeThrough() { pipeThrough = true; }
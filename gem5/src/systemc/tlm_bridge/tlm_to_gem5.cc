@@ -60,11 +60,16 @@
 
 #include "systemc/tlm_bridge/tlm_to_gem5.hh"
 
+#include <cstring>
+
 #include "params/TlmToGem5Bridge32.hh"
 #include "params/TlmToGem5Bridge64.hh"
 #include "sim/system.hh"
+#include "systemc/ext/core/sc_module.hh"
 #include "systemc/ext/core/sc_module_name.hh"
+#include "systemc/ext/core/sc_process_handle.hh"
 #include "systemc/ext/core/sc_time.hh"
+#include "systemc/ext/tlm_core/2/quantum/global_quantum.hh"
 
 namespace sc_gem5
 {
@@ -214,10 +219,96 @@ template <unsigned int BITWIDTH>
 void
 TlmToGem5Bridge<BITWIDTH>::invalidateDmi(const ::MemBackdoor &backdoor)
 {
+    dmiBackdoors.erase(&backdoor);
+    auto it = dmiRegions.contains(backdoor.range());
+    if (it != dmiRegions.end() && it->second.backdoor == &backdoor)
+        dmiRegions.erase(it);
     socket->invalidate_direct_mem_ptr(
             backdoor.range().start(), backdoor.range().end());
 }
 
+template <unsigned int BITWIDTH>
+void
+TlmToGem5Bridge<BITWIDTH>::addBackdoor(MemBackdoorPtr backdoor, Tick latency)
+{
+    if (dmiBackdoors.insert(backdoor).second) {
+        backdoor->addInvalidationCallback(
+            [this](const MemBackdoor &backdoor)
+            {
+                invalidateDmi(backdoor);
+            }
+        );
+    }
+
+    auto it = dmiRegions.contains(backdoor->range());
+    if (it == dmiRegions.end())
+        dmiRegions.insert(backdoor->range(), DmiRegion{ backdoor, latency });
+    else if (it->second.backdoor == backdoor)
+        it->second.latency = latency;
+}
+
+template <unsigned int BITWIDTH>
+bool
+TlmToGem5Bridge<BITWIDTH>::accessBackdoor(tlm::tlm_generic_payload &trans,
+                                          sc_core::sc_time &t)
+{
+    if (dmiRegions.empty())
+        return false;
+
+    auto cmd = trans.get_command();
+    unsigned len = trans.get_data_length();
+    if ((cmd != tlm::TLM_READ_COMMAND && cmd != tlm::TLM_WRITE_COMMAND) ||
+            !len || trans.get_byte_enable_ptr() ||
+            trans.get_streaming_width() < len) {
+        return false;
+    }
+
+    auto it = dmiRegions.contains(RangeSize(trans.get_address(), len));
+    if (it == dmiRegions.end())
+        return false;
+
+    const DmiRegion &region = it->second;
+    MemBackdoorPtr backdoor = region.backdoor;
+    uint8_t *host = backdoor->ptr() +
+        (trans.get_address() - backdoor->range().start());
+
+    if (cmd == tlm::TLM_READ_COMMAND) {
+        if (!backdoor->readable())
+            return false;
+        std::memcpy(trans.get_data_ptr(), host, len);
+    } else {
+        if (!backdoor->writeable())
+            return false;
+        std::memcpy(host, trans.get_data_ptr(), len);
+    }
+
+    trans.set_dmi_allowed(true);
+    t += sc_core::sc_time::from_value(region.latency);
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+
+    return true;
+}
+
+template <unsigned int BITWIDTH>
+void
+TlmToGem5Bridge<BITWIDTH>::syncQuantum(sc_core::sc_time &t)
+{
+    const sc_core::sc_time &quantum =
+        tlm::tlm_global_quantum::instance().get();
+    if (quantum == sc_core::SC_ZERO_TIME || t < quantum)
+        return;
+
+    // Only threads can wait, methods are left to sync on their own.
+    auto process = sc_core::sc_get_current_process_handle();
+    if (!process.valid() ||
+            process.proc_kind() == sc_core::SC_METHOD_PROC_) {
+        return;
+    }
+
+    sc_core::wait(t);
+    t = sc_core::SC_ZERO_TIME;
+}
+
 template <unsigned int BITWIDTH>
 void
 TlmToGem5Bridge<BITWIDTH>::peq_cb(tlm::tlm_generic_payload &trans,
@@ -277,13 +368,24 @@ TlmToGem5Bridge<BITWIDTH>::b_transport(tlm::tlm_generic_payload &trans,
         extension->setPipeThrough();
         pkt = extension->getPacket();
     } else {
+        syncQuantum(t);
+        // Once gem5 returned a backdoor for an address range, accesses to
+        // it don't need to go through gem5 anymore.
+        if (accessBackdoor(trans, t))
+            return;
         pkt = payload2packet(masterId, trans);
+        if (!pkt) {
+            trans.set_response_status(tlm::TLM_OK_RESPONSE);
+            return;
+        }
     }
 
     MemBackdoorPtr backdoor = nullptr;
     Tick ticks = bmp.sendAtomicBackdoor(pkt, backdoor);
-    if (backdoor)
+    if (backdoor) {
         trans.set_dmi_allowed(true);
+        addBackdoor(backdoor, ticks);
+    }
 
     // send an atomic request to gem5
     panic_if(pkt->needsResponse() && !pkt->isResponse(),
@@ -340,18 +442,29 @@ TlmToGem5Bridge<BITWIDTH>::get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
         extension->setPipeThrough();
         pkt = extension->getPacket();
     } else {
+        // A DMI request doesn't need a command, look up the range with a
+        // read which doesn't access anything.
+        auto cmd = trans.get_command();
+        trans.set_command(tlm::TLM_READ_COMMAND);
         pkt = payload2packet(masterId, trans);
+        trans.set_command(cmd);
         pkt->req->setFlags(Request::NO_ACCESS);
     }
 
     MemBackdoorPtr backdoor = nullptr;
-    bmp.sendAtomicBackdoor(pkt, backdoor);
+    Tick ticks = bmp.sendAtomicBackdoor(pkt, backdoor);
     if (backdoor) {
         trans.set_dmi_allowed(true);
         dmi_data.set_dmi_ptr(backdoor->ptr());
         dmi_data.set_start_address(backdoor->range().start());
         dmi_data.set_end_address(backdoor->range().end());
 
+        // Charge DMI accesses what a regular access to the region costs
+        // so the timing doesn't depend on which path the initiator uses.
+        auto latency = sc_core::sc_time::from_value(ticks);
+        dmi_data.set_read_latency(latency);
+        dmi_data.set_write_latency(latency);
+
         typedef tlm::tlm_dmi::dmi_access_e access_t;
         access_t access = tlm::tlm_dmi::DMI_ACCESS_NONE;
         if (backdoor->readable())
@@ -360,12 +473,7 @@ TlmToGem5Bridge<BITWIDTH>::get_direct_mem_ptr(tlm::tlm_generic_payload &trans,
             access = (access_t)(access | tlm::tlm_dmi::DMI_ACCESS_WRITE);
         dmi_data.set_granted_access(access);
 
-        backdoor->addInvalidationCallback(
-            [this](const MemBackdoor &backdoor)
-            {
-                invalidateDmi(backdoor);
-            }
-        );
+        addBackdoor(backdoor, ticks);
     }
 
     if (extension == nullptr)
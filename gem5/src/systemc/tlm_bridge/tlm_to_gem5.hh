@@ -61,6 +61,9 @@
 #ifndef __SYSTEMC_TLM_BRIDGE_TLM_TO_GEM5_HH__
 #define __SYSTEMC_TLM_BRIDGE_TLM_TO_GEM5_HH__
 
+#include <unordered_set>
+
+#include "base/addr_range_map.hh"
 #include "mem/port.hh"
 #include "params/TlmToGem5BridgeBase.hh"
 #include "systemc/ext/core/sc_module.hh"
@@ -142,6 +145,37 @@ class TlmToGem5Bridge : public TlmToGem5BridgeBase
 
     void invalidateDmi(const ::MemBackdoor &backdoor);
 
+    /**
+     * Backdoors handed out as DMI regions or used to bypass gem5. Their
+     * invalidation callback is only registered once, no matter how often
+     * the initiator asks for the same region.
+     */
+    std::unordered_set<const ::MemBackdoor *> dmiBackdoors;
+
+    /** A backdoor and the latency of the access which returned it */
+    struct DmiRegion
+    {
+        MemBackdoorPtr backdoor;
+        Tick latency;
+    };
+    AddrRangeMap<DmiRegion> dmiRegions;
+
+    void addBackdoor(MemBackdoorPtr backdoor, Tick latency);
+
+    /**
+     * Serve a blocking transaction from a backdoor gem5 already returned
+     * for its address range, without building a packet.
+     */
+    bool accessBackdoor(tlm::tlm_generic_payload &trans,
+                        sc_core::sc_time &t);
+
+    /**
+     * Wait for a loosely timed initiator which has run ahead of the
+     * SystemC time by at least the global quantum before its transaction
+     * reaches gem5, as its quantum keeper would.
+     */
+    void syncQuantum(sc_core::sc_time &t);
+
   protected:
     // payload event call back
     void peq_cb(tlm::tlm_generic_payload &trans, const tlm::tlm_phase &phase);
@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+/*
+ * Measure the throughput of address decoding with AddrRangeMap on a
+ * map that looks like the one of a memory crossbar: many interleaved
+ * memory channels followed by a number of device ranges. The
+ * containment lookup used for routing is compared to a walk of an
+ * interval tree in a std::map, the way AddrRangeMap looked up ranges
+ * before it had the flat slot array (minus its cache of recent hits).
+ */
+
+#include <chrono>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "base/addr_range_map.hh"
+#include "base/cprintf.hh"
+
+using namespace std;
+
+namespace {
+
+typedef AddrRangeMap<int, 3> Map;
+typedef map<AddrRange, int> Tree;
+
+/**
+ * Find the range containing an address by looking at the first range
+ * starting after it and the ranges that merge with the one before.
+ */
+int
+treeContains(const Tree &t, Addr a)
+{
+    auto next = t.upper_bound(RangeSize(a, 1));
+    if (next != t.end() && next->first.contains(a))
+        return next->second;
+    if (next == t.begin())
+        return -1;
+    --next;
+
+    Tree::const_iterator i;
+    do {
+        i = next;
+        if (i->first.contains(a))
+            return i->second;
+    } while (next != t.begin() && (--next)->first.mergesWith(i->first));
+
+    return -1;
+}
+
+void
+populate(Map &m, unsigned channels)
+{
+    // channels interleaved at a 64 byte granularity, xoring in
+    // higher bits as a hashed mapping does
+    unsigned bits = 0;
+    while ((1U << bits) < channels)
+        ++bits;
+
+    vector<Addr> masks;
+    for (unsigned i = 0; i < bits; ++i)
+        masks.push_back(ULL(1) << (6 + i) | ULL(1) << (20 + i));
+
+    const Addr mem_size = ULL(1) << 34;
+    for (unsigned i = 0; i < (1U << bits); ++i)
+        m.insert(AddrRange(0, mem_size - 1, masks, i), i);
+
+    // and a few devices above the memory
+    for (unsigned i = 0; i < 32; ++i)
+        m.insert(RangeSize(mem_size + i * 0x10000, 0x1000), channels + i);
+}
+
+template <typename F>
+double
+measure(const vector<Addr> &addrs, uint64_t &sum, F lookup)
+{
+    auto start = chrono::steady_clock::now();
+    for (auto a : addrs)
+        sum += lookup(a);
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double>(end - start).count();
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    bool identical = true;
+
+    cprintf("%8s %16s %16s %8s\n", "channels", "tree (lookup/s)",
+            "flat (lookup/s)", "speedup");
+
+    for (unsigned channels : { 1, 4, 16, 64 }) {
+        Map m;
+        populate(m, channels);
+        const Tree t(m.begin(), m.end());
+
+        // mostly memory accesses, with the occasional device access
+        mt19937_64 rng(channels);
+        uniform_int_distribution<Addr> mem(0, (ULL(1) << 34) - 1);
+        uniform_int_distribution<unsigned> dev(0, 31);
+        vector<Addr> addrs(1 << 22);
+        for (size_t i = 0; i < addrs.size(); ++i) {
+            addrs[i] = i % 16 ? mem(rng) :
+                (ULL(1) << 34) + dev(rng) * 0x10000 + 0x80;
+        }
+
+        uint64_t tree_sum = 0;
+        uint64_t flat_sum = 0;
+        const double tree = measure(addrs, tree_sum, [&t](Addr a) {
+                return treeContains(t, a); });
+        const double flat = measure(addrs, flat_sum, [&m](Addr a) {
+                return m.contains(a)->second; });
+
+        cprintf("%8d %16d %16d %8.2f\n", channels,
+                (uint64_t)(addrs.size() / tree),
+                (uint64_t)(addrs.size() / flat), tree / flat);
+
+        if (tree_sum != flat_sum) {
+            cprintf("lookups returned different entries!\n");
+            identical = false;
+        }
+    }
+
+    return identical ? 0 : 1;
+}
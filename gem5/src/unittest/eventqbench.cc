@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2019 The Regents of The University of Michigan
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met: redistributions of source code must retain the above copyright
+ * notice, this list of conditions and the following disclaimer;
+ * redistributions in binary form must reproduce the above copyright
+ * notice, this list of conditions and the following disclaimer in the
+ * documentation and/or other materials provided with the distribution;
+ * neither the name of the copyright holders nor the names of its
+ * contributors may be used to endorse or promote products derived from
+ * this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+/*
+ * Compare the event queue backends on synthetic event traces that mimic
+ * many clocked objects on unrelated clock domains. Each object ticks on
+ * its own clock and, every few cycles, sends a message that shows up as
+ * an auto-deleting event a few cycles later. The benchmark also checks
+ * that both backends service the events in exactly the same order.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "base/cprintf.hh"
+#include "sim/eventq_impl.hh"
+
+using namespace std;
+
+namespace {
+
+//! Order in which the objects were serviced, folded into a hash.
+uint64_t orderHash;
+
+void
+record(uint64_t id)
+{
+    orderHash = (orderHash ^ id) * 0x100000001b3ULL;
+}
+
+class Ticker
+{
+  private:
+    EventQueue &eventq;
+    uint64_t id;
+    Tick period;
+    unsigned sendInterval;
+    unsigned cycle;
+    EventFunctionWrapper tickEvent;
+
+    void
+    tick()
+    {
+        record(id);
+        if (++cycle % sendInterval == 0) {
+            const Tick latency = period * (1 + cycle % 4);
+            const uint64_t msg = id << 32 | cycle;
+            eventq.scheduleOneShot([msg]{ record(msg); },
+                                   eventq.getCurTick() + latency);
+        }
+        eventq.schedule(&tickEvent, eventq.getCurTick() + period);
+    }
+
+  public:
+    Ticker(EventQueue &q, uint64_t _id, Tick _period, unsigned interval)
+        : eventq(q), id(_id), period(_period), sendInterval(interval),
+          cycle(0), tickEvent([this]{ tick(); }, "ticker",
+                              false, Event::CPU_Tick_Pri)
+    {
+        eventq.schedule(&tickEvent, period);
+    }
+
+    ~Ticker()
+    {
+        if (tickEvent.scheduled())
+            eventq.deschedule(&tickEvent);
+    }
+};
+
+struct Result
+{
+    double seconds;
+    uint64_t events;
+    uint64_t hash;
+};
+
+Result
+run(EventQueue::Backend backend, unsigned objects, Tick duration)
+{
+    EventQueue eventq("bench");
+    eventq.setBackend(backend);
+    curEventQueue(&eventq);
+    orderHash = 0xcbf29ce484222325ULL;
+
+    // Clock periods between 250ps and 2ns, in steps of 1ps, so that
+    // the clock edges rarely line up.
+    mt19937 rng(objects);
+    uniform_int_distribution<Tick> period(250, 2000);
+    uniform_int_distribution<unsigned> interval(1, 8);
+
+    vector<Ticker *> tickers;
+    for (unsigned i = 0; i < objects; ++i)
+        tickers.push_back(new Ticker(eventq, i, period(rng), interval(rng)));
+
+    uint64_t events = 0;
+    auto start = chrono::steady_clock::now();
+    while (!eventq.empty() && eventq.nextTick() <= duration) {
+        eventq.serviceOne();
+        ++events;
+    }
+    auto end = chrono::steady_clock::now();
+
+    for (auto t : tickers)
+        delete t;
+    while (!eventq.empty())
+        eventq.deschedule(eventq.getHead());
+
+    return Result{ chrono::duration<double>(end - start).count(), events,
+                   orderHash };
+}
+
+} // anonymous namespace
+
+int
+main()
+{
+    bool identical = true;
+
+    cprintf("%8s %12s %14s %14s %8s\n", "objects", "events",
+            "list (ev/s)", "calendar (ev/s)", "speedup");
+
+    for (unsigned objects : { 16, 128, 1024, 4096 }) {
+        // Keep the number of serviced events roughly constant
+        const Tick duration = 500000000ULL / objects;
+
+        Result list = run(EventQueue::Backend::LinkedList, objects,
+                          duration);
+        Result cal = run(EventQueue::Backend::Calendar, objects, duration);
+
+        cprintf("%8d %12d %14d %14d %8.2f\n", objects, list.events,
+                (uint64_t)(list.events / list.seconds),
+                (uint64_t)(cal.events / cal.seconds),
+                list.seconds / cal.seconds);
+
+        if (list.events != cal.events || list.hash != cal.hash) {
+            cprintf("backends serviced events in a different order!\n");
+            identical = false;
+        }
+    }
+
+    return identical ? 0 : 1;
+}
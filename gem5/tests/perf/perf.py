@@ -0,0 +1,287 @@
+#!/usr/bin/env python2.7
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+'''
+Simulator performance suite.
+
+Runs a set of canonical configurations and reports how fast gem5
+itself simulates them: the host seconds, the simulated instruction
+rate, the event rate and the peak resident set size of each run.
+The results are compared with stored baselines, and the suite fails
+if any benchmark regressed by more than a threshold.
+
+The baselines are specific to a host, so none are shipped. Record
+them on the reference host with --update-baselines, and compare
+later revisions on the same host:
+
+    tests/perf/perf.py --update-baselines
+    tests/perf/perf.py --threshold 5
+
+Each benchmark runs the binary of its own build (e.g.
+build/X86/gem5.opt). Benchmarks whose binary or inputs are missing
+are skipped. The full-system boot looks up its kernel and disk image
+in $M5_PATH, as the full-system regressions do.
+'''
+
+from __future__ import print_function
+
+import argparse
+import collections
+import json
+import os
+import subprocess
+import sys
+import time
+
+try:
+    from urllib.request import urlretrieve
+except ImportError:
+    from urllib import urlretrieve
+
+base_dir = os.path.dirname(os.path.abspath(__file__))
+gem5_root = os.path.abspath(os.path.join(base_dir, os.pardir, os.pardir))
+
+bin_url = 'http://gem5.org/dist/current/gem5/cpu_tests/benchmarks/bin/'
+float_mm = os.path.join(base_dir, 'bin', 'x86', 'FloatMM')
+
+Benchmark = collections.namedtuple('Benchmark',
+    ['name', 'build', 'config', 'args', 'inputs'])
+
+def _se(cpu_type, *args):
+    return ['--cpu-type=' + cpu_type, '--cmd=' + float_mm] + list(args)
+
+def _fs_inputs():
+    paths = os.environ.get('M5_PATH', '/dist/m5/system').split(':')
+    def find(subdir, name):
+        for path in paths:
+            candidate = os.path.join(path, subdir, name)
+            if os.path.exists(candidate):
+                return candidate
+        return os.path.join(paths[0], subdir, name)
+    return (find('binaries', 'x86_64-vmlinux-2.6.22.9'),
+            find('disks', 'linux-x86.img'))
+
+_kernel, _disk = _fs_inputs()
+
+benchmarks = (
+    Benchmark('se-atomic', 'X86', 'configs/example/se.py',
+              _se('AtomicSimpleCPU'), (float_mm,)),
+    Benchmark('se-o3', 'X86', 'configs/example/se.py',
+              _se('DerivO3CPU', '--caches', '--l2cache'), (float_mm,)),
+    Benchmark('fs-boot-8core', 'X86', 'configs/example/fs.py',
+              ['--cpu-type=TimingSimpleCPU', '--num-cpus=8',
+               '--caches', '--l2cache',
+               '--kernel=' + _kernel, '--disk-image=' + _disk,
+               '--script=' + os.path.join(gem5_root, 'tests', 'halt.sh')],
+              (_kernel, _disk)),
+    Benchmark('ruby-mesi-16core', 'X86_MESI_Two_Level',
+              'configs/example/se.py',
+              ['--cpu-type=TimingSimpleCPU', '--num-cpus=16', '--ruby',
+               '--cmd=' + ';'.join([float_mm] * 16)], (float_mm,)),
+    Benchmark('garnet-mesh', 'Garnet_standalone',
+              'configs/example/garnet_synth_traffic.py',
+              ['--network=garnet2.0', '--topology=Mesh_XY',
+               '--num-cpus=64', '--num-dirs=64', '--mesh-rows=8',
+               '--synthetic=uniform_random', '--injectionrate=0.1',
+               '--sim-cycles=200000'], ()),
+    Benchmark('tgen-dram-sweep', 'NULL', 'configs/dram/sweep.py',
+              ['--mode=DRAM'], ()),
+)
+
+# Metric name, description, True if higher is better
+metrics = (
+    ('host_seconds', 'host seconds', False),
+    ('mips', 'simulated MIPS', True),
+    ('events_per_second', 'events/s', True),
+    ('peak_rss_mb', 'peak RSS (MB)', False),
+)
+
+def fetch_inputs():
+    '''Download the SE workload, if not done yet.'''
+    if os.path.exists(float_mm):
+        return
+    try:
+        if not os.path.isdir(os.path.dirname(float_mm)):
+            os.makedirs(os.path.dirname(float_mm))
+        print('Downloading', bin_url + 'x86/FloatMM')
+        urlretrieve(bin_url + 'x86/FloatMM', float_mm)
+        os.chmod(float_mm, 0o755)
+    except (IOError, OSError) as e:
+        print('Failed to download FloatMM:', e)
+        if os.path.exists(float_mm):
+            os.remove(float_mm)
+
+def parse_stats(path):
+    '''Get the values of the last stats dump of a run.'''
+    stats = {}
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            if len(fields) >= 2 and not line.startswith('-'):
+                try:
+                    stats[fields[0]] = float(fields[1])
+                except ValueError:
+                    pass
+    return stats
+
+def run(bench, binary, outdir):
+    '''Run a benchmark once, and measure it.'''
+    cmd = [binary, '-d', outdir, os.path.join(gem5_root, bench.config)] + \
+        bench.args
+
+    with open(os.path.join(outdir, 'simout'), 'w') as log:
+        start = time.time()
+        proc = subprocess.Popen(cmd, stdout=log, stderr=subprocess.STDOUT,
+                                cwd=gem5_root)
+        # wait4 gives the resource usage of this very child
+        _, status, usage = os.wait4(proc.pid, 0)
+        host_seconds = time.time() - start
+        proc.returncode = os.WEXITSTATUS(status)
+
+    if status != 0:
+        raise RuntimeError('%s failed, see %s' % (bench.name, outdir))
+
+    stats = parse_stats(os.path.join(outdir, 'stats.txt'))
+    insts = stats.get('sim_insts', 0)
+    events = stats.get('sim_events', 0)
+    return {
+        'host_seconds': host_seconds,
+        'mips': insts / host_seconds / 1e6 if insts else None,
+        'events_per_second': events / host_seconds if events else None,
+        # ru_maxrss is in kB on Linux
+        'peak_rss_mb': usage.ru_maxrss / 1024.0,
+    }
+
+def compare(name, result, baseline, threshold):
+    '''Print a benchmark result, and return the regressed metrics.'''
+    regressed = []
+    print(name)
+    for metric, desc, higher_better in metrics:
+        value = result.get(metric)
+        if value is None:
+            continue
+        base = baseline.get(metric) if baseline else None
+        if base:
+            change = (value - base) / base * 100
+            worse = -change if higher_better else change
+            flag = ' REGRESSION' if worse > threshold else ''
+            if flag:
+                regressed.append(metric)
+            print('  %-18s %14.2f  baseline %14.2f  %+7.1f%%%s' %
+                  (desc, value, base, change, flag))
+        else:
+            print('  %-18s %14.2f  no baseline' % (desc, value))
+    return regressed
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('benchmarks', nargs='*',
+                        help='benchmarks to run (default: all)')
+    parser.add_argument('--list', action='store_true',
+                        help='list the benchmarks and exit')
+    parser.add_argument('--build-dir',
+                        default=os.path.join(gem5_root, 'build'),
+                        help='directory holding the gem5 builds')
+    parser.add_argument('--variant', default='opt',
+                        help='binary variant to run (default: %(default)s)')
+    parser.add_argument('--outdir',
+                        default=os.path.join(gem5_root, 'perf-out'),
+                        help='directory for the outputs of the runs')
+    parser.add_argument('--baselines',
+                        default=os.path.join(base_dir, 'baselines.json'),
+                        help='file holding the baselines')
+    parser.add_argument('--update-baselines', action='store_true',
+                        help='store the results as the new baselines')
+    parser.add_argument('--threshold', type=float, default=10.0,
+                        help='regression threshold in percent '
+                             '(default: %(default)s)')
+    parser.add_argument('--repeat', type=int, default=1,
+                        help='runs of each benchmark, the fastest one is '
+                             'kept (default: %(default)s)')
+    args = parser.parse_args()
+
+    if args.list:
+        for bench in benchmarks:
+            print('%-18s %s %s' % (bench.name, bench.build, bench.config))
+        return 0
+
+    selected = [b for b in benchmarks
+                if not args.benchmarks or b.name in args.benchmarks]
+    unknown = set(args.benchmarks) - set(b.name for b in benchmarks)
+    if unknown:
+        parser.error('unknown benchmarks: ' + ', '.join(sorted(unknown)))
+
+    baselines = {}
+    if os.path.exists(args.baselines):
+        with open(args.baselines) as f:
+            baselines = json.load(f)
+
+    results = {}
+    regressions = []
+    for bench in selected:
+        binary = os.path.join(args.build_dir, bench.build,
+                              'gem5.' + args.variant)
+        if os.path.exists(binary) and float_mm in bench.inputs:
+            fetch_inputs()
+        missing = [p for p in (binary,) + tuple(bench.inputs)
+                   if not os.path.exists(p)]
+        if missing:
+            print('%s skipped, missing %s' % (bench.name, ', '.join(missing)))
+            continue
+
+        best = None
+        for i in range(args.repeat):
+            outdir = os.path.join(args.outdir, bench.name, str(i))
+            if not os.path.isdir(outdir):
+                os.makedirs(outdir)
+            result = run(bench, binary, outdir)
+            if best is None or result['host_seconds'] < best['host_seconds']:
+                best = result
+
+        results[bench.name] = best
+        regressed = compare(bench.name, best, baselines.get(bench.name),
+                            args.threshold)
+        regressions += ['%s %s' % (bench.name, m) for m in regressed]
+
+    if args.update_baselines:
+        baselines.update(results)
+        with open(args.baselines, 'w') as f:
+            json.dump(baselines, f, indent=4, sort_keys=True)
+        print('Baselines stored in', args.baselines)
+        return 0
+
+    if regressions:
+        print('Regressed by more than %.1f%%: %s' %
+              (args.threshold, ', '.join(regressions)))
+        return 1
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,86 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Convert a binary SimPoint BBV profile to the text format.
+
+The SimPoint probe writes the binary format when its binary_format
+parameter is set (see cpu/simple/probes/simpoint.hh for the layout).
+The text output can be fed to SimPoint 3.2.
+
+Usage: bbv_to_text.py simpoint.bb.gz [simpoint.bb.txt]
+"""
+
+from __future__ import print_function
+
+import gzip
+import sys
+
+def read_varint(data, pos):
+    val = 0
+    shift = 0
+    while True:
+        byte = data[pos]
+        pos += 1
+        val |= (byte & 0x7f) << shift
+        if not byte & 0x80:
+            return val, pos
+        shift += 7
+
+def convert(data, out):
+    if data[:4] != bytearray(b"BBV1"):
+        raise ValueError("not a binary BBV profile")
+    pos = 4
+    while pos < len(data):
+        num_blocks, pos = read_varint(data, pos)
+        block_id = 0
+        out.write("T")
+        for i in range(num_blocks):
+            delta, pos = read_varint(data, pos)
+            count, pos = read_varint(data, pos)
+            block_id += delta
+            out.write(":%d:%d " % (block_id, count))
+        out.write("\n")
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print(__doc__, file=sys.stderr)
+        sys.exit(1)
+
+    opener = gzip.open if sys.argv[1].endswith(".gz") else open
+    with opener(sys.argv[1], "rb") as f:
+        data = bytearray(f.read())
+
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "w") as out:
+            convert(data, out)
+    else:
+        convert(data, sys.stdout)
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,151 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Export a binary checkpoint (src/sim/serialize_binary.hh) to the INI
+text format, e.g., to update it with util/cpt_upgrader.py. gem5
+restores checkpoints in either format.
+
+Usage:
+    cpt_export.py <m5.cpt or checkpoint directory> [output file]
+
+The text checkpoint is written to stdout if no output file is given.
+"""
+
+from __future__ import print_function
+
+import os.path as osp
+import struct
+import sys
+
+MAGIC = b"GCPT"
+VERSION = 1
+
+STRING, SIGNED, UNSIGNED, FLOAT, BOOL = range(5)
+
+INT_FORMATS = { 1 : "b", 2 : "h", 4 : "i", 8 : "q" }
+FLOAT_FORMATS = { 4 : "f", 8 : "d" }
+
+class FormatError(Exception):
+    pass
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+    def take(self, size):
+        if self.pos + size > len(self.data):
+            raise FormatError("Truncated checkpoint file")
+        data = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return data
+
+    def unpack(self, fmt):
+        return struct.unpack(fmt, self.take(struct.calcsize(fmt)))
+
+    def string(self):
+        size = self.unpack("<I")[0]
+        return self.take(size).decode("utf-8")
+
+def _format(kind, value):
+    if kind == BOOL:
+        return "true" if value else "false"
+    elif kind == FLOAT:
+        return repr(value)
+    else:
+        return str(value)
+
+def _values(kind, size, count, data):
+    """Format the values of an entry as in a text checkpoint"""
+    if kind == STRING:
+        reader = Reader(data)
+        return [ reader.string() for _ in range(count) ]
+
+    if kind == FLOAT:
+        fmt = FLOAT_FORMATS.get(size)
+    elif kind == BOOL:
+        fmt = "B"
+    elif kind == SIGNED:
+        fmt = INT_FORMATS.get(size)
+    elif kind == UNSIGNED:
+        fmt = INT_FORMATS.get(size, "").upper()
+    else:
+        raise FormatError("Unknown kind of value %d" % kind)
+
+    if not fmt:
+        raise FormatError("Unsupported value size %d" % size)
+
+    return [ _format(kind, v) for v in \
+             struct.unpack("<%d%s" % (count, fmt), data) ]
+
+def export(filename, out):
+    """Write a binary checkpoint as text to the file object out."""
+    with open(filename, "rb") as f:
+        reader = Reader(f.read())
+
+    if reader.take(4) != MAGIC:
+        raise FormatError("%s isn't a binary checkpoint" % filename)
+    version = reader.unpack("<I")[0]
+    if version != VERSION:
+        raise FormatError("Unsupported checkpoint version %d" % version)
+
+    out.write("## checkpoint exported from %s\n" % filename)
+    while not reader.done():
+        tag = reader.take(1)
+        if tag == b"S":
+            out.write("\n[%s]\n" % reader.string())
+        elif tag == b"E":
+            name = reader.string()
+            kind, size, count, num_bytes = reader.unpack("<BBIQ")
+            values = _values(kind, size, count, reader.take(num_bytes))
+            out.write("%s=%s\n" % (name, " ".join(values)))
+        else:
+            raise FormatError("Unknown record %r" % tag)
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print("Usage: %s <m5.cpt or checkpoint directory> [output file]" % \
+              sys.argv[0])
+        sys.exit(1)
+
+    path = sys.argv[1]
+    if osp.isdir(path):
+        path = osp.join(path, "m5.cpt")
+
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "w") as out:
+            export(path, out)
+    else:
+        export(path, sys.stdout)
+
+if __name__ == "__main__":
+    main()
@@ -195,6 +195,12 @@ def process_file(path, **kwargs):
         import shutil
         shutil.copyfile(path, path + '.bak')
 
+    with open(path, 'rb') as cpt_file:
+        if cpt_file.read(4) == 'GCPT':
+            print "Error: %s is a binary checkpoint," % path,
+            print "export it with util/cpt_export.py first"
+            sys.exit(1)
+
     cpt = ConfigParser.SafeConfigParser()
 
     # gem5 is case sensitive with paramaters
@@ -0,0 +1,248 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Format the binary debug traces written by the binary debug logger
+(src/base/binary_logger.hh), which is used when --debug-file ends with
+.bin or .bin.gz.
+
+The output matches the text trace, except for the order of messages
+logged by different threads of a multi-threaded simulation, which can
+be sorted by tick with --sort.
+
+Usage:
+    decode_debug_trace.py [--sort] <trace file> [output file]
+"""
+
+from __future__ import print_function
+
+import gzip
+import re
+import struct
+import sys
+
+MAGIC = b"GDTB"
+VERSION = 1
+MAX_TICK = 2**64 - 1
+
+class FormatError(Exception):
+    pass
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+    def unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise FormatError("Truncated debug trace")
+        vals = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return vals
+
+    def u32(self):
+        return self.unpack("<I")[0]
+
+    def bytes(self, size):
+        if self.pos + size > len(self.data):
+            raise FormatError("Truncated debug trace")
+        b = self.data[self.pos:self.pos + size]
+        self.pos += size
+        return b
+
+    def string(self):
+        return self.bytes(self.u32()).decode("utf-8", "replace")
+
+def _decode_args(data):
+    """Decode the arguments of a message, encoded as in Trace::RawArgs
+    (src/base/trace_args.hh)."""
+    reader = Reader(data)
+    args = []
+    while not reader.done():
+        tag = reader.unpack("<c")[0]
+        if tag == b"i":
+            args.append(reader.unpack("<q")[0])
+        elif tag in (b"u", b"p"):
+            args.append(reader.unpack("<Q")[0])
+        elif tag == b"f":
+            args.append(reader.unpack("<d")[0])
+        elif tag == b"c":
+            args.append(reader.bytes(1).decode("latin-1"))
+        elif tag == b"s":
+            args.append(reader.string())
+        else:
+            raise FormatError("Unknown argument type %r" % tag)
+    return args
+
+# A conversion as parsed by cprintf: flags, width, precision, length
+# modifiers and the conversion character.
+_conversion = re.compile(r"%([-+ #0]*)(\*|\d+)?(?:\.(\*|\d*))?[hlLqjzt]*(.)")
+
+def _format_one(flags, width, precision, conv, arg):
+    if conv == "p":
+        conv, flags = "x", flags + "#"
+    if conv in "diu":
+        conv = "d"
+
+    if conv in "dxXo":
+        if isinstance(arg, str):
+            arg = ord(arg) if len(arg) == 1 else arg
+        if isinstance(arg, float):
+            arg = int(arg)
+        if precision is not None:
+            # cprintf treats a precision on an integer as a zero filled
+            # width
+            width, precision, flags = precision, None, flags + "0"
+    elif conv == "c":
+        if not isinstance(arg, str):
+            arg = chr(arg & 0xff)
+    else:
+        conv = "s"
+        if isinstance(arg, float):
+            arg = "%g" % arg
+
+    if isinstance(arg, str) and conv not in "sc":
+        conv = "s"
+
+    spec = "%" + flags
+    if width is not None:
+        spec += str(width)
+    if precision is not None and conv != "s":
+        spec += "." + str(precision)
+    return (spec + conv) % arg
+
+def cprintf(fmt, args):
+    """Format a message like cprintf, the way the text trace would."""
+    out = []
+    args = list(args)
+    pos = 0
+    while True:
+        idx = fmt.find("%", pos)
+        if idx < 0:
+            out.append(fmt[pos:])
+            break
+        out.append(fmt[pos:idx])
+        if fmt.startswith("%%", idx):
+            out.append("%")
+            pos = idx + 2
+            continue
+
+        m = _conversion.match(fmt, idx)
+        if not m:
+            out.append(fmt[idx:])
+            break
+        pos = m.end()
+        flags, width, precision, conv = m.groups()
+
+        if width == "*":
+            width = args.pop(0) if args else None
+        if precision == "*":
+            precision = args.pop(0) if args else None
+        elif precision == "":
+            precision = 0
+        elif precision is not None:
+            precision = int(precision)
+
+        if not args:
+            out.append("<missing arg for format>")
+            continue
+        out.append(_format_one(flags, width, precision, conv, args.pop(0)))
+
+    if args:
+        out.append("<extra arg>")
+    return "".join(out)
+
+def read_messages(filename):
+    """Iterate over the messages of a binary debug trace as (tick, name,
+    message) tuples. The tick is None for messages without one."""
+    opener = gzip.open if filename.endswith(".gz") else open
+    with opener(filename, "rb") as f:
+        reader = Reader(f.read())
+
+    if reader.unpack("<4s")[0] != MAGIC:
+        raise FormatError("%s isn't a binary debug trace" % filename)
+    version = reader.u32()
+    if version != VERSION:
+        raise FormatError("Unsupported debug trace version %d" % version)
+
+    formats = {}
+    names = { 0: "" }
+    while not reader.done():
+        tag = reader.unpack("<c")[0]
+        if tag == b"F":
+            idx = reader.u32()
+            formats[idx] = reader.string()
+        elif tag == b"N":
+            idx = reader.u32()
+            names[idx] = reader.string()
+        elif tag == b"R":
+            tick, fmt_id, name_id, size = reader.unpack("<QIIH")
+            if fmt_id not in formats or name_id not in names:
+                raise FormatError("Message before its definitions")
+            args = _decode_args(reader.bytes(size))
+            yield (None if tick == MAX_TICK else tick, names[name_id],
+                   cprintf(formats[fmt_id], args))
+        else:
+            raise FormatError("Unknown record %r" % tag)
+
+def write_text(filename, out, sort=False):
+    """Write a binary debug trace in the format of the text trace."""
+    messages = read_messages(filename)
+    if sort:
+        messages = sorted(messages,
+                          key=lambda m: -1 if m[0] is None else m[0])
+
+    for tick, name, message in messages:
+        if tick is not None:
+            out.write("%7d: " % tick)
+        if name:
+            out.write("%s: " % name)
+        out.write(message)
+
+def main():
+    argv = sys.argv[1:]
+    sort = "--sort" in argv
+    if sort:
+        argv.remove("--sort")
+
+    if len(argv) not in (1, 2):
+        print("Usage: %s [--sort] <trace file> [output file]" % sys.argv[0])
+        sys.exit(1)
+
+    if len(argv) == 2:
+        with open(argv[1], "w") as out:
+            write_text(argv[0], out, sort)
+    else:
+        write_text(argv[0], sys.stdout, sort)
+
+if __name__ == "__main__":
+    main()
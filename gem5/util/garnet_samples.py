@@ -0,0 +1,223 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Read the link and router activity time series written by Garnet.
+
+The network writes the file when GarnetNetwork.sample_interval is set
+(see GarnetNetwork::writeSampleHeader() for the layout). This script
+lists the busiest links and routers, and can render heatmaps of the
+link utilization over time and of the router activity over the mesh.
+
+Usage: garnet_samples.py [--top N] [--plot-links FILE]
+                         [--plot-routers FILE] samples.bin
+"""
+
+from __future__ import print_function
+
+import argparse
+import array
+import struct
+import sys
+
+MAGIC = b"GARNETTS"
+VERSION = 1
+LINK_TYPES = [ "ext_in", "ext_out", "int" ]
+
+class Samples(object):
+    """Samples of a Garnet network.
+
+    ticks[s] is the tick of sample s, link_flits[s][l] the flits sent
+    over link l during the interval ending at sample s,
+    crossbar[s][r] the crossbar traversals of router r during the
+    interval, and buffered[s][r] the flits buffered in router r at
+    sample time.
+    """
+
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            data = f.read()
+
+        if data[:len(MAGIC)] != MAGIC:
+            raise ValueError("%s is not a Garnet sample file" % path)
+        offset = len(MAGIC)
+
+        def unpack(fmt):
+            values = struct.unpack_from(fmt, data, offset)
+            return values, offset + struct.calcsize(fmt)
+
+        (version, self.interval, self.num_rows, self.num_routers,
+         num_links), offset = unpack("=IQiII")
+        if version != VERSION:
+            raise ValueError("Unsupported sample file version %d" % version)
+
+        self.links = []
+        for i in range(num_links):
+            (kind, src, dst), offset = unpack("=Iii")
+            self.links.append((LINK_TYPES[kind], src, dst))
+
+        if array.array("I").itemsize != 4:
+            raise RuntimeError("Need a 4-byte unsigned array type")
+
+        words = num_links + 2 * self.num_routers
+        record = 8 + 4 * words
+        num_samples = (len(data) - offset) // record
+
+        self.ticks = []
+        self.link_flits = []
+        self.crossbar = []
+        self.buffered = []
+        for s in range(num_samples):
+            start = offset + s * record
+            self.ticks.append(struct.unpack_from("=Q", data, start)[0])
+            values = array.array("I")
+            chunk = data[start + 8:start + record]
+            if hasattr(values, "frombytes"):
+                values.frombytes(chunk)
+            else:
+                values.fromstring(chunk)
+            self.link_flits.append(values[:num_links])
+            routers = values[num_links:]
+            self.crossbar.append(routers[0::2])
+            self.buffered.append(routers[1::2])
+
+    def linkName(self, index):
+        kind, src, dst = self.links[index]
+        if kind == "ext_in":
+            return "ni%d->r%d" % (src, dst)
+        if kind == "ext_out":
+            return "r%d->ni%d" % (src, dst)
+        return "r%d->r%d" % (src, dst)
+
+    def linkTotals(self):
+        return [ sum(s[l] for s in self.link_flits)
+                 for l in range(len(self.links)) ]
+
+    def routerTotals(self):
+        return [ sum(s[r] for s in self.crossbar)
+                 for r in range(self.num_routers) ]
+
+def report(samples, top):
+    ticks = samples.ticks
+    if not ticks:
+        print("No samples")
+        return
+
+    span = len(ticks)
+    print("%d samples, interval %d ticks, %d routers, %d links" %
+          (span, samples.interval, samples.num_routers, len(samples.links)))
+
+    # Utilization in flits per sample interval, averaged and at the peak
+    links = samples.linkTotals()
+    print("\nBusiest links (flits per interval: mean, peak)")
+    for l in sorted(range(len(links)), key=lambda l: -links[l])[:top]:
+        peak = max(s[l] for s in samples.link_flits)
+        print("  %-16s %10.2f %8d" %
+              (samples.linkName(l), float(links[l]) / span, peak))
+
+    routers = samples.routerTotals()
+    print("\nBusiest routers (crossbar traversals per interval, "
+          "peak buffered flits)")
+    for r in sorted(range(len(routers)), key=lambda r: -routers[r])[:top]:
+        peak = max(s[r] for s in samples.buffered)
+        print("  r%-15d %10.2f %8d" % (r, float(routers[r]) / span, peak))
+
+def pyplot():
+    try:
+        import matplotlib
+        matplotlib.use("Agg")
+        import matplotlib.pyplot as plt
+        return plt
+    except ImportError:
+        print("Failed to import matplotlib", file=sys.stderr)
+        sys.exit(1)
+
+def plotLinks(samples, path):
+    """Heatmap of the flits per interval of each link over time."""
+    plt = pyplot()
+    matrix = [ [ s[l] for s in samples.link_flits ]
+               for l in range(len(samples.links)) ]
+
+    fig, ax = plt.subplots(figsize=(12, max(4, len(matrix) * 0.12)))
+    image = ax.imshow(matrix, aspect="auto", interpolation="nearest",
+                      cmap="hot")
+    ax.set_xlabel("Sample (%d ticks each)" % samples.interval)
+    ax.set_ylabel("Link")
+    if len(matrix) <= 64:
+        ax.set_yticks(range(len(matrix)))
+        ax.set_yticklabels([ samples.linkName(l)
+                             for l in range(len(matrix)) ], fontsize=6)
+    fig.colorbar(image, ax=ax, label="Flits per interval")
+    fig.savefig(path, bbox_inches="tight")
+
+def plotRouters(samples, path):
+    """Heatmap of the crossbar traversals of the routers of a mesh."""
+    plt = pyplot()
+    rows = samples.num_rows
+    if rows <= 0 or samples.num_routers % rows:
+        rows = 1
+    cols = samples.num_routers // rows
+
+    span = max(len(samples.ticks), 1)
+    totals = samples.routerTotals()
+    grid = [ [ float(totals[r * cols + c]) / span for c in range(cols) ]
+             for r in range(rows) ]
+
+    fig, ax = plt.subplots()
+    image = ax.imshow(grid, interpolation="nearest", cmap="hot",
+                      origin="lower")
+    ax.set_xlabel("Column")
+    ax.set_ylabel("Row")
+    for r in range(rows):
+        for c in range(cols):
+            ax.text(c, r, str(r * cols + c), ha="center", va="center",
+                    color="cyan", fontsize=6)
+    fig.colorbar(image, ax=ax, label="Crossbar traversals per interval")
+    fig.savefig(path, bbox_inches="tight")
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="Summarize and plot Garnet activity samples")
+    parser.add_argument("samples", help="sample file (garnet_samples.bin)")
+    parser.add_argument("--top", type=int, default=10,
+                        help="number of links and routers to list")
+    parser.add_argument("--plot-links", metavar="FILE",
+                        help="write a link utilization heatmap to FILE")
+    parser.add_argument("--plot-routers", metavar="FILE",
+                        help="write a router activity heatmap to FILE")
+    args = parser.parse_args()
+
+    samples = Samples(args.samples)
+    report(samples, args.top)
+    if args.plot_links:
+        plotLinks(samples, args.plot_links)
+    if args.plot_routers:
+        plotRouters(samples, args.plot_routers)
+
+if __name__ == "__main__":
+    main()
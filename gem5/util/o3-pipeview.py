@@ -44,6 +44,8 @@ import os
 import sys
 import copy
 
+import protolib
+
 # Temporary storage for instructions. The queue is filled in out-of-order
 # until it reaches 'max_threshold' number of instructions. It is then
 # sorted out and instructions are printed out until their number drops to
@@ -106,22 +108,7 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
         if not line: return
         fields = line.split(':')
 
-    # Print header
-    outfile.write('// f = fetch, d = decode, n = rename, p = dispatch, '
-                  'i = issue, c = complete, r = retire')
-
-    if store_completions:
-        outfile.write(', s = store-complete')
-    outfile.write('\n\n')
-
-    outfile.write(' ' + 'timeline'.center(width) +
-                  '   ' + 'tick'.center(15) +
-                  '  ' + 'pc.upc'.center(12) +
-                  '  ' + 'disasm'.ljust(25) +
-                  '  ' + 'seq_num'.center(10))
-    if timestamps:
-        outfile.write('timestamps'.center(25))
-    outfile.write('\n')
+    print_header(outfile, width, timestamps, store_completions)
 
     # Region of interest
     curr_inst = {}
@@ -150,6 +137,103 @@ def process_trace(trace, outfile, cycle_time, width, color, timestamps,
         fields = line.split(':')
 
 
+def process_proto_trace(trace, outfile, cycle_time, width, color, timestamps,
+                        committed_only, store_completions, start_tick,
+                        stop_tick, start_sn, stop_sn):
+    """Process a binary trace written by the pipeTraceFile of the CPU."""
+    o3_pipe_trace_pb2 = import_proto()
+
+    global insts
+
+    header = o3_pipe_trace_pb2.O3PipeHeader()
+    protolib.decodeMessage(trace, header)
+    if header.ver != 0:
+        print "Warning: file version newer than decoder:", header.ver
+    if cycle_time is None:
+        cycle_time = header.clock_period
+
+    insts['sn_start'] = start_sn
+    insts['sn_stop'] = stop_sn
+    insts['tick_start'] = start_tick
+    insts['tick_stop'] = stop_tick
+    insts['tick_drift'] = insts['tick_drift'] * cycle_time
+    insts['only_committed'] = committed_only
+
+    print_header(outfile, width, timestamps, store_completions)
+
+    # The disassembly is only in the first record of each pc/upc
+    disasm = {}
+    stages = ('decode', 'rename', 'dispatch', 'issue', 'complete', 'store')
+    rec = o3_pipe_trace_pb2.O3PipeRecord()
+    while protolib.decodeMessage(trace, rec):
+        if ((stop_tick > 0 and rec.fetch > stop_tick + insts['tick_drift']) or
+            (stop_sn > 0 and rec.seq_num > stop_sn + insts['max_threshold'])):
+            break
+
+        key = (rec.pc, rec.upc)
+        if rec.HasField('disasm'):
+            disasm[key] = ' '.join(rec.disasm.split())
+
+        inst = { 'fetch': rec.fetch,
+                 'pc': '0x%08x' % rec.pc,
+                 'upc': str(rec.upc),
+                 'sn': rec.seq_num,
+                 'disasm': disasm.get(key, '') }
+        # Stages the instruction didn't reach are printed as 0
+        for stage in stages:
+            inst[stage] = (rec.fetch + getattr(rec, stage)
+                           if rec.HasField(stage) else 0)
+        inst['retire'] = (rec.fetch + rec.commit
+                          if rec.HasField('commit') else 0)
+        if inst['retire'] == 0:
+            inst['disasm'] = '-----' + inst['disasm']
+
+        insts['queue'].append(inst)
+        if len(insts['queue']) > insts['max_threshold']:
+            print_insts(outfile, cycle_time, width, color, timestamps,
+                        store_completions, insts['min_threshold'])
+
+    print_insts(outfile, cycle_time, width, color, timestamps,
+                store_completions, 0)
+
+
+def import_proto():
+    try:
+        import o3_pipe_trace_pb2
+    except ImportError:
+        print "Did not find protobuf pipeline trace definitions, " \
+            "attempting to generate"
+        from subprocess import call
+        util_dir = os.path.dirname(os.path.abspath(__file__))
+        error = call(['protoc', '--python_out=' + util_dir,
+                      '--proto_path=' + os.path.join(util_dir, '..', 'src',
+                                                     'proto'),
+                      'o3_pipe_trace.proto'])
+        if error:
+            print "Failed to import pipeline trace proto definitions"
+            sys.exit(1)
+        import o3_pipe_trace_pb2
+    return o3_pipe_trace_pb2
+
+
+def print_header(outfile, width, timestamps, store_completions):
+    outfile.write('// f = fetch, d = decode, n = rename, p = dispatch, '
+                  'i = issue, c = complete, r = retire')
+
+    if store_completions:
+        outfile.write(', s = store-complete')
+    outfile.write('\n\n')
+
+    outfile.write(' ' + 'timeline'.center(width) +
+                  '   ' + 'tick'.center(15) +
+                  '  ' + 'pc.upc'.center(12) +
+                  '  ' + 'disasm'.ljust(25) +
+                  '  ' + 'seq_num'.center(10))
+    if timestamps:
+        outfile.write('timestamps'.center(25))
+    outfile.write('\n')
+
+
 #Sorts out instructions according to sequence number
 def compare_by_sn(a, b):
     return cmp(a['sn'], b['sn'])
@@ -333,8 +417,9 @@ def main():
         help="enable colored output (default: '%default')")
     parser.add_option(
         '-c', '--cycle-time',
-        type='int', default=1000,
-        help="CPU cycle time in ticks (default: '%default')")
+        type='int', default=None,
+        help="CPU cycle time in ticks (default: the clock period stored "
+        "in binary traces, 1000 otherwise)")
     parser.add_option(
         '--timestamps',
         action='store_true', default=False,
@@ -361,12 +446,22 @@ def main():
         sys.exit(1)
     # Process trace
     print 'Processing trace... ',
-    with open(args[0], 'r') as trace:
-        with open(options.outfile, 'w') as out:
-            process_trace(trace, out, options.cycle_time, options.width,
-                          options.color, options.timestamps,
+    # Binary traces start with the magic number of the protobuf streams
+    trace = protolib.openFileRd(args[0])
+    with open(options.outfile, 'w') as out:
+        if trace.read(4) == 'gem5':
+            process_proto_trace(trace, out, options.cycle_time,
+                                options.width, options.color,
+                                options.timestamps, options.only_committed,
+                                options.store_completions,
+                                *(tick_range + inst_range))
+        else:
+            trace.seek(0)
+            process_trace(trace, out, options.cycle_time or 1000,
+                          options.width, options.color, options.timestamps,
                           options.only_committed, options.store_completions,
                           *(tick_range + inst_range))
+    trace.close()
     print 'done!'
 
 
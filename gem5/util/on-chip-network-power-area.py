@@ -25,35 +25,146 @@
 # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 
-from ConfigParser import ConfigParser
-import string, sys, subprocess, os
-
-# Compile DSENT to generate the Python module and then import it.
-# This script assumes it is executed from the gem5 root.
-print("Attempting compilation")
-from subprocess import call
-
-src_dir = 'ext/dsent'
-build_dir = 'build/ext/dsent'
-
-if not os.path.exists(build_dir):
-    os.makedirs(build_dir)
-os.chdir(build_dir)
-
-error = call(['cmake', '../../../%s' % src_dir])
-if error:
-    print("Failed to run cmake")
-    exit(-1)
+# This script parses the config.ini and the stats.txt of one or more runs
+# and computes the power and the area of the on-chip network using DSENT.
+#
+# DSENT is run in-process. A router or link model only depends on its
+# parameters (ports, vcs, buffers, flit width, frequency, technology),
+# so each distinct configuration is built and evaluated once, and the
+# resulting energies per event are cached on disk to be reused by later
+# runs of a sweep. The dynamic power of each router and link is then
+# computed from the Garnet activity counters of the run.
 
-error = call(['make'])
-if error:
-    print("Failed to run make")
-    exit(-1)
+from __future__ import print_function
 
-print("Compiled dsent")
-os.chdir("../../../")
-sys.path.append("build/ext/dsent")
-import dsent
+from ConfigParser import ConfigParser
+import argparse, hashlib, json, os, sys
+
+# Energies (J), leakage (W) and area (m^2) queried from the router model
+ROUTER_EVALUATE = "; ".join([
+    'print "buffer_write_energy" $(Energy>>Router:WriteBuffer)',
+    'print "buffer_read_energy" $(Energy>>Router:ReadBuffer)',
+    'print "crossbar_energy" $(Energy>>Router:TraverseCrossbar->Multicast1)',
+    'print "sw_input_arbiter_energy" '
+    '$(Energy>>Router:ArbitrateSwitch->ArbitrateStage1)',
+    'print "sw_output_arbiter_energy" '
+    '$(Energy>>Router:ArbitrateSwitch->ArbitrateStage2)',
+    'print "clock_energy" $(Energy>>Router:DistributeClock)',
+    'print "leakage_power" $(NddPower>>Router:Leakage)',
+    'print "area" $(Area>>Router:Active)',
+    ]) + ";"
+
+# Energy (J) per flit, leakage (W) and area (m^2) of the link model
+LINK_EVALUATE = "; ".join([
+    'print "send_energy" $(Energy>>RepeatedLink:Send)',
+    'print "leakage_power" $(NddPower>>RepeatedLink:Leakage)',
+    'print "area" $(Area>>RepeatedLink:Active)',
+    ]) + ";"
+
+def importDsent(gem5_root):
+    """Import the DSENT module, compiling it first if needed."""
+    build_dir = os.path.join(gem5_root, 'build', 'ext', 'dsent')
+    sys.path.append(build_dir)
+    try:
+        import dsent
+        return dsent
+    except ImportError:
+        pass
+
+    from subprocess import call
+
+    print("Attempting compilation")
+    if not os.path.exists(build_dir):
+        os.makedirs(build_dir)
+    src_dir = os.path.join(gem5_root, 'ext', 'dsent')
+    if call(['cmake', src_dir], cwd=build_dir):
+        print("Failed to run cmake")
+        exit(-1)
+    if call(['make'], cwd=build_dir):
+        print("Failed to run make")
+        exit(-1)
+    print("Compiled dsent")
+
+    import dsent
+    return dsent
+
+class DsentCache(object):
+    """Memoized DSENT evaluations.
+
+    The results are keyed by the model (the DSENT config file and its
+    contents) and by the parameters that replace the ones of the file,
+    which include the technology model if it is overridden.
+    """
+
+    def __init__(self, dsent, path):
+        self.dsent = dsent
+        self.path = path
+        self.results = {}
+        self.digests = {}
+        self.evaluations = 0
+        if path and os.path.exists(path):
+            with open(path) as f:
+                self.results = json.load(f)
+
+    def save(self):
+        if not self.path:
+            return
+        with open(self.path, 'w') as f:
+            json.dump(self.results, f, indent=1, sort_keys=True)
+
+    def digest(self, config_file):
+        if config_file not in self.digests:
+            with open(config_file, 'rb') as f:
+                self.digests[config_file] = \
+                    hashlib.sha1(f.read()).hexdigest()
+        return self.digests[config_file]
+
+    def evaluate(self, config_file, overrides, run):
+        params = dict((k, str(v)) for k, v in overrides.items())
+        key = json.dumps([self.digest(config_file), sorted(params.items())])
+        if key not in self.results:
+            self.dsent.initialize(config_file, params)
+            outputs = run(self.dsent)
+            self.dsent.finalize()
+            self.results[key] = dict(outputs)
+            self.evaluations += 1
+        return self.results[key]
+
+    def router(self, config_file, tech, frequency, num_in_ports,
+               num_out_ports, num_vnets, vcs_per_vnet, buffers_per_vc,
+               flit_size_bits):
+        overrides = {
+            "Frequency" : frequency,
+            "NumberInputPorts" : num_in_ports,
+            "NumberOutputPorts" : num_out_ports,
+            "NumberVirtualNetworks" : num_vnets,
+            "NumberVirtualChannelsPerVirtualNetwork" :
+                "[%s]" % ", ".join([str(vcs_per_vnet)] * num_vnets),
+            "NumberBuffersPerVirtualChannel" :
+                "[%s]" % ", ".join([str(buffers_per_vc)] * num_vnets),
+            "NumberBitsPerFlit" : flit_size_bits,
+            "EvaluateString" : ROUTER_EVALUATE,
+        }
+        if tech:
+            overrides["ElectricalTechModelFilename"] = tech
+
+        run = lambda dsent: dsent.computeRouterPowerAndArea(
+            frequency, num_in_ports, num_out_ports, num_vnets,
+            vcs_per_vnet, buffers_per_vc, flit_size_bits)
+        return self.evaluate(config_file, overrides, run)
+
+    def link(self, config_file, tech, frequency, flit_size_bits):
+        overrides = {
+            "Frequency" : frequency,
+            "NumberBits" : flit_size_bits,
+            "Delay" : 1.0 / frequency,
+            "EvaluateString" : LINK_EVALUATE,
+        }
+        if tech:
+            overrides["ElectricalTechModelFilename"] = tech
+
+        run = lambda dsent: dsent.computeLinkPower(frequency)
+        return self.evaluate(config_file, overrides, run)
 
 # Parse gem5 config.ini file for the configuration parameters related to
 # the on-chip network.
@@ -67,151 +178,181 @@ def parseConfig(config_file):
         print("ERROR: Ruby network not found in '", config_file)
         sys.exit(1)
 
-    if config.get("system.ruby.network", "type") != "GarnetNetwork_d" :
+    if config.get("system.ruby.network", "type") != "GarnetNetwork":
         print("ERROR: Garnet network not used in '", config_file)
         sys.exit(1)
 
-    number_of_virtual_networks = config.getint("system.ruby.network",
-                                               "number_of_virtual_networks")
-    vcs_per_vnet = config.getint("system.ruby.network", "vcs_per_vnet")
-
-    buffers_per_data_vc = config.getint("system.ruby.network",
-                                        "buffers_per_data_vc")
-    buffers_per_control_vc = config.getint("system.ruby.network",
-                                           "buffers_per_ctrl_vc")
-
-    ni_flit_size_bits = 8 * config.getint("system.ruby.network",
-                                          "ni_flit_size")
-
-    routers = config.get("system.ruby.network", "routers").split()
-    int_links = config.get("system.ruby.network", "int_links").split()
-    ext_links = config.get("system.ruby.network", "ext_links").split()
+    return config
 
-    return (config, number_of_virtual_networks, vcs_per_vnet,
-            buffers_per_data_vc, buffers_per_control_vc, ni_flit_size_bits,
-            routers, int_links, ext_links)
+# Parse the first stats dump of a stats.txt file
+def parseStats(stats_file):
+    stats = {}
+    try:
+        with open(stats_file) as f:
+            for line in f:
+                if line.startswith("---------- End"):
+                    break
+                fields = line.split()
+                if len(fields) >= 2:
+                    try:
+                        stats[fields[0]] = float(fields[1])
+                    except ValueError:
+                        pass
+    except IOError:
+        print("Failed to open ", stats_file, " for reading")
+        exit(-1)
+    return stats
 
+# Clock frequency of a clocked object in Hz
+def getFrequency(obj, config, ticks_per_second):
+    return int(round(ticks_per_second / getPeriod(obj, config)))
 
-def getClock(obj, config):
+# Clock period of a clocked object in ticks
+def getPeriod(obj, config):
     if config.get(obj, "type") == "SrcClockDomain":
-        return config.getint(obj, "clock")
+        # The first clock of the domain, the others are DVFS levels
+        return int(config.get(obj, "clock").split()[0])
 
     if config.get(obj, "type") == "DerivedClockDomain":
         source = config.get(obj, "clk_domain")
         divider = config.getint(obj, "clk_divider")
-        return getClock(source, config)  / divider
+        return getPeriod(source, config) * divider
 
     source = config.get(obj, "clk_domain")
-    return getClock(source, config)
+    return getPeriod(source, config)
 
+def evaluateRun(sim_dir, cache, args):
+    config = parseConfig(os.path.join(sim_dir, "config.ini"))
+    stats = parseStats(os.path.join(sim_dir, "stats.txt"))
 
-## Compute the power consumed by the given router
-def computeRouterPowerAndArea(router, stats_file, config, int_links, ext_links,
-                              number_of_virtual_networks, vcs_per_vnet,
-                              buffers_per_data_vc, buffers_per_control_vc,
-                              ni_flit_size_bits):
-    frequency = getClock(router, config)
-    num_ports = 0
+    network = "system.ruby.network"
+    num_vnets = config.getint(network, "number_of_virtual_networks")
+    vcs_per_vnet = config.getint(network, "vcs_per_vnet")
+    # The config doesn't tell which vnets carry data, so size all the
+    # VCs like the data VCs
+    buffers_per_vc = config.getint(network, "buffers_per_data_vc")
+    flit_size_bits = 8 * config.getint(network, "ni_flit_size")
 
-    for int_link in int_links:
-        if config.get(int_link, "node_a") == router or \
-           config.get(int_link, "node_b") == router:
-           num_ports += 1
+    routers = config.get(network, "routers").split()
+    int_links = config.get(network, "int_links").split()
+    ext_links = config.get(network, "ext_links").split()
 
-    for ext_link in ext_links:
-        if config.get(ext_link, "int_node") == router:
-           num_ports += 1
+    ticks_per_second = stats["sim_freq"]
+    seconds = stats["sim_seconds"]
 
-    power = dsent.computeRouterPowerAndArea(frequency, num_ports, num_ports,
-                                            number_of_virtual_networks,
-                                            vcs_per_vnet, buffers_per_data_vc,
-                                            ni_flit_size_bits)
+    print("%s (%g s)" % (sim_dir, seconds))
 
-    print("%s Power: " % router, power)
-
-
-## Compute the power consumed by the given link
-def computeLinkPower(link, stats_file, config, sim_seconds):
-    frequency = getClock(link + ".nls0", config)
-    power = dsent.computeLinkPower(frequency)
-    print("%s.nls0 Power: " % link, power)
-
-    frequency = getClock(link + ".nls1", config)
-    power = dsent.computeLinkPower(frequency)
-    print("%s.nls1 Power: " % link, power)
-
-
-def parseStats(stats_file, config, router_config_file, link_config_file,
-               routers, int_links, ext_links, number_of_virtual_networks,
-               vcs_per_vnet, buffers_per_data_vc, buffers_per_control_vc,
-               ni_flit_size_bits):
-
-    # Open the stats.txt file and parse it to for the required numbers
-    # and the number of routers.
-    try:
-        stats_handle = open(stats_file, 'r')
-        stats_handle.close()
-    except IOError:
-        print("Failed to open ", stats_file, " for reading")
-        exit(-1)
-
-    # Now parse the stats
-    pattern = "sim_seconds"
-    lines = string.split(subprocess.check_output(
-                ["grep", pattern, stats_file]), '\n', -1)
-    assert len(lines) >= 1
-
-    ## Assume that the first line is the one required
-    [l1,l2,l3] = lines[0].partition(" ")
-    l4 = l3.strip().partition(" ")
-    simulation_length_in_seconds = float(l4[0])
-
-    # Initialize DSENT with a configuration file
-    dsent.initialize(router_config_file)
-
-    # Compute the power consumed by the routers
+    total_dynamic = total_leakage = total_area = 0.0
     for router in routers:
-        computeRouterPowerAndArea(router, stats_file, config, int_links,
-                                  ext_links, number_of_virtual_networks,
-                                  vcs_per_vnet, buffers_per_data_vc,
-                                  buffers_per_control_vc, ni_flit_size_bits)
-
-    # Finalize DSENT
-    dsent.finalize()
-
-    # Initialize DSENT with a configuration file
-    dsent.initialize(link_config_file)
-
-    # Compute the power consumed by the links
-    for link in int_links:
-        computeLinkPower(link, stats_file, config,
-                         simulation_length_in_seconds)
-    for link in ext_links:
-        computeLinkPower(link, stats_file, config,
-                         simulation_length_in_seconds)
-
-    # Finalize DSENT
-    dsent.finalize()
-
-# This script parses the config.ini and the stats.txt from a run and
-# generates the power and the area of the on-chip network using DSENT
+        num_in_ports = num_out_ports = 0
+        for link in int_links:
+            num_in_ports += config.get(link, "dst_node") == router
+            num_out_ports += config.get(link, "src_node") == router
+        for link in ext_links:
+            if config.get(link, "int_node") == router:
+                num_in_ports += 1
+                num_out_ports += 1
+
+        frequency = getFrequency(router, config, ticks_per_second)
+        model = cache.router(args.router_config, args.tech, frequency,
+                             num_in_ports, num_out_ports, num_vnets,
+                             vcs_per_vnet, buffers_per_vc, flit_size_bits)
+
+        activity = lambda name: stats.get("%s.%s" % (router, name), 0.0)
+        energy = (activity("buffer_writes") * model["buffer_write_energy"] +
+                  activity("buffer_reads") * model["buffer_read_energy"] +
+                  activity("crossbar_activity") * model["crossbar_energy"] +
+                  activity("sw_input_arbiter_activity") *
+                  model["sw_input_arbiter_energy"] +
+                  activity("sw_output_arbiter_activity") *
+                  model["sw_output_arbiter_energy"])
+        dynamic = energy / seconds + model["clock_energy"] * frequency
+
+        print("  %s: dynamic %g W, leakage %g W, area %g m^2" %
+              (router, dynamic, model["leakage_power"], model["area"]))
+        total_dynamic += dynamic
+        total_leakage += model["leakage_power"]
+        total_area += model["area"]
+
+    # The flits are only counted per link type, so the links of a type
+    # are assumed to share the same model
+    link_types = [
+        ("int", [ "%s.network_link" % l for l in int_links ],
+         "int_link_utilization"),
+        ("ext_in", [ "%s.network_links0" % l for l in ext_links ],
+         "ext_in_link_utilization"),
+        ("ext_out", [ "%s.network_links1" % l for l in ext_links ],
+         "ext_out_link_utilization"),
+    ]
+    for name, links, stat in link_types:
+        if not links:
+            continue
+
+        leakage = area = send_energy = 0.0
+        for link in links:
+            frequency = getFrequency(link, config, ticks_per_second)
+            model = cache.link(args.link_config, args.tech, frequency,
+                               flit_size_bits)
+            leakage += model["leakage_power"]
+            area += model["area"]
+            send_energy += model["send_energy"] / len(links)
+
+        flits = stats.get("%s.%s" % (network, stat), 0.0)
+        dynamic = flits * send_energy / seconds
+        print("  %s links: dynamic %g W, leakage %g W, area %g m^2" %
+              (name, dynamic, leakage, area))
+        total_dynamic += dynamic
+        total_leakage += leakage
+        total_area += area
+
+    print("  Total: dynamic %g W, leakage %g W, area %g m^2" %
+          (total_dynamic, total_leakage, total_area))
+
 def main():
-    if len(sys.argv) != 5:
-        print("Usage: ", sys.argv[0], " <gem5 root directory> " \
-              "<simulation directory> <router config file> <link config file>")
-        exit(-1)
+    parser = argparse.ArgumentParser(
+        description="Compute the power and area of the Garnet network of "
+        "one or more runs with DSENT")
+    parser.add_argument("gem5_root", help="gem5 root directory")
+    parser.add_argument("sim_dir", help="simulation directory")
+    parser.add_argument("router_config", help="DSENT router config file")
+    parser.add_argument("link_config", help="DSENT link config file")
+    parser.add_argument("more_sim_dirs", nargs="*", metavar="sim_dir",
+                        help="more simulation directories of a sweep")
+    parser.add_argument("--tech", help="DSENT electrical technology model "
+                        "replacing the one of the config files")
+    parser.add_argument("--cache", help="file memoizing the DSENT results "
+                        "across runs (default: build/ext/dsent/cache.json "
+                        "in the gem5 root)")
+    parser.add_argument("--no-cache", action="store_true",
+                        help="don't read or write the cache file")
+    args = parser.parse_args()
 
     print("WARNING: configuration files for DSENT and McPAT are separate. " \
           "Changes made to one are not reflected in the other.")
 
-    (config, number_of_virtual_networks, vcs_per_vnet, buffers_per_data_vc,
-     buffers_per_control_vc, ni_flit_size_bits, routers, int_links,
-     ext_links) = parseConfig("%s/%s/config.ini" % (sys.argv[1], sys.argv[2]))
-
-    parseStats("%s/%s/stats.txt" % (sys.argv[1], sys.argv[2]), config,
-               sys.argv[3], sys.argv[4], routers, int_links, ext_links,
-               number_of_virtual_networks, vcs_per_vnet, buffers_per_data_vc,
-               buffers_per_control_vc, ni_flit_size_bits)
+    # The config files name the technology models relative to the gem5
+    # root, so run DSENT from there
+    gem5_root = os.path.abspath(args.gem5_root)
+    sim_dirs = [ os.path.join(gem5_root, d)
+                 for d in [ args.sim_dir ] + args.more_sim_dirs ]
+    args.router_config = os.path.abspath(args.router_config)
+    args.link_config = os.path.abspath(args.link_config)
+    if args.cache is None:
+        args.cache = os.path.join(gem5_root, "build", "ext", "dsent",
+                                  "cache.json")
+    else:
+        args.cache = os.path.abspath(args.cache)
+
+    dsent = importDsent(gem5_root)
+    os.chdir(gem5_root)
+
+    cache = DsentCache(dsent, None if args.no_cache else args.cache)
+    for sim_dir in sim_dirs:
+        evaluateRun(sim_dir, cache, args)
+    cache.save()
+
+    print("%d DSENT evaluations, %d cached configurations" %
+          (cache.evaluations, len(cache.results)))
 
 if __name__ == "__main__":
     main()
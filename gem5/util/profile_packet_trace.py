@@ -0,0 +1,231 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Fit a statistical profile to a packet trace.
+
+The profile describes the trace in a few kB: the read/write mix, the
+request sizes, the inter-arrival times, the reuse (LRU stack) distance
+of the blocks accessed and the strides between blocks accessed for the
+first time. The PROFILE state of the traffic generator (see
+src/cpu/testers/traffic_gen/profile_gen.hh) synthesizes a stream with
+the same statistics on the fly, which saves shipping the trace around.
+
+Usage: profile_packet_trace.py <protobuf input> <profile output>
+           [block size] [max strides]
+"""
+
+from __future__ import print_function
+
+import os
+import protolib
+import subprocess
+import sys
+
+util_dir = os.path.dirname(os.path.realpath(__file__))
+# Make sure the proto definitions are up to date.
+subprocess.check_call(['make', '--quiet', '-C', util_dir, 'packet_pb2.py'])
+import packet_pb2
+
+# ReadReq is 1 and WriteReq is 4 in src/mem/packet.hh Command enum
+READ_REQ = 1
+WRITE_REQ = 4
+
+class Fenwick(object):
+    """Binary indexed tree counting the last access of every block,
+    indexed by the time of that access."""
+
+    def __init__(self, size):
+        self.tree = [0] * (size + 1)
+
+    def size(self):
+        return len(self.tree) - 1
+
+    def add(self, idx, val):
+        idx += 1
+        while idx < len(self.tree):
+            self.tree[idx] += val
+            idx += idx & -idx
+
+    def prefix(self, idx):
+        """Sum of the entries [0, idx)."""
+        total = 0
+        while idx > 0:
+            total += self.tree[idx]
+            idx -= idx & -idx
+        return total
+
+def log2_bin(val):
+    """Index of the power-of-two bin containing val: 0 holds 0, bin i
+    holds [2^(i-1), 2^i)."""
+    return val.bit_length()
+
+def bin_range(idx):
+    if idx == 0:
+        return 0, 1
+    return 1 << (idx - 1), 1 << idx
+
+class Profiler(object):
+    def __init__(self, block_size):
+        self.block_size = block_size
+        self.reads = 0
+        self.writes = 0
+        self.sizes = {}
+        self.itt = {}
+        self.reuse = {}
+        self.strides = {}
+        self.cold = 0
+        self.min_block = None
+        self.max_block = None
+
+        self.last_tick = None
+        self.last_cold = None
+        # Time of the last access to every block
+        self.last_access = {}
+        self.now = 0
+        self.accesses = Fenwick(1 << 16)
+
+    def grow(self):
+        """Double the size of the access tree, it is cheaper to rebuild
+        it once in a while than to size it for the whole trace."""
+        tree = Fenwick(2 * self.accesses.size())
+        for t in self.last_access.values():
+            tree.add(t, 1)
+        self.accesses = tree
+
+    def add(self, packet):
+        if packet.cmd == READ_REQ:
+            self.reads += 1
+        elif packet.cmd == WRITE_REQ:
+            self.writes += 1
+        else:
+            return
+
+        self.sizes[packet.size] = self.sizes.get(packet.size, 0) + 1
+
+        if self.last_tick is not None:
+            b = log2_bin(max(packet.tick - self.last_tick, 0))
+            self.itt[b] = self.itt.get(b, 0) + 1
+        self.last_tick = packet.tick
+
+        block = packet.addr // self.block_size
+        if self.min_block is None or block < self.min_block:
+            self.min_block = block
+        if self.max_block is None or block > self.max_block:
+            self.max_block = block
+
+        if self.now == self.accesses.size():
+            self.grow()
+
+        last = self.last_access.get(block)
+        if last is None:
+            self.cold += 1
+            if self.last_cold is not None:
+                stride = block - self.last_cold
+                self.strides[stride] = self.strides.get(stride, 0) + 1
+            self.last_cold = block
+        else:
+            # The distinct blocks accessed since the last access to
+            # this one are the blocks whose last access is later
+            distance = self.accesses.prefix(self.now) - \
+                self.accesses.prefix(last + 1)
+            b = log2_bin(distance)
+            self.reuse[b] = self.reuse.get(b, 0) + 1
+            self.accesses.add(last, -1)
+
+        self.accesses.add(self.now, 1)
+        self.last_access[block] = self.now
+        self.now += 1
+
+    def write(self, out, max_strides):
+        total = self.reads + self.writes
+        if total == 0:
+            raise ValueError("The trace has no reads or writes")
+
+        out.write("PROFILE 1\n")
+        out.write("BLOCK_SIZE %d\n" % self.block_size)
+        out.write("RANGE %d %d\n" % (self.min_block * self.block_size,
+                                     (self.max_block + 1) * self.block_size))
+        out.write("READ_PERCENT %f\n" % (100.0 * self.reads / total))
+        for size, count in sorted(self.sizes.items()):
+            out.write("SIZE %d %d\n" % (size, count))
+        for b, count in sorted(self.itt.items()):
+            out.write("ITT %d %d %d\n" % (bin_range(b) + (count,)))
+        for b, count in sorted(self.reuse.items()):
+            out.write("REUSE %d %d %d\n" % (bin_range(b) + (count,)))
+        out.write("COLD %d\n" % self.cold)
+
+        # Keep the most common strides and let the generator pick a
+        # random block for the others
+        strides = sorted(self.strides.items(), key=lambda s: -s[1])
+        for stride, count in strides[:max_strides]:
+            out.write("STRIDE %d %d\n" % (stride, count))
+        out.write("RANDOM_STRIDE %d\n" %
+                  sum(count for _, count in strides[max_strides:]))
+
+def main():
+    if len(sys.argv) < 3 or len(sys.argv) > 5:
+        print("Usage: ", sys.argv[0], " <protobuf input> <profile output> "
+              "[block size] [max strides]")
+        exit(-1)
+
+    block_size = int(sys.argv[3]) if len(sys.argv) > 3 else 64
+    max_strides = int(sys.argv[4]) if len(sys.argv) > 4 else 16
+
+    # Open the file in read mode
+    proto_in = protolib.openFileRd(sys.argv[1])
+
+    # Read the magic number in 4-byte Little Endian
+    magic_number = proto_in.read(4)
+
+    if magic_number not in ("gem5", b"gem5"):
+        print("Unrecognized file", sys.argv[1])
+        exit(-1)
+
+    header = packet_pb2.PacketHeader()
+    protolib.decodeMessage(proto_in, header)
+
+    profiler = Profiler(block_size)
+    packet = packet_pb2.Packet()
+    num_packets = 0
+    while protolib.decodeMessage(proto_in, packet):
+        profiler.add(packet)
+        num_packets += 1
+
+    proto_in.close()
+    print("Parsed packets:", num_packets)
+
+    try:
+        with open(sys.argv[2], 'w') as out:
+            profiler.write(out, max_strides)
+    except IOError:
+        print("Failed to open ", sys.argv[2], " for writing")
+        exit(-1)
+
+if __name__ == "__main__":
+    main()
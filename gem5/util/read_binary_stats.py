@@ -0,0 +1,194 @@
+#!/usr/bin/env python2.7
+
+# Copyright (c) 2019 The Regents of The University of Michigan
+# All rights reserved.
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are
+# met: redistributions of source code must retain the above copyright
+# notice, this list of conditions and the following disclaimer;
+# redistributions in binary form must reproduce the above copyright
+# notice, this list of conditions and the following disclaimer in the
+# documentation and/or other materials provided with the distribution;
+# neither the name of the copyright holders nor the names of its
+# contributors may be used to endorse or promote products derived from
+# this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+# "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+# LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+# A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+# OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+# SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+# LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+# THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+# (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+# OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+"""Read the binary stat files written by the bin:// stat visitor
+(src/base/stats/binary.hh).
+
+The file is returned as a table with a row per stat dump and a column
+per stat value. Columns are named after the stat, followed by "::" and
+the name of the value for vectors, distributions and formulas. When the
+set of stats changes during the simulation, values that don't exist in
+a dump are left empty.
+
+As a library:
+    import read_binary_stats
+    df = read_binary_stats.read_dataframe("m5out/stats.bin")
+
+As a script, the table is written as CSV:
+    read_binary_stats.py <stat file> [csv output]
+"""
+
+from __future__ import print_function
+
+import gzip
+import struct
+import sys
+
+MAGIC = b"GSTB"
+VERSION = 1
+
+class FormatError(Exception):
+    pass
+
+class Reader(object):
+    def __init__(self, data):
+        self.data = data
+        self.pos = 0
+
+    def done(self):
+        return self.pos >= len(self.data)
+
+    def unpack(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise FormatError("Truncated stat file")
+        vals = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return vals
+
+    def u8(self):
+        return self.unpack("<B")[0]
+
+    def u32(self):
+        return self.unpack("<I")[0]
+
+    def string(self):
+        size = self.u32()
+        if self.pos + size > len(self.data):
+            raise FormatError("Truncated stat file")
+        s = self.data[self.pos:self.pos + size].decode("utf-8")
+        self.pos += size
+        return s
+
+def _schema_columns(reader):
+    """Read a schema and return the name of every value, and the
+    descriptions of the stats."""
+    columns = []
+    descs = {}
+    for _ in range(reader.u32()):
+        name = reader.string()
+        desc = reader.string()
+        reader.u8() # kind
+        num_values = reader.u32()
+        value_names = [ reader.string() for _ in range(reader.u32()) ]
+        if desc:
+            descs[name] = desc
+
+        if not value_names and num_values == 1:
+            columns.append(name)
+        elif not value_names:
+            columns += [ "%s::%d" % (name, i) for i in range(num_values) ]
+        elif len(value_names) == num_values:
+            columns += [ "%s::%s" % (name, v) for v in value_names ]
+        else:
+            raise FormatError("Stat %s has %d values but %d names" % \
+                              (name, num_values, len(value_names)))
+    return columns, descs
+
+def read_dumps(filename):
+    """Iterate over the dumps of a binary stat file. Every dump is a
+    list of (column name, value) tuples."""
+    opener = gzip.open if filename.endswith(".gz") else open
+    with opener(filename, "rb") as f:
+        reader = Reader(f.read())
+
+    if reader.unpack("<4s")[0] != MAGIC:
+        raise FormatError("%s isn't a binary stat file" % filename)
+    version = reader.u32()
+    if version != VERSION:
+        raise FormatError("Unsupported binary stat version %d" % version)
+
+    columns = None
+    values = None
+    while not reader.done():
+        tag = reader.unpack("<c")[0]
+        if tag == b"S":
+            columns, _ = _schema_columns(reader)
+            values = None
+        elif tag == b"D":
+            count = reader.u32()
+            if columns is None or count != len(columns):
+                raise FormatError("Dump doesn't match the stat schema")
+            values = list(reader.unpack("<%dd" % count))
+            yield list(zip(columns, values))
+        elif tag == b"C":
+            if values is None:
+                raise FormatError("Incremental dump without a full dump")
+            for _ in range(reader.u32()):
+                idx = reader.u32()
+                values[idx] = reader.unpack("<d")[0]
+            yield list(zip(columns, values))
+        else:
+            raise FormatError("Unknown record %r" % tag)
+
+def read_dataframe(filename):
+    """Read a binary stat file into a pandas DataFrame with a row per
+    dump."""
+    import pandas
+
+    rows = []
+    order = {}
+    for dump in read_dumps(filename):
+        for name, _ in dump:
+            order.setdefault(name, len(order))
+        rows.append(dict(dump))
+
+    columns = sorted(order, key=order.get)
+    return pandas.DataFrame(rows, columns=columns)
+
+def write_csv(filename, out):
+    """Write a binary stat file as CSV without requiring pandas."""
+    import csv
+
+    dumps = list(read_dumps(filename))
+    order = {}
+    for dump in dumps:
+        for name, _ in dump:
+            order.setdefault(name, len(order))
+    columns = sorted(order, key=order.get)
+
+    writer = csv.writer(out)
+    writer.writerow(columns)
+    for dump in dumps:
+        row = dict(dump)
+        writer.writerow([ repr(row[c]) if c in row else "" for c in columns ])
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        print("Usage: %s <stat file> [csv output]" % sys.argv[0])
+        sys.exit(1)
+
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "w") as out:
+            write_csv(sys.argv[1], out)
+    else:
+        write_csv(sys.argv[1], sys.stdout)
+
+if __name__ == "__main__":
+    main()